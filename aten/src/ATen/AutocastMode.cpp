@@ -0,0 +1,253 @@
+#include <ATen/AutocastMode.h>
+
+#include <ATen/ATen.h>
+#include <ATen/core/op_registration/op_registration.h>
+#include <c10/core/impl/LocalTensorTypeSet.h>
+#include <c10/util/flat_hash_map.h>
+#include <c10/util/intrusive_ptr.h>
+
+#include <tuple>
+#include <vector>
+
+namespace at {
+namespace autocast {
+
+namespace {
+
+// Cast cache: the fp16 copies of the leaf tensors that require grad. The
+// weak reference keeps the TensorImpl of a key from being freed (and its
+// address reused by another tensor) while the entry exists.
+using weakref_type = c10::weak_intrusive_ptr<TensorImpl, UndefinedTensorImpl>;
+using val_type = std::tuple<weakref_type, Tensor>;
+thread_local ska::flat_hash_map<TensorImpl*, val_type> cached_casts;
+
+thread_local int64_t nesting = 0;
+
+bool is_eligible(const Tensor& arg) {
+  return arg.defined() && arg.is_cuda() && arg.is_floating_point() &&
+      arg.scalar_type() != at::kDouble;
+}
+
+bool is_cacheable(const Tensor& arg) {
+  auto* meta = arg.unsafeGetTensorImpl()->autograd_meta();
+  return meta != nullptr && meta->requires_grad() && meta->is_leaf();
+}
+
+Tensor cached_cast(at::ScalarType to_type, const Tensor& arg) {
+  if (!is_eligible(arg) || arg.scalar_type() == to_type) {
+    return arg;
+  }
+  if (to_type == at::kHalf && arg.scalar_type() == at::kFloat && is_cacheable(arg)) {
+    auto it = cached_casts.find(arg.unsafeGetTensorImpl());
+    if (it != cached_casts.end()) {
+      return std::get<1>(it->second);
+    }
+    auto casted_arg = arg.to(to_type);
+    cached_casts.emplace(
+        arg.unsafeGetTensorImpl(),
+        val_type{weakref_type(arg.getIntrusivePtr()), casted_arg});
+    return casted_arg;
+  }
+  return arg.to(to_type);
+}
+
+std::vector<Tensor> cached_cast(at::ScalarType to_type, TensorList args) {
+  std::vector<Tensor> casted_args;
+  casted_args.reserve(args.size());
+  for (const auto& arg : args) {
+    casted_args.push_back(cached_cast(to_type, arg));
+  }
+  return casted_args;
+}
+
+// Everything that isn't a tensor is passed through.
+template<class T>
+T cached_cast(at::ScalarType /*to_type*/, T arg) {
+  return arg;
+}
+
+enum class CastPolicy : uint8_t {
+  fp16, // matmuls and convolutions, which are faster in fp16 (Tensor Cores)
+  fp32, // ops that lose too much range or precision in fp16
+};
+
+constexpr at::ScalarType policy_type(CastPolicy policy) {
+  return policy == CastPolicy::fp16 ? at::kHalf : at::kFloat;
+}
+
+// The autocast kernel of an op: casts the arguments and calls the op again
+// with AutocastTensorId excluded, which dispatches to autograd and then to
+// the backend.
+template<CastPolicy policy, class Sig, Sig* F, class Ret, class ArgList>
+struct WrapFunction_ {};
+
+template<CastPolicy policy, class Sig, Sig* F, class Ret, class... Args>
+struct WrapFunction_<policy, Sig, F, Ret, guts::typelist::typelist<Args...>> {
+  static Ret call(Args... args) {
+    c10::impl::ExcludeTensorTypeIdGuard no_autocast(TensorTypeId::AutocastTensorId);
+    return (*F)(cached_cast(policy_type(policy), args)...);
+  }
+};
+
+template<CastPolicy policy, class Sig, Sig* F>
+struct WrapFunction final {
+  using type = WrapFunction_<
+      policy,
+      Sig,
+      F,
+      typename guts::function_traits<Sig>::return_type,
+      typename guts::function_traits<Sig>::parameter_types>;
+};
+
+} // namespace
+
+bool is_enabled() {
+  return c10::impl::tls_is_tensor_type_id_included(TensorTypeId::AutocastTensorId);
+}
+
+void set_enabled(bool enabled) {
+  c10::impl::tls_set_tensor_type_id_included(TensorTypeId::AutocastTensorId, enabled);
+}
+
+void clear_cache() {
+  cached_casts.clear();
+}
+
+int64_t increment_nesting() {
+  return ++nesting;
+}
+
+int64_t decrement_nesting() {
+  TORCH_INTERNAL_ASSERT(nesting > 0, "unbalanced autocast nesting");
+  return --nesting;
+}
+
+AutocastGuard::AutocastGuard(bool enabled) : prev_enabled_(is_enabled()) {
+  increment_nesting();
+  set_enabled(enabled);
+}
+
+AutocastGuard::~AutocastGuard() {
+  set_enabled(prev_enabled_);
+  if (decrement_nesting() == 0) {
+    clear_cache();
+  }
+}
+
+#ifndef USE_STATIC_DISPATCH
+namespace {
+
+// Operators without an autocast kernel run in the types of their inputs.
+auto fallthrough = c10::Dispatcher::singleton().registerBackendFallbackKernel(
+    TensorTypeId::AutocastTensorId, &c10::backendFallthroughKernel);
+
+// The kernels are registered like the backend kernels in the generated
+// CPUType.cpp; the schemas must stay identical to native_functions.yaml.
+#define KERNEL(FUNC, SCHEMA, SIGNATURE, POLICY) \
+  .op(torch::RegisterOperators::options() \
+    .schema(SCHEMA) \
+    .kernel<SIGNATURE>(TensorTypeId::AutocastTensorId, \
+        &WrapFunction<CastPolicy::POLICY, SIGNATURE, &FUNC>::type::call) \
+    .aliasAnalysis(c10::AliasAnalysisKind::FROM_SCHEMA))
+
+#define KERNEL_UNBOXED_ONLY(FUNC, SCHEMA, SIGNATURE, POLICY) \
+  .op(torch::RegisterOperators::options() \
+    .schema(SCHEMA) \
+    .impl_unboxedOnlyKernel<SIGNATURE, \
+        &WrapFunction<CastPolicy::POLICY, SIGNATURE, &FUNC>::type::call>(TensorTypeId::AutocastTensorId) \
+    .aliasAnalysis(c10::AliasAnalysisKind::FROM_SCHEMA))
+
+auto registerer = torch::RegisterOperators()
+  // fp16: run faster on Tensor Cores
+  KERNEL_UNBOXED_ONLY(at::_convolution, "aten::_convolution(Tensor input, Tensor weight, Tensor? bias, int[] stride, int[] padding, int[] dilation, bool transposed, int[] output_padding, int groups, bool benchmark, bool deterministic, bool cudnn_enabled) -> Tensor", Tensor (const Tensor &, const Tensor &, const Tensor &, IntArrayRef, IntArrayRef, IntArrayRef, bool, IntArrayRef, int64_t, bool, bool, bool), fp16)
+  KERNEL_UNBOXED_ONLY(at::conv1d, "aten::conv1d(Tensor input, Tensor weight, Tensor? bias=None, int[1] stride=1, int[1] padding=0, int[1] dilation=1, int groups=1) -> Tensor", Tensor (const Tensor &, const Tensor &, const Tensor &, IntArrayRef, IntArrayRef, IntArrayRef, int64_t), fp16)
+  KERNEL_UNBOXED_ONLY(at::conv2d, "aten::conv2d(Tensor input, Tensor weight, Tensor? bias=None, int[2] stride=1, int[2] padding=0, int[2] dilation=1, int groups=1) -> Tensor", Tensor (const Tensor &, const Tensor &, const Tensor &, IntArrayRef, IntArrayRef, IntArrayRef, int64_t), fp16)
+  KERNEL_UNBOXED_ONLY(at::conv3d, "aten::conv3d(Tensor input, Tensor weight, Tensor? bias=None, int[3] stride=1, int[3] padding=0, int[3] dilation=1, int groups=1) -> Tensor", Tensor (const Tensor &, const Tensor &, const Tensor &, IntArrayRef, IntArrayRef, IntArrayRef, int64_t), fp16)
+  KERNEL(at::conv_tbc, "aten::conv_tbc(Tensor self, Tensor weight, Tensor bias, int pad=0) -> Tensor", Tensor (const Tensor &, const Tensor &, const Tensor &, int64_t), fp16)
+  KERNEL_UNBOXED_ONLY(at::conv_transpose1d, "aten::conv_transpose1d(Tensor input, Tensor weight, Tensor? bias=None, int[1] stride=1, int[1] padding=0, int[1] output_padding=0, int groups=1, int[1] dilation=1) -> Tensor", Tensor (const Tensor &, const Tensor &, const Tensor &, IntArrayRef, IntArrayRef, IntArrayRef, int64_t, IntArrayRef), fp16)
+  KERNEL_UNBOXED_ONLY(at::conv_transpose2d, "aten::conv_transpose2d.input(Tensor input, Tensor weight, Tensor? bias=None, int[2] stride=1, int[2] padding=0, int[2] output_padding=0, int groups=1, int[2] dilation=1) -> Tensor", Tensor (const Tensor &, const Tensor &, const Tensor &, IntArrayRef, IntArrayRef, IntArrayRef, int64_t, IntArrayRef), fp16)
+  KERNEL_UNBOXED_ONLY(at::conv_transpose3d, "aten::conv_transpose3d.input(Tensor input, Tensor weight, Tensor? bias=None, int[3] stride=1, int[3] padding=0, int[3] output_padding=0, int groups=1, int[3] dilation=1) -> Tensor", Tensor (const Tensor &, const Tensor &, const Tensor &, IntArrayRef, IntArrayRef, IntArrayRef, int64_t, IntArrayRef), fp16)
+  KERNEL_UNBOXED_ONLY(at::convolution, "aten::convolution(Tensor input, Tensor weight, Tensor? bias, int[] stride, int[] padding, int[] dilation, bool transposed, int[] output_padding, int groups) -> Tensor", Tensor (const Tensor &, const Tensor &, const Tensor &, IntArrayRef, IntArrayRef, IntArrayRef, bool, IntArrayRef, int64_t), fp16)
+  KERNEL(at::prelu, "aten::prelu(Tensor self, Tensor weight) -> Tensor", Tensor (const Tensor &, const Tensor &), fp16)
+  KERNEL(at::addmm, "aten::addmm(Tensor self, Tensor mat1, Tensor mat2, *, Scalar beta=1, Scalar alpha=1) -> Tensor", Tensor (const Tensor &, const Tensor &, const Tensor &, Scalar, Scalar), fp16)
+  KERNEL(at::addmv, "aten::addmv(Tensor self, Tensor mat, Tensor vec, *, Scalar beta=1, Scalar alpha=1) -> Tensor", Tensor (const Tensor &, const Tensor &, const Tensor &, Scalar, Scalar), fp16)
+  KERNEL(at::addr, "aten::addr(Tensor self, Tensor vec1, Tensor vec2, *, Scalar beta=1, Scalar alpha=1) -> Tensor", Tensor (const Tensor &, const Tensor &, const Tensor &, Scalar, Scalar), fp16)
+  KERNEL(at::matmul, "aten::matmul(Tensor self, Tensor other) -> Tensor", Tensor (const Tensor &, const Tensor &), fp16)
+  KERNEL(at::mm, "aten::mm(Tensor self, Tensor mat2) -> Tensor", Tensor (const Tensor &, const Tensor &), fp16)
+  KERNEL(at::mv, "aten::mv(Tensor self, Tensor vec) -> Tensor", Tensor (const Tensor &, const Tensor &), fp16)
+  KERNEL_UNBOXED_ONLY(at::linear, "aten::linear(Tensor input, Tensor weight, Tensor? bias=None) -> Tensor", Tensor (const Tensor &, const Tensor &, const Tensor &), fp16)
+  KERNEL(at::addbmm, "aten::addbmm(Tensor self, Tensor batch1, Tensor batch2, *, Scalar beta=1, Scalar alpha=1) -> Tensor", Tensor (const Tensor &, const Tensor &, const Tensor &, Scalar, Scalar), fp16)
+  KERNEL(at::baddbmm, "aten::baddbmm(Tensor self, Tensor batch1, Tensor batch2, *, Scalar beta=1, Scalar alpha=1) -> Tensor", Tensor (const Tensor &, const Tensor &, const Tensor &, Scalar, Scalar), fp16)
+  KERNEL(at::bmm, "aten::bmm(Tensor self, Tensor mat2) -> Tensor", Tensor (const Tensor &, const Tensor &), fp16)
+  KERNEL_UNBOXED_ONLY(at::chain_matmul, "aten::chain_matmul(Tensor[] matrices) -> Tensor", Tensor (TensorList), fp16)
+  // fp32: need the range or precision of float
+  KERNEL(at::acos, "aten::acos(Tensor self) -> Tensor", Tensor (const Tensor &), fp32)
+  KERNEL(at::asin, "aten::asin(Tensor self) -> Tensor", Tensor (const Tensor &), fp32)
+  KERNEL(at::cosh, "aten::cosh(Tensor self) -> Tensor", Tensor (const Tensor &), fp32)
+  KERNEL(at::erfinv, "aten::erfinv(Tensor self) -> Tensor", Tensor (const Tensor &), fp32)
+  KERNEL(at::exp, "aten::exp(Tensor self) -> Tensor", Tensor (const Tensor &), fp32)
+  KERNEL(at::expm1, "aten::expm1(Tensor self) -> Tensor", Tensor (const Tensor &), fp32)
+  KERNEL(at::log, "aten::log(Tensor self) -> Tensor", Tensor (const Tensor &), fp32)
+  KERNEL(at::log10, "aten::log10(Tensor self) -> Tensor", Tensor (const Tensor &), fp32)
+  KERNEL(at::log2, "aten::log2(Tensor self) -> Tensor", Tensor (const Tensor &), fp32)
+  KERNEL(at::log1p, "aten::log1p(Tensor self) -> Tensor", Tensor (const Tensor &), fp32)
+  KERNEL(at::reciprocal, "aten::reciprocal(Tensor self) -> Tensor", Tensor (const Tensor &), fp32)
+  KERNEL(at::rsqrt, "aten::rsqrt(Tensor self) -> Tensor", Tensor (const Tensor &), fp32)
+  KERNEL(at::sinh, "aten::sinh(Tensor self) -> Tensor", Tensor (const Tensor &), fp32)
+  KERNEL(at::tan, "aten::tan(Tensor self) -> Tensor", Tensor (const Tensor &), fp32)
+  KERNEL(at::pow, "aten::pow.Tensor_Scalar(Tensor self, Scalar exponent) -> Tensor", Tensor (const Tensor &, Scalar), fp32)
+  KERNEL(at::pow, "aten::pow.Tensor_Tensor(Tensor self, Tensor exponent) -> Tensor", Tensor (const Tensor &, const Tensor &), fp32)
+  KERNEL(at::pow, "aten::pow.Scalar(Scalar self, Tensor exponent) -> Tensor", Tensor (Scalar, const Tensor &), fp32)
+  KERNEL(at::softplus, "aten::softplus(Tensor self, Scalar beta=1, Scalar threshold=20) -> Tensor", Tensor (const Tensor &, Scalar, Scalar), fp32)
+  KERNEL_UNBOXED_ONLY(at::layer_norm, "aten::layer_norm(Tensor input, int[] normalized_shape, Tensor? weight=None, Tensor? bias=None, float eps=1e-05, bool cudnn_enable=True) -> Tensor", Tensor (const Tensor &, IntArrayRef, const Tensor &, const Tensor &, double, bool), fp32)
+  KERNEL_UNBOXED_ONLY(at::group_norm, "aten::group_norm(Tensor input, int num_groups, Tensor? weight=None, Tensor? bias=None, float eps=1e-05, bool cudnn_enabled=True) -> Tensor", Tensor (const Tensor &, int64_t, const Tensor &, const Tensor &, double, bool), fp32)
+  KERNEL(at::norm, "aten::norm.Scalar(Tensor self, Scalar p=2) -> Tensor", Tensor (const Tensor &, Scalar), fp32)
+  KERNEL_UNBOXED_ONLY(at::norm, "aten::norm.ScalarOpt_dim(Tensor self, Scalar? p, int[1] dim, bool keepdim=False) -> Tensor", Tensor (const Tensor &, c10::optional<Scalar>, IntArrayRef, bool), fp32)
+  KERNEL(at::frobenius_norm, "aten::frobenius_norm(Tensor self) -> Tensor", Tensor (const Tensor &), fp32)
+  KERNEL_UNBOXED_ONLY(at::frobenius_norm, "aten::frobenius_norm.dim(Tensor self, int[1] dim, bool keepdim=False) -> Tensor", Tensor (const Tensor &, IntArrayRef, bool), fp32)
+  KERNEL(at::nuclear_norm, "aten::nuclear_norm(Tensor self, bool keepdim=False) -> Tensor", Tensor (const Tensor &, bool), fp32)
+  KERNEL_UNBOXED_ONLY(at::nuclear_norm, "aten::nuclear_norm.dim(Tensor self, int[2] dim, bool keepdim=False) -> Tensor", Tensor (const Tensor &, IntArrayRef, bool), fp32)
+  KERNEL(at::cosine_similarity, "aten::cosine_similarity(Tensor x1, Tensor x2, int dim=1, float eps=1e-08) -> Tensor", Tensor (const Tensor &, const Tensor &, int64_t, double), fp32)
+  KERNEL(at::poisson_nll_loss, "aten::poisson_nll_loss(Tensor input, Tensor target, bool log_input, bool full, float eps, int reduction) -> Tensor", Tensor (const Tensor &, const Tensor &, bool, bool, double, int64_t), fp32)
+  KERNEL(at::cosine_embedding_loss, "aten::cosine_embedding_loss(Tensor input1, Tensor input2, Tensor target, float margin=0.0, int reduction=Mean) -> Tensor", Tensor (const Tensor &, const Tensor &, const Tensor &, double, int64_t), fp32)
+  KERNEL_UNBOXED_ONLY(at::nll_loss, "aten::nll_loss(Tensor self, Tensor target, Tensor? weight=None, int reduction=Mean, int ignore_index=-100) -> Tensor", Tensor (const Tensor &, const Tensor &, const Tensor &, int64_t, int64_t), fp32)
+  KERNEL_UNBOXED_ONLY(at::nll_loss2d, "aten::nll_loss2d(Tensor self, Tensor target, Tensor? weight=None, int reduction=Mean, int ignore_index=-100) -> Tensor", Tensor (const Tensor &, const Tensor &, const Tensor &, int64_t, int64_t), fp32)
+  KERNEL(at::hinge_embedding_loss, "aten::hinge_embedding_loss(Tensor self, Tensor target, float margin=1.0, int reduction=Mean) -> Tensor", Tensor (const Tensor &, const Tensor &, double, int64_t), fp32)
+  KERNEL(at::kl_div, "aten::kl_div(Tensor self, Tensor target, int reduction=Mean) -> Tensor", Tensor (const Tensor &, const Tensor &, int64_t), fp32)
+  KERNEL(at::l1_loss, "aten::l1_loss(Tensor self, Tensor target, int reduction=Mean) -> Tensor", Tensor (const Tensor &, const Tensor &, int64_t), fp32)
+  KERNEL(at::smooth_l1_loss, "aten::smooth_l1_loss(Tensor self, Tensor target, int reduction=Mean) -> Tensor", Tensor (const Tensor &, const Tensor &, int64_t), fp32)
+  KERNEL(at::mse_loss, "aten::mse_loss(Tensor self, Tensor target, int reduction=Mean) -> Tensor", Tensor (const Tensor &, const Tensor &, int64_t), fp32)
+  KERNEL(at::margin_ranking_loss, "aten::margin_ranking_loss(Tensor input1, Tensor input2, Tensor target, float margin=0.0, int reduction=Mean) -> Tensor", Tensor (const Tensor &, const Tensor &, const Tensor &, double, int64_t), fp32)
+  KERNEL(at::multilabel_margin_loss, "aten::multilabel_margin_loss(Tensor self, Tensor target, int reduction=Mean) -> Tensor", Tensor (const Tensor &, const Tensor &, int64_t), fp32)
+  KERNEL(at::soft_margin_loss, "aten::soft_margin_loss(Tensor self, Tensor target, int reduction=Mean) -> Tensor", Tensor (const Tensor &, const Tensor &, int64_t), fp32)
+  KERNEL(at::triplet_margin_loss, "aten::triplet_margin_loss(Tensor anchor, Tensor positive, Tensor negative, float margin=1.0, float p=2, float eps=1e-06, bool swap=False, int reduction=Mean) -> Tensor", Tensor (const Tensor &, const Tensor &, const Tensor &, double, double, double, bool, int64_t), fp32)
+  KERNEL_UNBOXED_ONLY(at::binary_cross_entropy_with_logits, "aten::binary_cross_entropy_with_logits(Tensor self, Tensor target, Tensor? weight=None, Tensor? pos_weight=None, int reduction=Mean) -> Tensor", Tensor (const Tensor &, const Tensor &, const Tensor &, const Tensor &, int64_t), fp32)
+  KERNEL_UNBOXED_ONLY(at::binary_cross_entropy, "aten::binary_cross_entropy(Tensor self, Tensor target, Tensor? weight=None, int reduction=Mean) -> Tensor", Tensor (const Tensor &, const Tensor &, const Tensor &, int64_t), fp32)
+  KERNEL(at::dist, "aten::dist(Tensor self, Tensor other, Scalar p=2) -> Tensor", Tensor (const Tensor &, const Tensor &, Scalar), fp32)
+  KERNEL(at::pdist, "aten::pdist(Tensor self, float p=2) -> Tensor", Tensor (const Tensor &, double), fp32)
+  KERNEL(at::cdist, "aten::cdist(Tensor x1, Tensor x2, float p=2, int? compute_mode=None) -> Tensor", Tensor (const Tensor &, const Tensor &, double, c10::optional<int64_t>), fp32)
+  KERNEL(at::renorm, "aten::renorm(Tensor self, Scalar p, int dim, Scalar maxnorm) -> Tensor", Tensor (const Tensor &, Scalar, int64_t, Scalar), fp32)
+  KERNEL_UNBOXED_ONLY(at::softmax, "aten::softmax.int(Tensor self, int dim, ScalarType? dtype=None) -> Tensor", Tensor (const Tensor &, int64_t, c10::optional<ScalarType>), fp32)
+  KERNEL_UNBOXED_ONLY(at::log_softmax, "aten::log_softmax.int(Tensor self, int dim, ScalarType? dtype=None) -> Tensor", Tensor (const Tensor &, int64_t, c10::optional<ScalarType>), fp32)
+  KERNEL_UNBOXED_ONLY(at::sum, "aten::sum(Tensor self, *, ScalarType? dtype=None) -> Tensor", Tensor (const Tensor &, c10::optional<ScalarType>), fp32)
+  KERNEL_UNBOXED_ONLY(at::sum, "aten::sum.dim_IntList(Tensor self, int[1] dim, bool keepdim=False, *, ScalarType? dtype=None) -> Tensor", Tensor (const Tensor &, IntArrayRef, bool, c10::optional<ScalarType>), fp32)
+  KERNEL_UNBOXED_ONLY(at::prod, "aten::prod(Tensor self, *, ScalarType? dtype=None) -> Tensor", Tensor (const Tensor &, c10::optional<ScalarType>), fp32)
+  KERNEL_UNBOXED_ONLY(at::prod, "aten::prod.dim_int(Tensor self, int dim, bool keepdim=False, *, ScalarType? dtype=None) -> Tensor", Tensor (const Tensor &, int64_t, bool, c10::optional<ScalarType>), fp32)
+  KERNEL_UNBOXED_ONLY(at::mean, "aten::mean(Tensor self, *, ScalarType? dtype=None) -> Tensor", Tensor (const Tensor &, c10::optional<ScalarType>), fp32)
+  KERNEL_UNBOXED_ONLY(at::mean, "aten::mean.dim(Tensor self, int[1] dim, bool keepdim=False, *, ScalarType? dtype=None) -> Tensor", Tensor (const Tensor &, IntArrayRef, bool, c10::optional<ScalarType>), fp32)
+  KERNEL_UNBOXED_ONLY(at::cumsum, "aten::cumsum(Tensor self, int dim, *, ScalarType? dtype=None) -> Tensor", Tensor (const Tensor &, int64_t, c10::optional<ScalarType>), fp32)
+  KERNEL_UNBOXED_ONLY(at::cumprod, "aten::cumprod(Tensor self, int dim, *, ScalarType? dtype=None) -> Tensor", Tensor (const Tensor &, int64_t, c10::optional<ScalarType>), fp32)
+  KERNEL(at::var, "aten::var(Tensor self, bool unbiased=True) -> Tensor", Tensor (const Tensor &, bool), fp32)
+  KERNEL_UNBOXED_ONLY(at::var, "aten::var.dim(Tensor self, int[1] dim, bool unbiased=True, bool keepdim=False) -> Tensor", Tensor (const Tensor &, IntArrayRef, bool, bool), fp32)
+  KERNEL(at::std, "aten::std(Tensor self, bool unbiased=True) -> Tensor", Tensor (const Tensor &, bool), fp32)
+  KERNEL_UNBOXED_ONLY(at::std, "aten::std.dim(Tensor self, int[1] dim, bool unbiased=True, bool keepdim=False) -> Tensor", Tensor (const Tensor &, IntArrayRef, bool, bool), fp32)
+  KERNEL_UNBOXED_ONLY(at::logsumexp, "aten::logsumexp(Tensor self, int[1] dim, bool keepdim=False) -> Tensor", Tensor (const Tensor &, IntArrayRef, bool), fp32);
+
+#undef KERNEL
+#undef KERNEL_UNBOXED_ONLY
+
+} // namespace
+#endif
+
+} // namespace autocast
+} // namespace at
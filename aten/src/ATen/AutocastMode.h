@@ -0,0 +1,52 @@
+#pragma once
+
+#include <c10/macros/Macros.h>
+
+#include <cstdint>
+
+namespace at {
+namespace autocast {
+
+/*
+* Automatic mixed precision. While autocast is enabled for a thread, the
+* dispatcher routes CUDA operators through AutocastTensorId first:
+*   - ops that run fast and safely in fp16 (matmuls, convolutions, linear)
+*     get their floating point CUDA inputs cast to half,
+*   - ops that need the range or precision of fp32 (softmax, losses,
+*     reductions, exp/log/pow, norms) get them cast to float,
+*   - all other ops run in the types of their inputs.
+* The casts are recorded by autograd, so gradients flow back to the original
+* (fp32) tensors. The fp16 copies of leaf tensors that require grad (i.e. the
+* parameters) are cached, so a weight used by several ops is converted only
+* once; the cache is cleared when the outermost AutocastGuard of the thread
+* exits, so with one guard per iteration, parameters updated by the optimizer
+* get converted again in the next iteration.
+*/
+
+CAFFE2_API bool is_enabled();
+CAFFE2_API void set_enabled(bool enabled);
+
+// Drops the cached casts of this thread.
+CAFFE2_API void clear_cache();
+
+// Number of enclosing autocast scopes, for Python context managers that can't
+// use AutocastGuard. decrement_nesting() returns the remaining depth.
+CAFFE2_API int64_t increment_nesting();
+CAFFE2_API int64_t decrement_nesting();
+
+// Enables (or disables) autocast for the thread in a scope. The cast cache is
+// cleared when the outermost guard exits.
+class CAFFE2_API AutocastGuard {
+ public:
+  explicit AutocastGuard(bool enabled = true);
+  ~AutocastGuard();
+
+  AutocastGuard(const AutocastGuard&) = delete;
+  AutocastGuard& operator=(const AutocastGuard&) = delete;
+
+ private:
+  bool prev_enabled_;
+};
+
+} // namespace autocast
+} // namespace at
@@ -61,6 +61,7 @@ void CPUGenerator::set_current_seed(uint64_t seed) {
   next_float_normal_sample_.reset();
   next_double_normal_sample_.reset();
   engine_ = mt19937(seed);
+  philox_offset_ = 0;
 }
 
 /**
@@ -159,6 +160,69 @@ void CPUGenerator::set_engine(at::mt19937 engine) {
   engine_ = engine;
 }
 
+/**
+ * Note [Philox mode of CPUGenerator]
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * The mt19937 engine is sequential: an op drawing from it has to hold the
+ * generator's lock and produce its numbers one after the other to stay
+ * reproducible. In Philox mode, the ops which support it (uniform_, normal_
+ * and bernoulli_ on float and double tensors, and so dropout) instead ask
+ * philox_engine_inputs for the seed and an offset, and generate their
+ * numbers in parallel: the numbers of the elements of block b come from
+ * at::philox_engine(seed, b, offset), so that they don't depend on the
+ * number of threads. The offset advances by the numbers consumed in a block,
+ * so that the next op gets fresh ones. The other ops keep using mt19937.
+ *
+ * The Philox state is the seed and the offset: the offset is reset by
+ * set_current_seed, and isn't part of the state of get_state / set_state,
+ * which only covers the mt19937 engine.
+ */
+
+/**
+ * Enables or disables the Philox mode
+ *
+ * See Note [Acquire lock when using random generators]
+ */
+void CPUGenerator::set_philox_mode(bool enabled) {
+  philox_mode_ = enabled;
+}
+
+/**
+ * Whether the ops which support it use Philox
+ */
+bool CPUGenerator::philox_mode() const {
+  return philox_mode_;
+}
+
+/**
+ * Sets the Philox offset
+ *
+ * See Note [Acquire lock when using random generators]
+ */
+void CPUGenerator::set_philox_offset(uint64_t offset) {
+  philox_offset_ = offset;
+}
+
+/**
+ * Gets the Philox offset
+ */
+uint64_t CPUGenerator::philox_offset() const {
+  return philox_offset_;
+}
+
+/**
+ * Gets the seed and the offset of the philox_engine of an op, and advances
+ * the offset by increment, the number of 128 bit numbers used by each
+ * subsequence of the op.
+ *
+ * See Note [Acquire lock when using random generators]
+ */
+std::pair<uint64_t, uint64_t> CPUGenerator::philox_engine_inputs(uint64_t increment) {
+  uint64_t offset = philox_offset_;
+  philox_offset_ += increment;
+  return std::make_pair(this->current_seed(), offset);
+}
+
 /**
  * Public clone method implementation
  * 
@@ -178,6 +242,8 @@ CPUGenerator* CPUGenerator::clone_impl() const {
   gen->set_engine(engine_);
   gen->set_next_float_normal_sample(next_float_normal_sample_);
   gen->set_next_double_normal_sample(next_double_normal_sample_);
+  gen->set_philox_mode(philox_mode_);
+  gen->set_philox_offset(philox_offset_);
   return gen;
 }
 
@@ -59,6 +59,30 @@ void Context::setDeterministicCuDNN(bool b) {
   deterministic_cudnn = b;
 }
 
+bool Context::fastMathCPU() const {
+  return fast_math_cpu;
+}
+
+void Context::setFastMathCPU(bool b) {
+  fast_math_cpu = b;
+}
+
+bool Context::benchmarkCPU() const {
+  return benchmark_cpu;
+}
+
+void Context::setBenchmarkCPU(bool b) {
+  benchmark_cpu = b;
+}
+
+bool Context::copyOnWriteClone() const {
+  return copy_on_write_clone;
+}
+
+void Context::setCopyOnWriteClone(bool b) {
+  copy_on_write_clone = b;
+}
+
 bool Context::benchmarkCuDNN() const {
   return benchmark_cudnn;
 }
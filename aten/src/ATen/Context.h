@@ -106,6 +106,18 @@ class CAFFE2_API Context {
   void setBenchmarkCuDNN(bool);
   bool deterministicCuDNN() const;
   void setDeterministicCuDNN(bool);
+  // Lets some CPU kernels trade a few ulp of accuracy for speed on float
+  // tensors, see ATen/cpu/vec256/vec256_math.h
+  bool fastMathCPU() const;
+  void setFastMathCPU(bool);
+  // Lets convolution pick the fastest of the CPU backends available for
+  // each shape by timing them, see native/ConvolutionBenchmarkCPU.h
+  bool benchmarkCPU() const;
+  void setBenchmarkCPU(bool);
+  // Makes the clones of tensors share their storage until one of them is
+  // written, see Note [Copy-on-write storages] in c10/core/impl/COW.h
+  bool copyOnWriteClone() const;
+  void setCopyOnWriteClone(bool);
   at::QEngine qEngine() const;
   void setQEngine(at::QEngine e);
   const std::vector<at::QEngine>& supportedQEngines() const;
@@ -127,6 +139,9 @@ class CAFFE2_API Context {
   bool deterministic_cudnn = false;
   bool benchmark_cudnn = false;
   bool enabled_mkldnn = true;
+  bool fast_math_cpu = false;
+  bool benchmark_cpu = false;
+  bool copy_on_write_clone = false;
   c10::optional<at::QEngine> quantized_engine = c10::nullopt;
   std::unique_ptr<THCState, void(*)(THCState*)> thc_state;
   std::unique_ptr<THHState, void(*)(THHState*)> thh_state;
@@ -1,19 +1,29 @@
 #pragma once
 
 #include <ATen/Parallel.h>
+#include <ATen/ThreadAffinity.h>
 #include <c10/core/thread_pool.h>
 
+#include <atomic>
+#include <memory>
+
 namespace at {
 
 class CAFFE2_API PTThreadPool : public c10::ThreadPool {
 public:
+  // Threads are pinned according to `affinity`, as threads
+  // first_thread_index, first_thread_index + 1, ... of the policy.
   explicit PTThreadPool(
       int pool_size,
-      int numa_node_id = -1)
-    : c10::ThreadPool(pool_size, numa_node_id, [](){
-        c10::setThreadName("PTThreadPool");
-        at::init_num_threads();
-      }) {}
+      int numa_node_id = -1,
+      ThreadAffinity affinity = ThreadAffinity(),
+      size_t first_thread_index = 0)
+    : c10::ThreadPool(pool_size, numa_node_id,
+        [affinity, next_index = std::make_shared<std::atomic<size_t>>(first_thread_index)](){
+          c10::setThreadName("PTThreadPool");
+          affinity.pin_current_thread((*next_index)++);
+          at::init_num_threads();
+        }) {}
 };
 
 } // namespace at
@@ -125,6 +125,59 @@ CAFFE2_API std::shared_ptr<c10::ivalue::Future> intraop_launch_future(
 // Returns number of intra-op threads used by default
 CAFFE2_API int intraop_default_num_threads();
 
+// Limits the number of threads, including the calling thread, that parallel
+// regions started on the calling thread may use; 0 (the default) means no
+// limit beyond get_num_threads(). Tasks started with launch() inherit the
+// budget of the launching thread, so that each inter-op task (e.g., a JIT
+// fork) gets its share of the intra-op threads instead of either all of them
+// or one. Honored by all backends; with TBB, parallel regions run in a task
+// arena of the budget size.
+CAFFE2_API void set_intraop_thread_budget(int budget);
+CAFFE2_API int get_intraop_thread_budget();
+
+// RAII guard that sets the intra-op thread budget of the current thread.
+class CAFFE2_API IntraOpThreadBudgetGuard {
+ public:
+  explicit IntraOpThreadBudgetGuard(int budget)
+      : prev_budget_(get_intraop_thread_budget()) {
+    set_intraop_thread_budget(budget);
+  }
+
+  ~IntraOpThreadBudgetGuard() {
+    set_intraop_thread_budget(prev_budget_);
+  }
+
+ private:
+  int prev_budget_;
+};
+
+// Time in microseconds that idle intra-op threads spin, waiting for the next
+// parallel region, before they go to sleep. Back-to-back small ops then do
+// not pay the latency of waking up sleeping threads, at the cost of CPU time
+// burnt while spinning. 0 disables spinning. Defaults to
+// PYTORCH_INTRAOP_SPIN_US, or 50. Honored by the native and work-stealing
+// backends; OpenMP has OMP_WAIT_POLICY and KMP_BLOCKTIME instead.
+CAFFE2_API void set_intraop_spin_time_us(int64_t us);
+CAFFE2_API int64_t get_intraop_spin_time_us();
+
+// How idle intra-op threads got their next work, since the pool started.
+struct IntraOpWakeupStats {
+  // found work while spinning
+  int64_t spin_hits = 0;
+  // went to sleep
+  int64_t parks = 0;
+};
+CAFFE2_API IntraOpWakeupStats get_intraop_wakeup_stats();
+
+namespace internal {
+// Number of threads a parallel region started on the calling thread may use:
+// get_num_threads() capped by the intra-op thread budget.
+CAFFE2_API int intraop_num_threads();
+
+// Spin time from PYTORCH_INTRAOP_SPIN_US, or the default.
+CAFFE2_API int64_t intraop_default_spin_time_us();
+} // namespace internal
+
 } // namespace at
 
 #if AT_PARALLEL_OPENMP
@@ -133,4 +186,6 @@ CAFFE2_API int intraop_default_num_threads();
 #include <ATen/ParallelNative.h>
 #elif AT_PARALLEL_NATIVE_TBB
 #include <ATen/ParallelNativeTBB.h>
+#elif AT_PARALLEL_WORK_STEALING
+#include <ATen/ParallelWorkStealing.h>
 #endif
@@ -2,8 +2,10 @@
 
 #include <ATen/Config.h>
 #include <ATen/PTThreadPool.h>
+#include <ATen/ThreadAffinity.h>
 #include <ATen/Version.h>
 
+#include <algorithm>
 #include <sstream>
 #include <thread>
 
@@ -19,6 +21,10 @@ namespace at {
 
 namespace {
 
+thread_local int intraop_thread_budget_ = 0;
+
+const int64_t DEFAULT_INTRAOP_SPIN_TIME_US = 50;
+
 const char* get_env_var(
     const char* var_name, const char* def_value = nullptr) {
   const char* value = std::getenv(var_name);
@@ -49,6 +55,12 @@ std::string get_parallel_info() {
      << at::get_num_threads() << std::endl;
   ss << "\tat::get_num_interop_threads() : "
      << at::get_num_interop_threads() << std::endl;
+  ss << "\tintra-op thread affinity : "
+     << at::intraop_thread_affinity().spec() << std::endl;
+  ss << "\tinter-op thread affinity : "
+     << at::interop_thread_affinity().spec() << std::endl;
+  ss << "\tintra-op spin time (us) : "
+     << at::get_intraop_spin_time_us() << std::endl;
 
   ss << at::get_openmp_version() << std::endl;
 #ifdef _OPENMP
@@ -70,6 +82,12 @@ std::string get_parallel_info() {
      << get_env_var("OMP_NUM_THREADS", "[not set]") << std::endl;
   ss << "\tMKL_NUM_THREADS : "
      << get_env_var("MKL_NUM_THREADS", "[not set]") << std::endl;
+  ss << "\tPYTORCH_INTRAOP_AFFINITY : "
+     << get_env_var("PYTORCH_INTRAOP_AFFINITY", "[not set]") << std::endl;
+  ss << "\tPYTORCH_INTEROP_AFFINITY : "
+     << get_env_var("PYTORCH_INTEROP_AFFINITY", "[not set]") << std::endl;
+  ss << "\tPYTORCH_INTRAOP_SPIN_US : "
+     << get_env_var("PYTORCH_INTRAOP_SPIN_US", "[not set]") << std::endl;
 
   ss << "ATen parallel backend: ";
   #if AT_PARALLEL_OPENMP
@@ -78,6 +96,8 @@ std::string get_parallel_info() {
   ss << "native thread pool";
   #elif AT_PARALLEL_NATIVE_TBB
   ss << "native thread pool and TBB";
+  #elif AT_PARALLEL_WORK_STEALING
+  ss << "work-stealing thread pool";
   #endif
   #ifdef C10_MOBILE
   ss << " [mobile]";
@@ -107,4 +127,53 @@ int intraop_default_num_threads() {
 #endif
 }
 
+void set_intraop_thread_budget(int budget) {
+  TORCH_CHECK(budget >= 0, "Expected a non-negative intra-op thread budget, but got ", budget);
+  intraop_thread_budget_ = budget;
+}
+
+int get_intraop_thread_budget() {
+  return intraop_thread_budget_;
+}
+
+#if !AT_PARALLEL_NATIVE && !AT_PARALLEL_WORK_STEALING
+// OpenMP and TBB threads wait for work on their own terms
+void set_intraop_spin_time_us(int64_t us) {
+  TORCH_CHECK(us >= 0, "Expected a non-negative spin time, but got ", us);
+}
+
+int64_t get_intraop_spin_time_us() {
+  return 0;
+}
+
+IntraOpWakeupStats get_intraop_wakeup_stats() {
+  return IntraOpWakeupStats();
+}
+#endif
+
+namespace internal {
+
+int intraop_num_threads() {
+  int nthreads = get_num_threads();
+  if (intraop_thread_budget_ > 0) {
+    nthreads = std::min(nthreads, intraop_thread_budget_);
+  }
+  return nthreads;
+}
+
+int64_t intraop_default_spin_time_us() {
+  try {
+    if (auto* value = std::getenv("PYTORCH_INTRAOP_SPIN_US")) {
+      int64_t us = c10::stoll(value);
+      TORCH_CHECK(us >= 0);
+      return us;
+    }
+  } catch (const std::exception& e) {
+    TORCH_WARN("Invalid PYTORCH_INTRAOP_SPIN_US variable value, ", e.what());
+  }
+  return DEFAULT_INTRAOP_SPIN_TIME_US;
+}
+
+} // namespace internal
+
 } // namespace at
@@ -40,6 +40,9 @@ void _unset_thread_num() {
   thread_num_ = 0;
 }
 
+// time idle intra-op threads spin before sleeping
+std::atomic<int64_t> intraop_spin_time_us{internal::intraop_default_spin_time_us()};
+
 #ifndef C10_MOBILE
 
 const int NOT_SET = -1;
@@ -65,13 +68,20 @@ int _num_pool_threads(int nthreads) {
   return nthreads - 1;
 }
 
-TaskThreadPoolBase& _get_intraop_pool() {
-  static std::shared_ptr<TaskThreadPoolBase> pool =
-      ThreadPoolRegistry()->Create(
-          "C10",
-          /* device_id */ 0,
-          /* pool_size */ _num_pool_threads(num_intraop_threads.exchange(CONSUMED)),
-          /* create_new */ true); // create a separate thread pool for intra-op
+// A separate thread pool for intra-op. It is created directly rather than
+// through ThreadPoolRegistry, so that the spin time of its threads can be set.
+PTThreadPool& _get_intraop_pool() {
+  static std::shared_ptr<PTThreadPool> pool = []() {
+    // CPU 0 of the affinity policy is left to the thread that starts parallel
+    // regions
+    auto pool = std::make_shared<PTThreadPool>(
+        _num_pool_threads(num_intraop_threads.exchange(CONSUMED)),
+        -1,
+        intraop_thread_affinity(),
+        /* first_thread_index */ 1);
+    pool->setSpinTime(intraop_spin_time_us);
+    return pool;
+  }();
   return *pool;
 }
 
@@ -249,6 +259,31 @@ void intraop_launch(std::function<void()> func) {
 #endif // C10_MOBILE
 }
 
+void set_intraop_spin_time_us(int64_t us) {
+  TORCH_CHECK(us >= 0, "Expected a non-negative spin time, but got ", us);
+  intraop_spin_time_us = us;
+#ifndef C10_MOBILE
+  if (num_intraop_threads.load() == CONSUMED) {
+    _get_intraop_pool().setSpinTime(us);
+  }
+#endif // C10_MOBILE
+}
+
+int64_t get_intraop_spin_time_us() {
+  return intraop_spin_time_us;
+}
+
+IntraOpWakeupStats get_intraop_wakeup_stats() {
+  IntraOpWakeupStats stats;
+#ifndef C10_MOBILE
+  if (num_intraop_threads.load() == CONSUMED) {
+    stats.spin_hits = _get_intraop_pool().numSpinHits();
+    stats.parks = _get_intraop_pool().numParks();
+  }
+#endif // C10_MOBILE
+  return stats;
+}
+
 std::shared_ptr<c10::ivalue::Future> intraop_launch_future(
     std::function<void()> func) {
 #ifndef C10_MOBILE
@@ -15,7 +15,7 @@ inline std::tuple<size_t, size_t> calc_num_tasks_and_chunk_size(
     return std::make_tuple(1, std::max((int64_t)0, end - begin));
   }
   // Choose number of tasks based on grain size and number of threads.
-  size_t chunk_size = divup((end - begin), get_num_threads());
+  size_t chunk_size = divup((end - begin), intraop_num_threads());
   // Make sure each task is at least grain_size size.
   chunk_size = std::max((size_t)grain_size, chunk_size);
   size_t num_tasks = divup((end - begin), chunk_size);
@@ -3,6 +3,7 @@
 #include <ATen/PTThreadPool.h>
 
 #include <atomic>
+#include <memory>
 #include <mutex>
 
 #include "tbb/tbb.h"
@@ -84,6 +85,24 @@ void intraop_launch(std::function<void()> func) {
   }
 }
 
+namespace internal {
+
+tbb::task_arena* _intraop_budget_arena() {
+  const int nthreads = intraop_num_threads();
+  if (nthreads >= get_num_threads()) {
+    return nullptr;
+  }
+  // creating an arena is not free, so each thread keeps the one of its last
+  // budget
+  static thread_local std::unique_ptr<tbb::task_arena> arena_;
+  if (!arena_ || arena_->max_concurrency() != nthreads) {
+    arena_.reset(new tbb::task_arena(nthreads));
+  }
+  return arena_.get();
+}
+
+} // namespace internal
+
 std::shared_ptr<c10::ivalue::Future> intraop_launch_future(
     std::function<void()> func) {
   auto future = std::make_shared<c10::ivalue::Future>(NoneType::get());
@@ -12,6 +12,21 @@
 #define INTRA_OP_PARALLEL
 
 namespace at {
+namespace internal {
+
+// Arena of the calling thread limited to its intra-op thread budget, or
+// nullptr if the budget does not limit get_num_threads().
+CAFFE2_API tbb::task_arena* _intraop_budget_arena();
+
+template <typename F>
+inline auto _run_in_budget_arena(const F& fn) -> decltype(fn()) {
+  if (auto* arena = _intraop_budget_arena()) {
+    return arena->execute(fn);
+  }
+  return fn();
+}
+
+} // namespace internal
 
 template <class F>
 inline void parallel_for(
@@ -23,22 +38,24 @@ inline void parallel_for(
   if (begin >= end) {
     return;
   }
-  if ((end - begin) < grain_size || get_num_threads() == 1) {
+  if ((end - begin) < grain_size || internal::intraop_num_threads() == 1) {
     f(begin, end);
     return;
   }
   std::atomic_flag err_flag = ATOMIC_FLAG_INIT;
   std::exception_ptr eptr;
-  tbb::parallel_for(tbb::blocked_range<int64_t>(begin, end, grain_size),
-    [&eptr, &err_flag, f](const tbb::blocked_range<int64_t>& r) {
-      try {
-        f(r.begin(), r.end());
-      } catch (...) {
-        if (!err_flag.test_and_set()) {
-          eptr = std::current_exception();
+  internal::_run_in_budget_arena([&]() {
+    tbb::parallel_for(tbb::blocked_range<int64_t>(begin, end, grain_size),
+      [&eptr, &err_flag, f](const tbb::blocked_range<int64_t>& r) {
+        try {
+          f(r.begin(), r.end());
+        } catch (...) {
+          if (!err_flag.test_and_set()) {
+            eptr = std::current_exception();
+          }
         }
-      }
-    });
+      });
+  });
   if (eptr) {
     std::rethrow_exception(eptr);
   }
@@ -56,27 +73,29 @@ inline scalar_t parallel_reduce(
   if (begin >= end) {
     return ident;
   }
-  if ((end - begin) < grain_size || get_num_threads() == 1) {
+  if ((end - begin) < grain_size || internal::intraop_num_threads() == 1) {
     return f(begin, end, ident);
   }
   scalar_t result;
   std::atomic_flag err_flag = ATOMIC_FLAG_INIT;
   std::exception_ptr eptr;
-  result = tbb::parallel_reduce(
-    tbb::blocked_range<int64_t>(begin, end, grain_size), ident,
-    [&eptr, &err_flag, f, ident]
-        (const tbb::blocked_range<int64_t>& r, scalar_t ident) {
-      try {
-        return f(r.begin(), r.end(), ident);
-      } catch (...) {
-        if (!err_flag.test_and_set()) {
-          eptr = std::current_exception();
+  result = internal::_run_in_budget_arena([&]() {
+    return tbb::parallel_reduce(
+      tbb::blocked_range<int64_t>(begin, end, grain_size), ident,
+      [&eptr, &err_flag, f, ident]
+          (const tbb::blocked_range<int64_t>& r, scalar_t ident) {
+        try {
+          return f(r.begin(), r.end(), ident);
+        } catch (...) {
+          if (!err_flag.test_and_set()) {
+            eptr = std::current_exception();
+          }
+          return ident;
         }
-        return ident;
-      }
-    },
-    sf
-  );
+      },
+      sf
+    );
+  });
   if (eptr) {
     std::rethrow_exception(eptr);
   }
@@ -85,7 +104,9 @@ inline scalar_t parallel_reduce(
 
 template<typename F0, typename F1>
 void intraop_invoke(const F0& f0, const F1& f1) {
-  tbb::parallel_invoke(f0, f1);
+  internal::_run_in_budget_arena([&]() {
+    tbb::parallel_invoke(f0, f1);
+  });
 }
 
 } // namespace at
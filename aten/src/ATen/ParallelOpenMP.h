@@ -27,6 +27,9 @@ inline void parallel_for(
   std::exception_ptr eptr;
   // choose number of tasks based on grain size and number of threads
   int64_t num_threads = omp_in_parallel() ? 1 : omp_get_max_threads();
+  if (get_intraop_thread_budget() > 0) {
+    num_threads = std::min(num_threads, (int64_t)get_intraop_thread_budget());
+  }
   if (grain_size > 0) {
     num_threads = std::min(num_threads, divup((end - begin), grain_size));
   }
@@ -66,7 +69,7 @@ inline scalar_t parallel_reduce(
   TORCH_CHECK(grain_size >= 0);
   if (begin >= end) {
     return ident;
-  } else if (in_parallel_region() || get_num_threads() == 1) {
+  } else if (in_parallel_region() || internal::intraop_num_threads() == 1) {
     return f(begin, end, ident);
   } else {
     const int64_t num_results = divup((end - begin), grain_size);
@@ -74,7 +77,7 @@ inline scalar_t parallel_reduce(
     scalar_t* results_data = results.data();
     std::atomic_flag err_flag = ATOMIC_FLAG_INIT;
     std::exception_ptr eptr;
-#pragma omp parallel for if ((end - begin) >= grain_size)
+#pragma omp parallel for if ((end - begin) >= grain_size) num_threads(internal::intraop_num_threads())
     for (int64_t id = 0; id < num_results; id++) {
       int64_t i = begin + id * grain_size;
       try {
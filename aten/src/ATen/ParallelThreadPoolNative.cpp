@@ -1,4 +1,4 @@
-#if AT_PARALLEL_OPENMP || AT_PARALLEL_NATIVE || AT_PARALLEL_NATIVE_TBB
+#if AT_PARALLEL_OPENMP || AT_PARALLEL_NATIVE || AT_PARALLEL_NATIVE_TBB || AT_PARALLEL_WORK_STEALING
 #include <ATen/Parallel.h>
 #include <ATen/PTThreadPool.h>
 #include <ATen/ThreadLocalDebugInfo.h>
@@ -21,12 +21,18 @@ std::atomic<int> num_interop_threads{NOT_SET};
 // thread pool global instance is hidden,
 // users should use at::launch and get/set_num_interop_threads interface
 TaskThreadPoolBase& get_pool() {
-  static std::shared_ptr<TaskThreadPoolBase> pool =
-      ThreadPoolRegistry()->Create(
-          "C10",
-          /* device_id */ 0,
-          /* pool_size */ num_interop_threads.exchange(CONSUMED),
-          /* create_new */ true);
+  static std::shared_ptr<TaskThreadPoolBase> pool = []() {
+    const int pool_size = num_interop_threads.exchange(CONSUMED);
+    if (interop_thread_affinity().enabled()) {
+      return std::shared_ptr<TaskThreadPoolBase>(
+          std::make_shared<PTThreadPool>(pool_size, -1, interop_thread_affinity()));
+    }
+    return ThreadPoolRegistry()->Create(
+        "C10",
+        /* device_id */ 0,
+        /* pool_size */ pool_size,
+        /* create_new */ true);
+  }();
   return *pool;
 }
 
@@ -69,12 +75,15 @@ int get_num_interop_threads() {
 
 void launch(std::function<void()> func) {
   auto fn = std::bind([](
-    std::function<void()> f, std::shared_ptr<ThreadLocalDebugInfoBase> info) {
+    std::function<void()> f, std::shared_ptr<ThreadLocalDebugInfoBase> info,
+    int intraop_thread_budget) {
       DebugInfoGuard guard(std::move(info));
+      IntraOpThreadBudgetGuard budget_guard(intraop_thread_budget);
       f();
     },
     std::move(func),
-    getThreadLocalDebugInfo()
+    getThreadLocalDebugInfo(),
+    get_intraop_thread_budget()
   );
 
 #if AT_EXPERIMENTAL_SINGLE_THREAD_POOL
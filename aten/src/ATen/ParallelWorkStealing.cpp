@@ -0,0 +1,537 @@
+#if AT_PARALLEL_WORK_STEALING
+#include <ATen/Parallel.h>
+#include <ATen/ThreadAffinity.h>
+
+#include <c10/util/thread_name.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <limits>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#ifdef TH_BLAS_MKL
+#include <mkl.h>
+#endif
+
+namespace at {
+namespace {
+// used with _set_in_parallel_region to mark master thread
+// as in parallel region while executing parallel primitives
+thread_local bool in_parallel_region_ = false;
+
+// thread number set by parallel primitive: 0 for the thread that started
+// the parallel region, and the slot of the worker in the region for pool
+// threads
+thread_local size_t thread_num_ = 0;
+
+// true for the threads of the intra-op pool
+thread_local bool in_pool_thread_ = false;
+
+// RAII guard helps to support in_parallel_region() and get_thread_num() API.
+struct ParallelRegionGuard {
+  ParallelRegionGuard(size_t thread_num) {
+    thread_num_ = thread_num;
+    in_parallel_region_ = true;
+  }
+
+  ~ParallelRegionGuard() {
+    in_parallel_region_ = false;
+    thread_num_ = 0;
+  }
+};
+
+const int NOT_SET = -1;
+const int CONSUMED = -2;
+
+// Number of threads set by the user
+// NOT_SET -> positive value -> CONSUMED
+// or
+// NOT_SET -> CONSUMED
+// Meaning:
+//  - NOT_SET - pool not initialized, user value is not set
+//  - positive value - pool not initialized, user value set
+//  - CONSUMED - pool is initialized
+std::atomic<int> num_intraop_threads{NOT_SET};
+
+// time idle workers spin before sleeping
+std::atomic<int64_t> intraop_spin_time_us{internal::intraop_default_spin_time_us()};
+
+// A range [lo, hi) of task ids, packed so that deque slots can be atomic.
+inline uint64_t pack_range(uint32_t lo, uint32_t hi) {
+  return (static_cast<uint64_t>(hi) << 32) | lo;
+}
+
+inline void unpack_range(uint64_t range, uint32_t& lo, uint32_t& hi) {
+  lo = static_cast<uint32_t>(range);
+  hi = static_cast<uint32_t>(range >> 32);
+}
+
+// Chase-Lev work-stealing deque of task ranges, with the memory orders of
+// Le et al., "Correct and Efficient Work-Stealing for Weak Memory Models"
+// (PPoPP 2013). The owner pushes and pops at the bottom, other threads steal
+// from the top. Ranges are split in halves, so the owner never holds more
+// than log2(number of tasks) of them and the buffer does not need to grow;
+// push() fails when it is full and the owner then runs the range itself.
+struct RangeDeque {
+  static constexpr int64_t kCapacity = 64;
+
+  bool push(uint64_t range) {
+    const int64_t b = bottom_.load(std::memory_order_relaxed);
+    const int64_t t = top_.load(std::memory_order_acquire);
+    if (b - t >= kCapacity) {
+      return false;
+    }
+    buffer_[b % kCapacity].store(range, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    bottom_.store(b + 1, std::memory_order_relaxed);
+    return true;
+  }
+
+  bool pop(uint64_t& range) {
+    const int64_t b = bottom_.load(std::memory_order_relaxed) - 1;
+    bottom_.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t t = top_.load(std::memory_order_relaxed);
+    if (t > b) {
+      // empty
+      bottom_.store(b + 1, std::memory_order_relaxed);
+      return false;
+    }
+    range = buffer_[b % kCapacity].load(std::memory_order_relaxed);
+    if (t < b) {
+      return true;
+    }
+    // last range: race against thieves
+    const bool won = top_.compare_exchange_strong(
+        t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+    bottom_.store(b + 1, std::memory_order_relaxed);
+    return won;
+  }
+
+  bool steal(uint64_t& range) {
+    int64_t t = top_.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const int64_t b = bottom_.load(std::memory_order_acquire);
+    if (t >= b) {
+      return false;
+    }
+    range = buffer_[t % kCapacity].load(std::memory_order_relaxed);
+    return top_.compare_exchange_strong(
+        t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+  }
+
+ private:
+  // padded, since thieves write top_ and the owner bottom_; alignas would
+  // not be honored by new[] before C++17
+  std::atomic<int64_t> top_{0};
+  char top_padding_[64];
+  std::atomic<int64_t> bottom_{0};
+  char bottom_padding_[64];
+  std::atomic<uint64_t> buffer_[kCapacity];
+  char buffer_padding_[64];
+};
+
+// One parallel region: num_tasks calls of run_task, shared out between the
+// deques of at most max_participants threads.
+struct Job {
+  Job(size_t max_participants, size_t num_tasks, const std::function<void(size_t)>& run_task)
+      : max_participants(max_participants),
+        num_tasks(num_tasks),
+        deques(new RangeDeque[max_participants]),
+        remaining(num_tasks),
+        run_task(run_task) {}
+
+  void run(size_t task_id) {
+    try {
+      run_task(task_id);
+    } catch (...) {
+      if (!err_flag.test_and_set()) {
+        eptr = std::current_exception();
+      }
+    }
+  }
+
+  const size_t max_participants;
+  const size_t num_tasks;
+  std::unique_ptr<RangeDeque[]> deques;
+  // participants so far, including the thread that started the job; guarded
+  // by the mutex of the pool
+  size_t num_participants = 1;
+  // tasks that have not finished yet
+  std::atomic<size_t> remaining;
+  // refers to the caller of _parallel_run, which waits until remaining is 0
+  const std::function<void(size_t)>& run_task;
+  std::atomic_flag err_flag = ATOMIC_FLAG_INIT;
+  std::exception_ptr eptr;
+};
+
+// Runs a range of tasks of the job in slot `slot`. The upper halves of the
+// range go to the deque of the slot, where idle threads can steal them, so a
+// range is only cut into smaller pieces when other threads run out of work;
+// the participant keeps the lowest task and pops the rest back in order.
+void run_range(Job& job, size_t slot, uint64_t range) {
+  RangeDeque& deque = job.deques[slot];
+  uint32_t lo, hi;
+  unpack_range(range, lo, hi);
+  while (true) {
+    while (hi - lo > 1) {
+      const uint32_t mid = lo + (hi - lo) / 2;
+      if (!deque.push(pack_range(mid, hi))) {
+        break;
+      }
+      hi = mid;
+    }
+    for (uint32_t task_id = lo; task_id < hi; task_id++) {
+      job.run(task_id);
+    }
+    job.remaining.fetch_sub(hi - lo, std::memory_order_acq_rel);
+    if (!deque.pop(range)) {
+      return;
+    }
+    unpack_range(range, lo, hi);
+  }
+}
+
+// Slot 0 is the thread that started the job and holds all its tasks at
+// first; it stays until every task has finished. Workers steal until there
+// is nothing left to steal, and leave early if another job could use them.
+void participate(Job& job, size_t slot, const std::atomic<size_t>& num_jobs) {
+  ParallelRegionGuard guard(slot);
+  if (slot == 0) {
+    run_range(job, slot, pack_range(0, static_cast<uint32_t>(job.num_tasks)));
+  }
+  while (job.remaining.load(std::memory_order_acquire) > 0) {
+    uint64_t range;
+    bool found = false;
+    for (size_t i = 1; i < job.max_participants && !found; i++) {
+      found = job.deques[(slot + i) % job.max_participants].steal(range);
+    }
+    if (found) {
+      run_range(job, slot, range);
+    } else if (slot != 0 && num_jobs.load(std::memory_order_relaxed) > 1) {
+      return;
+    } else {
+      std::this_thread::yield();
+    }
+  }
+}
+
+// Intra-op thread pool of the work-stealing backend. A parallel region is
+// run by the thread that starts it together with idle workers, up to the
+// intra-op thread budget of the starting thread. Regions started by
+// different threads (e.g., inter-op tasks) run concurrently, and idle
+// workers join the region with the fewest participants, so the workers are
+// shared out between them. Tasks from intraop_launch go through a regular
+// queue. Idle workers spin for intraop_spin_time_us before they sleep.
+class WorkStealingPool {
+ public:
+  explicit WorkStealingPool(size_t pool_size) {
+    for (size_t i = 0; i < pool_size; i++) {
+      threads_.emplace_back([this, i]() { main_loop(i + 1); });
+    }
+  }
+
+  ~WorkStealingPool() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+      epoch_++;
+    }
+    cv_.notify_all();
+    for (auto& thread : threads_) {
+      try {
+        thread.join();
+      } catch (const std::exception&) {
+      }
+    }
+  }
+
+  size_t size() const {
+    return threads_.size();
+  }
+
+  // Runs the tasks on the calling thread and at most max_threads - 1 workers.
+  void run(size_t num_tasks, size_t max_threads, const std::function<void(size_t)>& run_task) {
+    max_threads = std::max<size_t>(1, std::min(max_threads, threads_.size() + 1));
+    auto job = std::make_shared<Job>(max_threads, num_tasks, run_task);
+    if (max_threads > 1) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      jobs_.push_back(job);
+      num_jobs_++;
+      epoch_++;
+      if (parked_ > 0) {
+        cv_.notify_all();
+      }
+    }
+    participate(*job, 0, num_jobs_);
+    if (max_threads > 1) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      jobs_.erase(std::find(jobs_.begin(), jobs_.end(), job));
+      num_jobs_--;
+    }
+    if (job->eptr) {
+      std::rethrow_exception(job->eptr);
+    }
+  }
+
+  void launch(std::function<void()> func) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    tasks_.push_back(std::move(func));
+    epoch_++;
+    if (parked_ > 0) {
+      cv_.notify_one();
+    }
+  }
+
+  IntraOpWakeupStats wakeup_stats() const {
+    IntraOpWakeupStats stats;
+    stats.spin_hits = spin_hits_;
+    stats.parks = parks_;
+    return stats;
+  }
+
+ private:
+  // the job with a free slot and the fewest participants, if any; must be
+  // called with mutex_ held
+  std::shared_ptr<Job> joinable_job() {
+    std::shared_ptr<Job> best;
+    for (const auto& job : jobs_) {
+      if (job->num_participants < job->max_participants &&
+          job->remaining.load(std::memory_order_relaxed) > 0 &&
+          (!best || job->num_participants < best->num_participants)) {
+        best = job;
+      }
+    }
+    return best;
+  }
+
+  // Spins until epoch_ changes or the spin time has passed. Returns whether
+  // epoch_ changed.
+  bool spin_for_work(uint64_t epoch) {
+    const auto spin_time = std::chrono::microseconds(
+        intraop_spin_time_us.load(std::memory_order_relaxed));
+    const auto start = std::chrono::steady_clock::now();
+    while (epoch_.load(std::memory_order_acquire) == epoch) {
+      if (std::chrono::steady_clock::now() - start >= spin_time) {
+        return false;
+      }
+      std::this_thread::yield();
+    }
+    return true;
+  }
+
+  void main_loop(size_t index) {
+    c10::setThreadName("PTWorkStealing");
+    // CPU 0 of the policy is left to the thread that starts parallel regions
+    intraop_thread_affinity().pin_current_thread(index);
+    in_pool_thread_ = true;
+    init_num_threads();
+    while (true) {
+      std::shared_ptr<Job> job;
+      size_t slot = 0;
+      std::function<void()> task;
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        auto ready = [&]() {
+          job = joinable_job();
+          return stop_ || job || !tasks_.empty();
+        };
+        if (!ready() && intraop_spin_time_us.load(std::memory_order_relaxed) > 0) {
+          // Spin for a while before sleeping, so that a parallel region
+          // started soon after does not need a wakeup.
+          const uint64_t epoch = epoch_.load(std::memory_order_relaxed);
+          lock.unlock();
+          const bool woken = spin_for_work(epoch);
+          lock.lock();
+          if (woken && ready()) {
+            spin_hits_++;
+          }
+        }
+        if (!ready()) {
+          parks_++;
+          parked_++;
+          cv_.wait(lock, ready);
+          parked_--;
+        }
+        if (job) {
+          slot = job->num_participants++;
+        } else if (!tasks_.empty()) {
+          task = std::move(tasks_.front());
+          tasks_.pop_front();
+        } else {
+          return;
+        }
+      }
+      if (job) {
+        participate(*job, slot, num_jobs_);
+      } else {
+        try {
+          task();
+        } catch (const std::exception&) {
+        }
+      }
+    }
+  }
+
+  std::vector<std::thread> threads_;
+  std::atomic<size_t> num_jobs_{0};
+  // incremented for every new job or task, so that spinning workers see it
+  std::atomic<uint64_t> epoch_{0};
+  std::atomic<int64_t> spin_hits_{0};
+  std::atomic<int64_t> parks_{0};
+  // guards the members below and Job::num_participants
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::vector<std::shared_ptr<Job>> jobs_;
+  std::deque<std::function<void()>> tasks_;
+  // workers waiting on cv_
+  size_t parked_ = 0;
+  bool stop_ = false;
+};
+
+WorkStealingPool& _get_intraop_pool() {
+  static WorkStealingPool pool([]() {
+    int nthreads = num_intraop_threads.exchange(CONSUMED);
+    if (nthreads == NOT_SET) {
+      nthreads = intraop_default_num_threads();
+    } else {
+      TORCH_INTERNAL_ASSERT(nthreads > 0);
+    }
+    // minus one because of the master thread
+    return static_cast<size_t>(nthreads - 1);
+  }());
+  return pool;
+}
+
+} // namespace
+
+namespace internal {
+
+void _parallel_run(
+  const int64_t begin,
+  const int64_t end,
+  const int64_t grain_size,
+  const std::function<void(int64_t, int64_t, size_t)>& f) {
+  size_t num_tasks, chunk_size;
+  std::tie(num_tasks, chunk_size) =
+      internal::calc_num_tasks_and_chunk_size(begin, end, grain_size);
+  TORCH_INTERNAL_ASSERT(num_tasks <= std::numeric_limits<uint32_t>::max());
+
+  std::function<void(size_t)> run_task = [&f, begin, end, chunk_size](size_t task_id) {
+    int64_t local_start = begin + task_id * chunk_size;
+    if (local_start < end) {
+      int64_t local_end = std::min(end, (int64_t)(chunk_size + local_start));
+      f(local_start, local_end, task_id);
+    }
+  };
+  _get_intraop_pool().run(num_tasks, intraop_num_threads(), run_task);
+}
+
+} // namespace internal
+
+void init_num_threads() {
+#ifdef _OPENMP
+  omp_set_num_threads(1);
+#endif
+
+#ifdef TH_BLAS_MKL
+  mkl_set_num_threads(1);
+#endif
+}
+
+void set_num_threads(int nthreads) {
+  TORCH_CHECK(nthreads > 0, "Expected positive number of threads");
+  int no_value = NOT_SET;
+  if (!num_intraop_threads.compare_exchange_strong(no_value, nthreads)) {
+    // num_intraop_threads either stores a positive integer or CONSUMED,
+    // check that requested size is the same as the current one
+    int stored_nthreads = num_intraop_threads.load();
+    if (stored_nthreads <= 0) {
+      // plus one because of master thread
+      stored_nthreads = _get_intraop_pool().size() + 1;
+    }
+    if (stored_nthreads != nthreads) {
+      TORCH_WARN(
+        "Cannot set number of intraop threads "
+        "after parallel work has started or after set_num_threads call "
+        "when using work-stealing parallel backend");
+    }
+  }
+}
+
+int get_num_threads() {
+  // not initializing pool unnecessarily,
+  // because pool cannot be resized after initialization
+  int nthreads = num_intraop_threads.load();
+  if (nthreads > 0) {
+    return nthreads;
+  } else if (nthreads == NOT_SET) {
+    return intraop_default_num_threads();
+  } else {
+    TORCH_INTERNAL_ASSERT(nthreads == CONSUMED);
+    return _get_intraop_pool().size() + 1;
+  }
+}
+
+int get_thread_num() {
+  return thread_num_;
+}
+
+bool in_parallel_region() {
+  // pool threads also count when running tasks from intraop_launch()
+  return in_parallel_region_ || in_pool_thread_;
+}
+
+void intraop_launch(std::function<void()> func) {
+  if (!in_parallel_region() && get_num_threads() > 1) {
+    _get_intraop_pool().launch(std::move(func));
+  } else {
+    // execute inline if we're in parallel region
+    func();
+  }
+}
+
+void set_intraop_spin_time_us(int64_t us) {
+  TORCH_CHECK(us >= 0, "Expected a non-negative spin time, but got ", us);
+  intraop_spin_time_us = us;
+}
+
+int64_t get_intraop_spin_time_us() {
+  return intraop_spin_time_us;
+}
+
+IntraOpWakeupStats get_intraop_wakeup_stats() {
+  if (num_intraop_threads.load() != CONSUMED) {
+    return IntraOpWakeupStats();
+  }
+  return _get_intraop_pool().wakeup_stats();
+}
+
+std::shared_ptr<c10::ivalue::Future> intraop_launch_future(
+    std::function<void()> func) {
+  auto future = std::make_shared<c10::ivalue::Future>(c10::NoneType::get());
+  if (!in_parallel_region() && get_num_threads() > 1) {
+    _get_intraop_pool().launch(
+      [func, future]() {
+        func();
+        future->markCompleted();
+      }
+    );
+  } else {
+    func();
+    future->markCompleted();
+  }
+  return future;
+}
+
+} // namespace at
+#endif
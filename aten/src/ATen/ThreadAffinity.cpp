@@ -0,0 +1,102 @@
+#include <ATen/ThreadAffinity.h>
+
+#include <c10/util/Exception.h>
+#include <c10/util/StringUtil.h>
+#include <c10/util/numa.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <map>
+#include <sstream>
+
+namespace at {
+
+namespace {
+
+// "0-3,8" -> {0, 1, 2, 3, 8}
+std::vector<int> parse_cpu_list(const std::string& spec) {
+  std::vector<int> cpus;
+  std::stringstream ss(spec);
+  std::string item;
+  while (std::getline(ss, item, ',')) {
+    const auto dash = item.find('-');
+    const int first = c10::stoi(item.substr(0, dash));
+    const int last = dash == std::string::npos ? first : c10::stoi(item.substr(dash + 1));
+    TORCH_CHECK(first >= 0 && first <= last, "invalid CPU range ", item);
+    for (int cpu = first; cpu <= last; cpu++) {
+      cpus.push_back(cpu);
+    }
+  }
+  return cpus;
+}
+
+ThreadAffinity affinity_from_env(const char* var_name) {
+  if (const char* value = std::getenv(var_name)) {
+    try {
+      return ThreadAffinity::parse(value);
+    } catch (const std::exception& e) {
+      TORCH_WARN("Invalid ", var_name, " variable value, ", e.what());
+    }
+  }
+  return ThreadAffinity();
+}
+
+} // namespace
+
+ThreadAffinity ThreadAffinity::parse(const std::string& spec) {
+  ThreadAffinity affinity;
+  if (spec.empty() || spec == "none") {
+    return affinity;
+  }
+  affinity.spec_ = spec;
+  if (spec == "compact" || spec == "scatter") {
+    // CPUs of unknown nodes count as node 0
+    std::map<int, std::vector<int>> cpus_of_node;
+    for (int cpu : c10::GetAvailableCPUs()) {
+      cpus_of_node[std::max(0, c10::GetNUMANodeOfCPU(cpu))].push_back(cpu);
+    }
+    if (spec == "compact") {
+      for (const auto& node : cpus_of_node) {
+        affinity.cpus_.insert(affinity.cpus_.end(), node.second.begin(), node.second.end());
+      }
+    } else {
+      size_t max_cpus_per_node = 0;
+      for (const auto& node : cpus_of_node) {
+        max_cpus_per_node = std::max(max_cpus_per_node, node.second.size());
+      }
+      // the i-th CPU of every node before the (i + 1)-th of any
+      for (size_t i = 0; i < max_cpus_per_node; i++) {
+        for (const auto& node : cpus_of_node) {
+          if (i < node.second.size()) {
+            affinity.cpus_.push_back(node.second[i]);
+          }
+        }
+      }
+    }
+  } else {
+    affinity.cpus_ = parse_cpu_list(spec);
+  }
+  TORCH_CHECK(affinity.enabled(), "no CPUs for thread affinity ", spec);
+  return affinity;
+}
+
+void ThreadAffinity::pin_current_thread(size_t index) const {
+  if (!enabled()) {
+    return;
+  }
+  if (!c10::PinCurrentThreadToCPU(cpu(index))) {
+    TORCH_WARN("Could not pin a thread to CPU ", cpu(index), " (thread affinity ", spec_, ")");
+  }
+}
+
+const ThreadAffinity& intraop_thread_affinity() {
+  static const ThreadAffinity affinity = affinity_from_env("PYTORCH_INTRAOP_AFFINITY");
+  return affinity;
+}
+
+const ThreadAffinity& interop_thread_affinity() {
+  static const ThreadAffinity affinity = affinity_from_env("PYTORCH_INTEROP_AFFINITY");
+  return affinity;
+}
+
+} // namespace at
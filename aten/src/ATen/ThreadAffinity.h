@@ -0,0 +1,56 @@
+#pragma once
+
+#include <c10/macros/Macros.h>
+
+#include <string>
+#include <vector>
+
+namespace at {
+
+/*
+* Where the threads of a thread pool run. Parsed from:
+*   "" or "none" - threads are not pinned (default)
+*   "compact"    - thread i runs on the i-th CPU the process may use, filling
+*                  one NUMA node before the next
+*   "scatter"    - threads are spread round robin over the NUMA nodes
+*   a CPU list   - e.g. "0-7,16,18": thread i runs on the i-th CPU of the list
+* With more threads than CPUs, the assignment wraps around. Pinned threads
+* keep their memory on the local NUMA node (see c10::PinCurrentThreadToCPU).
+*/
+class CAFFE2_API ThreadAffinity {
+ public:
+  ThreadAffinity() = default;
+
+  static ThreadAffinity parse(const std::string& spec);
+
+  bool enabled() const {
+    return !cpus_.empty();
+  }
+
+  // CPU of the index-th thread of the pool, or -1 if threads are not pinned
+  int cpu(size_t index) const {
+    return enabled() ? cpus_[index % cpus_.size()] : -1;
+  }
+
+  // Pins the calling thread as the index-th thread of the pool, if enabled.
+  void pin_current_thread(size_t index) const;
+
+  const std::string& spec() const {
+    return spec_;
+  }
+
+ private:
+  std::string spec_ = "none";
+  std::vector<int> cpus_;
+};
+
+// Affinity of the intra-op pool, from PYTORCH_INTRAOP_AFFINITY. The thread
+// that starts a parallel region is not pinned; worker i (from 1) gets the
+// i-th CPU, so that CPU 0 of the policy is left to the calling thread.
+// OpenMP threads are placed by OMP_PLACES and OMP_PROC_BIND instead.
+CAFFE2_API const ThreadAffinity& intraop_thread_affinity();
+
+// Affinity of the inter-op pool, from PYTORCH_INTEROP_AFFINITY.
+CAFFE2_API const ThreadAffinity& interop_thread_affinity();
+
+} // namespace at
@@ -74,18 +74,22 @@ void check_names_valid_for(int64_t tensor_dim, DimnameList names) {
 
 namespace impl {
 
+// The names are checked before NamesMode, which is a thread local, since
+// almost no tensor has them
 static NamedTensorMeta* get_named_tensor_meta(TensorImpl* impl) {
-  if (!NamesMode::is_enabled()) {
+  auto* meta = impl->named_tensor_meta();
+  if (meta == nullptr || !NamesMode::is_enabled()) {
     return nullptr;
   }
-  return static_cast<NamedTensorMeta*>(impl->named_tensor_meta());
+  return static_cast<NamedTensorMeta*>(meta);
 }
 
 static const NamedTensorMeta* get_named_tensor_meta(const TensorImpl* impl) {
-  if (!NamesMode::is_enabled()) {
+  const auto* meta = impl->named_tensor_meta();
+  if (meta == nullptr || !NamesMode::is_enabled()) {
     return nullptr;
   }
-  return static_cast<const NamedTensorMeta*>(impl->named_tensor_meta());
+  return static_cast<const NamedTensorMeta*>(meta);
 }
 
 void check_names_valid_for(TensorImpl* impl, DimnameList names) {
@@ -137,7 +141,7 @@ DimnameList get_names(const TensorImpl* impl) {
   return default_names(impl->dim());
 }
 
-bool has_names(const TensorImpl* impl) {
+bool has_names_slow(const TensorImpl* impl) {
   const auto* named_tensor_meta = get_named_tensor_meta(impl);
   return named_tensor_meta != nullptr && named_tensor_meta->has_names();
 }
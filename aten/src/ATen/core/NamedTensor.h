@@ -94,11 +94,22 @@ CAFFE2_API void internal_set_names_inplace(TensorImpl* impl, std::vector<Dimname
 
 void check_names_valid_for(TensorImpl* impl, DimnameList names);
 
+CAFFE2_API bool has_names_slow(const TensorImpl* impl);
+
 // Returns true if the tensor's names exist and are not all 'None'.
 // Returns false if the tensor's names don't exist (were not allocated),
 // or if all names are 'None'.
 // We treat not-allocated-names the same as allocated names that are all 'None'.
-CAFFE2_API bool has_names(const TensorImpl* impl);
+//
+// Every op checks its inputs with this, and almost no tensor has its names
+// allocated, so that case is an inlined pointer test, without the call nor
+// the read of the thread local NamesMode of the general case.
+inline bool has_names(const TensorImpl* impl) {
+  if (C10_LIKELY(impl->named_tensor_meta() == nullptr)) {
+    return false;
+  }
+  return has_names_slow(impl);
+}
 
 // Returns the names of the tensor's dimensions.
 // Unnamed tensors are treated as having 'None' in all dimension; this method
@@ -21,9 +21,13 @@ namespace impl {
 // TODO: I'm not sure if this should live in this header or not; the operant
 // question is whether or not we have access to all the relevant TLS at this
 // point.
-static inline TensorTypeId dispatchTypeId(TensorTypeSet ts) {
+//
+// The type ids in 'skipped' are left out as if they were excluded; the
+// dispatcher uses this to fall through past a type id (see
+// c10::backendFallthroughKernel).
+static inline TensorTypeId dispatchTypeId(TensorTypeSet ts, TensorTypeSet skipped = TensorTypeSet()) {
   c10::impl::LocalTensorTypeSet local = c10::impl::tls_local_tensor_type_set();
-  return ((ts | local.included_) - local.excluded_).highestPriorityTypeId();
+  return ((ts | local.included_) - (local.excluded_ | skipped)).highestPriorityTypeId();
 }
 
 }
@@ -68,7 +72,7 @@ public:
     return DispatchKeyExtractor(schema.arguments().size());
   }
 
-  c10::optional<TensorTypeId> getDispatchKeyBoxed(const Stack* stack) const {
+  c10::optional<TensorTypeId> getDispatchKeyBoxed(const Stack* stack, TensorTypeSet skipped = TensorTypeSet()) const {
     // TODO Unboxed dispatch supports TensorOptions (i.e. ScalarType/Device/Layout) arguments
     //      but boxed doesn't yet. These should be aligned and do the same thing.
 
@@ -88,23 +92,25 @@ public:
       return c10::nullopt;
     }
 
-    // TODO: Don't use legacy extractor; blocked on c10 understanding variable
-    return c10::legacyExtractTypeId(ts);
+    // TODO: Don't remove VariableTensorId; blocked on c10 understanding variable
+    // Honors the thread local included and excluded dispatch keys like the
+    // unboxed path, so that backend fallbacks can redispatch boxed.
+    return impl::dispatchTypeId(ts.remove(TensorTypeId::VariableTensorId), skipped);
   }
 
   template<class... Args>
-  c10::optional<TensorTypeId> getDispatchKeyUnboxed(const Args&... args) const {
+  c10::optional<TensorTypeId> getDispatchKeyUnboxed(TensorTypeSet skipped, const Args&... args) const {
     auto type_set = detail::multi_dispatch_tensor_type_set(args...);
-    return typeSetToDispatchKey_(type_set);
+    return typeSetToDispatchKey_(type_set, skipped);
   }
 
 private:
-  static c10::optional<TensorTypeId> typeSetToDispatchKey_(const TensorTypeSet& typeSet) {
+  static c10::optional<TensorTypeId> typeSetToDispatchKey_(const TensorTypeSet& typeSet, TensorTypeSet skipped) {
     if (C10_UNLIKELY(typeSet.empty())) {
       return c10::nullopt;
     }
 
-    return impl::dispatchTypeId(typeSet);
+    return impl::dispatchTypeId(typeSet, skipped);
   }
 
   explicit DispatchKeyExtractor(size_t num_args)
@@ -36,7 +36,27 @@ class DispatchTable final {
   : kernels_()
   , catchallKernel_(c10::nullopt)
   , dispatchKeyExtractor_(DispatchKeyExtractor::make(schema))
-  , operatorName_(toString(schema.operator_name())) {}
+  , operatorName_(toString(schema.operator_name())) {
+    updateKernelIndex_();
+  }
+
+  DispatchTable(const DispatchTable& rhs)
+  : kernels_(rhs.kernels_)
+  , catchallKernel_(rhs.catchallKernel_)
+  , dispatchKeyExtractor_(rhs.dispatchKeyExtractor_)
+  , operatorName_(rhs.operatorName_) {
+    // kernelIndex_ must point into our own kernels_
+    updateKernelIndex_();
+  }
+
+  DispatchTable& operator=(const DispatchTable& rhs) {
+    kernels_ = rhs.kernels_;
+    catchallKernel_ = rhs.catchallKernel_;
+    dispatchKeyExtractor_ = rhs.dispatchKeyExtractor_;
+    operatorName_ = rhs.operatorName_;
+    updateKernelIndex_();
+    return *this;
+  }
 
   /**
    * Register a kernel in the table at some dispatch key.
@@ -56,6 +76,7 @@ class DispatchTable final {
       emplaced.first->second = kernel;
       TORCH_WARN("Registered a kernel for operator ", operatorName_," with dispatch key ", toString(dispatchKey), " that overwrote a previously registered kernel with the same dispatch key for the same operator.");
     }
+    updateKernelIndex_();
   }
 
   /**
@@ -66,6 +87,7 @@ class DispatchTable final {
   void removeKernelIfExists(TensorTypeId dispatchKey) {
     auto num_removed = kernels_.erase(dispatchKey);
     TORCH_INTERNAL_ASSERT(num_removed <= 1); // This is not a multi-map
+    updateKernelIndex_();
   }
 
   /**
@@ -114,12 +136,7 @@ class DispatchTable final {
   }
 
   const KernelFunction* lookup(TensorTypeId dispatchKey) const {
-    auto found = kernels_.find(dispatchKey);
-    if (found != kernels_.end()) {
-      return &found->second;
-    } else {
-      return nullptr;
-    }
+    return kernelIndex_[static_cast<uint8_t>(dispatchKey)];
   }
 
   const KernelFunction* lookupCatchallKernel() const {
@@ -140,7 +157,19 @@ class DispatchTable final {
 
 private:
 
+  // Rebuilds kernelIndex_, which has to be done after every change of
+  // kernels_ since inserting into or erasing from it moves its elements.
+  void updateKernelIndex_() {
+    kernelIndex_.fill(nullptr);
+    for (const auto& kernel : kernels_) {
+      kernelIndex_[static_cast<uint8_t>(kernel.first)] = &kernel.second;
+    }
+  }
+
   ska::flat_hash_map<TensorTypeId, KernelFunction> kernels_;
+  // The kernels of kernels_ by dispatch key, so that the lookup on every
+  // operator call is an array access rather than a hash table lookup.
+  std::array<const KernelFunction*, static_cast<uint8_t>(TensorTypeId::NumTensorIds)> kernelIndex_;
   c10::optional<KernelFunction> catchallKernel_;
   DispatchKeyExtractor dispatchKeyExtractor_;
   std::string operatorName_;
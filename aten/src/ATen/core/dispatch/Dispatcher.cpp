@@ -117,9 +117,16 @@ void Dispatcher::deregisterSchema_(const OperatorHandle& op, const OperatorName&
   }
 }
 
-RegistrationHandleRAII Dispatcher::registerBackendFallbackKernel(TensorTypeId dispatchKey, KernelFunction kernel) {
-  backendFallbackKernels_.write([&] (ska::flat_hash_map<TensorTypeId, KernelFunction>& backendFallbackKernels) {
-    auto inserted = backendFallbackKernels.emplace(dispatchKey, std::move(kernel));
+void backendFallthroughKernel(const OperatorHandle& op, Stack* /*stack*/) {
+  // The dispatcher skips the dispatch key instead of calling this.
+  TORCH_INTERNAL_ASSERT(false, "backendFallthroughKernel was called for ", op.schema().name(),
+      " but it is only a marker for the dispatcher.");
+}
+
+RegistrationHandleRAII Dispatcher::registerBackendFallbackKernel(TensorTypeId dispatchKey, BackendFallbackKernel* kernel) {
+  TORCH_INTERNAL_ASSERT(kernel != nullptr);
+  backendFallbackKernels_.write([&] (ska::flat_hash_map<TensorTypeId, BackendFallbackKernel*>& backendFallbackKernels) {
+    auto inserted = backendFallbackKernels.emplace(dispatchKey, kernel);
     TORCH_CHECK(inserted.second, "Tried to register a backend fallback kernel for ", dispatchKey, " but there was already one registered.");
   });
 
@@ -129,7 +136,7 @@ RegistrationHandleRAII Dispatcher::registerBackendFallbackKernel(TensorTypeId di
 }
 
 void Dispatcher::deregisterBackendFallbackKernel_(TensorTypeId dispatchKey) {
-  backendFallbackKernels_.write([&] (ska::flat_hash_map<TensorTypeId, KernelFunction>& backendFallbackKernels) {
+  backendFallbackKernels_.write([&] (ska::flat_hash_map<TensorTypeId, BackendFallbackKernel*>& backendFallbackKernels) {
     size_t numRemoved = backendFallbackKernels.erase(dispatchKey);
     TORCH_INTERNAL_ASSERT(1 == numRemoved, "Tried to deregister a backend fallback kernel for ", dispatchKey, " but there was none registered.");
   });
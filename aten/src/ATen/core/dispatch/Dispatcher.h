@@ -28,6 +28,24 @@ class RegistrationListenerList;
 }
 class SchemaRegistrationHandleRAII;
 
+/**
+ * A boxed kernel that can handle any operator, see
+ * Dispatcher::registerBackendFallbackKernel. It gets the operator that was
+ * called and a stack with its arguments, which it has to replace with the
+ * returns of the operator.
+ */
+using BackendFallbackKernel = void(const OperatorHandle& op, Stack* stack);
+
+/**
+ * Register this as the backend fallback kernel of a dispatch key to make the
+ * dispatcher fall through that key: operators without a concrete kernel for
+ * it are dispatched as if the key wasn't there. Unlike other backend
+ * fallbacks, this also works for unboxed-only operators, since the arguments
+ * don't have to be boxed. A mode that only wraps a few operators (e.g.
+ * autocast) can register kernels for those and fall through the rest.
+ */
+CAFFE2_API void backendFallthroughKernel(const OperatorHandle& op, Stack* stack);
+
 /**
  * Top-level dispatch interface for dispatching via the dynamic dispatcher.
  */
@@ -95,8 +113,16 @@ public:
    * If an operator is called but there is no concrete kernel for the dispatch
    * key of the given operator arguments, it will check if there is such a
    * fallback kernel for the given dispatch key and, if yes, call that one.
+   *
+   * One fallback handles every operator, so a wrapper (e.g. for profiling or
+   * logging) only needs one registration: it can look at op.schema(), and
+   * redispatch with callBoxed() after excluding its dispatch key with a
+   * c10::impl::ExcludeTensorTypeIdGuard. Operators whose kernels do not need
+   * the wrapper are not affected, since a concrete kernel for the dispatch key
+   * always takes precedence. Fallbacks are boxed and therefore not called for
+   * unboxed-only operators (see callUnboxedOnly()).
    */
-  RegistrationHandleRAII registerBackendFallbackKernel(TensorTypeId dispatch_key, KernelFunction kernel);
+  RegistrationHandleRAII registerBackendFallbackKernel(TensorTypeId dispatch_key, BackendFallbackKernel* kernel);
 
   template<class Return, class... Args>
   Return callUnboxed(const OperatorHandle& op, Args... args) const;
@@ -122,16 +148,17 @@ private:
   void deregisterSchema_(const OperatorHandle& op, const OperatorName& op_name);
   void deregisterBackendFallbackKernel_(TensorTypeId dispatchKey);
 
-  static const KernelFunction& dispatch_(const DispatchTable& dispatchTable, const ska::flat_hash_map<TensorTypeId, KernelFunction>& backendFallbackKernels, c10::optional<TensorTypeId> dispatch_key);
+  BackendFallbackKernel* lookupBackendFallbackKernel_(c10::optional<TensorTypeId> dispatch_key) const;
+  static const KernelFunction& dispatchCatchall_(const DispatchTable& dispatchTable, c10::optional<TensorTypeId> dispatch_key);
 
   template<class Return, class... Args>
-  Return doCallUnboxed(const DispatchTable& dispatchTable, const LeftRight<ska::flat_hash_map<TensorTypeId, KernelFunction>>& backendFallbackKernels_, Args... args) const;
+  Return doCallUnboxed(const OperatorHandle& op, const DispatchTable& dispatchTable, Args... args) const;
   template<class Return, class... Args>
-  Return doCallUnboxedOnly(const DispatchTable& dispatchTable, const LeftRight<ska::flat_hash_map<TensorTypeId, KernelFunction>>& backendFallbackKernels_, Args... args) const;
+  Return doCallUnboxedOnly(const DispatchTable& dispatchTable, Args... args) const;
 
   std::list<OperatorDef> operators_;
   LeftRight<ska::flat_hash_map<OperatorName, OperatorHandle>> operatorLookupTable_;
-  LeftRight<ska::flat_hash_map<TensorTypeId, KernelFunction>> backendFallbackKernels_;
+  LeftRight<ska::flat_hash_map<TensorTypeId, BackendFallbackKernel*>> backendFallbackKernels_;
   std::unique_ptr<detail::RegistrationListenerList> listeners_;
   std::mutex mutex_;
 };
@@ -166,6 +193,22 @@ private:
 
 namespace detail {
 template<class... Args> inline void unused_arg_(const Args&...) {}
+
+// Lets the boxing logic of KernelFunction call a backend fallback kernel,
+// which needs the operator on top of the stack.
+struct BackendFallbackFunctor final : OperatorKernel {
+  BackendFallbackFunctor(BackendFallbackKernel* kernel, const OperatorHandle& op)
+  : kernel_(kernel), op_(op) {}
+
+  static void call(OperatorKernel* functor, Stack* stack) {
+    auto* self = static_cast<BackendFallbackFunctor*>(functor);
+    (*self->kernel_)(self->op_, stack);
+  }
+
+private:
+  BackendFallbackKernel* kernel_;
+  const OperatorHandle& op_;
+};
 }
 
 template<class Return, class... Args>
@@ -176,18 +219,35 @@ inline Return Dispatcher::callUnboxed(const OperatorHandle& op, Args... args) co
   return op.operatorIterator_->op.readDispatchTable([&] (const DispatchTable& dispatchTable) -> Return {
     // TODO This should be a nested lambda instead of a separate function call, but that triggers an internal
     // compiler error on GCC5. Change this once we don't need gcc 5 anymore.
-    return doCallUnboxed<Return, Args...>(dispatchTable, backendFallbackKernels_, std::forward<Args>(args)...);
+    return doCallUnboxed<Return, Args...>(op, dispatchTable, std::forward<Args>(args)...);
   });
 }
 
 template<class Return, class... Args>
-inline Return Dispatcher::doCallUnboxed(const DispatchTable& dispatchTable, const LeftRight<ska::flat_hash_map<TensorTypeId, KernelFunction>>& backendFallbackKernels_, Args... args) const {
+inline Return Dispatcher::doCallUnboxed(const OperatorHandle& op, const DispatchTable& dispatchTable, Args... args) const {
   detail::unused_arg_(args...);  // workaround for a false-positive warning about unused parameters in gcc 5
-  return backendFallbackKernels_.read([&] (const ska::flat_hash_map<TensorTypeId, KernelFunction>& backendFallbackKernels) -> Return {
-    c10::optional<TensorTypeId> dispatchKey = dispatchTable.dispatchKeyExtractor().getDispatchKeyUnboxed(args...);
-    const KernelFunction& kernel = dispatch_(dispatchTable, backendFallbackKernels, dispatchKey);
-    return kernel.template callUnboxed<Return, Args...>(std::forward<Args>(args)...);
-  });
+  TensorTypeSet skipped;
+  while (true) {
+    c10::optional<TensorTypeId> dispatchKey = dispatchTable.dispatchKeyExtractor().getDispatchKeyUnboxed(skipped, args...);
+    // Fast path: an operator kernel for the dispatch key takes precedence over
+    // the backend fallbacks, so there is no need to read them.
+    if (C10_LIKELY(dispatchKey.has_value())) {
+      const KernelFunction* backendKernel = dispatchTable.lookup(*dispatchKey);
+      if (C10_LIKELY(nullptr != backendKernel)) {
+        return backendKernel->template callUnboxed<Return, Args...>(std::forward<Args>(args)...);
+      }
+    }
+    BackendFallbackKernel* backendFallbackKernel = lookupBackendFallbackKernel_(dispatchKey);
+    if (backendFallbackKernel == &backendFallthroughKernel) {
+      skipped = skipped.add(*dispatchKey);
+      continue;
+    }
+    if (nullptr != backendFallbackKernel) {
+      detail::BackendFallbackFunctor functor(backendFallbackKernel, op);
+      return c10::detail::boxAndCallBoxedFunc<Return, Args...>::call(&detail::BackendFallbackFunctor::call, &functor, std::forward<Args>(args)...);
+    }
+    return dispatchCatchall_(dispatchTable, dispatchKey).template callUnboxed<Return, Args...>(std::forward<Args>(args)...);
+  }
 }
 
 template<class Return, class... Args>
@@ -198,45 +258,68 @@ inline Return Dispatcher::callUnboxedOnly(const OperatorHandle& op, Args... args
   return op.operatorIterator_->op.readDispatchTable([&] (const DispatchTable& dispatchTable) -> Return {
     // TODO This should be a nested lambda instead of a separate function call, but that triggers an internal
     // compiler error on GCC5. Change this once we don't need gcc 5 anymore.
-    return doCallUnboxedOnly<Return, Args...>(dispatchTable, backendFallbackKernels_, std::forward<Args>(args)...);
+    return doCallUnboxedOnly<Return, Args...>(dispatchTable, std::forward<Args>(args)...);
   });
 }
 
 template<class Return, class... Args>
-inline Return Dispatcher::doCallUnboxedOnly(const DispatchTable& dispatchTable, const LeftRight<ska::flat_hash_map<TensorTypeId, KernelFunction>>& backendFallbackKernels_, Args... args) const {
+inline Return Dispatcher::doCallUnboxedOnly(const DispatchTable& dispatchTable, Args... args) const {
   detail::unused_arg_(args...);  // workaround for a false-positive warning about unused parameters in gcc 5
-  return backendFallbackKernels_.read([&] (const ska::flat_hash_map<TensorTypeId, KernelFunction>& backendFallbackKernels) -> Return {
-    c10::optional<TensorTypeId> dispatchKey = dispatchTable.dispatchKeyExtractor().getDispatchKeyUnboxed<Args...>(args...);
-    const KernelFunction& kernel = dispatch_(dispatchTable, backendFallbackKernels, dispatchKey);
-    return kernel.template callUnboxedOnly<Return, Args...>(std::forward<Args>(args)...);
-  });
+  TensorTypeSet skipped;
+  while (true) {
+    c10::optional<TensorTypeId> dispatchKey = dispatchTable.dispatchKeyExtractor().getDispatchKeyUnboxed<Args...>(skipped, args...);
+    if (C10_LIKELY(dispatchKey.has_value())) {
+      const KernelFunction* backendKernel = dispatchTable.lookup(*dispatchKey);
+      if (C10_LIKELY(nullptr != backendKernel)) {
+        return backendKernel->template callUnboxedOnly<Return, Args...>(std::forward<Args>(args)...);
+      }
+    }
+    // The arguments of unboxed-only operators can't be boxed, so the only
+    // backend fallback that applies to them is the fallthrough.
+    if (lookupBackendFallbackKernel_(dispatchKey) == &backendFallthroughKernel) {
+      skipped = skipped.add(*dispatchKey);
+      continue;
+    }
+    return dispatchCatchall_(dispatchTable, dispatchKey).template callUnboxedOnly<Return, Args...>(std::forward<Args>(args)...);
+  }
 }
 
 inline void Dispatcher::callBoxed(const OperatorHandle& op, Stack* stack) const {
   // note: this doesn't need the mutex because write operations on the list keep iterators intact.
   return op.operatorIterator_->op.readDispatchTable([&] (const DispatchTable& dispatchTable) {
-    return backendFallbackKernels_.read([&] (const ska::flat_hash_map<TensorTypeId, KernelFunction>& backendFallbackKernels) {
-      c10::optional<TensorTypeId> dispatchKey = dispatchTable.dispatchKeyExtractor().getDispatchKeyBoxed(stack);
-      const KernelFunction& kernel = dispatch_(dispatchTable, backendFallbackKernels, dispatchKey);
-      kernel.callBoxed(stack);
-    });
+    TensorTypeSet skipped;
+    while (true) {
+      c10::optional<TensorTypeId> dispatchKey = dispatchTable.dispatchKeyExtractor().getDispatchKeyBoxed(stack, skipped);
+      if (C10_LIKELY(dispatchKey.has_value())) {
+        const KernelFunction* backendKernel = dispatchTable.lookup(*dispatchKey);
+        if (C10_LIKELY(nullptr != backendKernel)) {
+          return backendKernel->callBoxed(stack);
+        }
+      }
+      BackendFallbackKernel* backendFallbackKernel = lookupBackendFallbackKernel_(dispatchKey);
+      if (backendFallbackKernel == &backendFallthroughKernel) {
+        skipped = skipped.add(*dispatchKey);
+        continue;
+      }
+      if (nullptr != backendFallbackKernel) {
+        return (*backendFallbackKernel)(op, stack);
+      }
+      return dispatchCatchall_(dispatchTable, dispatchKey).callBoxed(stack);
+    }
   });
 }
 
-inline const KernelFunction& Dispatcher::dispatch_(const DispatchTable& dispatchTable, const ska::flat_hash_map<TensorTypeId, KernelFunction>& backendFallbackKernels, c10::optional<TensorTypeId> dispatchKey) {
-  if (C10_LIKELY(dispatchKey.has_value())) {
-    const KernelFunction* backendKernel = dispatchTable.lookup(*dispatchKey);
-
-    if (nullptr != backendKernel) {
-      return *backendKernel;
-    }
-
-    auto backendFallbackKernel = backendFallbackKernels.find(*dispatchKey);
-    if (backendFallbackKernel != backendFallbackKernels.end()) {
-      return backendFallbackKernel->second;
-    }
+inline BackendFallbackKernel* Dispatcher::lookupBackendFallbackKernel_(c10::optional<TensorTypeId> dispatchKey) const {
+  if (!dispatchKey.has_value()) {
+    return nullptr;
   }
+  return backendFallbackKernels_.read([&] (const ska::flat_hash_map<TensorTypeId, BackendFallbackKernel*>& backendFallbackKernels) -> BackendFallbackKernel* {
+    auto found = backendFallbackKernels.find(*dispatchKey);
+    return found != backendFallbackKernels.end() ? found->second : nullptr;
+  });
+}
 
+inline const KernelFunction& Dispatcher::dispatchCatchall_(const DispatchTable& dispatchTable, c10::optional<TensorTypeId> dispatchKey) {
   const KernelFunction* catchallKernel = dispatchTable.lookupCatchallKernel();
   if (C10_LIKELY(nullptr != catchallKernel)) {
     return *catchallKernel;
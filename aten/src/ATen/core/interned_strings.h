@@ -116,6 +116,9 @@ namespace c10 {
   _(prim, profile)                   \
   _(prim, AddStatValue)              \
   _(prim, TimePoint)                 \
+  _(prim, MemoryPlanBegin)           \
+  _(prim, MemoryPlanSlot)            \
+  _(prim, MemoryPlanEnd)             \
   _(prim, CallFunction)              \
   _(prim, CallMethod)                \
   _(prim, LoopContinuation)          \
@@ -165,6 +168,7 @@ namespace c10 {
   _(aten, clear)                     \
   _(aten, setdefault)                \
   _(aten, bin)                       \
+  _(aten, to_mkldnn)                 \
   _(prim, unchecked_unwrap_optional) \
   _(aten, __contains__)              \
   _(prim, BailoutTemplate)           \
@@ -231,7 +235,9 @@ namespace c10 {
   _(attr, slot)                      \
   _(attr, kinds)                     \
   _(attr, types)                     \
-  _(attr, scope)
+  _(attr, nbytes)                    \
+  _(attr, scope)                     \
+  _(attr, symbols)
 #else
 #define FORALL_NS_SYMBOLS(_) \
   _(namespaces, prim)              \
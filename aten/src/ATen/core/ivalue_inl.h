@@ -229,8 +229,11 @@ struct C10_EXPORT ivalue::Future final : c10::intrusive_ptr_target {
     completed_ = true;
     value_ = std::move(value);
 
-    fireCallbacks();
+    // Callbacks may read the value and run for a while, so they run without
+    // the lock held, after waking up the threads blocked in wait()
+    lock.unlock();
     finished_cv_.notify_all();
+    fireCallbacks();
   }
 
   void markCompleted() {
@@ -244,8 +247,9 @@ struct C10_EXPORT ivalue::Future final : c10::intrusive_ptr_target {
     has_error = true;
     error = std::move(error_);
 
-    fireCallbacks();
+    lock.unlock();
     finished_cv_.notify_all();
+    fireCallbacks();
   }
 
   // Get the result of the current future.
@@ -536,6 +536,11 @@ struct CAFFE2_API TensorType : public Type {
 
   TensorTypePtr merge(TensorTypePtr other) const;
 
+  // Checks `t` against the properties this type knows, the ones that are
+  // c10::nullopt (e.g. the dims that varied across profiled runs) match any
+  // value
+  bool matchTensor(const at::Tensor& t) const;
+
   // is all information about the type specified except for autograd?
   // This replaces the notion of a 'CompleteTensorType' that used to exist
   // in the type-hierarchy. Excluding require_grad and undefined allows
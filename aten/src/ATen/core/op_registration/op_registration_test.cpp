@@ -13,6 +13,7 @@
 #include <ATen/core/boxing/test_helpers.h>
 #include <ATen/core/op_registration/op_registration.h>
 #include <ATen/core/Tensor.h>
+#include <c10/core/impl/LocalTensorTypeSet.h>
 #include <functional>
 
 using c10::RegisterOperators;
@@ -639,6 +640,114 @@ void autograd_kernel(Tensor a) {
   called_autograd = true;
 }
 
+bool called_backend_fallback = false;
+
+void backend_fallback_kernel(const c10::OperatorHandle&, c10::Stack* stack) {
+  called_backend_fallback = true;
+  stack->clear();
+}
+
+TEST(OperatorRegistrationTest, givenBackendFallbackKernel_whenKernelRegisteredAndDeregistered_thenCallsKernelAndThenFallback) {
+  auto fallback_registrar = Dispatcher::singleton().registerBackendFallbackKernel(
+      TensorTypeId::XLATensorId, &backend_fallback_kernel);
+  auto schema_registrar = c10::RegisterOperators().op("_test::dummy(Tensor dummy) -> ()");
+  bool called_kernel = false;
+  auto registrar = c10::RegisterOperators().op("_test::dummy(Tensor dummy) -> ()", c10::RegisterOperators::options().kernel<MockKernel>(TensorTypeId::XLATensorId, &called_kernel));
+
+  auto op = Dispatcher::singleton().findSchema({"_test::dummy", ""});
+  ASSERT_TRUE(op.has_value());
+
+  called_backend_fallback = false;
+  callOpUnboxed<void, Tensor>(*op, dummyTensor(TensorTypeId::XLATensorId));
+  EXPECT_TRUE(called_kernel);
+  EXPECT_FALSE(called_backend_fallback);
+
+  registrar = c10::RegisterOperators(); // destruct the kernel registrar
+
+  called_kernel = false;
+  callOpUnboxed<void, Tensor>(*op, dummyTensor(TensorTypeId::XLATensorId));
+  EXPECT_FALSE(called_kernel);
+  EXPECT_TRUE(called_backend_fallback);
+
+  called_backend_fallback = false;
+  callOp(*op, dummyTensor(TensorTypeId::XLATensorId));
+  EXPECT_TRUE(called_backend_fallback);
+}
+
+std::vector<std::string> wrapped_ops;
+
+// Records the operator and redispatches to the kernel below the wrapper
+void logging_wrapper_fallback(const c10::OperatorHandle& op, c10::Stack* stack) {
+  wrapped_ops.push_back(op.schema().name());
+  c10::impl::ExcludeTensorTypeIdGuard guard(TensorTypeId::TESTING_ONLY_GenericModeTensorId);
+  Dispatcher::singleton().callBoxed(op, stack);
+}
+
+TEST(OperatorRegistrationTest, givenWrapperBackendFallbackKernel_whenCallingOps_thenWrapsEveryOpAndRedispatches) {
+  auto fallback_registrar = Dispatcher::singleton().registerBackendFallbackKernel(
+      TensorTypeId::TESTING_ONLY_GenericModeTensorId, &logging_wrapper_fallback);
+  bool called_kernel1 = false;
+  bool called_kernel2 = false;
+  auto registrar = c10::RegisterOperators()
+      .op("_test::dummy1(Tensor dummy) -> ()", c10::RegisterOperators::options().kernel<MockKernel>(TensorTypeId::CPUTensorId, &called_kernel1))
+      .op("_test::dummy2(Tensor dummy) -> ()", c10::RegisterOperators::options().kernel<MockKernel>(TensorTypeId::CPUTensorId, &called_kernel2));
+
+  auto op1 = Dispatcher::singleton().findSchema({"_test::dummy1", ""});
+  ASSERT_TRUE(op1.has_value());
+  auto op2 = Dispatcher::singleton().findSchema({"_test::dummy2", ""});
+  ASSERT_TRUE(op2.has_value());
+
+  wrapped_ops.clear();
+  {
+    c10::impl::IncludeTensorTypeIdGuard guard(TensorTypeId::TESTING_ONLY_GenericModeTensorId);
+    callOpUnboxed<void, Tensor>(*op1, dummyTensor(TensorTypeId::CPUTensorId));
+    callOp(*op2, dummyTensor(TensorTypeId::CPUTensorId));
+  }
+  EXPECT_TRUE(called_kernel1);
+  EXPECT_TRUE(called_kernel2);
+  EXPECT_EQ(wrapped_ops, std::vector<std::string>({"_test::dummy1", "_test::dummy2"}));
+
+  // without the mode, the wrapper isn't called
+  called_kernel1 = false;
+  callOpUnboxed<void, Tensor>(*op1, dummyTensor(TensorTypeId::CPUTensorId));
+  EXPECT_TRUE(called_kernel1);
+  EXPECT_EQ(wrapped_ops.size(), 2);
+}
+
+TEST(OperatorRegistrationTest, givenFallthroughBackendFallbackKernel_whenCallingOps_thenCallsModeKernelOrFallsThrough) {
+  auto fallback_registrar = Dispatcher::singleton().registerBackendFallbackKernel(
+      TensorTypeId::TESTING_ONLY_GenericModeTensorId, &c10::backendFallthroughKernel);
+  bool called_mode_kernel = false;
+  bool called_kernel1 = false;
+  bool called_kernel2 = false;
+  auto registrar = c10::RegisterOperators()
+      .op("_test::dummy1(Tensor dummy) -> ()", c10::RegisterOperators::options()
+        .kernel<MockKernel>(TensorTypeId::CPUTensorId, &called_kernel1)
+        .kernel<MockKernel>(TensorTypeId::TESTING_ONLY_GenericModeTensorId, &called_mode_kernel))
+      .op("_test::dummy2(Tensor dummy) -> ()", c10::RegisterOperators::options().kernel<MockKernel>(TensorTypeId::CPUTensorId, &called_kernel2));
+
+  auto op1 = Dispatcher::singleton().findSchema({"_test::dummy1", ""});
+  ASSERT_TRUE(op1.has_value());
+  auto op2 = Dispatcher::singleton().findSchema({"_test::dummy2", ""});
+  ASSERT_TRUE(op2.has_value());
+
+  c10::impl::IncludeTensorTypeIdGuard guard(TensorTypeId::TESTING_ONLY_GenericModeTensorId);
+  callOpUnboxed<void, Tensor>(*op1, dummyTensor(TensorTypeId::CPUTensorId));
+  EXPECT_TRUE(called_mode_kernel);
+  EXPECT_FALSE(called_kernel1);
+
+  callOpUnboxed<void, Tensor>(*op2, dummyTensor(TensorTypeId::CPUTensorId));
+  EXPECT_TRUE(called_kernel2);
+
+  called_kernel2 = false;
+  Dispatcher::singleton().callUnboxedOnly<void, Tensor>(*op2, dummyTensor(TensorTypeId::CPUTensorId));
+  EXPECT_TRUE(called_kernel2);
+
+  called_kernel2 = false;
+  callOp(*op2, dummyTensor(TensorTypeId::CPUTensorId));
+  EXPECT_TRUE(called_kernel2);
+}
+
 // TODO Reenable these
 // TEST(OperatorRegistrationTest, whenRegisteringAutogradKernel_thenCanCallAutogradKernel) {
 //   auto registrar = c10::RegisterOperators().op("_test::dummy(Tensor dummy) -> ()", c10::RegisterOperators::options()
@@ -418,6 +418,41 @@ TensorTypePtr TensorType::merge(TensorTypePtr other) const {
   return TensorType::create(scalar_type, dev, sz, srs, gr, undef);
 }
 
+bool TensorType::matchTensor(const at::Tensor& t) const {
+  if (undefined().value_or(!t.defined()) != !t.defined()) {
+    return false;
+  }
+  if (!t.defined()) {
+    return true;
+  }
+  if (scalarType().value_or(t.scalar_type()) != t.scalar_type() ||
+      device().value_or(t.device()) != t.device() ||
+      requiresGrad().value_or(t.requires_grad()) != t.requires_grad()) {
+    return false;
+  }
+  const auto& dims = sizes().sizes();
+  const auto& strides_dims = strides().sizes();
+  if (!dims) {
+    return true;
+  }
+  if (dims->size() != static_cast<size_t>(t.dim()) ||
+      (strides_dims && strides_dims->size() != dims->size())) {
+    return false;
+  }
+  // The sizes and strides of mkldnn and sparse tensors are never profiled
+  const bool has_strides = !t.is_mkldnn() && !t.is_sparse();
+  for (size_t i = 0; i < dims->size(); i++) {
+    if ((*dims)[i] && (!has_strides || *(*dims)[i] != t.sizes()[i])) {
+      return false;
+    }
+    if (strides_dims && (*strides_dims)[i] &&
+        (!has_strides || *(*strides_dims)[i] != t.strides()[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
 std::ostream& operator<<(std::ostream & out, const VaryingShape & vs) {
 
     out << "(";
@@ -0,0 +1,387 @@
+#pragma once
+
+#include <ATen/cpu/vec256/intrinsics.h>
+#include <ATen/cpu/vec256/vec256_base.h>
+#include <ATen/cpu/vec256/vec256_float.h>
+#if defined(__AVX__) && !defined(_MSC_VER)
+#include <sleef.h>
+#endif
+
+namespace at {
+namespace vec256 {
+// See Note [Acceptable use of anonymous namespace in header]
+namespace {
+
+#if defined(__AVX2__) && !defined(_MSC_VER)
+
+// BFloat16 is the upper half of a float, so the 16 lanes are widened to two
+// Vec256<float> by a shift, computed on in float, and narrowed back with
+// round to nearest even, the same rounding as c10::BFloat16(float).
+
+static inline void cvtbf16_fp32(const __m256i& a, __m256& lo, __m256& hi) {
+  __m256i lo_bits = _mm256_cvtepu16_epi32(_mm256_castsi256_si128(a));
+  __m256i hi_bits = _mm256_cvtepu16_epi32(_mm256_extracti128_si256(a, 1));
+  lo = _mm256_castsi256_ps(_mm256_slli_epi32(lo_bits, 16));
+  hi = _mm256_castsi256_ps(_mm256_slli_epi32(hi_bits, 16));
+}
+
+static inline __m256i cvtfp32_bf16_bits(const __m256& a) {
+  const __m256i ones = _mm256_set1_epi32(0x1);
+  const __m256i vec_bias = _mm256_set1_epi32(0x7fff);
+  const __m256i nan = _mm256_set1_epi32(0x7fc0);
+  __m256i bits = _mm256_castps_si256(a);
+  // the lowest bit kept decides which way a tie rounds
+  __m256i lsb = _mm256_and_si256(_mm256_srli_epi32(bits, 16), ones);
+  __m256i rounded = _mm256_srli_epi32(
+      _mm256_add_epi32(bits, _mm256_add_epi32(vec_bias, lsb)), 16);
+  // rounding could turn a NaN into an infinity
+  __m256i is_ordered = _mm256_castps_si256(_mm256_cmp_ps(a, a, _CMP_ORD_Q));
+  return _mm256_blendv_epi8(nan, rounded, is_ordered);
+}
+
+// Packs the low 16 bits of the 32 bit lanes of lo and hi, in order.
+static inline __m256i pack_bf16_bits(const __m256i& lo, const __m256i& hi) {
+  // packus interleaves the 128 bit halves of lo and hi: lo0 hi0 lo1 hi1
+  __m256i packed = _mm256_packus_epi32(lo, hi);
+  return _mm256_permute4x64_epi64(packed, 0xd8);
+}
+
+static inline __m256i cvtfp32_bf16(const __m256& lo, const __m256& hi) {
+  return pack_bf16_bits(cvtfp32_bf16_bits(lo), cvtfp32_bf16_bits(hi));
+}
+
+// The all-ones float lanes of a comparison mask become all-ones BFloat16 lanes
+static inline __m256i cvtmask_bf16(const __m256& lo, const __m256& hi) {
+  return pack_bf16_bits(
+      _mm256_srli_epi32(_mm256_castps_si256(lo), 16),
+      _mm256_srli_epi32(_mm256_castps_si256(hi), 16));
+}
+
+template <> class Vec256<BFloat16> {
+private:
+  __m256i values;
+public:
+  using value_type = BFloat16;
+  static constexpr int size() {
+    return 16;
+  }
+  Vec256() {}
+  Vec256(__m256i v) : values(v) {}
+  Vec256(BFloat16 val) {
+    values = _mm256_set1_epi16(val.x);
+  }
+  Vec256(BFloat16 val1, BFloat16 val2, BFloat16 val3, BFloat16 val4,
+         BFloat16 val5, BFloat16 val6, BFloat16 val7, BFloat16 val8,
+         BFloat16 val9, BFloat16 val10, BFloat16 val11, BFloat16 val12,
+         BFloat16 val13, BFloat16 val14, BFloat16 val15, BFloat16 val16) {
+    values = _mm256_setr_epi16(
+        val1.x, val2.x, val3.x, val4.x, val5.x, val6.x, val7.x, val8.x,
+        val9.x, val10.x, val11.x, val12.x, val13.x, val14.x, val15.x, val16.x);
+  }
+  operator __m256i() const {
+    return values;
+  }
+  template <int64_t mask>
+  static Vec256<BFloat16> blend(const Vec256<BFloat16>& a, const Vec256<BFloat16>& b) {
+    __at_align32__ BFloat16 tmp_values[size()];
+    a.store(tmp_values);
+    __at_align32__ BFloat16 b_values[size()];
+    b.store(b_values);
+    for (int64_t i = 0; i < size(); i++) {
+      if (mask & (1LL << i)) {
+        tmp_values[i] = b_values[i];
+      }
+    }
+    return loadu(tmp_values);
+  }
+  static Vec256<BFloat16> blendv(const Vec256<BFloat16>& a, const Vec256<BFloat16>& b,
+                                 const Vec256<BFloat16>& mask) {
+    return _mm256_blendv_epi8(a.values, b.values, mask.values);
+  }
+  static Vec256<BFloat16> arange(BFloat16 base = 0.f, BFloat16 step = 1.f) {
+    __at_align32__ BFloat16 tmp_values[size()];
+    for (int64_t i = 0; i < size(); i++) {
+      tmp_values[i] = static_cast<float>(base) + i * static_cast<float>(step);
+    }
+    return loadu(tmp_values);
+  }
+  static Vec256<BFloat16> set(const Vec256<BFloat16>& a, const Vec256<BFloat16>& b,
+                              int64_t count = size()) {
+    __at_align32__ BFloat16 tmp_values[size()];
+    a.store(tmp_values);
+    b.store(tmp_values, count);
+    return loadu(tmp_values);
+  }
+  static Vec256<BFloat16> loadu(const void* ptr, int64_t count = size()) {
+    if (count == size())
+      return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ptr));
+    __at_align32__ BFloat16 tmp_values[size()];
+    std::memcpy(tmp_values, ptr, count * sizeof(BFloat16));
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(tmp_values));
+  }
+  void store(void* ptr, int64_t count = size()) const {
+    if (count == size()) {
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(ptr), values);
+    } else if (count > 0) {
+      __at_align32__ BFloat16 tmp_values[size()];
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(tmp_values), values);
+      std::memcpy(ptr, tmp_values, count * sizeof(BFloat16));
+    }
+  }
+  const BFloat16& operator[](int idx) const  = delete;
+  BFloat16& operator[](int idx) = delete;
+  template <typename Op>
+  Vec256<BFloat16> map_fp32(const Op& op) const {
+    __m256 lo, hi;
+    cvtbf16_fp32(values, lo, hi);
+    return cvtfp32_bf16(op(Vec256<float>(lo)), op(Vec256<float>(hi)));
+  }
+  template <typename Op>
+  Vec256<BFloat16> map_fp32(const Vec256<BFloat16>& b, const Op& op) const {
+    __m256 a_lo, a_hi, b_lo, b_hi;
+    cvtbf16_fp32(values, a_lo, a_hi);
+    cvtbf16_fp32(b.values, b_lo, b_hi);
+    return cvtfp32_bf16(
+        op(Vec256<float>(a_lo), Vec256<float>(b_lo)),
+        op(Vec256<float>(a_hi), Vec256<float>(b_hi)));
+  }
+  template <typename Op>
+  Vec256<BFloat16> compare_fp32(const Vec256<BFloat16>& b, const Op& op) const {
+    __m256 a_lo, a_hi, b_lo, b_hi;
+    cvtbf16_fp32(values, a_lo, a_hi);
+    cvtbf16_fp32(b.values, b_lo, b_hi);
+    return cvtmask_bf16(
+        op(Vec256<float>(a_lo), Vec256<float>(b_lo)),
+        op(Vec256<float>(a_hi), Vec256<float>(b_hi)));
+  }
+  Vec256<BFloat16> map(BFloat16 (*f)(BFloat16)) const {
+    __at_align32__ BFloat16 tmp[size()];
+    store(tmp);
+    for (int64_t i = 0; i < size(); i++) {
+      tmp[i] = f(tmp[i]);
+    }
+    return loadu(tmp);
+  }
+  Vec256<BFloat16> abs() const {
+    return _mm256_andnot_si256(_mm256_set1_epi16(0x8000), values);
+  }
+  Vec256<BFloat16> angle() const {
+    return _mm256_set1_epi16(0);
+  }
+  Vec256<BFloat16> real() const {
+    return *this;
+  }
+  Vec256<BFloat16> imag() const {
+    return _mm256_set1_epi16(0);
+  }
+  Vec256<BFloat16> conj() const {
+    return *this;
+  }
+  Vec256<BFloat16> acos() const {
+    return map_fp32([](const Vec256<float>& x) { return x.acos(); });
+  }
+  Vec256<BFloat16> asin() const {
+    return map_fp32([](const Vec256<float>& x) { return x.asin(); });
+  }
+  Vec256<BFloat16> atan() const {
+    return map_fp32([](const Vec256<float>& x) { return x.atan(); });
+  }
+  Vec256<BFloat16> atan2(const Vec256<BFloat16> &b) const {
+    return map_fp32(b, [](const Vec256<float>& x, const Vec256<float>& y) { return x.atan2(y); });
+  }
+  Vec256<BFloat16> erf() const {
+    return map_fp32([](const Vec256<float>& x) { return x.erf(); });
+  }
+  Vec256<BFloat16> erfc() const {
+    return map_fp32([](const Vec256<float>& x) { return x.erfc(); });
+  }
+  Vec256<BFloat16> erfinv() const {
+    return map_fp32([](const Vec256<float>& x) { return x.erfinv(); });
+  }
+  Vec256<BFloat16> exp() const {
+    return map_fp32([](const Vec256<float>& x) { return x.exp(); });
+  }
+  Vec256<BFloat16> expm1() const {
+    return map_fp32([](const Vec256<float>& x) { return x.expm1(); });
+  }
+  Vec256<BFloat16> log() const {
+    return map_fp32([](const Vec256<float>& x) { return x.log(); });
+  }
+  Vec256<BFloat16> log2() const {
+    return map_fp32([](const Vec256<float>& x) { return x.log2(); });
+  }
+  Vec256<BFloat16> log10() const {
+    return map_fp32([](const Vec256<float>& x) { return x.log10(); });
+  }
+  Vec256<BFloat16> log1p() const {
+    return map_fp32([](const Vec256<float>& x) { return x.log1p(); });
+  }
+  Vec256<BFloat16> frac() const {
+    return map_fp32([](const Vec256<float>& x) { return x.frac(); });
+  }
+  Vec256<BFloat16> sin() const {
+    return map_fp32([](const Vec256<float>& x) { return x.sin(); });
+  }
+  Vec256<BFloat16> sinh() const {
+    return map_fp32([](const Vec256<float>& x) { return x.sinh(); });
+  }
+  Vec256<BFloat16> cos() const {
+    return map_fp32([](const Vec256<float>& x) { return x.cos(); });
+  }
+  Vec256<BFloat16> cosh() const {
+    return map_fp32([](const Vec256<float>& x) { return x.cosh(); });
+  }
+  Vec256<BFloat16> ceil() const {
+    return map_fp32([](const Vec256<float>& x) { return x.ceil(); });
+  }
+  Vec256<BFloat16> floor() const {
+    return map_fp32([](const Vec256<float>& x) { return x.floor(); });
+  }
+  Vec256<BFloat16> neg() const {
+    return _mm256_xor_si256(_mm256_set1_epi16(0x8000), values);
+  }
+  Vec256<BFloat16> round() const {
+    return map_fp32([](const Vec256<float>& x) { return x.round(); });
+  }
+  Vec256<BFloat16> tan() const {
+    return map_fp32([](const Vec256<float>& x) { return x.tan(); });
+  }
+  Vec256<BFloat16> tanh() const {
+    return map_fp32([](const Vec256<float>& x) { return x.tanh(); });
+  }
+  Vec256<BFloat16> trunc() const {
+    return map_fp32([](const Vec256<float>& x) { return x.trunc(); });
+  }
+  Vec256<BFloat16> lgamma() const {
+    return map_fp32([](const Vec256<float>& x) { return x.lgamma(); });
+  }
+  Vec256<BFloat16> sqrt() const {
+    return map_fp32([](const Vec256<float>& x) { return x.sqrt(); });
+  }
+  Vec256<BFloat16> reciprocal() const {
+    return map_fp32([](const Vec256<float>& x) { return x.reciprocal(); });
+  }
+  Vec256<BFloat16> rsqrt() const {
+    return map_fp32([](const Vec256<float>& x) { return x.rsqrt(); });
+  }
+  Vec256<BFloat16> pow(const Vec256<BFloat16> &b) const {
+    return map_fp32(b, [](const Vec256<float>& x, const Vec256<float>& y) { return x.pow(y); });
+  }
+  Vec256<BFloat16> operator==(const Vec256<BFloat16>& other) const {
+    return compare_fp32(other, [](const Vec256<float>& x, const Vec256<float>& y) { return x == y; });
+  }
+  Vec256<BFloat16> operator!=(const Vec256<BFloat16>& other) const {
+    return compare_fp32(other, [](const Vec256<float>& x, const Vec256<float>& y) { return x != y; });
+  }
+  Vec256<BFloat16> operator<(const Vec256<BFloat16>& other) const {
+    return compare_fp32(other, [](const Vec256<float>& x, const Vec256<float>& y) { return x < y; });
+  }
+  Vec256<BFloat16> operator<=(const Vec256<BFloat16>& other) const {
+    return compare_fp32(other, [](const Vec256<float>& x, const Vec256<float>& y) { return x <= y; });
+  }
+  Vec256<BFloat16> operator>(const Vec256<BFloat16>& other) const {
+    return compare_fp32(other, [](const Vec256<float>& x, const Vec256<float>& y) { return x > y; });
+  }
+  Vec256<BFloat16> operator>=(const Vec256<BFloat16>& other) const {
+    return compare_fp32(other, [](const Vec256<float>& x, const Vec256<float>& y) { return x >= y; });
+  }
+};
+
+template <>
+Vec256<BFloat16> inline operator+(const Vec256<BFloat16>& a, const Vec256<BFloat16>& b) {
+  return a.map_fp32(b, [](const Vec256<float>& x, const Vec256<float>& y) { return x + y; });
+}
+
+template <>
+Vec256<BFloat16> inline operator-(const Vec256<BFloat16>& a, const Vec256<BFloat16>& b) {
+  return a.map_fp32(b, [](const Vec256<float>& x, const Vec256<float>& y) { return x - y; });
+}
+
+template <>
+Vec256<BFloat16> inline operator*(const Vec256<BFloat16>& a, const Vec256<BFloat16>& b) {
+  return a.map_fp32(b, [](const Vec256<float>& x, const Vec256<float>& y) { return x * y; });
+}
+
+template <>
+Vec256<BFloat16> inline operator/(const Vec256<BFloat16>& a, const Vec256<BFloat16>& b) {
+  return a.map_fp32(b, [](const Vec256<float>& x, const Vec256<float>& y) { return x / y; });
+}
+
+// Implements the IEEE 754 201X `maximum` operation, which propagates NaN if
+// either input is a NaN.
+template <>
+Vec256<BFloat16> inline maximum(const Vec256<BFloat16>& a, const Vec256<BFloat16>& b) {
+  return a.map_fp32(b, [](const Vec256<float>& x, const Vec256<float>& y) { return maximum(x, y); });
+}
+
+// Implements the IEEE 754 201X `minimum` operation, which propagates NaN if
+// either input is a NaN.
+template <>
+Vec256<BFloat16> inline minimum(const Vec256<BFloat16>& a, const Vec256<BFloat16>& b) {
+  return a.map_fp32(b, [](const Vec256<float>& x, const Vec256<float>& y) { return minimum(x, y); });
+}
+
+template <>
+Vec256<BFloat16> inline clamp(const Vec256<BFloat16>& a, const Vec256<BFloat16>& min, const Vec256<BFloat16>& max) {
+  __m256 a_lo, a_hi, min_lo, min_hi, max_lo, max_hi;
+  cvtbf16_fp32(a, a_lo, a_hi);
+  cvtbf16_fp32(min, min_lo, min_hi);
+  cvtbf16_fp32(max, max_lo, max_hi);
+  return cvtfp32_bf16(
+      _mm256_min_ps(max_lo, _mm256_max_ps(min_lo, a_lo)),
+      _mm256_min_ps(max_hi, _mm256_max_ps(min_hi, a_hi)));
+}
+
+template <>
+Vec256<BFloat16> inline clamp_max(const Vec256<BFloat16>& a, const Vec256<BFloat16>& max) {
+  return a.map_fp32(max, [](const Vec256<float>& x, const Vec256<float>& y) { return clamp_max(x, y); });
+}
+
+template <>
+Vec256<BFloat16> inline clamp_min(const Vec256<BFloat16>& a, const Vec256<BFloat16>& min) {
+  return a.map_fp32(min, [](const Vec256<float>& x, const Vec256<float>& y) { return clamp_min(x, y); });
+}
+
+template <>
+Vec256<BFloat16> inline operator&(const Vec256<BFloat16>& a, const Vec256<BFloat16>& b) {
+  return _mm256_and_si256(a, b);
+}
+
+template <>
+Vec256<BFloat16> inline operator|(const Vec256<BFloat16>& a, const Vec256<BFloat16>& b) {
+  return _mm256_or_si256(a, b);
+}
+
+template <>
+Vec256<BFloat16> inline operator^(const Vec256<BFloat16>& a, const Vec256<BFloat16>& b) {
+  return _mm256_xor_si256(a, b);
+}
+
+template <>
+inline void convert(const BFloat16* src, BFloat16* dst, int64_t n) {
+  int64_t i;
+#pragma unroll
+  for (i = 0; i <= (n - Vec256<BFloat16>::size()); i += Vec256<BFloat16>::size()) {
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i),
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i)));
+  }
+#pragma unroll
+  for (; i < n; i++) {
+    dst[i] = src[i];
+  }
+}
+
+// Rounds once, after the fused multiply-add in float
+template <>
+Vec256<BFloat16> inline fmadd(const Vec256<BFloat16>& a, const Vec256<BFloat16>& b, const Vec256<BFloat16>& c) {
+  __m256 a_lo, a_hi, b_lo, b_hi, c_lo, c_hi;
+  cvtbf16_fp32(a, a_lo, a_hi);
+  cvtbf16_fp32(b, b_lo, b_hi);
+  cvtbf16_fp32(c, c_lo, c_hi);
+  return cvtfp32_bf16(
+      _mm256_fmadd_ps(a_lo, b_lo, c_lo), _mm256_fmadd_ps(a_hi, b_hi, c_hi));
+}
+
+#endif
+
+}}}
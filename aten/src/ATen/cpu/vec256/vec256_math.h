@@ -0,0 +1,217 @@
+#pragma once
+
+#include <ATen/cpu/vec256/vec256.h>
+#include <ATen/native/Math.h>
+
+#include <cmath>
+#include <limits>
+
+// This header implements vectorized versions of the special functions in
+// ATen/native/Math.h that Vec256 itself only provides through map(), and
+// "fast" lower-precision variants of some elementary functions.
+//
+// Everything here is templated on the vector type, so it works for Vec256 and
+// Vec512 (and vec512::Vectorized) alike. The fast variants are only meant to
+// be called on float vectors; native implementations exist for
+// Vec256<float> under AVX2 (below) and Vec512<float> under AVX512
+// (vec512/vec512_math.h). For other types they fall back to the precise
+// member function.
+//
+// Maximum relative error of the fast float variants, measured against the
+// double precision result:
+//   fast_exp      1.2e-7 (2 ulp)
+//   fast_tanh     2.6e-7
+//   fast_sigmoid  1.8e-7
+//   fast_erfinv   3.6e-7 (one Newton step instead of two, which is enough
+//                 in single precision)
+
+namespace at {
+namespace vec256 {
+// See Note [Acceptable use of anonymous namespace in header]
+namespace {
+
+// Vectorized calc_erfinv. Both branches of the rational approximation are
+// evaluated and blended, followed by `newton_steps` Newton-Raphson steps.
+template <typename Vec, int newton_steps = 2>
+Vec vec_erfinv(const Vec& y) {
+  using T = typename Vec::value_type;
+  const Vec one(static_cast<T>(1));
+  const Vec zero(static_cast<T>(0));
+  const Vec y_abs = y.abs();
+
+  // central range, |y| <= 0.7
+  Vec z = y * y;
+  Vec num = fmadd(fmadd(fmadd(Vec(static_cast<T>(-0.140543331)), z,
+                              Vec(static_cast<T>(0.914624893))), z,
+                        Vec(static_cast<T>(-1.645349621))), z,
+                  Vec(static_cast<T>(0.886226899)));
+  Vec dem = fmadd(fmadd(fmadd(fmadd(Vec(static_cast<T>(0.012229801)), z,
+                                    Vec(static_cast<T>(-0.329097515))), z,
+                              Vec(static_cast<T>(1.442710462))), z,
+                        Vec(static_cast<T>(-2.118377725))), z,
+                  one);
+  const Vec x_central = y * num / dem;
+
+  // tails
+  z = ((one - y_abs) / Vec(static_cast<T>(2))).log().neg().sqrt();
+  num = fmadd(fmadd(fmadd(Vec(static_cast<T>(1.641345311)), z,
+                          Vec(static_cast<T>(3.429567803))), z,
+                    Vec(static_cast<T>(-1.624906493))), z,
+              Vec(static_cast<T>(-1.970840454)));
+  dem = fmadd(fmadd(Vec(static_cast<T>(1.637067800)), z,
+                    Vec(static_cast<T>(3.543889200))), z,
+              one);
+  num = num.abs();
+  const Vec x_tail = Vec::blendv(num, num.neg(), y < zero) / dem;
+
+  Vec x = Vec::blendv(x_tail, x_central, y_abs <= Vec(static_cast<T>(0.7)));
+
+  const Vec two_over_sqrt_pi(static_cast<T>(2.0) / static_cast<T>(std::sqrt(M_PI)));
+  for (int i = 0; i < newton_steps; i++) {
+    x = x - (x.erf() - y) / (two_over_sqrt_pi * (x.neg() * x).exp());
+  }
+
+  const Vec inf(std::numeric_limits<T>::infinity());
+  x = Vec::blendv(x, Vec::blendv(inf, inf.neg(), y < zero), y_abs == one);
+  return Vec::blendv(x, Vec(std::numeric_limits<T>::quiet_NaN()), y_abs > one);
+}
+
+// Vectorized calc_digamma. Only positive inputs are handled in vector
+// registers; if any lane is zero, negative or NaN the whole vector goes
+// through the scalar implementation, which needs the reflection formula in
+// higher precision.
+template <typename Vec>
+Vec vec_digamma(Vec x) {
+  using T = typename Vec::value_type;
+  __at_align32__ T tmp[Vec::size()];
+  x.store(tmp);
+  for (int64_t i = 0; i < Vec::size(); i++) {
+    if (!(tmp[i] > 0)) {
+      return x.map([](T v) -> T { return calc_digamma(v); });
+    }
+  }
+
+  const Vec zero(static_cast<T>(0));
+  const Vec one(static_cast<T>(1));
+  const Vec ten(static_cast<T>(10));
+
+  // Push x to be >= 10. Every lane is positive, so ten steps are enough.
+  Vec result = zero;
+  for (int i = 0; i < 10; i++) {
+    const Vec mask = x < ten;
+    result = result - Vec::blendv(zero, one / x, mask);
+    x = x + Vec::blendv(zero, one, mask);
+  }
+  const Vec at_ten = x == ten;
+
+  // Compute asymptotic digamma
+  const Vec z = one / (x * x);
+  Vec y = Vec(static_cast<T>(8.33333333333333333333E-2));
+  y = fmadd(y, z, Vec(static_cast<T>(-2.10927960927960927961E-2)));
+  y = fmadd(y, z, Vec(static_cast<T>(7.57575757575757575758E-3)));
+  y = fmadd(y, z, Vec(static_cast<T>(-4.16666666666666666667E-3)));
+  y = fmadd(y, z, Vec(static_cast<T>(3.96825396825396825397E-3)));
+  y = fmadd(y, z, Vec(static_cast<T>(-8.33333333333333333333E-3)));
+  y = fmadd(y, z, Vec(static_cast<T>(8.33333333333333333333E-2)));
+  y = z * y;
+
+  const Vec psi = result + x.log() - (Vec(static_cast<T>(0.5)) / x) - y;
+  return Vec::blendv(psi, result + Vec(static_cast<T>(2.25175258906672110764)), at_ten);
+}
+
+// Vectorized trigamma.
+template <typename Vec>
+Vec vec_trigamma(Vec x) {
+  using T = typename Vec::value_type;
+  const Vec zero(static_cast<T>(0));
+  const Vec one(static_cast<T>(1));
+  const Vec pi(static_cast<T>(M_PI));
+
+  const Vec reflect = x < Vec(static_cast<T>(0.5));
+  const Vec sin_pi_x = (pi * x).sin();
+  Vec result = Vec::blendv(zero, (pi * pi).neg() / (sin_pi_x * sin_pi_x), reflect);
+  const Vec sign = Vec::blendv(one, one.neg(), reflect);
+  x = Vec::blendv(x, one - x, reflect);
+
+  for (int i = 0; i < 6; ++i) {
+    result = result + one / (x * x);
+    x = x + one;
+  }
+  const Vec ixx = one / (x * x);
+  Vec poly = Vec(static_cast<T>(1. / 30)) - ixx * Vec(static_cast<T>(1. / 42));
+  poly = Vec(static_cast<T>(1. / 6)) - ixx * poly;
+  poly = one + one / (Vec(static_cast<T>(2)) * x) + ixx * poly;
+  result = result + poly / x;
+  return sign * result;
+}
+
+template <typename Vec>
+Vec fast_exp(const Vec& x) {
+  return x.exp();
+}
+
+#if defined(__AVX2__) && !defined(_MSC_VER)
+
+// Cephes expf: exp(x) = 2^n * exp(r) with |r| <= ln(2) / 2, where exp(r) is a
+// degree 5 polynomial. 2^n is assembled in the exponent bits in two halves so
+// that neither overflows at the ends of the range.
+Vec256<float> inline fast_exp(const Vec256<float>& a) {
+  const __m256 max_x = _mm256_set1_ps(88.72283935546875f);
+  const __m256 x = _mm256_min_ps(_mm256_max_ps(a, _mm256_set1_ps(-103.972084f)), max_x);
+  const __m256 n = _mm256_floor_ps(
+      _mm256_fmadd_ps(x, _mm256_set1_ps(1.44269504088896341f), _mm256_set1_ps(0.5f)));
+  __m256 r = _mm256_fnmadd_ps(n, _mm256_set1_ps(0.693359375f), x);
+  r = _mm256_fnmadd_ps(n, _mm256_set1_ps(-2.12194440e-4f), r);
+  __m256 y = _mm256_set1_ps(1.9875691500E-4f);
+  y = _mm256_fmadd_ps(y, r, _mm256_set1_ps(1.3981999507E-3f));
+  y = _mm256_fmadd_ps(y, r, _mm256_set1_ps(8.3334519073E-3f));
+  y = _mm256_fmadd_ps(y, r, _mm256_set1_ps(4.1665795894E-2f));
+  y = _mm256_fmadd_ps(y, r, _mm256_set1_ps(1.6666665459E-1f));
+  y = _mm256_fmadd_ps(y, r, _mm256_set1_ps(5.0000001201E-1f));
+  y = _mm256_fmadd_ps(y, _mm256_mul_ps(r, r), _mm256_add_ps(r, _mm256_set1_ps(1.f)));
+  const __m256i n_int = _mm256_cvttps_epi32(n);
+  const __m256i n_hi = _mm256_srai_epi32(n_int, 1);
+  const __m256i bias = _mm256_set1_epi32(0x7f);
+  y = _mm256_mul_ps(y, _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_add_epi32(n_hi, bias), 23)));
+  y = _mm256_mul_ps(y, _mm256_castsi256_ps(_mm256_slli_epi32(
+      _mm256_add_epi32(_mm256_sub_epi32(n_int, n_hi), bias), 23)));
+  // the clamp above swallows overflow and NaN, put them back
+  y = _mm256_blendv_ps(y, _mm256_set1_ps(std::numeric_limits<float>::infinity()),
+                       _mm256_cmp_ps(a, max_x, _CMP_GT_OQ));
+  return _mm256_blendv_ps(y, a, _mm256_cmp_ps(a, a, _CMP_UNORD_Q));
+}
+
+#endif
+
+// Rational approximation of tanh on [-9, 9]; outside of that range tanh is
+// +/-1 in single precision.
+template <typename Vec>
+Vec fast_tanh(const Vec& a) {
+  using T = typename Vec::value_type;
+  const Vec x = clamp(a, Vec(static_cast<T>(-9)), Vec(static_cast<T>(9)));
+  const Vec x2 = x * x;
+  Vec p = fmadd(x2, Vec(static_cast<T>(-2.76076847742355e-16)), Vec(static_cast<T>(2.00018790482477e-13)));
+  p = fmadd(x2, p, Vec(static_cast<T>(-8.60467152213735e-11)));
+  p = fmadd(x2, p, Vec(static_cast<T>(5.12229709037114e-08)));
+  p = fmadd(x2, p, Vec(static_cast<T>(1.48572235717979e-05)));
+  p = fmadd(x2, p, Vec(static_cast<T>(6.37261928875436e-04)));
+  p = fmadd(x2, p, Vec(static_cast<T>(4.89352455891786e-03)));
+  p = x * p;
+  Vec q = fmadd(x2, Vec(static_cast<T>(1.19825839466702e-06)), Vec(static_cast<T>(1.18534705686654e-04)));
+  q = fmadd(x2, q, Vec(static_cast<T>(2.26843463243900e-03)));
+  q = fmadd(x2, q, Vec(static_cast<T>(4.89352518554385e-03)));
+  return p / q;
+}
+
+template <typename Vec>
+Vec fast_sigmoid(const Vec& x) {
+  using T = typename Vec::value_type;
+  return (Vec(static_cast<T>(1)) + fast_exp(x.neg())).reciprocal();
+}
+
+template <typename Vec>
+Vec fast_erfinv(const Vec& y) {
+  return vec_erfinv<Vec, /*newton_steps=*/1>(y);
+}
+
+}}}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <ATen/cpu/vec512/vec512_base.h>
+#include <ATen/cpu/vec512/vec512_float.h>
+#include <ATen/cpu/vec512/vec512_double.h>
+#include <ATen/cpu/vec512/vec512_int.h>
+
+#include <iostream>
+
+namespace at {
+namespace vec512 {
+// See Note [Acceptable use of anonymous namespace in header]
+namespace {
+
+// The widest vector type of the CPU capability this translation unit is
+// compiled for. Kernels in native/cpu that write their vectorized lambdas
+// against Vectorized<scalar_t> use 512-bit vectors in their AVX512 build and
+// Vec256 otherwise; Loops.h and Reduce.h pick the width up from the lambda.
+#if defined(CPU_CAPABILITY_AVX512) && !defined(_MSC_VER)
+template <typename T>
+using Vectorized = Vec512<T>;
+#else
+template <typename T>
+using Vectorized = vec256::Vec256<T>;
+#endif
+
+template <typename T>
+std::ostream& operator<<(std::ostream& stream, const Vec512<T>& vec) {
+  T buf[Vec512<T>::size()];
+  vec.store(buf);
+  stream << "vec[";
+  for (int i = 0; i != Vec512<T>::size(); i++) {
+    if (i != 0) {
+      stream << ", ";
+    }
+    stream << buf[i];
+  }
+  stream << "]";
+  return stream;
+}
+
+}}}
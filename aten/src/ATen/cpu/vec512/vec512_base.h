@@ -0,0 +1,200 @@
+#pragma once
+
+#include <ATen/cpu/vec256/vec256.h>
+
+#if defined(__GNUC__)
+#define __at_align64__ __attribute__((aligned(64)))
+#elif defined(_WIN32)
+#define __at_align64__ __declspec(align(64))
+#else
+#define __at_align64__
+#endif
+
+namespace at {
+namespace vec512 {
+// See Note [Acceptable use of anonymous namespace in header]
+namespace {
+
+using vec256::Vec256;
+
+// NOTE: If you specialize on a type, you must define all operations!
+
+// Emulates a 512-bit vector with two Vec256 halves, so that every operation
+// is available for every type that Vec256 supports. Types with native AVX-512
+// support specialize this in the other vec512_*.h headers.
+template <class T>
+struct Vec512 {
+private:
+  Vec256<T> lo_;
+  Vec256<T> hi_;
+public:
+  using value_type = T;
+  // See Note [constexpr static function to avoid odr-usage compiler bug]
+  static constexpr int size() {
+    return 2 * half_size();
+  }
+  static constexpr int half_size() {
+    return Vec256<T>::size();
+  }
+  Vec512() {}
+  Vec512(T val) : lo_(val), hi_(val) {}
+  Vec512(const Vec256<T>& lo, const Vec256<T>& hi) : lo_(lo), hi_(hi) {}
+  const Vec256<T>& lo() const {
+    return lo_;
+  }
+  const Vec256<T>& hi() const {
+    return hi_;
+  }
+  static Vec512<T> blendv(const Vec512<T>& a, const Vec512<T>& b,
+                          const Vec512<T>& mask) {
+    return Vec512<T>(Vec256<T>::blendv(a.lo_, b.lo_, mask.lo_),
+                     Vec256<T>::blendv(a.hi_, b.hi_, mask.hi_));
+  }
+  static Vec512<T> arange(T base = static_cast<T>(0), T step = static_cast<T>(1)) {
+    return Vec512<T>(Vec256<T>::arange(base, step),
+                     Vec256<T>::arange(base + half_size() * step, step));
+  }
+  static Vec512<T> set(const Vec512<T>& a, const Vec512<T>& b, int64_t count = size()) {
+    if (count <= half_size()) {
+      return Vec512<T>(Vec256<T>::set(a.lo_, b.lo_, count), a.hi_);
+    }
+    return Vec512<T>(b.lo_, Vec256<T>::set(a.hi_, b.hi_, count - half_size()));
+  }
+  static Vec512<T> loadu(const void* ptr, int64_t count = size()) {
+    const T* data = reinterpret_cast<const T*>(ptr);
+    if (count == size()) {
+      return Vec512<T>(Vec256<T>::loadu(data), Vec256<T>::loadu(data + half_size()));
+    }
+    if (count <= half_size()) {
+      return Vec512<T>(Vec256<T>::loadu(data, count), Vec256<T>(static_cast<T>(0)));
+    }
+    return Vec512<T>(Vec256<T>::loadu(data),
+                     Vec256<T>::loadu(data + half_size(), count - half_size()));
+  }
+  void store(void* ptr, int64_t count = size()) const {
+    T* data = reinterpret_cast<T*>(ptr);
+    if (count <= half_size()) {
+      lo_.store(data, count);
+    } else {
+      lo_.store(data);
+      hi_.store(data + half_size(), count - half_size());
+    }
+  }
+  const T& operator[](int idx) const  = delete;
+  T& operator[](int idx) = delete;
+  template <typename F>
+  Vec512<T> map(F f) const {
+    return Vec512<T>(lo_.map(f), hi_.map(f));
+  }
+
+#define DEFINE_UNARY(op)                       \
+  Vec512<T> op() const {                       \
+    return Vec512<T>(lo_.op(), hi_.op());      \
+  }
+
+  DEFINE_UNARY(abs)
+  DEFINE_UNARY(angle)
+  DEFINE_UNARY(real)
+  DEFINE_UNARY(imag)
+  DEFINE_UNARY(conj)
+  DEFINE_UNARY(acos)
+  DEFINE_UNARY(asin)
+  DEFINE_UNARY(atan)
+  DEFINE_UNARY(erf)
+  DEFINE_UNARY(erfc)
+  DEFINE_UNARY(erfinv)
+  DEFINE_UNARY(exp)
+  DEFINE_UNARY(expm1)
+  DEFINE_UNARY(frac)
+  DEFINE_UNARY(log)
+  DEFINE_UNARY(log10)
+  DEFINE_UNARY(log1p)
+  DEFINE_UNARY(log2)
+  DEFINE_UNARY(ceil)
+  DEFINE_UNARY(cos)
+  DEFINE_UNARY(cosh)
+  DEFINE_UNARY(floor)
+  DEFINE_UNARY(neg)
+  DEFINE_UNARY(round)
+  DEFINE_UNARY(sin)
+  DEFINE_UNARY(sinh)
+  DEFINE_UNARY(tan)
+  DEFINE_UNARY(tanh)
+  DEFINE_UNARY(trunc)
+  DEFINE_UNARY(lgamma)
+  DEFINE_UNARY(sqrt)
+  DEFINE_UNARY(reciprocal)
+  DEFINE_UNARY(rsqrt)
+
+#undef DEFINE_UNARY
+
+  Vec512<T> atan2(const Vec512<T>& b) const {
+    return Vec512<T>(lo_.atan2(b.lo_), hi_.atan2(b.hi_));
+  }
+  Vec512<T> pow(const Vec512<T>& b) const {
+    return Vec512<T>(lo_.pow(b.lo_), hi_.pow(b.hi_));
+  }
+
+#define DEFINE_COMP(binary_pred)                                              \
+  Vec512<T> operator binary_pred(const Vec512<T>& other) const {              \
+    return Vec512<T>(lo_ binary_pred other.lo_, hi_ binary_pred other.hi_);   \
+  }
+
+  DEFINE_COMP(==)
+  DEFINE_COMP(!=)
+  DEFINE_COMP(>=)
+  DEFINE_COMP(<=)
+  DEFINE_COMP(>)
+  DEFINE_COMP(<)
+
+#undef DEFINE_COMP
+};
+
+#define DEFINE_BINARY_OP(op)                                                   \
+template <class T>                                                             \
+Vec512<T> inline operator op(const Vec512<T>& a, const Vec512<T>& b) {         \
+  return Vec512<T>(a.lo() op b.lo(), a.hi() op b.hi());                        \
+}
+
+DEFINE_BINARY_OP(+)
+DEFINE_BINARY_OP(-)
+DEFINE_BINARY_OP(*)
+DEFINE_BINARY_OP(/)
+DEFINE_BINARY_OP(&)
+DEFINE_BINARY_OP(|)
+DEFINE_BINARY_OP(^)
+
+#undef DEFINE_BINARY_OP
+
+template <class T>
+Vec512<T> inline maximum(const Vec512<T>& a, const Vec512<T>& b) {
+  return Vec512<T>(vec256::maximum(a.lo(), b.lo()), vec256::maximum(a.hi(), b.hi()));
+}
+
+template <class T>
+Vec512<T> inline minimum(const Vec512<T>& a, const Vec512<T>& b) {
+  return Vec512<T>(vec256::minimum(a.lo(), b.lo()), vec256::minimum(a.hi(), b.hi()));
+}
+
+template <class T>
+Vec512<T> inline clamp(const Vec512<T>& a, const Vec512<T>& min_vec, const Vec512<T>& max_vec) {
+  return Vec512<T>(vec256::clamp(a.lo(), min_vec.lo(), max_vec.lo()),
+                   vec256::clamp(a.hi(), min_vec.hi(), max_vec.hi()));
+}
+
+template <class T>
+Vec512<T> inline clamp_max(const Vec512<T>& a, const Vec512<T>& max_vec) {
+  return Vec512<T>(vec256::clamp_max(a.lo(), max_vec.lo()), vec256::clamp_max(a.hi(), max_vec.hi()));
+}
+
+template <class T>
+Vec512<T> inline clamp_min(const Vec512<T>& a, const Vec512<T>& min_vec) {
+  return Vec512<T>(vec256::clamp_min(a.lo(), min_vec.lo()), vec256::clamp_min(a.hi(), min_vec.hi()));
+}
+
+template <class T>
+Vec512<T> inline fmadd(const Vec512<T>& a, const Vec512<T>& b, const Vec512<T>& c) {
+  return Vec512<T>(vec256::fmadd(a.lo(), b.lo(), c.lo()), vec256::fmadd(a.hi(), b.hi(), c.hi()));
+}
+
+}}}
@@ -0,0 +1,203 @@
+#pragma once
+
+#include <ATen/cpu/vec256/intrinsics.h>
+#include <ATen/cpu/vec512/vec512_base.h>
+
+namespace at {
+namespace vec512 {
+namespace {
+
+#if defined(CPU_CAPABILITY_AVX512) && !defined(_MSC_VER)
+
+struct Vec512i {
+protected:
+  __m512i values;
+public:
+  Vec512i() {}
+  Vec512i(__m512i v) : values(v) {}
+  operator __m512i() const {
+    return values;
+  }
+};
+
+// Int32 and int64 share everything except the lane width, so both are
+// generated from this macro. `epi` is the intrinsic suffix, `mask_t` the
+// AVX-512 mask type with one bit per lane.
+#define DEFINE_VEC512_INT(int_t, epi, mask_t, nlanes)                          \
+template <>                                                                    \
+struct Vec512<int_t> : public Vec512i {                                        \
+private:                                                                       \
+  static inline __m512i from_mask(mask_t mask) {                               \
+    return _mm512_maskz_set1_##epi(mask, -1);                                  \
+  }                                                                            \
+public:                                                                        \
+  using value_type = int_t;                                                    \
+  static constexpr int size() {                                                \
+    return nlanes;                                                             \
+  }                                                                            \
+  using Vec512i::Vec512i;                                                      \
+  Vec512() {}                                                                  \
+  Vec512(int_t v) { values = _mm512_set1_##epi(v); }                           \
+  template <int64_t mask>                                                      \
+  static Vec512<int_t> blend(Vec512<int_t> a, Vec512<int_t> b) {               \
+    return _mm512_mask_blend_##epi(static_cast<mask_t>(mask), a.values, b.values); \
+  }                                                                            \
+  static Vec512<int_t> blendv(const Vec512<int_t>& a, const Vec512<int_t>& b,  \
+                              const Vec512<int_t>& mask) {                     \
+    auto mask_ = _mm512_test_##epi##_mask(mask.values, mask.values);           \
+    return _mm512_mask_blend_##epi(mask_, a.values, b.values);                 \
+  }                                                                            \
+  static Vec512<int_t> arange(int_t base = 0, int_t step = 1) {                \
+    __at_align64__ int_t tmp[nlanes];                                          \
+    for (int64_t i = 0; i < nlanes; i++) {                                     \
+      tmp[i] = base + i * step;                                                \
+    }                                                                          \
+    return loadu(tmp);                                                         \
+  }                                                                            \
+  static Vec512<int_t> set(Vec512<int_t> a, Vec512<int_t> b, int64_t count = size()) { \
+    return _mm512_mask_blend_##epi((mask_t)((1U << count) - 1), a.values, b.values); \
+  }                                                                            \
+  static Vec512<int_t> loadu(const void* ptr, int64_t count = size()) {        \
+    if (count == size())                                                       \
+      return _mm512_loadu_si512(ptr);                                          \
+    return _mm512_maskz_loadu_##epi((mask_t)((1U << count) - 1), ptr);         \
+  }                                                                            \
+  void store(void* ptr, int64_t count = size()) const {                        \
+    if (count == size()) {                                                     \
+      _mm512_storeu_si512(ptr, values);                                        \
+    } else if (count > 0) {                                                    \
+      _mm512_mask_storeu_##epi(ptr, (mask_t)((1U << count) - 1), values);      \
+    }                                                                          \
+  }                                                                            \
+  const int_t& operator[](int idx) const  = delete;                            \
+  int_t& operator[](int idx) = delete;                                         \
+  Vec512<int_t> map(int_t (*f)(int_t)) const {                                 \
+    __at_align64__ int_t tmp[nlanes];                                          \
+    store(tmp);                                                                \
+    for (int64_t i = 0; i < nlanes; i++) {                                     \
+      tmp[i] = f(tmp[i]);                                                      \
+    }                                                                          \
+    return loadu(tmp);                                                         \
+  }                                                                            \
+  Vec512<int_t> abs() const {                                                  \
+    return _mm512_abs_##epi(values);                                           \
+  }                                                                            \
+  Vec512<int_t> angle() const {                                                \
+    return _mm512_set1_##epi(0);                                               \
+  }                                                                            \
+  Vec512<int_t> real() const {                                                 \
+    return *this;                                                              \
+  }                                                                            \
+  Vec512<int_t> imag() const {                                                 \
+    return _mm512_set1_##epi(0);                                               \
+  }                                                                            \
+  Vec512<int_t> conj() const {                                                 \
+    return *this;                                                              \
+  }                                                                            \
+  Vec512<int_t> frac() const {                                                 \
+    return _mm512_set1_##epi(0);                                               \
+  }                                                                            \
+  Vec512<int_t> neg() const {                                                  \
+    return _mm512_sub_##epi(_mm512_setzero_si512(), values);                   \
+  }                                                                            \
+  Vec512<int_t> operator==(const Vec512<int_t>& other) const {                 \
+    return from_mask(_mm512_cmpeq_##epi##_mask(values, other.values));         \
+  }                                                                            \
+  Vec512<int_t> operator!=(const Vec512<int_t>& other) const {                 \
+    return from_mask(_mm512_cmpneq_##epi##_mask(values, other.values));        \
+  }                                                                            \
+  Vec512<int_t> operator<(const Vec512<int_t>& other) const {                  \
+    return from_mask(_mm512_cmplt_##epi##_mask(values, other.values));         \
+  }                                                                            \
+  Vec512<int_t> operator<=(const Vec512<int_t>& other) const {                 \
+    return from_mask(_mm512_cmple_##epi##_mask(values, other.values));         \
+  }                                                                            \
+  Vec512<int_t> operator>(const Vec512<int_t>& other) const {                  \
+    return from_mask(_mm512_cmpgt_##epi##_mask(values, other.values));         \
+  }                                                                            \
+  Vec512<int_t> operator>=(const Vec512<int_t>& other) const {                 \
+    return from_mask(_mm512_cmpge_##epi##_mask(values, other.values));         \
+  }                                                                            \
+};                                                                             \
+                                                                               \
+template <>                                                                    \
+Vec512<int_t> inline operator+(const Vec512<int_t>& a, const Vec512<int_t>& b) { \
+  return _mm512_add_##epi(a, b);                                               \
+}                                                                              \
+                                                                               \
+template <>                                                                    \
+Vec512<int_t> inline operator-(const Vec512<int_t>& a, const Vec512<int_t>& b) { \
+  return _mm512_sub_##epi(a, b);                                               \
+}                                                                              \
+                                                                               \
+template <>                                                                    \
+Vec512<int_t> inline operator*(const Vec512<int_t>& a, const Vec512<int_t>& b) { \
+  return _mm512_mullo_##epi(a, b);                                             \
+}                                                                              \
+                                                                               \
+template <>                                                                    \
+Vec512<int_t> inline operator/(const Vec512<int_t>& a, const Vec512<int_t>& b) { \
+  /* There's no SIMD integer division */                                       \
+  __at_align64__ int_t tmp_a[nlanes];                                          \
+  __at_align64__ int_t tmp_b[nlanes];                                          \
+  a.store(tmp_a);                                                              \
+  b.store(tmp_b);                                                              \
+  for (int64_t i = 0; i < nlanes; i++) {                                       \
+    tmp_a[i] /= tmp_b[i];                                                      \
+  }                                                                            \
+  return Vec512<int_t>::loadu(tmp_a);                                          \
+}                                                                              \
+                                                                               \
+template <>                                                                    \
+Vec512<int_t> inline minimum(const Vec512<int_t>& a, const Vec512<int_t>& b) { \
+  return _mm512_min_##epi(a, b);                                               \
+}                                                                              \
+                                                                               \
+template <>                                                                    \
+Vec512<int_t> inline maximum(const Vec512<int_t>& a, const Vec512<int_t>& b) { \
+  return _mm512_max_##epi(a, b);                                               \
+}                                                                              \
+                                                                               \
+template <>                                                                    \
+Vec512<int_t> inline clamp(const Vec512<int_t>& a, const Vec512<int_t>& min_val, const Vec512<int_t>& max_val) { \
+  return _mm512_min_##epi(max_val, _mm512_max_##epi(a, min_val));              \
+}                                                                              \
+                                                                               \
+template <>                                                                    \
+Vec512<int_t> inline clamp_max(const Vec512<int_t>& a, const Vec512<int_t>& max_val) { \
+  return _mm512_min_##epi(max_val, a);                                         \
+}                                                                              \
+                                                                               \
+template <>                                                                    \
+Vec512<int_t> inline clamp_min(const Vec512<int_t>& a, const Vec512<int_t>& min_val) { \
+  return _mm512_max_##epi(min_val, a);                                         \
+}                                                                              \
+                                                                               \
+template <>                                                                    \
+Vec512<int_t> inline operator&(const Vec512<int_t>& a, const Vec512<int_t>& b) { \
+  return _mm512_and_si512(a, b);                                               \
+}                                                                              \
+                                                                               \
+template <>                                                                    \
+Vec512<int_t> inline operator|(const Vec512<int_t>& a, const Vec512<int_t>& b) { \
+  return _mm512_or_si512(a, b);                                                \
+}                                                                              \
+                                                                               \
+template <>                                                                    \
+Vec512<int_t> inline operator^(const Vec512<int_t>& a, const Vec512<int_t>& b) { \
+  return _mm512_xor_si512(a, b);                                               \
+}                                                                              \
+                                                                               \
+template <>                                                                    \
+Vec512<int_t> inline fmadd(const Vec512<int_t>& a, const Vec512<int_t>& b, const Vec512<int_t>& c) { \
+  return a * b + c;                                                            \
+}
+
+DEFINE_VEC512_INT(int64_t, epi64, __mmask8, 8)
+DEFINE_VEC512_INT(int32_t, epi32, __mmask16, 16)
+
+#undef DEFINE_VEC512_INT
+
+#endif
+
+}}}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <ATen/cpu/vec256/vec256_math.h>
+#include <ATen/cpu/vec512/vec512.h>
+
+namespace at {
+namespace vec512 {
+// See Note [Acceptable use of anonymous namespace in header]
+namespace {
+
+#if defined(CPU_CAPABILITY_AVX512) && !defined(_MSC_VER)
+
+// See fast_exp(const Vec256<float>&) in vec256_math.h
+Vec512<float> inline fast_exp(const Vec512<float>& a) {
+  const __m512 max_x = _mm512_set1_ps(88.72283935546875f);
+  const __m512 x = _mm512_min_ps(_mm512_max_ps(a, _mm512_set1_ps(-103.972084f)), max_x);
+  const __m512 n = _mm512_roundscale_ps(
+      _mm512_fmadd_ps(x, _mm512_set1_ps(1.44269504088896341f), _mm512_set1_ps(0.5f)),
+      (_MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC));
+  __m512 r = _mm512_fnmadd_ps(n, _mm512_set1_ps(0.693359375f), x);
+  r = _mm512_fnmadd_ps(n, _mm512_set1_ps(-2.12194440e-4f), r);
+  __m512 y = _mm512_set1_ps(1.9875691500E-4f);
+  y = _mm512_fmadd_ps(y, r, _mm512_set1_ps(1.3981999507E-3f));
+  y = _mm512_fmadd_ps(y, r, _mm512_set1_ps(8.3334519073E-3f));
+  y = _mm512_fmadd_ps(y, r, _mm512_set1_ps(4.1665795894E-2f));
+  y = _mm512_fmadd_ps(y, r, _mm512_set1_ps(1.6666665459E-1f));
+  y = _mm512_fmadd_ps(y, r, _mm512_set1_ps(5.0000001201E-1f));
+  y = _mm512_fmadd_ps(y, _mm512_mul_ps(r, r), _mm512_add_ps(r, _mm512_set1_ps(1.f)));
+  const __m512i n_int = _mm512_cvttps_epi32(n);
+  const __m512i n_hi = _mm512_srai_epi32(n_int, 1);
+  const __m512i bias = _mm512_set1_epi32(0x7f);
+  y = _mm512_mul_ps(y, _mm512_castsi512_ps(_mm512_slli_epi32(_mm512_add_epi32(n_hi, bias), 23)));
+  y = _mm512_mul_ps(y, _mm512_castsi512_ps(_mm512_slli_epi32(
+      _mm512_add_epi32(_mm512_sub_epi32(n_int, n_hi), bias), 23)));
+  // the clamp above swallows overflow and NaN, put them back
+  y = _mm512_mask_blend_ps(_mm512_cmp_ps_mask(a, max_x, _CMP_GT_OQ), y,
+                           _mm512_set1_ps(std::numeric_limits<float>::infinity()));
+  return _mm512_mask_blend_ps(_mm512_cmp_ps_mask(a, a, _CMP_UNORD_Q), y, a);
+}
+
+#endif
+
+}}}
@@ -4,6 +4,7 @@
 #include <ATen/Parallel.h>
 #include <ATen/cpu/vec256/functional.h>
 #include <ATen/cpu/vec256/vec256.h>
+#include <ATen/cpu/vec256/vec256_math.h>
 
 // This header implements various unary operations using a MKL VML style
 // interface.
@@ -37,10 +38,13 @@
 // [Note SSE-AVX transitions]
 // There is a bug in Glibc2.23
 // https://bugs.launchpad.net/ubuntu/+source/glibc/+bug/1663280. Calling zeroall
-// when using AVX/AVX2 code resolves this.
+// when using AVX/AVX2 code resolves this. BFloat16 math is computed in float.
 #if defined(__AVX__) && defined(__GLIBC__) && __GLIBC_MINOR__ == 23
 #define DL_RUNTIME_BUG(op, type)                              \
-  using value_t = typename at::native::ztype<type>::value_t;  \
+  using value_t = typename std::conditional<                  \
+      std::is_same<type, c10::BFloat16>::value,               \
+      float,                                                  \
+      typename at::native::ztype<type>::value_t>::type;       \
   volatile value_t x = (value_t)(1);                          \
   x = std::op(x);                                             \
   _mm256_zeroall();
@@ -67,6 +71,17 @@ inline void vrsqrt(scalar_t* out, scalar_t* in, int64_t size) {
   });
 }
 
+template <typename scalar_t>
+inline void verfinv(scalar_t* out, const scalar_t* in, int64_t size) {
+  parallel_for(0, size, 2048, [out, in](int64_t begin, int64_t end) {
+    map(
+        [](const Vec256<scalar_t>& x) { return vec_erfinv(x); },
+        out + begin,
+        in + begin,
+        end - begin);
+  });
+}
+
 // NB: We ignore numerical errors by convention and leave them to the user
 
 // We unfortunately need to duplicate code here to deal with the SSE-AVX
@@ -107,7 +122,6 @@ IMPLEMENT_VML_BUG(cos)
 // IMPLEMENT_VML_BUG(cosh)
 IMPLEMENT_VML_BUG(erf)
 IMPLEMENT_VML_BUG(erfc)
-IMPLEMENT_VML(erfinv)
 IMPLEMENT_VML_BUG(exp)
 IMPLEMENT_VML_BUG(expm1)
 IMPLEMENT_VML_BUG(floor)
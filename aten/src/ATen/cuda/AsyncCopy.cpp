@@ -0,0 +1,30 @@
+#include <ATen/cuda/AsyncCopy.h>
+#include <c10/cuda/CUDAGuard.h>
+
+namespace at { namespace cuda {
+
+HostCopyFuture::HostCopyFuture(Tensor result, CUDAEvent event)
+    : result_(std::move(result)),
+      event_(std::make_shared<CUDAEvent>(std::move(event))) {}
+
+bool HostCopyFuture::done() const {
+  return event_->query();
+}
+
+const Tensor& HostCopyFuture::wait() const {
+  event_->synchronize();
+  return result_;
+}
+
+HostCopyFuture copy_to_host_async(const Tensor& src) {
+  TORCH_CHECK(src.is_cuda(), "copy_to_host_async: expected a CUDA tensor, but got a tensor on ", src.device());
+  CUDAGuard device_guard(src.device());
+  auto result = at::empty(src.sizes(), src.options().device(kCPU).pinned_memory(true));
+  // copy_ records the use of the pinned block on the current stream
+  result.copy_(src.detach(), /*non_blocking=*/true);
+  CUDAEvent event;
+  event.record(getCurrentCUDAStream());
+  return HostCopyFuture(std::move(result), std::move(event));
+}
+
+}} // namespace at::cuda
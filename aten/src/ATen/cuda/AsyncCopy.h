@@ -0,0 +1,41 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <ATen/cuda/ATenCUDAGeneral.h>
+#include <ATen/cuda/CUDAEvent.h>
+
+#include <memory>
+
+namespace at { namespace cuda {
+
+/*
+* HostCopyFuture is the result of copy_to_host_async: a CPU tensor and an
+* event recorded on the stream of the copy, after the copy. The tensor must
+* not be read before done() returns true or wait() returns.
+*
+*   auto future = copy_to_host_async(output);
+*   ... // launch the work of the next request
+*   const Tensor& result = future.wait();
+*
+* Copies of a HostCopyFuture refer to the same copy.
+*/
+struct TORCH_CUDA_API HostCopyFuture {
+  HostCopyFuture(Tensor result, CUDAEvent event);
+
+  // Whether the copy has completed. Does not block.
+  bool done() const;
+  // Blocks the calling thread until the copy has completed.
+  const Tensor& wait() const;
+
+ private:
+  Tensor result_;
+  std::shared_ptr<CUDAEvent> event_;
+};
+
+// Enqueues a copy of the CUDA tensor src into a new pinned CPU tensor on the
+// current stream, without synchronizing. The pinned memory comes from the
+// caching host allocator, which does not reuse it before the copy is done.
+// The result is contiguous and does not require grad.
+TORCH_CUDA_API HostCopyFuture copy_to_host_async(const Tensor& src);
+
+}} // namespace at::cuda
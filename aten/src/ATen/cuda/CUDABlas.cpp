@@ -263,6 +263,58 @@ void gemm<at::Half>(CUDABLAS_GEMM_ARGTYPES(at::Half)) {
 #endif
 }
 
+void gemm_s8s32(
+    cudaStream_t stream,
+    char transa,
+    char transb,
+    int64_t m,
+    int64_t n,
+    int64_t k,
+    int32_t alpha,
+    const int8_t* a,
+    int64_t lda,
+    const int8_t* b,
+    int64_t ldb,
+    int32_t beta,
+    int32_t* c,
+    int64_t ldc) {
+#if defined(__HIP_PLATFORM_HCC__) || CUDA_VERSION < 8000
+  AT_ERROR("at::cuda::blas::gemm_s8s32: not supported on this platform");
+#else
+  TORCH_CHECK(
+      (transa == 't' || transa == 'T') && (transb == 'n' || transb == 'N'),
+      "at::cuda::blas::gemm_s8s32 only supports transa = 't' and transb = 'n'");
+  TORCH_CHECK(
+      lda % 4 == 0 && ldb % 4 == 0 && ldc % 4 == 0,
+      "at::cuda::blas::gemm_s8s32 expects lda, ldb and ldc to be multiples of 4");
+  cublasHandle_t handle = at::cuda::getCurrentCUDABlasHandle();
+  cublasOperation_t opa = _cublasOpFromChar(transa);
+  cublasOperation_t opb = _cublasOpFromChar(transb);
+  GEMM_CHECK_ARGVALUES(int8_t);
+  TORCH_CUDABLAS_CHECK(cublasSetStream(handle, stream));
+  TORCH_CUDABLAS_CHECK(cublasGemmEx(
+      handle,
+      opa,
+      opb,
+      m,
+      n,
+      k,
+      &alpha,
+      a,
+      CUDA_R_8I,
+      lda,
+      b,
+      CUDA_R_8I,
+      ldb,
+      &beta,
+      c,
+      CUDA_R_32I,
+      ldc,
+      CUDA_R_32I,
+      CUBLAS_GEMM_DFALT));
+#endif
+}
+
 /* LEVEL 2 BLAS FUNCTIONS */
 
 #define GEMV_CHECK_ARGVALUES(Dtype)           \
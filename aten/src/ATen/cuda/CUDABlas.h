@@ -7,7 +7,12 @@
 
     gemv<Dtype>(stream, transa, m, n, alpha, a, lda, x, incx, beta, y, incy)
 
-  where Dtype is double, float, or at::Half. The functions are
+  where Dtype is double, float, or at::Half, and
+
+    gemm_s8s32(stream, transa, transb, m, n, k, alpha, a, lda, b, ldb, beta, c,
+  ldc)
+
+  with int8 a and b and int32 alpha, beta and c. The functions are
   available in at::cuda::blas namespace.
  */
 
@@ -36,6 +41,25 @@ void gemm<float>(CUDABLAS_GEMM_ARGTYPES(float));
 template <>
 void gemm<at::Half>(CUDABLAS_GEMM_ARGTYPES(at::Half));
 
+// Accumulates in int32. cuBLAS only supports transa == 't' and transb == 'n',
+// lda, ldb and ldc that are multiples of 4 and devices of compute capability
+// 6.1 and up for it.
+void gemm_s8s32(
+    cudaStream_t stream,
+    char transa,
+    char transb,
+    int64_t m,
+    int64_t n,
+    int64_t k,
+    int32_t alpha,
+    const int8_t* a,
+    int64_t lda,
+    const int8_t* b,
+    int64_t ldb,
+    int32_t beta,
+    int32_t* c,
+    int64_t ldc);
+
 /* LEVEL 2 BLAS FUNCTIONS */
 
 #define CUDABLAS_GEMV_ARGTYPES(Dtype)                                        \
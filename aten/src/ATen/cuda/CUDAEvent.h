@@ -2,6 +2,7 @@
 
 #include <ATen/cuda/ATenCUDAGeneral.h>
 #include <ATen/cuda/CUDAContext.h>
+#include <c10/cuda/CUDACachingAllocator.h>
 #include <c10/cuda/CUDAStream.h>
 #include <c10/cuda/CUDAGuard.h>
 #include <ATen/cuda/Exceptions.h>
@@ -113,6 +114,7 @@ struct TORCH_CUDA_API CUDAEvent {
     TORCH_CHECK(device_index_ == stream.device_index(), "Event device ", device_index_,
       " does not match recording stream's device ", stream.device_index(), ".");
     CUDAGuard guard(device_index_);
+    c10::cuda::CUDACachingAllocator::notifyEventRecorded(event_, stream);
     AT_CUDA_CHECK(cudaEventRecord(event_, stream));
     was_recorded_ = true;
   }
@@ -123,6 +125,7 @@ struct TORCH_CUDA_API CUDAEvent {
     if (is_created_) {
       CUDAGuard guard(stream.device_index());
       AT_CUDA_CHECK(cudaStreamWaitEvent(stream, event_, 0));
+      c10::cuda::CUDACachingAllocator::notifyStreamWaitEvent(event_, stream);
     }
   }
 
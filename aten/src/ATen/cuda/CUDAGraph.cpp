@@ -0,0 +1,124 @@
+#include <ATen/cuda/CUDAGraph.h>
+#include <ATen/cuda/Exceptions.h>
+#include <c10/cuda/CUDACachingAllocator.h>
+#include <c10/cuda/CUDAGuard.h>
+
+#include <atomic>
+
+namespace at { namespace cuda {
+
+#if !defined(__HIP_PLATFORM_HCC__) && CUDA_VERSION >= 10010
+
+namespace {
+
+// 0 is the regular pools of the allocator
+uint64_t next_pool_id() {
+  static std::atomic<uint64_t> pool_id{1};
+  return pool_id++;
+}
+
+} // namespace
+
+CUDAGraph::CUDAGraph() {}
+
+CUDAGraph::~CUDAGraph() {
+  try {
+    reset();
+  } catch (...) { /* No throw */ }
+}
+
+void CUDAGraph::capture_begin() {
+  TORCH_CHECK(!has_graph_exec_,
+      "CUDAGraph::capture_begin: this graph was already captured; call reset() before capturing it again");
+  TORCH_CHECK(pool_id_ == 0, "CUDAGraph::capture_begin: a capture is already underway");
+
+  const auto stream = getCurrentCUDAStream();
+  TORCH_CHECK(stream != getDefaultCUDAStream(),
+      "CUDAGraph::capture_begin: the default stream cannot be captured, capture on a side stream instead");
+
+  capture_device_ = stream.device_index();
+  capture_stream_ = stream.stream();
+  pool_id_ = next_pool_id();
+  c10::cuda::CUDACachingAllocator::notifyCaptureBegin(capture_device_, capture_stream_, pool_id_);
+
+  // In global mode, calls that are unsafe during capture, like
+  // cudaStreamSynchronize, fail in every thread instead of silently breaking
+  // the capture.
+  cudaError_t err = cudaStreamBeginCapture(capture_stream_, cudaStreamCaptureModeGlobal);
+  if (err != cudaSuccess) {
+    c10::cuda::CUDACachingAllocator::notifyCaptureEnd(capture_device_, capture_stream_);
+    c10::cuda::CUDACachingAllocator::releasePool(pool_id_);
+    pool_id_ = 0;
+    AT_CUDA_CHECK(err);
+  }
+}
+
+void CUDAGraph::capture_end() {
+  TORCH_CHECK(pool_id_ != 0 && !has_graph_exec_, "CUDAGraph::capture_end: no capture is underway");
+  const auto stream = getCurrentCUDAStream();
+  TORCH_CHECK(stream.stream() == capture_stream_,
+      "CUDAGraph::capture_end: expected the current stream to be the stream the capture began on");
+
+  cudaError_t err = cudaStreamEndCapture(capture_stream_, &graph_);
+  c10::cuda::CUDACachingAllocator::notifyCaptureEnd(capture_device_, capture_stream_);
+  AT_CUDA_CHECK(err);
+  TORCH_CHECK(graph_ != nullptr, "CUDAGraph::capture_end: the capture was invalidated");
+  has_graph_ = true;
+
+  AT_CUDA_CHECK(cudaGraphInstantiate(&graph_exec_, graph_, nullptr, nullptr, 0));
+  has_graph_exec_ = true;
+
+  // The executable graph holds everything a replay needs.
+  AT_CUDA_CHECK(cudaGraphDestroy(graph_));
+  has_graph_ = false;
+}
+
+void CUDAGraph::replay() {
+  TORCH_CHECK(has_graph_exec_, "CUDAGraph::replay: the graph has not been captured");
+  CUDAGuard device_guard(capture_device_);
+  AT_CUDA_CHECK(cudaGraphLaunch(graph_exec_, getCurrentCUDAStream()));
+}
+
+void CUDAGraph::reset() {
+  if (pool_id_ == 0) {
+    return;
+  }
+  CUDAGuard device_guard(capture_device_);
+  if (has_graph_exec_) {
+    // Replays may still be running; their memory must not be reused before
+    // they finish.
+    AT_CUDA_CHECK(cudaDeviceSynchronize());
+    AT_CUDA_CHECK(cudaGraphExecDestroy(graph_exec_));
+    has_graph_exec_ = false;
+  }
+  if (has_graph_) {
+    AT_CUDA_CHECK(cudaGraphDestroy(graph_));
+    has_graph_ = false;
+  }
+  c10::cuda::CUDACachingAllocator::releasePool(pool_id_);
+  pool_id_ = 0;
+}
+
+#else
+
+CUDAGraph::CUDAGraph() {}
+
+CUDAGraph::~CUDAGraph() {}
+
+void CUDAGraph::capture_begin() {
+  TORCH_CHECK(false, "CUDA graphs need CUDA 10.1 or newer");
+}
+
+void CUDAGraph::capture_end() {
+  TORCH_CHECK(false, "CUDA graphs need CUDA 10.1 or newer");
+}
+
+void CUDAGraph::replay() {
+  TORCH_CHECK(false, "CUDA graphs need CUDA 10.1 or newer");
+}
+
+void CUDAGraph::reset() {}
+
+#endif
+
+}} // namespace at::cuda
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <ATen/cuda/ATenCUDAGeneral.h>
+#include <ATen/cuda/CUDAContext.h>
+#include <c10/cuda/CUDAStream.h>
+
+#include <cuda_runtime_api.h>
+
+#include <cstdint>
+
+namespace at { namespace cuda {
+
+/*
+* CUDAGraph records the kernels that a static-shape step (e.g., a forward,
+* backward and optimizer step) launches on the current stream and replays
+* them with a single cudaGraphLaunch, which removes the per-kernel launch
+* overhead of the allocator, the dispatcher and the driver.
+*
+*   CUDAGraph graph;
+*   // on a side stream; the default stream cannot be captured
+*   graph.capture_begin();
+*   out = step(static_input);
+*   graph.capture_end();
+*   ...
+*   static_input.copy_(next_input);
+*   graph.replay();  // out holds the result for next_input
+*
+* Kernels are not run during capture. A replay reads and writes the same
+* addresses as the captured kernels did, so inputs have to be copied into the
+* tensors used during capture, and the outputs are only valid until the next
+* replay. Memory allocated during capture comes from a private pool of the
+* caching allocator that lives as long as the graph, so it is never handed to
+* other allocations. Work that must not be captured includes anything that
+* synchronizes with the host (e.g., .item() or nonzero()) and ops that draw
+* random numbers, whose seeds and offsets would be frozen into the graph.
+*
+* Needs CUDA 10.1 or newer; the methods throw otherwise.
+*/
+struct TORCH_CUDA_API CUDAGraph {
+  CUDAGraph();
+  ~CUDAGraph();
+
+  CUDAGraph(const CUDAGraph&) = delete;
+  CUDAGraph& operator=(const CUDAGraph&) = delete;
+
+  // Starts capturing the work submitted to the current stream.
+  void capture_begin();
+  // Ends the capture and instantiates the graph.
+  void capture_end();
+  // Launches the captured work on the current stream.
+  void replay();
+  // Destroys the graph and returns its private pool to the allocator.
+  void reset();
+
+  // id of the private memory pool of the allocator
+  uint64_t pool() const { return pool_id_; }
+
+ private:
+#if !defined(__HIP_PLATFORM_HCC__) && CUDA_VERSION >= 10010
+  cudaGraph_t graph_ = nullptr;
+  cudaGraphExec_t graph_exec_ = nullptr;
+#endif
+  bool has_graph_ = false;
+  bool has_graph_exec_ = false;
+  uint64_t pool_id_ = 0;
+  DeviceIndex capture_device_ = -1;
+  cudaStream_t capture_stream_ = nullptr;
+};
+
+}} // namespace at::cuda
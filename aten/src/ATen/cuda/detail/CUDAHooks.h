@@ -23,6 +23,7 @@ struct CUDAHooks : public at::CUDAHooksInterface {
   bool hasPrimaryContext(int64_t device_index) const override;
   c10::optional<int64_t> getDevceIndexWithPrimaryContext() const override;
   Allocator* getPinnedMemoryAllocator() const override;
+  Allocator* getCUDADeviceAllocator() const override;
   bool compiledWithCuDNN() const override;
   bool compiledWithMIOpen() const override;
   bool supportsDilatedConvolutionWithCuDNN() const override;
@@ -34,6 +35,14 @@ struct CUDAHooks : public at::CUDAHooksInterface {
   void cuFFTSetPlanCacheMaxSize(int64_t device_index, int64_t max_size) const override;
   int64_t cuFFTGetPlanCacheSize(int64_t device_index) const override;
   void cuFFTClearPlanCache(int64_t device_index) const override;
+  int64_t cuFFTGetPlanCacheMaxBytes(int64_t device_index) const override;
+  void cuFFTSetPlanCacheMaxBytes(int64_t device_index, int64_t max_bytes) const override;
+  int64_t cuFFTGetPlanCacheBytes(int64_t device_index) const override;
+  int64_t cuFFTGetPlanCacheHits(int64_t device_index) const override;
+  int64_t cuFFTGetPlanCacheMisses(int64_t device_index) const override;
+  int64_t cuFFTGetPlanCacheEvictions(int64_t device_index) const override;
+  void cuDNNSaveBenchmarkCache(const std::string& path) const override;
+  int64_t cuDNNLoadBenchmarkCache(const std::string& path) const override;
   int getNumGPUs() const override;
 };
 
@@ -107,6 +107,10 @@ struct CAFFE2_API CUDAHooksInterface {
     TORCH_CHECK(false, "Pinned memory requires CUDA. ", CUDA_HELP);
   }
 
+  virtual Allocator* getCUDADeviceAllocator() const {
+    TORCH_CHECK(false, "Cannot allocate CUDA memory without ATen_cuda library. ", CUDA_HELP);
+  }
+
   virtual bool compiledWithCuDNN() const {
     return false;
   }
@@ -152,6 +156,38 @@ struct CAFFE2_API CUDAHooksInterface {
     TORCH_CHECK(false, "Cannot access cuFFT plan cache without ATen_cuda library. ", CUDA_HELP);
   }
 
+  virtual int64_t cuFFTGetPlanCacheMaxBytes(int64_t device_index) const {
+    TORCH_CHECK(false, "Cannot access cuFFT plan cache without ATen_cuda library. ", CUDA_HELP);
+  }
+
+  virtual void cuFFTSetPlanCacheMaxBytes(int64_t device_index, int64_t max_bytes) const {
+    TORCH_CHECK(false, "Cannot access cuFFT plan cache without ATen_cuda library. ", CUDA_HELP);
+  }
+
+  virtual int64_t cuFFTGetPlanCacheBytes(int64_t device_index) const {
+    TORCH_CHECK(false, "Cannot access cuFFT plan cache without ATen_cuda library. ", CUDA_HELP);
+  }
+
+  virtual int64_t cuFFTGetPlanCacheHits(int64_t device_index) const {
+    TORCH_CHECK(false, "Cannot access cuFFT plan cache without ATen_cuda library. ", CUDA_HELP);
+  }
+
+  virtual int64_t cuFFTGetPlanCacheMisses(int64_t device_index) const {
+    TORCH_CHECK(false, "Cannot access cuFFT plan cache without ATen_cuda library. ", CUDA_HELP);
+  }
+
+  virtual int64_t cuFFTGetPlanCacheEvictions(int64_t device_index) const {
+    TORCH_CHECK(false, "Cannot access cuFFT plan cache without ATen_cuda library. ", CUDA_HELP);
+  }
+
+  virtual void cuDNNSaveBenchmarkCache(const std::string& path) const {
+    TORCH_CHECK(false, "Cannot access cuDNN benchmark cache without ATen_cuda library. ", CUDA_HELP);
+  }
+
+  virtual int64_t cuDNNLoadBenchmarkCache(const std::string& path) const {
+    TORCH_CHECK(false, "Cannot access cuDNN benchmark cache without ATen_cuda library. ", CUDA_HELP);
+  }
+
   virtual int getNumGPUs() const {
     return 0;
   }
@@ -1,6 +1,7 @@
 #include <ATen/ATen.h>
 #include <ATen/NativeFunctions.h>
 #include <ATen/Parallel.h>
+#include <ATen/native/AdaptivePooling.h>
 #include <tuple>
 
 
@@ -128,6 +129,14 @@ namespace {
     auto osizeH = output_size[0];
     auto osizeW = output_size[1];
 
+    if (input.ndimension() == 4 && input.suggest_memory_format() == at::MemoryFormat::ChannelsLast &&
+        input.scalar_type() != at::kHalf) {
+      output.resize_({input.size(-4), sizeD, osizeH, osizeW}, at::MemoryFormat::ChannelsLast);
+      adaptive_avg_pool2d_channels_last_kernel(
+        kCPU, output, input.contiguous(at::MemoryFormat::ChannelsLast));
+      return;
+    }
+
     /* resize output */
     if (input.ndimension() == 3 || input.size(-4) == 1)
     {
@@ -326,7 +335,7 @@ namespace {
       return at::mkldnn_adaptive_avg_pool2d(input, output_size);
     }
 
-    // TODO: fastpath for Channels_last should be explored later;
+    // channels last inputs go through the native NHWC kernel of _adaptive_avg_pool2d
     if (input.suggest_memory_format() == at::MemoryFormat::Contiguous && !input.is_quantized() && output_size[0] == 1 && output_size[1] == 1) {
       // in this case, adaptive pooling is just computing mean over hw
       // dimensions, which can be done more efficiently
@@ -360,5 +369,7 @@ namespace {
     return gradInput;
   }
 
+DEFINE_DISPATCH(adaptive_avg_pool2d_channels_last_kernel);
+
 } // at::native
 } // at
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <ATen/native/DispatchStub.h>
+
+namespace at {
+namespace native {
+
+// Kernel for 4D channels last (NHWC) inputs; output is expected to be
+// allocated in channels last by the caller.
+using adaptive_avg_pool2d_fn = void(*)(Tensor& output, const Tensor& input);
+
+DECLARE_DISPATCH(adaptive_avg_pool2d_fn, adaptive_avg_pool2d_channels_last_kernel);
+
+} // namespace native
+} // namespace at
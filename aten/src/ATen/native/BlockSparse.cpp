@@ -0,0 +1,135 @@
+#include <ATen/native/BlockSparse.h>
+
+#include <ATen/ATen.h>
+#include <ATen/NativeFunctions.h>
+
+namespace at {
+namespace native {
+
+DEFINE_DISPATCH(block_sparse_mm_stub);
+
+namespace {
+
+// The kernels trust the indices, so validate them where that is cheap. On
+// CUDA that would need a sync, so only their shapes are checked there.
+void check_block_sparse(
+    const Tensor& crow_indices,
+    const Tensor& col_indices,
+    const Tensor& values,
+    int64_t block_cols_count) {
+  TORCH_CHECK(crow_indices.dim() == 1 && crow_indices.numel() >= 1 && crow_indices.scalar_type() == kLong,
+      "block_sparse_mm: expected crow_indices to be a non-empty 1D long tensor");
+  TORCH_CHECK(col_indices.dim() == 1 && col_indices.scalar_type() == kLong,
+      "block_sparse_mm: expected col_indices to be a 1D long tensor");
+  TORCH_CHECK(values.dim() == 3,
+      "block_sparse_mm: expected values to be 3D [blocks, block rows, block cols], but got ",
+      values.dim(), "D");
+  TORCH_CHECK(values.size(0) == col_indices.numel(),
+      "block_sparse_mm: expected as many blocks in values as col_indices, but got ", values.size(0),
+      " and ", col_indices.numel());
+  TORCH_CHECK(crow_indices.device() == values.device() && col_indices.device() == values.device(),
+      "block_sparse_mm: expected the indices and values to be on the same device");
+  if (!values.device().is_cpu()) {
+    return;
+  }
+  auto crow_contig = crow_indices.contiguous();
+  auto col_contig = col_indices.contiguous();
+  const int64_t* crow_data = crow_contig.data_ptr<int64_t>();
+  const int64_t* col_data = col_contig.data_ptr<int64_t>();
+  const int64_t num_crow = crow_contig.numel();
+  TORCH_CHECK(crow_data[0] == 0, "block_sparse_mm: expected crow_indices to start at 0, but got ", crow_data[0]);
+  for (int64_t r = 1; r < num_crow; r++) {
+    TORCH_CHECK(crow_data[r - 1] <= crow_data[r], "block_sparse_mm: expected crow_indices to be non-decreasing");
+  }
+  TORCH_CHECK(crow_data[num_crow - 1] == col_contig.numel(),
+      "block_sparse_mm: expected crow_indices to end at the number of blocks ", col_contig.numel(),
+      ", but got ", crow_data[num_crow - 1]);
+  for (int64_t b = 0; b < col_contig.numel(); b++) {
+    TORCH_CHECK(col_data[b] >= 0 && col_data[b] < block_cols_count,
+        "block_sparse_mm: block column ", col_data[b], " is out of bounds for ", block_cols_count,
+        " block columns");
+  }
+}
+
+} // namespace
+
+std::tuple<Tensor, Tensor, Tensor> to_block_sparse(const Tensor& self, IntArrayRef blocksize) {
+  TORCH_CHECK(self.dim() == 2, "to_block_sparse: expected a 2D tensor, but got ", self.dim(), "D");
+  TORCH_CHECK(blocksize.size() == 2 && blocksize[0] > 0 && blocksize[1] > 0,
+      "to_block_sparse: expected a positive blocksize of 2 entries, but got ", blocksize);
+  const int64_t block_rows = blocksize[0];
+  const int64_t block_cols = blocksize[1];
+  TORCH_CHECK(self.size(0) % block_rows == 0 && self.size(1) % block_cols == 0,
+      "to_block_sparse: expected the sizes ", self.sizes(), " to be multiples of the blocksize ", blocksize);
+  const int64_t rows_count = self.size(0) / block_rows;
+  const int64_t cols_count = self.size(1) / block_cols;
+
+  // [rows_count * cols_count, block_rows, block_cols], in row major block order
+  auto blocks = self.reshape({rows_count, block_rows, cols_count, block_cols})
+                    .transpose(1, 2)
+                    .reshape({rows_count * cols_count, block_rows, block_cols});
+  // A block is kept if any of its entries is non-zero.
+  auto mask = blocks.reshape({rows_count, cols_count, block_rows * block_cols}).ne(0).any(2);
+  auto nonzero = mask.nonzero();
+  auto row_indices = nonzero.select(1, 0);
+  auto col_indices = nonzero.select(1, 1).contiguous();
+  auto values = blocks.index_select(0, row_indices * cols_count + col_indices);
+  auto crow_indices = at::cat({at::zeros({1}, nonzero.options()), mask.sum(1, /*keepdim=*/false, kLong).cumsum(0)});
+  return std::make_tuple(crow_indices, col_indices, values);
+}
+
+Tensor block_sparse_mm(
+    const Tensor& crow_indices,
+    const Tensor& col_indices,
+    const Tensor& values,
+    const Tensor& dense) {
+  TORCH_CHECK(dense.dim() == 2, "block_sparse_mm: expected dense to be 2D, but got ", dense.dim(), "D");
+  TORCH_CHECK(values.scalar_type() == dense.scalar_type(),
+      "block_sparse_mm: expected values and dense to have the same dtype, but got ", values.scalar_type(),
+      " and ", dense.scalar_type());
+  TORCH_CHECK(values.device() == dense.device(),
+      "block_sparse_mm: expected values and dense to be on the same device, but got ", values.device(),
+      " and ", dense.device());
+  TORCH_CHECK(values.dim() == 3 && values.size(2) > 0 && dense.size(0) % values.size(2) == 0,
+      "block_sparse_mm: expected the rows of dense, ", dense.size(0),
+      ", to be a multiple of the block columns of values");
+  check_block_sparse(crow_indices, col_indices, values, dense.size(0) / values.size(2));
+
+  const int64_t rows = (crow_indices.numel() - 1) * values.size(1);
+  Tensor output = at::zeros({rows, dense.size(1)}, dense.options());
+  if (output.numel() > 0 && values.numel() > 0) {
+    auto dense_contig = dense.contiguous();
+    block_sparse_mm_stub(
+        dense.device().type(),
+        output,
+        crow_indices.contiguous(),
+        col_indices.contiguous(),
+        values.contiguous(),
+        dense_contig);
+  }
+  return output;
+}
+
+// The weight is [out_features, in_features], so the input is multiplied as
+// weight @ input^T, which keeps the batch as the contiguous dimension of the
+// dense operand that the kernels vectorize over.
+Tensor block_sparse_linear(
+    const Tensor& input,
+    const Tensor& crow_indices,
+    const Tensor& col_indices,
+    const Tensor& values,
+    const Tensor& bias) {
+  TORCH_CHECK(input.dim() >= 1, "block_sparse_linear: expected input to have at least one dimension");
+  const int64_t in_features = input.size(-1);
+  auto input_2d = input.reshape({-1, in_features});
+  auto output = at::block_sparse_mm(crow_indices, col_indices, values, input_2d.t()).t();
+  if (bias.defined()) {
+    output = output + bias;
+  }
+  auto sizes = input.sizes().vec();
+  sizes.back() = output.size(1);
+  return output.reshape(sizes);
+}
+
+} // namespace native
+} // namespace at
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <ATen/native/DispatchStub.h>
+
+namespace at {
+namespace native {
+
+// A block sparse row (BSR) matrix of [rows, cols] with blocks of
+// [block_rows, block_cols] is given by:
+//   - crow_indices, of rows / block_rows + 1 entries: the blocks of block row r
+//     are crow_indices[r] to crow_indices[r + 1],
+//   - col_indices, of nnz entries: the block column of every block, increasing
+//     within a block row,
+//   - values, of [nnz, block_rows, block_cols]: the blocks themselves.
+//
+// output is the zeroed [rows, dense.size(1)] result of multiplying the matrix
+// with dense. All tensors are contiguous.
+using block_sparse_mm_fn = void(*)(
+    Tensor& output,
+    const Tensor& crow_indices,
+    const Tensor& col_indices,
+    const Tensor& values,
+    const Tensor& dense);
+
+DECLARE_DISPATCH(block_sparse_mm_fn, block_sparse_mm_stub);
+
+} // namespace native
+} // namespace at
@@ -1,14 +1,26 @@
 #include <ATen/ATen.h>
 #include <ATen/NativeFunctions.h>
+#include <ATen/Parallel.h>
+#include <ATen/core/grad_mode.h>
+#include <ATen/detail/CUDAHooksInterface.h>
+#include <ATen/native/ConvolutionBenchmarkCPU.h>
 #include <ATen/native/cpu/DepthwiseConvKernel.h>
 #include <ATen/native/utils/ParamUtils.h>
 
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <limits>
+
 #include <ATen/Config.h>
 #if AT_NNPACK_ENABLED()
 #include "nnpack.h"
 #endif
 
 static const int MIOPEN_DIM_MAX = 4;
+// Largest batch for which the native CPU convolutions are picked over
+// thnn_conv2d; at 16 and above NNPACK takes over where it's available.
+static const int CPU_SMALL_BATCH_MAX = 15;
 
 namespace at { namespace native {
 
@@ -34,6 +46,12 @@ struct ConvParams {
   bool is_stride_nonpos() const;
   void view1d_as_2d();
   bool use_cpu_depthwise3x3_winograd(const at::Tensor& input, const at::Tensor& weight) const;
+  bool is_cpu_inference(const at::Tensor& input, const at::Tensor& weight, const at::Tensor& bias) const;
+  bool is_cpu_small_batch_inference(const at::Tensor& input, const at::Tensor& weight, const at::Tensor& bias) const;
+  bool use_cpu_benchmark(const at::Tensor& input) const;
+  std::vector<CPUConvBackend> cpu_backends(const at::Tensor& input, const at::Tensor& weight, const at::Tensor& bias) const;
+  bool use_cpu_winograd(const at::Tensor& input, const at::Tensor& weight, const at::Tensor& bias) const;
+  bool use_cpu_direct_nhwc(const at::Tensor& input, const at::Tensor& weight, const at::Tensor& bias) const;
   bool use_cudnn(const at::Tensor& input) const;
   bool use_cudnn_depthwise(const at::Tensor& input, const at::Tensor& weight) const;
   bool use_miopen(const at::Tensor& input) const;
@@ -146,6 +164,90 @@ auto ConvParams::use_cpu_depthwise3x3_winograd(
 #endif
 }
 
+// Whether the native CPU convolutions, which don't have derivatives, can run
+auto ConvParams::is_cpu_inference(
+    const at::Tensor& input, const at::Tensor& weight, const at::Tensor& bias) const -> bool {
+  const bool requires_grad = GradMode::is_enabled() &&
+      (input.requires_grad() || weight.requires_grad() || (bias.defined() && bias.requires_grad()));
+  return !requires_grad &&
+         input.device().is_cpu() &&
+         input.layout() == at::kStrided &&
+         input.scalar_type() == at::kFloat &&
+         input.ndimension() == 4 &&
+         weight.device().is_cpu() &&
+         weight.layout() == at::kStrided &&
+         weight.scalar_type() == at::kFloat &&
+         groups == 1 &&
+         !is_dilated() &&
+         !transposed;
+}
+
+// The native CPU convolutions are meant for the small batches of inference,
+// for which the memory traffic of the im2col buffer of thnn_conv2d dominates.
+auto ConvParams::is_cpu_small_batch_inference(
+    const at::Tensor& input, const at::Tensor& weight, const at::Tensor& bias) const -> bool {
+  return is_cpu_inference(input, weight, bias) && input.size(0) <= CPU_SMALL_BATCH_MAX;
+}
+
+// Winograd F(4x4, 3x3) does 2.25 times fewer multiplications than the direct
+// 3x3 convolution, and moves 4 times less data than im2col, but its transforms
+// don't pay off for the few channels of the first layers of a network.
+auto ConvParams::use_cpu_winograd(
+    const at::Tensor& input, const at::Tensor& weight, const at::Tensor& bias) const -> bool {
+  return is_cpu_small_batch_inference(input, weight, bias) &&
+         weight.size(2) == 3 &&
+         weight.size(3) == 3 &&
+         !is_strided() &&
+         input.size(1) >= 16 &&
+         weight.size(0) >= 16 &&
+         input.size(2) + 2 * padding[0] >= 6 &&
+         input.size(3) + 2 * padding[1] >= 6;
+}
+
+// A channels last input runs the direct convolution on packed weights, which
+// keeps its layout, rather than being made contiguous for im2col.
+auto ConvParams::use_cpu_direct_nhwc(
+    const at::Tensor& input, const at::Tensor& weight, const at::Tensor& bias) const -> bool {
+  return is_cpu_small_batch_inference(input, weight, bias) &&
+         input.suggest_memory_format() == at::MemoryFormat::ChannelsLast;
+}
+
+// See native/ConvolutionBenchmarkCPU.h. Only float has a choice of backends.
+auto ConvParams::use_cpu_benchmark(const at::Tensor& input) const -> bool {
+  return at::globalContext().benchmarkCPU() &&
+         input.device().is_cpu() &&
+         input.layout() == at::kStrided &&
+         input.scalar_type() == at::kFloat &&
+         input.ndimension() == 4 &&
+         !transposed;
+}
+
+// The CPU backends which can run the convolution, whatever the shape rules
+// of the use_* functions above say about their speed
+auto ConvParams::cpu_backends(
+    const at::Tensor& input, const at::Tensor& weight, const at::Tensor& bias) const
+    -> std::vector<CPUConvBackend> {
+  std::vector<CPUConvBackend> backends = {CPUConvBackend::Im2col};
+#if AT_MKLDNN_ENABLED()
+  if (at::globalContext().userEnabledMkldnn() && !is_dilated()) {
+    backends.push_back(CPUConvBackend::Mkldnn);
+  }
+#endif
+#if AT_NNPACK_ENABLED()
+  if (at::_nnpack_available() && groups == 1 && !is_dilated()) {
+    backends.push_back(CPUConvBackend::Nnpack);
+  }
+#endif
+  if (is_cpu_inference(input, weight, bias)) {
+    if (weight.size(2) == 3 && weight.size(3) == 3 && !is_strided() &&
+        input.size(2) + 2 * padding[0] >= 3 && input.size(3) + 2 * padding[1] >= 3) {
+      backends.push_back(CPUConvBackend::Winograd);
+    }
+    backends.push_back(CPUConvBackend::DirectNHWC);
+  }
+  return backends;
+}
+
 auto ConvParams::use_cudnn(const at::Tensor& input) const -> bool {
   if (!detail::getCUDAHooks().compiledWithCuDNN()) {
     return false;
@@ -470,6 +572,121 @@ static at::Tensor subtensor(at::Tensor& tensor, int dim, int groups, int g) {
   return tensor.narrow(dim, n * g, n).contiguous();
 }
 
+static at::Tensor cpu_convolution(
+    CPUConvBackend backend, const Tensor& input_r, const Tensor& weight, const Tensor& bias,
+    const ConvParams& params) {
+  auto kernel_size = weight.sizes().slice(2);
+  switch (backend) {
+    case CPUConvBackend::Im2col: {
+      auto input = input_r.contiguous();
+      auto im2col = [&](const Tensor& input_g, const Tensor& weight_g, const Tensor& bias_g) {
+        if (params.is_dilated()) {
+          return at::slow_conv_dilated2d(
+              input_g, weight_g, kernel_size, bias_g, params.stride, params.padding, params.dilation);
+        }
+        return at::thnn_conv2d(
+            input_g, weight_g, kernel_size, bias_g, params.stride, params.padding);
+      };
+      if (params.groups == 1) {
+        return im2col(input, weight, bias);
+      }
+      auto weight_c = weight;
+      auto bias_c = bias;
+      std::vector<Tensor> outputs(params.groups);
+      for (int g = 0; g < params.groups; ++g) {
+        outputs[g] = im2col(
+            subtensor(input, 1, params.groups, g),
+            subtensor(weight_c, 0, params.groups, g),
+            subtensor(bias_c, 0, params.groups, g));
+      }
+      return at::cat(outputs, 1);
+    }
+    case CPUConvBackend::Mkldnn:
+#if AT_MKLDNN_ENABLED()
+      return at::mkldnn_convolution(
+          input_r.contiguous(), weight.contiguous(), bias.defined() ? bias.contiguous() : bias,
+          params.padding, params.stride, params.dilation, params.groups);
+#else
+      break;
+#endif
+    case CPUConvBackend::Nnpack:
+#if AT_NNPACK_ENABLED()
+      return at::_nnpack_spatial_convolution(
+          input_r.contiguous(), weight, bias, params.padding, params.stride);
+#else
+      break;
+#endif
+    case CPUConvBackend::Winograd:
+      return at::_winograd_conv2d(
+          input_r.contiguous(), at::_winograd_conv2d_weight(weight), bias, params.padding);
+    case CPUConvBackend::DirectNHWC:
+      return at::_direct_conv2d_nhwc(
+          input_r, at::_direct_conv2d_nhwc_weight(weight), bias, params.stride, params.padding);
+  }
+  AT_ERROR("CPU convolution backend ", cpuConvBackendName(backend), " is not available");
+}
+
+// Runs the convolution with the backend chosen for its shape by the CPU
+// benchmark cache, timing the candidates the first time the shape is seen.
+// The benchmark runs each candidate twice and keeps the faster time, so that
+// the first touch of the buffers of a backend isn't held against it.
+static at::Tensor cpu_convolution_benchmarked(
+    const Tensor& input, const Tensor& weight, const Tensor& bias, const ConvParams& params) {
+  CPUConvolutionParams key;
+  memset(&key, 0, sizeof(CPUConvolutionParams));
+  for (int i = 0; i < 4; i++) {
+    key.input_size[i] = input.size(i);
+    key.weight_size[i] = weight.size(i);
+  }
+  for (int i = 0; i < 2; i++) {
+    key.stride[i] = params.stride[i];
+    key.padding[i] = params.padding[i];
+    key.dilation[i] = params.dilation[i];
+  }
+  key.groups = params.groups;
+  key.dtype = static_cast<int32_t>(input.scalar_type());
+  key.num_threads = at::get_num_threads();
+  key.channels_last = input.suggest_memory_format() == at::MemoryFormat::ChannelsLast;
+  key.has_bias = bias.defined();
+  key.requires_grad = !params.is_cpu_inference(input, weight, bias);
+
+  const auto backends = params.cpu_backends(input, weight, bias);
+  if (auto cached = cpu_conv_benchmark_cache_find(key)) {
+    // A cache loaded from a file may name a backend that this build or this
+    // call can't run, in which case it is benchmarked again.
+    if (std::find(backends.begin(), backends.end(), *cached) != backends.end()) {
+      return cpu_convolution(*cached, input, weight, bias, params);
+    }
+  }
+
+  Tensor best_output;
+  CPUConvBackend best_backend = CPUConvBackend::Im2col;
+  double best_time = std::numeric_limits<double>::infinity();
+  for (const auto backend : backends) {
+    Tensor output;
+    double time = std::numeric_limits<double>::infinity();
+    try {
+      for (int run = 0; run < 2; run++) {
+        const auto start = std::chrono::steady_clock::now();
+        output = cpu_convolution(backend, input, weight, bias, params);
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        time = std::min(time, elapsed.count());
+      }
+    } catch (const c10::Error&) {
+      // e.g. nnpack failing to initialize for the shape; not a candidate
+      continue;
+    }
+    if (!best_output.defined() || time < best_time) {
+      best_output = output;
+      best_backend = backend;
+      best_time = time;
+    }
+  }
+  TORCH_CHECK(best_output.defined(), "no CPU convolution backend could run the convolution");
+  cpu_conv_benchmark_cache_insert(key, best_backend);
+  return best_output;
+}
+
 
 at::Tensor conv1d(
     const Tensor& input, const Tensor& weight, const Tensor& bias,
@@ -574,7 +791,15 @@ at::Tensor _convolution(
   }
 
   Tensor output;
-  if (params.is_depthwise(input, weight)) {
+  if (params.use_cpu_benchmark(input)) {
+    TORCH_CHECK(input.type() == weight.type(),
+             "Input type (", input.type().toString(), ") and weight type (", weight.type().toString(),
+             ") should be the same");
+    TORCH_CHECK(!bias.defined() || (input.type() == bias.type()),
+             "Input type (", input.type().toString(), ") and bias type (", bias.type().toString(),
+             ") should be the same");
+    output = cpu_convolution_benchmarked(input, weight, bias, params);
+  } else if (params.is_depthwise(input, weight)) {
       /* output.resize_(output_size(input, weight)); */
 
       auto kernel_size = weight.sizes().slice(2);
@@ -648,6 +873,12 @@ at::Tensor _convolution(
     if (params.use_cpu_depthwise3x3_winograd(input, weight)) {
       output = convolution_depthwise3x3_winograd_stub(
         input.device().type(), input, weight, bias, params.stride, params.padding, params.groups);
+    } else if (params.use_cpu_direct_nhwc(input, weight, bias)) {
+      output = at::_direct_conv2d_nhwc(
+          input, at::_direct_conv2d_nhwc_weight(weight), bias, params.stride, params.padding);
+    } else if (params.use_cpu_winograd(input, weight, bias)) {
+      output = at::_winograd_conv2d(
+          input, at::_winograd_conv2d_weight(weight), bias, params.padding);
     } else if (params.groups == 1) {
       output = at::_convolution_nogroup(
           input.contiguous(), weight, bias, params.stride, params.padding, params.dilation, params.transposed, params.output_padding);
@@ -995,4 +1226,15 @@ std::tuple<Tensor,Tensor,Tensor> _convolution_double_backward(
   return std::tuple<Tensor,Tensor,Tensor>{ggO, gI, gW};
 }
 
+// We call the following methods via CUDA hooks because the cuDNN benchmark
+// cache only exists in the CUDA build. See native/cudnn/BenchmarkCache.h for
+// more details.
+void _cudnn_save_benchmark_cache(std::string path) {
+  detail::getCUDAHooks().cuDNNSaveBenchmarkCache(path);
+}
+
+int64_t _cudnn_load_benchmark_cache(std::string path) {
+  return detail::getCUDAHooks().cuDNNLoadBenchmarkCache(path);
+}
+
 }} // at::native
@@ -0,0 +1,157 @@
+#include <ATen/native/ConvolutionBenchmarkCPU.h>
+
+#include <ATen/NativeFunctions.h>
+#include <ATen/native/utils/ParamsHash.h>
+#include <cpuinfo.h>
+
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace at { namespace native {
+
+namespace {
+
+struct CPUConvBenchmarkCache {
+  std::mutex mutex;
+  std::unordered_map<CPUConvolutionParams, CPUConvBackend,
+                     ParamsHash<CPUConvolutionParams>, ParamsEqual<CPUConvolutionParams>> map;
+};
+
+CPUConvBenchmarkCache& benchmark_cache() {
+  static CPUConvBenchmarkCache cache;
+  return cache;
+}
+
+// The cache file is this header followed by the raw (CPUConvolutionParams,
+// CPUConvBackend) pairs. The size of the params is recorded so that a file
+// from a build with a different layout is rejected instead of misread.
+constexpr char kBenchmarkCacheMagic[8] = "CPUCONV";
+constexpr int32_t kBenchmarkCacheFormatVersion = 1;
+
+struct BenchmarkCacheHeader {
+  char magic[8];
+  int32_t format_version;
+  int32_t params_size;
+  char cpu_name[64];
+  int64_t num_entries;
+};
+
+BenchmarkCacheHeader makeBenchmarkCacheHeader() {
+  BenchmarkCacheHeader header;
+  // zero the padding too, so that headers compare equal with memcmp
+  memset(&header, 0, sizeof(BenchmarkCacheHeader));
+  memcpy(header.magic, kBenchmarkCacheMagic, sizeof(header.magic));
+  header.format_version = kBenchmarkCacheFormatVersion;
+  header.params_size = sizeof(CPUConvolutionParams);
+  if (cpuinfo_initialize() && cpuinfo_get_packages_count() > 0) {
+    strncpy(header.cpu_name, cpuinfo_get_package(0)->name, sizeof(header.cpu_name) - 1);
+  }
+  return header;
+}
+
+} // namespace
+
+const char* cpuConvBackendName(CPUConvBackend backend) {
+  switch (backend) {
+    case CPUConvBackend::Im2col: return "im2col";
+    case CPUConvBackend::Mkldnn: return "mkldnn";
+    case CPUConvBackend::Nnpack: return "nnpack";
+    case CPUConvBackend::Winograd: return "winograd";
+    case CPUConvBackend::DirectNHWC: return "direct_nhwc";
+  }
+  return "unknown";
+}
+
+c10::optional<CPUConvBackend> cpu_conv_benchmark_cache_find(const CPUConvolutionParams& params) {
+  auto& cache = benchmark_cache();
+  std::lock_guard<std::mutex> guard(cache.mutex);
+  auto it = cache.map.find(params);
+  if (it == cache.map.end()) {
+    return c10::nullopt;
+  }
+  return it->second;
+}
+
+void cpu_conv_benchmark_cache_insert(const CPUConvolutionParams& params, CPUConvBackend backend) {
+  auto& cache = benchmark_cache();
+  std::lock_guard<std::mutex> guard(cache.mutex);
+  cache.map[params] = backend;
+}
+
+void cpu_conv_save_benchmark_cache(const std::string& path) {
+  std::vector<std::pair<CPUConvolutionParams, CPUConvBackend>> entries;
+  {
+    auto& cache = benchmark_cache();
+    std::lock_guard<std::mutex> guard(cache.mutex);
+    entries.assign(cache.map.begin(), cache.map.end());
+  }
+  BenchmarkCacheHeader header = makeBenchmarkCacheHeader();
+  header.num_entries = entries.size();
+
+  std::ofstream file(path, std::ios::binary | std::ios::trunc);
+  TORCH_CHECK(file, "cpu_conv_save_benchmark_cache: could not open ", path, " for writing");
+  file.write(reinterpret_cast<const char*>(&header), sizeof(BenchmarkCacheHeader));
+  for (const auto& entry : entries) {
+    file.write(reinterpret_cast<const char*>(&entry.first), sizeof(CPUConvolutionParams));
+    file.write(reinterpret_cast<const char*>(&entry.second), sizeof(CPUConvBackend));
+  }
+  file.close();
+  TORCH_CHECK(file, "cpu_conv_save_benchmark_cache: failed to write ", path);
+}
+
+int64_t cpu_conv_load_benchmark_cache(const std::string& path) {
+  std::ifstream file(path, std::ios::binary);
+  TORCH_CHECK(file, "cpu_conv_load_benchmark_cache: could not open ", path, " for reading");
+
+  BenchmarkCacheHeader header;
+  file.read(reinterpret_cast<char*>(&header), sizeof(BenchmarkCacheHeader));
+  TORCH_CHECK(file && memcmp(header.magic, kBenchmarkCacheMagic, sizeof(header.magic)) == 0,
+      "cpu_conv_load_benchmark_cache: ", path, " is not a CPU convolution benchmark cache");
+
+  BenchmarkCacheHeader expected = makeBenchmarkCacheHeader();
+  expected.num_entries = header.num_entries;
+  if (memcmp(&header, &expected, sizeof(BenchmarkCacheHeader)) != 0) {
+    header.cpu_name[sizeof(header.cpu_name) - 1] = '\0';
+    TORCH_WARN("cpu_conv_load_benchmark_cache: ignoring ", path, ", which was saved on ",
+        header.cpu_name, " (format ", header.format_version, "), but this process runs on ",
+        expected.cpu_name, " (format ", expected.format_version, ")");
+    return 0;
+  }
+  TORCH_CHECK(header.num_entries >= 0,
+      "cpu_conv_load_benchmark_cache: ", path, " is corrupted");
+
+  // Read the whole file before touching the cache, so that a truncated file
+  // loads nothing.
+  std::vector<std::pair<CPUConvolutionParams, CPUConvBackend>> entries;
+  for (int64_t i = 0; i < header.num_entries; i++) {
+    std::pair<CPUConvolutionParams, CPUConvBackend> entry;
+    file.read(reinterpret_cast<char*>(&entry.first), sizeof(CPUConvolutionParams));
+    file.read(reinterpret_cast<char*>(&entry.second), sizeof(CPUConvBackend));
+    TORCH_CHECK(file, "cpu_conv_load_benchmark_cache: ", path, " is truncated");
+    const auto backend = static_cast<int32_t>(entry.second);
+    TORCH_CHECK(backend >= 0 && backend <= static_cast<int32_t>(CPUConvBackend::DirectNHWC),
+        "cpu_conv_load_benchmark_cache: ", path, " is corrupted");
+    entries.push_back(entry);
+  }
+
+  int64_t inserted = 0;
+  auto& cache = benchmark_cache();
+  std::lock_guard<std::mutex> guard(cache.mutex);
+  for (const auto& entry : entries) {
+    inserted += cache.map.emplace(entry.first, entry.second).second;
+  }
+  return inserted;
+}
+
+void _cpu_conv_save_benchmark_cache(std::string path) {
+  cpu_conv_save_benchmark_cache(path);
+}
+
+int64_t _cpu_conv_load_benchmark_cache(std::string path) {
+  return cpu_conv_load_benchmark_cache(path);
+}
+
+}}  // namespace at::native
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <c10/util/Optional.h>
+
+#include <cstdint>
+#include <string>
+
+namespace at { namespace native {
+
+// With torch.backends.cpu.benchmark = True (Context::benchmarkCPU), the
+// first call of _convolution for a shape on a dense CPU input times each of
+// the CPU backends which can run it, and every later call runs the fastest
+// one, like cudnn.benchmark does with the cuDNN algorithms. The choices
+// can be saved to a file and loaded into another process, like the ones of
+// cudnn.benchmark (see native/cudnn/BenchmarkCache.h).
+
+enum class CPUConvBackend : int32_t {
+  Im2col = 0,      // thnn_conv2d or slow_conv_dilated2d, per group
+  Mkldnn = 1,
+  Nnpack = 2,
+  Winograd = 3,    // _winograd_conv2d, inference only
+  DirectNHWC = 4,  // _direct_conv2d_nhwc, inference only
+};
+
+const char* cpuConvBackendName(CPUConvBackend backend);
+
+// The key of a convolution in the cache: a POD, hashed and compared bytewise,
+// and written to the cache file as is. Zero it before filling it in.
+struct CPUConvolutionParams {
+  int64_t input_size[4];
+  int64_t weight_size[4];
+  int64_t stride[2];
+  int64_t padding[2];
+  int64_t dilation[2];
+  int64_t groups;
+  int32_t dtype;
+  // The fastest backend depends on the number of threads
+  int32_t num_threads;
+  bool channels_last;
+  bool has_bias;
+  // The inference only backends are only candidates without grad
+  bool requires_grad;
+};
+
+c10::optional<CPUConvBackend> cpu_conv_benchmark_cache_find(const CPUConvolutionParams& params);
+void cpu_conv_benchmark_cache_insert(const CPUConvolutionParams& params, CPUConvBackend backend);
+
+// The file records the model of the CPU; loading a file written on another
+// model warns and loads nothing. Entries benchmarked by this process are
+// kept over the ones of the file. Called by the native functions
+// _cpu_conv_save_benchmark_cache and _cpu_conv_load_benchmark_cache.
+void cpu_conv_save_benchmark_cache(const std::string& path);
+int64_t cpu_conv_load_benchmark_cache(const std::string& path);
+
+}}  // namespace at::native
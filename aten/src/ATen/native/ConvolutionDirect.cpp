@@ -0,0 +1,55 @@
+#include <ATen/ATen.h>
+#include <ATen/NativeFunctions.h>
+#include <ATen/native/cpu/DirectConvKernel.h>
+
+namespace at {
+namespace native {
+
+DEFINE_DISPATCH(convolution_direct_nhwc_stub);
+
+// The weight as (kernel_h, kernel_w, in_channels, out_channels), for
+// _direct_conv2d_nhwc. See native/cpu/DirectConvKernel.cpp.
+Tensor _direct_conv2d_nhwc_weight(const Tensor& weight) {
+  TORCH_CHECK(weight.dim() == 4, "_direct_conv2d_nhwc_weight: expected a 4-D weight, but got ",
+              weight.dim(), "-D");
+  return weight.permute({2, 3, 1, 0}).contiguous();
+}
+
+Tensor _direct_conv2d_nhwc_cpu(
+    const Tensor& self,
+    const Tensor& packed_weight,
+    const Tensor& bias,
+    IntArrayRef stride,
+    IntArrayRef padding) {
+  TORCH_CHECK(self.dim() == 4, "_direct_conv2d_nhwc: expected a 4-D input, but got ",
+              self.dim(), "-D");
+  TORCH_CHECK(packed_weight.dim() == 4 && packed_weight.size(2) == self.size(1),
+              "_direct_conv2d_nhwc: expected a weight of size (kernel_h, kernel_w, ",
+              self.size(1), ", out_channels) from _direct_conv2d_nhwc_weight, but got ",
+              packed_weight.sizes());
+  TORCH_CHECK(self.scalar_type() == packed_weight.scalar_type(),
+              "_direct_conv2d_nhwc: expected the input and the weight to have the same dtype, "
+              "but got ", self.scalar_type(), " and ", packed_weight.scalar_type());
+  TORCH_CHECK(!bias.defined() ||
+              (bias.dim() == 1 && bias.size(0) == packed_weight.size(3) &&
+               bias.scalar_type() == self.scalar_type()),
+              "_direct_conv2d_nhwc: expected a bias of ", packed_weight.size(3), " elements");
+  TORCH_CHECK(stride.size() == 2 && stride[0] > 0 && stride[1] > 0,
+              "_direct_conv2d_nhwc: expected 2 positive strides, but got ", stride);
+  TORCH_CHECK(padding.size() == 2 && padding[0] >= 0 && padding[1] >= 0,
+              "_direct_conv2d_nhwc: expected 2 non negative paddings, but got ", padding);
+  TORCH_CHECK(self.size(2) + 2 * padding[0] >= packed_weight.size(0) &&
+              self.size(3) + 2 * padding[1] >= packed_weight.size(1),
+              "_direct_conv2d_nhwc: the padded input of size ", self.sizes(),
+              " is smaller than the kernel");
+  return convolution_direct_nhwc_stub(
+      kCPU,
+      self.contiguous(MemoryFormat::ChannelsLast),
+      packed_weight.contiguous(),
+      bias.defined() ? bias.contiguous() : bias,
+      stride,
+      padding);
+}
+
+} // namespace native
+} // namespace at
@@ -0,0 +1,101 @@
+#include <ATen/ATen.h>
+#include <ATen/Dispatch.h>
+#include <ATen/NativeFunctions.h>
+#include <ATen/native/cpu/WinogradConvKernel.h>
+
+namespace at {
+namespace native {
+
+DEFINE_DISPATCH(convolution_winograd4x3_stub);
+
+namespace {
+
+// y = G x for the 3-vector x and the 6-vector y read and written with
+// strides, where
+//
+//       [ 1/4     0    0]
+//       [-1/6  -1/6 -1/6]
+//   G = [-1/6   1/6 -1/6]
+//       [1/24  1/12  1/6]
+//       [1/24 -1/12  1/6]
+//       [   0     0    1]
+template <typename scalar_t>
+inline void weight_transform_1d(const scalar_t* x, int64_t xs, scalar_t* y, int64_t ys) {
+  const scalar_t x0 = x[0], x1 = x[xs], x2 = x[2 * xs];
+  y[0] = x0 / 4;
+  y[ys] = -(x0 + x1 + x2) / 6;
+  y[2 * ys] = -(x0 - x1 + x2) / 6;
+  y[3 * ys] = x0 / 24 + x1 / 12 + x2 / 6;
+  y[4 * ys] = x0 / 24 - x1 / 12 + x2 / 6;
+  y[5 * ys] = x2;
+}
+
+} // namespace
+
+// The (36, out_channels, in_channels) transformed filters G g G^T of the 3x3
+// filters g of weight, for _winograd_conv2d. See
+// native/cpu/WinogradConvKernel.cpp.
+Tensor _winograd_conv2d_weight_cpu(const Tensor& weight) {
+  TORCH_CHECK(weight.dim() == 4 && weight.size(2) == 3 && weight.size(3) == 3,
+              "_winograd_conv2d_weight: expected a weight of size "
+              "(out_channels, in_channels, 3, 3), but got ", weight.sizes());
+  const Tensor g = weight.contiguous();
+  const int64_t filters = g.size(0) * g.size(1);
+  Tensor result = at::empty({36, g.size(0), g.size(1)}, g.options());
+  AT_DISPATCH_FLOATING_TYPES(g.scalar_type(), "_winograd_conv2d_weight", [&] {
+    const scalar_t* g_data = g.data_ptr<scalar_t>();
+    scalar_t* result_data = result.data_ptr<scalar_t>();
+    scalar_t tmp[6][3];
+    scalar_t u[6][6];
+    for (int64_t f = 0; f < filters; ++f) {
+      const scalar_t* filter = g_data + f * 9;
+      for (int64_t j = 0; j < 3; ++j) {
+        weight_transform_1d(filter + j, 3, &tmp[0][j], 3);
+      }
+      for (int64_t i = 0; i < 6; ++i) {
+        weight_transform_1d(&tmp[i][0], 1, &u[i][0], 1);
+      }
+      for (int64_t i = 0; i < 6; ++i) {
+        for (int64_t j = 0; j < 6; ++j) {
+          result_data[(i * 6 + j) * filters + f] = u[i][j];
+        }
+      }
+    }
+  });
+  return result;
+}
+
+Tensor _winograd_conv2d_cpu(
+    const Tensor& self,
+    const Tensor& winograd_weight,
+    const Tensor& bias,
+    IntArrayRef padding) {
+  TORCH_CHECK(self.dim() == 4, "_winograd_conv2d: expected a 4-D input, but got ",
+              self.dim(), "-D");
+  TORCH_CHECK(winograd_weight.dim() == 3 && winograd_weight.size(0) == 36 &&
+              winograd_weight.size(2) == self.size(1),
+              "_winograd_conv2d: expected a weight of size (36, out_channels, ",
+              self.size(1), ") from _winograd_conv2d_weight, but got ",
+              winograd_weight.sizes());
+  TORCH_CHECK(self.scalar_type() == winograd_weight.scalar_type(),
+              "_winograd_conv2d: expected the input and the weight to have the same dtype, "
+              "but got ", self.scalar_type(), " and ", winograd_weight.scalar_type());
+  TORCH_CHECK(!bias.defined() ||
+              (bias.dim() == 1 && bias.size(0) == winograd_weight.size(1) &&
+               bias.scalar_type() == self.scalar_type()),
+              "_winograd_conv2d: expected a bias of ", winograd_weight.size(1), " elements");
+  TORCH_CHECK(padding.size() == 2 && padding[0] >= 0 && padding[1] >= 0,
+              "_winograd_conv2d: expected 2 non negative paddings, but got ", padding);
+  TORCH_CHECK(self.size(2) + 2 * padding[0] >= 3 && self.size(3) + 2 * padding[1] >= 3,
+              "_winograd_conv2d: the padded input of size ", self.sizes(),
+              " is smaller than the 3x3 kernel");
+  return convolution_winograd4x3_stub(
+      kCPU,
+      self.contiguous(),
+      winograd_weight.contiguous(),
+      bias.defined() ? bias.contiguous() : bias,
+      padding);
+}
+
+} // namespace native
+} // namespace at
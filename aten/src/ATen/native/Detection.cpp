@@ -0,0 +1,267 @@
+// Detection ops: box decoding, batched NMS and RoIAlign. The CPU kernels and
+// the composite ops live here, the CUDA kernels in cuda/Detection.cu.
+
+#include <ATen/native/Detection.h>
+
+#include <ATen/ATen.h>
+#include <ATen/Dispatch.h>
+#include <ATen/NativeFunctions.h>
+#include <ATen/Parallel.h>
+
+#include <vector>
+
+namespace at { namespace native {
+
+void check_roi_align_inputs(
+    const Tensor& input, const Tensor& rois, int64_t pooled_height, int64_t pooled_width) {
+  TORCH_CHECK(input.dim() == 4, "roi_align: expected input to be 4D (N, C, H, W), but got ", input.dim(), "D");
+  TORCH_CHECK(rois.dim() == 2 && rois.size(1) == 5,
+      "roi_align: expected rois of size (K, 5) holding (batch_index, x1, y1, x2, y2), but got ", rois.sizes());
+  TORCH_CHECK(rois.scalar_type() == input.scalar_type() && rois.device() == input.device(),
+      "roi_align: expected rois to have the same type and device as input");
+  TORCH_CHECK(pooled_height > 0 && pooled_width > 0,
+      "roi_align: expected a positive output size, but got ", pooled_height, "x", pooled_width);
+}
+
+void check_nms_inputs(const Tensor& boxes, const Tensor& scores) {
+  TORCH_CHECK(boxes.dim() == 2 && boxes.size(1) == 4,
+      "nms: expected boxes of size (N, 4) holding (x1, y1, x2, y2), but got ", boxes.sizes());
+  TORCH_CHECK(scores.dim() == 1 && scores.size(0) == boxes.size(0),
+      "nms: expected one score per box, but got scores of size ", scores.sizes(), " for ", boxes.size(0), " boxes");
+  TORCH_CHECK(scores.scalar_type() == boxes.scalar_type() && scores.device() == boxes.device(),
+      "nms: expected scores to have the same type and device as boxes");
+}
+
+namespace {
+
+// Reading the batch indices on CUDA would need a sync, so the CUDA kernels
+// trust them.
+void check_roi_batch_indices(const Tensor& rois, int64_t batch_size) {
+  if (rois.size(0) == 0) {
+    return;
+  }
+  auto batch_indices = rois.select(1, 0);
+  TORCH_CHECK(batch_indices.min().item<double>() >= 0 && batch_indices.max().item<double>() < batch_size,
+      "roi_align: expected the batch indices of rois to be in [0, ", batch_size, ")");
+}
+
+// An input position and its weight, for the samples of one bin.
+template <typename scalar_t>
+struct RoIAlignSample {
+  int64_t pos[4];
+  scalar_t weight[4];
+};
+
+template <typename scalar_t>
+void roi_align_forward_kernel(
+    const Tensor& output, const Tensor& input, const Tensor& rois, double spatial_scale,
+    int64_t pooled_height, int64_t pooled_width, int64_t sampling_ratio, bool aligned) {
+  const int64_t num_rois = rois.size(0);
+  const int64_t channels = input.size(1);
+  const int64_t height = input.size(2);
+  const int64_t width = input.size(3);
+  const int64_t num_bins = pooled_height * pooled_width;
+  const scalar_t* input_data = input.data_ptr<scalar_t>();
+  const scalar_t* rois_data = rois.data_ptr<scalar_t>();
+  scalar_t* output_data = output.data_ptr<scalar_t>();
+
+  // The sampling positions and weights only depend on the RoI, so they are
+  // computed once and applied to all channels.
+  at::parallel_for(0, num_rois, 1, [&](int64_t begin, int64_t end) {
+    std::vector<RoIAlignSample<scalar_t>> samples;
+    std::vector<int64_t> bin_offsets(num_bins + 1);
+    for (int64_t n = begin; n < end; n++) {
+      const auto bins = roi_align_bins<scalar_t>(
+          rois_data + n * 5, static_cast<scalar_t>(spatial_scale), pooled_height, pooled_width,
+          sampling_ratio, aligned);
+      samples.clear();
+      for (int64_t ph = 0; ph < pooled_height; ph++) {
+        for (int64_t pw = 0; pw < pooled_width; pw++) {
+          bin_offsets[ph * pooled_width + pw] = samples.size();
+          roi_align_for_each_sample(bins, height, width, ph, pw,
+              [&](int y_low, int y_high, int x_low, int x_high, scalar_t w1, scalar_t w2, scalar_t w3, scalar_t w4) {
+                samples.push_back({{y_low * width + x_low, y_low * width + x_high,
+                                    y_high * width + x_low, y_high * width + x_high},
+                                   {w1, w2, w3, w4}});
+              });
+        }
+      }
+      bin_offsets[num_bins] = samples.size();
+
+      for (int64_t c = 0; c < channels; c++) {
+        const scalar_t* plane = input_data + (bins.batch * channels + c) * height * width;
+        scalar_t* out = output_data + (n * channels + c) * num_bins;
+        for (int64_t bin = 0; bin < num_bins; bin++) {
+          scalar_t val = 0;
+          for (int64_t s = bin_offsets[bin]; s < bin_offsets[bin + 1]; s++) {
+            const auto& sample = samples[s];
+            val += sample.weight[0] * plane[sample.pos[0]] + sample.weight[1] * plane[sample.pos[1]] +
+                sample.weight[2] * plane[sample.pos[2]] + sample.weight[3] * plane[sample.pos[3]];
+          }
+          out[bin] = val;
+        }
+      }
+    }
+  });
+}
+
+template <typename scalar_t>
+void roi_align_backward_kernel(
+    const Tensor& grad_input, const Tensor& grad, const Tensor& rois, double spatial_scale,
+    int64_t pooled_height, int64_t pooled_width, int64_t sampling_ratio, bool aligned) {
+  const int64_t num_rois = rois.size(0);
+  const int64_t channels = grad_input.size(1);
+  const int64_t height = grad_input.size(2);
+  const int64_t width = grad_input.size(3);
+  const int64_t num_bins = pooled_height * pooled_width;
+  const scalar_t* grad_data = grad.data_ptr<scalar_t>();
+  const scalar_t* rois_data = rois.data_ptr<scalar_t>();
+  scalar_t* grad_input_data = grad_input.data_ptr<scalar_t>();
+
+  // Every channel only writes its own planes of grad_input, so channels are
+  // processed in parallel and the sums are deterministic.
+  at::parallel_for(0, channels, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t n = 0; n < num_rois; n++) {
+      const auto bins = roi_align_bins<scalar_t>(
+          rois_data + n * 5, static_cast<scalar_t>(spatial_scale), pooled_height, pooled_width,
+          sampling_ratio, aligned);
+      for (int64_t c = begin; c < end; c++) {
+        scalar_t* plane = grad_input_data + (bins.batch * channels + c) * height * width;
+        const scalar_t* g = grad_data + (n * channels + c) * num_bins;
+        for (int64_t ph = 0; ph < pooled_height; ph++) {
+          for (int64_t pw = 0; pw < pooled_width; pw++) {
+            const scalar_t g_bin = g[ph * pooled_width + pw];
+            roi_align_for_each_sample(bins, height, width, ph, pw,
+                [&](int y_low, int y_high, int x_low, int x_high, scalar_t w1, scalar_t w2, scalar_t w3, scalar_t w4) {
+                  plane[y_low * width + x_low] += g_bin * w1;
+                  plane[y_low * width + x_high] += g_bin * w2;
+                  plane[y_high * width + x_low] += g_bin * w3;
+                  plane[y_high * width + x_high] += g_bin * w4;
+                });
+          }
+        }
+      }
+    }
+  });
+}
+
+} // namespace
+
+Tensor roi_align_cpu(
+    const Tensor& input, const Tensor& rois, double spatial_scale, int64_t pooled_height,
+    int64_t pooled_width, int64_t sampling_ratio, bool aligned) {
+  check_roi_align_inputs(input, rois, pooled_height, pooled_width);
+  check_roi_batch_indices(rois, input.size(0));
+  auto output = at::empty({rois.size(0), input.size(1), pooled_height, pooled_width}, input.options());
+  if (output.numel() == 0) {
+    return output;
+  }
+  auto input_contig = input.contiguous();
+  auto rois_contig = rois.contiguous();
+  AT_DISPATCH_FLOATING_TYPES(input.scalar_type(), "roi_align", [&] {
+    roi_align_forward_kernel<scalar_t>(
+        output, input_contig, rois_contig, spatial_scale, pooled_height, pooled_width, sampling_ratio, aligned);
+  });
+  return output;
+}
+
+Tensor roi_align_backward_cpu(
+    const Tensor& grad, const Tensor& rois, double spatial_scale, int64_t pooled_height,
+    int64_t pooled_width, int64_t batch_size, int64_t channels, int64_t height, int64_t width,
+    int64_t sampling_ratio, bool aligned) {
+  TORCH_CHECK(grad.dim() == 4 && grad.size(0) == rois.size(0) && grad.size(2) == pooled_height &&
+      grad.size(3) == pooled_width, "_roi_align_backward: expected grad of size (",
+      rois.size(0), ", C, ", pooled_height, ", ", pooled_width, "), but got ", grad.sizes());
+  auto grad_input = at::zeros({batch_size, channels, height, width}, grad.options());
+  if (grad.numel() == 0) {
+    return grad_input;
+  }
+  auto grad_contig = grad.contiguous();
+  auto rois_contig = rois.contiguous();
+  AT_DISPATCH_FLOATING_TYPES(grad.scalar_type(), "roi_align_backward", [&] {
+    roi_align_backward_kernel<scalar_t>(
+        grad_input, grad_contig, rois_contig, spatial_scale, pooled_height, pooled_width, sampling_ratio, aligned);
+  });
+  return grad_input;
+}
+
+Tensor nms_cpu(const Tensor& boxes, const Tensor& scores, double iou_threshold) {
+  check_nms_inputs(boxes, scores);
+  const int64_t num_boxes = boxes.size(0);
+  if (num_boxes == 0) {
+    return at::empty({0}, boxes.options().dtype(kLong));
+  }
+  auto boxes_contig = boxes.contiguous();
+  auto order = std::get<1>(scores.sort(/*dim=*/0, /*descending=*/true)).contiguous();
+  const int64_t* order_data = order.data_ptr<int64_t>();
+
+  std::vector<int64_t> keep;
+  AT_DISPATCH_FLOATING_TYPES(boxes.scalar_type(), "nms", [&] {
+    const scalar_t* boxes_data = boxes_contig.data_ptr<scalar_t>();
+    const auto threshold = static_cast<scalar_t>(iou_threshold);
+    std::vector<bool> suppressed(num_boxes, false);
+    for (int64_t i = 0; i < num_boxes; i++) {
+      if (suppressed[i]) {
+        continue;
+      }
+      const int64_t index = order_data[i];
+      keep.push_back(index);
+      const scalar_t* box = boxes_data + index * 4;
+      for (int64_t j = i + 1; j < num_boxes; j++) {
+        if (!suppressed[j] && nms_iou_above(box, boxes_data + order_data[j] * 4, threshold)) {
+          suppressed[j] = true;
+        }
+      }
+    }
+  });
+  return at::tensor(keep, boxes.options().dtype(kLong));
+}
+
+Tensor batched_nms(const Tensor& boxes, const Tensor& scores, const Tensor& idxs, double iou_threshold) {
+  check_nms_inputs(boxes, scores);
+  TORCH_CHECK(idxs.dim() == 1 && idxs.size(0) == boxes.size(0),
+      "batched_nms: expected one category index per box, but got idxs of size ", idxs.sizes(),
+      " for ", boxes.size(0), " boxes");
+  if (boxes.size(0) == 0) {
+    return at::empty({0}, boxes.options().dtype(kLong));
+  }
+  // Boxes of different categories are shifted apart by more than the range
+  // of the coordinates, so they never overlap and one NMS over all of them
+  // handles every category. The range stays on the device, so this needs
+  // no sync.
+  auto range = boxes.max() - boxes.min() + 1;
+  auto offsets = idxs.to(boxes.scalar_type()) * range;
+  return at::_nms(boxes + offsets.unsqueeze(1), scores, iou_threshold);
+}
+
+Tensor box_decode(
+    const Tensor& boxes, const Tensor& deltas, double wx, double wy, double ww, double wh,
+    double bbox_xform_clip) {
+  TORCH_CHECK(boxes.dim() >= 1 && boxes.size(-1) == 4,
+      "box_decode: expected boxes of size (*, 4), but got ", boxes.sizes());
+  TORCH_CHECK(deltas.dim() == boxes.dim() && deltas.size(-1) % 4 == 0 &&
+      deltas.sizes().slice(0, deltas.dim() - 1).equals(boxes.sizes().slice(0, boxes.dim() - 1)),
+      "box_decode: expected deltas of size (*, 4 * num_classes) with the same leading sizes as boxes ",
+      boxes.sizes(), ", but got ", deltas.sizes());
+
+  auto widths = (boxes.select(-1, 2) - boxes.select(-1, 0)).unsqueeze(-1);
+  auto heights = (boxes.select(-1, 3) - boxes.select(-1, 1)).unsqueeze(-1);
+  auto ctr_x = boxes.select(-1, 0).unsqueeze(-1) + 0.5 * widths;
+  auto ctr_y = boxes.select(-1, 1).unsqueeze(-1) + 0.5 * heights;
+
+  // (*, num_classes, 4)
+  std::vector<int64_t> sizes(deltas.sizes().begin(), deltas.sizes().end() - 1);
+  sizes.push_back(deltas.size(-1) / 4);
+  sizes.push_back(4);
+  auto d = deltas.reshape(sizes);
+  // clipping dw and dh keeps exp() from overflowing for outlier deltas
+  auto pred_ctr_x = d.select(-1, 0) / wx * widths + ctr_x;
+  auto pred_ctr_y = d.select(-1, 1) / wy * heights + ctr_y;
+  auto pred_w = (d.select(-1, 2) / ww).clamp_max(bbox_xform_clip).exp() * widths;
+  auto pred_h = (d.select(-1, 3) / wh).clamp_max(bbox_xform_clip).exp() * heights;
+
+  return at::stack({pred_ctr_x - 0.5 * pred_w, pred_ctr_y - 0.5 * pred_h,
+                    pred_ctr_x + 0.5 * pred_w, pred_ctr_y + 0.5 * pred_h}, -1).reshape(deltas.sizes());
+}
+
+}} // namespace at::native
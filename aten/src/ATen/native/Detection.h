@@ -0,0 +1,135 @@
+#pragma once
+
+// Helpers shared by the CPU and CUDA kernels of the detection ops (roi_align,
+// batched_nms), ported from caffe2/operators/roi_align_op and
+// generate_proposals_op_util_nms. Boxes are (x1, y1, x2, y2) with continuous
+// coordinates, i.e., a box from 0 to 1 has width 1.
+
+#include <ATen/ATen.h>
+#include <c10/macros/Macros.h>
+
+#include <cmath>
+
+namespace at { namespace native {
+
+// Where a roi_align bin of one RoI samples the input.
+template <typename T>
+struct RoIAlignBins {
+  int batch;
+  T start_h;
+  T start_w;
+  T bin_h;
+  T bin_w;
+  int grid_h;   // samples per bin along y
+  int grid_w;   // samples per bin along x
+};
+
+// roi is (batch_index, x1, y1, x2, y2). With aligned, pixel centers are
+// shifted by half a pixel, so that a box from 0 to 1 covers exactly one
+// pixel; otherwise malformed RoIs are forced to be at least 1x1, as in the
+// original Detectron implementation.
+template <typename T>
+C10_HOST_DEVICE inline RoIAlignBins<T> roi_align_bins(
+    const T* roi, T spatial_scale, int pooled_height, int pooled_width,
+    int sampling_ratio, bool aligned) {
+  RoIAlignBins<T> bins;
+  bins.batch = static_cast<int>(roi[0]);
+  const T offset = aligned ? T(0.5) : T(0);
+  bins.start_w = roi[1] * spatial_scale - offset;
+  bins.start_h = roi[2] * spatial_scale - offset;
+  T roi_width = roi[3] * spatial_scale - offset - bins.start_w;
+  T roi_height = roi[4] * spatial_scale - offset - bins.start_h;
+  if (!aligned) {
+    roi_width = roi_width < T(1) ? T(1) : roi_width;
+    roi_height = roi_height < T(1) ? T(1) : roi_height;
+  }
+  bins.bin_h = roi_height / pooled_height;
+  bins.bin_w = roi_width / pooled_width;
+  // an adaptive number of samples approximates the integral over the bin
+  bins.grid_h = sampling_ratio > 0 ? sampling_ratio : static_cast<int>(::ceil(roi_height / pooled_height));
+  bins.grid_w = sampling_ratio > 0 ? sampling_ratio : static_cast<int>(::ceil(roi_width / pooled_width));
+  return bins;
+}
+
+// Bilinear interpolation weights of the four pixels around (y, x). Returns
+// false if the point is outside the input, in which case it contributes 0.
+template <typename T>
+C10_HOST_DEVICE inline bool roi_align_bilinear_weights(
+    int height, int width, T y, T x,
+    int& y_low, int& y_high, int& x_low, int& x_high,
+    T& w1, T& w2, T& w3, T& w4) {
+  if (y < T(-1) || y > height || x < T(-1) || x > width) {
+    return false;
+  }
+  y = y <= 0 ? T(0) : y;
+  x = x <= 0 ? T(0) : x;
+
+  y_low = static_cast<int>(y);
+  x_low = static_cast<int>(x);
+  if (y_low >= height - 1) {
+    y_high = y_low = height - 1;
+    y = static_cast<T>(y_low);
+  } else {
+    y_high = y_low + 1;
+  }
+  if (x_low >= width - 1) {
+    x_high = x_low = width - 1;
+    x = static_cast<T>(x_low);
+  } else {
+    x_high = x_low + 1;
+  }
+
+  const T ly = y - y_low;
+  const T lx = x - x_low;
+  const T hy = T(1) - ly;
+  const T hx = T(1) - lx;
+  w1 = hy * hx;
+  w2 = hy * lx;
+  w3 = ly * hx;
+  w4 = ly * lx;
+  return true;
+}
+
+// Calls fn(y_low, y_high, x_low, x_high, w1, w2, w3, w4) for every sample of
+// the bin (ph, pw) that lies in the input, with the weights divided by the
+// number of samples so that they average over the bin.
+template <typename T, typename F>
+C10_HOST_DEVICE inline void roi_align_for_each_sample(
+    const RoIAlignBins<T>& bins, int height, int width, int ph, int pw, const F& fn) {
+  const T count = bins.grid_h * bins.grid_w > 0 ? T(bins.grid_h * bins.grid_w) : T(1);
+  for (int iy = 0; iy < bins.grid_h; iy++) {
+    const T y = bins.start_h + ph * bins.bin_h + (iy + T(0.5)) * bins.bin_h / bins.grid_h;
+    for (int ix = 0; ix < bins.grid_w; ix++) {
+      const T x = bins.start_w + pw * bins.bin_w + (ix + T(0.5)) * bins.bin_w / bins.grid_w;
+      int y_low, y_high, x_low, x_high;
+      T w1, w2, w3, w4;
+      if (roi_align_bilinear_weights(height, width, y, x, y_low, y_high, x_low, x_high, w1, w2, w3, w4)) {
+        fn(y_low, y_high, x_low, x_high, w1 / count, w2 / count, w3 / count, w4 / count);
+      }
+    }
+  }
+}
+
+// Whether the intersection over union of two boxes exceeds the threshold.
+template <typename T>
+C10_HOST_DEVICE inline bool nms_iou_above(const T* a, const T* b, T threshold) {
+  const T left = a[0] > b[0] ? a[0] : b[0];
+  const T right = a[2] < b[2] ? a[2] : b[2];
+  const T top = a[1] > b[1] ? a[1] : b[1];
+  const T bottom = a[3] < b[3] ? a[3] : b[3];
+  const T width = right - left > T(0) ? right - left : T(0);
+  const T height = bottom - top > T(0) ? bottom - top : T(0);
+  const T intersection = width * height;
+  const T area_a = (a[2] - a[0]) * (a[3] - a[1]);
+  const T area_b = (b[2] - b[0]) * (b[3] - b[1]);
+  return intersection > threshold * (area_a + area_b - intersection);
+}
+
+// Checks the shapes of the roi_align arguments; rois is (K, 5).
+void check_roi_align_inputs(
+    const Tensor& input, const Tensor& rois, int64_t pooled_height, int64_t pooled_width);
+
+// Checks the shapes of the nms arguments; boxes is (N, 4) and scores (N).
+void check_nms_inputs(const Tensor& boxes, const Tensor& scores);
+
+}} // namespace at::native
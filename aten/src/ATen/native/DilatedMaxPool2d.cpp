@@ -170,6 +170,18 @@ void max_pool2d_with_indices_out_cpu_template(
     inputHeight, inputWidth,
     outputHeight, outputWidth);
 
+  if (input_.ndimension() == 4 && input_.suggest_memory_format() == at::MemoryFormat::ChannelsLast) {
+    Tensor input = input_.contiguous(at::MemoryFormat::ChannelsLast);
+    output.resize_({nbatch, nInputPlane, outputHeight, outputWidth}, at::MemoryFormat::ChannelsLast);
+    indices.resize_({nbatch, nInputPlane, outputHeight, outputWidth}, at::MemoryFormat::ChannelsLast);
+    max_pool2d_channels_last_kernel(
+      kCPU, output, indices, input,
+      kW, kH, dW, dH,
+      padW, padH,
+      dilationW, dilationH);
+    return;
+  }
+
   /* get contiguous input */
   Tensor input = input_.contiguous();
 
@@ -298,7 +310,7 @@ Tensor& max_pool2d_with_indices_backward_out_cpu_template(
           Tensor& gradInput,
           const Tensor& gradOutput_,
           const Tensor& input,
-          const Tensor& indices,
+          const Tensor& indices_,
           IntArrayRef kernel_size,
           IntArrayRef stride,
           IntArrayRef padding,
@@ -332,20 +344,13 @@ Tensor& max_pool2d_with_indices_backward_out_cpu_template(
   TORCH_CHECK((input.ndimension() == 3 || input.ndimension() == 4),
     "non-empty 3D or 4D (batch mode) tensor expected for input");
 
-  /* get contiguous gradOutput */
-  const Tensor gradOutput = gradOutput_.contiguous();
-
-  /* resize */
-  gradInput.resize_as_(input);
-  gradInput.zero_();
-
   /* sizes */
   const int64_t nbatch = input.ndimension() == 4 ? input.size(-4) : 1;
   const int64_t nInputPlane = input.size(-3);
   const int64_t inputHeight = input.size(-2);
   const int64_t inputWidth = input.size(-1);
-  const int64_t outputHeight = gradOutput.size(-2);
-  const int64_t outputWidth = gradOutput.size(-1);
+  const int64_t outputHeight = gradOutput_.size(-2);
+  const int64_t outputWidth = gradOutput_.size(-1);
 
   /* XXX preserve the existing shape check behavior */
   const int64_t outputHeight_for_shape_check = pooling_output_shape<int64_t>(inputHeight, kH, padH, dH, dilationH, ceil_mode);
@@ -354,13 +359,31 @@ Tensor& max_pool2d_with_indices_backward_out_cpu_template(
   max_pool2d_backward_shape_check(
     input,
     gradOutput_,
-    indices,
+    indices_,
     nbatch,
     kH, kW, dH, dW, padH, padW, dilationH, dilationW,
     nInputPlane,
     inputHeight, inputWidth,
     outputHeight_for_shape_check, outputWidth_for_shape_check);
 
+  if (input.ndimension() == 4 && input.suggest_memory_format() == at::MemoryFormat::ChannelsLast) {
+    gradInput.resize_(input.sizes(), at::MemoryFormat::ChannelsLast);
+    gradInput.zero_();
+    max_pool2d_backward_channels_last_kernel(
+      kCPU, gradInput,
+      gradOutput_.contiguous(at::MemoryFormat::ChannelsLast),
+      indices_.contiguous(at::MemoryFormat::ChannelsLast));
+    return gradInput;
+  }
+
+  /* get contiguous gradOutput and indices */
+  const Tensor gradOutput = gradOutput_.contiguous();
+  const Tensor indices = indices_.contiguous();
+
+  /* resize */
+  gradInput.resize_as_(input);
+  gradInput.zero_();
+
   /* backprop */
   if (input.ndimension() == 3)
   {
@@ -501,5 +524,8 @@ Tensor max_pool2d_with_indices_backward_cpu(
   return gradInput;
 }
 
+DEFINE_DISPATCH(max_pool2d_channels_last_kernel);
+DEFINE_DISPATCH(max_pool2d_backward_channels_last_kernel);
+
 } // at::native
 } // at
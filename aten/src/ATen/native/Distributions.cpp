@@ -15,6 +15,8 @@
 #include <ATen/native/DispatchStub.h>
 #include <ATen/native/UnaryOps.h>
 #include <ATen/NamedTensorUtils.h>
+#include <ATen/LegacyTHFunctionsCPU.h>
+#include <ATen/Parallel.h>
 
 #include <type_traits>
 #include <functional>
@@ -106,6 +108,69 @@ int64_t sample_poisson(double lambda, at::CPUGenerator* generator) {
   }
 }
 
+// Number of elements drawn from one Philox subsequence. It is fixed rather
+// than derived from the parallel_for chunks, so that the numbers don't depend
+// on the number of threads. See Note [Philox mode of CPUGenerator].
+constexpr int64_t kPhiloxBlockSize = 4096;
+
+template <typename T>
+T philox_uniform(at::philox_engine& engine);
+
+template <>
+inline float philox_uniform<float>(at::philox_engine& engine) {
+  return (engine() & at::FLOAT_MASK) * at::FLOAT_DIVISOR;
+}
+
+template <>
+inline double philox_uniform<double>(at::philox_engine& engine) {
+  const uint64_t hi = engine();
+  const uint64_t lo = engine();
+  return (((hi << 32) | lo) & at::DOUBLE_MASK) * at::DOUBLE_DIVISOR;
+}
+
+// 32 bit numbers used by philox_uniform<T>
+template <typename T>
+constexpr int64_t philox_uniform_draws() {
+  return std::is_same<T, double>::value ? 2 : 1;
+}
+
+bool use_philox(at::CPUGenerator* generator, const at::Tensor& self) {
+  return generator->philox_mode() &&
+      (self.scalar_type() == at::kFloat || self.scalar_type() == at::kDouble);
+}
+
+// Sets self[i] = sample(engine, i) in parallel, where sample draws at most
+// draws 32 bit numbers from engine, the philox_engine of the block of i.
+template <typename scalar_t, typename sample_t>
+void philox_fill(at::Tensor& self, at::CPUGenerator* generator, int64_t draws, const sample_t& sample) {
+  const int64_t numel = self.numel();
+  if (numel == 0) {
+    return;
+  }
+  std::pair<uint64_t, uint64_t> seeds;
+  {
+    // See Note [Acquire lock when using random generators]
+    std::lock_guard<std::mutex> lock(generator->mutex_);
+    seeds = generator->philox_engine_inputs(at::divup(kPhiloxBlockSize * draws, 4));
+  }
+  at::Tensor out = self.is_contiguous() ? self : at::empty(self.sizes(), self.options());
+  scalar_t* data = out.data_ptr<scalar_t>();
+  const int64_t num_blocks = at::divup(numel, kPhiloxBlockSize);
+  const int64_t grain_size = std::max<int64_t>(1, at::internal::GRAIN_SIZE / kPhiloxBlockSize);
+  at::parallel_for(0, num_blocks, grain_size, [&](int64_t begin, int64_t end) {
+    for (int64_t block = begin; block < end; ++block) {
+      at::philox_engine engine(seeds.first, block, seeds.second);
+      const int64_t stop = std::min(numel, (block + 1) * kPhiloxBlockSize);
+      for (int64_t i = block * kPhiloxBlockSize; i < stop; ++i) {
+        data[i] = sample(engine, i);
+      }
+    }
+  });
+  if (!out.is_same(self)) {
+    self.copy_(out);
+  }
+}
+
 } // namespace
 
 namespace at {
@@ -134,8 +199,22 @@ Tensor& bernoulli_tensor_cpu_(Tensor& self, const Tensor& p_, Generator* gen) {
 #ifdef BUILD_NAMEDTENSOR
   NoNamesGuard guard;
 #endif
+  CPUGenerator* generator = get_generator_or_default<CPUGenerator>(gen, detail::getDefaultCPUGenerator());
+  if (use_philox(generator, self)) {
+    AT_DISPATCH_FLOATING_TYPES(self.scalar_type(), "bernoulli_tensor_cpu_self_", [&] {
+      using self_t = scalar_t;
+      AT_DISPATCH_FLOATING_TYPES(p_.scalar_type(), "bernoulli_tensor_cpu_p_", [&] {
+        auto p = std::get<0>(expand_inplace(self, p_.to(kCPU))).contiguous();
+        const scalar_t* p_data = p.data_ptr<scalar_t>();
+        philox_fill<self_t>(self, generator, philox_uniform_draws<double>(),
+          [p_data](at::philox_engine& engine, int64_t i) {
+            return static_cast<self_t>(philox_uniform<double>(engine) < p_data[i]);
+          });
+      });
+    });
+    return self;
+  }
   AT_DISPATCH_ALL_TYPES_AND(at::ScalarType::Bool, self.scalar_type(), "bernoulli_tensor_cpu_self_", [&] {
-    CPUGenerator* generator = get_generator_or_default<CPUGenerator>(gen, detail::getDefaultCPUGenerator());
     // See Note [Acquire lock when using random generators]
     std::lock_guard<std::mutex> lock(generator->mutex_);
     using self_t = scalar_t;
@@ -165,6 +244,16 @@ DEFINE_DISPATCH(bernoulli_mkl_stub);
 
 Tensor& bernoulli_scalar_cpu_(Tensor& self, double p, Generator* gen) {
   TORCH_CHECK(0 <= p && p <= 1, "bernoulli_ expects p to be in [0, 1], but got p=", p);
+  CPUGenerator* generator = get_generator_or_default<CPUGenerator>(gen, detail::getDefaultCPUGenerator());
+  if (use_philox(generator, self)) {
+    AT_DISPATCH_FLOATING_TYPES(self.scalar_type(), "bernoulli_scalar_cpu_", [&] {
+      philox_fill<scalar_t>(self, generator, philox_uniform_draws<double>(),
+        [p](at::philox_engine& engine, int64_t) {
+          return static_cast<scalar_t>(philox_uniform<double>(engine) < p);
+        });
+    });
+    return self;
+  }
 #if AT_MKL_ENABLED()
   if (cpuinfo_initialize() && cpuinfo_vendor_intel == cpuinfo_get_processor(0)->core->vendor) {
     bernoulli_mkl_stub(kCPU, self, p, gen);
@@ -172,7 +261,6 @@ Tensor& bernoulli_scalar_cpu_(Tensor& self, double p, Generator* gen) {
   }
 #endif
   AT_DISPATCH_ALL_TYPES_AND(at::ScalarType::Bool, self.scalar_type(), "bernoulli_scalar_cpu_", [&] {
-    CPUGenerator* generator = get_generator_or_default<CPUGenerator>(gen, detail::getDefaultCPUGenerator());
     // See Note [Acquire lock when using random generators]
     std::lock_guard<std::mutex> lock(generator->mutex_);
     CPU_tensor_apply1<scalar_t>(
@@ -184,6 +272,45 @@ Tensor& bernoulli_scalar_cpu_(Tensor& self, double p, Generator* gen) {
   return self;
 }
 
+Tensor& uniform_cpu_(Tensor& self, double from, double to, Generator* gen) {
+  CPUGenerator* generator = get_generator_or_default<CPUGenerator>(gen, detail::getDefaultCPUGenerator());
+  if (!use_philox(generator, self)) {
+    return legacy::cpu::_th_uniform_(self, from, to, gen);
+  }
+  TORCH_CHECK(from <= to, "uniform_ expects to return a [from, to) range, but found from=", from,
+              " > to=", to);
+  AT_DISPATCH_FLOATING_TYPES(self.scalar_type(), "uniform_cpu_", [&] {
+    const scalar_t from_ = static_cast<scalar_t>(from);
+    const scalar_t range = static_cast<scalar_t>(to - from);
+    philox_fill<scalar_t>(self, generator, philox_uniform_draws<scalar_t>(),
+      [from_, range](at::philox_engine& engine, int64_t) {
+        return philox_uniform<scalar_t>(engine) * range + from_;
+      });
+  });
+  return self;
+}
+
+Tensor& normal_cpu_(Tensor& self, double mean, double std, Generator* gen) {
+  CPUGenerator* generator = get_generator_or_default<CPUGenerator>(gen, detail::getDefaultCPUGenerator());
+  if (!use_philox(generator, self)) {
+    return legacy::cpu::_th_normal_(self, mean, std, gen);
+  }
+  TORCH_CHECK(std > 0.0, "normal_ expects std > 0.0, but found std=", std);
+  AT_DISPATCH_FLOATING_TYPES(self.scalar_type(), "normal_cpu_", [&] {
+    const scalar_t mean_ = static_cast<scalar_t>(mean);
+    const scalar_t std_ = static_cast<scalar_t>(std);
+    // Box-Muller, as at::normal_distribution, without caching the second sample
+    philox_fill<scalar_t>(self, generator, 2 * philox_uniform_draws<scalar_t>(),
+      [mean_, std_](at::philox_engine& engine, int64_t) {
+        const scalar_t u1 = philox_uniform<scalar_t>(engine);
+        const scalar_t u2 = philox_uniform<scalar_t>(engine);
+        const scalar_t r = ::sqrt(static_cast<scalar_t>(-2.0) * ::log(static_cast<scalar_t>(1.0) - u2));
+        const scalar_t theta = static_cast<scalar_t>(2.0) * static_cast<scalar_t>(M_PI) * u1;
+        return r * ::cos(theta) * std_ + mean_;
+      });
+  });
+  return self;
+}
 
 Tensor _standard_gamma_grad_cpu(const Tensor& self, const Tensor& output) {
   Tensor ret = at::empty(self.sizes(), self.options());
@@ -387,6 +387,193 @@ _embedding_bag_cpu(const Tensor &weight, const Tensor &indices,
   }
 }
 
+// Computes one table of _embedding_bag_grouped into columns
+// [column_offset, column_offset + weight.size(1)) of the concatenated output.
+// Float tables with contiguous rows go through the same perfkernel as the
+// embedding_bag fast path, staged in `buffer` since the kernel can only write
+// densely packed rows.
+template<typename scalar_t>
+static void embedding_bag_grouped_table(const Tensor &weight,
+                                        const Tensor &indices,
+                                        const Tensor &offsets,
+                                        const Tensor &per_sample_weights,
+                                        const int64_t mode,
+                                        Tensor &output,
+                                        int64_t column_offset,
+                                        std::vector<scalar_t>& /*buffer*/) {
+  auto weight_data = weight.data_ptr<scalar_t>();
+  auto indices_data = indices.data_ptr<int64_t>();
+  auto offsets_data = offsets.data_ptr<int64_t>();
+  auto per_sample_weights_data =
+      per_sample_weights.defined() ? per_sample_weights.data_ptr<scalar_t>() : nullptr;
+  auto output_data = output.data_ptr<scalar_t>() + column_offset;
+  int64_t num_bags = offsets.numel();
+  int64_t numel = indices.numel();
+  int64_t num_weights = weight.size(0);
+  int64_t ddim = weight.size(1);
+  auto weight_stride0 = weight.stride(0);
+  auto weight_stride1 = weight.stride(1);
+  auto output_stride0 = output.stride(0);
+
+  for (int64_t bag = 0; bag < num_bags; bag++) {
+    auto* output_base = output_data + output_stride0 * bag;
+    std::fill(output_base, output_base + ddim, static_cast<scalar_t>(0));
+    int64_t start = offsets_data[bag];
+    int64_t end = bag == num_bags - 1 ? numel : offsets_data[bag + 1];
+    for (int64_t i = start; i < end; i++) {
+      auto idx = indices_data[i];
+      TORCH_CHECK(idx >= 0 && idx < num_weights,
+          "_embedding_bag_grouped: index ", idx, " is out of bounds for a table of size ", num_weights);
+      auto* src_base = weight_data + weight_stride0 * idx;
+      auto scale = per_sample_weights_data ? per_sample_weights_data[i] : static_cast<scalar_t>(1);
+      for (int64_t j = 0; j < ddim; j++) {
+        output_base[j] += src_base[j * weight_stride1] * scale;
+      }
+    }
+    if (mode == MODE_MEAN && end > start) {
+      for (int64_t j = 0; j < ddim; j++) {
+        output_base[j] /= (end - start);
+      }
+    }
+  }
+}
+
+template<>
+void embedding_bag_grouped_table<float>(const Tensor &weight,
+                                        const Tensor &indices,
+                                        const Tensor &offsets,
+                                        const Tensor &per_sample_weights,
+                                        const int64_t mode,
+                                        Tensor &output,
+                                        int64_t column_offset,
+                                        std::vector<float>& buffer) {
+  int64_t num_bags = offsets.numel();
+  int64_t ddim = weight.size(1);
+
+  if (!weight.is_contiguous() || num_bags == 0) {
+    embedding_bag_grouped_table<float>(
+        weight, indices, offsets, per_sample_weights, mode, output, column_offset, buffer);
+    return;
+  }
+
+  // A single table owns whole output rows and can be written in place.
+  bool in_place = output.stride(0) == ddim;
+  if (!in_place) {
+    buffer.resize(num_bags * ddim);
+  }
+  float* out = in_place ? output.data_ptr<float>() + column_offset : buffer.data();
+
+  caffe2::EmbeddingLookupIdx(
+    /*block_size=*/ddim,
+    /*output_size=*/num_bags,
+    /*index_size=*/indices.numel(),
+    /*data_size=*/weight.size(0),
+    /*input=*/weight.data_ptr<float>(),
+    /*indices=*/indices.data_ptr<int64_t>(),
+    /*offsets=*/offsets.data_ptr<int64_t>(),
+    /*weights=*/per_sample_weights.defined() ? per_sample_weights.data_ptr<float>() : nullptr,
+    /*scale_bias=*/nullptr,
+    /*normalize_by_lengths=*/mode == MODE_MEAN,
+    /*out=*/out
+  );
+
+  if (!in_place) {
+    auto output_data = output.data_ptr<float>() + column_offset;
+    auto output_stride0 = output.stride(0);
+    for (int64_t bag = 0; bag < num_bags; bag++) {
+      std::memcpy(output_data + output_stride0 * bag, out + bag * ddim, ddim * sizeof(float));
+    }
+  }
+}
+
+// Runs embedding_bag in 'sum' or 'mean' mode over a group of tables that share
+// the same number of bags, writing the results side by side into one
+// [num_bags, sum(weights[i].size(1))] output. Tables are distributed over
+// threads, so a whole group costs a single parallel region instead of one
+// embedding_bag call, offset2bag computation and output allocation per table.
+// An empty per_sample_weights list means no table is weighted.
+Tensor& _embedding_bag_grouped_out_cpu(Tensor& output,
+                                       TensorList weights,
+                                       TensorList indices,
+                                       TensorList offsets,
+                                       TensorList per_sample_weights,
+                                       const int64_t mode) {
+  int64_t num_tables = weights.size();
+  TORCH_CHECK(num_tables > 0, "_embedding_bag_grouped: expected at least one table");
+  TORCH_CHECK(indices.size() == weights.size() && offsets.size() == weights.size(),
+      "_embedding_bag_grouped: expected as many indices and offsets as weights, but got ",
+      weights.size(), " weights, ", indices.size(), " indices and ", offsets.size(), " offsets");
+  TORCH_CHECK(per_sample_weights.empty() || per_sample_weights.size() == weights.size(),
+      "_embedding_bag_grouped: expected per_sample_weights to be empty or to have one entry per table, "
+      "but got ", per_sample_weights.size(), " entries for ", weights.size(), " tables");
+  TORCH_CHECK(mode == MODE_SUM || mode == MODE_MEAN,
+      "_embedding_bag_grouped: only mode='sum' and mode='mean' are supported");
+  TORCH_CHECK(per_sample_weights.empty() || mode == MODE_SUM,
+      "_embedding_bag_grouped: per_sample_weights only supported with mode='sum'");
+
+  auto scalar_type = weights[0].scalar_type();
+  int64_t num_bags = offsets[0].numel();
+  std::vector<int64_t> column_offsets(num_tables + 1, 0);
+  std::vector<Tensor> indices_contig(num_tables);
+  std::vector<Tensor> offsets_contig(num_tables);
+  std::vector<Tensor> per_sample_weights_contig(num_tables);
+  for (int64_t t = 0; t < num_tables; t++) {
+    auto weight_arg = TensorArg(weights[t], "weights", 1);
+    checkScalarTypes("_embedding_bag_grouped", weight_arg, {kFloat, kDouble});
+    checkDim("_embedding_bag_grouped", weight_arg, 2);
+    TORCH_CHECK(weights[t].scalar_type() == scalar_type,
+        "_embedding_bag_grouped: expected all weights to have the same dtype");
+    auto indices_arg = TensorArg(indices[t], "indices", 2);
+    checkScalarType("_embedding_bag_grouped", indices_arg, kLong);
+    checkDim("_embedding_bag_grouped", indices_arg, 1);
+    auto offsets_arg = TensorArg(offsets[t], "offsets", 3);
+    checkScalarType("_embedding_bag_grouped", offsets_arg, kLong);
+    checkDim("_embedding_bag_grouped", offsets_arg, 1);
+    TORCH_CHECK(offsets[t].numel() == num_bags,
+        "_embedding_bag_grouped: expected every table to have ", num_bags,
+        " bags, but table ", t, " has ", offsets[t].numel());
+    if (!per_sample_weights.empty()) {
+      auto per_sample_weights_arg = TensorArg(per_sample_weights[t], "per_sample_weights", 4);
+      checkSameType("_embedding_bag_grouped", weight_arg, per_sample_weights_arg);
+      TORCH_CHECK(per_sample_weights[t].dim() == 1 && per_sample_weights[t].numel() == indices[t].numel(),
+          "_embedding_bag_grouped: expected per_sample_weights[", t, "] to be 1D with the same number of "
+          "elements as indices[", t, "]");
+      per_sample_weights_contig[t] = per_sample_weights[t].contiguous();
+    }
+    indices_contig[t] = indices[t].contiguous();
+    offsets_contig[t] = offsets[t].contiguous();
+    column_offsets[t + 1] = column_offsets[t] + weights[t].size(1);
+  }
+
+  TORCH_CHECK(output.scalar_type() == scalar_type,
+      "_embedding_bag_grouped: expected out to have dtype ", scalar_type, " but got ", output.scalar_type());
+  output.resize_({num_bags, column_offsets[num_tables]});
+  TORCH_CHECK(output.is_contiguous(), "_embedding_bag_grouped: expected out to be contiguous");
+
+  AT_DISPATCH_FLOATING_TYPES(scalar_type, "_embedding_bag_grouped_cpu", [&]() {
+    at::parallel_for(0, num_tables, 1, [&](int64_t begin, int64_t end) {
+      std::vector<scalar_t> buffer;
+      for (int64_t t = begin; t < end; t++) {
+        embedding_bag_grouped_table<scalar_t>(
+            weights[t], indices_contig[t], offsets_contig[t], per_sample_weights_contig[t],
+            mode, output, column_offsets[t], buffer);
+      }
+    });
+  });
+  return output;
+}
+
+Tensor _embedding_bag_grouped_cpu(TensorList weights,
+                                  TensorList indices,
+                                  TensorList offsets,
+                                  TensorList per_sample_weights,
+                                  const int64_t mode) {
+  TORCH_CHECK(weights.size() > 0, "_embedding_bag_grouped: expected at least one table");
+  auto output = at::empty({0}, weights[0].options());
+  _embedding_bag_grouped_out_cpu(output, weights, indices, offsets, per_sample_weights, mode);
+  return output;
+}
+
 // Assumes all input tensors are contiguous.
 // See NOTE [ embedding_bag Native Functions ] in native_functions.yaml for details
 Tensor _embedding_bag_backward(const Tensor &grad, const Tensor &indices,
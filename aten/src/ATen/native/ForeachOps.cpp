@@ -0,0 +1,266 @@
+#include <ATen/native/ForeachUtils.h>
+
+#include <ATen/ATen.h>
+#include <ATen/NativeFunctions.h>
+
+namespace at { namespace native {
+
+DEFINE_DISPATCH(foreach_add_scalar_stub);
+DEFINE_DISPATCH(foreach_mul_scalar_stub);
+DEFINE_DISPATCH(foreach_add_list_stub);
+DEFINE_DISPATCH(foreach_mul_list_stub);
+DEFINE_DISPATCH(foreach_norm_stub);
+
+namespace {
+
+bool is_fast_path_dtype(ScalarType dtype, bool allow_half) {
+  return isIntegralType(dtype, /*includeBool=*/false) || dtype == kFloat || dtype == kDouble ||
+      (allow_half && dtype == kHalf);
+}
+
+// The scalar doesn't change the dtype of the result under type promotion
+bool is_fast_path_scalar(ScalarType dtype, Scalar scalar) {
+  if (scalar.isComplex()) {
+    return false;
+  }
+  return !(isIntegralType(dtype, /*includeBool=*/false) && scalar.isFloatingPoint());
+}
+
+bool is_fast_path_tensor(const Tensor& t, const Tensor& first) {
+  return t.layout() == kStrided && t.device() == first.device() &&
+      t.scalar_type() == first.scalar_type() && t.is_contiguous();
+}
+
+} // namespace
+
+void check_foreach_lists(const char* name, TensorList tensors1, TensorList tensors2) {
+  TORCH_CHECK(tensors1.size() == tensors2.size(), name, ": expected both lists to have the same length, ",
+      "but got lists of length ", tensors1.size(), " and ", tensors2.size());
+}
+
+bool can_use_foreach_fast_path(TensorList tensors, Scalar scalar, bool allow_half) {
+  if (tensors.empty()) {
+    return false;
+  }
+  const Tensor& first = tensors[0];
+  if (!is_fast_path_dtype(first.scalar_type(), allow_half) || !is_fast_path_scalar(first.scalar_type(), scalar)) {
+    return false;
+  }
+  for (const Tensor& t : tensors) {
+    if (!is_fast_path_tensor(t, first)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool can_use_foreach_fast_path(TensorList tensors1, TensorList tensors2, Scalar alpha, bool allow_half) {
+  if (!can_use_foreach_fast_path(tensors1, alpha, allow_half)) {
+    return false;
+  }
+  const Tensor& first = tensors1[0];
+  for (size_t i = 0; i < tensors2.size(); i++) {
+    if (!is_fast_path_tensor(tensors2[i], first) || tensors2[i].sizes() != tensors1[i].sizes()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool can_use_foreach_scale_fast_path(TensorList tensors, const Tensor& scale, bool allow_half) {
+  if (!can_use_foreach_fast_path(tensors, 1, allow_half)) {
+    return false;
+  }
+  const ScalarType dtype = tensors[0].scalar_type();
+  return scale.numel() == 1 && scale.device() == tensors[0].device() && !isComplexType(scale.scalar_type()) &&
+      (isFloatingType(dtype) || !isFloatingType(scale.scalar_type()));
+}
+
+bool can_use_foreach_norm_fast_path(TensorList tensors, Scalar ord, bool allow_half) {
+  return can_use_foreach_fast_path(tensors, 1, allow_half) && isFloatingType(tensors[0].scalar_type()) &&
+      !ord.isComplex() && ord.toDouble() == 2;
+}
+
+std::vector<Tensor> empty_like_list(TensorList tensors) {
+  std::vector<Tensor> result;
+  result.reserve(tensors.size());
+  for (const Tensor& t : tensors) {
+    result.push_back(at::empty_like(t));
+  }
+  return result;
+}
+
+std::vector<Tensor> foreach_add_scalar_slow(TensorList tensors, Scalar scalar) {
+  std::vector<Tensor> result;
+  result.reserve(tensors.size());
+  for (const Tensor& t : tensors) {
+    result.push_back(at::add(t, scalar));
+  }
+  return result;
+}
+
+void foreach_add_scalar_slow_(TensorList self, Scalar scalar) {
+  for (const Tensor& t : self) {
+    const_cast<Tensor&>(t).add_(scalar);
+  }
+}
+
+std::vector<Tensor> foreach_mul_scalar_slow(TensorList tensors, Scalar scalar) {
+  std::vector<Tensor> result;
+  result.reserve(tensors.size());
+  for (const Tensor& t : tensors) {
+    result.push_back(at::mul(t, scalar));
+  }
+  return result;
+}
+
+void foreach_mul_scalar_slow_(TensorList self, Scalar scalar) {
+  for (const Tensor& t : self) {
+    const_cast<Tensor&>(t).mul_(scalar);
+  }
+}
+
+std::vector<Tensor> foreach_add_list_slow(TensorList tensors1, TensorList tensors2, Scalar alpha) {
+  std::vector<Tensor> result;
+  result.reserve(tensors1.size());
+  for (size_t i = 0; i < tensors1.size(); i++) {
+    result.push_back(at::add(tensors1[i], tensors2[i], alpha));
+  }
+  return result;
+}
+
+void foreach_add_list_slow_(TensorList self, TensorList other, Scalar alpha) {
+  for (size_t i = 0; i < self.size(); i++) {
+    const_cast<Tensor&>(self[i]).add_(other[i], alpha);
+  }
+}
+
+std::vector<Tensor> foreach_mul_list_slow(TensorList tensors1, TensorList tensors2) {
+  std::vector<Tensor> result;
+  result.reserve(tensors1.size());
+  for (size_t i = 0; i < tensors1.size(); i++) {
+    result.push_back(at::mul(tensors1[i], tensors2[i]));
+  }
+  return result;
+}
+
+void foreach_mul_list_slow_(TensorList self, TensorList other) {
+  for (size_t i = 0; i < self.size(); i++) {
+    const_cast<Tensor&>(self[i]).mul_(other[i]);
+  }
+}
+
+// The tensors may be on several devices, e.g. the gradients of a model split
+// over GPUs, for which other is copied to each of them
+void foreach_mul_tensor_slow_(TensorList self, const Tensor& other) {
+  for (const Tensor& t : self) {
+    const bool other_on_device = other.device() == t.device() || (other.dim() == 0 && other.device().is_cpu());
+    const_cast<Tensor&>(t).mul_(other_on_device ? other : other.to(t.device()));
+  }
+}
+
+Tensor foreach_norm_slow(TensorList tensors, Scalar ord) {
+  // The ord-norm of the norms of the tensors is the norm of all of them,
+  // which are gathered on the device of the first. Empty tensors add
+  // nothing, and have no inf-norm.
+  std::vector<Tensor> norms;
+  norms.reserve(tensors.size());
+  for (const Tensor& t : tensors) {
+    if (t.numel() == 0) {
+      continue;
+    }
+    Tensor norm = at::norm(t, ord);
+    norms.push_back(norms.empty() ? norm : norm.to(norms[0].options()));
+  }
+  if (norms.empty()) {
+    return at::zeros({}, tensors[0].options());
+  }
+  return at::norm(at::stack(norms), ord);
+}
+
+std::vector<Tensor> foreach_add_scalar_cpu(TensorList tensors, Scalar scalar) {
+  if (!can_use_foreach_fast_path(tensors, scalar, /*allow_half=*/false)) {
+    return foreach_add_scalar_slow(tensors, scalar);
+  }
+  auto result = empty_like_list(tensors);
+  foreach_add_scalar_stub(kCPU, result, tensors, scalar);
+  return result;
+}
+
+void foreach_add_scalar_cpu_(TensorList self, Scalar scalar) {
+  if (!can_use_foreach_fast_path(self, scalar, /*allow_half=*/false)) {
+    return foreach_add_scalar_slow_(self, scalar);
+  }
+  foreach_add_scalar_stub(kCPU, self, self, scalar);
+}
+
+std::vector<Tensor> foreach_mul_scalar_cpu(TensorList tensors, Scalar scalar) {
+  if (!can_use_foreach_fast_path(tensors, scalar, /*allow_half=*/false)) {
+    return foreach_mul_scalar_slow(tensors, scalar);
+  }
+  auto result = empty_like_list(tensors);
+  foreach_mul_scalar_stub(kCPU, result, tensors, scalar);
+  return result;
+}
+
+void foreach_mul_scalar_cpu_(TensorList self, Scalar scalar) {
+  if (!can_use_foreach_fast_path(self, scalar, /*allow_half=*/false)) {
+    return foreach_mul_scalar_slow_(self, scalar);
+  }
+  foreach_mul_scalar_stub(kCPU, self, self, scalar);
+}
+
+std::vector<Tensor> foreach_add_list_cpu(TensorList tensors1, TensorList tensors2, Scalar alpha) {
+  check_foreach_lists("_foreach_add", tensors1, tensors2);
+  if (!can_use_foreach_fast_path(tensors1, tensors2, alpha, /*allow_half=*/false)) {
+    return foreach_add_list_slow(tensors1, tensors2, alpha);
+  }
+  auto result = empty_like_list(tensors1);
+  foreach_add_list_stub(kCPU, result, tensors1, tensors2, alpha);
+  return result;
+}
+
+void foreach_add_list_cpu_(TensorList self, TensorList other, Scalar alpha) {
+  check_foreach_lists("_foreach_add_", self, other);
+  if (!can_use_foreach_fast_path(self, other, alpha, /*allow_half=*/false)) {
+    return foreach_add_list_slow_(self, other, alpha);
+  }
+  foreach_add_list_stub(kCPU, self, self, other, alpha);
+}
+
+std::vector<Tensor> foreach_mul_list_cpu(TensorList tensors1, TensorList tensors2) {
+  check_foreach_lists("_foreach_mul", tensors1, tensors2);
+  if (!can_use_foreach_fast_path(tensors1, tensors2, 1, /*allow_half=*/false)) {
+    return foreach_mul_list_slow(tensors1, tensors2);
+  }
+  auto result = empty_like_list(tensors1);
+  foreach_mul_list_stub(kCPU, result, tensors1, tensors2, 1);
+  return result;
+}
+
+void foreach_mul_list_cpu_(TensorList self, TensorList other) {
+  check_foreach_lists("_foreach_mul_", self, other);
+  if (!can_use_foreach_fast_path(self, other, 1, /*allow_half=*/false)) {
+    return foreach_mul_list_slow_(self, other);
+  }
+  foreach_mul_list_stub(kCPU, self, self, other, 1);
+}
+
+void foreach_mul_tensor_cpu_(TensorList self, const Tensor& other) {
+  if (!can_use_foreach_scale_fast_path(self, other, /*allow_half=*/false)) {
+    return foreach_mul_tensor_slow_(self, other);
+  }
+  foreach_mul_scalar_stub(kCPU, self, self, other.item());
+}
+
+Tensor foreach_norm_cpu(TensorList tensors, Scalar ord) {
+  TORCH_CHECK(!tensors.empty(), "_foreach_norm: expected a non-empty list of tensors");
+  if (!can_use_foreach_norm_fast_path(tensors, ord, /*allow_half=*/false)) {
+    return foreach_norm_slow(tensors, ord);
+  }
+  Tensor result = at::empty({}, tensors[0].options());
+  foreach_norm_stub(kCPU, result, tensors);
+  return result;
+}
+
+}} // namespace at::native
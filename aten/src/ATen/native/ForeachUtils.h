@@ -0,0 +1,58 @@
+#pragma once
+
+// Pointwise ops over lists of tensors, see _foreach_add in
+// native_functions.yaml
+
+#include <ATen/ATen.h>
+#include <ATen/native/DispatchStub.h>
+
+#include <vector>
+
+namespace at { namespace native {
+
+// The kernels compute result[i] = self[i] op scalar, or
+// result[i] = self[i] op alpha * other[i] for the list ops (alpha is 1 for
+// mul). result is self for the in-place ops. They are only given lists that
+// can_use_foreach_fast_path accepts.
+using foreach_scalar_fn = void(*)(TensorList result, TensorList self, Scalar scalar);
+using foreach_list_fn = void(*)(TensorList result, TensorList self, TensorList other, Scalar alpha);
+// Sets result, a one-element tensor of the dtype of the tensors, to their
+// 2-norm.
+using foreach_norm_fn = void(*)(Tensor& result, TensorList tensors);
+
+DECLARE_DISPATCH(foreach_scalar_fn, foreach_add_scalar_stub);
+DECLARE_DISPATCH(foreach_scalar_fn, foreach_mul_scalar_stub);
+DECLARE_DISPATCH(foreach_list_fn, foreach_add_list_stub);
+DECLARE_DISPATCH(foreach_list_fn, foreach_mul_list_stub);
+DECLARE_DISPATCH(foreach_norm_fn, foreach_norm_stub);
+
+void check_foreach_lists(const char* name, TensorList tensors1, TensorList tensors2);
+
+// Whether the ops over the lists can run as one loop over all the tensors:
+// they must be strided and contiguous, of one device and of one dtype the
+// kernels handle, which Half only is on CUDA, the tensors at the same index
+// of both lists must have the same sizes, and the op must not change the
+// dtype under type promotion, e.g. adding a floating scalar to integers.
+// Everything else runs as one op per tensor.
+bool can_use_foreach_fast_path(TensorList tensors, Scalar scalar, bool allow_half);
+bool can_use_foreach_fast_path(TensorList tensors1, TensorList tensors2, Scalar alpha, bool allow_half);
+// The same for scaling the tensors by the one-element tensor scale, and for
+// their ord-norm, of floating tensors only
+bool can_use_foreach_scale_fast_path(TensorList tensors, const Tensor& scale, bool allow_half);
+bool can_use_foreach_norm_fast_path(TensorList tensors, Scalar ord, bool allow_half);
+
+// Empty tensors like the ones of the list, for the results of the kernels
+std::vector<Tensor> empty_like_list(TensorList tensors);
+
+std::vector<Tensor> foreach_add_scalar_slow(TensorList tensors, Scalar scalar);
+void foreach_add_scalar_slow_(TensorList self, Scalar scalar);
+std::vector<Tensor> foreach_mul_scalar_slow(TensorList tensors, Scalar scalar);
+void foreach_mul_scalar_slow_(TensorList self, Scalar scalar);
+std::vector<Tensor> foreach_add_list_slow(TensorList tensors1, TensorList tensors2, Scalar alpha);
+void foreach_add_list_slow_(TensorList self, TensorList other, Scalar alpha);
+std::vector<Tensor> foreach_mul_list_slow(TensorList tensors1, TensorList tensors2);
+void foreach_mul_list_slow_(TensorList self, TensorList other);
+void foreach_mul_tensor_slow_(TensorList self, const Tensor& other);
+Tensor foreach_norm_slow(TensorList tensors, Scalar ord);
+
+}} // namespace at::native
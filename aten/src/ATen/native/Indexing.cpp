@@ -54,6 +54,8 @@
 #include <ATen/ATen.h>
 #include <ATen/NativeFunctions.h>
 #include <ATen/ExpandUtils.h>
+#include <ATen/LegacyTHFunctionsCPU.h>
+#include <ATen/WrapDimUtils.h>
 #include <ATen/native/TensorIterator.h>
 #include <ATen/core/EnableNamedTensor.h>
 
@@ -67,7 +69,9 @@ namespace at { namespace native {
 DEFINE_DISPATCH(index_stub);
 DEFINE_DISPATCH(index_put_stub);
 DEFINE_DISPATCH(index_put_accum_stub);
-REGISTER_NO_CPU_DISPATCH(index_put_accum_stub, index_put_accum_fn);
+DEFINE_DISPATCH(scatter_add_stub);
+DEFINE_DISPATCH(gather_stub);
+DEFINE_DISPATCH(index_select_stub);
 
 static bool all_strides_match(TensorList tensors) {
   AT_ASSERT(tensors.size() >= 1);
@@ -246,11 +250,38 @@ Tensor index_put(const Tensor & self, TensorList indices, const Tensor & value,
   return self.clone(at::MemoryFormat::Preserve).index_put_(indices, value, accumulate);
 }
 
+// The CPU index_put_accum_stub only handles a long index vector on the first
+// dimension of a contiguous self, e.g. to accumulate rows of embeddings, see
+// Note [Parallel index_put_ with accumulate]. Other CPU cases take the serial
+// index_put_stub.
+static bool can_use_index_put_accum_cpu(const Tensor& self, TensorList indices, const Tensor& value) {
+  const auto dtype = self.scalar_type();
+  if (self.type().device_type() != kCPU || self.dim() == 0 || !self.is_contiguous() ||
+      !(isIntegralType(dtype) || dtype == kFloat || dtype == kDouble) ||
+      value.scalar_type() != dtype || value.device() != self.device() ||
+      value.is_alias_of(self)) {
+    return false;
+  }
+  if (indices.empty() || !indices[0].defined() || indices[0].scalar_type() != kLong ||
+      indices[0].dim() != 1 || indices[0].device() != self.device()) {
+    return false;
+  }
+  for (const auto& index : indices.slice(1)) {
+    if (index.defined()) {
+      return false;
+    }
+  }
+  auto shape = self.sizes().vec();
+  shape[0] = indices[0].numel();
+  return is_expandable_to(value.sizes(), shape);
+}
+
 Tensor & _index_put_impl_(Tensor & self, TensorList indices, const Tensor & value, const bool accumulate, const bool unsafe) {
   if (indices.size() > (size_t)self.dim()) {
     AT_INDEX_ERROR("too many indices for tensor of dimension ", self.dim(), " (got ", indices.size(), ")");
   }
-  if (accumulate && self.type().device_type() == kCUDA) {
+  if (accumulate && (self.type().device_type() == kCUDA ||
+                     can_use_index_put_accum_cpu(self, indices, value))) {
       index_put_accum_stub(self.type().device_type(), self, indices, value, unsafe);
       return self;
   }
@@ -265,6 +296,98 @@ Tensor & index_put_(Tensor & self, TensorList indices, const Tensor & value, con
   return at::_index_put_impl_(self, indices, value, accumulate, /*unsafe=*/false);
 }
 
+Tensor & scatter_add_cpu_(Tensor & self, int64_t dim, const Tensor & index, const Tensor & src) {
+  // Scalars keep the legacy semantics of TH, as do the tensors overlapping
+  // self, which the parallel kernel would race on
+  if (self.dim() == 0 || index.dim() == 0 || src.dim() == 0 ||
+      src.is_alias_of(self) || index.is_alias_of(self)) {
+    return legacy::cpu::_th_scatter_add_(self, dim, index, src);
+  }
+  dim = maybe_wrap_dim(dim, self.dim());
+  TORCH_CHECK(index.scalar_type() == kLong,
+              "scatter_add_(): Expected dtype int64 for index, but got ", index.scalar_type());
+  TORCH_CHECK(src.scalar_type() == self.scalar_type(),
+              "scatter_add_(): Expected src to have the dtype of self, ", self.scalar_type(),
+              ", but got ", src.scalar_type());
+  if (index.numel() == 0) {
+    return self;
+  }
+  TORCH_CHECK(index.dim() == self.dim(), "Index tensor must have same dimensions as output tensor");
+  TORCH_CHECK(src.dim() == self.dim(), "Input tensor must have same dimensions as output tensor");
+  for (int64_t d = 0; d < self.dim(); d++) {
+    TORCH_CHECK(index.size(d) <= src.size(d) && (d == dim || index.size(d) <= self.size(d)),
+                "Expected index ", index.sizes(), " to be smaller size than src ", src.sizes(),
+                " and to be smaller than tensor ", self.sizes(), " apart from dimension ", dim);
+  }
+  scatter_add_stub(kCPU, self, dim, index, src);
+  return self;
+}
+
+Tensor & index_select_out_cpu_(Tensor & result, const Tensor & self, int64_t dim, const Tensor & index) {
+  // Scalars and the strided tensors keep the legacy semantics of TH
+  if (self.dim() == 0 || !self.is_contiguous() || result.is_alias_of(self) ||
+      result.scalar_type() != self.scalar_type()) {
+    return legacy::cpu::_th_index_select_out(result, self, dim, index);
+  }
+  dim = maybe_wrap_dim(dim, self.dim());
+  TORCH_CHECK(index.scalar_type() == kLong,
+              "index_select(): Expected dtype int64 for index, but got ", index.scalar_type());
+  TORCH_CHECK(index.dim() <= 1, "index_select(): Index is supposed to be 1-dimensional");
+  auto result_sizes = self.sizes().vec();
+  result_sizes[dim] = index.numel();
+  result.resize_(result_sizes);
+  if (!result.is_contiguous()) {
+    return legacy::cpu::_th_index_select_out(result, self, dim, index);
+  }
+  auto index_contig = index.contiguous();
+  const int64_t* index_data = index_contig.data_ptr<int64_t>();
+  const int64_t max = self.size(dim) - 1;
+  for (int64_t i = 0; i < index_contig.numel(); i++) {
+    TORCH_CHECK(index_data[i] >= 0 && index_data[i] <= max,
+                "index out of range: Tried to access index ", index_data[i],
+                " out of table with ", max, " rows.");
+  }
+  if (result.numel() == 0) {
+    return result;
+  }
+  index_select_stub(kCPU, result, self, dim, index_contig);
+  return result;
+}
+
+Tensor index_select_cpu_(const Tensor & self, int64_t dim, const Tensor & index) {
+  Tensor result = at::empty({0}, self.options());
+  return at::native::index_select_out_cpu_(result, self, dim, index);
+}
+
+Tensor & gather_out_cpu(Tensor & result, const Tensor & self, int64_t dim, const Tensor & index, bool sparse_grad) {
+  // Scalars keep the legacy semantics of TH, as does the result overlapping
+  // its inputs
+  if (self.dim() == 0 || index.dim() == 0 || result.is_alias_of(self) ||
+      result.is_alias_of(index) || result.scalar_type() != self.scalar_type()) {
+    return legacy::cpu::_th_gather_out(result, self, dim, index);
+  }
+  dim = maybe_wrap_dim(dim, self.dim());
+  TORCH_CHECK(index.scalar_type() == kLong,
+              "gather(): Expected dtype int64 for index, but got ", index.scalar_type());
+  TORCH_CHECK(index.dim() == self.dim(), "Index tensor must have same dimensions as input tensor");
+  for (int64_t d = 0; d < self.dim(); d++) {
+    TORCH_CHECK(d == dim || index.size(d) == self.size(d),
+                "Expected tensor ", index.sizes(), ", src ", self.sizes(), " and index ",
+                index.sizes(), " to have the same size apart from dimension ", dim);
+  }
+  result.resize_(index.sizes());
+  if (index.numel() == 0) {
+    return result;
+  }
+  gather_stub(kCPU, result, self, dim, index);
+  return result;
+}
+
+Tensor gather_cpu(const Tensor & self, int64_t dim, const Tensor & index, bool sparse_grad) {
+  Tensor result = at::empty({0}, self.options());
+  return at::native::gather_out_cpu(result, self, dim, index, sparse_grad);
+}
+
 Tensor & index_copy_(Tensor & self, int64_t dim, const Tensor & index, const Tensor & source) {
   dim = maybe_wrap_dim(dim, self.dim());
 
@@ -2,6 +2,7 @@
 #include <ATen/ExpandUtils.h>
 #include <ATen/Dispatch.h>
 #include <ATen/NativeFunctions.h>
+#include <ATen/native/LinearAlgebra.h>
 #include <ATen/native/LinearAlgebraUtils.h>
 #include <ATen/TensorUtils.h>
 #include <ATen/Parallel.h>
@@ -17,6 +18,8 @@
 namespace at {
 namespace native {
 
+DEFINE_DISPATCH(baddbmm_small_stub);
+
 // Helper function for det methods.
 // For pivoted LU factorization A = P * L * U. Since we always have det(L) = 1,
 // det(P) = \pm 1, this method returns a 3-tuple:
@@ -171,7 +174,7 @@ inline void baddbmm_cpu_kernel(const Tensor& result, const Tensor& self, const T
   auto s0 = self.accessor<scalar_t, 3>();
   auto m0 = mat2.accessor<scalar_t, 3>();
 
-  int64_t grain_size = std::min(internal::GRAIN_SIZE / (is * js * ks), (int64_t)1);
+  int64_t grain_size = std::max(internal::GRAIN_SIZE / (is * js * ks), (int64_t)1);
   parallel_for(0, bs, grain_size, [&](int64_t b_begin, int64_t b_end) {
       for (int64_t b = b_begin; b < b_end; b++) {
         auto r1 = r0[b];
@@ -201,12 +204,16 @@ inline void baddbmm_cpu_kernel(const Tensor& result, const Tensor& self, const T
 
 // This tries to apply some optimizations to bmm/baddbmm:
 // - When the operand size is small, computation are parallelized over the batch
-//   dimension using OMP and naive matrix multiplication is applied.
+//   dimension using OMP and naive matrix multiplication is applied. For floating
+//   point types whose rows are contiguous, a register blocked kernel is used instead.
 // - When the operand size is larger than the threshold, if compiled with MKL, MKL's batch gemm is used.
+// - Without MKL, products of up to kSmallGemmMaxSize multiply-adds per matrix are still
+//   handled by the blocked kernel in parallel over the batch.
 // - Otherwise, we use a series of matrix multiplications.
 // The threshold of 400 for the first has not been thoroughly benchmarked yet and may have room for further
 // optimization, it likely depends on the characteristics of the CPU, MKL will be different from non-MKL etc.,
 // but this seems to be a first starting point.
+static constexpr int64_t kSmallGemmMaxSize = 64 * 64 * 64;
 
 static inline Tensor& bmm_out_or_baddbmm_(Tensor& self_or_result, const Tensor& batch1, const Tensor& batch2, Scalar beta, Scalar alpha, bool is_bmm_out) {
   // is_bmm_out: true for bmm_out, false for baddbmm_
@@ -246,7 +253,18 @@ static inline Tensor& bmm_out_or_baddbmm_(Tensor& self_or_result, const Tensor&
             || (t.stride(1) == 1 && t.stride(2) >= t.size(1));
   };
 
-  if (contraction_size * res_rows * res_cols < 400) {
+  const int64_t gemm_size = contraction_size * res_rows * res_cols;
+  const bool use_mkl = at::hasMKL() && at::native::is_floating_point(self_or_result)
+            && batch_items_contiguous_or_transposed(batch1)
+            && batch_items_contiguous_or_transposed(batch2)
+            && self_or_result.is_contiguous();
+  const bool use_small_gemm = (self_or_result.scalar_type() == kFloat || self_or_result.scalar_type() == kDouble)
+            && batch2.stride(2) == 1 && self_or_result.stride(2) == 1
+            && (gemm_size < 400 || (!use_mkl && gemm_size <= kSmallGemmMaxSize));
+
+  if (use_small_gemm) {
+    baddbmm_small_stub(kCPU, self_or_result, batch1, batch2, beta, alpha, is_bmm_out);
+  } else if (gemm_size < 400) {
     if (is_bmm_out) {
       AT_DISPATCH_ALL_TYPES(batch1.scalar_type(), "bmm", [&] {
           baddbmm_cpu_kernel<scalar_t, true>(self_or_result, batch1, batch2, beta, alpha);
@@ -256,10 +274,7 @@ static inline Tensor& bmm_out_or_baddbmm_(Tensor& self_or_result, const Tensor&
           baddbmm_cpu_kernel<scalar_t, false>(self_or_result, batch1, batch2, beta, alpha);
         });
     }
-  } else if (at::hasMKL() && at::native::is_floating_point(self_or_result)
-            && batch_items_contiguous_or_transposed(batch1)
-            && batch_items_contiguous_or_transposed(batch2)
-            && self_or_result.is_contiguous()) {
+  } else if (use_mkl) {
     at::native::_baddbmm_mkl_(self_or_result, batch1, batch2, beta, alpha);
   } else { // split along batch dimension
     if (is_bmm_out) {
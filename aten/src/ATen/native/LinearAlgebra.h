@@ -0,0 +1,22 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <ATen/native/DispatchStub.h>
+
+namespace at { namespace native {
+
+// Computes result[b] = beta * result[b] + alpha * batch1[b] @ batch2[b] for
+// every b, or result[b] = batch1[b] @ batch2[b] when is_bmm is set. As in
+// BLAS, result is not read when beta is zero. Expects floating point tensors
+// where the columns of batch2 and result have unit stride.
+using baddbmm_small_fn = void(*)(
+    const Tensor& result,
+    const Tensor& batch1,
+    const Tensor& batch2,
+    Scalar beta,
+    Scalar alpha,
+    bool is_bmm);
+
+DECLARE_DISPATCH(baddbmm_small_fn, baddbmm_small_stub);
+
+}} // namespace at::native
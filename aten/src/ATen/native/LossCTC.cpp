@@ -11,8 +11,11 @@
 #include <ATen/Parallel.h>
 #include <ATen/TensorUtils.h>
 
+#include <algorithm>
+#include <cmath>
 #include <numeric>
 #include <type_traits>
+#include <vector>
 
 namespace at {
 namespace native {
@@ -29,12 +32,66 @@ static inline int64_t get_target_prime(target_t* target, int64_t offset, int64_t
   }
 }
 
+// The first row of alpha, the three equations for alpha_1 above eq (6)
+template<typename scalar_t, typename target_t>
+static inline void ctc_alpha_init(scalar_t* log_alpha_0, int64_t num_states, const TensorAccessor<scalar_t, 1>& log_probs_0,
+                                  target_t* targets_data, int64_t tg_batch_offset, int64_t tg_target_stride,
+                                  int64_t target_length, int64_t BLANK) {
+  constexpr scalar_t neginf = -std::numeric_limits<scalar_t>::infinity();
+  std::fill(log_alpha_0, log_alpha_0 + num_states, neginf);
+  // the first two items of alpha_t above eq (6)
+  log_alpha_0[0] = log_probs_0[BLANK];
+  if (target_length > 0)
+    log_alpha_0[1] = log_probs_0[get_target_prime(targets_data, tg_batch_offset, tg_target_stride, 1, BLANK)];
+}
+
+// The row t of alpha from the row t-1
+template<typename scalar_t, typename target_t>
+static inline void ctc_alpha_step(scalar_t* log_alpha_t, const scalar_t* log_alpha_tm1, const TensorAccessor<scalar_t, 1>& log_probs_t,
+                                  target_t* targets_data, int64_t tg_batch_offset, int64_t tg_target_stride,
+                                  int64_t target_length, int64_t BLANK) {
+  constexpr scalar_t neginf = -std::numeric_limits<scalar_t>::infinity();
+  for (int64_t s=0; s<2*target_length+1; s++) {
+    auto current_target_prime = get_target_prime(targets_data, tg_batch_offset, tg_target_stride, s, BLANK);
+    // this loop over s could be parallel/vectorized, too, but the required items are one index apart
+    // alternatively, one might consider moving s to the outer loop to cache current_target_prime more (but then it needs to be descending)
+    // for the cuda implementation, that gave a speed boost.
+    // This is eq (6) and (7), la1,2,3 are the three summands. We keep track of the maximum for the logsumexp calculation.
+
+    scalar_t la1 = log_alpha_tm1[s];
+    scalar_t lamax = la1;
+    scalar_t la2, la3;
+    if (s > 0) {
+      la2 = log_alpha_tm1[s-1];
+      if (la2 > lamax)
+        lamax = la2;
+    } else {
+      la2 = neginf;
+    }
+    if ((s > 1) && (get_target_prime(targets_data, tg_batch_offset, tg_target_stride, s-2, BLANK) !=
+                    current_target_prime)) {
+      la3 = log_alpha_tm1[s-2];
+      if (la3 > lamax)
+        lamax = la3;
+    } else {
+      la3 = neginf;
+    }
+    if (lamax == neginf) // cannot do neginf-neginf
+      lamax = 0;
+    // this is the assignment of eq (6)
+    log_alpha_t[s] = std::log(std::exp(la1-lamax)+std::exp(la2-lamax)+std::exp(la3-lamax))+lamax + log_probs_t[current_target_prime];
+  }
+}
+
 // This kernel is a relatively straightforward implementation of the alpha calculation in the forward backward algorithm (section 4.1).
 // A (minor) twist is that we are using log-calculations to enhance numerical stability (log_probs and log_alpha).
 // The function returns the loss and the alphas, the alphas are kept for the backward step. The wrapper (ctc_loss below) hides
 // the alphas from the user by only returning the loss.
+// Only every checkpoint_interval-th row of the alphas is kept (all of them for the regular _ctc_loss), the backward
+// recomputes the others from these checkpoints. See Note [Checkpointed CTC loss].
 template<typename scalar_t, ScalarType target_scalar_type>
-std::tuple<Tensor, Tensor> ctc_loss_cpu_template(const Tensor& log_probs, const Tensor& targets, IntArrayRef input_lengths, IntArrayRef target_lengths, int64_t BLANK) {
+std::tuple<Tensor, Tensor> ctc_loss_cpu_template(const Tensor& log_probs, const Tensor& targets, IntArrayRef input_lengths, IntArrayRef target_lengths, int64_t BLANK,
+                                                 int64_t checkpoint_interval) {
   // log_probs: input_len x batch_size x num_labels
   // targets [int64]: batch_size x target_length OR sum(target_lengths)
   constexpr scalar_t neginf = -std::numeric_limits<scalar_t>::infinity();
@@ -88,7 +145,9 @@ std::tuple<Tensor, Tensor> ctc_loss_cpu_template(const Tensor& log_probs, const
              " (while checking arguments for ", c, ")");
   }
 
-  Tensor log_alpha = at::empty({batch_size, log_probs.size(0), 2*max_target_length+1}, log_probs.options());
+  const int64_t num_states = 2*max_target_length+1;
+  const int64_t num_checkpoints = (max_input_length + checkpoint_interval - 1) / checkpoint_interval;
+  Tensor log_alpha = at::empty({batch_size, num_checkpoints, num_states}, log_probs.options());
   Tensor neg_log_likelihood = at::empty({batch_size}, log_probs.options());
 
   auto lpp  = log_probs.permute({1,0,2});
@@ -97,10 +156,9 @@ std::tuple<Tensor, Tensor> ctc_loss_cpu_template(const Tensor& log_probs, const
   auto targets_data = targets.data_ptr<target_t>();
   auto neg_log_likelihood_a = neg_log_likelihood.accessor<scalar_t, 1>();
 
-  // alpha calculation for the first row, the three equations for alpha_1 above eq (6)
-  // first the default
-  log_alpha.narrow(1, 0, 1).fill_(neginf);
   at::parallel_for(0, batch_size, 0, [&](int64_t start, int64_t end) {
+    // the two rows between the checkpoints
+    std::vector<scalar_t> rows(checkpoint_interval > 1 ? 2 * num_states : 0);
     for (int64_t b = start; b < end; b++) {
       int64_t input_length = input_lengths[b];
       int64_t target_length = target_lengths[b];
@@ -108,51 +166,25 @@ std::tuple<Tensor, Tensor> ctc_loss_cpu_template(const Tensor& log_probs, const
       auto log_alpha_a = log_alpha_a_global[b];
       int64_t tg_batch_offset = tg_batch_offsets[b];
 
-      // the first two items of alpha_t above eq (6)
-      log_alpha_a[0][0] = log_probs_a[0][BLANK];
-      if (target_length > 0)
-        log_alpha_a[0][1] = log_probs_a[0][get_target_prime(targets_data, tg_batch_offset, tg_target_stride, 1, BLANK)];
+      scalar_t* log_alpha_prev = log_alpha_a[0].data();
+      ctc_alpha_init(log_alpha_prev, num_states, log_probs_a[0], targets_data, tg_batch_offset, tg_target_stride,
+                     target_length, BLANK);
 
       // now the loop over the inputs
       for (int64_t t=1; t<input_length; t++) {
-        for (int64_t s=0; s<2*target_length+1; s++) {
-          auto current_target_prime = get_target_prime(targets_data, tg_batch_offset, tg_target_stride, s, BLANK);
-          // this loop over s could be parallel/vectorized, too, but the required items are one index apart
-          // alternatively, one might consider moving s to the outer loop to cache current_target_prime more (but then it needs to be descending)
-          // for the cuda implementation, that gave a speed boost.
-          // This is eq (6) and (7), la1,2,3 are the three summands. We keep track of the maximum for the logsumexp calculation.
-
-          scalar_t la1 = log_alpha_a[t-1][s];
-          scalar_t lamax = la1;
-          scalar_t la2, la3;
-          if (s > 0) {
-            la2 = log_alpha_a[t-1][s-1];
-            if (la2 > lamax)
-              lamax = la2;
-          } else {
-            la2 = neginf;
-          }
-          if ((s > 1) && (get_target_prime(targets_data, tg_batch_offset, tg_target_stride, s-2, BLANK) !=
-                          current_target_prime)) {
-            la3 = log_alpha_a[t-1][s-2];
-            if (la3 > lamax)
-              lamax = la3;
-          } else {
-            la3 = neginf;
-          }
-          if (lamax == neginf) // cannot do neginf-neginf
-            lamax = 0;
-          // this is the assignment of eq (6)
-          log_alpha_a[t][s] = std::log(std::exp(la1-lamax)+std::exp(la2-lamax)+std::exp(la3-lamax))+lamax + log_probs_a[t][current_target_prime];
-        }
+        scalar_t* log_alpha_cur = (t % checkpoint_interval == 0) ? log_alpha_a[t / checkpoint_interval].data()
+                                                                 : rows.data() + (t % 2) * num_states;
+        ctc_alpha_step(log_alpha_cur, log_alpha_prev, log_probs_a[t], targets_data, tg_batch_offset, tg_target_stride,
+                       target_length, BLANK);
+        log_alpha_prev = log_alpha_cur;
       }
       // the likelihood is the the sum of the last two alphas, eq (8), the loss is the negative log likelihood
       if (target_length == 0) {
         // if the target is empty then there is no preceding BLANK state and hence there is no path to merge
-        neg_log_likelihood_a[b] = -log_alpha_a[input_length-1][0];
+        neg_log_likelihood_a[b] = -log_alpha_prev[0];
       } else {
-        scalar_t l1 = log_alpha_a[input_length-1][target_length*2];
-        scalar_t l2 = log_alpha_a[input_length-1][target_length*2-1];
+        scalar_t l1 = log_alpha_prev[target_length*2];
+        scalar_t l2 = log_alpha_prev[target_length*2-1];
         scalar_t m = std::max(l1, l2);
         m = ((m == neginf) ? 0 : m);
         scalar_t log_likelihood = std::log(std::exp(l1-m)+std::exp(l2-m))+m;
@@ -164,12 +196,24 @@ std::tuple<Tensor, Tensor> ctc_loss_cpu_template(const Tensor& log_probs, const
   return std::make_tuple(neg_log_likelihood, log_alpha);
 }
 
+// Note [Checkpointed CTC loss]
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// The regular CTC loss keeps all of the (input_length, 2*target_length+1) alphas of the forward for the backward,
+// which for long inputs with long targets takes more memory than anything else. _ctc_loss_checkpointed only keeps
+// the rows t of the alphas with t % checkpoint_interval == 0. The backward goes through the windows of
+// checkpoint_interval rows from the last to the first, recomputing the alphas of the window from its checkpoint
+// while the betas of the window are computed, so that it keeps checkpoint_interval rows of the alphas and two of
+// the betas at a time. With checkpoint_interval about sqrt(input_length), the memory goes from
+// O(input_length * target_length) to O(sqrt(input_length) * target_length), for about one more forward in the
+// backward. The regular _ctc_loss is the one with checkpoint_interval 1.
+
 // This is the backward. It consists of two phases:
 // a) computing the beta analogous to the alphas in the forward (backward half of the forward-backward algorithm) (eq (10) and (11))
 // b) collecting the per-activation characters for all s and wrapping the gradient (eq (16), the collection is the sum)
 template<typename scalar_t, ScalarType target_scalar_type>
 Tensor ctc_loss_backward_cpu_template(const Tensor& grad_out, const Tensor& log_probs, const Tensor& targets, IntArrayRef input_lengths, IntArrayRef target_lengths,
-                                      const Tensor& neg_log_likelihood, const Tensor& log_alpha, int64_t BLANK, bool zero_infinity) {
+                                      const Tensor& neg_log_likelihood, const Tensor& log_alpha, int64_t BLANK, bool zero_infinity,
+                                      int64_t checkpoint_interval) {
   constexpr scalar_t neginf = -std::numeric_limits<scalar_t>::infinity();
   using target_t = typename std::conditional<target_scalar_type == kInt, int, int64_t>::type;
   int64_t max_input_length = log_probs.size(0);
@@ -202,17 +246,20 @@ Tensor ctc_loss_backward_cpu_template(const Tensor& grad_out, const Tensor& log_
     tg_target_stride = targets.stride(1);
     max_target_length = targets.size(1);
   }
+  // the alphas have the number of states of the forward, which for 2d targets is at most that of targets.size(1)
+  const int64_t num_states = log_alpha.size(2);
 
-  Tensor log_beta = at::empty_like(log_alpha, LEGACY_CONTIGUOUS_MEMORY_FORMAT);  // could be optimized to use only 2 rows
   auto lpp  = log_probs.permute({1,0,2});
   auto log_probs_a_global = lpp.accessor<scalar_t, 3>();
   auto log_alpha_a_global = log_alpha.accessor<scalar_t, 3>();
-  auto log_beta_a_global = log_beta.accessor<scalar_t, 3>();
   auto gp = grad.permute({1,0,2});
   auto grad_a_global = gp.accessor<scalar_t, 3>();
   auto targets_data = targets.data_ptr<target_t>();
 
   at::parallel_for(0, batch_size, 0, [&](int64_t start, int64_t end) {
+    // the rows of the alphas of the current window after its checkpoint, and the rows t and t+1 of the betas
+    std::vector<scalar_t> log_alpha_window((checkpoint_interval - 1) * num_states);
+    std::vector<scalar_t> log_beta_rows(2 * num_states);
     for (int64_t b = start; b < end; b++) {
       scalar_t nll = neg_log_likelihood.accessor<scalar_t, 1>()[b];
       if (zero_infinity &&  nll == std::numeric_limits<scalar_t>::infinity()) {
@@ -222,70 +269,88 @@ Tensor ctc_loss_backward_cpu_template(const Tensor& grad_out, const Tensor& log_
 
       auto log_probs_a = log_probs_a_global[b];
       auto log_alpha_a = log_alpha_a_global[b];
-      auto log_beta_a = log_beta_a_global[b];
       auto grad_a = grad_a_global[b];
       int64_t input_length = input_lengths[b];
       int64_t target_length = target_lengths[b];
       int64_t tg_batch_offset = tg_batch_offsets[b];
 
-      // the initialization of beta before eq (10)
-      // here we do the fill for each batch item separately, as the input lengths will differ, so the t in which
-      // we start varies
-      if (input_length > 0) {
-        log_beta.narrow(0, b, 1).narrow(1, input_length-1, 1).fill_(neginf);
-        log_beta_a[input_length-1][2*target_length] = log_probs_a[input_length-1][BLANK];
-        grad_a[input_length-1][BLANK] = log_alpha_a[input_length-1][2*target_length] + log_beta_a[input_length-1][2*target_length];
-
-        if (target_length > 0) {
-          auto current_target_prime = get_target_prime(targets_data, tg_batch_offset, tg_target_stride, 2*target_length-1, BLANK);
-          log_beta_a[input_length-1][2*target_length-1] = log_probs_a[input_length-1][current_target_prime];
-
-          // the first two are a blank and a non-blank, so we know they are different and we don't need to do log+
-          grad_a[input_length-1][current_target_prime] = log_alpha_a[input_length-1][2*target_length-1] + log_beta_a[input_length-1][2*target_length-1];
+      // the windows [t_begin, t_end) of rows, from the last to the first
+      for (int64_t t_begin = ((input_length - 1) / checkpoint_interval) * checkpoint_interval;
+           t_begin >= 0 && input_length > 0; t_begin -= checkpoint_interval) {
+        const int64_t t_end = std::min(t_begin + checkpoint_interval, input_length);
+        const scalar_t* log_alpha_checkpoint = log_alpha_a[t_begin / checkpoint_interval].data();
+        auto log_alpha_row = [&](int64_t t) -> const scalar_t* {
+          return t == t_begin ? log_alpha_checkpoint : log_alpha_window.data() + (t - t_begin - 1) * num_states;
+        };
+        for (int64_t t = t_begin + 1; t < t_end; t++) {
+          ctc_alpha_step(log_alpha_window.data() + (t - t_begin - 1) * num_states, log_alpha_row(t - 1), log_probs_a[t],
+                         targets_data, tg_batch_offset, tg_target_stride, target_length, BLANK);
         }
-      }
 
-      // now loop applying eq (10) / (11)
-      for (int64_t t=input_length-2; t>=0; t--) {
-        // this loop over s could be parallel/vectorized and doesn't really need to be descending...
-        // alternatively, one might consider moving s to the outer loop to cache current_target_prime more (but then it needs to be descending)
-        // for the cuda implementation, that gave a speed boost.
-        for (int64_t s=2*target_length; s>=0; s--) {
-          scalar_t lb1 = log_beta_a[t+1][s];
-          scalar_t lbmax = lb1;
-          scalar_t lb2, lb3;
-          auto current_target_prime = get_target_prime(targets_data, tg_batch_offset, tg_target_stride, s, BLANK);
-          if (s < 2*target_length) {
-            lb2 = log_beta_a[t+1][s+1];
-            if (lb2 > lbmax)
-              lbmax = lb2;
-          } else {
-            lb2 = neginf;
-          }
-          if ((s < 2*target_length-1) && (get_target_prime(targets_data, tg_batch_offset, tg_target_stride, s+2, BLANK) !=
-                                          current_target_prime)) {
-            lb3 = log_beta_a[t+1][s+2];
-            if (lb3 > lbmax)
-              lbmax = lb3;
-          } else {
-            lb3 = neginf;
+        for (int64_t t = t_end - 1; t >= t_begin; t--) {
+          const scalar_t* log_alpha_t = log_alpha_row(t);
+          scalar_t* log_beta_t = log_beta_rows.data() + (t % 2) * num_states;
+          const scalar_t* log_beta_tp1 = log_beta_rows.data() + ((t + 1) % 2) * num_states;
+
+          if (t == input_length - 1) {
+            // the initialization of beta before eq (10)
+            // here we do the fill for each batch item separately, as the input lengths will differ, so the t in which
+            // we start varies
+            std::fill(log_beta_t, log_beta_t + num_states, neginf);
+            log_beta_t[2*target_length] = log_probs_a[t][BLANK];
+            grad_a[t][BLANK] = log_alpha_t[2*target_length] + log_beta_t[2*target_length];
+
+            if (target_length > 0) {
+              auto current_target_prime = get_target_prime(targets_data, tg_batch_offset, tg_target_stride, 2*target_length-1, BLANK);
+              log_beta_t[2*target_length-1] = log_probs_a[t][current_target_prime];
+
+              // the first two are a blank and a non-blank, so we know they are different and we don't need to do log+
+              grad_a[t][current_target_prime] = log_alpha_t[2*target_length-1] + log_beta_t[2*target_length-1];
+            }
+            continue;
           }
-          if (lbmax == neginf)
-            lbmax = 0;
-
-          log_beta_a[t][s] = std::log(std::exp(lb1-lbmax)+std::exp(lb2-lbmax)+std::exp(lb3-lbmax))+lbmax + log_probs_a[t][current_target_prime];
-          // one might check whether one can vectorize this better when done after the t-loop...
-          // now that we have beta, we fill in the sum of alpha*beta in eq (16)
-          // in contrast to the cuda implementation, we only parallelize over the batch, so we don't have a concurrency
-          // issue (several s can map to the same target character)
-          // collected[b, t, target'[s]] "log+=" log_alpha[t, s]+log_beta[t, s]
-          scalar_t log_alpha_beta =  log_alpha_a[t][s] + log_beta_a[t][s];
-          scalar_t &lcab = grad_a[t][current_target_prime];
-          if (lcab == neginf) {
-            lcab = log_alpha_beta;
-          } else {
-            scalar_t max = std::max(lcab, log_alpha_beta);
-            lcab = std::log(std::exp(lcab-max)+std::exp(log_alpha_beta-max))+max;
+
+          // now apply eq (10) / (11)
+          // this loop over s could be parallel/vectorized and doesn't really need to be descending...
+          // alternatively, one might consider moving s to the outer loop to cache current_target_prime more (but then it needs to be descending)
+          // for the cuda implementation, that gave a speed boost.
+          for (int64_t s=2*target_length; s>=0; s--) {
+            scalar_t lb1 = log_beta_tp1[s];
+            scalar_t lbmax = lb1;
+            scalar_t lb2, lb3;
+            auto current_target_prime = get_target_prime(targets_data, tg_batch_offset, tg_target_stride, s, BLANK);
+            if (s < 2*target_length) {
+              lb2 = log_beta_tp1[s+1];
+              if (lb2 > lbmax)
+                lbmax = lb2;
+            } else {
+              lb2 = neginf;
+            }
+            if ((s < 2*target_length-1) && (get_target_prime(targets_data, tg_batch_offset, tg_target_stride, s+2, BLANK) !=
+                                            current_target_prime)) {
+              lb3 = log_beta_tp1[s+2];
+              if (lb3 > lbmax)
+                lbmax = lb3;
+            } else {
+              lb3 = neginf;
+            }
+            if (lbmax == neginf)
+              lbmax = 0;
+
+            log_beta_t[s] = std::log(std::exp(lb1-lbmax)+std::exp(lb2-lbmax)+std::exp(lb3-lbmax))+lbmax + log_probs_a[t][current_target_prime];
+            // one might check whether one can vectorize this better when done after the t-loop...
+            // now that we have beta, we fill in the sum of alpha*beta in eq (16)
+            // in contrast to the cuda implementation, we only parallelize over the batch, so we don't have a concurrency
+            // issue (several s can map to the same target character)
+            // collected[b, t, target'[s]] "log+=" log_alpha[t, s]+log_beta[t, s]
+            scalar_t log_alpha_beta =  log_alpha_t[s] + log_beta_t[s];
+            scalar_t &lcab = grad_a[t][current_target_prime];
+            if (lcab == neginf) {
+              lcab = log_alpha_beta;
+            } else {
+              scalar_t max = std::max(lcab, log_alpha_beta);
+              lcab = std::log(std::exp(lcab-max)+std::exp(log_alpha_beta-max))+max;
+            }
           }
         }
       }
@@ -313,28 +378,45 @@ Tensor ctc_loss_backward_cpu_template(const Tensor& grad_out, const Tensor& log_
 
 } // namespace
 
-std::tuple<Tensor, Tensor> ctc_loss_cpu(const Tensor& log_probs, const Tensor& targets, IntArrayRef input_lengths, IntArrayRef target_lengths, int64_t BLANK, bool zero_infinity) {
+std::tuple<Tensor, Tensor> ctc_loss_checkpointed_cpu(const Tensor& log_probs, const Tensor& targets, IntArrayRef input_lengths, IntArrayRef target_lengths, int64_t BLANK, bool zero_infinity,
+                                                     int64_t checkpoint_interval) {
   (void)zero_infinity; // only used for backwards
+  TORCH_CHECK(checkpoint_interval > 0, "checkpoint_interval must be positive, but got ", checkpoint_interval);
   return AT_DISPATCH_FLOATING_TYPES(log_probs.scalar_type(), "ctc_loss_cpu", [&] {
       if (targets.scalar_type() == kLong) {
-        return ctc_loss_cpu_template<scalar_t, kLong>(log_probs, targets, input_lengths, target_lengths, BLANK);
+        return ctc_loss_cpu_template<scalar_t, kLong>(log_probs, targets, input_lengths, target_lengths, BLANK, checkpoint_interval);
       } else {
-        return ctc_loss_cpu_template<scalar_t, kInt>(log_probs, targets, input_lengths, target_lengths, BLANK);
+        return ctc_loss_cpu_template<scalar_t, kInt>(log_probs, targets, input_lengths, target_lengths, BLANK, checkpoint_interval);
       }
   });
 }
 
-Tensor ctc_loss_backward_cpu(const Tensor& grad, const Tensor& log_probs, const Tensor& targets, IntArrayRef input_lengths, IntArrayRef target_lengths,
-                             const Tensor& neg_log_likelihood, const Tensor& log_alpha, int64_t BLANK, bool zero_infinity) {
+Tensor ctc_loss_checkpointed_backward_cpu(const Tensor& grad, const Tensor& log_probs, const Tensor& targets, IntArrayRef input_lengths, IntArrayRef target_lengths,
+                                          const Tensor& neg_log_likelihood, const Tensor& log_alpha_checkpoints, int64_t BLANK, bool zero_infinity,
+                                          int64_t checkpoint_interval) {
+  TORCH_CHECK(checkpoint_interval > 0, "checkpoint_interval must be positive, but got ", checkpoint_interval);
   return AT_DISPATCH_FLOATING_TYPES(log_probs.scalar_type(), "ctc_loss_backward_cpu", [&] {
       if (targets.scalar_type() == kLong) {
-        return ctc_loss_backward_cpu_template<scalar_t,kLong>(grad, log_probs, targets, input_lengths, target_lengths, neg_log_likelihood, log_alpha, BLANK, zero_infinity);
+        return ctc_loss_backward_cpu_template<scalar_t,kLong>(grad, log_probs, targets, input_lengths, target_lengths, neg_log_likelihood, log_alpha_checkpoints, BLANK, zero_infinity, checkpoint_interval);
       } else {
-        return ctc_loss_backward_cpu_template<scalar_t,kInt>(grad, log_probs, targets, input_lengths, target_lengths, neg_log_likelihood, log_alpha, BLANK, zero_infinity);
+        return ctc_loss_backward_cpu_template<scalar_t,kInt>(grad, log_probs, targets, input_lengths, target_lengths, neg_log_likelihood, log_alpha_checkpoints, BLANK, zero_infinity, checkpoint_interval);
       }
   });
 }
 
+std::tuple<Tensor, Tensor> ctc_loss_cpu(const Tensor& log_probs, const Tensor& targets, IntArrayRef input_lengths, IntArrayRef target_lengths, int64_t BLANK, bool zero_infinity) {
+  return ctc_loss_checkpointed_cpu(log_probs, targets, input_lengths, target_lengths, BLANK, zero_infinity, /*checkpoint_interval=*/1);
+}
+
+Tensor ctc_loss_backward_cpu(const Tensor& grad, const Tensor& log_probs, const Tensor& targets, IntArrayRef input_lengths, IntArrayRef target_lengths,
+                             const Tensor& neg_log_likelihood, const Tensor& log_alpha, int64_t BLANK, bool zero_infinity) {
+  return ctc_loss_checkpointed_backward_cpu(grad, log_probs, targets, input_lengths, target_lengths, neg_log_likelihood, log_alpha, BLANK, zero_infinity,
+                                            /*checkpoint_interval=*/1);
+}
+
+// The alphas of the regular _ctc_loss above which ctc_loss checkpoints them, see Note [Checkpointed CTC loss]
+static constexpr int64_t CTC_CHECKPOINT_MIN_ALPHAS = 1 << 24;
+
 // this wrapper function dispatches to the native and cudnn implementations and hides the alpha/grad from the user (by just returning the loss)
 // the gradient is implemented for _cudnn_ctc_loss (just in derivatives.yaml) and _ctc_loss and this function has automatic gradients
 // it also handles the reduction if desired
@@ -344,6 +426,15 @@ Tensor ctc_loss(const Tensor& log_probs, const Tensor& targets, IntArrayRef inpu
       at::_use_cudnn_ctc_loss(
           log_probs, targets, input_lengths, target_lengths, BLANK);
 
+  // the alphas are batch x input length x (2 * target length + 1)
+  int64_t max_target_length = 0;
+  for (auto target_length : target_lengths) {
+    max_target_length = std::max(max_target_length, target_length);
+  }
+  bool use_checkpoints =
+      (log_probs.device().type() == at::kCPU) && (log_probs.dim() == 3) &&
+      log_probs.size(0) * log_probs.size(1) * (2 * max_target_length + 1) >= CTC_CHECKPOINT_MIN_ALPHAS;
+
   Tensor res;
   if (use_cudnn) {
     // non-deterministic ctc loss on cudnn disabled due to inconsistent results
@@ -352,13 +443,20 @@ Tensor ctc_loss(const Tensor& log_probs, const Tensor& targets, IntArrayRef inpu
   } else {
     // if the targets are on CPU (which you need for CuDNN, let's move them to
     // GPU as a service for the user)
-    res = std::get<0>(at::_ctc_loss(
-        log_probs,
-        targets.to(log_probs.device(), kLong),
-        input_lengths,
-        target_lengths,
-        BLANK,
-        zero_infinity));
+    auto targets_long = targets.to(log_probs.device(), kLong);
+    if (use_checkpoints) {
+      const auto checkpoint_interval = static_cast<int64_t>(std::ceil(std::sqrt(static_cast<double>(log_probs.size(0)))));
+      res = std::get<0>(at::_ctc_loss_checkpointed(
+          log_probs, targets_long, input_lengths, target_lengths, BLANK, zero_infinity, checkpoint_interval));
+    } else {
+      res = std::get<0>(at::_ctc_loss(
+          log_probs,
+          targets_long,
+          input_lengths,
+          target_lengths,
+          BLANK,
+          zero_infinity));
+    }
     if (zero_infinity) {
       res = at::where(res == Scalar(std::numeric_limits<double>::infinity()), at::zeros({}, res.options()), res);
     }
@@ -9,6 +9,7 @@
 #include <ATen/native/TensorIterator.h>
 #include <ATen/native/cpu/Loops.h>
 
+#include <algorithm>
 #include <vector>
 
 static const int MIOPEN_DIM_MAX = 4;
@@ -140,14 +141,14 @@ void batch_norm_cpu_inference_contiguous(Tensor& output, const Tensor& input,
   }
 }
 
-/// A fast path for CPU inference when all tensors are channels last contiguous.
+/// Apply the linear terms to a channels last contiguous input,
+/// output(n, c, h, w) = input(n, c, h, w) * alpha(c) + beta(c)
 /// This code achieves machine bandwidth peak without AVX support.
 /// If this changes for future architectures, we can move it to the cpu/
 /// directory.
 template<typename scalar_t>
-void batch_norm_cpu_inference_channels_last(Tensor& output, const Tensor& input,
-    const Tensor& weight /* optional */, const Tensor& bias /* optional */,
-    const Tensor& mean, const Tensor& variance, double eps) {
+void batch_norm_cpu_channels_last_apply_linear_terms(Tensor& output, const Tensor& input,
+    const scalar_t* alpha_data, const scalar_t* beta_data) {
 
   int64_t n_batch = input.size(0);
   int64_t n_channel = input.size(1);
@@ -156,16 +157,6 @@ void batch_norm_cpu_inference_channels_last(Tensor& output, const Tensor& input,
   scalar_t* output_data = output.data_ptr<scalar_t>();
   const scalar_t* input_data = input.data_ptr<scalar_t>();
 
-  Tensor alpha = at::empty_like(mean, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
-  Tensor beta = at::empty_like(mean, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
-  scalar_t* alpha_data = alpha.data_ptr<scalar_t>();
-  scalar_t* beta_data = beta.data_ptr<scalar_t>();
-
-  batch_norm_cpu_inference_collect_liner_and_constant_terms<scalar_t>(
-      alpha_data, beta_data, n_channel, weight, bias, mean, variance, eps);
-
-  // Apply the linear terms to the input,
-  // output(n, c, h, w) = input(n, c, h, w) * alpha(c) + beta(c)
   // No need to use parallel_for as this function is supposed to be
   // memory-limited.
   // Keep the loop struture simple to make sure compiler vetorization kicks in.
@@ -192,6 +183,109 @@ void batch_norm_cpu_inference_channels_last(Tensor& output, const Tensor& input,
   }
 }
 
+/// A fast path for CPU inference when all tensors are channels last contiguous.
+template<typename scalar_t>
+void batch_norm_cpu_inference_channels_last(Tensor& output, const Tensor& input,
+    const Tensor& weight /* optional */, const Tensor& bias /* optional */,
+    const Tensor& mean, const Tensor& variance, double eps) {
+
+  int64_t n_channel = input.size(1);
+
+  Tensor alpha = at::empty_like(mean, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
+  Tensor beta = at::empty_like(mean, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
+  scalar_t* alpha_data = alpha.data_ptr<scalar_t>();
+  scalar_t* beta_data = beta.data_ptr<scalar_t>();
+
+  batch_norm_cpu_inference_collect_liner_and_constant_terms<scalar_t>(
+      alpha_data, beta_data, n_channel, weight, bias, mean, variance, eps);
+
+  batch_norm_cpu_channels_last_apply_linear_terms<scalar_t>(
+      output, input, alpha_data, beta_data);
+}
+
+/// The training counterpart of batch_norm_cpu_inference_channels_last, which
+/// normalizes with the batch statistics instead of the running ones.
+template<typename scalar_t>
+void batch_norm_cpu_train_channels_last(Tensor& output, const Tensor& input,
+    const Tensor& weight /* optional */, const Tensor& bias /* optional */,
+    const Tensor& save_mean, const Tensor& save_invstd) {
+
+  int64_t n_channel = input.size(1);
+
+  const scalar_t* weight_data = weight.defined() ? weight.data_ptr<scalar_t>() : nullptr;
+  const scalar_t* bias_data = bias.defined() ? bias.data_ptr<scalar_t>() : nullptr;
+  const scalar_t* mean_data = save_mean.data_ptr<scalar_t>();
+  const scalar_t* invstd_data = save_invstd.data_ptr<scalar_t>();
+
+  std::vector<scalar_t> alpha(n_channel);
+  std::vector<scalar_t> beta(n_channel);
+  for (int64_t c = 0; c < n_channel; c++) {
+    scalar_t weight_v = weight_data ? weight_data[c] : 1;
+    scalar_t bias_v = bias_data ? bias_data[c] : 0;
+    alpha[c] = invstd_data[c] * weight_v;
+    beta[c] = bias_v - mean_data[c] * invstd_data[c] * weight_v;
+  }
+
+  batch_norm_cpu_channels_last_apply_linear_terms<scalar_t>(
+      output, input, alpha.data(), beta.data());
+}
+
+/// Collect the per channel mean and sum of squared deviations from it of a
+/// channels last contiguous input. Every pixel is a contiguous row of
+/// n_channel values, so the rows are split between threads that each reduce
+/// into their own buffer, and the buffers are summed at the end.
+template<typename scalar_t, typename accscalar_t>
+void batch_norm_cpu_collect_stats_channels_last(
+    scalar_t* mean, accscalar_t* var_sum, const Tensor& input) {
+
+  int64_t n_channel = input.size(1);
+  int64_t n_rows = input.numel() / n_channel;
+  const scalar_t* input_data = input.data_ptr<scalar_t>();
+
+  int64_t num_threads = at::get_num_threads();
+  std::vector<accscalar_t> buffer(num_threads * n_channel, 0);
+
+  // sum
+  parallel_for(0, num_threads, 1, [&](int64_t t_begin, int64_t t_end) {
+    for (int64_t t = t_begin; t < t_end; ++t) {
+      accscalar_t* buffer_data = buffer.data() + t * n_channel;
+      for (int64_t i = t * n_rows / num_threads; i < (t + 1) * n_rows / num_threads; ++i) {
+        const scalar_t* row = input_data + i * n_channel;
+        for (int64_t c = 0; c < n_channel; ++c) {
+          buffer_data[c] += row[c];
+        }
+      }
+    }
+  });
+  for (int64_t c = 0; c < n_channel; ++c) {
+    accscalar_t sum = 0;
+    for (int64_t t = 0; t < num_threads; ++t) {
+      sum += buffer[t * n_channel + c];
+    }
+    mean[c] = sum / n_rows;
+  }
+
+  // sum of squared deviations
+  std::fill(buffer.begin(), buffer.end(), accscalar_t(0));
+  parallel_for(0, num_threads, 1, [&](int64_t t_begin, int64_t t_end) {
+    for (int64_t t = t_begin; t < t_end; ++t) {
+      accscalar_t* buffer_data = buffer.data() + t * n_channel;
+      for (int64_t i = t * n_rows / num_threads; i < (t + 1) * n_rows / num_threads; ++i) {
+        const scalar_t* row = input_data + i * n_channel;
+        for (int64_t c = 0; c < n_channel; ++c) {
+          buffer_data[c] += (row[c] - mean[c]) * (row[c] - mean[c]);
+        }
+      }
+    }
+  });
+  for (int64_t c = 0; c < n_channel; ++c) {
+    var_sum[c] = 0;
+    for (int64_t t = 0; t < num_threads; ++t) {
+      var_sum[c] += buffer[t * n_channel + c];
+    }
+  }
+}
+
 template<typename scalar_t>
 std::tuple<Tensor,Tensor,Tensor> batch_norm_cpu_transform_input_template(
     const Tensor& input, const Tensor& weight, const Tensor& bias,
@@ -225,6 +319,16 @@ std::tuple<Tensor,Tensor,Tensor> batch_norm_cpu_transform_input_template(
     return std::make_tuple(output, save_mean, save_invstd);
   }
 
+  if (train && input.is_contiguous(at::MemoryFormat::ChannelsLast)
+      && (!weight.defined() || weight.is_contiguous())
+      && (!bias.defined() || bias.is_contiguous())) {
+
+    Tensor output = at::empty_like(input, at::MemoryFormat::ChannelsLast);
+    batch_norm_cpu_train_channels_last<scalar_t>(
+      output, input, weight, bias, save_mean, save_invstd);
+    return std::make_tuple(output, save_mean, save_invstd);
+  }
+
   Tensor output = at::empty_like(input, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
 
   int64_t n_input = input.size(1);
@@ -280,6 +384,26 @@ std::tuple<Tensor,Tensor> batch_norm_cpu_update_stats_template(
   auto running_mean_a = conditional_accessor_1d<scalar_t>(running_mean);
   auto running_var_a = conditional_accessor_1d<scalar_t>(running_var);
 
+  if (input.is_contiguous(at::MemoryFormat::ChannelsLast)) {
+    std::vector<accscalar_t> var_sum(n_input);
+    batch_norm_cpu_collect_stats_channels_last<scalar_t, accscalar_t>(
+      save_mean.data_ptr<scalar_t>(), var_sum.data(), input);
+
+    for (int64_t f = 0; f < n_input; ++f) {
+      save_var_transform_a[f] = VarTransform<accscalar_t>{}(var_sum[f] / n, eps);
+
+      // update running averages
+      if (running_mean.defined()) {
+        running_mean_a[f] = momentum * save_mean_a[f] + (1 - momentum) * running_mean_a[f];
+      }
+      if (running_var.defined()) {
+        accscalar_t unbiased_var = var_sum[f] / (n - 1);
+        running_var_a[f] = momentum * unbiased_var + (1 - momentum) * running_var_a[f];
+      }
+    }
+    return std::make_tuple(save_mean, save_var_transform);
+  }
+
   parallel_for(0, n_input, 1, [&](int64_t b_begin, int64_t b_end) {
     for (int64_t f = b_begin; f < b_end; ++f) {
       Tensor in = input.select(1, f);
@@ -330,7 +454,7 @@ std::tuple<Tensor, Tensor, Tensor> batch_norm_backward_cpu_template(const Tensor
   Tensor grad_weight;
   Tensor grad_bias;
   if (grad_input_mask[0]) {
-    grad_input = at::empty_like(input, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
+    grad_input = at::empty_like(input, input.suggest_memory_format());
   }
   if (grad_input_mask[1]) {
     grad_weight = at::empty_like(weight, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
@@ -2,6 +2,7 @@
 #include <ATen/Parallel.h>
 #include <ATen/NativeFunctions.h>
 #include <ATen/div_rtn.h>
+#include <ATen/native/DispatchStub.h>
 #include <tuple>
 
 #pragma once
@@ -258,5 +259,16 @@ avg_pool3d_backward_shape_check(
 
 } // namespace
 
+// Kernels for 4D channels last (NHWC) inputs. Output, indices and grad_input
+// are expected to be allocated in channels last by the caller; indices keep
+// the h * input_width + w encoding of the NCHW kernels.
+using max_pool2d_fn = void(*)(Tensor& output, Tensor& indices, const Tensor& input,
+    int kW, int kH, int dW, int dH, int padW, int padH, int dilationW, int dilationH);
+using max_pool2d_backward_fn = void(*)(Tensor& grad_input, const Tensor& grad_output,
+    const Tensor& indices);
+
+DECLARE_DISPATCH(max_pool2d_fn, max_pool2d_channels_last_kernel);
+DECLARE_DISPATCH(max_pool2d_backward_fn, max_pool2d_backward_channels_last_kernel);
+
 } // at::native
 } // at
@@ -2,7 +2,9 @@
 
 #include <ATen/ATen.h>
 #include <ATen/NativeFunctions.h>
+#include <ATen/Parallel.h>
 #include <ATen/cpp_custom_type_hack.h>
+#include <ATen/core/grad_mode.h>
 #include <ATen/native/quantized/cpu/fbgemm_utils.h>
 
 #include <ATen/native/c10_utils.h>
@@ -27,6 +29,16 @@ template<typename T>
 using tpair_of = std::tuple<T, T>;
 
 // Those could have been function pointers, but MSVC chokes on function pointers as template parameters
+// The fused pointwise kernels are not differentiable, so they are only used
+// when no gradient has to be recorded through the cell.
+bool use_fused_cell_pointwise(const Tensor& igates, const Tensor& hgates, const Tensor& hidden) {
+  return igates.device().is_cpu() && igates.scalar_type() == kFloat &&
+      hgates.scalar_type() == kFloat && hidden.scalar_type() == kFloat &&
+      hidden.dim() == 2 &&
+      !(GradMode::is_enabled() &&
+        (igates.requires_grad() || hgates.requires_grad() || hidden.requires_grad()));
+}
+
 struct tanh_f {
   Tensor operator()(const Tensor& t) const { return at::tanh(t); }
 };
@@ -171,11 +183,21 @@ struct QuantizedCellParamsDynamic {
     TORCH_CHECK(false, "matmul is not supported with quantized cell params");
   }
 
+  // Looked up once instead of on every time step.
+  static const c10::OperatorHandle& linear_dynamic_op() {
+    static const c10::OperatorHandle op = [] {
+      const auto handle = c10::Dispatcher::singleton().findSchema(
+          {"quantized::linear_dynamic", ""});
+      TORCH_INTERNAL_ASSERT(
+          handle.has_value(), "quantized::linear_dynamic is not registered");
+      return handle.value();
+    }();
+    return op;
+  }
+
   Tensor linear_ih(const Tensor& input_ih) const {
-    const auto kFuncName = "quantized::linear_dynamic";
-    const auto kOvrldName = "";
     const std::vector<c10::IValue> output_ih_list =
-        callOp(kFuncName, kOvrldName, input_ih, w_ih);
+        callOp(linear_dynamic_op(), input_ih, w_ih);
     TORCH_INTERNAL_ASSERT(
         output_ih_list.size() == 1,
         "The output vector should have exact one element");
@@ -183,10 +205,8 @@ struct QuantizedCellParamsDynamic {
     return output_ih;
   }
   Tensor linear_hh(const Tensor& input_hh) const {
-    const auto kFuncName = "quantized::linear_dynamic";
-    const auto kOvrldName = "";
     const std::vector<c10::IValue> output_hh_list =
-        callOp(kFuncName, kOvrldName, input_hh, w_hh);
+        callOp(linear_dynamic_op(), input_hh, w_hh);
     TORCH_INTERNAL_ASSERT(
         output_hh_list.size() == 1,
         "The output vector should have exact one element");
@@ -409,8 +429,16 @@ struct LSTMCell : Cell<std::tuple<Tensor, Tensor>, cell_params> {
       return std::make_tuple(std::move(std::get<0>(result)), std::move(std::get<1>(result)));
     }
 
-    const auto gates = params.linear_hh(hx).add_(
-        pre_compute_input ? input : params.linear_ih(input));
+    const auto igates = pre_compute_input ? input : params.linear_ih(input);
+    auto hgates = params.linear_hh(hx);
+    if (use_fused_cell_pointwise(igates, hgates, cx)) {
+      auto hy = at::empty(cx.sizes(), cx.options());
+      auto cy = at::empty(cx.sizes(), cx.options());
+      lstm_cell_pointwise_stub(kCPU, hy, cy, igates, hgates, cx);
+      return std::make_tuple(std::move(hy), std::move(cy));
+    }
+
+    const auto gates = hgates.add_(igates);
     auto chunked_gates = gates.chunk(4, 1);
     auto ingate = chunked_gates[0].sigmoid_();
     auto forgetgate = chunked_gates[1].sigmoid_();
@@ -441,10 +469,15 @@ struct GRUCell : Cell<Tensor, cell_params> {
       // Slice off the workspace argument (it's needed only for AD).
       return std::move(std::get<0>(result));
     }
-    const auto chunked_igates = pre_compute_input
-        ? input.chunk(3, 1)
-        : params.linear_ih(input).chunk(3, 1);
-    auto chunked_hgates = params.linear_hh(hidden).chunk(3, 1);
+    const auto igates = pre_compute_input ? input : params.linear_ih(input);
+    auto hgates = params.linear_hh(hidden);
+    if (use_fused_cell_pointwise(igates, hgates, hidden)) {
+      auto hy = at::empty(hidden.sizes(), hidden.options());
+      gru_cell_pointwise_stub(kCPU, hy, igates, hgates, hidden);
+      return hy;
+    }
+    const auto chunked_igates = igates.chunk(3, 1);
+    auto chunked_hgates = hgates.chunk(3, 1);
     const auto reset_gate =
         chunked_hgates[0].add_(chunked_igates[0]).sigmoid_();
     const auto input_gate =
@@ -822,6 +855,142 @@ std::tuple<io_type, Tensor, Tensor> _lstm_impl(
   return std::make_tuple(std::move(result.outputs), at::stack(hy, 0), at::stack(cy, 0));
 }
 
+////////////////////////////////////////////////////////////////////////////////
+// FUSED CPU SEQUENCE KERNEL
+//
+// For float inference on CPU, LSTM and GRU layers run as a loop over raw
+// buffers instead of cells and layers: the input projection of the whole
+// sequence is one GEMM, every step is one GEMM into a reused gate buffer
+// followed by the fused pointwise kernel writing the hidden state straight
+// into the output, and the two directions of a bidirectional layer run in
+// parallel when the steps are too small for the GEMMs to use the threads.
+////////////////////////////////////////////////////////////////////////////////
+
+// The cells the fused kernel implements, with their number of gates.
+template <typename cell_type>
+struct FusedCpuCell {
+  static constexpr bool enabled = false;
+  static constexpr int64_t gates = 0;
+};
+
+template <>
+struct FusedCpuCell<LSTMCell<CellParams>> {
+  static constexpr bool enabled = true;
+  static constexpr int64_t gates = 4;
+};
+
+template <>
+struct FusedCpuCell<GRUCell<CellParams>> {
+  static constexpr bool enabled = true;
+  static constexpr int64_t gates = 3;
+};
+
+// Below this many flops per step and direction, the step GEMMs barely scale
+// with threads, so the directions get a thread each instead.
+constexpr int64_t kParallelDirectionsMaxStepFlops = 1 << 22;
+
+bool use_fused_rnn_cpu(const Tensor& input, TensorList hiddens, TensorList params) {
+  auto is_float_cpu = [](const Tensor& t) {
+    return t.device().is_cpu() && t.layout() == kStrided && t.scalar_type() == kFloat;
+  };
+  auto needs_grad = [](const Tensor& t) {
+    return GradMode::is_enabled() && t.requires_grad();
+  };
+  if (!is_float_cpu(input) || needs_grad(input) || input.dim() != 3 ||
+      input.size(0) == 0 || input.size(1) == 0) {
+    return false;
+  }
+  for (const auto& t : hiddens) {
+    if (!is_float_cpu(t) || needs_grad(t)) {
+      return false;
+    }
+  }
+  for (const auto& t : params) {
+    if (!is_float_cpu(t) || needs_grad(t)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Runs a stack of LSTM (cx defined) or GRU (cx undefined) layers on a
+// (seq_len, batch, input_size) input. Returns the output and the final hidden
+// states, the final cell states too for an LSTM.
+std::tuple<Tensor, Tensor, Tensor> fused_rnn_cpu(
+    int64_t gates, const Tensor& input, const Tensor& hx, const Tensor& cx,
+    const std::vector<CellParams>& params, int64_t num_layers, double dropout_p,
+    bool train, bool bidirectional) {
+  const bool is_lstm = cx.defined();
+  const int64_t num_directions = bidirectional ? 2 : 1;
+  const int64_t seq_len = input.size(0);
+  const int64_t batch_size = input.size(1);
+  const int64_t hidden_size = hx.size(2);
+  TORCH_CHECK(num_layers * num_directions == hx.size(0),
+      "Expected ", num_layers * num_directions, " hidden states, got ", hx.size(0));
+  TORCH_CHECK(params.size() == static_cast<size_t>(num_layers * num_directions),
+      "Expected more weights in stacked_rnn");
+
+  auto hy = at::empty(hx.sizes(), hx.options());
+  Tensor cy;
+  if (is_lstm) {
+    // The cell state is updated in place, step after step
+    cy = cx.contiguous().clone();
+  }
+
+  Tensor layer_input = input.contiguous();
+  for (int64_t l = 0; l < num_layers; ++l) {
+    std::vector<Tensor> outputs(num_directions);
+    auto run_direction = [&](int64_t direction) {
+      const int64_t index = l * num_directions + direction;
+      const auto& p = params[index];
+      const Tensor igates = p.linear_ih(layer_input);
+      Tensor hgates = at::empty({batch_size, gates * hidden_size}, input.options());
+      Tensor output = at::empty({seq_len, batch_size, hidden_size}, input.options());
+      Tensor c = is_lstm ? cy.select(0, index) : Tensor();
+      const auto w_hh_t = p.w_hh.t();
+
+      Tensor h_prev = hx.select(0, index);
+      for (int64_t step = 0; step < seq_len; ++step) {
+        const int64_t t = direction == 1 ? seq_len - 1 - step : step;
+        if (p.b_hh.defined()) {
+          at::addmm_out(hgates, p.b_hh, h_prev, w_hh_t);
+        } else {
+          at::mm_out(hgates, h_prev, w_hh_t);
+        }
+        Tensor h = output.select(0, t);
+        if (is_lstm) {
+          lstm_cell_pointwise_stub(kCPU, h, c, igates.select(0, t), hgates, c);
+        } else {
+          gru_cell_pointwise_stub(kCPU, h, igates.select(0, t), hgates, h_prev);
+        }
+        h_prev = h;
+      }
+      hy.select(0, index).copy_(h_prev);
+      outputs[direction] = std::move(output);
+    };
+
+    const int64_t step_flops = 2 * batch_size * gates * hidden_size * hidden_size;
+    if (bidirectional && at::get_num_threads() > 1 &&
+        step_flops < kParallelDirectionsMaxStepFlops) {
+      at::parallel_for(0, num_directions, 1, [&](int64_t begin, int64_t end) {
+        for (int64_t direction = begin; direction < end; ++direction) {
+          run_direction(direction);
+        }
+      });
+    } else {
+      for (int64_t direction = 0; direction < num_directions; ++direction) {
+        run_direction(direction);
+      }
+    }
+
+    layer_input = bidirectional ? at::cat(outputs, 2) : outputs[0];
+    if (dropout_p != 0 && train && l < num_layers - 1) {
+      layer_input = dropout(layer_input, dropout_p);
+    }
+  }
+  return std::make_tuple(std::move(layer_input), std::move(hy), std::move(cy));
+}
+
 } // anonymous namespace
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -863,6 +1032,15 @@ std::tuple<Tensor, Tensor> NAME(                                               \
   check_device(_input, _params, hx);                                           \
   auto input = batch_first ? _input.transpose(0, 1) : _input;                  \
   auto params = gather_params(_params, has_biases);                            \
+  if (FusedCpuCell<CELL>::enabled && use_fused_rnn_cpu(input, hx, _params)) {  \
+    auto fused = fused_rnn_cpu(FusedCpuCell<CELL>::gates, input, hx, Tensor(), \
+        params, num_layers, dropout_p, train, bidirectional);                  \
+    auto output = std::move(std::get<0>(fused));                               \
+    if (batch_first) {                                                         \
+      output.transpose_(0, 1);                                                 \
+    }                                                                          \
+    return std::make_tuple(std::move(output), std::move(std::get<1>(fused)));  \
+  }                                                                            \
   auto results = _rnn_impl_with_concat<CELL, FullLayer, FullBidirectionalLayer>( \
           input, params, hx.unbind(0), num_layers, dropout_p, train, bidirectional); \
   if (batch_first) {                                                           \
@@ -960,6 +1138,8 @@ ONE_HIDDEN_RNN(rnn_tanh, tanf_cell_type)
 using relu_cell_type = SimpleCell<relu_f, CellParams>;
 ONE_HIDDEN_RNN(rnn_relu, relu_cell_type);
 
+DEFINE_DISPATCH(lstm_cell_pointwise_stub);
+DEFINE_DISPATCH(gru_cell_pointwise_stub);
 DEFINE_DISPATCH(lstm_cudnn_stub);
 DEFINE_DISPATCH(lstm_packed_cudnn_stub);
 DEFINE_DISPATCH(lstm_miopen_stub);
@@ -990,6 +1170,14 @@ std::tuple<Tensor, Tensor, Tensor> lstm(
   check_device(_input, _params, hx);
   auto input = batch_first ? _input.transpose(0, 1) : _input;
   auto params = gather_params(_params, has_biases);
+  if (use_fused_rnn_cpu(input, hx, _params)) {
+    auto results = fused_rnn_cpu(FusedCpuCell<LSTMCell<CellParams>>::gates,
+        input, hx[0], hx[1], params, num_layers, dropout_p, train, bidirectional);
+    if (batch_first) {
+      std::get<0>(results) = std::get<0>(results).transpose(0, 1);
+    }
+    return results;
+  }
   auto results = _lstm_impl<FullLayer, FullBidirectionalLayer>(
       input, params, hx[0], hx[1], num_layers, dropout_p, train, bidirectional);
   if (batch_first) {
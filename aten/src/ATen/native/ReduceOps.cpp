@@ -32,6 +32,8 @@ DEFINE_DISPATCH(min_values_stub);
 DEFINE_DISPATCH(max_values_stub);
 DEFINE_DISPATCH(argmax_stub);
 DEFINE_DISPATCH(argmin_stub);
+DEFINE_DISPATCH(aminmax_stub);
+DEFINE_DISPATCH(sum_sumsq_stub);
 
 static inline Tensor integer_upcast(const Tensor& self, optional<ScalarType> dtype) {
   ScalarType scalarType = self.scalar_type();
@@ -802,6 +804,30 @@ std::tuple<Tensor,Tensor> var_mean(const Tensor& self, bool unbiased) {
   return at::native::var_mean_out(result1, result2, self, unbiased);
 }
 
+std::tuple<Tensor,Tensor> _sum_and_sumsq(const Tensor& self, IntArrayRef dim, bool keepdim) {
+  TORCH_CHECK(at::isFloatingType(self.scalar_type()),
+              "_sum_and_sumsq only supports floating-point dtypes");
+  Tensor sum = at::empty({0}, self.options());
+  Tensor sumsq = at::empty({0}, self.options());
+  auto iter = make_reduction("_sum_and_sumsq", sum, sumsq, self, dim, keepdim, self.scalar_type());
+  if (iter.numel() == 0) {
+    sum.zero_();
+    sumsq.zero_();
+  } else {
+    sum_sumsq_stub(iter.device_type(), iter);
+  }
+  return std::tuple<Tensor, Tensor>(sum, sumsq);
+}
+
+std::tuple<Tensor,Tensor> _aminmax(const Tensor& self, IntArrayRef dim, bool keepdim) {
+  Tensor min = at::empty({0}, self.options());
+  Tensor max = at::empty({0}, self.options());
+  auto iter = make_reduction("_aminmax", min, max, self, dim, keepdim, self.scalar_type());
+  TORCH_CHECK(iter.numel() > 0, "_aminmax on a tensor with no elements is not defined.");
+  aminmax_stub(iter.device_type(), iter);
+  return std::tuple<Tensor, Tensor>(min, max);
+}
+
 Tensor var(const Tensor& self, bool unbiased) {
   TORCH_CHECK(self.type().backend() == Backend::CPU || self.type().backend() == Backend::CUDA,
               "var only supports CPU AND CUDA backend, got: ", toString(self.type().backend()));
@@ -0,0 +1,104 @@
+#include <ATen/native/SegmentReduce.h>
+
+#include <ATen/ATen.h>
+#include <ATen/NativeFunctions.h>
+
+namespace at {
+namespace native {
+
+DEFINE_DISPATCH(segment_reduce_stub);
+DEFINE_DISPATCH(segment_reduce_backward_stub);
+
+namespace {
+
+int64_t get_reduction_type(const std::string& reduce) {
+  if (reduce == "sum") {
+    return SEGMENT_SUM;
+  } else if (reduce == "mean") {
+    return SEGMENT_MEAN;
+  } else if (reduce == "max") {
+    return SEGMENT_MAX;
+  }
+  TORCH_CHECK(false, "segment_reduce: unsupported reduction '", reduce,
+      "', expected one of 'sum', 'mean' and 'max'");
+}
+
+// The kernels trust the offsets, so validate them where that is cheap. On
+// CUDA that would need a sync, so only the shape is checked there.
+void check_offsets(const Tensor& offsets, int64_t num_rows) {
+  TORCH_CHECK(offsets.dim() == 1 && offsets.numel() >= 1 && offsets.scalar_type() == kLong,
+      "segment_reduce: expected offsets to be a non-empty 1D long tensor");
+  if (!offsets.device().is_cpu()) {
+    return;
+  }
+  auto offsets_contig = offsets.contiguous();
+  const int64_t* offsets_data = offsets_contig.data_ptr<int64_t>();
+  const int64_t num_offsets = offsets_contig.numel();
+  TORCH_CHECK(offsets_data[0] == 0, "segment_reduce: expected offsets to start at 0, but got ", offsets_data[0]);
+  for (int64_t i = 1; i < num_offsets; i++) {
+    TORCH_CHECK(offsets_data[i - 1] <= offsets_data[i], "segment_reduce: expected offsets to be non-decreasing");
+  }
+  TORCH_CHECK(offsets_data[num_offsets - 1] == num_rows,
+      "segment_reduce: expected the segments to cover all ", num_rows, " rows of data, but they cover ",
+      offsets_data[num_offsets - 1]);
+}
+
+} // namespace
+
+Tensor segment_reduce(
+    const Tensor& data,
+    std::string reduce,
+    const Tensor& lengths,
+    const Tensor& offsets) {
+  TORCH_CHECK(lengths.defined() != offsets.defined(),
+      "segment_reduce: expected exactly one of lengths and offsets");
+  Tensor segment_offsets = offsets;
+  if (lengths.defined()) {
+    TORCH_CHECK(lengths.dim() == 1, "segment_reduce: expected lengths to be 1D, but got ", lengths.dim(), "D");
+    auto lengths_long = lengths.to(kLong);
+    segment_offsets = at::cat({at::zeros({1}, lengths_long.options()), lengths_long.cumsum(0)});
+  }
+  return std::get<0>(at::_segment_reduce(data, segment_offsets, get_reduction_type(reduce)));
+}
+
+std::tuple<Tensor, Tensor> _segment_reduce(
+    const Tensor& data,
+    const Tensor& offsets,
+    int64_t reduce) {
+  TORCH_CHECK(data.dim() >= 1, "segment_reduce: expected data to have at least one dimension");
+  TORCH_CHECK(reduce >= SEGMENT_SUM && reduce <= SEGMENT_MAX, "segment_reduce: unknown reduction ", reduce);
+  TORCH_CHECK(offsets.device() == data.device(),
+      "segment_reduce: expected offsets and data to be on the same device, but got ", offsets.device(),
+      " and ", data.device());
+  check_offsets(offsets, data.size(0));
+
+  auto sizes = data.sizes().vec();
+  sizes[0] = offsets.numel() - 1;
+  Tensor output = at::empty(sizes, data.options());
+  Tensor arg_max = at::empty(reduce == SEGMENT_MAX ? sizes : std::vector<int64_t>{0},
+      data.options().dtype(kLong));
+  if (output.numel() > 0) {
+    auto data_contig = data.contiguous();
+    segment_reduce_stub(data.device().type(), output, arg_max, data_contig, offsets.contiguous(), reduce);
+  }
+  return std::make_tuple(output, arg_max);
+}
+
+Tensor _segment_reduce_backward(
+    const Tensor& grad,
+    const Tensor& offsets,
+    const Tensor& arg_max,
+    int64_t reduce,
+    IntArrayRef sizes) {
+  // for max only the rows that were picked get a gradient
+  Tensor grad_input = reduce == SEGMENT_MAX ? at::zeros(sizes, grad.options()) : at::empty(sizes, grad.options());
+  if (grad_input.numel() > 0 && grad.numel() > 0) {
+    auto grad_contig = grad.contiguous();
+    segment_reduce_backward_stub(
+        grad.device().type(), grad_input, grad_contig, offsets.contiguous(), arg_max, reduce);
+  }
+  return grad_input;
+}
+
+} // namespace native
+} // namespace at
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <ATen/native/DispatchStub.h>
+
+namespace at {
+namespace native {
+
+enum SegmentReductionType : int64_t {
+  SEGMENT_SUM = 0,
+  SEGMENT_MEAN = 1,
+  SEGMENT_MAX = 2,
+};
+
+// Segment s covers rows [offsets[s], offsets[s + 1]) of data, which is
+// contiguous and viewed as 2D [rows, inner]. output is [segments, inner] and
+// arg_max holds the row picked by SEGMENT_MAX for every output element, or
+// -1 for an empty segment. Empty segments reduce to zero.
+using segment_reduce_fn = void(*)(
+    Tensor& output,
+    Tensor& arg_max,
+    const Tensor& data,
+    const Tensor& offsets,
+    int64_t reduce);
+using segment_reduce_backward_fn = void(*)(
+    Tensor& grad_input,
+    const Tensor& grad,
+    const Tensor& offsets,
+    const Tensor& arg_max,
+    int64_t reduce);
+
+DECLARE_DISPATCH(segment_reduce_fn, segment_reduce_stub);
+DECLARE_DISPATCH(segment_reduce_backward_fn, segment_reduce_backward_stub);
+
+} // namespace native
+} // namespace at
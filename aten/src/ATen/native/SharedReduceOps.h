@@ -5,6 +5,8 @@
 #include <c10/macros/Macros.h>
 #include <ATen/detail/FunctionTraits.h>
 #include <ATen/NumericUtils.h>
+#include <c10/util/C++17.h>
+#include <tuple>
 #if defined(__CUDACC__)
 #include <THC/THCDeviceUtils.cuh>
 #include <ATen/native/cuda/DeviceSqrt.cuh>
@@ -252,6 +254,48 @@ struct NormOneOps {
 #endif
 };
 
+template <typename scalar_t, typename acc_t = scalar_t>
+struct SumOps {
+  inline C10_DEVICE acc_t reduce(acc_t acc, scalar_t data, int64_t /*idx*/) const {
+    return acc + acc_t(data);
+  }
+
+  inline C10_DEVICE acc_t combine(acc_t a, acc_t b) const {
+    return a + b;
+  }
+
+  inline C10_DEVICE scalar_t project(acc_t a) const {
+    return a;
+  }
+
+#if defined(__CUDACC__) || defined(__HIPCC__)
+  inline C10_DEVICE acc_t warp_shfl_down(acc_t data, int offset) const {
+    return WARP_SHFL_DOWN(data, offset);
+  }
+#endif
+};
+
+template <typename scalar_t, typename acc_t = scalar_t>
+struct SquareSumOps {
+  inline C10_DEVICE acc_t reduce(acc_t acc, scalar_t data, int64_t /*idx*/) const {
+    return acc + acc_t(data) * acc_t(data);
+  }
+
+  inline C10_DEVICE acc_t combine(acc_t a, acc_t b) const {
+    return a + b;
+  }
+
+  inline C10_DEVICE scalar_t project(acc_t a) const {
+    return a;
+  }
+
+#if defined(__CUDACC__) || defined(__HIPCC__)
+  inline C10_DEVICE acc_t warp_shfl_down(acc_t data, int offset) const {
+    return WARP_SHFL_DOWN(data, offset);
+  }
+#endif
+};
+
 namespace detail {
 
 #if defined(__CUDACC__) || defined(__HIPCC__)
@@ -260,6 +304,14 @@ template <typename T1, typename T2> using pair = thrust::pair<T1, T2>;
 template <typename T1, typename T2> using pair = std::pair<T1, T2>;
 #endif
 
+#if defined(__CUDACC__) || defined(__HIPCC__)
+template <typename... T> using tuple = thrust::tuple<T...>;
+using thrust::get;
+#else
+template <typename... T> using tuple = std::tuple<T...>;
+using std::get;
+#endif
+
 template <typename scalar_t>
 struct LessOrNan {
   C10_DEVICE bool operator () (scalar_t a, scalar_t b) const {
@@ -312,6 +364,117 @@ struct ArgMinOps :
   public detail::ArgReductionOps<detail::LessOrNan<scalar_t>> {
 };
 
+// NaN propagating min and max, the values computed by min() and max().
+template <typename scalar_t, typename acc_t = scalar_t>
+struct MinOps {
+  inline C10_DEVICE acc_t reduce(acc_t acc, scalar_t data, int64_t /*idx*/) const {
+    return combine(acc, acc_t(data));
+  }
+
+  inline C10_DEVICE acc_t combine(acc_t a, acc_t b) const {
+    return detail::LessOrNan<acc_t>{}(a, b) ? a : b;
+  }
+
+  inline C10_DEVICE scalar_t project(acc_t a) const {
+    return a;
+  }
+
+#if defined(__CUDACC__) || defined(__HIPCC__)
+  inline C10_DEVICE acc_t warp_shfl_down(acc_t data, int offset) const {
+    return WARP_SHFL_DOWN(data, offset);
+  }
+#endif
+};
+
+template <typename scalar_t, typename acc_t = scalar_t>
+struct MaxOps {
+  inline C10_DEVICE acc_t reduce(acc_t acc, scalar_t data, int64_t /*idx*/) const {
+    return combine(acc, acc_t(data));
+  }
+
+  inline C10_DEVICE acc_t combine(acc_t a, acc_t b) const {
+    return detail::GreaterOrNan<acc_t>{}(a, b) ? a : b;
+  }
+
+  inline C10_DEVICE scalar_t project(acc_t a) const {
+    return a;
+  }
+
+#if defined(__CUDACC__) || defined(__HIPCC__)
+  inline C10_DEVICE acc_t warp_shfl_down(acc_t data, int offset) const {
+    return WARP_SHFL_DOWN(data, offset);
+  }
+#endif
+};
+
+// Runs several reductions over the same input in a single pass. The
+// accumulator is the tuple of the accumulators of `ops_t...` and project()
+// returns one output per op, in order. Every op must take the same input type
+// and project to a single value. The identity is the tuple of the ops'
+// identities, e.g. for the minimum and maximum:
+//
+//   binary_kernel_reduce(
+//     iter,
+//     MultiReduceOps<MinOps<scalar_t>, MaxOps<scalar_t>>{},
+//     std::make_tuple(upper_bound<scalar_t>(), lower_bound<scalar_t>()));
+//
+// The CUDA reduction kernel writes at most two outputs.
+template <typename... ops_t>
+struct MultiReduceOps {
+  using first_ops_t = typename std::tuple_element<0, std::tuple<ops_t...>>::type;
+  using scalar_t = typename binary_function_traits<decltype(&first_ops_t::reduce)>::arg2_t;
+  using acc_t = detail::tuple<typename unary_function_traits<decltype(&ops_t::project)>::arg1_t...>;
+  using res_t = detail::tuple<typename unary_function_traits<decltype(&ops_t::project)>::result_type...>;
+  using indices_t = c10::guts::index_sequence_for<ops_t...>;
+
+  detail::tuple<ops_t...> ops;
+
+  inline C10_DEVICE acc_t reduce(acc_t acc, scalar_t data, int64_t idx) const {
+    return reduce_(acc, data, idx, indices_t{});
+  }
+
+  inline C10_DEVICE acc_t combine(acc_t a, acc_t b) const {
+    return combine_(a, b, indices_t{});
+  }
+
+  inline C10_DEVICE res_t project(acc_t acc) const {
+    return project_(acc, indices_t{});
+  }
+
+#if defined(__CUDACC__) || defined(__HIPCC__)
+  inline C10_DEVICE acc_t warp_shfl_down(acc_t acc, int offset) const {
+    return warp_shfl_down_(acc, offset, indices_t{});
+  }
+#endif
+
+  MultiReduceOps() = default;
+  MultiReduceOps(ops_t... ops) : ops(ops...) {
+  }
+
+ private:
+  template <size_t... I>
+  inline C10_DEVICE acc_t reduce_(acc_t acc, scalar_t data, int64_t idx, c10::guts::index_sequence<I...>) const {
+    return acc_t(detail::get<I>(ops).reduce(detail::get<I>(acc), data, idx)...);
+  }
+
+  template <size_t... I>
+  inline C10_DEVICE acc_t combine_(acc_t a, acc_t b, c10::guts::index_sequence<I...>) const {
+    return acc_t(detail::get<I>(ops).combine(detail::get<I>(a), detail::get<I>(b))...);
+  }
+
+  template <size_t... I>
+  inline C10_DEVICE res_t project_(acc_t acc, c10::guts::index_sequence<I...>) const {
+    return res_t(detail::get<I>(ops).project(detail::get<I>(acc))...);
+  }
+
+#if defined(__CUDACC__) || defined(__HIPCC__)
+  template <size_t... I>
+  inline C10_DEVICE acc_t warp_shfl_down_(acc_t acc, int offset, c10::guts::index_sequence<I...>) const {
+    return acc_t(detail::get<I>(ops).warp_shfl_down(detail::get<I>(acc), offset)...);
+  }
+#endif
+};
+
 }} // namespace at::native
 
 #undef MAX
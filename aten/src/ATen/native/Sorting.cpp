@@ -1,6 +1,7 @@
 #include <ATen/native/Sorting.h>
 
 #include <ATen/ATen.h>
+#include <ATen/LegacyTHFunctionsCPU.h>
 #include <ATen/NumericUtils.h>
 #include <ATen/Parallel.h>
 #include <ATen/WrapDimUtils.h>
@@ -225,6 +226,54 @@ std::tuple<Tensor, Tensor> topk(
   return std::make_tuple(values, indices);
 }
 
+std::tuple<Tensor&, Tensor&> sort_out_cpu(
+    Tensor& values,
+    Tensor& indices,
+    const Tensor& self,
+    int64_t dim_,
+    bool descending) {
+  int64_t dim = maybe_wrap_dim(dim_, self.dim(), /*wrap_scalar=*/true);
+  // Short slices are sorted well enough by the TH sort, which runs in
+  // parallel across them. Long ones would each run on a single thread there.
+  if (self.dim() == 0 || self.size(dim) < kParallelSortThreshold ||
+      !(isIntegralType(self.scalar_type(), /*includeBool=*/false) ||
+        self.scalar_type() == kFloat || self.scalar_type() == kDouble)) {
+    return legacy::cpu::_th_sort_out(values, indices, self, dim, descending);
+  }
+  TORCH_CHECK(
+      values.scalar_type() == self.scalar_type(),
+      "sort(): expected values to be of type ", self.scalar_type(), " but got ", values.scalar_type());
+  TORCH_CHECK(
+      indices.scalar_type() == kLong,
+      "sort(): expected indices to be of type Long but got ", indices.scalar_type());
+  values.resize_(self.sizes());
+  indices.resize_(self.sizes());
+
+  // sort_stub sorts along the last dimension of contiguous tensors
+  const bool last_dim = dim == self.dim() - 1;
+  auto input = self.transpose(dim, -1).contiguous();
+  Tensor sorted_values = last_dim && values.is_contiguous() ? values : at::empty_like(input);
+  Tensor sorted_indices = last_dim && indices.is_contiguous() ? indices : at::empty(input.sizes(), indices.options());
+  sort_stub(kCPU, sorted_values, sorted_indices, input, descending);
+  if (!sorted_values.is_same(values)) {
+    values.transpose(dim, -1).copy_(sorted_values);
+  }
+  if (!sorted_indices.is_same(indices)) {
+    indices.transpose(dim, -1).copy_(sorted_indices);
+  }
+  return std::forward_as_tuple(values, indices);
+}
+
+std::tuple<Tensor, Tensor> sort_cpu(
+    const Tensor& self,
+    int64_t dim,
+    bool descending) {
+  Tensor values = at::empty({0}, self.options());
+  Tensor indices = at::empty({0}, self.options().dtype(kLong));
+  sort_out_cpu(values, indices, self, dim, descending);
+  return std::make_tuple(values, indices);
+}
+
 std::tuple<Tensor&, Tensor&> median_out(
     Tensor& values,
     Tensor& indices,
@@ -312,6 +361,7 @@ Tensor median_cpu(const Tensor& self) {
   return result.view({});
 }
 
+DEFINE_DISPATCH(sort_stub);
 DEFINE_DISPATCH(topk_stub);
 
 } // namespace native
@@ -5,8 +5,18 @@
 
 namespace at { namespace native {
 
+// Slices along the sorted dimension that are at least this long go through
+// sort_stub instead of the TH sort, and through the parallel paths of
+// topk_stub.
+constexpr int64_t kParallelSortThreshold = 1 << 15;
+
+using sort_fn = void(*)(Tensor& values, Tensor& indices, const Tensor& self, bool descending);
 using topk_fn = void(*)(Tensor&, Tensor&, const Tensor&, int64_t, int64_t, bool, bool);
 
+// Sorts every slice of a contiguous tensor along its last dimension with a
+// parallel, stable LSD radix sort. values and indices are contiguous and of
+// the same size as self.
+DECLARE_DISPATCH(sort_fn, sort_stub);
 DECLARE_DISPATCH(topk_fn, topk_stub);
 
 }} // at::native
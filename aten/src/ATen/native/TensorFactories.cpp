@@ -14,6 +14,7 @@
 #include <ATen/native/Resize.h>
 #include <ATen/native/TensorFactories.h>
 #include <c10/core/TensorOptions.h>
+#include <c10/core/impl/COW.h>
 #include <TH/THAllocator.h>
 #include <ATen/detail/CUDAHooksInterface.h>
 #include <c10/util/Exception.h>
@@ -961,9 +962,36 @@ Tensor from_file(std::string filename, c10::optional<bool> shared, c10::optional
 
 // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ clone ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 
+// The clone sharing the storage of src, if src has the layout of the clone
+// and spans its whole storage, see Note [Copy-on-write storages]
+static Tensor lazy_clone(const Tensor& src, MemoryFormat memory_format) {
+  if (src.numel() == 0 || src.storage_offset() != 0 ||
+      !src.is_non_overlapping_and_dense() ||
+      (memory_format != MemoryFormat::Preserve && !src.is_contiguous(memory_format))) {
+    return Tensor();
+  }
+  StorageImpl* storage = src.storage().unsafeGetStorageImpl();
+  if (static_cast<size_t>(src.numel()) * src.itemsize() != storage->capacity()) {
+    return Tensor();
+  }
+  auto shared = c10::impl::cow::lazy_clone_storage(*storage);
+  if (!shared) {
+    return Tensor();
+  }
+  return at::empty({0}, src.options())
+      .set_(Storage(std::move(shared)), 0, src.sizes(), src.strides());
+}
+
 Tensor clone(const Tensor& src, c10::optional<c10::MemoryFormat> optional_memory_format) {
   auto memory_format =
       optional_memory_format.value_or(MemoryFormat::Contiguous);
+  if (at::globalContext().copyOnWriteClone() &&
+      c10::impl::cow::LazyCloneRequest::take()) {
+    auto lazy = lazy_clone(src, memory_format);
+    if (lazy.defined()) {
+      return lazy;
+    }
+  }
   if (memory_format == MemoryFormat::Preserve) {
     if (src.is_non_overlapping_and_dense()) {
       // Copy all strides
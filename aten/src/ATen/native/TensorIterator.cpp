@@ -6,6 +6,8 @@
 #include <ATen/core/EnableNamedTensor.h>
 #include <ATen/native/TypeProperties.h>
 
+#include <unordered_map>
+
 namespace at {
 
 using DimMask = TensorIterator::DimMask;
@@ -956,14 +958,7 @@ bool TensorIterator::can_use_fast_set_up() {
   return true;
 }
 
-void TensorIterator::build() {
-  // check input tensors memory format to use it during output allocation
-  analyze_memory_format();
-  // set is_output and is_read_write flags on appropriate tensors
-  mark_outputs();
-  // Check that the outputs have no internal overlap
-  // and do not share memory with inputs.
-  check_mem_overlaps();
+void TensorIterator::compute_plan() {
 #ifdef BUILD_NAMEDTENSOR
   // Check that input dimensions are aligned correctly & compute outnames.
   compute_names();
@@ -988,6 +983,207 @@ void TensorIterator::build() {
   // perform name inference
   propagate_names_to_outputs();
 #endif
+}
+
+// Note [TensorIterator plan cache]
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// The key of a cached plan encodes everything compute_plan() reads: the
+// iterator flags, and for every operand whether it is defined, an output or
+// read-write, the requested dtype and device and, if defined, the tensor's
+// dtype, sizes, strides and whether it is a wrapped number. Two iterators
+// with equal keys therefore compute the same plan, and since only successful
+// builds are inserted, also raise the same (lack of) errors.
+//
+// Builds that replace or resize an operand (type promotion by copy, legacy
+// resizing of out= arguments) are not cached, so a cached plan only ever has
+// to restore metadata and allocate the outputs that were missing.
+using PlanKey = SmallVector<int64_t, 32>;
+
+struct PlanKeyHash {
+  size_t operator()(const PlanKey& key) const {
+    size_t hash = key.size();
+    for (auto v : key) {
+      hash ^= std::hash<int64_t>()(v) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    }
+    return hash;
+  }
+};
+
+struct IterationPlan {
+  struct Operand {
+    ScalarType dtype;
+    Device device;
+    StrideVector stride_bytes;
+    // sizes and strides of the output allocated by build(), if any
+    DimVector sizes;
+    DimVector strides;
+  };
+  DimVector shape;
+  DimVector perm;
+  ScalarType common_dtype;
+  bool has_coalesced_dimensions;
+  bool all_ops_same_shape;
+  bool have_differing_types;
+  SmallVector<Operand, 4> operands;
+};
+
+struct TensorIteratorPlanCache {
+  // The cache is dropped wholesale once it holds this many plans; workloads
+  // it helps only ever see a handful of distinct signatures.
+  static constexpr size_t kMaxPlans = 256;
+
+  bool enabled = false;
+  std::unordered_map<PlanKey, IterationPlan, PlanKeyHash> plans;
+
+  static TensorIteratorPlanCache& get() {
+    static thread_local TensorIteratorPlanCache cache;
+    return cache;
+  }
+
+  // Returns false if the iterator can't be cached.
+  static bool compute_key(const TensorIterator& iter, PlanKey& key) {
+    key.push_back(static_cast<int64_t>(iter.common_dtype_strategy_));
+    key.push_back(iter.num_outputs_);
+    key.push_back(iter.resize_outputs_ | iter.is_reduction_ << 1 |
+                  iter.allow_cpu_scalars_ << 2 | iter.promote_gpu_output_dtypes_ << 3 |
+                  iter.requires_channels_last_output_ << 4);
+    for (auto& op : iter.operands_) {
+      if (!op.device.is_cpu()) {
+        return false;
+      }
+      key.push_back(static_cast<int64_t>(op.dtype));
+      if (!op.tensor.defined()) {
+        key.push_back(-1);
+        continue;
+      }
+      auto impl = op.tensor.unsafeGetTensorImpl();
+      if (!op.tensor.device().is_cpu()) {
+        return false;
+      }
+#ifdef BUILD_NAMEDTENSOR
+      if (op.tensor.has_names()) {
+        return false;
+      }
+#endif
+      key.push_back(op.is_output | op.is_read_write << 1 | impl->is_wrapped_number() << 2);
+      key.push_back(static_cast<int64_t>(op.tensor.scalar_type()));
+      key.push_back(op.tensor.dim());
+      key.append(op.tensor.sizes().begin(), op.tensor.sizes().end());
+      key.append(op.tensor.strides().begin(), op.tensor.strides().end());
+    }
+    return true;
+  }
+
+  static bool apply(TensorIterator& iter, const PlanKey& key) {
+    auto& plans = get().plans;
+    auto it = plans.find(key);
+    if (it == plans.end()) {
+      return false;
+    }
+    const auto& plan = it->second;
+    iter.shape_ = plan.shape;
+    iter.perm_ = plan.perm;
+    iter.common_dtype_ = plan.common_dtype;
+    iter.has_coalesced_dimensions_ = plan.has_coalesced_dimensions;
+    iter.all_ops_same_shape_ = plan.all_ops_same_shape;
+    iter.have_differing_types_ = plan.have_differing_types;
+    for (int i = 0; i < iter.ntensors(); i++) {
+      auto& op = iter.operands_[i];
+      const auto& plan_op = plan.operands[i];
+      op.dtype = plan_op.dtype;
+      op.device = plan_op.device;
+      op.stride_bytes = plan_op.stride_bytes;
+      if (!op.tensor.defined()) {
+        op.tensor = at::empty_strided(plan_op.sizes, plan_op.strides, op.options());
+      }
+    }
+    return true;
+  }
+
+  // `impls` are the operands' TensorImpls before compute_plan() ran, and
+  // `output_sizes` the sizes of the outputs that were defined then.
+  static void insert(const TensorIterator& iter, PlanKey&& key,
+                     ArrayRef<TensorImpl*> impls, ArrayRef<DimVector> output_sizes) {
+    IterationPlan plan;
+    for (int i = 0; i < iter.ntensors(); i++) {
+      const auto& op = iter.operands_[i];
+      if (op.original_tensor.defined()) {
+        return;
+      }
+      IterationPlan::Operand plan_op{op.dtype, op.device, op.stride_bytes, {}, {}};
+      if (impls[i] == nullptr) {
+        plan_op.sizes = op.tensor.sizes();
+        plan_op.strides = op.tensor.strides();
+      } else if (op.tensor.unsafeGetTensorImpl() != impls[i] ||
+                 (i < iter.noutputs() && !op.tensor.sizes().equals(output_sizes[i]))) {
+        return;
+      }
+      plan.operands.push_back(std::move(plan_op));
+    }
+    plan.shape = iter.shape_;
+    plan.perm = iter.perm_;
+    plan.common_dtype = iter.common_dtype_;
+    plan.has_coalesced_dimensions = iter.has_coalesced_dimensions_;
+    plan.all_ops_same_shape = iter.all_ops_same_shape_;
+    plan.have_differing_types = iter.have_differing_types_;
+
+    auto& plans = get().plans;
+    if (plans.size() >= kMaxPlans) {
+      plans.clear();
+    }
+    plans.emplace(std::move(key), std::move(plan));
+  }
+};
+
+TensorIteratorPlanCacheGuard::TensorIteratorPlanCacheGuard(bool enabled)
+  : prev_enabled_(TensorIteratorPlanCache::get().enabled) {
+  TensorIteratorPlanCache::get().enabled = enabled;
+}
+
+TensorIteratorPlanCacheGuard::~TensorIteratorPlanCacheGuard() {
+  TensorIteratorPlanCache::get().enabled = prev_enabled_;
+}
+
+bool TensorIteratorPlanCacheGuard::is_enabled() {
+  return TensorIteratorPlanCache::get().enabled;
+}
+
+size_t TensorIteratorPlanCacheGuard::size() {
+  return TensorIteratorPlanCache::get().plans.size();
+}
+
+void TensorIteratorPlanCacheGuard::clear() {
+  TensorIteratorPlanCache::get().plans.clear();
+}
+
+void TensorIterator::build() {
+  // check input tensors memory format to use it during output allocation
+  analyze_memory_format();
+  // set is_output and is_read_write flags on appropriate tensors
+  mark_outputs();
+  // Check that the outputs have no internal overlap
+  // and do not share memory with inputs.
+  check_mem_overlaps();
+
+  // See Note [TensorIterator plan cache]
+  PlanKey key;
+  bool use_plan_cache = TensorIteratorPlanCacheGuard::is_enabled() &&
+      TensorIteratorPlanCache::compute_key(*this, key);
+  if (!use_plan_cache) {
+    compute_plan();
+  } else if (!TensorIteratorPlanCache::apply(*this, key)) {
+    SmallVector<TensorImpl*, 4> impls;
+    SmallVector<DimVector, 2> output_sizes;
+    for (int i = 0; i < ntensors(); i++) {
+      const auto& tensor = operands_[i].tensor;
+      impls.push_back(tensor.defined() ? tensor.unsafeGetTensorImpl() : nullptr);
+      if (i < num_outputs_) {
+        output_sizes.emplace_back(tensor.defined() ? tensor.sizes() : IntArrayRef());
+      }
+    }
+    compute_plan();
+    TensorIteratorPlanCache::insert(*this, std::move(key), impls, output_sizes);
+  }
 
   for (auto& op : operands_) {
     TORCH_INTERNAL_ASSERT(op.tensor.defined());
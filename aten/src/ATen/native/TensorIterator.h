@@ -125,6 +125,7 @@ struct CAFFE2_API OperandInfo {
 };
 
 struct SplitUntil32Bit;
+struct TensorIteratorPlanCache;
 
 enum class CommonDTypeStrategy : uint8_t {
   NONE, // Do not compute a common dtype
@@ -337,6 +338,9 @@ struct CAFFE2_API TensorIterator {
   void build();
 
 protected:
+  friend struct TensorIteratorPlanCache;
+
+  void compute_plan();
   void mark_outputs();
   void check_mem_overlaps();
   void compute_shape();
@@ -377,6 +381,44 @@ protected:
   bool all_ops_same_shape_ = false;
   bool requires_channels_last_output_ = false;
 };
+
+/// Enables the thread-local cache of iteration plans in TensorIterator::build()
+/// for the lifetime of the guard.
+///
+/// An iteration plan is everything build() derives from the operands' dtypes,
+/// sizes and strides: the broadcast shape, the dimension permutation, the
+/// coalesced strides and the result types. When a CPU iterator is built with
+/// the same operand signature as a previously built one, the plan is reused
+/// and build() only allocates missing outputs. This is meant for workloads
+/// dominated by ops on small tensors, where the setup costs more than the
+/// loop itself.
+///
+/// Iterators with named tensors, non-CPU operands, or whose build had to cast
+/// or resize operands are never cached.
+///
+///   {
+///     at::TensorIteratorPlanCacheGuard guard;
+///     for (auto& request : requests) {
+///       run_model(request);
+///     }
+///   }
+struct CAFFE2_API TensorIteratorPlanCacheGuard {
+  explicit TensorIteratorPlanCacheGuard(bool enabled = true);
+  ~TensorIteratorPlanCacheGuard();
+
+  TensorIteratorPlanCacheGuard(const TensorIteratorPlanCacheGuard&) = delete;
+  TensorIteratorPlanCacheGuard& operator=(const TensorIteratorPlanCacheGuard&) = delete;
+
+  /// Whether build() consults the plan cache on this thread.
+  static bool is_enabled();
+  /// Number of plans cached on this thread.
+  static size_t size();
+  /// Drops all plans cached on this thread.
+  static void clear();
+
+ private:
+  bool prev_enabled_;
+};
 /// A container-like struct that acts as if it contains splits of a
 /// TensorIterator that can use 32-bit indexing. Taken together the splits cover
 /// the original TensorIterator.
@@ -5,6 +5,7 @@
 #include <ATen/ExpandUtils.h>
 #include <ATen/InferSize.h>
 #include <ATen/NativeFunctions.h>
+#include <ATen/Parallel.h>
 #include <ATen/WrapDimUtils.h>
 #include <c10/util/Exception.h>
 #include <c10/util/Optional.h>
@@ -12,6 +13,7 @@
 #include <ATen/SparseTensorUtils.h>
 #include <ATen/quantized/QTensorImpl.h>
 #include <algorithm>
+#include <numeric>
 #include <vector>
 #include <ATen/NamedTensorUtils.h>
 #include <ATen/core/EnableNamedTensor.h>
@@ -213,6 +215,9 @@ Tensor cat(TensorList tensors, int64_t dim) {
   }
   check_cat_no_zero_dim(tensors);
   dim = legacy_cat_wrap_dim(dim, tensors);
+  if (tensors.size() > 0 && tensors[0].is_mkldnn()) {
+    return at::_mkldnn_cat(tensors, dim);
+  }
 #ifdef BUILD_NAMEDTENSOR
   auto maybe_outnames = namedinference::compute_cat_outnames(tensors);
 #endif
@@ -229,6 +234,155 @@ Tensor cat(TensorList tensors, int64_t dim) {
   return result;
 }
 
+// Size [0] tensors used to be the only empty tensors, and are skipped by cat
+// whatever the other sizes for backwards compatibility.
+static bool cat_should_skip_tensor(const Tensor& t) {
+  return t.numel() == 0 && t.dim() == 1;
+}
+
+static void check_cat_shape_except_dim(const Tensor& first, const Tensor& second, int64_t dimension) {
+  int64_t first_dims = first.dim();
+  int64_t second_dims = second.dim();
+  TORCH_CHECK(first_dims == second_dims,
+      "Tensors must have same number of dimensions: got ", first_dims, " and ", second_dims);
+  for (int64_t dim = 0; dim < first_dims; dim++) {
+    if (dim == dimension) {
+      continue;
+    }
+    int64_t first_dim_size = first.size(dim);
+    int64_t second_dim_size = second.size(dim);
+    TORCH_CHECK(first_dim_size == second_dim_size,
+        "Sizes of tensors must match except in dimension ", dimension, ". Got ",
+        first_dim_size, " and ", second_dim_size, " in dimension ", dim);
+  }
+}
+
+// The memory format all the inputs are contiguous in, if any.
+static c10::optional<MemoryFormat> cat_common_memory_format(const std::vector<Tensor>& inputs) {
+  if (std::all_of(inputs.begin(), inputs.end(),
+                  [](const Tensor& t) { return t.is_contiguous(); })) {
+    return MemoryFormat::Contiguous;
+  }
+  if (std::all_of(inputs.begin(), inputs.end(), [](const Tensor& t) {
+        return t.dim() == 4 && t.is_contiguous(MemoryFormat::ChannelsLast);
+      })) {
+    return MemoryFormat::ChannelsLast;
+  }
+  return c10::nullopt;
+}
+
+// Concatenates inputs that are, like the result, contiguous in memory_format:
+// in memory, every input is then a sequence of `outer` slices, and the result
+// the same slices of all inputs interleaved. Each (slice, input) pair is one
+// memcpy, and the pairs are split between threads, so that both a cat of many
+// inputs along the first dimension and a cat of a few inputs along an inner
+// one run in parallel.
+static void cat_contiguous_cpu(Tensor& result, const std::vector<Tensor>& inputs, int64_t dim, MemoryFormat memory_format) {
+  // The dimensions in memory order
+  std::vector<int64_t> order(result.dim());
+  std::iota(order.begin(), order.end(), 0);
+  if (memory_format == MemoryFormat::ChannelsLast) {
+    order = {0, 2, 3, 1};
+  }
+  int64_t outer = 1, inner = 1;
+  bool before_dim = true;
+  for (auto d : order) {
+    if (d == dim) {
+      before_dim = false;
+    } else if (before_dim) {
+      outer *= result.size(d);
+    } else {
+      inner *= result.size(d);
+    }
+  }
+
+  const int64_t num_inputs = inputs.size();
+  const int64_t element_size = result.element_size();
+  std::vector<const char*> input_data(num_inputs);
+  std::vector<int64_t> slice_bytes(num_inputs);
+  std::vector<int64_t> result_offsets(num_inputs);
+  int64_t row_bytes = 0;
+  for (int64_t j = 0; j < num_inputs; ++j) {
+    input_data[j] = static_cast<const char*>(inputs[j].data_ptr());
+    slice_bytes[j] = inner * inputs[j].size(dim) * element_size;
+    result_offsets[j] = row_bytes;
+    row_bytes += slice_bytes[j];
+  }
+  if (row_bytes == 0) {
+    return;
+  }
+  char* result_data = static_cast<char*>(result.data_ptr());
+
+  const int64_t average_numel = std::max<int64_t>(row_bytes / element_size / num_inputs, 1);
+  const int64_t grain_size = std::max<int64_t>(internal::GRAIN_SIZE / average_numel, 1);
+  at::parallel_for(0, outer * num_inputs, grain_size, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; ++i) {
+      const int64_t o = i / num_inputs;
+      const int64_t j = i % num_inputs;
+      if (slice_bytes[j] != 0) {
+        memcpy(result_data + o * row_bytes + result_offsets[j],
+               input_data[j] + o * slice_bytes[j],
+               slice_bytes[j]);
+      }
+    }
+  });
+}
+
+Tensor& _cat_out_cpu(Tensor& result, TensorList tensors, int64_t dim) {
+  TORCH_CHECK(tensors.size() > 0, "expected a non-empty list of Tensors");
+  for (size_t i = 0; i < tensors.size(); ++i) {
+    TORCH_CHECK(tensors[i].device().is_cpu() && tensors[i].layout() == kStrided,
+        "Expected a dense CPU tensor for sequence element ", i, " in argument 'tensors' of cat");
+    TORCH_CHECK(tensors[i].scalar_type() == result.scalar_type(),
+        "Expected object of scalar type ", result.scalar_type(), " but got scalar type ",
+        tensors[i].scalar_type(), " for sequence element ", i, " in argument 'tensors' of cat");
+  }
+
+  std::vector<Tensor> inputs;
+  inputs.reserve(tensors.size());
+  for (const auto& t : tensors) {
+    if (!cat_should_skip_tensor(t)) {
+      inputs.push_back(t);
+    }
+  }
+  if (inputs.empty()) {
+    return result;
+  }
+
+  const auto& first = inputs[0];
+  TORCH_CHECK(dim >= 0 && dim < first.dim(), "invalid dimension ", dim);
+  int64_t cat_dim_size = 0;
+  for (const auto& t : inputs) {
+    check_cat_shape_except_dim(first, t, dim);
+    cat_dim_size += t.size(dim);
+  }
+  auto size = first.sizes().vec();
+  size[dim] = cat_dim_size;
+
+  const auto memory_format = cat_common_memory_format(inputs);
+  // A preallocated result of the right size is written to as it is
+  if (result.sizes() != IntArrayRef(size)) {
+    result.resize_(size, memory_format.value_or(MemoryFormat::Contiguous));
+  }
+
+  if (memory_format && result.is_contiguous(*memory_format)) {
+    cat_contiguous_cpu(result, inputs, dim, *memory_format);
+  } else {
+    int64_t offset = 0;
+    for (const auto& t : inputs) {
+      result.narrow(dim, offset, t.size(dim)).copy_(t);
+      offset += t.size(dim);
+    }
+  }
+  return result;
+}
+
+Tensor _cat_cpu(TensorList tensors, int64_t dim) {
+  TORCH_CHECK(tensors.size() > 0, "expected a non-empty list of Tensors");
+  Tensor result = at::empty({0}, tensors[0].options());
+  return native::_cat_out_cpu(result, tensors, dim);
+}
+
 std::vector<Tensor> chunk(const Tensor& self, int64_t chunks, int64_t dim) {
   TORCH_CHECK(self.dim() > 0,
            "chunk expects at least a 1-dimensional tensor");
@@ -431,8 +585,8 @@ Tensor permute(const Tensor& self, IntArrayRef dims) {
            "number of dims don't match in permute");
   auto oldSizes = self.sizes();
   auto oldStrides = self.strides();
-  std::vector<int64_t> newSizes(nDims);
-  std::vector<int64_t> newStrides(nDims);
+  DimVector newSizes(static_cast<size_t>(nDims));
+  DimVector newStrides(static_cast<size_t>(nDims));
   std::vector<bool> seen(nDims);
   for (int64_t i = 0; i < nDims; i++) {
     auto dim = maybe_wrap_dim(dims[i], nDims);
@@ -569,8 +723,8 @@ Tensor select(const Tensor& self, int64_t dim, int64_t index) {
   if (self.is_sparse()) {
     return select_sparse(self, dim, index);
   }
-  auto sizes = self.sizes().vec();
-  auto strides = self.strides().vec();
+  DimVector sizes(self.sizes());
+  DimVector strides(self.strides());
   auto storage_offset = self.storage_offset() + index * strides[dim];
   sizes.erase(sizes.begin() + dim);
   strides.erase(strides.begin() + dim);
@@ -678,8 +832,8 @@ Tensor slice(const Tensor& self, int64_t dim, int64_t start, int64_t end, int64_
     AT_INDEX_ERROR("slice() cannot be applied to a 0-dim tensor.");
   }
   dim = maybe_wrap_dim(dim, ndim);
-  auto sizes = self.sizes().vec();
-  auto strides = self.strides().vec();
+  DimVector sizes(self.sizes());
+  DimVector strides(self.strides());
   // TODO: support negative strides
   TORCH_CHECK(step > 0, "slice step must be positive");
   if (start < 0) {
@@ -846,8 +1000,8 @@ Tensor & transpose_(Tensor & self, int64_t dim0, int64_t dim1) {
     return at::_mkldnn_transpose_(self, dim0, dim1);
   }
 
-  auto strides = self.strides().vec();
-  auto sizes = self.sizes().vec();
+  DimVector strides(self.strides());
+  DimVector sizes(self.sizes());
   std::swap(strides[dim0], strides[dim1]);
   std::swap(sizes[dim0], sizes[dim1]);
   return self.as_strided_(sizes, strides);
@@ -870,8 +1024,8 @@ Tensor transpose(const Tensor & self, int64_t dim0, int64_t dim1) {
     return at::_mkldnn_transpose(self, dim0, dim1);
   }
 
-  auto strides = self.strides().vec();
-  auto sizes = self.sizes().vec();
+  DimVector strides(self.strides());
+  DimVector sizes(self.sizes());
   std::swap(strides[dim0], strides[dim1]);
   std::swap(sizes[dim0], sizes[dim1]);
   auto result = self.as_strided(sizes, strides);
@@ -904,10 +1058,10 @@ Tensor & t_(Tensor & self) {
   return self.transpose_(0, self.dim() < 2 ? 0 : 1);
 }
 
-std::tuple<std::vector<int64_t>, std::vector<int64_t> >
+std::tuple<DimVector, DimVector>
 inferSqueezeGeometry(const Tensor &tensor) {
-  std::vector<int64_t> sizes;
-  std::vector<int64_t> strides;
+  DimVector sizes;
+  DimVector strides;
 
   for(int64_t d = 0; d < tensor.dim(); d++) {
     if(tensor.sizes()[d] != 1) {
@@ -919,10 +1073,10 @@ inferSqueezeGeometry(const Tensor &tensor) {
   return std::make_tuple(sizes, strides);
 }
 
-std::tuple<std::vector<int64_t>, std::vector<int64_t> >
+std::tuple<DimVector, DimVector>
 inferSqueezeGeometry(const Tensor& tensor, int64_t dim) {
-  std::vector<int64_t> sizes;
-  std::vector<int64_t> strides;
+  DimVector sizes;
+  DimVector strides;
 
   for(int64_t d = 0; d < tensor.dim(); d++) {
     if(d != dim || tensor.sizes()[dim] != 1) {
@@ -933,10 +1087,10 @@ inferSqueezeGeometry(const Tensor& tensor, int64_t dim) {
   return std::make_tuple(sizes, strides);
 }
 
-std::tuple<std::vector<int64_t>, std::vector<int64_t> >
+std::tuple<DimVector, DimVector>
 inferUnsqueezeGeometry(const Tensor& tensor, int64_t dim) {
-  auto sizes = tensor.sizes().vec();
-  auto strides = tensor.strides().vec();
+  DimVector sizes(tensor.sizes());
+  DimVector strides(tensor.strides());
   int64_t new_stride = dim >= tensor.dim() ? 1 : sizes[dim] * strides[dim];
   sizes.insert(sizes.begin() + dim, 1);
   strides.insert(strides.begin() + dim, new_stride);
@@ -1211,8 +1365,8 @@ Tensor unfold(const Tensor& self, int64_t dimension, int64_t size, int64_t step)
                                 " is ", max_size, " but size is ", size);
   TORCH_CHECK(step > 0, "step is ", step, " but must be > 0");
 
-  std::vector<int64_t> new_size(self.dim() + 1);
-  std::vector<int64_t> new_stride(self.dim() + 1);
+  DimVector new_size(static_cast<size_t>(self.dim() + 1));
+  DimVector new_stride(static_cast<size_t>(self.dim() + 1));
 
   new_size[self.dim()] = size;
   new_stride[self.dim()] = self.dim() == 0 ? 1 : self.stride(dimension);
@@ -2,6 +2,8 @@
 
 #include <ATen/ATen.h>
 #include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
+#include <ATen/native/Sorting.h>
 
 #include <set>
 #include <tuple>
@@ -13,12 +15,87 @@ namespace native{
 
 namespace {
 
+// Sorts the input and keeps the first element of every run of equal values.
+// For long inputs the parallel sort is faster than hashing, and the runs are
+// numbered in parallel with a per-chunk scan.
+template <typename scalar_t>
+std::tuple<Tensor, Tensor, Tensor> unique_cpu_sorted_template(
+    const Tensor& self,
+    const bool return_inverse,
+    const bool return_counts) {
+  Tensor sorted, sorted_indices;
+  std::tie(sorted, sorted_indices) = self.reshape({-1}).sort();
+  const scalar_t* sorted_data = sorted.data_ptr<scalar_t>();
+  const int64_t* sorted_indices_data = sorted_indices.data_ptr<int64_t>();
+  const int64_t numel = sorted.numel();
+
+  const int64_t num_chunks = std::max<int64_t>(1, std::min<int64_t>(at::get_num_threads(), numel / 4096));
+  const int64_t chunk_size = (numel + num_chunks - 1) / num_chunks;
+  auto is_run_start = [&](int64_t i) {
+    return i == 0 || sorted_data[i] != sorted_data[i - 1];
+  };
+
+  std::vector<int64_t> chunk_base(num_chunks + 1, 0);
+  at::parallel_for(0, num_chunks, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t c = begin; c < end; c++) {
+      int64_t runs = 0;
+      for (int64_t i = c * chunk_size; i < std::min(numel, (c + 1) * chunk_size); i++) {
+        runs += is_run_start(i);
+      }
+      chunk_base[c + 1] = runs;
+    }
+  });
+  for (int64_t c = 0; c < num_chunks; c++) {
+    chunk_base[c + 1] += chunk_base[c];
+  }
+  const int64_t num_unique = chunk_base[num_chunks];
+
+  Tensor output = at::empty({num_unique}, self.options());
+  Tensor inverse_indices = at::empty({0}, self.options().dtype(kLong));
+  Tensor counts = at::empty({0}, self.options().dtype(kLong));
+  if (return_inverse || return_counts) {
+    inverse_indices.resize_(self.sizes());
+  }
+  std::vector<int64_t> run_starts(num_unique);
+  scalar_t* output_data = output.data_ptr<scalar_t>();
+  int64_t* inverse_data = inverse_indices.numel() > 0 ? inverse_indices.data_ptr<int64_t>() : nullptr;
+  at::parallel_for(0, num_chunks, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t c = begin; c < end; c++) {
+      // the first element of every chunk but the first may continue the
+      // last run of the previous chunk
+      int64_t run = chunk_base[c] - 1;
+      for (int64_t i = c * chunk_size; i < std::min(numel, (c + 1) * chunk_size); i++) {
+        if (is_run_start(i)) {
+          run++;
+          output_data[run] = sorted_data[i];
+          run_starts[run] = i;
+        }
+        if (inverse_data) {
+          inverse_data[sorted_indices_data[i]] = run;
+        }
+      }
+    }
+  });
+
+  if (return_counts) {
+    counts.resize_({num_unique});
+    int64_t* counts_data = counts.data_ptr<int64_t>();
+    for (int64_t run = 0; run < num_unique; run++) {
+      counts_data[run] = (run + 1 < num_unique ? run_starts[run + 1] : numel) - run_starts[run];
+    }
+  }
+  return std::make_tuple(output, inverse_indices, counts);
+}
+
 template <typename scalar_t>
 std::tuple<Tensor, Tensor, Tensor> unique_cpu_template(
     const Tensor& self,
     const bool sorted,
     const bool return_inverse,
     const bool return_counts) {
+  if (sorted && self.numel() >= kParallelSortThreshold && !std::is_same<scalar_t, bool>::value) {
+    return unique_cpu_sorted_template<scalar_t>(self, return_inverse, return_counts);
+  }
   const Tensor& input = self.contiguous();
   const scalar_t* input_data = input.data_ptr<scalar_t>();
   int64_t numel = input.numel();
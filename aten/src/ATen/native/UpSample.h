@@ -2,10 +2,17 @@
 
 #include <ATen/ATen.h>
 #include <ATen/TensorUtils.h>
+#include <ATen/native/DispatchStub.h>
 
 namespace at {
 namespace native {
 
+// Kernel for 4D channels last (NHWC) inputs; output is expected to be
+// allocated in channels last by the caller.
+using upsample_bilinear2d_fn = void(*)(Tensor& output, const Tensor& input, bool align_corners);
+
+DECLARE_DISPATCH(upsample_bilinear2d_fn, upsample_bilinear2d_channels_last_kernel);
+
 static inline void upsample_1d_shape_check(
     const Tensor& input,
     const Tensor& grad_output,
@@ -3,8 +3,12 @@
 
 #include <ATen/ATen.h>
 #include <ATen/NativeFunctions.h>
+#include <ATen/Parallel.h>
 #include <ATen/native/UpSample.h>
 
+#include <algorithm>
+#include <vector>
+
 namespace at {
 namespace native {
 namespace {
@@ -81,6 +85,12 @@ static void upsample_bilinear2d_out_frame(
   }
 }
 
+// The planes of grad_input only receive gradient from the same planes of
+// grad_output, so the planes are run in parallel. Within a plane, the
+// gradient of each output row is first interpolated back along the width into
+// a row of input_width elements, which is then added to the two input rows
+// with the height weights, in contiguous loops instead of the four scattered
+// adds per output pixel.
 template <typename scalar_t>
 static void upsample_bilinear2d_backward_out_frame(
     scalar_t* odata,
@@ -93,23 +103,18 @@ static void upsample_bilinear2d_backward_out_frame(
     int64_t channels,
     bool align_corners) {
   channels = channels * nbatch;
+  const int64_t input_slice_size = input_height * input_width;
+  const int64_t output_slice_size = output_height * output_width;
+  const int64_t grain_size =
+      std::max<int64_t>(1, at::internal::GRAIN_SIZE / (4 * output_slice_size));
 
   // special case: same-size matching grids
   if (input_height == output_height && input_width == output_width) {
-    for (int64_t h2 = 0; h2 < output_height; ++h2) {
-      const int64_t h1 = h2;
-      for (int64_t w2 = 0; w2 < output_width; ++w2) {
-        const int64_t w1 = w2;
-        scalar_t* pos1 = &idata[h1 * input_width + w1];
-        const scalar_t* pos2 = &odata[h2 * output_width + w2];
-
-        for (int64_t c = 0; c < channels; ++c) {
-          pos1[0] += pos2[0];
-          pos1 += input_width * input_height;
-          pos2 += output_width * output_height;
-        }
+    at::parallel_for(0, channels * input_slice_size, at::internal::GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+      for (int64_t i = begin; i < end; ++i) {
+        idata[i] += odata[i];
       }
-    }
+    });
     return;
   }
 
@@ -118,40 +123,54 @@ static void upsample_bilinear2d_backward_out_frame(
   const scalar_t rwidth = area_pixel_compute_scale<scalar_t>(
       input_width, output_width, align_corners);
 
-  for (int64_t h2 = 0; h2 < output_height; ++h2) {
-    const scalar_t h1r = area_pixel_compute_source_index<scalar_t>(
-        rheight, h2, align_corners, /*cubic=*/false);
-
-    const int64_t h1 = h1r;
-    const int64_t h1p = (h1 < input_height - 1) ? 1 : 0;
-
-    const scalar_t h1lambda = h1r - h1;
-    const scalar_t h0lambda = static_cast<scalar_t>(1.) - h1lambda;
+  // The source columns and weights are the same for all the rows and planes
+  std::vector<int64_t> w1s(output_width);
+  std::vector<int64_t> w1ps(output_width);
+  std::vector<scalar_t> w0lambdas(output_width);
+  std::vector<scalar_t> w1lambdas(output_width);
+  for (int64_t w2 = 0; w2 < output_width; ++w2) {
+    const scalar_t w1r = area_pixel_compute_source_index<scalar_t>(
+        rwidth, w2, align_corners, /*cubic=*/false);
+    w1s[w2] = w1r;
+    w1ps[w2] = (w1s[w2] < input_width - 1) ? 1 : 0;
+    w1lambdas[w2] = w1r - w1s[w2];
+    w0lambdas[w2] = static_cast<scalar_t>(1.) - w1lambdas[w2];
+  }
 
-    for (int64_t w2 = 0; w2 < output_width; ++w2) {
-      const scalar_t w1r = area_pixel_compute_source_index<scalar_t>(
-          rwidth, w2, align_corners, /*cubic=*/false);
+  at::parallel_for(0, channels, grain_size, [&](int64_t begin, int64_t end) {
+    std::vector<scalar_t> row(input_width);
+    for (int64_t c = begin; c < end; ++c) {
+      scalar_t* islice = idata + c * input_slice_size;
+      const scalar_t* oslice = odata + c * output_slice_size;
 
-      const int64_t w1 = w1r;
-      const int64_t w1p = (w1 < input_width - 1) ? 1 : 0;
+      for (int64_t h2 = 0; h2 < output_height; ++h2) {
+        const scalar_t h1r = area_pixel_compute_source_index<scalar_t>(
+            rheight, h2, align_corners, /*cubic=*/false);
 
-      const scalar_t w1lambda = w1r - w1;
-      const scalar_t w0lambda = static_cast<scalar_t>(1.) - w1lambda;
+        const int64_t h1 = h1r;
+        const int64_t h1p = (h1 < input_height - 1) ? 1 : 0;
 
-      scalar_t* pos1 = &idata[h1 * input_width + w1];
+        const scalar_t h1lambda = h1r - h1;
+        const scalar_t h0lambda = static_cast<scalar_t>(1.) - h1lambda;
 
-      const scalar_t* pos2 = &odata[h2 * output_width + w2];
+        const scalar_t* orow = oslice + h2 * output_width;
+        std::fill(row.begin(), row.end(), static_cast<scalar_t>(0));
+        for (int64_t w2 = 0; w2 < output_width; ++w2) {
+          row[w1s[w2]] += w0lambdas[w2] * orow[w2];
+          row[w1s[w2] + w1ps[w2]] += w1lambdas[w2] * orow[w2];
+        }
 
-      for (int64_t c = 0; c < channels; ++c) {
-        pos1[0] += h0lambda * w0lambda * pos2[0];
-        pos1[w1p] += h0lambda * w1lambda * pos2[0];
-        pos1[h1p * input_width] += h1lambda * w0lambda * pos2[0];
-        pos1[h1p * input_width + w1p] += h1lambda * w1lambda * pos2[0];
-        pos1 += input_width * input_height;
-        pos2 += output_width * output_height;
+        scalar_t* irow0 = islice + h1 * input_width;
+        scalar_t* irow1 = irow0 + h1p * input_width;
+        for (int64_t w1 = 0; w1 < input_width; ++w1) {
+          irow0[w1] += h0lambda * row[w1];
+        }
+        for (int64_t w1 = 0; w1 < input_width; ++w1) {
+          irow1[w1] += h1lambda * row[w1];
+        }
       }
     }
-  }
+  });
 }
 
 static void upsample_bilinear2d_out_cpu_template(
@@ -182,6 +201,14 @@ static void upsample_bilinear2d_out_cpu_template(
       output_height,
       output_width);
 
+  if (input_.suggest_memory_format() == at::MemoryFormat::ChannelsLast &&
+      input_.scalar_type() != at::kHalf) {
+    output.resize_({nbatch, channels, output_height, output_width}, at::MemoryFormat::ChannelsLast);
+    upsample_bilinear2d_channels_last_kernel(
+        kCPU, output, input_.contiguous(at::MemoryFormat::ChannelsLast), align_corners);
+    return;
+  }
+
   auto input = input_.contiguous();
 
   output.resize_({nbatch, channels, output_height, output_width});
@@ -308,5 +335,7 @@ Tensor upsample_bilinear2d_backward_cpu(
   return grad_input;
 }
 
+DEFINE_DISPATCH(upsample_bilinear2d_channels_last_kernel);
+
 } // namespace native
 } // namespace at
@@ -0,0 +1,95 @@
+#include <ATen/ATen.h>
+
+#include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
+#include <ATen/cpu/vec512/vec512.h>
+#include <ATen/native/AdaptivePooling.h>
+
+#include <cmath>
+
+namespace at { namespace native {
+
+namespace {
+
+using namespace vec512;
+
+inline int start_index(int a, int b, int c) {
+  return (int)std::floor((float)(a * c) / b);
+}
+
+inline int end_index(int a, int b, int c) {
+  return (int)std::ceil((float)((a + 1) * c) / b);
+}
+
+template <typename scalar_t>
+void cpu_adaptive_avg_pool2d_channels_last(
+    Tensor& output,
+    const Tensor& input) {
+  using Vec = Vectorized<scalar_t>;
+  const int64_t nbatch = input.size(0);
+  const int64_t channels = input.size(1);
+  const int64_t input_height = input.size(2);
+  const int64_t input_width = input.size(3);
+  const int64_t output_height = output.size(2);
+  const int64_t output_width = output.size(3);
+
+  const scalar_t* input_data = input.data_ptr<scalar_t>();
+  scalar_t* output_data = output.data_ptr<scalar_t>();
+
+  // Each output pixel is the average of a window of input pixels, and every
+  // pixel holds `channels` contiguous values, so the sum is vectorized over
+  // channels. The summation order matches the NCHW kernel.
+  const int64_t vec_end = channels - (channels % Vec::size());
+  at::parallel_for(0, nbatch * output_height * output_width, 0, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; i++) {
+      const int64_t n = i / (output_height * output_width);
+      const int oh = (i / output_width) % output_height;
+      const int ow = i % output_width;
+
+      const int ih0 = start_index(oh, output_height, input_height);
+      const int ih1 = end_index(oh, output_height, input_height);
+      const int iw0 = start_index(ow, output_width, input_width);
+      const int iw1 = end_index(ow, output_width, input_width);
+      const int kh = ih1 - ih0;
+      const int kw = iw1 - iw0;
+
+      const scalar_t* in = input_data + n * input_height * input_width * channels;
+      scalar_t* out = output_data + i * channels;
+
+      int64_t c = 0;
+      for (; c < vec_end; c += Vec::size()) {
+        Vec sum(scalar_t(0));
+        for (int ih = ih0; ih < ih1; ih++) {
+          for (int iw = iw0; iw < iw1; iw++) {
+            sum = sum + Vec::loadu(in + (ih * input_width + iw) * channels + c);
+          }
+        }
+        sum = sum / Vec(scalar_t(kw)) / Vec(scalar_t(kh));
+        sum.store(out + c);
+      }
+      for (; c < channels; c++) {
+        scalar_t sum = 0;
+        for (int ih = ih0; ih < ih1; ih++) {
+          for (int iw = iw0; iw < iw1; iw++) {
+            sum += in[(ih * input_width + iw) * channels + c];
+          }
+        }
+        out[c] = sum / kw / kh;
+      }
+    }
+  });
+}
+
+void adaptive_avg_pool2d_channels_last_kernel_impl(
+    Tensor& output,
+    const Tensor& input) {
+  AT_DISPATCH_FLOATING_TYPES(input.scalar_type(), "adaptive_avg_pool2d_channels_last", [&] {
+    cpu_adaptive_avg_pool2d_channels_last<scalar_t>(output, input);
+  });
+}
+
+} // namespace
+
+REGISTER_DISPATCH(adaptive_avg_pool2d_channels_last_kernel, &adaptive_avg_pool2d_channels_last_kernel_impl);
+
+}} // namespace at::native
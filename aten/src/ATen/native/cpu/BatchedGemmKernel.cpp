@@ -0,0 +1,156 @@
+#include <ATen/ATen.h>
+
+#include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
+#include <ATen/cpu/vec512/vec512.h>
+#include <ATen/native/LinearAlgebra.h>
+
+#include <algorithm>
+
+namespace at { namespace native {
+
+namespace {
+
+using namespace vec512;
+
+// Number of rows of the result computed at once by the microkernel. Together
+// with one vector of columns per row this keeps MR accumulators in registers
+// while every loaded row vector of B is reused MR times.
+constexpr int64_t MR = 4;
+
+template <typename scalar_t>
+struct GemmParams {
+  const scalar_t* a;
+  int64_t a_row_stride;
+  int64_t a_col_stride;
+  const scalar_t* b;
+  int64_t ldb;
+  scalar_t* c;
+  int64_t ldc;
+  int64_t k;
+  scalar_t alpha;
+  scalar_t beta;
+};
+
+// Writes rows [i, i + ROWS) and columns [j, j + Vec::size()) of
+// c = alpha * a @ b + beta * c.
+template <typename scalar_t, int64_t ROWS>
+inline void gemm_micro_tile(const GemmParams<scalar_t>& p, int64_t i, int64_t j) {
+  using Vec = Vectorized<scalar_t>;
+  Vec acc[ROWS];
+  for (int64_t r = 0; r < ROWS; r++) {
+    acc[r] = Vec(scalar_t(0));
+  }
+  const scalar_t* a = p.a + i * p.a_row_stride;
+  for (int64_t l = 0; l < p.k; l++) {
+    const Vec b_vec = Vec::loadu(p.b + l * p.ldb + j);
+    for (int64_t r = 0; r < ROWS; r++) {
+      acc[r] = fmadd(Vec(a[r * p.a_row_stride + l * p.a_col_stride]), b_vec, acc[r]);
+    }
+  }
+  for (int64_t r = 0; r < ROWS; r++) {
+    scalar_t* c = p.c + (i + r) * p.ldc + j;
+    Vec out = acc[r] * Vec(p.alpha);
+    if (p.beta != scalar_t(0)) {
+      out = fmadd(Vec::loadu(c), Vec(p.beta), out);
+    }
+    out.store(c);
+  }
+}
+
+// Scalar version of gemm_micro_tile for the columns left over after the last
+// full vector.
+template <typename scalar_t>
+inline void gemm_scalar_tile(const GemmParams<scalar_t>& p, int64_t i_begin, int64_t i_end, int64_t j_begin, int64_t j_end) {
+  for (int64_t i = i_begin; i < i_end; i++) {
+    const scalar_t* a = p.a + i * p.a_row_stride;
+    scalar_t* c = p.c + i * p.ldc;
+    for (int64_t j = j_begin; j < j_end; j++) {
+      scalar_t sum = 0;
+      for (int64_t l = 0; l < p.k; l++) {
+        sum += a[l * p.a_col_stride] * p.b[l * p.ldb + j];
+      }
+      c[j] = p.beta == scalar_t(0) ? p.alpha * sum : p.alpha * sum + p.beta * c[j];
+    }
+  }
+}
+
+template <typename scalar_t>
+void gemm_small(const GemmParams<scalar_t>& p, int64_t m, int64_t n) {
+  using Vec = Vectorized<scalar_t>;
+  const int64_t n_vec = n - (n % Vec::size());
+  const int64_t m_blocked = m - (m % MR);
+  for (int64_t j = 0; j < n_vec; j += Vec::size()) {
+    int64_t i = 0;
+    for (; i < m_blocked; i += MR) {
+      gemm_micro_tile<scalar_t, MR>(p, i, j);
+    }
+    for (; i < m; i++) {
+      gemm_micro_tile<scalar_t, 1>(p, i, j);
+    }
+  }
+  if (n_vec < n) {
+    gemm_scalar_tile(p, 0, m, n_vec, n);
+  }
+}
+
+template <typename scalar_t>
+void cpu_baddbmm_small(
+    const Tensor& result,
+    const Tensor& batch1,
+    const Tensor& batch2,
+    Scalar beta_,
+    Scalar alpha_,
+    bool is_bmm) {
+  const int64_t bs = result.size(0);
+  const int64_t m = result.size(1);
+  const int64_t n = result.size(2);
+  const int64_t k = batch1.size(2);
+
+  GemmParams<scalar_t> params;
+  params.a_row_stride = batch1.stride(1);
+  params.a_col_stride = batch1.stride(2);
+  params.ldb = batch2.stride(1);
+  params.ldc = result.stride(1);
+  params.k = k;
+  params.alpha = is_bmm ? scalar_t(1) : alpha_.to<scalar_t>();
+  params.beta = is_bmm ? scalar_t(0) : beta_.to<scalar_t>();
+
+  const scalar_t* a_data = batch1.data_ptr<scalar_t>();
+  const scalar_t* b_data = batch2.data_ptr<scalar_t>();
+  scalar_t* c_data = result.data_ptr<scalar_t>();
+  const int64_t a_batch_stride = batch1.stride(0);
+  const int64_t b_batch_stride = batch2.stride(0);
+  const int64_t c_batch_stride = result.stride(0);
+
+  // The matrices are small enough that a single one does not pay for
+  // splitting across threads, so the batch is split instead.
+  const int64_t grain_size = std::max<int64_t>(1, at::internal::GRAIN_SIZE / std::max<int64_t>(1, m * n * k));
+  at::parallel_for(0, bs, grain_size, [&](int64_t begin, int64_t end) {
+    GemmParams<scalar_t> p = params;
+    for (int64_t b = begin; b < end; b++) {
+      p.a = a_data + b * a_batch_stride;
+      p.b = b_data + b * b_batch_stride;
+      p.c = c_data + b * c_batch_stride;
+      gemm_small(p, m, n);
+    }
+  });
+}
+
+void baddbmm_small_kernel_impl(
+    const Tensor& result,
+    const Tensor& batch1,
+    const Tensor& batch2,
+    Scalar beta,
+    Scalar alpha,
+    bool is_bmm) {
+  AT_DISPATCH_FLOATING_TYPES(result.scalar_type(), "baddbmm_small", [&] {
+    cpu_baddbmm_small<scalar_t>(result, batch1, batch2, beta, alpha, is_bmm);
+  });
+}
+
+} // namespace
+
+REGISTER_DISPATCH(baddbmm_small_stub, &baddbmm_small_kernel_impl);
+
+}} // namespace at::native
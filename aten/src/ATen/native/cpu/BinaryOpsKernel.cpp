@@ -3,6 +3,7 @@
 #include <ATen/Dispatch.h>
 #include <ATen/Parallel.h>
 #include <ATen/cpu/vec256/vec256.h>
+#include <ATen/cpu/vec512/vec512.h>
 #include <ATen/cpu/vec256/functional.h>
 #include <ATen/native/TensorIterator.h>
 #include <ATen/native/BinaryOps.h>
@@ -12,6 +13,7 @@ namespace at { namespace native {
 namespace {
 
 using namespace vec256;
+using namespace vec512;
 
 void add_kernel(TensorIterator& iter, Scalar alpha_scalar) {
   if (iter.dtype() == ScalarType::Bool) {
@@ -22,11 +24,11 @@ void add_kernel(TensorIterator& iter, Scalar alpha_scalar) {
   } else {
     AT_DISPATCH_ALL_TYPES_AND_COMPLEX_AND(kBFloat16, iter.dtype(), "add_cpu/sub_cpu", [&]() {
       auto alpha = alpha_scalar.to<scalar_t>();
-      auto alpha_vec = Vec256<scalar_t>(alpha);
+      auto alpha_vec = Vectorized<scalar_t>(alpha);
       cpu_kernel_vec(iter,
         [=](scalar_t a, scalar_t b) -> scalar_t { return a + alpha * b; },
-        [=](Vec256<scalar_t> a, Vec256<scalar_t> b) {
-          return vec256::fmadd(b, alpha_vec, a);
+        [=](Vectorized<scalar_t> a, Vectorized<scalar_t> b) {
+          return fmadd(b, alpha_vec, a);
         });
       });
   }
@@ -37,7 +39,7 @@ void atan2_kernel(TensorIterator& iter) {
     cpu_kernel_vec(iter, [=](scalar_t a, scalar_t b) -> scalar_t {
     return std::atan2(a, b);
   },
-    [=](Vec256<scalar_t> a, Vec256<scalar_t> b) {
+    [=](Vectorized<scalar_t> a, Vectorized<scalar_t> b) {
       return a.atan2(b);
     });
   });
@@ -54,7 +56,7 @@ void mul_kernel(TensorIterator& iter) {
     AT_DISPATCH_ALL_TYPES_AND_COMPLEX_AND(kBFloat16, iter.dtype(), "mul_cpu", [&]() {
       cpu_kernel_vec(iter,
         [=](scalar_t a, scalar_t b) -> scalar_t { return a * b; },
-        [=](Vec256<scalar_t> a, Vec256<scalar_t> b) {
+        [=](Vectorized<scalar_t> a, Vectorized<scalar_t> b) {
           return a * b;
         });
     });
@@ -76,7 +78,7 @@ void div_kernel(TensorIterator& iter) {
           [=](scalar_t a, scalar_t b) __ubsan_ignore_float_divide_by_zero__ -> scalar_t {
              return a / b;
           },
-          [=](Vec256<scalar_t> a, Vec256<scalar_t> b) {
+          [=](Vectorized<scalar_t> a, Vectorized<scalar_t> b) {
             return a / b;
           });
       });
@@ -86,7 +88,7 @@ void div_kernel(TensorIterator& iter) {
         [=](scalar_t a, scalar_t b) __ubsan_ignore_float_divide_by_zero__ -> scalar_t {
            return a / b;
         },
-        [=](Vec256<scalar_t> a, Vec256<scalar_t> b) {
+        [=](Vectorized<scalar_t> a, Vectorized<scalar_t> b) {
           return a / b;
         });
     });
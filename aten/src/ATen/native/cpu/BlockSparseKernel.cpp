@@ -0,0 +1,88 @@
+#include <ATen/ATen.h>
+
+#include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
+#include <ATen/cpu/vec256/vec256.h>
+#include <ATen/native/BlockSparse.h>
+
+namespace at { namespace native {
+
+namespace {
+
+using namespace vec256;
+
+// output[row] += weight * dense[row'], vectorized over the columns.
+template <typename scalar_t>
+inline void axpy_row(scalar_t* out, const scalar_t* in, scalar_t weight, int64_t n) {
+  using Vec = Vec256<scalar_t>;
+  const Vec weight_vec(weight);
+  int64_t d = 0;
+  for (; d + Vec::size() <= n; d += Vec::size()) {
+    Vec out_vec = fmadd(weight_vec, Vec::loadu(in + d), Vec::loadu(out + d));
+    out_vec.store(out + d);
+  }
+  for (; d < n; d++) {
+    out[d] += weight * in[d];
+  }
+}
+
+template <typename scalar_t>
+void cpu_block_sparse_mm(
+    Tensor& output,
+    const Tensor& crow_indices,
+    const Tensor& col_indices,
+    const Tensor& values,
+    const Tensor& dense) {
+  const int64_t block_rows = values.size(1);
+  const int64_t block_cols = values.size(2);
+  const int64_t block_numel = block_rows * block_cols;
+  const int64_t rows_count = crow_indices.numel() - 1;
+  const int64_t n = dense.size(1);
+
+  const int64_t* crow_data = crow_indices.data_ptr<int64_t>();
+  const int64_t* col_data = col_indices.data_ptr<int64_t>();
+  const scalar_t* values_data = values.data_ptr<scalar_t>();
+  const scalar_t* dense_data = dense.data_ptr<scalar_t>();
+  scalar_t* output_data = output.data_ptr<scalar_t>();
+
+  // Block rows write disjoint rows of the output, so they are split across
+  // threads; the block_rows output rows of a block row stay in cache while
+  // all of its blocks are accumulated into them.
+  const int64_t work_per_row = std::max<int64_t>(1, values.numel() * n / rows_count);
+  const int64_t grain_size = std::max<int64_t>(1, at::internal::GRAIN_SIZE / work_per_row);
+  at::parallel_for(0, rows_count, grain_size, [&](int64_t begin, int64_t end) {
+    for (int64_t r = begin; r < end; r++) {
+      scalar_t* out = output_data + r * block_rows * n;
+      for (int64_t b = crow_data[r]; b < crow_data[r + 1]; b++) {
+        const scalar_t* block = values_data + b * block_numel;
+        const scalar_t* in = dense_data + col_data[b] * block_cols * n;
+        for (int64_t i = 0; i < block_rows; i++) {
+          for (int64_t j = 0; j < block_cols; j++) {
+            const scalar_t weight = block[i * block_cols + j];
+            // pruned weights often leave zeros inside the kept blocks
+            if (weight != scalar_t(0)) {
+              axpy_row(out + i * n, in + j * n, weight, n);
+            }
+          }
+        }
+      }
+    }
+  });
+}
+
+void block_sparse_mm_kernel_impl(
+    Tensor& output,
+    const Tensor& crow_indices,
+    const Tensor& col_indices,
+    const Tensor& values,
+    const Tensor& dense) {
+  AT_DISPATCH_FLOATING_TYPES(values.scalar_type(), "block_sparse_mm", [&] {
+    cpu_block_sparse_mm<scalar_t>(output, crow_indices, col_indices, values, dense);
+  });
+}
+
+} // namespace
+
+REGISTER_DISPATCH(block_sparse_mm_stub, &block_sparse_mm_kernel_impl);
+
+}} // namespace at::native
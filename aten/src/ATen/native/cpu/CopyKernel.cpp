@@ -4,15 +4,212 @@
 #include <ATen/native/Copy.h>
 #include <ATen/native/TensorIterator.h>
 #include <ATen/native/cpu/Loops.h>
+#include <ATen/Parallel.h>
+#include <ATen/cpu/vec256/intrinsics.h>
 #include <c10/util/TypeCast.h>
 
 namespace at {
 namespace native {
 namespace {
 
+// Transposes a size x size block: dst[j * ld_dst + i] = src[i * ld_src + j].
+// The element type is only used for its width, the copy is bitwise.
+template <typename T>
+struct TransposeBlock {
+  static constexpr int64_t size = 8;
+  static void apply(const T* src, int64_t ld_src, T* dst, int64_t ld_dst) {
+    for (int64_t i = 0; i < size; i++) {
+      for (int64_t j = 0; j < size; j++) {
+        dst[j * ld_dst + i] = src[i * ld_src + j];
+      }
+    }
+  }
+};
+
+#if defined(CPU_CAPABILITY_AVX512) && !defined(_MSC_VER)
+
+template <>
+struct TransposeBlock<int32_t> {
+  static constexpr int64_t size = 16;
+  static void apply(const int32_t* src, int64_t ld_src, int32_t* dst, int64_t ld_dst) {
+    __m512 r[16], t[16];
+    for (int i = 0; i < 16; i++) {
+      r[i] = _mm512_loadu_ps(src + i * ld_src);
+    }
+    for (int i = 0; i < 16; i += 2) {
+      t[i] = _mm512_unpacklo_ps(r[i], r[i + 1]);
+      t[i + 1] = _mm512_unpackhi_ps(r[i], r[i + 1]);
+    }
+    for (int i = 0; i < 16; i += 4) {
+      r[i] = _mm512_shuffle_ps(t[i], t[i + 2], 0x44);
+      r[i + 1] = _mm512_shuffle_ps(t[i], t[i + 2], 0xee);
+      r[i + 2] = _mm512_shuffle_ps(t[i + 1], t[i + 3], 0x44);
+      r[i + 3] = _mm512_shuffle_ps(t[i + 1], t[i + 3], 0xee);
+    }
+    for (int i = 0; i < 16; i += 8) {
+      for (int j = 0; j < 4; j++) {
+        t[i + j] = _mm512_shuffle_f32x4(r[i + j], r[i + j + 4], 0x88);
+        t[i + j + 4] = _mm512_shuffle_f32x4(r[i + j], r[i + j + 4], 0xdd);
+      }
+    }
+    for (int i = 0; i < 8; i++) {
+      r[i] = _mm512_shuffle_f32x4(t[i], t[i + 8], 0x88);
+      r[i + 8] = _mm512_shuffle_f32x4(t[i], t[i + 8], 0xdd);
+    }
+    for (int i = 0; i < 16; i++) {
+      _mm512_storeu_ps(dst + i * ld_dst, r[i]);
+    }
+  }
+};
+
+#elif defined(CPU_CAPABILITY_AVX2) && !defined(_MSC_VER)
+
+template <>
+struct TransposeBlock<int32_t> {
+  static constexpr int64_t size = 8;
+  static void apply(const int32_t* src, int64_t ld_src, int32_t* dst, int64_t ld_dst) {
+    __m256 r[8], t[8];
+    for (int i = 0; i < 8; i++) {
+      r[i] = _mm256_loadu_ps(reinterpret_cast<const float*>(src + i * ld_src));
+    }
+    for (int i = 0; i < 8; i += 2) {
+      t[i] = _mm256_unpacklo_ps(r[i], r[i + 1]);
+      t[i + 1] = _mm256_unpackhi_ps(r[i], r[i + 1]);
+    }
+    for (int i = 0; i < 8; i += 4) {
+      r[i] = _mm256_shuffle_ps(t[i], t[i + 2], 0x44);
+      r[i + 1] = _mm256_shuffle_ps(t[i], t[i + 2], 0xee);
+      r[i + 2] = _mm256_shuffle_ps(t[i + 1], t[i + 3], 0x44);
+      r[i + 3] = _mm256_shuffle_ps(t[i + 1], t[i + 3], 0xee);
+    }
+    for (int i = 0; i < 4; i++) {
+      t[i] = _mm256_permute2f128_ps(r[i], r[i + 4], 0x20);
+      t[i + 4] = _mm256_permute2f128_ps(r[i], r[i + 4], 0x31);
+    }
+    for (int i = 0; i < 8; i++) {
+      _mm256_storeu_ps(reinterpret_cast<float*>(dst + i * ld_dst), t[i]);
+    }
+  }
+};
+
+#endif
+
+#if (defined(CPU_CAPABILITY_AVX2) || defined(CPU_CAPABILITY_AVX512)) && !defined(_MSC_VER)
+
+template <>
+struct TransposeBlock<int64_t> {
+  static constexpr int64_t size = 4;
+  static void apply(const int64_t* src, int64_t ld_src, int64_t* dst, int64_t ld_dst) {
+    __m256d r[4], t[4];
+    for (int i = 0; i < 4; i++) {
+      r[i] = _mm256_loadu_pd(reinterpret_cast<const double*>(src + i * ld_src));
+    }
+    t[0] = _mm256_unpacklo_pd(r[0], r[1]);
+    t[1] = _mm256_unpackhi_pd(r[0], r[1]);
+    t[2] = _mm256_unpacklo_pd(r[2], r[3]);
+    t[3] = _mm256_unpackhi_pd(r[2], r[3]);
+    r[0] = _mm256_permute2f128_pd(t[0], t[2], 0x20);
+    r[1] = _mm256_permute2f128_pd(t[1], t[3], 0x20);
+    r[2] = _mm256_permute2f128_pd(t[0], t[2], 0x31);
+    r[3] = _mm256_permute2f128_pd(t[1], t[3], 0x31);
+    for (int i = 0; i < 4; i++) {
+      _mm256_storeu_pd(reinterpret_cast<double*>(dst + i * ld_dst), r[i]);
+    }
+  }
+};
+
+#endif
+
+// Transposes the n0 x n1 matrix src into dst, in register blocks.
+template <typename T>
+static void transpose_tile(const T* src, int64_t ld_src, T* dst, int64_t ld_dst, int64_t n0, int64_t n1) {
+  constexpr int64_t block = TransposeBlock<T>::size;
+  int64_t i = 0;
+  for (; i + block <= n0; i += block) {
+    int64_t j = 0;
+    for (; j + block <= n1; j += block) {
+      TransposeBlock<T>::apply(src + i * ld_src + j, ld_src, dst + j * ld_dst + i, ld_dst);
+    }
+    for (; j < n1; j++) {
+      for (int64_t k = i; k < i + block; k++) {
+        dst[j * ld_dst + k] = src[k * ld_src + j];
+      }
+    }
+  }
+  for (; i < n0; i++) {
+    for (int64_t j = 0; j < n1; j++) {
+      dst[j * ld_dst + i] = src[i * ld_src + j];
+    }
+  }
+}
+
+// A copy is transpose-like if, after coalescing, the output is contiguous in
+// dim 0 and the input in dim 1, with at most one batch dimension on top
+// (e.g. NCHW -> NHWC coalesces to [C, HW, N]). The generic loop reads the
+// input with a large stride for those; the transpose path works through
+// tiles that fit in L1 instead.
+static bool is_transpose_copy(TensorIterator& iter) {
+  if (iter.ndim() != 2 && iter.ndim() != 3) {
+    return false;
+  }
+  const int64_t element_size = iter.element_size(0);
+  if (element_size != 1 && element_size != 2 && element_size != 4 && element_size != 8) {
+    return false;
+  }
+  const auto out_strides = iter.strides(0);
+  const auto in_strides = iter.strides(1);
+  const auto shape = iter.shape();
+  return out_strides[0] == element_size && in_strides[1] == element_size &&
+      in_strides[0] % element_size == 0 && out_strides[1] % element_size == 0 &&
+      shape[0] >= 16 && shape[1] >= 16 && iter.numel() >= 4096;
+}
+
+template <typename T>
+static void transpose_copy_kernel(TensorIterator& iter) {
+  // tiles of 16KB per operand
+  constexpr int64_t tile = sizeof(T) == 8 ? 32 : 64;
+  const auto out_strides = iter.strides(0);
+  const auto in_strides = iter.strides(1);
+  const int64_t n0 = iter.shape()[0];
+  const int64_t n1 = iter.shape()[1];
+  const int64_t batch = iter.ndim() == 3 ? iter.shape()[2] : 1;
+  const int64_t out_batch_stride = iter.ndim() == 3 ? out_strides[2] : 0;
+  const int64_t in_batch_stride = iter.ndim() == 3 ? in_strides[2] : 0;
+  const int64_t ld_dst = out_strides[1] / sizeof(T);
+  const int64_t ld_src = in_strides[0] / sizeof(T);
+  char* out = (char*)iter.data_ptr(0);
+  const char* in = (const char*)iter.data_ptr(1);
+
+  const int64_t tiles0 = (n0 + tile - 1) / tile;
+  const int64_t tiles1 = (n1 + tile - 1) / tile;
+  const int64_t grain_size = std::max<int64_t>(internal::GRAIN_SIZE / (tile * tile), 1);
+  at::parallel_for(0, batch * tiles0 * tiles1, grain_size, [&](int64_t begin, int64_t end) {
+    for (int64_t idx = begin; idx < end; idx++) {
+      const int64_t b = idx / (tiles0 * tiles1);
+      const int64_t i = (idx / tiles1) % tiles0 * tile;
+      const int64_t j = idx % tiles1 * tile;
+      const T* src = (const T*)(in + b * in_batch_stride) + i * ld_src + j;
+      T* dst = (T*)(out + b * out_batch_stride) + j * ld_dst + i;
+      transpose_tile(src, ld_src, dst, ld_dst, std::min(tile, n0 - i), std::min(tile, n1 - j));
+    }
+  });
+}
+
+static void transpose_copy(TensorIterator& iter) {
+  switch (iter.element_size(0)) {
+    case 1: return transpose_copy_kernel<int8_t>(iter);
+    case 2: return transpose_copy_kernel<int16_t>(iter);
+    case 4: return transpose_copy_kernel<int32_t>(iter);
+    case 8: return transpose_copy_kernel<int64_t>(iter);
+    default: TORCH_INTERNAL_ASSERT(false, "unexpected element size for transpose copy");
+  }
+}
+
 static void copy_kernel(TensorIterator& iter, bool non_blocking) {
   ScalarType dtype = iter.dtype(0);
-  if (dtype == iter.dtype(1)) {
+  if (dtype == iter.dtype(1) && is_transpose_copy(iter)) {
+    transpose_copy(iter);
+  } else if (dtype == iter.dtype(1)) {
     if (dtype == ScalarType::Half) {
       cpu_kernel(iter, [=](at::Half a) -> at::Half { return a; });
     } else if (dtype == ScalarType::BFloat16) {
@@ -0,0 +1,114 @@
+#include <ATen/native/cpu/DirectConvKernel.h>
+#include <ATen/ATen.h>
+#include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
+#include <ATen/cpu/vec512/vec512.h>
+
+namespace at {
+namespace native {
+namespace {
+
+using namespace vec512;
+
+// y += a * x for the n-vectors x and y
+template <typename scalar_t>
+inline void axpy(int64_t n, scalar_t a, const scalar_t* x, scalar_t* y) {
+  using Vec = Vectorized<scalar_t>;
+  const Vec a_vec(a);
+  int64_t i = 0;
+  for (; i + Vec::size() <= n; i += Vec::size()) {
+    fmadd(a_vec, Vec::loadu(x + i), Vec::loadu(y + i)).store(y + i);
+  }
+  for (; i < n; ++i) {
+    y[i] += a * x[i];
+  }
+}
+
+// The output pixels of the NHWC output are the sums, over the taps of the
+// filter and the input channels, of the input pixel times the row of the
+// (KH, KW, C, K) packed weight for the tap and the channel: every input value
+// is loaded once per tap and multiplied by a contiguous vector of weights,
+// accumulated in the contiguous output pixel, without an im2col buffer.
+template <typename scalar_t>
+void convolution_direct_nhwc_impl(
+    const Tensor& input,
+    const Tensor& weight,
+    const Tensor& bias,
+    const IntArrayRef stride,
+    const IntArrayRef padding,
+    Tensor& output) {
+  const int64_t batch = input.size(0);
+  const int64_t in_channels = input.size(1);
+  const int64_t in_rows = input.size(2);
+  const int64_t in_cols = input.size(3);
+  const int64_t kernel_rows = weight.size(0);
+  const int64_t kernel_cols = weight.size(1);
+  const int64_t out_channels = weight.size(3);
+  const int64_t out_rows = output.size(2);
+  const int64_t out_cols = output.size(3);
+
+  const scalar_t* input_data = input.data_ptr<scalar_t>();
+  const scalar_t* weight_data = weight.data_ptr<scalar_t>();
+  const scalar_t* bias_data = bias.defined() ? bias.data_ptr<scalar_t>() : nullptr;
+  scalar_t* output_data = output.data_ptr<scalar_t>();
+
+  at::parallel_for(0, batch * out_rows, 0, [&](int64_t start, int64_t end) {
+    for (int64_t row = start; row < end; ++row) {
+      const int64_t n = row / out_rows;
+      const int64_t oh = row % out_rows;
+      for (int64_t ow = 0; ow < out_cols; ++ow) {
+        scalar_t* out = output_data + (row * out_cols + ow) * out_channels;
+        if (bias_data) {
+          std::copy(bias_data, bias_data + out_channels, out);
+        } else {
+          std::fill(out, out + out_channels, scalar_t(0));
+        }
+        for (int64_t kh = 0; kh < kernel_rows; ++kh) {
+          const int64_t ih = oh * stride[0] - padding[0] + kh;
+          if (ih < 0 || ih >= in_rows) {
+            continue;
+          }
+          for (int64_t kw = 0; kw < kernel_cols; ++kw) {
+            const int64_t iw = ow * stride[1] - padding[1] + kw;
+            if (iw < 0 || iw >= in_cols) {
+              continue;
+            }
+            const scalar_t* in = input_data + ((n * in_rows + ih) * in_cols + iw) * in_channels;
+            const scalar_t* w = weight_data + (kh * kernel_cols + kw) * in_channels * out_channels;
+            for (int64_t c = 0; c < in_channels; ++c) {
+              axpy(out_channels, in[c], w + c * out_channels, out);
+            }
+          }
+        }
+      }
+    }
+  });
+}
+
+Tensor _convolution_direct_nhwc(
+    const Tensor& input,
+    const Tensor& packed_weight,
+    const Tensor& bias,
+    const IntArrayRef stride,
+    const IntArrayRef padding) {
+  const int64_t out_rows =
+      (input.size(2) + 2 * padding[0] - packed_weight.size(0)) / stride[0] + 1;
+  const int64_t out_cols =
+      (input.size(3) + 2 * padding[1] - packed_weight.size(1)) / stride[1] + 1;
+  Tensor output = at::empty(
+      {input.size(0), packed_weight.size(3), out_rows, out_cols},
+      input.options(),
+      MemoryFormat::ChannelsLast);
+  AT_DISPATCH_FLOATING_TYPES(input.scalar_type(), "convolution_direct_nhwc", [&] {
+    convolution_direct_nhwc_impl<scalar_t>(
+        input, packed_weight, bias, stride, padding, output);
+  });
+  return output;
+}
+
+}  // namespace
+
+REGISTER_DISPATCH(convolution_direct_nhwc_stub, &_convolution_direct_nhwc);
+
+}  // namespace native
+}  // namespace at
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <ATen/native/DispatchStub.h>
+
+/*
+  Direct NHWC convolution operator
+*/
+
+namespace at {
+namespace native {
+
+// input, packed_weight (the output of _direct_conv2d_nhwc_weight), bias,
+// stride, padding
+using convolution_direct_nhwc_fn =
+    Tensor (*)(const Tensor &, const Tensor &, const Tensor &, IntArrayRef, IntArrayRef);
+
+DECLARE_DISPATCH(convolution_direct_nhwc_fn, convolution_direct_nhwc_stub);
+
+}  // namespace native
+}  // namespace at
@@ -0,0 +1,138 @@
+#include <ATen/native/ForeachUtils.h>
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <vector>
+#include <ATen/AccumulateType.h>
+#include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
+#include <ATen/cpu/vec256/functional.h>
+#include <ATen/cpu/vec256/vec256.h>
+
+namespace at { namespace native {
+namespace {
+
+using namespace vec256;
+
+// offsets[t] is the number of elements of the tensors before the t-th, so
+// that the elements of all the tensors can be split between the threads as
+// if they were one tensor, and lists of many small tensors make one parallel
+// region instead of one per tensor.
+std::vector<int64_t> list_offsets(TensorList tensors) {
+  std::vector<int64_t> offsets(tensors.size() + 1, 0);
+  for (size_t t = 0; t < tensors.size(); t++) {
+    offsets[t + 1] = offsets[t] + tensors[t].numel();
+  }
+  return offsets;
+}
+
+// Calls f(t, begin, end) for the elements [begin, end) of the t-th tensor
+// within the elements [begin, end) of all the tensors
+template <typename func_t>
+void for_each_segment(const std::vector<int64_t>& offsets, int64_t begin, int64_t end, const func_t& f) {
+  size_t t = std::upper_bound(offsets.begin(), offsets.end(), begin) - offsets.begin() - 1;
+  for (int64_t i = begin; i < end; t++) {
+    const int64_t stop = std::min(end, offsets[t + 1]);
+    if (stop > i) {
+      f(t, i - offsets[t], stop - offsets[t]);
+      i = stop;
+    }
+  }
+}
+
+template <typename func_t>
+void parallel_over_lists(TensorList tensors, const func_t& f) {
+  const auto offsets = list_offsets(tensors);
+  at::parallel_for(0, offsets.back(), internal::GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+    for_each_segment(offsets, begin, end, f);
+  });
+}
+
+template <typename scalar_t, typename vec_op_t>
+void foreach_scalar_loop(TensorList result, TensorList self, const vec_op_t& vec_op) {
+  parallel_over_lists(self, [&](size_t t, int64_t begin, int64_t end) {
+    map(vec_op,
+        result[t].data_ptr<scalar_t>() + begin,
+        self[t].data_ptr<scalar_t>() + begin,
+        end - begin);
+  });
+}
+
+template <typename scalar_t, typename vec_op_t>
+void foreach_list_loop(TensorList result, TensorList self, TensorList other, const vec_op_t& vec_op) {
+  parallel_over_lists(self, [&](size_t t, int64_t begin, int64_t end) {
+    map2(vec_op,
+         result[t].data_ptr<scalar_t>() + begin,
+         self[t].data_ptr<scalar_t>() + begin,
+         other[t].data_ptr<scalar_t>() + begin,
+         end - begin);
+  });
+}
+
+void foreach_add_scalar_kernel(TensorList result, TensorList self, Scalar scalar) {
+  AT_DISPATCH_ALL_TYPES(self[0].scalar_type(), "_foreach_add_cpu", [&] {
+    using Vec = Vec256<scalar_t>;
+    const Vec s(scalar.to<scalar_t>());
+    foreach_scalar_loop<scalar_t>(result, self, [=](Vec a) { return a + s; });
+  });
+}
+
+void foreach_mul_scalar_kernel(TensorList result, TensorList self, Scalar scalar) {
+  AT_DISPATCH_ALL_TYPES(self[0].scalar_type(), "_foreach_mul_cpu", [&] {
+    using Vec = Vec256<scalar_t>;
+    const Vec s(scalar.to<scalar_t>());
+    foreach_scalar_loop<scalar_t>(result, self, [=](Vec a) { return a * s; });
+  });
+}
+
+void foreach_add_list_kernel(TensorList result, TensorList self, TensorList other, Scalar alpha) {
+  AT_DISPATCH_ALL_TYPES(self[0].scalar_type(), "_foreach_add_cpu", [&] {
+    using Vec = Vec256<scalar_t>;
+    const Vec alpha_vec(alpha.to<scalar_t>());
+    foreach_list_loop<scalar_t>(result, self, other, [=](Vec a, Vec b) { return vec256::fmadd(b, alpha_vec, a); });
+  });
+}
+
+void foreach_mul_list_kernel(TensorList result, TensorList self, TensorList other, Scalar /*alpha*/) {
+  AT_DISPATCH_ALL_TYPES(self[0].scalar_type(), "_foreach_mul_cpu", [&] {
+    using Vec = Vec256<scalar_t>;
+    foreach_list_loop<scalar_t>(result, self, other, [](Vec a, Vec b) { return a * b; });
+  });
+}
+
+void foreach_norm_kernel(Tensor& result, TensorList tensors) {
+  AT_DISPATCH_FLOATING_TYPES(tensors[0].scalar_type(), "_foreach_norm_cpu", [&] {
+    using Vec = Vec256<scalar_t>;
+    using acc_t = acc_type<scalar_t, false>;
+    const auto offsets = list_offsets(tensors);
+    std::vector<scalar_t*> data(tensors.size());
+    for (size_t t = 0; t < tensors.size(); t++) {
+      data[t] = tensors[t].data_ptr<scalar_t>();
+    }
+    const acc_t sum_sq = at::parallel_reduce(0, offsets.back(), internal::GRAIN_SIZE, acc_t(0),
+        [&](int64_t begin, int64_t end, acc_t ident) {
+          acc_t partial = ident;
+          for_each_segment(offsets, begin, end, [&](size_t t, int64_t seg_begin, int64_t seg_end) {
+            partial += map_reduce_all<scalar_t>(
+                [](Vec x) { return x * x; },
+                [](Vec x, Vec y) { return x + y; },
+                data[t] + seg_begin,
+                seg_end - seg_begin);
+          });
+          return partial;
+        },
+        std::plus<acc_t>());
+    result.fill_(std::sqrt(sum_sq));
+  });
+}
+
+} // namespace
+
+REGISTER_DISPATCH(foreach_add_scalar_stub, &foreach_add_scalar_kernel);
+REGISTER_DISPATCH(foreach_mul_scalar_stub, &foreach_mul_scalar_kernel);
+REGISTER_DISPATCH(foreach_add_list_stub, &foreach_add_list_kernel);
+REGISTER_DISPATCH(foreach_mul_list_stub, &foreach_mul_list_kernel);
+REGISTER_DISPATCH(foreach_norm_stub, &foreach_norm_kernel);
+
+}} // namespace at::native
@@ -10,6 +10,7 @@
 
 #include <algorithm>
 #include <cstring>
+#include <memory>
 #include <type_traits>
 
 namespace at { namespace native { namespace {
@@ -952,6 +953,57 @@ Tensor grid_sampler_2d_cpu_kernel_impl(const Tensor& input, const Tensor& grid,
   return output;
 }
 
+// Splits the rows of the grid of every sample among the threads, for the
+// backward with fewer samples than threads, where parallelizing over the batch
+// leaves threads idle. Since the grid locations of different rows can read the
+// same input pixels, each thread scatters into its own zeroed copy of the
+// gradient of the input plane, and the copies are summed into grad_input.
+// `backward_rows(gInp_slice, n, h_begin, h_end)` runs the backward for the
+// grid rows [h_begin, h_end) of sample n, scattering into gInp_slice.
+template<typename scalar_t, typename BackwardFn>
+static inline void grid_sample_2d_backward_split_rows(
+    Tensor& grad_input, int64_t out_H, int64_t grain_size, const BackwardFn& backward_rows) {
+  using Vec = Vec256<scalar_t>;
+  const int64_t N = grad_input.size(0);
+  const int64_t plane_size = grad_input[0].numel();
+  const int max_threads = at::get_num_threads();
+  auto buffer = at::empty({max_threads, grad_input.size(1), grad_input.size(2), grad_input.size(3)},
+                          grad_input.options());
+  auto buffer_acc = buffer.accessor<scalar_t, 4>();
+  std::unique_ptr<bool[]> written(new bool[max_threads]);
+  auto gInp_ptr = grad_input.data_ptr<scalar_t>();
+
+  for (int64_t n = 0; n < N; n++) {
+    std::fill(written.get(), written.get() + max_threads, false);
+    parallel_for(0, out_H, grain_size, [&](int64_t begin, int64_t end) {
+      int thread_num = at::get_thread_num();
+      auto gInp_slice = buffer_acc[thread_num];
+      if (!written[thread_num]) {
+        written[thread_num] = true;
+        std::memset(gInp_slice.data(), 0, sizeof(scalar_t) * plane_size);
+      }
+      backward_rows(gInp_slice, n, begin, end);
+    });
+
+    auto gInp_n_ptr = gInp_ptr + n * plane_size;
+    parallel_for(0, plane_size, at::internal::GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+      for (int thread_num = 0; thread_num < max_threads; thread_num++) {
+        if (!written[thread_num]) {
+          continue;
+        }
+        auto buffer_ptr = buffer_acc[thread_num].data();
+        int64_t i = begin;
+        for (; i + Vec::size() <= end; i += Vec::size()) {
+          (Vec::loadu(gInp_n_ptr + i) + Vec::loadu(buffer_ptr + i)).store(gInp_n_ptr + i);
+        }
+        for (; i < end; i++) {
+          gInp_n_ptr[i] += buffer_ptr[i];
+        }
+      }
+    });
+  }
+}
+
 std::tuple<Tensor, Tensor>
 grid_sampler_2d_backward_cpu_kernel_impl(const Tensor& grad_output_,
                                          const Tensor& input,
@@ -966,30 +1018,63 @@ grid_sampler_2d_backward_cpu_kernel_impl(const Tensor& grad_output_,
   auto grad_input = at::zeros_like(input, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
   auto grad_grid = at::empty_like(grid, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
   auto N = input.size(0);
-  auto spatial_size = grid.size(1) * grid.size(2);
+  auto out_H = grid.size(1);
+  auto out_W = grid.size(2);
+  auto spatial_size = out_H * out_W;
   auto grain_size = spatial_size == 0 ? (N + 1)
                                       : at::divup(at::internal::GRAIN_SIZE, spatial_size * 10 /* 2d * 5 tensors*/);
-
-#define HANDLE_CASE(interp, padding, align_corners)                              \
-  case padding: {                                                                \
-    ApplyGridSample<scalar_t, 2, interp, padding, align_corners>                 \
-    grid_sample(inp_acc);                                                        \
-    parallel_for(0, N, grain_size, [&](int64_t begin, int64_t end) {             \
-      for (int64_t n = begin; n < end; n++) {                                    \
-        auto gInp_slice = gInp_acc[n];                                           \
-        auto gGrid_slice = gGrid_acc[n];                                         \
-        auto gOut_slice = gOut_acc[n];                                           \
-        auto inp_slice = inp_acc[n];                                             \
-        grid_sample_2d_grid_slice_iterator(                                      \
-          grid_acc[n],                                                           \
-          [&](const Vec256<scalar_t>& grid_x, const Vec256<scalar_t>& grid_y,    \
-              int64_t spatial_offset, int64_t len) {                             \
-            grid_sample.backward(gInp_slice, gGrid_slice, gOut_slice, inp_slice, \
-                                 spatial_offset, grid_x, grid_y, len);           \
-          });                                                                    \
-      }                                                                          \
-    });                                                                          \
-    return;                                                                      \
+  // Splitting the rows costs a copy of the input plane per thread to zero and
+  // sum, so it is only worth it when the grid is at least as large as the input.
+  const bool split_rows = N < at::get_num_threads() && out_H > 1 &&
+                          input.size(2) * input.size(3) <= spatial_size;
+  const auto row_grain_size = out_W == 0 ? (out_H + 1)
+                                         : at::divup(at::internal::GRAIN_SIZE, out_W * 10);
+
+  // Runs the backward on the grid rows [h_begin, h_end) of sample n. The
+  // offsets used by ApplyGridSample::backward are relative to the start of the
+  // grid slice, so the slices of grid, grad_grid and grad_output are narrowed
+  // to the rows. Both grad_grid and grad_output are contiguous.
+#define HANDLE_CASE(interp, padding, align_corners)                                     \
+  case padding: {                                                                       \
+    ApplyGridSample<scalar_t, 2, interp, padding, align_corners>                        \
+    grid_sample(inp_acc);                                                               \
+    auto backward_rows = [&](TensorAccessor<scalar_t, 3>& gInp_slice, int64_t n,        \
+                             int64_t h_begin, int64_t h_end) {                          \
+      auto grid_slice = grid_acc[n];                                                    \
+      auto gGrid_slice = gGrid_acc[n];                                                  \
+      auto gOut_slice = gOut_acc[n];                                                    \
+      const int64_t grid_sizes[3] = {h_end - h_begin, out_W, 2};                        \
+      const int64_t gOut_sizes[3] = {gOut_slice.size(0), h_end - h_begin, out_W};       \
+      TensorAccessor<scalar_t, 3> grid_rows(                                            \
+        grid_slice.data() + h_begin * grid_slice.stride(0),                             \
+        grid_sizes, grid_slice.strides().data());                                       \
+      TensorAccessor<scalar_t, 3> gGrid_rows(                                           \
+        gGrid_slice.data() + h_begin * gGrid_slice.stride(0),                           \
+        grid_sizes, gGrid_slice.strides().data());                                      \
+      const TensorAccessor<scalar_t, 3> gOut_rows(                                      \
+        gOut_slice.data() + h_begin * gOut_slice.stride(1),                             \
+        gOut_sizes, gOut_slice.strides().data());                                       \
+      auto inp_slice = inp_acc[n];                                                      \
+      grid_sample_2d_grid_slice_iterator(                                               \
+        grid_rows,                                                                      \
+        [&](const Vec256<scalar_t>& grid_x, const Vec256<scalar_t>& grid_y,             \
+            int64_t spatial_offset, int64_t len) {                                      \
+          grid_sample.backward(gInp_slice, gGrid_rows, gOut_rows, inp_slice,            \
+                               spatial_offset, grid_x, grid_y, len);                    \
+        });                                                                             \
+    };                                                                                  \
+    if (split_rows) {                                                                   \
+      grid_sample_2d_backward_split_rows<scalar_t>(                                     \
+        grad_input, out_H, row_grain_size, backward_rows);                              \
+    } else {                                                                            \
+      parallel_for(0, N, grain_size, [&](int64_t begin, int64_t end) {                  \
+        for (int64_t n = begin; n < end; n++) {                                         \
+          auto gInp_slice = gInp_acc[n];                                                \
+          backward_rows(gInp_slice, n, 0, out_H);                                       \
+        }                                                                               \
+      });                                                                               \
+    }                                                                                   \
+    return;                                                                             \
   }
 
 #define HANDLE_INTERP(interp, align_corners)                                \
@@ -1,7 +1,12 @@
 #include <ATen/native/Indexing.h>
 
+#include <algorithm>
 #include <cmath>
+#include <cstring>
+#include <functional>
 #include <iostream>
+#include <numeric>
+#include <vector>
 #include <ATen/Dispatch.h>
 #include <ATen/native/TensorIterator.h>
 #include <ATen/Parallel.h>
@@ -104,8 +109,9 @@ void index_put_kernel(TensorIterator& iter, IntArrayRef index_size, IntArrayRef
   // NOTE: duplicate indices are only supported if accumulate is true.
   AT_DISPATCH_ALL_TYPES_AND2(at::ScalarType::Half, at::ScalarType::Bool, iter.dtype(), "index_put", [&] {
     if (accumulate) {
-      // TODO: investigate parallelization of the accumulate kernel. Unlike the non-accumulate case,
-      // this needs to be thread-safe.
+      // Serial, since duplicate indices would race. The common case of one
+      // index on the first dimension goes to the parallel
+      // index_put_accum_cpu_kernel instead.
       cpu_index_kernel<scalar_t>(iter, index_size, index_stride, [](char* dst, char* src, int64_t offset) {
         *(scalar_t*)(dst + offset) += *(scalar_t*)src;
       }, /*serial_execution=*/true);
@@ -117,10 +123,315 @@ void index_put_kernel(TensorIterator& iter, IntArrayRef index_size, IntArrayRef
   });
 }
 
+// dst[i] += src[i] for i < n
+template <typename scalar_t>
+inline void add_row(scalar_t* dst, const scalar_t* src, int64_t n) {
+  using Vec = Vec256<scalar_t>;
+  int64_t i = 0;
+  for (; i + Vec::size() <= n; i += Vec::size()) {
+    (Vec::loadu(dst + i) + Vec::loadu(src + i)).store(dst + i);
+  }
+  for (; i < n; i++) {
+    dst[i] += src[i];
+  }
+}
+
+// Note [Parallel index_put_ with accumulate]
+// The rows of self are split into one contiguous range per thread, and the
+// indices are bucketed by the range of their row with a stable counting sort,
+// which runs in parallel over chunks of the indices too. Each thread then adds
+// the values of its bucket to its own rows, so no two threads write the same
+// row, and every row gets its values added in the order of the indices, as by
+// the serial kernel: the results are deterministic, and the same as serial.
+template <typename scalar_t>
+void index_put_accum_rows(
+    scalar_t* self_data,
+    int64_t num_rows,
+    int64_t row_size,
+    const int64_t* index,
+    int64_t num_indices,
+    const scalar_t* values,
+    int64_t values_row_stride) {
+  auto wrap_index = [&](int64_t i) {
+    int64_t row = index[i];
+    if (row < -num_rows || row >= num_rows) {
+      AT_INDEX_ERROR("index ", row, " is out of bounds for dimension 0 with size ", num_rows);
+    }
+    return row < 0 ? row + num_rows : row;
+  };
+
+  const int64_t num_buckets = std::min<int64_t>(at::get_num_threads(), num_rows);
+  if (num_buckets == 1 || num_indices * row_size < at::internal::GRAIN_SIZE) {
+    for (int64_t i = 0; i < num_indices; i++) {
+      add_row(self_data + wrap_index(i) * row_size, values + i * values_row_stride, row_size);
+    }
+    return;
+  }
+  auto bucket_of = [&](int64_t row) {
+    return row * num_buckets / num_rows;
+  };
+
+  // counts[c * num_buckets + b] is the number of indices of chunk c in the
+  // bucket b, and then where the first of them goes in sorted
+  const int64_t num_chunks = num_buckets;
+  const int64_t chunk_size = (num_indices + num_chunks - 1) / num_chunks;
+  std::vector<int64_t> counts(num_chunks * num_buckets, 0);
+  std::vector<int64_t> rows(num_indices);
+  at::parallel_for(0, num_chunks, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t c = begin; c < end; c++) {
+      int64_t* chunk_counts = counts.data() + c * num_buckets;
+      for (int64_t i = c * chunk_size; i < std::min(num_indices, (c + 1) * chunk_size); i++) {
+        rows[i] = wrap_index(i);
+        chunk_counts[bucket_of(rows[i])]++;
+      }
+    }
+  });
+  std::vector<int64_t> bucket_begin(num_buckets + 1);
+  int64_t position = 0;
+  for (int64_t b = 0; b < num_buckets; b++) {
+    bucket_begin[b] = position;
+    for (int64_t c = 0; c < num_chunks; c++) {
+      const int64_t count = counts[c * num_buckets + b];
+      counts[c * num_buckets + b] = position;
+      position += count;
+    }
+  }
+  bucket_begin[num_buckets] = position;
+  std::vector<int64_t> sorted(num_indices);
+  at::parallel_for(0, num_chunks, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t c = begin; c < end; c++) {
+      int64_t* next = counts.data() + c * num_buckets;
+      for (int64_t i = c * chunk_size; i < std::min(num_indices, (c + 1) * chunk_size); i++) {
+        sorted[next[bucket_of(rows[i])]++] = i;
+      }
+    }
+  });
+
+  at::parallel_for(0, num_buckets, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t b = begin; b < end; b++) {
+      for (int64_t k = bucket_begin[b]; k < bucket_begin[b + 1]; k++) {
+        const int64_t i = sorted[k];
+        add_row(self_data + rows[i] * row_size, values + i * values_row_stride, row_size);
+      }
+    }
+  });
+}
+
+// Only called for one long index vector on the first dimension of a
+// contiguous self, see can_use_index_put_accum_cpu
+void index_put_accum_cpu_kernel(Tensor& self, TensorList indices, const Tensor& value, bool unsafe) {
+  const Tensor index = indices[0].contiguous();
+  if (index.numel() == 0) {
+    return;
+  }
+  auto shape = self.sizes().vec();
+  shape[0] = index.numel();
+  Tensor values = value.expand(shape);
+  if (!values[0].is_contiguous()) {
+    values = values.contiguous();
+  }
+  const int64_t num_rows = self.size(0);
+  const int64_t row_size = num_rows == 0 ? 0 : self.numel() / num_rows;
+  AT_DISPATCH_ALL_TYPES(self.scalar_type(), "index_put_accum_cpu", [&] {
+    index_put_accum_rows<scalar_t>(
+        self.data_ptr<scalar_t>(),
+        num_rows,
+        row_size,
+        index.data_ptr<int64_t>(),
+        index.numel(),
+        values.data_ptr<scalar_t>(),
+        values.stride(0));
+  });
+}
+
+inline void prefetch(const void* ptr) {
+#if defined(__GNUC__) || defined(__clang__)
+  __builtin_prefetch(ptr);
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+  _mm_prefetch(static_cast<const char*>(ptr), _MM_HINT_T0);
+#endif
+}
+
+// How many elements ahead gather prefetches the source of, which covers the
+// latency of a miss to memory at a few cycles per element
+constexpr int64_t kGatherPrefetchDistance = 16;
+
+// Calls f(index_offset, self_offset, src_offset) in parallel for every
+// position of index apart from dim, with the offsets of the position in the
+// tensors, which all have the dimensions of index; f loops over dim.
+template <typename func_t>
+void cpu_scatter_gather_positions(
+    const Tensor& self, int64_t dim, const Tensor& index, const Tensor& src,
+    const func_t& f) {
+  const int64_t ndim = index.dim();
+  const int64_t dim_size = index.size(dim);
+  std::vector<int64_t> outer_sizes, self_strides, index_strides, src_strides;
+  for (int64_t d = 0; d < ndim; d++) {
+    if (d != dim) {
+      outer_sizes.push_back(index.size(d));
+      self_strides.push_back(self.stride(d));
+      index_strides.push_back(index.stride(d));
+      src_strides.push_back(src.stride(d));
+    }
+  }
+  const int64_t num_outer = outer_sizes.size();
+  const int64_t num_positions = index.numel() / dim_size;
+  const int64_t grain_size = std::max<int64_t>(1, at::internal::GRAIN_SIZE / dim_size);
+  at::parallel_for(0, num_positions, grain_size, [&](int64_t begin, int64_t end) {
+    std::vector<int64_t> coord(num_outer);
+    int64_t rest = begin;
+    for (int64_t d = num_outer - 1; d >= 0; d--) {
+      coord[d] = rest % outer_sizes[d];
+      rest /= outer_sizes[d];
+    }
+    for (int64_t position = begin; position < end; position++) {
+      int64_t self_offset = 0, index_offset = 0, src_offset = 0;
+      for (int64_t d = 0; d < num_outer; d++) {
+        self_offset += coord[d] * self_strides[d];
+        index_offset += coord[d] * index_strides[d];
+        src_offset += coord[d] * src_strides[d];
+      }
+      f(index_offset, self_offset, src_offset);
+      for (int64_t d = num_outer - 1; d >= 0; d--) {
+        if (++coord[d] < outer_sizes[d]) {
+          break;
+        }
+        coord[d] = 0;
+      }
+    }
+  });
+}
+
+// Each position of index apart from dim scatters into its own column of self
+// along dim, so the positions run in parallel without conflicts, and each
+// column gets its values added in the order of dim, as by the TH kernel.
+void scatter_add_cpu_kernel(Tensor& self, int64_t dim, const Tensor& index, const Tensor& src) {
+  const int64_t dim_size = index.size(dim);
+  const int64_t self_dim_size = self.size(dim);
+  const int64_t self_dim_stride = self.stride(dim);
+  const int64_t index_dim_stride = index.stride(dim);
+  const int64_t src_dim_stride = src.stride(dim);
+  AT_DISPATCH_ALL_TYPES_AND(at::ScalarType::Bool, self.scalar_type(), "scatter_add_cpu", [&] {
+    scalar_t* self_data = self.data_ptr<scalar_t>();
+    const scalar_t* src_data = src.data_ptr<scalar_t>();
+    const int64_t* index_data = index.data_ptr<int64_t>();
+    cpu_scatter_gather_positions(self, dim, index, src,
+        [&](int64_t index_offset, int64_t self_offset, int64_t src_offset) {
+      for (int64_t i = 0; i < dim_size; i++) {
+        const int64_t idx = index_data[index_offset + i * index_dim_stride];
+        TORCH_CHECK(idx >= 0 && idx < self_dim_size, "Invalid index in scatterAdd");
+        self_data[self_offset + idx * self_dim_stride] += src_data[src_offset + i * src_dim_stride];
+      }
+    });
+  });
+}
+
+// result takes the shape of index. The reads of src along dim are random
+// access, so they are prefetched kGatherPrefetchDistance elements ahead.
+void gather_cpu_kernel(Tensor& result, const Tensor& self, int64_t dim, const Tensor& index) {
+  const int64_t dim_size = index.size(dim);
+  const int64_t self_dim_size = self.size(dim);
+  const int64_t result_dim_stride = result.stride(dim);
+  const int64_t self_dim_stride = self.stride(dim);
+  const int64_t index_dim_stride = index.stride(dim);
+  AT_DISPATCH_ALL_TYPES_AND2(at::ScalarType::Bool, at::ScalarType::Half, self.scalar_type(), "gather_cpu", [&] {
+    scalar_t* result_data = result.data_ptr<scalar_t>();
+    const scalar_t* self_data = self.data_ptr<scalar_t>();
+    const int64_t* index_data = index.data_ptr<int64_t>();
+    cpu_scatter_gather_positions(result, dim, index, self,
+        [&](int64_t index_offset, int64_t result_offset, int64_t self_offset) {
+      const int64_t* position_index = index_data + index_offset;
+      for (int64_t i = 0; i < dim_size; i++) {
+        if (i + kGatherPrefetchDistance < dim_size) {
+          const int64_t ahead = position_index[(i + kGatherPrefetchDistance) * index_dim_stride];
+          if (ahead >= 0 && ahead < self_dim_size) {
+            prefetch(self_data + self_offset + ahead * self_dim_stride);
+          }
+        }
+        const int64_t idx = position_index[i * index_dim_stride];
+        TORCH_CHECK(idx >= 0 && idx < self_dim_size, "Invalid index in gather");
+        result_data[result_offset + i * result_dim_stride] =
+            self_data[self_offset + idx * self_dim_stride];
+      }
+    });
+  });
+}
+
+// self and result are contiguous, so they are [outer, size, row] and
+// [outer, numel, row] with rows of row_bytes bytes, and result copies the rows
+// of self the indices pick. Sorted indices often pick runs of consecutive
+// rows, which are copied at once; the rows of the other indices are random
+// access, so they are prefetched ahead.
+template <typename row_t>
+void index_select_rows(
+    char* result_data, const char* self_data, const int64_t* index_data,
+    int64_t outer, int64_t size, int64_t numel, int64_t row_bytes) {
+  const int64_t grain_size = std::max<int64_t>(1, at::internal::GRAIN_SIZE / row_bytes);
+  at::parallel_for(0, outer * numel, grain_size, [&](int64_t begin, int64_t end) {
+    int64_t j = begin;
+    while (j < end) {
+      const int64_t o = j / numel;
+      const int64_t i = j % numel;
+      const char* self_outer = self_data + o * size * row_bytes;
+      // A run stops at the end of the indices of this outer slice
+      const int64_t last = std::min(end - j, numel - i);
+      int64_t run = 1;
+      while (run < last && index_data[i + run] == index_data[i + run - 1] + 1) {
+        run++;
+      }
+      if (i + run + kGatherPrefetchDistance < numel) {
+        prefetch(self_outer + index_data[i + run + kGatherPrefetchDistance] * row_bytes);
+      }
+      char* dst = result_data + j * row_bytes;
+      const char* src = self_outer + index_data[i] * row_bytes;
+      if (run == 1 && sizeof(row_t) == row_bytes) {
+        *reinterpret_cast<row_t*>(dst) = *reinterpret_cast<const row_t*>(src);
+      } else {
+        std::memcpy(dst, src, run * row_bytes);
+      }
+      j += run;
+    }
+  });
+}
+
+void index_select_cpu_kernel(Tensor& result, const Tensor& self, int64_t dim, const Tensor& index) {
+  // The strides of contiguous tensors are arbitrary in dimensions of size 1,
+  // so the shape is computed from the sizes
+  const auto sizes = self.sizes();
+  const int64_t outer = std::accumulate(
+      sizes.begin(), sizes.begin() + dim, int64_t{1}, std::multiplies<int64_t>());
+  const int64_t row = std::accumulate(
+      sizes.begin() + dim + 1, sizes.end(), int64_t{1}, std::multiplies<int64_t>());
+  const int64_t row_bytes = row * self.element_size();
+  const int64_t size = self.size(dim);
+  const int64_t numel = index.numel();
+  char* result_data = static_cast<char*>(result.data_ptr());
+  const char* self_data = static_cast<const char*>(self.data_ptr());
+  const int64_t* index_data = index.data_ptr<int64_t>();
+  // Rows of one element of up to 8 bytes are copied as a single word
+  switch (row_bytes) {
+    case 1:
+      index_select_rows<uint8_t>(result_data, self_data, index_data, outer, size, numel, row_bytes);
+      break;
+    case 2:
+      index_select_rows<uint16_t>(result_data, self_data, index_data, outer, size, numel, row_bytes);
+      break;
+    case 4:
+      index_select_rows<uint32_t>(result_data, self_data, index_data, outer, size, numel, row_bytes);
+      break;
+    default:
+      index_select_rows<uint64_t>(result_data, self_data, index_data, outer, size, numel, row_bytes);
+  }
+}
+
 } // anonymous namespace
 
 
 REGISTER_DISPATCH(index_stub, &index_kernel);
 REGISTER_DISPATCH(index_put_stub, &index_put_kernel);
+REGISTER_DISPATCH(index_put_accum_stub, &index_put_accum_cpu_kernel);
+REGISTER_DISPATCH(scatter_add_stub, &scatter_add_cpu_kernel);
+REGISTER_DISPATCH(gather_stub, &gather_cpu_kernel);
+REGISTER_DISPATCH(index_select_stub, &index_select_cpu_kernel);
 
 }} // namespace at::native
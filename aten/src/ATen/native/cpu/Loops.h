@@ -22,6 +22,10 @@
 //     [](float a, float b) { return a * b; },
 //     [](Vec256<float> a, Vec256<float> b) { return a * b; });
 //
+// The vector width is taken from the vectorized lambda, so it may also take
+// Vec512 arguments (or vec512::Vectorized, which is Vec512 in the AVX512
+// build of a kernel and Vec256 otherwise).
+//
 // See BinaryOpsKernel.cpp for the complete implementation
 //
 //
@@ -32,6 +36,7 @@
 #include <ATen/native/cpu/IsContiguous.h>
 #include <ATen/native/TensorIterator.h>
 #include <ATen/cpu/vec256/vec256.h>
+#include <ATen/cpu/vec512/vec512.h>
 
 #ifndef _MSC_VER
 #pragma GCC diagnostic push
@@ -41,6 +46,7 @@
 namespace at { namespace native { namespace {
 
 using namespace vec256;
+using namespace vec512;
 
 template <typename traits, std::size_t... INDEX>
 typename traits::ArgsTuple
@@ -135,7 +141,7 @@ static inline void
 vectorized_loop(char** C10_RESTRICT data_, int64_t n, int64_t S, func_t op, vec_func_t vop) {
   using traits = function_traits<vec_func_t>;
   using scalar_t = typename function_traits<func_t>::result_type;
-  using Vec = Vec256<scalar_t>;
+  using Vec = typename traits::result_type;
   constexpr int ntensors = traits::arity + 1;
 
   char* C10_RESTRICT data[ntensors];
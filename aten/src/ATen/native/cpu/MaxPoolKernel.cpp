@@ -0,0 +1,138 @@
+#include <ATen/ATen.h>
+
+#include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
+#include <ATen/native/Pool.h>
+
+#include <cmath>
+#include <limits>
+
+namespace at { namespace native {
+
+namespace {
+
+template <typename scalar_t>
+void cpu_max_pool2d_channels_last(
+    Tensor& output,
+    Tensor& indices,
+    const Tensor& input,
+    int kW, int kH,
+    int dW, int dH,
+    int padW, int padH,
+    int dilationW, int dilationH) {
+  const int64_t nbatch = input.size(0);
+  const int64_t channels = input.size(1);
+  const int64_t input_height = input.size(2);
+  const int64_t input_width = input.size(3);
+  const int64_t output_height = output.size(2);
+  const int64_t output_width = output.size(3);
+
+  const scalar_t* input_data = input.data_ptr<scalar_t>();
+  scalar_t* output_data = output.data_ptr<scalar_t>();
+  int64_t* indices_data = indices.data_ptr<int64_t>();
+
+  // Every output pixel owns a contiguous row of `channels` values and
+  // indices, so the window is walked once and each input pixel updates the
+  // whole row. Keep the inner loop over channels free of function calls
+  // so that it gets vectorized for the capability this file is compiled for.
+  const int64_t grain_size = std::max<int64_t>(1, at::internal::GRAIN_SIZE / (channels * kH * kW));
+  at::parallel_for(0, nbatch * output_height * output_width, grain_size, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; i++) {
+      const int64_t n = i / (output_height * output_width);
+      const int64_t oh = (i / output_width) % output_height;
+      const int64_t ow = i % output_width;
+
+      int64_t hstart = oh * dH - padH;
+      int64_t wstart = ow * dW - padW;
+      const int64_t hend = std::min(hstart + (kH - 1) * dilationH + 1, input_height);
+      const int64_t wend = std::min(wstart + (kW - 1) * dilationW + 1, input_width);
+      while (hstart < 0)
+        hstart += dilationH;
+      while (wstart < 0)
+        wstart += dilationW;
+
+      scalar_t* out = output_data + i * channels;
+      int64_t* ind = indices_data + i * channels;
+      const int64_t start_index = hstart * input_width + wstart;
+      for (int64_t c = 0; c < channels; c++) {
+        out[c] = -std::numeric_limits<scalar_t>::infinity();
+        ind[c] = start_index;
+      }
+
+      for (int64_t y = hstart; y < hend; y += dilationH) {
+        for (int64_t x = wstart; x < wend; x += dilationW) {
+          const int64_t index = y * input_width + x;
+          const scalar_t* in = input_data + (n * input_height * input_width + index) * channels;
+          for (int64_t c = 0; c < channels; c++) {
+            const scalar_t val = in[c];
+            if ((val > out[c]) || std::isnan(val)) {
+              out[c] = val;
+              ind[c] = index;
+            }
+          }
+        }
+      }
+    }
+  });
+}
+
+template <typename scalar_t>
+void cpu_max_pool2d_backward_channels_last(
+    Tensor& grad_input,
+    const Tensor& grad_output,
+    const Tensor& indices) {
+  const int64_t nbatch = grad_input.size(0);
+  const int64_t channels = grad_input.size(1);
+  const int64_t input_image_size = grad_input.size(2) * grad_input.size(3);
+  const int64_t output_image_size = grad_output.size(2) * grad_output.size(3);
+
+  scalar_t* grad_input_data = grad_input.data_ptr<scalar_t>();
+  const scalar_t* grad_output_data = grad_output.data_ptr<scalar_t>();
+  const int64_t* indices_data = indices.data_ptr<int64_t>();
+
+  // Overlapping windows scatter into the same input pixel, so only the
+  // batch dimension is parallelized.
+  at::parallel_for(0, nbatch, 0, [&](int64_t begin, int64_t end) {
+    for (int64_t n = begin; n < end; n++) {
+      scalar_t* gin = grad_input_data + n * input_image_size * channels;
+      for (int64_t i = 0; i < output_image_size; i++) {
+        const int64_t offset = (n * output_image_size + i) * channels;
+        const scalar_t* gout = grad_output_data + offset;
+        const int64_t* ind = indices_data + offset;
+        for (int64_t c = 0; c < channels; c++) {
+          gin[ind[c] * channels + c] += gout[c];
+        }
+      }
+    }
+  });
+}
+
+void max_pool2d_channels_last_kernel_impl(
+    Tensor& output,
+    Tensor& indices,
+    const Tensor& input,
+    int kW, int kH,
+    int dW, int dH,
+    int padW, int padH,
+    int dilationW, int dilationH) {
+  AT_DISPATCH_FLOATING_TYPES(input.scalar_type(), "max_pool2d_channels_last", [&] {
+    cpu_max_pool2d_channels_last<scalar_t>(
+        output, indices, input, kW, kH, dW, dH, padW, padH, dilationW, dilationH);
+  });
+}
+
+void max_pool2d_backward_channels_last_kernel_impl(
+    Tensor& grad_input,
+    const Tensor& grad_output,
+    const Tensor& indices) {
+  AT_DISPATCH_FLOATING_TYPES(grad_output.scalar_type(), "max_pool2d_backward_channels_last", [&] {
+    cpu_max_pool2d_backward_channels_last<scalar_t>(grad_input, grad_output, indices);
+  });
+}
+
+} // namespace
+
+REGISTER_DISPATCH(max_pool2d_channels_last_kernel, &max_pool2d_channels_last_kernel_impl);
+REGISTER_DISPATCH(max_pool2d_backward_channels_last_kernel, &max_pool2d_backward_channels_last_kernel_impl);
+
+}} // namespace at::native
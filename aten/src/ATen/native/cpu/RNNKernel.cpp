@@ -0,0 +1,109 @@
+#include <ATen/native/RNN.h>
+
+#include <ATen/ATen.h>
+#include <ATen/Parallel.h>
+#include <ATen/cpu/vec256/vec256.h>
+
+#include <algorithm>
+
+namespace at { namespace native {
+
+namespace {
+
+using namespace vec256;
+using Vec = Vec256<float>;
+
+inline Vec sigmoid(const Vec& x) {
+  return (Vec(1.0f) + x.neg().exp()).reciprocal();
+}
+
+// The gates of every batch row are laid out as consecutive chunks of
+// hidden_size values, in the order used by the unfused cells in RNN.cpp.
+// Loads of the last partial vector are padded, and the padding lanes are
+// never stored.
+void lstm_cell_pointwise_kernel(
+    Tensor& hy,
+    Tensor& cy,
+    const Tensor& igates_,
+    const Tensor& hgates_,
+    const Tensor& cx_) {
+  const Tensor igates = igates_.contiguous();
+  const Tensor hgates = hgates_.contiguous();
+  const Tensor cx = cx_.contiguous();
+  const int64_t batch_size = cx.size(0);
+  const int64_t hidden_size = cx.size(1);
+
+  const float* ig_data = igates.data_ptr<float>();
+  const float* hg_data = hgates.data_ptr<float>();
+  const float* cx_data = cx.data_ptr<float>();
+  float* hy_data = hy.data_ptr<float>();
+  float* cy_data = cy.data_ptr<float>();
+
+  const int64_t grain_size = std::max<int64_t>(1, at::internal::GRAIN_SIZE / (8 * hidden_size));
+  at::parallel_for(0, batch_size, grain_size, [&](int64_t begin, int64_t end) {
+    for (int64_t b = begin; b < end; b++) {
+      const float* ig = ig_data + b * 4 * hidden_size;
+      const float* hg = hg_data + b * 4 * hidden_size;
+      const float* c = cx_data + b * hidden_size;
+      float* h_out = hy_data + b * hidden_size;
+      float* c_out = cy_data + b * hidden_size;
+      for (int64_t j = 0; j < hidden_size; j += Vec::size()) {
+        const int64_t count = std::min<int64_t>(Vec::size(), hidden_size - j);
+        auto gate = [&](int64_t chunk) {
+          const int64_t offset = chunk * hidden_size + j;
+          return Vec::loadu(ig + offset, count) + Vec::loadu(hg + offset, count);
+        };
+        const Vec ingate = sigmoid(gate(0));
+        const Vec forgetgate = sigmoid(gate(1));
+        const Vec cellgate = gate(2).tanh();
+        const Vec outgate = sigmoid(gate(3));
+        const Vec c_new = forgetgate * Vec::loadu(c + j, count) + ingate * cellgate;
+        c_new.store(c_out + j, count);
+        (outgate * c_new.tanh()).store(h_out + j, count);
+      }
+    }
+  });
+}
+
+void gru_cell_pointwise_kernel(
+    Tensor& hy,
+    const Tensor& igates_,
+    const Tensor& hgates_,
+    const Tensor& hx_) {
+  const Tensor igates = igates_.contiguous();
+  const Tensor hgates = hgates_.contiguous();
+  const Tensor hx = hx_.contiguous();
+  const int64_t batch_size = hx.size(0);
+  const int64_t hidden_size = hx.size(1);
+
+  const float* ig_data = igates.data_ptr<float>();
+  const float* hg_data = hgates.data_ptr<float>();
+  const float* hx_data = hx.data_ptr<float>();
+  float* hy_data = hy.data_ptr<float>();
+
+  const int64_t grain_size = std::max<int64_t>(1, at::internal::GRAIN_SIZE / (6 * hidden_size));
+  at::parallel_for(0, batch_size, grain_size, [&](int64_t begin, int64_t end) {
+    for (int64_t b = begin; b < end; b++) {
+      const float* ig = ig_data + b * 3 * hidden_size;
+      const float* hg = hg_data + b * 3 * hidden_size;
+      const float* h = hx_data + b * hidden_size;
+      float* h_out = hy_data + b * hidden_size;
+      for (int64_t j = 0; j < hidden_size; j += Vec::size()) {
+        const int64_t count = std::min<int64_t>(Vec::size(), hidden_size - j);
+        const Vec reset_gate = sigmoid(Vec::loadu(ig + j, count) + Vec::loadu(hg + j, count));
+        const Vec input_gate = sigmoid(
+            Vec::loadu(ig + hidden_size + j, count) + Vec::loadu(hg + hidden_size + j, count));
+        const Vec new_gate = (Vec::loadu(ig + 2 * hidden_size + j, count) +
+            reset_gate * Vec::loadu(hg + 2 * hidden_size + j, count)).tanh();
+        ((Vec::loadu(h + j, count) - new_gate) * input_gate + new_gate).store(h_out + j, count);
+      }
+    }
+  });
+}
+
+} // namespace
+
+REGISTER_DISPATCH(lstm_cell_pointwise_stub, &lstm_cell_pointwise_kernel);
+REGISTER_DISPATCH(gru_cell_pointwise_stub, &gru_cell_pointwise_kernel);
+
+}} // namespace at::native
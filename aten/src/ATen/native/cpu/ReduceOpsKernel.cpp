@@ -5,6 +5,7 @@
 
 #include <ATen/Dispatch.h>
 #include <ATen/cpu/vec256/vec256.h>
+#include <ATen/cpu/vec512/vec512.h>
 #include <ATen/native/ReduceOps.h>
 #include <ATen/native/TensorIterator.h>
 #include <ATen/native/SharedReduceOps.h>
@@ -14,13 +15,35 @@
 namespace at { namespace native { namespace {
 
 using namespace vec256;
+using namespace vec512;
+
+// BFloat16 only keeps 8 bits of mantissa, so a running BFloat16 sum stops
+// growing once it is 2^8 times the elements added to it. Its sums are
+// accumulated in float and rounded once.
+struct BFloat16SumOps {
+  inline float reduce(float acc, BFloat16 data, int64_t /*idx*/) const {
+    return acc + static_cast<float>(data);
+  }
+
+  inline float combine(float a, float b) const {
+    return a + b;
+  }
+
+  inline BFloat16 project(float acc) const {
+    return acc;
+  }
+};
 
 static void sum_kernel_impl(TensorIterator& iter) {
-  AT_DISPATCH_ALL_TYPES_AND_COMPLEX_AND2(
-      ScalarType::BFloat16, ScalarType::Bool, iter.dtype(), "sum_cpu", [&] {
+  if (iter.dtype() == ScalarType::BFloat16) {
+    binary_kernel_reduce(iter, BFloat16SumOps(), 0.f);
+    return;
+  }
+  AT_DISPATCH_ALL_TYPES_AND_COMPLEX_AND(
+      ScalarType::Bool, iter.dtype(), "sum_cpu", [&] {
         binary_kernel_reduce_vec(
             iter, [=](scalar_t a, scalar_t b) -> scalar_t { return a + b; },
-            [=](Vec256<scalar_t> a, Vec256<scalar_t> b) { return a + b; });
+            [=](Vectorized<scalar_t> a, Vectorized<scalar_t> b) { return a + b; });
       });
 }
 
@@ -50,7 +73,7 @@ static void prod_kernel_impl(TensorIterator& iter) {
     binary_kernel_reduce_vec(
       iter,
       [=](scalar_t a, scalar_t b) -> scalar_t { return a * b; },
-      [=](Vec256<scalar_t> a, Vec256<scalar_t> b) { return a * b; },
+      [=](Vectorized<scalar_t> a, Vectorized<scalar_t> b) { return a * b; },
       /*identity=*/1);
   });
 }
@@ -154,7 +177,7 @@ static void min_values_kernel_impl(TensorIterator& iter) {
     binary_kernel_reduce_vec(
       iter,
       [](scalar_t a, scalar_t b) -> scalar_t { return min_impl(a, b); },
-      [](Vec256<scalar_t> a, Vec256<scalar_t> b) { return minimum(a, b); });
+      [](Vectorized<scalar_t> a, Vectorized<scalar_t> b) { return minimum(a, b); });
   });
 }
 
@@ -163,7 +186,7 @@ static void max_values_kernel_impl(TensorIterator& iter) {
     binary_kernel_reduce_vec(
       iter,
       [](scalar_t a, scalar_t b) -> scalar_t { return max_impl(a, b); },
-      [](Vec256<scalar_t> a, Vec256<scalar_t> b) { return maximum(a, b); });
+      [](Vectorized<scalar_t> a, Vectorized<scalar_t> b) { return maximum(a, b); });
   });
 }
 
@@ -199,6 +222,26 @@ static void argmin_kernel_impl(TensorIterator &iter) {
   });
 }
 
+// The minimum and the maximum, reading the input once
+static void aminmax_kernel_impl(TensorIterator &iter) {
+  AT_DISPATCH_ALL_TYPES(iter.dtype(), "aminmax_cpu", [&] {
+    binary_kernel_reduce(
+      iter,
+      MultiReduceOps<MinOps<scalar_t>, MaxOps<scalar_t>>{},
+      std::make_tuple(upper_bound<scalar_t>(), lower_bound<scalar_t>()));
+  });
+}
+
+// The sum and the sum of squares, reading the input once
+static void sum_sumsq_kernel_impl(TensorIterator &iter) {
+  AT_DISPATCH_FLOATING_TYPES(iter.dtype(), "sum_sumsq_cpu", [&] {
+    binary_kernel_reduce(
+      iter,
+      MultiReduceOps<SumOps<scalar_t, double>, SquareSumOps<scalar_t, double>>{},
+      std::make_tuple(0., 0.));
+  });
+}
+
 }  // anonymous namespace
 
 REGISTER_DISPATCH(sum_stub, &sum_kernel_impl);
@@ -212,5 +255,7 @@ REGISTER_DISPATCH(min_values_stub, &min_values_kernel_impl);
 REGISTER_DISPATCH(max_values_stub, &max_values_kernel_impl);
 REGISTER_DISPATCH(argmax_stub, &argmax_kernel_impl);
 REGISTER_DISPATCH(argmin_stub, &argmin_kernel_impl);
+REGISTER_DISPATCH(aminmax_stub, &aminmax_kernel_impl);
+REGISTER_DISPATCH(sum_sumsq_stub, &sum_sumsq_kernel_impl);
 
 }}  // namespace at::native
@@ -0,0 +1,177 @@
+#include <ATen/ATen.h>
+
+#include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
+#include <ATen/cpu/vec512/vec512.h>
+#include <ATen/native/SegmentReduce.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace at { namespace native {
+
+namespace {
+
+using namespace vec512;
+
+template <typename scalar_t>
+void cpu_segment_reduce(
+    Tensor& output,
+    Tensor& arg_max,
+    const Tensor& data,
+    const Tensor& offsets,
+    int64_t reduce) {
+  using Vec = Vectorized<scalar_t>;
+  const int64_t num_segments = offsets.numel() - 1;
+  const int64_t inner = output.numel() / num_segments;
+  const int64_t num_rows = data.size(0);
+
+  const scalar_t* data_data = data.data_ptr<scalar_t>();
+  const int64_t* offsets_data = offsets.data_ptr<int64_t>();
+  scalar_t* output_data = output.data_ptr<scalar_t>();
+  int64_t* arg_max_data = reduce == SEGMENT_MAX ? arg_max.data_ptr<int64_t>() : nullptr;
+
+  // Segments are independent, so they are split across threads; within a
+  // segment the rows are accumulated into the output row, which stays in
+  // cache.
+  const int64_t vec_end = inner - (inner % Vec::size());
+  const int64_t work_per_segment = std::max<int64_t>(1, inner * num_rows / num_segments);
+  const int64_t grain_size = std::max<int64_t>(1, at::internal::GRAIN_SIZE / work_per_segment);
+  at::parallel_for(0, num_segments, grain_size, [&](int64_t begin, int64_t end) {
+    for (int64_t s = begin; s < end; s++) {
+      const int64_t row_begin = offsets_data[s];
+      const int64_t row_end = offsets_data[s + 1];
+      scalar_t* out = output_data + s * inner;
+
+      if (reduce == SEGMENT_MAX) {
+        int64_t* am = arg_max_data + s * inner;
+        if (row_begin == row_end) {
+          std::fill(out, out + inner, scalar_t(0));
+          std::fill(am, am + inner, -1);
+          continue;
+        }
+        const scalar_t* first = data_data + row_begin * inner;
+        for (int64_t d = 0; d < inner; d++) {
+          out[d] = first[d];
+          am[d] = row_begin;
+        }
+        for (int64_t r = row_begin + 1; r < row_end; r++) {
+          const scalar_t* in = data_data + r * inner;
+          for (int64_t d = 0; d < inner; d++) {
+            const scalar_t val = in[d];
+            if ((val > out[d]) || std::isnan(val)) {
+              out[d] = val;
+              am[d] = r;
+            }
+          }
+        }
+        continue;
+      }
+
+      std::fill(out, out + inner, scalar_t(0));
+      for (int64_t r = row_begin; r < row_end; r++) {
+        const scalar_t* in = data_data + r * inner;
+        int64_t d = 0;
+        for (; d < vec_end; d += Vec::size()) {
+          (Vec::loadu(out + d) + Vec::loadu(in + d)).store(out + d);
+        }
+        for (; d < inner; d++) {
+          out[d] += in[d];
+        }
+      }
+      if (reduce == SEGMENT_MEAN && row_end > row_begin) {
+        const scalar_t scale = scalar_t(1) / (row_end - row_begin);
+        int64_t d = 0;
+        for (; d < vec_end; d += Vec::size()) {
+          (Vec::loadu(out + d) * Vec(scale)).store(out + d);
+        }
+        for (; d < inner; d++) {
+          out[d] *= scale;
+        }
+      }
+    }
+  });
+}
+
+template <typename scalar_t>
+void cpu_segment_reduce_backward(
+    Tensor& grad_input,
+    const Tensor& grad,
+    const Tensor& offsets,
+    const Tensor& arg_max,
+    int64_t reduce) {
+  using Vec = Vectorized<scalar_t>;
+  const int64_t num_segments = offsets.numel() - 1;
+  const int64_t inner = grad.numel() / num_segments;
+  const int64_t num_rows = grad_input.size(0);
+
+  scalar_t* grad_input_data = grad_input.data_ptr<scalar_t>();
+  const scalar_t* grad_data = grad.data_ptr<scalar_t>();
+  const int64_t* offsets_data = offsets.data_ptr<int64_t>();
+  const int64_t* arg_max_data = reduce == SEGMENT_MAX ? arg_max.data_ptr<int64_t>() : nullptr;
+
+  // Every row of grad_input belongs to exactly one segment, so the segments
+  // can be written in parallel without synchronization.
+  const int64_t vec_end = inner - (inner % Vec::size());
+  const int64_t work_per_segment = std::max<int64_t>(1, inner * num_rows / num_segments);
+  const int64_t grain_size = std::max<int64_t>(1, at::internal::GRAIN_SIZE / work_per_segment);
+  at::parallel_for(0, num_segments, grain_size, [&](int64_t begin, int64_t end) {
+    for (int64_t s = begin; s < end; s++) {
+      const int64_t row_begin = offsets_data[s];
+      const int64_t row_end = offsets_data[s + 1];
+      const scalar_t* gout = grad_data + s * inner;
+
+      if (reduce == SEGMENT_MAX) {
+        const int64_t* am = arg_max_data + s * inner;
+        for (int64_t d = 0; d < inner; d++) {
+          if (am[d] >= 0) {
+            grad_input_data[am[d] * inner + d] = gout[d];
+          }
+        }
+        continue;
+      }
+
+      const scalar_t scale = reduce == SEGMENT_MEAN && row_end > row_begin
+          ? scalar_t(1) / (row_end - row_begin) : scalar_t(1);
+      for (int64_t r = row_begin; r < row_end; r++) {
+        scalar_t* gin = grad_input_data + r * inner;
+        int64_t d = 0;
+        for (; d < vec_end; d += Vec::size()) {
+          (Vec::loadu(gout + d) * Vec(scale)).store(gin + d);
+        }
+        for (; d < inner; d++) {
+          gin[d] = gout[d] * scale;
+        }
+      }
+    }
+  });
+}
+
+void segment_reduce_kernel_impl(
+    Tensor& output,
+    Tensor& arg_max,
+    const Tensor& data,
+    const Tensor& offsets,
+    int64_t reduce) {
+  AT_DISPATCH_FLOATING_TYPES(data.scalar_type(), "segment_reduce", [&] {
+    cpu_segment_reduce<scalar_t>(output, arg_max, data, offsets, reduce);
+  });
+}
+
+void segment_reduce_backward_kernel_impl(
+    Tensor& grad_input,
+    const Tensor& grad,
+    const Tensor& offsets,
+    const Tensor& arg_max,
+    int64_t reduce) {
+  AT_DISPATCH_FLOATING_TYPES(grad.scalar_type(), "segment_reduce_backward", [&] {
+    cpu_segment_reduce_backward<scalar_t>(grad_input, grad, offsets, arg_max, reduce);
+  });
+}
+
+} // namespace
+
+REGISTER_DISPATCH(segment_reduce_stub, &segment_reduce_kernel_impl);
+REGISTER_DISPATCH(segment_reduce_backward_stub, &segment_reduce_backward_kernel_impl);
+
+}} // namespace at::native
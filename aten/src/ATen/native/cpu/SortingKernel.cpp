@@ -5,10 +5,251 @@
 #include <ATen/native/Sorting.h>
 #include <ATen/native/SortingUtils.h>
 
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <type_traits>
+
 namespace at { namespace native {
 
 namespace {
 
+// Radix sort works on unsigned keys whose integer order is the order of the
+// values: sign bits are flipped for signed integers, and negative floats get
+// all of their bits flipped. NaNs all map to the largest key, so that they
+// sort to the end like in the TH sort.
+template <typename scalar_t, typename Enable = void>
+struct RadixKey;
+
+template <typename scalar_t>
+struct RadixKey<scalar_t, typename std::enable_if<std::is_integral<scalar_t>::value>::type> {
+  using type = typename std::make_unsigned<scalar_t>::type;
+  static type encode(scalar_t v) {
+    type key = static_cast<type>(v);
+    if (std::is_signed<scalar_t>::value) {
+      key ^= type(1) << (sizeof(type) * 8 - 1);
+    }
+    return key;
+  }
+};
+
+template <typename scalar_t>
+struct RadixKey<scalar_t, typename std::enable_if<std::is_floating_point<scalar_t>::value>::type> {
+  using type = typename std::conditional<sizeof(scalar_t) == 4, uint32_t, uint64_t>::type;
+  static type encode(scalar_t v) {
+    if (_isnan(v)) {
+      return std::numeric_limits<type>::max();
+    }
+    type bits;
+    std::memcpy(&bits, &v, sizeof(bits));
+    const type sign = type(1) << (sizeof(type) * 8 - 1);
+    return (bits & sign) ? ~bits : (bits | sign);
+  }
+};
+
+// Inputs shorter than this per thread are not worth splitting any further.
+constexpr int64_t kMinRadixChunk = 1 << 13;
+constexpr int kRadixBits = 8;
+constexpr int kRadixBuckets = 1 << kRadixBits;
+
+// Stable LSD radix sort of one slice of n elements, one byte per pass. Every
+// pass builds per-chunk histograms in parallel, turns them into per-chunk
+// scatter offsets, and scatters in parallel; passes where all keys share the
+// same byte are skipped. Writes the sorted values and their original
+// positions.
+template <typename scalar_t>
+void radix_sort(
+    scalar_t* values,
+    int64_t* indices,
+    const scalar_t* input,
+    int64_t n,
+    bool descending) {
+  using key_t = typename RadixKey<scalar_t>::type;
+  const key_t flip = descending ? ~key_t(0) : key_t(0);
+
+  const int64_t num_chunks = std::max<int64_t>(
+      1, std::min<int64_t>(at::get_num_threads(), n / kMinRadixChunk));
+  const int64_t chunk_size = divup(n, num_chunks);
+  auto for_each_chunk = [&](const std::function<void(int64_t, int64_t, int64_t)>& fn) {
+    at::parallel_for(0, num_chunks, 1, [&](int64_t begin, int64_t end) {
+      for (int64_t c = begin; c < end; c++) {
+        fn(c, c * chunk_size, std::min(n, (c + 1) * chunk_size));
+      }
+    });
+  };
+
+  std::vector<key_t> keys(n), keys_tmp(n);
+  std::vector<int64_t> indices_tmp(n);
+  key_t* src_keys = keys.data();
+  key_t* dst_keys = keys_tmp.data();
+  int64_t* src_indices = indices;
+  int64_t* dst_indices = indices_tmp.data();
+
+  for_each_chunk([&](int64_t, int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; i++) {
+      src_keys[i] = RadixKey<scalar_t>::encode(input[i]) ^ flip;
+      src_indices[i] = i;
+    }
+  });
+
+  std::vector<int64_t> offsets(num_chunks * kRadixBuckets);
+  for (int shift = 0; shift < static_cast<int>(sizeof(key_t) * 8); shift += kRadixBits) {
+    std::fill(offsets.begin(), offsets.end(), 0);
+    for_each_chunk([&](int64_t c, int64_t begin, int64_t end) {
+      int64_t* hist = offsets.data() + c * kRadixBuckets;
+      for (int64_t i = begin; i < end; i++) {
+        hist[(src_keys[i] >> shift) & (kRadixBuckets - 1)]++;
+      }
+    });
+
+    // exclusive scan, bucket-major so that the sort stays stable
+    int64_t total = 0;
+    bool single_bucket = false;
+    for (int64_t b = 0; b < kRadixBuckets; b++) {
+      const int64_t bucket_begin = total;
+      for (int64_t c = 0; c < num_chunks; c++) {
+        const int64_t count = offsets[c * kRadixBuckets + b];
+        offsets[c * kRadixBuckets + b] = total;
+        total += count;
+      }
+      if (total - bucket_begin == n) {
+        single_bucket = true;
+      }
+    }
+    if (single_bucket) {
+      continue;
+    }
+
+    for_each_chunk([&](int64_t c, int64_t begin, int64_t end) {
+      int64_t* offset = offsets.data() + c * kRadixBuckets;
+      for (int64_t i = begin; i < end; i++) {
+        const int64_t pos = offset[(src_keys[i] >> shift) & (kRadixBuckets - 1)]++;
+        dst_keys[pos] = src_keys[i];
+        dst_indices[pos] = src_indices[i];
+      }
+    });
+    std::swap(src_keys, dst_keys);
+    std::swap(src_indices, dst_indices);
+  }
+
+  for_each_chunk([&](int64_t, int64_t begin, int64_t end) {
+    if (src_indices != indices) {
+      std::memcpy(indices + begin, src_indices + begin, (end - begin) * sizeof(int64_t));
+    }
+    for (int64_t i = begin; i < end; i++) {
+      values[i] = input[indices[i]];
+    }
+  });
+}
+
+static void sort_kernel(
+    Tensor& values,
+    Tensor& indices,
+    const Tensor& self,
+    bool descending) {
+  const int64_t n = self.dim() == 0 ? 1 : self.size(-1);
+  const int64_t num_slices = n == 0 ? 0 : self.numel() / n;
+  AT_DISPATCH_ALL_TYPES(self.scalar_type(), "sort_cpu", [&] {
+    const scalar_t* self_data = self.data_ptr<scalar_t>();
+    scalar_t* values_data = values.data_ptr<scalar_t>();
+    int64_t* indices_data = indices.data_ptr<int64_t>();
+    // slices are long here, so parallelize within each slice instead of
+    // across them
+    for (int64_t s = 0; s < num_slices; s++) {
+      radix_sort<scalar_t>(
+          values_data + s * n, indices_data + s * n, self_data + s * n, n, descending);
+    }
+  });
+}
+
+// topk of a single long slice. For small k every thread selects the top k of
+// its own chunk and the candidates are merged; for large k that saves little,
+// so the slice is radix sorted instead.
+template <typename scalar_t>
+void topk_single_slice(
+    Tensor& values,
+    Tensor& indices,
+    const Tensor& self,
+    int64_t k,
+    bool largest,
+    bool sorted) {
+  using elem_t = std::pair<scalar_t, int64_t>;
+  // we want NaN to be sorted as top for numpy compatibility
+  auto greater = [](const elem_t& x, const elem_t& y) -> bool {
+    return ((_isnan<scalar_t>(x.first) && !_isnan<scalar_t>(y.first)) || (x.first > y.first));
+  };
+  auto less = [](const elem_t& x, const elem_t& y) -> bool {
+    return ((!_isnan<scalar_t>(x.first) && _isnan<scalar_t>(y.first)) || (x.first < y.first));
+  };
+
+  auto input = self.contiguous();
+  const scalar_t* input_data = input.data_ptr<scalar_t>();
+  const int64_t n = input.numel();
+  auto values_tmp = at::empty({k}, input.options());
+  auto indices_tmp = at::empty({k}, input.options().dtype(kLong));
+  scalar_t* values_data = values_tmp.data_ptr<scalar_t>();
+  int64_t* indices_data = indices_tmp.data_ptr<int64_t>();
+
+  const int64_t num_chunks = std::min<int64_t>(at::get_num_threads(), n / kMinRadixChunk);
+  if (num_chunks > 1 && num_chunks * k * 2 <= n) {
+    const int64_t chunk_size = divup(n, num_chunks);
+    std::vector<elem_t> candidates(num_chunks * k);
+    std::vector<int64_t> num_candidates(num_chunks);
+    at::parallel_for(0, num_chunks, 1, [&](int64_t c_begin, int64_t c_end) {
+      std::vector<elem_t> queue;
+      for (int64_t c = c_begin; c < c_end; c++) {
+        const int64_t begin = c * chunk_size;
+        const int64_t end = std::min(n, begin + chunk_size);
+        queue.resize(end - begin);
+        for (int64_t j = begin; j < end; j++) {
+          queue[j - begin] = elem_t(input_data[j], j);
+        }
+        const int64_t m = std::min<int64_t>(k, end - begin);
+        if (m > 0 && m < end - begin) {
+          if (largest) {
+            std::nth_element(queue.begin(), queue.begin() + m - 1, queue.end(), greater);
+          } else {
+            std::nth_element(queue.begin(), queue.begin() + m - 1, queue.end(), less);
+          }
+        }
+        std::copy(queue.begin(), queue.begin() + m, candidates.begin() + c * k);
+        num_candidates[c] = m;
+      }
+    });
+    // compact, chunks at the end may have fewer than k elements
+    int64_t total = 0;
+    for (int64_t c = 0; c < num_chunks; c++) {
+      std::copy(candidates.begin() + c * k, candidates.begin() + c * k + num_candidates[c],
+                candidates.begin() + total);
+      total += num_candidates[c];
+    }
+    candidates.resize(total);
+    if (largest) {
+      std::nth_element(candidates.begin(), candidates.begin() + k - 1, candidates.end(), greater);
+      if (sorted) {
+        std::sort(candidates.begin(), candidates.begin() + k - 1, greater);
+      }
+    } else {
+      std::nth_element(candidates.begin(), candidates.begin() + k - 1, candidates.end(), less);
+      if (sorted) {
+        std::sort(candidates.begin(), candidates.begin() + k - 1, less);
+      }
+    }
+    for (int64_t j = 0; j < k; j++) {
+      values_data[j] = candidates[j].first;
+      indices_data[j] = candidates[j].second;
+    }
+  } else {
+    std::vector<scalar_t> sorted_values(n);
+    std::vector<int64_t> sorted_indices(n);
+    radix_sort<scalar_t>(sorted_values.data(), sorted_indices.data(), input_data, n, /*descending=*/largest);
+    std::copy(sorted_values.begin(), sorted_values.begin() + k, values_data);
+    std::copy(sorted_indices.begin(), sorted_indices.begin() + k, indices_data);
+  }
+  values.copy_(values_tmp.view(values.sizes()));
+  indices.copy_(indices_tmp.view(indices.sizes()));
+}
+
 static void topk_kernel(
     Tensor& values,
     Tensor& indices,
@@ -18,6 +259,11 @@ static void topk_kernel(
     bool largest,
     bool sorted) {
   AT_DISPATCH_ALL_TYPES(self.scalar_type(), "topk_cpu", [&] {
+    // a single slice would run on one thread in dim_apply
+    if (k > 0 && self.numel() == self.size(dim) && self.size(dim) >= kParallelSortThreshold) {
+      topk_single_slice<scalar_t>(values, indices, self, k, largest, sorted);
+      return;
+    }
     dim_apply(
         {self, values, indices},
         dim,
@@ -85,6 +331,7 @@ static void topk_kernel(
 
 } // anonymous namespace
 
+REGISTER_DISPATCH(sort_stub, &sort_kernel);
 REGISTER_DISPATCH(topk_stub, &topk_kernel);
 
 }} //at::native
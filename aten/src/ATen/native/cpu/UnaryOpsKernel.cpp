@@ -1,6 +1,7 @@
 #include <cmath>
 #include <type_traits>
 #include <ATen/Config.h>
+#include <ATen/Context.h>
 #include <ATen/Dispatch.h>
 #include <ATen/CPUGenerator.h>
 #include <ATen/Utils.h>
@@ -9,6 +10,9 @@
 
 #include <ATen/cpu/vml.h>
 #include <ATen/cpu/vec256/vec256.h>
+#include <ATen/cpu/vec256/vec256_math.h>
+#include <ATen/cpu/vec512/vec512.h>
+#include <ATen/cpu/vec512/vec512_math.h>
 #include <ATen/cpu/vec256/functional.h>
 
 #include <ATen/native/Distributions.h>
@@ -28,16 +32,34 @@ namespace at { namespace native {
 namespace {
 
 using namespace vec256;
+using namespace vec512;
+
+// Runs a float kernel through the lower-precision vectorized implementation
+// if the user asked for it with at::globalContext().setFastMathCPU(true).
+// Returns false if the regular kernel should run instead.
+template <typename func_t, typename vec_func_t>
+static bool fast_math_kernel(TensorIterator& iter, func_t op, vec_func_t vop) {
+  if (iter.dtype() != ScalarType::Float || !at::globalContext().fastMathCPU()) {
+    return false;
+  }
+  cpu_kernel_vec(iter, op, vop);
+  return true;
+}
 
 static void sigmoid_kernel(TensorIterator& iter) {
-  AT_DISPATCH_FLOATING_AND_COMPLEX_TYPES(iter.dtype(), "sigmoid_cpu", [&]() {
+  if (fast_math_kernel(iter,
+        [](float a) -> float { return 1.f / (1.f + std::exp(-a)); },
+        [](Vectorized<float> a) { return fast_sigmoid(a); })) {
+    return;
+  }
+  AT_DISPATCH_FLOATING_AND_COMPLEX_TYPES_AND1(kBFloat16, iter.dtype(), "sigmoid_cpu", [&]() {
     cpu_kernel_vec(
         iter,
         [=](scalar_t a) -> scalar_t { return ((scalar_t)(1) / ((scalar_t)(1) + std::exp((-a)))); },
-        [=](Vec256<scalar_t> a) {
-          a = Vec256<scalar_t>((scalar_t)(0)) - a;
+        [=](Vectorized<scalar_t> a) {
+          a = Vectorized<scalar_t>((scalar_t)(0)) - a;
           a = a.exp();
-          a = Vec256<scalar_t>((scalar_t)(1)) + a;
+          a = Vectorized<scalar_t>((scalar_t)(1)) + a;
           a = a.reciprocal();
           return a;
         });
@@ -58,7 +80,7 @@ static void abs_kernel(TensorIterator& iter) {
     cpu_kernel_vec(
         iter,
         [=](scalar_t a) -> scalar_t { return abs_impl(a); },
-        [=](Vec256<scalar_t> a) { return a.abs(); });
+        [=](Vectorized<scalar_t> a) { return a.abs(); });
   });
 }
 
@@ -67,7 +89,7 @@ static void angle_kernel(TensorIterator& iter) {
     cpu_kernel_vec(
         iter,
         [=](scalar_t a) -> scalar_t { return angle_impl(a); },
-        [=](Vec256<scalar_t> a) { return a.angle(); });
+        [=](Vectorized<scalar_t> a) { return a.angle(); });
   });
 }
 
@@ -76,7 +98,7 @@ static void real_kernel(TensorIterator& iter) {
     cpu_kernel_vec(
         iter,
         [=](scalar_t a) -> scalar_t { return real_impl(a); },
-        [=](Vec256<scalar_t> a) { return a.real(); });
+        [=](Vectorized<scalar_t> a) { return a.real(); });
   });
 }
 
@@ -85,7 +107,7 @@ static void imag_kernel(TensorIterator& iter) {
     cpu_kernel_vec(
         iter,
         [=](scalar_t a) -> scalar_t { return imag_impl(a); },
-        [=](Vec256<scalar_t> a) { return a.imag(); });
+        [=](Vectorized<scalar_t> a) { return a.imag(); });
   });
 }
 
@@ -94,7 +116,7 @@ static void conj_kernel(TensorIterator& iter) {
     cpu_kernel_vec(
         iter,
         [=](scalar_t a) -> scalar_t { return conj_impl(a); },
-        [=](Vec256<scalar_t> a) { return a.conj(); });
+        [=](Vectorized<scalar_t> a) { return a.conj(); });
   });
 }
 
@@ -123,7 +145,7 @@ static void frac_kernel(TensorIterator& iter) {
     cpu_kernel_vec(
         iter,
         [=](scalar_t a) -> scalar_t { return a - std::trunc(a); },
-        [=](Vec256<scalar_t> a) { return a.frac(); });
+        [=](Vectorized<scalar_t> a) { return a.frac(); });
   });
 }
 
@@ -137,20 +159,20 @@ static void logical_not_kernel(TensorIterator& iter) {
 }
 
 static void reciprocal_kernel(TensorIterator& iter) {
-  AT_DISPATCH_FLOATING_AND_COMPLEX_TYPES(iter.dtype(), "reciprocal_cpu", [&]() {
+  AT_DISPATCH_FLOATING_AND_COMPLEX_TYPES_AND1(kBFloat16, iter.dtype(), "reciprocal_cpu", [&]() {
     cpu_kernel_vec(
         iter,
         [=](scalar_t a) -> scalar_t { return decltype(a)(1.0) / a; },
-        [=](Vec256<scalar_t> a) { return a.reciprocal(); });
+        [=](Vectorized<scalar_t> a) { return a.reciprocal(); });
   });
 }
 
 static void neg_kernel(TensorIterator& iter) {
-  AT_DISPATCH_ALL_TYPES_AND_COMPLEX(iter.dtype(), "neg_cpu", [&]() {
+  AT_DISPATCH_ALL_TYPES_AND_COMPLEX_AND(kBFloat16, iter.dtype(), "neg_cpu", [&]() {
     cpu_kernel_vec(
         iter,
         [=](scalar_t a) -> scalar_t { return -a; },
-        [=](Vec256<scalar_t> a) { return a.neg(); });
+        [=](Vectorized<scalar_t> a) { return a.neg(); });
   });
 }
 
@@ -159,17 +181,17 @@ static void sign_kernel(TensorIterator& iter){
       cpu_kernel(iter, [=](bool x) -> bool { return x; });
   } else {
     AT_DISPATCH_ALL_TYPES_AND(ScalarType::Half, iter.dtype(), "sign_cpu", [&]() {
-        auto zero_vec = Vec256<scalar_t>((scalar_t)(0));
-        auto one_vec = Vec256<scalar_t>((scalar_t)(1));
+        auto zero_vec = Vectorized<scalar_t>((scalar_t)(0));
+        auto one_vec = Vectorized<scalar_t>((scalar_t)(1));
 
         cpu_kernel_vec(
             iter,
             [=](scalar_t a) -> scalar_t { return (0 < a) - (a < 0); },
-            [=](Vec256<scalar_t> self_vec){
+            [=](Vectorized<scalar_t> self_vec){
 
                 // Comparision operators returns bitmask.
-                auto left = Vec256<scalar_t>::blendv(zero_vec, one_vec, zero_vec < self_vec);
-                auto right = Vec256<scalar_t>::blendv(zero_vec, one_vec, self_vec < zero_vec);
+                auto left = Vectorized<scalar_t>::blendv(zero_vec, one_vec, zero_vec < self_vec);
+                auto right = Vectorized<scalar_t>::blendv(zero_vec, one_vec, self_vec < zero_vec);
 
                 return left - right;
             });
@@ -179,33 +201,37 @@ static void sign_kernel(TensorIterator& iter){
 
 static void sinh_kernel(TensorIterator& iter) {
   AT_DISPATCH_FLOATING_AND_COMPLEX_TYPES(iter.dtype(), "sinh_cpu", [&]() {
-    cpu_kernel(
+    cpu_kernel_vec(
         iter,
-        [=](scalar_t a) -> scalar_t { return std::sinh(a); });
+        [=](scalar_t a) -> scalar_t { return std::sinh(a); },
+        [=](Vectorized<scalar_t> a) { return a.sinh(); });
   });
 }
 
 static void cosh_kernel(TensorIterator& iter) {
   AT_DISPATCH_FLOATING_AND_COMPLEX_TYPES(iter.dtype(), "cosh_cpu", [&]() {
-    cpu_kernel(
+    cpu_kernel_vec(
         iter,
-        [=](scalar_t a) -> scalar_t { return std::cosh(a); });
+        [=](scalar_t a) -> scalar_t { return std::cosh(a); },
+        [=](Vectorized<scalar_t> a) { return a.cosh(); });
   });
 }
 
 static void digamma_kernel(TensorIterator& iter) {
   AT_DISPATCH_FLOATING_TYPES(iter.dtype(), "digamma", [&]() {
-    cpu_kernel(
+    cpu_kernel_vec(
         iter,
-        [=](scalar_t a) -> scalar_t { return calc_digamma(a); });
+        [=](scalar_t a) -> scalar_t { return calc_digamma(a); },
+        [=](Vectorized<scalar_t> a) { return vec_digamma(a); });
   });
 }
 
 static void trigamma_kernel(TensorIterator& iter) {
   AT_DISPATCH_FLOATING_TYPES(iter.dtype(), "trigamma", [&]() {
-    cpu_kernel(
+    cpu_kernel_vec(
         iter,
-        [=](scalar_t a) -> scalar_t { return trigamma(a); });
+        [=](scalar_t a) -> scalar_t { return trigamma(a); },
+        [=](Vectorized<scalar_t> a) { return vec_trigamma(a); });
   });
 }
 
@@ -222,11 +248,11 @@ static void clamp_kernel(TensorIterator& iter, Scalar min_scalar, Scalar max_sca
     ztype<scalar_t>::value_t (*zabs_)(scalar_t) = zabs;
     auto min = min_scalar.to<scalar_t>();
     auto max = max_scalar.to<scalar_t>();
-    auto min_vec = Vec256<scalar_t>(min);
-    auto max_vec = Vec256<scalar_t>(max);
+    auto min_vec = Vectorized<scalar_t>(min);
+    auto max_vec = Vectorized<scalar_t>(max);
     cpu_kernel_vec(iter,
      [=](scalar_t a) -> scalar_t { return zabs_(a) < zabs_(min) ? min : (zabs_(a) > zabs_(max) ? max : a); },
-     [=](Vec256<scalar_t> a) { return vec256::clamp(a, min_vec, max_vec); });
+     [=](Vectorized<scalar_t> a) { return clamp(a, min_vec, max_vec); });
   });
 }
 
@@ -234,10 +260,10 @@ static void clamp_max_kernel(TensorIterator& iter, Scalar max_scalar) {
   AT_DISPATCH_ALL_TYPES_AND_COMPLEX(iter.dtype(), "clamp_max_cpu", [&]() {
     ztype<scalar_t>::value_t (*zabs_)(scalar_t) = zabs;
     auto max = max_scalar.to<scalar_t>();
-    auto max_vec = Vec256<scalar_t>(max);
+    auto max_vec = Vectorized<scalar_t>(max);
     cpu_kernel_vec(iter,
      [=](scalar_t a) -> scalar_t { return zabs_(a) > zabs_(max) ? max : a; },
-     [=](Vec256<scalar_t> a) { return vec256::clamp_max(a, max_vec); });
+     [=](Vectorized<scalar_t> a) { return clamp_max(a, max_vec); });
   });
 }
 
@@ -245,10 +271,10 @@ static void clamp_min_kernel(TensorIterator& iter, Scalar min_scalar) {
   AT_DISPATCH_ALL_TYPES_AND_COMPLEX(iter.dtype(), "clamp_min_cpu", [&]() {
     ztype<scalar_t>::value_t (*zabs_)(scalar_t) = zabs;
     auto min = min_scalar.to<scalar_t>();
-    auto min_vec = Vec256<scalar_t>(min);
+    auto min_vec = Vectorized<scalar_t>(min);
     cpu_kernel_vec(iter,
      [=](scalar_t a) -> scalar_t { return zabs_(a) < zabs_(min) ? min : a; },
-     [=](Vec256<scalar_t> a) { return vec256::clamp_min(a, min_vec); });
+     [=](Vectorized<scalar_t> a) { return clamp_min(a, min_vec); });
   });
 }
 
@@ -312,80 +338,91 @@ void bernoulli_mkl_kernel(Tensor &self, const double p, Generator* gen) {
 #endif
 
 static void rsqrt_kernel(TensorIterator& iter) {
-  AT_DISPATCH_FLOATING_AND_COMPLEX_TYPES(iter.dtype(), "rsqrt_cpu", [&] {
+  AT_DISPATCH_FLOATING_AND_COMPLEX_TYPES_AND1(kBFloat16, iter.dtype(), "rsqrt_cpu", [&] {
     cpu_kernel_vec(
         iter,
         [=](scalar_t a) -> scalar_t {
           return ((scalar_t)1) / std::sqrt(a);
         },
-        [=](Vec256<scalar_t> a) { return a.rsqrt(); });
+        [=](Vectorized<scalar_t> a) { return a.rsqrt(); });
   });
 }
 
 // TODO: Disable cont. branch to test more risky code
 
+template <typename scalar_t, typename vml_func_t>
+static void vml_kernel(TensorIterator& iter, vml_func_t vml_func) {
+  iter.serial_for_each(
+      [&](char** data_, const int64_t* strides, int64_t n) {
+        scalar_t* out_data = reinterpret_cast<scalar_t*>(data_[0]);
+        scalar_t* in_data = reinterpret_cast<scalar_t*>(data_[1]);
+        int64_t out_stride = strides[0] / sizeof(scalar_t);
+        int64_t in_stride = strides[1] / sizeof(scalar_t);
+        if (out_stride == 1 && in_stride == 1) {
+          vml_func(out_data, in_data, n);
+        } else {
+          static constexpr int64_t WIDTH = 131072 / sizeof(scalar_t);
+          for (int64_t i = 0; i < n; i += WIDTH) {
+            scalar_t buffer[WIDTH];
+            int64_t width = WIDTH;
+            width = std::min(width, n - i);
+            for (int64_t j = 0; j < width; j++)
+              buffer[j] = in_data[in_stride * (i + j)];
+            vml_func(buffer, buffer, width);
+            for (int64_t j = 0; j < width; j++)
+              out_data[out_stride * (i + j)] = buffer[j];
+          }
+        }
+      },
+      {0, iter.numel()});
+}
+
 #define IMPLEMENT_FLOAT_KERNEL(dispatchtypes, op)                             \
   static void op##_kernel(TensorIterator& iter) {                             \
     TORCH_INTERNAL_ASSERT(iter.ntensors() == 2);                              \
-    AT_DISPATCH_FLOATING_TYPES(iter.dtype(), op##_vml_cpu, [&]() {            \
-      iter.serial_for_each(                                                   \
-          [&](char** data_, const int64_t* strides, int64_t n) { \
-            scalar_t* out_data = reinterpret_cast<scalar_t*>(data_[0]);       \
-            scalar_t* in_data = reinterpret_cast<scalar_t*>(data_[1]);        \
-            int64_t out_stride = strides[0] / sizeof(scalar_t);               \
-            int64_t in_stride = strides[1] / sizeof(scalar_t);                \
-            if (out_stride == 1 && in_stride == 1) {                          \
-              vml::v##op(out_data, in_data, n);                               \
-            } else {                                                          \
-              static constexpr int64_t WIDTH = 131072 / sizeof(scalar_t);     \
-              for (int64_t i = 0; i < n; i += WIDTH) {                        \
-                scalar_t buffer[WIDTH];                                       \
-                int64_t width = WIDTH;                                        \
-                width = std::min(width, n - i);                               \
-                for (int64_t j = 0; j < width; j++)                           \
-                  buffer[j] = in_data[in_stride * (i + j)];                   \
-                vml::v##op(buffer, buffer, width);                            \
-                for (int64_t j = 0; j < width; j++)                           \
-                  out_data[out_stride * (i + j)] = buffer[j];                 \
-              }                                                               \
-            }                                                                 \
-          },                                                                  \
-          {0, iter.numel()});                                                 \
+    AT_DISPATCH_FLOATING_TYPES_AND(kBFloat16, iter.dtype(), op##_vml_cpu, [&]() { \
+      vml_kernel<scalar_t>(iter, vml::v##op<scalar_t>);                       \
+    });                                                                       \
+  }                                                                           \
+  REGISTER_DISPATCH(op##_stub, &op##_kernel)
+
+#define IMPLEMENT_COMPLEX_KERNEL(dispatchtypes, op)                           \
+  static void op##_kernel(TensorIterator& iter) {                             \
+    TORCH_INTERNAL_ASSERT(iter.ntensors() == 2);                              \
+    AT_DISPATCH_FLOATING_AND_COMPLEX_TYPES_AND1(kBFloat16, iter.dtype(), op##_vml_cpu, [&]() { \
+      vml_kernel<scalar_t>(iter, vml::v##op<scalar_t>);                       \
     });                                                                       \
   }                                                                           \
   REGISTER_DISPATCH(op##_stub, &op##_kernel)
 
-#define IMPLEMENT_COMPLEX_KERNEL(dispatchtypes, op)                             \
+// Like IMPLEMENT_COMPLEX_KERNEL, but float tensors use fast_##op from
+// vec256_math.h in fast math mode.
+#define IMPLEMENT_COMPLEX_KERNEL_WITH_FAST_MATH(dispatchtypes, op)            \
   static void op##_kernel(TensorIterator& iter) {                             \
     TORCH_INTERNAL_ASSERT(iter.ntensors() == 2);                              \
-    AT_DISPATCH_FLOATING_AND_COMPLEX_TYPES(iter.dtype(), op##_vml_cpu, [&]() {\
-      iter.serial_for_each(                                                   \
-          [&](char** data_, const int64_t* strides, int64_t n) {              \
-            scalar_t* out_data = reinterpret_cast<scalar_t*>(data_[0]);       \
-            scalar_t* in_data = reinterpret_cast<scalar_t*>(data_[1]);        \
-            int64_t out_stride = strides[0] / sizeof(scalar_t);               \
-            int64_t in_stride = strides[1] / sizeof(scalar_t);                \
-            if (out_stride == 1 && in_stride == 1) {                          \
-              vml::v##op(out_data, in_data, n);                               \
-            } else {                                                          \
-              static constexpr int64_t WIDTH = 131072 / sizeof(scalar_t);     \
-              for (int64_t i = 0; i < n; i += WIDTH) {                        \
-                scalar_t buffer[WIDTH];                                       \
-                int64_t width = WIDTH;                                        \
-                width = std::min(width, n - i);                               \
-                for (int64_t j = 0; j < width; j++)                           \
-                  buffer[j] = in_data[in_stride * (i + j)];                   \
-                vml::v##op(buffer, buffer, width);                            \
-                for (int64_t j = 0; j < width; j++)                           \
-                  out_data[out_stride * (i + j)] = buffer[j];                 \
-              }                                                               \
-            }                                                                 \
-          },                                                                  \
-          {0, iter.numel()});                                                 \
+    if (fast_math_kernel(iter,                                                \
+          [](float a) -> float { return std::op(a); },                        \
+          [](Vectorized<float> a) { return fast_##op(a); })) {                \
+      return;                                                                 \
+    }                                                                         \
+    AT_DISPATCH_FLOATING_AND_COMPLEX_TYPES_AND1(kBFloat16, iter.dtype(), op##_vml_cpu, [&]() { \
+      vml_kernel<scalar_t>(iter, vml::v##op<scalar_t>);                       \
     });                                                                       \
   }                                                                           \
   REGISTER_DISPATCH(op##_stub, &op##_kernel)
 
+static void erfinv_kernel(TensorIterator& iter) {
+  TORCH_INTERNAL_ASSERT(iter.ntensors() == 2);
+  if (fast_math_kernel(iter,
+        [](float a) -> float { return calc_erfinv(a); },
+        [](Vectorized<float> a) { return fast_erfinv(a); })) {
+    return;
+  }
+  AT_DISPATCH_FLOATING_TYPES(iter.dtype(), "erfinv_vml_cpu", [&]() {
+    vml_kernel<scalar_t>(iter, vml::verfinv<scalar_t>);
+  });
+}
+
 } // anonymous namespace
 
 REGISTER_DISPATCH(rsqrt_stub, &rsqrt_kernel);
@@ -410,6 +447,7 @@ REGISTER_DISPATCH(polygamma_stub, &polygamma_kernel);
 REGISTER_DISPATCH(clamp_stub, &clamp_kernel);
 REGISTER_DISPATCH(clamp_max_stub, &clamp_max_kernel);
 REGISTER_DISPATCH(clamp_min_stub, &clamp_min_kernel);
+REGISTER_DISPATCH(erfinv_stub, &erfinv_kernel);
 
 
 // IMPLEMENT_FLOAT_KERNEL(ALL, abs)
@@ -421,8 +459,7 @@ IMPLEMENT_COMPLEX_KERNEL(FLOATING, cos)
 // IMPLEMENT_FLOAT_KERNEL(FLOATING, cosh)
 IMPLEMENT_FLOAT_KERNEL(FLOATING, erf)
 IMPLEMENT_FLOAT_KERNEL(FLOATING, erfc)
-IMPLEMENT_FLOAT_KERNEL(FLOATING, erfinv)
-IMPLEMENT_COMPLEX_KERNEL(FLOATING, exp)
+IMPLEMENT_COMPLEX_KERNEL_WITH_FAST_MATH(FLOATING, exp)
 IMPLEMENT_FLOAT_KERNEL(FLOATING, expm1)
 IMPLEMENT_COMPLEX_KERNEL(FLOATING, floor)
 IMPLEMENT_COMPLEX_KERNEL(FLOATING, log)
@@ -434,7 +471,7 @@ IMPLEMENT_COMPLEX_KERNEL(FLOATING, sin)
 // IMPLEMENT_FLOAT_KERNEL(FLOATING, sinh)
 IMPLEMENT_COMPLEX_KERNEL(FLOATING, sqrt)
 IMPLEMENT_COMPLEX_KERNEL(FLOATING, tan)
-IMPLEMENT_COMPLEX_KERNEL(FLOATING, tanh)
+IMPLEMENT_COMPLEX_KERNEL_WITH_FAST_MATH(FLOATING, tanh)
 IMPLEMENT_COMPLEX_KERNEL(FLOATING, trunc)
 IMPLEMENT_FLOAT_KERNEL(FLOATING, lgamma)
 
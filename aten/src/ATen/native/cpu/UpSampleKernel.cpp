@@ -0,0 +1,96 @@
+#include <ATen/ATen.h>
+
+#include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
+#include <ATen/cpu/vec512/vec512.h>
+#include <ATen/native/UpSample.h>
+
+namespace at { namespace native {
+
+namespace {
+
+using namespace vec512;
+
+template <typename scalar_t>
+void cpu_upsample_bilinear2d_channels_last(
+    Tensor& output,
+    const Tensor& input,
+    bool align_corners) {
+  using Vec = Vectorized<scalar_t>;
+  const int64_t nbatch = input.size(0);
+  const int64_t channels = input.size(1);
+  const int64_t input_height = input.size(2);
+  const int64_t input_width = input.size(3);
+  const int64_t output_height = output.size(2);
+  const int64_t output_width = output.size(3);
+
+  const scalar_t* input_data = input.data_ptr<scalar_t>();
+  scalar_t* output_data = output.data_ptr<scalar_t>();
+
+  const scalar_t rheight = area_pixel_compute_scale<scalar_t>(
+      input_height, output_height, align_corners);
+  const scalar_t rwidth = area_pixel_compute_scale<scalar_t>(
+      input_width, output_width, align_corners);
+
+  // The four neighbours of an output pixel are each `channels` contiguous
+  // values, so the interpolation is a weighted sum of four rows vectorized
+  // over channels.
+  const int64_t vec_end = channels - (channels % Vec::size());
+  at::parallel_for(0, nbatch * output_height, 0, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; i++) {
+      const int64_t n = i / output_height;
+      const int64_t h2 = i % output_height;
+
+      const scalar_t h1r = area_pixel_compute_source_index<scalar_t>(
+          rheight, h2, align_corners, /*cubic=*/false);
+      const int64_t h1 = h1r;
+      const int64_t h1p = (h1 < input_height - 1) ? 1 : 0;
+      const scalar_t h1lambda = h1r - h1;
+      const scalar_t h0lambda = static_cast<scalar_t>(1.) - h1lambda;
+
+      for (int64_t w2 = 0; w2 < output_width; w2++) {
+        const scalar_t w1r = area_pixel_compute_source_index<scalar_t>(
+            rwidth, w2, align_corners, /*cubic=*/false);
+        const int64_t w1 = w1r;
+        const int64_t w1p = (w1 < input_width - 1) ? 1 : 0;
+        const scalar_t w1lambda = w1r - w1;
+        const scalar_t w0lambda = static_cast<scalar_t>(1.) - w1lambda;
+
+        const scalar_t* in00 = input_data + ((n * input_height + h1) * input_width + w1) * channels;
+        const scalar_t* in01 = in00 + w1p * channels;
+        const scalar_t* in10 = in00 + h1p * input_width * channels;
+        const scalar_t* in11 = in10 + w1p * channels;
+        scalar_t* out = output_data + (i * output_width + w2) * channels;
+
+        const Vec h0lambda_vec(h0lambda), h1lambda_vec(h1lambda);
+        const Vec w0lambda_vec(w0lambda), w1lambda_vec(w1lambda);
+        int64_t c = 0;
+        for (; c < vec_end; c += Vec::size()) {
+          const Vec result =
+              h0lambda_vec * (w0lambda_vec * Vec::loadu(in00 + c) + w1lambda_vec * Vec::loadu(in01 + c)) +
+              h1lambda_vec * (w0lambda_vec * Vec::loadu(in10 + c) + w1lambda_vec * Vec::loadu(in11 + c));
+          result.store(out + c);
+        }
+        for (; c < channels; c++) {
+          out[c] = h0lambda * (w0lambda * in00[c] + w1lambda * in01[c]) +
+              h1lambda * (w0lambda * in10[c] + w1lambda * in11[c]);
+        }
+      }
+    }
+  });
+}
+
+void upsample_bilinear2d_channels_last_kernel_impl(
+    Tensor& output,
+    const Tensor& input,
+    bool align_corners) {
+  AT_DISPATCH_FLOATING_TYPES(input.scalar_type(), "upsample_bilinear2d_channels_last", [&] {
+    cpu_upsample_bilinear2d_channels_last<scalar_t>(output, input, align_corners);
+  });
+}
+
+} // namespace
+
+REGISTER_DISPATCH(upsample_bilinear2d_channels_last_kernel, &upsample_bilinear2d_channels_last_kernel_impl);
+
+}} // namespace at::native
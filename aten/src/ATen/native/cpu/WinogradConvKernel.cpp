@@ -0,0 +1,217 @@
+#include <ATen/native/cpu/WinogradConvKernel.h>
+#include <ATen/ATen.h>
+#include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
+
+namespace at {
+namespace native {
+namespace {
+
+// Winograd F(4x4, 3x3) as in Lavin and Gray, "Fast Algorithms for
+// Convolutional Neural Networks": the 4x4 output tile of a 6x6 input tile d is
+//
+//   A^T [(G g G^T) . (B^T d B)] A
+//
+// where G g G^T is the transformed 3x3 filter g (see _winograd_conv2d_weight).
+// Summing the elementwise products over the input channels is, for each of
+// the 36 elements of the 6x6 tiles, a GEMM of the (K, C) transformed filters
+// by the (C, tiles) transformed inputs, so that the convolution is one batched
+// GEMM of 36 matrices between the input and output transforms, instead of
+// the GEMM of a 9 times larger im2col buffer.
+//
+//         [4  0 -5  0  1  0]             [1  1  1  1  1  0]
+//         [0 -4 -4  1  1  0]             [0  1 -1  2 -2  0]
+//   B^T = [0  4 -4 -1  1  0]       A^T = [0  1  1  4  4  0]
+//         [0 -2 -1  2  1  0]             [0  1 -1  8 -8  1]
+//         [0  2 -1 -2  1  0]
+//         [0  4  0 -5  0  1]
+constexpr int64_t kInputTile = 6;
+constexpr int64_t kOutputTile = 4;
+
+// y = B^T x for the 6-vectors x and y read and written with strides
+template <typename scalar_t>
+inline void input_transform_1d(const scalar_t* x, int64_t xs, scalar_t* y, int64_t ys) {
+  const scalar_t x0 = x[0], x1 = x[xs], x2 = x[2 * xs];
+  const scalar_t x3 = x[3 * xs], x4 = x[4 * xs], x5 = x[5 * xs];
+  y[0] = 4 * x0 - 5 * x2 + x4;
+  y[ys] = -4 * x1 - 4 * x2 + x3 + x4;
+  y[2 * ys] = 4 * x1 - 4 * x2 - x3 + x4;
+  y[3 * ys] = -2 * x1 - x2 + 2 * x3 + x4;
+  y[4 * ys] = 2 * x1 - x2 - 2 * x3 + x4;
+  y[5 * ys] = 4 * x1 - 5 * x3 + x5;
+}
+
+// y = A^T x for the 6-vector x and the 4-vector y
+template <typename scalar_t>
+inline void output_transform_1d(const scalar_t* x, int64_t xs, scalar_t* y, int64_t ys) {
+  const scalar_t x0 = x[0], x1 = x[xs], x2 = x[2 * xs];
+  const scalar_t x3 = x[3 * xs], x4 = x[4 * xs], x5 = x[5 * xs];
+  y[0] = x0 + x1 + x2 + x3 + x4;
+  y[ys] = x1 - x2 + 2 * (x3 - x4);
+  y[2 * ys] = x1 + x2 + 4 * (x3 + x4);
+  y[3 * ys] = x1 - x2 + 8 * (x3 - x4) + x5;
+}
+
+struct Arguments final {
+  int64_t batch;
+  int64_t in_channels;
+  int64_t out_channels;
+  int64_t in_rows;
+  int64_t in_cols;
+  int64_t pad_rows;
+  int64_t pad_cols;
+  int64_t out_rows;
+  int64_t out_cols;
+  int64_t tile_rows;
+  int64_t tile_cols;
+
+  int64_t tiles() const {
+    return batch * tile_rows * tile_cols;
+  }
+};
+
+// Writes B^T d B for the tile t of the plane of channel c of input n to
+// transformed[xi][c][t], for the 36 elements xi of the tiles
+template <typename scalar_t>
+void winograd_input_transform(
+    const Arguments& args,
+    const scalar_t* input,
+    scalar_t* transformed) {
+  const int64_t tiles = args.tiles();
+  const int64_t xi_stride = args.in_channels * tiles;
+  at::parallel_for(0, args.batch * args.in_channels, 0, [&](int64_t start, int64_t end) {
+    scalar_t d[kInputTile][kInputTile];
+    scalar_t tmp[kInputTile][kInputTile];
+    scalar_t v[kInputTile][kInputTile];
+    for (int64_t nc = start; nc < end; ++nc) {
+      const int64_t n = nc / args.in_channels;
+      const int64_t c = nc % args.in_channels;
+      const scalar_t* plane = input + nc * args.in_rows * args.in_cols;
+      for (int64_t th = 0; th < args.tile_rows; ++th) {
+        for (int64_t tw = 0; tw < args.tile_cols; ++tw) {
+          const int64_t row0 = th * kOutputTile - args.pad_rows;
+          const int64_t col0 = tw * kOutputTile - args.pad_cols;
+          for (int64_t i = 0; i < kInputTile; ++i) {
+            const int64_t row = row0 + i;
+            for (int64_t j = 0; j < kInputTile; ++j) {
+              const int64_t col = col0 + j;
+              d[i][j] = (row >= 0 && row < args.in_rows && col >= 0 && col < args.in_cols)
+                  ? plane[row * args.in_cols + col]
+                  : scalar_t(0);
+            }
+          }
+          for (int64_t j = 0; j < kInputTile; ++j) {
+            input_transform_1d(&d[0][j], kInputTile, &tmp[0][j], kInputTile);
+          }
+          for (int64_t i = 0; i < kInputTile; ++i) {
+            input_transform_1d(&tmp[i][0], 1, &v[i][0], 1);
+          }
+          const int64_t t = (n * args.tile_rows + th) * args.tile_cols + tw;
+          scalar_t* out = transformed + c * tiles + t;
+          for (int64_t i = 0; i < kInputTile; ++i) {
+            for (int64_t j = 0; j < kInputTile; ++j) {
+              out[(i * kInputTile + j) * xi_stride] = v[i][j];
+            }
+          }
+        }
+      }
+    }
+  });
+}
+
+// Writes A^T m A plus the bias for the tiles m of products[xi][k][t] to the
+// plane of channel k of output n
+template <typename scalar_t>
+void winograd_output_transform(
+    const Arguments& args,
+    const scalar_t* products,
+    const scalar_t* bias,
+    scalar_t* output) {
+  const int64_t tiles = args.tiles();
+  const int64_t xi_stride = args.out_channels * tiles;
+  at::parallel_for(0, args.batch * args.out_channels, 0, [&](int64_t start, int64_t end) {
+    scalar_t m[kInputTile][kInputTile];
+    scalar_t tmp[kOutputTile][kInputTile];
+    scalar_t y[kOutputTile][kOutputTile];
+    for (int64_t nk = start; nk < end; ++nk) {
+      const int64_t n = nk / args.out_channels;
+      const int64_t k = nk % args.out_channels;
+      const scalar_t b = bias ? bias[k] : scalar_t(0);
+      scalar_t* plane = output + nk * args.out_rows * args.out_cols;
+      for (int64_t th = 0; th < args.tile_rows; ++th) {
+        for (int64_t tw = 0; tw < args.tile_cols; ++tw) {
+          const int64_t t = (n * args.tile_rows + th) * args.tile_cols + tw;
+          const scalar_t* in = products + k * tiles + t;
+          for (int64_t i = 0; i < kInputTile; ++i) {
+            for (int64_t j = 0; j < kInputTile; ++j) {
+              m[i][j] = in[(i * kInputTile + j) * xi_stride];
+            }
+          }
+          for (int64_t j = 0; j < kInputTile; ++j) {
+            output_transform_1d(&m[0][j], kInputTile, &tmp[0][j], kInputTile);
+          }
+          for (int64_t i = 0; i < kOutputTile; ++i) {
+            output_transform_1d(&tmp[i][0], 1, &y[i][0], 1);
+          }
+          const int64_t row0 = th * kOutputTile;
+          const int64_t col0 = tw * kOutputTile;
+          const int64_t rows = std::min(kOutputTile, args.out_rows - row0);
+          const int64_t cols = std::min(kOutputTile, args.out_cols - col0);
+          for (int64_t i = 0; i < rows; ++i) {
+            for (int64_t j = 0; j < cols; ++j) {
+              plane[(row0 + i) * args.out_cols + col0 + j] = y[i][j] + b;
+            }
+          }
+        }
+      }
+    }
+  });
+}
+
+Tensor _convolution_winograd4x3(
+    const Tensor& input,
+    const Tensor& winograd_weight,
+    const Tensor& bias,
+    const IntArrayRef padding) {
+  Arguments args;
+  args.batch = input.size(0);
+  args.in_channels = input.size(1);
+  args.out_channels = winograd_weight.size(1);
+  args.in_rows = input.size(2);
+  args.in_cols = input.size(3);
+  args.pad_rows = padding[0];
+  args.pad_cols = padding[1];
+  args.out_rows = args.in_rows + 2 * args.pad_rows - 2;
+  args.out_cols = args.in_cols + 2 * args.pad_cols - 2;
+  args.tile_rows = divup(args.out_rows, kOutputTile);
+  args.tile_cols = divup(args.out_cols, kOutputTile);
+
+  Tensor output = at::empty(
+      {args.batch, args.out_channels, args.out_rows, args.out_cols}, input.options());
+  if (output.numel() == 0) {
+    return output;
+  }
+  Tensor transformed_input = at::empty(
+      {kInputTile * kInputTile, args.in_channels, args.tiles()}, input.options());
+  AT_DISPATCH_FLOATING_TYPES(input.scalar_type(), "winograd_input_transform", [&] {
+    winograd_input_transform<scalar_t>(
+        args, input.data_ptr<scalar_t>(), transformed_input.data_ptr<scalar_t>());
+  });
+  // (36, K, C) x (36, C, tiles)
+  const Tensor products = at::bmm(winograd_weight, transformed_input);
+  AT_DISPATCH_FLOATING_TYPES(input.scalar_type(), "winograd_output_transform", [&] {
+    winograd_output_transform<scalar_t>(
+        args,
+        products.data_ptr<scalar_t>(),
+        bias.defined() ? bias.data_ptr<scalar_t>() : nullptr,
+        output.data_ptr<scalar_t>());
+  });
+  return output;
+}
+
+}  // namespace
+
+REGISTER_DISPATCH(convolution_winograd4x3_stub, &_convolution_winograd4x3);
+
+}  // namespace native
+}  // namespace at
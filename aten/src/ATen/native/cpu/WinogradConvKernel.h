@@ -0,0 +1,20 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <ATen/native/DispatchStub.h>
+
+/*
+  Winograd F(4x4, 3x3) convolution operator
+*/
+
+namespace at {
+namespace native {
+
+// input, winograd_weight (the output of _winograd_conv2d_weight), bias, padding
+using convolution_winograd4x3_fn =
+    Tensor (*)(const Tensor &, const Tensor &, const Tensor &, IntArrayRef);
+
+DECLARE_DISPATCH(convolution_winograd4x3_fn, convolution_winograd4x3_stub);
+
+}  // namespace native
+}  // namespace at
@@ -0,0 +1,83 @@
+#include <ATen/ATen.h>
+#include <ATen/AccumulateType.h>
+#include <ATen/Dispatch.h>
+#include <ATen/cuda/CUDAContext.h>
+#include <ATen/native/BlockSparse.h>
+
+#include <c10/macros/Macros.h>
+
+// One thread per output element, consecutive threads of a warp covering
+// consecutive columns, so the reads of dense and the writes of the output are
+// coalesced and every output element has a single writer.
+
+namespace at {
+namespace native {
+
+namespace {
+
+constexpr int kThreads = 256;
+
+template <typename scalar_t, typename accscalar_t>
+__global__ void block_sparse_mm_kernel(
+    scalar_t* output,
+    const int64_t* crow_indices,
+    const int64_t* col_indices,
+    const scalar_t* values,
+    const scalar_t* dense,
+    int64_t rows,
+    int64_t n,
+    int64_t block_rows,
+    int64_t block_cols) {
+  const int64_t total = rows * n;
+  for (int64_t idx = blockIdx.x * blockDim.x + threadIdx.x; idx < total;
+       idx += blockDim.x * gridDim.x) {
+    const int64_t row = idx / n;
+    const int64_t d = idx % n;
+    const int64_t r = row / block_rows;
+    const int64_t i = row % block_rows;
+    accscalar_t sum = 0;
+    for (int64_t b = crow_indices[r]; b < crow_indices[r + 1]; b++) {
+      const scalar_t* block_row = values + (b * block_rows + i) * block_cols;
+      const scalar_t* in = dense + col_indices[b] * block_cols * n + d;
+      for (int64_t j = 0; j < block_cols; j++) {
+        sum += static_cast<accscalar_t>(block_row[j]) * static_cast<accscalar_t>(in[j * n]);
+      }
+    }
+    output[idx] = static_cast<scalar_t>(sum);
+  }
+}
+
+dim3 grid_for(int64_t total) {
+  const int64_t max_blocks = at::cuda::getCurrentDeviceProperties()->multiProcessorCount * 8;
+  return dim3(std::min<int64_t>(max_blocks, (total + kThreads - 1) / kThreads));
+}
+
+void block_sparse_mm_kernel_cuda(
+    Tensor& output,
+    const Tensor& crow_indices,
+    const Tensor& col_indices,
+    const Tensor& values,
+    const Tensor& dense) {
+  cudaStream_t stream = at::cuda::getCurrentCUDAStream();
+  AT_DISPATCH_FLOATING_TYPES_AND_HALF(values.scalar_type(), "block_sparse_mm_cuda", [&] {
+    using accscalar_t = acc_type<scalar_t, true>;
+    block_sparse_mm_kernel<scalar_t, accscalar_t><<<grid_for(output.numel()), kThreads, 0, stream>>>(
+        output.data_ptr<scalar_t>(),
+        crow_indices.data_ptr<int64_t>(),
+        col_indices.data_ptr<int64_t>(),
+        values.data_ptr<scalar_t>(),
+        dense.data_ptr<scalar_t>(),
+        output.size(0),
+        output.size(1),
+        values.size(1),
+        values.size(2));
+  });
+  AT_CUDA_CHECK(cudaGetLastError());
+}
+
+} // namespace
+
+REGISTER_DISPATCH(block_sparse_mm_stub, &block_sparse_mm_kernel_cuda);
+
+} // namespace native
+} // namespace at
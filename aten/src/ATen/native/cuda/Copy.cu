@@ -57,6 +57,12 @@ void copy_device_to_device(TensorIterator& iter, bool non_blocking) {
         numel * iter.element_size(0),
         cudaMemcpyDeviceToDevice,
         copy_stream));
+  } else if (same_type && isQIntType(iter.dtype(0))) {
+    // Quantized values are only copied to the same type, as the integers
+    // they hold
+    AT_DISPATCH_QINT_TYPES(iter.dtype(0), "copy_", [&] {
+      gpu_kernel(iter, []GPU_LAMBDA(underlying_t x) { return x; });
+    });
   } else {
     // this is done intentionally done after build because copy has a "promotion"
     // rule that always "promote" to target dtype.
@@ -4,7 +4,12 @@
 #include <ATen/native/cuda/CuFFTUtils.h>
 #include <ATen/native/utils/ParamsHash.h>
 
+#include <cstdlib>
+#include <exception>
+#include <future>
 #include <list>
+#include <memory>
+#include <mutex>
 #include <unordered_map>
 #include <string>
 #include <stdexcept>
@@ -329,6 +334,10 @@ public:
 
   int64_t workspace_size() const { return ws_size; }
 
+  // cufftSetStream and cufftSetWorkArea modify the plan, so a plan shared
+  // through the cache must only be executed by one thread at a time.
+  std::mutex exec_mutex;
+
 private:
   std::unique_ptr<cufftHandle, CuFFTHandleDeleter> plan_ptr;
   bool clone_input;
@@ -347,105 +356,225 @@ private:
   // default. Users can always configure it via cufft_set_plan_cache_max_size.
   constexpr size_t CUFFT_DEFAULT_CACHE_SIZE = 4096;
 #endif
+// By default, the cache is not limited by the workspace size of its plans.
+// Users can configure it via cufft_set_plan_cache_max_bytes.
+constexpr int64_t CUFFT_DEFAULT_CACHE_MAX_BYTES = std::numeric_limits<int64_t>::max();
 static_assert(CUFFT_MAX_PLAN_NUM >= 0 && CUFFT_MAX_PLAN_NUM <= std::numeric_limits<size_t>::max(),
               "CUFFT_MAX_PLAN_NUM not in size_t range");
 static_assert(CUFFT_DEFAULT_CACHE_SIZE >= 0 && CUFFT_DEFAULT_CACHE_SIZE <= CUFFT_MAX_PLAN_NUM,
               "CUFFT_DEFAULT_CACHE_SIZE not in [0, CUFFT_MAX_PLAN_NUM] range");
 
+// Reads the default of a plan cache limit from the environment variable
+// `name`, e.g. PYTORCH_CUFFT_PLAN_CACHE_SIZE, falling back to `def_value` if
+// it is unset or empty.
+static inline int64_t cufft_plan_cache_limit_from_env(const char* name, int64_t def_value) {
+  const char* env = std::getenv(name);
+  if (env == nullptr || *env == '\0') {
+    return def_value;
+  }
+  char* end = nullptr;
+  const long long value = std::strtoll(env, &end, 10);
+  TORCH_CHECK(*end == '\0' && value >= 0,
+           "expected ", name, " to be a non-negative integer, but got ", env);
+  return static_cast<int64_t>(value);
+}
+
 // This cache assumes that the mapping from key to value never changes.
-// This is **NOT** thread-safe. Please use a mutex when using it **AND** the
-// value returned from try_emplace_value.
-// The contract of using this cache is that try_emplace_value should only be
-// used when the max_size is positive.
+// It is thread-safe: every method takes the internal mutex.
+//
+// Plans are created outside of the mutex, so that a thread creating a plan
+// does not block the threads looking up other plans. The entry for a plan
+// being created is inserted before creation starts and holds a future that
+// is fulfilled once the plan exists, so concurrent lookups of the same key
+// wait for that one plan instead of each creating their own.
+//
+// Besides the number of plans, the cache can be limited by the total
+// workspace size of its plans, in bytes. Plans are returned as shared_ptrs,
+// so evicting a plan that is still being executed is safe.
 class CuFFTParamsLRUCache {
 public:
-  using kv_t = typename std::pair<CuFFTParams, CuFFTConfig>;
-  using map_t = typename std::unordered_map<std::reference_wrapper<CuFFTParams>,
-                                            typename std::list<kv_t>::iterator,
-                                            ParamsHash<CuFFTParams>,
-                                            ParamsEqual<CuFFTParams>>;
-  using map_kkv_iter_t = typename map_t::iterator;
+  using config_ptr_t = std::shared_ptr<CuFFTConfig>;
 
+  CuFFTParamsLRUCache()
+    : CuFFTParamsLRUCache(
+        cufft_plan_cache_limit_from_env("PYTORCH_CUFFT_PLAN_CACHE_SIZE", CUFFT_DEFAULT_CACHE_SIZE),
+        cufft_plan_cache_limit_from_env("PYTORCH_CUFFT_PLAN_CACHE_MAX_BYTES", CUFFT_DEFAULT_CACHE_MAX_BYTES)) {}
 
-  CuFFTParamsLRUCache() : CuFFTParamsLRUCache(CUFFT_DEFAULT_CACHE_SIZE) {}
-
-  CuFFTParamsLRUCache(int64_t max_size) {
+  CuFFTParamsLRUCache(int64_t max_size, int64_t max_bytes) {
     _set_max_size(max_size);
+    _set_max_bytes(max_bytes);
   }
 
-  CuFFTParamsLRUCache(CuFFTParamsLRUCache&& other) noexcept :
-    _usage_list(std::move(other._usage_list)),
-    _cache_map(std::move(other._cache_map)),
-    _max_size(other._max_size) {}
-
-  CuFFTParamsLRUCache& operator=(CuFFTParamsLRUCache&& other) noexcept {
-    _usage_list = std::move(other._usage_list);
-    _cache_map = std::move(other._cache_map);
-    _max_size = other._max_size;
-    return *this;
-  }
+  CuFFTParamsLRUCache(const CuFFTParamsLRUCache&) = delete;
+  CuFFTParamsLRUCache& operator=(const CuFFTParamsLRUCache&) = delete;
+
+  // If key is in this cache, return the cached config, waiting for it if
+  // another thread is still creating it. Otherwise, create the config from
+  // value_args, insert it into this cache and return it. If the cache has
+  // zero capacity, the config is created but not cached.
+  template<class ...VArgs>
+  config_ptr_t lookup(const CuFFTParams& key, VArgs&&... value_args) {
+    std::promise<config_ptr_t> promise;
+    uint64_t id;
+    {
+      std::unique_lock<std::mutex> guard(_mutex);
+      map_kkv_iter_t map_it = _cache_map.find(key);
+      // Hit, put to list front
+      if (map_it != _cache_map.end()) {
+        _hits++;
+        _usage_list.splice(_usage_list.begin(), _usage_list, map_it->second);
+        std::shared_future<config_ptr_t> config = map_it->second->config;
+        guard.unlock();
+        // rethrows if the thread creating the config failed
+        return config.get();
+      }
 
-  // If key is in this cache, return the cached config. Otherwise, emplace the
-  // config in this cache using value_args and return it.
-  // Return const reference because CuFFTConfig shouldn't be tampered with once
-  // created.
-  // This is similar to c++ 17 try_emplace.
-  template<typename K, class ...VArgs>
-  const CuFFTConfig &try_emplace_value(K&& key, VArgs&&... value_args) {
-    AT_ASSERT(_max_size > 0);
+      // Miss
+      _misses++;
+      if (_max_size == 0) {
+        guard.unlock();
+        return std::make_shared<CuFFTConfig>(std::forward<VArgs>(value_args)...);
+      }
+      // remove if needed
+      if (_usage_list.size() >= _max_size) {
+        _evict_last();
+      }
 
-    map_kkv_iter_t map_it = _cache_map.find(key);
-    // Hit, put to list front
-    if (map_it != _cache_map.end()) {
-      _usage_list.splice(_usage_list.begin(), _usage_list, map_it->second);
-      return map_it->second->second;
+      // insert a pending entry at list front, then insert into _cache_map
+      id = _next_id++;
+      _usage_list.emplace_front(key, promise.get_future().share(), id);
+      auto kv_it = _usage_list.begin();
+      _cache_map.emplace(std::piecewise_construct,
+                  std::forward_as_tuple(kv_it->key),
+                  std::forward_as_tuple(kv_it));
     }
 
-    // Miss
-    // remove if needed
-    if (_usage_list.size() >= _max_size) {
-      auto last = _usage_list.end();
-      last--;
-      _cache_map.erase(last->first);
-      _usage_list.pop_back();
+    config_ptr_t config;
+    try {
+      config = std::make_shared<CuFFTConfig>(std::forward<VArgs>(value_args)...);
+    } catch (...) {
+      promise.set_exception(std::current_exception());
+      // Drop the pending entry, so that the next lookup tries again.
+      std::lock_guard<std::mutex> guard(_mutex);
+      map_kkv_iter_t map_it = _cache_map.find(key);
+      if (map_it != _cache_map.end() && map_it->second->id == id) {
+        _erase(map_it);
+      }
+      throw;
     }
+    promise.set_value(config);
 
-    // construct new plan at list front, then insert into _cache_map
-    _usage_list.emplace_front(std::piecewise_construct,
-                       std::forward_as_tuple(key),
-                       std::forward_as_tuple(value_args...));
-    auto kv_it = _usage_list.begin();
-    _cache_map.emplace(std::piecewise_construct,
-                std::forward_as_tuple(kv_it->first),
-                std::forward_as_tuple(kv_it));
-    return kv_it->second;
+    std::lock_guard<std::mutex> guard(_mutex);
+    // The entry may have been evicted or cleared while the plan was created.
+    map_kkv_iter_t map_it = _cache_map.find(key);
+    if (map_it != _cache_map.end() && map_it->second->id == id) {
+      map_it->second->bytes = config->workspace_size();
+      _bytes += map_it->second->bytes;
+      _evict_to_max_bytes();
+    }
+    return config;
   }
 
   void clear() {
+    std::lock_guard<std::mutex> guard(_mutex);
     _cache_map.clear();
     _usage_list.clear();
+    _bytes = 0;
   }
 
   void resize(int64_t new_size) {
+    std::lock_guard<std::mutex> guard(_mutex);
     _set_max_size(new_size);
-    auto cur_size = _usage_list.size();
-    if (cur_size > _max_size) {
-      auto delete_it = _usage_list.end();
-      for (size_t i = 0; i < cur_size - _max_size; i++) {
-        delete_it--;
-        _cache_map.erase(delete_it->first);
-      }
-      _usage_list.erase(delete_it, _usage_list.end());
+    while (_usage_list.size() > _max_size) {
+      _evict_last();
     }
   }
 
-  size_t size() const { return _cache_map.size(); }
+  void set_max_bytes(int64_t new_max_bytes) {
+    std::lock_guard<std::mutex> guard(_mutex);
+    _set_max_bytes(new_max_bytes);
+    _evict_to_max_bytes();
+  }
+
+  size_t size() const {
+    std::lock_guard<std::mutex> guard(_mutex);
+    return _cache_map.size();
+  }
+
+  size_t max_size() const {
+    std::lock_guard<std::mutex> guard(_mutex);
+    return _max_size;
+  }
+
+  // Total workspace size of the cached plans, in bytes.
+  int64_t bytes() const {
+    std::lock_guard<std::mutex> guard(_mutex);
+    return _bytes;
+  }
+
+  int64_t max_bytes() const {
+    std::lock_guard<std::mutex> guard(_mutex);
+    return _max_bytes;
+  }
+
+  // Lookups that found the key (including ones that waited for a plan being
+  // created by another thread), lookups that had to create a plan, and plans
+  // evicted to stay within max_size or max_bytes, since the cache was created.
+  int64_t hits() const {
+    std::lock_guard<std::mutex> guard(_mutex);
+    return _hits;
+  }
 
-  size_t max_size() const noexcept { return _max_size; }
+  int64_t misses() const {
+    std::lock_guard<std::mutex> guard(_mutex);
+    return _misses;
+  }
 
-  std::mutex mutex;
+  int64_t evictions() const {
+    std::lock_guard<std::mutex> guard(_mutex);
+    return _evictions;
+  }
 
 private:
+  struct Entry {
+    Entry(const CuFFTParams& key, std::shared_future<config_ptr_t> config, uint64_t id)
+      : key(key), config(std::move(config)), bytes(0), id(id) {}
+
+    CuFFTParams key;
+    std::shared_future<config_ptr_t> config;
+    // workspace size of the plan, zero while it is being created
+    int64_t bytes;
+    // tells apart a pending entry from one inserted again for the same key
+    // after the pending entry was evicted
+    uint64_t id;
+  };
+
+  using map_t = typename std::unordered_map<std::reference_wrapper<const CuFFTParams>,
+                                            typename std::list<Entry>::iterator,
+                                            ParamsHash<CuFFTParams>,
+                                            ParamsEqual<CuFFTParams>>;
+  using map_kkv_iter_t = typename map_t::iterator;
+
+  void _erase(map_kkv_iter_t map_it) {
+    auto kv_it = map_it->second;
+    _bytes -= kv_it->bytes;
+    _cache_map.erase(map_it);
+    _usage_list.erase(kv_it);
+  }
+
+  void _evict_last() {
+    auto last = _usage_list.end();
+    last--;
+    _erase(_cache_map.find(last->key));
+    _evictions++;
+  }
+
+  void _evict_to_max_bytes() {
+    while (_bytes > _max_bytes && !_usage_list.empty()) {
+      _evict_last();
+    }
+  }
+
   // Only sets size and does value check. Does not resize the data structures.
   void _set_max_size(int64_t new_size) {
     // We check that 0 <= new_size <= CUFFT_MAX_PLAN_NUM here. Since
@@ -458,9 +587,22 @@ private:
     _max_size = static_cast<size_t>(new_size);
   }
 
-  std::list<kv_t> _usage_list;
+  void _set_max_bytes(int64_t new_max_bytes) {
+    TORCH_CHECK(new_max_bytes >= 0,
+             "cuFFT plan cache max bytes must be non-negative, but got ", new_max_bytes);
+    _max_bytes = new_max_bytes;
+  }
+
+  mutable std::mutex _mutex;
+  std::list<Entry> _usage_list;
   map_t _cache_map;
   size_t _max_size;
+  int64_t _max_bytes;
+  int64_t _bytes = 0;
+  int64_t _hits = 0;
+  int64_t _misses = 0;
+  int64_t _evictions = 0;
+  uint64_t _next_id = 0;
 };
 
 // Since ATen is separated into CPU build and CUDA build, we need a way to call
@@ -473,5 +615,14 @@ int64_t cufft_get_plan_cache_max_size_impl(int64_t device_index);
 void cufft_set_plan_cache_max_size_impl(int64_t device_index, int64_t max_size);
 int64_t cufft_get_plan_cache_size_impl(int64_t device_index);
 void cufft_clear_plan_cache_impl(int64_t device_index);
+// _cufft_get_plan_cache_max_bytes, _cufft_set_plan_cache_max_bytes,
+// _cufft_get_plan_cache_bytes, and _cufft_get_plan_cache_{hits,misses,evictions}
+// are plumbed the same way.
+int64_t cufft_get_plan_cache_max_bytes_impl(int64_t device_index);
+void cufft_set_plan_cache_max_bytes_impl(int64_t device_index, int64_t max_bytes);
+int64_t cufft_get_plan_cache_bytes_impl(int64_t device_index);
+int64_t cufft_get_plan_cache_hits_impl(int64_t device_index);
+int64_t cufft_get_plan_cache_misses_impl(int64_t device_index);
+int64_t cufft_get_plan_cache_evictions_impl(int64_t device_index);
 
 }}} // namespace at::native::detail
@@ -0,0 +1,253 @@
+#include <ATen/ATen.h>
+#include <ATen/AccumulateType.h>
+#include <ATen/Dispatch.h>
+#include <ATen/NativeFunctions.h>
+#include <ATen/cuda/CUDAContext.h>
+#include <ATen/cuda/detail/KernelUtils.h>
+#include <ATen/native/Detection.h>
+#include <c10/cuda/CUDAGuard.h>
+#include <c10/macros/Macros.h>
+
+#include <THC/THCAtomics.cuh>
+
+namespace at { namespace native {
+
+using namespace at::cuda::detail;
+
+namespace {
+
+constexpr int kBoxesPerWord = 64;
+// The greedy pass keeps the suppressed bits of all boxes in shared memory.
+constexpr int64_t kMaxNmsWords = 48 * 1024 / sizeof(unsigned long long);
+
+template <typename scalar_t, typename accscalar_t>
+__device__ __forceinline__ RoIAlignBins<accscalar_t> load_roi_align_bins(
+    const scalar_t* rois, int n, accscalar_t spatial_scale, int pooled_height, int pooled_width,
+    int sampling_ratio, bool aligned) {
+  accscalar_t roi[5];
+  #pragma unroll
+  for (int i = 0; i < 5; i++) {
+    roi[i] = static_cast<accscalar_t>(rois[n * 5 + i]);
+  }
+  return roi_align_bins(roi, spatial_scale, pooled_height, pooled_width, sampling_ratio, aligned);
+}
+
+template <typename scalar_t, typename accscalar_t>
+C10_LAUNCH_BOUNDS_1(CUDA_NUM_THREADS)
+__global__ void roi_align_forward_kernel(
+    const int nthreads, const scalar_t* input, const scalar_t* rois, const accscalar_t spatial_scale,
+    const int channels, const int height, const int width, const int pooled_height,
+    const int pooled_width, const int sampling_ratio, const bool aligned, scalar_t* output) {
+  CUDA_KERNEL_LOOP(index, nthreads) {
+    // (n, c, ph, pw) is an element of the output
+    const int pw = index % pooled_width;
+    const int ph = (index / pooled_width) % pooled_height;
+    const int c = (index / pooled_width / pooled_height) % channels;
+    const int n = index / pooled_width / pooled_height / channels;
+
+    const auto bins = load_roi_align_bins<scalar_t, accscalar_t>(
+        rois, n, spatial_scale, pooled_height, pooled_width, sampling_ratio, aligned);
+    const scalar_t* plane = input + (static_cast<int64_t>(bins.batch) * channels + c) * height * width;
+
+    accscalar_t val = 0;
+    roi_align_for_each_sample(bins, height, width, ph, pw,
+        [&](int y_low, int y_high, int x_low, int x_high,
+            accscalar_t w1, accscalar_t w2, accscalar_t w3, accscalar_t w4) {
+          val += w1 * static_cast<accscalar_t>(plane[y_low * width + x_low]) +
+              w2 * static_cast<accscalar_t>(plane[y_low * width + x_high]) +
+              w3 * static_cast<accscalar_t>(plane[y_high * width + x_low]) +
+              w4 * static_cast<accscalar_t>(plane[y_high * width + x_high]);
+        });
+    output[index] = static_cast<scalar_t>(val);
+  }
+}
+
+template <typename scalar_t, typename accscalar_t>
+C10_LAUNCH_BOUNDS_1(CUDA_NUM_THREADS)
+__global__ void roi_align_backward_kernel(
+    const int nthreads, const scalar_t* grad, const scalar_t* rois, const accscalar_t spatial_scale,
+    const int channels, const int height, const int width, const int pooled_height,
+    const int pooled_width, const int sampling_ratio, const bool aligned, scalar_t* grad_input) {
+  CUDA_KERNEL_LOOP(index, nthreads) {
+    const int pw = index % pooled_width;
+    const int ph = (index / pooled_width) % pooled_height;
+    const int c = (index / pooled_width / pooled_height) % channels;
+    const int n = index / pooled_width / pooled_height / channels;
+
+    const auto bins = load_roi_align_bins<scalar_t, accscalar_t>(
+        rois, n, spatial_scale, pooled_height, pooled_width, sampling_ratio, aligned);
+    scalar_t* plane = grad_input + (static_cast<int64_t>(bins.batch) * channels + c) * height * width;
+    const accscalar_t g = static_cast<accscalar_t>(grad[index]);
+
+    roi_align_for_each_sample(bins, height, width, ph, pw,
+        [&](int y_low, int y_high, int x_low, int x_high,
+            accscalar_t w1, accscalar_t w2, accscalar_t w3, accscalar_t w4) {
+          atomicAdd(plane + y_low * width + x_low, static_cast<scalar_t>(g * w1));
+          atomicAdd(plane + y_low * width + x_high, static_cast<scalar_t>(g * w2));
+          atomicAdd(plane + y_high * width + x_low, static_cast<scalar_t>(g * w3));
+          atomicAdd(plane + y_high * width + x_high, static_cast<scalar_t>(g * w4));
+        });
+  }
+}
+
+// Block (row_block, col_block) compares kBoxesPerWord boxes with as many
+// others; thread t sets bit j of mask[row * num_words + col_block] if box
+// row = row_block * 64 + t suppresses box col_block * 64 + j. Boxes are
+// sorted by decreasing score, so only the upper triangle is computed.
+template <typename scalar_t>
+C10_LAUNCH_BOUNDS_1(kBoxesPerWord)
+__global__ void nms_mask_kernel(
+    const int num_boxes, const scalar_t* boxes, const scalar_t iou_threshold, unsigned long long* mask) {
+  const int row_block = blockIdx.y;
+  const int col_block = blockIdx.x;
+  if (row_block > col_block) {
+    return;
+  }
+  const int num_words = (num_boxes + kBoxesPerWord - 1) / kBoxesPerWord;
+  const int row_size = min(num_boxes - row_block * kBoxesPerWord, kBoxesPerWord);
+  const int col_size = min(num_boxes - col_block * kBoxesPerWord, kBoxesPerWord);
+
+  __shared__ scalar_t col_boxes[kBoxesPerWord * 4];
+  if (threadIdx.x < col_size) {
+    #pragma unroll
+    for (int i = 0; i < 4; i++) {
+      col_boxes[threadIdx.x * 4 + i] = boxes[(col_block * kBoxesPerWord + threadIdx.x) * 4 + i];
+    }
+  }
+  __syncthreads();
+
+  if (threadIdx.x < row_size) {
+    const int row = row_block * kBoxesPerWord + threadIdx.x;
+    const scalar_t* box = boxes + row * 4;
+    unsigned long long bits = 0;
+    for (int j = row_block == col_block ? threadIdx.x + 1 : 0; j < col_size; j++) {
+      if (nms_iou_above(box, col_boxes + j * 4, iou_threshold)) {
+        bits |= 1ULL << j;
+      }
+    }
+    mask[static_cast<int64_t>(row) * num_words + col_block] = bits;
+  }
+}
+
+// The greedy pass of NMS in a single block, so that the mask never leaves
+// the device: box i is kept unless a kept box before it suppresses it.
+__global__ void nms_reduce_kernel(
+    const int num_boxes, const unsigned long long* mask, bool* keep) {
+  extern __shared__ unsigned long long removed[];
+  const int num_words = (num_boxes + kBoxesPerWord - 1) / kBoxesPerWord;
+  for (int w = threadIdx.x; w < num_words; w += blockDim.x) {
+    removed[w] = 0;
+  }
+  __syncthreads();
+
+  for (int i = 0; i < num_boxes; i++) {
+    const int word = i / kBoxesPerWord;
+    const bool is_kept = !(removed[word] & (1ULL << (i % kBoxesPerWord)));
+    __syncthreads();
+    if (is_kept) {
+      const unsigned long long* row = mask + static_cast<int64_t>(i) * num_words;
+      for (int w = word + threadIdx.x; w < num_words; w += blockDim.x) {
+        removed[w] |= row[w];
+      }
+    }
+    if (threadIdx.x == 0) {
+      keep[i] = is_kept;
+    }
+    __syncthreads();
+  }
+}
+
+} // namespace
+
+Tensor roi_align_cuda(
+    const Tensor& input, const Tensor& rois, double spatial_scale, int64_t pooled_height,
+    int64_t pooled_width, int64_t sampling_ratio, bool aligned) {
+  check_roi_align_inputs(input, rois, pooled_height, pooled_width);
+  const cuda::CUDAGuard device_guard(input.device());
+  auto output = at::empty({rois.size(0), input.size(1), pooled_height, pooled_width}, input.options());
+  const int64_t output_size = output.numel();
+  if (output_size == 0) {
+    return output;
+  }
+  TORCH_CHECK(output_size <= std::numeric_limits<int>::max() && input.numel() <= std::numeric_limits<int>::max(),
+      "roi_align: input and output are too large for 32-bit indexing");
+  auto input_contig = input.contiguous();
+  auto rois_contig = rois.contiguous();
+  auto stream = at::cuda::getCurrentCUDAStream();
+  AT_DISPATCH_FLOATING_TYPES_AND_HALF(input.scalar_type(), "roi_align", [&] {
+    using accscalar_t = acc_type<scalar_t, true>;
+    roi_align_forward_kernel<scalar_t, accscalar_t>
+        <<<GET_BLOCKS(output_size), CUDA_NUM_THREADS, 0, stream>>>(
+            output_size, input_contig.data_ptr<scalar_t>(), rois_contig.data_ptr<scalar_t>(),
+            static_cast<accscalar_t>(spatial_scale), input.size(1), input.size(2), input.size(3),
+            pooled_height, pooled_width, sampling_ratio, aligned, output.data_ptr<scalar_t>());
+  });
+  AT_CUDA_CHECK(cudaGetLastError());
+  return output;
+}
+
+Tensor roi_align_backward_cuda(
+    const Tensor& grad, const Tensor& rois, double spatial_scale, int64_t pooled_height,
+    int64_t pooled_width, int64_t batch_size, int64_t channels, int64_t height, int64_t width,
+    int64_t sampling_ratio, bool aligned) {
+  TORCH_CHECK(grad.dim() == 4 && grad.size(0) == rois.size(0) && grad.size(2) == pooled_height &&
+      grad.size(3) == pooled_width, "_roi_align_backward: expected grad of size (",
+      rois.size(0), ", C, ", pooled_height, ", ", pooled_width, "), but got ", grad.sizes());
+  const cuda::CUDAGuard device_guard(grad.device());
+  auto grad_input = at::zeros({batch_size, channels, height, width}, grad.options());
+  const int64_t grad_size = grad.numel();
+  if (grad_size == 0) {
+    return grad_input;
+  }
+  TORCH_CHECK(grad_size <= std::numeric_limits<int>::max() && grad_input.numel() <= std::numeric_limits<int>::max(),
+      "_roi_align_backward: input and output are too large for 32-bit indexing");
+  auto grad_contig = grad.contiguous();
+  auto rois_contig = rois.contiguous();
+  auto stream = at::cuda::getCurrentCUDAStream();
+  AT_DISPATCH_FLOATING_TYPES_AND_HALF(grad.scalar_type(), "roi_align_backward", [&] {
+    using accscalar_t = acc_type<scalar_t, true>;
+    roi_align_backward_kernel<scalar_t, accscalar_t>
+        <<<GET_BLOCKS(grad_size), CUDA_NUM_THREADS, 0, stream>>>(
+            grad_size, grad_contig.data_ptr<scalar_t>(), rois_contig.data_ptr<scalar_t>(),
+            static_cast<accscalar_t>(spatial_scale), channels, height, width,
+            pooled_height, pooled_width, sampling_ratio, aligned, grad_input.data_ptr<scalar_t>());
+  });
+  AT_CUDA_CHECK(cudaGetLastError());
+  return grad_input;
+}
+
+Tensor nms_cuda(const Tensor& boxes, const Tensor& scores, double iou_threshold) {
+  check_nms_inputs(boxes, scores);
+  const int64_t num_boxes = boxes.size(0);
+  if (num_boxes == 0) {
+    return at::empty({0}, boxes.options().dtype(kLong));
+  }
+  const int64_t num_words = (num_boxes + kBoxesPerWord - 1) / kBoxesPerWord;
+  TORCH_CHECK(num_words <= kMaxNmsWords, "nms: at most ", kMaxNmsWords * kBoxesPerWord,
+      " boxes are supported on CUDA, but got ", num_boxes);
+
+  const cuda::CUDAGuard device_guard(boxes.device());
+  auto order = std::get<1>(scores.sort(/*dim=*/0, /*descending=*/true));
+  auto boxes_sorted = boxes.index_select(0, order).contiguous();
+  auto mask = at::empty({num_boxes * num_words}, boxes.options().dtype(kLong));
+  auto keep = at::empty({num_boxes}, boxes.options().dtype(kBool));
+  auto stream = at::cuda::getCurrentCUDAStream();
+
+  AT_DISPATCH_FLOATING_TYPES_AND_HALF(boxes.scalar_type(), "nms", [&] {
+    const dim3 grid(num_words, num_words);
+    nms_mask_kernel<scalar_t><<<grid, kBoxesPerWord, 0, stream>>>(
+        num_boxes, boxes_sorted.data_ptr<scalar_t>(), static_cast<scalar_t>(iou_threshold),
+        reinterpret_cast<unsigned long long*>(mask.data_ptr<int64_t>()));
+  });
+  AT_CUDA_CHECK(cudaGetLastError());
+
+  const int threads = std::min<int64_t>(CUDA_NUM_THREADS, (num_words + 31) / 32 * 32);
+  nms_reduce_kernel<<<1, threads, num_words * sizeof(unsigned long long), stream>>>(
+      num_boxes, reinterpret_cast<const unsigned long long*>(mask.data_ptr<int64_t>()), keep.data_ptr<bool>());
+  AT_CUDA_CHECK(cudaGetLastError());
+
+  // Reading the number of kept boxes is the only sync.
+  return order.masked_select(keep);
+}
+
+}} // namespace at::native
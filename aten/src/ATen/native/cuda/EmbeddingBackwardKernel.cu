@@ -12,10 +12,15 @@
 #include <THC/THCAtomics.cuh>
 
 #include <thrust/execution_policy.h>
+#include <thrust/iterator/constant_iterator.h>
 #include <thrust/unique.h>
 
+#include <cub/cub.cuh>
+
 #include <c10/macros/Macros.h>
 
+#include <limits>
+
 namespace at {
 namespace native {
 
@@ -181,6 +186,79 @@ __global__ void sum_and_scatter(
 
 } // anon namespace
 
+std::tuple<Tensor, Tensor, Tensor> embedding_partition_indices(
+        const Tensor &indices,
+        int64_t num_weights,
+        bool scale_grad_by_freq) {
+  const int64_t numel = indices.numel();
+  TORCH_CHECK(numel <= std::numeric_limits<int>::max(),
+      "embedding_backward: expected at most ", std::numeric_limits<int>::max(),
+      " indices, but got ", numel);
+  auto stream = at::cuda::getCurrentCUDAStream();
+  auto indices_contig = indices.contiguous();
+  auto sorted_indices = at::empty_like(indices_contig, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
+  auto orig_indices = at::empty_like(indices_contig, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
+  auto range = at::arange(numel, indices_contig.options());
+
+  // All indices are in [0, num_weights), so only the low bits that can be set
+  // have to be sorted on, e.g., 27 instead of 64 bits for 10^8 rows. The
+  // radix sort is stable, which keeps the order of equal indices. Its temporary
+  // storage comes from the caching allocator and is reused by later calls.
+  int end_bit = 1;
+  while (end_bit < 63 && (static_cast<int64_t>(1) << end_bit) < num_weights) {
+    ++end_bit;
+  }
+  const int64_t* keys_in = indices_contig.data_ptr<int64_t>();
+  int64_t* keys_out = sorted_indices.data_ptr<int64_t>();
+  const int64_t* values_in = range.data_ptr<int64_t>();
+  int64_t* values_out = orig_indices.data_ptr<int64_t>();
+  size_t temp_storage_bytes = 0;
+  AT_CUDA_CHECK(cub::DeviceRadixSort::SortPairs(
+      nullptr, temp_storage_bytes, keys_in, keys_out, values_in, values_out,
+      static_cast<int>(numel), 0, end_bit, stream));
+  auto temp_storage = at::empty(
+      {static_cast<int64_t>(temp_storage_bytes)}, indices_contig.options().dtype(kByte));
+  AT_CUDA_CHECK(cub::DeviceRadixSort::SortPairs(
+      temp_storage.data_ptr(), temp_storage_bytes, keys_in, keys_out, values_in, values_out,
+      static_cast<int>(numel), 0, end_bit, stream));
+
+  Tensor count;
+  if (scale_grad_by_freq) {
+    count = at::empty_like(indices_contig, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
+
+    auto allocator = THCThrustAllocator(globalContext().lazyInitCUDA());
+    auto policy = thrust::cuda::par(allocator).on(stream);
+    using device_ptr = thrust::device_ptr<int64_t>;
+
+    // Compute an increasing sequence per unique item in sortedIndices:
+    // sorted: 2 5 5 5 7 7 8 9 9
+    //  count: 1 1 2 3 1 2 1 1 2
+    auto sorted_data = device_ptr(sorted_indices.data_ptr<int64_t>());
+    auto count_data = device_ptr(count.data_ptr<int64_t>());
+    thrust::inclusive_scan_by_key(
+      policy,
+      sorted_data,
+      sorted_data + numel,
+      thrust::make_constant_iterator(1),
+      count_data
+    );
+
+    // Take the maximum of each count per unique key in reverse:
+    // sorted: 2 5 5 5 7 7 8 9 9
+    //  count: 1 3 3 3 2 2 1 2 2
+    thrust::inclusive_scan_by_key(
+      policy,
+      thrust::make_reverse_iterator(sorted_data + numel),
+      thrust::make_reverse_iterator(sorted_data),
+      thrust::make_reverse_iterator(count_data + numel),
+      thrust::make_reverse_iterator(count_data + numel),
+      thrust::equal_to<int64_t>(),
+      thrust::maximum<int64_t>()
+    );
+  }
+  return std::make_tuple(std::move(sorted_indices), std::move(orig_indices), std::move(count));
+}
+
 Tensor embedding_backward_cuda_kernel(
         const Tensor &grad,
         const Tensor &orig_indices,
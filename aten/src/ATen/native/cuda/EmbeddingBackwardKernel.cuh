@@ -20,6 +20,17 @@
 namespace at {
 namespace native {
 
+// Groups equal indices for the backward pass. Returns the indices ordered by
+// value, the position in `indices` of every entry of that order and, if
+// scale_grad_by_freq, how often every entry's index occurs. Equal indices
+// keep the order in which they appear in `indices`, so that the gradient
+// rows are always summed in the same order and the backward pass is
+// deterministic.
+std::tuple<Tensor, Tensor, Tensor> embedding_partition_indices(
+    const Tensor &indices,
+    int64_t num_weights,
+    bool scale_grad_by_freq);
+
 Tensor embedding_backward_cuda_kernel(
     const Tensor &grad,
     const Tensor &orig_indices,
@@ -0,0 +1,201 @@
+#include <ATen/ATen.h>
+#include <ATen/AccumulateType.h>
+#include <ATen/Dispatch.h>
+#include <ATen/native/ForeachUtils.h>
+#include <ATen/cuda/CUDAContext.h>
+#include <c10/cuda/CUDAGuard.h>
+#include <ATen/native/cuda/MultiTensorApply.cuh>
+#include <THC/THCAtomics.cuh>
+
+#include <vector>
+
+namespace at { namespace native {
+
+namespace {
+
+// ptrs holds result and self.
+template <typename scalar_t, bool is_mul>
+struct ScalarFunctor {
+  using accscalar_t = acc_type<scalar_t, true>;
+  accscalar_t scalar;
+
+  __device__ __forceinline__ void operator()(scalar_t** ptrs, int64_t i, const float* /*args*/) const {
+    const accscalar_t a = ptrs[1][i];
+    ptrs[0][i] = is_mul ? a * scalar : a + scalar;
+  }
+};
+
+// ptrs holds result, self and other.
+template <typename scalar_t, bool is_mul>
+struct ListFunctor {
+  using accscalar_t = acc_type<scalar_t, true>;
+  accscalar_t alpha;
+
+  __device__ __forceinline__ void operator()(scalar_t** ptrs, int64_t i, const float* /*args*/) const {
+    const accscalar_t a = ptrs[1][i];
+    const accscalar_t b = ptrs[2][i];
+    ptrs[0][i] = is_mul ? a * b : a + alpha * b;
+  }
+};
+
+// ptrs holds self, which is scaled by the scale on the device.
+template <typename scalar_t>
+struct TensorScaleFunctor {
+  using accscalar_t = acc_type<scalar_t, true>;
+  const accscalar_t* scale;
+
+  __device__ __forceinline__ void operator()(scalar_t** ptrs, int64_t i, const float* /*args*/) const {
+    ptrs[0][i] = static_cast<accscalar_t>(ptrs[0][i]) * *scale;
+  }
+};
+
+// Adds the sum of the squares of the chunk of the block to *sum_sq.
+template <typename scalar_t>
+struct SumSquaresFunctor {
+  using accscalar_t = acc_type<scalar_t, true>;
+  accscalar_t* sum_sq;
+
+  __device__ __forceinline__ void operator()(
+      scalar_t** ptrs, int64_t chunk_begin, int64_t chunk_end, const float* /*args*/) const {
+    __shared__ accscalar_t partials[multi_tensor::kBlockSize];
+    accscalar_t partial = 0;
+    for (int64_t i = chunk_begin + threadIdx.x; i < chunk_end; i += blockDim.x) {
+      const accscalar_t x = ptrs[0][i];
+      partial += x * x;
+    }
+    partials[threadIdx.x] = partial;
+    __syncthreads();
+    for (int stride = blockDim.x / 2; stride > 0; stride /= 2) {
+      if (threadIdx.x < stride) {
+        partials[threadIdx.x] += partials[threadIdx.x + stride];
+      }
+      __syncthreads();
+    }
+    if (threadIdx.x == 0) {
+      atomicAdd(sum_sq, partials[0]);
+    }
+  }
+};
+
+template <bool is_mul>
+void foreach_scalar_cuda_kernel(TensorList result, TensorList self, Scalar scalar) {
+  const cuda::CUDAGuard device_guard(self[0].device());
+  AT_DISPATCH_ALL_TYPES_AND(at::ScalarType::Half, self[0].scalar_type(), "_foreach_scalar_cuda", [&] {
+    using accscalar_t = acc_type<scalar_t, true>;
+    ScalarFunctor<scalar_t, is_mul> op{scalar.to<accscalar_t>()};
+    multi_tensor_apply<2, scalar_t>({{result, self}}, {}, op);
+  });
+}
+
+template <bool is_mul>
+void foreach_list_cuda_kernel(TensorList result, TensorList self, TensorList other, Scalar alpha) {
+  const cuda::CUDAGuard device_guard(self[0].device());
+  AT_DISPATCH_ALL_TYPES_AND(at::ScalarType::Half, self[0].scalar_type(), "_foreach_list_cuda", [&] {
+    using accscalar_t = acc_type<scalar_t, true>;
+    ListFunctor<scalar_t, is_mul> op{alpha.to<accscalar_t>()};
+    multi_tensor_apply<3, scalar_t>({{result, self, other}}, {}, op);
+  });
+}
+
+} // namespace
+
+std::vector<Tensor> foreach_add_scalar_cuda(TensorList tensors, Scalar scalar) {
+  if (!can_use_foreach_fast_path(tensors, scalar, /*allow_half=*/true)) {
+    return foreach_add_scalar_slow(tensors, scalar);
+  }
+  auto result = empty_like_list(tensors);
+  foreach_scalar_cuda_kernel</*is_mul=*/false>(result, tensors, scalar);
+  return result;
+}
+
+void foreach_add_scalar_cuda_(TensorList self, Scalar scalar) {
+  if (!can_use_foreach_fast_path(self, scalar, /*allow_half=*/true)) {
+    return foreach_add_scalar_slow_(self, scalar);
+  }
+  foreach_scalar_cuda_kernel</*is_mul=*/false>(self, self, scalar);
+}
+
+std::vector<Tensor> foreach_mul_scalar_cuda(TensorList tensors, Scalar scalar) {
+  if (!can_use_foreach_fast_path(tensors, scalar, /*allow_half=*/true)) {
+    return foreach_mul_scalar_slow(tensors, scalar);
+  }
+  auto result = empty_like_list(tensors);
+  foreach_scalar_cuda_kernel</*is_mul=*/true>(result, tensors, scalar);
+  return result;
+}
+
+void foreach_mul_scalar_cuda_(TensorList self, Scalar scalar) {
+  if (!can_use_foreach_fast_path(self, scalar, /*allow_half=*/true)) {
+    return foreach_mul_scalar_slow_(self, scalar);
+  }
+  foreach_scalar_cuda_kernel</*is_mul=*/true>(self, self, scalar);
+}
+
+std::vector<Tensor> foreach_add_list_cuda(TensorList tensors1, TensorList tensors2, Scalar alpha) {
+  check_foreach_lists("_foreach_add", tensors1, tensors2);
+  if (!can_use_foreach_fast_path(tensors1, tensors2, alpha, /*allow_half=*/true)) {
+    return foreach_add_list_slow(tensors1, tensors2, alpha);
+  }
+  auto result = empty_like_list(tensors1);
+  foreach_list_cuda_kernel</*is_mul=*/false>(result, tensors1, tensors2, alpha);
+  return result;
+}
+
+void foreach_add_list_cuda_(TensorList self, TensorList other, Scalar alpha) {
+  check_foreach_lists("_foreach_add_", self, other);
+  if (!can_use_foreach_fast_path(self, other, alpha, /*allow_half=*/true)) {
+    return foreach_add_list_slow_(self, other, alpha);
+  }
+  foreach_list_cuda_kernel</*is_mul=*/false>(self, self, other, alpha);
+}
+
+std::vector<Tensor> foreach_mul_list_cuda(TensorList tensors1, TensorList tensors2) {
+  check_foreach_lists("_foreach_mul", tensors1, tensors2);
+  if (!can_use_foreach_fast_path(tensors1, tensors2, 1, /*allow_half=*/true)) {
+    return foreach_mul_list_slow(tensors1, tensors2);
+  }
+  auto result = empty_like_list(tensors1);
+  foreach_list_cuda_kernel</*is_mul=*/true>(result, tensors1, tensors2, 1);
+  return result;
+}
+
+void foreach_mul_list_cuda_(TensorList self, TensorList other) {
+  check_foreach_lists("_foreach_mul_", self, other);
+  if (!can_use_foreach_fast_path(self, other, 1, /*allow_half=*/true)) {
+    return foreach_mul_list_slow_(self, other);
+  }
+  foreach_list_cuda_kernel</*is_mul=*/true>(self, self, other, 1);
+}
+
+void foreach_mul_tensor_cuda_(TensorList self, const Tensor& other) {
+  if (!can_use_foreach_scale_fast_path(self, other, /*allow_half=*/true)) {
+    return foreach_mul_tensor_slow_(self, other);
+  }
+  const cuda::CUDAGuard device_guard(self[0].device());
+  AT_DISPATCH_ALL_TYPES_AND(at::ScalarType::Half, self[0].scalar_type(), "_foreach_mul_cuda", [&] {
+    using accscalar_t = acc_type<scalar_t, true>;
+    const auto acc_options = self[0].options().dtype(caffe2::TypeMeta::Make<accscalar_t>());
+    const Tensor scale = other.to(acc_options).contiguous();
+    TensorScaleFunctor<scalar_t> op{scale.data_ptr<accscalar_t>()};
+    multi_tensor_apply<1, scalar_t>({{self}}, {}, op);
+  });
+}
+
+Tensor foreach_norm_cuda(TensorList tensors, Scalar ord) {
+  TORCH_CHECK(!tensors.empty(), "_foreach_norm: expected a non-empty list of tensors");
+  if (!can_use_foreach_norm_fast_path(tensors, ord, /*allow_half=*/true)) {
+    return foreach_norm_slow(tensors, ord);
+  }
+  const cuda::CUDAGuard device_guard(tensors[0].device());
+  Tensor result;
+  AT_DISPATCH_FLOATING_TYPES_AND_HALF(tensors[0].scalar_type(), "_foreach_norm_cuda", [&] {
+    using accscalar_t = acc_type<scalar_t, true>;
+    Tensor sum_sq = at::zeros({}, tensors[0].options().dtype(caffe2::TypeMeta::Make<accscalar_t>()));
+    SumSquaresFunctor<scalar_t> op{sum_sq.data_ptr<accscalar_t>()};
+    multi_tensor_apply_chunks<1, scalar_t>({{tensors}}, {}, op);
+    result = sum_sq.sqrt_().to(tensors[0].scalar_type());
+  });
+  return result;
+}
+
+}} // namespace at::native
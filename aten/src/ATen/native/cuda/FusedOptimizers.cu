@@ -0,0 +1,157 @@
+#include <ATen/ATen.h>
+#include <ATen/AccumulateType.h>
+#include <ATen/Dispatch.h>
+#include <ATen/cuda/CUDAContext.h>
+#include <c10/cuda/CUDAGuard.h>
+#include <ATen/native/cuda/MultiTensorApply.cuh>
+
+#include <cmath>
+#include <vector>
+
+namespace at { namespace native {
+
+namespace {
+
+// The first list holds the params.
+void check_multi_tensor_lists(const char* name, std::initializer_list<TensorList> lists) {
+  TensorList params = *lists.begin();
+  TORCH_CHECK(!params.empty(), name, ": expected a non-empty list of params");
+  const Tensor& first = params[0];
+  for (TensorList list : lists) {
+    TORCH_CHECK(list.size() == params.size(), name, ": expected all lists to have the same length as params (",
+        params.size(), "), but got a list of length ", list.size());
+    for (size_t i = 0; i < list.size(); i++) {
+      TORCH_CHECK(list[i].device() == first.device() && list[i].scalar_type() == first.scalar_type(),
+          name, ": expected all tensors to be on the same device and have the same type as params[0], ",
+          "which is a ", first.toString(), " on ", first.device());
+      TORCH_CHECK(list[i].numel() == params[i].numel(), name, ": expected the tensors at index ", i,
+          " of all lists to have ", params[i].numel(), " elements, but got ", list[i].numel());
+      TORCH_CHECK(list[i].is_contiguous(), name, ": expected all tensors to be contiguous");
+    }
+  }
+}
+
+template <typename scalar_t, bool amsgrad>
+struct AdamFunctor {
+  using accscalar_t = acc_type<scalar_t, true>;
+  accscalar_t beta1;
+  accscalar_t beta2;
+  accscalar_t weight_decay;
+  accscalar_t eps;
+
+  // ptrs holds param, grad, exp_avg, exp_avg_sq and, for amsgrad,
+  // max_exp_avg_sq; args holds step_size and bias_correction2.
+  __device__ __forceinline__ void operator()(scalar_t** ptrs, int64_t i, const float* args) const {
+    const accscalar_t step_size = args[0];
+    const accscalar_t bias_correction2 = args[1];
+    accscalar_t param = ptrs[0][i];
+    accscalar_t grad = ptrs[1][i];
+    accscalar_t exp_avg = ptrs[2][i];
+    accscalar_t exp_avg_sq = ptrs[3][i];
+
+    grad += weight_decay * param;
+    exp_avg = beta1 * exp_avg + (1 - beta1) * grad;
+    exp_avg_sq = beta2 * exp_avg_sq + (1 - beta2) * grad * grad;
+    accscalar_t denom_sq = exp_avg_sq;
+    if (amsgrad) {
+      const accscalar_t max_exp_avg_sq = ::max(static_cast<accscalar_t>(ptrs[4][i]), exp_avg_sq);
+      ptrs[4][i] = max_exp_avg_sq;
+      denom_sq = max_exp_avg_sq;
+    }
+    const accscalar_t denom = ::sqrt(denom_sq / bias_correction2) + eps;
+
+    ptrs[0][i] = param - step_size * exp_avg / denom;
+    ptrs[2][i] = exp_avg;
+    ptrs[3][i] = exp_avg_sq;
+  }
+};
+
+template <typename scalar_t, bool has_momentum>
+struct SGDFunctor {
+  using accscalar_t = acc_type<scalar_t, true>;
+  accscalar_t lr;
+  accscalar_t momentum;
+  accscalar_t dampening;
+  accscalar_t weight_decay;
+  bool nesterov;
+
+  // ptrs holds param, grad and, with momentum, momentum_buffer.
+  __device__ __forceinline__ void operator()(scalar_t** ptrs, int64_t i, const float* /*args*/) const {
+    accscalar_t param = ptrs[0][i];
+    accscalar_t update = static_cast<accscalar_t>(ptrs[1][i]) + weight_decay * param;
+    if (has_momentum) {
+      const accscalar_t buf = momentum * static_cast<accscalar_t>(ptrs[2][i]) + (1 - dampening) * update;
+      ptrs[2][i] = buf;
+      update = nesterov ? update + momentum * buf : buf;
+    }
+    ptrs[0][i] = param - lr * update;
+  }
+};
+
+} // namespace
+
+void multi_tensor_adam_cuda(
+    TensorList params, TensorList grads, TensorList exp_avgs, TensorList exp_avg_sqs,
+    TensorList max_exp_avg_sqs, IntArrayRef steps, double lr, double beta1, double beta2,
+    double weight_decay, double eps, bool amsgrad) {
+  if (amsgrad) {
+    check_multi_tensor_lists("_multi_tensor_adam", {params, grads, exp_avgs, exp_avg_sqs, max_exp_avg_sqs});
+  } else {
+    check_multi_tensor_lists("_multi_tensor_adam", {params, grads, exp_avgs, exp_avg_sqs});
+  }
+  TORCH_CHECK(steps.size() == params.size(), "_multi_tensor_adam: expected one step per param, but got ",
+      steps.size(), " steps for ", params.size(), " params");
+
+  std::vector<std::array<float, multi_tensor::kMaxTensorArgs>> tensor_args(params.size());
+  for (size_t i = 0; i < params.size(); i++) {
+    TORCH_CHECK(steps[i] > 0, "_multi_tensor_adam: expected positive steps, but got ", steps[i]);
+    const double bias_correction1 = 1 - std::pow(beta1, steps[i]);
+    const double bias_correction2 = 1 - std::pow(beta2, steps[i]);
+    tensor_args[i] = {{static_cast<float>(lr / bias_correction1), static_cast<float>(bias_correction2)}};
+  }
+
+  const cuda::CUDAGuard device_guard(params[0].device());
+  AT_DISPATCH_FLOATING_TYPES_AND_HALF(params[0].scalar_type(), "_multi_tensor_adam", [&] {
+    using accscalar_t = acc_type<scalar_t, true>;
+    if (amsgrad) {
+      AdamFunctor<scalar_t, true> op{
+          static_cast<accscalar_t>(beta1), static_cast<accscalar_t>(beta2),
+          static_cast<accscalar_t>(weight_decay), static_cast<accscalar_t>(eps)};
+      multi_tensor_apply<5, scalar_t>({{params, grads, exp_avgs, exp_avg_sqs, max_exp_avg_sqs}}, tensor_args, op);
+    } else {
+      AdamFunctor<scalar_t, false> op{
+          static_cast<accscalar_t>(beta1), static_cast<accscalar_t>(beta2),
+          static_cast<accscalar_t>(weight_decay), static_cast<accscalar_t>(eps)};
+      multi_tensor_apply<4, scalar_t>({{params, grads, exp_avgs, exp_avg_sqs}}, tensor_args, op);
+    }
+  });
+}
+
+void multi_tensor_sgd_cuda(
+    TensorList params, TensorList grads, TensorList momentum_buffers, double lr,
+    double momentum, double dampening, double weight_decay, bool nesterov) {
+  const bool has_momentum = momentum != 0;
+  if (has_momentum) {
+    check_multi_tensor_lists("_multi_tensor_sgd", {params, grads, momentum_buffers});
+  } else {
+    check_multi_tensor_lists("_multi_tensor_sgd", {params, grads});
+  }
+
+  const cuda::CUDAGuard device_guard(params[0].device());
+  AT_DISPATCH_FLOATING_TYPES_AND_HALF(params[0].scalar_type(), "_multi_tensor_sgd", [&] {
+    using accscalar_t = acc_type<scalar_t, true>;
+    if (has_momentum) {
+      SGDFunctor<scalar_t, true> op{
+          static_cast<accscalar_t>(lr), static_cast<accscalar_t>(momentum),
+          static_cast<accscalar_t>(dampening), static_cast<accscalar_t>(weight_decay), nesterov};
+      multi_tensor_apply<3, scalar_t>({{params, grads, momentum_buffers}}, {}, op);
+    } else {
+      SGDFunctor<scalar_t, false> op{
+          static_cast<accscalar_t>(lr), static_cast<accscalar_t>(momentum),
+          static_cast<accscalar_t>(dampening), static_cast<accscalar_t>(weight_decay), nesterov};
+      multi_tensor_apply<2, scalar_t>({{params, grads}}, {}, op);
+    }
+  });
+}
+
+}} // namespace at::native
@@ -27,6 +27,12 @@
 //
 // See BinaryOpsKernel.cu for the complete implementation
 //
+// When all operands are contiguous, have the types the lambda expects and
+// are suitably aligned, gpu_kernel moves them with 16-byte vector loads and
+// stores (e.g. float4 or eight halfs) in a grid-stride loop; otherwise, every
+// thread handles one element. Both are picked at runtime, callers don't need
+// to do anything.
+//
 
 #include <ATen/ATen.h>
 #include <ATen/cuda/CUDAContext.h>
@@ -37,6 +43,8 @@
 #include <c10/macros/Macros.h>
 #include <c10/util/TypeCast.h>
 
+#include <thrust/tuple.h>
+
 // Marks a lambda as executable on both the host and device. The __host__
 // attribute is important so that we can access static type information from
 // the host, even if the function is typically only executed on the device.
@@ -131,6 +139,94 @@ invoke(const func_t &f, char *const C10_RESTRICT data[], const index_t strides[]
   return invoke_impl<traits>(f, data, strides, dtypes, i, Indices{});
 }
 
+// Path for contiguous operands: every thread handles vec_size consecutive
+// elements of each operand at a time, loaded and stored as one aligned vector.
+template <typename scalar_t, int vec_size>
+struct alignas(sizeof(scalar_t) * vec_size) aligned_vector {
+  scalar_t val[vec_size];
+};
+
+// The number of elements per vector, such that no operand needs more than 16
+// bytes, i.e., a single 128-bit load or store.
+template <typename traits, size_t... INDEX>
+constexpr int vectorized_size(c10::guts::index_sequence<INDEX...>) {
+  const size_t sizes[] = {sizeof(typename traits::result_type), sizeof(typename traits::template arg<INDEX>::type)...};
+  size_t max_size = 1;
+  for (size_t size : sizes) {
+    max_size = size > max_size ? size : max_size;
+  }
+  return max_size >= 16 ? 1 : (max_size >= 8 ? 2 : (max_size >= 4 ? 4 : 8));
+}
+
+template <int vec_size, typename traits, typename func_t, size_t... INDEX>
+C10_DEVICE void vectorized_apply(const func_t &f, char *const C10_RESTRICT data[], int vec_idx,
+                                 c10::guts::index_sequence<INDEX...>) {
+  using arg0_t = typename traits::result_type;
+  thrust::tuple<aligned_vector<typename traits::template arg<INDEX>::type, vec_size>...> args{
+    reinterpret_cast<const aligned_vector<typename traits::template arg<INDEX>::type, vec_size>*>(data[INDEX + 1])[vec_idx]...
+  };
+  aligned_vector<arg0_t, vec_size> out;
+  #pragma unroll
+  for (int i = 0; i < vec_size; i++) {
+    out.val[i] = f(thrust::get<INDEX>(args).val[i]...);
+  }
+  reinterpret_cast<aligned_vector<arg0_t, vec_size>*>(data[0])[vec_idx] = out;
+}
+
+template <typename traits, typename func_t, size_t... INDEX>
+C10_DEVICE void contiguous_apply(const func_t &f, char *const C10_RESTRICT data[], int idx,
+                                 c10::guts::index_sequence<INDEX...>) {
+  using arg0_t = typename traits::result_type;
+  reinterpret_cast<arg0_t*>(data[0])[idx] =
+    f(reinterpret_cast<const typename traits::template arg<INDEX>::type*>(data[INDEX + 1])[idx]...);
+}
+
+template<int vec_size, typename func_t, typename array_t>
+C10_LAUNCH_BOUNDS_1(launch_size_1d)
+__global__ void vectorized_elementwise_kernel(int N, func_t f, array_t data) {
+  using traits = function_traits<func_t>;
+  using Indices = c10::guts::make_index_sequence<traits::arity>;
+  int num_vecs = N / vec_size;
+  int idx = blockIdx.x * blockDim.x + threadIdx.x;
+  for (int vec_idx = idx; vec_idx < num_vecs; vec_idx += blockDim.x * gridDim.x) {
+    vectorized_apply<vec_size, traits>(f, data.data, vec_idx, Indices{});
+  }
+  // the last N % vec_size elements
+  int tail_idx = num_vecs * vec_size + idx;
+  if (tail_idx < N) {
+    contiguous_apply<traits>(f, data.data, tail_idx, Indices{});
+  }
+}
+
+template<int vec_size, typename array_t>
+static bool can_vectorize(const TensorIterator& iter, const array_t& data) {
+  if (!iter.is_contiguous()) {
+    return false;
+  }
+  for (int i = 0; i < iter.ntensors(); i++) {
+    if (reinterpret_cast<uintptr_t>(data[i]) % (vec_size * iter.element_size(i)) != 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+template<int vec_size, typename func_t, typename array_t>
+static void launch_vectorized_kernel(int64_t N, const func_t& f, array_t data) {
+  TORCH_INTERNAL_ASSERT(N > 0 && N <= std::numeric_limits<int32_t>::max());
+  // The grid-stride loop lets the grid be capped at what the device can run
+  // at once.
+  const cudaDeviceProp* prop = at::cuda::getCurrentDeviceProperties();
+  int64_t max_blocks = prop->multiProcessorCount * (prop->maxThreadsPerMultiProcessor / launch_size_1d);
+  int64_t num_vecs = N / vec_size;
+  int64_t blocks = std::min((num_vecs + launch_size_1d - 1) / launch_size_1d, max_blocks);
+  dim3 block(launch_size_1d);
+  dim3 grid(std::max<int64_t>(blocks, 1));
+  auto stream = at::cuda::getCurrentCUDAStream();
+  vectorized_elementwise_kernel<vec_size, func_t, array_t><<<grid, block, 0, stream>>>(N, f, data);
+  AT_CUDA_CHECK(cudaGetLastError());
+}
+
 template <typename func_t>
 void gpu_kernel_impl(TensorIterator& iter, const func_t& f) {
   using traits = function_traits<func_t>;
@@ -165,6 +261,11 @@ void gpu_kernel_impl(TensorIterator& iter, const func_t& f) {
         c10::cast_and_store<arg0_t>(dtypes[0], out, result);
       });
     } else {
+      constexpr int vec_size = vectorized_size<traits>(c10::guts::make_index_sequence<traits::arity>{});
+      if (vec_size > 1 && can_vectorize<vec_size>(iter, data)) {
+        launch_vectorized_kernel<vec_size>(numel, f, data);
+        return;
+      }
       launch_kernel<launch_size_1d, 1>(numel, [=]GPU_LAMBDA(int idx) {
         arg0_t* out = (arg0_t*)(data[0] + strides[0] * idx);
         *out = invoke(f, &data.data[1], &strides.data[1], idx);
@@ -0,0 +1,188 @@
+#pragma once
+
+// multi_tensor_apply runs an elementwise op over lists of tensors with as
+// few kernel launches as possible, which matters for optimizer steps over
+// hundreds of small parameters.
+//
+// The tensors are split into chunks of kChunkSize elements and every block
+// of the launch handles one chunk. Which tensor and chunk a block handles,
+// together with the data pointers and sizes of those tensors, is carried in
+// TensorListMetadata. It is passed by value, i.e., it lives in the kernel
+// parameter space in constant memory, so it is limited to 4KB in total and
+// a launch covers at most depth_to_max_tensors[depth - 1] tensors and
+// kMaxBlocks chunks; longer lists take several launches.
+//
+// `depth` is the number of lists, e.g., 4 for the params, grads, first and
+// second moments of Adam. All tensors must be contiguous, have the same
+// scalar type and be on the same device, and the i-th tensor of every list
+// must have the same number of elements.
+//
+// The op is a functor called as
+//
+//   op(scalar_t* ptrs[depth], int64_t i, const float* args)
+//
+// where ptrs are the data pointers of the current tensor of each list, i the
+// element to update and args the kMaxTensorArgs per-tensor scalars given to
+// multi_tensor_apply, e.g., the bias corrections of Adam.
+
+#include <ATen/ATen.h>
+#include <ATen/cuda/CUDAContext.h>
+#include <c10/macros/Macros.h>
+
+#include <array>
+
+namespace at { namespace native {
+
+namespace multi_tensor {
+
+constexpr int kChunkSize = 65536;
+constexpr int kBlockSize = 512;
+constexpr int kMaxBlocks = 320;
+constexpr int kMaxTensorArgs = 2;
+// Keeps sizeof(TensorListMetadata<depth>) under 4KB.
+constexpr int depth_to_max_tensors[5] = {110, 64, 48, 36, 30};
+
+template <int depth>
+struct TensorListMetadata {
+  void* addresses[depth][depth_to_max_tensors[depth - 1]];
+  int64_t sizes[depth_to_max_tensors[depth - 1]];
+  float args[depth_to_max_tensors[depth - 1]][kMaxTensorArgs];
+  unsigned char block_to_tensor[kMaxBlocks];
+  int block_to_chunk[kMaxBlocks];
+};
+
+template <int depth, typename scalar_t, typename op_t>
+C10_LAUNCH_BOUNDS_1(kBlockSize)
+__global__ void multi_tensor_apply_kernel(TensorListMetadata<depth> tl, op_t op) {
+  const int tensor_loc = tl.block_to_tensor[blockIdx.x];
+  const int64_t chunk_begin = static_cast<int64_t>(tl.block_to_chunk[blockIdx.x]) * kChunkSize;
+  const int64_t size = tl.sizes[tensor_loc];
+  const int64_t chunk_end = chunk_begin + kChunkSize < size ? chunk_begin + kChunkSize : size;
+
+  scalar_t* ptrs[depth];
+  #pragma unroll
+  for (int d = 0; d < depth; d++) {
+    ptrs[d] = static_cast<scalar_t*>(tl.addresses[d][tensor_loc]);
+  }
+  for (int64_t i = chunk_begin + threadIdx.x; i < chunk_end; i += blockDim.x) {
+    op(ptrs, i, tl.args[tensor_loc]);
+  }
+}
+
+template <int depth, typename scalar_t, typename op_t>
+C10_LAUNCH_BOUNDS_1(kBlockSize)
+__global__ void multi_tensor_apply_chunks_kernel(TensorListMetadata<depth> tl, op_t op) {
+  const int tensor_loc = tl.block_to_tensor[blockIdx.x];
+  const int64_t chunk_begin = static_cast<int64_t>(tl.block_to_chunk[blockIdx.x]) * kChunkSize;
+  const int64_t size = tl.sizes[tensor_loc];
+  const int64_t chunk_end = chunk_begin + kChunkSize < size ? chunk_begin + kChunkSize : size;
+
+  scalar_t* ptrs[depth];
+  #pragma unroll
+  for (int d = 0; d < depth; d++) {
+    ptrs[d] = static_cast<scalar_t*>(tl.addresses[d][tensor_loc]);
+  }
+  op(ptrs, chunk_begin, chunk_end, tl.args[tensor_loc]);
+}
+
+// Fills the metadata of the lists and calls launch(tl, num_blocks) for every
+// launch they take.
+template <int depth, typename launch_t>
+void for_each_launch(
+    const std::array<TensorList, depth>& lists,
+    ArrayRef<std::array<float, kMaxTensorArgs>> tensor_args,
+    const launch_t& launch) {
+  constexpr int max_tensors = depth_to_max_tensors[depth - 1];
+  static_assert(sizeof(TensorListMetadata<depth>) <= 4096,
+                "TensorListMetadata does not fit into the kernel parameter space");
+
+  const size_t num_tensors = lists[0].size();
+  TORCH_INTERNAL_ASSERT(tensor_args.empty() || tensor_args.size() == num_tensors);
+
+  TensorListMetadata<depth> tl;
+  int loc_tensor = 0;
+  int loc_block = 0;
+  for (size_t t = 0; t < num_tensors; t++) {
+    const int64_t numel = lists[0][t].numel();
+    if (numel == 0) {
+      continue;
+    }
+    tl.sizes[loc_tensor] = numel;
+    for (int d = 0; d < depth; d++) {
+      tl.addresses[d][loc_tensor] = lists[d][t].data_ptr();
+    }
+    for (int a = 0; a < kMaxTensorArgs; a++) {
+      tl.args[loc_tensor][a] = tensor_args.empty() ? 0.f : tensor_args[t][a];
+    }
+    loc_tensor++;
+
+    const int64_t num_chunks = (numel + kChunkSize - 1) / kChunkSize;
+    for (int64_t chunk = 0; chunk < num_chunks; chunk++) {
+      tl.block_to_tensor[loc_block] = loc_tensor - 1;
+      tl.block_to_chunk[loc_block] = chunk;
+      loc_block++;
+
+      const bool last_chunk = chunk == num_chunks - 1;
+      const bool tensors_full = loc_tensor == max_tensors && last_chunk;
+      const bool blocks_full = loc_block == kMaxBlocks;
+      if (tensors_full || blocks_full) {
+        launch(tl, loc_block);
+
+        loc_block = 0;
+        if (last_chunk) {
+          loc_tensor = 0;
+        } else {
+          // the rest of the current tensor goes into the next launch
+          tl.sizes[0] = tl.sizes[loc_tensor - 1];
+          for (int d = 0; d < depth; d++) {
+            tl.addresses[d][0] = tl.addresses[d][loc_tensor - 1];
+          }
+          for (int a = 0; a < kMaxTensorArgs; a++) {
+            tl.args[0][a] = tl.args[loc_tensor - 1][a];
+          }
+          loc_tensor = 1;
+        }
+      }
+    }
+  }
+  if (loc_block > 0) {
+    launch(tl, loc_block);
+  }
+}
+
+} // namespace multi_tensor
+
+// tensor_args is either empty or holds the per-tensor scalars of every
+// tensor in the lists.
+template <int depth, typename scalar_t, typename op_t>
+void multi_tensor_apply(
+    const std::array<TensorList, depth>& lists,
+    ArrayRef<std::array<float, multi_tensor::kMaxTensorArgs>> tensor_args,
+    const op_t& op) {
+  using namespace multi_tensor;
+  auto stream = at::cuda::getCurrentCUDAStream();
+  for_each_launch<depth>(lists, tensor_args, [&](const TensorListMetadata<depth>& tl, int num_blocks) {
+    multi_tensor_apply_kernel<depth, scalar_t><<<num_blocks, kBlockSize, 0, stream>>>(tl, op);
+    AT_CUDA_CHECK(cudaGetLastError());
+  });
+}
+
+// Like multi_tensor_apply, but every thread of a block calls
+//
+//   op(scalar_t* ptrs[depth], int64_t chunk_begin, int64_t chunk_end, const float* args)
+//
+// once for the whole chunk of the block, e.g. to reduce it.
+template <int depth, typename scalar_t, typename op_t>
+void multi_tensor_apply_chunks(
+    const std::array<TensorList, depth>& lists,
+    ArrayRef<std::array<float, multi_tensor::kMaxTensorArgs>> tensor_args,
+    const op_t& op) {
+  using namespace multi_tensor;
+  auto stream = at::cuda::getCurrentCUDAStream();
+  for_each_launch<depth>(lists, tensor_args, [&](const TensorListMetadata<depth>& tl, int num_blocks) {
+    multi_tensor_apply_chunks_kernel<depth, scalar_t><<<num_blocks, kBlockSize, 0, stream>>>(tl, op);
+    AT_CUDA_CHECK(cudaGetLastError());
+  });
+}
+
+}} // namespace at::native
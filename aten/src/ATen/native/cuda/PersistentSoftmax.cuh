@@ -7,6 +7,8 @@
 #include <stdint.h>
 #include <cuda_fp16.h>
 #include <c10/macros/Macros.h>
+#include <ATen/cuda/CUDAContext.h>
+#include <algorithm>
 
 namespace {
 
@@ -231,6 +233,126 @@ __global__ void softmax_warp_backward(output_t *gradInput, const input_t *grad,
     }
 }
 
+// The softmax_block_* methods handle samples of up to
+// SOFTMAX_BLOCK_THREADS * 16 elements, which are too long for one warp. One
+// block works on one sample at a time and each thread keeps ITERATIONS
+// elements of it in registers, so that the input is read only once. The
+// grid is capped at the number of blocks that fit on the device at once and
+// every block loops over the samples.
+constexpr int SOFTMAX_BLOCK_THREADS = 512;
+constexpr int SOFTMAX_BLOCK_MAX_ELEMENTS = SOFTMAX_BLOCK_THREADS * 16;
+
+// Reduces val over the block and returns the result to all threads. shared
+// must hold C10_WARP_SIZE elements and can be reused right after the call.
+template <typename acc_t, template<typename> class ReduceOp>
+__device__ __forceinline__ acc_t block_reduce(acc_t val, acc_t* shared) {
+    ReduceOp<acc_t> r;
+    warp_reduce<acc_t, 1, C10_WARP_SIZE, ReduceOp>(&val);
+    if (threadIdx.x % C10_WARP_SIZE == 0) {
+        shared[threadIdx.x / C10_WARP_SIZE] = val;
+    }
+    __syncthreads();
+    acc_t result = shared[0];
+    for (int i = 1;  i < blockDim.x / C10_WARP_SIZE;  ++i) {
+        result = r(result, shared[i]);
+    }
+    __syncthreads();
+    return result;
+}
+
+template <typename input_t, typename output_t, typename acc_t, int ITERATIONS, bool is_log_softmax>
+__global__ void softmax_block_forward(output_t *dst, const input_t *src, int batch_size, int stride, int element_count)
+{
+    __shared__ acc_t shared[C10_WARP_SIZE];
+    for (int batch = blockIdx.x;  batch < batch_size;  batch += gridDim.x) {
+        const input_t *batch_src = src + static_cast<int64_t>(batch) * stride;
+        output_t *batch_dst = dst + static_cast<int64_t>(batch) * stride;
+
+        acc_t elements[ITERATIONS];
+        acc_t max_value = -std::numeric_limits<acc_t>::infinity();
+        #pragma unroll
+        for (int it = 0;  it < ITERATIONS;  ++it) {
+            int element_index = threadIdx.x + it * blockDim.x;
+            if (element_index < element_count) {
+                elements[it] = batch_src[element_index];
+            } else {
+                elements[it] = -std::numeric_limits<acc_t>::infinity();
+            }
+            max_value = (max_value > elements[it]) ? max_value : elements[it];
+        }
+        max_value = block_reduce<acc_t, Max>(max_value, shared);
+
+        acc_t sum = 0;
+        #pragma unroll
+        for (int it = 0;  it < ITERATIONS;  ++it) {
+            if (is_log_softmax) {
+              sum += std::exp(elements[it] - max_value);
+            } else {
+              elements[it] = std::exp(elements[it] - max_value);
+              sum += elements[it];
+            }
+        }
+        sum = block_reduce<acc_t, Add>(sum, shared);
+        if (is_log_softmax) sum = max_value + std::log(sum);
+
+        #pragma unroll
+        for (int it = 0;  it < ITERATIONS;  ++it) {
+            int element_index = threadIdx.x + it * blockDim.x;
+            if (element_index < element_count) {
+                if (is_log_softmax) {
+                    batch_dst[element_index] = elements[it] - sum;
+                } else {
+                    batch_dst[element_index] = elements[it] / sum;
+                }
+            }
+        }
+    }
+}
+
+template <typename input_t, typename output_t, typename acc_t, int ITERATIONS, bool is_log_softmax>
+__global__ void softmax_block_backward(output_t *gradInput, const input_t *grad, const input_t *output, int batch_size, int stride, int element_count)
+{
+    __shared__ acc_t shared[C10_WARP_SIZE];
+    for (int batch = blockIdx.x;  batch < batch_size;  batch += gridDim.x) {
+        const int64_t batch_offset = static_cast<int64_t>(batch) * stride;
+
+        acc_t grad_reg[ITERATIONS];
+        acc_t output_reg[ITERATIONS];
+        acc_t sum = 0;
+        #pragma unroll
+        for (int it = 0;  it < ITERATIONS;  ++it) {
+            int element_index = threadIdx.x + it * blockDim.x;
+            if (element_index < element_count) {
+                grad_reg[it] = grad[batch_offset + element_index];
+                output_reg[it] = output[batch_offset + element_index];
+            } else {
+                grad_reg[it] = acc_t(0);
+                output_reg[it] = acc_t(0);
+            }
+            sum += grad_reg[it];
+        }
+        sum = block_reduce<acc_t, Add>(sum, shared);
+
+        #pragma unroll
+        for (int it = 0;  it < ITERATIONS;  ++it) {
+            int element_index = threadIdx.x + it * blockDim.x;
+            if (element_index < element_count) {
+                if (is_log_softmax) {
+                    gradInput[batch_offset + element_index] = (grad_reg[it] - std::exp(output_reg[it]) * sum);
+                } else {
+                    gradInput[batch_offset + element_index] = (grad_reg[it] - output_reg[it] * sum);
+                }
+            }
+        }
+    }
+}
+
+int softmax_block_grid_size(int batch_count) {
+    const cudaDeviceProp* prop = at::cuda::getCurrentDeviceProperties();
+    const int max_blocks = prop->multiProcessorCount * (prop->maxThreadsPerMultiProcessor / SOFTMAX_BLOCK_THREADS);
+    return std::min(batch_count, max_blocks);
+}
+
 } // end of anonymous namespace
 
 template<typename input_t, typename output_t, typename acc_t, bool is_log_softmax>
@@ -383,3 +505,53 @@ void dispatch_softmax_backward(output_t *grad_input, const input_t *grad, const
     }
 }
 
+
+template<typename input_t, typename output_t, typename acc_t, bool is_log_softmax>
+void dispatch_softmax_block_forward(output_t *dst, const input_t *src, int softmax_elements, int softmax_elements_stride, int batch_count)
+{
+    TORCH_INTERNAL_ASSERT( softmax_elements >= 0 && softmax_elements <= SOFTMAX_BLOCK_MAX_ELEMENTS );
+    if (softmax_elements == 0 || batch_count == 0) {
+        return;
+    }
+    const int blocks = softmax_block_grid_size(batch_count);
+    const int threads = SOFTMAX_BLOCK_THREADS;
+    auto stream = at::cuda::getCurrentCUDAStream();
+    if (softmax_elements <= 2 * SOFTMAX_BLOCK_THREADS) {
+        softmax_block_forward<input_t, output_t, acc_t, 2, is_log_softmax>
+            <<<blocks, threads, 0, stream>>>(dst, src, batch_count, softmax_elements_stride, softmax_elements);
+    } else if (softmax_elements <= 4 * SOFTMAX_BLOCK_THREADS) {
+        softmax_block_forward<input_t, output_t, acc_t, 4, is_log_softmax>
+            <<<blocks, threads, 0, stream>>>(dst, src, batch_count, softmax_elements_stride, softmax_elements);
+    } else if (softmax_elements <= 8 * SOFTMAX_BLOCK_THREADS) {
+        softmax_block_forward<input_t, output_t, acc_t, 8, is_log_softmax>
+            <<<blocks, threads, 0, stream>>>(dst, src, batch_count, softmax_elements_stride, softmax_elements);
+    } else {
+        softmax_block_forward<input_t, output_t, acc_t, 16, is_log_softmax>
+            <<<blocks, threads, 0, stream>>>(dst, src, batch_count, softmax_elements_stride, softmax_elements);
+    }
+}
+
+template<typename input_t, typename output_t, typename acc_t, bool is_log_softmax>
+void dispatch_softmax_block_backward(output_t *grad_input, const input_t *grad, const input_t *output, int softmax_elements, int softmax_elements_stride, int batch_count)
+{
+    TORCH_INTERNAL_ASSERT( softmax_elements >= 0 && softmax_elements <= SOFTMAX_BLOCK_MAX_ELEMENTS );
+    if (softmax_elements == 0 || batch_count == 0) {
+        return;
+    }
+    const int blocks = softmax_block_grid_size(batch_count);
+    const int threads = SOFTMAX_BLOCK_THREADS;
+    auto stream = at::cuda::getCurrentCUDAStream();
+    if (softmax_elements <= 2 * SOFTMAX_BLOCK_THREADS) {
+        softmax_block_backward<input_t, output_t, acc_t, 2, is_log_softmax>
+            <<<blocks, threads, 0, stream>>>(grad_input, grad, output, batch_count, softmax_elements_stride, softmax_elements);
+    } else if (softmax_elements <= 4 * SOFTMAX_BLOCK_THREADS) {
+        softmax_block_backward<input_t, output_t, acc_t, 4, is_log_softmax>
+            <<<blocks, threads, 0, stream>>>(grad_input, grad, output, batch_count, softmax_elements_stride, softmax_elements);
+    } else if (softmax_elements <= 8 * SOFTMAX_BLOCK_THREADS) {
+        softmax_block_backward<input_t, output_t, acc_t, 8, is_log_softmax>
+            <<<blocks, threads, 0, stream>>>(grad_input, grad, output, batch_count, softmax_elements_stride, softmax_elements);
+    } else {
+        softmax_block_backward<input_t, output_t, acc_t, 16, is_log_softmax>
+            <<<blocks, threads, 0, stream>>>(grad_input, grad, output, batch_count, softmax_elements_stride, softmax_elements);
+    }
+}
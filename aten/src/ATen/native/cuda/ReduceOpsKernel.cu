@@ -217,6 +217,43 @@ void argmin_kernel_cuda(TensorIterator& iter) {
   }
 }
 
+template <typename scalar_t, typename acc_t=scalar_t>
+void aminmax_kernel_cuda_impl(TensorIterator& iter) {
+  gpu_reduce_kernel<scalar_t, scalar_t>(
+    iter,
+    MultiReduceOps<MinOps<scalar_t, acc_t>, MaxOps<scalar_t, acc_t>>{},
+    thrust::tuple<acc_t, acc_t>(at::numeric_limits<acc_t>::upper_bound(),
+                                at::numeric_limits<acc_t>::lower_bound()));
+}
+
+void aminmax_kernel_cuda(TensorIterator& iter) {
+  if (iter.dtype() == kHalf) {
+    aminmax_kernel_cuda_impl<at::Half, float>(iter);
+  } else {
+    AT_DISPATCH_ALL_TYPES(iter.dtype(), "aminmax_cuda", [&]() {
+      aminmax_kernel_cuda_impl<scalar_t>(iter);
+    });
+  }
+}
+
+template <typename scalar_t, typename acc_t=scalar_t>
+void sum_sumsq_kernel_cuda_impl(TensorIterator& iter) {
+  gpu_reduce_kernel<scalar_t, scalar_t>(
+    iter,
+    MultiReduceOps<SumOps<scalar_t, acc_t>, SquareSumOps<scalar_t, acc_t>>{},
+    thrust::tuple<acc_t, acc_t>(0, 0));
+}
+
+void sum_sumsq_kernel_cuda(TensorIterator& iter) {
+  if (iter.dtype() == kHalf) {
+    sum_sumsq_kernel_cuda_impl<at::Half, float>(iter);
+  } else {
+    AT_DISPATCH_FLOATING_TYPES(iter.dtype(), "sum_sumsq_cuda", [&]() {
+      sum_sumsq_kernel_cuda_impl<scalar_t>(iter);
+    });
+  }
+}
+
 REGISTER_DISPATCH(std_var_stub, &std_var_kernel_cuda);
 REGISTER_DISPATCH(sum_stub, &sum_kernel_cuda);
 REGISTER_DISPATCH(prod_stub, &prod_kernel_cuda);
@@ -228,5 +265,7 @@ REGISTER_DISPATCH(max_values_stub, &max_values_kernel_cuda);
 REGISTER_DISPATCH(min_values_stub, &min_values_kernel_cuda);
 REGISTER_DISPATCH(argmax_stub, &argmax_kernel_cuda);
 REGISTER_DISPATCH(argmin_stub, &argmin_kernel_cuda);
+REGISTER_DISPATCH(aminmax_stub, &aminmax_kernel_cuda);
+REGISTER_DISPATCH(sum_sumsq_stub, &sum_sumsq_kernel_cuda);
 
 }} // namespace at::native
@@ -0,0 +1,186 @@
+#include <ATen/ATen.h>
+#include <ATen/AccumulateType.h>
+#include <ATen/Dispatch.h>
+#include <ATen/cuda/CUDAContext.h>
+#include <ATen/native/SegmentReduce.h>
+
+#include <THC/THCNumerics.cuh>
+
+#include <c10/macros/Macros.h>
+
+// One thread per output element and a read-only walk over the rows of its
+// segment, so neither direction needs atomics: every output element of the
+// forward and every row of the backward has a single writer.
+
+namespace at {
+namespace native {
+
+namespace {
+
+constexpr int kThreads = 256;
+
+template <typename scalar_t, typename accscalar_t>
+__global__ void segment_reduce_kernel(
+    scalar_t* output,
+    int64_t* arg_max,
+    const scalar_t* data,
+    const int64_t* offsets,
+    int64_t num_segments,
+    int64_t inner,
+    int64_t reduce) {
+  const int64_t total = num_segments * inner;
+  for (int64_t idx = blockIdx.x * blockDim.x + threadIdx.x; idx < total;
+       idx += blockDim.x * gridDim.x) {
+    const int64_t s = idx / inner;
+    const int64_t d = idx % inner;
+    const int64_t row_begin = offsets[s];
+    const int64_t row_end = offsets[s + 1];
+    if (reduce == SEGMENT_MAX) {
+      if (row_begin == row_end) {
+        output[idx] = scalar_t(0);
+        arg_max[idx] = -1;
+        continue;
+      }
+      scalar_t max_val = data[row_begin * inner + d];
+      int64_t max_row = row_begin;
+      for (int64_t r = row_begin + 1; r < row_end; r++) {
+        const scalar_t val = data[r * inner + d];
+        if (val > max_val || THCNumerics<scalar_t>::isnan(val)) {
+          max_val = val;
+          max_row = r;
+        }
+      }
+      output[idx] = max_val;
+      arg_max[idx] = max_row;
+    } else {
+      accscalar_t sum = 0;
+      for (int64_t r = row_begin; r < row_end; r++) {
+        sum += static_cast<accscalar_t>(data[r * inner + d]);
+      }
+      if (reduce == SEGMENT_MEAN && row_end > row_begin) {
+        sum /= static_cast<accscalar_t>(row_end - row_begin);
+      }
+      output[idx] = static_cast<scalar_t>(sum);
+    }
+  }
+}
+
+// Finds the segment of every row with a binary search over the offsets.
+template <typename scalar_t, typename accscalar_t>
+__global__ void segment_reduce_backward_kernel(
+    scalar_t* grad_input,
+    const scalar_t* grad,
+    const int64_t* offsets,
+    int64_t num_segments,
+    int64_t num_rows,
+    int64_t inner,
+    int64_t reduce) {
+  const int64_t total = num_rows * inner;
+  for (int64_t idx = blockIdx.x * blockDim.x + threadIdx.x; idx < total;
+       idx += blockDim.x * gridDim.x) {
+    const int64_t r = idx / inner;
+    const int64_t d = idx % inner;
+    // last segment whose first row is <= r
+    int64_t lo = 0;
+    int64_t hi = num_segments;
+    while (hi - lo > 1) {
+      const int64_t mid = lo + (hi - lo) / 2;
+      if (offsets[mid] <= r) {
+        lo = mid;
+      } else {
+        hi = mid;
+      }
+    }
+    accscalar_t g = static_cast<accscalar_t>(grad[lo * inner + d]);
+    if (reduce == SEGMENT_MEAN) {
+      g /= static_cast<accscalar_t>(offsets[lo + 1] - offsets[lo]);
+    }
+    grad_input[idx] = static_cast<scalar_t>(g);
+  }
+}
+
+template <typename scalar_t>
+__global__ void segment_max_backward_kernel(
+    scalar_t* grad_input,
+    const scalar_t* grad,
+    const int64_t* arg_max,
+    int64_t num_segments,
+    int64_t inner) {
+  const int64_t total = num_segments * inner;
+  for (int64_t idx = blockIdx.x * blockDim.x + threadIdx.x; idx < total;
+       idx += blockDim.x * gridDim.x) {
+    const int64_t row = arg_max[idx];
+    if (row >= 0) {
+      grad_input[row * inner + idx % inner] = grad[idx];
+    }
+  }
+}
+
+dim3 grid_for(int64_t total) {
+  const int64_t max_blocks = at::cuda::getCurrentDeviceProperties()->multiProcessorCount * 8;
+  return dim3(std::min<int64_t>(max_blocks, (total + kThreads - 1) / kThreads));
+}
+
+void segment_reduce_kernel_cuda(
+    Tensor& output,
+    Tensor& arg_max,
+    const Tensor& data,
+    const Tensor& offsets,
+    int64_t reduce) {
+  const int64_t num_segments = offsets.numel() - 1;
+  const int64_t inner = output.numel() / num_segments;
+  cudaStream_t stream = at::cuda::getCurrentCUDAStream();
+  AT_DISPATCH_FLOATING_TYPES_AND_HALF(data.scalar_type(), "segment_reduce_cuda", [&] {
+    using accscalar_t = acc_type<scalar_t, true>;
+    segment_reduce_kernel<scalar_t, accscalar_t><<<grid_for(output.numel()), kThreads, 0, stream>>>(
+        output.data_ptr<scalar_t>(),
+        reduce == SEGMENT_MAX ? arg_max.data_ptr<int64_t>() : nullptr,
+        data.data_ptr<scalar_t>(),
+        offsets.data_ptr<int64_t>(),
+        num_segments,
+        inner,
+        reduce);
+  });
+  AT_CUDA_CHECK(cudaGetLastError());
+}
+
+void segment_reduce_backward_kernel_cuda(
+    Tensor& grad_input,
+    const Tensor& grad,
+    const Tensor& offsets,
+    const Tensor& arg_max,
+    int64_t reduce) {
+  const int64_t num_segments = offsets.numel() - 1;
+  const int64_t inner = grad.numel() / num_segments;
+  const int64_t num_rows = grad_input.size(0);
+  cudaStream_t stream = at::cuda::getCurrentCUDAStream();
+  AT_DISPATCH_FLOATING_TYPES_AND_HALF(grad.scalar_type(), "segment_reduce_backward_cuda", [&] {
+    using accscalar_t = acc_type<scalar_t, true>;
+    if (reduce == SEGMENT_MAX) {
+      segment_max_backward_kernel<scalar_t><<<grid_for(grad.numel()), kThreads, 0, stream>>>(
+          grad_input.data_ptr<scalar_t>(),
+          grad.data_ptr<scalar_t>(),
+          arg_max.data_ptr<int64_t>(),
+          num_segments,
+          inner);
+    } else {
+      segment_reduce_backward_kernel<scalar_t, accscalar_t><<<grid_for(grad_input.numel()), kThreads, 0, stream>>>(
+          grad_input.data_ptr<scalar_t>(),
+          grad.data_ptr<scalar_t>(),
+          offsets.data_ptr<int64_t>(),
+          num_segments,
+          num_rows,
+          inner,
+          reduce);
+    }
+  });
+  AT_CUDA_CHECK(cudaGetLastError());
+}
+
+} // namespace
+
+REGISTER_DISPATCH(segment_reduce_stub, &segment_reduce_kernel_cuda);
+REGISTER_DISPATCH(segment_reduce_backward_stub, &segment_reduce_backward_kernel_cuda);
+
+} // namespace native
+} // namespace at
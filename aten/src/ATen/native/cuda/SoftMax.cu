@@ -516,6 +516,9 @@ Tensor host_softmax(const Tensor & input_, const int64_t dim_, const bool half_t
         if (dim_size <= 1024 && dim_size*sizeof(scalar_t) <= 4096) {
           dispatch_softmax_forward<scalar_t, scalar_t, accscalar_t, is_log_softmax>(
               output.data_ptr<scalar_t>(), input.data_ptr<scalar_t>(), dim_size, dim_size, outer_size);
+        } else if (dim_size <= SOFTMAX_BLOCK_MAX_ELEMENTS) {
+          dispatch_softmax_block_forward<scalar_t, scalar_t, accscalar_t, is_log_softmax>(
+              output.data_ptr<scalar_t>(), input.data_ptr<scalar_t>(), dim_size, dim_size, outer_size);
         } else {
           cunn_SoftMaxForward<ILP, scalar_t, accscalar_t, scalar_t, Epilogue>
             <<<grid, block, block.x * sizeof(accscalar_t), stream>>>(
@@ -526,6 +529,9 @@ Tensor host_softmax(const Tensor & input_, const int64_t dim_, const bool half_t
         if (dim_size <= 1024 && dim_size*sizeof(scalar_t) <= 4096) {
           dispatch_softmax_forward<scalar_t, accscalar_t, accscalar_t, is_log_softmax>(
               output.data_ptr<accscalar_t>(), input.data_ptr<scalar_t>(), dim_size, dim_size, outer_size);
+        } else if (dim_size <= SOFTMAX_BLOCK_MAX_ELEMENTS) {
+          dispatch_softmax_block_forward<scalar_t, accscalar_t, accscalar_t, is_log_softmax>(
+              output.data_ptr<accscalar_t>(), input.data_ptr<scalar_t>(), dim_size, dim_size, outer_size);
         } else {
           cunn_SoftMaxForward<ILP, scalar_t, accscalar_t, accscalar_t, Epilogue>
             <<<grid, block, block.x * sizeof(accscalar_t), stream>>>(
@@ -600,6 +606,9 @@ Tensor host_softmax_backward(const Tensor &grad_, const Tensor &output_, int64_t
       if (dim_size <= 1024 && dim_size*sizeof(scalar_t) <= 4096) {
         dispatch_softmax_backward<scalar_t, scalar_t, accscalar_t, is_log_softmax>(
             gI.data_ptr<scalar_t>(), grad.data_ptr<scalar_t>(), output.data_ptr<scalar_t>(), dim_size, dim_size, outer_size);
+      } else if (dim_size <= SOFTMAX_BLOCK_MAX_ELEMENTS) {
+        dispatch_softmax_block_backward<scalar_t, scalar_t, accscalar_t, is_log_softmax>(
+            gI.data_ptr<scalar_t>(), grad.data_ptr<scalar_t>(), output.data_ptr<scalar_t>(), dim_size, dim_size, outer_size);
       } else {
         cunn_SoftMaxBackward<ILP, scalar_t, accscalar_t, scalar_t, Epilogue>
          <<<grid, block, block.x * sizeof(accscalar_t), stream>>>(
@@ -610,6 +619,9 @@ Tensor host_softmax_backward(const Tensor &grad_, const Tensor &output_, int64_t
       if (dim_size <= 1024 && dim_size*sizeof(scalar_t) <= 4096) {
         dispatch_softmax_backward<accscalar_t, scalar_t, accscalar_t, is_log_softmax>(
             gI.data_ptr<scalar_t>(), grad.data_ptr<accscalar_t>(), output.data_ptr<accscalar_t>(), dim_size, dim_size, outer_size);
+      } else if (dim_size <= SOFTMAX_BLOCK_MAX_ELEMENTS) {
+        dispatch_softmax_block_backward<accscalar_t, scalar_t, accscalar_t, is_log_softmax>(
+            gI.data_ptr<scalar_t>(), grad.data_ptr<accscalar_t>(), output.data_ptr<accscalar_t>(), dim_size, dim_size, outer_size);
       } else {
         cunn_SoftMaxBackward<ILP, scalar_t, accscalar_t, accscalar_t, Epilogue>
          <<<grid, block, block.x * sizeof(accscalar_t), stream>>>(
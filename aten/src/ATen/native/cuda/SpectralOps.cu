@@ -262,7 +262,9 @@ static inline Tensor _run_cufft(
 }
 
 // The cuFFT plan cache, defined in CuFFTUtils.h
-std::vector<optional<CuFFTParamsLRUCache>> plan_caches;
+// The caches are held by pointer so that growing the vector does not move a
+// cache that another thread is using.
+std::vector<std::unique_ptr<CuFFTParamsLRUCache>> plan_caches;
 std::mutex plan_caches_mutex;
 
 static inline
@@ -276,7 +278,7 @@ CuFFTParamsLRUCache &cufft_get_plan_cache(int64_t device_index) {
   }
 
   if (!plan_caches[device_index]) {
-    plan_caches[device_index].emplace();
+    plan_caches[device_index] = c10::guts::make_unique<CuFFTParamsLRUCache>();
   }
 
   return *plan_caches[device_index];
@@ -285,38 +287,64 @@ CuFFTParamsLRUCache &cufft_get_plan_cache(int64_t device_index) {
 
 namespace detail {
 
+#define CUFFT_CHECK_DEVICE_INDEX(name, device_index)                                    \
+  TORCH_CHECK(0 <= device_index && device_index < at::detail::getCUDAHooks().getNumGPUs(), \
+    name ": expected 0 <= device_index < ",                                             \
+    at::detail::getCUDAHooks().getNumGPUs(), "], but got device_index=",                \
+    device_index)
+
 int64_t cufft_get_plan_cache_max_size_impl(int64_t device_index) {
-  TORCH_CHECK(0 <= device_index && device_index < at::detail::getCUDAHooks().getNumGPUs(),
-    "cufft_get_plan_cache_max_size: expected 0 <= device_index < ",
-    at::detail::getCUDAHooks().getNumGPUs(), "], but got device_index=",
-    device_index);
+  CUFFT_CHECK_DEVICE_INDEX("cufft_get_plan_cache_max_size", device_index);
   return cufft_get_plan_cache(device_index).max_size();
 }
 
 void cufft_set_plan_cache_max_size_impl(int64_t device_index, int64_t max_size) {
-  TORCH_CHECK(0 <= device_index && device_index < at::detail::getCUDAHooks().getNumGPUs(),
-    "cufft_set_plan_cache_max_size: expected 0 <= device_index < ",
-    at::detail::getCUDAHooks().getNumGPUs(), "], but got device_index=",
-    device_index);
+  CUFFT_CHECK_DEVICE_INDEX("cufft_set_plan_cache_max_size", device_index);
   return cufft_get_plan_cache(device_index).resize(max_size);
 }
 
 int64_t cufft_get_plan_cache_size_impl(int64_t device_index) {
-  TORCH_CHECK(0 <= device_index && device_index < at::detail::getCUDAHooks().getNumGPUs(),
-    "cufft_get_plan_cache_size: expected 0 <= device_index < ",
-    at::detail::getCUDAHooks().getNumGPUs(), "], but got device_index=",
-    device_index);
+  CUFFT_CHECK_DEVICE_INDEX("cufft_get_plan_cache_size", device_index);
   return cufft_get_plan_cache(device_index).size();
 }
 
 void cufft_clear_plan_cache_impl(int64_t device_index) {
-  TORCH_CHECK(0 <= device_index && device_index < at::detail::getCUDAHooks().getNumGPUs(),
-    "cufft_clear_plan_cache: expected 0 <= device_index < ",
-    at::detail::getCUDAHooks().getNumGPUs(), "], but got device_index=",
-    device_index);
+  CUFFT_CHECK_DEVICE_INDEX("cufft_clear_plan_cache", device_index);
   return cufft_get_plan_cache(device_index).clear();
 }
 
+int64_t cufft_get_plan_cache_max_bytes_impl(int64_t device_index) {
+  CUFFT_CHECK_DEVICE_INDEX("cufft_get_plan_cache_max_bytes", device_index);
+  return cufft_get_plan_cache(device_index).max_bytes();
+}
+
+void cufft_set_plan_cache_max_bytes_impl(int64_t device_index, int64_t max_bytes) {
+  CUFFT_CHECK_DEVICE_INDEX("cufft_set_plan_cache_max_bytes", device_index);
+  return cufft_get_plan_cache(device_index).set_max_bytes(max_bytes);
+}
+
+int64_t cufft_get_plan_cache_bytes_impl(int64_t device_index) {
+  CUFFT_CHECK_DEVICE_INDEX("cufft_get_plan_cache_bytes", device_index);
+  return cufft_get_plan_cache(device_index).bytes();
+}
+
+int64_t cufft_get_plan_cache_hits_impl(int64_t device_index) {
+  CUFFT_CHECK_DEVICE_INDEX("cufft_get_plan_cache_hits", device_index);
+  return cufft_get_plan_cache(device_index).hits();
+}
+
+int64_t cufft_get_plan_cache_misses_impl(int64_t device_index) {
+  CUFFT_CHECK_DEVICE_INDEX("cufft_get_plan_cache_misses", device_index);
+  return cufft_get_plan_cache(device_index).misses();
+}
+
+int64_t cufft_get_plan_cache_evictions_impl(int64_t device_index) {
+  CUFFT_CHECK_DEVICE_INDEX("cufft_get_plan_cache_evictions", device_index);
+  return cufft_get_plan_cache(device_index).evictions();
+}
+
+#undef CUFFT_CHECK_DEVICE_INDEX
+
 } // namespace at::native::detail
 
 // cuFFT
@@ -357,32 +385,23 @@ Tensor _fft_cufft(const Tensor& self, int64_t signal_ndim,
   // futher cuFFT parameter computation and plan creation to the helper class
   // CuFFTConfig in CuFFTUtils.h.
 
-  // If plan caching is enabled, we check the cache. Note that this accesses
-  // plan_cache.max_size() and thus makes this function less functional.
-  // However, integrating additional arguments into the "public" level c++ APIs,
-  // e.g., irfft, is difficult as we have a long call sequence looking like
+  // We check the plan cache, which creates the plan without caching it if
+  // caching is disabled. Note that this accesses the cache's max_size and
+  // thus makes this function less functional. However, integrating additional
+  // arguments into the "public" level c++ APIs, e.g., irfft, is difficult as
+  // we have a long call sequence looking like
   //   irfft --> _fft --> _fft_with_size --dispatching-to-> _fft_cufft
-
-  // This read is not locked for perf reason. Shouldn't matter too much because
-  // we check again after acquiring the lock.
-  if (plan_cache.max_size() > 0) {
-    CuFFTParams params;
-    setCuFFTParams(&params, input, signal_ndim, complex_input,
-      complex_output, checked_signal_sizes, onesided);
-    std::lock_guard<std::mutex> guard(plan_cache.mutex);
-    if (plan_cache.max_size() > 0) {  // check again after acquiring the lock
-      const CuFFTConfig &config = plan_cache.try_emplace_value(std::move(params),
-                                             input, signal_ndim, complex_input,
-                                             complex_output, checked_signal_sizes,
-                                             onesided, output_sizes);
-      return _run_cufft(config, input, signal_ndim, complex_input,
-                        complex_output, inverse, checked_signal_sizes, normalized,
-                        onesided, output_sizes, input_was_cloned);
-    }
-  }
-  CuFFTConfig config(input, signal_ndim, complex_input, complex_output,
-                     checked_signal_sizes, onesided, output_sizes);
-  return _run_cufft(config, input, signal_ndim, complex_input,
+  CuFFTParams params;
+  setCuFFTParams(&params, input, signal_ndim, complex_input,
+    complex_output, checked_signal_sizes, onesided);
+  std::shared_ptr<CuFFTConfig> config = plan_cache.lookup(params,
+                                          input, signal_ndim, complex_input,
+                                          complex_output, checked_signal_sizes,
+                                          onesided, output_sizes);
+  // Only executing the plan needs to be serialized, other plans in the cache
+  // can be used meanwhile.
+  std::lock_guard<std::mutex> guard(config->exec_mutex);
+  return _run_cufft(*config, input, signal_ndim, complex_input,
                     complex_output, inverse, checked_signal_sizes, normalized,
                     onesided, output_sizes, input_was_cloned);
 }
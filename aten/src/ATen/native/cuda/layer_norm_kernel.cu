@@ -5,11 +5,15 @@
 #include <ATen/Dispatch.h>
 #include <ATen/NativeFunctions.h>
 #include <ATen/cuda/CUDAApplyUtils.cuh>
+#include <ATen/cuda/CUDAContext.h>
 #include <ATen/cuda/detail/IndexUtils.cuh>
 #include <THC/THCDeviceUtils.cuh>
 
 #include <c10/cuda/CUDAMathCompat.h>
 
+#include <algorithm>
+#include <type_traits>
+
 namespace at {
 namespace native {
 
@@ -44,6 +48,36 @@ __inline__ __device__ T BlockReduceSum(T val, T* shared) {
   return val;
 }
 
+template <typename T>
+__inline__ __device__ T WarpAllReduceSum(T val) {
+#pragma unroll
+  for (int offset = (C10_WARP_SIZE >> 1); offset > 0; offset >>= 1) {
+    val += WARP_SHFL_XOR(val, offset);
+  }
+  return val;
+}
+
+// Sums val over the threads of a row, i.e., over a warp if kWarpPerRow and
+// over the block otherwise, and returns the sum to all of them. shared must
+// hold C10_WARP_SIZE elements and can be reused right after the call.
+template <typename T, bool kWarpPerRow>
+__inline__ __device__ T RowAllReduceSum(T val, T* shared) {
+  val = WarpAllReduceSum(val);
+  if (kWarpPerRow) {
+    return val;
+  }
+  const int lid = threadIdx.x % C10_WARP_SIZE;
+  const int wid = threadIdx.x / C10_WARP_SIZE;
+  if (lid == 0) {
+    shared[wid] = val;
+  }
+  __syncthreads();
+  val = (lid < blockDim.x / C10_WARP_SIZE) ? shared[lid] : T(0);
+  val = WarpAllReduceSum(val);
+  __syncthreads();
+  return val;
+}
+
 template <typename T>
 __global__ void RowwiseMomentsCUDAKernel(
     int64_t N,
@@ -279,6 +313,249 @@ __global__ void GammaBetaBackwardCUDAKernel(
   }
 }
 
+// Persistent kernels for rows of up to kPersistentBlockMaxN elements. Rows of
+// up to kPersistentWarpMaxN elements are handled by one warp, longer ones by
+// one block of kPersistentBlockNumThreads threads. Either way each thread keeps
+// its kItems elements of the row in registers, so the input is read once for
+// the moments and the normalization instead of once per kernel, and the
+// variance is computed from the centered values. The grid is capped at the
+// number of blocks that are resident at once and every warp or block loops
+// over the rows.
+constexpr int kPersistentWarpMaxN = 32 * C10_WARP_SIZE;
+constexpr int kPersistentWarpsPerBlock = 4;
+constexpr int kPersistentBlockNumThreads = 512;
+constexpr int kPersistentBlockMaxN = 16 * kPersistentBlockNumThreads;
+
+// If R is given, the row is X + R, which is also written to S, so that a
+// residual connection followed by LayerNorm takes a single pass.
+template <typename T, int kItems, bool kWarpPerRow>
+__global__ void PersistentLayerNormForwardCUDAKernel(
+    int64_t M,
+    int64_t N,
+    acc_type<T, true> eps,
+    const T* X,
+    const T* R,
+    const T* gamma,
+    const T* beta,
+    T* Y,
+    T* S,
+    T* mean,
+    T* rstd) {
+  using T_ACC = acc_type<T, true>;
+  __shared__ T_ACC shared[C10_WARP_SIZE];
+  const int64_t row_begin =
+      kWarpPerRow ? blockIdx.x * blockDim.y + threadIdx.y : blockIdx.x;
+  const int64_t row_stride =
+      kWarpPerRow ? gridDim.x * blockDim.y : gridDim.x;
+  const T_ACC scale = T_ACC(1) / static_cast<T_ACC>(N);
+  for (int64_t i = row_begin; i < M; i += row_stride) {
+    T_ACC x[kItems];
+    T_ACC sum = 0;
+#pragma unroll
+    for (int k = 0; k < kItems; ++k) {
+      const int64_t j = threadIdx.x + k * blockDim.x;
+      x[k] = 0;
+      if (j < N) {
+        const int64_t index = i * N + j;
+        if (R == nullptr) {
+          x[k] = static_cast<T_ACC>(X[index]);
+        } else {
+          const T s = static_cast<T_ACC>(X[index]) + static_cast<T_ACC>(R[index]);
+          S[index] = s;
+          x[k] = static_cast<T_ACC>(s);
+        }
+        sum += x[k];
+      }
+    }
+    const T_ACC m = RowAllReduceSum<T_ACC, kWarpPerRow>(sum, shared) * scale;
+    T_ACC sum_sq = 0;
+#pragma unroll
+    for (int k = 0; k < kItems; ++k) {
+      const int64_t j = threadIdx.x + k * blockDim.x;
+      if (j < N) {
+        sum_sq += (x[k] - m) * (x[k] - m);
+      }
+    }
+    const T_ACC var = RowAllReduceSum<T_ACC, kWarpPerRow>(sum_sq, shared) * scale;
+    const T_ACC r = c10::cuda::compat::rsqrt(var + eps);
+    if (threadIdx.x == 0) {
+      mean[i] = m;
+      rstd[i] = r;
+    }
+#pragma unroll
+    for (int k = 0; k < kItems; ++k) {
+      const int64_t j = threadIdx.x + k * blockDim.x;
+      if (j < N) {
+        const T_ACC gamma_v =
+            gamma == nullptr ? T_ACC(1) : static_cast<T_ACC>(gamma[j]);
+        const T_ACC beta_v =
+            beta == nullptr ? T_ACC(0) : static_cast<T_ACC>(beta[j]);
+        Y[i * N + j] = (x[k] - m) * r * gamma_v + beta_v;
+      }
+    }
+  }
+}
+
+// Computes dX in one pass over dY and X, see
+// ComputeGradientFusedParamsCUDAKernel for the math.
+template <typename T, int kItems, bool kWarpPerRow>
+__global__ void PersistentLayerNormBackwardCUDAKernel(
+    int64_t M,
+    int64_t N,
+    const T* dY,
+    const T* X,
+    const T* mean,
+    const T* rstd,
+    const T* gamma,
+    T* dX) {
+  using T_ACC = acc_type<T, true>;
+  __shared__ T_ACC shared[C10_WARP_SIZE];
+  const int64_t row_begin =
+      kWarpPerRow ? blockIdx.x * blockDim.y + threadIdx.y : blockIdx.x;
+  const int64_t row_stride =
+      kWarpPerRow ? gridDim.x * blockDim.y : gridDim.x;
+  const T_ACC scale = T_ACC(1) / static_cast<T_ACC>(N);
+  for (int64_t i = row_begin; i < M; i += row_stride) {
+    T_ACC x[kItems];
+    T_ACC dy_gamma[kItems];
+    T_ACC ds = 0;
+    T_ACC db = 0;
+#pragma unroll
+    for (int k = 0; k < kItems; ++k) {
+      const int64_t j = threadIdx.x + k * blockDim.x;
+      x[k] = 0;
+      dy_gamma[k] = 0;
+      if (j < N) {
+        const int64_t index = i * N + j;
+        const T_ACC gamma_v =
+            gamma == nullptr ? T_ACC(1) : static_cast<T_ACC>(gamma[j]);
+        x[k] = static_cast<T_ACC>(X[index]);
+        dy_gamma[k] = static_cast<T_ACC>(dY[index]) * gamma_v;
+        ds += dy_gamma[k] * x[k];
+        db += dy_gamma[k];
+      }
+    }
+    ds = RowAllReduceSum<T_ACC, kWarpPerRow>(ds, shared);
+    db = RowAllReduceSum<T_ACC, kWarpPerRow>(db, shared);
+    const T_ACC m = static_cast<T_ACC>(mean[i]);
+    const T_ACC r = static_cast<T_ACC>(rstd[i]);
+    const T_ACC b = (db * m - ds) * r * r * r * scale;
+    const T_ACC c = -(b * m + db * r * scale);
+#pragma unroll
+    for (int k = 0; k < kItems; ++k) {
+      const int64_t j = threadIdx.x + k * blockDim.x;
+      if (j < N) {
+        dX[i * N + j] = r * dy_gamma[k] + b * x[k] + c;
+      }
+    }
+  }
+}
+
+// Calls launch with the number of items per thread, whether a warp handles a
+// row, the block and the grid of a persistent kernel that covers rows of N
+// elements. Returns false if the rows are too long for the persistent kernels.
+template <typename Launch>
+bool DispatchPersistentLayerNorm(int64_t M, int64_t N, const Launch& launch) {
+  if (N > kPersistentBlockMaxN || M == 0) {
+    return false;
+  }
+  const cudaDeviceProp* prop = at::cuda::getCurrentDeviceProperties();
+  const auto grid_size = [&](int64_t rows_per_block, int64_t num_threads) {
+    const int64_t max_blocks = static_cast<int64_t>(prop->multiProcessorCount) *
+        (prop->maxThreadsPerMultiProcessor / num_threads);
+    const int64_t blocks = (M + rows_per_block - 1) / rows_per_block;
+    return static_cast<int>(std::min(blocks, max_blocks));
+  };
+  if (N <= kPersistentWarpMaxN) {
+    const dim3 block(C10_WARP_SIZE, kPersistentWarpsPerBlock);
+    const int grid = grid_size(
+        kPersistentWarpsPerBlock, C10_WARP_SIZE * kPersistentWarpsPerBlock);
+    if (N <= C10_WARP_SIZE) {
+      launch(std::integral_constant<int, 1>(), std::true_type(), block, grid);
+    } else if (N <= 2 * C10_WARP_SIZE) {
+      launch(std::integral_constant<int, 2>(), std::true_type(), block, grid);
+    } else if (N <= 4 * C10_WARP_SIZE) {
+      launch(std::integral_constant<int, 4>(), std::true_type(), block, grid);
+    } else if (N <= 8 * C10_WARP_SIZE) {
+      launch(std::integral_constant<int, 8>(), std::true_type(), block, grid);
+    } else if (N <= 16 * C10_WARP_SIZE) {
+      launch(std::integral_constant<int, 16>(), std::true_type(), block, grid);
+    } else {
+      launch(std::integral_constant<int, 32>(), std::true_type(), block, grid);
+    }
+  } else {
+    const dim3 block(kPersistentBlockNumThreads);
+    const int grid = grid_size(1, kPersistentBlockNumThreads);
+    if (N <= 4 * kPersistentBlockNumThreads) {
+      launch(std::integral_constant<int, 4>(), std::false_type(), block, grid);
+    } else if (N <= 8 * kPersistentBlockNumThreads) {
+      launch(std::integral_constant<int, 8>(), std::false_type(), block, grid);
+    } else {
+      launch(std::integral_constant<int, 16>(), std::false_type(), block, grid);
+    }
+  }
+  AT_CUDA_CHECK(cudaGetLastError());
+  return true;
+}
+
+template <typename T>
+bool PersistentLayerNormForward(
+    int64_t M,
+    int64_t N,
+    T eps,
+    const T* X,
+    const T* R,
+    const T* gamma,
+    const T* beta,
+    T* Y,
+    T* S,
+    T* mean,
+    T* rstd) {
+  using T_ACC = acc_type<T, true>;
+  cudaStream_t cuda_stream = at::cuda::getCurrentCUDAStream();
+  return DispatchPersistentLayerNorm(
+      M, N, [&](auto items, auto warp_per_row, dim3 block, int grid) {
+        PersistentLayerNormForwardCUDAKernel<
+            T,
+            decltype(items)::value,
+            decltype(warp_per_row)::value>
+            <<<grid, block, 0, cuda_stream>>>(
+                M,
+                N,
+                static_cast<T_ACC>(eps),
+                X,
+                R,
+                gamma,
+                beta,
+                Y,
+                S,
+                mean,
+                rstd);
+      });
+}
+
+template <typename T>
+bool PersistentLayerNormBackward(
+    int64_t M,
+    int64_t N,
+    const T* dY,
+    const T* X,
+    const T* mean,
+    const T* rstd,
+    const T* gamma,
+    T* dX) {
+  cudaStream_t cuda_stream = at::cuda::getCurrentCUDAStream();
+  return DispatchPersistentLayerNorm(
+      M, N, [&](auto items, auto warp_per_row, dim3 block, int grid) {
+        PersistentLayerNormBackwardCUDAKernel<
+            T,
+            decltype(items)::value,
+            decltype(warp_per_row)::value>
+            <<<grid, block, 0, cuda_stream>>>(
+                M, N, dY, X, mean, rstd, gamma, dX);
+      });
+}
+
 template <typename T>
 void LayerNormKernelImplInternal(
     const Tensor& X,
@@ -299,6 +576,20 @@ void LayerNormKernelImplInternal(
   T* Y_data = Y->data_ptr<T>();
   T* mean_data = mean->data_ptr<T>();
   T* rstd_data = rstd->data_ptr<T>();
+  if (PersistentLayerNormForward<T>(
+          M,
+          N,
+          eps,
+          X_data,
+          nullptr,
+          gamma_data,
+          beta_data,
+          Y_data,
+          nullptr,
+          mean_data,
+          rstd_data)) {
+    return;
+  }
   cudaStream_t cuda_stream = at::cuda::getCurrentCUDAStream();
   RowwiseMomentsCUDAKernel<T>
       <<<M, kCUDABlockReduceNumThreads, 0, cuda_stream>>>(
@@ -325,6 +616,69 @@ void LayerNormKernelImpl(
       });
 }
 
+template <typename T>
+void AddLayerNormKernelImplInternal(
+    const Tensor& X,
+    const Tensor& R,
+    const Tensor& gamma,
+    const Tensor& beta,
+    int64_t M,
+    int64_t N,
+    T eps,
+    Tensor* Y,
+    Tensor* S,
+    Tensor* mean,
+    Tensor* rstd) {
+  DCHECK_EQ(X.numel(), M * N);
+  DCHECK_EQ(R.numel(), M * N);
+  const T* gamma_data = gamma.defined() ? gamma.data_ptr<T>() : nullptr;
+  const T* beta_data = beta.defined() ? beta.data_ptr<T>() : nullptr;
+  if (!PersistentLayerNormForward<T>(
+          M,
+          N,
+          eps,
+          X.data_ptr<T>(),
+          R.data_ptr<T>(),
+          gamma_data,
+          beta_data,
+          Y->data_ptr<T>(),
+          S->data_ptr<T>(),
+          mean->data_ptr<T>(),
+          rstd->data_ptr<T>())) {
+    at::add_out(*S, X, R);
+    LayerNormKernelImplInternal<T>(*S, gamma, beta, M, N, eps, Y, mean, rstd);
+  }
+}
+
+void AddLayerNormKernelImpl(
+    const Tensor& X,
+    const Tensor& R,
+    const Tensor& gamma,
+    const Tensor& beta,
+    int64_t M,
+    int64_t N,
+    double eps,
+    Tensor* Y,
+    Tensor* S,
+    Tensor* mean,
+    Tensor* rstd) {
+  AT_DISPATCH_FLOATING_TYPES_AND_HALF(
+      X.scalar_type(), "AddLayerNormKernelImpl", [&]() {
+        AddLayerNormKernelImplInternal<scalar_t>(
+            X,
+            R,
+            gamma,
+            beta,
+            M,
+            N,
+            static_cast<scalar_t>(eps),
+            Y,
+            S,
+            mean,
+            rstd);
+      });
+}
+
 template <typename T>
 void LayerNormBackwardKernelImplInternal(
     const Tensor& dY,
@@ -351,7 +705,9 @@ void LayerNormBackwardKernelImplInternal(
       gamma.defined() ? gamma.template data_ptr<T>() : nullptr;
   T* dX_data = dX->defined() ? dX->template data_ptr<T>() : nullptr;
   cudaStream_t cuda_stream = at::cuda::getCurrentCUDAStream();
-  if (dX_data != nullptr) {
+  if (dX_data != nullptr &&
+      !PersistentLayerNormBackward<T>(
+          M, N, dY_data, X_data, mean_data, rstd_data, gamma_data, dX_data)) {
     const auto kAccType = X.scalar_type() == kHalf ? kFloat : X.scalar_type();
     Tensor ds = at::empty({M}, X.options().dtype(kAccType));
     Tensor db = at::empty({M}, X.options().dtype(kAccType));
@@ -457,6 +813,25 @@ std::tuple<Tensor, Tensor, Tensor> layer_norm_cuda(
   return std::make_tuple(std::move(Y), std::move(mean), std::move(rstd));
 }
 
+std::tuple<Tensor, Tensor, Tensor, Tensor> add_layer_norm_cuda(
+    const Tensor& X,
+    const Tensor& R,
+    const Tensor& gamma /* optional */,
+    const Tensor& beta /* optional */,
+    int64_t M,
+    int64_t N,
+    double eps) {
+  Tensor Y = at::native::empty_like(X, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
+  Tensor S = at::native::empty_like(X, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
+  Tensor mean = at::empty({M}, X.options());
+  Tensor rstd = at::empty({M}, X.options());
+  if (M > 0) {
+    AddLayerNormKernelImpl(X, R, gamma, beta, M, N, eps, &Y, &S, &mean, &rstd);
+  }
+  return std::make_tuple(
+      std::move(Y), std::move(S), std::move(mean), std::move(rstd));
+}
+
 std::tuple<Tensor, Tensor, Tensor> layer_norm_backward_cuda(
     const Tensor& dY,
     const Tensor& X,
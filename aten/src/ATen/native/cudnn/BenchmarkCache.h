@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace at { namespace native { namespace detail {
+
+// Save and restore the algorithms that cudnn.benchmark picked for each
+// convolution (at native/cudnn/Conv.cpp), so that a new process can reuse
+// them instead of running cudnnFind again for every shape.
+//
+// The file records the cuDNN version and the model of the current device;
+// loading a file written with a different cuDNN or GPU warns and loads
+// nothing. Like the cuFFT plan cache functions, these are called through
+// the CUDA hooks (at cuda/detail/CUDAHooks.cpp) from the native functions
+// _cudnn_save_benchmark_cache and _cudnn_load_benchmark_cache (at
+// native/Convolution.cpp), since the CPU build cannot call them directly.
+void cudnn_save_benchmark_cache_impl(const std::string& path);
+int64_t cudnn_load_benchmark_cache_impl(const std::string& path);
+
+}}} // namespace at::native::detail
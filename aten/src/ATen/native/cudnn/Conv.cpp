@@ -3,6 +3,7 @@
 #include <ATen/Config.h>
 #include <ATen/cuda/CUDAConfig.h>
 #include <ATen/cuda/Exceptions.h>
+#include <ATen/native/cudnn/BenchmarkCache.h>
 
 #if !AT_CUDNN_ENABLED()
 
@@ -71,12 +72,25 @@ std::tuple<at::Tensor,at::Tensor,at::Tensor> cudnn_convolution_transpose_backwar
   AT_ERROR("cudnn_convolution_transpose_backward: ATen not compiled with cuDNN support");
 }
 
+namespace detail {
+
+void cudnn_save_benchmark_cache_impl(const std::string& path) {
+  AT_ERROR("cudnn_save_benchmark_cache: ATen not compiled with cuDNN support");
+}
+
+int64_t cudnn_load_benchmark_cache_impl(const std::string& path) {
+  AT_ERROR("cudnn_load_benchmark_cache: ATen not compiled with cuDNN support");
+}
+
+} // namespace detail
+
 }}
 
 #else  // AT_CUDNN_ENABLED
 
 #include <THC/THC.h>
 
+#include <ATen/cuda/CUDAContext.h>
 #include <ATen/cudnn/cudnn-wrapper.h>
 #include <ATen/cudnn/Descriptors.h>
 #include <ATen/cudnn/Types.h>
@@ -89,10 +103,14 @@ std::tuple<at::Tensor,at::Tensor,at::Tensor> cudnn_convolution_transpose_backwar
 #include <iterator>
 #include <sstream>
 #include <algorithm>
+#include <cstring>
+#include <fstream>
 #include <memory>
 #include <mutex>
 #include <stdint.h>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 // Note [behavior of cudnnFind and cudnnGet]
 // You'll notice that by default, in the ConvolutionDescriptor, we do the following:
@@ -361,12 +379,170 @@ struct BenchmarkCache {
     std::lock_guard<std::mutex> guard(mutex);
     map[params] = results;
   }
+
+  // Entries measured by this process win over the ones read from disk.
+  bool insert_if_absent(const ConvolutionParams& params, const T& results) {
+    std::lock_guard<std::mutex> guard(mutex);
+    return map.emplace(params, results).second;
+  }
+
+  std::vector<std::pair<ConvolutionParams, T>> entries() {
+    std::lock_guard<std::mutex> guard(mutex);
+    return std::vector<std::pair<ConvolutionParams, T>>(map.begin(), map.end());
+  }
 };
 
 BenchmarkCache<cudnnConvolutionFwdAlgoPerf_t> fwd_algos;
 BenchmarkCache<cudnnConvolutionBwdDataAlgoPerf_t> bwd_data_algos;
 BenchmarkCache<cudnnConvolutionBwdFilterAlgoPerf_t> bwd_filter_algos;
 
+// ---------------------------------------------------------------------
+//
+// Benchmark cache persistence
+//
+// ---------------------------------------------------------------------
+
+// The cache file is this header followed by the raw (ConvolutionParams,
+// perf_t) pairs of the forward, backward data and backward filter caches,
+// in that order. Both structs are PODs (the params are hashed bytewise
+// already), so they are written as is; the sizes are recorded so that a
+// file from a build with a different layout is rejected instead of misread.
+// The cache is not keyed by device, so the file is tied to the model of
+// the device that is current when it is saved and loaded.
+constexpr char kBenchmarkCacheMagic[8] = "CUDNNBC";
+constexpr int32_t kBenchmarkCacheFormatVersion = 1;
+
+struct BenchmarkCacheHeader {
+  char magic[8];
+  int32_t format_version;
+  int32_t compute_capability_major;
+  int32_t compute_capability_minor;
+  int64_t cudnn_version;
+  char device_name[256];
+  int64_t params_size;
+  int64_t fwd_perf_size;
+  int64_t bwd_data_perf_size;
+  int64_t bwd_filter_perf_size;
+  int64_t num_fwd;
+  int64_t num_bwd_data;
+  int64_t num_bwd_filter;
+};
+
+BenchmarkCacheHeader makeBenchmarkCacheHeader() {
+  BenchmarkCacheHeader header;
+  // zero the padding too, so that headers compare equal with memcmp
+  memset(&header, 0, sizeof(BenchmarkCacheHeader));
+  memcpy(header.magic, kBenchmarkCacheMagic, sizeof(header.magic));
+  header.format_version = kBenchmarkCacheFormatVersion;
+  const cudaDeviceProp* prop = at::cuda::getCurrentDeviceProperties();
+  header.compute_capability_major = prop->major;
+  header.compute_capability_minor = prop->minor;
+  header.cudnn_version = static_cast<int64_t>(cudnnGetVersion());
+  strncpy(header.device_name, prop->name, sizeof(header.device_name) - 1);
+  header.params_size = sizeof(ConvolutionParams);
+  header.fwd_perf_size = sizeof(cudnnConvolutionFwdAlgoPerf_t);
+  header.bwd_data_perf_size = sizeof(cudnnConvolutionBwdDataAlgoPerf_t);
+  header.bwd_filter_perf_size = sizeof(cudnnConvolutionBwdFilterAlgoPerf_t);
+  return header;
+}
+
+template <typename T>
+void writeBenchmarkCacheEntries(std::ofstream& file, const std::vector<std::pair<ConvolutionParams, T>>& entries) {
+  for (const auto& entry : entries) {
+    file.write(reinterpret_cast<const char*>(&entry.first), sizeof(ConvolutionParams));
+    file.write(reinterpret_cast<const char*>(&entry.second), sizeof(T));
+  }
+}
+
+template <typename T>
+bool readBenchmarkCacheEntries(std::ifstream& file, int64_t count, std::vector<std::pair<ConvolutionParams, T>>& entries) {
+  for (int64_t i = 0; i < count; i++) {
+    std::pair<ConvolutionParams, T> entry;
+    file.read(reinterpret_cast<char*>(&entry.first), sizeof(ConvolutionParams));
+    file.read(reinterpret_cast<char*>(&entry.second), sizeof(T));
+    if (!file) {
+      return false;
+    }
+    entries.push_back(entry);
+  }
+  return true;
+}
+
+template <typename T>
+int64_t insertBenchmarkCacheEntries(BenchmarkCache<T>& cache, const std::vector<std::pair<ConvolutionParams, T>>& entries) {
+  int64_t inserted = 0;
+  for (const auto& entry : entries) {
+    inserted += cache.insert_if_absent(entry.first, entry.second);
+  }
+  return inserted;
+}
+
+namespace detail {
+
+void cudnn_save_benchmark_cache_impl(const std::string& path) {
+  const auto fwd = fwd_algos.entries();
+  const auto bwd_data = bwd_data_algos.entries();
+  const auto bwd_filter = bwd_filter_algos.entries();
+
+  BenchmarkCacheHeader header = makeBenchmarkCacheHeader();
+  header.num_fwd = fwd.size();
+  header.num_bwd_data = bwd_data.size();
+  header.num_bwd_filter = bwd_filter.size();
+
+  std::ofstream file(path, std::ios::binary | std::ios::trunc);
+  TORCH_CHECK(file, "cudnn_save_benchmark_cache: could not open ", path, " for writing");
+  file.write(reinterpret_cast<const char*>(&header), sizeof(BenchmarkCacheHeader));
+  writeBenchmarkCacheEntries(file, fwd);
+  writeBenchmarkCacheEntries(file, bwd_data);
+  writeBenchmarkCacheEntries(file, bwd_filter);
+  file.close();
+  TORCH_CHECK(file, "cudnn_save_benchmark_cache: failed to write ", path);
+}
+
+int64_t cudnn_load_benchmark_cache_impl(const std::string& path) {
+  std::ifstream file(path, std::ios::binary);
+  TORCH_CHECK(file, "cudnn_load_benchmark_cache: could not open ", path, " for reading");
+
+  BenchmarkCacheHeader header;
+  file.read(reinterpret_cast<char*>(&header), sizeof(BenchmarkCacheHeader));
+  TORCH_CHECK(file && memcmp(header.magic, kBenchmarkCacheMagic, sizeof(header.magic)) == 0,
+      "cudnn_load_benchmark_cache: ", path, " is not a cuDNN benchmark cache");
+
+  // Compare everything but the entry counts against what this process
+  // would write.
+  BenchmarkCacheHeader expected = makeBenchmarkCacheHeader();
+  expected.num_fwd = header.num_fwd;
+  expected.num_bwd_data = header.num_bwd_data;
+  expected.num_bwd_filter = header.num_bwd_filter;
+  if (memcmp(&header, &expected, sizeof(BenchmarkCacheHeader)) != 0) {
+    header.device_name[sizeof(header.device_name) - 1] = '\0';
+    TORCH_WARN("cudnn_load_benchmark_cache: ignoring ", path, ", which was saved with cuDNN ",
+        header.cudnn_version, " on ", header.device_name, " (sm_", header.compute_capability_major,
+        header.compute_capability_minor, "), but this process uses cuDNN ", expected.cudnn_version,
+        " on ", expected.device_name, " (sm_", expected.compute_capability_major,
+        expected.compute_capability_minor, ")");
+    return 0;
+  }
+  TORCH_CHECK(header.num_fwd >= 0 && header.num_bwd_data >= 0 && header.num_bwd_filter >= 0,
+      "cudnn_load_benchmark_cache: ", path, " is corrupted");
+
+  // Read the whole file before touching the caches, so that a truncated
+  // file loads nothing.
+  std::vector<std::pair<ConvolutionParams, cudnnConvolutionFwdAlgoPerf_t>> fwd;
+  std::vector<std::pair<ConvolutionParams, cudnnConvolutionBwdDataAlgoPerf_t>> bwd_data;
+  std::vector<std::pair<ConvolutionParams, cudnnConvolutionBwdFilterAlgoPerf_t>> bwd_filter;
+  TORCH_CHECK(readBenchmarkCacheEntries(file, header.num_fwd, fwd) &&
+      readBenchmarkCacheEntries(file, header.num_bwd_data, bwd_data) &&
+      readBenchmarkCacheEntries(file, header.num_bwd_filter, bwd_filter),
+      "cudnn_load_benchmark_cache: ", path, " is truncated");
+
+  return insertBenchmarkCacheEntries(fwd_algos, fwd) +
+      insertBenchmarkCacheEntries(bwd_data_algos, bwd_data) +
+      insertBenchmarkCacheEntries(bwd_filter_algos, bwd_filter);
+}
+
+} // namespace detail
+
 // TODO: Stop manually allocating CUDA memory; allocate an ATen byte
 // tensor instead.
 struct Workspace {
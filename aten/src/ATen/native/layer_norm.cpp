@@ -4,6 +4,7 @@
 #include <functional>
 #include <numeric>
 #include <tuple>
+#include <utility>
 #include <vector>
 
 #include <ATen/ATen.h>
@@ -60,13 +61,34 @@ std::tuple<Tensor, Tensor, Tensor> layer_norm_backward_cpu(
   return std::make_tuple(std::move(dX), std::move(dgamma), std::move(dbeta));
 }
 
-Tensor layer_norm(
+std::tuple<Tensor, Tensor, Tensor, Tensor> add_layer_norm_cpu(
+    const Tensor& X,
+    const Tensor& R,
+    const Tensor& gamma /* optional */,
+    const Tensor& beta /* optional */,
+    int64_t M,
+    int64_t N,
+    double eps) {
+  Tensor S = at::add(X, R);
+  Tensor Y = at::native::empty_like(X, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
+  Tensor mean = at::empty({M}, X.options());
+  Tensor rstd = at::empty({M}, X.options());
+  if (M > 0) {
+    LayerNormKernel(kCPU, S, gamma, beta, M, N, eps, &Y, &mean, &rstd);
+  }
+  return std::make_tuple(
+      std::move(Y), std::move(S), std::move(mean), std::move(rstd));
+}
+
+namespace {
+
+// Checks the arguments of layer_norm and returns the number of rows M and the
+// number of elements N per row.
+std::pair<int64_t, int64_t> _check_layer_norm_inputs(
     const Tensor& input,
     IntArrayRef normalized_shape,
     const Tensor& weight /* optional */,
-    const Tensor& bias /* optional */,
-    double eps,
-    bool /* cudnn_enable, deprecated */) {
+    const Tensor& bias /* optional */) {
   const int normalized_ndim = normalized_shape.size();
   TORCH_CHECK(
       normalized_ndim >= 1,
@@ -115,6 +137,21 @@ Tensor layer_norm(
       input_shape.cend(),
       1LL,
       std::multiplies<int64_t>());
+  return std::make_pair(M, N);
+}
+
+} // namespace
+
+Tensor layer_norm(
+    const Tensor& input,
+    IntArrayRef normalized_shape,
+    const Tensor& weight /* optional */,
+    const Tensor& bias /* optional */,
+    double eps,
+    bool /* cudnn_enable, deprecated */) {
+  int64_t M, N;
+  std::tie(M, N) =
+      _check_layer_norm_inputs(input, normalized_shape, weight, bias);
 
   const auto& X = input.is_contiguous() ? input : input.contiguous();
   const auto& gamma = weight.is_contiguous() ? weight : weight.contiguous();
@@ -122,6 +159,39 @@ Tensor layer_norm(
   return std::get<0>(at::native_layer_norm(X, gamma, beta, M, N, eps));
 }
 
+std::tuple<Tensor, Tensor> _add_layer_norm(
+    const Tensor& input,
+    const Tensor& residual,
+    IntArrayRef normalized_shape,
+    const Tensor& weight /* optional */,
+    const Tensor& bias /* optional */,
+    double eps) {
+  TORCH_CHECK(
+      input.sizes().equals(residual.sizes()),
+      "Expected residual to be of same shape as input, but got residual of ",
+      "shape ",
+      residual.sizes(),
+      " and input of shape ",
+      input.sizes());
+  TORCH_CHECK(
+      input.scalar_type() == residual.scalar_type(),
+      "Expected residual to have the same dtype as input, but got ",
+      residual.scalar_type(),
+      " and ",
+      input.scalar_type());
+  int64_t M, N;
+  std::tie(M, N) =
+      _check_layer_norm_inputs(input, normalized_shape, weight, bias);
+
+  const auto& X = input.is_contiguous() ? input : input.contiguous();
+  const auto& R = residual.is_contiguous() ? residual : residual.contiguous();
+  const auto& gamma = weight.is_contiguous() ? weight : weight.contiguous();
+  const auto& beta = bias.is_contiguous() ? bias : bias.contiguous();
+  auto outputs = at::_native_add_layer_norm(X, R, gamma, beta, M, N, eps);
+  return std::make_tuple(
+      std::move(std::get<0>(outputs)), std::move(std::get<1>(outputs)));
+}
+
 DEFINE_DISPATCH(LayerNormKernel);
 DEFINE_DISPATCH(LayerNormBackwardKernel);
 
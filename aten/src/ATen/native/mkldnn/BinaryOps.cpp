@@ -50,6 +50,15 @@ Tensor& mkldnn_add_out(
     const Tensor& self,
     const Tensor& other,
     Scalar alpha) {
+  if (self.sizes() != other.sizes()) {
+    // MKLDNN doesn't broadcast, so reorder around the dense kernel
+    auto dense = at::add(self.to_dense(), other.to_dense(), alpha);
+    TORCH_CHECK(dense.sizes() == result.sizes(),
+        "mkldnn_add_out: the output size should be the broadcast size of the inputs");
+    itensor_from_mkldnn(result) = itensor_from_mkldnn(dense.to_mkldnn());
+    return result;
+  }
+
   ideep::tensor& x = itensor_from_mkldnn(self);
   ideep::tensor& y = itensor_from_mkldnn(other);
 
@@ -61,6 +70,10 @@ Tensor& mkldnn_add_out(
 }
 
 Tensor mkldnn_add(const Tensor& self, const Tensor& other, Scalar alpha) {
+  if (self.sizes() != other.sizes()) {
+    return at::add(self.to_dense(), other.to_dense(), alpha).to_mkldnn();
+  }
+
   ideep::tensor& x = itensor_from_mkldnn(self);
   ideep::tensor& y = itensor_from_mkldnn(other);
 
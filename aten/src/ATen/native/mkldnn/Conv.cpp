@@ -34,9 +34,16 @@ std::tuple<at::Tensor,at::Tensor,at::Tensor> mkldnn_convolution_backward(
 
 #else // AT_MKLDNN_EBABLED
 
+#include <ATen/core/grad_mode.h>
 #include <ATen/mkldnn/Runtime.h>
 #include <ATen/native/mkldnn/MKLDNNCommon.h>
 #include <ATen/native/mkldnn/Utils.h>
+#include <ATen/native/utils/ParamsHash.h>
+#include <c10/util/intrusive_ptr.h>
+
+#include <list>
+#include <mutex>
+#include <unordered_map>
 
 using namespace mkldnn;
 
@@ -53,6 +60,148 @@ inline ideep::tensor get_mkldnn_tensor(const at::Tensor& tensor) {
     return at::native::itensor_view_from_dense(tensor);
   }
 }
+
+constexpr int max_dim = 3;
+
+// This POD struct is used to let us easily compute hashes of the
+// parameters. The reordered weights don't depend on the input sizes.
+struct ConvWeightParams {
+  c10::TensorImpl* weight;
+  const void* weight_data;
+  int64_t dim;
+  int64_t weight_size[2 + max_dim];
+  int64_t padding[max_dim];
+  int64_t stride[max_dim];
+  int64_t dilation[max_dim];
+  int64_t groups;
+};
+
+// NB: This can't be a constructor, because then ConvWeightParams
+// would not be a POD anymore.
+void setConvWeightParams(
+    ConvWeightParams* params, const at::Tensor& weight,
+    at::IntArrayRef padding, at::IntArrayRef stride, at::IntArrayRef dilation,
+    int64_t groups) {
+  memset(params, 0, sizeof(ConvWeightParams));
+  params->weight = weight.unsafeGetTensorImpl();
+  params->weight_data = weight.data_ptr();
+  params->dim = weight.dim();
+  for (int64_t i = 0; i != weight.dim(); ++i) {
+    params->weight_size[i] = weight.size(i);
+  }
+  for (size_t i = 0; i != padding.size(); ++i) {
+    params->padding[i] = padding[i];
+    params->stride[i] = stride[i];
+    params->dilation[i] = dilation[i];
+  }
+  params->groups = groups;
+}
+
+// Ideep reorders dense weights into the blocked format of its conv kernels on
+// every call (see mkldnn_reorder_conv2d_weight), which is a large share of a
+// small-batch conv. The reordered weights of the last kMaxEntries convs are
+// kept, keyed by the TensorImpl of the weight and the conv parameters, and
+// reused until the version of the weight changes. Writes through `.data`,
+// which has its own version counter, are not seen.
+//
+// The weak reference keeps the TensorImpl of a key from being freed (and its
+// address reused by another weight) while the entry exists, without keeping
+// the weight's storage alive.
+class ConvWeightCache {
+ public:
+  static ConvWeightCache& get() {
+    static ConvWeightCache cache;
+    return cache;
+  }
+
+  bool find(const ConvWeightParams& params, uint32_t version, ideep::tensor* weight) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    auto it = map_.find(params);
+    if (it == map_.end()) {
+      return false;
+    }
+    auto entry = it->second;
+    if (entry->weight_ref.expired() || entry->version != version) {
+      entry_list_.erase(entry);
+      map_.erase(it);
+      return false;
+    }
+    entry_list_.splice(entry_list_.begin(), entry_list_, entry);
+    *weight = entry->reordered;
+    return true;
+  }
+
+  void insert(const ConvWeightParams& params, const at::Tensor& weight,
+              uint32_t version, const ideep::tensor& reordered) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    auto it = map_.find(params);
+    if (it != map_.end()) {
+      entry_list_.erase(it->second);
+      map_.erase(it);
+    }
+    entry_list_.push_front(
+        Entry{params, weakref_type(weight.getIntrusivePtr()), version, reordered});
+    map_[params] = entry_list_.begin();
+    if (entry_list_.size() > kMaxEntries) {
+      map_.erase(entry_list_.back().params);
+      entry_list_.pop_back();
+    }
+  }
+
+ private:
+  using weakref_type = c10::weak_intrusive_ptr<c10::TensorImpl, c10::UndefinedTensorImpl>;
+
+  struct Entry {
+    ConvWeightParams params;
+    weakref_type weight_ref;
+    uint32_t version;
+    ideep::tensor reordered;
+  };
+
+  static constexpr size_t kMaxEntries = 64;
+
+  std::mutex mutex_;
+  std::list<Entry> entry_list_;
+  std::unordered_map<
+      ConvWeightParams,
+      std::list<Entry>::iterator,
+      at::native::ParamsHash<ConvWeightParams>,
+      at::native::ParamsEqual<ConvWeightParams>>
+      map_;
+};
+
+// The dense weight of an inference conv, reordered for the MKLDNN kernels
+ideep::tensor get_reordered_weight(
+    const at::Tensor& weight,
+    at::IntArrayRef padding,
+    at::IntArrayRef stride,
+    at::IntArrayRef dilation,
+    int64_t groups) {
+  ConvWeightParams params;
+  setConvWeightParams(&params, weight, padding, stride, dilation, groups);
+  const uint32_t version = weight.unsafeGetTensorImpl()->version_counter().current_version();
+  ideep::tensor reordered;
+  if (ConvWeightCache::get().find(params, version, &reordered)) {
+    return reordered;
+  }
+
+  ideep::tensor w = get_mkldnn_tensor(weight).as_weights();
+  w.make_group(groups);
+  ideep::tensor::descriptor desc =
+      ideep::convolution_forward::expected_weights_descriptor(
+          w.get_dims(),
+          w.get_data_type(),
+          {stride.begin(), stride.end()},
+          {padding.begin(), padding.end()},
+          {padding.begin(), padding.end()},
+          {dilation.begin(), dilation.end()},
+          groups,
+          ideep::algorithm::convolution_direct);
+  reordered.init<at::native::AllocForMKLDNN>(desc);
+  reordered.feed_from(w);
+  ConvWeightCache::get().insert(params, weight, version, reordered);
+  return reordered;
+}
 }
 
 namespace at { namespace native {
@@ -127,7 +276,13 @@ at::Tensor mkldnn_convolution(
     IntArrayRef dilation,
     int64_t groups) {
   const ideep::tensor mkldnn_input = get_mkldnn_tensor(input);
-  const ideep::tensor mkldnn_weight = get_mkldnn_tensor(weight);
+  // weights that autograd may be updating are not worth caching
+  const bool cache_weight = !weight.is_mkldnn() &&
+      weight.dim() <= 2 + max_dim &&
+      !(weight.requires_grad() && at::GradMode::is_enabled());
+  const ideep::tensor mkldnn_weight = cache_weight
+      ? get_reordered_weight(weight, padding, stride, dilation, groups)
+      : get_mkldnn_tensor(weight);
   c10::optional<ideep::tensor> mkldnn_bias{c10::nullopt};
   if (bias.defined()) {
     mkldnn_bias = get_mkldnn_tensor(bias);
@@ -32,17 +32,19 @@ Tensor mkldnn_linear(
       "mkldnn_linear: input needs to has dim at least 2, input dim ", self.dim());
   TORCH_CHECK(self.is_mkldnn(),
       "mkldnn_linear: input needs to be mkldnn layout");
-  TORCH_CHECK(weight.is_mkldnn() && bias.is_mkldnn(),
-      "mkldnn_linear: weight and bias need to be mkldnn layout");
+  // The weight and bias may also be dense float tensors, as left by the
+  // MKLDNN layout propagation pass on frozen graphs.
+  auto weight_ = weight.is_mkldnn() ? weight : weight.contiguous();
+  auto bias_ = !bias.defined() || bias.is_mkldnn() ? bias : bias.contiguous();
 
   // reshape first if input dim is greater than 2 and the reshape will cost a memory copy.
   auto self_reshaped = self.dim() > 2 ? self.reshape({-1, self.size(self.dim() - 1)}) : self;
   const ideep::tensor x = itensor_from_mkldnn(self_reshaped);
-  const ideep::tensor w = itensor_from_mkldnn(weight);
+  const ideep::tensor w = itensor_from_tensor(weight_);
 
   ideep::tensor y;
-  if (bias.defined()) {
-    const ideep::tensor b = itensor_from_mkldnn(bias);
+  if (bias_.defined()) {
+    const ideep::tensor b = itensor_from_tensor(bias_);
     ideep::inner_product_forward::compute(x, w, b, y);
   } else {
     ideep::inner_product_forward::compute(x, w, y);
@@ -73,6 +73,13 @@ ideep::tensor itensor_view_from_dense(const Tensor& tensor) {
            ideep::tensor::data_type::f32},
           tensor.template data_ptr<float>()};
 }
+
+ideep::tensor itensor_from_tensor(const Tensor& tensor) {
+  if (tensor.is_mkldnn()) {
+    return itensor_from_mkldnn(tensor);
+  }
+  return itensor_view_from_dense(tensor);
+}
 }}
 
 #endif // AT_MKLDNN_ENABLED()
@@ -30,6 +30,10 @@ ideep::tensor& itensor_from_mkldnn(const Tensor& mkldnn_tensor);
 // Construct an `ideep::tensor` "view" from dense tensor, note the
 // ideep::tensor will share the underlying buffer
 ideep::tensor itensor_view_from_dense(const Tensor& tensor);
+
+// Retrieve `ideep::tensor` from MKL-DNN tensor, or a "view" of a contiguous
+// dense float tensor, which must outlive the ideep::tensor
+ideep::tensor itensor_from_tensor(const Tensor& tensor);
 }}
 
 #endif // AT_MKLDNN_ENABLED
@@ -30,6 +30,14 @@ std::tuple<Tensor, Tensor, Tensor> mkldnn_batch_norm(
 namespace at {
 namespace native {
 
+namespace {
+
+Tensor to_dense_if_mkldnn(const Tensor& tensor) {
+  return tensor.defined() && tensor.is_mkldnn() ? tensor.to_dense() : tensor;
+}
+
+} // namespace
+
 std::tuple<Tensor, Tensor, Tensor> mkldnn_batch_norm(
     const Tensor& input,
     const Tensor& weight,
@@ -39,11 +47,31 @@ std::tuple<Tensor, Tensor, Tensor> mkldnn_batch_norm(
     bool train,
     double momentum,
     double eps) {
+  if (!train && input.dim() != 4 && input.dim() != 5) {
+    // Reorder around the dense kernel, so that the MKLDNN layout can be kept
+    // across a batch norm of any dimension
+    auto output = at::native_batch_norm(
+        input.to_dense(), to_dense_if_mkldnn(weight), to_dense_if_mkldnn(bias),
+        to_dense_if_mkldnn(running_mean), to_dense_if_mkldnn(running_var),
+        train, momentum, eps);
+    return std::make_tuple(
+        std::get<0>(output).to_mkldnn(),
+        new_with_itensor_mkldnn(ideep::tensor{}, input.options()),
+        new_with_itensor_mkldnn(ideep::tensor{}, input.options()));
+  }
+
+  // The parameters may also be dense float tensors, as left by the MKLDNN
+  // layout propagation pass on frozen graphs.
+  auto weight_ = weight.is_mkldnn() ? weight : weight.contiguous();
+  auto bias_ = bias.is_mkldnn() ? bias : bias.contiguous();
+  auto running_mean_ = running_mean.is_mkldnn() ? running_mean : running_mean.contiguous();
+  auto running_var_ = running_var.is_mkldnn() ? running_var : running_var.contiguous();
+
   ideep::tensor& x = itensor_from_mkldnn(input);
-  ideep::tensor& w = itensor_from_mkldnn(weight);
-  ideep::tensor& b = itensor_from_mkldnn(bias);
-  ideep::tensor& m = itensor_from_mkldnn(running_mean);
-  ideep::tensor& v = itensor_from_mkldnn(running_var);
+  ideep::tensor w = itensor_from_tensor(weight_);
+  ideep::tensor b = itensor_from_tensor(bias_);
+  ideep::tensor m = itensor_from_tensor(running_mean_);
+  ideep::tensor v = itensor_from_tensor(running_var_);
 
   ideep::tensor y;
 
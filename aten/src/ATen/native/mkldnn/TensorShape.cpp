@@ -28,6 +28,10 @@ Tensor& mkldnn_transpose_(Tensor& self, int64_t dim0, int64_t dim1) {
   AT_ERROR("mkldnn_transpose_: ATen not compiled with MKLDNN support");
 }
 
+Tensor mkldnn_cat(TensorList tensors, int64_t dim) {
+  AT_ERROR("mkldnn_cat: ATen not compiled with MKLDNN support");
+}
+
 } // namespace native
 } // namespace at
 
@@ -79,6 +83,22 @@ Tensor& mkldnn_transpose_(Tensor& self, int64_t dim0, int64_t dim1) {
   AT_ERROR("mkldnn_transpose_: in-place mkldnn operations are not supported yet");
 }
 
+Tensor mkldnn_cat(TensorList tensors, int64_t dim) {
+  TORCH_CHECK(!tensors.empty(), "mkldnn_cat: expected a non-empty list of tensors");
+  std::vector<ideep::tensor> inputs;
+  inputs.reserve(tensors.size());
+  for (const auto& tensor : tensors) {
+    TORCH_CHECK(tensor.is_mkldnn(), "mkldnn_cat: expected all the tensors to be mkldnn layout");
+    TORCH_CHECK(tensor.dim() == tensors[0].dim(),
+        "mkldnn_cat: expected all the tensors to have ", tensors[0].dim(), " dimensions, but got ",
+        tensor.dim());
+    inputs.push_back(itensor_from_mkldnn(tensor));
+  }
+  ideep::tensor y;
+  ideep::concat::compute<AllocForMKLDNN>(inputs, static_cast<int>(dim), /*add_axis=*/false, y);
+  return new_with_itensor_mkldnn(std::move(y), tensors[0].options());
+}
+
 } // namespace native
 } // namespace at
 
@@ -0,0 +1,145 @@
+#include <ATen/ATen.h>
+#include <ATen/NativeFunctions.h>
+#include <ATen/WrapDimUtils.h>
+
+#include <limits>
+
+/* The state updates of the calibration observers of
+   torch/quantization/observer.py. The min and max of the input come from a
+   single _aminmax reduction, over all the dimensions but the channel one for
+   the per channel observers, instead of a min and a max over a permuted copy.
+   The rest only touches the state, of a few elements, so these are device
+   generic.
+*/
+namespace at {
+namespace native {
+namespace {
+
+std::tuple<Tensor, Tensor> observer_aminmax(
+    const Tensor& self,
+    c10::optional<int64_t> ch_axis) {
+  if (!ch_axis.has_value()) {
+    return at::_aminmax(self);
+  }
+  TORCH_CHECK(
+      self.dim() > 0,
+      "Per channel observers expect inputs of at least one dimension");
+  const int64_t axis = maybe_wrap_dim(*ch_axis, self.dim());
+  if (self.dim() == 1) {
+    // Each element is its own channel
+    return std::make_tuple(self.clone(), self.clone());
+  }
+  std::vector<int64_t> dims;
+  for (int64_t d = 0; d < self.dim(); ++d) {
+    if (d != axis) {
+      dims.push_back(d);
+    }
+  }
+  return at::_aminmax(self, dims);
+}
+
+} // namespace
+
+std::tuple<Tensor, Tensor> _observer_min_max(
+    const Tensor& self,
+    const Tensor& min_val,
+    const Tensor& max_val,
+    c10::optional<int64_t> ch_axis) {
+  Tensor x_min, x_max;
+  std::tie(x_min, x_max) = observer_aminmax(self, ch_axis);
+  if (!min_val.defined() || !max_val.defined()) {
+    return std::make_tuple(x_min, x_max);
+  }
+  return std::make_tuple(at::min(x_min, min_val), at::max(x_max, max_val));
+}
+
+std::tuple<Tensor, Tensor> _observer_moving_average_min_max(
+    const Tensor& self,
+    const Tensor& min_val,
+    const Tensor& max_val,
+    double averaging_constant,
+    c10::optional<int64_t> ch_axis) {
+  Tensor x_min, x_max;
+  std::tie(x_min, x_max) = observer_aminmax(self, ch_axis);
+  if (!min_val.defined() || !max_val.defined()) {
+    return std::make_tuple(x_min, x_max);
+  }
+  return std::make_tuple(
+      min_val + averaging_constant * (x_min - min_val),
+      max_val + averaging_constant * (x_max - max_val));
+}
+
+// The histogram of the input is taken over the union of its range and the
+// observed one, widened so that the bins of the observed histogram, upsampled
+// upsample_rate times, fall on a whole number of the new bins. The observed
+// histogram is then resampled onto them and added, as HistogramObserver did.
+std::tuple<Tensor, Tensor, Tensor> _observer_histogram(
+    const Tensor& self,
+    const Tensor& histogram,
+    const Tensor& min_val,
+    const Tensor& max_val,
+    int64_t bins,
+    int64_t upsample_rate) {
+  TORCH_CHECK(
+      bins > 0 && upsample_rate > 0,
+      "_observer_histogram: Expected positive bins and upsample_rate, but got ",
+      bins,
+      " and ",
+      upsample_rate);
+  Tensor x_min, x_max;
+  std::tie(x_min, x_max) = at::_aminmax(self);
+  if (!histogram.defined() || !min_val.defined() || !max_val.defined()) {
+    return std::make_tuple(
+        at::histc(self, bins, x_min.item(), x_max.item()), x_min, x_max);
+  }
+  Tensor combined_min = at::min(x_min, min_val);
+  Tensor combined_max = at::max(x_max, max_val);
+
+  const Tensor hist_bin_width = (max_val - min_val) / (bins * upsample_rate);
+  const int64_t downsample_rate =
+      at::ceil((combined_max - combined_min) / (bins * hist_bin_width))
+          .to(kInt)
+          .item<int32_t>();
+  const Tensor e = downsample_rate * (bins * hist_bin_width) -
+      (combined_max - combined_min);
+  combined_max = combined_max + e / 2;
+  combined_min = combined_min - e / 2;
+  const int64_t start_idx =
+      at::round((min_val - combined_min) / hist_bin_width)
+          .to(kInt)
+          .item<int32_t>();
+
+  Tensor combined_histogram =
+      at::histc(self, bins, combined_min.item(), combined_max.item());
+  if (combined_min.equal(min_val) && combined_max.equal(max_val)) {
+    return std::make_tuple(
+        combined_histogram + histogram, combined_min, combined_max);
+  }
+  // Upsample the observed histogram into a piecewise constant density on the
+  // common grid, then sum it back over each of the new bins.
+  Tensor histogram_with_output_range =
+      at::zeros({bins * downsample_rate}, histogram.options());
+  histogram_with_output_range
+      .slice(0, start_idx, bins * upsample_rate + start_idx)
+      .copy_(histogram.repeat_interleave(upsample_rate));
+  // Double precision ensures that there are no overflows
+  const Tensor integral_histogram =
+      at::cumsum(histogram_with_output_range, 0, kDouble)
+          .slice(
+              0,
+              downsample_rate - 1,
+              std::numeric_limits<int64_t>::max(),
+              downsample_rate);
+  Tensor shifted_integral_histogram = at::zeros({bins}, histogram.options());
+  shifted_integral_histogram.slice(0, 1, bins)
+      .copy_(integral_histogram.slice(0, 0, bins - 1));
+  const Tensor interpolated_histogram =
+      (integral_histogram - shifted_integral_histogram) / upsample_rate;
+  return std::make_tuple(
+      combined_histogram + interpolated_histogram.to(kFloat),
+      combined_min,
+      combined_max);
+}
+
+} // namespace native
+} // namespace at
@@ -8,7 +8,7 @@
 namespace at {
 namespace native {
 
-Tensor quantize_per_tensor_cpu(
+Tensor quantize_per_tensor(
     const Tensor& self,
     double scale,
     int64_t zero_point,
@@ -17,7 +17,7 @@ Tensor quantize_per_tensor_cpu(
   return quantizer->quantize(self);
 }
 
-Tensor quantize_per_channel_cpu(
+Tensor quantize_per_channel(
     const Tensor& self,
     const Tensor& scales,
     const Tensor& zero_points,
@@ -0,0 +1,12 @@
+#include <ATen/native/quantized/affine_quantizer.h>
+
+namespace at {
+namespace native {
+
+DEFINE_DISPATCH(quantize_tensor_per_tensor_affine_stub);
+DEFINE_DISPATCH(dequantize_tensor_per_tensor_affine_stub);
+DEFINE_DISPATCH(quantize_tensor_per_channel_affine_stub);
+DEFINE_DISPATCH(dequantize_tensor_per_channel_affine_stub);
+
+} // namespace native
+} // namespace at
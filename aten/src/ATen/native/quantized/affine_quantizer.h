@@ -0,0 +1,50 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <ATen/native/DispatchStub.h>
+
+namespace at {
+namespace native {
+
+// The kernels of PerTensorAffineQuantizer and PerChannelAffineQuantizer for
+// the devices other than the CPU, see ATen/quantized/Quantizer.cpp. rtensor
+// and qtensor are contiguous, of the same sizes and on the same device, and the
+// per channel scales (float) and zero points (int) are on that device too.
+using quantize_tensor_per_tensor_affine_fn = void (*)(
+    const Tensor& /*rtensor*/,
+    Tensor& /*qtensor*/,
+    double /*scale*/,
+    int64_t /*zero_point*/);
+using dequantize_tensor_per_tensor_affine_fn = void (*)(
+    const Tensor& /*qtensor*/,
+    Tensor& /*rtensor*/,
+    double /*scale*/,
+    int64_t /*zero_point*/);
+using quantize_tensor_per_channel_affine_fn = void (*)(
+    const Tensor& /*rtensor*/,
+    Tensor& /*qtensor*/,
+    const Tensor& /*scales*/,
+    const Tensor& /*zero_points*/,
+    int64_t /*axis*/);
+using dequantize_tensor_per_channel_affine_fn = void (*)(
+    const Tensor& /*qtensor*/,
+    Tensor& /*rtensor*/,
+    const Tensor& /*scales*/,
+    const Tensor& /*zero_points*/,
+    int64_t /*axis*/);
+
+DECLARE_DISPATCH(
+    quantize_tensor_per_tensor_affine_fn,
+    quantize_tensor_per_tensor_affine_stub);
+DECLARE_DISPATCH(
+    dequantize_tensor_per_tensor_affine_fn,
+    dequantize_tensor_per_tensor_affine_stub);
+DECLARE_DISPATCH(
+    quantize_tensor_per_channel_affine_fn,
+    quantize_tensor_per_channel_affine_stub);
+DECLARE_DISPATCH(
+    dequantize_tensor_per_channel_affine_fn,
+    dequantize_tensor_per_channel_affine_stub);
+
+} // namespace native
+} // namespace at
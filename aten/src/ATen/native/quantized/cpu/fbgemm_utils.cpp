@@ -192,6 +192,42 @@ Tensor ConvertToChannelsLast3dTensor(const Tensor& src) {
   return dst;
 }
 
+void GetWeightQuantizationParams(
+    const Tensor& weight,
+    int64_t output_channels,
+    std::vector<float>* scales,
+    std::vector<int32_t>* zero_points) {
+  const auto qtype = weight.qscheme();
+  if (qtype == kPerTensorAffine) {
+    *scales = {static_cast<float>(weight.q_scale())};
+    *zero_points = {static_cast<int32_t>(weight.q_zero_point())};
+  } else if (qtype == kPerChannelAffine) {
+    // Read from the quantizer rather than q_per_channel_scales() and
+    // q_per_channel_zero_points(), which make a tensor at every call
+    const auto* quantizer = static_cast<PerChannelAffineQuantizer*>(
+        get_qtensorimpl(weight)->quantizer().get());
+    TORCH_CHECK(
+        quantizer->axis() == 0,
+        "Only per output channel quantization is supported for the weights");
+    const auto& channel_scales = quantizer->scales();
+    const auto& channel_zero_points = quantizer->zero_points();
+    TORCH_CHECK(
+        channel_scales.size() == static_cast<size_t>(output_channels) &&
+            channel_zero_points.size() == static_cast<size_t>(output_channels),
+        "Expected a scale and a zero point for each of the ",
+        output_channels,
+        " output channels, but got ",
+        channel_scales.size(),
+        " scales and ",
+        channel_zero_points.size(),
+        " zero points");
+    scales->assign(channel_scales.begin(), channel_scales.end());
+    zero_points->assign(channel_zero_points.begin(), channel_zero_points.end());
+  } else {
+    TORCH_CHECK(false, "Unsupported qscheme: ", toString(qtype));
+  }
+}
+
 } // namespace fbgemm_utils
 } // namespace native
 } // namespace at
@@ -102,6 +102,15 @@ Tensor MakeEmptyPerChannelAffineQuantizedChannelsLast3dTensor(
 
 Tensor ConvertToChannelsLast3dTensor(const Tensor& src);
 
+// Returns the scales and zero points of a weight quantized per tensor or per
+// output channel (axis 0), which have output_channels elements in the latter
+// case, for fbgemm's TENSOR and OUT_CHANNEL requantization.
+void GetWeightQuantizationParams(
+    const Tensor& weight,
+    int64_t output_channels,
+    std::vector<float>* scales,
+    std::vector<int32_t>* zero_points);
+
 } // namespace fbgemm_utils
 } // namespace native
 } // namespace at
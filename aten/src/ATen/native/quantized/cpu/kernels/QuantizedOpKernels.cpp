@@ -3,6 +3,7 @@
 #include <ATen/native/TensorIterator.h>
 #include <ATen/native/UpSample.h>
 #include <ATen/native/cpu/Loops.h>
+#include <ATen/native/quantized/affine_quantizer.h>
 #include <ATen/native/quantized/cpu/quantized_ops.h>
 #include <ATen/quantized/Quantizer.h>
 #include <ATen/native/SortingUtils.h>
@@ -192,7 +193,7 @@ void qrelu6_kernel(const Tensor& qx, Tensor& qy) {
   });
 }
 
-// Note: out is assumed to be the same size as self and other.
+// Note: out is assumed to have the broadcast size of self and other.
 // Note: Addition is only supported when self, other, out are of the same dtype.
 template <bool ReLUFused = false>
 void qadd_kernel(Tensor& out, const Tensor& self, const Tensor& other) {
@@ -256,6 +257,176 @@ void qadd_kernel(Tensor& out, const Tensor& self, const Tensor& other) {
   });
 }
 
+// Note: out is assumed to have the broadcast size of self and other.
+// Note: Multiplication is only supported when self, other, out are of the same
+//       dtype.
+template <bool ReLUFused = false>
+void qmul_kernel(Tensor& out, const Tensor& self, const Tensor& other) {
+  int64_t zero_point = out.q_zero_point();
+  float scale = out.q_scale();
+  float inv_scale = 1.0f / scale;
+  int64_t self_zero_point = self.q_zero_point();
+  float self_scale = self.q_scale();
+  int64_t other_zero_point = other.q_zero_point();
+  float other_scale = other.q_scale();
+
+  auto self_zero_point_vec = Vec256<float>((float)self_zero_point);
+  auto self_scale_vec = Vec256<float>(self_scale);
+  auto other_zero_point_vec = Vec256<float>((float)other_zero_point);
+  auto other_scale_vec = Vec256<float>(other_scale);
+
+  auto self_scale_neg_zp_premul_vec = self_scale_vec * self_zero_point_vec.neg();
+  auto other_scale_zp_premul_vec = other_scale_vec * other_zero_point_vec.neg();
+
+  auto iter = TensorIterator::binary_op(out, self, other);
+
+  AT_DISPATCH_QINT_TYPES(out.scalar_type(), "qmul", [&]() {
+    using Vec = Vec256<scalar_t>;
+    cpu_kernel_vec(
+        iter,
+        [&](scalar_t a, scalar_t b) -> scalar_t {
+          const auto da = at::dequantize_val(self_scale, self_zero_point, a);
+          const auto db = at::dequantize_val(other_scale, other_zero_point, b);
+          float c = da * db;
+          if (ReLUFused) {
+            c = std::max<float>(c, 0.0);
+          }
+          return at::quantize_val<scalar_t>(scale, zero_point, c);
+        },
+        [&](Vec a, Vec b) -> Vec {
+          const auto da = a.dequantize(
+              self_scale_vec, self_zero_point_vec, self_scale_neg_zp_premul_vec);
+          const auto db = b.dequantize(
+              other_scale_vec, other_zero_point_vec, other_scale_zp_premul_vec);
+          Vec::float_vec_return_type retvals;
+          for (int i = 0; i < Vec::float_num_vecs(); ++i) {
+            auto c = da[i] * db[i];
+            if (ReLUFused) {
+              c = vec256::maximum(c, Vec256<float>(0.0f));
+            }
+            retvals[i] = c;
+          }
+          return Vec::quantize(retvals, scale, zero_point, inv_scale);
+        });
+  });
+}
+
+// Copies qx into out, which may have different quantization parameters.
+// When the parameters match the values are copied (and clamped for ReLU)
+// without leaving the quantized domain.
+void qrequantize_kernel(Tensor& out, const Tensor& qx, bool relu) {
+  const int64_t zero_point = out.q_zero_point();
+  const float scale = out.q_scale();
+  const float inv_scale = 1.0f / scale;
+  const int64_t x_zero_point = qx.q_zero_point();
+  const float x_scale = qx.q_scale();
+  const bool same_qparams = zero_point == x_zero_point && scale == x_scale;
+
+  auto x_zero_point_vec = Vec256<float>((float)x_zero_point);
+  auto x_scale_vec = Vec256<float>(x_scale);
+  auto x_scale_neg_zp_premul_vec = x_scale_vec * x_zero_point_vec.neg();
+
+  auto iter = TensorIterator::unary_op(out, qx);
+
+  AT_DISPATCH_QINT_TYPES(out.scalar_type(), "qrequantize", [&]() {
+    using Vec = Vec256<scalar_t>;
+    if (same_qparams) {
+      auto zero_point_vec = Vec(scalar_t(zero_point));
+      cpu_kernel_vec(
+          iter,
+          [&](scalar_t value) -> scalar_t {
+            return relu ? scalar_t(std::max<underlying_t>(value.val_, zero_point)) : value;
+          },
+          [&](Vec value) -> Vec { return relu ? value.relu(zero_point_vec) : value; });
+      return;
+    }
+    cpu_kernel_vec(
+        iter,
+        [&](scalar_t value) -> scalar_t {
+          float x = at::dequantize_val(x_scale, x_zero_point, value);
+          if (relu) {
+            x = std::max<float>(x, 0.0);
+          }
+          return at::quantize_val<scalar_t>(scale, zero_point, x);
+        },
+        [&](Vec value) -> Vec {
+          auto retvals = value.dequantize(x_scale_vec, x_zero_point_vec, x_scale_neg_zp_premul_vec);
+          if (relu) {
+            for (int i = 0; i < Vec::float_num_vecs(); ++i) {
+              retvals[i] = vec256::maximum(retvals[i], Vec256<float>(0.0f));
+            }
+          }
+          return Vec::quantize(retvals, scale, zero_point, inv_scale);
+        });
+  });
+}
+
+void qsigmoid_kernel(const Tensor& qx, Tensor& qy) {
+  const int64_t x_zero_point = qx.q_zero_point();
+  const float x_scale = qx.q_scale();
+  auto x_zero_point_vec = Vec256<float>((float)x_zero_point);
+  auto x_scale_vec = Vec256<float>(x_scale);
+  auto x_scale_neg_zp_premul_vec = x_scale_vec * x_zero_point_vec.neg();
+
+  AT_DISPATCH_QINT_TYPES(qx.scalar_type(), "qsigmoid", [&]() {
+    // The output lies in [0, 1], so the whole quantized range is spread over
+    // it regardless of the input parameters.
+    const int64_t q_min = std::numeric_limits<underlying_t>::min();
+    const int64_t q_max = std::numeric_limits<underlying_t>::max();
+    const float scale = 1.0f / (static_cast<float>(q_max) - q_min + 1);
+    const int64_t zero_point = q_min;
+    const float inv_scale = 1.0f / scale;
+    qy = at::_empty_affine_quantized(
+        qx.sizes(),
+        at::device(kCPU).dtype(SCALAR_TYPE),
+        scale,
+        zero_point,
+        qx.suggest_memory_format());
+    using Vec = Vec256<scalar_t>;
+    auto iter = TensorIterator::unary_op(qy, qx);
+    cpu_kernel_vec(
+        iter,
+        [&](scalar_t value) -> scalar_t {
+          const float x = at::dequantize_val(x_scale, x_zero_point, value);
+          return at::quantize_val<scalar_t>(scale, zero_point, 1.0f / (1.0f + std::exp(-x)));
+        },
+        [&](Vec value) -> Vec {
+          auto retvals = value.dequantize(x_scale_vec, x_zero_point_vec, x_scale_neg_zp_premul_vec);
+          for (int i = 0; i < Vec::float_num_vecs(); ++i) {
+            retvals[i] = (Vec256<float>(1.0f) + retvals[i].neg().exp()).reciprocal();
+          }
+          return Vec::quantize(retvals, scale, zero_point, inv_scale);
+        });
+  });
+}
+
+void qclamp_kernel(const Tensor& qx, Scalar min, Scalar max, Tensor& qy) {
+  AT_DISPATCH_QINT_TYPES(qx.scalar_type(), "qclamp", [&]() {
+    qy = at::_empty_affine_quantized(
+        qx.sizes(),
+        at::device(kCPU).dtype(SCALAR_TYPE),
+        qx.q_scale(),
+        qx.q_zero_point(),
+        qx.suggest_memory_format());
+    using Vec = Vec256<scalar_t>;
+    auto iter = TensorIterator::unary_op(qy, qx);
+    // Quantization is monotonic, so clamping the quantized values to the
+    // quantized bounds is the same as clamping the real values.
+    scalar_t min_q = at::quantize_val<scalar_t>(qx.q_scale(), qx.q_zero_point(), min.to<float>());
+    scalar_t max_q = at::quantize_val<scalar_t>(qx.q_scale(), qx.q_zero_point(), max.to<float>());
+    auto min_vec = Vec(min_q);
+    auto max_vec = Vec(max_q);
+    cpu_kernel_vec(
+        iter,
+        [&](scalar_t value) -> scalar_t {
+          underlying_t lower = std::max<underlying_t>(value.val_, min_q.val_);
+          return scalar_t(std::min<underlying_t>(lower, max_q.val_));
+        },
+        // relu6 clamps to [zero_point, q_six], which is any clamp range
+        [&](Vec value) -> Vec { return value.relu6(min_vec, max_vec); });
+  });
+}
+
 void qmaxpool_2d_nhwc_kernel(
     const Tensor& qx,
     int64_t iC, // input/output channels
@@ -808,12 +979,199 @@ void qtopk_kernel(Tensor& values,
   });
 }
 
+// Quantizes len floats of src into dst a Vec256<T> at a time. The tail goes
+// through a zero padded buffer, so that all the elements are rounded by the
+// same vectorized code whatever their position.
+template <typename T>
+void quantize_affine_vec(
+    const float* src,
+    T* dst,
+    int64_t len,
+    float scale,
+    int32_t zero_point) {
+  using Vec = Vec256<T>;
+  using fVec = Vec256<float>;
+  const float inverse_scale = 1.0f / scale;
+  typename Vec::float_vec_return_type float_vals;
+  int64_t i = 0;
+  for (; i + Vec::size() <= len; i += Vec::size()) {
+    for (int j = 0; j < Vec::float_num_vecs(); ++j) {
+      float_vals[j] = fVec::loadu(src + i + j * fVec::size());
+    }
+    Vec::quantize(float_vals, scale, zero_point, inverse_scale).store(dst + i);
+  }
+  if (i < len) {
+    float buf[Vec::size()] = {0.0f};
+    std::copy(src + i, src + len, buf);
+    for (int j = 0; j < Vec::float_num_vecs(); ++j) {
+      float_vals[j] = fVec::loadu(buf + j * fVec::size());
+    }
+    Vec::quantize(float_vals, scale, zero_point, inverse_scale)
+        .store(dst + i, len - i);
+  }
+}
+
+template <typename T>
+void dequantize_affine_vec(
+    const T* src,
+    float* dst,
+    int64_t len,
+    float scale,
+    int32_t zero_point) {
+  using Vec = Vec256<T>;
+  using fVec = Vec256<float>;
+  const fVec scale_vec(scale);
+  const fVec zero_point_vec(static_cast<float>(zero_point));
+  const fVec scale_neg_zp_premul_vec = scale_vec * zero_point_vec.neg();
+  int64_t i = 0;
+  for (; i + Vec::size() <= len; i += Vec::size()) {
+    const auto float_vals = Vec::loadu(src + i).dequantize(
+        scale_vec, zero_point_vec, scale_neg_zp_premul_vec);
+    for (int j = 0; j < Vec::float_num_vecs(); ++j) {
+      float_vals[j].store(dst + i + j * fVec::size());
+    }
+  }
+  if (i < len) {
+    typename T::underlying qbuf[Vec::size()] = {0};
+    float buf[Vec::size()];
+    std::copy(
+        reinterpret_cast<const typename T::underlying*>(src + i),
+        reinterpret_cast<const typename T::underlying*>(src + len),
+        qbuf);
+    const auto float_vals = Vec::loadu(qbuf).dequantize(
+        scale_vec, zero_point_vec, scale_neg_zp_premul_vec);
+    for (int j = 0; j < Vec::float_num_vecs(); ++j) {
+      float_vals[j].store(buf + j * fVec::size());
+    }
+    std::copy(buf, buf + (len - i), dst + i);
+  }
+}
+
+// The CPU kernels of PerTensorAffineQuantizer and PerChannelAffineQuantizer,
+// see affine_quantizer.h. The per channel ones quantize the tensors as
+// [batches, channels, elements] blocks, the channel being the axis, and split
+// the work over the (batch, channel) rows.
+void quantize_tensor_per_tensor_affine_cpu(
+    const Tensor& rtensor,
+    Tensor& qtensor,
+    double scale,
+    int64_t zero_point) {
+  AT_DISPATCH_QINT_TYPES(
+      qtensor.scalar_type(), "quantize_tensor_per_tensor_affine_cpu", [&]() {
+        const float* rdata = rtensor.data_ptr<float>();
+        scalar_t* qdata = qtensor.data_ptr<scalar_t>();
+        at::parallel_for(
+            0,
+            rtensor.numel(),
+            at::internal::GRAIN_SIZE,
+            [&](int64_t begin, int64_t end) {
+              quantize_affine_vec<scalar_t>(
+                  rdata + begin, qdata + begin, end - begin, scale, zero_point);
+            });
+      });
+}
+
+void dequantize_tensor_per_tensor_affine_cpu(
+    const Tensor& qtensor,
+    Tensor& rtensor,
+    double scale,
+    int64_t zero_point) {
+  AT_DISPATCH_QINT_TYPES(
+      qtensor.scalar_type(), "dequantize_tensor_per_tensor_affine_cpu", [&]() {
+        const scalar_t* qdata = qtensor.data_ptr<scalar_t>();
+        float* rdata = rtensor.data_ptr<float>();
+        at::parallel_for(
+            0,
+            qtensor.numel(),
+            at::internal::GRAIN_SIZE,
+            [&](int64_t begin, int64_t end) {
+              dequantize_affine_vec<scalar_t>(
+                  qdata + begin, rdata + begin, end - begin, scale, zero_point);
+            });
+      });
+}
+
+void quantize_tensor_per_channel_affine_cpu(
+    const Tensor& rtensor,
+    Tensor& qtensor,
+    const Tensor& scales,
+    const Tensor& zero_points,
+    int64_t axis) {
+  const int64_t channels = rtensor.size(axis);
+  const int64_t elements = size_from_dim_(axis + 1, rtensor.sizes());
+  const int64_t rows = size_to_dim_(axis, rtensor.sizes()) * channels;
+  const float* scales_data = scales.data_ptr<float>();
+  const int32_t* zero_points_data = zero_points.data_ptr<int32_t>();
+  const int64_t grain_size = std::max<int64_t>(
+      1, at::internal::GRAIN_SIZE / std::max<int64_t>(elements, 1));
+  AT_DISPATCH_QINT_TYPES(
+      qtensor.scalar_type(), "quantize_tensor_per_channel_affine_cpu", [&]() {
+        const float* rdata = rtensor.data_ptr<float>();
+        scalar_t* qdata = qtensor.data_ptr<scalar_t>();
+        at::parallel_for(
+            0,
+            rows,
+            grain_size,
+            [&](int64_t begin, int64_t end) {
+              for (int64_t row = begin; row < end; ++row) {
+                const int64_t c = row % channels;
+                quantize_affine_vec<scalar_t>(
+                    rdata + row * elements,
+                    qdata + row * elements,
+                    elements,
+                    scales_data[c],
+                    zero_points_data[c]);
+              }
+            });
+      });
+}
+
+void dequantize_tensor_per_channel_affine_cpu(
+    const Tensor& qtensor,
+    Tensor& rtensor,
+    const Tensor& scales,
+    const Tensor& zero_points,
+    int64_t axis) {
+  const int64_t channels = qtensor.size(axis);
+  const int64_t elements = size_from_dim_(axis + 1, qtensor.sizes());
+  const int64_t rows = size_to_dim_(axis, qtensor.sizes()) * channels;
+  const float* scales_data = scales.data_ptr<float>();
+  const int32_t* zero_points_data = zero_points.data_ptr<int32_t>();
+  const int64_t grain_size = std::max<int64_t>(
+      1, at::internal::GRAIN_SIZE / std::max<int64_t>(elements, 1));
+  AT_DISPATCH_QINT_TYPES(
+      qtensor.scalar_type(), "dequantize_tensor_per_channel_affine_cpu", [&]() {
+        const scalar_t* qdata = qtensor.data_ptr<scalar_t>();
+        float* rdata = rtensor.data_ptr<float>();
+        at::parallel_for(
+            0,
+            rows,
+            grain_size,
+            [&](int64_t begin, int64_t end) {
+              for (int64_t row = begin; row < end; ++row) {
+                const int64_t c = row % channels;
+                dequantize_affine_vec<scalar_t>(
+                    qdata + row * elements,
+                    rdata + row * elements,
+                    elements,
+                    scales_data[c],
+                    zero_points_data[c]);
+              }
+            });
+      });
+}
+
 } // namespace
 
 REGISTER_DISPATCH(qrelu_stub, &qrelu_kernel);
 REGISTER_DISPATCH(qrelu6_stub, &qrelu6_kernel);
 REGISTER_DISPATCH(qadd_relu_stub, &qadd_kernel<true>);
 REGISTER_DISPATCH(qadd_stub, &qadd_kernel<false>);
+REGISTER_DISPATCH(qmul_relu_stub, &qmul_kernel<true>);
+REGISTER_DISPATCH(qmul_stub, &qmul_kernel<false>);
+REGISTER_DISPATCH(qrequantize_stub, &qrequantize_kernel);
+REGISTER_DISPATCH(qsigmoid_stub, &qsigmoid_kernel);
+REGISTER_DISPATCH(qclamp_stub, &qclamp_kernel);
 REGISTER_DISPATCH(qmaxpool_2d_nhwc_stub, &qmaxpool_2d_nhwc_kernel);
 REGISTER_DISPATCH(
     qadaptive_avg_pool2d_nhwc_stub,
@@ -825,6 +1183,18 @@ REGISTER_DISPATCH(
 REGISTER_DISPATCH(qcat_nhwc_stub, &qcat_nhwc_kernel<false>);
 REGISTER_DISPATCH(qcat_relu_nhwc_stub, &qcat_nhwc_kernel<true>);
 REGISTER_DISPATCH(qtopk_stub, &qtopk_kernel);
+REGISTER_DISPATCH(
+    quantize_tensor_per_tensor_affine_stub,
+    &quantize_tensor_per_tensor_affine_cpu);
+REGISTER_DISPATCH(
+    dequantize_tensor_per_tensor_affine_stub,
+    &dequantize_tensor_per_tensor_affine_cpu);
+REGISTER_DISPATCH(
+    quantize_tensor_per_channel_affine_stub,
+    &quantize_tensor_per_channel_affine_cpu);
+REGISTER_DISPATCH(
+    dequantize_tensor_per_channel_affine_stub,
+    &dequantize_tensor_per_channel_affine_cpu);
 
 } // namespace native
 } // namespace at
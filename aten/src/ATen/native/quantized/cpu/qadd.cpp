@@ -1,4 +1,5 @@
 #include <ATen/ATen.h>
+#include <ATen/ExpandUtils.h>
 #include <ATen/core/op_registration/op_registration.h>
 #include <ATen/cpu/vec256/vec256.h>
 #include <ATen/native/TensorIterator.h>
@@ -26,13 +27,12 @@ inline void check_inputs(const Tensor& qa, const Tensor& qb) {
   TORCH_CHECK(
       qa.qscheme() == qb.qscheme(),
       "Both inputs to Add must have the same quantization shceme.");
-  TORCH_CHECK(qa.numel() == qb.numel(), "Add operands must be the same size!");
   TORCH_CHECK(
       qa.scalar_type() == qb.scalar_type(),
       "Add operands should have same data type.");
 }
 
-// Note: out is assumed to be the same size as self and other.
+// Note: out is assumed to have the broadcast size of self and other.
 // Note: Addition is only supported when self, other, out are of the same dtype.
 template <bool ReLUFused = false>
 Tensor _add_out(Tensor& out, const Tensor& self, const Tensor& other) {
@@ -194,16 +194,21 @@ Tensor qnnpack_add(Tensor qa, Tensor qb, double scale, int64_t zero_point) {
     check_inputs(qa, qb);
 #ifdef USE_PYTORCH_QNNPACK
     if (at::globalContext().qEngine() == at::QEngine::QNNPACK &&
-        qa.scalar_type() == kQUInt8 && qb.scalar_type() == kQUInt8) {
+        qa.device().is_cpu() && qa.scalar_type() == kQUInt8 &&
+        qb.scalar_type() == kQUInt8 &&
+        qa.sizes() == qb.sizes()) {
       return qnnpack_add(qa, qb, scale, zero_point);
     }
 #endif
+    // Operands of different sizes are broadcast by TensorIterator.
+    const auto sizes = infer_size(qa.sizes(), qb.sizes());
     auto qc = at::_empty_affine_quantized(
-        qa.sizes(),
-        at::device(kCPU).dtype(qa.scalar_type()),
+        sizes,
+        qa.options(),
         scale,
         zero_point,
-        qa.suggest_memory_format());
+        qa.sizes() == sizes ? qa.suggest_memory_format()
+                            : MemoryFormat::Contiguous);
     return _add_out<ReLUFused>(qc, qa, qb);
   }
 };
@@ -214,6 +219,9 @@ class QAddOut final : public c10::OperatorKernel {
   Tensor operator()(Tensor qa, Tensor qb, Tensor out) {
     check_inputs(qa, qb);
     check_inputs(qa, out);
+    TORCH_CHECK(out.sizes() == infer_size(qa.sizes(), qb.sizes()),
+                "Add: expected out to have the broadcast size of the operands, but got ",
+                out.sizes());
     return _add_out<ReLUFused>(out, qa, qb);
   }
 };
@@ -236,6 +244,7 @@ class QAddScalarOut final : public c10::OperatorKernel {
  public:
   Tensor operator()(Tensor qa, Scalar b, Tensor out) {
     check_inputs(qa, out);
+    TORCH_CHECK(qa.numel() == out.numel(), "Add operands must be the same size!");
     return _add_scalar_out<ReLUFused>(out, qa, b);
   }
 };
@@ -244,19 +253,23 @@ static auto registry = c10::RegisterOperators()
 .op("quantized::add(Tensor qa, Tensor qb, float scale, int zero_point)"
      "-> Tensor qc",
     c10::RegisterOperators::options()
-      .kernel<QAdd</*ReLUFused=*/false>>(TensorTypeId::QuantizedCPUTensorId))
+      .kernel<QAdd</*ReLUFused=*/false>>(TensorTypeId::QuantizedCPUTensorId)
+      .kernel<QAdd</*ReLUFused=*/false>>(TensorTypeId::QuantizedCUDATensorId))
 .op("quantized::add_relu(Tensor qa, Tensor qb, float scale, int zero_point)"
      "-> Tensor qc",
     c10::RegisterOperators::options()
-      .kernel<QAdd</*ReLUFused=*/true>>(TensorTypeId::QuantizedCPUTensorId))
+      .kernel<QAdd</*ReLUFused=*/true>>(TensorTypeId::QuantizedCPUTensorId)
+      .kernel<QAdd</*ReLUFused=*/true>>(TensorTypeId::QuantizedCUDATensorId))
 .op("quantized::add_out(Tensor qa, Tensor qb, Tensor out)"
      "-> Tensor out",
     c10::RegisterOperators::options()
-      .kernel<QAddOut</*ReLUFused=*/false>>(TensorTypeId::QuantizedCPUTensorId))
+      .kernel<QAddOut</*ReLUFused=*/false>>(TensorTypeId::QuantizedCPUTensorId)
+      .kernel<QAddOut</*ReLUFused=*/false>>(TensorTypeId::QuantizedCUDATensorId))
 .op("quantized::add_relu_out(Tensor qa, Tensor qb, Tensor out)"
      "-> Tensor out",
     c10::RegisterOperators::options()
-      .kernel<QAddOut</*ReLUFused=*/true>>(TensorTypeId::QuantizedCPUTensorId))
+      .kernel<QAddOut</*ReLUFused=*/true>>(TensorTypeId::QuantizedCPUTensorId)
+      .kernel<QAddOut</*ReLUFused=*/true>>(TensorTypeId::QuantizedCUDATensorId))
 .op("quantized::add_scalar(Tensor qa, Scalar b) -> Tensor qc",
     c10::RegisterOperators::options()
       .kernel<QAddScalar</*ReLUFused=*/false>>(TensorTypeId::QuantizedCPUTensorId))
@@ -0,0 +1,19 @@
+#include <ATen/ATen.h>
+#include <ATen/NativeFunctions.h>
+#include <ATen/native/quantized/cpu/quantized_ops.h>
+
+namespace at {
+namespace native {
+
+DEFINE_DISPATCH(qclamp_stub);
+
+Tensor quantized_hardtanh(const Tensor& qx, Scalar min_val, Scalar max_val) {
+  TORCH_CHECK(
+      qx.qscheme() == kPerTensorAffine || qx.qscheme() == kPerTensorSymmetric,
+      "Only per tensor quantization is supported in hardtanh.");
+  Tensor qy;
+  qclamp_stub(qx.device().type(), qx, min_val, max_val, qy);
+  return qy;
+}
+
+}}  // namespace at::native
@@ -1,4 +1,5 @@
 #include <ATen/ATen.h>
+#include <ATen/WrapDimUtils.h>
 #include <ATen/core/op_registration/op_registration.h>
 #include <ATen/native/TensorIterator.h>
 #include <ATen/native/cpu/Loops.h>
@@ -9,6 +10,9 @@
 
 namespace at {
 namespace native {
+
+DEFINE_DISPATCH(qrequantize_stub);
+
 namespace {
 
 DEFINE_DISPATCH(qcat_nhwc_stub);
@@ -31,7 +35,8 @@ bool is_valid_quantization_scheme(const Tensor& t) {
 
 /* Quantized concatenation.
  *
- * Note: This function uses a dequantization.
+ * Note: Every input is requantized directly into its slice of the output,
+ * without a round trip through a float tensor.
  */
 template <bool ReLUFused>
 Tensor quantized_cat(
@@ -51,27 +56,49 @@ Tensor quantized_cat(
     }
   }
 
-  const auto x_dtype = qxs.get(0).scalar_type();
-  const auto x_qscheme = qxs.get(0).qscheme();
-  std::vector<Tensor> xs;
-  xs.reserve(qxs.size());
+  const Tensor& qx0 = qxs.get(0);
+  const auto x_dtype = qx0.scalar_type();
+  const auto x_qscheme = qx0.qscheme();
+  TORCH_CHECK(qx0.dim() > 0, "zero-dimensional tensor cannot be concatenated");
+  dim = maybe_wrap_dim(dim, qx0.dim());
+  std::vector<int64_t> out_sizes = qx0.sizes().vec();
+  out_sizes[dim] = 0;
   for (const at::Tensor& qx : qxs) {
     TORCH_CHECK(x_dtype == qx.scalar_type(), "All dtypes must be the same.");
     TORCH_CHECK(
         x_qscheme == qx.qscheme(), "Quantization schemes must be the same.");
-    xs.push_back(qx.dequantize());
+    TORCH_CHECK(
+        qx.dim() == qx0.dim(),
+        "Tensors must have the same number of dimensions: got ",
+        qx.dim(),
+        " and ",
+        qx0.dim());
+    for (int64_t d = 0; d < qx.dim(); ++d) {
+      TORCH_CHECK(
+          d == dim || qx.size(d) == qx0.size(d),
+          "Sizes of tensors must match except in dimension ",
+          dim,
+          ". Got ",
+          qx.size(d),
+          " and ",
+          qx0.size(d),
+          " in dimension ",
+          d);
+    }
+    out_sizes[dim] += qx.size(dim);
   }
-  const Tensor y = at::cat(xs, dim);
-  Tensor qy;
-  AT_DISPATCH_QINT_TYPES(x_dtype, "qcat", [&]() {
-    qy = at::quantize_per_tensor(y, scale, zero_point, SCALAR_TYPE);
-    if (ReLUFused) {
-      auto iter = TensorIterator::unary_op(qy, qy);
-      cpu_kernel(iter, [&](scalar_t value) -> scalar_t {
-        return scalar_t(std::max<underlying_t>(value.val_, zero_point));
-      });
+
+  Tensor qy = at::_empty_affine_quantized(
+      out_sizes, at::device(kCPU).dtype(x_dtype), scale, zero_point);
+  int64_t offset = 0;
+  for (const at::Tensor& qx : qxs) {
+    const int64_t size = qx.size(dim);
+    if (size > 0) {
+      Tensor qy_slice = qy.narrow(dim, offset, size);
+      qrequantize_stub(at::kCPU, qy_slice, qx, ReLUFused);
     }
-  });
+    offset += size;
+  }
   return qy;
 }
 
@@ -9,6 +9,7 @@
 #include <ATen/cpp_custom_type_hack.h>
 #include <ATen/native/quantized/cpu/fbgemm_utils.h>
 #include <ATen/native/quantized/cpu/qnnpack_utils.h>
+#include <ATen/native/quantized/cpu/quantized_ops.h>
 #include <caffe2/utils/threadpool/ThreadPoolMobile.h>
 
 namespace at {
@@ -520,9 +521,7 @@ class QConvInt8 final : public c10::OperatorKernel {
 
     const uint32_t kernel_h = kernel[0];
     const uint32_t kernel_w = kernel[1];
-    // TODO Can be replaced with packB->getOutputChannels() when update pre-pack
-    // to actually do the packing.
-    const auto out_ch = pack_data.bias.size(0);
+    const auto out_ch = pack_w->getOutputChannels();
     // inputs are in semantic NCHW format
     const int N = act.size(0);
     const int C = act.size(1);
@@ -562,39 +561,19 @@ class QConvInt8 final : public c10::OperatorKernel {
 
     auto input_scale = act_nhwc.q_scale();
 
-    // Re-quantizing the bias based on input scale and weight scale.
+    // Re-quantizing the bias based on input scale and weight scale. The
+    // weights were packed at prepack time, only their bias is updated.
+    TORCH_INTERNAL_ASSERT(pack_w != nullptr, "Packed Weights are NULL");
     if (!pack_data.input_scale.has_value() ||
         pack_data.input_scale.value() != input_scale) {
-      // Get the original weight and adjust it to uint8 from int8
-      auto weight_contig =
-          pack_data.orig_weight.contiguous(MemoryFormat::ChannelsLast);
-      auto bias_fp32 = pack_data.bias;
-      int8_t* w_data =
-          reinterpret_cast<int8_t*>(weight_contig.data_ptr<c10::qint8>());
-      Tensor qnnp_weight = at::_empty_affine_quantized(
-          weight_contig.sizes(),
-          at::device(kCPU).dtype(kQUInt8),
-          kernel_scale,
-          kernel_zp,
-          MemoryFormat::ChannelsLast);
-      auto* qnnp_w_data = qnnp_weight.data_ptr<c10::quint8>();
-      auto wt_numel = weight_contig.numel();
-      for (int i = 0; i < wt_numel; ++i) {
-        qnnp_w_data[i] = static_cast<c10::quint8>(w_data[i] + 128);
-      }
       // Original bias was float, so we requantize it here.
       auto bias = at::quantize_per_tensor(
-          bias_fp32, kernel_scale * input_scale, 0, kQInt32);
-      // Update the input scale to not pack again.
+          pack_data.bias, kernel_scale * input_scale, 0, kQInt32);
+      pack_w->updateBias(
+          conv_p, reinterpret_cast<int32_t*>(bias.data_ptr<c10::qint32>()));
+      // Update the input scale to not requantize again.
       pack_data.input_scale = input_scale;
-      pack_data.w.reset();
-      pack_data.w = guts::make_unique<qnnpack::PrePackConvWeights>(
-          conv_p,
-          reinterpret_cast<uint8_t*>(qnnp_w_data),
-          reinterpret_cast<int32_t*>(bias.data_ptr<c10::qint32>()));
-      pack_w = pack_data.w.get();
     }
-    TORCH_INTERNAL_ASSERT(pack_w != nullptr, "Packed Weights are NULL");
     const auto output_shape = MakeConvOutputShape<kSpatialDim>(
         N, M, {H, W}, kernel, stride, padding, dilation);
     TORCH_CHECK(
@@ -636,6 +615,67 @@ class QConvInt8 final : public c10::OperatorKernel {
 #endif
 };
 
+/*
+ * The residual block epilogue of a 2D convolution,
+ *   relu(conv(act) + other), requantized to output_scale and output_zero_point
+ * The convolution is requantized to conv_scale and conv_zero_point, as
+ * quantized::conv2d would be followed by quantized::add(_relu), and the
+ * addition runs over the convolution's output in place. FBGEMM only runs its
+ * own output pipelines, so the addition can't be moved into the requantization
+ * of the accumulators without losing the range of the convolution.
+ */
+template <bool kReluFused>
+class QConvAddInt8 final : public c10::OperatorKernel {
+ public:
+  Tensor operator()(
+      Tensor act,
+      Tensor other,
+      Tensor packed_weight,
+      torch::List<int64_t> stride,
+      torch::List<int64_t> padding,
+      torch::List<int64_t> dilation,
+      int64_t groups,
+      double conv_scale,
+      int64_t conv_zero_point,
+      double output_scale,
+      int64_t output_zero_point) {
+    Tensor conv = QConvInt8<2, false>()(
+        act,
+        packed_weight,
+        stride,
+        padding,
+        dilation,
+        groups,
+        conv_scale,
+        conv_zero_point);
+    TORCH_CHECK(
+        other.sizes() == conv.sizes(),
+        "quantized::conv2d_add: Expected the residual to have the size of the "
+        "convolution's output ",
+        conv.sizes(),
+        " but got ",
+        other.sizes());
+    TORCH_CHECK(
+        other.qscheme() == kPerTensorAffine &&
+            other.scalar_type() == conv.scalar_type(),
+        "quantized::conv2d_add: Expected a per tensor quantized residual of "
+        "type ",
+        toString(conv.scalar_type()));
+
+    // The output shares the convolution's storage, with its own quantizer
+    Tensor output = at::_empty_affine_quantized(
+        {0}, conv.options(), output_scale, output_zero_point);
+    output.set_(
+        conv.storage(), conv.storage_offset(), conv.sizes(), conv.strides());
+    if (kReluFused) {
+      qadd_relu_stub(conv.device().type(), output, conv, other);
+    } else {
+      qadd_stub(conv.device().type(), output, conv, other);
+    }
+    return output;
+  }
+};
+
 static auto registry =
     c10::RegisterOperators()
         .op("quantized::conv2d",
@@ -644,6 +684,12 @@ static auto registry =
         .op("quantized::conv2d_relu",
             c10::RegisterOperators::options().kernel<QConvInt8<2, true>>(
                 TensorTypeId::QuantizedCPUTensorId))
+        .op("quantized::conv2d_add",
+            c10::RegisterOperators::options().kernel<QConvAddInt8<false>>(
+                TensorTypeId::QuantizedCPUTensorId))
+        .op("quantized::conv2d_add_relu",
+            c10::RegisterOperators::options().kernel<QConvAddInt8<true>>(
+                TensorTypeId::QuantizedCPUTensorId))
         .op("quantized::conv3d",
             c10::RegisterOperators::options().kernel<QConvInt8<3, false>>(
                 TensorTypeId::QuantizedCPUTensorId))
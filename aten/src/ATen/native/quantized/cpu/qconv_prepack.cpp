@@ -7,6 +7,7 @@
 #include <ATen/native/quantized/cpu/fbgemm_utils.h>
 #include <ATen/native/quantized/cpu/init_qnnpack.h>
 #include <ATen/native/quantized/cpu/qnnpack_utils.h>
+#include <ATen/native/quantized/cuda/qgemm_utils.h>
 #include <ATen/quantized/Quantizer.h>
 
 namespace caffe2 {
@@ -22,6 +23,9 @@ CAFFE_KNOWN_TYPE(PackedConvWeight<3>);
 CAFFE_KNOWN_TYPE(PackedConvWeightsQnnp);
 #endif // USE_PYTORCH_QNNPACK
 
+// Known to the CPU library too, as conv_unpack runs on the CPU
+CAFFE_KNOWN_TYPE(PackedConvWeightCuda);
+
 } // namespace caffe2
 
 namespace at {
@@ -121,21 +125,10 @@ class QConvPackWeightInt8 final : public c10::OperatorKernel {
             std::vector<int>(dilation.begin(), dilation.end()));
 
     const auto qtype = weight.qscheme();
+    std::vector<float> scales;
     std::vector<int32_t> zero_points;
-    if (qtype == kPerTensorAffine) {
-      zero_points = {static_cast<int32_t>(weight.q_zero_point())};
-    } else if (qtype == kPerChannelAffine) {
-      int64_t axis = weight.q_per_channel_axis();
-      TORCH_CHECK(
-          axis == 0,
-          "Only per output channel quantization is supported for the weights");
-      zero_points.resize(output_channels);
-      for (int i = 0; i < output_channels; ++i) {
-        zero_points[i] = weight.q_per_channel_zero_points()[i].item<int32_t>();
-      }
-    } else {
-      TORCH_CHECK(false, "Unsupported qscheme: ", toString(qtype));
-    }
+    fbgemm_utils::GetWeightQuantizationParams(
+        weight, output_channels, &scales, &zero_points);
 
     // FBGEMM expects weights to be in channels last
     // TODO: Change this when ChannelsLast3d is ready.
@@ -167,16 +160,6 @@ class QConvPackWeightInt8 final : public c10::OperatorKernel {
       }
     }
 
-    std::vector<float> scales;
-    if (qtype == kPerTensorAffine) {
-      scales = {static_cast<float>(weight.q_scale())};
-    } else if (qtype == kPerChannelAffine) {
-      scales.resize(output_channels);
-      for (int i = 0; i < output_channels; ++i) {
-        scales[i] = weight.q_per_channel_scales()[i].item<float>();
-      }
-    }
-
     c10::optional<at::Tensor> bias_contig;
     if (bias.has_value()) {
       Tensor bias_vec = bias.value();
@@ -267,6 +250,9 @@ class QConvPackWeightInt8 final : public c10::OperatorKernel {
     uint32_t dilation_h = dilation[0];
     uint32_t dilation_w = dilation[1];
 
+    auto weight_contig = weight.contiguous(MemoryFormat::ChannelsLast);
+    auto weight_zp = weight.q_zero_point() + 128;
+
     qnnpack::conv_param_t conv_p(
         {kernel_w, kernel_h},
         {stride_w, stride_h},
@@ -275,14 +261,11 @@ class QConvPackWeightInt8 final : public c10::OperatorKernel {
         groups,
         in_ch,
         out_ch,
-        weight.q_zero_point(),
+        weight_zp,
         weight.q_scale(),
         std::numeric_limits<uint8_t>::min(),
         std::numeric_limits<uint8_t>::max());
 
-    auto weight_contig = weight.contiguous(MemoryFormat::ChannelsLast);
-    auto weight_zp = weight.q_zero_point() + 128;
-
     int8_t* w_data = (int8_t*)weight_contig.data_ptr<c10::qint8>();
     Tensor qnnp_weight = at::_empty_affine_quantized(
         weight_contig.sizes(),
@@ -294,12 +277,16 @@ class QConvPackWeightInt8 final : public c10::OperatorKernel {
     for (int i = 0; i < wt_numel; ++i) {
       qnnp_w_data[i] = static_cast<c10::quint8>(w_data[i] + 128);
     }
-    // We set the pre-packed conv weights to nullptr below as we call pre-pack
-    // during the first invocation of operator run. Refer to qconv.cpp for more
-    // details. TODO Update to actually call pre-pack here once bias is removed
-    // from pre-packing step.
+    // The bias is quantized with the input scale, which is only known when the
+    // operator runs, so the weights are packed with a zero bias here and the
+    // first run writes the quantized one in place. Refer to qconv.cpp for more
+    // details.
+    std::vector<int32_t> zero_bias(out_ch, 0);
     auto wt_ptr = guts::make_unique<PackedConvWeightsQnnp>(
-        PackedConvWeightsQnnp{nullptr, /* PrePackConvWeights */
+        PackedConvWeightsQnnp{guts::make_unique<qnnpack::PrePackConvWeights>(
+                                  conv_p,
+                                  reinterpret_cast<uint8_t*>(qnnp_w_data),
+                                  zero_bias.data()),
                               weight_contig, /* int8_t weight */
                               bias_fp32.contiguous(), /* fp32 bias */
                               c10::nullopt, /* input_scale */
@@ -6,6 +6,7 @@
 #include <ATen/cpp_custom_type_hack.h>
 #include <ATen/native/quantized/cpu/fbgemm_utils.h>
 #include <ATen/native/quantized/cpu/qnnpack_utils.h>
+#include <ATen/native/quantized/cuda/qgemm_utils.h>
 
 namespace at {
 namespace native {
@@ -23,6 +24,14 @@ class QConvUnpackWeightsInt8 final : public c10::OperatorKernel {
  public:
   std::tuple<at::Tensor, c10::optional<at::Tensor>> operator()(
       Tensor packed_weights) {
+    // The weights packed for CUDA devices are wrapped in CPU tensors too
+    if (cpp_custom_type_hack::isa<PackedConvWeightCuda>(packed_weights)) {
+      auto& pack_ptr =
+          cpp_custom_type_hack::cast<PackedConvWeightCuda>(packed_weights);
+      return std::tuple<at::Tensor, c10::optional<Tensor>>(
+          pack_ptr.orig_weight, pack_ptr.bias);
+    }
+
     auto& ctx = at::globalContext();
 
 #ifdef USE_FBGEMM
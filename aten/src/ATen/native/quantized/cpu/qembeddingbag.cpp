@@ -0,0 +1,364 @@
+#include <ATen/ATen.h>
+#include <ATen/Parallel.h>
+#include <ATen/core/op_registration/op_registration.h>
+
+#include <caffe2/perfkernels/fused_8bit_rowwise_embedding_lookup_idx.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+// Row-wise quantized embedding tables.
+//
+// 8-bit rows hold embedding_dim uint8 values followed by a float scale and a
+// float bias, the "fused" layout of caffe2's FloatToFused8BitRowwiseQuantized:
+//   | uint8 x embedding_dim | float scale | float bias |
+// 4-bit rows pack two values per byte, low nibble first, followed by a half
+// scale and a half bias, the layout of caffe2's
+// FloatToFused4BitRowwiseQuantized:
+//   | uint8 x embedding_dim / 2 | half scale | half bias |
+// In both cases a value dequantizes to q * scale + bias.
+
+namespace at {
+namespace native {
+namespace {
+
+const int MODE_SUM = 0;
+const int MODE_MEAN = 1;
+
+void check_prepack_input(const Tensor& weight, const char* name) {
+  TORCH_CHECK(weight.dim() == 2, name, ": expected a 2D weight, but got ", weight.dim(), "D");
+  TORCH_CHECK(weight.scalar_type() == kFloat,
+      name, ": expected a float weight, but got ", weight.scalar_type());
+  TORCH_CHECK(weight.size(1) > 0, name, ": expected a non-empty embedding dimension");
+}
+
+class QEmbeddingBagBytePrepack final : public c10::OperatorKernel {
+ public:
+  Tensor operator()(Tensor weight) {
+    check_prepack_input(weight, "embedding_bag_byte_prepack");
+    auto weight_contig = weight.contiguous();
+    int64_t num_embeddings = weight.size(0);
+    int64_t embedding_dim = weight.size(1);
+    int64_t row_bytes = embedding_dim + 2 * sizeof(float);
+    auto output = at::empty({num_embeddings, row_bytes}, weight.options().dtype(kByte));
+
+    const float* weight_data = weight_contig.data_ptr<float>();
+    uint8_t* output_data = output.data_ptr<uint8_t>();
+    at::parallel_for(0, num_embeddings, 1, [&](int64_t begin, int64_t end) {
+      for (int64_t row = begin; row < end; row++) {
+        const float* input_row = weight_data + row * embedding_dim;
+        uint8_t* output_row = output_data + row * row_bytes;
+        float minimum = *std::min_element(input_row, input_row + embedding_dim);
+        float maximum = *std::max_element(input_row, input_row + embedding_dim);
+        float range = maximum - minimum;
+        float scale = range / 255.0f;
+        float inverse_scale = 255.0f / (range + 1e-8f);
+        for (int64_t j = 0; j < embedding_dim; j++) {
+          output_row[j] = std::round((input_row[j] - minimum) * inverse_scale);
+        }
+        std::memcpy(output_row + embedding_dim, &scale, sizeof(float));
+        std::memcpy(output_row + embedding_dim + sizeof(float), &minimum, sizeof(float));
+      }
+    });
+    return output;
+  }
+};
+
+class QEmbeddingBag4BitPrepack final : public c10::OperatorKernel {
+ public:
+  Tensor operator()(Tensor weight) {
+    check_prepack_input(weight, "embedding_bag_4bit_prepack");
+    TORCH_CHECK(weight.size(1) % 2 == 0,
+        "embedding_bag_4bit_prepack: expected an even embedding dimension, but got ", weight.size(1));
+    auto weight_contig = weight.contiguous();
+    int64_t num_embeddings = weight.size(0);
+    int64_t embedding_dim = weight.size(1);
+    int64_t row_bytes = embedding_dim / 2 + 2 * sizeof(at::Half);
+    auto output = at::empty({num_embeddings, row_bytes}, weight.options().dtype(kByte));
+
+    const float* weight_data = weight_contig.data_ptr<float>();
+    uint8_t* output_data = output.data_ptr<uint8_t>();
+    at::parallel_for(0, num_embeddings, 1, [&](int64_t begin, int64_t end) {
+      for (int64_t row = begin; row < end; row++) {
+        const float* input_row = weight_data + row * embedding_dim;
+        uint8_t* output_row = output_data + row * row_bytes;
+        // scale and bias are stored as half, so quantize against the rounded
+        // values to keep everything consistent
+        at::Half minimum = *std::min_element(input_row, input_row + embedding_dim);
+        float maximum = *std::max_element(input_row, input_row + embedding_dim);
+        at::Half scale = (maximum - minimum) / 15.0f;
+        if (static_cast<float>(scale) == 0.0f ||
+            std::isinf(1.0f / static_cast<float>(scale))) {
+          scale = 1.0f;
+        }
+        float inverse_scale = 1.0f / scale;
+        std::fill(output_row, output_row + embedding_dim / 2, 0);
+        for (int64_t j = 0; j < embedding_dim; j++) {
+          long q = std::lrintf((input_row[j] - minimum) * inverse_scale);
+          q = std::max(0L, std::min(q, 15L));
+          output_row[j / 2] |= static_cast<uint8_t>(q << ((j % 2) * 4));
+        }
+        std::memcpy(output_row + embedding_dim / 2, &scale, sizeof(at::Half));
+        std::memcpy(output_row + embedding_dim / 2 + sizeof(at::Half), &minimum, sizeof(at::Half));
+      }
+    });
+    return output;
+  }
+};
+
+class QEmbeddingBagByteUnpack final : public c10::OperatorKernel {
+ public:
+  Tensor operator()(Tensor packed_weight) {
+    TORCH_CHECK(packed_weight.dim() == 2 && packed_weight.scalar_type() == kByte &&
+        packed_weight.size(1) > static_cast<int64_t>(2 * sizeof(float)),
+        "embedding_bag_byte_unpack: expected a 2D uint8 tensor from embedding_bag_byte_prepack");
+    auto packed_contig = packed_weight.contiguous();
+    int64_t num_embeddings = packed_weight.size(0);
+    int64_t row_bytes = packed_weight.size(1);
+    int64_t embedding_dim = row_bytes - 2 * sizeof(float);
+    auto output = at::empty({num_embeddings, embedding_dim}, packed_weight.options().dtype(kFloat));
+
+    const uint8_t* packed_data = packed_contig.data_ptr<uint8_t>();
+    float* output_data = output.data_ptr<float>();
+    at::parallel_for(0, num_embeddings, 1, [&](int64_t begin, int64_t end) {
+      for (int64_t row = begin; row < end; row++) {
+        const uint8_t* input_row = packed_data + row * row_bytes;
+        float* output_row = output_data + row * embedding_dim;
+        float scale, bias;
+        std::memcpy(&scale, input_row + embedding_dim, sizeof(float));
+        std::memcpy(&bias, input_row + embedding_dim + sizeof(float), sizeof(float));
+        for (int64_t j = 0; j < embedding_dim; j++) {
+          output_row[j] = input_row[j] * scale + bias;
+        }
+      }
+    });
+    return output;
+  }
+};
+
+class QEmbeddingBag4BitUnpack final : public c10::OperatorKernel {
+ public:
+  Tensor operator()(Tensor packed_weight) {
+    TORCH_CHECK(packed_weight.dim() == 2 && packed_weight.scalar_type() == kByte &&
+        packed_weight.size(1) > static_cast<int64_t>(2 * sizeof(at::Half)),
+        "embedding_bag_4bit_unpack: expected a 2D uint8 tensor from embedding_bag_4bit_prepack");
+    auto packed_contig = packed_weight.contiguous();
+    int64_t num_embeddings = packed_weight.size(0);
+    int64_t row_bytes = packed_weight.size(1);
+    int64_t embedding_dim = (row_bytes - 2 * sizeof(at::Half)) * 2;
+    auto output = at::empty({num_embeddings, embedding_dim}, packed_weight.options().dtype(kFloat));
+
+    const uint8_t* packed_data = packed_contig.data_ptr<uint8_t>();
+    float* output_data = output.data_ptr<float>();
+    at::parallel_for(0, num_embeddings, 1, [&](int64_t begin, int64_t end) {
+      for (int64_t row = begin; row < end; row++) {
+        const uint8_t* input_row = packed_data + row * row_bytes;
+        float* output_row = output_data + row * embedding_dim;
+        at::Half scale, bias;
+        std::memcpy(&scale, input_row + embedding_dim / 2, sizeof(at::Half));
+        std::memcpy(&bias, input_row + embedding_dim / 2 + sizeof(at::Half), sizeof(at::Half));
+        for (int64_t j = 0; j < embedding_dim; j++) {
+          uint8_t q = (input_row[j / 2] >> ((j % 2) * 4)) & 0xF;
+          output_row[j] = q * static_cast<float>(scale) + static_cast<float>(bias);
+        }
+      }
+    });
+    return output;
+  }
+};
+
+void check_embedding_bag_inputs(
+    const Tensor& packed_weight,
+    const Tensor& indices,
+    const Tensor& offsets,
+    int64_t mode,
+    const c10::optional<Tensor>& per_sample_weights,
+    const char* name) {
+  TORCH_CHECK(packed_weight.dim() == 2 && packed_weight.scalar_type() == kByte,
+      name, ": expected a 2D uint8 packed weight");
+  TORCH_CHECK(indices.dim() == 1 && indices.scalar_type() == kLong,
+      name, ": expected indices to be a 1D long tensor");
+  TORCH_CHECK(offsets.dim() == 1 && offsets.scalar_type() == kLong,
+      name, ": expected offsets to be a 1D long tensor");
+  TORCH_CHECK(mode == MODE_SUM || mode == MODE_MEAN,
+      name, ": only mode='sum' (0) and mode='mean' (1) are supported");
+  if (per_sample_weights.has_value()) {
+    TORCH_CHECK(per_sample_weights->dim() == 1 && per_sample_weights->scalar_type() == kFloat &&
+        per_sample_weights->numel() == indices.numel(),
+        name, ": expected per_sample_weights to be a 1D float tensor with as many elements as indices");
+  }
+  // The lookup kernels walk the indices bag by bag, so the offsets have to
+  // partition them exactly.
+  auto offsets_data = offsets.data_ptr<int64_t>();
+  int64_t num_bags = offsets.numel();
+  TORCH_CHECK(num_bags == 0 || offsets_data[0] == 0, name, ": expected offsets[0] to be 0");
+  for (int64_t i = 1; i < num_bags; i++) {
+    TORCH_CHECK(offsets_data[i - 1] <= offsets_data[i], name, ": expected offsets to be non-decreasing");
+  }
+  TORCH_CHECK(num_bags == 0 || offsets_data[num_bags - 1] <= indices.numel(),
+      name, ": expected the last offset to be at most the number of indices");
+}
+
+class QEmbeddingBagByteRowwiseOffsets final : public c10::OperatorKernel {
+ public:
+  Tensor operator()(
+      Tensor packed_weight,
+      Tensor indices,
+      Tensor offsets,
+      int64_t mode,
+      c10::optional<Tensor> per_sample_weights) {
+    auto indices_contig = indices.contiguous();
+    auto offsets_contig = offsets.contiguous();
+    check_embedding_bag_inputs(
+        packed_weight, indices_contig, offsets_contig, mode, per_sample_weights,
+        "embedding_bag_byte_rowwise_offsets");
+    TORCH_CHECK(packed_weight.size(1) > static_cast<int64_t>(2 * sizeof(float)),
+        "embedding_bag_byte_rowwise_offsets: packed weight rows are too short");
+    auto packed_contig = packed_weight.contiguous();
+    Tensor per_sample_weights_contig;
+    if (per_sample_weights.has_value()) {
+      per_sample_weights_contig = per_sample_weights->contiguous();
+    }
+
+    int64_t num_embeddings = packed_weight.size(0);
+    int64_t embedding_dim = packed_weight.size(1) - 2 * sizeof(float);
+    int64_t num_bags = offsets.numel();
+    int64_t numel = indices.numel();
+    auto output = at::empty({num_bags, embedding_dim}, packed_weight.options().dtype(kFloat));
+
+    const uint8_t* weight_data = packed_contig.data_ptr<uint8_t>();
+    const int64_t* indices_data = indices_contig.data_ptr<int64_t>();
+    const int64_t* offsets_data = offsets_contig.data_ptr<int64_t>();
+    const float* per_sample_weights_data = per_sample_weights_contig.defined()
+        ? per_sample_weights_contig.data_ptr<float>() : nullptr;
+    float* output_data = output.data_ptr<float>();
+
+    // The perfkernel expects the offsets of its first bag to start at 0, so
+    // every chunk of bags gets its own rebased copy of the offsets.
+    const int64_t grain_size = std::max<int64_t>(1, at::internal::GRAIN_SIZE / embedding_dim);
+    at::parallel_for(0, num_bags, grain_size, [&](int64_t begin, int64_t end) {
+      int64_t index_begin = offsets_data[begin];
+      int64_t index_end = end == num_bags ? numel : offsets_data[end];
+      std::vector<int64_t> chunk_offsets(end - begin);
+      for (int64_t bag = begin; bag < end; bag++) {
+        chunk_offsets[bag - begin] = offsets_data[bag] - index_begin;
+      }
+      caffe2::Fused8BitRowwiseEmbeddingLookupIdx<int64_t, uint8_t, float>(
+          /*block_size=*/embedding_dim,
+          /*output_size=*/end - begin,
+          /*index_size=*/index_end - index_begin,
+          /*data_size=*/num_embeddings,
+          /*input=*/weight_data,
+          /*indices=*/indices_data + index_begin,
+          /*offsets=*/chunk_offsets.data(),
+          /*weights=*/per_sample_weights_data ? per_sample_weights_data + index_begin : nullptr,
+          /*normalize_by_lengths=*/mode == MODE_MEAN,
+          /*out=*/output_data + begin * embedding_dim);
+    });
+    return output;
+  }
+};
+
+// There is no 4-bit perfkernel, so this one is a plain loop over the packed
+// rows.
+class QEmbeddingBag4BitRowwiseOffsets final : public c10::OperatorKernel {
+ public:
+  Tensor operator()(
+      Tensor packed_weight,
+      Tensor indices,
+      Tensor offsets,
+      int64_t mode,
+      c10::optional<Tensor> per_sample_weights) {
+    auto indices_contig = indices.contiguous();
+    auto offsets_contig = offsets.contiguous();
+    check_embedding_bag_inputs(
+        packed_weight, indices_contig, offsets_contig, mode, per_sample_weights,
+        "embedding_bag_4bit_rowwise_offsets");
+    TORCH_CHECK(packed_weight.size(1) > static_cast<int64_t>(2 * sizeof(at::Half)),
+        "embedding_bag_4bit_rowwise_offsets: packed weight rows are too short");
+    auto packed_contig = packed_weight.contiguous();
+    Tensor per_sample_weights_contig;
+    if (per_sample_weights.has_value()) {
+      per_sample_weights_contig = per_sample_weights->contiguous();
+    }
+
+    int64_t num_embeddings = packed_weight.size(0);
+    int64_t row_bytes = packed_weight.size(1);
+    int64_t packed_dim = row_bytes - 2 * sizeof(at::Half);
+    int64_t embedding_dim = packed_dim * 2;
+    int64_t num_bags = offsets.numel();
+    int64_t numel = indices.numel();
+    auto output = at::empty({num_bags, embedding_dim}, packed_weight.options().dtype(kFloat));
+
+    const uint8_t* weight_data = packed_contig.data_ptr<uint8_t>();
+    const int64_t* indices_data = indices_contig.data_ptr<int64_t>();
+    const int64_t* offsets_data = offsets_contig.data_ptr<int64_t>();
+    const float* per_sample_weights_data = per_sample_weights_contig.defined()
+        ? per_sample_weights_contig.data_ptr<float>() : nullptr;
+    float* output_data = output.data_ptr<float>();
+
+    const int64_t grain_size = std::max<int64_t>(1, at::internal::GRAIN_SIZE / embedding_dim);
+    at::parallel_for(0, num_bags, grain_size, [&](int64_t begin, int64_t end) {
+      for (int64_t bag = begin; bag < end; bag++) {
+        float* out = output_data + bag * embedding_dim;
+        std::fill(out, out + embedding_dim, 0.0f);
+        int64_t start = offsets_data[bag];
+        int64_t stop = bag == num_bags - 1 ? numel : offsets_data[bag + 1];
+        for (int64_t i = start; i < stop; i++) {
+          int64_t idx = indices_data[i];
+          TORCH_CHECK(idx >= 0 && idx < num_embeddings,
+              "embedding_bag_4bit_rowwise_offsets: index ", idx,
+              " is out of bounds for a table of size ", num_embeddings);
+          const uint8_t* row = weight_data + idx * row_bytes;
+          at::Half scale_half, bias_half;
+          std::memcpy(&scale_half, row + packed_dim, sizeof(at::Half));
+          std::memcpy(&bias_half, row + packed_dim + sizeof(at::Half), sizeof(at::Half));
+          float weight = per_sample_weights_data ? per_sample_weights_data[i] : 1.0f;
+          float scale = weight * static_cast<float>(scale_half);
+          float bias = weight * static_cast<float>(bias_half);
+          for (int64_t j = 0; j < packed_dim; j++) {
+            out[2 * j] += scale * (row[j] & 0xF) + bias;
+            out[2 * j + 1] += scale * (row[j] >> 4) + bias;
+          }
+        }
+        if (mode == MODE_MEAN && stop > start) {
+          float inverse_length = 1.0f / (stop - start);
+          for (int64_t j = 0; j < embedding_dim; j++) {
+            out[j] *= inverse_length;
+          }
+        }
+      }
+    });
+    return output;
+  }
+};
+
+static auto registry =
+    c10::RegisterOperators()
+        .op("quantized::embedding_bag_byte_prepack(Tensor weight) -> Tensor",
+            c10::RegisterOperators::options().kernel<QEmbeddingBagBytePrepack>(
+                TensorTypeId::CPUTensorId))
+        .op("quantized::embedding_bag_4bit_prepack(Tensor weight) -> Tensor",
+            c10::RegisterOperators::options().kernel<QEmbeddingBag4BitPrepack>(
+                TensorTypeId::CPUTensorId))
+        .op("quantized::embedding_bag_byte_unpack(Tensor packed_weight) -> Tensor",
+            c10::RegisterOperators::options().kernel<QEmbeddingBagByteUnpack>(
+                TensorTypeId::CPUTensorId))
+        .op("quantized::embedding_bag_4bit_unpack(Tensor packed_weight) -> Tensor",
+            c10::RegisterOperators::options().kernel<QEmbeddingBag4BitUnpack>(
+                TensorTypeId::CPUTensorId))
+        .op("quantized::embedding_bag_byte_rowwise_offsets(Tensor packed_weight, Tensor indices, "
+            "Tensor offsets, int mode=0, Tensor? per_sample_weights=None) -> Tensor",
+            c10::RegisterOperators::options().kernel<QEmbeddingBagByteRowwiseOffsets>(
+                TensorTypeId::CPUTensorId))
+        .op("quantized::embedding_bag_4bit_rowwise_offsets(Tensor packed_weight, Tensor indices, "
+            "Tensor offsets, int mode=0, Tensor? per_sample_weights=None) -> Tensor",
+            c10::RegisterOperators::options().kernel<QEmbeddingBag4BitRowwiseOffsets>(
+                TensorTypeId::CPUTensorId));
+
+} // namespace
+} // namespace native
+} // namespace at
@@ -4,6 +4,7 @@
 #include <ATen/cpp_custom_type_hack.h>
 #include <ATen/native/quantized/cpu/fbgemm_utils.h>
 #include <ATen/native/quantized/cpu/qnnpack_utils.h>
+#include <ATen/quantized/Quantizer.h>
 #include <caffe2/utils/threadpool/ThreadPoolMobile.h>
 
 #include <algorithm>
@@ -351,6 +352,47 @@ class QLinearInt8 final : public torch::OperatorKernel {
   }
 };
 
+// hardtanh(linear(X)) requantized: as the quantization is monotonic, this is
+// the quantized linear clamped to [quantize(min_val), quantize(max_val)], done
+// in place over its output.
+class QLinearHardtanhInt8 final : public torch::OperatorKernel {
+ public:
+  at::Tensor operator()(
+      at::Tensor input,
+      at::Tensor packed_weight,
+      double output_scale,
+      int64_t output_zero_point,
+      double min_val,
+      double max_val) {
+    TORCH_CHECK(
+        min_val <= max_val,
+        "quantized::linear_hardtanh: Expected min_val <= max_val, but got ",
+        min_val,
+        " and ",
+        max_val);
+    at::Tensor output = QLinearInt8</*ReluFused=*/false>()(
+        input, packed_weight, output_scale, output_zero_point);
+    const uint8_t qmin =
+        at::quantize_val<c10::quint8>(output_scale, output_zero_point, min_val)
+            .val_;
+    const uint8_t qmax =
+        at::quantize_val<c10::quint8>(output_scale, output_zero_point, max_val)
+            .val_;
+    uint8_t* output_data =
+        reinterpret_cast<uint8_t*>(output.data_ptr<c10::quint8>());
+    at::parallel_for(
+        0,
+        output.numel(),
+        at::internal::GRAIN_SIZE,
+        [&](int64_t begin, int64_t end) {
+          for (int64_t i = begin; i < end; ++i) {
+            output_data[i] = std::min(std::max(output_data[i], qmin), qmax);
+          }
+        });
+    return output;
+  }
+};
+
 static auto registry =
     torch::RegisterOperators()
         .op("quantized::linear(Tensor X, Tensor W_prepack, float Y_scale_i, int Y_zero_point_i) -> Tensor Y",
@@ -358,6 +400,9 @@ static auto registry =
                 TensorTypeId::QuantizedCPUTensorId))
         .op("quantized::linear_relu(Tensor X, Tensor W_prepack, float Y_scale_i, int Y_zero_point_i) -> Tensor Y",
             torch::RegisterOperators::options().kernel<QLinearInt8<true>>(
+                TensorTypeId::QuantizedCPUTensorId))
+        .op("quantized::linear_hardtanh(Tensor X, Tensor W_prepack, float Y_scale_i, int Y_zero_point_i, float min_val, float max_val) -> Tensor Y",
+            torch::RegisterOperators::options().kernel<QLinearHardtanhInt8>(
                 TensorTypeId::QuantizedCPUTensorId));
 } // namespace
 } // namespace native
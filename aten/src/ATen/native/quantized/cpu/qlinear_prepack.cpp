@@ -4,6 +4,7 @@
 #include <ATen/native/quantized/cpu/fbgemm_utils.h>
 #include <ATen/native/quantized/cpu/init_qnnpack.h>
 #include <ATen/native/quantized/cpu/qnnpack_utils.h>
+#include <ATen/native/quantized/cuda/qgemm_utils.h>
 #include <ATen/quantized/Quantizer.h>
 #include <algorithm>
 #include <vector>
@@ -17,6 +18,8 @@ CAFFE_KNOWN_TYPE(PackedLinearWeight);
 // Required for cpp_custom_type_hack to work
 CAFFE_KNOWN_TYPE(PackedLinearWeightsQnnp);
 #endif // USE_PYTORCH_QNNPACK
+// Known to the CPU library too, as linear_unpack runs on the CPU
+CAFFE_KNOWN_TYPE(PackedLinearWeightCuda);
 } // namespace caffe2
 
 namespace at {
@@ -63,25 +66,10 @@ class QLinearPackWeightInt8 final : public c10::OperatorKernel {
     // TODO: contiguous is called for further JIT optimizations.
     auto weight_contig = weight.contiguous();
     const auto qtype = weight.qscheme();
-    std::vector<int32_t> weight_zero_points_int32(1, 0);
-    if (qtype == kPerTensorAffine) {
-      weight_zero_points_int32[0] = weight.q_zero_point();
-    } else if (qtype == kPerChannelAffine) {
-      weight_zero_points_int32.resize(N, 0);
-      for (int i = 0; i < N; ++i) {
-        weight_zero_points_int32[i] =
-            weight.q_per_channel_zero_points()[i].item<int32_t>();
-      }
-    }
-    std::vector<float> weight_scales_float(1, 0.0);
-    if (qtype == kPerTensorAffine) {
-      weight_scales_float[0] = weight.q_scale();
-    } else if (qtype == kPerChannelAffine) {
-      weight_scales_float.resize(N, 0.0);
-      for (int i = 0; i < N; ++i) {
-        weight_scales_float[i] = weight.q_per_channel_scales()[i].item<float>();
-      }
-    }
+    std::vector<float> weight_scales_float;
+    std::vector<int32_t> weight_zero_points_int32;
+    fbgemm_utils::GetWeightQuantizationParams(
+        weight, N, &weight_scales_float, &weight_zero_points_int32);
 
     int8_t* weight_ptr_int8 =
         reinterpret_cast<int8_t*>(weight_contig.data_ptr<c10::qint8>());
@@ -3,6 +3,7 @@
 #include <ATen/cpp_custom_type_hack.h>
 #include <ATen/native/quantized/cpu/fbgemm_utils.h>
 #include <ATen/native/quantized/cpu/qnnpack_utils.h>
+#include <ATen/native/quantized/cuda/qgemm_utils.h>
 
 namespace at {
 namespace native {
@@ -66,6 +67,14 @@ class QLinearUnpackWeightInt8 final : public c10::OperatorKernel {
 #endif // USE_PYTORCH_QNNPACK
   std::tuple<at::Tensor, c10::optional<Tensor>> operator()(
       at::Tensor packed_weight) {
+    // The weights packed for CUDA devices are wrapped in CPU tensors too
+    if (cpp_custom_type_hack::isa<PackedLinearWeightCuda>(packed_weight)) {
+      auto& pack_ptr =
+          cpp_custom_type_hack::cast<PackedLinearWeightCuda>(packed_weight);
+      return std::tuple<at::Tensor, c10::optional<Tensor>>(
+          pack_ptr.orig_weight, pack_ptr.bias);
+    }
+
     auto& ctx = at::globalContext();
 
 #ifdef USE_FBGEMM
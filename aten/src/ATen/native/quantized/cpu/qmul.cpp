@@ -1,4 +1,5 @@
 #include <ATen/ATen.h>
+#include <ATen/ExpandUtils.h>
 #include <ATen/core/op_registration/op_registration.h>
 #include <ATen/native/TensorIterator.h>
 #include <ATen/native/cpu/Loops.h>
@@ -9,6 +10,10 @@
 
 namespace at {
 namespace native {
+
+DEFINE_DISPATCH(qmul_relu_stub);
+DEFINE_DISPATCH(qmul_stub);
+
 namespace {
 
 inline void check_inputs(const Tensor& qa, const Tensor& qb) {
@@ -16,36 +21,20 @@ inline void check_inputs(const Tensor& qa, const Tensor& qb) {
               "Only per tensor quantization is supported in Mul.");
   TORCH_CHECK(qa.qscheme() == qb.qscheme(),
               "Both inputs to Mul must have the same quantization shceme.");
-  TORCH_CHECK(qa.numel() == qb.numel(),
-              "Mul operands must be the same size!");
   TORCH_CHECK(qa.scalar_type() == qb.scalar_type(),
               "Mul operands should have same data type.");
 }
 
-// Note: out is assumed to be the same size as self and other.
+// Note: out is assumed to have the broadcast size of self and other.
 // Note: Multiplication is only supported when self, other, out are of the same
 //       dtype.
 template <bool ReLUFused = false>
 Tensor _mul_out(Tensor& out, const Tensor& self, const Tensor& other) {
-  int64_t zero_point = out.q_zero_point();
-  double scale = out.q_scale();
-  int64_t self_zero_point = self.q_zero_point();
-  double self_scale = self.q_scale();
-  int64_t other_zero_point = other.q_zero_point();
-  double other_scale = other.q_scale();
-
-  auto iter = TensorIterator::binary_op(out, self, other);
-  AT_DISPATCH_QINT_TYPES(out.scalar_type(), "qmul", [&]() {
-    cpu_kernel(iter, [&](scalar_t a, scalar_t b) -> scalar_t {
-      const auto da = at::dequantize_val(self_scale, self_zero_point, a);
-      const auto db = at::dequantize_val(other_scale, other_zero_point, b);
-      float c = da * db;
-      if (ReLUFused) {
-        c = std::max<float>(c, 0.0);
-      }
-      return at::quantize_val<scalar_t>(scale, zero_point, c);
-    });
-  });
+  if (ReLUFused) {
+    qmul_relu_stub(self.device().type(), out, self, other);
+  } else {
+    qmul_stub(self.device().type(), out, self, other);
+  }
   return out;
 }
 
@@ -117,7 +106,7 @@ class QMul final : public c10::OperatorKernel {
   Tensor operator()(Tensor qa, Tensor qb,
                     double scale, int64_t zero_point) {
     check_inputs(qa, qb);
-    auto qc = at::_empty_affine_quantized(qa.sizes(),
+    auto qc = at::_empty_affine_quantized(infer_size(qa.sizes(), qb.sizes()),
       at::device(kCPU).dtype(qa.scalar_type()), scale, zero_point);
     return _mul_out<ReLUFused>(qc, qa, qb);
   }
@@ -128,6 +117,10 @@ class QMulOut final : public c10::OperatorKernel {
  public:
   Tensor operator()(at::Tensor qa, at::Tensor qb, Tensor out) {
     check_inputs(qa, qb);
+    check_inputs(qa, out);
+    TORCH_CHECK(out.sizes() == infer_size(qa.sizes(), qb.sizes()),
+                "Mul: expected out to have the broadcast size of the operands, but got ",
+                out.sizes());
     return _mul_out<ReLUFused>(out, qa, qb);
   }
 };
@@ -150,6 +143,7 @@ class QMulScalarOut final : public c10::OperatorKernel {
  public:
   Tensor operator()(Tensor qa, Scalar b, Tensor out) {
     check_inputs(qa, out);
+    TORCH_CHECK(qa.numel() == out.numel(), "Mul operands must be the same size!");
     return _mul_scalar_out<ReLUFused>(out, qa, b);
   }
 };
@@ -6,6 +6,10 @@ class PrePackConvWeights final {
  public:
   PrePackConvWeights(const conv_param_t& conv_param, const uint8_t* kernel, const int32_t* bias);
 
+  // Replaces the bias of the packed weights, e.g. once it is requantized for
+  // another input scale. conv_param must be the one they were packed with.
+  void updateBias(const conv_param_t& conv_param, const int32_t* bias);
+
   void* getPackedWeights() const
   {
     return packed_weights_;
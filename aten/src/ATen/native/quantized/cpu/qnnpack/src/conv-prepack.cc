@@ -1,6 +1,7 @@
 #include <conv_utils.h>
 #include <qnnpack/pack.h>
 #include <qnnpack_func.h>
+#include <algorithm>
 #include <cstring>
 
 namespace qnnpack {
@@ -186,5 +187,73 @@ PrePackConvWeights::PrePackConvWeights(
     default:
       PYTORCH_QNNP_UNREACHABLE;
   }
-} // namespace qnnpack
+}
+
+void PrePackConvWeights::updateBias(
+    const conv_param_t& conv_p,
+    const int32_t* bias) {
+  // Every layout above stores a block of output channels as the bias of its
+  // channels followed by their weights, so the bias is rewritten in place
+  // rather than packing the weights again.
+  const uint32_t kernel_width = conv_p.kernel_dims[0];
+  const uint32_t kernel_height = conv_p.kernel_dims[1];
+  const size_t kernel_size = kernel_height * kernel_width;
+  const uint32_t groups = conv_p.groups;
+
+  size_t block;
+  size_t block_stride;
+  size_t group_stride;
+  size_t group_channels;
+  size_t num_groups;
+  switch (conv_p.ukernel_type) {
+    case pytorch_qnnp_ukernel_type_dwconv: {
+      block = pytorch_qnnp_params.q8dw9.cr;
+      // The 5x5 kernels are packed in three passes, the first one with the
+      // bias and the first two columns of weights
+      const size_t block_weights = kernel_size == 25 ? 10 : kernel_size;
+      block_stride = (sizeof(uint8_t) * block_weights + sizeof(int32_t)) * block;
+      group_stride = 0;
+      group_channels = groups;
+      num_groups = 1;
+      break;
+    }
+    case pytorch_qnnp_ukernel_type_xzp_gemm:
+    case pytorch_qnnp_ukernel_type_gemm:
+    case pytorch_qnnp_ukernel_type_conv: {
+      const bool xzp =
+          conv_p.ukernel_type == pytorch_qnnp_ukernel_type_xzp_gemm;
+      const uint32_t nr =
+          xzp ? pytorch_qnnp_params.q8conv_xzp.nr : pytorch_qnnp_params.q8conv.nr;
+      const uint32_t kr =
+          xzp ? pytorch_qnnp_params.q8conv_xzp.kr : pytorch_qnnp_params.q8conv.kr;
+      const uint32_t n_stride = (conv_p.group_output_channels + (nr - 1)) & -nr;
+      const uint32_t k_stride = (conv_p.group_input_channels + (kr - 1)) & -kr;
+      block = nr;
+      block_stride =
+          (sizeof(uint8_t) * kernel_size * k_stride + sizeof(int32_t)) * nr;
+      group_stride =
+          (sizeof(uint8_t) * kernel_size * k_stride + sizeof(int32_t)) *
+          n_stride;
+      group_channels = conv_p.group_output_channels;
+      num_groups = groups;
+      break;
+    }
+    default:
+      PYTORCH_QNNP_UNREACHABLE;
+  }
+
+  for (size_t group = 0; group < num_groups; group++) {
+    const int32_t* group_bias = bias + group * group_channels;
+    uintptr_t packed = (uintptr_t)packed_weights_ + group * group_stride;
+    for (size_t block_start = 0; block_start < group_channels;
+         block_start += block) {
+      const size_t block_size = std::min(group_channels - block_start, block);
+      memcpy(
+          (void*)packed,
+          group_bias + block_start,
+          sizeof(int32_t) * block_size);
+      packed += block_stride;
+    }
+  }
+}
 } // namespace qnnpack
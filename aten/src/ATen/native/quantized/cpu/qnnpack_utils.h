@@ -28,6 +28,9 @@ struct PackedLinearWeightsQnnp {
   int64_t w_zp;
 };
 
+// The conv weights are packed at prepack time with a zero bias, and the run
+// writes the bias quantized with its input scale into the packed weights,
+// without packing them again.
 struct PackedConvWeightsQnnp {
   std::unique_ptr<qnnpack::PrePackConvWeights> w;
   at::Tensor orig_weight;
@@ -85,7 +85,8 @@ Tensor qnnpack_relu(Tensor input) {
 
 Tensor quantized_relu(const Tensor& qx) {
   #ifdef USE_PYTORCH_QNNPACK
-  if (at::globalContext().qEngine() == at::QEngine::QNNPACK && qx.scalar_type() == kQUInt8) {
+  if (at::globalContext().qEngine() == at::QEngine::QNNPACK &&
+      qx.device().is_cpu() && qx.scalar_type() == kQUInt8) {
     return qnnpack_relu(qx);
   }
   #endif
@@ -0,0 +1,21 @@
+#include <ATen/ATen.h>
+#include <ATen/NativeFunctions.h>
+#include <ATen/native/quantized/cpu/quantized_ops.h>
+
+namespace at {
+namespace native {
+
+DEFINE_DISPATCH(qsigmoid_stub);
+
+// The output is quantized over [0, 1] with the full range of the input dtype,
+// independently of the quantization parameters of the input.
+Tensor quantized_sigmoid(const Tensor& qx) {
+  TORCH_CHECK(
+      qx.qscheme() == kPerTensorAffine || qx.qscheme() == kPerTensorSymmetric,
+      "Only per tensor quantization is supported in sigmoid.");
+  Tensor qy;
+  qsigmoid_stub(qx.device().type(), qx, qy);
+  return qy;
+}
+
+}}  // namespace at::native
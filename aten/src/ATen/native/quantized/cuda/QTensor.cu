@@ -0,0 +1,50 @@
+#include <ATen/ATen.h>
+#include <ATen/NativeFunctions.h>
+#include <ATen/native/TensorIterator.h>
+#include <ATen/native/cuda/Loops.cuh>
+
+namespace at {
+namespace native {
+
+// The quantized tensors are read and written as the integers they hold, see
+// int_repr_quant in QTensor.cpp
+Tensor int_repr_quant_cuda(const Tensor& self) {
+  Tensor dst;
+  AT_DISPATCH_QINT_TYPES(self.scalar_type(), "int_repr_cuda", [&]() {
+    dst = at::empty(
+        self.sizes(),
+        self.options().dtype(UNDERLYING_TYPE),
+        self.suggest_memory_format());
+    auto iter = TensorIterator();
+    iter.add_output(dst);
+    iter.add_input(self);
+    iter.dont_compute_common_dtype();
+    iter.build();
+    gpu_kernel(iter, [] GPU_LAMBDA(underlying_t value) { return value; });
+  });
+  return dst;
+}
+
+Tensor make_per_tensor_quantized_tensor_cuda(
+    const Tensor& self,
+    double scale,
+    int64_t zero_point) {
+  Tensor dst = at::_empty_affine_quantized(
+      self.sizes(),
+      self.options().dtype(toQIntType(self.scalar_type())),
+      scale,
+      zero_point);
+  AT_DISPATCH_QINT_TYPES(
+      dst.scalar_type(), "make_per_tensor_quantized_tensor_cuda", [&]() {
+        auto iter = TensorIterator();
+        iter.add_output(dst);
+        iter.add_input(self);
+        iter.dont_compute_common_dtype();
+        iter.build();
+        gpu_kernel(iter, [] GPU_LAMBDA(underlying_t value) { return value; });
+      });
+  return dst;
+}
+
+} // namespace native
+} // namespace at
@@ -0,0 +1,144 @@
+#include <ATen/ATen.h>
+#include <ATen/Dispatch.h>
+#include <ATen/native/TensorIterator.h>
+#include <ATen/native/cuda/Loops.cuh>
+#include <ATen/native/quantized/affine_quantizer.h>
+
+#include <limits>
+
+/* The CUDA kernels of the affine quantizers. They follow FBGEMM's
+   quantization, as the CPU does with it: the values are computed in float and
+   rounded to nearest even. The quantized values are read and written as their
+   underlying integers, so the iterators don't compute a common dtype.
+*/
+namespace at {
+namespace native {
+namespace {
+
+// The per channel parameters, viewed so that they broadcast along axis of a
+// tensor of dim dimensions
+Tensor channel_view(const Tensor& params, int64_t dim, int64_t axis) {
+  std::vector<int64_t> sizes(dim, 1);
+  sizes[axis] = params.numel();
+  return params.view(sizes);
+}
+
+template <typename underlying_t>
+struct QuantizeVal {
+  C10_HOST_DEVICE underlying_t
+  operator()(float value, float scale, int32_t zero_point) const {
+    constexpr int64_t qmin = std::numeric_limits<underlying_t>::min();
+    constexpr int64_t qmax = std::numeric_limits<underlying_t>::max();
+    int64_t qvalue =
+        static_cast<int64_t>(nearbyintf(value / scale + zero_point));
+    qvalue = qvalue < qmin ? qmin : qvalue;
+    qvalue = qvalue > qmax ? qmax : qvalue;
+    return static_cast<underlying_t>(qvalue);
+  }
+};
+
+void quantize_tensor_per_tensor_affine_cuda(
+    const Tensor& rtensor,
+    Tensor& qtensor,
+    double scale,
+    int64_t zero_point) {
+  AT_DISPATCH_QINT_TYPES(
+      qtensor.scalar_type(), "quantize_tensor_per_tensor_affine_cuda", [&]() {
+        auto iter = TensorIterator();
+        iter.add_output(qtensor);
+        iter.add_input(rtensor);
+        iter.dont_compute_common_dtype();
+        iter.build();
+        const float fscale = scale;
+        const int32_t izero_point = zero_point;
+        gpu_kernel(iter, [=] GPU_LAMBDA(float value) -> underlying_t {
+          return QuantizeVal<underlying_t>()(value, fscale, izero_point);
+        });
+      });
+}
+
+void dequantize_tensor_per_tensor_affine_cuda(
+    const Tensor& qtensor,
+    Tensor& rtensor,
+    double scale,
+    int64_t zero_point) {
+  AT_DISPATCH_QINT_TYPES(
+      qtensor.scalar_type(), "dequantize_tensor_per_tensor_affine_cuda", [&]() {
+        auto iter = TensorIterator();
+        iter.add_output(rtensor);
+        iter.add_input(qtensor);
+        iter.dont_compute_common_dtype();
+        iter.build();
+        const float fscale = scale;
+        const int32_t izero_point = zero_point;
+        gpu_kernel(iter, [=] GPU_LAMBDA(underlying_t value) -> float {
+          return (static_cast<float>(value) - izero_point) * fscale;
+        });
+      });
+}
+
+void quantize_tensor_per_channel_affine_cuda(
+    const Tensor& rtensor,
+    Tensor& qtensor,
+    const Tensor& scales,
+    const Tensor& zero_points,
+    int64_t axis) {
+  AT_DISPATCH_QINT_TYPES(
+      qtensor.scalar_type(), "quantize_tensor_per_channel_affine_cuda", [&]() {
+        auto iter = TensorIterator();
+        iter.add_output(qtensor);
+        iter.add_input(rtensor);
+        iter.add_input(channel_view(scales, rtensor.dim(), axis));
+        iter.add_input(channel_view(zero_points, rtensor.dim(), axis));
+        iter.dont_compute_common_dtype();
+        iter.build();
+        gpu_kernel(
+            iter,
+            [] GPU_LAMBDA(float value, float scale, int32_t zero_point)
+                -> underlying_t {
+              return QuantizeVal<underlying_t>()(value, scale, zero_point);
+            });
+      });
+}
+
+void dequantize_tensor_per_channel_affine_cuda(
+    const Tensor& qtensor,
+    Tensor& rtensor,
+    const Tensor& scales,
+    const Tensor& zero_points,
+    int64_t axis) {
+  AT_DISPATCH_QINT_TYPES(
+      qtensor.scalar_type(), "dequantize_tensor_per_channel_affine_cuda", [&]() {
+        auto iter = TensorIterator();
+        iter.add_output(rtensor);
+        iter.add_input(qtensor);
+        iter.add_input(channel_view(scales, qtensor.dim(), axis));
+        iter.add_input(channel_view(zero_points, qtensor.dim(), axis));
+        iter.dont_compute_common_dtype();
+        iter.build();
+        gpu_kernel(
+            iter,
+            [] GPU_LAMBDA(underlying_t value, float scale, int32_t zero_point)
+                -> float {
+              return (static_cast<float>(value) - zero_point) * scale;
+            });
+      });
+}
+
+} // namespace
+
+REGISTER_DISPATCH(
+    quantize_tensor_per_tensor_affine_stub,
+    &quantize_tensor_per_tensor_affine_cuda);
+REGISTER_DISPATCH(
+    dequantize_tensor_per_tensor_affine_stub,
+    &dequantize_tensor_per_tensor_affine_cuda);
+REGISTER_DISPATCH(
+    quantize_tensor_per_channel_affine_stub,
+    &quantize_tensor_per_channel_affine_cuda);
+REGISTER_DISPATCH(
+    dequantize_tensor_per_channel_affine_stub,
+    &dequantize_tensor_per_channel_affine_cuda);
+
+} // namespace native
+} // namespace at
@@ -0,0 +1,122 @@
+#include <ATen/ATen.h>
+#include <ATen/core/op_registration/op_registration.h>
+#include <ATen/cpp_custom_type_hack.h>
+#include <ATen/native/quantized/cuda/qgemm_utils.h>
+
+namespace at {
+namespace native {
+namespace {
+
+void check_conv2d_params(
+    const std::string& fn_name,
+    const torch::List<int64_t>& stride,
+    const torch::List<int64_t>& padding,
+    const torch::List<int64_t>& dilation) {
+  TORCH_CHECK(
+      stride.size() == 2 && padding.size() == 2 && dilation.size() == 2,
+      fn_name,
+      " (cuda): Expected 2 values for each of stride, padding and dilation, "
+      "only 2D convolutions are supported on CUDA devices");
+}
+
+class QConvPackWeightInt8Cuda final : public c10::OperatorKernel {
+ public:
+  Tensor operator()(
+      Tensor weight,
+      c10::optional<Tensor> bias,
+      torch::List<int64_t> stride,
+      torch::List<int64_t> padding,
+      torch::List<int64_t> dilation,
+      int64_t groups) {
+    check_conv2d_params("quantized::conv2d_prepack", stride, padding, dilation);
+    TORCH_CHECK(
+        weight.dim() == 4,
+        "quantized::conv2d_prepack (cuda): Weights are expected to have 4 "
+        "dimensions");
+    const int64_t output_channels = weight.size(0);
+    TORCH_CHECK(
+        groups > 0 && output_channels % groups == 0,
+        "quantized::conv2d_prepack (cuda): Expected the output channels ",
+        output_channels,
+        " to be divisible by groups ",
+        groups);
+
+    auto wt_ptr = guts::make_unique<PackedConvWeightCuda>();
+    wt_ptr->orig_weight = weight;
+    if (bias.has_value()) {
+      TORCH_CHECK(
+          bias->dim() == 1 && bias->size(0) == output_channels,
+          "quantized::conv2d_prepack (cuda): Expected bias to be "
+          "1-dimensional with ",
+          output_channels,
+          " elements, but got bias of size ",
+          bias->sizes());
+      wt_ptr->bias = bias->to(weight.device(), kFloat).contiguous();
+    }
+    wt_ptr->kernel = {weight.size(2), weight.size(3)};
+    wt_ptr->groups = groups;
+    qgemm_pack_weight_cuda(
+        weight,
+        groups,
+        wt_ptr->w,
+        wt_ptr->w_row_sums,
+        wt_ptr->w_scales,
+        wt_ptr->w_zero_points);
+    return cpp_custom_type_hack::create(std::move(wt_ptr), weight.options());
+  }
+};
+
+template <bool kReluFused>
+class QConvInt8Cuda final : public c10::OperatorKernel {
+ public:
+  Tensor operator()(
+      Tensor act,
+      Tensor packed_weight,
+      torch::List<int64_t> stride,
+      torch::List<int64_t> padding,
+      torch::List<int64_t> dilation,
+      int64_t groups,
+      double output_scale,
+      int64_t output_zero_point) {
+    check_conv2d_params("quantized::conv2d", stride, padding, dilation);
+    auto& pack_ptr =
+        cpp_custom_type_hack::cast<PackedConvWeightCuda>(packed_weight);
+    TORCH_CHECK(
+        groups == pack_ptr.groups,
+        "quantized::conv2d (cuda): Expected groups ",
+        pack_ptr.groups,
+        " of the packed weights, but got ",
+        groups);
+    const std::vector<int64_t> stride_vec(stride.begin(), stride.end());
+    const std::vector<int64_t> padding_vec(padding.begin(), padding.end());
+    const std::vector<int64_t> dilation_vec(dilation.begin(), dilation.end());
+    return qconv2d_cuda(
+        act,
+        pack_ptr,
+        stride_vec,
+        padding_vec,
+        dilation_vec,
+        output_scale,
+        output_zero_point,
+        kReluFused);
+  }
+};
+
+static auto registry =
+    c10::RegisterOperators()
+        .op("quantized::conv_prepack",
+            c10::RegisterOperators::options().kernel<QConvPackWeightInt8Cuda>(
+                TensorTypeId::QuantizedCUDATensorId))
+        .op("quantized::conv2d_prepack",
+            c10::RegisterOperators::options().kernel<QConvPackWeightInt8Cuda>(
+                TensorTypeId::QuantizedCUDATensorId))
+        .op("quantized::conv2d",
+            c10::RegisterOperators::options().kernel<QConvInt8Cuda<false>>(
+                TensorTypeId::QuantizedCUDATensorId))
+        .op("quantized::conv2d_relu",
+            c10::RegisterOperators::options().kernel<QConvInt8Cuda<true>>(
+                TensorTypeId::QuantizedCUDATensorId));
+
+} // namespace
+} // namespace native
+} // namespace at
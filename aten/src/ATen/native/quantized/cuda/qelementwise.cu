@@ -0,0 +1,82 @@
+#include <ATen/ATen.h>
+#include <ATen/Dispatch.h>
+#include <ATen/native/TensorIterator.h>
+#include <ATen/native/cuda/Loops.cuh>
+#include <ATen/native/quantized/cpu/quantized_ops.h>
+
+#include <limits>
+
+/* The CUDA kernels of the quantized elementwise ops, dispatched to from
+   cpu/qrelu.cpp and cpu/qadd.cpp. The quantized values are read and written as
+   their underlying integers, see affine_quantizer.cu for the quantization.
+*/
+namespace at {
+namespace native {
+namespace {
+
+void qrelu_kernel_cuda(const Tensor& qx, Tensor& qy) {
+  const int64_t zero_point = qx.q_zero_point();
+  AT_DISPATCH_QINT_TYPES(qx.scalar_type(), "qrelu_cuda", [&]() {
+    qy = at::_empty_affine_quantized(
+        qx.sizes(),
+        qx.options(),
+        qx.q_scale(),
+        qx.q_zero_point(),
+        qx.suggest_memory_format());
+    auto iter = TensorIterator();
+    iter.add_output(qy);
+    iter.add_input(qx);
+    iter.dont_compute_common_dtype();
+    iter.build();
+    const underlying_t qzero = zero_point;
+    gpu_kernel(iter, [=] GPU_LAMBDA(underlying_t value) -> underlying_t {
+      return value < qzero ? qzero : value;
+    });
+  });
+}
+
+// Note: out is assumed to have the broadcast size of self and other, and all
+// of them the same dtype, as on the CPU.
+template <bool ReLUFused = false>
+void qadd_kernel_cuda(Tensor& out, const Tensor& self, const Tensor& other) {
+  const int32_t zero_point = out.q_zero_point();
+  const float inv_scale = 1.0f / static_cast<float>(out.q_scale());
+  const int32_t self_zero_point = self.q_zero_point();
+  const float self_scale = self.q_scale();
+  const int32_t other_zero_point = other.q_zero_point();
+  const float other_scale = other.q_scale();
+
+  AT_DISPATCH_QINT_TYPES(out.scalar_type(), "qadd_cuda", [&]() {
+    auto iter = TensorIterator();
+    iter.add_output(out);
+    iter.add_input(self);
+    iter.add_input(other);
+    iter.dont_compute_common_dtype();
+    iter.build();
+    gpu_kernel(
+        iter,
+        [=] GPU_LAMBDA(underlying_t a, underlying_t b) -> underlying_t {
+          constexpr int64_t qmin = std::numeric_limits<underlying_t>::min();
+          constexpr int64_t qmax = std::numeric_limits<underlying_t>::max();
+          float c = (static_cast<float>(a) - self_zero_point) * self_scale +
+              (static_cast<float>(b) - other_zero_point) * other_scale;
+          if (ReLUFused) {
+            c = c < 0.0f ? 0.0f : c;
+          }
+          int64_t qvalue =
+              static_cast<int64_t>(nearbyintf(c * inv_scale + zero_point));
+          qvalue = qvalue < qmin ? qmin : qvalue;
+          qvalue = qvalue > qmax ? qmax : qvalue;
+          return static_cast<underlying_t>(qvalue);
+        });
+  });
+}
+
+} // namespace
+
+REGISTER_DISPATCH(qrelu_stub, &qrelu_kernel_cuda);
+REGISTER_DISPATCH(qadd_relu_stub, &qadd_kernel_cuda<true>);
+REGISTER_DISPATCH(qadd_stub, &qadd_kernel_cuda<false>);
+
+} // namespace native
+} // namespace at
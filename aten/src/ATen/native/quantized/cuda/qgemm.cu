@@ -0,0 +1,475 @@
+#include <ATen/ATen.h>
+#include <ATen/DeviceGuard.h>
+#include <ATen/cuda/CUDABlas.h>
+#include <ATen/cuda/CUDAContext.h>
+#include <ATen/cuda/Exceptions.h>
+#include <ATen/cuda/detail/KernelUtils.h>
+#include <ATen/native/quantized/cuda/qgemm_utils.h>
+
+#include <limits>
+
+namespace at {
+namespace native {
+
+using at::cuda::detail::CUDA_NUM_THREADS;
+using at::cuda::detail::GET_BLOCKS;
+
+namespace {
+
+// The quint8 value shifted by -128 into an int8
+__device__ __forceinline__ int8_t shift_to_int8(uint8_t value) {
+  return static_cast<int8_t>(value ^ 0x80);
+}
+
+// Writes the shifted rows of x [n / ld, cols] into y [n / ld, ld], padded
+// with zeros
+__global__ void shift_rows_kernel(
+    const int64_t n,
+    const uint8_t* x,
+    int8_t* y,
+    const int64_t cols,
+    const int64_t ld) {
+  CUDA_KERNEL_LOOP(index, n) {
+    const int64_t col = index % ld;
+    const int64_t row = index / ld;
+    y[index] = col < cols ? shift_to_int8(x[row * cols + col]) : 0;
+  }
+}
+
+// Writes the shifted patches of the channels [c_begin, c_begin + channels) of
+// the NCHW images x into y [batch * OH * OW, ld], a row per output pixel in
+// the (channel, kernel row, kernel column) order of the weights. The padding
+// of the images holds the input zero point, which adds nothing once the zero
+// points are corrected for.
+__global__ void im2row_kernel(
+    const int64_t n,
+    const uint8_t* x,
+    int8_t* y,
+    const int64_t C,
+    const int64_t H,
+    const int64_t W,
+    const int64_t c_begin,
+    const int64_t channels,
+    const int64_t kH,
+    const int64_t kW,
+    const int64_t sH,
+    const int64_t sW,
+    const int64_t pH,
+    const int64_t pW,
+    const int64_t dH,
+    const int64_t dW,
+    const int64_t OH,
+    const int64_t OW,
+    const int64_t ld,
+    const int8_t padding_value) {
+  CUDA_KERNEL_LOOP(index, n) {
+    const int64_t k = index % ld;
+    const int64_t row = index / ld;
+    if (k >= channels * kH * kW) {
+      y[index] = 0;
+      continue;
+    }
+    const int64_t b = row / (OH * OW);
+    const int64_t oh = (row / OW) % OH;
+    const int64_t ow = row % OW;
+    const int64_t c = k / (kH * kW);
+    const int64_t h = oh * sH - pH + (k / kW) % kH * dH;
+    const int64_t w = ow * sW - pW + k % kW * dW;
+    y[index] = (h >= 0 && h < H && w >= 0 && w < W)
+        ? shift_to_int8(x[((b * C + c_begin + c) * H + h) * W + w])
+        : padding_value;
+  }
+}
+
+// Requantizes the accumulators acc [n / N, ld] of the output channels [0, N)
+// into y, row r and channel c at
+// (r / rows_per_image) * image_stride + c * rows_per_image + r % rows_per_image
+// x_row_sums are those of the shifted activations and w_row_sums those of the
+// weights, over K values.
+__global__ void requantize_kernel(
+    const int64_t n,
+    const int32_t* acc,
+    const int64_t ld,
+    const int64_t N,
+    const int64_t K,
+    const int32_t* x_row_sums,
+    const int32_t* w_row_sums,
+    const float* w_scales,
+    const int32_t* w_zero_points,
+    const float* bias,
+    const float x_scale,
+    const int32_t x_zero_point,
+    const float inv_y_scale,
+    const int32_t y_zero_point,
+    const int32_t y_min,
+    uint8_t* y,
+    const int64_t rows_per_image,
+    const int64_t image_stride) {
+  CUDA_KERNEL_LOOP(index, n) {
+    const int64_t c = index % N;
+    const int64_t row = index / N;
+    const int64_t x_row_sum = x_row_sums[row] + 128 * K;
+    const int64_t w_zero_point = w_zero_points[c];
+    // sum((x - x_zp)(w - w_zp)) with sum((x - 128) w) in acc
+    const int64_t acc_value = acc[row * ld + c] +
+        (128 - x_zero_point) * static_cast<int64_t>(w_row_sums[c]) -
+        w_zero_point * x_row_sum + K * x_zero_point * w_zero_point;
+    float value = x_scale * w_scales[c] * acc_value;
+    if (bias != nullptr) {
+      value += bias[c];
+    }
+    int64_t qvalue =
+        static_cast<int64_t>(nearbyintf(value * inv_y_scale)) + y_zero_point;
+    qvalue = qvalue < y_min ? y_min : qvalue;
+    qvalue = qvalue > 255 ? 255 : qvalue;
+    y[(row / rows_per_image) * image_stride + c * rows_per_image +
+      row % rows_per_image] = static_cast<uint8_t>(qvalue);
+  }
+}
+
+int blocks_for(int64_t n) {
+  TORCH_CHECK(
+      n <= std::numeric_limits<int32_t>::max(),
+      "qgemm_cuda: too many elements in a kernel launch: ",
+      n);
+  return GET_BLOCKS(static_cast<int>(n));
+}
+
+// acc [rows, N_padded] = x [rows, K_padded] w^T, w [N_padded, K_padded], all
+// row major, as cuBLAS' column major acc^T = w x^T
+void int8_gemm(const Tensor& x, const Tensor& w, Tensor& acc) {
+  const int64_t rows = x.size(0);
+  const int64_t N = w.size(0);
+  const int64_t K = w.size(1);
+  at::cuda::blas::gemm_s8s32(
+      at::cuda::getCurrentCUDAStream(),
+      't',
+      'n',
+      N,
+      rows,
+      K,
+      1,
+      w.data_ptr<int8_t>(),
+      K,
+      x.data_ptr<int8_t>(),
+      K,
+      0,
+      acc.data_ptr<int32_t>(),
+      N);
+}
+
+// Requantizes the accumulators of the packed weights' output channels
+// [c_begin, c_begin + N) into y, see requantize_kernel
+template <typename PackedWeight>
+void requantize(
+    const Tensor& acc,
+    const Tensor& x,
+    int64_t K,
+    const PackedWeight& packed,
+    int64_t c_begin,
+    int64_t N,
+    double x_scale,
+    int64_t x_zero_point,
+    double y_scale,
+    int64_t y_zero_point,
+    bool relu_fused,
+    uint8_t* y,
+    int64_t rows_per_image,
+    int64_t image_stride) {
+  const Tensor x_row_sums = x.sum(1, /*keepdim=*/false, kInt);
+  const float* bias = packed.bias.has_value()
+      ? packed.bias->template data_ptr<float>() + c_begin
+      : nullptr;
+  const int64_t n = acc.size(0) * N;
+  requantize_kernel<<<
+      blocks_for(n),
+      CUDA_NUM_THREADS,
+      0,
+      at::cuda::getCurrentCUDAStream()>>>(
+      n,
+      acc.data_ptr<int32_t>(),
+      acc.size(1),
+      N,
+      K,
+      x_row_sums.data_ptr<int32_t>(),
+      packed.w_row_sums.template data_ptr<int32_t>() + c_begin,
+      packed.w_scales.template data_ptr<float>() + c_begin,
+      packed.w_zero_points.template data_ptr<int32_t>() + c_begin,
+      bias,
+      x_scale,
+      x_zero_point,
+      1.0f / static_cast<float>(y_scale),
+      y_zero_point,
+      relu_fused ? y_zero_point : 0,
+      y,
+      rows_per_image,
+      image_stride);
+  AT_CUDA_CHECK(cudaGetLastError());
+}
+
+template <typename PackedWeight>
+void check_inputs(
+    const std::string& fn_name,
+    const Tensor& input,
+    const PackedWeight& packed) {
+  TORCH_CHECK(
+      input.scalar_type() == kQUInt8,
+      fn_name,
+      " (cuda): Expected input data type ",
+      toString(kQUInt8),
+      " but got ",
+      toString(input.scalar_type()));
+  TORCH_CHECK(
+      input.qscheme() == kPerTensorAffine,
+      fn_name,
+      " (cuda): Only per tensor quantization is supported for the input");
+  TORCH_CHECK(
+      input.device() == packed.w.device(),
+      fn_name,
+      " (cuda): Expected the input and the weight on the same device, but got ",
+      input.device(),
+      " and ",
+      packed.w.device());
+}
+
+} // namespace
+
+void qgemm_pack_weight_cuda(
+    const Tensor& weight,
+    int64_t groups,
+    Tensor& w,
+    Tensor& w_row_sums,
+    Tensor& w_scales,
+    Tensor& w_zero_points) {
+  const cudaDeviceProp* prop =
+      at::cuda::getDeviceProperties(weight.device().index());
+  TORCH_CHECK(
+      prop->major > 6 || (prop->major == 6 && prop->minor >= 1),
+      "The quantized int8 GEMM needs a CUDA device of compute capability 6.1 ",
+      "or higher, but got ",
+      prop->major,
+      ".",
+      prop->minor);
+  TORCH_CHECK(
+      weight.scalar_type() == kQInt8,
+      "Expected weight data type ",
+      toString(kQInt8),
+      " but got ",
+      toString(weight.scalar_type()));
+  const int64_t N = weight.size(0);
+  const int64_t N_per_group = N / groups;
+  const int64_t K = weight.numel() / N;
+  const Tensor weight_int8 =
+      weight.int_repr().reshape({groups, N_per_group, K});
+  w = at::constant_pad_nd(
+          weight_int8,
+          {0,
+           qgemm_padded_size(K) - K,
+           0,
+           qgemm_padded_size(N_per_group) - N_per_group})
+          .contiguous();
+  w_row_sums = weight_int8.sum(2, /*keepdim=*/false, kInt).reshape({N});
+  if (weight.qscheme() == kPerTensorAffine) {
+    w_scales = at::full({N}, weight.q_scale(), w_row_sums.options().dtype(kFloat));
+    w_zero_points = at::full({N}, weight.q_zero_point(), w_row_sums.options());
+  } else {
+    TORCH_CHECK(
+        weight.qscheme() == kPerChannelAffine &&
+            weight.q_per_channel_axis() == 0,
+        "Only per tensor and per output channel quantized weights are supported");
+    w_scales = weight.q_per_channel_scales().to(weight.device(), kFloat);
+    w_zero_points =
+        weight.q_per_channel_zero_points().to(weight.device(), kInt);
+  }
+}
+
+Tensor qlinear_cuda(
+    const Tensor& input,
+    const PackedLinearWeightCuda& packed,
+    double output_scale,
+    int64_t output_zero_point,
+    bool relu_fused) {
+  check_inputs("quantized::linear", input, packed);
+  TORCH_CHECK(
+      input.dim() >= 2,
+      "quantized::linear (cuda): Input tensor rank should be >= 2");
+  const OptionalDeviceGuard device_guard(device_of(input));
+
+  const int64_t K = input.size(-1);
+  const int64_t N = packed.w_row_sums.numel();
+  TORCH_CHECK(
+      K == packed.orig_weight.size(1),
+      "quantized::linear (cuda): input size does not match weight dimension 1 "
+      "size: got ",
+      K,
+      " but expected ",
+      packed.orig_weight.size(1));
+  const int64_t M = input.numel() / K;
+
+  std::vector<int64_t> output_sizes = input.sizes().vec();
+  output_sizes.back() = N;
+  Tensor output = at::_empty_affine_quantized(
+      output_sizes, input.options(), output_scale, output_zero_point);
+  if (M == 0 || N == 0) {
+    return output;
+  }
+
+  const Tensor input_contig = input.contiguous();
+  const int64_t K_padded = packed.w.size(2);
+  Tensor x = at::empty({M, K_padded}, input.options().dtype(kChar));
+  const int64_t n = x.numel();
+  shift_rows_kernel<<<
+      blocks_for(n),
+      CUDA_NUM_THREADS,
+      0,
+      at::cuda::getCurrentCUDAStream()>>>(
+      n,
+      reinterpret_cast<uint8_t*>(input_contig.data_ptr<c10::quint8>()),
+      x.data_ptr<int8_t>(),
+      K,
+      K_padded);
+  AT_CUDA_CHECK(cudaGetLastError());
+
+  Tensor acc = at::empty({M, packed.w.size(1)}, x.options().dtype(kInt));
+  int8_gemm(x, packed.w[0], acc);
+  requantize(
+      acc,
+      x,
+      K,
+      packed,
+      0,
+      N,
+      input.q_scale(),
+      input.q_zero_point(),
+      output_scale,
+      output_zero_point,
+      relu_fused,
+      reinterpret_cast<uint8_t*>(output.data_ptr<c10::quint8>()),
+      /*rows_per_image=*/1,
+      /*image_stride=*/N);
+  return output;
+}
+
+Tensor qconv2d_cuda(
+    const Tensor& input,
+    const PackedConvWeightCuda& packed,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    IntArrayRef dilation,
+    double output_scale,
+    int64_t output_zero_point,
+    bool relu_fused) {
+  check_inputs("quantized::conv2d", input, packed);
+  TORCH_CHECK(
+      input.dim() == 4,
+      "quantized::conv2d (cuda): Expected activation tensor to have 4 "
+      "dimensions");
+  TORCH_CHECK(
+      stride.size() == 2 && padding.size() == 2 && dilation.size() == 2,
+      "quantized::conv2d (cuda): Expected 2 values for each of stride, "
+      "padding and dilation");
+  const OptionalDeviceGuard device_guard(device_of(input));
+
+  const int64_t B = input.size(0);
+  const int64_t C = input.size(1);
+  const int64_t H = input.size(2);
+  const int64_t W = input.size(3);
+  const int64_t groups = packed.groups;
+  const int64_t kH = packed.kernel[0];
+  const int64_t kW = packed.kernel[1];
+  const int64_t M = packed.w_row_sums.numel();
+  const int64_t C_per_group = packed.orig_weight.size(1);
+  TORCH_CHECK(
+      C == C_per_group * groups,
+      "quantized::conv2d (cuda): Given groups=",
+      groups,
+      ", weight of size ",
+      packed.orig_weight.sizes(),
+      ", expected input ",
+      input.sizes(),
+      " to have ",
+      C_per_group * groups,
+      " channels");
+  const int64_t OH =
+      (H + 2 * padding[0] - dilation[0] * (kH - 1) - 1) / stride[0] + 1;
+  const int64_t OW =
+      (W + 2 * padding[1] - dilation[1] * (kW - 1) - 1) / stride[1] + 1;
+  TORCH_CHECK(
+      OH > 0 && OW > 0,
+      "quantized::conv2d (cuda): Computed output size (",
+      OH,
+      "x",
+      OW,
+      ") is too small");
+
+  Tensor output = at::_empty_affine_quantized(
+      {B, M, OH, OW}, input.options(), output_scale, output_zero_point);
+  if (B == 0 || M == 0) {
+    return output;
+  }
+
+  const Tensor input_contig = input.contiguous();
+  const int64_t M_per_group = M / groups;
+  const int64_t K_per_group = C_per_group * kH * kW;
+  const int64_t K_padded = packed.w.size(2);
+  const int64_t rows_per_image = OH * OW;
+  const int64_t x_zero_point = input.q_zero_point();
+  Tensor x =
+      at::empty({B * rows_per_image, K_padded}, input.options().dtype(kChar));
+  Tensor acc = at::empty({x.size(0), packed.w.size(1)}, x.options().dtype(kInt));
+  const uint8_t* input_data =
+      reinterpret_cast<uint8_t*>(input_contig.data_ptr<c10::quint8>());
+  uint8_t* output_data =
+      reinterpret_cast<uint8_t*>(output.data_ptr<c10::quint8>());
+  const int64_t n = x.numel();
+
+  for (int64_t g = 0; g < groups; ++g) {
+    im2row_kernel<<<
+        blocks_for(n),
+        CUDA_NUM_THREADS,
+        0,
+        at::cuda::getCurrentCUDAStream()>>>(
+        n,
+        input_data,
+        x.data_ptr<int8_t>(),
+        C,
+        H,
+        W,
+        g * C_per_group,
+        C_per_group,
+        kH,
+        kW,
+        stride[0],
+        stride[1],
+        padding[0],
+        padding[1],
+        dilation[0],
+        dilation[1],
+        OH,
+        OW,
+        K_padded,
+        static_cast<int8_t>(x_zero_point - 128));
+    AT_CUDA_CHECK(cudaGetLastError());
+
+    int8_gemm(x, packed.w[g], acc);
+    requantize(
+        acc,
+        x,
+        K_per_group,
+        packed,
+        g * M_per_group,
+        M_per_group,
+        input.q_scale(),
+        x_zero_point,
+        output_scale,
+        output_zero_point,
+        relu_fused,
+        output_data + g * M_per_group * rows_per_image,
+        rows_per_image,
+        /*image_stride=*/M * rows_per_image);
+  }
+  return output;
+}
+
+} // namespace native
+} // namespace at
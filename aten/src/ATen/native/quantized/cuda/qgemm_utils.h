@@ -0,0 +1,86 @@
+#pragma once
+
+#include <ATen/ATen.h>
+
+/* The int8 GEMM of quantized::linear and quantized::conv2d on CUDA devices.
+
+   The quint8 activations are shifted by 128 into int8 and multiplied with the
+   qint8 weights by cuBLAS, accumulating in int32. The zero points are
+   corrected for with the row sums of both operands afterwards, as FBGEMM does
+   with its column offsets, and the accumulators are requantized with the
+   output scale and zero point, adding the float bias on the way.
+
+   The packed weights are int8 [N, K] matrices, N the output channels and K
+   the input channels, times the kernel size for convolutions, with both
+   padded with zeros to multiples of 4 for cuBLAS. They keep the scales
+   (float) and zero points (int) of each output channel, repeated from the
+   tensor ones for per tensor weights, so that both schemes run the same
+   kernels. Everything but orig_weight's quantizer is on the weights' device.
+
+   The packed weights are wrapped in CPU tensors by cpp_custom_type_hack, like
+   the CPU ones, so their types are registered with the CPU prepack ops.
+ */
+struct PackedLinearWeightCuda {
+  at::Tensor orig_weight;
+  c10::optional<at::Tensor> bias;
+  // int8 [1, N_padded, K_padded]
+  at::Tensor w;
+  // int32 [N], sum of each row of the int8 weights
+  at::Tensor w_row_sums;
+  at::Tensor w_scales;
+  at::Tensor w_zero_points;
+};
+
+struct PackedConvWeightCuda {
+  at::Tensor orig_weight;
+  c10::optional<at::Tensor> bias;
+  // int8 [groups, M_per_group_padded, K_per_group_padded], K_per_group the
+  // input channels per group times kH times kW
+  at::Tensor w;
+  at::Tensor w_row_sums;
+  at::Tensor w_scales;
+  at::Tensor w_zero_points;
+  std::vector<int64_t> kernel;
+  int64_t groups;
+};
+
+namespace at {
+namespace native {
+
+inline int64_t qgemm_padded_size(int64_t size) {
+  return (size + 3) / 4 * 4;
+}
+
+// Packs the qint8 weight [N, K] into the int8 matrices [groups,
+// N_per_group_padded, K_padded] of the GEMMs, with the row sums, scales and
+// zero points of the output channels.
+void qgemm_pack_weight_cuda(
+    const Tensor& weight,
+    int64_t groups,
+    Tensor& w,
+    Tensor& w_row_sums,
+    Tensor& w_scales,
+    Tensor& w_zero_points);
+
+// The quint8 output [M, N] of the quint8 input [M, K] and the packed weights.
+Tensor qlinear_cuda(
+    const Tensor& input,
+    const PackedLinearWeightCuda& packed,
+    double output_scale,
+    int64_t output_zero_point,
+    bool relu_fused);
+
+// The NCHW quint8 output of the 2d convolution of the quint8 input, through an
+// im2row of each group.
+Tensor qconv2d_cuda(
+    const Tensor& input,
+    const PackedConvWeightCuda& packed,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    IntArrayRef dilation,
+    double output_scale,
+    int64_t output_zero_point,
+    bool relu_fused);
+
+} // namespace native
+} // namespace at
@@ -0,0 +1,69 @@
+#include <ATen/ATen.h>
+#include <ATen/core/op_registration/op_registration.h>
+#include <ATen/cpp_custom_type_hack.h>
+#include <ATen/native/quantized/cuda/qgemm_utils.h>
+
+namespace at {
+namespace native {
+namespace {
+
+class QLinearPackWeightInt8Cuda final : public c10::OperatorKernel {
+ public:
+  Tensor operator()(at::Tensor weight, c10::optional<Tensor> bias) {
+    TORCH_CHECK(
+        weight.dim() == 2,
+        "quantized::linear_prepack (cuda): Weight tensor rank should be == 2");
+    auto wt_ptr = guts::make_unique<PackedLinearWeightCuda>();
+    wt_ptr->orig_weight = weight;
+    if (bias.has_value()) {
+      TORCH_CHECK(
+          bias->dim() == 1 && bias->size(0) == weight.size(0),
+          "quantized::linear_prepack (cuda): Expected bias to be 1-dimensional "
+          "with ",
+          weight.size(0),
+          " elements, but got bias of size ",
+          bias->sizes());
+      wt_ptr->bias = bias->to(weight.device(), kFloat).contiguous();
+    }
+    qgemm_pack_weight_cuda(
+        weight,
+        /*groups=*/1,
+        wt_ptr->w,
+        wt_ptr->w_row_sums,
+        wt_ptr->w_scales,
+        wt_ptr->w_zero_points);
+    return cpp_custom_type_hack::create(std::move(wt_ptr), weight.options());
+  }
+};
+
+template <bool ReluFused>
+class QLinearInt8Cuda final : public c10::OperatorKernel {
+ public:
+  at::Tensor operator()(
+      at::Tensor input,
+      at::Tensor packed_weight,
+      double output_scale,
+      int64_t output_zero_point) {
+    auto& pack_ptr =
+        cpp_custom_type_hack::cast<PackedLinearWeightCuda>(packed_weight);
+    return qlinear_cuda(
+        input, pack_ptr, output_scale, output_zero_point, ReluFused);
+  }
+};
+
+static auto registry =
+    c10::RegisterOperators()
+        .op("quantized::linear_prepack(Tensor W, Tensor? B=None) -> Tensor W_prepack",
+            c10::RegisterOperators::options()
+                .kernel<QLinearPackWeightInt8Cuda>(
+                    TensorTypeId::QuantizedCUDATensorId))
+        .op("quantized::linear(Tensor X, Tensor W_prepack, float Y_scale_i, int Y_zero_point_i) -> Tensor Y",
+            c10::RegisterOperators::options().kernel<QLinearInt8Cuda<false>>(
+                TensorTypeId::QuantizedCUDATensorId))
+        .op("quantized::linear_relu(Tensor X, Tensor W_prepack, float Y_scale_i, int Y_zero_point_i) -> Tensor Y",
+            c10::RegisterOperators::options().kernel<QLinearInt8Cuda<true>>(
+                TensorTypeId::QuantizedCUDATensorId));
+
+} // namespace
+} // namespace native
+} // namespace at
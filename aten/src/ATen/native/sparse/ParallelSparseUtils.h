@@ -0,0 +1,135 @@
+#pragma once
+
+// Building blocks of the parallel CPU kernels of sparse tensors, working on
+// their indices linearized into 64-bit keys (see flatten_indices).
+
+#include <ATen/Parallel.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+namespace at { namespace native { namespace sparse_parallel {
+
+// The number of chunks of about GRAIN_SIZE elements `n` elements are split
+// into, at most one per thread.
+inline int64_t num_chunks(int64_t n) {
+  int64_t chunks = (n + at::internal::GRAIN_SIZE - 1) / at::internal::GRAIN_SIZE;
+  return std::max<int64_t>(1, std::min<int64_t>(chunks, at::get_num_threads()));
+}
+
+// The `chunk`th of `chunks` contiguous ranges splitting [0, n).
+inline std::pair<int64_t, int64_t> chunk_range(int64_t n, int64_t chunks, int64_t chunk) {
+  return {n * chunk / chunks, n * (chunk + 1) / chunks};
+}
+
+// Runs `f(chunk)` for every chunk in [0, chunks), in parallel.
+template <typename F>
+inline void for_each_chunk(int64_t chunks, const F& f) {
+  at::parallel_for(0, chunks, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t chunk = begin; chunk < end; chunk++) {
+      f(chunk);
+    }
+  });
+}
+
+// Sorts the `n` non-negative `keys` into `sorted_keys`, and writes into
+// `permutation` the position in `keys` of every sorted key. This is a stable
+// LSD radix sort on 8-bit digits, with only as many passes as the digits of
+// the largest key. In every pass, each chunk histograms its digits, and then
+// scatters its elements after the ones of the same digit in the previous
+// chunks, so that the result doesn't depend on the number of threads.
+inline void radix_sort(const int64_t* keys, int64_t n, int64_t* sorted_keys, int64_t* permutation) {
+  constexpr int kBits = 8;
+  constexpr int kBuckets = 1 << kBits;
+  const int64_t chunks = num_chunks(n);
+
+  std::vector<int64_t> chunk_max(chunks, 0);
+  for_each_chunk(chunks, [&](int64_t chunk) {
+    auto range = chunk_range(n, chunks, chunk);
+    int64_t max_key = 0;
+    for (int64_t i = range.first; i < range.second; i++) {
+      max_key = std::max(max_key, keys[i]);
+    }
+    chunk_max[chunk] = max_key;
+  });
+  uint64_t max_key = *std::max_element(chunk_max.begin(), chunk_max.end());
+
+  std::vector<int64_t> keys_buffer(keys, keys + n);
+  std::vector<int64_t> permutation_buffer(n);
+  std::iota(permutation_buffer.begin(), permutation_buffer.end(), 0);
+  std::vector<int64_t> next_keys(n);
+  std::vector<int64_t> next_permutation(n);
+  std::vector<std::array<int64_t, kBuckets>> offsets(chunks);
+
+  for (int shift = 0; shift < 64 && (max_key >> shift) != 0; shift += kBits) {
+    for_each_chunk(chunks, [&](int64_t chunk) {
+      auto range = chunk_range(n, chunks, chunk);
+      auto& histogram = offsets[chunk];
+      histogram.fill(0);
+      for (int64_t i = range.first; i < range.second; i++) {
+        histogram[(keys_buffer[i] >> shift) & (kBuckets - 1)]++;
+      }
+    });
+    int64_t offset = 0;
+    for (int digit = 0; digit < kBuckets; digit++) {
+      for (int64_t chunk = 0; chunk < chunks; chunk++) {
+        int64_t count = offsets[chunk][digit];
+        offsets[chunk][digit] = offset;
+        offset += count;
+      }
+    }
+    for_each_chunk(chunks, [&](int64_t chunk) {
+      auto range = chunk_range(n, chunks, chunk);
+      auto& next = offsets[chunk];
+      for (int64_t i = range.first; i < range.second; i++) {
+        int64_t pos = next[(keys_buffer[i] >> shift) & (kBuckets - 1)]++;
+        next_keys[pos] = keys_buffer[i];
+        next_permutation[pos] = permutation_buffer[i];
+      }
+    });
+    std::swap(keys_buffer, next_keys);
+    std::swap(permutation_buffer, next_permutation);
+  }
+
+  std::copy(keys_buffer.begin(), keys_buffer.end(), sorted_keys);
+  std::copy(permutation_buffer.begin(), permutation_buffer.end(), permutation);
+}
+
+// Splits the merge of the sorted, duplicate free `a_keys` and `b_keys` into
+// chunks merging disjoint key ranges: the `chunk`th one merges
+// a_keys[a_bounds[chunk], a_bounds[chunk + 1]) with
+// b_keys[b_bounds[chunk], b_bounds[chunk + 1]). The chunks are split evenly
+// in the longest of the two arrays.
+struct MergePartition {
+  int64_t chunks;
+  std::vector<int64_t> a_bounds;
+  std::vector<int64_t> b_bounds;
+};
+
+inline MergePartition partition_merge(const int64_t* a_keys, int64_t a_n, const int64_t* b_keys, int64_t b_n) {
+  MergePartition partition;
+  partition.chunks = num_chunks(a_n + b_n);
+  partition.a_bounds.resize(partition.chunks + 1);
+  partition.b_bounds.resize(partition.chunks + 1);
+  const bool split_a = a_n >= b_n;
+  const int64_t* keys = split_a ? a_keys : b_keys;
+  const int64_t n = split_a ? a_n : b_n;
+  const int64_t* other_keys = split_a ? b_keys : a_keys;
+  const int64_t other_n = split_a ? b_n : a_n;
+  auto& bounds = split_a ? partition.a_bounds : partition.b_bounds;
+  auto& other_bounds = split_a ? partition.b_bounds : partition.a_bounds;
+  for (int64_t chunk = 0; chunk < partition.chunks; chunk++) {
+    bounds[chunk] = chunk_range(n, partition.chunks, chunk).first;
+    other_bounds[chunk] = chunk == 0 ? 0 :
+        bounds[chunk] == n ? other_n :
+        std::lower_bound(other_keys, other_keys + other_n, keys[bounds[chunk]]) - other_keys;
+  }
+  bounds[partition.chunks] = n;
+  other_bounds[partition.chunks] = other_n;
+  return partition;
+}
+
+}}} // namespace at::native::sparse_parallel
@@ -0,0 +1,158 @@
+// Fused optimizer steps for sparse row gradients, e.g. the ones produced by
+// embedding(sparse=True) and embedding_bag(sparse=True).
+//
+// The optimizers in torch.optim coalesce such a gradient and then run a chain
+// of sparse ops over it. The functions here instead group the gradient rows by
+// the row of the parameter they update and apply the update row by row,
+// directly from the uncoalesced indices and values, in parallel over the
+// unique rows. Rows that appear more than once get their gradients summed
+// first, which is what coalescing would do.
+
+#include <ATen/ATen.h>
+#include <ATen/NativeFunctions.h>
+#include <ATen/Parallel.h>
+#include <ATen/SparseTensorUtils.h>
+
+#include <caffe2/perfkernels/adagrad.h>
+#include <caffe2/perfkernels/typed_axpy.h>
+
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
+namespace at { namespace native {
+
+using namespace at::sparse;
+
+namespace {
+
+void check_sparse_row_grad(const Tensor& self, const SparseTensor& grad, const char* name) {
+  TORCH_CHECK(grad.is_sparse(), name, ": expected grad to be a sparse tensor");
+  TORCH_CHECK(!self.is_sparse() && self.device().is_cpu(), name, ": expected self to be a dense CPU tensor");
+  TORCH_CHECK(self.scalar_type() == kFloat && grad.scalar_type() == kFloat,
+      name, ": only float tensors are supported, but got self of type ", self.scalar_type(),
+      " and grad of type ", grad.scalar_type());
+  TORCH_CHECK(self.dim() >= 1 && self.is_contiguous(), name, ": expected self to be contiguous and at least 1D");
+  TORCH_CHECK(grad.sparse_dim() == 1, name, ": expected grad to have a single sparse dimension, but got ",
+      grad.sparse_dim());
+  TORCH_CHECK(grad.sizes() == self.sizes(), name, ": expected grad and self to have the same size, but got ",
+      grad.sizes(), " and ", self.sizes());
+}
+
+// Sorts the nonzero positions of a sparse gradient by the row they update.
+// Returns the permutation in `order` and the start of every run of equal rows
+// in `starts`, terminated with nnz.
+void group_rows(
+    const int64_t* rows,
+    int64_t nnz,
+    int64_t num_rows,
+    bool is_coalesced,
+    std::vector<int64_t>& order,
+    std::vector<int64_t>& starts,
+    const char* name) {
+  for (int64_t i = 0; i < nnz; i++) {
+    TORCH_CHECK(rows[i] >= 0 && rows[i] < num_rows,
+        name, ": grad index ", rows[i], " is out of bounds for a parameter with ", num_rows, " rows");
+  }
+  order.resize(nnz);
+  std::iota(order.begin(), order.end(), 0);
+  if (!is_coalesced) {
+    std::stable_sort(order.begin(), order.end(), [&](int64_t a, int64_t b) { return rows[a] < rows[b]; });
+  }
+  starts.clear();
+  for (int64_t i = 0; i < nnz; i++) {
+    if (i == 0 || rows[order[i]] != rows[order[i - 1]]) {
+      starts.push_back(i);
+    }
+  }
+  starts.push_back(nnz);
+}
+
+// Calls fn(row, grad_row, block_size) for every unique row of the parameter
+// that the sparse gradient touches, in parallel. grad_row points at the summed
+// gradient of that row, block_size elements long.
+template <typename F>
+void for_each_grad_row(const Tensor& self, const SparseTensor& grad, const char* name, const F& fn) {
+  const int64_t num_rows = self.size(0);
+  const int64_t block_size = num_rows == 0 ? 0 : self.numel() / num_rows;
+  const int64_t nnz = grad._nnz();
+  if (nnz == 0 || block_size == 0) {
+    return;
+  }
+  const Tensor rows_tensor = grad._indices().contiguous();
+  const Tensor values = grad._values().contiguous();
+  const int64_t* rows = rows_tensor.data_ptr<int64_t>();
+  const float* values_data = values.data_ptr<float>();
+
+  std::vector<int64_t> order, starts;
+  group_rows(rows, nnz, num_rows, grad.is_coalesced(), order, starts, name);
+  const int64_t num_groups = starts.size() - 1;
+
+  const int64_t grain_size = std::max<int64_t>(1, at::internal::GRAIN_SIZE / block_size);
+  at::parallel_for(0, num_groups, grain_size, [&](int64_t begin, int64_t end) {
+    std::vector<float> buffer;
+    for (int64_t group = begin; group < end; group++) {
+      const int64_t first = starts[group];
+      const int64_t last = starts[group + 1];
+      const int64_t row = rows[order[first]];
+      const float* grad_row = values_data + order[first] * block_size;
+      if (last - first > 1) {
+        buffer.assign(grad_row, grad_row + block_size);
+        for (int64_t i = first + 1; i < last; i++) {
+          caffe2::TypedAxpy<float, float>(block_size, 1.0f, values_data + order[i] * block_size, buffer.data());
+        }
+        grad_row = buffer.data();
+      }
+      fn(row, grad_row, block_size);
+    }
+  });
+}
+
+} // namespace
+
+Tensor& sparse_adagrad_cpu_(Tensor& self, const Tensor& state_sum, const SparseTensor& grad, double lr, double eps, bool rowwise) {
+  check_sparse_row_grad(self, grad, "_sparse_adagrad_");
+  TORCH_CHECK(!state_sum.is_sparse() && state_sum.scalar_type() == kFloat && state_sum.is_contiguous(),
+      "_sparse_adagrad_: expected state_sum to be a contiguous dense float tensor");
+  if (rowwise) {
+    TORCH_CHECK(state_sum.dim() == 1 && state_sum.size(0) == self.size(0),
+        "_sparse_adagrad_: expected state_sum to hold one value per row of self for rowwise=True, but got size ",
+        state_sum.sizes());
+  } else {
+    TORCH_CHECK(state_sum.sizes() == self.sizes(),
+        "_sparse_adagrad_: expected state_sum to have the same size as self, but got ", state_sum.sizes(),
+        " and ", self.sizes());
+  }
+
+  float* weight_data = self.data_ptr<float>();
+  float* state_data = state_sum.data_ptr<float>();
+  // the caffe2 kernels add the step, so hand them the negated learning rate
+  const float step = -static_cast<float>(lr);
+  const float epsilon = static_cast<float>(eps);
+  if (rowwise) {
+    for_each_grad_row(self, grad, "_sparse_adagrad_", [&](int64_t row, const float* g, int64_t block_size) {
+      float* w = weight_data + row * block_size;
+      float* h = state_data + row;
+      caffe2::rowwise_adagrad_update(block_size, w, w, g, h, h, epsilon, step);
+    });
+  } else {
+    for_each_grad_row(self, grad, "_sparse_adagrad_", [&](int64_t row, const float* g, int64_t block_size) {
+      float* w = weight_data + row * block_size;
+      float* h = state_data + row * block_size;
+      caffe2::adagrad_update_prefetch(block_size, w, w, g, h, h, w, w, h, h, epsilon, step);
+    });
+  }
+  return self;
+}
+
+Tensor& sparse_sgd_cpu_(Tensor& self, const SparseTensor& grad, double lr) {
+  check_sparse_row_grad(self, grad, "_sparse_sgd_");
+  float* weight_data = self.data_ptr<float>();
+  const float step = -static_cast<float>(lr);
+  for_each_grad_row(self, grad, "_sparse_sgd_", [&](int64_t row, const float* g, int64_t block_size) {
+    caffe2::TypedAxpy<float, float>(block_size, step, g, weight_data + row * block_size);
+  });
+  return self;
+}
+
+}} // namespace at::native
@@ -7,9 +7,13 @@
 #include <ATen/NativeFunctions.h>
 #include <ATen/InitialTensorOptions.h>
 #include <ATen/SparseTensorUtils.h>
+#include <ATen/native/sparse/ParallelSparseUtils.h>
 
 #include <TH/THBlasUtils.h>
 
+#include <numeric>
+#include <vector>
+
 namespace at { namespace native {
 
 using namespace at::sparse;
@@ -374,7 +378,7 @@ SparseTensor coalesce_sparse_cpu(const SparseTensor& self) {
   int64_t dense_dim = self.dense_dim();
   int64_t nnz = self._nnz();
 
-  LongTensor indices_scalar = flatten_indices(indices, self.sizes());
+  LongTensor indices_scalar = flatten_indices(indices, self.sizes()).contiguous();
 
   SparseTensor dst = new_sparse(self.options());
   get_sparse_impl(dst)->resize_(sparse_dim, dense_dim, self.sizes());
@@ -383,44 +387,67 @@ SparseTensor coalesce_sparse_cpu(const SparseTensor& self) {
   Tensor newValues = at::empty(values.sizes(), values.options());
   alias_into_sparse(dst, newIndices, newValues);
 
-  LongTensor indicesBuffer;
-  LongTensor indicesPermutation;
-  std::tie(indicesBuffer, indicesPermutation) = indices_scalar.sort(0);
+  LongTensor indicesBuffer = at::empty({nnz}, indices_scalar.options());
+  LongTensor indicesPermutation = at::empty({nnz}, indices_scalar.options());
+  sparse_parallel::radix_sort(
+      indices_scalar.data_ptr<int64_t>(), nnz,
+      indicesBuffer.data_ptr<int64_t>(), indicesPermutation.data_ptr<int64_t>());
   // NB: The accessor accesses here rely on self._nnz() > 0 (tested earlier in this function)
   auto newIndicesAccessor = newIndices.accessor<int64_t, 2>();
   auto indicesAccessor = indices.accessor<int64_t, 2>();
-  auto indicesPermutationAccessor = indicesPermutation.accessor<int64_t, 1>();
-  auto indicesBufferAccessor = indicesBuffer.accessor<int64_t, 1>();
+  const int64_t* permutation = indicesPermutation.data_ptr<int64_t>();
+  const int64_t* sorted = indicesBuffer.data_ptr<int64_t>();
+
+  // Every chunk of the sorted indices reduces the runs of equal indices that
+  // start in it, into the entries after the ones of the previous chunks.
+  const int64_t chunks = sparse_parallel::num_chunks(nnz);
+  std::vector<int64_t> chunkOffsets(chunks + 1, 0);
+  sparse_parallel::for_each_chunk(chunks, [&](int64_t chunk) {
+    auto range = sparse_parallel::chunk_range(nnz, chunks, chunk);
+    int64_t runs = 0;
+    for (int64_t j = range.first; j < range.second; j++) {
+      runs += (j == 0 || sorted[j] != sorted[j - 1]);
+    }
+    chunkOffsets[chunk + 1] = runs;
+  });
+  std::partial_sum(chunkOffsets.begin(), chunkOffsets.end(), chunkOffsets.begin());
 
-  int64_t i = -1;
   AT_DISPATCH_ALL_TYPES(
       values.scalar_type(), "coalesce", [&] {
-        int64_t prev = -1;
         int64_t blockSize = values.stride(0);
         scalar_t* values_ptr = values.data_ptr<scalar_t>();
         scalar_t* newValues_ptr = newValues.data_ptr<scalar_t>();
-        for (int64_t j = 0; j < nnz; j++) {
-          int64_t pos = indicesPermutationAccessor[j];
-          int64_t curr = indicesBufferAccessor[j];
-          if (curr == prev) {
-            if (values.numel() > 0) {  // if values is an empty tensor, there are no elements to copy
-              THBlas_axpy<scalar_t>(blockSize, 1, values_ptr + pos * blockSize, 1, newValues_ptr + i * blockSize, 1);
-            }
-          } else {
-            ++i;
+        sparse_parallel::for_each_chunk(chunks, [&](int64_t chunk) {
+          auto range = sparse_parallel::chunk_range(nnz, chunks, chunk);
+          int64_t i = chunkOffsets[chunk];
+          int64_t j = range.first;
+          // the run the chunk starts in, if any, belongs to the previous chunk
+          while (j < range.second && j > 0 && sorted[j] == sorted[j - 1]) {
+            j++;
+          }
+          while (j < range.second) {
+            int64_t pos = permutation[j];
             for (int64_t d = 0; d < sparse_dim; d++) {
               newIndicesAccessor[d][i] = indicesAccessor[d][pos];
             }
             if (values.numel() > 0) {  // if values is an empty tensor, there are no elements to copy
               THBlas_copy<scalar_t>(blockSize, values_ptr + pos * blockSize, 1, newValues_ptr + i * blockSize, 1);
             }
+            // the run may go on past the end of the chunk
+            int64_t k = j + 1;
+            for (; k < nnz && sorted[k] == sorted[j]; k++) {
+              if (values.numel() > 0) {
+                THBlas_axpy<scalar_t>(blockSize, 1, values_ptr + permutation[k] * blockSize, 1, newValues_ptr + i * blockSize, 1);
+              }
+            }
+            i++;
+            j = k;
           }
-          prev = curr;
-        }
+        });
     });
 
   dst._coalesced_(true);
-  get_sparse_impl(dst)->set_nnz_and_narrow(i + 1);
+  get_sparse_impl(dst)->set_nnz_and_narrow(chunkOffsets[chunks]);
 
   return dst;
 }
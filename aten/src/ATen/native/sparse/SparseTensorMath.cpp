@@ -8,9 +8,15 @@
 #include <ATen/InitialTensorOptions.h>
 #include <ATen/SparseTensorUtils.h>
 #include <ATen/WrapDimUtilsMulti.h>
+#include <ATen/native/sparse/ParallelSparseUtils.h>
 
 #include <TH/THBlasUtils.h>
 
+#include <algorithm>
+#include <functional>
+#include <numeric>
+#include <vector>
+
 namespace at { namespace native {
 
 using namespace at::sparse;
@@ -230,6 +236,89 @@ Tensor& sub_out_sparse(Tensor& r, const Tensor& self, const Tensor& other, Scala
 
 Tensor& add_out_dense_sparse_cpu(Tensor& r, const Tensor& dense, const SparseTensor& sparse_, Scalar value);
 
+// r = t + value * src, for coalesced `t` and `src` with contiguous values, of
+// the sizes of `r`. Both are sorted by their linearized indices, so each chunk
+// of a partition of their merge is merged in parallel: once to count the
+// entries of its key range, and once to write them after the ones of the
+// previous chunks.
+static SparseTensor& add_out_coalesced_sparse_cpu(SparseTensor& r, const LongTensor& t_indices, const Tensor& t_values, const LongTensor& src_indices, const Tensor& s_values, Scalar value) {
+  int64_t t_nnz = t_indices.size(1), s_nnz = src_indices.size(1);
+  int64_t sparse_dim = src_indices.size(0);
+  LongTensor t_keys = flatten_indices(t_indices, r.sizes()).contiguous();
+  LongTensor s_keys = flatten_indices(src_indices, r.sizes()).contiguous();
+  const int64_t* t_keys_ptr = t_keys.data_ptr<int64_t>();
+  const int64_t* s_keys_ptr = s_keys.data_ptr<int64_t>();
+  auto partition = sparse_parallel::partition_merge(t_keys_ptr, t_nnz, s_keys_ptr, s_nnz);
+  const int64_t chunks = partition.chunks;
+
+  std::vector<int64_t> offsets(chunks + 1, 0);
+  sparse_parallel::for_each_chunk(chunks, [&](int64_t chunk) {
+    int64_t t_i = partition.a_bounds[chunk], t_end = partition.a_bounds[chunk + 1];
+    int64_t s_i = partition.b_bounds[chunk], s_end = partition.b_bounds[chunk + 1];
+    int64_t count = 0;
+    while (t_i < t_end && s_i < s_end) {
+      int64_t t_key = t_keys_ptr[t_i], s_key = s_keys_ptr[s_i];
+      t_i += t_key <= s_key;
+      s_i += s_key <= t_key;
+      count++;
+    }
+    offsets[chunk + 1] = count + (t_end - t_i) + (s_end - s_i);
+  });
+  std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+  LongTensor r_indices = at::empty({sparse_dim, offsets[chunks]}, t_indices.options());
+  Tensor r_values = new_values_with_size_of(s_values, offsets[chunks]).zero_();
+  get_sparse_impl(r)->set_indices_and_values_unsafe(r_indices, r_values);
+
+  int64_t blockSize = r_values.stride(0);
+  auto t_indices_accessor = t_indices.accessor<int64_t, 2>();
+  auto r_indices_accessor = r_indices.accessor<int64_t, 2>();
+  auto src_indices_accessor = src_indices.accessor<int64_t, 2>();
+
+  AT_DISPATCH_ALL_TYPES(
+      t_values.scalar_type(), "cadd_sparse", [&] {
+        scalar_t* t_values_ptr = t_values.data_ptr<scalar_t>();
+        scalar_t* s_values_ptr = s_values.data_ptr<scalar_t>();
+        scalar_t* r_values_ptr = r_values.data_ptr<scalar_t>();
+        scalar_t cast_value = value.to<scalar_t>();
+        sparse_parallel::for_each_chunk(chunks, [&](int64_t chunk) {
+          int64_t t_i = partition.a_bounds[chunk], t_end = partition.a_bounds[chunk + 1];
+          int64_t s_i = partition.b_bounds[chunk], s_end = partition.b_bounds[chunk + 1];
+          int64_t r_i = offsets[chunk];
+          while (t_i < t_end || s_i < s_end) {
+            bool take_t = s_i >= s_end || (t_i < t_end && t_keys_ptr[t_i] <= s_keys_ptr[s_i]);
+            bool take_s = t_i >= t_end || (s_i < s_end && s_keys_ptr[s_i] <= t_keys_ptr[t_i]);
+            if (take_t) {
+              for (int64_t d = 0; d < sparse_dim; d++) {
+                r_indices_accessor[d][r_i] = t_indices_accessor[d][t_i];
+              }
+              if (t_values.numel() > 0) {
+                THBlas_axpy<scalar_t>(blockSize, 1,
+                  t_values_ptr + t_i * blockSize, 1,
+                  r_values_ptr + r_i * blockSize, 1);
+              }
+              t_i++;
+            }
+            if (take_s) {
+              for (int64_t d = 0; d < sparse_dim; d++) {
+                r_indices_accessor[d][r_i] = src_indices_accessor[d][s_i];
+              }
+              if (s_values.numel() > 0) {
+                THBlas_axpy<scalar_t>(blockSize, cast_value,
+                  s_values_ptr + s_i * blockSize, 1,
+                  r_values_ptr + r_i * blockSize, 1);
+              }
+              s_i++;
+            }
+            r_i++;
+          }
+        });
+      }
+  );
+
+  return r._coalesced_(true);
+}
+
 SparseTensor& add_out_sparse_cpu(SparseTensor& r, const SparseTensor& t, const SparseTensor& src, Scalar value) {
   if (!t.is_sparse()) {
     return add_out_dense_sparse_cpu(r, t, src, value);
@@ -261,6 +350,10 @@ SparseTensor& add_out_sparse_cpu(SparseTensor& r, const SparseTensor& t, const S
   Tensor s_values = src._values();
   r.resize_as_(src);
 
+  if (s_values.is_contiguous() && t_values.is_contiguous() && t_coalesced && s_coalesced) {
+    return add_out_coalesced_sparse_cpu(r, t_indices, t_values, src_indices, s_values, value);
+  }
+
   if (s_values.is_contiguous() && t_values.is_contiguous()) {
     LongTensor r_indices = at::empty({sparse_dim, max_nnz}, t_indices.options());
     Tensor r_values = new_values_with_size_of(s_values, max_nnz).zero_();
@@ -454,76 +547,77 @@ SparseTensor& mul_out_sparse_cpu(SparseTensor& r, const Tensor& t_, const Tensor
 
   // saving those because they can be overwritten when doing in-place operations
   int64_t t_nnz = t._nnz(), s_nnz = src._nnz();
-  int64_t max_nnz = std::min(t_nnz, s_nnz);  // multiply by zero is zero, and can be dropped
   int64_t sparse_dim = src.sparse_dim();
   LongTensor t_indices = t._indices();
-  Tensor t_values = t._values();
+  Tensor t_values = t._values().contiguous();
   LongTensor src_indices = src._indices();
-  Tensor s_values = src._values();
-  LongTensor r_indices = at::empty({sparse_dim, max_nnz}, t_indices.options());
-  Tensor r_values = new_values_with_size_of(t_values, max_nnz).zero_();
+  Tensor s_values = src._values().contiguous();
   r.resize_as_(src);
-  get_sparse_impl(r)->set_indices_and_values_unsafe(r_indices, r_values);
 
-  int64_t match, d;
-  int64_t r_i = 0, t_i = 0, s_i = 0;
-
-  // NB: relies on nnz test above
-  auto t_indices_accessor = t_indices.accessor<int64_t, 2>();
-  auto r_indices_accessor = r_indices.accessor<int64_t, 2>();
-  auto src_indices_accessor = src_indices.accessor<int64_t, 2>();
-
-  // Check if we can find matching indices, and if so, write an
-  // entry to the result indices vector.  Returns true if matching
-  // indices were found.
-  auto index_preamble = [&]() {
-    match = 1;
-    for (d = 0; d < sparse_dim; d++) {
-      if (t_indices_accessor[d][t_i] < src_indices_accessor[d][s_i]) {
+  // Both are coalesced, and thus sorted by their linearized indices, so each
+  // chunk of a partition of their merge is intersected in parallel: once to
+  // count the indices of its key range in both, and once to write their
+  // products after the ones of the previous chunks.
+  LongTensor t_keys = flatten_indices(t_indices, r.sizes()).contiguous();
+  LongTensor s_keys = flatten_indices(src_indices, r.sizes()).contiguous();
+  const int64_t* t_keys_ptr = t_keys.data_ptr<int64_t>();
+  const int64_t* s_keys_ptr = s_keys.data_ptr<int64_t>();
+  auto partition = sparse_parallel::partition_merge(t_keys_ptr, t_nnz, s_keys_ptr, s_nnz);
+  const int64_t chunks = partition.chunks;
+
+  // Calls `f(t_i, s_i)` for the matching entries of `t` and `src` in `chunk`.
+  auto for_each_match = [&](int64_t chunk, const std::function<void(int64_t, int64_t)>& f) {
+    int64_t t_i = partition.a_bounds[chunk], t_end = partition.a_bounds[chunk + 1];
+    int64_t s_i = partition.b_bounds[chunk], s_end = partition.b_bounds[chunk + 1];
+    while (t_i < t_end && s_i < s_end) {
+      int64_t t_key = t_keys_ptr[t_i], s_key = s_keys_ptr[s_i];
+      if (t_key < s_key) {
         t_i++;
-        match = 0;
-        break;
-      }
-      if (t_indices_accessor[d][t_i] > src_indices_accessor[d][s_i]) {
+      } else if (s_key < t_key) {
         s_i++;
-        match = 0;
-        break;
+      } else {
+        f(t_i++, s_i++);
       }
     }
-    if (!match) return false;
-    for (d = 0; d < sparse_dim; d++) {
-      r_indices_accessor[d][r_i] = t_indices_accessor[d][t_i];
-    }
-    return true;
   };
 
-  if (t_values.dim() > 1) {
-    while (t_i < t_nnz && s_i < s_nnz) {
-      if (!index_preamble()) continue;
-      r_values.select(0, r_i).addcmul_(t_values.select(0, t_i), s_values.select(0, s_i));
-      r_i++;
-      t_i++;
-      s_i++;
-    }
-  } else {
-    AT_DISPATCH_ALL_TYPES(
-        r_values.scalar_type(), "mul_out_sparse", [&] {
-          auto r_accessor = r_values.accessor<scalar_t, 1>();
-          auto t_accessor = t_values.accessor<scalar_t, 1>();
-          auto s_accessor = s_values.accessor<scalar_t, 1>();
-
-          while (t_i < t_nnz && s_i < s_nnz) {
-            if (!index_preamble()) continue;
-            r_accessor[r_i] = t_accessor[t_i] * s_accessor[s_i];
+  std::vector<int64_t> offsets(chunks + 1, 0);
+  sparse_parallel::for_each_chunk(chunks, [&](int64_t chunk) {
+    int64_t count = 0;
+    for_each_match(chunk, [&](int64_t, int64_t) { count++; });
+    offsets[chunk + 1] = count;
+  });
+  std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+  LongTensor r_indices = at::empty({sparse_dim, offsets[chunks]}, t_indices.options());
+  Tensor r_values = new_values_with_size_of(t_values, offsets[chunks]);
+  get_sparse_impl(r)->set_indices_and_values_unsafe(r_indices, r_values);
+
+  // NB: relies on nnz test above
+  auto t_indices_accessor = t_indices.accessor<int64_t, 2>();
+  auto r_indices_accessor = r_indices.accessor<int64_t, 2>();
+  int64_t blockSize = r_values.numel() == 0 ? 0 : r_values.stride(0);
+
+  AT_DISPATCH_ALL_TYPES(
+      r_values.scalar_type(), "mul_out_sparse", [&] {
+        scalar_t* r_ptr = r_values.data_ptr<scalar_t>();
+        const scalar_t* t_ptr = t_values.data_ptr<scalar_t>();
+        const scalar_t* s_ptr = s_values.data_ptr<scalar_t>();
+        sparse_parallel::for_each_chunk(chunks, [&](int64_t chunk) {
+          int64_t r_i = offsets[chunk];
+          for_each_match(chunk, [&](int64_t t_i, int64_t s_i) {
+            for (int64_t d = 0; d < sparse_dim; d++) {
+              r_indices_accessor[d][r_i] = t_indices_accessor[d][t_i];
+            }
+            for (int64_t k = 0; k < blockSize; k++) {
+              r_ptr[r_i * blockSize + k] = t_ptr[t_i * blockSize + k] * s_ptr[s_i * blockSize + k];
+            }
             r_i++;
-            t_i++;
-            s_i++;
-          }
-        }
-    );
-  }
+          });
+        });
+      }
+  );
 
-  get_sparse_impl(r)->set_nnz_and_narrow(r_i);
   return r._coalesced_(true);
 }
 
@@ -534,9 +628,7 @@ SparseTensor& mul_out_sparse_cpu(SparseTensor& r, const Tensor& t_, const Tensor
 // --------------------------------------------------------------------
 
 template <typename scalar_t>
-void s_addmm_out_sparse_dense_worker(int64_t nnz, int64_t dim_i, int64_t dim_j, int64_t dim_k, Tensor& r, Scalar beta, const Tensor& t, Scalar alpha, const Tensor& indices, const Tensor& values, const Tensor& dense) {
-  int64_t i;
-
+void s_addmm_out_sparse_dense_worker(int64_t nnz, int64_t dim_i, int64_t dim_j, int64_t dim_k, Tensor& r, Scalar beta, const Tensor& t, Scalar alpha, const Tensor& indices, const Tensor& values, const Tensor& dense, bool coalesced) {
   // r_ = alpha * sparse * dense
   scalar_t cast_alpha = alpha.to<scalar_t>();
   scalar_t cast_beta = beta.to<scalar_t>();
@@ -560,23 +652,47 @@ void s_addmm_out_sparse_dense_worker(int64_t nnz, int64_t dim_i, int64_t dim_j,
   int64_t dense_stride1 = dense.stride(1);
   int64_t r_stride0 = r.stride(0);
   int64_t r_stride1 = r.stride(1);
-  for (i = 0; i < nnz; i++) {
-    scalar_t val = values_accessor[i];
+
+  // Group the nonzeros by row, in CSR form: the nonzeros of row `row` are
+  // the `order[p]`th for `p` in [row_ptr[row], row_ptr[row + 1]), or the
+  // `p`th if the tensor is coalesced, and thus sorted by row. Every row of `r`
+  // only depends on the nonzeros of its row, so rows are computed in parallel.
+  std::vector<int64_t> row_ptr(dim_i + 1, 0);
+  for (int64_t i = 0; i < nnz; i++) {
     int64_t row = indices_accessor[0][i];
     int64_t col = indices_accessor[1][i];
-    if (col >= 0 && col < dim_j && row >= 0 && row < dim_i) {
-      THBlas_axpy<scalar_t>(dim_k,
-            cast_alpha * val,
-            dense_ptr + col * dense_stride0, dense_stride1,
-            r_ptr + row * r_stride0, r_stride1);
-    } else {
-      if (col < 0 || col >= dim_j) {
-        AT_ERROR("addmm: index out of column bound: ", col, " not between 1 and ", dim_j);
-      } else {
-        AT_ERROR("addmm: index out of row bound: ", row, " not between 1 and ", dim_i);
-      }
+    if (col < 0 || col >= dim_j) {
+      AT_ERROR("addmm: index out of column bound: ", col, " not between 1 and ", dim_j);
+    } else if (row < 0 || row >= dim_i) {
+      AT_ERROR("addmm: index out of row bound: ", row, " not between 1 and ", dim_i);
+    }
+    row_ptr[row + 1]++;
+  }
+  std::partial_sum(row_ptr.begin(), row_ptr.end(), row_ptr.begin());
+  std::vector<int64_t> order;
+  if (!coalesced) {
+    order.resize(nnz);
+    std::vector<int64_t> next(row_ptr.begin(), row_ptr.end() - 1);
+    for (int64_t i = 0; i < nnz; i++) {
+      order[next[indices_accessor[0][i]]++] = i;
     }
   }
+
+  // about GRAIN_SIZE multiply-adds per task
+  int64_t row_work = std::max<int64_t>(1, (nnz / dim_i) * dim_k);
+  int64_t grain_size = std::max<int64_t>(1, at::internal::GRAIN_SIZE / row_work);
+  at::parallel_for(0, dim_i, grain_size, [&](int64_t start, int64_t end) {
+    for (int64_t row = start; row < end; row++) {
+      for (int64_t p = row_ptr[row]; p < row_ptr[row + 1]; p++) {
+        int64_t i = coalesced ? p : order[p];
+        int64_t col = indices_accessor[1][i];
+        THBlas_axpy<scalar_t>(dim_k,
+              cast_alpha * values_accessor[i],
+              dense_ptr + col * dense_stride0, dense_stride1,
+              r_ptr + row * r_stride0, r_stride1);
+      }
+    }
+  });
 };
 
 Tensor& s_addmm_out_sparse_dense_cpu(
@@ -623,7 +739,7 @@ Tensor& s_addmm_out_sparse_dense_cpu(
 
   AT_DISPATCH_ALL_TYPES(
       values.scalar_type(), "addmm_sparse_dense", [&] {
-        s_addmm_out_sparse_dense_worker<scalar_t>(nnz, dim_i, dim_j, dim_k, r, beta, t, alpha, indices, values, dense);
+        s_addmm_out_sparse_dense_worker<scalar_t>(nnz, dim_i, dim_j, dim_k, r, beta, t, alpha, indices, values, dense, sparse_.is_coalesced());
       }
   );
 
@@ -3,9 +3,12 @@
 #include <c10/core/Allocator.h>
 #include <ATen/Dispatch.h>
 #include <ATen/NativeFunctions.h>
+#include <ATen/detail/CUDAHooksInterface.h>
 #include <ATen/native/TensorFactories.h>
+#include <ATen/native/quantized/affine_quantizer.h>
 #include <ATen/quantized/QTensorImpl.h>
 #include <ATen/core/Tensor.h>
+#include <c10/core/DeviceGuard.h>
 #include <typeinfo>
 
 #ifdef USE_FBGEMM
@@ -360,72 +363,6 @@ template CAFFE2_API qint8 requantize_val<qint32, qint8>(double, int64_t, double,
 template CAFFE2_API quint8 requantize_val<qint32, quint8>(double, int64_t, double, int64_t, qint32);
 template CAFFE2_API qint32 requantize_val<qint32, qint32>(double, int64_t, double, int64_t, qint32);
 
-// TODO: add fbgemm for per channel
-template <typename T>
-Tensor quantize_tensor_per_channel_affine(Tensor rtensor,
-                                          Tensor qtensor,
-                                          const std::vector<double>& scales,
-                                          const std::vector<int64_t>& zero_points,
-                                          int64_t axis) {
-  auto fn_name = "quantize_tensor_per_channel_affine";
-  checkFloatCPUTensor(fn_name, rtensor);
-  checkQuantizedCPUTensor<T>(fn_name, qtensor);
-  checkZeroPoints<typename T::underlying>(fn_name, zero_points);
-  TORCH_CHECK(0 <= axis && axis < rtensor.dim(), "Channel axis out of range in per channel affine quantization.");
-  int64_t batches = size_to_dim_(axis, rtensor.sizes());
-  int64_t elements_per_channel = size_from_dim_(axis + 1, rtensor.sizes());
-  int64_t channel = rtensor.size(axis);
-  TORCH_CHECK(channel == int64_t(scales.size()),
-              "length of scales must equal to channel");
-  TORCH_CHECK(channel == int64_t(zero_points.size()),
-              "length of zero_points must equal to channel");
-  const float* rdata = rtensor.data_ptr<float>();
-  auto qdata = qtensor.data_ptr<T>();
-  for (auto b = 0; b < batches; ++b) {
-    for (auto c = 0; c < channel; ++c) {
-      for (auto e = 0; e < elements_per_channel; ++e) {
-        auto i = b * channel * elements_per_channel + c * elements_per_channel + e;
-        qdata[i] = quantize_val<T>(scales[c], zero_points[c], rdata[i]);
-      }
-    }
-  }
-  return qtensor;
-}
-
-template <typename T>
-Tensor dequantize_tensor_per_channel_affine(Tensor qtensor,
-                                            Tensor rtensor,
-                                            const std::vector<double>& scales,
-                                            const std::vector<int64_t>& zero_points,
-                                            int64_t axis) {
-  auto fn_name = "dequantize_tensor_per_channel_affine";
-  checkFloatCPUTensor(fn_name, rtensor);
-  checkQuantizedCPUTensor<T>(fn_name, qtensor);
-  checkZeroPoints<typename T::underlying>(fn_name, zero_points);
-  TORCH_CHECK(0 <= axis && axis < qtensor.dim(),
-              "Channel axis out of range in per channel affine dequantization.");
-  int64_t batches = size_to_dim_(axis, rtensor.sizes());
-  int64_t elements_per_channel = size_from_dim_(axis + 1, rtensor.sizes());
-  int64_t channel = rtensor.size(axis);
-  TORCH_CHECK(channel == int64_t(scales.size()),
-              "length of scales must equal to channel");
-  TORCH_CHECK(channel == int64_t(zero_points.size()),
-              "length of zero_points must equal to channel");
-  const auto* qd = qtensor.data_ptr<T>();
-  float* rd = rtensor.data_ptr<float>();
-  for (auto b = 0; b < batches; ++b) {
-    for (auto c = 0; c < channel; ++c) {
-      for (auto e = 0; e < elements_per_channel; ++e) {
-        auto i = b * channel * elements_per_channel + c * elements_per_channel + e;
-        // We need to convert the qint8 value to float to ensure the subtraction
-        // subexpression returns a float
-        rd[i] = (static_cast<float>(qd[i].val_) - zero_points[c]) * scales[c];
-      }
-    }
-  }
-  return rtensor;
-}
-
 QuantizerPtr make_per_tensor_affine_quantizer(
     double scale,
     int64_t zero_point,
@@ -479,19 +416,49 @@ QTensorImpl* get_qtensorimpl(const Tensor& self) {
   return static_cast<QTensorImpl*>(self.unsafeGetTensorImpl());
 }
 
-inline Tensor new_qtensor_cpu(
+void checkPerChannelParams(
+    std::string fn_name,
+    const Tensor& t,
+    const std::vector<double>& scales,
+    const std::vector<int64_t>& zero_points,
+    int64_t axis) {
+  TORCH_CHECK(
+      0 <= axis && axis < t.dim(),
+      fn_name,
+      ": channel axis out of range.");
+  TORCH_CHECK(
+      t.size(axis) == int64_t(scales.size()),
+      "length of scales must equal to channel");
+  TORCH_CHECK(
+      t.size(axis) == int64_t(zero_points.size()),
+      "length of zero_points must equal to channel");
+}
+
+inline Tensor new_qtensor(
     IntArrayRef sizes,
     const TensorOptions& options,
     QuantizerPtr quantizer,
     MemoryFormat memory_format=MemoryFormat::Contiguous) {
-  AT_ASSERT(options.device().is_cpu());
+  auto device = options.device();
+  TORCH_CHECK(
+      device.is_cpu() || device.is_cuda(),
+      "Quantized tensors are only supported on CPU and CUDA, but got ",
+      device);
 
   native::check_size_nonnegative(sizes);
-  auto* allocator = at::getCPUAllocator();
+  // The CUDA allocator allocates on the current device
+  c10::OptionalDeviceGuard device_guard;
+  at::Allocator* allocator;
+  if (device.is_cuda()) {
+    device_guard.reset_device(device);
+    allocator = at::detail::getCUDAHooks().getCUDADeviceAllocator();
+  } else {
+    allocator = at::getCPUAllocator();
+  }
   int64_t nelements = at::prod_intlist(sizes);
   auto dtype = options.dtype();
   TORCH_CHECK(isQIntType(typeMetaToScalarType(dtype)),
-           "ScalarType is not supported in new_qtensor_cpu.");
+           "ScalarType is not supported in new_qtensor.");
   auto storage = c10::make_intrusive<StorageImpl>(
       dtype,
       nelements,
@@ -499,7 +466,7 @@ inline Tensor new_qtensor_cpu(
       allocator,
       /*resizable=*/true);
   auto tensor = detail::make_tensor<QTensorImpl>(
-      storage, at::TensorTypeSet(at::TensorTypeId::QuantizedCPUTensorId), quantizer);
+      storage, at::TensorTypeSet(options.computeTensorTypeId()), quantizer);
   get_qtensorimpl(tensor)->set_sizes_contiguous(sizes);
   get_qtensorimpl(tensor)->empty_tensor_restride(memory_format);
   return tensor;
@@ -509,36 +476,40 @@ Tensor PerTensorAffineQuantizer::quantize(Tensor rtensor) {
   TORCH_CHECK(
       rtensor.scalar_type() == kFloat,
       "quantize only works on Float Tensor.");
-  TORCH_CHECK(
-      rtensor.device() == kCPU,
-      "quantize only works for CPU backend right now.");
   // Here we need a std::intrusive_ptr<Quantizer>.. but actually "this" is the
   // quantizer that can be reused, so I'm using intrusive_from_this here
-  Tensor qtensor = new_qtensor_cpu(
+  Tensor qtensor = new_qtensor(
       rtensor.sizes(),
       rtensor.options().dtype(scalar_type_),
       intrusive_from_this());
 
   rtensor = rtensor.contiguous();
+  // If QEngine is set to QNNPACK, use caffe2 specialized Int8Quantize implementation on ARM
+#if defined(__ARM_NEON__)
+  if (rtensor.device().type() == kCPU &&
+      at::globalContext().qEngine() == at::QEngine::QNNPACK) {
+    AT_DISPATCH_QINT_TYPES(qtensor.scalar_type(), "quantize_tensor", [&]() {
+      qtensor = quantize_tensor<scalar_t>(rtensor, qtensor, scale_, zero_point_);
+    });
+    return qtensor;
+  }
+#endif
   AT_DISPATCH_QINT_TYPES(qtensor.scalar_type(), "quantize_tensor", [&]() {
-    qtensor = quantize_tensor<scalar_t>(rtensor, qtensor, scale_, zero_point_);
+    checkZeroPoint<underlying_t>("quantize_tensor", zero_point_);
   });
+  native::quantize_tensor_per_tensor_affine_stub(
+      rtensor.device().type(), rtensor, qtensor, scale_, zero_point_);
   return qtensor;
 }
 
 Tensor PerTensorAffineQuantizer::dequantize(Tensor qtensor) {
   TORCH_CHECK(qtensor.is_quantized(),
            "dequantize is only supported in quantized Tensor.");
-  TORCH_CHECK(
-      qtensor.device() == kCPU,
-      "dequantize only works for CPU backend right now.");
   Tensor rtensor = at::empty(qtensor.sizes(), qtensor.options().dtype(at::kFloat));
   qtensor = qtensor.contiguous();
 
-  AT_DISPATCH_QINT_TYPES(qtensor.scalar_type(), "dequantize_tensor", [&]() {
-    rtensor = dequantize_tensor<scalar_t>(qtensor, rtensor, scale_, zero_point_);
-  });
-
+  native::dequantize_tensor_per_tensor_affine_stub(
+      qtensor.device().type(), qtensor, rtensor, scale_, zero_point_);
   return rtensor;
 }
 
@@ -546,42 +517,57 @@ Tensor PerChannelAffineQuantizer::quantize(Tensor rtensor) {
   TORCH_CHECK(
       rtensor.scalar_type() == kFloat,
       "quantize only works on Float Tensor.");
-  TORCH_CHECK(
-      rtensor.device() == kCPU,
-      "quantize only works for CPU backend right now.");
   // Here we need a std::intrusive_ptr<Quantizer>.. but actually "this" is the
   // quantizer that can be reused, so I'm using intrusive_from_this here
-  Tensor qtensor = new_qtensor_cpu(
+  Tensor qtensor = new_qtensor(
       rtensor.sizes(),
       rtensor.options().dtype(scalar_type_),
       intrusive_from_this());
 
   rtensor = rtensor.contiguous();
-  AT_DISPATCH_QINT_TYPES(qtensor.scalar_type(),
-                         "quantize_tensor_per_channel_affine",
-                         [&]() {
-    qtensor = quantize_tensor_per_channel_affine<scalar_t>(
-        rtensor, qtensor, scales_, zero_points_, axis_);
+  checkPerChannelParams(
+      "quantize_tensor_per_channel_affine",
+      rtensor,
+      scales_,
+      zero_points_,
+      axis_);
+  AT_DISPATCH_QINT_TYPES(qtensor.scalar_type(), "quantize_tensor", [&]() {
+    checkZeroPoints<underlying_t>(
+        "quantize_tensor_per_channel_affine", zero_points_);
   });
+  native::quantize_tensor_per_channel_affine_stub(
+      rtensor.device().type(),
+      rtensor,
+      qtensor,
+      at::tensor(scales_, at::device(kCPU).dtype(kDouble))
+          .to(rtensor.device(), kFloat),
+      at::tensor(zero_points_, at::device(kCPU).dtype(kLong))
+          .to(rtensor.device(), kInt),
+      axis_);
   return qtensor;
 }
 
 Tensor PerChannelAffineQuantizer::dequantize(Tensor qtensor) {
   TORCH_CHECK(qtensor.is_quantized(),
            "dequantize is only supported in quantized Tensor.");
-  TORCH_CHECK(
-      qtensor.device() == kCPU,
-      "dequantize only works for CPU backend right now.");
   Tensor rtensor = at::empty(qtensor.sizes(), qtensor.options().dtype(at::kFloat));
   qtensor = qtensor.contiguous();
 
-  AT_DISPATCH_QINT_TYPES(qtensor.scalar_type(),
-                         "dequantize_tensor_per_channel_affine",
-                         [&]() {
-    rtensor = dequantize_tensor_per_channel_affine<scalar_t>(
-        qtensor, rtensor, scales_, zero_points_, axis_);
-  });
-
+  checkPerChannelParams(
+      "dequantize_tensor_per_channel_affine",
+      qtensor,
+      scales_,
+      zero_points_,
+      axis_);
+  native::dequantize_tensor_per_channel_affine_stub(
+      qtensor.device().type(),
+      qtensor,
+      rtensor,
+      at::tensor(scales_, at::device(kCPU).dtype(kDouble))
+          .to(rtensor.device(), kFloat),
+      at::tensor(zero_points_, at::device(kCPU).dtype(kLong))
+          .to(rtensor.device(), kInt),
+      axis_);
   return rtensor;
 }
 
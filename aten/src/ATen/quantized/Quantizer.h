@@ -262,8 +262,9 @@ CAFFE2_API QuantizerPtr make_per_channel_affine_quantizer(
     int64_t axis,
     ScalarType scalar_type);
 
-// Create a Quantized Tensor given arguments for normal Tensor and a quantizer
-CAFFE2_API Tensor new_qtensor_cpu(
+// Create a Quantized Tensor given arguments for normal Tensor and a quantizer,
+// on the CPU or a CUDA device
+CAFFE2_API Tensor new_qtensor(
     IntArrayRef sizes,
     const TensorOptions& options,
     QuantizerPtr quantizer,
@@ -4,6 +4,7 @@
 #include <ATen/Utils.h>
 #include <ATen/CPUGenerator.h>
 #include <ATen/core/PhiloxRNGEngine.h>
+#include <ATen/Parallel.h>
 #include <thread>
 #include <limits>
 #include <random>
@@ -196,6 +197,55 @@ TEST(CPUGenerator, TestPhiloxEngineIndex) {
   ASSERT_NE(engine1(), engine2());
 }
 
+TEST(CPUGenerator, TestPhiloxModeEngineInputs) {
+  // Test Description:
+  //   Tests that philox_engine_inputs advances the offset, that seeding
+  //   resets it and that cloning keeps the Philox state.
+  auto gen = at::detail::createCPUGenerator(42);
+  gen->set_philox_mode(true);
+  auto inputs1 = gen->philox_engine_inputs(8);
+  auto inputs2 = gen->philox_engine_inputs(8);
+  ASSERT_EQ(inputs1.first, 42u);
+  ASSERT_EQ(inputs1.second, 0u);
+  ASSERT_EQ(inputs2.second, 8u);
+  auto gen2 = gen->clone();
+  ASSERT_TRUE(gen2->philox_mode());
+  ASSERT_EQ(gen2->philox_offset(), 16u);
+  gen->set_current_seed(42);
+  ASSERT_EQ(gen->philox_offset(), 0u);
+}
+
+TEST(CPUGenerator, TestPhiloxModeReproducibility) {
+  // Test Description:
+  //   Tests that the random ops using Philox give the same numbers for the
+  //   same seed whatever the number of threads, and fresh ones on the next
+  //   call.
+  auto gen = at::detail::createCPUGenerator(123);
+  gen->set_philox_mode(true);
+  const int num_threads = at::get_num_threads();
+  auto sample = [&](int threads) {
+    at::set_num_threads(threads);
+    gen->set_current_seed(123);
+    auto uniform = at::empty({100000}).uniform_(-1, 1, gen.get());
+    auto normal = at::empty({100000}, at::kDouble).normal_(0, 1, gen.get());
+    auto bernoulli = at::empty({100000}).bernoulli_(0.3, gen.get());
+    return std::make_tuple(uniform, normal, bernoulli);
+  };
+  auto serial = sample(1);
+  auto parallel = sample(4);
+  at::set_num_threads(num_threads);
+  ASSERT_TRUE(std::get<0>(serial).equal(std::get<0>(parallel)));
+  ASSERT_TRUE(std::get<1>(serial).equal(std::get<1>(parallel)));
+  ASSERT_TRUE(std::get<2>(serial).equal(std::get<2>(parallel)));
+  ASSERT_FALSE(std::get<0>(serial).equal(at::empty({100000}).uniform_(-1, 1, gen.get())));
+
+  ASSERT_GE(std::get<0>(serial).min().item<float>(), -1);
+  ASSERT_LT(std::get<0>(serial).max().item<float>(), 1);
+  ASSERT_NEAR(std::get<1>(serial).mean().item<double>(), 0, 0.05);
+  ASSERT_NEAR(std::get<1>(serial).std().item<double>(), 1, 0.05);
+  ASSERT_NEAR(std::get<2>(serial).mean().item<float>(), 0.3, 0.05);
+}
+
 /**
  * MT19937 CPU Engine Tests
  */
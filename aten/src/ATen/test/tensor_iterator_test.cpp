@@ -224,3 +224,56 @@ TEST(TensorIteratorTest, FailNonPromotingBinaryOp) {
   iter.add_input(at::ones({1,1}, at::dtype(at::kInt)));
   ASSERT_ANY_THROW(iter.build());
 }
+
+TEST(TensorIteratorTest, PlanCacheReusesPlan) {
+  auto x = at::randn({4, 8}, kCPU).t();
+  auto x_contiguous = x.contiguous();
+  auto y = at::randn({8, 1}, kCPU);
+  auto expected = at::add(x, y);
+
+  at::TensorIteratorPlanCacheGuard guard;
+  at::TensorIteratorPlanCacheGuard::clear();
+  for (int i = 0; i < 3; i++) {
+    Tensor out;
+    auto iter = TensorIterator::binary_op(out, x, y);
+    at::native::cpu_serial_kernel(iter, [](float a, float b) -> float { return a + b; });
+    EXPECT_TRUE(out.strides().equals(expected.strides()));
+    EXPECT_TRUE(out.equal(expected));
+  }
+  EXPECT_EQ(at::TensorIteratorPlanCacheGuard::size(), 1u);
+
+  // a different signature gets its own plan
+  Tensor out;
+  TensorIterator::binary_op(out, x_contiguous, y);
+  EXPECT_EQ(at::TensorIteratorPlanCacheGuard::size(), 2u);
+}
+
+TEST(TensorIteratorTest, PlanCacheSkipsResizes) {
+  auto x = at::ones({5});
+  Tensor out = at::empty({0});
+  Tensor bad = at::empty({5}, kInt);
+
+  at::TensorIteratorPlanCacheGuard guard;
+  at::TensorIteratorPlanCacheGuard::clear();
+  TensorIterator::binary_op(out, x, x);
+  EXPECT_EQ(at::TensorIteratorPlanCacheGuard::size(), 0u);
+  // errors are still raised on every call
+  for (int i = 0; i < 2; i++) {
+    ASSERT_ANY_THROW(TensorIterator::binary_op(bad, x, x));
+  }
+  EXPECT_EQ(at::TensorIteratorPlanCacheGuard::size(), 0u);
+}
+
+TEST(TensorIteratorTest, PlanCacheGuardRestoresState) {
+  EXPECT_FALSE(at::TensorIteratorPlanCacheGuard::is_enabled());
+  {
+    at::TensorIteratorPlanCacheGuard guard;
+    EXPECT_TRUE(at::TensorIteratorPlanCacheGuard::is_enabled());
+    {
+      at::TensorIteratorPlanCacheGuard disable(false);
+      EXPECT_FALSE(at::TensorIteratorPlanCacheGuard::is_enabled());
+    }
+    EXPECT_TRUE(at::TensorIteratorPlanCacheGuard::is_enabled());
+  }
+  EXPECT_FALSE(at::TensorIteratorPlanCacheGuard::is_enabled());
+}
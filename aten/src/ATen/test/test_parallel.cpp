@@ -3,10 +3,18 @@
 #include <ATen/ATen.h>
 #include <ATen/DLConvertor.h>
 #include <ATen/Parallel.h>
+#include <ATen/ThreadAffinity.h>
+#include <c10/util/numa.h>
 
+#include <algorithm>
+#include <atomic>
 #include <iostream>
+#include <mutex>
+#include <set>
 #include <string.h>
 #include <sstream>
+#include <thread>
+#include <vector>
 
 using namespace at;
 
@@ -69,3 +77,126 @@ TEST(TestParallel, IntraOpLaunchFuture) {
 
   ASSERT_TRUE(v1 == 1 && v2 == 2);
 }
+
+TEST(TestParallel, UnevenWork) {
+  // every index is visited exactly once, also when some chunks take much
+  // longer than others
+  const int64_t n = 10000;
+  std::vector<std::atomic<int>> visits(n);
+  for (auto& v : visits) {
+    v = 0;
+  }
+  at::parallel_for(0, n, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; ++i) {
+      if (i < n / 10) {
+        volatile double x = 0;
+        for (int k = 0; k < 1000; ++k) {
+          x = x + k;
+        }
+      }
+      visits[i]++;
+    }
+  });
+  for (int64_t i = 0; i < n; ++i) {
+    ASSERT_EQ(visits[i], 1);
+  }
+
+  auto sum = at::parallel_reduce(0, n, 1, (int64_t)0,
+    [](int64_t begin, int64_t end, int64_t ident) {
+      for (int64_t i = begin; i < end; ++i) {
+        ident += i;
+      }
+      return ident;
+    },
+    [](int64_t a, int64_t b) { return a + b; });
+  ASSERT_EQ(sum, n * (n - 1) / 2);
+}
+
+TEST(TestParallel, IntraOpThreadBudget) {
+  ASSERT_EQ(at::get_intraop_thread_budget(), 0);
+  {
+    at::IntraOpThreadBudgetGuard guard(1);
+    ASSERT_EQ(at::internal::intraop_num_threads(), 1);
+    // with a budget of one thread, everything runs on the calling thread
+    const auto caller = std::this_thread::get_id();
+    std::atomic<bool> same_thread{true};
+    at::parallel_for(0, 1000, 1, [&](int64_t begin, int64_t end) {
+      if (std::this_thread::get_id() != caller) {
+        same_thread = false;
+      }
+    });
+    ASSERT_TRUE(same_thread);
+
+    // inter-op tasks inherit the budget
+    std::atomic<int> launched_budget{-1};
+    auto done = std::make_shared<c10::ivalue::Future>(c10::NoneType::get());
+    at::launch([&launched_budget, done]() {
+      launched_budget = at::get_intraop_thread_budget();
+      done->markCompleted();
+    });
+    done->wait();
+    ASSERT_EQ(launched_budget, 1);
+  }
+  {
+    // a larger budget caps the number of threads of a parallel region
+    at::IntraOpThreadBudgetGuard guard(2);
+    std::mutex mutex;
+    std::set<std::thread::id> threads;
+    at::parallel_for(0, 1000, 1, [&](int64_t begin, int64_t end) {
+      std::lock_guard<std::mutex> lock(mutex);
+      threads.insert(std::this_thread::get_id());
+    });
+    ASSERT_LE(threads.size(), 2);
+  }
+  ASSERT_EQ(at::get_intraop_thread_budget(), 0);
+  ASSERT_ANY_THROW(at::set_intraop_thread_budget(-1));
+}
+
+TEST(TestParallel, ThreadAffinity) {
+  ASSERT_FALSE(at::ThreadAffinity::parse("none").enabled());
+  ASSERT_EQ(at::ThreadAffinity::parse("").cpu(0), -1);
+
+  auto list = at::ThreadAffinity::parse("2-4,7");
+  ASSERT_TRUE(list.enabled());
+  std::vector<int> cpus;
+  for (size_t i = 0; i < 6; ++i) {
+    cpus.push_back(list.cpu(i));
+  }
+  ASSERT_EQ(cpus, std::vector<int>({2, 3, 4, 7, 2, 3}));
+  ASSERT_ANY_THROW(at::ThreadAffinity::parse("4-2"));
+  ASSERT_ANY_THROW(at::ThreadAffinity::parse("first"));
+
+  // both policies use every available CPU once
+  auto available = c10::GetAvailableCPUs();
+  for (const char* policy : {"compact", "scatter"}) {
+    auto affinity = at::ThreadAffinity::parse(policy);
+    std::vector<int> assigned;
+    for (size_t i = 0; i < available.size(); ++i) {
+      assigned.push_back(affinity.cpu(i));
+    }
+    std::sort(assigned.begin(), assigned.end());
+    ASSERT_EQ(assigned, available);
+  }
+}
+
+TEST(TestParallel, IntraOpSpinTime) {
+  const int64_t spin_time_us = at::get_intraop_spin_time_us();
+  ASSERT_GE(spin_time_us, 0);
+  ASSERT_ANY_THROW(at::set_intraop_spin_time_us(-1));
+
+  for (int64_t us : {int64_t(0), int64_t(1000)}) {
+    at::set_intraop_spin_time_us(us);
+    const auto before = at::get_intraop_wakeup_stats();
+    for (int i = 0; i < 100; ++i) {
+      std::atomic<int64_t> sum{0};
+      at::parallel_for(0, 64, 1, [&sum](int64_t begin, int64_t end) {
+        sum += end - begin;
+      });
+      ASSERT_EQ(sum, 64);
+    }
+    const auto after = at::get_intraop_wakeup_stats();
+    ASSERT_GE(after.spin_hits, before.spin_hits);
+    ASSERT_GE(after.parks, before.parks);
+  }
+  at::set_intraop_spin_time_us(spin_time_us);
+}
@@ -4,61 +4,108 @@
 
 
 #include <cuda_runtime_api.h>
+#include <array>
+#include <condition_variable>
+#include <cstdlib>
 #include <deque>
+#include <limits>
 #include <memory>
 #include <mutex>
 #include <stdint.h>
+#include <thread>
 #include <unordered_map>
 #include <unordered_set>
-#include <set>
 #include <utility>
+#include <vector>
 
 namespace {
 
-struct BlockSize
-{
-  size_t  size; // allocation size
-  void*   ptr;  // host memory pointer
+using c10::cuda::CUDACachingAllocator::Stat;
 
-  BlockSize(size_t size, void* ptr=NULL) : size(size), ptr(ptr) {}
-};
+// Blocks are rounded up to a power of two and cached in one bin per power,
+// so that repeated requests of similar sizes (e.g. pinned batches from a
+// data loader) are served in O(1) from the matching bin.
+constexpr size_t kNumBins = 64;
 
-struct Block : public BlockSize
+size_t round_size(size_t size)
 {
-  bool  allocated;    // true if the block is currently allocated
-  int   event_count;  // number of outstanding cuda events
-  std::unordered_set<at::cuda::CUDAStream> streams;
+  size_t rounded = 1;
+  while (rounded < size) {
+    rounded <<= 1;
+  }
+  return rounded;
+}
 
-  Block(size_t size, void* ptr, bool allocated) :
-      BlockSize(size, ptr), allocated(allocated), event_count(0), streams() {}
-};
+size_t bin_index(size_t rounded_size)
+{
+  size_t index = 0;
+  while (((size_t)1 << index) < rounded_size) {
+    index++;
+  }
+  return index;
+}
 
-static bool BlockComparator(const BlockSize& a, const BlockSize& b)
+size_t max_cached_bytes_from_env()
 {
-  // sort by size, break ties with pointer
-  if (a.size != b.size) {
-    return a.size < b.size;
+  const char* env = getenv("PYTORCH_CUDA_HOST_ALLOCATOR_MAX_CACHED_BYTES");
+  if (env == nullptr || *env == '\0') {
+    return std::numeric_limits<size_t>::max();
   }
-  return (uintptr_t)a.ptr < (uintptr_t)b.ptr;
+  return strtoull(env, nullptr, 10);
 }
 
-struct HostAllocator
+void update_stat(Stat& stat, int64_t amount) {
+  stat.current += amount;
+
+  THAssertMsg(stat.current >= 0, "Negative tracked stat in CUDA host allocator (likely logic error).");
+
+  stat.peak = std::max(stat.current, stat.peak);
+  if (amount > 0) {
+    stat.allocated += amount;
+  }
+  if (amount < 0) {
+    stat.freed += -amount;
+  }
+}
+
+struct Block
 {
-  typedef bool (*Comparison)(const BlockSize&, const BlockSize&);
+  size_t size;        // allocation size, a power of two
+  void*  ptr;         // host memory pointer
+  bool   allocated;   // true if the block is currently allocated
+  int    event_count; // number of outstanding cuda events
+  std::unordered_set<at::cuda::CUDAStream> streams;
+
+  Block(size_t size, void* ptr, bool allocated) :
+      size(size), ptr(ptr), allocated(allocated), event_count(0), streams() {}
+};
 
+struct HostAllocator
+{
   // lock around all operations
   std::mutex mutex;
 
   // blocks by pointer
   std::unordered_map<void*, Block> blocks;
 
-  // pointers that are ready to be allocated (event_count=0)
-  std::set<BlockSize, Comparison> available;
+  // pointers that are ready to be allocated (event_count=0), by bin. The most
+  // recently freed block of a bin is handed out first.
+  std::array<std::vector<void*>, kNumBins> available;
+
+  // bytes of the blocks in 'available'
+  size_t cached_bytes = 0;
+
+  // the background trimmer frees cached blocks above this limit
+  size_t max_cached_bytes = max_cached_bytes_from_env();
 
   // outstanding cuda events
   std::deque<std::pair<cudaEvent_t, void*>> cuda_events;
 
-  HostAllocator() : available(BlockComparator) {}
+  THCCachingHostAllocatorStats stats;
+
+  // wakes up the trimmer thread, which is started on first use
+  std::condition_variable trim_cv;
+  bool trim_thread_started = false;
 
   cudaError_t malloc(void** ptr, size_t size)
   {
@@ -70,15 +117,24 @@ struct HostAllocator
       return err;
     }
 
-    // search for the smallest block which can hold this allocation
-    BlockSize search_key(size);
-    auto it = available.lower_bound(search_key);
-    if (it != available.end()) {
-      Block& block = blocks.at(it->ptr);
+    // note that cudaHostAlloc would not touch pointer if size is 0
+    *ptr = 0;
+    if (size == 0) {
+      return cudaSuccess;
+    }
+
+    // reuse the most recently freed block of the same size class
+    const size_t rounded_size = round_size(size);
+    auto& bin = available[bin_index(rounded_size)];
+    if (!bin.empty()) {
+      Block& block = blocks.at(bin.back());
       THAssert(!block.allocated && block.event_count == 0);
+      bin.pop_back();
+      cached_bytes -= block.size;
       block.allocated = true;
       *ptr = block.ptr;
-      available.erase(it);
+      update_stat(stats.allocation, 1);
+      update_stat(stats.allocated_bytes, block.size);
       return cudaSuccess;
     }
 
@@ -93,16 +149,17 @@ struct HostAllocator
       device_guard.reset_device(at::Device(at::DeviceType::CUDA, *primary_ctx_device_index));
     }
 
-    // note that cudaHostAlloc may not touch pointer if size is 0
-    *ptr = 0;
-
     // allocate a new block if no cached allocation is found
-    err = cudaHostAlloc(ptr, size, cudaHostAllocDefault);
+    err = cudaHostAlloc(ptr, rounded_size, cudaHostAllocDefault);
     if (err != cudaSuccess) {
       return err;
     }
 
-    blocks.insert({*ptr, Block(size, *ptr, true)});
+    blocks.insert({*ptr, Block(rounded_size, *ptr, true)});
+    update_stat(stats.segment, 1);
+    update_stat(stats.reserved_bytes, rounded_size);
+    update_stat(stats.allocation, 1);
+    update_stat(stats.allocated_bytes, rounded_size);
     return cudaSuccess;
   }
 
@@ -129,6 +186,8 @@ struct HostAllocator
     // free (on valid memory) shouldn't fail, so mark unallocated before
     // we process the streams.
     block.allocated = false;
+    update_stat(stats.allocation, -1);
+    update_stat(stats.allocated_bytes, -static_cast<int64_t>(block.size));
 
     // insert CUDA events for each stream on which this block was used. This
     err = insertEvents(block);
@@ -138,7 +197,7 @@ struct HostAllocator
 
     if (block.event_count == 0) {
       // the block can be re-used if there are no outstanding cuda events
-      available.insert(block);
+      makeAvailable(block);
     }
     return cudaSuccess;
   }
@@ -185,7 +244,7 @@ struct HostAllocator
       Block& block = blocks.at(e.second);
       block.event_count--;
       if (block.event_count == 0 && !block.allocated) {
-        available.insert(block);
+        makeAvailable(block);
       }
       cuda_events.pop_front();
     }
@@ -210,13 +269,18 @@ struct HostAllocator
     cuda_events.clear();
 
     // clear list of available blocks
-    available.clear();
+    for (auto& bin : available) {
+      bin.clear();
+    }
+    cached_bytes = 0;
 
     // free and erase non-allocated blocks
     for (auto it = blocks.begin(); it != blocks.end();) {
       Block& block = it->second;
       if (!block.allocated) {
         THCudaCheckWarn(cudaFreeHost(block.ptr));
+        update_stat(stats.segment, -1);
+        update_stat(stats.reserved_bytes, -static_cast<int64_t>(block.size));
         it = blocks.erase(it);
       } else {
         ++it;
@@ -224,6 +288,39 @@ struct HostAllocator
     }
   }
 
+  void setMaxCachedBytes(size_t max_bytes)
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    max_cached_bytes = max_bytes;
+    maybeTrim();
+  }
+
+  THCCachingHostAllocatorStats getStats()
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    return stats;
+  }
+
+  void resetAccumulatedStats()
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (Stat* stat : {&stats.allocation, &stats.segment,
+                       &stats.allocated_bytes, &stats.reserved_bytes}) {
+      stat->allocated = 0;
+      stat->freed = 0;
+    }
+    stats.num_trimmed_blocks = 0;
+  }
+
+  void resetPeakStats()
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (Stat* stat : {&stats.allocation, &stats.segment,
+                       &stats.allocated_bytes, &stats.reserved_bytes}) {
+      stat->peak = stat->current;
+    }
+  }
+
   cudaError_t insertEvents(Block& block)
   {
     cudaError_t err;
@@ -251,31 +348,113 @@ struct HostAllocator
     cudaSetDevice(prev_device);
     return err;
   }
+
+ private:
+  // requires mutex to be held
+  void makeAvailable(Block& block)
+  {
+    available[bin_index(block.size)].push_back(block.ptr);
+    cached_bytes += block.size;
+    maybeTrim();
+  }
+
+  // requires mutex to be held
+  void maybeTrim()
+  {
+    if (cached_bytes <= max_cached_bytes) {
+      return;
+    }
+    // cudaFreeHost synchronizes with the device, so leave it to a separate
+    // thread instead of stalling the thread that freed the block.
+    if (!trim_thread_started) {
+      trim_thread_started = true;
+      std::thread(&HostAllocator::trimLoop, this).detach();
+    }
+    trim_cv.notify_one();
+  }
+
+  void trimLoop()
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+      trim_cv.wait(lock, [this] { return cached_bytes > max_cached_bytes; });
+
+      // release the largest cached blocks first
+      std::vector<void*> to_free;
+      for (size_t i = kNumBins; i-- > 0 && cached_bytes > max_cached_bytes;) {
+        auto& bin = available[i];
+        while (!bin.empty() && cached_bytes > max_cached_bytes) {
+          void* ptr = bin.back();
+          bin.pop_back();
+          auto it = blocks.find(ptr);
+          const size_t size = it->second.size;
+          cached_bytes -= size;
+          update_stat(stats.segment, -1);
+          update_stat(stats.reserved_bytes, -static_cast<int64_t>(size));
+          stats.num_trimmed_blocks++;
+          blocks.erase(it);
+          to_free.push_back(ptr);
+        }
+      }
+
+      lock.unlock();
+      for (void* ptr : to_free) {
+        THCudaCheckWarn(cudaFreeHost(ptr));
+      }
+      lock.lock();
+    }
+  }
 };
 
-}  // namespace
+// Leaked on purpose: the trimmer thread is never joined, and pinned tensors
+// may be freed during static destruction.
+HostAllocator& getHostAllocator()
+{
+  static HostAllocator* allocator = new HostAllocator();
+  return *allocator;
+}
 
-static HostAllocator allocator;
+}  // namespace
 
 cudaError_t THCCachingHostAllocator_recordEvent(void *ptr, at::cuda::CUDAStream stream)
 {
-  return allocator.recordEvent(ptr, stream);
+  return getHostAllocator().recordEvent(ptr, stream);
 }
 
 void THCCachingHostAllocator_emptyCache()
 {
-  allocator.emptyCache();
+  getHostAllocator().emptyCache();
+}
+
+void THCCachingHostAllocator_setMaxCachedBytes(size_t max_cached_bytes)
+{
+  getHostAllocator().setMaxCachedBytes(max_cached_bytes);
+}
+
+THCCachingHostAllocatorStats THCCachingHostAllocator_getStats()
+{
+  return getHostAllocator().getStats();
+}
+
+void THCCachingHostAllocator_resetAccumulatedStats()
+{
+  getHostAllocator().resetAccumulatedStats();
+}
+
+void THCCachingHostAllocator_resetPeakStats()
+{
+  getHostAllocator().resetPeakStats();
 }
 
 static void THCCachingHostDeleter(void* ptr) {
-  allocator.free(ptr);
+  getHostAllocator().free(ptr);
 }
 
 struct THCCachingHostAllocator final : public at::Allocator {
   at::DataPtr allocate(size_t size) const override {
     THAssert(size >= 0);
     void *ptr;
-    THCudaCheck(allocator.malloc(&ptr, size));
+    THCudaCheck(getHostAllocator().malloc(&ptr, size));
     return {ptr, ptr, &THCCachingHostDeleter, at::DeviceType::CPU};
   }
   at::DeleterFnPtr raw_deleter() const override {
@@ -4,6 +4,7 @@
 #include <THC/THCGeneral.h>
 
 
+#include <c10/cuda/CUDACachingAllocator.h>
 #include <c10/cuda/CUDAStream.h>
 
 //
@@ -19,7 +20,13 @@
 // copy_from_cpu_async_ and copy_to_cpu_async_.
 //
 // Note that this allocator does not split larger allocations into smaller
-// blocks, unlike the caching device allocator.
+// blocks, unlike the caching device allocator. Instead, requests are rounded
+// up to a power of two and freed blocks are cached in one bin per size class.
+//
+// Cached bytes are unbounded by default. When a cap is set (with
+// THCCachingHostAllocator_setMaxCachedBytes or the environment variable
+// PYTORCH_CUDA_HOST_ALLOCATOR_MAX_CACHED_BYTES), cached blocks above the cap
+// are released by a background thread, largest first.
 //
 THC_API c10::Allocator* getTHCCachingHostAllocator(void);
 
@@ -30,4 +37,28 @@ THC_API cudaError_t THCCachingHostAllocator_recordEvent(void *ptr, at::cuda::CUD
 // Releases cached pinned memory allocations via cudaHostFree
 THC_API void THCCachingHostAllocator_emptyCache(void);
 
+// Sets the number of bytes of freed blocks the allocator may keep cached.
+THC_API void THCCachingHostAllocator_setMaxCachedBytes(size_t max_cached_bytes);
+
+// Summary statistics of the host allocator, following the meaning of the
+// same fields of c10::cuda::CUDACachingAllocator::DeviceStats.
+struct THCCachingHostAllocatorStats {
+  // COUNT: allocations requested by client code
+  c10::cuda::CUDACachingAllocator::Stat allocation;
+  // COUNT: number of allocated segments from cudaHostAlloc().
+  c10::cuda::CUDACachingAllocator::Stat segment;
+
+  // SUM: bytes of allocated blocks (requests rounded up to their size class)
+  c10::cuda::CUDACachingAllocator::Stat allocated_bytes;
+  // SUM: bytes reserved by this memory allocator (both free and used)
+  c10::cuda::CUDACachingAllocator::Stat reserved_bytes;
+
+  // COUNT: number of cached blocks released by the background trimmer
+  int64_t num_trimmed_blocks = 0;
+};
+
+THC_API THCCachingHostAllocatorStats THCCachingHostAllocator_getStats(void);
+THC_API void THCCachingHostAllocator_resetAccumulatedStats(void);
+THC_API void THCCachingHostAllocator_resetPeakStats(void);
+
 #endif
@@ -0,0 +1,254 @@
+"""Benchmark of the collectives of the c10d process groups.
+
+Measures the latency and the bandwidth of allreduce, allgather and broadcast,
+and of the coalesced variants of allreduce and allgather, across message sizes
+and tensor counts, through the ProcessGroup API used by torch.distributed.
+
+The bandwidths reported are the ones of nccl-tests:
+
+    algbw = size / time
+    busbw = algbw * factor
+
+where size is the message size per rank, and factor, 2 (n - 1) / n for
+allreduce, (n - 1) / n for allgather and 1 for broadcast on n ranks, makes the
+bus bandwidth comparable to the peak bandwidth of the links whatever the
+collective and the number of ranks.
+
+Run it on one machine with:
+
+    python -m benchmarks.distributed.bench_collectives --backend gloo --nprocs 4
+
+or on several machines with torch.distributed.launch, or with mpirun for the
+MPI backend.
+"""
+from __future__ import absolute_import, division, print_function, unicode_literals
+
+import argparse
+import json
+import os
+import sys
+import timeit
+
+import torch
+import torch.distributed as dist
+import torch.multiprocessing as mp
+
+
+COLLECTIVES = [
+    'allreduce', 'allreduce_coalesced', 'allgather', 'allgather_coalesced',
+    'broadcast',
+]
+
+
+def bus_factor(collective, world_size):
+    if collective.startswith('allreduce'):
+        return 2.0 * (world_size - 1) / world_size
+    if collective.startswith('allgather'):
+        return (world_size - 1) / world_size
+    return 1.0
+
+
+def parse_size(size):
+    """ Parses a size in bytes such as 4096, 64K or 16M """
+    units = {'K': 2 ** 10, 'M': 2 ** 20, 'G': 2 ** 30}
+    if size[-1].upper() in units:
+        return int(size[:-1]) * units[size[-1].upper()]
+    return int(size)
+
+
+def format_size(nbytes):
+    for unit, scale in (('G', 2 ** 30), ('M', 2 ** 20), ('K', 2 ** 10)):
+        if nbytes >= scale and nbytes % scale == 0:
+            return '%d%s' % (nbytes // scale, unit)
+    return str(nbytes)
+
+
+def make_tensors(nbytes, ntensors, dtype, device, flat):
+    """ Splits a message of nbytes into ntensors tensors. With flat, they are
+        views of a single buffer, which the coalesced collectives of the MPI
+        and NCCL process groups reduce in place rather than copying them.
+    """
+    numel = max(nbytes // torch.tensor([], dtype=dtype).element_size(), ntensors)
+    sizes = [numel // ntensors] * ntensors
+    sizes[-1] += numel - sum(sizes)
+    if flat:
+        return list(torch.ones(numel, dtype=dtype, device=device).split(sizes))
+    return [torch.ones(size, dtype=dtype, device=device) for size in sizes]
+
+
+def collective_fn(collective, tensors, world_size):
+    """ Returns a function running the collective on tensors, one call per
+        tensor for the uncoalesced ones, the way gradients are reduced without
+        bucketing.
+    """
+    if collective == 'allreduce':
+        def fn():
+            return [dist.all_reduce(t, async_op=True) for t in tensors]
+    elif collective == 'allreduce_coalesced':
+        def fn():
+            return [dist.all_reduce_coalesced(tensors, async_op=True)]
+    elif collective == 'allgather':
+        outputs = [[torch.empty_like(t) for _ in range(world_size)]
+                   for t in tensors]
+
+        def fn():
+            return [dist.all_gather(output, t, async_op=True)
+                    for output, t in zip(outputs, tensors)]
+    elif collective == 'allgather_coalesced':
+        outputs = [[torch.empty_like(t) for t in tensors]
+                   for _ in range(world_size)]
+
+        def fn():
+            return [dist.all_gather_coalesced(outputs, tensors, async_op=True)]
+    elif collective == 'broadcast':
+        def fn():
+            return [dist.broadcast(t, 0, async_op=True) for t in tensors]
+    else:
+        raise ValueError('Unknown collective: ' + collective)
+    return fn
+
+
+def synchronize(device):
+    if device.type == 'cuda':
+        torch.cuda.synchronize(device)
+
+
+def time_collective(fn, device, warmup, iters):
+    """ Returns the times (unit: us) of iters runs of fn, each one waited for """
+    for _ in range(warmup):
+        for work in fn():
+            work.wait()
+    synchronize(device)
+    dist.barrier()
+
+    times = []
+    for _ in range(iters):
+        start = timeit.default_timer()
+        for work in fn():
+            work.wait()
+        synchronize(device)
+        times.append((timeit.default_timer() - start) * 1e6)
+    return times
+
+
+def max_across_ranks(values, device):
+    """ The slowest rank bounds the collective: reduce the stats with MAX """
+    tensor = torch.tensor(values, dtype=torch.float64, device=device)
+    dist.all_reduce(tensor, op=dist.ReduceOp.MAX)
+    return tensor.tolist()
+
+
+def run_benchmarks(args, device):
+    rank = dist.get_rank()
+    world_size = dist.get_world_size()
+    dtype = getattr(torch, args.dtype)
+    results = []
+    if rank == 0:
+        print('# backend %s, %d ranks, device %s, dtype %s' % (
+            dist.get_backend(), world_size, device.type, args.dtype))
+        print('%-20s %8s %8s %12s %12s %12s %10s %10s' % (
+            'collective', 'size', 'tensors', 'avg(us)', 'p50(us)', 'max(us)',
+            'algbw(GB/s)', 'busbw(GB/s)'))
+    for collective in args.collectives:
+        for ntensors in args.num_tensors:
+            for size in args.sizes:
+                nbytes = parse_size(size)
+                tensors = make_tensors(nbytes, ntensors, dtype, device, args.flat)
+                nbytes = sum(t.numel() * t.element_size() for t in tensors)
+                fn = collective_fn(collective, tensors, world_size)
+                times = sorted(time_collective(fn, device, args.warmup, args.iters))
+                avg_us, p50_us, max_us = max_across_ranks(
+                    [sum(times) / len(times), times[len(times) // 2], times[-1]],
+                    device)
+                algbw = nbytes / p50_us / 1e3
+                busbw = algbw * bus_factor(collective, world_size)
+                result = {
+                    'collective': collective,
+                    'bytes': nbytes,
+                    'num_tensors': ntensors,
+                    'avg_us': avg_us,
+                    'p50_us': p50_us,
+                    'max_us': max_us,
+                    'algbw_gbps': algbw,
+                    'busbw_gbps': busbw,
+                }
+                results.append(result)
+                if rank == 0:
+                    print('%-20s %8s %8d %12.1f %12.1f %12.1f %10.3f %10.3f' % (
+                        collective, format_size(nbytes), ntensors, avg_us,
+                        p50_us, max_us, algbw, busbw))
+                    sys.stdout.flush()
+    return results
+
+
+def get_device(args, local_rank):
+    if args.device == 'cuda':
+        torch.cuda.set_device(local_rank % torch.cuda.device_count())
+        return torch.device('cuda', torch.cuda.current_device())
+    return torch.device('cpu')
+
+
+def worker(local_rank, args):
+    if args.backend == 'mpi':
+        dist.init_process_group('mpi')
+        local_rank = int(os.environ.get('OMPI_COMM_WORLD_LOCAL_RANK', local_rank))
+    elif args.nprocs:
+        dist.init_process_group(args.backend, init_method=args.init_method,
+                                rank=local_rank, world_size=args.nprocs)
+    else:
+        dist.init_process_group(args.backend, init_method='env://')
+        local_rank = int(os.environ.get('LOCAL_RANK', args.local_rank))
+
+    results = run_benchmarks(args, get_device(args, local_rank))
+    if dist.get_rank() == 0 and args.output:
+        with open(args.output, 'w') as f:
+            json.dump({
+                'backend': dist.get_backend(),
+                'world_size': dist.get_world_size(),
+                'device': args.device,
+                'dtype': args.dtype,
+                'results': results,
+            }, f, indent=2)
+    dist.destroy_process_group()
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description='Benchmark the collectives of the c10d process groups')
+    parser.add_argument('--backend', default='gloo', choices=['gloo', 'nccl', 'mpi'])
+    parser.add_argument('--device', default=None, choices=['cpu', 'cuda'],
+                        help='Device of the tensors, cuda for nccl and cpu '
+                        'otherwise by default')
+    parser.add_argument('--collectives', nargs='*', default=COLLECTIVES,
+                        choices=COLLECTIVES)
+    parser.add_argument('--sizes', nargs='*',
+                        default=['4', '1K', '64K', '1M', '16M', '64M'],
+                        help='Message sizes per rank in bytes, K, M or G suffixed')
+    parser.add_argument('--num_tensors', nargs='*', type=int, default=[1, 16],
+                        help='Number of tensors the message is split into')
+    parser.add_argument('--flat', action='store_true',
+                        help='Make the tensors of a message views of one buffer')
+    parser.add_argument('--dtype', default='float32')
+    parser.add_argument('--warmup', default=5, type=int)
+    parser.add_argument('--iters', default=20, type=int)
+    parser.add_argument('--nprocs', default=0, type=int,
+                        help='Spawn this many ranks on this machine rather than '
+                        'reading them from the environment of torch.distributed.launch')
+    parser.add_argument('--init_method', default='tcp://127.0.0.1:29500',
+                        help='Rendezvous of the ranks spawned with --nprocs')
+    parser.add_argument('--local_rank', default=0, type=int,
+                        help='Set by torch.distributed.launch')
+    parser.add_argument('--output', default=None,
+                        help='Write the results of rank 0 as JSON to this file')
+    args = parser.parse_args()
+    if args.device is None:
+        args.device = 'cuda' if args.backend == 'nccl' else 'cpu'
+
+    if args.nprocs and args.backend != 'mpi':
+        mp.spawn(worker, args=(args,), nprocs=args.nprocs)
+    else:
+        worker(args.local_rank, args)
+
+
+if __name__ == '__main__':
+    main()
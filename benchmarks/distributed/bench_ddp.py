@@ -0,0 +1,250 @@
+"""End to end benchmark of DistributedDataParallel.
+
+Trains the models of benchmarks/training_step with DistributedDataParallel on
+1, 2, 4, ... up to all the ranks, and reports for each world size the step
+time, the throughput, the scaling efficiency against a single rank, and how
+the gradient reductions overlap with the backward pass, from the bucket times
+the Reducer of DistributedDataParallel records (see Reducer.set_bucket_timing):
+
+    ready:   the time the last gradient of a bucket was ready
+    launch:  the time the reduction of the bucket was launched
+    finish:  the time the reduction of the bucket was seen finished
+
+all relative to the end of the forward pass. The communication time is the
+union of the [launch, finish] intervals of the buckets, the hidden part of it
+is the part before the last gradient was ready, the end of the backward pass.
+
+Run it with one rank per GPU with torch.distributed.launch:
+
+    python -m torch.distributed.launch --nproc_per_node=8 \\
+        -m benchmarks.distributed.bench_ddp --models resnet50
+
+or on a single machine with --nprocs.
+"""
+from __future__ import absolute_import, division, print_function, unicode_literals
+
+import argparse
+import json
+import os
+import sys
+import timeit
+
+import torch
+import torch.distributed as dist
+import torch.multiprocessing as mp
+from torch.nn.parallel import DistributedDataParallel
+
+from benchmarks.training_step.runner import model_creators
+
+
+def world_sizes(max_size):
+    sizes = []
+    size = 1
+    while size < max_size:
+        sizes.append(size)
+        size *= 2
+    return sizes + [max_size]
+
+
+def union_length(intervals, end=None):
+    """ Length of the union of intervals, clipped at end if given """
+    total = 0
+    last = None
+    for start, stop in sorted(intervals):
+        if end is not None:
+            stop = min(stop, end)
+        if last is not None:
+            start = max(start, last)
+        if stop > start:
+            total += stop - start
+        last = stop if last is None else max(last, stop)
+    return total
+
+
+def overlap_stats(reducer):
+    """ Returns the communication time (unit: ms) of the last backward pass,
+        the part hidden behind it, and the times of its buckets.
+    """
+    buckets = [(b.ready_ns, b.launch_ns, b.finish_ns)
+               for b in reducer.get_bucket_stats()]
+    backward_end = max(reducer.get_backward_stats()[0])
+    intervals = [(launch, finish) for _, launch, finish in buckets]
+    comm = union_length(intervals)
+    hidden = union_length(intervals, end=backward_end)
+    return comm / 1e6, hidden / 1e6, buckets
+
+
+def synchronize(device):
+    if device.type == 'cuda':
+        torch.cuda.synchronize(device)
+
+
+def train_steps(modeldef, ddp, device, nsteps, timing):
+    times = []
+    comm_ms = []
+    hidden_ms = []
+    buckets = []
+    for _ in range(nsteps):
+        synchronize(device)
+        start = timeit.default_timer()
+        modeldef.optimizer.zero_grad()
+        loss = modeldef.loss_fn(ddp(*modeldef.inputs))
+        loss.backward()
+        modeldef.optimizer.step()
+        synchronize(device)
+        times.append((timeit.default_timer() - start) * 1e3)
+        if timing:
+            comm, hidden, bucket_times = overlap_stats(ddp.reducer)
+            comm_ms.append(comm)
+            hidden_ms.append(hidden)
+            buckets.append(bucket_times)
+    return times, comm_ms, hidden_ms, buckets
+
+
+def mean(values):
+    return sum(values) / len(values) if values else float('nan')
+
+
+def bench_world_size(name, args, device, group, size):
+    """ Trains name on the first size ranks, returns the stats of rank 0 """
+    torch.manual_seed(args.seed)
+    modeldef = model_creators[name](device=device, miniBatch=args.miniBatch,
+                                    seqLength=args.seqLength)
+    device_ids = [device.index] if device.type == 'cuda' else None
+    ddp = DistributedDataParallel(modeldef.model, device_ids=device_ids,
+                                  process_group=group,
+                                  bucket_cap_mb=args.bucket_cap_mb)
+
+    train_steps(modeldef, ddp, device, args.warmup, False)
+    ddp.reducer.set_bucket_timing(not args.no_timing)
+    times, comm_ms, hidden_ms, buckets = train_steps(
+        modeldef, ddp, device, args.nloops, not args.no_timing)
+
+    # The slowest rank sets the pace, report its step time
+    step = torch.tensor([mean(times)], device=device)
+    dist.all_reduce(step, op=dist.ReduceOp.MAX, group=group)
+    step_ms = step.item()
+    result = {
+        'model': name,
+        'world_size': size,
+        'step_ms': step_ms,
+        'samples_per_sec': size * args.miniBatch * 1e3 / step_ms,
+        'comm_ms': mean(comm_ms),
+        'hidden_ms': mean(hidden_ms),
+        'hidden_fraction': mean(hidden_ms) / mean(comm_ms) if comm_ms else None,
+    }
+    if buckets:
+        # Average the times of each bucket over the steps
+        result['buckets'] = [
+            {key: mean([step_buckets[i][k] for step_buckets in buckets]) / 1e6
+             for k, key in enumerate(('ready_ms', 'launch_ms', 'finish_ms'))}
+            for i in range(len(buckets[0]))]
+    return result
+
+
+def print_result(result, baseline, details):
+    efficiency = result['samples_per_sec'] / (
+        baseline['samples_per_sec'] * result['world_size'])
+    result['scaling_efficiency'] = efficiency
+    hidden = result['hidden_fraction']
+    print('%-14s %6d %10.2f %12.1f %10.1f%% %10.2f %10s' % (
+        result['model'], result['world_size'], result['step_ms'],
+        result['samples_per_sec'], 100 * efficiency, result['comm_ms'],
+        'n/a' if hidden is None else '%.1f%%' % (100 * hidden)))
+    if details and 'buckets' in result:
+        for i, bucket in enumerate(result['buckets']):
+            print('    bucket %3d  ready %8.2f  launch %8.2f  finish %8.2f  ms' % (
+                i, bucket['ready_ms'], bucket['launch_ms'], bucket['finish_ms']))
+    sys.stdout.flush()
+
+
+def run(args, device):
+    rank = dist.get_rank()
+    results = []
+    if rank == 0:
+        print('# backend %s, %d ranks, device %s, batch %d per rank' % (
+            dist.get_backend(), dist.get_world_size(), device.type, args.miniBatch))
+        print('%-14s %6s %10s %12s %11s %10s %10s' % (
+            'model', 'ranks', 'step(ms)', 'samples/s', 'efficiency',
+            'comm(ms)', 'hidden'))
+    sizes = [s for s in world_sizes(dist.get_world_size())
+             if not args.world_sizes or s in args.world_sizes]
+    # Every rank has to take part in creating every group
+    groups = [dist.new_group(list(range(size))) for size in sizes]
+    for name in args.models:
+        baseline = None
+        for size, group in zip(sizes, groups):
+            if rank < size:
+                result = bench_world_size(name, args, device, group, size)
+                if rank == 0:
+                    baseline = baseline or result
+                    print_result(result, baseline, args.bucket_details)
+                    results.append(result)
+            dist.barrier()
+    return results
+
+
+def worker(local_rank, args):
+    if args.nprocs:
+        dist.init_process_group(args.backend, init_method=args.init_method,
+                                rank=local_rank, world_size=args.nprocs)
+    else:
+        dist.init_process_group(args.backend, init_method='env://')
+        local_rank = int(os.environ.get('LOCAL_RANK', args.local_rank))
+    if args.device == 'cuda':
+        torch.cuda.set_device(local_rank % torch.cuda.device_count())
+        device = torch.device('cuda', torch.cuda.current_device())
+    else:
+        device = torch.device('cpu')
+
+    results = run(args, device)
+    if dist.get_rank() == 0 and args.output:
+        with open(args.output, 'w') as f:
+            json.dump(results, f, indent=2)
+    dist.destroy_process_group()
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description='Benchmark the scaling of DistributedDataParallel')
+    parser.add_argument('--models', nargs='*', default=['resnet50', 'transformer'],
+                        choices=sorted(model_creators.keys()))
+    parser.add_argument('--backend', default='nccl', choices=['gloo', 'nccl'])
+    parser.add_argument('--device', default=None, choices=['cpu', 'cuda'],
+                        help='cpu for gloo and cuda for nccl by default')
+    parser.add_argument('--world_sizes', nargs='*', type=int, default=None,
+                        help='Subset of the sizes 1, 2, 4, ... and the number '
+                        'of ranks to run on, all of them by default')
+    parser.add_argument('--miniBatch', default=32, type=int,
+                        help='Batch size per rank')
+    parser.add_argument('--seqLength', default=64, type=int,
+                        help='Sequence length of the transformer')
+    parser.add_argument('--bucket_cap_mb', default=25, type=int)
+    parser.add_argument('--warmup', default=5, type=int)
+    parser.add_argument('--nloops', default=20, type=int)
+    parser.add_argument('--seed', default=0, type=int)
+    parser.add_argument('--no_timing', action='store_true',
+                        help='Do not record the bucket times')
+    parser.add_argument('--bucket_details', action='store_true',
+                        help='Print the average times of each bucket')
+    parser.add_argument('--nprocs', default=0, type=int,
+                        help='Spawn this many ranks on this machine rather than '
+                        'reading them from the environment of torch.distributed.launch')
+    parser.add_argument('--init_method', default='tcp://127.0.0.1:29500',
+                        help='Rendezvous of the ranks spawned with --nprocs')
+    parser.add_argument('--local_rank', default=0, type=int,
+                        help='Set by torch.distributed.launch')
+    parser.add_argument('--output', default=None,
+                        help='Write the results of rank 0 as JSON to this file')
+    args = parser.parse_args()
+    if args.device is None:
+        args.device = 'cpu' if args.backend == 'gloo' else 'cuda'
+
+    if args.nprocs:
+        mp.spawn(worker, args=(args,), nprocs=args.nprocs)
+    else:
+        worker(args.local_rank, args)
+
+
+if __name__ == '__main__':
+    main()
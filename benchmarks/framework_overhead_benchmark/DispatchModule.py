@@ -0,0 +1,18 @@
+from __future__ import absolute_import, division, print_function, unicode_literals
+import torch
+from utils import NUM_LOOP_ITERS
+
+def is_same_size_loop(x, y):
+    # is_same_size does next to no work, so the time per call is mostly
+    # the binding and dispatcher overhead.
+    for i in range(NUM_LOOP_ITERS):
+        torch.is_same_size(x, y)
+    return x
+
+class DispatchModule(torch.nn.Module):
+    def __init__(self, op):
+        super(DispatchModule, self).__init__()
+        self.op = op
+
+    def forward(self, x, y):
+        return self.op(x, y)
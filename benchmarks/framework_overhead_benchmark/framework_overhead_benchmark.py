@@ -1,14 +1,19 @@
 from __future__ import absolute_import, division, print_function, unicode_literals
-from utils import ms_to_us, benchmark_module, BenchmarkConfig, ModuleConfig
+from utils import ms_to_us, benchmark_module, BenchmarkConfig, ModuleConfig, NUM_LOOP_ITERS
 import argparse
 from C2Module import C2SimpleNet
 
-from SimpleAddModule import SimpleAddModule, add_tensors_loop
+import torch
+from SimpleAddModule import SimpleAddModule, add_tensors_loop, add_tensors
+from DispatchModule import DispatchModule, is_same_size_loop
 from pt_wrapper_module import WrapperModule
 
 """ Framework overhead benchmark script.
 Benchmark framework overhead.
-Currently supported ops: add.
+Currently supported ops: add, dispatch (an op that does no work, which tracks
+the per-call overhead of the dispatcher; eager mode only), call (a single add
+per call of the graph, which tracks the per-call overhead of the graph
+executor; graph mode only).
 As of now runs only forward pass.
 Supports both graph mode and eager mode. In graph mode the module is traced via JIT tracing.
 Debug option prints the traced graph is graph_mode is enabled.
@@ -19,12 +24,21 @@ buck run @mode/opt <path-to-framework_overhead_benchmark>:framework_overhead_ben
  --add_op --graph_mode --eager_mode (Runs both graph mode and eager mode)
 buck run @mode/opt <path-to-framework_overhead_benchmark>:framework_overhead_benchmark --
  --add_op --graph_mode (Runs only graph mode)
+To run the dispatch overhead benchmark:
+buck run @mode/opt <path-to-framework_overhead_benchmark>:framework_overhead_benchmark --
+ --op dispatch_op --eager_mode
+To run the graph executor call overhead benchmark, with the legacy executor:
+buck run @mode/opt <path-to-framework_overhead_benchmark>:framework_overhead_benchmark --
+ --op call_op --legacy_executor
 To run C2 benchmark:
 buck run @mode/opt <path-to-framework_overhead_benchmark>:framework_overhead_benchmark --
  --add_op --benchmark_c2_net
+The overhead of each layer of an op call below Python (dispatcher, autograd
+wrapping, RecordFunction, JIT interpreter) is measured by the C++ benchmark
+binaries/framework_overhead_benchmark.cc, built with BUILD_TEST.
 """
 
-SUPPORTED_OPS = {"add_op"}
+SUPPORTED_OPS = {"add_op", "dispatch_op", "call_op"}
 
 def parse_op_args(op):
     op_list = ops.split(",")
@@ -35,7 +49,7 @@ def print_results(result):
         print("{}, latency per iter (us):{}".format(key, ms_to_us(value)))
     print("===================================")
 
-def benchmark_simple_fn(args, config, module_config, module_type, result):
+def benchmark_simple_fn(args, config, module_config, module_type, result, num_loop_iters=NUM_LOOP_ITERS):
     """ Benchmarks a PyTorch traceable function specified in the config.
     Instantiates a wrapper object that wraps the object of module_type and runs the forward
     method using benchmark_module.
@@ -45,6 +59,7 @@ def benchmark_simple_fn(args, config, module_config, module_type, result):
                     and wether graph mode is enabled or not.
         module_type:    Type of the module to be wrapped. e.g. SimpleAddModule for add op.
         result:         dictionary instance to be populated with the benchmark result (latency per iter).
+        num_loop_iters: number of iterations pt_fn loops for in a single call.
     """
     benchmark_c2_net = args.benchmark_c2_net
     print("Benchmarking {}".format(module_type.__name__))
@@ -59,7 +74,7 @@ def benchmark_simple_fn(args, config, module_config, module_type, result):
         graph_mode_str = "Graph mode" + ":" + str(module_config.graph_mode)
         result_key = ','.join((f_name, graph_mode_str))
         module = WrapperModule(module_type, module_config, args.debug, args.save)
-        latency_per_iter_ms = benchmark_module(config, module, args.use_throughput_benchmark)
+        latency_per_iter_ms = benchmark_module(config, module, args.use_throughput_benchmark, num_loop_iters)
         result[result_key] = latency_per_iter_ms
 
 def main():
@@ -70,6 +85,7 @@ def main():
     parser.add_argument("--debug", default=False, dest="debug", action="store_true")
     parser.add_argument("--save", default=False, dest="save", action="store_true")
     parser.add_argument("--eager_mode", default=False, dest="eager_mode", action="store_true")
+    parser.add_argument("--legacy_executor", default=False, dest="legacy_executor", action="store_true")
     parser.add_argument("--num_warmup_iters", type=int, default=100)
     parser.add_argument("--num_iters", type=int, default=1000)
     args = parser.parse_args()
@@ -86,6 +102,8 @@ def main():
     graph_mode = True
     if args.eager_mode:
         graph_mode = False
+    if args.legacy_executor:
+        torch._C._jit_set_profiling_executor(False)
     result = {}
     if args.op == "add_op":
         num_params = 2
@@ -94,6 +112,18 @@ def main():
         else:
             module_config = ModuleConfig(add_tensors_loop, None, num_params, graph_mode)
         benchmark_simple_fn(args, config, module_config, SimpleAddModule, result)
+    elif args.op == "dispatch_op":
+        assert not args.benchmark_c2_net and not graph_mode, \
+            "dispatch_op is only supported for PyTorch in eager mode"
+        num_params = 2
+        module_config = ModuleConfig(is_same_size_loop, None, num_params, graph_mode)
+        benchmark_simple_fn(args, config, module_config, DispatchModule, result)
+    elif args.op == "call_op":
+        assert not args.benchmark_c2_net and graph_mode, \
+            "call_op is only supported for PyTorch in graph mode"
+        num_params = 2
+        module_config = ModuleConfig(add_tensors, None, num_params, graph_mode)
+        benchmark_simple_fn(args, config, module_config, SimpleAddModule, result, num_loop_iters=1)
     print_results(result)
 
 if __name__ == "__main__":
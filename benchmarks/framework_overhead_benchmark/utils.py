@@ -16,20 +16,22 @@ def secs_to_us(time_s):
 def secs_to_ms(time_s):
     return (time_s * 1e3)
 
-def benchmark_using_throughput_benchmark(config, module):
+def benchmark_using_throughput_benchmark(config, module, num_loop_iters=NUM_LOOP_ITERS):
     print("Benchmarking via ThroughputBenchmark")
     bench = ThroughputBenchmark(module.module)
     bench.add_input(*module.tensor_inputs)
     stats = bench.benchmark(1, config.num_warmup_iters, config.num_iters)
-    return stats.latency_avg_ms / NUM_LOOP_ITERS
+    return stats.latency_avg_ms / num_loop_iters
 
-def benchmark_module(config, module, use_throughput_benchmark=False):
+# num_loop_iters is the number of iterations the benchmarked function loops
+# for, in a single call
+def benchmark_module(config, module, use_throughput_benchmark=False, num_loop_iters=NUM_LOOP_ITERS):
     if use_throughput_benchmark:
-        return benchmark_using_throughput_benchmark(config, module)
+        return benchmark_using_throughput_benchmark(config, module, num_loop_iters)
     module.forward(config.num_warmup_iters)
     print("Running module for {} iterations".format(config.num_iters))
     start = time.time()
     module.forward(config.num_iters)
     end = time.time()
     time_elapsed_s = (end - start)
-    return (secs_to_ms(time_elapsed_s) / config.num_iters / NUM_LOOP_ITERS)
+    return (secs_to_ms(time_elapsed_s) / config.num_iters / num_loop_iters)
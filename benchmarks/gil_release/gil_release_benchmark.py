@@ -0,0 +1,98 @@
+from __future__ import absolute_import, division, print_function, unicode_literals
+import argparse
+import os
+import tempfile
+import threading
+import time
+
+import torch
+
+""" GIL release benchmark script.
+Measures how loading and saving models scale with the number of Python threads
+doing it concurrently, which they only do if the C++ entry points they spend
+their time in release the GIL.
+Currently supported entry points: torch.save and torch.load of a state dict
+(storage file reads and writes), torch.jit.save and torch.jit.load of a scripted
+module, and a call to a scripted module doing a matrix multiplication.
+Example run:
+python gil_release_benchmark.py --threads 1 2 4 8
+python gil_release_benchmark.py --entry_points jit_load --threads 1 4
+"""
+
+
+class Model(torch.nn.Module):
+    def __init__(self, size, layers):
+        super(Model, self).__init__()
+        self.layers = torch.nn.ModuleList([torch.nn.Linear(size, size) for _ in range(layers)])
+
+    def forward(self, x):
+        for layer in self.layers:
+            x = layer(x)
+        return x
+
+
+def make_entry_points(args, directory):
+    model = Model(args.size, args.layers)
+    scripted = torch.jit.script(model)
+    state_path = os.path.join(directory, 'state.pt')
+    script_path = os.path.join(directory, 'script.pt')
+    torch.save(model.state_dict(), state_path)
+    torch.jit.save(scripted, script_path)
+    x = torch.randn(args.size, args.size)
+
+    def save(i):
+        torch.save(model.state_dict(), os.path.join(directory, 'save{}.pt'.format(i)))
+
+    def jit_save(i):
+        torch.jit.save(scripted, os.path.join(directory, 'jit_save{}.pt'.format(i)))
+
+    return {
+        'save': save,
+        'load': lambda i: torch.load(state_path),
+        'jit_save': jit_save,
+        'jit_load': lambda i: torch.jit.load(script_path),
+        'jit_call': lambda i: scripted(x),
+    }
+
+
+def run(fn, num_threads, iters):
+    def worker(i):
+        for _ in range(iters):
+            fn(i)
+
+    threads = [threading.Thread(target=worker, args=(i,)) for i in range(num_threads)]
+    start = time.time()
+    for thread in threads:
+        thread.start()
+    for thread in threads:
+        thread.join()
+    return time.time() - start
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Multi-threaded load, save and call benchmark")
+    parser.add_argument('--entry_points', nargs='+', default=['save', 'load', 'jit_save', 'jit_load', 'jit_call'])
+    parser.add_argument('--threads', type=int, nargs='+', default=[1, 2, 4, 8])
+    parser.add_argument('--iters', type=int, default=10, help='calls per thread')
+    parser.add_argument('--size', type=int, default=1024, help='size of the linear layers')
+    parser.add_argument('--layers', type=int, default=16, help='number of linear layers')
+    args = parser.parse_args()
+
+    # One intra-op thread, so that the scaling measured is the one of Python threads
+    torch.set_num_threads(1)
+    directory = tempfile.mkdtemp()
+    entry_points = make_entry_points(args, directory)
+    for name in args.entry_points:
+        fn = entry_points[name]
+        fn(0)  # warm up
+        base = None
+        for num_threads in args.threads:
+            elapsed = run(fn, num_threads, args.iters)
+            throughput = num_threads * args.iters / elapsed
+            base = base or throughput
+            print("{:>8}: {:>2} threads, {:8.2f} calls/s, {:5.2f}x".format(
+                name, num_threads, throughput, throughput / base))
+
+
+if __name__ == '__main__':
+    main()
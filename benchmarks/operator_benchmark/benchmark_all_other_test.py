@@ -6,8 +6,8 @@ from __future__ import unicode_literals
 import operator_benchmark as op_bench
 from pt import ( # noqa
     add_test, batchnorm_test, cat_test, chunk_test, conv_test,  # noqa
-    gather_test, linear_test, matmul_test, pool_test,  # noqa
-    softmax_test, split_test, fill_test, as_strided_test,  # noqa
+    gather_test, index_select_test, linear_test, matmul_test, pool_test,  # noqa
+    softmax_test, split_test, sum_test, fill_test, as_strided_test,  # noqa
     embeddingbag_test  # noqa
 )
 
@@ -28,6 +28,7 @@ class Caffe2BenchmarkBase(object):
         self.user_provided_name = None
         self._num_inputs_require_grads = 0
         self._pass_count = 0
+        self._blob_bytes = {}
 
     def _set_backward_test(self, is_backward):
         pass
@@ -58,10 +59,32 @@ class Caffe2BenchmarkBase(object):
         blob_name = 'blob_' + str(Caffe2BenchmarkBase.tensor_index)
         dev = self._device_option(device)
         with core.DeviceScope(dev):
-            workspace.FeedBlob(blob_name, benchmark_utils.numpy_random(dtype, *shapes))
+            data = benchmark_utils.numpy_random(dtype, *shapes)
+            workspace.FeedBlob(blob_name, data)
+        self._blob_bytes[blob_name] = data.nbytes
         Caffe2BenchmarkBase.tensor_index += 1
         return blob_name
 
+    def bytes_moved(self):
+        """ Number of bytes read and written by one run of the operator, which
+            --roofline uses to report the achieved memory bandwidth. None if
+            the benchmark doesn't declare it.
+        """
+        return None
+
+    def flops(self):
+        """ Number of floating point operations done by one run of the
+            operator, which --roofline uses to report the achieved GFLOP/s.
+            None if the benchmark doesn't declare it.
+        """
+        return None
+
+    def tensor_bytes(self, *blob_names):
+        """ Total size in bytes of the given blobs created by tensor, to
+            implement bytes_moved
+        """
+        return sum(self._blob_bytes[name] for name in blob_names)
+
     def module_name(self):
         """ this is used to label the operator being benchmarked
         """
@@ -27,9 +27,9 @@ This module contains core functionalities for performance microbenchmark tests.
 This is used to store configs of tests
 An example input is:
 TestConfig(test_name='add_M8_N2_K1', input_config='M: 8, N: 2, K: 1',
-    tag='long', run_backward=False)
+    tag='long', run_backward=False, attrs={'M': '8', 'N': '2', 'K': '1'})
 """
-TestConfig = namedtuple("TestConfig", "test_name input_config tag run_backward")
+TestConfig = namedtuple("TestConfig", "test_name input_config tag run_backward attrs")
 
 
 BENCHMARK_TESTER = []
@@ -66,7 +66,7 @@ def _create_test(bench_op_obj, orig_test_attrs, tags, OperatorTestCase, run_back
         # When auto_set is used, the test name needs to include input.
         test_attrs.update({'bwd': bwd_input})
     test_name = bench_op_obj.test_name(**test_attrs)
-    test_config = TestConfig(test_name, input_config, tags, run_backward)
+    test_config = TestConfig(test_name, input_config, tags, run_backward, test_attrs)
     return OperatorTestCase(bench_op_obj, test_config)
 
 def _build_test(configs, bench_op, OperatorTestCase, run_backward, op_name_function=None):
@@ -149,6 +149,47 @@ def _build_test(configs, bench_op, OperatorTestCase, run_backward, op_name_funct
             yield _create_test(new_op, test_attrs, tags, OperatorTestCase, run_backward, input_name)
 
 
+def _best_time(func, device, repeats=10):
+    """ Returns the shortest time (unit: second) of repeats calls of func
+    """
+    func()
+    run_times = []
+    for _ in range(repeats):
+        if device == 'cuda':
+            torch.cuda.synchronize(torch.cuda.current_device())
+        start_time = timeit.default_timer()
+        func()
+        if device == 'cuda':
+            torch.cuda.synchronize(torch.cuda.current_device())
+        run_times.append(timeit.default_timer() - start_time)
+    return min(run_times)
+
+
+def _measure_peak_bandwidth(device):
+    """ Measures the memory bandwidth (unit: GB/s) of device with the STREAM
+    triad a = b + scalar * c, on arrays much larger than the caches
+    """
+    size = 1 << 25
+    a = torch.empty(size, device=device)
+    b = torch.rand(size, device=device)
+    c = torch.rand(size, device=device)
+    run_time_sec = _best_time(
+        functools.partial(torch.add, b, c, alpha=3.0, out=a), device)
+    return 3 * size * a.element_size() / run_time_sec / 1e9
+
+
+def _measure_peak_gflops(device):
+    """ Measures the float throughput (unit: GFLOP/s) of device with a large
+    matrix multiplication
+    """
+    size = 2048
+    a = torch.rand(size, size, device=device)
+    b = torch.rand(size, size, device=device)
+    c = torch.empty(size, size, device=device)
+    run_time_sec = _best_time(functools.partial(torch.mm, a, b, out=c), device)
+    return 2 * size ** 3 / run_time_sec / 1e9
+
+
 class BenchmarkRunner(object):
     """BenchmarkRunner is responsible for benchmarking all the registered
     benchmark test groups.
@@ -173,6 +214,8 @@ class BenchmarkRunner(object):
         self.num_runs = args.num_runs
         self.print_per_iter = False
         self.operator_range = benchmark_utils.get_operator_range(args.operator_range)
+        # Measured peak (GB/s, GFLOP/s) of each device, for --roofline
+        self.peaks = {}
         # 100 is the default warmup iterations
         if self.args.warmup_iterations == -1:
             self.args.warmup_iterations = 100
@@ -202,6 +245,7 @@ class BenchmarkRunner(object):
         if self.args.ai_pep_format:
             # Output for AI-PEP
             # Print out per iteration execution time instead of avg time
+            self._print_roofline(reported_run_time_us, test_case)
             return
             test_name = '_'.join([test_case.framework, test_case.test_config.test_name])
             for run in range(self.num_runs):
@@ -228,10 +272,65 @@ class BenchmarkRunner(object):
                     print("Run: {}, {} Execution Time (us) : {:.3f}".format(
                         run,
                         mode, reported_run_time_us[run]))
-                print()
             else:
-                print("{} Execution Time (us) : {:.3f}\n".format(
+                print("{} Execution Time (us) : {:.3f}".format(
                     mode, reported_run_time_us[0]))
+            self._print_roofline(reported_run_time_us, test_case)
+            print()
+
+    def _get_peaks(self, device):
+        if device not in self.peaks:
+            peak_bandwidth = self.args.peak_bandwidth or _measure_peak_bandwidth(device)
+            peak_gflops = self.args.peak_gflops or _measure_peak_gflops(device)
+            self.peaks[device] = (peak_bandwidth, peak_gflops)
+        return self.peaks[device]
+
+    def _print_roofline(self, reported_run_time_us, test_case):
+        """ Reports the bandwidth and GFLOP/s achieved by the forward path of
+        an op against the peaks of the device, for the ops declaring the
+        bytes they move and the flops they do. When both are declared, the
+        roofline efficiency is the achieved GFLOP/s over the attainable one,
+        min(peak GFLOP/s, arithmetic intensity * peak bandwidth).
+        """
+        if not self.args.roofline or test_case.test_config.run_backward:
+            return
+        bytes_moved = test_case.op_bench.bytes_moved()
+        flops = test_case.op_bench.flops()
+        if bytes_moved is None and flops is None:
+            return
+
+        device = 'cuda' if 'cuda' in test_case.test_config.test_name else 'cpu'
+        peak_bandwidth, peak_gflops = self._get_peaks(device)
+        run_time_sec = np.median(reported_run_time_us) / 1e6
+        metrics = []
+        if bytes_moved is not None:
+            metrics.append(("bandwidth", "Achieved Bandwidth", "GB/s",
+                            bytes_moved / run_time_sec / 1e9, peak_bandwidth))
+        if flops is not None:
+            metrics.append(("throughput", "Achieved Throughput", "GFLOP/s",
+                            flops / run_time_sec / 1e9, peak_gflops))
+        if bytes_moved and flops is not None:
+            attainable_gflops = min(peak_gflops, flops / bytes_moved * peak_bandwidth)
+            metrics.append(("roofline_efficiency", "Roofline Efficiency", "%",
+                            100.0 * flops / run_time_sec / 1e9 / attainable_gflops, None))
+
+        for metric, label, unit, value, peak in metrics:
+            if self.args.ai_pep_format:
+                mode = "JIT" if self.use_jit else "Eager"
+                test_name = '_'.join([test_case.framework, test_case.test_config.test_name, mode])
+                print("{}Observer ".format(test_case.framework) + json.dumps(
+                    {
+                        "type": test_name,
+                        "metric": metric,
+                        "unit": unit,
+                        "value": str(value),
+                    }
+                ))
+            elif peak is None:
+                print("{} ({}) : {:.1f}".format(label, unit, value))
+            else:
+                print("{} ({}) : {:.3f} ({:.1f}% of peak {:.1f})".format(
+                    label, unit, value, 100.0 * value / peak, peak))
 
     def _predict_num_iter_needed(self, i):
         return (i * self.multiplier)
@@ -365,8 +464,22 @@ class BenchmarkRunner(object):
 
         return False
 
+    def _export_test_case(self, test_case):
+        """ Returns the config of a test case in the format read by the C++
+        benchmark binaries/aten_op_benchmark.cc
+        """
+        return {
+            "framework": test_case.framework,
+            "operator": test_case.op_bench.module_name(),
+            "test_name": test_case.test_config.test_name,
+            "tag": test_case.test_config.tag,
+            "run_backward": test_case.test_config.run_backward,
+            "attrs": test_case.test_config.attrs,
+        }
+
     def run(self):
         self._print_header()
+        exported_configs = []
 
         for test_metainfo in BENCHMARK_TESTER:
             for test in _build_test(*test_metainfo):
@@ -379,6 +492,10 @@ class BenchmarkRunner(object):
                 if not self._keep_test(test_case):
                     continue
 
+                if self.args.export_configs:
+                    exported_configs.append(self._export_test_case(test_case))
+                    continue
+
                 # To reduce variance, fix a numpy randseed to the test case,
                 # so that the randomly generated input tensors remain the
                 # same for each test case.
@@ -403,3 +520,9 @@ class BenchmarkRunner(object):
                                  for _ in range(self.num_runs)]
 
                 self._print_perf_result(reported_time, test_case)
+
+        if self.args.export_configs:
+            with open(self.args.export_configs, 'w') as f:
+                json.dump(exported_configs, f, indent=2)
+            print("# Exported {} test configs to {}".format(
+                len(exported_configs), self.args.export_configs))
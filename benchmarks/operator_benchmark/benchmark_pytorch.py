@@ -81,6 +81,25 @@ class TorchBenchmarkBase(object):
             return result
         return _jit_forward_graph
 
+    def bytes_moved(self):
+        """ Number of bytes read and written by one call of forward, which
+            --roofline uses to report the achieved memory bandwidth. None if
+            the benchmark doesn't declare it.
+        """
+        return None
+
+    def flops(self):
+        """ Number of floating point operations done by one call of forward,
+            which --roofline uses to report the achieved GFLOP/s. None if the
+            benchmark doesn't declare it.
+        """
+        return None
+
+    def tensor_bytes(self, *tensors):
+        """ Total size in bytes of the given tensors, to implement bytes_moved
+        """
+        return sum(t.numel() * t.element_size() for t in tensors)
+
     def module_name(self):
         """ this is used to label the operator being benchmarked
         """
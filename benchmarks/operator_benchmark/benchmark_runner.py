@@ -54,6 +54,13 @@ def main():
         help='List all test cases without running them',
         action='store_true')
 
+    parser.add_argument(
+        '--export_configs',
+        help='Write the configs of the selected tests to this JSON file without '
+             'running them, to run them with the C++ benchmark '
+             'binaries/aten_op_benchmark.cc',
+        default=None)
+
     parser.add_argument(
         "--iterations",
         help="Repeat each operator for the number of iterations",
@@ -139,6 +146,31 @@ def main():
         default=False
     )
 
+    parser.add_argument(
+        '--roofline',
+        help='Report the memory bandwidth and GFLOP/s achieved by the operators '
+             'declaring the bytes they move and the flops they do, against the '
+             'peaks measured on the device',
+        action='store_true',
+        default=False
+    )
+
+    parser.add_argument(
+        '--peak_bandwidth',
+        help='Peak memory bandwidth (unit: GB/s) used by --roofline instead of '
+             'the one measured with the STREAM triad',
+        type=float,
+        default=None
+    )
+
+    parser.add_argument(
+        '--peak_gflops',
+        help='Peak GFLOP/s used by --roofline instead of the one measured with '
+             'a large matrix multiplication',
+        type=float,
+        default=None
+    )
+
     args, _ = parser.parse_known_args()
 
     if args.omp_num_threads:
@@ -44,6 +44,9 @@ class AddBenchmark(op_bench_c2.Caffe2BenchmarkBase):
         )
         return op
 
+    def bytes_moved(self):
+        return self.tensor_bytes(self.input_one, self.input_two, self.output)
+
 
 op_bench_c2.generate_c2_test(add_long_configs + add_short_configs, AddBenchmark)
 
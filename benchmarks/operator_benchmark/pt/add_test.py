@@ -40,6 +40,12 @@ class AddBenchmark(op_bench.TorchBenchmarkBase):
     def forward(self):
         return torch.add(self.input_one, self.input_two)
 
+    def bytes_moved(self):
+        return 3 * self.tensor_bytes(self.input_one)
+
+    def flops(self):
+        return self.input_one.numel()
+
 # The generated test names based on add_short_configs will be in the following pattern:
 # add_M8_N16_K32_devicecpu
 # add_M8_N16_K32_devicecpu_bwdall
@@ -63,6 +69,15 @@ class AddmmBenchmark(op_bench.TorchBenchmarkBase):
     def forward(self):
         return torch.addmm(self.input_one, self.mat1, self.mat2)
 
+    def bytes_moved(self):
+        return 2 * self.tensor_bytes(self.input_one) + \
+            self.tensor_bytes(self.mat1, self.mat2)
+
+    def flops(self):
+        M, N = self.mat1.shape
+        K = self.mat2.shape[1]
+        return 2 * M * N * K + M * K
+
 op_bench.generate_pt_test(add_long_configs + add_short_configs, AddmmBenchmark)
 op_bench.generate_pt_gradient_test(add_long_configs + add_short_configs, AddmmBenchmark)
 
@@ -42,6 +42,9 @@ class CatBenchmark(op_bench.TorchBenchmarkBase):
     def forward(self):
         return torch.cat((self.input_one, self.input_one), dim=self.dim)
 
+    def bytes_moved(self):
+        return 4 * self.tensor_bytes(self.input_one)
+
 
 op_bench.generate_pt_test(cat_configs_short + cat_configs_long,
                           CatBenchmark)
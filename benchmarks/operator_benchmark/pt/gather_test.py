@@ -45,6 +45,11 @@ class GatherBenchmark(op_bench.TorchBenchmarkBase):
     def forward(self):
         return torch.gather(self.input_one, self.dim, self.index)
 
+    def bytes_moved(self):
+        # Each index reads one input element and writes one output element
+        return self.tensor_bytes(self.index) + \
+            2 * self.index.numel() * self.input_one.element_size()
+
 
 op_bench.generate_pt_test(gather_configs_short + gather_configs_long,
                           GatherBenchmark)
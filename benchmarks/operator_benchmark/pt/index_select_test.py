@@ -0,0 +1,61 @@
+from __future__ import absolute_import
+from __future__ import division
+from __future__ import print_function
+from __future__ import unicode_literals
+
+import operator_benchmark as op_bench
+import torch
+import numpy
+
+
+"""Microbenchmarks for index_select operator."""
+
+# An example input from this configuration is M=256, N=512, K=128, dim=0.
+index_select_configs_short = op_bench.config_list(
+    attr_names=['M', 'N', 'K', 'dim'],
+    attrs=[
+        [256, 512, 128, 0],
+        [512, 512, 256, 1],
+    ],
+    cross_product_configs={
+        'device': ['cpu', 'cuda'],
+    },
+    tags=['short']
+)
+
+
+index_select_configs_long = op_bench.cross_product_configs(
+    M=[128, 1024],
+    N=[128, 1024],
+    K=[64, 512],
+    dim=[0, 1],
+    device=['cpu', 'cuda'],
+    tags=['long']
+)
+
+
+class IndexSelectBenchmark(op_bench.TorchBenchmarkBase):
+    def init(self, M, N, K, dim, device):
+        self.input_one = torch.rand(M, N, device=device)
+        self.dim = dim
+        max_val = M if dim == 0 else N
+        numpy.random.seed((1 << 32) - 1)
+        self.index = torch.tensor(numpy.random.randint(0, max_val, K), device=device)
+        self.set_module_name('index_select')
+
+    def forward(self):
+        return torch.index_select(self.input_one, self.dim, self.index)
+
+    def bytes_moved(self):
+        # Each index reads and writes one slice of the input
+        slices = self.input_one.numel() // self.input_one.shape[self.dim]
+        return self.tensor_bytes(self.index) + \
+            2 * self.index.numel() * slices * self.input_one.element_size()
+
+
+op_bench.generate_pt_test(index_select_configs_short + index_select_configs_long,
+                          IndexSelectBenchmark)
+
+
+if __name__ == "__main__":
+    op_bench.benchmark_runner.main()
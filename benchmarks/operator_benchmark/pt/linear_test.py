@@ -42,6 +42,15 @@ class LinearBenchmark(op_bench.TorchBenchmarkBase):
     def forward(self):
         return self.linear(self.input_one)
 
+    def bytes_moved(self):
+        N = self.input_one.shape[0]
+        return self.tensor_bytes(self.input_one, self.linear.weight, self.linear.bias) + \
+            N * self.linear.out_features * self.input_one.element_size()
+
+    def flops(self):
+        N = self.input_one.shape[0]
+        return 2 * N * self.linear.in_features * self.linear.out_features
+
 
 op_bench.generate_pt_test(linear_configs_short + linear_configs_long,
                           LinearBenchmark)
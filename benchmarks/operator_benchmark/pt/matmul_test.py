@@ -44,6 +44,17 @@ class MatMulBenchmark(op_bench.TorchBenchmarkBase):
     def forward(self):
         return torch.matmul(self.input_one, self.input_two)
 
+    def bytes_moved(self):
+        M, N = self.input_one.shape
+        K = self.input_two.shape[1]
+        return self.tensor_bytes(self.input_one, self.input_two) + \
+            M * K * self.input_one.element_size()
+
+    def flops(self):
+        M, N = self.input_one.shape
+        K = self.input_two.shape[1]
+        return 2 * M * N * K
+
 
 op_bench.generate_pt_test(mm_long_configs + mm_short_configs, MatMulBenchmark)
 
@@ -20,6 +20,10 @@ quantize_configs_short_dict = {
     'attrs': [
         [3, 512, 512, torch.quint8, 'Q'],
         [3, 512, 512, torch.quint8, 'D'],
+        [3, 512, 512, torch.qint8, 'Q'],
+        [3, 512, 512, torch.qint8, 'D'],
+        [3, 512, 512, torch.qint32, 'Q'],
+        [3, 512, 512, torch.qint32, 'D'],
     ],
     'tags': ['short'],
 }
@@ -0,0 +1,58 @@
+from __future__ import absolute_import
+from __future__ import division
+from __future__ import print_function
+from __future__ import unicode_literals
+
+import operator_benchmark as op_bench
+import torch
+
+
+"""Microbenchmarks for sum reduction operator."""
+
+# Configs for PT sum operator
+sum_configs_short = op_bench.config_list(
+    attr_names=['M', 'N', 'dim'],
+    attrs=[
+        [256, 512, 0],
+        [512, 512, 1],
+    ],
+    cross_product_configs={
+        'device': ['cpu', 'cuda'],
+    },
+    tags=['short']
+)
+
+
+sum_configs_long = op_bench.cross_product_configs(
+    M=[128, 1024],
+    N=[128, 1024],
+    dim=[0, 1],
+    device=['cpu', 'cuda'],
+    tags=['long']
+)
+
+
+class SumBenchmark(op_bench.TorchBenchmarkBase):
+    def init(self, M, N, dim, device):
+        self.input_one = torch.rand(M, N, device=device)
+        self.dim = dim
+        self.set_module_name('sum')
+
+    def forward(self):
+        return self.input_one.sum(dim=self.dim)
+
+    def bytes_moved(self):
+        M, N = self.input_one.shape
+        output_size = N if self.dim == 0 else M
+        return self.tensor_bytes(self.input_one) + \
+            output_size * self.input_one.element_size()
+
+    def flops(self):
+        return self.input_one.numel()
+
+
+op_bench.generate_pt_test(sum_configs_short + sum_configs_long, SumBenchmark)
+
+
+if __name__ == "__main__":
+    op_bench.benchmark_runner.main()
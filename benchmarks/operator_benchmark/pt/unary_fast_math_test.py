@@ -0,0 +1,91 @@
+from __future__ import absolute_import
+from __future__ import division
+from __future__ import print_function
+from __future__ import unicode_literals
+
+
+import operator_benchmark as op_bench
+import torch
+
+
+"""Microbenchmarks for the CPU fast math variants of unary operators.
+
+Running this file directly also prints the accuracy of every op with and
+without fast math, measured against the double precision result.
+"""
+
+
+# Configs for fast math unary ops
+unary_fast_math_configs_short = op_bench.config_list(
+    attr_names=['M', 'N'],
+    attrs=[
+        [512, 512],
+    ],
+    cross_product_configs={
+        'fast_math': [False, True],
+    },
+    tags=['short']
+)
+
+unary_fast_math_configs_long = op_bench.cross_product_configs(
+    M=[256, 1024],
+    N=[256, 1024],
+    fast_math=[False, True],
+    tags=['long']
+)
+
+
+# Inputs are drawn uniformly from the interesting part of each op's domain
+input_ranges = {
+    'exp': (-80., 80.),
+    'tanh': (-10., 10.),
+    'sigmoid': (-20., 20.),
+    'erfinv': (-1., 1.),
+}
+
+
+class UnaryFastMathBenchmark(op_bench.TorchBenchmarkBase):
+    def init(self, M, N, fast_math, op_func):
+        self.input_one = torch.empty(M, N).uniform_(*input_ranges[self.module_name()])
+        self.fast_math = fast_math
+        self.op_func = op_func
+
+    def forward(self):
+        with torch.backends.cpu.flags(fast_math=self.fast_math):
+            return self.op_func(self.input_one)
+
+
+unary_fast_math_ops_list = op_bench.op_list(
+    attr_names=['op_name', 'op_func'],
+    attrs=[
+        ['exp', torch.exp],
+        ['tanh', torch.tanh],
+        ['sigmoid', torch.sigmoid],
+        ['erfinv', torch.erfinv],
+    ],
+)
+
+
+op_bench.generate_pt_tests_from_op_list(unary_fast_math_ops_list,
+                                        unary_fast_math_configs_short + unary_fast_math_configs_long,
+                                        UnaryFastMathBenchmark)
+
+
+def print_accuracy_table():
+    print('# {:<10} {:>18} {:>18}'.format('op', 'max rel err', 'max rel err (fast)'))
+    for op in unary_fast_math_ops_list:
+        x = torch.empty(1 << 20).uniform_(*input_ranges[op['op_name']])
+        expected = op['op_func'](x.double())
+        row = []
+        for fast_math in [False, True]:
+            with torch.backends.cpu.flags(fast_math=fast_math):
+                actual = op['op_func'](x).double()
+            finite = torch.isfinite(expected)
+            err = (actual - expected)[finite].abs() / expected[finite].abs().clamp(min=1e-30)
+            row.append(err.max().item())
+        print('# {:<10} {:>18.3g} {:>18.3g}'.format(op['op_name'], *row))
+
+
+if __name__ == "__main__":
+    print_accuracy_table()
+    op_bench.benchmark_runner.main()
@@ -38,6 +38,10 @@ class UnaryOpBenchmark(op_bench.TorchBenchmarkBase):
     def forward(self):
         return self.op_func(self.input_one)
 
+    def bytes_moved(self):
+        # Reads the input once and writes an output of the same size
+        return 2 * self.tensor_bytes(self.input_one)
+
 
 unary_ops_list = op_bench.op_list(
     attr_names=['op_name', 'op_func'],
@@ -0,0 +1,239 @@
+from __future__ import print_function
+import argparse
+from collections import namedtuple
+import torch
+import gc
+import json
+import sys
+import timeit
+
+from .runner import get_model_runners
+
+
+BenchResult = namedtuple('BenchResult', [
+    'name', 'avg_step', 'std_step', 'avg_fwd', 'avg_bwd', 'avg_optim',
+    'avg_host', 'num_ops', 'kernel_ops', 'op_cpu', 'allocs', 'peak_mb',
+])
+
+
+def fit_str(string, colwidth=12):
+    if len(string) < colwidth:
+        return (colwidth - len(string)) * ' ' + string
+    else:
+        return string[:colwidth]
+
+
+def to_str(item):
+    if isinstance(item, float):
+        return '%.4g' % item
+    return str(item)
+
+
+def print_header(colwidth=12, sep=' '):
+    items = []
+    for item in BenchResult._fields:
+        items.append(fit_str(item, colwidth))
+    return sep.join(items)
+
+
+def pretty_print(benchresult, colwidth=12, sep=' '):
+    items = []
+    for thing in benchresult:
+        items.append(fit_str(to_str(thing), colwidth))
+    return sep.join(items)
+
+
+def print_stderr(*args, **kwargs):
+    kwargs['file'] = sys.stderr
+    return print(*args, **kwargs)
+
+
+class Mark(object):
+    """ A point in time of a training step: a CUDA event on CUDA, so that
+        marking doesn't synchronize, a timestamp on CPU.
+    """
+    def __init__(self, device):
+        if device == 'cuda':
+            self.event = torch.cuda.Event(enable_timing=True)
+            self.event.record()
+        else:
+            self.time = timeit.default_timer()
+
+    def elapsed_ms(self, end):
+        if hasattr(self, 'event'):
+            return self.event.elapsed_time(end.event)
+        return (end.time - self.time) * 1e3
+
+
+def train_step(modeldef, device):
+    """ Runs one training step, returns the times (unit: ms) of its forward,
+        backward and optimizer step, and the host time of the step: the time
+        until all its work is launched, which is the CPU overhead of the step
+        on CUDA.
+    """
+    gc.collect()
+    modeldef.optimizer.zero_grad()
+
+    host_start = timeit.default_timer()
+    marks = [Mark(device)]
+    loss = modeldef.loss_fn(modeldef.model(*modeldef.inputs))
+    marks.append(Mark(device))
+    loss.backward()
+    marks.append(Mark(device))
+    modeldef.optimizer.step()
+    marks.append(Mark(device))
+    host_time = (timeit.default_timer() - host_start) * 1e3
+
+    if device == 'cuda':
+        torch.cuda.synchronize()
+    fwd_time, bwd_time, optim_time = [
+        start.elapsed_ms(end) for start, end in zip(marks[:-1], marks[1:])]
+    return fwd_time, bwd_time, optim_time, host_time
+
+
+def profile_steps(modeldef, device, nprofile):
+    """ Runs nprofile training steps with the autograd profiler, returns the
+        ops per step, the ops per step that ran work on the GPU, and the CPU
+        time (unit: ms) spent in the ops per step.
+    """
+    use_cuda = device == 'cuda'
+    with torch.autograd.profiler.profile(use_cuda=use_cuda) as prof:
+        for _ in range(nprofile):
+            train_step(modeldef, device)
+    events = prof.function_events
+    # The profiler records ops rather than kernels: count the ones with GPU time
+    kernel_ops = sum(1 for event in events if event.cuda_time_total > 0)
+    return (len(events) // nprofile,
+            kernel_ops // nprofile,
+            prof.self_cpu_time_total / 1e3 / nprofile)
+
+
+def memory_stats(device, nloops):
+    """ Returns the allocations per step and the peak allocated memory (unit: MB)
+        of the CUDA caching allocator since the stats were reset
+    """
+    if device != 'cuda':
+        return None, None
+    stats = torch.cuda.memory_stats()
+    return (stats.get('allocation.all.allocated', 0) // nloops,
+            stats.get('allocated_bytes.all.peak', 0) / 2 ** 20)
+
+
+def trainbench(name, creator, nloops=20, warmup=5, nprofile=3,
+               device='cuda', seed=None, **params):
+    if seed is not None:
+        torch.manual_seed(seed)
+    modeldef = creator(device=device, **params)
+
+    [train_step(modeldef, device) for _ in range(warmup)]
+
+    if device == 'cuda':
+        torch.cuda.reset_peak_memory_stats()
+        torch.cuda.reset_accumulated_memory_stats()
+    results = [train_step(modeldef, device) for _ in range(nloops)]
+    allocs, peak_mb = memory_stats(device, nloops)
+
+    num_ops, kernel_ops, op_cpu = profile_steps(modeldef, device, nprofile)
+
+    fwd_times, bwd_times, optim_times, host_times = [
+        torch.tensor(times) for times in zip(*results)]
+    step_times = fwd_times + bwd_times + optim_times
+    return BenchResult(name=name,
+                       avg_step=step_times.mean().item(),
+                       std_step=step_times.std().item(),
+                       avg_fwd=fwd_times.mean().item(),
+                       avg_bwd=bwd_times.mean().item(),
+                       avg_optim=optim_times.mean().item(),
+                       avg_host=host_times.mean().item(),
+                       num_ops=num_ops,
+                       kernel_ops=kernel_ops,
+                       op_cpu=op_cpu,
+                       allocs=allocs,
+                       peak_mb=peak_mb)
+
+
+def bench(model_runners, sep=' ', **params):
+    print_stderr(print_header(sep=sep))
+    results = {}
+    for name, creator in model_runners:
+        result = trainbench(name, creator, **params)
+        print_stderr(pretty_print(result, sep=sep))
+        results[name] = result._asdict()
+        del results[name]['name']
+    return results
+
+
+def check_regressions(results, baseline, threshold):
+    """ Compares results against the ones of a previous run. Returns the
+        messages about the models whose step time grew by more than
+        threshold, or which run more ops per step.
+    """
+    regressions = []
+    for name, result in results.items():
+        if name not in baseline:
+            continue
+        base = baseline[name]
+        if result['avg_step'] > base['avg_step'] * (1 + threshold):
+            regressions.append('{}: step time {:.4g} ms vs {:.4g} ms'.format(
+                name, result['avg_step'], base['avg_step']))
+        if result['num_ops'] > base['num_ops']:
+            regressions.append('{}: {} ops per step vs {}'.format(
+                name, result['num_ops'], base['num_ops']))
+    return regressions
+
+
+if __name__ == '__main__':
+    parser = argparse.ArgumentParser(description='Benchmark training steps')
+
+    parser.add_argument('--models', nargs='*',
+                        default=['resnet50', 'resnet50_jit', 'resnet50_fused',
+                                 'transformer', 'transformer_jit', 'transformer_fused'],
+                        help='What to run: resnet18, resnet50, mobilenet_v2 or '
+                        'transformer, with _jit or _fused for the TorchScript modes')
+    parser.add_argument('--miniBatch', default='32', type=int)
+    parser.add_argument('--seqLength', default='64', type=int,
+                        help='Sequence length of the transformer')
+    parser.add_argument('--warmup', default='5', type=int)
+    parser.add_argument('--nloops', default='20', type=int)
+    parser.add_argument('--nprofile', default='3', type=int,
+                        help='Number of steps run with the autograd profiler')
+    parser.add_argument('--device', default='cuda', type=str)
+    parser.add_argument('--seed', default=None, type=int)
+    parser.add_argument('--sep', default=' ', type=str)
+    parser.add_argument('--print-json', action='store_true',
+                        help='Print the results as JSON on stdout')
+    parser.add_argument('--output', default=None, type=str,
+                        help='Write the results as JSON to this file')
+    parser.add_argument('--baseline', default=None, type=str,
+                        help='JSON results of a previous run: exit with an '
+                        'error if a model regressed against them')
+    parser.add_argument('--threshold', default=0.05, type=float,
+                        help='Relative step time increase reported as a regression')
+
+    args = parser.parse_args()
+    print_stderr(args)
+
+    results = bench(get_model_runners(*args.models),
+                    sep=args.sep,
+                    miniBatch=args.miniBatch,
+                    seqLength=args.seqLength,
+                    warmup=args.warmup,
+                    nloops=args.nloops,
+                    nprofile=args.nprofile,
+                    device=args.device,
+                    seed=args.seed)
+
+    if args.print_json:
+        print(json.dumps(results))
+    if args.output:
+        with open(args.output, 'w') as f:
+            json.dump(results, f, indent=2)
+
+    if args.baseline:
+        with open(args.baseline) as f:
+            baseline = json.load(f)
+        regressions = check_regressions(results, baseline, args.threshold)
+        for regression in regressions:
+            print_stderr('REGRESSION ' + regression)
+        if regressions:
+            sys.exit(1)
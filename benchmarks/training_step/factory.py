@@ -0,0 +1,83 @@
+import torch
+import torch.nn as nn
+
+from collections import namedtuple
+
+
+'''
+Define a creator as a function:
+(options) -> (model, inputs, loss_fn, optimizer)
+model: module / traced module. One can call model(*inputs) directly.
+inputs: the inputs to 'model'.
+loss_fn: loss = loss_fn(model(*inputs)), the scalar to backpropagate.
+optimizer: a torch.optim optimizer over the parameters of 'model'.
+
+training_step.bench times the forward, backward and optimizer step of each
+training step separately.
+'''
+
+
+ModelDef = namedtuple('ModelDef', [
+    'model', 'inputs', 'loss_fn', 'optimizer'])
+
+
+def script_model(model, inputs, mode):
+    """ Compiles model for the given mode:
+        eager: the module as is.
+        jit: the module traced with TorchScript.
+        fused: the traced module, with the fuser also enabled on CPU so that
+            elementwise chains run as fused kernels on both devices.
+    """
+    if mode == 'eager':
+        return model
+    if mode not in ('jit', 'fused'):
+        raise ValueError('Unknown mode {}'.format(mode))
+    # The fuser is always on for CUDA, this sets it for CPU for the runs after
+    torch._C._jit_override_can_fuse_on_cpu(mode == 'fused')
+    # Dropout makes the outputs differ between runs, so skip checking them
+    return torch.jit.trace(model, inputs, check_trace=False)
+
+
+def imagenet_cnn_creator(arch):
+    def creator(mode='eager', device='cuda', miniBatch=32, **kwargs):
+        model = arch().to(device)
+        x = torch.randn(miniBatch, 3, 224, 224, device=device)
+        target = torch.randint(1000, (miniBatch,), device=device)
+        optimizer = torch.optim.SGD(model.parameters(), lr=0.01, momentum=0.9)
+        return ModelDef(
+            model=script_model(model, (x,), mode),
+            inputs=(x,),
+            loss_fn=lambda output: nn.functional.cross_entropy(output, target),
+            optimizer=optimizer)
+
+    return creator
+
+
+class TransformerLM(nn.Module):
+    """ Language model with a transformer encoder, the usual word language
+        model of the examples
+    """
+    def __init__(self, ntoken, d_model, nhead, num_layers, dropout=0.1):
+        super(TransformerLM, self).__init__()
+        self.embedding = nn.Embedding(ntoken, d_model)
+        layer = nn.TransformerEncoderLayer(d_model, nhead, 4 * d_model, dropout)
+        self.encoder = nn.TransformerEncoder(layer, num_layers)
+        self.decoder = nn.Linear(d_model, ntoken)
+
+    def forward(self, tokens, mask):
+        return self.decoder(self.encoder(self.embedding(tokens), mask))
+
+
+def transformer_creator(mode='eager', device='cuda', seqLength=64, miniBatch=32,
+                        ntoken=10000, d_model=512, nhead=8, num_layers=6, **kwargs):
+    model = TransformerLM(ntoken, d_model, nhead, num_layers).to(device)
+    tokens = torch.randint(ntoken, (seqLength, miniBatch), device=device)
+    target = torch.randint(ntoken, (seqLength * miniBatch,), device=device)
+    # Causal mask, -inf above the diagonal
+    mask = torch.triu(torch.full((seqLength, seqLength), float('-inf'), device=device), 1)
+    optimizer = torch.optim.Adam(model.parameters(), lr=1e-4)
+    return ModelDef(
+        model=script_model(model, (tokens, mask), mode),
+        inputs=(tokens, mask),
+        loss_fn=lambda output: nn.functional.cross_entropy(output.view(-1, ntoken), target),
+        optimizer=optimizer)
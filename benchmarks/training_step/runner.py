@@ -0,0 +1,30 @@
+from collections import namedtuple
+from functools import partial
+import torchvision.models as cnn
+
+from .factory import *  # noqa
+
+
+ModelRunner = namedtuple('ModelRunner', [
+    'name', 'creator',
+])
+
+
+modes = ('eager', 'jit', 'fused')
+
+
+def get_model_runners(*names):
+    runners = []
+    for name in names:
+        # e.g. resnet50 runs eager and resnet50_jit runs with TorchScript
+        model, mode = name.rsplit('_', 1) if name.endswith(modes) else (name, 'eager')
+        runners.append(ModelRunner(name, partial(model_creators[model], mode=mode)))
+    return runners
+
+
+model_creators = {
+    'resnet18': imagenet_cnn_creator(cnn.resnet18),
+    'resnet50': imagenet_cnn_creator(cnn.resnet50),
+    'mobilenet_v2': imagenet_cnn_creator(cnn.mobilenet_v2),
+    'transformer': transformer_creator,
+}
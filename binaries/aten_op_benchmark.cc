@@ -0,0 +1,468 @@
+/**
+ * Copyright (c) 2016-present, Facebook, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// C++ counterpart of benchmarks/operator_benchmark: runs the ATen ops of the
+// test configs exported by
+//
+//   python -m benchmark_all_test --export_configs configs.json
+//
+// with Google Benchmark, without the Python overhead. Use e.g.
+//
+//   aten_op_benchmark --op_configs configs.json \
+//       --benchmark_format=json --benchmark_out=results.json
+//
+// for machine-readable results: the time of each benchmark is per call of the
+// op, bytes_per_second counts the bytes the op reads and writes, and the label
+// is the CPU capability the ATen kernels dispatch to, which can be lowered with
+// the ATEN_CPU_CAPABILITY environment variable.
+
+#include "benchmark/benchmark.h"
+
+#include <ATen/ATen.h>
+#include <ATen/Parallel.h>
+#include <ATen/native/DispatchStub.h>
+
+#include "c10/util/Flags.h"
+
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+C10_DEFINE_string(
+    op_configs,
+    "",
+    "JSON file of the test configs exported by benchmark_runner.py "
+    "--export_configs");
+C10_DEFINE_string(
+    operators,
+    "",
+    "Comma-delimited list of operators to run, all the supported ones if empty");
+C10_DEFINE_int(num_threads, 1, "Number of intra-op threads");
+
+namespace {
+
+// A minimal parser for the JSON written by benchmark_runner.py
+struct JsonValue {
+  enum class Type { Null, Bool, Number, String, Array, Object };
+  Type type{Type::Null};
+  bool boolean{false};
+  double number{0};
+  std::string str;
+  std::vector<JsonValue> array;
+  std::vector<std::pair<std::string, JsonValue>> object;
+
+  const JsonValue* get(const std::string& key) const {
+    for (const auto& kv : object) {
+      if (kv.first == key) {
+        return &kv.second;
+      }
+    }
+    return nullptr;
+  }
+};
+
+class JsonParser {
+ public:
+  explicit JsonParser(const std::string& text) : text_(text) {}
+
+  JsonValue parse() {
+    auto value = parseValue();
+    skipSpaces();
+    TORCH_CHECK(pos_ == text_.size(), "Trailing characters in JSON");
+    return value;
+  }
+
+ private:
+  void skipSpaces() {
+    while (pos_ < text_.size() && std::isspace(text_[pos_])) {
+      ++pos_;
+    }
+  }
+
+  char peek() {
+    skipSpaces();
+    TORCH_CHECK(pos_ < text_.size(), "Unexpected end of JSON");
+    return text_[pos_];
+  }
+
+  void expect(char c) {
+    TORCH_CHECK(peek() == c, "Expected '", c, "' at ", pos_, " in JSON");
+    ++pos_;
+  }
+
+  bool consume(const std::string& word) {
+    if (text_.compare(pos_, word.size(), word) == 0) {
+      pos_ += word.size();
+      return true;
+    }
+    return false;
+  }
+
+  JsonValue parseValue() {
+    JsonValue value;
+    const char c = peek();
+    if (c == '{') {
+      value.type = JsonValue::Type::Object;
+      ++pos_;
+      if (peek() == '}') {
+        ++pos_;
+        return value;
+      }
+      do {
+        auto key = parseString();
+        expect(':');
+        value.object.emplace_back(std::move(key), parseValue());
+      } while (peek() == ',' && ++pos_);
+      expect('}');
+    } else if (c == '[') {
+      value.type = JsonValue::Type::Array;
+      ++pos_;
+      if (peek() == ']') {
+        ++pos_;
+        return value;
+      }
+      do {
+        value.array.push_back(parseValue());
+      } while (peek() == ',' && ++pos_);
+      expect(']');
+    } else if (c == '"') {
+      value.type = JsonValue::Type::String;
+      value.str = parseString();
+    } else if (consume("true")) {
+      value.type = JsonValue::Type::Bool;
+      value.boolean = true;
+    } else if (consume("false")) {
+      value.type = JsonValue::Type::Bool;
+    } else if (consume("null")) {
+    } else {
+      value.type = JsonValue::Type::Number;
+      size_t length = 0;
+      value.number = std::stod(text_.substr(pos_), &length);
+      pos_ += length;
+    }
+    return value;
+  }
+
+  std::string parseString() {
+    expect('"');
+    std::string result;
+    while (true) {
+      TORCH_CHECK(pos_ < text_.size(), "Unterminated string in JSON");
+      const char c = text_[pos_++];
+      if (c == '"') {
+        return result;
+      }
+      if (c != '\\') {
+        result += c;
+        continue;
+      }
+      TORCH_CHECK(pos_ < text_.size(), "Unterminated string in JSON");
+      const char escaped = text_[pos_++];
+      switch (escaped) {
+        case 'n':
+          result += '\n';
+          break;
+        case 't':
+          result += '\t';
+          break;
+        case 'r':
+          result += '\r';
+          break;
+        case 'b':
+          result += '\b';
+          break;
+        case 'f':
+          result += '\f';
+          break;
+        case 'u': {
+          // The configs are ASCII, as json.dump escapes anything else
+          TORCH_CHECK(pos_ + 4 <= text_.size(), "Bad escape in JSON");
+          result += static_cast<char>(std::stoi(text_.substr(pos_, 4), 0, 16));
+          pos_ += 4;
+          break;
+        }
+        default:
+          result += escaped;
+      }
+    }
+  }
+
+  const std::string& text_;
+  size_t pos_{0};
+};
+
+// The attributes of a test config, as the strings of benchmark_core.py
+using Attrs = std::map<std::string, std::string>;
+
+int64_t getInt(const Attrs& attrs, const std::string& name) {
+  auto it = attrs.find(name);
+  TORCH_CHECK(it != attrs.end(), "Missing attribute ", name);
+  return std::stoll(it->second);
+}
+
+bool getBool(const Attrs& attrs, const std::string& name) {
+  auto it = attrs.find(name);
+  TORCH_CHECK(it != attrs.end(), "Missing attribute ", name);
+  return it->second == "True" || it->second == "true" || it->second == "1";
+}
+
+// Inputs of an op are created once, and run is what's measured
+struct OpBenchmark {
+  std::function<void()> run;
+  // Bytes read and written by one call of the op
+  int64_t bytes{0};
+};
+
+using OpFactory = std::function<OpBenchmark(const Attrs&)>;
+
+OpBenchmark unaryOp(
+    const Attrs& attrs,
+    std::function<at::Tensor(at::Tensor&)> op) {
+  auto input = at::rand({getInt(attrs, "M"), getInt(attrs, "N")});
+  return {[input, op]() mutable { op(input); },
+          2 * input.numel() * static_cast<int64_t>(sizeof(float))};
+}
+
+OpBenchmark softmaxOp(
+    const Attrs& attrs,
+    std::function<at::Tensor(const at::Tensor&)> op) {
+  auto input = at::rand({getInt(attrs, "N"),
+                         getInt(attrs, "C"),
+                         getInt(attrs, "H"),
+                         getInt(attrs, "W")});
+  return {[input, op]() { op(input); },
+          2 * input.numel() * static_cast<int64_t>(sizeof(float))};
+}
+
+// The ops of benchmarks/operator_benchmark/pt, by their module name there,
+// with the same inputs
+std::map<std::string, OpFactory> opFactories() {
+  std::map<std::string, OpFactory> factories;
+  factories["add"] = [](const Attrs& attrs) {
+    const auto M = getInt(attrs, "M");
+    const auto N = getInt(attrs, "N");
+    const auto K = getInt(attrs, "K");
+    auto a = at::rand({M, N, K});
+    auto b = at::rand({M, N, K});
+    return OpBenchmark{[a, b]() { at::add(a, b); },
+                       3 * M * N * K * static_cast<int64_t>(sizeof(float))};
+  };
+  factories["addmm"] = [](const Attrs& attrs) {
+    const auto M = getInt(attrs, "M");
+    const auto N = getInt(attrs, "N");
+    const auto K = getInt(attrs, "K");
+    auto input = at::rand({M, K});
+    auto mat1 = at::rand({M, N});
+    auto mat2 = at::rand({N, K});
+    return OpBenchmark{
+        [input, mat1, mat2]() { at::addmm(input, mat1, mat2); },
+        (2 * M * K + M * N + N * K) * static_cast<int64_t>(sizeof(float))};
+  };
+  factories["matmul"] = [](const Attrs& attrs) {
+    const auto M = getInt(attrs, "M");
+    const auto N = getInt(attrs, "N");
+    const auto K = getInt(attrs, "K");
+    auto a = getBool(attrs, "trans_a") ? at::rand({M, N}) : at::rand({N, M}).t();
+    auto b = getBool(attrs, "trans_b") ? at::rand({N, K}) : at::rand({K, N}).t();
+    return OpBenchmark{
+        [a, b]() { at::matmul(a, b); },
+        (M * N + N * K + M * K) * static_cast<int64_t>(sizeof(float))};
+  };
+  factories["cat"] = [](const Attrs& attrs) {
+    auto input =
+        at::rand({getInt(attrs, "M"), getInt(attrs, "N"), getInt(attrs, "K")});
+    const auto dim = getInt(attrs, "dim");
+    return OpBenchmark{[input, dim]() { at::cat({input, input}, dim); },
+                       4 * input.numel() * static_cast<int64_t>(sizeof(float))};
+  };
+  factories["linear"] = [](const Attrs& attrs) {
+    const auto N = getInt(attrs, "N");
+    const auto IN = getInt(attrs, "IN");
+    const auto OUT = getInt(attrs, "OUT");
+    auto input = at::rand({N, IN});
+    auto weight = at::rand({OUT, IN});
+    auto bias = at::rand({OUT});
+    return OpBenchmark{
+        [input, weight, bias]() { at::linear(input, weight, bias); },
+        (N * IN + OUT * IN + OUT + N * OUT) *
+            static_cast<int64_t>(sizeof(float))};
+  };
+
+  // nn.Softmax and nn.LogSoftmax without dim on 4D inputs use dim 1
+  factories["Softmax"] = [](const Attrs& attrs) {
+    return softmaxOp(attrs, [](const at::Tensor& t) { return t.softmax(1); });
+  };
+  factories["Softmax2d"] = factories["Softmax"];
+  factories["LogSoftmax"] = [](const Attrs& attrs) {
+    return softmaxOp(
+        attrs, [](const at::Tensor& t) { return t.log_softmax(1); });
+  };
+
+#define UNARY_OP(name)                                          \
+  factories[#name] = [](const Attrs& attrs) {                   \
+    return unaryOp(attrs, [](at::Tensor& t) { return t.name(); }); \
+  };                                                            \
+  factories[#name "_"] = [](const Attrs& attrs) {               \
+    return unaryOp(attrs, [](at::Tensor& t) { return t.name##_(); }); \
+  };
+  UNARY_OP(abs)
+  UNARY_OP(acos)
+  UNARY_OP(asin)
+  UNARY_OP(atan)
+  UNARY_OP(ceil)
+  UNARY_OP(cos)
+  UNARY_OP(erf)
+  UNARY_OP(erfc)
+  UNARY_OP(exp)
+  UNARY_OP(expm1)
+  UNARY_OP(floor)
+  UNARY_OP(frac)
+  UNARY_OP(log)
+  UNARY_OP(log10)
+  UNARY_OP(log1p)
+  UNARY_OP(log2)
+  UNARY_OP(neg)
+  UNARY_OP(reciprocal)
+  UNARY_OP(relu)
+  UNARY_OP(round)
+  UNARY_OP(rsqrt)
+  UNARY_OP(sigmoid)
+  UNARY_OP(sin)
+  UNARY_OP(sqrt)
+  UNARY_OP(tan)
+  UNARY_OP(tanh)
+  UNARY_OP(trunc)
+#undef UNARY_OP
+  return factories;
+}
+
+std::string cpuCapabilityName() {
+  switch (at::native::get_cpu_capability()) {
+    case at::native::CPUCapability::DEFAULT:
+      return "default";
+    case at::native::CPUCapability::AVX:
+      return "avx";
+    case at::native::CPUCapability::AVX2:
+      return "avx2";
+    case at::native::CPUCapability::AVX512:
+      return "avx512";
+    default:
+      return "unknown";
+  }
+}
+
+std::vector<std::string> splitOperators(const std::string& operators) {
+  std::vector<std::string> result;
+  std::stringstream stream(operators);
+  std::string op;
+  while (std::getline(stream, op, ',')) {
+    if (!op.empty()) {
+      result.push_back(op);
+    }
+  }
+  return result;
+}
+
+// Registers a benchmark for each forward test on CPU of a supported op,
+// returns the number of benchmarks
+int registerBenchmarks(const JsonValue& configs) {
+  TORCH_CHECK(
+      configs.type == JsonValue::Type::Array,
+      "The configs must be a JSON list");
+  const auto factories = opFactories();
+  const auto operators = splitOperators(FLAGS_operators);
+  const auto label = cpuCapabilityName();
+  int num_benchmarks = 0;
+  for (const auto& config : configs.array) {
+    const auto* framework = config.get("framework");
+    const auto* op = config.get("operator");
+    const auto* test_name = config.get("test_name");
+    const auto* run_backward = config.get("run_backward");
+    const auto* attrs_json = config.get("attrs");
+    TORCH_CHECK(
+        framework && op && test_name && attrs_json,
+        "Malformed test config in ", FLAGS_op_configs);
+    if (framework->str != "PyTorch" || (run_backward && run_backward->boolean)) {
+      continue;
+    }
+    if (!operators.empty() &&
+        std::find(operators.begin(), operators.end(), op->str) ==
+            operators.end()) {
+      continue;
+    }
+    auto factory = factories.find(op->str);
+    if (factory == factories.end()) {
+      std::cerr << "Skipping " << test_name->str << ": " << op->str
+                << " is not supported" << std::endl;
+      continue;
+    }
+    Attrs attrs;
+    for (const auto& kv : attrs_json->object) {
+      attrs[kv.first] = kv.second.str;
+    }
+    if (attrs.count("device") && attrs["device"] != "cpu") {
+      continue;
+    }
+
+    auto factory_fn = factory->second;
+    benchmark::RegisterBenchmark(
+        test_name->str.c_str(),
+        [factory_fn, attrs, label](benchmark::State& state) {
+          at::manual_seed(0);
+          auto op_benchmark = factory_fn(attrs);
+          for (auto _ : state) {
+            op_benchmark.run();
+          }
+          state.SetBytesProcessed(state.iterations() * op_benchmark.bytes);
+          state.SetLabel(label);
+        })
+        ->Unit(benchmark::kNanosecond)
+        ->UseRealTime();
+    ++num_benchmarks;
+  }
+  return num_benchmarks;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  benchmark::Initialize(&argc, argv);
+  if (!c10::ParseCommandLineFlags(&argc, &argv)) {
+    std::cerr << "Failed to parse command line flags" << std::endl;
+    return 1;
+  }
+  TORCH_CHECK(!FLAGS_op_configs.empty(), "Please provide --op_configs");
+  at::set_num_threads(FLAGS_num_threads);
+
+  std::ifstream file(FLAGS_op_configs);
+  TORCH_CHECK(file, "Cannot open ", FLAGS_op_configs);
+  std::stringstream text;
+  text << file.rdbuf();
+  const auto configs = JsonParser(text.str()).parse();
+  if (registerBenchmarks(configs) == 0) {
+    std::cerr << "No supported test configs in " << FLAGS_op_configs
+              << std::endl;
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+  return 0;
+}
@@ -0,0 +1,91 @@
+#!/usr/bin/env python
+
+"""Generates a wide async_scheduling net to benchmark the latency of the
+critical path scheduler with caffe2_benchmark.
+
+The net has one long chain of FC ops next to many short branches, e.g.:
+
+  python critical_path_bench_gen.py --critical_path
+  caffe2_benchmark --init_net init_net.pb --net predict_net.pb \\
+      --input data --input_dims 64,256 --warmup 10 --iter 100 \\
+      --caffe2_net_async_thread_pool_size 4
+
+and the same without --critical_path for the FIFO baseline.
+"""
+
+from __future__ import absolute_import
+from __future__ import division
+from __future__ import print_function
+from __future__ import unicode_literals
+
+import argparse
+
+import numpy as np
+
+from caffe2.python.model_helper import ModelHelper
+from caffe2.python.predictor import mobile_exporter
+from caffe2.python import brew, utils, workspace
+
+
+def main(args):
+    model = ModelHelper(name=args.benchmark_name)
+    dim = args.dim
+
+    # short branches, listed first so that a FIFO scheduler runs them first
+    outputs = []
+    for i in range(args.width):
+        outputs.append(brew.fc(
+            model, args.input_name, "branch{}".format(i), dim, dim))
+
+    blob = args.input_name
+    for i in range(args.depth):
+        blob = brew.fc(model, blob, "chain{}".format(i), dim, dim)
+        blob = brew.relu(model, blob, blob)
+    outputs.append(blob)
+
+    workspace.FeedBlob(args.input_name, np.zeros((1, dim), dtype=np.float32))
+    workspace.RunNetOnce(model.param_init_net)
+
+    init_net, predict_net = mobile_exporter.Export(
+        workspace, model.net, model.params
+    )
+    predict_net.type = "async_scheduling"
+    del predict_net.external_output[:]
+    predict_net.external_output.extend(outputs)
+    if args.critical_path:
+        predict_net.arg.extend([
+            utils.MakeArgument("critical_path_scheduling", 1),
+            # measured op times refine the schema cost estimates
+            utils.MakeArgument("enable_profiling", 1),
+        ])
+
+    with open(args.predict_net, 'wb') as f:
+        f.write(predict_net.SerializeToString())
+    with open(args.init_net, 'wb') as f:
+        f.write(init_net.SerializeToString())
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(
+        description="Generates a wide net to benchmark the latency of the "
+        "critical path scheduler.")
+    parser.add_argument("--depth", help="Number of FC ops in the long chain.",
+                        type=int, default=16)
+    parser.add_argument("--width", help="Number of short branches.",
+                        type=int, default=32)
+    parser.add_argument("--dim", help="Input and output size of the FC ops.",
+                        type=int, default=256)
+    parser.add_argument("--critical_path",
+                        help="Enable the critical path scheduler.",
+                        action='store_true')
+    parser.add_argument("--init_net", help="Output initialization net.",
+                        default="init_net.pb")
+    parser.add_argument("--predict_net", help="Output prediction net.",
+                        default="predict_net.pb")
+    parser.add_argument("--benchmark_name",
+                        help="Name of the benchmark network",
+                        default="critical_path_benchmark")
+    parser.add_argument("--input_name", help="Name of the input blob.",
+                        default="data")
+    args = parser.parse_args()
+    main(args)
@@ -0,0 +1,464 @@
+// Benchmarks the CUDA caching allocator on allocation patterns of real
+// workloads, so that allocator modes can be compared on the same patterns:
+//
+//   transformer_training  activations kept from the forward to the backward
+//                         pass, freed in reverse, persistent gradients and
+//                         short lived temporaries
+//   variable_inference    per request activations sized by a random sequence
+//                         length, freed layer by layer
+//   multi_stream          allocations on several streams, some used on another
+//                         stream (recordStream) before being freed
+//
+// and on traces recorded with c10::cuda::CUDACachingAllocator::recordTrace()
+// (--trace). Each pattern reports the latency percentiles of malloc and free,
+// the peak allocated and reserved memory, the fragmentation (the fraction of
+// reserved memory not allocated) over time, and the number of cudaMalloc
+// calls. Only the allocator runs: no kernel touches the memory.
+//
+//   cuda_allocator_benchmark --patterns transformer_training,multi_stream
+//   cuda_allocator_benchmark --trace trace.txt --size_classes
+
+#include "c10/cuda/CUDACachingAllocator.h"
+#include "c10/cuda/CUDAFunctions.h"
+#include "c10/cuda/CUDAGuard.h"
+#include "c10/util/Flags.h"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <unordered_map>
+
+C10_DEFINE_string(
+    patterns,
+    "transformer_training,variable_inference,multi_stream",
+    "Comma separated synthetic patterns to run");
+C10_DEFINE_string(trace, "", "Allocator trace to run in place of the patterns");
+C10_DEFINE_int(steps, 10, "Training steps, requests or rounds per pattern");
+C10_DEFINE_int(layers, 6, "Layers of the transformer patterns");
+C10_DEFINE_int(batch, 8, "Batch size of the transformer patterns");
+C10_DEFINE_int(seq_len, 256, "(Maximum) sequence length of the patterns");
+C10_DEFINE_int(hidden, 1024, "Hidden size of the transformer patterns");
+C10_DEFINE_int(heads, 16, "Attention heads of the transformer patterns");
+C10_DEFINE_int(streams, 4, "Streams of the multi_stream pattern");
+C10_DEFINE_int(seed, 0, "Seed of the random sizes");
+C10_DEFINE_int(samples, 20, "Fragmentation samples printed per pattern");
+C10_DEFINE_bool(size_classes, false, "Serve small requests from size classes");
+C10_DEFINE_bool(expandable_segments, false, "Grow large segments in place");
+
+namespace {
+
+using namespace c10::cuda;
+using c10::cuda::CUDACachingAllocator::TraceEntry;
+
+typedef std::chrono::high_resolution_clock clock_type;
+
+// Builds a pattern as a trace, with ids in place of the addresses.
+class PatternBuilder {
+ public:
+  int64_t malloc(int64_t size, int64_t stream = 0) {
+    TraceEntry entry;
+    entry.action = TraceEntry::MALLOC;
+    entry.address = ++last_id_;
+    entry.size = std::max<int64_t>(size, 1);
+    entry.stream = stream;
+    trace_.push_back(entry);
+    return last_id_;
+  }
+
+  void free(int64_t id) {
+    TraceEntry entry;
+    entry.action = TraceEntry::FREE;
+    entry.address = id;
+    trace_.push_back(entry);
+  }
+
+  void record_stream(int64_t id, int64_t stream) {
+    TraceEntry entry;
+    entry.action = TraceEntry::RECORD_STREAM;
+    entry.address = id;
+    entry.stream = stream;
+    trace_.push_back(entry);
+  }
+
+  // A temporary allocated and freed right away, such as a kernel workspace.
+  void temporary(int64_t size, int64_t stream = 0) {
+    free(malloc(size, stream));
+  }
+
+  std::vector<TraceEntry> release() {
+    return std::move(trace_);
+  }
+
+ private:
+  int64_t last_id_ = 0;
+  std::vector<TraceEntry> trace_;
+};
+
+constexpr int64_t kFloat = 4;
+
+std::vector<TraceEntry> transformer_training() {
+  PatternBuilder builder;
+  const int64_t tokens = int64_t{FLAGS_batch} * FLAGS_seq_len;
+  const int64_t hidden = FLAGS_hidden;
+  const int64_t scores =
+      int64_t{FLAGS_batch} * FLAGS_heads * FLAGS_seq_len * FLAGS_seq_len;
+  // Weights and gradients live through the whole run: qkv, output
+  // projection and the two feed forward matrices of every layer.
+  const std::vector<int64_t> weight_sizes = {
+      3 * hidden * hidden, hidden * hidden, 4 * hidden * hidden,
+      4 * hidden * hidden};
+  std::vector<int64_t> weights;
+  std::vector<int64_t> grads;
+  for (int layer = 0; layer < FLAGS_layers; ++layer) {
+    for (auto size : weight_sizes) {
+      weights.push_back(builder.malloc(size * kFloat));
+    }
+  }
+
+  for (int step = 0; step < FLAGS_steps; ++step) {
+    std::vector<std::vector<int64_t>> saved(FLAGS_layers);
+    for (int layer = 0; layer < FLAGS_layers; ++layer) {
+      auto& activations = saved[layer];
+      activations.push_back(builder.malloc(3 * tokens * hidden * kFloat));
+      activations.push_back(builder.malloc(scores * kFloat));
+      // softmax of the scores, then the dropout mask
+      activations.push_back(builder.malloc(scores * kFloat));
+      activations.push_back(builder.malloc(scores));
+      builder.temporary(tokens * hidden * kFloat);
+      activations.push_back(builder.malloc(tokens * hidden * kFloat));
+      activations.push_back(builder.malloc(4 * tokens * hidden * kFloat));
+      builder.temporary(4 * tokens * hidden * kFloat);
+      activations.push_back(builder.malloc(tokens * hidden * kFloat));
+      // layer norm statistics
+      activations.push_back(builder.malloc(tokens * kFloat));
+      activations.push_back(builder.malloc(tokens * kFloat));
+    }
+
+    for (int layer = FLAGS_layers - 1; layer >= 0; --layer) {
+      const auto grad_output = builder.malloc(tokens * hidden * kFloat);
+      builder.temporary(4 * tokens * hidden * kFloat);
+      builder.temporary(scores * kFloat);
+      builder.temporary(3 * tokens * hidden * kFloat);
+      if (step == 0) {
+        for (auto size : weight_sizes) {
+          grads.push_back(builder.malloc(size * kFloat));
+        }
+      }
+      for (auto it = saved[layer].rbegin(); it != saved[layer].rend(); ++it) {
+        builder.free(*it);
+      }
+      builder.free(grad_output);
+    }
+
+    // Optimizer: a few small temporaries per parameter
+    for (size_t i = 0; i < weights.size(); ++i) {
+      builder.temporary(kFloat);
+      builder.temporary(kFloat * 2);
+    }
+  }
+
+  for (auto id : grads) {
+    builder.free(id);
+  }
+  for (auto id : weights) {
+    builder.free(id);
+  }
+  return builder.release();
+}
+
+std::vector<TraceEntry> variable_inference() {
+  PatternBuilder builder;
+  std::mt19937 generator(FLAGS_seed);
+  std::uniform_int_distribution<int> seq_len(1, FLAGS_seq_len);
+  const int64_t hidden = FLAGS_hidden;
+
+  for (int request = 0; request < FLAGS_steps * FLAGS_batch; ++request) {
+    const int64_t len = seq_len(generator);
+    const int64_t scores = FLAGS_heads * len * len;
+    const auto input = builder.malloc(len * hidden * kFloat);
+    auto hidden_state = input;
+    for (int layer = 0; layer < FLAGS_layers; ++layer) {
+      const auto qkv = builder.malloc(3 * len * hidden * kFloat);
+      const auto attn = builder.malloc(scores * kFloat);
+      const auto context = builder.malloc(len * hidden * kFloat);
+      builder.free(attn);
+      builder.free(qkv);
+      const auto ffn = builder.malloc(4 * len * hidden * kFloat);
+      const auto output = builder.malloc(len * hidden * kFloat);
+      builder.free(ffn);
+      builder.free(context);
+      builder.free(hidden_state);
+      hidden_state = output;
+    }
+    builder.free(hidden_state);
+  }
+  return builder.release();
+}
+
+std::vector<TraceEntry> multi_stream() {
+  PatternBuilder builder;
+  std::mt19937 generator(FLAGS_seed);
+  // Sizes from 512 bytes to 64 MiB, small ones more likely
+  std::uniform_int_distribution<int> log_size(9, 26);
+  std::uniform_int_distribution<int> stream_dist(0, FLAGS_streams - 1);
+  const size_t kLivePerStream = 32;
+
+  std::vector<std::vector<int64_t>> live(FLAGS_streams);
+  for (int round = 0; round < FLAGS_steps * 100; ++round) {
+    const int64_t stream = stream_dist(generator);
+    const int64_t size = int64_t{1} << std::min(log_size(generator), log_size(generator));
+    const auto id = builder.malloc(size + size / 3, stream);
+    // A quarter of the blocks are also used on another stream
+    if (round % 4 == 0 && FLAGS_streams > 1) {
+      builder.record_stream(id, (stream + 1) % FLAGS_streams);
+    }
+    auto& blocks = live[stream];
+    blocks.push_back(id);
+    if (blocks.size() > kLivePerStream) {
+      std::uniform_int_distribution<size_t> victim(0, blocks.size() - 1);
+      const auto index = victim(generator);
+      builder.free(blocks[index]);
+      blocks.erase(blocks.begin() + index);
+    }
+  }
+  for (const auto& blocks : live) {
+    for (auto id : blocks) {
+      builder.free(id);
+    }
+  }
+  return builder.release();
+}
+
+struct Sample {
+  size_t event;
+  int64_t allocated;
+  int64_t reserved;
+};
+
+struct RunResult {
+  std::vector<double> malloc_ns;
+  std::vector<double> free_ns;
+  std::vector<Sample> samples;
+  int64_t ooms = 0;
+};
+
+CUDAStream get_stream(
+    std::unordered_map<int64_t, CUDAStream>& streams,
+    int64_t device,
+    int64_t recorded) {
+  auto it = streams.find(recorded);
+  if (it != streams.end()) {
+    return it->second;
+  }
+  CUDAStream stream = recorded == 0
+      ? getDefaultCUDAStream(device)
+      : getStreamFromPool(/*isHighPriority=*/false, device);
+  streams.emplace(recorded, stream);
+  return stream;
+}
+
+RunResult run(const std::vector<TraceEntry>& trace, int device) {
+  using CUDACachingAllocator::StatType;
+  const size_t all = static_cast<size_t>(StatType::AGGREGATE);
+  const size_t sample_every =
+      std::max<size_t>(1, trace.size() / std::max(FLAGS_samples, 1));
+
+  RunResult result;
+  std::unordered_map<int64_t, void*> live;
+  std::unordered_map<int64_t, CUDAStream> streams;
+  CUDAGuard device_guard(device);
+
+  for (size_t i = 0; i < trace.size(); ++i) {
+    const TraceEntry& entry = trace[i];
+    switch (entry.action) {
+      case TraceEntry::MALLOC: {
+        CUDAStreamGuard stream_guard(get_stream(streams, device, entry.stream));
+        const auto start = clock_type::now();
+        void* ptr = nullptr;
+        try {
+          ptr = CUDACachingAllocator::raw_alloc(entry.size);
+        } catch (const c10::Error&) {
+          result.ooms++;
+          break;
+        }
+        result.malloc_ns.push_back(std::chrono::duration<double, std::nano>(
+                                       clock_type::now() - start)
+                                       .count());
+        live[entry.address] = ptr;
+        break;
+      }
+      case TraceEntry::FREE: {
+        auto it = live.find(entry.address);
+        if (it == live.end()) {
+          break;
+        }
+        const auto start = clock_type::now();
+        CUDACachingAllocator::raw_delete(it->second);
+        result.free_ns.push_back(std::chrono::duration<double, std::nano>(
+                                     clock_type::now() - start)
+                                     .count());
+        live.erase(it);
+        break;
+      }
+      case TraceEntry::RECORD_STREAM: {
+        auto it = live.find(entry.address);
+        if (it != live.end()) {
+          CUDACachingAllocator::recordStream(
+              it->second, get_stream(streams, device, entry.stream));
+        }
+        break;
+      }
+      case TraceEntry::EMPTY_CACHE:
+        CUDACachingAllocator::emptyCache();
+        break;
+    }
+    if (i % sample_every == 0) {
+      const auto stats = CUDACachingAllocator::getDeviceStats(device);
+      result.samples.push_back({i,
+                                stats.allocated_bytes[all].current,
+                                stats.reserved_bytes[all].current});
+    }
+  }
+
+  for (const auto& item : live) {
+    CUDACachingAllocator::raw_delete(item.second);
+  }
+  return result;
+}
+
+double percentile(const std::vector<double>& sorted, double p) {
+  if (sorted.empty()) {
+    return 0;
+  }
+  const size_t index = std::min(
+      sorted.size() - 1, static_cast<size_t>(p / 100 * sorted.size()));
+  return sorted[index];
+}
+
+void print_latency(const char* name, std::vector<double> times) {
+  std::sort(times.begin(), times.end());
+  std::cout << "  " << std::left << std::setw(8) << name << std::right
+            << std::setw(9) << times.size() << " calls, ns: p50 "
+            << percentile(times, 50) << ", p90 " << percentile(times, 90)
+            << ", p99 " << percentile(times, 99) << ", max "
+            << (times.empty() ? 0 : times.back()) << std::endl;
+}
+
+double fragmentation(int64_t allocated, int64_t reserved) {
+  return reserved > 0 ? 100.0 * (reserved - allocated) / reserved : 0.0;
+}
+
+void benchmark(const std::string& name, const std::vector<TraceEntry>& trace) {
+  using CUDACachingAllocator::StatType;
+  const size_t all = static_cast<size_t>(StatType::AGGREGATE);
+  const int device = current_device();
+
+  // Every pattern starts from an empty cache
+  CUDACachingAllocator::emptyCache();
+  CUDACachingAllocator::resetAccumulatedStats(device);
+  CUDACachingAllocator::resetPeakStats(device);
+
+  const RunResult result = run(trace, device);
+  const auto stats = CUDACachingAllocator::getDeviceStats(device);
+  const int64_t peak_allocated = stats.allocated_bytes[all].peak;
+  const int64_t peak_reserved = stats.reserved_bytes[all].peak;
+
+  std::cout << name << " (" << trace.size() << " events):" << std::endl;
+  print_latency("malloc", result.malloc_ns);
+  print_latency("free", result.free_ns);
+  std::cout << "  peak allocated MiB:  " << peak_allocated / 1048576.0
+            << std::endl
+            << "  peak reserved MiB:   " << peak_reserved / 1048576.0
+            << " (" << fragmentation(peak_allocated, peak_reserved)
+            << "% above allocated)" << std::endl
+            << "  cudaMalloc calls:    " << stats.segment[all].allocated
+            << std::endl
+            << "  cudaMalloc retries:  " << stats.num_alloc_retries
+            << std::endl
+            << "  OOMs:                " << result.ooms << std::endl;
+
+  double max_fragmentation = 0;
+  double sum_fragmentation = 0;
+  std::ostringstream series;
+  for (const auto& sample : result.samples) {
+    const double frag = fragmentation(sample.allocated, sample.reserved);
+    max_fragmentation = std::max(max_fragmentation, frag);
+    sum_fragmentation += frag;
+    series << std::setw(10) << sample.event << std::setw(12) << std::fixed
+           << std::setprecision(1) << sample.allocated / 1048576.0
+           << std::setw(12) << sample.reserved / 1048576.0 << std::setw(8)
+           << frag << "%" << std::endl;
+  }
+  std::cout << "  fragmentation:       mean "
+            << (result.samples.empty()
+                    ? 0
+                    : sum_fragmentation / result.samples.size())
+            << "%, max " << max_fragmentation << "%" << std::endl
+            << "  over time:" << std::endl
+            << std::setw(10) << "event" << std::setw(12) << "alloc MiB"
+            << std::setw(12) << "resv MiB" << std::setw(9) << "frag"
+            << std::endl
+            << series.str();
+  std::cout.unsetf(std::ios::fixed);
+}
+
+std::vector<std::string> split(const std::string& string, char separator) {
+  std::vector<std::string> pieces;
+  std::stringstream ss(string);
+  std::string item;
+  while (std::getline(ss, item, separator)) {
+    if (!item.empty()) {
+      pieces.push_back(item);
+    }
+  }
+  return pieces;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  c10::SetUsageMessage(
+      "Benchmarks the CUDA caching allocator on synthetic allocation patterns "
+      "or a recorded trace.");
+  if (!c10::ParseCommandLineFlags(&argc, &argv)) {
+    std::cout << "Failed to parse command line flags" << std::endl;
+    return -1;
+  }
+  TORCH_CHECK(device_count() > 0, "no CUDA device available");
+  CUDACachingAllocator::setSizeClassMode(FLAGS_size_classes);
+  CUDACachingAllocator::setExpandableSegments(FLAGS_expandable_segments);
+  std::cout << "size classes: " << FLAGS_size_classes
+            << ", expandable segments: " << FLAGS_expandable_segments
+            << std::endl;
+
+  if (!FLAGS_trace.empty()) {
+    std::ifstream in(FLAGS_trace);
+    if (!in) {
+      std::cout << "Cannot open " << FLAGS_trace << std::endl;
+      return -1;
+    }
+    // Recorded traces are replayed on the current device
+    benchmark(FLAGS_trace, CUDACachingAllocator::readTrace(in));
+    return 0;
+  }
+
+  const std::unordered_map<std::string, std::vector<TraceEntry> (*)()>
+      generators = {
+          {"transformer_training", &transformer_training},
+          {"variable_inference", &variable_inference},
+          {"multi_stream", &multi_stream},
+      };
+  for (const auto& name : split(FLAGS_patterns, ',')) {
+    auto it = generators.find(name);
+    if (it == generators.end()) {
+      std::cout << "Unknown pattern " << name << std::endl;
+      return -1;
+    }
+    benchmark(name, it->second());
+  }
+  return 0;
+}
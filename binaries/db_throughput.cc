@@ -22,6 +22,8 @@
 #include "caffe2/core/init.h"
 #include "caffe2/core/timer.h"
 #include "caffe2/core/logging.h"
+#include "caffe2/core/prefetching_db_reader.h"
+#include "caffe2/proto/caffe2_pb.h"
 
 C10_DEFINE_string(input_db, "", "The input db.");
 C10_DEFINE_string(input_db_type, "", "The input db type.");
@@ -32,10 +34,24 @@ C10_DEFINE_int(
     num_read_threads,
     1,
     "The number of concurrent reading threads.");
+C10_DEFINE_int(
+    num_decode_threads,
+    0,
+    "If positive, read through a PrefetchingDBReader that parses the values "
+    "as TensorProtos on this many threads.");
+C10_DEFINE_int(
+    decode_queue_size,
+    64,
+    "The number of items read ahead by the PrefetchingDBReader.");
+C10_DEFINE_bool(
+    decode_ordered,
+    true,
+    "If true, the PrefetchingDBReader returns the items in the db order.");
 
 using caffe2::db::Cursor;
 using caffe2::db::DB;
 using caffe2::db::DBReader;
+using caffe2::db::PrefetchingDBReader;
 using caffe2::string;
 
 void TestThroughputWithDB() {
@@ -93,9 +109,37 @@ void TestThroughputWithReader() {
   }
 }
 
+void TestThroughputWithPrefetchingReader() {
+  caffe2::db::DBReader reader(FLAGS_input_db_type, FLAGS_input_db);
+  PrefetchingDBReader<caffe2::TensorProtos> prefetching_reader(
+      &reader,
+      [](const string& /*key*/, const string& value) {
+        caffe2::TensorProtos protos;
+        CAFFE_ENFORCE(protos.ParseFromString(value));
+        return protos;
+      },
+      FLAGS_num_decode_threads,
+      FLAGS_decode_queue_size,
+      FLAGS_decode_ordered);
+  for (int iter_id = 0; iter_id < FLAGS_repeat; ++iter_id) {
+    caffe2::Timer timer;
+    for (int i = 0; i < FLAGS_report_interval; ++i) {
+      prefetching_reader.Next();
+    }
+    double elapsed_seconds = timer.Seconds();
+    printf(
+        "Iteration %03d, took %4.5f seconds, throughput %f items/sec.\n",
+        iter_id,
+        elapsed_seconds,
+        FLAGS_report_interval / elapsed_seconds);
+  }
+}
+
 int main(int argc, char** argv) {
   caffe2::GlobalInit(&argc, &argv);
-  if (FLAGS_use_reader) {
+  if (FLAGS_num_decode_threads > 0) {
+    TestThroughputWithPrefetchingReader();
+  } else if (FLAGS_use_reader) {
     TestThroughputWithReader();
   } else {
     TestThroughputWithDB();
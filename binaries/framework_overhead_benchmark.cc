@@ -0,0 +1,196 @@
+/**
+ * Copyright (c) 2016-present, Facebook, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// C++ portion of benchmarks/framework_overhead_benchmark: the per-op overhead
+// of each layer an op call goes through, measured with kernels doing no work.
+// Each benchmark makes kOpsPerIteration calls per iteration, so items_per_second
+// is the number of op calls per second, and the difference between two
+// benchmarks is the cost of the layer added by the second one:
+//
+//   BM_DirectCall                    the kernel called as a function
+//   BM_DispatcherCallUnboxed         + c10::Dispatcher::callUnboxed
+//   BM_AtenOp/BM_AtenOpVariable*     an ATen op (alias), then with the
+//                                    Variable/autograd wrapping of VariableType
+//   BM_RecordFunction*               + RECORD_FUNCTION without callbacks, with
+//                                    a callback, with a sampled callback
+//   BM_InterpreterOp                 + the JIT interpreter OP instruction
+
+#include "benchmark/benchmark.h"
+
+#include <ATen/ATen.h>
+#include <ATen/core/dispatch/Dispatcher.h>
+#include <ATen/core/op_registration/op_registration.h>
+#include <torch/csrc/autograd/record_function.h>
+#include <torch/csrc/autograd/variable.h>
+#include <torch/csrc/jit/interpreter.h>
+#include <torch/csrc/jit/ir.h>
+#include <torch/csrc/jit/irparser.h>
+
+#include <sstream>
+
+#if defined(__GNUC__)
+#define NOINLINE __attribute__((noinline))
+#else
+#define NOINLINE
+#endif
+
+namespace {
+
+constexpr int kOpsPerIteration = 100;
+
+NOINLINE at::Tensor noop(const at::Tensor& self) {
+  return self;
+}
+
+const c10::OperatorHandle& noopOp() {
+  static auto registry = c10::RegisterOperators().op(
+      "_overhead_benchmark::noop(Tensor self) -> Tensor",
+      c10::RegisterOperators::options()
+          .catchAllKernel<decltype(noop), &noop>());
+  static const auto op = c10::Dispatcher::singleton().findSchema(
+      {"_overhead_benchmark::noop", ""});
+  TORCH_CHECK(op.has_value());
+  return *op;
+}
+
+at::Tensor noopDispatched(const at::Tensor& self) {
+  return c10::Dispatcher::singleton().callUnboxed<at::Tensor, const at::Tensor&>(
+      noopOp(), self);
+}
+
+at::Tensor input() {
+  return at::ones({1});
+}
+
+void BM_DirectCall(benchmark::State& state) {
+  auto x = input();
+  for (auto _ : state) {
+    for (int i = 0; i < kOpsPerIteration; ++i) {
+      benchmark::DoNotOptimize(noop(x));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kOpsPerIteration);
+}
+BENCHMARK(BM_DirectCall);
+
+void BM_DispatcherCallUnboxed(benchmark::State& state) {
+  auto x = input();
+  for (auto _ : state) {
+    for (int i = 0; i < kOpsPerIteration; ++i) {
+      benchmark::DoNotOptimize(noopDispatched(x));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kOpsPerIteration);
+}
+BENCHMARK(BM_DispatcherCallUnboxed);
+
+void runAlias(benchmark::State& state, const at::Tensor& x) {
+  for (auto _ : state) {
+    for (int i = 0; i < kOpsPerIteration; ++i) {
+      benchmark::DoNotOptimize(at::alias(x));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kOpsPerIteration);
+}
+
+void BM_AtenOp(benchmark::State& state) {
+  auto x = torch::autograd::make_variable(input());
+  at::AutoNonVariableTypeMode non_var_type_mode(true);
+  runAlias(state, x);
+}
+BENCHMARK(BM_AtenOp);
+
+void BM_AtenOpVariable(benchmark::State& state) {
+  runAlias(state, torch::autograd::make_variable(input()));
+}
+BENCHMARK(BM_AtenOpVariable);
+
+void BM_AtenOpVariableRequiresGrad(benchmark::State& state) {
+  runAlias(
+      state,
+      torch::autograd::make_variable(input(), /*requires_grad=*/true));
+}
+BENCHMARK(BM_AtenOpVariableRequiresGrad);
+
+NOINLINE at::Tensor recordedNoop(const at::Tensor& self) {
+  RECORD_FUNCTION("noop", std::vector<c10::IValue>({self}));
+  return noopDispatched(self);
+}
+
+void runRecordedNoop(benchmark::State& state) {
+  auto x = input();
+  for (auto _ : state) {
+    for (int i = 0; i < kOpsPerIteration; ++i) {
+      benchmark::DoNotOptimize(recordedNoop(x));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kOpsPerIteration);
+}
+
+void BM_RecordFunction(benchmark::State& state) {
+  runRecordedNoop(state);
+}
+BENCHMARK(BM_RecordFunction);
+
+void BM_RecordFunctionCallback(benchmark::State& state) {
+  torch::autograd::profiler::pushCallback(
+      [](const torch::autograd::profiler::RecordFunction&) {});
+  runRecordedNoop(state);
+  torch::autograd::profiler::popCallback();
+}
+BENCHMARK(BM_RecordFunctionCallback);
+
+void BM_RecordFunctionSampledCallback(benchmark::State& state) {
+  torch::autograd::profiler::pushSampledCallback(
+      [](const torch::autograd::profiler::RecordFunction&) {},
+      [](const torch::autograd::profiler::RecordFunction&) {},
+      /*sampling_prob=*/0.01);
+  runRecordedNoop(state);
+  torch::autograd::profiler::popCallback();
+}
+BENCHMARK(BM_RecordFunctionSampledCallback);
+
+// A graph chaining kOpsPerIteration noops, so that each run is one iteration
+std::shared_ptr<torch::jit::Graph> noopGraph() {
+  std::ostringstream ir;
+  ir << "graph(%x0 : Tensor):\n";
+  for (int i = 1; i <= kOpsPerIteration; ++i) {
+    ir << "  %x" << i << " : Tensor = _overhead_benchmark::noop(%x" << i - 1
+       << ")\n";
+  }
+  ir << "  return (%x" << kOpsPerIteration << ")\n";
+  auto graph = std::make_shared<torch::jit::Graph>();
+  torch::jit::script::parseIR(ir.str(), graph.get());
+  return graph;
+}
+
+void BM_InterpreterOp(benchmark::State& state) {
+  noopOp();
+  torch::jit::Code code(noopGraph());
+  auto x = input();
+  torch::jit::Stack stack;
+  for (auto _ : state) {
+    stack.emplace_back(x);
+    torch::jit::InterpreterState(code).run(stack);
+    stack.clear();
+  }
+  state.SetItemsProcessed(state.iterations() * kOpsPerIteration);
+}
+BENCHMARK(BM_InterpreterOp);
+
+} // namespace
+
+BENCHMARK_MAIN();
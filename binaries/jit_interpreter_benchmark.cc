@@ -0,0 +1,77 @@
+#include "torch/csrc/jit/instruction.h"
+#include "torch/csrc/jit/interpreter.h"
+#include "torch/csrc/jit/ir.h"
+#include "torch/csrc/jit/irparser.h"
+
+#include "c10/util/Flags.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <sstream>
+
+C10_DEFINE_int(ops, 100, "Number of scalar ops in the benchmarked graph");
+C10_DEFINE_int(iter, 10e4, "Number of runs of the graph");
+C10_DEFINE_int(warmup_iter, 100, "Number of warmup runs");
+C10_DEFINE_int(benchmark_iter, 3, "Number of times to run benchmark");
+
+namespace {
+
+// A chain of integer additions: for graphs like this one, the time goes into
+// the interpreter itself rather than into the ops.
+std::shared_ptr<torch::jit::Graph> buildGraph(int num_ops) {
+  std::stringstream ir;
+  ir << "graph(%a0 : int, %b : int):\n";
+  for (int i = 0; i < num_ops; ++i) {
+    ir << "  %a" << i + 1 << " : int = aten::add(%a" << i << ", %b)\n";
+  }
+  ir << "  return (%a" << num_ops << ")\n";
+  auto graph = std::make_shared<torch::jit::Graph>();
+  torch::jit::script::parseIR(ir.str(), graph.get());
+  return graph;
+}
+
+void run(const torch::jit::Code& code, int iter) {
+  for (int i = 0; i < iter; ++i) {
+    torch::jit::Stack stack{int64_t(0), int64_t(1)};
+    torch::jit::InterpreterState(code).run(stack);
+    if (stack.back().toInt() != FLAGS_ops) {
+      std::cerr << "Wrong result " << stack.back().toInt() << std::endl;
+      std::exit(1);
+    }
+  }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  if (!c10::ParseCommandLineFlags(&argc, &argv)) {
+    std::cout << "Failed to parse command line flags" << std::endl;
+    return -1;
+  }
+
+  typedef std::chrono::high_resolution_clock clock;
+  typedef std::chrono::nanoseconds ns;
+
+  torch::jit::Code code(buildGraph(FLAGS_ops));
+  const size_t num_instructions = code.instructions().size();
+  std::cout << "Running a graph of " << FLAGS_ops << " ops, "
+            << num_instructions << " instructions" << std::endl;
+
+  run(code, FLAGS_warmup_iter);
+
+  for (auto bench_iter = 0; bench_iter < FLAGS_benchmark_iter; ++bench_iter) {
+    auto start_time = clock::now();
+    run(code, FLAGS_iter);
+    auto duration = static_cast<double>(
+        std::chrono::duration_cast<ns>(clock::now() - start_time).count());
+
+    std::cout << "Time per run " << duration / FLAGS_iter << " ns, per op "
+              << duration / FLAGS_iter / FLAGS_ops << " ns, per instruction "
+              << duration / FLAGS_iter / num_instructions << " ns."
+              << std::endl;
+  }
+
+  return 0;
+}
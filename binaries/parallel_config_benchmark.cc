@@ -0,0 +1,424 @@
+/**
+ * Copyright (c) 2016-present, Facebook, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Sweeps the number of intra-op threads, inter-op threads and concurrent
+// requests for a TorchScript model, and recommends the configuration with the
+// best throughput (within a latency budget, if given) for the cores and NUMA
+// nodes of the host.
+//
+// The thread pools can only be sized once per process, so each pair of
+// thread counts runs in a child process (this binary with --config), which
+// sweeps the concurrent requests and prints one RESULT line per run.
+
+#include "ATen/ATen.h"
+#include "ATen/Parallel.h"
+#include "c10/util/Flags.h"
+#include "caffe2/core/init.h"
+#include "torch/csrc/autograd/grad_mode.h"
+#include "torch/script.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#define popen _popen
+#define pclose _pclose
+#endif
+
+C10_DEFINE_string(model, "", "The given torch script model to benchmark.");
+C10_DEFINE_string(
+    input_dims,
+    "",
+    "The dimensions of the inputs, which are all ones, as comma separated "
+    "numbers. If multiple inputs are needed, use semicolon to separate the "
+    "dimensions of different tensors.");
+C10_DEFINE_string(input_type, "", "Input types (uint8_t/float/int64)");
+C10_DEFINE_string(
+    intra_op_threads,
+    "",
+    "Comma separated intra-op thread counts to try, powers of two up to the "
+    "number of physical cores if empty");
+C10_DEFINE_string(
+    inter_op_threads,
+    "1,2,4",
+    "Comma separated inter-op thread counts to try");
+C10_DEFINE_string(
+    concurrency,
+    "",
+    "Comma separated numbers of concurrent requests to try, powers of two up "
+    "to the number of physical cores if empty");
+C10_DEFINE_int(warmup, 5, "Warmup iterations of each request thread");
+C10_DEFINE_int(iter, 20, "Measured iterations of each request thread");
+C10_DEFINE_double(
+    max_p99_latency_ms,
+    0,
+    "If positive, only recommend configurations within this p99 latency");
+C10_DEFINE_bool(
+    allow_oversubscription,
+    false,
+    "Also try configurations using more threads than logical cores");
+C10_DEFINE_string(
+    config,
+    "",
+    "intra,inter: run the sweep of concurrent requests for these thread "
+    "counts and print the results, used by the child processes");
+
+namespace {
+
+struct Result {
+  int intra_op_threads;
+  int inter_op_threads;
+  int concurrency;
+  double throughput;
+  double p50_ms;
+  double p99_ms;
+};
+
+std::vector<std::string> split(char separator, const std::string& string) {
+  std::vector<std::string> pieces;
+  std::stringstream ss(string);
+  std::string item;
+  while (getline(ss, item, separator)) {
+    if (!item.empty()) {
+      pieces.push_back(std::move(item));
+    }
+  }
+  return pieces;
+}
+
+std::vector<int> parseInts(const std::string& string) {
+  std::vector<int> values;
+  for (const auto& s : split(',', string)) {
+    values.push_back(c10::stoi(s));
+  }
+  return values;
+}
+
+std::vector<int> powersOfTwoUpTo(int max) {
+  std::vector<int> values;
+  for (int value = 1; value < max; value *= 2) {
+    values.push_back(value);
+  }
+  values.push_back(max);
+  return values;
+}
+
+// The layout of the cores of the host, from sysfs on Linux
+struct CpuLayout {
+  int logical_cores = 1;
+  int physical_cores = 1;
+  int numa_nodes = 1;
+
+  CpuLayout() {
+    logical_cores = std::max(1u, std::thread::hardware_concurrency());
+    physical_cores = logical_cores;
+#ifdef __linux__
+    std::set<std::pair<int, int>> cores;
+    for (int cpu = 0; cpu < logical_cores; ++cpu) {
+      const std::string topology =
+          "/sys/devices/system/cpu/cpu" + c10::to_string(cpu) + "/topology/";
+      std::ifstream package_file(topology + "physical_package_id");
+      std::ifstream core_file(topology + "core_id");
+      int package = 0;
+      int core = 0;
+      if (package_file >> package && core_file >> core) {
+        cores.emplace(package, core);
+      }
+    }
+    if (!cores.empty()) {
+      physical_cores = cores.size();
+    }
+    int nodes = 0;
+    while (std::ifstream(
+        "/sys/devices/system/node/node" + c10::to_string(nodes) + "/cpulist")) {
+      ++nodes;
+    }
+    numa_nodes = std::max(nodes, 1);
+#endif
+  }
+};
+
+std::vector<c10::IValue> createInputs() {
+  std::vector<std::string> input_dims_list = split(';', FLAGS_input_dims);
+  std::vector<std::string> input_type_list = split(';', FLAGS_input_type);
+  CAFFE_ENFORCE_EQ(
+      input_dims_list.size(),
+      input_type_list.size(),
+      "Input dims and type should have the same number of items.");
+
+  std::vector<c10::IValue> inputs;
+  for (size_t i = 0; i < input_dims_list.size(); ++i) {
+    std::vector<int64_t> input_dims;
+    for (const auto& s : split(',', input_dims_list[i])) {
+      input_dims.push_back(c10::stoi(s));
+    }
+    if (input_type_list[i] == "float") {
+      inputs.push_back(torch::ones(input_dims, at::ScalarType::Float));
+    } else if (input_type_list[i] == "uint8_t") {
+      inputs.push_back(torch::ones(input_dims, at::ScalarType::Byte));
+    } else if (input_type_list[i] == "int64") {
+      inputs.push_back(torch::ones(input_dims, torch::kI64));
+    } else {
+      CAFFE_THROW("Unsupported input type: ", input_type_list[i]);
+    }
+  }
+  return inputs;
+}
+
+double percentile(const std::vector<double>& sorted, double p) {
+  const size_t index = std::min(
+      sorted.size() - 1, static_cast<size_t>(p / 100 * sorted.size()));
+  return sorted[index];
+}
+
+// Runs concurrency threads each sending requests to module one after another
+Result runRequests(
+    torch::jit::script::Module& module,
+    const std::vector<c10::IValue>& inputs,
+    int concurrency) {
+  typedef std::chrono::high_resolution_clock clock;
+  std::vector<std::vector<double>> latencies(concurrency);
+  auto request_loop = [&](int thread_id) {
+    at::init_num_threads();
+    torch::autograd::AutoGradMode guard(false);
+    for (int i = 0; i < FLAGS_warmup; ++i) {
+      module.forward(inputs);
+    }
+    for (int i = 0; i < FLAGS_iter; ++i) {
+      auto start = clock::now();
+      module.forward(inputs);
+      latencies[thread_id].push_back(
+          std::chrono::duration<double, std::milli>(clock::now() - start)
+              .count());
+    }
+  };
+
+  auto start = clock::now();
+  std::vector<std::thread> threads;
+  for (int i = 0; i < concurrency; ++i) {
+    threads.emplace_back(request_loop, i);
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  const double seconds =
+      std::chrono::duration<double>(clock::now() - start).count();
+
+  std::vector<double> all_latencies;
+  for (const auto& thread_latencies : latencies) {
+    all_latencies.insert(
+        all_latencies.end(), thread_latencies.begin(), thread_latencies.end());
+  }
+  std::sort(all_latencies.begin(), all_latencies.end());
+  // The warmup is part of the wall time, count its requests as well
+  const double requests = concurrency * (FLAGS_warmup + FLAGS_iter);
+  return {at::get_num_threads(),
+          at::get_num_interop_threads(),
+          concurrency,
+          requests / seconds,
+          percentile(all_latencies, 50),
+          percentile(all_latencies, 99)};
+}
+
+std::vector<int> concurrencyLevels(const CpuLayout& layout) {
+  return FLAGS_concurrency.empty() ? powersOfTwoUpTo(layout.physical_cores)
+                                   : parseInts(FLAGS_concurrency);
+}
+
+// Child process: sweeps the concurrent requests with the given thread counts
+int runConfig(const CpuLayout& layout) {
+  const auto config = parseInts(FLAGS_config);
+  CAFFE_ENFORCE_EQ(config.size(), 2, "--config should be intra,inter");
+  at::set_num_interop_threads(config[1]);
+  at::set_num_threads(config[0]);
+  at::init_num_threads();
+
+  auto inputs = createInputs();
+  torch::autograd::AutoGradMode guard(false);
+  auto module = torch::jit::load(FLAGS_model);
+  module.eval();
+
+  for (int concurrency : concurrencyLevels(layout)) {
+    if (!FLAGS_allow_oversubscription &&
+        config[0] * concurrency > layout.logical_cores) {
+      continue;
+    }
+    const auto result = runRequests(module, inputs, concurrency);
+    std::cout << "RESULT " << result.intra_op_threads << " "
+              << result.inter_op_threads << " " << result.concurrency << " "
+              << result.throughput << " " << result.p50_ms << " "
+              << result.p99_ms << std::endl;
+  }
+  return 0;
+}
+
+std::vector<Result> runChild(
+    const std::string& binary,
+    int intra_op_threads,
+    int inter_op_threads) {
+  std::ostringstream cmd;
+  cmd << "\"" << binary << "\" --config=" << intra_op_threads << ","
+      << inter_op_threads << " --model=\"" << FLAGS_model << "\""
+      << " --input_dims=\"" << FLAGS_input_dims << "\""
+      << " --input_type=\"" << FLAGS_input_type << "\""
+      << " --concurrency=\"" << FLAGS_concurrency << "\""
+      << " --warmup=" << FLAGS_warmup << " --iter=" << FLAGS_iter
+      << " --allow_oversubscription="
+      << (FLAGS_allow_oversubscription ? "true" : "false");
+
+  std::vector<Result> results;
+  FILE* pipe = popen(cmd.str().c_str(), "r");
+  CAFFE_ENFORCE(pipe, "Failed to run ", cmd.str());
+  char line[512];
+  while (fgets(line, sizeof(line), pipe)) {
+    std::istringstream stream(line);
+    std::string tag;
+    Result result;
+    if (stream >> tag && tag == "RESULT" &&
+        stream >> result.intra_op_threads >> result.inter_op_threads >>
+            result.concurrency >> result.throughput >> result.p50_ms >>
+            result.p99_ms) {
+      results.push_back(result);
+    }
+  }
+  if (pclose(pipe) != 0) {
+    std::cerr << "Configuration intra " << intra_op_threads << ", inter "
+              << inter_op_threads << " failed" << std::endl;
+  }
+  return results;
+}
+
+void printResult(const Result& result) {
+  std::cout << std::setw(8) << result.intra_op_threads << std::setw(8)
+            << result.inter_op_threads << std::setw(12) << result.concurrency
+            << std::setw(14) << std::fixed << std::setprecision(2)
+            << result.throughput << std::setw(10) << result.p50_ms
+            << std::setw(10) << result.p99_ms << std::endl;
+}
+
+void printHeader() {
+  std::cout << std::setw(8) << "intra" << std::setw(8) << "inter"
+            << std::setw(12) << "concurrency" << std::setw(14) << "requests/s"
+            << std::setw(10) << "p50 ms" << std::setw(10) << "p99 ms"
+            << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  c10::SetUsageMessage(
+      "Find the best thread configuration for a torch script model.\n"
+      "Example usage:\n"
+      "./parallel_config_benchmark"
+      " --model=<model_file>"
+      " --input_dims=\"1,3,224,224\""
+      " --input_type=float"
+      " --max_p99_latency_ms=50");
+  if (!c10::ParseCommandLineFlags(&argc, &argv)) {
+    std::cerr << "Failed to parse command line flags!" << std::endl;
+    return 1;
+  }
+  CAFFE_ENFORCE(!FLAGS_model.empty(), "Please provide --model.");
+  caffe2::unsafeRunCaffe2InitFunction("registerThreadPools");
+
+  const CpuLayout layout;
+  if (!FLAGS_config.empty()) {
+    return runConfig(layout);
+  }
+
+  std::cout << "Host: " << layout.logical_cores << " logical cores, "
+            << layout.physical_cores << " physical cores, "
+            << layout.numa_nodes << " NUMA nodes" << std::endl;
+  const auto intra_op_threads = FLAGS_intra_op_threads.empty()
+      ? powersOfTwoUpTo(layout.physical_cores)
+      : parseInts(FLAGS_intra_op_threads);
+  const auto inter_op_threads = parseInts(FLAGS_inter_op_threads);
+
+  printHeader();
+  std::vector<Result> results;
+  for (int intra : intra_op_threads) {
+    for (int inter : inter_op_threads) {
+      for (const auto& result : runChild(argv[0], intra, inter)) {
+        printResult(result);
+        results.push_back(result);
+      }
+    }
+  }
+  CAFFE_ENFORCE(!results.empty(), "No configuration ran successfully");
+
+  const Result* best = nullptr;
+  const Result* best_latency = nullptr;
+  for (const auto& result : results) {
+    if (!best_latency || result.p50_ms < best_latency->p50_ms) {
+      best_latency = &result;
+    }
+    if (FLAGS_max_p99_latency_ms > 0 &&
+        result.p99_ms > FLAGS_max_p99_latency_ms) {
+      continue;
+    }
+    if (!best || result.throughput > best->throughput) {
+      best = &result;
+    }
+  }
+
+  std::cout << std::endl << "Lowest latency:" << std::endl;
+  printHeader();
+  printResult(*best_latency);
+  if (!best) {
+    std::cout << "No configuration is within a p99 latency of "
+              << FLAGS_max_p99_latency_ms << " ms" << std::endl;
+    return 0;
+  }
+  std::cout << "Highest throughput";
+  if (FLAGS_max_p99_latency_ms > 0) {
+    std::cout << " within a p99 latency of " << FLAGS_max_p99_latency_ms
+              << " ms";
+  }
+  std::cout << ":" << std::endl;
+  printHeader();
+  printResult(*best);
+  std::cout << "Recommended: at::set_num_threads(" << best->intra_op_threads
+            << "), at::set_num_interop_threads(" << best->inter_op_threads
+            << ") and " << best->concurrency << " concurrent requests"
+            << std::endl;
+
+  if (layout.numa_nodes > 1) {
+    const int threads = best->intra_op_threads * best->concurrency;
+    const int cores_per_node = layout.physical_cores / layout.numa_nodes;
+    if (threads <= cores_per_node) {
+      std::cout << "These threads fit in one NUMA node: to scale to the "
+                << "whole host, run one process per node, e.g. with "
+                << "numactl --cpunodebind=<node> --membind=<node>"
+                << std::endl;
+    } else {
+      std::cout << "These threads span " << layout.numa_nodes
+                << " NUMA nodes: compare with one process per node bound "
+                << "with numactl, sweeping up to " << cores_per_node
+                << " cores with --intra_op_threads and --concurrency"
+                << std::endl;
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,205 @@
+// Replays an allocation trace recorded with
+// c10::cuda::CUDACachingAllocator::recordTrace() against the caching
+// allocator, so that allocator settings can be compared offline.
+//
+// Record a trace from Python with
+//
+//   torch.cuda.memory._record_memory_trace(True)
+//   ... run the workload ...
+//   torch.cuda.memory._save_memory_trace("trace.txt")
+//
+// and replay it with
+//
+//   replay_cuda_allocator_trace --trace trace.txt --size_classes
+
+#include "c10/cuda/CUDACachingAllocator.h"
+#include "c10/cuda/CUDAFunctions.h"
+#include "c10/cuda/CUDAGuard.h"
+#include "c10/util/Flags.h"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <unordered_map>
+
+C10_DEFINE_string(trace, "", "Path of the allocator trace to replay");
+C10_DEFINE_int(iterations, 1, "Number of times to replay the trace");
+C10_DEFINE_bool(size_classes, false, "Serve small requests from size classes");
+C10_DEFINE_bool(expandable_segments, false, "Grow large segments in place");
+C10_DEFINE_bool(ignore_record_stream, false, "Skip recordStream events");
+
+namespace {
+
+using namespace c10::cuda;
+using c10::cuda::CUDACachingAllocator::TraceEntry;
+
+typedef std::chrono::high_resolution_clock clock_type;
+
+struct ReplayResult {
+  int64_t mallocs = 0;
+  int64_t frees = 0;
+  int64_t unmatched_frees = 0;
+  int64_t ooms = 0;
+  double malloc_ns = 0;
+  double free_ns = 0;
+};
+
+CUDAStream get_stream(
+    std::unordered_map<int64_t, CUDAStream>& streams,
+    int64_t device,
+    int64_t recorded) {
+  auto it = streams.find(recorded);
+  if (it != streams.end()) {
+    return it->second;
+  }
+  // The recorded default stream keeps being the default stream.
+  CUDAStream stream = recorded == 0
+      ? getDefaultCUDAStream(device)
+      : getStreamFromPool(/*isHighPriority=*/false, device);
+  streams.emplace(recorded, stream);
+  return stream;
+}
+
+ReplayResult replay(const std::vector<TraceEntry>& trace) {
+  ReplayResult result;
+  std::unordered_map<int64_t, void*> live;
+  std::unordered_map<int64_t, CUDAStream> streams;
+
+  for (const TraceEntry& entry : trace) {
+    CUDAGuard device_guard(entry.device);
+    switch (entry.action) {
+      case TraceEntry::MALLOC: {
+        CUDAStreamGuard stream_guard(
+            get_stream(streams, entry.device, entry.stream));
+        const auto start = clock_type::now();
+        void* ptr = nullptr;
+        try {
+          ptr = CUDACachingAllocator::raw_alloc(entry.size);
+        } catch (const c10::Error&) {
+          result.ooms++;
+          break;
+        }
+        result.malloc_ns += std::chrono::duration<double, std::nano>(
+                                clock_type::now() - start)
+                                .count();
+        result.mallocs++;
+        live[entry.address] = ptr;
+        break;
+      }
+      case TraceEntry::FREE: {
+        auto it = live.find(entry.address);
+        if (it == live.end()) {
+          // allocated before the ring buffer started, or failed to allocate
+          result.unmatched_frees++;
+          break;
+        }
+        const auto start = clock_type::now();
+        CUDACachingAllocator::raw_delete(it->second);
+        result.free_ns += std::chrono::duration<double, std::nano>(
+                              clock_type::now() - start)
+                              .count();
+        result.frees++;
+        live.erase(it);
+        break;
+      }
+      case TraceEntry::RECORD_STREAM: {
+        auto it = live.find(entry.address);
+        if (it != live.end() && !FLAGS_ignore_record_stream) {
+          CUDACachingAllocator::recordStream(
+              it->second, get_stream(streams, entry.device, entry.stream));
+        }
+        break;
+      }
+      case TraceEntry::EMPTY_CACHE:
+        CUDACachingAllocator::emptyCache();
+        break;
+    }
+  }
+
+  for (const auto& item : live) {
+    CUDACachingAllocator::raw_delete(item.second);
+  }
+  return result;
+}
+
+void print_device_stats(int device) {
+  using CUDACachingAllocator::StatType;
+  const auto stats = CUDACachingAllocator::getDeviceStats(device);
+  const size_t all = static_cast<size_t>(StatType::AGGREGATE);
+  const int64_t peak_allocated = stats.allocated_bytes[all].peak;
+  const int64_t peak_reserved = stats.reserved_bytes[all].peak;
+
+  std::cout << "Device " << device << ":" << std::endl
+            << "  peak allocated bytes:  " << peak_allocated << std::endl
+            << "  peak reserved bytes:   " << peak_reserved << std::endl
+            << "  peak unused reserved:  "
+            << (peak_reserved > 0
+                    ? 100.0 * (peak_reserved - peak_allocated) / peak_reserved
+                    : 0.0)
+            << "%" << std::endl
+            << "  peak segments:         " << stats.segment[all].peak
+            << std::endl
+            << "  peak inactive split:   "
+            << stats.inactive_split_bytes[all].peak << " bytes" << std::endl
+            << "  cudaMalloc retries:    " << stats.num_alloc_retries
+            << std::endl
+            << "  OOMs:                  " << stats.num_ooms << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  c10::SetUsageMessage(
+      "Replays a CUDA caching allocator trace and reports allocator stats.");
+  if (!c10::ParseCommandLineFlags(&argc, &argv)) {
+    std::cout << "Failed to parse command line flags" << std::endl;
+    return -1;
+  }
+  if (FLAGS_trace.empty()) {
+    std::cout << "--trace is required" << std::endl;
+    return -1;
+  }
+
+  std::ifstream in(FLAGS_trace);
+  if (!in) {
+    std::cout << "Cannot open " << FLAGS_trace << std::endl;
+    return -1;
+  }
+  const auto trace = CUDACachingAllocator::readTrace(in);
+
+  CUDACachingAllocator::setSizeClassMode(FLAGS_size_classes);
+  CUDACachingAllocator::setExpandableSegments(FLAGS_expandable_segments);
+
+  int max_device = 0;
+  for (const TraceEntry& entry : trace) {
+    max_device = std::max<int>(max_device, entry.device);
+  }
+  TORCH_CHECK(
+      max_device < device_count(),
+      "trace uses device ",
+      max_device,
+      " but only ",
+      static_cast<int>(device_count()),
+      " devices are available");
+
+  std::cout << "Replaying " << trace.size() << " events from " << FLAGS_trace
+            << " (size classes: " << FLAGS_size_classes
+            << ", expandable segments: " << FLAGS_expandable_segments << ")"
+            << std::endl;
+
+  for (int iter = 0; iter < FLAGS_iterations; ++iter) {
+    const ReplayResult result = replay(trace);
+    std::cout << "Iteration " << iter << ": " << result.mallocs
+              << " mallocs (" << (result.mallocs ? result.malloc_ns / result.mallocs : 0)
+              << " ns avg), " << result.frees << " frees ("
+              << (result.frees ? result.free_ns / result.frees : 0)
+              << " ns avg), " << result.unmatched_frees
+              << " unmatched frees, " << result.ooms << " OOMs" << std::endl;
+  }
+
+  for (int device = 0; device <= max_device; ++device) {
+    print_device_stats(device);
+  }
+  return 0;
+}
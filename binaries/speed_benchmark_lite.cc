@@ -0,0 +1,254 @@
+/**
+ * Copyright (c) 2016-present, Facebook, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <string>
+#include <vector>
+
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+#include "ATen/ATen.h"
+#include "ATen/Parallel.h"
+#include "c10/util/Flags.h"
+#include "caffe2/core/logging.h"
+#include "torch/csrc/autograd/grad_mode.h"
+#include "torch/csrc/jit/mobile/import.h"
+#include "torch/csrc/jit/mobile/interpreter.h"
+#include "torch/csrc/jit/mobile/module.h"
+
+using namespace std::chrono;
+
+C10_DEFINE_string(
+    model,
+    "",
+    "The given lite interpreter model (saved with _save_for_lite_interpreter) "
+    "to benchmark.");
+C10_DEFINE_string(
+    input_dims,
+    "",
+    "The dimensions of the inputs, which are all ones, as comma separated "
+    "numbers. If multiple inputs are needed, use semicolon to separate the "
+    "dimensions of different tensors.");
+C10_DEFINE_string(input_type, "", "Input types (uint8_t/float/int64)");
+C10_DEFINE_int(warmup, 0, "The number of iterations to warm up.");
+C10_DEFINE_int(iter, 10, "The number of iterations to run.");
+C10_DEFINE_int(
+    num_threads,
+    -1,
+    "The number of intra-op threads, the default of ATen if -1.");
+C10_DEFINE_int(
+    profile_iter,
+    10,
+    "The number of iterations run after the main ones with the time of each "
+    "operator recorded, 0 to skip the per-operator breakdown.");
+C10_DEFINE_bool(
+    report_pep,
+    false,
+    "Whether to print performance stats for AI-PEP.");
+
+namespace {
+
+std::vector<std::string>
+split(char separator, const std::string& string, bool ignore_empty = true) {
+  std::vector<std::string> pieces;
+  std::stringstream ss(string);
+  std::string item;
+  while (getline(ss, item, separator)) {
+    if (!ignore_empty || !item.empty()) {
+      pieces.push_back(std::move(item));
+    }
+  }
+  return pieces;
+}
+
+std::vector<c10::IValue> createInputs() {
+  std::vector<std::string> input_dims_list = split(';', FLAGS_input_dims);
+  std::vector<std::string> input_type_list = split(';', FLAGS_input_type);
+  CAFFE_ENFORCE_EQ(
+      input_dims_list.size(),
+      input_type_list.size(),
+      "Input dims and type should have the same number of items.");
+
+  std::vector<c10::IValue> inputs;
+  for (size_t i = 0; i < input_dims_list.size(); ++i) {
+    std::vector<int64_t> input_dims;
+    for (const auto& s : split(',', input_dims_list[i])) {
+      input_dims.push_back(c10::stoi(s));
+    }
+    if (input_type_list[i] == "float") {
+      inputs.push_back(at::ones(input_dims, at::ScalarType::Float));
+    } else if (input_type_list[i] == "uint8_t") {
+      inputs.push_back(at::ones(input_dims, at::ScalarType::Byte));
+    } else if (input_type_list[i] == "int64") {
+      inputs.push_back(at::ones(input_dims, at::ScalarType::Long));
+    } else {
+      CAFFE_THROW("Unsupported input type: ", input_type_list[i]);
+    }
+  }
+  return inputs;
+}
+
+// Peak resident set size of the process in KB, -1 if unknown
+int64_t peakRssKB() {
+#ifndef _WIN32
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) == 0) {
+#ifdef __APPLE__
+    return usage.ru_maxrss / 1024;
+#else
+    return usage.ru_maxrss;
+#endif
+  }
+#endif
+  return -1;
+}
+
+float percentile(std::vector<float> sorted, float p) {
+  CAFFE_ENFORCE(!sorted.empty());
+  const size_t index = std::min(
+      sorted.size() - 1, static_cast<size_t>(p / 100 * sorted.size()));
+  return sorted[index];
+}
+
+void printOpBreakdown(
+    const torch::jit::mobile::InterpreterProfiler& profiler,
+    int iters) {
+  using OpStats = torch::jit::mobile::InterpreterProfiler::OpStats;
+  std::vector<std::pair<std::string, OpStats>> ops;
+  int64_t total_ns = 0;
+  for (const auto& kv : profiler.op_stats()) {
+    ops.emplace_back(c10::toString(kv.first), kv.second);
+    total_ns += kv.second.total_ns;
+  }
+  std::sort(ops.begin(), ops.end(), [](const auto& a, const auto& b) {
+    return a.second.total_ns > b.second.total_ns;
+  });
+
+  std::cout << "Operator breakdown over " << iters << " iterations:"
+            << std::endl;
+  std::cout << std::setw(40) << std::left << "operator" << std::right
+            << std::setw(12) << "calls/iter" << std::setw(14) << "us/iter"
+            << std::setw(10) << "%" << std::endl;
+  for (const auto& op : ops) {
+    const float us_per_iter = op.second.total_ns / 1e3f / iters;
+    std::cout << std::setw(40) << std::left << op.first << std::right
+              << std::setw(12) << op.second.count / iters << std::setw(14)
+              << std::fixed << std::setprecision(1) << us_per_iter
+              << std::setw(10)
+              << 100.0f * op.second.total_ns / std::max<int64_t>(total_ns, 1)
+              << std::endl;
+    if (FLAGS_report_pep) {
+      std::cout << "PyTorchObserver {\"type\": \"" << op.first
+                << "\", \"unit\": \"us\", \"metric\": \"latency\", "
+                << "\"value\": \"" << us_per_iter << "\"}" << std::endl;
+    }
+  }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  c10::SetUsageMessage(
+      "Run speed benchmark for a lite interpreter model.\n"
+      "Example usage on Android:\n"
+      "adb push speed_benchmark_lite model.bc /data/local/tmp\n"
+      "adb shell /data/local/tmp/speed_benchmark_lite"
+      " --model=/data/local/tmp/model.bc"
+      " --input_dims=\"1,3,224,224\""
+      " --input_type=float"
+      " --warmup=5"
+      " --iter=20"
+      " --num_threads=4");
+  if (!c10::ParseCommandLineFlags(&argc, &argv)) {
+    std::cerr << "Failed to parse command line flags!" << std::endl;
+    return 1;
+  }
+  CAFFE_ENFORCE(!FLAGS_model.empty(), "Please provide --model.");
+  CAFFE_ENFORCE(
+      FLAGS_warmup >= 0,
+      "Number of warm up runs should be non negative, provided ",
+      FLAGS_warmup,
+      ".");
+  CAFFE_ENFORCE(
+      FLAGS_iter > 0,
+      "Number of main runs should be positive, provided ",
+      FLAGS_iter,
+      ".");
+  if (FLAGS_num_threads > 0) {
+    at::set_num_threads(FLAGS_num_threads);
+  }
+
+  auto inputs = createInputs();
+  auto qengines = at::globalContext().supportedQEngines();
+  if (std::find(qengines.begin(), qengines.end(), at::QEngine::QNNPACK) !=
+      qengines.end()) {
+    at::globalContext().setQEngine(at::QEngine::QNNPACK);
+  }
+  torch::autograd::AutoGradMode guard(false);
+  auto module = torch::jit::_load_for_mobile(FLAGS_model);
+
+  std::cout << "Starting benchmark with " << at::get_num_threads()
+            << " threads." << std::endl;
+  std::cout << "Running warmup runs." << std::endl;
+  for (int i = 0; i < FLAGS_warmup; ++i) {
+    module.forward(inputs);
+  }
+
+  std::cout << "Main runs." << std::endl;
+  std::vector<float> times_us;
+  for (int i = 0; i < FLAGS_iter; ++i) {
+    auto start = high_resolution_clock::now();
+    module.forward(inputs);
+    auto stop = high_resolution_clock::now();
+    times_us.push_back(duration_cast<microseconds>(stop - start).count());
+  }
+
+  if (FLAGS_report_pep) {
+    for (auto t : times_us) {
+      std::cout << "PyTorchObserver {\"type\": \"NET\", \"unit\": \"us\", "
+                << "\"metric\": \"latency\", \"value\": \"" << t << "\"}"
+                << std::endl;
+    }
+  }
+  float total_us = 0;
+  for (auto t : times_us) {
+    total_us += t;
+  }
+  std::sort(times_us.begin(), times_us.end());
+  std::cout << "Main run finished. Microseconds per iter: "
+            << total_us / FLAGS_iter
+            << ". Iters per second: " << 1e6 * FLAGS_iter / total_us
+            << std::endl;
+  std::cout << "Latency percentiles (us): p50 " << percentile(times_us, 50)
+            << ", p90 " << percentile(times_us, 90) << ", p99 "
+            << percentile(times_us, 99) << ", max " << times_us.back()
+            << std::endl;
+  std::cout << "Peak RSS (KB): " << peakRssKB() << std::endl;
+
+  if (FLAGS_profile_iter > 0) {
+    torch::jit::mobile::InterpreterProfiler profiler;
+    for (int i = 0; i < FLAGS_profile_iter; ++i) {
+      module.forward(inputs);
+    }
+    printOpBreakdown(profiler, FLAGS_profile_iter);
+  }
+
+  return 0;
+}
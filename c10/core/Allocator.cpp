@@ -16,6 +16,14 @@ at::DataPtr InefficientStdFunctionContext::makeDataPtr(
           device};
 }
 
+namespace detail {
+std::atomic<MemoryUsageReporter> memory_usage_reporter{nullptr};
+} // namespace detail
+
+void setMemoryUsageReporter(MemoryUsageReporter reporter) {
+  detail::memory_usage_reporter.store(reporter);
+}
+
 C10_API at::Allocator* allocator_array[at::COMPILE_TIME_MAX_DEVICE_TYPES];
 
 void SetAllocator(at::DeviceType t, at::Allocator* alloc) {
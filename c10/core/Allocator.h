@@ -1,6 +1,7 @@
 #pragma once
 
 #include <stddef.h>
+#include <atomic>
 #include <memory>
 
 #include <c10/core/Device.h>
@@ -190,6 +191,24 @@ struct C10_API InefficientStdFunctionContext {
       Device device);
 };
 
+// Profilers can install a function that allocators call with every pointer
+// they hand out and its size, and with every pointer they take back and a size
+// of 0. It may be called on any thread, and must not allocate through the
+// allocator that calls it. The default CPU allocator and the CUDA caching
+// allocator report.
+using MemoryUsageReporter = void (*)(void* ptr, int64_t alloc_size, Device device);
+C10_API void setMemoryUsageReporter(MemoryUsageReporter reporter);
+
+namespace detail {
+C10_API extern std::atomic<MemoryUsageReporter> memory_usage_reporter;
+} // namespace detail
+
+inline void reportMemoryUsage(void* ptr, int64_t alloc_size, Device device) {
+  if (auto reporter = detail::memory_usage_reporter.load(std::memory_order_relaxed)) {
+    reporter(ptr, alloc_size, device);
+  }
+}
+
 /** Set the allocator for DeviceType `t`. The passed in allocator pointer is
  *  expected to have static lifetime; this function does NOT take ownership
  *  of the raw pointer. (The reason for this is to prevent existing pointers
@@ -0,0 +1,198 @@
+#include <c10/core/ArenaAllocator.h>
+#include <c10/core/CPUAllocator.h>
+
+#include <atomic>
+
+namespace c10 {
+
+// A chunk holds one reference for the arena that owns it and one for each
+// live allocation carved out of it. Whoever drops the last one frees it.
+struct ArenaChunk {
+  std::atomic<int64_t> refcount{1};
+  char* data = nullptr;
+  size_t capacity = 0;
+  size_t used = 0;
+};
+
+namespace {
+
+// Every allocation is preceded by a header pointing back at its chunk, so that
+// the deleter only needs the data pointer. The header takes gAlignment bytes
+// to keep the data aligned.
+struct ArenaAllocationHeader {
+  ArenaChunk* chunk;
+};
+
+static_assert(
+    sizeof(ArenaAllocationHeader) <= gAlignment,
+    "ArenaAllocationHeader must fit in the alignment padding");
+
+size_t round_total_size(size_t nbytes) {
+  return gAlignment + (nbytes + gAlignment - 1) / gAlignment * gAlignment;
+}
+
+void decref(ArenaChunk* chunk) {
+  if (chunk->refcount.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+    free_cpu(chunk->data);
+    delete chunk;
+  }
+}
+
+void Delete(void* data) {
+  if (!data) {
+    return;
+  }
+  auto* header = reinterpret_cast<ArenaAllocationHeader*>(
+      static_cast<char*>(data) - gAlignment);
+  decref(header->chunk);
+}
+
+thread_local at::Allocator* thread_local_cpu_allocator = nullptr;
+
+} // namespace
+
+ArenaAllocator::ArenaAllocator(size_t chunk_size) : chunk_size_(chunk_size) {
+  CAFFE_ENFORCE(
+      chunk_size_ >= 2 * gAlignment,
+      "ArenaAllocator chunk size must be at least ",
+      2 * gAlignment,
+      " bytes, got ",
+      chunk_size_);
+}
+
+ArenaAllocator::~ArenaAllocator() {
+  for (ArenaChunk* chunk : chunks_) {
+    decref(chunk);
+  }
+}
+
+ArenaChunk* ArenaAllocator::new_chunk(size_t capacity) const {
+  auto* chunk = new ArenaChunk();
+  chunk->data = static_cast<char*>(alloc_cpu(capacity));
+  chunk->capacity = capacity;
+  return chunk;
+}
+
+at::DataPtr ArenaAllocator::allocate(size_t nbytes) const {
+  if (nbytes == 0) {
+    return {nullptr, nullptr, &Delete, at::Device(at::DeviceType::CPU)};
+  }
+  CAFFE_ENFORCE(
+      ((ptrdiff_t)nbytes) >= 0,
+      "ArenaAllocator seems to have been called with negative number: ",
+      nbytes);
+
+  const size_t total_size = round_total_size(nbytes);
+  ArenaChunk* chunk = nullptr;
+  if (total_size > chunk_size_) {
+    // Oversized requests get a chunk of their own, which is retired right
+    // away so that it is freed together with the allocation.
+    chunk = new_chunk(total_size);
+    chunk->refcount.fetch_sub(1, std::memory_order_relaxed);
+  } else {
+    while (current_ < chunks_.size() &&
+           chunks_[current_]->used + total_size >
+               chunks_[current_]->capacity) {
+      current_++;
+    }
+    if (current_ == chunks_.size()) {
+      chunks_.push_back(new_chunk(chunk_size_));
+    }
+    chunk = chunks_[current_];
+  }
+
+  auto* header =
+      reinterpret_cast<ArenaAllocationHeader*>(chunk->data + chunk->used);
+  header->chunk = chunk;
+  chunk->used += total_size;
+  chunk->refcount.fetch_add(1, std::memory_order_relaxed);
+
+  void* data = reinterpret_cast<char*>(header) + gAlignment;
+  CHECK(
+      !FLAGS_caffe2_cpu_allocator_do_zero_fill ||
+      !FLAGS_caffe2_cpu_allocator_do_junk_fill)
+      << "Cannot request both zero-fill and junk-fill at the same time";
+  if (FLAGS_caffe2_cpu_allocator_do_zero_fill) {
+    memset(data, 0, nbytes);
+  } else if (FLAGS_caffe2_cpu_allocator_do_junk_fill) {
+    memset_junk(data, nbytes);
+  }
+  return {data, data, &Delete, at::Device(at::DeviceType::CPU)};
+}
+
+at::DeleterFnPtr ArenaAllocator::raw_deleter() const {
+  return &Delete;
+}
+
+void ArenaAllocator::reset() {
+  std::vector<ArenaChunk*> kept;
+  kept.reserve(chunks_.size());
+  for (ArenaChunk* chunk : chunks_) {
+    if (chunk->refcount.load(std::memory_order_acquire) == 1) {
+      // Only the arena references it, so nobody else can touch it anymore.
+      chunk->used = 0;
+      kept.push_back(chunk);
+    } else {
+      decref(chunk);
+    }
+  }
+  chunks_ = std::move(kept);
+  current_ = 0;
+}
+
+void ArenaAllocator::release() {
+  reset();
+  for (ArenaChunk* chunk : chunks_) {
+    decref(chunk);
+  }
+  chunks_.clear();
+}
+
+size_t ArenaAllocator::reserved_bytes() const {
+  size_t total = 0;
+  for (const ArenaChunk* chunk : chunks_) {
+    total += chunk->capacity;
+  }
+  return total;
+}
+
+size_t ArenaAllocator::used_bytes() const {
+  size_t total = 0;
+  for (const ArenaChunk* chunk : chunks_) {
+    total += chunk->used;
+  }
+  return total;
+}
+
+ArenaAllocatorGuard::ArenaAllocatorGuard(size_t chunk_size)
+    : owned_arena_(new ArenaAllocator(chunk_size)),
+      arena_(owned_arena_.get()),
+      prev_allocator_(impl::getThreadLocalCPUAllocator()) {
+  impl::setThreadLocalCPUAllocator(arena_);
+}
+
+ArenaAllocatorGuard::ArenaAllocatorGuard(ArenaAllocator& arena)
+    : arena_(&arena), prev_allocator_(impl::getThreadLocalCPUAllocator()) {
+  impl::setThreadLocalCPUAllocator(arena_);
+}
+
+ArenaAllocatorGuard::~ArenaAllocatorGuard() {
+  impl::setThreadLocalCPUAllocator(prev_allocator_);
+  if (!owned_arena_) {
+    arena_->reset();
+  }
+}
+
+namespace impl {
+
+at::Allocator* getThreadLocalCPUAllocator() {
+  return thread_local_cpu_allocator;
+}
+
+void setThreadLocalCPUAllocator(at::Allocator* allocator) {
+  thread_local_cpu_allocator = allocator;
+}
+
+} // namespace impl
+
+} // namespace c10
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <vector>
+
+#include <c10/core/Allocator.h>
+
+namespace c10 {
+
+struct ArenaChunk;
+
+// A bump-pointer allocator for CPU tensors whose allocations all die together,
+// e.g. the intermediates of one inference request. Allocation carves the next
+// aligned range off the current chunk; freeing an allocation only drops a
+// reference on its chunk.
+//
+// Allocations may outlive a reset() or the arena itself: a chunk that still
+// has live allocations is retired instead of reused, and its memory goes back
+// to the system when the last of them is freed. Storages escaping the arena
+// scope are therefore safe, they just pin their chunk.
+//
+// allocate() must only be called from one thread at a time; the returned
+// DataPtrs can be freed from any thread.
+class C10_API ArenaAllocator final : public at::Allocator {
+ public:
+  static constexpr size_t kDefaultChunkSize = 4194304; // 4 MiB
+
+  explicit ArenaAllocator(size_t chunk_size = kDefaultChunkSize);
+  ~ArenaAllocator() override;
+
+  ArenaAllocator(const ArenaAllocator&) = delete;
+  ArenaAllocator& operator=(const ArenaAllocator&) = delete;
+
+  at::DataPtr allocate(size_t nbytes) const override;
+  at::DeleterFnPtr raw_deleter() const override;
+
+  // Rewinds the arena. Chunks without live allocations are kept for reuse,
+  // chunks with live allocations are handed over to those allocations.
+  void reset();
+
+  // Releases the chunks kept for reuse back to the system.
+  void release();
+
+  // Bytes held by the chunks owned by the arena (not counting retired chunks).
+  size_t reserved_bytes() const;
+  // Bytes handed out since the last reset(), including alignment padding.
+  size_t used_bytes() const;
+
+ private:
+  ArenaChunk* new_chunk(size_t capacity) const;
+
+  const size_t chunk_size_;
+  // chunks_[current_] is the chunk being bumped; later chunks are empty.
+  mutable std::vector<ArenaChunk*> chunks_;
+  mutable size_t current_ = 0;
+};
+
+// RAII guard that redirects c10::GetCPUAllocator() on the current thread to
+// an arena for its lifetime, so that every CPU tensor allocated in the scope
+// is bump-allocated:
+//
+//   {
+//     c10::ArenaAllocatorGuard guard;
+//     auto output = module.forward(inputs);
+//   } // intermediates are gone, `output` keeps its chunk alive
+//
+// The default constructor frees its own arena on exit. Pass a long-lived
+// arena to reset it on exit instead, so that its chunks are reused by the
+// next request. Guards nest; other threads (including intra-op worker
+// threads) keep using the regular CPU allocator.
+class C10_API ArenaAllocatorGuard {
+ public:
+  explicit ArenaAllocatorGuard(
+      size_t chunk_size = ArenaAllocator::kDefaultChunkSize);
+  explicit ArenaAllocatorGuard(ArenaAllocator& arena);
+  ~ArenaAllocatorGuard();
+
+  ArenaAllocatorGuard(const ArenaAllocatorGuard&) = delete;
+  ArenaAllocatorGuard& operator=(const ArenaAllocatorGuard&) = delete;
+
+  ArenaAllocator& arena() {
+    return *arena_;
+  }
+
+ private:
+  std::unique_ptr<ArenaAllocator> owned_arena_;
+  ArenaAllocator* arena_;
+  at::Allocator* prev_allocator_;
+};
+
+namespace impl {
+
+// The allocator installed by the innermost ArenaAllocatorGuard on this
+// thread, or nullptr.
+C10_API at::Allocator* getThreadLocalCPUAllocator();
+C10_API void setThreadLocalCPUAllocator(at::Allocator* allocator);
+
+} // namespace impl
+
+} // namespace c10
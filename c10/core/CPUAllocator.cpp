@@ -1,4 +1,5 @@
 #include <c10/core/CPUAllocator.h>
+#include <c10/core/ArenaAllocator.h>
 #include <c10/core/DeviceType.h>
 
 // TODO: rename flags to C10
@@ -113,11 +114,21 @@ struct C10_API DefaultCPUAllocator final : at::Allocator {
   ~DefaultCPUAllocator() override {}
   at::DataPtr allocate(size_t nbytes) const override {
     void* data = alloc_cpu(nbytes);
+    if (data) {
+      reportMemoryUsage(data, nbytes, at::Device(at::DeviceType::CPU));
+    }
     if (FLAGS_caffe2_report_cpu_memory_usage && nbytes > 0) {
       getMemoryAllocationReporter().New(data, nbytes);
       return {data, data, &ReportAndDelete, at::Device(at::DeviceType::CPU)};
     }
-    return {data, data, &free_cpu, at::Device(at::DeviceType::CPU)};
+    return {data, data, &Delete, at::Device(at::DeviceType::CPU)};
+  }
+
+  static void Delete(void* ptr) {
+    if (ptr) {
+      reportMemoryUsage(ptr, 0, at::Device(at::DeviceType::CPU));
+    }
+    free_cpu(ptr);
   }
 
   static void ReportAndDelete(void* ptr) {
@@ -125,14 +136,14 @@ struct C10_API DefaultCPUAllocator final : at::Allocator {
       return;
     }
     getMemoryAllocationReporter().Delete(ptr);
-    free_cpu(ptr);
+    Delete(ptr);
   }
 
   at::DeleterFnPtr raw_deleter() const override {
     if (FLAGS_caffe2_report_cpu_memory_usage) {
       return &ReportAndDelete;
     }
-    return &free_cpu;
+    return &Delete;
   }
 
  protected:
@@ -146,6 +157,10 @@ struct C10_API DefaultCPUAllocator final : at::Allocator {
 void NoDelete(void*) {}
 
 at::Allocator* GetCPUAllocator() {
+  // set by ArenaAllocatorGuard
+  if (at::Allocator* allocator = impl::getThreadLocalCPUAllocator()) {
+    return allocator;
+  }
   return GetAllocator(DeviceType::CPU);
 }
 
@@ -30,7 +30,8 @@ C10_API void memset_junk(void* data, size_t num);
 C10_API void* alloc_cpu(size_t nbytes);
 C10_API void free_cpu(void* data);
 
-// Get the CPU Allocator.
+// Get the CPU Allocator. Returns the arena of the innermost
+// ArenaAllocatorGuard on this thread if there is one.
 C10_API at::Allocator* GetCPUAllocator();
 // Sets the CPU allocator to the given allocator: the caller gives away the
 // ownership of the pointer.
@@ -39,4 +40,13 @@ C10_API void SetCPUAllocator(at::Allocator* alloc);
 // Get the Default CPU Allocator
 C10_API at::Allocator* GetDefaultCPUAllocator();
 
+// Get a CPU allocator that caches freed blocks by size class, with a separate
+// cache for each NUMA node. New blocks are placed on the node of the
+// allocating thread, and blocks of 2 MiB or more are backed by huge pages.
+// Select it at startup with SetCPUAllocator(GetPoolingCPUAllocator()).
+C10_API at::Allocator* GetPoolingCPUAllocator();
+
+// Returns the blocks cached by the pooling CPU allocator to the system.
+C10_API void EmptyPoolingCPUAllocatorCache();
+
 } // namespace c10
@@ -0,0 +1,261 @@
+#include <c10/core/CPUAllocator.h>
+#include <c10/core/DeviceType.h>
+
+#include <array>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#if defined(__linux__) && !defined(C10_MOBILE)
+#include <sys/mman.h>
+#include <unistd.h>
+#define C10_POOL_USE_MMAP
+#endif
+
+C10_DEFINE_int64(
+    caffe2_cpu_pool_max_cached_bytes,
+    1LL << 30,
+    "Maximum number of free bytes the pooling CPU allocator keeps cached per "
+    "NUMA node");
+
+C10_DEFINE_bool(
+    caffe2_cpu_pool_huge_pages,
+    true,
+    "If set, back pooled blocks of 2 MiB or more with transparent huge pages");
+
+C10_DEFINE_bool(
+    caffe2_cpu_pool_hugetlb,
+    false,
+    "If set, back pooled blocks of 2 MiB or more with explicit (hugetlbfs) "
+    "huge pages, falling back to transparent huge pages when none are free");
+
+namespace c10 {
+
+namespace {
+
+constexpr size_t kHugePageSize = 2097152;  // blocks this large use huge pages
+constexpr size_t kMaxPowerOfTwoClass = 1048576;  // larger blocks round to kHugePageSize
+constexpr size_t kMaxNUMANodes = 64;
+
+// Every block starts with a header that records where the block goes back
+// to on free, so that the deleter only needs the data pointer. The header
+// takes gAlignment bytes to keep the data aligned.
+struct PoolBlockHeader {
+  size_t total_size;  // bytes including the header
+  int numa_node;      // node whose pool the block belongs to
+  bool mmapped;       // allocated with mmap instead of posix_memalign
+};
+
+static_assert(
+    sizeof(PoolBlockHeader) <= gAlignment,
+    "PoolBlockHeader must fit in the alignment padding");
+
+struct NodePool {
+  std::mutex mutex;
+  // free blocks by total size
+  std::unordered_map<size_t, std::vector<PoolBlockHeader*>> free_blocks;
+  size_t cached_bytes = 0;
+};
+
+size_t round_total_size(size_t nbytes) {
+  const size_t total = nbytes + gAlignment;
+  if (total > kMaxPowerOfTwoClass) {
+    return kHugePageSize * ((total + kHugePageSize - 1) / kHugePageSize);
+  }
+  size_t rounded = gAlignment;
+  while (rounded < total) {
+    rounded <<= 1;
+  }
+  return rounded;
+}
+
+size_t pool_index(int numa_node) {
+  return numa_node < 0 ? 0 : static_cast<size_t>(numa_node) % kMaxNUMANodes;
+}
+
+#ifdef C10_POOL_USE_MMAP
+void* map_huge_pages(size_t total_size) {
+  if (FLAGS_caffe2_cpu_pool_hugetlb) {
+    void* ptr = mmap(
+        nullptr,
+        total_size,
+        PROT_READ | PROT_WRITE,
+        MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB,
+        -1,
+        0);
+    if (ptr != MAP_FAILED) {
+      return ptr;
+    }
+  }
+
+  // Transparent huge pages are only used for 2 MiB aligned ranges, so map a
+  // slightly larger range and trim it.
+  const size_t mapped_size = total_size + kHugePageSize;
+  void* mapped = mmap(
+      nullptr,
+      mapped_size,
+      PROT_READ | PROT_WRITE,
+      MAP_PRIVATE | MAP_ANONYMOUS,
+      -1,
+      0);
+  if (mapped == MAP_FAILED) {
+    return nullptr;
+  }
+  const uintptr_t begin = reinterpret_cast<uintptr_t>(mapped);
+  const uintptr_t aligned =
+      (begin + kHugePageSize - 1) & ~(uintptr_t)(kHugePageSize - 1);
+  if (aligned > begin) {
+    munmap(mapped, aligned - begin);
+  }
+  const uintptr_t end = begin + mapped_size;
+  if (end > aligned + total_size) {
+    munmap(
+        reinterpret_cast<void*>(aligned + total_size),
+        end - (aligned + total_size));
+  }
+  void* ptr = reinterpret_cast<void*>(aligned);
+  madvise(ptr, total_size, MADV_HUGEPAGE);
+  return ptr;
+}
+#endif
+
+class PoolingCPUAllocator final : public at::Allocator {
+ public:
+  at::DataPtr allocate(size_t nbytes) const override {
+    void* data = nullptr;
+    if (nbytes > 0) {
+      data = alloc(nbytes);
+    }
+    return {data, data, &Delete, at::Device(at::DeviceType::CPU)};
+  }
+
+  at::DeleterFnPtr raw_deleter() const override {
+    return &Delete;
+  }
+
+  void emptyCache() {
+    for (NodePool& pool : pools_) {
+      std::unordered_map<size_t, std::vector<PoolBlockHeader*>> free_blocks;
+      {
+        std::lock_guard<std::mutex> guard(pool.mutex);
+        std::swap(free_blocks, pool.free_blocks);
+        pool.cached_bytes = 0;
+      }
+      for (const auto& item : free_blocks) {
+        for (PoolBlockHeader* header : item.second) {
+          release(header);
+        }
+      }
+    }
+  }
+
+  static PoolingCPUAllocator& get() {
+    // Leaked on purpose: tensors may be freed during static destruction.
+    static PoolingCPUAllocator* allocator = new PoolingCPUAllocator();
+    return *allocator;
+  }
+
+ private:
+  void* alloc(size_t nbytes) const {
+    CAFFE_ENFORCE(
+        ((ptrdiff_t)nbytes) >= 0,
+        "PoolingCPUAllocator seems to have been called with negative number: ",
+        nbytes);
+
+    const int numa_node = GetCurrentNUMANode();
+    const size_t total_size = round_total_size(nbytes);
+    NodePool& pool = pools_[pool_index(numa_node)];
+
+    PoolBlockHeader* header = nullptr;
+    {
+      std::lock_guard<std::mutex> guard(pool.mutex);
+      auto it = pool.free_blocks.find(total_size);
+      if (it != pool.free_blocks.end() && !it->second.empty()) {
+        header = it->second.back();
+        it->second.pop_back();
+        pool.cached_bytes -= total_size;
+      }
+    }
+    if (header == nullptr) {
+      header = create(total_size, numa_node);
+    }
+
+    void* data = reinterpret_cast<char*>(header) + gAlignment;
+    CHECK(
+        !FLAGS_caffe2_cpu_allocator_do_zero_fill ||
+        !FLAGS_caffe2_cpu_allocator_do_junk_fill)
+        << "Cannot request both zero-fill and junk-fill at the same time";
+    if (FLAGS_caffe2_cpu_allocator_do_zero_fill) {
+      memset(data, 0, nbytes);
+    } else if (FLAGS_caffe2_cpu_allocator_do_junk_fill) {
+      memset_junk(data, nbytes);
+    }
+    return data;
+  }
+
+  static PoolBlockHeader* create(size_t total_size, int numa_node) {
+    void* ptr = nullptr;
+    bool mmapped = false;
+#ifdef C10_POOL_USE_MMAP
+    if (total_size >= kHugePageSize && FLAGS_caffe2_cpu_pool_huge_pages) {
+      ptr = map_huge_pages(total_size);
+      mmapped = ptr != nullptr;
+    }
+#endif
+    if (ptr == nullptr) {
+      ptr = alloc_cpu(total_size);
+    } else {
+      // alloc_cpu moves its pages itself; do the same for mapped blocks.
+      NUMAMove(ptr, total_size, numa_node);
+    }
+
+    PoolBlockHeader* header = static_cast<PoolBlockHeader*>(ptr);
+    header->total_size = total_size;
+    header->numa_node = numa_node;
+    header->mmapped = mmapped;
+    return header;
+  }
+
+  static void release(PoolBlockHeader* header) {
+#ifdef C10_POOL_USE_MMAP
+    if (header->mmapped) {
+      munmap(header, header->total_size);
+      return;
+    }
+#endif
+    free_cpu(header);
+  }
+
+  static void Delete(void* data) {
+    if (!data) {
+      return;
+    }
+    PoolBlockHeader* header = reinterpret_cast<PoolBlockHeader*>(
+        static_cast<char*>(data) - gAlignment);
+    NodePool& pool = get().pools_[pool_index(header->numa_node)];
+    {
+      std::lock_guard<std::mutex> guard(pool.mutex);
+      if (pool.cached_bytes + header->total_size <=
+          static_cast<size_t>(FLAGS_caffe2_cpu_pool_max_cached_bytes)) {
+        pool.free_blocks[header->total_size].push_back(header);
+        pool.cached_bytes += header->total_size;
+        return;
+      }
+    }
+    release(header);
+  }
+
+  mutable std::array<NodePool, kMaxNUMANodes> pools_;
+};
+
+} // namespace
+
+at::Allocator* GetPoolingCPUAllocator() {
+  return &PoolingCPUAllocator::get();
+}
+
+void EmptyPoolingCPUAllocatorCache() {
+  PoolingCPUAllocator::get().emptyCache();
+}
+
+} // namespace c10
@@ -134,6 +134,8 @@ struct TensorImpl;
 struct C10_API AutogradMetaInterface {
   virtual void set_requires_grad(bool requires_grad, at::TensorImpl* self_impl) = 0;
   virtual bool requires_grad() const = 0;
+  // Whether the tensor wasn't computed by a differentiable operation
+  virtual bool is_leaf() const = 0;
   virtual at::Tensor& grad() = 0;
   virtual const at::Tensor& grad() const = 0;
   virtual ~AutogradMetaInterface();
@@ -430,13 +432,15 @@ struct C10_API TensorImpl : public c10::intrusive_ptr_target {
 
   bool is_quantized() const {
     // NB: This method is not virtual and avoid dispatches for performance reasons.
-    return type_set_.has(TensorTypeId::QuantizedCPUTensorId);
+    return type_set_.has(TensorTypeId::QuantizedCPUTensorId) ||
+           type_set_.has(TensorTypeId::QuantizedCUDATensorId);
   }
 
   bool is_cuda() const {
     // NB: This method is not virtual and avoid dispatches for performance reasons.
     return type_set_.has(TensorTypeId::CUDATensorId) ||
-           type_set_.has(TensorTypeId::SparseCUDATensorId);
+           type_set_.has(TensorTypeId::SparseCUDATensorId) ||
+           type_set_.has(TensorTypeId::QuantizedCUDATensorId);
   }
 
   bool is_hip() const {
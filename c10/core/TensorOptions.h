@@ -347,6 +347,9 @@ struct C10_API TensorOptions {
             if (isComplexType(typeMetaToScalarType(dtype()))) {
               return TensorTypeId::ComplexCUDATensorId;
             }
+            if (isQIntType(typeMetaToScalarType(dtype()))) {
+              return TensorTypeId::QuantizedCUDATensorId;
+            }
             return TensorTypeId::CUDATensorId;
           case DeviceType::MKLDNN:
             return TensorTypeId::MKLDNNTensorId;
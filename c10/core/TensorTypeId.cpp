@@ -34,12 +34,16 @@ const char* toString(TensorTypeId t) {
       return "MkldnnCPUTensorId";
     case TensorTypeId::QuantizedCPUTensorId:
       return "QuantizedCPUTensorId";
+    case TensorTypeId::QuantizedCUDATensorId:
+      return "QuantizedCUDATensorId";
     case TensorTypeId::ComplexCPUTensorId:
       return "ComplexCPUTensorId";
     case TensorTypeId::ComplexCUDATensorId:
       return "ComplexCUDATensorId";
     case TensorTypeId::VariableTensorId:
       return "VariableTensorId";
+    case TensorTypeId::AutocastTensorId:
+      return "AutocastTensorId";
     case TensorTypeId::TESTING_ONLY_GenericModeTensorId:
       return "TESTING_ONLY_GenericModeTensorId";
     case TensorTypeId::TESTING_ONLY_GenericWrapperTensorId:
@@ -35,6 +35,7 @@ enum class TensorTypeId : uint8_t {
   XLATensorId, // PyTorch only
   MkldnnCPUTensorId,
   QuantizedCPUTensorId, // PyTorch only
+  QuantizedCUDATensorId, // PyTorch only
   ComplexCPUTensorId, // PyTorch only
   ComplexCUDATensorId, // PyTorch only
 
@@ -49,6 +50,11 @@ enum class TensorTypeId : uint8_t {
 
   VariableTensorId,
 
+  // Casts the inputs of some operators to a lower or higher precision before
+  // autograd sees them, see ATen/AutocastMode.h. Never set on a tensor; it is
+  // turned on for a thread via the included type set.
+  AutocastTensorId,
+
   // TESTING: This is intended to be a generic testing tensor type id.
   // Don't use it for anything real; its only acceptible use is within a single
   // process test.  Use it by creating a TensorImpl with this TensorTypeId, and
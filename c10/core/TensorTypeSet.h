@@ -122,7 +122,9 @@ C10_API std::ostream& operator<<(std::ostream&, TensorTypeSet);
 // NB: If you add other non-VariableTensorId other keys to this set, you'll
 // have to adjust this some more (sorry.)
 static inline TensorTypeId legacyExtractTypeId(TensorTypeSet s) {
-  return s.remove(TensorTypeId::VariableTensorId).highestPriorityTypeId();
+  return s.remove(TensorTypeId::VariableTensorId)
+          .remove(TensorTypeId::AutocastTensorId)
+          .highestPriorityTypeId();
 }
 
 }
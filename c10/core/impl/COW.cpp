@@ -0,0 +1,114 @@
+#include <c10/core/impl/COW.h>
+
+#include <c10/core/CopyBytes.h>
+#include <c10/core/DeviceGuard.h>
+
+#include <cstring>
+#include <memory>
+#include <mutex>
+
+namespace c10 {
+namespace impl {
+namespace cow {
+
+namespace {
+
+using SharedData = std::shared_ptr<DataPtr>;
+
+// Guards turning storages COW and materializing them, which replace their
+// DataPtr
+std::mutex& cow_mutex() {
+  static std::mutex mutex;
+  return mutex;
+}
+
+DataPtr make_alias(SharedData data) {
+  void* ptr = data->get();
+  const Device device = data->device();
+  return DataPtr(
+      ptr, new SharedData(std::move(data)), &delete_cow_context, device);
+}
+
+SharedData& shared_data(StorageImpl& storage) {
+  return *static_cast<SharedData*>(storage.data_ptr().get_context());
+}
+
+/// In the CAFFE2_FB_LIMITED_MOBILE_CAPABILITY build setting,
+/// thread_local is not supported.
+#ifndef CAFFE2_FB_LIMITED_MOBILE_CAPABILITY
+thread_local bool lazy_clone_requested = false;
+#else
+static bool lazy_clone_requested = false;
+#endif
+
+} // namespace
+
+void delete_cow_context(void* ctx) {
+  delete static_cast<SharedData*>(ctx);
+}
+
+c10::intrusive_ptr<StorageImpl> lazy_clone_storage(StorageImpl& storage) {
+  if (storage.allocator() == nullptr) {
+    return {};
+  }
+  std::lock_guard<std::mutex> guard(cow_mutex());
+  if (!is_cow(storage)) {
+    auto data = std::make_shared<DataPtr>(std::move(storage.data_ptr()));
+    storage.set_data_ptr(make_alias(std::move(data)));
+  }
+  return c10::make_intrusive<StorageImpl>(
+      storage.dtype(),
+      storage.numel(),
+      make_alias(shared_data(storage)),
+      storage.allocator(),
+      storage.resizable());
+}
+
+void materialize(StorageImpl& storage) {
+  std::lock_guard<std::mutex> guard(cow_mutex());
+  if (!is_cow(storage)) {
+    return;
+  }
+  SharedData& data = shared_data(storage);
+  // The other storages sharing the data only ever drop it without the lock,
+  // so a count of one can't go up
+  if (data.use_count() == 1) {
+    DataPtr own = std::move(*data);
+    storage.set_data_ptr(std::move(own));
+    return;
+  }
+  const size_t nbytes = storage.capacity();
+  const Device device = storage.device();
+  DataPtr copy;
+  if (device.type() == DeviceType::CPU) {
+    copy = storage.allocator()->allocate(nbytes);
+    if (nbytes > 0) {
+      std::memcpy(copy.get(), storage.data(), nbytes);
+    }
+  } else {
+    DeviceGuard device_guard(device);
+    copy = storage.allocator()->allocate(nbytes);
+    if (nbytes > 0) {
+      CopyBytes(nbytes, storage.data(), device, copy.get(), device, false);
+    }
+  }
+  storage.set_data_ptr(std::move(copy));
+}
+
+LazyCloneRequest::LazyCloneRequest() : prev_(lazy_clone_requested) {
+  lazy_clone_requested = true;
+}
+
+LazyCloneRequest::~LazyCloneRequest() {
+  lazy_clone_requested = prev_;
+}
+
+bool LazyCloneRequest::take() {
+  const bool requested = lazy_clone_requested;
+  lazy_clone_requested = false;
+  return requested;
+}
+
+} // namespace cow
+} // namespace impl
+} // namespace c10
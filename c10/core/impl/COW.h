@@ -0,0 +1,67 @@
+#pragma once
+
+#include <c10/core/StorageImpl.h>
+#include <c10/util/intrusive_ptr.h>
+
+// Note [Copy-on-write storages]
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// A copy-on-write (COW) storage shares its data with other COW storages
+// until one of them is written: the DataPtr of each of them aliases a shared
+// DataPtr holding the data, which is freed with the last alias. Writing
+// requires materialize() first, which gives the storage a copy of its own,
+// or takes the data back if it's the last one holding it.
+//
+// Nothing in the storage itself sees writes, which go through raw pointers,
+// so the tensors of COW storages must only be written through the ops of the
+// autograd wrappers (VariableType), which call materialize() on the tensors
+// in-place and out= ops write before calling the kernel. This is why only the
+// clones the users ask for through VariableType are lazy: ATen writes the
+// tensors it clones itself below VariableType. Writes through data_ptr(),
+// e.g. in C++ extensions, or through the storage, aren't seen, and must not
+// be made to the tensors of COW storages.
+
+namespace c10 {
+namespace impl {
+namespace cow {
+
+// The deleter of the DataPtrs of COW storages
+C10_API void delete_cow_context(void* ctx);
+
+inline bool is_cow(const StorageImpl& storage) {
+  return storage.data_ptr().get_deleter() == &delete_cow_context;
+}
+
+// Returns a new storage sharing the data of storage, which becomes COW too,
+// or a null pointer if storage can't be COW because it has no allocator for
+// materialize() to allocate the copy with, e.g. because it wraps external
+// memory.
+C10_API c10::intrusive_ptr<StorageImpl> lazy_clone_storage(
+    StorageImpl& storage);
+
+// Gives the storage its own data if it shares it, see the Note
+C10_API void materialize(StorageImpl& storage);
+
+inline void materialize_if_cow(StorageImpl& storage) {
+  if (C10_UNLIKELY(is_cow(storage))) {
+    materialize(storage);
+  }
+}
+
+// Marks the clone() called in its scope as asked for by a user rather than by
+// another ATen op, so that it can be lazy.
+class C10_API LazyCloneRequest {
+ public:
+  LazyCloneRequest();
+  ~LazyCloneRequest();
+
+  // Whether a clone() was requested, which it then clears so that the clones
+  // the kernel of the requested one may make aren't lazy
+  static bool take();
+
+ private:
+  bool prev_;
+};
+
+} // namespace cow
+} // namespace impl
+} // namespace c10
@@ -92,9 +92,9 @@ private:
 // The non-RAII API is less efficient than the RAII guards because both the
 // getter and setter will do a tls_getaddr lookup (the RAII struct only needs one!)
 
-bool tls_is_tensor_type_id_excluded(TensorTypeId x);
-void tls_set_tensor_type_id_excluded(TensorTypeId x, bool desired_state);
-bool tls_is_tensor_type_id_included(TensorTypeId x);
-void tls_set_tensor_type_id_included(TensorTypeId x, bool desired_state);
+C10_API bool tls_is_tensor_type_id_excluded(TensorTypeId x);
+C10_API void tls_set_tensor_type_id_excluded(TensorTypeId x, bool desired_state);
+C10_API bool tls_is_tensor_type_id_included(TensorTypeId x);
+C10_API void tls_set_tensor_type_id_included(TensorTypeId x, bool desired_state);
 
 }} // namespace c10::impl
@@ -1,5 +1,7 @@
 #include <c10/core/thread_pool.h>
 
+#include <chrono>
+
 namespace c10 {
 
 ThreadPool::ThreadPool(
@@ -11,7 +13,12 @@ ThreadPool::ThreadPool(
       complete_(true),
       available_(threads_.size()),
       total_(threads_.size()),
-      numa_node_id_(numa_node_id) {
+      numa_node_id_(numa_node_id),
+      parked_(0),
+      epoch_(0),
+      spin_time_us_(0),
+      spin_hits_(0),
+      parks_(0) {
   for (std::size_t i = 0; i < threads_.size(); ++i) {
     threads_[i] = std::thread([this, i, init_thread](){
       if (init_thread) {
@@ -65,7 +72,47 @@ void ThreadPool::run(const std::function<void()>& func) {
   // wake up and use the task.
   tasks_.push(task_element_t(func));
   complete_ = false;
-  condition_.notify_one();
+  notify_new_task();
+}
+
+void ThreadPool::notify_new_task() {
+  epoch_.fetch_add(1, std::memory_order_release);
+  // spinning threads take the task without a wakeup; they only go to sleep
+  // after checking tasks_ under the lock
+  if (parked_ > 0) {
+    condition_.notify_one();
+  }
+}
+
+bool ThreadPool::spin_for_task(uint64_t epoch) {
+  const auto spin_time = std::chrono::microseconds(spin_time_us_.load(std::memory_order_relaxed));
+  const auto start = std::chrono::steady_clock::now();
+  while (running_) {
+    if (epoch_.load(std::memory_order_acquire) != epoch) {
+      return true;
+    }
+    if (std::chrono::steady_clock::now() - start >= spin_time) {
+      return false;
+    }
+    std::this_thread::yield();
+  }
+  return false;
+}
+
+void ThreadPool::setSpinTime(int64_t us) {
+  spin_time_us_ = us < 0 ? 0 : us;
+}
+
+int64_t ThreadPool::spinTime() const {
+  return spin_time_us_;
+}
+
+int64_t ThreadPool::numSpinHits() const {
+  return spin_hits_;
+}
+
+int64_t ThreadPool::numParks() const {
+  return parks_;
 }
 
 void ThreadPool::waitWorkComplete() {
@@ -78,10 +125,26 @@ void ThreadPool::waitWorkComplete() {
 void ThreadPool::main_loop(std::size_t index) {
   std::unique_lock<std::mutex> lock(mutex_);
   while (running_) {
+    if (tasks_.empty() && running_ && spin_time_us_.load(std::memory_order_relaxed) > 0) {
+      // Spin for a while before sleeping, so that a task pushed soon after
+      // does not need a wakeup.
+      const uint64_t epoch = epoch_.load(std::memory_order_acquire);
+      lock.unlock();
+      const bool pushed = spin_for_task(epoch);
+      lock.lock();
+      if (pushed && !tasks_.empty()) {
+        ++spin_hits_;
+      }
+    }
     // Wait on condition variable while the task is empty and
     // the pool is still running.
-    while (tasks_.empty() && running_) {
-      condition_.wait(lock);
+    if (tasks_.empty() && running_) {
+      ++parks_;
+      ++parked_;
+      while (tasks_.empty() && running_) {
+        condition_.wait(lock);
+      }
+      --parked_;
     }
     // If pool is no longer running, break out of loop.
     if (!running_) {
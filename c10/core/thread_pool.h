@@ -1,5 +1,6 @@
 #pragma once
 
+#include <atomic>
 #include <condition_variable>
 #include <functional>
 #include <mutex>
@@ -69,6 +70,13 @@ class C10_API ThreadPool : public c10::TaskThreadPoolBase {
   std::size_t available_;
   std::size_t total_;
   int numa_node_id_;
+  // threads waiting on condition_
+  std::size_t parked_;
+  // incremented for every new task, so that spinning threads see it
+  std::atomic<uint64_t> epoch_;
+  std::atomic<int64_t> spin_time_us_;
+  std::atomic<int64_t> spin_hits_;
+  std::atomic<int64_t> parks_;
 
  public:
   ThreadPool() = delete;
@@ -97,15 +105,34 @@ class C10_API ThreadPool : public c10::TaskThreadPoolBase {
     tasks_.push(
         task_element_t(static_cast<std::function<void(std::size_t)>>(task)));
     complete_ = false;
-    condition_.notify_one();
+    notify_new_task();
   }
 
   /// @brief Wait for queue to be empty
   void waitWorkComplete();
 
+  /// @brief Lets idle threads spin for up to `us` microseconds waiting for
+  /// the next task before they go to sleep on the condition variable, which
+  /// saves the wakeup latency when tasks come back to back. 0 (the default)
+  /// disables spinning.
+  void setSpinTime(int64_t us);
+  int64_t spinTime() const;
+
+  /// @brief Number of times an idle thread found a task while spinning.
+  int64_t numSpinHits() const;
+  /// @brief Number of times an idle thread went to sleep.
+  int64_t numParks() const;
+
  private:
   // @brief Entry point for pool threads.
   void main_loop(std::size_t index);
+
+  // @brief Wakes up a thread for a task just pushed; mutex_ must be held.
+  void notify_new_task();
+
+  // @brief Spins until a new task is pushed, the pool stops or the spin
+  // time has passed. Returns whether a task was pushed.
+  bool spin_for_task(uint64_t epoch);
 };
 
 class C10_API TaskThreadPool : public c10::ThreadPool {
@@ -6,13 +6,21 @@
 #include <c10/util/UniqueVoidPtr.h>
 
 #include <cuda_runtime_api.h>
+#ifndef _WIN32
+#include <dlfcn.h>
+#endif
 #include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
 #include <bitset>
 #include <deque>
+#include <istream>
 #include <iterator>
 #include <map>
 #include <memory>
 #include <mutex>
+#include <ostream>
 #include <set>
 #include <unordered_map>
 #include <unordered_set>
@@ -51,6 +59,32 @@ namespace CUDACachingAllocator {
 // ensure that the block is not reused before each recorded stream completes
 // work.
 //
+// Optionally (see setSizeClassMode), requests up to kMaxSizeClassAlloc are
+// served by a size-class front end that sits on top of the pools above:
+//
+// - Requests are rounded up to a power of two. Freed blocks are kept in free
+//   lists keyed by (device, stream, size class) rather than being merged back
+//   into the best-fit pools, so reuse does not need the global mutex.
+// - Each thread keeps a few blocks per key that it accesses without locking.
+//   Overflow goes to shared per-key lists behind striped mutexes.
+// - Blocks used on other streams (recordStream) are handed back to the pools
+//   on free, so the usual event-based synchronization still applies.
+// - emptyCache() returns the shared lists and the calling thread's lists to
+//   the pools. Other threads return their lists on their next allocator call.
+//
+// While a CUDA graph is captured on a stream (see notifyCaptureBegin), the
+// allocations on that stream are tagged with the private pool id of the
+// graph:
+//
+// - Tagged blocks are only reused by allocations with the same tag, and
+//   emptyCache() does not free them, since replays of the graph keep using
+//   the addresses that were handed out during capture.
+// - Calls that are illegal during capture (cudaEventQuery, cudaFree,
+//   synchronization) are avoided while any capture is underway: outstanding
+//   events are not polled, events for blocks used on other streams are
+//   recorded once the capture ends, and a failed cudaMalloc is not retried.
+// - The size-class front end and expandable segments are bypassed.
+//
 
 
 namespace {
@@ -63,6 +97,13 @@ constexpr size_t kSmallBuffer = 2097152;    // "small" allocations are packed in
 constexpr size_t kLargeBuffer = 20971520;   // "large" allocations may be packed in 20 MiB blocks
 constexpr size_t kMinLargeAlloc = 10485760; // allocations between 1 and 10 MiB may use kLargeBuffer
 constexpr size_t kRoundLarge = 2097152;     // round up large allocs to 2 MiB
+constexpr size_t kMaxSizeClassAlloc = 4194304; // size classes cover requests up to 4 MiB
+constexpr size_t kThreadCacheDepth = 8;     // blocks kept per size class and stream by each thread
+constexpr size_t kNumSizeClassShards = 64;  // stripes of the shared size-class state
+
+#if !defined(_WIN32) && defined(CUDA_VERSION) && CUDA_VERSION >= 10020
+#define C10_CUDA_EXPANDABLE_SEGMENTS
+#endif
 
 typedef std::bitset<static_cast<size_t>(StatType::NUM_TYPES)> StatTypes;
 
@@ -101,6 +142,95 @@ struct Block;
 typedef bool (*Comparison)(const Block*, const Block*);
 typedef std::set<Block*, Comparison> BlockPool;
 
+#ifdef C10_CUDA_EXPANDABLE_SEGMENTS
+
+// The virtual memory management entry points live in the CUDA driver library,
+// which c10_cuda does not link against. They are resolved on first use so
+// that the allocator keeps working with drivers that do not provide them.
+struct DriverAPI {
+  decltype(&cuGetErrorString) cuGetErrorString_ = nullptr;
+  decltype(&cuMemGetAllocationGranularity) cuMemGetAllocationGranularity_ = nullptr;
+  decltype(&cuMemAddressReserve) cuMemAddressReserve_ = nullptr;
+  decltype(&cuMemAddressFree) cuMemAddressFree_ = nullptr;
+  decltype(&cuMemCreate) cuMemCreate_ = nullptr;
+  decltype(&cuMemRelease) cuMemRelease_ = nullptr;
+  decltype(&cuMemMap) cuMemMap_ = nullptr;
+  decltype(&cuMemUnmap) cuMemUnmap_ = nullptr;
+  decltype(&cuMemSetAccess) cuMemSetAccess_ = nullptr;
+  bool available = false;
+
+  static const DriverAPI& get() {
+    static DriverAPI api = load();
+    return api;
+  }
+
+ private:
+  static DriverAPI load() {
+    DriverAPI api;
+    void* handle = dlopen("libcuda.so.1", RTLD_LAZY | RTLD_NOLOAD);
+    if (handle == nullptr) {
+      handle = dlopen("libcuda.so.1", RTLD_LAZY);
+    }
+    if (handle == nullptr) {
+      return api;
+    }
+#define LOOKUP_DRIVER_ENTRY_POINT(name) \
+    api.name##_ = reinterpret_cast<decltype(&name)>(dlsym(handle, #name)); \
+    if (api.name##_ == nullptr) { \
+      return api; \
+    }
+    LOOKUP_DRIVER_ENTRY_POINT(cuGetErrorString)
+    LOOKUP_DRIVER_ENTRY_POINT(cuMemGetAllocationGranularity)
+    LOOKUP_DRIVER_ENTRY_POINT(cuMemAddressReserve)
+    LOOKUP_DRIVER_ENTRY_POINT(cuMemAddressFree)
+    LOOKUP_DRIVER_ENTRY_POINT(cuMemCreate)
+    LOOKUP_DRIVER_ENTRY_POINT(cuMemRelease)
+    LOOKUP_DRIVER_ENTRY_POINT(cuMemMap)
+    LOOKUP_DRIVER_ENTRY_POINT(cuMemUnmap)
+    LOOKUP_DRIVER_ENTRY_POINT(cuMemSetAccess)
+#undef LOOKUP_DRIVER_ENTRY_POINT
+    api.available = true;
+    return api;
+  }
+};
+
+#define C10_CUDA_DRIVER_CHECK(EXPR)                                         \
+  do {                                                                      \
+    CUresult __err = EXPR;                                                  \
+    if (__err != CUDA_SUCCESS) {                                            \
+      const char* err_str = nullptr;                                        \
+      DriverAPI::get().cuGetErrorString_(__err, &err_str);                  \
+      TORCH_CHECK(false, "CUDA driver error: ", err_str ? err_str : "unknown"); \
+    }                                                                       \
+  } while (0)
+
+// A range of virtual addresses reserved up front, backed by physical memory
+// that is mapped granule by granule as the segment grows.
+struct ExpandableSegment {
+  int          device;        // gpu
+  cudaStream_t stream;        // allocation stream
+  CUdeviceptr  ptr;           // base of the reserved range
+  size_t       reserved_size; // size of the reserved range in bytes
+  size_t       granularity;   // size of one physical allocation
+  Block*       tail;          // block at the end of the mapped range
+  std::vector<CUmemGenericAllocationHandle> handles; // mapped physical memory
+
+  size_t mapped_size() const {
+    return handles.size() * granularity;
+  }
+};
+
+#else
+
+struct ExpandableSegment {
+  Block* tail;
+  size_t mapped_size() const {
+    return 0;
+  }
+};
+
+#endif // C10_CUDA_EXPANDABLE_SEGMENTS
+
 struct Block {
   int           device;      // gpu
   cudaStream_t  stream;      // allocation stream
@@ -112,21 +242,39 @@ struct Block {
   Block*        prev;        // prev block if split from a larger allocation
   Block*        next;        // next block if split from a larger allocation
   int           event_count; // number of outstanding CUDA events
+  ExpandableSegment* expandable; // owning segment if it grows in place
+  uint64_t      pool_id;     // private pool of a graph capture, 0 if none
 
-  Block(int device, cudaStream_t stream, size_t size, BlockPool* pool, void* ptr) :
+  Block(int device, cudaStream_t stream, size_t size, BlockPool* pool, void* ptr, uint64_t pool_id = 0) :
     device(device), stream(stream), stream_uses(), size(size), pool(pool),
-    ptr(ptr), allocated(0), prev(nullptr), next(nullptr), event_count(0) { }
+    ptr(ptr), allocated(0), prev(nullptr), next(nullptr), event_count(0),
+    expandable(nullptr), pool_id(pool_id) { }
 
   // constructor for search key
-  Block(int device, cudaStream_t stream, size_t size) :
+  Block(int device, cudaStream_t stream, size_t size, uint64_t pool_id = 0) :
     device(device), stream(stream), stream_uses(), size(size), pool(nullptr),
-    ptr(nullptr), allocated(0), prev(nullptr), next(nullptr), event_count(0) { }
+    ptr(nullptr), allocated(0), prev(nullptr), next(nullptr), event_count(0),
+    expandable(nullptr), pool_id(pool_id) { }
 
   bool is_split() const {
     return (prev != nullptr) || (next != nullptr);
   }
 };
 
+// An event recorded on a stream that used a freed block. The block is not
+// reused before all of its events are complete, or before its allocation
+// stream waits on a later event of the same stream (see notifyStreamWaitEvent).
+struct StreamUse {
+  cudaEvent_t event;
+  Block*      block;
+  uint64_t    seq;   // number of uses recorded on the stream before this one
+};
+
+struct StreamUses {
+  std::deque<StreamUse> uses;  // in the order they were recorded
+  uint64_t next_seq = 0;
+};
+
 static bool BlockComparator(const Block* a, const Block* b)
 {
   if (a->device != b->device) {
@@ -135,6 +283,9 @@ static bool BlockComparator(const Block* a, const Block* b)
   if (a->stream != b->stream) {
     return (uintptr_t)a->stream < (uintptr_t)b->stream;
   }
+  if (a->pool_id != b->pool_id) {
+    return a->pool_id < b->pool_id;
+  }
   if (a->size != b->size) {
     return a->size < b->size;
   }
@@ -160,6 +311,11 @@ static std::string format_size(uint64_t size) {
   return os.str();
 }
 
+static bool env_flag_enabled(const char* name) {
+  const char* env = getenv(name);
+  return env != nullptr && strcmp(env, "0") != 0;
+}
+
 } // namespace
 
 class THCCachingAllocator {
@@ -184,36 +340,72 @@ class THCCachingAllocator {
   // allocated blocks by device pointer
   std::unordered_map<void*, Block*> allocated_blocks;
 
-  // outstanding cuda events
-  std::deque<std::pair<cudaEvent_t, Block*>> cuda_events;
+  // outstanding cuda events by the stream they were recorded on; events of
+  // one stream complete in order, so each queue is polled up to its first
+  // incomplete event
+  std::unordered_map<cuda::CUDAStream, StreamUses> cuda_events;
+
+  // number of events in cuda_events, readable without the mutex
+  std::atomic<size_t> num_stream_uses;
+
+  // client events recorded on a stream while it had outstanding uses, with
+  // the stream and the number of uses recorded on it before the event. Uses
+  // are numbered in order, so a mark never covers a use recorded after the
+  // event, even if the event was recorded again since.
+  std::unordered_map<cudaEvent_t, std::pair<cuda::CUDAStream, uint64_t>> event_marks;
+
+  // whether large requests grow expandable segments instead of calling cudaMalloc
+  bool expandable_segments_enabled;
+
+  // expandable segments by device and allocation stream
+  std::map<std::pair<int, cudaStream_t>, ExpandableSegment*> expandable_segments;
+
+  // private pools of the graph captures underway, by device and capture stream
+  std::map<std::pair<int, cudaStream_t>, uint64_t> capture_pools;
+
+  // size of capture_pools, readable without the mutex
+  std::atomic<size_t> num_captures;
+
+  // freed blocks used on other streams whose events wait for the captures to end
+  std::vector<Block*> needs_events_deferred_until_no_capture;
 
  public:
 
   THCCachingAllocator() :
       large_blocks(BlockComparator),
-      small_blocks(BlockComparator) {}
+      small_blocks(BlockComparator),
+      expandable_segments_enabled(env_flag_enabled("PYTORCH_CUDA_ALLOCATOR_EXPANDABLE_SEGMENTS")),
+      num_captures(0),
+      num_stream_uses(0) {}
 
   std::mutex* getCudaFreeMutex() const {
     return &cuda_free_mutex;
   }
 
+  bool capturesUnderway() const {
+    return num_captures > 0;
+  }
+
   // All public methods (except the above) acquire the allocator mutex.
   // Thus, do not call a public method from another public method.
 
   /** allocates a block which is safe to use from the provided stream */
-  void malloc(void** devPtr, size_t size, cudaStream_t stream)
+  void malloc(void** devPtr, size_t size, cudaStream_t stream, size_t* blockSize = nullptr)
   {
     std::lock_guard<std::recursive_mutex> lock(mutex);
 
     int device;
     C10_CUDA_CHECK(cudaGetDevice(&device));
 
-    // process outstanding cudaEvents
-    process_events();
+    // process outstanding cudaEvents; querying them is illegal during capture
+    if (capture_pools.empty()) {
+      process_events();
+    }
 
     size = round_size(size);
 
-    Block search_key(device, stream, size);
+    const uint64_t pool_id = get_capture_pool_id(device, stream);
+    Block search_key(device, stream, size, pool_id);
     auto& pool = get_pool(size);
 
     DeviceStats& stats = get_stats_for_device(device);
@@ -224,7 +416,7 @@ class THCCachingAllocator {
     auto find_free_block = [&]()->Block*{
       auto it = pool.lower_bound(&search_key);
       if (it != pool.end() && (*it)->device == device &&
-          (*it)->stream == stream) {
+          (*it)->stream == stream && (*it)->pool_id == pool_id) {
         Block* block = *it;
         pool.erase(it);
         return block;
@@ -245,13 +437,18 @@ class THCCachingAllocator {
     }
     if (block == nullptr) {
       void* ptr;
-      size_t alloc_size = get_allocation_size(size);
-      cudaError_t err = cuda_malloc_with_retry(device, &ptr, alloc_size);
+      const bool expandable = &pool == &large_blocks && pool_id == 0 && use_expandable_segments();
+      size_t alloc_size = expandable ? size : get_allocation_size(size);
+      cudaError_t err = expandable
+          ? expand_segment_with_retry(device, stream, size, &block)
+          : cuda_malloc_with_retry(device, &ptr, alloc_size);
 
       if (err == cudaSuccess) {
-        block = new Block(device, stream, alloc_size, &pool, ptr);
-        update_stat_array(stats.segment, 1, stat_types);
-        update_stat_array(stats.reserved_bytes, alloc_size, stat_types);
+        if (block == nullptr) {
+          block = new Block(device, stream, alloc_size, &pool, ptr, pool_id);
+          update_stat_array(stats.segment, 1, stat_types);
+          update_stat_array(stats.reserved_bytes, alloc_size, stat_types);
+        }
       } else if (err == cudaErrorMemoryAllocation) {
         cudaGetLastError();  // clear CUDA error
 
@@ -299,7 +496,7 @@ class THCCachingAllocator {
     if (should_split(block, size)) {
       remaining = block;
 
-      block = new Block(device, stream, size, &pool, block->ptr);
+      block = new Block(device, stream, size, &pool, block->ptr, pool_id);
       block->prev = remaining->prev;
       if (block->prev) {
         block->prev->next = block;
@@ -330,6 +527,9 @@ class THCCachingAllocator {
     allocated_blocks[block->ptr] = block;
 
     *devPtr = block->ptr;
+    if (blockSize) {
+      *blockSize = block->size;
+    }
 
     update_stat_array(stats.allocation, 1, stat_types);
     update_stat_array(stats.allocated_bytes, block->size, stat_types);
@@ -361,18 +561,136 @@ class THCCachingAllocator {
     update_stat_array(stats.allocated_bytes, -block->size, {stat_types});
 
     if (!block->stream_uses.empty()) {
-      insert_events(block);
+      update_stat_array(stats.deferred_free, 1, stat_types);
+      update_stat_array(stats.deferred_free_bytes, block->size, stat_types);
+      if (capture_pools.empty()) {
+        insert_events(block);
+      } else {
+        needs_events_deferred_until_no_capture.push_back(block);
+      }
     } else {
       free_block(block);
     }
   }
 
+  /** remembers which outstanding uses of `stream` precede `event` */
+  void notifyEventRecorded(cudaEvent_t event, cuda::CUDAStream stream) {
+    if (num_stream_uses == 0) {
+      return;
+    }
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    auto it = cuda_events.find(stream);
+    if (it == cuda_events.end() || it->second.uses.empty()) {
+      return;
+    }
+    const auto mark = std::make_pair(stream, it->second.next_seq);
+    auto inserted = event_marks.emplace(event, mark);
+    if (!inserted.second) {
+      inserted.first->second = mark;
+    }
+  }
+
+  /** frees the blocks whose outstanding uses are now ordered before later work on `stream` */
+  void notifyStreamWaitEvent(cudaEvent_t event, cuda::CUDAStream stream) {
+    if (num_stream_uses == 0) {
+      return;
+    }
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    auto mark = event_marks.find(event);
+    if (mark == event_marks.end()) {
+      return;
+    }
+    auto it = cuda_events.find(mark->second.first);
+    if (it == cuda_events.end()) {
+      return;
+    }
+    auto& uses = it->second.uses;
+    const uint64_t end_seq = mark->second.second;
+    for (auto use = uses.begin(); use != uses.end() && use->seq < end_seq;) {
+      Block* block = use->block;
+      if (block->device != stream.device_index() || block->stream != stream.stream()) {
+        ++use;
+        continue;
+      }
+      // Destroying an event that has not completed yet is fine; its
+      // resources are released once it completes.
+      C10_CUDA_CHECK(cudaEventDestroy(use->event));
+      get_stats_for_device(block->device).num_deferred_frees_released_by_wait += 1;
+      use = uses.erase(use);
+      release_stream_use(block);
+    }
+  }
+
+  /** routes the allocations on a stream to a private pool until the capture ends */
+  void notifyCaptureBegin(int device, cudaStream_t stream, uint64_t pool_id) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    TORCH_CHECK(pool_id != 0, "notifyCaptureBegin: pool id 0 is reserved for the regular pools");
+    const bool inserted = capture_pools.emplace(std::make_pair(device, stream), pool_id).second;
+    TORCH_CHECK(inserted, "notifyCaptureBegin: a capture is already underway on this stream");
+    num_captures = capture_pools.size();
+  }
+
+  void notifyCaptureEnd(int device, cudaStream_t stream) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    capture_pools.erase(std::make_pair(device, stream));
+    num_captures = capture_pools.size();
+    if (capture_pools.empty()) {
+      for (Block* block : needs_events_deferred_until_no_capture) {
+        insert_events(block);
+      }
+      needs_events_deferred_until_no_capture.clear();
+    }
+  }
+
+  /** hands all blocks of a private pool to the regular pools */
+  void releasePool(uint64_t pool_id) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    for (const auto& item : capture_pools) {
+      TORCH_CHECK(item.second != pool_id, "releasePool: the pool is used by a capture that is underway");
+    }
+    for (BlockPool* pool : {&large_blocks, &small_blocks}) {
+      // the pool id is part of the ordering, so the blocks have to be reinserted
+      std::vector<Block*> released;
+      for (auto it = pool->begin(); it != pool->end();) {
+        if ((*it)->pool_id == pool_id) {
+          released.push_back(*it);
+          it = pool->erase(it);
+        } else {
+          ++it;
+        }
+      }
+      for (Block* block : released) {
+        block->pool_id = 0;
+        pool->insert(block);
+      }
+    }
+    for (auto& item : allocated_blocks) {
+      if (item.second->pool_id == pool_id) {
+        item.second->pool_id = 0;
+      }
+    }
+    for (auto& item : cuda_events) {
+      for (StreamUse& use : item.second.uses) {
+        if (use.block->pool_id == pool_id) {
+          use.block->pool_id = 0;
+        }
+      }
+    }
+    for (Block* block : needs_events_deferred_until_no_capture) {
+      if (block->pool_id == pool_id) {
+        block->pool_id = 0;
+      }
+    }
+  }
+
   void* getBaseAllocation(void* ptr, size_t* outSize) {
     std::lock_guard<std::recursive_mutex> lock(mutex);
     Block* block = find_allocated_block(ptr);
     if (!block) {
       AT_ERROR("invalid device pointer: ", ptr);
     }
+    TORCH_CHECK(!block->expandable,
+        "getBaseAllocation is not supported for memory in expandable segments");
     while (block->prev) {
       block = block->prev;
     }
@@ -412,9 +730,22 @@ class THCCachingAllocator {
   /** returns cached blocks to the system allocator **/
   void emptyCache() {
     std::lock_guard<std::recursive_mutex> lock(mutex);
+    TORCH_CHECK(capture_pools.empty(), "emptyCache is not allowed while a CUDA graph is captured");
     synchronize_and_free_events(nullopt);
     free_blocks(large_blocks, large_blocks.begin(), large_blocks.end());
     free_blocks(small_blocks, small_blocks.begin(), small_blocks.end());
+    shrink_expandable_segments(nullopt);
+  }
+
+  /** enables or disables growing expandable segments for new large blocks **/
+  void setExpandableSegments(bool enabled) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    expandable_segments_enabled = enabled;
+  }
+
+  bool expandableSegmentsEnabled() const {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    return expandable_segments_enabled;
   }
 
   /** Retrieves info (total size + largest block) of the memory cache **/
@@ -444,10 +775,13 @@ class THCCachingAllocator {
       reset_accumulated_stat(stats.reserved_bytes[statType]);
       reset_accumulated_stat(stats.active_bytes[statType]);
       reset_accumulated_stat(stats.inactive_split_bytes[statType]);
+      reset_accumulated_stat(stats.deferred_free[statType]);
+      reset_accumulated_stat(stats.deferred_free_bytes[statType]);
     }
 
     stats.num_alloc_retries = 0;
     stats.num_ooms = 0;
+    stats.num_deferred_frees_released_by_wait = 0;
   }
 
   /** Resets the historical peak stats for the device **/
@@ -464,6 +798,8 @@ class THCCachingAllocator {
       reset_peak_stat(stats.reserved_bytes[statType]);
       reset_peak_stat(stats.active_bytes[statType]);
       reset_peak_stat(stats.inactive_split_bytes[statType]);
+      reset_peak_stat(stats.deferred_free[statType]);
+      reset_peak_stat(stats.deferred_free_bytes[statType]);
     }
   }
 
@@ -483,6 +819,7 @@ class THCCachingAllocator {
       segment_info.device = head_block->device;
       segment_info.address = reinterpret_cast<int64_t>(head_block->ptr);
       segment_info.is_large = (head_block->pool == &large_blocks);
+      segment_info.is_expandable = (head_block->expandable != nullptr);
 
       const Block* block = head_block;
       while (block != nullptr) {
@@ -503,6 +840,15 @@ class THCCachingAllocator {
 
         block = block->next;
       }
+
+#ifdef C10_CUDA_EXPANDABLE_SEGMENTS
+      if (head_block->expandable) {
+        segment_info.reserved_size = head_block->expandable->reserved_size;
+      } else
+#endif
+      {
+        segment_info.reserved_size = segment_info.total_size;
+      }
     }
 
     std::sort(result.begin(), result.end(), [](const SegmentInfo& a, const SegmentInfo& b) {
@@ -596,6 +942,10 @@ class THCCachingAllocator {
       }
     }
 
+    if (src->expandable && src->expandable->tail == src) {
+      src->expandable->tail = dst;
+    }
+
     const size_t subsumed_size = src->size;
     dst->size += subsumed_size;
     pool.erase(src);
@@ -604,6 +954,14 @@ class THCCachingAllocator {
     return subsumed_size;
   }
 
+  uint64_t get_capture_pool_id(int device, cudaStream_t stream) const {
+    if (capture_pools.empty()) {
+      return 0;
+    }
+    auto it = capture_pools.find(std::make_pair(device, stream));
+    return it == capture_pools.end() ? 0 : it->second;
+  }
+
   BlockPool& get_pool(size_t size) {
     if (size <= kSmallSize) {
       return small_blocks;
@@ -657,7 +1015,8 @@ class THCCachingAllocator {
     // and retries.
     cudaError_t err = cudaMalloc(devPtr, size);
 
-    if (err != cudaSuccess) {
+    // Freeing cached blocks synchronizes, which would invalidate a capture.
+    if (err != cudaSuccess && capture_pools.empty()) {
       DeviceStats& stats = get_stats_for_device(device);
       stats.num_alloc_retries += 1;
       cudaGetLastError();  // reset the last CUDA error
@@ -671,6 +1030,257 @@ class THCCachingAllocator {
     return cudaSuccess;
   }
 
+  bool use_expandable_segments() {
+#ifdef C10_CUDA_EXPANDABLE_SEGMENTS
+    if (expandable_segments_enabled && !DriverAPI::get().available) {
+      TORCH_WARN("Expandable segments need the CUDA virtual memory management API, "
+                 "which this driver does not provide. Falling back to cudaMalloc.");
+      expandable_segments_enabled = false;
+    }
+#else
+    if (expandable_segments_enabled) {
+      TORCH_WARN("Expandable segments are not supported in this build. Falling back to cudaMalloc.");
+      expandable_segments_enabled = false;
+    }
+#endif
+    return expandable_segments_enabled;
+  }
+
+  cudaError_t expand_segment_with_retry(int device, cudaStream_t stream, size_t size, Block** block)
+  {
+    // Grow the expandable segment of the stream. If physical memory runs out,
+    // free all non-split cached blocks and retries.
+    if (expand_segment(device, stream, size, block)) {
+      return cudaSuccess;
+    }
+    if (!capture_pools.empty()) {
+      return cudaErrorMemoryAllocation;
+    }
+
+    DeviceStats& stats = get_stats_for_device(device);
+    stats.num_alloc_retries += 1;
+    free_cached_blocks(device);
+    if (expand_segment(device, stream, size, block)) {
+      return cudaSuccess;
+    }
+    return cudaErrorMemoryAllocation;
+  }
+
+#ifdef C10_CUDA_EXPANDABLE_SEGMENTS
+
+  /** maps enough memory at the end of the stream's expandable segment to return a free block of `size` bytes */
+  bool expand_segment(int device, cudaStream_t stream, size_t size, Block** out)
+  {
+    ExpandableSegment* segment = get_expandable_segment(device, stream);
+    Block* tail = segment->tail;
+    const bool tail_free = tail && !tail->allocated && tail->event_count == 0;
+    const size_t available = tail_free ? tail->size : 0;
+    const size_t granularity = segment->granularity;
+    const size_t needed = granularity * ((size - available + granularity - 1) / granularity);
+    const size_t old_mapped_size = segment->mapped_size();
+
+    if (old_mapped_size + needed > segment->reserved_size ||
+        !map_granules(segment, needed / granularity)) {
+      return false;
+    }
+
+    DeviceStats& stats = get_stats_for_device(device);
+    StatTypes stat_types;
+    stat_types[static_cast<size_t>(StatType::AGGREGATE)] = true;
+    stat_types[static_cast<size_t>(StatType::LARGE_POOL)] = true;
+    update_stat_array(stats.reserved_bytes, needed, stat_types);
+    if (old_mapped_size == 0) {
+      update_stat_array(stats.segment, 1, stat_types);
+    }
+
+    Block* block;
+    if (tail_free) {
+      block = tail;
+      large_blocks.erase(block);
+      block->size += needed;
+    } else {
+      void* ptr = reinterpret_cast<void*>(segment->ptr + old_mapped_size);
+      block = new Block(device, stream, needed, &large_blocks, ptr);
+      block->expandable = segment;
+      block->prev = tail;
+      if (tail) {
+        tail->next = block;
+      }
+      segment->tail = block;
+    }
+
+    // The caller accounts for the whole block as leaving the inactive split
+    // state, so the newly mapped part has to be added to it first.
+    if (block->is_split()) {
+      if (!tail_free) {
+        update_stat_array(stats.inactive_split, 1, stat_types);
+      }
+      update_stat_array(stats.inactive_split_bytes, needed, stat_types);
+    }
+
+    *out = block;
+    return true;
+  }
+
+  ExpandableSegment* get_expandable_segment(int device, cudaStream_t stream)
+  {
+    const auto key = std::make_pair(device, stream);
+    auto it = expandable_segments.find(key);
+    if (it != expandable_segments.end()) {
+      return it->second;
+    }
+
+    const DriverAPI& driver = DriverAPI::get();
+    size_t device_free;
+    size_t device_total;
+    C10_CUDA_CHECK(cudaMemGetInfo(&device_free, &device_total));
+
+    CUmemAllocationProp prop = {};
+    prop.type = CU_MEM_ALLOCATION_TYPE_PINNED;
+    prop.location.type = CU_MEM_LOCATION_TYPE_DEVICE;
+    prop.location.id = device;
+    size_t granularity;
+    C10_CUDA_DRIVER_CHECK(driver.cuMemGetAllocationGranularity_(
+        &granularity, &prop, CU_MEM_ALLOC_GRANULARITY_MINIMUM));
+
+    // Reserve enough address space for the segment to grow up to the whole
+    // device; only mapped memory is backed by physical pages.
+    const size_t reserved_size = granularity * ((device_total + granularity - 1) / granularity);
+    CUdeviceptr ptr;
+    C10_CUDA_DRIVER_CHECK(driver.cuMemAddressReserve_(&ptr, reserved_size, 0, 0, 0));
+
+    ExpandableSegment* segment = new ExpandableSegment();
+    segment->device = device;
+    segment->stream = stream;
+    segment->ptr = ptr;
+    segment->reserved_size = reserved_size;
+    segment->granularity = granularity;
+    segment->tail = nullptr;
+    expandable_segments.emplace(key, segment);
+    return segment;
+  }
+
+  /** maps `count` granules at the end of the segment. Returns false, mapping nothing, when out of memory. */
+  bool map_granules(ExpandableSegment* segment, size_t count)
+  {
+    const DriverAPI& driver = DriverAPI::get();
+    CUmemAllocationProp prop = {};
+    prop.type = CU_MEM_ALLOCATION_TYPE_PINNED;
+    prop.location.type = CU_MEM_LOCATION_TYPE_DEVICE;
+    prop.location.id = segment->device;
+    CUmemAccessDesc access = {};
+    access.location = prop.location;
+    access.flags = CU_MEM_ACCESS_FLAGS_PROT_READWRITE;
+
+    const size_t old_count = segment->handles.size();
+    for (size_t i = 0; i < count; ++i) {
+      CUmemGenericAllocationHandle handle;
+      CUresult err = driver.cuMemCreate_(&handle, segment->granularity, &prop, 0);
+      if (err == CUDA_ERROR_OUT_OF_MEMORY) {
+        unmap_granules(segment, old_count);
+        return false;
+      }
+      C10_CUDA_DRIVER_CHECK(err);
+
+      const CUdeviceptr ptr = segment->ptr + segment->mapped_size();
+      C10_CUDA_DRIVER_CHECK(driver.cuMemMap_(ptr, segment->granularity, 0, handle, 0));
+      segment->handles.push_back(handle);
+      C10_CUDA_DRIVER_CHECK(driver.cuMemSetAccess_(ptr, segment->granularity, &access, 1));
+    }
+    return true;
+  }
+
+  /** unmaps all granules past the first `count` and releases their memory */
+  void unmap_granules(ExpandableSegment* segment, size_t count)
+  {
+    if (segment->handles.size() <= count) {
+      return;
+    }
+    // Unlike cudaFree, unmapping does not wait for work that still uses the
+    // memory.
+    C10_CUDA_CHECK(cudaStreamSynchronize(segment->stream));
+
+    const DriverAPI& driver = DriverAPI::get();
+    while (segment->handles.size() > count) {
+      const CUdeviceptr ptr = segment->ptr + (segment->handles.size() - 1) * segment->granularity;
+      C10_CUDA_DRIVER_CHECK(driver.cuMemUnmap_(ptr, segment->granularity));
+      C10_CUDA_DRIVER_CHECK(driver.cuMemRelease_(segment->handles.back()));
+      segment->handles.pop_back();
+    }
+  }
+
+  /** unmaps the free memory at the end of expandable segments */
+  void shrink_expandable_segments(optional<int> device)
+  {
+    for (auto it = expandable_segments.begin(); it != expandable_segments.end();) {
+      ExpandableSegment* segment = it->second;
+      Block* tail = segment->tail;
+      if ((device.has_value() && segment->device != *device) ||
+          !tail || tail->allocated || tail->event_count > 0) {
+        ++it;
+        continue;
+      }
+
+      CUDAGuard device_guard(segment->device);
+
+      // Keep the granules that are partially used by the blocks before the tail.
+      const size_t granularity = segment->granularity;
+      const size_t tail_offset = reinterpret_cast<uintptr_t>(tail->ptr) - static_cast<uintptr_t>(segment->ptr);
+      const size_t kept_count = (tail_offset + granularity - 1) / granularity;
+      const size_t released = segment->mapped_size() - kept_count * granularity;
+      if (released == 0) {
+        ++it;
+        continue;
+      }
+
+      DeviceStats& stats = get_stats_for_device(segment->device);
+      StatTypes stat_types;
+      stat_types[static_cast<size_t>(StatType::AGGREGATE)] = true;
+      stat_types[static_cast<size_t>(StatType::LARGE_POOL)] = true;
+
+      const bool was_split = tail->is_split();
+      large_blocks.erase(tail);
+      tail->size -= released;
+      if (tail->size == 0) {
+        segment->tail = tail->prev;
+        if (tail->prev) {
+          tail->prev->next = nullptr;
+        }
+        delete tail;
+        if (was_split) {
+          update_stat_array(stats.inactive_split, -1, stat_types);
+        }
+      } else {
+        large_blocks.insert(tail);
+      }
+      if (was_split) {
+        update_stat_array(stats.inactive_split_bytes, -released, stat_types);
+      }
+
+      unmap_granules(segment, kept_count);
+      update_stat_array(stats.reserved_bytes, -released, stat_types);
+
+      if (segment->mapped_size() == 0) {
+        update_stat_array(stats.segment, -1, stat_types);
+        C10_CUDA_DRIVER_CHECK(DriverAPI::get().cuMemAddressFree_(segment->ptr, segment->reserved_size));
+        delete segment;
+        it = expandable_segments.erase(it);
+      } else {
+        ++it;
+      }
+    }
+  }
+
+#else
+
+  bool expand_segment(int device, cudaStream_t stream, size_t size, Block** out) {
+    return false;
+  }
+
+  void shrink_expandable_segments(optional<int> device) {}
+
+#endif // C10_CUDA_EXPANDABLE_SEGMENTS
+
   void free_cached_blocks(int device)
   {
     // First ensure that all blocks that can't currently be allocated due to
@@ -689,14 +1299,18 @@ class THCCachingAllocator {
         small_blocks,
         small_blocks.lower_bound(&lower_bound),
         small_blocks.lower_bound(&upper_bound));
+
+    shrink_expandable_segments(device);
   }
 
   void free_blocks(BlockPool& blocks, BlockPool::iterator it, BlockPool::iterator end)
   {
-    // Frees all non-split blocks between `it` and `end`
+    // Frees all non-split blocks between `it` and `end`. Blocks in expandable
+    // segments are released by shrink_expandable_segments instead, and blocks
+    // of private pools only once the pool is released.
     while (it != end) {
       Block* block = *it;
-      if (!block->prev && !block->next) {
+      if (!block->prev && !block->next && !block->expandable && block->pool_id == 0) {
         C10_CUDA_CHECK(cudaFree((void*)block->ptr));
 
         DeviceStats& stats = get_stats_for_device(block->device);
@@ -720,26 +1334,22 @@ class THCCachingAllocator {
     // Synchronize on outstanding events and then free associated blocks.
     // Limited to blocks on the given device if specified.
 
-    auto remaining_events = decltype(cuda_events)();
-
-    for (auto& e : cuda_events) {
-      cudaEvent_t event = e.first;
-      Block* block = e.second;
-      if (device.has_value() && block->device != *device) {
-        remaining_events.push_back(e);
-        continue;
-      }
+    for (auto& item : cuda_events) {
+      auto& uses = item.second.uses;
+      for (auto use = uses.begin(); use != uses.end();) {
+        Block* block = use->block;
+        if (device.has_value() && block->device != *device) {
+          ++use;
+          continue;
+        }
 
-      C10_CUDA_CHECK(cudaEventSynchronize(event));
-      C10_CUDA_CHECK(cudaEventDestroy(event));
+        C10_CUDA_CHECK(cudaEventSynchronize(use->event));
+        C10_CUDA_CHECK(cudaEventDestroy(use->event));
 
-      block->event_count--;
-      if (block->event_count == 0) {
-        free_block(block);
+        use = uses.erase(use);
+        release_stream_use(block);
       }
     }
-
-    std::swap(cuda_events, remaining_events);
   }
 
   Block* find_allocated_block(void *ptr) {
@@ -765,40 +1375,57 @@ class THCCachingAllocator {
       C10_CUDA_CHECK(cudaEventRecord(event, it->stream()));
 
       block->event_count++;
-      cuda_events.emplace_back(event, block);
+      StreamUses& uses = cuda_events[*it];
+      uses.uses.push_back(StreamUse{event, block, uses.next_seq++});
+      num_stream_uses++;
     }
 
     C10_CUDA_CHECK(cudaSetDevice(prev_device));
   }
 
+  /** drops one outstanding event of a freed block, whose event was already destroyed */
+  void release_stream_use(Block* block)
+  {
+    if (--num_stream_uses == 0) {
+      event_marks.clear();
+    }
+    block->event_count--;
+    if (block->event_count == 0) {
+      DeviceStats& stats = get_stats_for_device(block->device);
+      StatTypes stat_types;
+      stat_types[static_cast<size_t>(StatType::AGGREGATE)] = true;
+      stat_types[static_cast<size_t>(get_stat_type_for_pool(*(block->pool)))] = true;
+      update_stat_array(stats.deferred_free, -1, stat_types);
+      update_stat_array(stats.deferred_free_bytes, -block->size, stat_types);
+      free_block(block);
+    }
+  }
+
   void process_events()
   {
     // Process outstanding cudaEvents. Events that are completed are removed
-    // from the queue, and the 'event_count' for the corresponding allocation
-    // is decremented. Stops at the first event which has not been completed.
-    // Since events on different devices or streams may occur out of order,
-    // the processing of some events may be delayed.
-    while (!cuda_events.empty()) {
-      auto& e = cuda_events.front();
-      cudaEvent_t event = e.first;
-      Block* block = e.second;
-
-      cudaError_t err = cudaEventQuery(event);
-      if (err == cudaErrorNotReady) {
-        // ignore and clear the error if not ready
-        cudaGetLastError();
-        break;
-      } else if (err != cudaSuccess) {
-        C10_CUDA_CHECK(err);
-      }
+    // from the queues, and the 'event_count' for the corresponding allocation
+    // is decremented. Since events of one stream complete in order, each
+    // queue is processed up to its first event which has not been completed.
+    for (auto& item : cuda_events) {
+      auto& uses = item.second.uses;
+      while (!uses.empty()) {
+        const StreamUse use = uses.front();
+
+        cudaError_t err = cudaEventQuery(use.event);
+        if (err == cudaErrorNotReady) {
+          // ignore and clear the error if not ready
+          cudaGetLastError();
+          break;
+        } else if (err != cudaSuccess) {
+          C10_CUDA_CHECK(err);
+        }
 
-      C10_CUDA_CHECK(cudaEventDestroy(event));
+        C10_CUDA_CHECK(cudaEventDestroy(use.event));
 
-      block->event_count--;
-      if (block->event_count == 0) {
-        free_block(block);
+        uses.pop_front();
+        release_stream_use(use.block);
       }
-      cuda_events.pop_front();
     }
   }
 
@@ -819,8 +1446,463 @@ class THCCachingAllocator {
 
 THCCachingAllocator caching_allocator;
 
+namespace {
+
+struct SizeClassBlock {
+  void*             ptr;         // memory address
+  int               device;      // gpu
+  cudaStream_t      stream;      // allocation stream
+  size_t            size;        // size of the underlying block in bytes
+  size_t            size_class;  // rounded request size is kMinBlockSize << size_class
+  bool              is_small;    // carved from the small pool
+  std::atomic<bool> cached;      // parked in a free list
+  std::atomic<bool> stream_used; // used on a stream other than `stream`
+
+  SizeClassBlock(void* ptr, int device, cudaStream_t stream, size_t size, size_t size_class) :
+    ptr(ptr), device(device), stream(stream), size(size), size_class(size_class),
+    is_small(size <= kSmallSize), cached(false), stream_used(false) { }
+};
+
+struct SizeClassKey {
+  int          device;
+  cudaStream_t stream;
+  size_t       size_class;
+
+  bool operator==(const SizeClassKey& other) const {
+    return device == other.device && stream == other.stream &&
+        size_class == other.size_class;
+  }
+};
+
+struct SizeClassKeyHash {
+  size_t operator()(const SizeClassKey& key) const {
+    size_t h = std::hash<void*>()(static_cast<void*>(key.stream));
+    h ^= std::hash<int>()(key.device) + 0x9e3779b9 + (h << 6) + (h >> 2);
+    h ^= std::hash<size_t>()(key.size_class) + 0x9e3779b9 + (h << 6) + (h >> 2);
+    return h;
+  }
+};
+
+typedef std::unordered_map<SizeClassKey, std::vector<SizeClassBlock*>, SizeClassKeyHash> SizeClassFreeLists;
+
+struct SizeClassShard {
+  std::mutex mutex;
+  // size-class blocks by device pointer (sharded by pointer)
+  std::unordered_map<void*, SizeClassBlock*> blocks;
+  // shared free lists (sharded by key)
+  SizeClassFreeLists free_lists;
+};
+
+// Free lists private to one thread. Blocks are moved to the shared lists
+// when the thread exits.
+struct ThreadSizeClassCache {
+  uint64_t           epoch = 0;
+  SizeClassFreeLists free_lists;
+
+  ~ThreadSizeClassCache();
+};
+
+static size_t size_class_index(size_t size) {
+  size_t size_class = 0;
+  while ((kMinBlockSize << size_class) < size) {
+    ++size_class;
+  }
+  return size_class;
+}
+
+ThreadSizeClassCache& get_thread_size_class_cache() {
+  static thread_local ThreadSizeClassCache cache;
+  return cache;
+}
+
+} // namespace
+
+class SizeClassAllocator {
+
+ private:
+
+  // whether new requests are served from size classes
+  std::atomic<bool> enabled;
+
+  // number of live size-class blocks; lets free() skip the lookup when zero
+  std::atomic<int64_t> num_blocks;
+
+  // bumped by emptyCache() so that threads release their private lists
+  std::atomic<uint64_t> epoch;
+
+  std::array<SizeClassShard, kNumSizeClassShards> shards;
+
+  // per-device counters of cached blocks, indexed by StatType
+  struct CachedStats {
+    std::array<std::atomic<int64_t>, static_cast<size_t>(StatType::NUM_TYPES)> blocks;
+    std::array<std::atomic<int64_t>, static_cast<size_t>(StatType::NUM_TYPES)> bytes;
+  };
+  std::array<CachedStats, C10_COMPILE_TIME_MAX_GPUS> cached_stats;
+
+ public:
+
+  SizeClassAllocator() : enabled(env_flag_enabled("PYTORCH_CUDA_ALLOCATOR_SIZE_CLASSES")), num_blocks(0), epoch(0) {
+    for (auto& stats : cached_stats) {
+      for (size_t i = 0; i < stats.blocks.size(); ++i) {
+        stats.blocks[i] = 0;
+        stats.bytes[i] = 0;
+      }
+    }
+  }
+
+  void setEnabled(bool value) {
+    enabled = value;
+  }
+
+  bool isEnabled() const {
+    return enabled;
+  }
+
+  /** returns a cached or newly carved block, or nullptr if the request is not served by size classes */
+  void* malloc(int device, size_t size, cudaStream_t stream)
+  {
+    if (!enabled || size > kMaxSizeClassAlloc || device >= C10_COMPILE_TIME_MAX_GPUS ||
+        caching_allocator.capturesUnderway()) {
+      return nullptr;
+    }
+
+    const SizeClassKey key{device, stream, size_class_index(size)};
+    ThreadSizeClassCache& cache = get_thread_size_class_cache();
+    maybe_release_thread_cache(cache);
+
+    SizeClassBlock* block = nullptr;
+    auto it = cache.free_lists.find(key);
+    if (it != cache.free_lists.end() && !it->second.empty()) {
+      block = it->second.back();
+      it->second.pop_back();
+    } else {
+      block = pop_shared(key);
+    }
+
+    if (block) {
+      block->cached = false;
+      update_cached_stats(*block, -1);
+      return block->ptr;
+    }
+
+    void* ptr = nullptr;
+    size_t block_size = 0;
+    caching_allocator.malloc(&ptr, kMinBlockSize << key.size_class, stream, &block_size);
+    block = new SizeClassBlock(ptr, device, stream, block_size, key.size_class);
+    SizeClassShard& shard = shard_for_ptr(ptr);
+    {
+      std::lock_guard<std::mutex> lock(shard.mutex);
+      shard.blocks[ptr] = block;
+    }
+    num_blocks++;
+    return ptr;
+  }
+
+  /** parks a size-class block in a free list; returns false if ptr is not a size-class block */
+  bool free(void* ptr)
+  {
+    if (num_blocks == 0) {
+      return false;
+    }
+    SizeClassBlock* block = find_block(ptr);
+    if (!block) {
+      return false;
+    }
+
+    if (block->stream_used) {
+      // Hand the block back so that the pools record events for the streams
+      // it was used on.
+      release_block(block);
+      return true;
+    }
+
+    block->cached = true;
+    update_cached_stats(*block, 1);
+
+    ThreadSizeClassCache& cache = get_thread_size_class_cache();
+    maybe_release_thread_cache(cache);
+
+    const SizeClassKey key{block->device, block->stream, block->size_class};
+    auto& list = cache.free_lists[key];
+    list.push_back(block);
+    if (list.size() > kThreadCacheDepth) {
+      // Keep the most recently freed half, which is likelier to be warm.
+      const size_t num_moved = list.size() / 2;
+      push_shared(key, list.begin(), list.begin() + num_moved);
+      list.erase(list.begin(), list.begin() + num_moved);
+    }
+    return true;
+  }
+
+  void recordStream(void* ptr, cuda::CUDAStream stream) {
+    if (!ptr || num_blocks == 0) {
+      return;
+    }
+    SizeClassBlock* block = find_block(ptr);
+    if (block && stream.stream() != block->stream) {
+      block->stream_used = true;
+    }
+  }
+
+  /** returns the shared free lists and the calling thread's free lists to the pools */
+  void emptyCache() {
+    epoch++;
+    maybe_release_thread_cache(get_thread_size_class_cache());
+
+    for (auto& shard : shards) {
+      SizeClassFreeLists free_lists;
+      {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        std::swap(free_lists, shard.free_lists);
+      }
+      release_free_lists(free_lists);
+    }
+  }
+
+  /** moves the lists of an exiting thread to the shared lists */
+  void adoptThreadCache(ThreadSizeClassCache& cache) {
+    for (auto& item : cache.free_lists) {
+      push_shared(item.first, item.second.begin(), item.second.end());
+    }
+    cache.free_lists.clear();
+  }
+
+  /** excludes cached blocks from the current allocation and active stats */
+  void adjustStats(int dev_id, DeviceStats& stats) {
+    if (dev_id >= C10_COMPILE_TIME_MAX_GPUS) {
+      return;
+    }
+    const CachedStats& cached = cached_stats[dev_id];
+    for (size_t stat_type = 0; stat_type < static_cast<size_t>(StatType::NUM_TYPES); ++stat_type) {
+      const int64_t blocks = cached.blocks[stat_type];
+      const int64_t bytes = cached.bytes[stat_type];
+      stats.allocation[stat_type].current -= blocks;
+      stats.active[stat_type].current -= blocks;
+      stats.allocated_bytes[stat_type].current -= bytes;
+      stats.active_bytes[stat_type].current -= bytes;
+    }
+    stats.size_class_cached_blocks = cached.blocks[static_cast<size_t>(StatType::AGGREGATE)];
+    stats.size_class_cached_bytes = cached.bytes[static_cast<size_t>(StatType::AGGREGATE)];
+  }
+
+  /** marks cached blocks in a snapshot of the pools */
+  void adjustSnapshot(std::vector<SegmentInfo>& segments) {
+    if (num_blocks == 0) {
+      return;
+    }
+    for (SegmentInfo& segment_info : segments) {
+      int64_t address = segment_info.address;
+      for (BlockInfo& block_info : segment_info.blocks) {
+        void* ptr = reinterpret_cast<void*>(address);
+        address += block_info.size;
+        if (!block_info.allocated) {
+          continue;
+        }
+        SizeClassBlock* block = find_block(ptr);
+        if (block && block->cached) {
+          block_info.allocated = false;
+          block_info.active = false;
+          block_info.size_class_cached = true;
+          segment_info.allocated_size -= block_info.size;
+          segment_info.active_size -= block_info.size;
+        }
+      }
+    }
+  }
+
+ private:
+
+  SizeClassShard& shard_for_ptr(void* ptr) {
+    return shards[(reinterpret_cast<uintptr_t>(ptr) / kMinBlockSize) % kNumSizeClassShards];
+  }
+
+  SizeClassShard& shard_for_key(const SizeClassKey& key) {
+    return shards[SizeClassKeyHash()(key) % kNumSizeClassShards];
+  }
+
+  SizeClassBlock* find_block(void* ptr) {
+    SizeClassShard& shard = shard_for_ptr(ptr);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.blocks.find(ptr);
+    if (it == shard.blocks.end()) {
+      return nullptr;
+    }
+    return it->second;
+  }
+
+  SizeClassBlock* pop_shared(const SizeClassKey& key) {
+    SizeClassShard& shard = shard_for_key(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.free_lists.find(key);
+    if (it == shard.free_lists.end() || it->second.empty()) {
+      return nullptr;
+    }
+    SizeClassBlock* block = it->second.back();
+    it->second.pop_back();
+    return block;
+  }
+
+  template <typename It>
+  void push_shared(const SizeClassKey& key, It begin, It end) {
+    if (begin == end) {
+      return;
+    }
+    SizeClassShard& shard = shard_for_key(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto& list = shard.free_lists[key];
+    list.insert(list.end(), begin, end);
+  }
+
+  void update_cached_stats(const SizeClassBlock& block, int64_t amount) {
+    CachedStats& stats = cached_stats[block.device];
+    const size_t pool_type = static_cast<size_t>(block.is_small ? StatType::SMALL_POOL : StatType::LARGE_POOL);
+    const size_t aggregate = static_cast<size_t>(StatType::AGGREGATE);
+    stats.blocks[aggregate] += amount;
+    stats.blocks[pool_type] += amount;
+    stats.bytes[aggregate] += amount * static_cast<int64_t>(block.size);
+    stats.bytes[pool_type] += amount * static_cast<int64_t>(block.size);
+  }
+
+  /** retires a size-class block and frees it through the pools */
+  void release_block(SizeClassBlock* block) {
+    if (block->cached) {
+      update_cached_stats(*block, -1);
+    }
+    void* ptr = block->ptr;
+    SizeClassShard& shard = shard_for_ptr(ptr);
+    {
+      std::lock_guard<std::mutex> lock(shard.mutex);
+      shard.blocks.erase(ptr);
+    }
+    num_blocks--;
+    delete block;
+    caching_allocator.free(ptr);
+  }
+
+  void release_free_lists(SizeClassFreeLists& free_lists) {
+    for (auto& item : free_lists) {
+      for (SizeClassBlock* block : item.second) {
+        release_block(block);
+      }
+    }
+    free_lists.clear();
+  }
+
+  void maybe_release_thread_cache(ThreadSizeClassCache& cache) {
+    const uint64_t current_epoch = epoch;
+    if (cache.epoch != current_epoch) {
+      cache.epoch = current_epoch;
+      release_free_lists(cache.free_lists);
+    }
+  }
+};
+
+SizeClassAllocator size_class_allocator;
+
+ThreadSizeClassCache::~ThreadSizeClassCache() {
+  size_class_allocator.adoptThreadCache(*this);
+}
+
+namespace {
+
+thread_local uint64_t trace_caller_id = 0;
+
+// Ring buffer of allocator events. Recording takes its own mutex so that it
+// does not serialize the size-class fast paths with the pools.
+class TraceRecorder {
+
+ private:
+
+  std::atomic<bool> enabled{false};
+  std::mutex mutex;
+  std::vector<TraceEntry> entries;
+  size_t next = 0;
+  bool wrapped = false;
+
+ public:
+
+  bool isEnabled() const {
+    return enabled.load(std::memory_order_relaxed);
+  }
+
+  void setEnabled(bool value, size_t max_entries) {
+    std::lock_guard<std::mutex> lock(mutex);
+    TORCH_CHECK(!value || max_entries > 0, "trace must hold at least one entry");
+    if (value) {
+      entries.clear();
+      entries.resize(max_entries);
+      next = 0;
+      wrapped = false;
+    }
+    enabled = value;
+  }
+
+  void record(TraceEntry::Action action, int device, void* ptr, size_t size, cudaStream_t stream) {
+    TraceEntry entry;
+    entry.action = action;
+    entry.device = device;
+    entry.address = reinterpret_cast<int64_t>(ptr);
+    entry.size = size;
+    entry.stream = reinterpret_cast<int64_t>(stream);
+    entry.caller_id = trace_caller_id;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!enabled || entries.empty()) {
+      return;
+    }
+    entries[next] = entry;
+    if (++next == entries.size()) {
+      next = 0;
+      wrapped = true;
+    }
+  }
+
+  /** returns the recorded events, oldest first */
+  std::vector<TraceEntry> get() {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::vector<TraceEntry> result;
+    if (wrapped) {
+      result.insert(result.end(), entries.begin() + next, entries.end());
+    }
+    result.insert(result.end(), entries.begin(), entries.begin() + next);
+    return result;
+  }
+};
+
+TraceRecorder trace_recorder;
+
+} // namespace
+
+static void* malloc_on_stream(int device, size_t size, cudaStream_t stream) {
+  void* r = size_class_allocator.malloc(device, size, stream);
+  if (r == nullptr) {
+    caching_allocator.malloc(&r, size, stream);
+  }
+  if (trace_recorder.isEnabled()) {
+    trace_recorder.record(TraceEntry::MALLOC, device, r, size, stream);
+  }
+  if (r) {
+    reportMemoryUsage(r, size, Device(DeviceType::CUDA, device));
+  }
+  return r;
+}
+
+static void free_on_stream(void* ptr) {
+  if (trace_recorder.isEnabled() && ptr) {
+    int device;
+    C10_CUDA_CHECK(cudaGetDevice(&device));
+    trace_recorder.record(TraceEntry::FREE, device, ptr, 0, nullptr);
+  }
+  if (ptr) {
+    reportMemoryUsage(ptr, 0, Device(DeviceType::CUDA));
+  }
+  if (!size_class_allocator.free(ptr)) {
+    caching_allocator.free(ptr);
+  }
+}
+
 static void CudaCachingDeleter(void* ptr) {
-  caching_allocator.free(ptr);
+  free_on_stream(ptr);
 }
 
 // NB: I decided not to fold this into THCCachingAllocator, because the latter
@@ -832,7 +1914,7 @@ struct CudaCachingAllocator : public Allocator {
     C10_CUDA_CHECK(cudaGetDevice(&device));
     void* r = nullptr;
     if (size != 0) {
-      caching_allocator.malloc(&r, size, cuda::getCurrentCUDAStream(device));
+      r = malloc_on_stream(device, size, cuda::getCurrentCUDAStream(device));
     }
     return {r, r, &CudaCachingDeleter, Device(DeviceType::CUDA, device)};
   }
@@ -849,6 +1931,12 @@ Allocator* get(void)
 }
 
 void emptyCache(void) {
+  if (trace_recorder.isEnabled()) {
+    int device;
+    C10_CUDA_CHECK(cudaGetDevice(&device));
+    trace_recorder.record(TraceEntry::EMPTY_CACHE, device, nullptr, 0, nullptr);
+  }
+  size_class_allocator.emptyCache();
   caching_allocator.emptyCache();
 }
 
@@ -863,9 +1951,33 @@ void* getBaseAllocation(void *ptr, size_t *size)
 
 void recordStream(void *ptr, cuda::CUDAStream stream)
 {
+  if (trace_recorder.isEnabled() && ptr) {
+    trace_recorder.record(TraceEntry::RECORD_STREAM, stream.device_index(), ptr, 0, stream.stream());
+  }
+  size_class_allocator.recordStream(ptr, stream);
   caching_allocator.recordStream(ptr, stream);
 }
 
+void notifyEventRecorded(cudaEvent_t event, cuda::CUDAStream stream) {
+  caching_allocator.notifyEventRecorded(event, stream);
+}
+
+void notifyStreamWaitEvent(cudaEvent_t event, cuda::CUDAStream stream) {
+  caching_allocator.notifyStreamWaitEvent(event, stream);
+}
+
+void notifyCaptureBegin(int device, cudaStream_t stream, uint64_t pool_id) {
+  caching_allocator.notifyCaptureBegin(device, stream, pool_id);
+}
+
+void notifyCaptureEnd(int device, cudaStream_t stream) {
+  caching_allocator.notifyCaptureEnd(device, stream);
+}
+
+void releasePool(uint64_t pool_id) {
+  caching_allocator.releasePool(pool_id);
+}
+
 std::mutex* getFreeMutex()
 {
   return caching_allocator.getCudaFreeMutex();
@@ -878,7 +1990,9 @@ static inline void assertValidDevice(int device) {
 
 DeviceStats getDeviceStats(int device) {
   assertValidDevice(device);
-  return caching_allocator.getStatsForDevice(device);
+  DeviceStats stats = caching_allocator.getStatsForDevice(device);
+  size_class_allocator.adjustStats(device, stats);
+  return stats;
 }
 
 void resetAccumulatedStats(int device) {
@@ -892,7 +2006,66 @@ void resetPeakStats(int device) {
 }
 
 std::vector<SegmentInfo> snapshot() {
-  return caching_allocator.snapshot();
+  std::vector<SegmentInfo> result = caching_allocator.snapshot();
+  size_class_allocator.adjustSnapshot(result);
+  return result;
+}
+
+void recordTrace(bool enabled, size_t max_entries) {
+  trace_recorder.setEnabled(enabled, max_entries);
+}
+
+std::vector<TraceEntry> getTrace() {
+  return trace_recorder.get();
+}
+
+void setTraceCallerId(uint64_t caller_id) {
+  trace_caller_id = caller_id;
+}
+
+uint64_t getTraceCallerId() {
+  return trace_caller_id;
+}
+
+void writeTrace(std::ostream& out, const std::vector<TraceEntry>& trace) {
+  static const char* const action_names = "mfre";
+  for (const TraceEntry& entry : trace) {
+    out << action_names[entry.action] << ' ' << entry.device << ' '
+        << entry.address << ' ' << entry.size << ' ' << entry.stream << ' '
+        << entry.caller_id << '\n';
+  }
+}
+
+std::vector<TraceEntry> readTrace(std::istream& in) {
+  static const std::string action_names = "mfre";
+  std::vector<TraceEntry> trace;
+  char action;
+  TraceEntry entry;
+  while (in >> action >> entry.device >> entry.address >> entry.size >>
+         entry.stream >> entry.caller_id) {
+    const size_t index = action_names.find(action);
+    TORCH_CHECK(index != std::string::npos, "invalid action '", action, "' in allocator trace");
+    entry.action = static_cast<TraceEntry::Action>(index);
+    trace.push_back(entry);
+  }
+  TORCH_CHECK(in.eof(), "malformed allocator trace after ", trace.size(), " entries");
+  return trace;
+}
+
+void setExpandableSegments(bool enabled) {
+  caching_allocator.setExpandableSegments(enabled);
+}
+
+bool expandableSegmentsEnabled() {
+  return caching_allocator.expandableSegmentsEnabled();
+}
+
+void setSizeClassMode(bool enabled) {
+  size_class_allocator.setEnabled(enabled);
+}
+
+bool isSizeClassModeEnabled() {
+  return size_class_allocator.isEnabled();
 }
 
 //
@@ -955,13 +2128,11 @@ void* raw_alloc(size_t nbytes) {
   }
   int device;
   C10_CUDA_CHECK(cudaGetDevice(&device));
-  void* r = nullptr;
-  caching_allocator.malloc(&r, nbytes, cuda::getCurrentCUDAStream(device));
-  return r;
+  return malloc_on_stream(device, nbytes, cuda::getCurrentCUDAStream(device));
 }
 
 void raw_delete(void* ptr) {
-  caching_allocator.free(ptr);
+  free_on_stream(ptr);
 }
 
 } // namespace CUDACachingAllocator
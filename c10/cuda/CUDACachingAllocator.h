@@ -7,6 +7,7 @@
 #include <c10/util/Registry.h>
 
 #include <array>
+#include <iosfwd>
 #include <mutex>
 
 namespace c10 {
@@ -76,11 +77,28 @@ struct DeviceStats {
   // SUM: bytes within inactive, split memory blocks
   StatArray inactive_split_bytes;
 
+  // COUNT: number of freed blocks waiting for work on other streams (recordStream)
+  StatArray deferred_free;
+  // SUM: bytes within freed blocks waiting for work on other streams
+  StatArray deferred_free_bytes;
+
   // COUNT: total number of failed calls to CUDA malloc necessitating cache flushes.
   int64_t num_alloc_retries = 0;
 
   // COUNT: total number of OOMs (i.e. failed calls to CUDA after cache flush)
   int64_t num_ooms = 0;
+
+  // COUNT: total number of waits for other streams that ended the deferral
+  // of a freed block early (see notifyStreamWaitEvent).
+  int64_t num_deferred_frees_released_by_wait = 0;
+
+  // COUNT: number of blocks parked in size-class free lists. These blocks are
+  // excluded from the current allocation and active counts above.
+  int64_t size_class_cached_blocks = 0;
+
+  // SUM: bytes parked in size-class free lists. Excluded from the current
+  // allocated and active bytes above.
+  int64_t size_class_cached_bytes = 0;
 };
 
 // Struct containing info of an allocation block (i.e. a fractional part of a cudaMalloc)..
@@ -88,6 +106,7 @@ struct BlockInfo {
   int64_t size = 0;
   bool allocated = false;
   bool active = false;
+  bool size_class_cached = false;
 };
 
 // Struct containing info of a memory segment (i.e. one contiguous cudaMalloc).
@@ -97,10 +116,34 @@ struct SegmentInfo {
   int64_t total_size = 0;
   int64_t allocated_size = 0;
   int64_t active_size = 0;
+  // bytes of address space held by the segment; larger than total_size only
+  // for expandable segments, whose total_size counts mapped bytes.
+  int64_t reserved_size = 0;
   bool is_large = false;
+  bool is_expandable = false;
   std::vector<BlockInfo> blocks;
 };
 
+// Struct containing one allocator event recorded by the trace ring buffer.
+struct TraceEntry {
+  enum Action : uint8_t {
+    MALLOC = 0,
+    FREE = 1,
+    RECORD_STREAM = 2,
+    EMPTY_CACHE = 3
+  };
+  Action action = MALLOC;
+  int64_t device = 0;
+  // device pointer; 0 for EMPTY_CACHE
+  int64_t address = 0;
+  // bytes requested by client code; MALLOC only
+  int64_t size = 0;
+  // allocation stream, or the stream passed to recordStream()
+  int64_t stream = 0;
+  // value of setTraceCallerId() on the calling thread
+  uint64_t caller_id = 0;
+};
+
 C10_CUDA_API void* raw_alloc(size_t nbytes);
 C10_CUDA_API void raw_delete(void* ptr);
 
@@ -114,6 +157,56 @@ C10_CUDA_API void resetAccumulatedStats(int device);
 C10_CUDA_API void resetPeakStats(int device);
 C10_CUDA_API std::vector<SegmentInfo> snapshot();
 
+// Expandable-segment mode reserves a virtual address range per stream for
+// large allocations and maps physical memory into it on demand, so that a
+// segment grows in place instead of needing a new cudaMalloc. It needs the
+// CUDA virtual memory management API (CUDA 10.2+). Off by default; can also
+// be enabled by setting PYTORCH_CUDA_ALLOCATOR_EXPANDABLE_SEGMENTS=1.
+C10_CUDA_API void setExpandableSegments(bool enabled);
+C10_CUDA_API bool expandableSegmentsEnabled();
+
+// Size-class mode serves requests of up to a few MiB from power-of-two free
+// lists kept per stream and per thread. It is off by default and can also be
+// enabled by setting PYTORCH_CUDA_ALLOCATOR_SIZE_CLASSES=1.
+C10_CUDA_API void setSizeClassMode(bool enabled);
+C10_CUDA_API bool isSizeClassModeEnabled();
+
+// Opt-in recording of malloc/free/recordStream/emptyCache events into a ring
+// buffer holding the last `max_entries` events. Recording is off by default.
+// Traces can be replayed offline with binaries/replay_cuda_allocator_trace,
+// or benchmarked with binaries/cuda_allocator_benchmark.
+C10_CUDA_API void recordTrace(bool enabled, size_t max_entries = 1 << 20);
+C10_CUDA_API std::vector<TraceEntry> getTrace();
+// Tags events recorded on the calling thread, e.g. with an operator or layer id.
+C10_CUDA_API void setTraceCallerId(uint64_t caller_id);
+C10_CUDA_API uint64_t getTraceCallerId();
+// Text format: one event per line, "<action> <device> <address> <size> <stream> <caller_id>".
+C10_CUDA_API void writeTrace(std::ostream& out, const std::vector<TraceEntry>& trace);
+C10_CUDA_API std::vector<TraceEntry> readTrace(std::istream& in);
+
+// A block freed after being used on other streams (recordStream) is only
+// reused once events recorded on those streams at the time of the free have
+// completed. A stream that waits on one of those streams has an explicit
+// dependency on it, though: if the allocation stream of the block waits on an
+// event recorded on the other stream after the free, later work on the
+// allocation stream is ordered after the uses, and the block goes back to the
+// pool right away. at::cuda::CUDAEvent and c10::Event report their record()
+// and block() calls through these functions.
+C10_CUDA_API void notifyEventRecorded(cudaEvent_t event, CUDAStream stream);
+C10_CUDA_API void notifyStreamWaitEvent(cudaEvent_t event, CUDAStream stream);
+
+// Private memory pools for CUDA graph capture (see ATen/cuda/CUDAGraph.h).
+// Between notifyCaptureBegin and notifyCaptureEnd, allocations on `stream`
+// come from the pool `pool_id` (any nonzero id), whose blocks are never
+// handed to other allocations or returned to the driver, because replaying
+// the graph reuses the addresses recorded during capture. Blocks freed after
+// the capture go back to the pool and can be reused by a later capture into
+// the same pool. releasePool returns all blocks of the pool to the regular
+// pools; it must only be called once no graph uses the pool anymore.
+C10_CUDA_API void notifyCaptureBegin(int device, cudaStream_t stream, uint64_t pool_id);
+C10_CUDA_API void notifyCaptureEnd(int device, cudaStream_t stream);
+C10_CUDA_API void releasePool(uint64_t pool_id);
+
 C10_CUDA_API std::mutex* getFreeMutex();
 
 C10_CUDA_API std::shared_ptr<void> getIpcDevPtr(std::string handle);
@@ -4,6 +4,7 @@
 #include <c10/macros/Macros.h>
 #include <c10/util/Exception.h>
 
+#include <c10/cuda/CUDACachingAllocator.h>
 #include <c10/cuda/CUDAException.h>
 #include <c10/cuda/CUDAStream.h>
 #include <c10/cuda/CUDAFunctions.h>
@@ -50,6 +51,9 @@ struct CUDAGuardImpl final : public c10::impl::DeviceGuardImplInterface {
   Stream getDefaultStream(Device d) const override {
     return getDefaultCUDAStream(d.index());
   }
+  Stream getStreamFromPool(Device d, bool isHighPriority = false) const override {
+    return c10::cuda::getStreamFromPool(isHighPriority, d.index());
+  }
   // NB: These do NOT set the current device
   Stream exchangeStream(Stream s) const noexcept override {
     CUDAStream cs(s);
@@ -116,6 +120,7 @@ struct CUDAGuardImpl final : public c10::impl::DeviceGuardImplInterface {
 
     // Creates the event (lazily)
     if (!cuda_event) createEvent(&cuda_event, flag);
+    CUDACachingAllocator::notifyEventRecorded(cuda_event, cuda_stream);
     C10_CUDA_CHECK(cudaEventRecord(cuda_event, cuda_stream));
     // Makes the void* point to the (possibly just allocated) CUDA event
     *event = cuda_event;
@@ -136,6 +141,7 @@ struct CUDAGuardImpl final : public c10::impl::DeviceGuardImplInterface {
       cuda_stream,
       cuda_event,
       /*flags (must be zero)=*/ 0));
+    CUDACachingAllocator::notifyStreamWaitEvent(cuda_event, cuda_stream);
     setDevice(orig_device);
   }
 
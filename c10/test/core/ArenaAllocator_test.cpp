@@ -0,0 +1,87 @@
+#include <gtest/gtest.h>
+
+#include <c10/core/ArenaAllocator.h>
+#include <c10/core/CPUAllocator.h>
+
+#include <cstdint>
+#include <cstring>
+
+using namespace c10;
+
+TEST(ArenaAllocatorTest, GuardRedirectsCPUAllocator) {
+  at::Allocator* global = GetCPUAllocator();
+  {
+    ArenaAllocatorGuard guard;
+    ASSERT_EQ(GetCPUAllocator(), &guard.arena());
+    {
+      ArenaAllocatorGuard inner;
+      ASSERT_EQ(GetCPUAllocator(), &inner.arena());
+    }
+    ASSERT_EQ(GetCPUAllocator(), &guard.arena());
+  }
+  ASSERT_EQ(GetCPUAllocator(), global);
+}
+
+TEST(ArenaAllocatorTest, BumpAllocatesAlignedBlocks) {
+  ArenaAllocator arena(1 << 16);
+  at::DataPtr a = arena.allocate(100);
+  at::DataPtr b = arena.allocate(1);
+  ASSERT_EQ(reinterpret_cast<uintptr_t>(a.get()) % gAlignment, 0);
+  ASSERT_EQ(reinterpret_cast<uintptr_t>(b.get()) % gAlignment, 0);
+  // 100 bytes round up to 128, plus the header of the next allocation
+  ASSERT_EQ(static_cast<char*>(b.get()) - static_cast<char*>(a.get()), 192);
+  ASSERT_EQ(arena.used_bytes(), 192 + 128);
+  ASSERT_EQ(arena.reserved_bytes(), 1 << 16);
+  memset(a.get(), 0x5a, 100);
+  a.clear();
+  b.clear();
+  arena.reset();
+  ASSERT_EQ(arena.used_bytes(), 0);
+}
+
+TEST(ArenaAllocatorTest, ResetReusesChunks) {
+  ArenaAllocator arena(1 << 16);
+  void* first;
+  {
+    ArenaAllocatorGuard guard(arena);
+    at::DataPtr ptr = GetCPUAllocator()->allocate(1000);
+    first = ptr.get();
+  }
+  ArenaAllocatorGuard guard(arena);
+  at::DataPtr ptr = GetCPUAllocator()->allocate(1000);
+  ASSERT_EQ(ptr.get(), first);
+  ASSERT_EQ(arena.reserved_bytes(), 1 << 16);
+}
+
+TEST(ArenaAllocatorTest, EscapingAllocationsPinTheirChunk) {
+  ArenaAllocator arena(1 << 16);
+  at::DataPtr escaped;
+  {
+    ArenaAllocatorGuard guard(arena);
+    escaped = GetCPUAllocator()->allocate(1 << 10);
+    memset(escaped.get(), 0x5a, 1 << 10);
+  }
+  // the chunk is retired rather than handed out again
+  ASSERT_EQ(arena.reserved_bytes(), 0);
+  at::DataPtr other = arena.allocate(1 << 10);
+  ASSERT_NE(other.get(), escaped.get());
+  memset(other.get(), 0, 1 << 10);
+  ASSERT_EQ(static_cast<unsigned char*>(escaped.get())[0], 0x5a);
+
+  // outliving the arena itself is fine too
+  {
+    ArenaAllocatorGuard guard;
+    escaped = GetCPUAllocator()->allocate(1 << 10);
+  }
+  memset(escaped.get(), 0x5a, 1 << 10);
+}
+
+TEST(ArenaAllocatorTest, OversizedAllocationsGetTheirOwnChunk) {
+  ArenaAllocator arena(1 << 12);
+  at::DataPtr small = arena.allocate(64);
+  at::DataPtr large = arena.allocate(1 << 16);
+  memset(large.get(), 0x5a, 1 << 16);
+  ASSERT_EQ(arena.reserved_bytes(), 1 << 12);
+  void* raw = arena.raw_allocate(1 << 16);
+  arena.raw_deallocate(raw);
+}
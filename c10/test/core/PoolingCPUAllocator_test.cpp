@@ -0,0 +1,52 @@
+#include <gtest/gtest.h>
+
+#include <c10/core/CPUAllocator.h>
+
+#include <cstdint>
+#include <cstring>
+
+using namespace c10;
+
+TEST(PoolingCPUAllocatorTest, ReusesFreedBlocksOfSameSizeClass) {
+  at::Allocator* allocator = GetPoolingCPUAllocator();
+  EmptyPoolingCPUAllocatorCache();
+
+  void* first;
+  {
+    at::DataPtr ptr = allocator->allocate(1000);
+    first = ptr.get();
+  }
+  at::DataPtr ptr = allocator->allocate(1500);
+  ASSERT_EQ(ptr.get(), first);
+  at::DataPtr other = allocator->allocate(1500);
+  ASSERT_NE(other.get(), first);
+}
+
+TEST(PoolingCPUAllocatorTest, BlocksAreAlignedAndUsable) {
+  at::Allocator* allocator = GetPoolingCPUAllocator();
+  for (size_t nbytes : {1, 63, 64, 4096, 1 << 20, 5 << 20}) {
+    at::DataPtr ptr = allocator->allocate(nbytes);
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(ptr.get()) % gAlignment, 0);
+    memset(ptr.get(), 0x5a, nbytes);
+    ASSERT_EQ(static_cast<unsigned char*>(ptr.get())[nbytes - 1], 0x5a);
+  }
+}
+
+TEST(PoolingCPUAllocatorTest, RawInterface) {
+  at::Allocator* allocator = GetPoolingCPUAllocator();
+  ASSERT_NE(allocator->raw_deleter(), nullptr);
+  void* ptr = allocator->raw_allocate(3 << 20);
+  ASSERT_NE(ptr, nullptr);
+  allocator->raw_deallocate(ptr);
+  ASSERT_EQ(allocator->allocate(0).get(), nullptr);
+}
+
+TEST(PoolingCPUAllocatorTest, SelectableAsCPUAllocator) {
+  at::Allocator* previous = GetCPUAllocator();
+  SetCPUAllocator(GetPoolingCPUAllocator());
+  ASSERT_EQ(GetCPUAllocator(), GetPoolingCPUAllocator());
+  at::DataPtr ptr = GetCPUAllocator()->allocate(128);
+  ASSERT_NE(ptr.get(), nullptr);
+  SetCPUAllocator(previous);
+  EmptyPoolingCPUAllocatorCache();
+}
@@ -263,5 +263,22 @@ public:
 /// Used by vec256<c10::BFloat16>::map
 inline c10::BFloat16 exp(c10::BFloat16 a) { return std::exp(float(a)); }
 inline c10::BFloat16 log(c10::BFloat16 a) { return std::log(float(a)); }
+inline c10::BFloat16 acos(c10::BFloat16 a) { return std::acos(float(a)); }
+inline c10::BFloat16 asin(c10::BFloat16 a) { return std::asin(float(a)); }
+inline c10::BFloat16 atan(c10::BFloat16 a) { return std::atan(float(a)); }
+inline c10::BFloat16 erf(c10::BFloat16 a) { return std::erf(float(a)); }
+inline c10::BFloat16 erfc(c10::BFloat16 a) { return std::erfc(float(a)); }
+inline c10::BFloat16 expm1(c10::BFloat16 a) { return std::expm1(float(a)); }
+inline c10::BFloat16 log10(c10::BFloat16 a) { return std::log10(float(a)); }
+inline c10::BFloat16 log1p(c10::BFloat16 a) { return std::log1p(float(a)); }
+inline c10::BFloat16 log2(c10::BFloat16 a) { return std::log2(float(a)); }
+inline c10::BFloat16 cos(c10::BFloat16 a) { return std::cos(float(a)); }
+inline c10::BFloat16 sin(c10::BFloat16 a) { return std::sin(float(a)); }
+inline c10::BFloat16 tan(c10::BFloat16 a) { return std::tan(float(a)); }
+inline c10::BFloat16 sinh(c10::BFloat16 a) { return std::sinh(float(a)); }
+inline c10::BFloat16 cosh(c10::BFloat16 a) { return std::cosh(float(a)); }
+inline c10::BFloat16 tanh(c10::BFloat16 a) { return std::tanh(float(a)); }
+inline c10::BFloat16 lgamma(c10::BFloat16 a) { return std::lgamma(float(a)); }
+inline c10::BFloat16 sqrt(c10::BFloat16 a) { return std::sqrt(float(a)); }
 
 } // namespace std
@@ -10,8 +10,8 @@
  //
  //===----------------------------------------------------------------------===//
 
- #ifndef LLVM_SUPPORT_MATHEXTRAS_H
- #define LLVM_SUPPORT_MATHEXTRAS_H
+ #ifndef C10_UTIL_LLVMMATHEXTRAS_H
+ #define C10_UTIL_LLVMMATHEXTRAS_H
 
  #include <algorithm>
  #include <cmath>
@@ -54,6 +54,7 @@
  }
  #endif
 
+ namespace c10 {
  namespace llvm {
  /// The behavior an operation has on an input of 0.
  enum ZeroBehavior {
@@ -860,5 +861,6 @@
  /// Use this rather than HUGE_VALF; the latter causes warnings on MSVC.
  extern const float huge_valf;
  } // End llvm namespace
+ } // End c10 namespace
 
  #endif
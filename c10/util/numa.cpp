@@ -9,6 +9,13 @@ C10_DEFINE_bool(caffe2_cpu_numa_enabled, false, "Use NUMA whenever possible.");
 #define C10_ENABLE_NUMA
 #endif
 
+#if defined(__linux__) && !defined(C10_MOBILE)
+#include <sched.h>
+#define C10_ENABLE_AFFINITY
+#endif
+
+#include <thread>
+
 // This code used to have a lot of VLOGs. However, because allocation might be
 // triggered during static initialization, it's unsafe to invoke VLOG here
 
@@ -103,6 +110,13 @@ int GetCurrentNUMANode() {
   return n;
 }
 
+int GetNUMANodeOfCPU(int cpu) {
+  if (numa_available() < 0) {
+    return -1;
+  }
+  return numa_node_of_cpu(cpu);
+}
+
 #else // C10_ENABLE_NUMA
 
 bool IsNUMAEnabled() {
@@ -127,6 +141,59 @@ int GetCurrentNUMANode() {
   return -1;
 }
 
+int GetNUMANodeOfCPU(int cpu) {
+  return -1;
+}
+
 #endif // C10_NUMA_ENABLED
 
+#ifdef C10_ENABLE_AFFINITY
+std::vector<int> GetAvailableCPUs() {
+  std::vector<int> cpus;
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  if (sched_getaffinity(0, sizeof(set), &set) != 0) {
+    return cpus;
+  }
+  for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+    if (CPU_ISSET(cpu, &set)) {
+      cpus.push_back(cpu);
+    }
+  }
+  return cpus;
+}
+
+bool PinCurrentThreadToCPU(int cpu) {
+  if (cpu < 0 || cpu >= CPU_SETSIZE) {
+    return false;
+  }
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(cpu, &set);
+  if (sched_setaffinity(0, sizeof(set), &set) != 0) {
+    return false;
+  }
+#ifdef C10_ENABLE_NUMA
+  if (IsNUMAEnabled()) {
+    // first-touch allocation on the node the thread now runs on, instead of
+    // a policy inherited from the creating thread
+    numa_set_localalloc();
+  }
+#endif
+  return true;
+}
+#else // C10_ENABLE_AFFINITY
+std::vector<int> GetAvailableCPUs() {
+  std::vector<int> cpus(std::thread::hardware_concurrency());
+  for (size_t cpu = 0; cpu < cpus.size(); cpu++) {
+    cpus[cpu] = cpu;
+  }
+  return cpus;
+}
+
+bool PinCurrentThreadToCPU(int cpu) {
+  return false;
+}
+#endif // C10_ENABLE_AFFINITY
+
 } // namespace c10
@@ -3,6 +3,8 @@
 #include <c10/util/Logging.h>
 #include <c10/util/Optional.h>
 
+#include <vector>
+
 C10_DECLARE_bool(caffe2_cpu_numa_enabled);
 
 namespace c10 {
@@ -37,4 +39,22 @@ C10_API void NUMAMove(void* ptr, size_t size, int numa_node_id);
  */
 C10_API int GetCurrentNUMANode();
 
+/**
+ * Get the NUMA node of a CPU, or -1 if the topology is unknown. Unlike the
+ * functions above, this does not need caffe2_cpu_numa_enabled, only libnuma.
+ */
+C10_API int GetNUMANodeOfCPU(int cpu);
+
+/**
+ * Get the CPUs the calling thread is allowed to run on, in increasing order
+ */
+C10_API std::vector<int> GetAvailableCPUs();
+
+/**
+ * Pin the calling thread to a CPU. If NUMA is enabled, memory the thread
+ * allocates afterwards comes from the node of that CPU. Returns false if
+ * pinning is unsupported or failed.
+ */
+C10_API bool PinCurrentThreadToCPU(int cpu);
+
 } // namespace c10
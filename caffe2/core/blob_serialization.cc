@@ -6,6 +6,10 @@
 #include "caffe2/core/blob.h"
 #include "caffe2/utils/proto_utils.h"
 
+#ifdef CAFFE2_USE_ZSTD
+#include <zstd.h>
+#endif
+
 C10_DEFINE_int(
     caffe2_tensor_chunk_size,
     1000000,
@@ -21,6 +25,25 @@ C10_DEFINE_bool(
     false,
     "Serialize FLOAT16 tensors using byte_data field");
 
+C10_DEFINE_bool(
+    caffe2_serialize_using_raw_data,
+    false,
+    "Serialize tensors of fixed size data types as their little-endian bytes "
+    "in the raw_data field, instead of the typed fields");
+
+C10_DEFINE_int(
+    caffe2_serialize_zstd_level,
+    0,
+    "If positive, compress the raw_data of the serialized tensors with zstd "
+    "at this level. Requires caffe2_serialize_using_raw_data and a build with "
+    "USE_ZSTD");
+
+C10_DEFINE_int(
+    caffe2_max_tensor_deserializer_threads,
+    16,
+    "Maximal number of threads that can be used for tensor deserialization "
+    "when loading blobs from a DB");
+
 namespace caffe2 {
 /**
  * @brief StringSerializer is the serializer for String.
@@ -183,6 +206,132 @@ void TensorSerializer::SerializeWithChunkSize(
 #endif
 }
 
+// Whether the tensors of a data type can be stored in raw_data
+static bool IsFixedSizeDataType(TensorProto::DataType data_type) {
+  switch (data_type) {
+    case TensorProto_DataType_FLOAT:
+    case TensorProto_DataType_INT32:
+    case TensorProto_DataType_BOOL:
+    case TensorProto_DataType_UINT8:
+    case TensorProto_DataType_INT8:
+    case TensorProto_DataType_UINT16:
+    case TensorProto_DataType_INT16:
+    case TensorProto_DataType_INT64:
+    case TensorProto_DataType_FLOAT16:
+    case TensorProto_DataType_DOUBLE:
+      return true;
+    default:
+      return false;
+  }
+}
+
+static void EnforceLittleEndian() {
+  const int kValue = 1;
+  CAFFE_ENFORCE_EQ(
+      reinterpret_cast<const char*>(&kValue)[0],
+      1,
+      "Serialization of raw data on big endian platform is not written yet.");
+}
+
+// Stores the chunk of input as raw bytes, compressed with zstd if
+// caffe2_serialize_zstd_level is set
+static void SerializeRawData(
+    const Tensor& input,
+    size_t chunkBegin,
+    int32_t chunkSize,
+    TensorProto* proto,
+    BaseContext* context) {
+  EnforceLittleEndian();
+  const size_t nbytes = chunkSize * input.itemsize();
+  const char* src = static_cast<const char*>(input.raw_data()) +
+      chunkBegin * input.itemsize();
+  proto->set_storage_type(TensorProto_StorageType_RAW);
+  std::string* raw_data = proto->mutable_raw_data();
+  if (FLAGS_caffe2_serialize_zstd_level <= 0) {
+    raw_data->resize(nbytes);
+    if (nbytes > 0) {
+      context->CopyBytesToCPU(nbytes, src, &(*raw_data)[0]);
+      context->FinishDeviceComputation();
+    }
+    return;
+  }
+#ifdef CAFFE2_USE_ZSTD
+  // zstd needs the data in CPU memory
+  std::unique_ptr<char[]> buffer;
+  if (input.GetDeviceType() != CPU) {
+    buffer.reset(new char[nbytes]);
+    context->CopyBytesToCPU(nbytes, src, buffer.get());
+    context->FinishDeviceComputation();
+    src = buffer.get();
+  }
+  raw_data->resize(ZSTD_compressBound(nbytes));
+  const size_t size = ZSTD_compress(
+      &(*raw_data)[0],
+      raw_data->size(),
+      src,
+      nbytes,
+      FLAGS_caffe2_serialize_zstd_level);
+  CAFFE_ENFORCE(
+      !ZSTD_isError(size), "zstd compression failed: ", ZSTD_getErrorName(size));
+  raw_data->resize(size);
+  proto->set_raw_data_compression(TensorProto_RawDataCompression_ZSTD);
+#else
+  CAFFE_THROW("caffe2_serialize_zstd_level requires a build with USE_ZSTD");
+#endif
+}
+
+// Fills in the chunk [chunkBegin, chunkBegin + chunkSize) of tensor from the
+// raw_data of proto
+static void DeserializeRawData(
+    const TensorProto& proto,
+    int64_t chunkBegin,
+    int64_t chunkSize,
+    Tensor* tensor,
+    BaseContext* context) {
+  CAFFE_ENFORCE(
+      IsFixedSizeDataType(proto.data_type()),
+      "Raw data is not supported for data type ",
+      proto.data_type());
+  EnforceLittleEndian();
+  const size_t nbytes = chunkSize * tensor->itemsize();
+  char* dst = static_cast<char*>(tensor->raw_mutable_data(tensor->dtype())) +
+      chunkBegin * tensor->itemsize();
+  const std::string& raw_data = proto.raw_data();
+  switch (proto.raw_data_compression()) {
+    case TensorProto_RawDataCompression_UNCOMPRESSED:
+      CAFFE_ENFORCE_EQ(nbytes, raw_data.size(), "Incorrect proto field size.");
+      if (nbytes > 0) {
+        context->CopyBytesFromCPU(nbytes, raw_data.data(), dst);
+      }
+      break;
+    case TensorProto_RawDataCompression_ZSTD: {
+#ifdef CAFFE2_USE_ZSTD
+      // CPU tensors are decompressed in place
+      std::unique_ptr<char[]> buffer;
+      char* out = dst;
+      if (tensor->GetDeviceType() != CPU) {
+        buffer.reset(new char[nbytes]);
+        out = buffer.get();
+      }
+      const size_t size =
+          ZSTD_decompress(out, nbytes, raw_data.data(), raw_data.size());
+      CAFFE_ENFORCE(
+          !ZSTD_isError(size),
+          "zstd decompression failed: ",
+          ZSTD_getErrorName(size));
+      CAFFE_ENFORCE_EQ(nbytes, size, "Incorrect size of decompressed data.");
+      if (buffer) {
+        context->CopyBytesFromCPU(nbytes, buffer.get(), dst);
+      }
+#else
+      CAFFE_THROW(
+          "Deserializing zstd compressed tensors requires a build with "
+          "USE_ZSTD");
+#endif
+    } break;
+  }
+}
+
 void TensorSerializer::Serialize(
     const Tensor& input,
     const string& name,
@@ -226,6 +375,11 @@ void TensorSerializer::Serialize(
   // TODO: use CUDAGuard here instead of context and employ explicit sync
   // copy
   auto uniq_ptr = CreateContext(input.GetDevice());
+  if (FLAGS_caffe2_serialize_using_raw_data &&
+      IsFixedSizeDataType(data_type)) {
+    SerializeRawData(input, chunkBegin, chunkSize, &proto, uniq_ptr.get());
+    return;
+  }
   // A lot of copypaste is error prone. Should we create a macro for this?
   switch (data_type) {
     case TensorProto_DataType_FLOAT:
@@ -455,7 +609,16 @@ Tensor EmptyTensorFromProto(const TensorProto& tensor_proto) {
 }
 
 void TensorDeserializer::Deserialize(const BlobProto& blob_proto, Blob* blob) {
-  auto tensor_proto = blob_proto.tensor();
+  const auto& tensor_proto = blob_proto.tensor();
+  Tensor* tensor = AllocateTensor(tensor_proto, blob);
+  if (tensor) {
+    DeserializeToTensor(tensor_proto, tensor);
+  }
+}
+
+Tensor* TensorDeserializer::AllocateTensor(
+    const TensorProto& tensor_proto,
+    Blob* blob) {
   auto context = ContextFromProto(tensor_proto);
   context->SwitchToDevice();
   if (NumelFromTensorProto(tensor_proto) == 0 &&
@@ -467,14 +630,12 @@ void TensorDeserializer::Deserialize(const BlobProto& blob_proto, Blob* blob) {
         {0},
         at::dtype<float>().device(
             OptionToDevice(tensor_proto.device_detail())));
-  } else {
-    DeserializeToTensor(
-        tensor_proto,
-        BlobGetMutableTensor(
-            blob,
-            DimsFromTensorProto(tensor_proto),
-            TensorOptionsFromProto(tensor_proto)));
+    return nullptr;
   }
+  return BlobGetMutableTensor(
+      blob,
+      DimsFromTensorProto(tensor_proto),
+      TensorOptionsFromProto(tensor_proto));
 }
 
 void TensorDeserializer::DeserializeToTensor(
@@ -506,6 +667,12 @@ void TensorDeserializer::DeserializeToTensor(
       tensor->numel());
   auto chunkSize = chunkEnd - chunkBegin;
 
+  if (tensor_proto.storage_type() == TensorProto_StorageType_RAW) {
+    DeserializeRawData(tensor_proto, chunkBegin, chunkSize, tensor, context);
+    context->FinishDeviceComputation();
+    return;
+  }
+
   switch (tensor_proto.data_type()) {
     case TensorProto_DataType_FLOAT:
       detail::CopyFromProtoAsIs(
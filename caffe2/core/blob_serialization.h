@@ -16,6 +16,9 @@
 C10_DECLARE_int(caffe2_tensor_chunk_size);
 C10_DECLARE_int(caffe2_max_tensor_serializer_threads);
 C10_DECLARE_bool(caffe2_serialize_fp16_as_bytes);
+C10_DECLARE_bool(caffe2_serialize_using_raw_data);
+C10_DECLARE_int(caffe2_serialize_zstd_level);
+C10_DECLARE_int(caffe2_max_tensor_deserializer_threads);
 
 namespace caffe2 {
 
@@ -129,6 +132,14 @@ class CAFFE2_API TensorDeserializer : public BlobDeserializerBase {
  public:
   void Deserialize(const BlobProto& proto, Blob* blob) override;
 
+  /* Allocates the Tensor of blob given the meta data in proto, which is what
+   * Deserialize does before filling in the data, and returns it. The chunks of
+   * a Tensor can then be filled in with DeserializeToTensor, in parallel since
+   * they are disjoint. Returns nullptr for the legacy empty Tensors without
+   * data type, which have no data to fill in.
+   */
+  Tensor* AllocateTensor(const TensorProto& proto, Blob* blob);
+
   /* There are cases when a Tensor is split into multiple protos and
    * we have to call Deserialize multiple times to get the complete deserialized
    * Tensor, each call will fill part of the Tensor given the segment begin and
@@ -733,6 +733,75 @@ TEST(TensorTest, Half) {
   }
 }
 
+TEST(TensorTest, RawDataSerialization) {
+  const int64_t kSize = 1000;
+  Blob blob;
+  TensorCPU* tensor = BlobGetMutableTensor(&blob, CPU);
+  tensor->Resize(10, kSize / 10);
+  for (int i = 0; i < kSize; ++i) {
+    tensor->mutable_data<float>()[i] = i * 0.5f;
+  }
+  FLAGS_caffe2_serialize_using_raw_data = true;
+  std::vector<std::string> chunks;
+  std::mutex mutex;
+  SerializeBlob(
+      blob,
+      "test",
+      [&](const std::string& /*key*/, const std::string& value) {
+        std::lock_guard<std::mutex> guard(mutex);
+        chunks.push_back(value);
+      },
+      kSize / 4);
+  FLAGS_caffe2_serialize_using_raw_data = false;
+  EXPECT_EQ(chunks.size(), 4);
+
+  Blob new_blob;
+  for (const auto& chunk : chunks) {
+    BlobProto proto;
+    CHECK(proto.ParseFromString(chunk));
+    const TensorProto& tensor_proto = proto.tensor();
+    EXPECT_EQ(tensor_proto.storage_type(), TensorProto_StorageType_RAW);
+    EXPECT_EQ(tensor_proto.float_data_size(), 0);
+    EXPECT_EQ(tensor_proto.raw_data().size(), kSize / 4 * sizeof(float));
+    EXPECT_NO_THROW(DeserializeBlob(proto, &new_blob));
+  }
+  const TensorCPU& new_tensor = new_blob.Get<TensorCPU>();
+  EXPECT_EQ(new_tensor.sizes(), tensor->sizes());
+  for (int i = 0; i < kSize; ++i) {
+    EXPECT_EQ(new_tensor.data<float>()[i], i * 0.5f);
+  }
+}
+
+#ifdef CAFFE2_USE_ZSTD
+TEST(TensorTest, ZstdRawDataSerialization) {
+  const int64_t kSize = 100000;
+  Blob blob;
+  TensorCPU* tensor = BlobGetMutableTensor(&blob, CPU);
+  tensor->Resize(kSize);
+  for (int i = 0; i < kSize; ++i) {
+    tensor->mutable_data<int64_t>()[i] = i % 7;
+  }
+  FLAGS_caffe2_serialize_using_raw_data = true;
+  FLAGS_caffe2_serialize_zstd_level = 3;
+  string serialized = SerializeBlob(blob, "test");
+  FLAGS_caffe2_serialize_using_raw_data = false;
+  FLAGS_caffe2_serialize_zstd_level = 0;
+  BlobProto proto;
+  CHECK(proto.ParseFromString(serialized));
+  EXPECT_EQ(
+      proto.tensor().raw_data_compression(),
+      TensorProto_RawDataCompression_ZSTD);
+  EXPECT_LT(proto.tensor().raw_data().size(), kSize * sizeof(int64_t));
+  Blob new_blob;
+  EXPECT_NO_THROW(DeserializeBlob(serialized, &new_blob));
+  const TensorCPU& new_tensor = new_blob.Get<TensorCPU>();
+  EXPECT_EQ(new_tensor.numel(), kSize);
+  for (int i = 0; i < kSize; ++i) {
+    EXPECT_EQ(new_tensor.data<int64_t>()[i], i % 7);
+  }
+}
+#endif // CAFFE2_USE_ZSTD
+
 TEST(TensorTest, TensorFactory) {
   Tensor a = empty({1, 2, 3}, at::device(CPU).dtype<float>());
   EXPECT_NE(a.data<float>(), nullptr);
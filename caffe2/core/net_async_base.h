@@ -24,6 +24,7 @@ C10_DECLARE_bool(caffe2_net_async_use_single_pool);
 C10_DECLARE_bool(caffe2_net_async_use_per_net_pools);
 C10_DECLARE_bool(caffe2_net_async_run_root_tasks_inline);
 C10_DECLARE_bool(caffe2_net_async_profile_operators);
+C10_DECLARE_bool(caffe2_net_async_critical_path_scheduling);
 
 namespace caffe2 {
 
@@ -55,6 +56,8 @@ struct ExecutionOptions {
   bool use_dfs_scheduling_ = false;
   // run net's root tasks in RunAsync thread instead of in thread pool
   bool run_root_tasks_inline_ = false;
+  // run ready tasks in order of their remaining critical path
+  bool use_critical_path_scheduling_ = false;
 };
 
 class CAFFE2_API AsyncNetBase : public NetBase {
@@ -1,13 +1,153 @@
 #include "caffe2/core/net_async_scheduling.h"
 
 #include "caffe2/core/net_async_tracing.h"
+#include "caffe2/core/operator.h"
+#include "caffe2/core/operator_schema.h"
 
 namespace caffe2 {
 
 AsyncSchedulingNet::AsyncSchedulingNet(
     const std::shared_ptr<const NetDef>& net_def,
     Workspace* ws)
-    : AsyncNetBase(net_def, ws), running_(false) {}
+    : AsyncNetBase(net_def, ws), running_(false) {
+  if (options_.use_critical_path_scheduling_) {
+    updateTaskPriorities(estimateOpCosts(*net_def, ws));
+  }
+}
+
+// Estimates the cost of the ops from their schema cost functions, where the
+// input shapes are already known (e.g. parameters), ops without an estimate
+// count as an average op. The estimates are replaced with the measured times
+// once the net is profiled
+std::vector<float> AsyncSchedulingNet::estimateOpCosts(
+    const NetDef& net_def,
+    const Workspace* ws) const {
+  std::vector<float> costs(net_def.op_size(), -1.0f);
+  float total_cost = 0;
+  int num_estimated = 0;
+  for (int op_id = 0; op_id < net_def.op_size(); ++op_id) {
+    const auto& op_def = net_def.op(op_id);
+    const auto* schema = OpSchemaRegistry::Schema(op_def.type());
+    if (!schema || !schema->HasCostInferenceFunction()) {
+      continue;
+    }
+    std::vector<TensorShape> shapes;
+    for (const auto& input : op_def.input()) {
+      const auto* blob = ws->GetBlob(input);
+      if (!blob) {
+        break;
+      }
+      auto shape = GetTensorShapeOfBlob(blob);
+      if (shape.unknown_shape()) {
+        break;
+      }
+      shapes.push_back(std::move(shape));
+    }
+    if (shapes.size() != static_cast<size_t>(op_def.input_size())) {
+      continue;
+    }
+    try {
+      const auto cost = schema->InferCost(op_def, shapes);
+      costs[op_id] = static_cast<float>(cost.flops) + cost.bytes_read +
+          cost.bytes_written;
+      total_cost += costs[op_id];
+      ++num_estimated;
+    } catch (const std::exception& e) {
+      VLOG(1) << "Failed to infer the cost of " << op_def.type() << ": "
+              << e.what();
+    }
+  }
+  const float default_cost =
+      num_estimated > 0 && total_cost > 0 ? total_cost / num_estimated : 1.0f;
+  for (auto& cost : costs) {
+    if (cost < 0) {
+      cost = default_cost;
+    }
+  }
+  return costs;
+}
+
+void AsyncSchedulingNet::updateTaskPriorities(
+    const std::vector<float>& op_costs) {
+  const auto tasks_num = tasksNum();
+  CAFFE_ENFORCE_EQ(op_costs.size(), operators_.size());
+  // visit the tasks children first, starting from the leaves
+  std::vector<int> pending_children(tasks_num);
+  std::vector<int> ready;
+  for (auto task_id = 0; task_id < tasks_num; ++task_id) {
+    pending_children[task_id] = children(task_id).size();
+    if (pending_children[task_id] == 0) {
+      ready.push_back(task_id);
+    }
+  }
+  task_priorities_.assign(tasks_num, 0.0f);
+  while (!ready.empty()) {
+    auto task_id = ready.back();
+    ready.pop_back();
+    float path_cost = 0;
+    for (auto child_id : children(task_id)) {
+      path_cost = std::max(path_cost, task_priorities_[child_id]);
+    }
+    for (auto op_id : chains_[task_id]) {
+      path_cost += op_costs[op_id];
+    }
+    task_priorities_[task_id] = path_cost;
+    for (auto parent_id : parents(task_id)) {
+      if (--pending_children[parent_id] == 0) {
+        ready.push_back(parent_id);
+      }
+    }
+  }
+
+  children_by_priority_.resize(tasks_num);
+  for (auto task_id = 0; task_id < tasks_num; ++task_id) {
+    auto& sorted = children_by_priority_[task_id];
+    sorted = children(task_id);
+    std::stable_sort(sorted.begin(), sorted.end(), [this](int a, int b) {
+      return task_priorities_[a] > task_priorities_[b];
+    });
+  }
+}
+
+const std::vector<int>& AsyncSchedulingNet::scheduledChildren(
+    int task_id) const {
+  if (options_.use_critical_path_scheduling_) {
+    return children_by_priority_[task_id];
+  }
+  return children(task_id);
+}
+
+void AsyncSchedulingNet::enqueueTask(
+    int task_id,
+    TaskThreadPoolBase* task_pool) {
+  ReadyQueue* queue = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(ready_queues_mutex_);
+    auto& queue_ptr = ready_queues_[task_pool];
+    if (!queue_ptr) {
+      queue_ptr = caffe2::make_unique<ReadyQueue>();
+    }
+    queue = queue_ptr.get();
+  }
+  {
+    std::lock_guard<std::mutex> lock(queue->mutex);
+    queue->tasks.emplace(task_priorities_[task_id], -task_id);
+  }
+  // one pool job per queued task, each job runs the most critical task that
+  // is ready at the time the job starts
+  task_pool->run(std::bind(&AsyncSchedulingNet::runReadyTask, this, queue));
+}
+
+void AsyncSchedulingNet::runReadyTask(ReadyQueue* queue) noexcept {
+  int task_id = -1;
+  {
+    std::lock_guard<std::mutex> lock(queue->mutex);
+    CAFFE_ENFORCE(!queue->tasks.empty());
+    task_id = -queue->tasks.top().second;
+    queue->tasks.pop();
+  }
+  executeTask(task_id);
+}
 
 void AsyncSchedulingNet::reset() {
   AsyncNetBase::reset();
@@ -32,149 +172,155 @@ bool AsyncSchedulingNet::isInlineTask(int parent_id, int child_id) const {
       last_parent_op->device_option(), first_child_op->device_option());
 }
 
-// schedule() is not supposed to throw, all exceptions in the ops are caught
-// and reported in the end of the graph's execution, the full graph of tasks
-// is expected to be scheduled
+// schedule() and executeTask() are not supposed to throw, all exceptions in
+// the ops are caught and reported in the end of the graph's execution, the
+// full graph of tasks is expected to be scheduled
 void AsyncSchedulingNet::schedule(int task_id, bool run_inline) noexcept {
   if (!testAndSetScheduled(task_id)) {
     return;
   }
-  auto schedule_func = [this, task_id]() {
-    try {
-      if (success_) {
-        int stream_id = 0;
-        if (options_.streams_per_gpu_ > 1) {
-          try {
-            stream_id = stream(task_id);
-          } catch (const std::exception& e) {
-            C10_LOG_EVERY_MS(ERROR, 1000)
-                << "Failed to select a stream: " << e.what();
-          }
-        }
-        if (!run(task_id, stream_id)) {
-          success_ = false;
-        }
-      }
+  if (run_inline) {
+    executeTask(task_id);
+  } else {
+    const auto& device_option = event(task_id).GetDeviceOption();
+    auto* task_pool = pool(device_option);
+    if (options_.use_critical_path_scheduling_) {
+      enqueueTask(task_id, task_pool);
+    } else {
+      task_pool->run(
+          std::bind(&AsyncSchedulingNet::executeTask, this, task_id));
+    }
+  }
+}
 
-      if (options_.report_stats_) {
+void AsyncSchedulingNet::executeTask(int task_id) noexcept {
+  try {
+    if (success_) {
+      int stream_id = 0;
+      if (options_.streams_per_gpu_ > 1) {
         try {
-          auto last_op_id = lastTaskOpId(task_id);
-          auto* last_op = lastTaskOp(task_id);
-          if (last_op->device_option().device_type() == PROTO_CPU &&
-              last_op->HasAsyncPart()) {
-            last_op->event().SetCallback([this, last_op_id] {
-              counters_.AddPerOpAsyncEndTime(last_op_id);
-            });
-          }
+          stream_id = stream(task_id);
         } catch (const std::exception& e) {
           C10_LOG_EVERY_MS(ERROR, 1000)
-              << "Failed to report operator stats: " << e.what();
+              << "Failed to select a stream: " << e.what();
         }
       }
+      if (!run(task_id, stream_id)) {
+        success_ = false;
+      }
+    }
 
-      for (auto child_id : children(task_id)) {
-        int parent_count = updateParentCount(child_id);
-        if (parent_count == 0) {
-          // Schedule a child if:
-          // - there is failure, we skip an op execution and finish the job
-          // - forced scheduling though always_schedule_child_
-          // - finish_chain_ is set, in this case parents are
-          //   guaranteed to be finished
-          // - in all other cases, check parents with canSchedule
-          if (!success_ || options_.always_schedule_child_ ||
-              options_.finish_chain_ || canSchedule(child_id)) {
-            // if DFS scheduling is enabled, run children inline,
-            // ignore DFS scheduling in callbacks
-            schedule(child_id, isInlineTask(task_id, child_id));
-          } else {
-            bool parent_failed = false;
-            bool parent_needs_polling = false;
-            std::vector<int> parents_with_callback;
-
-            for (auto parent_id : parents(child_id)) {
-              auto& parent_event = event(parent_id);
-              auto parent_status = parent_event.Query();
-
-              if (parent_status == EventStatus::EVENT_FAILED) {
-                parent_failed = true;
-                break;
-              } else if (parent_status == EventStatus::EVENT_SCHEDULED) {
-                // parent is not finished yet, check if this is blocking us
-                // from scheduling a child
-                if (!canSchedule(parent_id, child_id)) {
-                  // we can't schedule a child because of this parent,
-                  // check if parent supports callback
-                  if (parent_event.SupportsCallback()) {
-                    parents_with_callback.push_back(parent_id);
-                  } else {
-                    parent_needs_polling = true;
-                    break;
-                  }
+    if (options_.report_stats_) {
+      try {
+        auto last_op_id = lastTaskOpId(task_id);
+        auto* last_op = lastTaskOp(task_id);
+        if (last_op->device_option().device_type() == PROTO_CPU &&
+            last_op->HasAsyncPart()) {
+          last_op->event().SetCallback([this, last_op_id] {
+            counters_.AddPerOpAsyncEndTime(last_op_id);
+          });
+        }
+      } catch (const std::exception& e) {
+        C10_LOG_EVERY_MS(ERROR, 1000)
+            << "Failed to report operator stats: " << e.what();
+      }
+    }
+
+    for (auto child_id : scheduledChildren(task_id)) {
+      int parent_count = updateParentCount(child_id);
+      if (parent_count == 0) {
+        // Schedule a child if:
+        // - there is failure, we skip an op execution and finish the job
+        // - forced scheduling though always_schedule_child_
+        // - finish_chain_ is set, in this case parents are
+        //   guaranteed to be finished
+        // - in all other cases, check parents with canSchedule
+        if (!success_ || options_.always_schedule_child_ ||
+            options_.finish_chain_ || canSchedule(child_id)) {
+          // if DFS scheduling is enabled, run children inline,
+          // ignore DFS scheduling in callbacks
+          schedule(child_id, isInlineTask(task_id, child_id));
+        } else {
+          bool parent_failed = false;
+          bool parent_needs_polling = false;
+          std::vector<int> parents_with_callback;
+
+          for (auto parent_id : parents(child_id)) {
+            auto& parent_event = event(parent_id);
+            auto parent_status = parent_event.Query();
+
+            if (parent_status == EventStatus::EVENT_FAILED) {
+              parent_failed = true;
+              break;
+            } else if (parent_status == EventStatus::EVENT_SCHEDULED) {
+              // parent is not finished yet, check if this is blocking us
+              // from scheduling a child
+              if (!canSchedule(parent_id, child_id)) {
+                // we can't schedule a child because of this parent,
+                // check if parent supports callback
+                if (parent_event.SupportsCallback()) {
+                  parents_with_callback.push_back(parent_id);
+                } else {
+                  parent_needs_polling = true;
+                  break;
                 }
-              } else if (parent_status != EventStatus::EVENT_SUCCESS) {
-                VLOG(1) << "Unexpected parent task state: " << parent_status
-                        << ", task id: " << child_id
-                        << ", parent task id: " << parent_id;
-                parent_failed = true;
-                break;
               }
+            } else if (parent_status != EventStatus::EVENT_SUCCESS) {
+              VLOG(1) << "Unexpected parent task state: " << parent_status
+                      << ", task id: " << child_id
+                      << ", parent task id: " << parent_id;
+              parent_failed = true;
+              break;
             }
+          }
 
-            if (parent_failed) {
-              // one of parents failed, set failure flag and wrap up execution
-              success_ = false;
-              schedule(child_id, isInlineTask(task_id, child_id));
-            } else if (parent_needs_polling) {
-              // some parents are blocking us from scheduling a child and don't
-              // support callbacks, using polling
-              const auto& child_device_option =
-                  event(child_id).GetDeviceOption();
-              pool(child_device_option)
-                  ->run(std::bind(
-                      &AsyncSchedulingNet::pollAndSchedule, this, child_id));
-            } else if (!parents_with_callback.empty()) {
-              // some parents are blocking us from scheduling a child and they
-              // support callbacks
-              for (auto parent_id : parents_with_callback) {
-                event(parent_id).SetCallback(std::bind(
-                    &AsyncSchedulingNet::parentCallback, this, parent_id));
-              }
-            } else {
-              // we're ready to schedule a child
-              schedule(child_id, isInlineTask(task_id, child_id));
+          if (parent_failed) {
+            // one of parents failed, set failure flag and wrap up execution
+            success_ = false;
+            schedule(child_id, isInlineTask(task_id, child_id));
+          } else if (parent_needs_polling) {
+            // some parents are blocking us from scheduling a child and don't
+            // support callbacks, using polling
+            const auto& child_device_option =
+                event(child_id).GetDeviceOption();
+            pool(child_device_option)
+                ->run(std::bind(
+                    &AsyncSchedulingNet::pollAndSchedule, this, child_id));
+          } else if (!parents_with_callback.empty()) {
+            // some parents are blocking us from scheduling a child and they
+            // support callbacks
+            for (auto parent_id : parents_with_callback) {
+              event(parent_id).SetCallback(std::bind(
+                  &AsyncSchedulingNet::parentCallback, this, parent_id));
             }
+          } else {
+            // we're ready to schedule a child
+            schedule(child_id, isInlineTask(task_id, child_id));
           }
         }
       }
+    }
 
-      // In case of net's failure, make sure all pending tasks are finished
-      if (!success_) {
-        CancelAndFinishAsyncTasks();
-      }
-
-      // finishRun may cause waiters to wake up and destroy the net,
-      // before we call finishRun we need to make sure all other (finishing)
-      // tasks are done;
-      // Bumping and checking the counter after the task's job is done
-      auto tasks_num = tasksNum();
-      auto cur_processed_tasks = ++processed_tasks_num_;
-      if (cur_processed_tasks == tasks_num) {
-        finishRun();
-      }
-    } catch (const std::exception& e) {
-      // error of core scheduling and/or logic, will call terminate
-      LOG(FATAL) << "Unexpected error during graph scheduling run: "
-                 << e.what();
-    } catch (...) {
-      LOG(FATAL) << "Unknown error during graph scheduling run";
+    // In case of net's failure, make sure all pending tasks are finished
+    if (!success_) {
+      CancelAndFinishAsyncTasks();
     }
-  };
 
-  if (run_inline) {
-    schedule_func();
-  } else {
-    const auto& device_option = event(task_id).GetDeviceOption();
-    pool(device_option)->run(schedule_func);
+    // finishRun may cause waiters to wake up and destroy the net,
+    // before we call finishRun we need to make sure all other (finishing)
+    // tasks are done;
+    // Bumping and checking the counter after the task's job is done
+    auto tasks_num = tasksNum();
+    auto cur_processed_tasks = ++processed_tasks_num_;
+    if (cur_processed_tasks == tasks_num) {
+      finishRun();
+    }
+  } catch (const std::exception& e) {
+    // error of core scheduling and/or logic, will call terminate
+    LOG(FATAL) << "Unexpected error during graph scheduling run: "
+               << e.what();
+  } catch (...) {
+    LOG(FATAL) << "Unknown error during graph scheduling run";
   }
 }
 
@@ -217,6 +363,15 @@ void AsyncSchedulingNet::finishRun() {
   finalizeEvents();
   if (options_.report_stats_) {
     counters_.ReportRunEnd();
+    // switch to the measured op times, refreshed after 2^k runs
+    ++num_runs_;
+    if (options_.use_critical_path_scheduling_ &&
+        (num_runs_ & (num_runs_ - 1)) == 0) {
+      auto op_times = counters_.GetPerOpMeanTimes();
+      if (!op_times.empty()) {
+        updateTaskPriorities(op_times);
+      }
+    }
   }
   // notify observers and waiters
   StopAllObservers();
@@ -1,6 +1,8 @@
 #ifndef CAFFE2_CORE_NET_ASYNC_SCHEDULING_H_
 #define CAFFE2_CORE_NET_ASYNC_SCHEDULING_H_
 
+#include <queue>
+
 #include "caffe2/core/net_async_base.h"
 
 namespace caffe2 {
@@ -16,11 +18,16 @@ class CAFFE2_API AsyncSchedulingNet : public AsyncNetBase {
 
   void Cancel();
 
+  const std::vector<float>& TEST_task_priorities() const {
+    return task_priorities_;
+  }
+
  protected:
   bool RunAsync() override;
 
   void pollAndSchedule(int task_id);
   void schedule(int task_id, bool run_inline = false) noexcept;
+  void executeTask(int task_id) noexcept;
   void reset() override;
   virtual void finishRun();
   void parentCallback(int parent_id);
@@ -34,6 +41,28 @@ class CAFFE2_API AsyncSchedulingNet : public AsyncNetBase {
 
   std::atomic<int> processed_tasks_num_;
 
+  // Critical path scheduling: the ready tasks of a pool wait in a queue
+  // ordered by the cost of the longest path from the task to a leaf task
+  struct ReadyQueue {
+    std::mutex mutex;
+    // (priority, -task_id), earlier tasks first among equal priorities
+    std::priority_queue<std::pair<float, int>> tasks;
+  };
+  std::vector<float> estimateOpCosts(
+      const NetDef& net_def,
+      const Workspace* ws) const;
+  void updateTaskPriorities(const std::vector<float>& op_costs);
+  const std::vector<int>& scheduledChildren(int task_id) const;
+  void enqueueTask(int task_id, TaskThreadPoolBase* task_pool);
+  void runReadyTask(ReadyQueue* queue) noexcept;
+
+  std::vector<float> task_priorities_;
+  std::vector<std::vector<int>> children_by_priority_;
+  std::mutex ready_queues_mutex_;
+  std::unordered_map<TaskThreadPoolBase*, std::unique_ptr<ReadyQueue>>
+      ready_queues_;
+  int num_runs_ = 0;
+
   C10_DISABLE_COPY_AND_ASSIGN(AsyncSchedulingNet);
 };
 
@@ -1052,6 +1052,68 @@ TEST(NetTest, ChainErrorTest) {
   ASSERT_FALSE(net->Run());
 }
 
+TEST(NetTest, CriticalPathScheduling) {
+  const auto spec = R"DOC(
+        name: "critical_path"
+        type: "async_scheduling"
+        external_input: "in"
+        arg {
+          name: "critical_path_scheduling"
+          i: 1
+        }
+        arg {
+          name: "enable_profiling"
+          i: 1
+        }
+        op {
+          input: "in"
+          output: "fork"
+          type: "NetTestDummy"
+        }
+        op {
+          input: "fork"
+          output: "short"
+          type: "NetTestDummy"
+        }
+        op {
+          input: "fork"
+          output: "long1"
+          type: "NetTestDummy"
+        }
+        op {
+          input: "long1"
+          output: "long2"
+          type: "NetTestDummy"
+        }
+        op {
+          input: "long2"
+          output: "long3"
+          type: "NetTestDummy"
+        }
+  )DOC";
+
+  Workspace ws;
+  ws.CreateBlob("in");
+  NetDef net_def;
+  CAFFE_ENFORCE(TextFormat::ParseFromString(spec, &net_def));
+  auto net = CreateNet(net_def, &ws);
+  auto* async_net = dynamic_cast_if_rtti<AsyncSchedulingNet*>(net.get());
+  ASSERT_TRUE(async_net != nullptr);
+
+  // without cost functions every op costs the same, the longest path from
+  // the root is fork -> long1 -> long2 -> long3
+  const auto& priorities = async_net->TEST_task_priorities();
+  ASSERT_EQ(priorities.size(), async_net->TEST_execution_chains().size());
+  EXPECT_FLOAT_EQ(
+      *std::max_element(priorities.begin(), priorities.end()), 4.0f);
+
+  counter.exchange(0);
+  for (int i = 0; i < 10; ++i) {
+    ASSERT_TRUE(net->Run());
+  }
+  EXPECT_EQ(counter.load(), 10 * net_def.op_size());
+}
+
 void testProfDAGNetErrorCase(bool test_error) {
   std::string spec_template = R"DOC(
         name: "prof_dag_error_test_net"
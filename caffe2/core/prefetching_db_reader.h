@@ -0,0 +1,202 @@
+#ifndef CAFFE2_CORE_PREFETCHING_DB_READER_H_
+#define CAFFE2_CORE_PREFETCHING_DB_READER_H_
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "c10/util/Optional.h"
+#include "caffe2/core/db.h"
+
+namespace caffe2 {
+namespace db {
+
+/**
+ * Reads a DBReader ahead of its consumer and decodes the records on a pool of
+ * worker threads.
+ *
+ * One thread pulls the key-value pairs out of the reader and `num_workers`
+ * threads turn them into T with `decode`, so that the disk reads and the
+ * parsing and decoding of different records overlap. At most `capacity`
+ * records are read but not yet returned by Next(), which bounds the memory
+ * held by the prefetched records.
+ *
+ * If `ordered` is true, Next() returns the records in the order of the reader.
+ * Otherwise it returns whichever record has been decoded first, so that one
+ * slow record doesn't hold back the others.
+ *
+ * An exception thrown by `decode` is rethrown by the Next() call that returns
+ * the record. An exception thrown by the reader stops the reading, and is
+ * rethrown by every Next() call once the records read before it are returned.
+ */
+template <typename T>
+class PrefetchingDBReader {
+ public:
+  using DecodeFunction =
+      std::function<T(const string& key, const string& value)>;
+
+  PrefetchingDBReader(
+      const DBReader* reader,
+      DecodeFunction decode,
+      int num_workers = 1,
+      int capacity = 64,
+      bool ordered = true)
+      : reader_(reader),
+        decode_(std::move(decode)),
+        capacity_(capacity),
+        ordered_(ordered) {
+    CAFFE_ENFORCE(reader_, "Passed null reader");
+    CAFFE_ENFORCE_GE(num_workers, 1);
+    CAFFE_ENFORCE_GE(capacity, 1);
+    read_thread_ = std::thread([this]() { ReadLoop(); });
+    for (int i = 0; i < num_workers; ++i) {
+      decode_threads_.emplace_back([this]() { DecodeLoop(); });
+    }
+  }
+
+  ~PrefetchingDBReader() {
+    {
+      std::lock_guard<std::mutex> guard(mutex_);
+      stop_ = true;
+    }
+    space_cv_.notify_all();
+    record_cv_.notify_all();
+    read_thread_.join();
+    for (auto& thread : decode_threads_) {
+      thread.join();
+    }
+  }
+
+  /**
+   * Returns the next decoded record, waiting for it if it is not ready yet.
+   * Thread safe.
+   */
+  T Next() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    ready_cv_.wait(lock, [this]() {
+      return Available() || (read_error_ && consumed_ == num_read_);
+    });
+    if (!Available()) {
+      std::rethrow_exception(read_error_);
+    }
+    Item item = std::move(ready_.begin()->second);
+    ready_.erase(ready_.begin());
+    ++consumed_;
+    lock.unlock();
+    space_cv_.notify_one();
+    if (item.error) {
+      std::rethrow_exception(item.error);
+    }
+    return std::move(*item.value);
+  }
+
+ private:
+  struct Record {
+    int64_t id;
+    string key;
+    string value;
+  };
+
+  struct Item {
+    c10::optional<T> value;
+    std::exception_ptr error;
+  };
+
+  // In order, the next record to return is the one with the smallest id that
+  // hasn't been returned yet, which is consumed_
+  bool Available() const {
+    return !ready_.empty() &&
+        (!ordered_ || ready_.begin()->first == consumed_);
+  }
+
+  void ReadLoop() {
+    for (int64_t id = 0;; ++id) {
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        space_cv_.wait(
+            lock, [&]() { return stop_ || id - consumed_ < capacity_; });
+        if (stop_) {
+          return;
+        }
+      }
+      Record record;
+      record.id = id;
+      try {
+        reader_->Read(&record.key, &record.value);
+      } catch (...) {
+        std::lock_guard<std::mutex> guard(mutex_);
+        read_error_ = std::current_exception();
+        num_read_ = id;
+        ready_cv_.notify_all();
+        return;
+      }
+      {
+        std::lock_guard<std::mutex> guard(mutex_);
+        records_.push_back(std::move(record));
+      }
+      record_cv_.notify_one();
+    }
+  }
+
+  void DecodeLoop() {
+    while (true) {
+      Record record;
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        record_cv_.wait(lock, [this]() { return stop_ || !records_.empty(); });
+        if (stop_) {
+          return;
+        }
+        record = std::move(records_.front());
+        records_.pop_front();
+      }
+      Item item;
+      try {
+        item.value = decode_(record.key, record.value);
+      } catch (...) {
+        item.error = std::current_exception();
+      }
+      {
+        std::lock_guard<std::mutex> guard(mutex_);
+        ready_.emplace(record.id, std::move(item));
+      }
+      // Several callers of Next() may wait for different records
+      ready_cv_.notify_all();
+    }
+  }
+
+  const DBReader* reader_;
+  DecodeFunction decode_;
+  const int64_t capacity_;
+  const bool ordered_;
+
+  std::mutex mutex_;
+  // Signaled when a record is returned, and the reader may read one more
+  std::condition_variable space_cv_;
+  // Signaled when a record is read and waits to be decoded
+  std::condition_variable record_cv_;
+  // Signaled when a record is decoded, or the reader fails
+  std::condition_variable ready_cv_;
+  std::deque<Record> records_;
+  // Decoded records by id, which is their position in the reader
+  std::map<int64_t, Item> ready_;
+  int64_t consumed_ = 0;
+  std::exception_ptr read_error_;
+  int64_t num_read_ = 0;
+  bool stop_ = false;
+
+  std::thread read_thread_;
+  std::vector<std::thread> decode_threads_;
+
+  C10_DISABLE_COPY_AND_ASSIGN(PrefetchingDBReader);
+};
+
+} // namespace db
+} // namespace caffe2
+
+#endif // CAFFE2_CORE_PREFETCHING_DB_READER_H_
@@ -105,6 +105,9 @@ class ProfDAGCounters {
   void AddPerOpAsyncEndTime(size_t op_id);
   ProfDAGReport GetReport() const;
 
+  // Mean time of each operator in ms, empty until a run has been measured
+  std::vector<float> GetPerOpMeanTimes() const;
+
  private:
   Timer timer_;
 
@@ -1,3 +1,5 @@
+#include <algorithm>
+#include <chrono>
 #include <cstdio>
 #include <iomanip>
 #include <sstream>
@@ -6,6 +8,7 @@
 #include "caffe2/core/blob_serialization.h"
 #include "caffe2/core/db.h"
 #include "caffe2/core/logging.h"
+#include "caffe2/core/prefetching_db_reader.h"
 #include "caffe2/proto/caffe2_pb.h"
 #include <gtest/gtest.h>
 
@@ -196,5 +199,62 @@ TEST(DBReaderShardedTest, Reader) {
   EXPECT_EQ(value, "05");
 }
 
+TEST(PrefetchingDBReaderTest, Ordered) {
+  std::string name = std::tmpnam(nullptr);
+  CreateAndFill("leveldb", name);
+  DBReader reader("leveldb", name);
+  PrefetchingDBReader<string> prefetching_reader(
+      &reader,
+      [](const string& key, const string& value) {
+        EXPECT_EQ(key, value);
+        CAFFE_ENFORCE(value != "03", "Cannot decode ", value);
+        return value;
+      },
+      4,
+      3,
+      true);
+  EXPECT_EQ(prefetching_reader.Next(), "00");
+  EXPECT_EQ(prefetching_reader.Next(), "01");
+  EXPECT_EQ(prefetching_reader.Next(), "02");
+  // The error of one record doesn't stop the others
+  EXPECT_THROW(prefetching_reader.Next(), EnforceNotMet);
+  for (int i = 4; i < kMaxItems; ++i) {
+    std::stringstream ss;
+    ss << std::setw(2) << std::setfill('0') << i;
+    EXPECT_EQ(prefetching_reader.Next(), ss.str());
+  }
+  // The reader goes back to the head of the db
+  EXPECT_EQ(prefetching_reader.Next(), "00");
+}
+
+TEST(PrefetchingDBReaderTest, Unordered) {
+  std::string name = std::tmpnam(nullptr);
+  CreateAndFill("leveldb", name);
+  DBReader reader("leveldb", name);
+  PrefetchingDBReader<string> prefetching_reader(
+      &reader,
+      [](const string& /*key*/, const string& value) {
+        if (value == "00") {
+          // The records read after this one are returned before it
+          std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        }
+        return value;
+      },
+      2,
+      kMaxItems,
+      false);
+  std::vector<string> values;
+  for (int i = 0; i < kMaxItems; ++i) {
+    values.push_back(prefetching_reader.Next());
+  }
+  EXPECT_NE(values.front(), "00");
+  std::sort(values.begin(), values.end());
+  for (int i = 0; i < kMaxItems; ++i) {
+    std::stringstream ss;
+    ss << std::setw(2) << std::setfill('0') << i;
+    EXPECT_EQ(values[i], ss.str());
+  }
+}
+
 }  // namespace db
 }  // namespace caffe2
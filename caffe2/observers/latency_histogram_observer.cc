@@ -0,0 +1,161 @@
+#include "caffe2/observers/latency_histogram_observer.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "c10/util/llvmMathExtras.h"
+
+namespace caffe2 {
+
+constexpr int LatencyHistogram::kSubBucketBits;
+constexpr int LatencyHistogram::kSubBuckets;
+constexpr int LatencyHistogram::kMaxBits;
+constexpr int LatencyHistogram::kNumBuckets;
+
+namespace {
+
+// Returns the smallest value of `counts` whose rank is at least `fraction` of
+// `total`
+float percentile(
+    const std::vector<uint64_t>& counts,
+    uint64_t total,
+    double fraction) {
+  const uint64_t rank =
+      std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(fraction * total)));
+  uint64_t seen = 0;
+  for (size_t i = 0; i < counts.size(); ++i) {
+    seen += counts[i];
+    if (seen >= rank) {
+      return LatencyHistogram::BucketValue(i) / 1e6f;
+    }
+  }
+  return 0.0f;
+}
+
+} // namespace
+
+LatencyHistogram::LatencyHistogram() {
+  Reset();
+}
+
+int LatencyHistogram::BucketIndex(uint64_t nanos) {
+  nanos = std::min(nanos, (uint64_t(1) << kMaxBits) - 1);
+  if (nanos < kSubBuckets) {
+    return nanos;
+  }
+  // The top kSubBucketBits + 1 bits of the value select the bucket
+  int shift = c10::llvm::Log2_64(nanos) - kSubBucketBits;
+  return (shift + 1) * kSubBuckets + ((nanos >> shift) - kSubBuckets);
+}
+
+uint64_t LatencyHistogram::BucketValue(int index) {
+  if (index < kSubBuckets) {
+    return index;
+  }
+  int shift = index / kSubBuckets - 1;
+  uint64_t lower = uint64_t(kSubBuckets + index % kSubBuckets) << shift;
+  return lower + ((uint64_t(1) << shift) >> 1);
+}
+
+void LatencyHistogram::Record(uint64_t nanos) {
+  counts_[BucketIndex(nanos)].fetch_add(1, std::memory_order_relaxed);
+  total_nanos_.fetch_add(nanos, std::memory_order_relaxed);
+}
+
+void LatencyHistogram::Reset() {
+  for (auto& count : counts_) {
+    count.store(0, std::memory_order_relaxed);
+  }
+  total_nanos_.store(0, std::memory_order_relaxed);
+}
+
+LatencyStats LatencyHistogram::Summarize() const {
+  Snapshot snapshot;
+  snapshot.Add(*this);
+  return snapshot.Summarize();
+}
+
+void LatencyHistogram::Snapshot::Add(const LatencyHistogram& histogram) {
+  for (int i = 0; i < kNumBuckets; ++i) {
+    counts_[i] += histogram.counts_[i].load(std::memory_order_relaxed);
+  }
+  total_nanos_ += histogram.total_nanos_.load(std::memory_order_relaxed);
+}
+
+LatencyStats LatencyHistogram::Snapshot::Summarize() const {
+  LatencyStats stats;
+  for (int i = 0; i < kNumBuckets; ++i) {
+    if (counts_[i]) {
+      stats.count += counts_[i];
+      stats.max = BucketValue(i) / 1e6f;
+    }
+  }
+  if (stats.count == 0) {
+    return stats;
+  }
+  stats.mean = total_nanos_ / 1e6f / stats.count;
+  stats.p50 = percentile(counts_, stats.count, 0.50);
+  stats.p90 = percentile(counts_, stats.count, 0.90);
+  stats.p99 = percentile(counts_, stats.count, 0.99);
+  return stats;
+}
+
+void LatencyHistogramOperatorObserver::Start() {
+  timer_.Start();
+}
+
+void LatencyHistogramOperatorObserver::Stop() {
+  histogram_->Record(static_cast<uint64_t>(timer_.NanoSeconds()));
+}
+
+std::unique_ptr<ObserverBase<OperatorBase>>
+LatencyHistogramOperatorObserver::rnnCopy(
+    OperatorBase* subject,
+    int /* rnn_order */) const {
+  return std::unique_ptr<ObserverBase<OperatorBase>>(
+      new LatencyHistogramOperatorObserver(subject, histogram_));
+}
+
+LatencyHistogramObserver::LatencyHistogramObserver(NetBase* subject)
+    : OperatorAttachingNetObserver<
+          LatencyHistogramOperatorObserver,
+          LatencyHistogramObserver>(subject, this) {
+  for (const auto* observer : operator_observers_) {
+    operator_histograms_.emplace_back(
+        observer->subject()->type(), observer->histogram());
+  }
+}
+
+void LatencyHistogramObserver::Start() {
+  timer_.Start();
+}
+
+void LatencyHistogramObserver::Stop() {
+  net_histogram_.Record(static_cast<uint64_t>(timer_.NanoSeconds()));
+}
+
+LatencyStats LatencyHistogramObserver::GetNetStats() const {
+  return net_histogram_.Summarize();
+}
+
+std::map<std::string, LatencyStats> LatencyHistogramObserver::GetOperatorStats()
+    const {
+  std::map<std::string, LatencyHistogram::Snapshot> snapshots;
+  for (const auto& entry : operator_histograms_) {
+    snapshots[entry.first].Add(*entry.second);
+  }
+  std::map<std::string, LatencyStats> stats;
+  for (const auto& entry : snapshots) {
+    stats[entry.first] = entry.second.Summarize();
+  }
+  return stats;
+}
+
+void LatencyHistogramObserver::Reset() {
+  net_histogram_.Reset();
+  for (const auto& entry : operator_histograms_) {
+    entry.second->Reset();
+  }
+}
+
+} // namespace caffe2
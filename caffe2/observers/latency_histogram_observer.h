@@ -0,0 +1,144 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "caffe2/core/common.h"
+#include "caffe2/core/net.h"
+#include "caffe2/core/observer.h"
+#include "caffe2/core/operator.h"
+#include "caffe2/core/timer.h"
+#include "caffe2/observers/operator_attaching_net_observer.h"
+
+namespace caffe2 {
+
+// Summary of a latency distribution, in milliseconds
+struct CAFFE2_API LatencyStats {
+  uint64_t count = 0;
+  float mean = 0.0f;
+  float p50 = 0.0f;
+  float p90 = 0.0f;
+  float p99 = 0.0f;
+  float max = 0.0f;
+};
+
+/**
+ * Histogram of latencies with buckets of bounded relative width, in the
+ * manner of HdrHistogram: each power of two of nanoseconds is split into
+ * kSubBuckets buckets, so that a percentile is off by at most 1/32 of its
+ * value. Record() is a couple of relaxed atomic increments, and can run
+ * concurrently with itself and with the readers.
+ */
+class CAFFE2_API LatencyHistogram {
+ public:
+  static constexpr int kSubBucketBits = 4;
+  static constexpr int kSubBuckets = 1 << kSubBucketBits;
+  // Latencies are clamped to 2^kMaxBits nanoseconds, about 18 minutes
+  static constexpr int kMaxBits = 40;
+  static constexpr int kNumBuckets =
+      kSubBuckets * (kMaxBits - kSubBucketBits + 1);
+
+  // Counts of a set of histograms, taken one bucket at a time
+  class CAFFE2_API Snapshot {
+   public:
+    Snapshot() : counts_(kNumBuckets, 0) {}
+    void Add(const LatencyHistogram& histogram);
+    LatencyStats Summarize() const;
+
+   private:
+    std::vector<uint64_t> counts_;
+    uint64_t total_nanos_ = 0;
+  };
+
+  LatencyHistogram();
+
+  void Record(uint64_t nanos);
+  // Not atomic with the concurrent records, which may be partly kept
+  void Reset();
+
+  LatencyStats Summarize() const;
+
+  static int BucketIndex(uint64_t nanos);
+  // Value reported for the records of a bucket, the middle of its range
+  static uint64_t BucketValue(int index);
+
+ private:
+  std::array<std::atomic<uint64_t>, kNumBuckets> counts_;
+  std::atomic<uint64_t> total_nanos_;
+
+  C10_DISABLE_COPY_AND_ASSIGN(LatencyHistogram);
+};
+
+class LatencyHistogramObserver;
+
+class CAFFE2_API LatencyHistogramOperatorObserver final
+    : public ObserverBase<OperatorBase> {
+ public:
+  explicit LatencyHistogramOperatorObserver(OperatorBase* subject) = delete;
+  LatencyHistogramOperatorObserver(
+      OperatorBase* subject,
+      LatencyHistogramObserver* /* unused */)
+      : LatencyHistogramOperatorObserver(
+            subject,
+            std::make_shared<LatencyHistogram>()) {}
+  LatencyHistogramOperatorObserver(
+      OperatorBase* subject,
+      std::shared_ptr<LatencyHistogram> histogram)
+      : ObserverBase<OperatorBase>(subject),
+        histogram_(std::move(histogram)) {}
+
+  // The copies in the step nets of an RNN record to the same histogram
+  std::unique_ptr<ObserverBase<OperatorBase>> rnnCopy(
+      OperatorBase* subject,
+      int rnn_order) const override;
+
+  const std::shared_ptr<LatencyHistogram>& histogram() const {
+    return histogram_;
+  }
+
+ private:
+  void Start() override;
+  void Stop() override;
+
+  Timer timer_;
+  std::shared_ptr<LatencyHistogram> histogram_;
+};
+
+/**
+ * Keeps a latency histogram of the net and of each of its operators, cheap
+ * enough to stay attached in production. The stats are pulled with
+ * GetNetStats() and GetOperatorStats(), from any thread and while the net
+ * runs.
+ *
+ * For an async net, the latency of an operator is the time taken to schedule
+ * its asynchronous part, as for the other operator observers.
+ */
+class CAFFE2_API LatencyHistogramObserver final
+    : public OperatorAttachingNetObserver<
+          LatencyHistogramOperatorObserver,
+          LatencyHistogramObserver> {
+ public:
+  explicit LatencyHistogramObserver(NetBase* subject);
+
+  LatencyStats GetNetStats() const;
+  // Merges the histograms of the operators of the same type
+  std::map<std::string, LatencyStats> GetOperatorStats() const;
+  // Starts a new window of stats
+  void Reset();
+
+ private:
+  void Start() override;
+  void Stop() override;
+
+  Timer timer_;
+  LatencyHistogram net_histogram_;
+  // The operator observers belong to the operators, the histograms are kept
+  // here so that they can be read after the net is gone
+  std::vector<std::pair<std::string, std::shared_ptr<LatencyHistogram>>>
+      operator_histograms_;
+};
+
+} // namespace caffe2
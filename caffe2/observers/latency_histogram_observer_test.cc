@@ -0,0 +1,109 @@
+#include "caffe2/core/common.h"
+#include "caffe2/core/net.h"
+#include "caffe2/core/observer.h"
+#include "caffe2/core/operator.h"
+#include "latency_histogram_observer.h"
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <thread>
+
+namespace caffe2 {
+
+namespace {
+
+class LatencySleepOp final : public OperatorBase {
+ public:
+  LatencySleepOp(const OperatorDef& operator_def, Workspace* ws)
+      : OperatorBase(operator_def, ws),
+        ms_(GetSingleArgument<int>("ms", 10)) {}
+
+  bool Run(int /* unused */) override {
+    StartAllObservers();
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms_));
+    StopAllObservers();
+    return true;
+  }
+
+ private:
+  int ms_;
+};
+
+REGISTER_CPU_OPERATOR(LatencySleepOp, LatencySleepOp);
+
+OPERATOR_SCHEMA(LatencySleepOp).NumInputs(0, INT_MAX).NumOutputs(0, INT_MAX);
+
+unique_ptr<NetBase> CreateNetTestHelper(Workspace* ws) {
+  NetDef net_def;
+  for (int ms : {10, 30}) {
+    auto& op = *(net_def.add_op());
+    op.set_type("LatencySleepOp");
+    auto& arg = *(op.add_arg());
+    arg.set_name("ms");
+    arg.set_i(ms);
+  }
+  return CreateNet(net_def, ws);
+}
+
+} // namespace
+
+TEST(LatencyHistogramTest, Percentiles) {
+  LatencyHistogram histogram;
+  EXPECT_EQ(histogram.Summarize().count, 0);
+  // 1 to 100 ms
+  for (int i = 1; i <= 100; ++i) {
+    histogram.Record(i * 1000000);
+  }
+  auto stats = histogram.Summarize();
+  EXPECT_EQ(stats.count, 100);
+  EXPECT_NEAR(stats.mean, 50.5, 1e-3);
+  EXPECT_NEAR(stats.p50, 50, 50 / 32.0);
+  EXPECT_NEAR(stats.p90, 90, 90 / 32.0);
+  EXPECT_NEAR(stats.p99, 99, 99 / 32.0);
+  EXPECT_NEAR(stats.max, 100, 100 / 32.0);
+
+  histogram.Reset();
+  EXPECT_EQ(histogram.Summarize().count, 0);
+}
+
+TEST(LatencyHistogramTest, Buckets) {
+  int last = -1;
+  for (uint64_t nanos = 0; nanos < (1 << 20); ++nanos) {
+    int index = LatencyHistogram::BucketIndex(nanos);
+    // The buckets are contiguous and each holds its value
+    EXPECT_TRUE(index == last || index == last + 1);
+    last = index;
+    uint64_t value = LatencyHistogram::BucketValue(index);
+    EXPECT_LE(std::abs(double(value) - double(nanos)), nanos / 16.0);
+  }
+  EXPECT_EQ(
+      LatencyHistogram::BucketIndex(uint64_t(-1)),
+      LatencyHistogram::kNumBuckets - 1);
+}
+
+TEST(LatencyHistogramObserverTest, NetAndOperators) {
+  Workspace ws;
+  unique_ptr<NetBase> net(CreateNetTestHelper(&ws));
+  auto net_ob = caffe2::make_unique<LatencyHistogramObserver>(net.get());
+  const auto* ob = net_ob.get();
+  net->AttachObserver(std::move(net_ob));
+  for (int i = 0; i < 3; ++i) {
+    net->Run();
+  }
+
+  auto net_stats = ob->GetNetStats();
+  EXPECT_EQ(net_stats.count, 3);
+  EXPECT_GT(net_stats.p50, 40 * (1 - 1 / 32.0));
+  EXPECT_LT(net_stats.p50, 100);
+
+  // Both operators are of the same type
+  auto op_stats = ob->GetOperatorStats();
+  ASSERT_EQ(op_stats.size(), 1);
+  const auto& stats = op_stats["LatencySleepOp"];
+  EXPECT_EQ(stats.count, 6);
+  EXPECT_GT(stats.p50, 10 * (1 - 1 / 32.0));
+  EXPECT_GT(stats.max, 30 * (1 - 1 / 32.0));
+  EXPECT_LT(stats.p50, stats.max);
+}
+
+} // namespace caffe2
@@ -0,0 +1,119 @@
+#include "caffe2/operators/fused_elementwise_op.h"
+
+#include <algorithm>
+#include <unordered_map>
+
+#include "caffe2/operators/abs_op.h"
+#include "caffe2/operators/exp_op.h"
+#include "caffe2/operators/log_op.h"
+#include "caffe2/operators/sqr_op.h"
+#include "caffe2/operators/sqrt_op.h"
+#include "caffe2/operators/tanh_op.h"
+#include "caffe2/utils/eigen_utils.h"
+
+namespace caffe2 {
+
+namespace {
+
+// Elements processed by each op of the chain at a time
+constexpr int64_t kBlockSize = 1024;
+
+template <class Functor>
+void applyFunctor(const int N, const float* X, float* Y, CPUContext* context) {
+  Functor()(N, X, Y, context);
+}
+
+// Same as ReluFunctor and SigmoidFunctor, which are only defined along with
+// their ops
+void relu(const int N, const float* X, float* Y, CPUContext* /* context */) {
+  EigenVectorMap<float>(Y, N) = ConstEigenVectorMap<float>(X, N).cwiseMax(0.0f);
+}
+
+void sigmoid(const int N, const float* X, float* Y, CPUContext* /* context */) {
+  EigenVectorArrayMap<float>(Y, N) =
+      1.0f / (1.0f + (-ConstEigenVectorArrayMap<float>(X, N)).exp());
+}
+
+const std::unordered_map<std::string, FusedElementwiseOp::UnaryFunction>&
+unaryFunctions() {
+  static const std::unordered_map<std::string, FusedElementwiseOp::UnaryFunction>
+      functions = {
+          {"Abs", applyFunctor<AbsFunctor<CPUContext>>},
+          {"Exp", applyFunctor<ExpFunctor<CPUContext>>},
+          {"Log", applyFunctor<LogFunctor<CPUContext>>},
+          {"Relu", relu},
+          {"Sigmoid", sigmoid},
+          {"Sqr", applyFunctor<SqrFunctor<CPUContext>>},
+          {"Sqrt", applyFunctor<SqrtFunctor<CPUContext>>},
+          {"Tanh", applyFunctor<TanhFunctor<CPUContext>>},
+      };
+  return functions;
+}
+
+} // namespace
+
+FusedElementwiseOp::FusedElementwiseOp(
+    const OperatorDef& operator_def,
+    Workspace* ws)
+    : Operator<CPUContext>(operator_def, ws) {
+  const auto ops = this->template GetRepeatedArgument<std::string>("ops");
+  CAFFE_ENFORCE(!ops.empty(), "FusedElementwise needs at least one op");
+  for (const auto& op : ops) {
+    const auto it = unaryFunctions().find(op);
+    CAFFE_ENFORCE(
+        it != unaryFunctions().end(), "Unsupported op in FusedElementwise: ", op);
+    functions_.push_back(it->second);
+  }
+}
+
+bool FusedElementwiseOp::RunOnDevice() {
+  const auto& X = Input(0);
+  auto* Y = Output(0, X.sizes(), at::dtype<float>());
+  const float* X_data = X.template data<float>();
+  float* Y_data = Y->template mutable_data<float>();
+  const int64_t size = X.numel();
+  for (int64_t i = 0; i < size; i += kBlockSize) {
+    const int n = std::min(kBlockSize, size - i);
+    functions_.front()(n, X_data + i, Y_data + i, &context_);
+    for (size_t j = 1; j < functions_.size(); ++j) {
+      functions_[j](n, Y_data + i, Y_data + i, &context_);
+    }
+  }
+  return true;
+}
+
+const std::vector<std::string>& FusedElementwiseOp::SupportedOps() {
+  static const std::vector<std::string> ops = []() {
+    std::vector<std::string> ops;
+    for (const auto& kv : unaryFunctions()) {
+      ops.push_back(kv.first);
+    }
+    std::sort(ops.begin(), ops.end());
+    return ops;
+  }();
+  return ops;
+}
+
+REGISTER_CPU_OPERATOR(FusedElementwise, FusedElementwiseOp);
+
+OPERATOR_SCHEMA(FusedElementwise)
+    .NumInputs(1)
+    .NumOutputs(1)
+    .AllowInplace({{0, 0}})
+    .IdenticalTypeAndShape()
+    .SetDoc(R"DOC(
+Applies the unary elementwise ops listed in `ops` one after another, as the
+chain of these ops would. The ops run on one block of the input at a time, so
+that the intermediate results stay in cache. Inserted by the inference fusion
+passes of caffe2/opt.
+)DOC")
+    .Arg(
+        "ops",
+        "*(type: [string])* The types of the ops of the chain, in order: Abs, "
+        "Exp, Log, Relu, Sigmoid, Sqr, Sqrt or Tanh.")
+    .Input(0, "X", "*(type: Tensor`<float>`)* Input tensor.")
+    .Output(0, "Y", "*(type: Tensor`<float>`)* Output tensor.");
+
+SHOULD_NOT_DO_GRADIENT(FusedElementwise);
+
+} // namespace caffe2
@@ -0,0 +1,33 @@
+#ifndef CAFFE2_OPERATORS_FUSED_ELEMENTWISE_OP_H_
+#define CAFFE2_OPERATORS_FUSED_ELEMENTWISE_OP_H_
+
+#include <string>
+#include <vector>
+
+#include "caffe2/core/context.h"
+#include "caffe2/core/operator.h"
+
+namespace caffe2 {
+
+// Applies a chain of unary elementwise float ops in one pass over the data:
+// the ops run one after another on a block of the input small enough to stay
+// in cache, instead of each op going through the whole tensor.
+class CAFFE2_API FusedElementwiseOp final : public Operator<CPUContext> {
+ public:
+  USE_OPERATOR_FUNCTIONS(CPUContext);
+  using UnaryFunction = void (*)(int, const float*, float*, CPUContext*);
+
+  FusedElementwiseOp(const OperatorDef& operator_def, Workspace* ws);
+
+  bool RunOnDevice() override;
+
+  // The op types that can be part of a chain
+  static const std::vector<std::string>& SupportedOps();
+
+ private:
+  std::vector<UnaryFunction> functions_;
+};
+
+} // namespace caffe2
+
+#endif // CAFFE2_OPERATORS_FUSED_ELEMENTWISE_OP_H_
@@ -0,0 +1,63 @@
+#include "caffe2/operators/fused_fc_ops.h"
+
+#include <functional>
+
+#include "caffe2/operators/fc_inference.h"
+
+namespace caffe2 {
+
+REGISTER_CPU_OPERATOR(FCRelu, FusedFullyConnectedOp<true>);
+REGISTER_CPU_OPERATOR(ConcatFC, FusedFullyConnectedOp<false>);
+
+using namespace std::placeholders;
+
+OPERATOR_SCHEMA(FCRelu)
+    .NumInputs(3)
+    .NumOutputs(1)
+    .TensorInferenceFunction(std::bind(FCShapeInference, _1, _2, false))
+    .CostInferenceFunction(std::bind(CostInferenceForFC, _1, _2, false))
+    .SetDoc(R"DOC(
+Same as FC followed by Relu, $Y = max(XW^T + b, 0)$, with the bias and the
+Relu applied in a single pass over the output. Inserted by the inference
+fusion passes of caffe2/opt.
+)DOC")
+    .Arg("axis", "*(type: int; default: 1)* Describes the axis of the input data $X$.")
+    .Arg("axis_w", "*(type: int; default: 1)* Describes the axis of the input weight matrix $W$.")
+    .Input(0, "X", "Input blob to be coerced into a 2D matrix of shape $(M,K)$.")
+    .Input(1, "W", "Input blob to be coerced into a 2D matrix of shape $(N,K)$.")
+    .Input(2, "b", "Input blob containing vector of length $N$.")
+    .Output(0, "Y", "Output blob containing a 2D output matrix of shape $(M,N)$.");
+
+OPERATOR_SCHEMA(ConcatFC)
+    .NumInputs(3, INT_MAX)
+    .NumOutputs(1)
+    .TensorInferenceFunction([](const OperatorDef& def,
+                                const vector<TensorShape>& in) {
+      ArgumentHelper helper(def);
+      const auto& X = in.front();
+      const auto& W = in[in.size() - 2];
+      const int axis = canonical_axis_index_(
+          helper.GetSingleArgument<int32_t>("axis", 1), X.dims_size());
+      const int axis_w = canonical_axis_index_(
+          helper.GetSingleArgument<int32_t>("axis_w", 1), W.dims_size());
+      std::vector<int64_t> dims(X.dims().begin(), X.dims().begin() + axis);
+      dims.push_back(size_to_dim_(axis_w, GetDimsVector(W)));
+      return vector<TensorShape>{CreateTensorShape(dims, X.data_type())};
+    })
+    .SetDoc(R"DOC(
+Same as Concat of the $X_i$ along `axis` followed by FC, $Y = XW^T + b$ with
+$X = [X_1, ..., X_k]$, but without materializing $X$: each $X_i$ is multiplied
+by its slice of the columns of $W$. The $X_i$ must agree on the dims before
+`axis`. Inserted by the inference fusion passes of caffe2/opt.
+)DOC")
+    .Arg("axis", "*(type: int; default: 1)* Axis along which the $X_i$ are concatenated, and $X$ is coerced into a 2D matrix.")
+    .Arg("axis_w", "*(type: int; default: 1)* Describes the axis of the input weight matrix $W$.")
+    .Input(0, "X_1, ..., X_k", "The pieces of the input of FC.")
+    .Input(1, "W", "Input blob to be coerced into a 2D matrix of shape $(N,K)$, where $K$ is the total size of the $X_i$ from `axis`.")
+    .Input(2, "b", "Input blob containing vector of length $N$.")
+    .Output(0, "Y", "Output blob containing a 2D output matrix of shape $(M,N)$.");
+
+SHOULD_NOT_DO_GRADIENT(FCRelu);
+SHOULD_NOT_DO_GRADIENT(ConcatFC);
+
+} // namespace caffe2
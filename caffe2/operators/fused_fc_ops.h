@@ -0,0 +1,117 @@
+#ifndef CAFFE2_OPERATORS_FUSED_FC_OPS_H_
+#define CAFFE2_OPERATORS_FUSED_FC_OPS_H_
+
+#include "caffe2/core/context.h"
+#include "caffe2/core/operator.h"
+#include "caffe2/utils/eigen_utils.h"
+#include "caffe2/utils/math.h"
+
+namespace caffe2 {
+
+// FC whose input X is given as the pieces X_1, ..., X_k of its concatenation
+// along `axis`, optionally followed by Relu. The inputs are (X_1, ..., X_k, W,
+// b), and the output is the same as FC on the concatenation of the X_i.
+//
+// Each X_i is multiplied by its slice of the columns of W, so that X is never
+// materialized. The bias and the Relu are applied in one pass over Y.
+template <bool FuseRelu>
+class FusedFullyConnectedOp final : public Operator<CPUContext> {
+ public:
+  USE_OPERATOR_FUNCTIONS(CPUContext);
+  template <class... Args>
+  explicit FusedFullyConnectedOp(Args&&... args)
+      : Operator<CPUContext>(std::forward<Args>(args)...),
+        axis_(this->template GetSingleArgument<int32_t>("axis", 1)),
+        axis_w_(this->template GetSingleArgument<int32_t>("axis_w", 1)) {}
+
+  bool RunOnDevice() override {
+    const int num_x = InputSize() - 2;
+    const auto& W = Input(num_x);
+    const auto& b = Input(num_x + 1);
+    CAFFE_ENFORCE(b.dim() == 1, b.dim());
+
+    const auto& X0 = Input(0);
+    const auto canonical_axis = X0.canonical_axis_index(axis_);
+    const auto M = X0.size_to_dim(canonical_axis);
+    int64_t K = 0;
+    for (int i = 0; i < num_x; ++i) {
+      const auto& X = Input(i);
+      CAFFE_ENFORCE_EQ(
+          X.size_to_dim(X.canonical_axis_index(axis_)),
+          M,
+          "Dimension mismatch of X_",
+          i,
+          ": ",
+          X.sizes(),
+          " vs ",
+          X0.sizes());
+      K += X.size_from_dim(X.canonical_axis_index(axis_));
+    }
+    const auto canonical_axis_w = W.canonical_axis_index(axis_w_);
+    const auto N = W.size_to_dim(canonical_axis_w);
+    CAFFE_ENFORCE_EQ(
+        W.size_from_dim(canonical_axis_w),
+        K,
+        "Dimension mismatch: W: ",
+        W.sizes(),
+        ", K: ",
+        K);
+    CAFFE_ENFORCE_EQ(b.numel(), N, "Dimension mismatch: b: ", b.sizes());
+
+    Y_shape_cache_ = X0.sizes().vec();
+    Y_shape_cache_.resize(canonical_axis + 1);
+    Y_shape_cache_[canonical_axis] = N;
+    auto* Y = Output(0, Y_shape_cache_, at::dtype<float>());
+    float* Y_data = Y->template mutable_data<float>();
+    if (M == 0) {
+      return true;
+    }
+
+    const float* W_data = W.template data<float>();
+    int64_t k_offset = 0;
+    for (int i = 0; i < num_x; ++i) {
+      const auto& X = Input(i);
+      const auto K_i = X.size_from_dim(X.canonical_axis_index(axis_));
+      if (K_i == 0) {
+        continue;
+      }
+      math::GemmEx<float, CPUContext>(
+          CblasNoTrans,
+          CblasTrans,
+          M,
+          N,
+          K_i,
+          1.0f,
+          X.template data<float>(),
+          K_i,
+          W_data + k_offset,
+          K,
+          k_offset == 0 ? 0.0f : 1.0f,
+          Y_data,
+          N,
+          &context_);
+      k_offset += K_i;
+    }
+    if (k_offset == 0) {
+      math::Set<float, CPUContext>(M * N, 0.0f, Y_data, &context_);
+    }
+
+    EigenMatrixMap<float> Y_mat(Y_data, N, M);
+    ConstEigenVectorMap<float> b_vec(b.template data<float>(), N);
+    if (FuseRelu) {
+      Y_mat = (Y_mat.colwise() + b_vec).cwiseMax(0.0f);
+    } else {
+      Y_mat.colwise() += b_vec;
+    }
+    return true;
+  }
+
+ protected:
+  const int axis_;
+  const int axis_w_;
+  std::vector<int64_t> Y_shape_cache_;
+};
+
+} // namespace caffe2
+
+#endif // CAFFE2_OPERATORS_FUSED_FC_OPS_H_
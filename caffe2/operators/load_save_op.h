@@ -213,6 +213,7 @@ class LoadOp final : public Operator<Context> {
       int* total_loaded_blobs) {
     CAFFE_ENFORCE(cursor, "cursor is not valid");
     int loaded_blobs = 0;
+    load_save_op_util::BlobBatch batch;
     for (; cursor->Valid(); cursor->Next()) {
       const auto key = load_save_op_util::buildBlobNameFromDbKey(
           cursor->key(), strip_prefix_, add_prefix_);
@@ -222,21 +223,36 @@ class LoadOp final : public Operator<Context> {
         key_to_dbid_[key] = db_id;
       }
 
-      BlobProto proto;
-      CAFFE_ENFORCE(
-          proto.ParseFromString(cursor->value()), "Couldn't parse Proto");
-      if (!keep_device_) {
-        // If we are not keeping the device as the one specified in the
-        // proto, we will set the current device.
-        SetCurrentDevice(&proto);
+      batch.Add(key, cursor->value(), ws_->CreateBlob(key));
+      if (batch.Full()) {
+        processBatch(&batch, blob_states, &loaded_blobs);
       }
-      Blob* blob = ws_->CreateBlob(key);
-      load_save_op_util::ProcessBlob(
-          blob, proto, blob_states, key, &loaded_blobs);
     }
+    processBatch(&batch, blob_states, &loaded_blobs);
     *total_loaded_blobs += loaded_blobs;
   }
 
+  // Deserializes the records of the batch, in parallel for the CPU tensors
+  void processBatch(
+      load_save_op_util::BlobBatch* batch,
+      std::unordered_map<string, load_save_op_util::BlobState>* blob_states,
+      int* loaded_blobs) {
+    if (batch->empty()) {
+      return;
+    }
+    load_save_op_util::ProcessBlobs(
+        batch,
+        [this](BlobProto* proto) {
+          if (!keep_device_) {
+            // If we are not keeping the device as the one specified in the
+            // proto, we will set the current device.
+            SetCurrentDevice(proto);
+          }
+        },
+        blob_states,
+        loaded_blobs);
+  }
+
   void extractFrom(
       int db_id,
       Cursor* cursor,
@@ -245,6 +261,7 @@ class LoadOp final : public Operator<Context> {
       int* total_loaded_blobs) {
     CAFFE_ENFORCE(cursor);
     int loaded_blobs = 0;
+    load_save_op_util::BlobBatch batch;
     for (; cursor->Valid(); cursor->Next()) {
       const auto key = load_save_op_util::buildBlobNameFromDbKey(
           cursor->key(), strip_prefix_, add_prefix_);
@@ -258,23 +275,17 @@ class LoadOp final : public Operator<Context> {
         }
 
         VLOG(2) << "Deserializing blob " << key;
-        BlobProto proto;
-        CAFFE_ENFORCE(proto.ParseFromString(cursor->value()));
-        if (!keep_device_) {
-          // If we are not keeping the device as the one specified in the
-          // proto, we will set the current device.
-          SetCurrentDevice(&proto);
-        }
         auto blobIndex = output_indices_[key];
-        Blob* blob = outputs.at(blobIndex);
-        load_save_op_util::ProcessBlob(
-            blob, proto, blob_states, key, &loaded_blobs);
-
-        if (*total_loaded_blobs + loaded_blobs == OutputSize()) {
-          break;
+        batch.Add(key, cursor->value(), outputs.at(blobIndex));
+        if (batch.Full()) {
+          processBatch(&batch, blob_states, &loaded_blobs);
+          if (*total_loaded_blobs + loaded_blobs == OutputSize()) {
+            break;
+          }
         }
       }
     }
+    processBatch(&batch, blob_states, &loaded_blobs);
 
     *total_loaded_blobs += loaded_blobs;
   }
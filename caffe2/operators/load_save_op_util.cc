@@ -1,5 +1,9 @@
 #include "caffe2/operators/load_save_op_util.h"
 
+#include <algorithm>
+#include <atomic>
+#include <future>
+
 namespace caffe2 {
 namespace load_save_op_util {
 
@@ -18,22 +22,55 @@ std::string buildBlobNameFromDbKey(
   return key;
 }
 
-void ProcessBlob(
-    Blob* blob,
+namespace {
+
+// Bounds the memory held by the records of a batch and their parsed protos
+constexpr size_t kMaxBatchBytes = 256 << 20;
+
+int numThreads() {
+#ifdef __ANDROID__
+  // Since Android does not have std::future, we will always do sync mode
+  return 1;
+#else
+  return std::max(1, FLAGS_caffe2_max_tensor_deserializer_threads);
+#endif
+}
+
+// Runs f(0), ..., f(n - 1) on up to numThreads() threads
+void parallelFor(size_t n, const std::function<void(size_t)>& f) {
+  const size_t num_threads = std::min(static_cast<size_t>(numThreads()), n);
+  if (num_threads <= 1) {
+    for (size_t i = 0; i < n; ++i) {
+      f(i);
+    }
+    return;
+  }
+#ifndef __ANDROID__
+  std::atomic<size_t> next{0};
+  auto task = [&]() {
+    for (size_t i = next++; i < n; i = next++) {
+      f(i);
+    }
+  };
+  std::vector<std::future<void>> futures;
+  futures.reserve(num_threads - 1);
+  for (size_t i = 1; i < num_threads; ++i) {
+    futures.emplace_back(std::async(std::launch::async, task));
+  }
+  task();
+  for (auto& fut : futures) {
+    fut.get();
+  }
+#endif
+}
+
+// Tracks the part of the blob of key that proto holds, once deserialized
+void UpdateBlobState(
     const BlobProto& proto,
     std::unordered_map<std::string, BlobState>* blob_states_ptr,
     const std::string& key,
     int* loaded_blobs) {
   auto& blob_states = *blob_states_ptr;
-  if (blob_states.count(key) == 0) {
-    // We reset the blob so that any existing content is destroyed. This
-    // is to guaranee correct device placement: if we are deserializing
-    // into a TensorCUDA, without explicit Reset we might be loading data
-    // into an existing TensorCUDA that has pre-allocated memory on a
-    // different GPU.
-    blob->Reset();
-  }
-  DeserializeBlob(proto, blob);
   if (proto.has_content_num_chunks()) {
     if (!blob_states.count(key)) {
       blob_states[key] = BlobState(proto.content_num_chunks());
@@ -109,6 +146,85 @@ void ProcessBlob(
   }
 }
 
+} // namespace
+
+void ProcessBlob(
+    Blob* blob,
+    const BlobProto& proto,
+    std::unordered_map<std::string, BlobState>* blob_states_ptr,
+    const std::string& key,
+    int* loaded_blobs) {
+  auto& blob_states = *blob_states_ptr;
+  if (blob_states.count(key) == 0) {
+    // We reset the blob so that any existing content is destroyed. This
+    // is to guaranee correct device placement: if we are deserializing
+    // into a TensorCUDA, without explicit Reset we might be loading data
+    // into an existing TensorCUDA that has pre-allocated memory on a
+    // different GPU.
+    blob->Reset();
+  }
+  DeserializeBlob(proto, blob);
+  UpdateBlobState(proto, blob_states_ptr, key, loaded_blobs);
+}
+
+void BlobBatch::Add(const std::string& key, std::string value, Blob* blob) {
+  num_bytes += value.size();
+  keys.push_back(key);
+  values.push_back(std::move(value));
+  blobs.push_back(blob);
+}
+
+bool BlobBatch::Full() const {
+  return keys.size() >= static_cast<size_t>(4 * numThreads()) ||
+      num_bytes >= kMaxBatchBytes;
+}
+
+void BlobBatch::Clear() {
+  keys.clear();
+  values.clear();
+  blobs.clear();
+  num_bytes = 0;
+}
+
+void ProcessBlobs(
+    BlobBatch* batch,
+    const std::function<void(BlobProto*)>& prepare,
+    std::unordered_map<std::string, BlobState>* blob_states_ptr,
+    int* loaded_blobs) {
+  const size_t n = batch->keys.size();
+  std::vector<BlobProto> protos(n);
+  parallelFor(n, [&](size_t i) {
+    CAFFE_ENFORCE(
+        protos[i].ParseFromString(batch->values[i]), "Couldn't parse Proto");
+  });
+
+  // Tensors are allocated, and other blobs deserialized, in order of the
+  // records, so that only the disjoint chunks are filled in in parallel.
+  std::vector<Tensor*> tensors(n, nullptr);
+  for (size_t i = 0; i < n; ++i) {
+    BlobProto& proto = protos[i];
+    prepare(&proto);
+    const auto& key = batch->keys[i];
+    Blob* blob = batch->blobs[i];
+    if (proto.type() == kTensorBlobType &&
+        proto.tensor().device_detail().device_type() == PROTO_CPU) {
+      if (blob_states_ptr->count(key) == 0) {
+        blob->Reset();
+      }
+      tensors[i] = TensorDeserializer().AllocateTensor(proto.tensor(), blob);
+      UpdateBlobState(proto, blob_states_ptr, key, loaded_blobs);
+    } else {
+      ProcessBlob(blob, proto, blob_states_ptr, key, loaded_blobs);
+    }
+  }
+  parallelFor(n, [&](size_t i) {
+    if (tensors[i]) {
+      TensorDeserializer().DeserializeToTensor(protos[i].tensor(), tensors[i]);
+    }
+  });
+  batch->Clear();
+}
+
 void validateBlobStates(
     const std::unordered_map<std::string, BlobState>& blob_states) {
   for (const auto& iter : blob_states) {
@@ -1,9 +1,11 @@
 #ifndef CAFFE2_OPERATORS_LOAD_SAVE_OP_UTIL_H_
 #define CAFFE2_OPERATORS_LOAD_SAVE_OP_UTIL_H_
 
+#include <functional>
 #include <set>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "caffe2/core/blob.h"
 #include "caffe2/core/blob_serialization.h"
@@ -40,6 +42,32 @@ void ProcessBlob(
     const std::string& key,
     int* loaded_blobs);
 
+// Records read from a DB, which are deserialized together by ProcessBlobs
+struct BlobBatch {
+  std::vector<std::string> keys;
+  std::vector<std::string> values;
+  std::vector<Blob*> blobs;
+  size_t num_bytes = 0;
+
+  void Add(const std::string& key, std::string value, Blob* blob);
+  // Whether the batch should be processed before adding more records
+  bool Full() const;
+  bool empty() const {
+    return keys.empty();
+  }
+  void Clear();
+};
+
+// Same as ProcessBlob on each record of the batch, in order, after parsing it
+// and passing it to prepare. The parsing, and the deserialization of the
+// chunks of CPU tensors into their preallocated tensors, run on up to
+// caffe2_max_tensor_deserializer_threads threads. The batch is cleared.
+void ProcessBlobs(
+    BlobBatch* batch,
+    const std::function<void(BlobProto*)>& prepare,
+    std::unordered_map<std::string, BlobState>* blob_states_ptr,
+    int* loaded_blobs);
+
 void validateBlobStates(
     const std::unordered_map<std::string, BlobState>& blob_states);
 
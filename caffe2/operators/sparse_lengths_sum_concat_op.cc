@@ -0,0 +1,158 @@
+#include "caffe2/core/context.h"
+#include "caffe2/core/operator.h"
+#include "caffe2/perfkernels/embedding_lookup.h"
+
+namespace caffe2 {
+
+namespace {
+
+// SparseLengthsSum of several tables, concatenated along axis 1. Each pooled
+// row is written in place into its slice of the output, instead of into an
+// intermediate blob that Concat then copies.
+class SparseLengthsSumConcatOp final : public Operator<CPUContext> {
+ public:
+  USE_OPERATOR_FUNCTIONS(CPUContext);
+  template <class... Args>
+  explicit SparseLengthsSumConcatOp(Args&&... args)
+      : Operator<CPUContext>(std::forward<Args>(args)...),
+        add_axis_(this->template GetSingleArgument<int>("add_axis", 0)) {}
+
+  bool RunOnDevice() override {
+    const int num_tables = InputSize() / 3;
+    const auto& lengths0 = Input(LENGTHS);
+    CAFFE_ENFORCE_EQ(1, lengths0.dim(), "LENGTHS must be a vector");
+    const int64_t M = lengths0.size(0);
+
+    // The output shape is the one of Concat of the SparseLengthsSum outputs
+    const auto& data0 = Input(DATA);
+    CAFFE_ENFORCE_GE(data0.dim(), 2, "DATA must have at least 2 dims");
+    auto shape = data0.sizes().vec();
+    shape[0] = M;
+    int64_t row_size = 0;
+    for (int t = 0; t < num_tables; ++t) {
+      const auto& data = Input(3 * t + DATA);
+      const auto& lengths = Input(3 * t + LENGTHS);
+      CAFFE_ENFORCE_EQ(1, lengths.dim(), "LENGTHS must be a vector");
+      CAFFE_ENFORCE_EQ(M, lengths.size(0), "Tables have different batches");
+      CAFFE_ENFORCE_EQ(
+          data0.dim(), data.dim(), "Tables have different number of dims");
+      for (int i = add_axis_ ? 1 : 2; i < data.dim(); ++i) {
+        CAFFE_ENFORCE_EQ(
+            data0.size(i),
+            data.size(i),
+            "Tables have different dims: ",
+            data0.sizes(),
+            " vs ",
+            data.sizes());
+      }
+      if (t > 0 && !add_axis_) {
+        shape[1] += data.size(1);
+      }
+      row_size += data.size_from_dim(1);
+    }
+    if (add_axis_) {
+      shape.insert(shape.begin() + 1, num_tables);
+    }
+    auto* output = Output(0, shape, at::dtype<float>());
+    float* out_data = output->template mutable_data<float>();
+
+    int64_t offset = 0;
+    for (int t = 0; t < num_tables; ++t) {
+      const auto& data = Input(3 * t + DATA);
+      if (data.template IsType<float>()) {
+        LookupTable<float>(t, offset, row_size, out_data);
+      } else if (data.template IsType<at::Half>()) {
+        LookupTable<at::Half>(t, offset, row_size, out_data);
+      } else {
+        CAFFE_THROW("Unsupported type of DATA: ", data.dtype().name());
+      }
+      offset += data.size_from_dim(1);
+    }
+    return true;
+  }
+
+ private:
+  template <typename InputType>
+  void LookupTable(int t, int64_t offset, int64_t row_size, float* out) {
+    const auto& indices = Input(3 * t + INDICES);
+    if (indices.template IsType<int32_t>()) {
+      LookupTable<InputType, int32_t>(t, offset, row_size, out);
+    } else if (indices.template IsType<int64_t>()) {
+      LookupTable<InputType, int64_t>(t, offset, row_size, out);
+    } else {
+      CAFFE_THROW("Unsupported type of INDICES: ", indices.dtype().name());
+    }
+  }
+
+  // Pools the rows of table t into the columns [offset, offset + D) of out
+  template <typename InputType, typename IndexType>
+  void LookupTable(int t, int64_t offset, int64_t row_size, float* out) {
+    const auto& data = Input(3 * t + DATA);
+    const auto& indices = Input(3 * t + INDICES);
+    const auto& lengths = Input(3 * t + LENGTHS);
+    CAFFE_ENFORCE_EQ(1, indices.dim(), "INDICES must be a vector");
+    const int64_t N = data.size(0);
+    const int64_t D = data.size_from_dim(1);
+    const int64_t M = lengths.size(0);
+    const int64_t indices_size = indices.numel();
+
+    const InputType* in_data = data.template data<InputType>();
+    const IndexType* indices_data = indices.template data<IndexType>();
+    const int* lengths_data = lengths.template data<int>();
+
+    int64_t current = 0;
+    for (int64_t m = 0; m < M; ++m) {
+      CAFFE_ENFORCE(
+          lengths_data[m] >= 0 && current + lengths_data[m] <= indices_size,
+          "Your input seems to be incorrect: the sum of lengths values should "
+          "be the size of the indices tensor, but it appears not.");
+      EmbeddingLookup<IndexType, InputType, float>(
+          D,
+          1,
+          lengths_data[m],
+          N,
+          in_data,
+          indices_data + current,
+          lengths_data + m,
+          nullptr,
+          nullptr,
+          false,
+          out + m * row_size + offset);
+      current += lengths_data[m];
+    }
+    CAFFE_ENFORCE_EQ(
+        current,
+        indices_size,
+        "Your input seems to be incorrect: the sum of lengths values should be "
+        "the size of the indices tensor, but it appears not.");
+  }
+
+  enum { DATA = 0, INDICES = 1, LENGTHS = 2 };
+
+  const int add_axis_;
+};
+
+} // namespace
+
+REGISTER_CPU_OPERATOR(SparseLengthsSumConcat, SparseLengthsSumConcatOp);
+
+OPERATOR_SCHEMA(SparseLengthsSumConcat)
+    .NumInputs([](int n) { return n > 0 && n % 3 == 0; })
+    .NumOutputs(1)
+    .SetDoc(R"DOC(
+Same as SparseLengthsSum of each of the tables (DATA_t, INDICES_t, LENGTHS_t),
+followed by Concat of the results along axis 1, without the intermediate
+results: the pooled rows are written in place into the output. The tables must
+have the same number of segments. Inserted by the inference fusion passes of
+caffe2/opt.
+)DOC")
+    .Arg(
+        "add_axis",
+        "*(type: int; default: 0)* As in Concat, stack the results along a new "
+        "axis 1 instead of concatenating them.")
+    .Input(0, "DATA_1, INDICES_1, LENGTHS_1, ...", "The inputs of SparseLengthsSum, for each table.")
+    .Output(0, "OUTPUT", "The concatenated pooled rows of the tables.");
+
+SHOULD_NOT_DO_GRADIENT(SparseLengthsSumConcat);
+
+} // namespace caffe2
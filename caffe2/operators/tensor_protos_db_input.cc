@@ -19,6 +19,14 @@ corresponding index in the TensorProtos objects in the DB.
   .Arg("batch_size", "(int, default 0) the number of samples in a batch. The "
        "default value of 0 means that the operator will attempt to insert the "
        "entire data in a single output blob.")
+  .Arg("decode_threads", "(int, default 0) if positive, the items are read "
+       "ahead of the operator and parsed on this many threads, so that the "
+       "reads and the parsing of different items overlap.")
+  .Arg("decode_queue_size", "(int, default 2 * batch_size) the number of "
+       "items read ahead when decode_threads is positive.")
+  .Arg("decode_ordered", "(bool, default true) whether the items read ahead "
+       "are returned in the order of the db. Otherwise, they are returned as "
+       "soon as they are parsed.")
   .Input(0, "data", "A pre-initialized DB reader. Typically, this is obtained "
          "by calling CreateDB operator with a db_name and a db_type. The "
          "resulting output blob is a DB Reader tensor")
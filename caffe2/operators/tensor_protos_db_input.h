@@ -1,10 +1,12 @@
 #ifndef CAFFE2_OPERATORS_TENSOR_PROTOS_DB_INPUT_H_
 #define CAFFE2_OPERATORS_TENSOR_PROTOS_DB_INPUT_H_
 
+#include <algorithm>
 #include <iostream>
 #include <mutex>
 
 #include "caffe2/core/db.h"
+#include "caffe2/core/prefetching_db_reader.h"
 #include "caffe2/operators/prefetch_op.h"
 
 namespace caffe2 {
@@ -23,12 +25,22 @@ class TensorProtosDBInput final : public PrefetchOperator<Context> {
   bool CopyPrefetched() override;
 
  private:
+  // Reads the next item of the db and returns one tensor per output
+  vector<Tensor> ReadItem(const db::DBReader& reader);
+  static vector<Tensor> DecodeItem(const string& value, int num_outputs);
+
   // Prefetch will always just happen on the CPU side.
   vector<Blob> prefetched_blobs_;
   int batch_size_;
   bool shape_inferred_ = false;
   string key_;
   string value_;
+  // If positive, the items are read and decoded ahead on this many threads
+  int decode_threads_;
+  int decode_queue_size_;
+  bool decode_ordered_;
+  const db::DBReader* prefetching_source_ = nullptr;
+  std::unique_ptr<db::PrefetchingDBReader<vector<Tensor>>> prefetching_reader_;
 };
 
 template <class Context>
@@ -38,45 +50,81 @@ TensorProtosDBInput<Context>::TensorProtosDBInput(
     : PrefetchOperator<Context>(operator_def, ws),
       prefetched_blobs_(operator_def.output_size()),
       batch_size_(
-          this->template GetSingleArgument<int>("batch_size", 0)) {}
+          this->template GetSingleArgument<int>("batch_size", 0)),
+      decode_threads_(
+          this->template GetSingleArgument<int>("decode_threads", 0)),
+      decode_queue_size_(this->template GetSingleArgument<int>(
+          "decode_queue_size",
+          2 * std::max(batch_size_, 1))),
+      decode_ordered_(
+          this->template GetSingleArgument<bool>("decode_ordered", true)) {
+  CAFFE_ENFORCE_GE(decode_threads_, 0);
+}
+
+template <class Context>
+vector<Tensor> TensorProtosDBInput<Context>::DecodeItem(
+    const string& value,
+    int num_outputs) {
+  TensorProtos protos;
+  CAFFE_ENFORCE(protos.ParseFromString(value));
+  CAFFE_ENFORCE(protos.protos_size() == num_outputs);
+  TensorDeserializer deserializer;
+  vector<Tensor> tensors;
+  tensors.reserve(num_outputs);
+  for (int i = 0; i < protos.protos_size(); ++i) {
+    if (protos.protos(i).has_device_detail()) {
+      protos.mutable_protos(i)->clear_device_detail();
+    }
+    tensors.push_back(deserializer.Deserialize(protos.protos(i)));
+  }
+  return tensors;
+}
+
+template <class Context>
+vector<Tensor> TensorProtosDBInput<Context>::ReadItem(
+    const db::DBReader& reader) {
+  if (decode_threads_ == 0) {
+    reader.Read(&key_, &value_);
+    return DecodeItem(value_, OutputSize());
+  }
+  // The reader lives in the input blob, which is only filled in once the op
+  // runs, so the prefetching reader is created on the first read
+  if (prefetching_source_ != &reader) {
+    prefetching_reader_.reset();
+    const int num_outputs = OutputSize();
+    prefetching_reader_ =
+        caffe2::make_unique<db::PrefetchingDBReader<vector<Tensor>>>(
+            &reader,
+            [num_outputs](const string& /*key*/, const string& value) {
+              return DecodeItem(value, num_outputs);
+            },
+            decode_threads_,
+            decode_queue_size_,
+            decode_ordered_);
+    prefetching_source_ = &reader;
+  }
+  return prefetching_reader_->Next();
+}
 
 template <class Context>
 bool TensorProtosDBInput<Context>::Prefetch() {
   const db::DBReader& reader = this->template Input<db::DBReader>(0);
-  TensorDeserializer deserializer;
   if (batch_size_ == 0) {
     // We do not need to construct a batch. As a result, we will simply
     // deserialize everything into the target prefetched blob.
-    reader.Read(&key_, &value_);
-    TensorProtos protos;
-    CAFFE_ENFORCE(protos.ParseFromString(value_));
-    CAFFE_ENFORCE(protos.protos_size() == OutputSize());
-    for (int i = 0; i < protos.protos_size(); ++i) {
-      if (protos.protos(i).has_device_detail()) {
-        protos.mutable_protos(i)->clear_device_detail();
-      }
-      BlobSetTensor(
-          &prefetched_blobs_[i], deserializer.Deserialize(protos.protos(i)));
-      // deserializer.Deserialize(
-      //     protos.protos(i), BlobGetMutableTensor(&prefetched_blobs_[i],
-      //     CPU));
+    vector<Tensor> tensors = ReadItem(reader);
+    for (size_t i = 0; i < tensors.size(); ++i) {
+      BlobSetTensor(&prefetched_blobs_[i], std::move(tensors[i]));
     }
   } else {
     for (int item_id = 0; item_id < batch_size_; ++item_id) {
-      reader.Read(&key_, &value_);
-      TensorProtos protos;
-      CAFFE_ENFORCE(protos.ParseFromString(value_));
-      CAFFE_ENFORCE(protos.protos_size() == OutputSize());
+      vector<Tensor> tensors = ReadItem(reader);
       // Note: shape_inferred_ is ignored, we'll always get dimensions from
       // proto
-      for (int i = 0; i < protos.protos_size(); ++i) {
-        vector<int64_t> dims(
-            protos.protos(i).dims().begin(), protos.protos(i).dims().end());
+      for (size_t i = 0; i < tensors.size(); ++i) {
+        const Tensor& src = tensors[i];
+        vector<int64_t> dims = src.sizes().vec();
         dims.insert(dims.begin(), batch_size_);
-        if (protos.protos(i).has_device_detail()) {
-          protos.mutable_protos(i)->clear_device_detail();
-        }
-        Tensor src = deserializer.Deserialize(protos.protos(i));
         Tensor* dst = BlobGetMutableTensor(
             &prefetched_blobs_[i], dims, at::dtype(src.dtype()).device(CPU));
         DCHECK_EQ(src.numel() * batch_size_, dst->numel());
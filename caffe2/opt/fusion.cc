@@ -1,7 +1,13 @@
 #include "caffe2/opt/fusion.h"
+
+#include <unordered_set>
+
 #include "caffe2/core/logging.h"
+#include "caffe2/core/operator.h"
+#include "caffe2/operators/fused_elementwise_op.h"
 #include "caffe2/opt/converter.h"
 #include "caffe2/opt/passes.h"
+#include "caffe2/utils/proto_utils.h"
 
 namespace caffe2 {
 namespace opt {
@@ -121,5 +127,300 @@ void fuseConvBN(nom::repr::NNModule* nn, caffe2::Workspace* ws) {
 
 REGISTER_WS_OPT_PASS_FROM_FUNC(FuseConvBN, fuseConvBN);
 
+namespace {
+
+// Returns the OperatorDef of an operator node, if it runs with the default
+// engine on CPU, which is where the fused ops are
+const caffe2::OperatorDef* getCPUOperatorDef(repr::NNGraph::NodeRef node) {
+  NOM_REQUIRE_OR_RET_NULL(repr::nn::is<repr::NeuralNetOperator>(node));
+  auto annotation =
+      repr::nn::get<repr::NeuralNetOperator>(node)->getMutableAnnotation();
+  NOM_REQUIRE_OR_RET_NULL(annotation && isa<Caffe2Annotation>(annotation));
+  auto c2_annotation = dyn_cast<Caffe2Annotation>(annotation);
+  NOM_REQUIRE_OR_RET_NULL(c2_annotation->hasOperatorDef());
+  NOM_REQUIRE_OR_RET_NULL(
+      c2_annotation->getDeviceType() == caffe2::PROTO_CPU);
+  const auto& op = c2_annotation->getOperatorDef();
+  NOM_REQUIRE_OR_RET_NULL(op.engine().empty());
+  return &op;
+}
+
+bool isCPUOperator(repr::NNGraph::NodeRef node, const std::string& type) {
+  const auto* op = getCPUOperatorDef(node);
+  return op && op->type() == type;
+}
+
+// Whether a tensor can be dropped once its consumer is fused with its producer
+bool isOnlyConsumedBy(
+    repr::NNModule* nn,
+    repr::NNGraph::NodeRef tensor,
+    repr::NNGraph::NodeRef consumer) {
+  const auto consumers = repr::nn::getConsumers(tensor);
+  return consumers.size() == 1 && consumers.front() == consumer &&
+      !nn->outputs.count(tensor);
+}
+
+bool isUnused(repr::NNModule* nn, repr::NNGraph::NodeRef tensor) {
+  return repr::nn::getConsumers(tensor).empty() && !nn->outputs.count(tensor);
+}
+
+// Concat along axis 1, which is the axis that the fused ops concatenate
+bool isConcatOnAxis1(const caffe2::OperatorDef& op) {
+  ArgumentHelper helper(op);
+  const int axis = helper.HasArgument("axis")
+      ? helper.GetSingleArgument<int>("axis", -1)
+      : (helper.GetSingleArgument<std::string>("order", "NCHW") == "NHWC" ? 3
+                                                                          : 1);
+  return axis == 1;
+}
+
+bool isFloatFC(const caffe2::OperatorDef& op) {
+  return op.type() == "FC" &&
+      !ArgumentHelper(op).GetSingleArgument<bool>("float16_compute", false);
+}
+
+// Creates the node of a fused op, to be connected by the caller
+repr::NNGraph::NodeRef createFusedNode(
+    repr::NNModule* nn,
+    const caffe2::OperatorDef& like,
+    const std::string& type) {
+  caffe2::OperatorDef op;
+  op.set_type(type);
+  op.set_name(like.name());
+  op.mutable_device_option()->CopyFrom(like.device_option());
+  return nn->dataFlow.createNode(convertToNeuralNetOperator(op));
+}
+
+// Builds that select their ops may not have the fused ones
+bool isRegistered(const std::string& type) {
+  return caffe2::CPUOperatorRegistry()->Has(type);
+}
+
+caffe2::OperatorDef* getMutableOperatorDef(repr::NNGraph::NodeRef node) {
+  auto annotation =
+      repr::nn::get<repr::NeuralNetOperator>(node)->getMutableAnnotation();
+  return dyn_cast<Caffe2Annotation>(annotation)->getMutableOperatorDef();
+}
+
+} // namespace
+
+void fuseFCRelu(repr::NNModule* nn) {
+  NOM_REQUIRE_OR_RET(isRegistered("FCRelu"));
+  // fuseActivation drops the output of FC, which therefore must only be read
+  // by the Relu
+  std::unordered_set<const repr::FC*> fusable;
+  for (auto node_pair : repr::nn::dataIterator<repr::FC>(nn->dataFlow)) {
+    repr::NNGraph::NodeRef fc_node;
+    repr::FC* fc;
+    std::tie(fc, fc_node) = node_pair;
+    const auto* op = getCPUOperatorDef(fc_node);
+    NOM_REQUIRE_OR_CONT(op && isFloatFC(*op));
+    const auto outputs = repr::nn::getOutputs(fc_node);
+    NOM_REQUIRE_OR_CONT(outputs.size() == 1);
+    const auto consumers = repr::nn::getConsumers(outputs.front());
+    NOM_REQUIRE_OR_CONT(consumers.size() == 1);
+    NOM_REQUIRE_OR_CONT(isOnlyConsumedBy(nn, outputs.front(), consumers[0]));
+    NOM_REQUIRE_OR_CONT(isCPUOperator(consumers.front(), "Relu"));
+    fusable.insert(fc);
+  }
+
+  auto should_fuse = [&fusable](const repr::FC& fc) {
+    return fusable.count(&fc) > 0;
+  };
+  auto postprocess = [](repr::NNGraph::NodeRef fc_node) {
+    getMutableOperatorDef(fc_node)->set_type("FCRelu");
+  };
+  fuseActivation<repr::FC, repr::Relu>(nn, should_fuse, postprocess);
+}
+
+void fuseConcatFC(repr::NNModule* nn) {
+  NOM_REQUIRE_OR_RET(isRegistered("ConcatFC"));
+  std::vector<repr::NNGraph::NodeRef> fc_nodes;
+  for (auto node_pair : repr::nn::dataIterator<repr::FC>(nn->dataFlow)) {
+    fc_nodes.push_back(node_pair.second);
+  }
+  for (auto fc_node : fc_nodes) {
+    const auto* fc_op = getCPUOperatorDef(fc_node);
+    NOM_REQUIRE_OR_CONT(fc_op && isFloatFC(*fc_op));
+    NOM_REQUIRE_OR_CONT(
+        ArgumentHelper(*fc_op).GetSingleArgument<int>("axis", 1) == 1);
+    const auto fc_inputs = repr::nn::getInputs(fc_node);
+    const auto fc_outputs = repr::nn::getOutputs(fc_node);
+    NOM_REQUIRE_OR_CONT(fc_inputs.size() == 3 && fc_outputs.size() == 1);
+
+    const auto x = fc_inputs.front();
+    NOM_REQUIRE_OR_CONT(repr::nn::hasProducer(x));
+    NOM_REQUIRE_OR_CONT(isOnlyConsumedBy(nn, x, fc_node));
+    const auto concat_node = repr::nn::getProducer(x);
+    const auto* concat_op = getCPUOperatorDef(concat_node);
+    NOM_REQUIRE_OR_CONT(concat_op && concat_op->type() == "Concat");
+    NOM_REQUIRE_OR_CONT(isConcatOnAxis1(*concat_op));
+    NOM_REQUIRE_OR_CONT(
+        !ArgumentHelper(*concat_op).GetSingleArgument<int>("add_axis", 0));
+    // The split info must not be used
+    const auto concat_outputs = repr::nn::getOutputs(concat_node);
+    bool split_info_used = false;
+    for (const auto output : concat_outputs) {
+      split_info_used |= output != x && !isUnused(nn, output);
+    }
+    NOM_REQUIRE_OR_CONT(!split_info_used);
+    const auto concat_inputs = repr::nn::getInputs(concat_node);
+
+    // ConcatFC(X_1, ..., X_k, W, b), with the args of FC
+    auto node = createFusedNode(nn, *fc_op, "ConcatFC");
+    getMutableOperatorDef(node)->mutable_arg()->CopyFrom(fc_op->arg());
+    for (const auto input : concat_inputs) {
+      nn->dataFlow.createEdge(input, node);
+    }
+    nn->dataFlow.createEdge(fc_inputs[1], node);
+    nn->dataFlow.createEdge(fc_inputs[2], node);
+    nn->dataFlow.deleteNode(fc_node);
+    nn->dataFlow.createEdge(node, fc_outputs.front());
+    for (const auto output : concat_outputs) {
+      nn->dataFlow.deleteNode(output);
+    }
+    nn->dataFlow.deleteNode(concat_node);
+  }
+}
+
+void fuseSparseLengthsSumConcat(repr::NNModule* nn) {
+  NOM_REQUIRE_OR_RET(isRegistered("SparseLengthsSumConcat"));
+  std::vector<repr::NNGraph::NodeRef> concat_nodes;
+  for (auto node : nn->dataFlow.getMutableNodes()) {
+    if (isCPUOperator(node, "Concat")) {
+      concat_nodes.push_back(node);
+    }
+  }
+  for (auto concat_node : concat_nodes) {
+    const auto* concat_op = getCPUOperatorDef(concat_node);
+    NOM_REQUIRE_OR_CONT(isConcatOnAxis1(*concat_op));
+    const auto concat_inputs = repr::nn::getInputs(concat_node);
+    const auto concat_outputs = repr::nn::getOutputs(concat_node);
+    NOM_REQUIRE_OR_CONT(concat_inputs.size() >= 2 && !concat_outputs.empty());
+
+    // Every input must be the output of a SparseLengthsSum that nothing else
+    // reads
+    std::vector<repr::NNGraph::NodeRef> sls_nodes;
+    for (const auto input : concat_inputs) {
+      NOM_REQUIRE_OR_BREAK(repr::nn::hasProducer(input));
+      NOM_REQUIRE_OR_BREAK(isOnlyConsumedBy(nn, input, concat_node));
+      const auto producer = repr::nn::getProducer(input);
+      NOM_REQUIRE_OR_BREAK(isCPUOperator(producer, "SparseLengthsSum"));
+      NOM_REQUIRE_OR_BREAK(repr::nn::getInputs(producer).size() == 3);
+      NOM_REQUIRE_OR_BREAK(repr::nn::getOutputs(producer).size() == 1);
+      sls_nodes.push_back(producer);
+    }
+    NOM_REQUIRE_OR_CONT(sls_nodes.size() == concat_inputs.size());
+    bool split_info_used = false;
+    for (size_t i = 1; i < concat_outputs.size(); ++i) {
+      split_info_used |= !isUnused(nn, concat_outputs[i]);
+    }
+    NOM_REQUIRE_OR_CONT(!split_info_used);
+
+    // SparseLengthsSumConcat(DATA_1, INDICES_1, LENGTHS_1, ...)
+    auto node = createFusedNode(nn, *concat_op, "SparseLengthsSumConcat");
+    const int add_axis =
+        ArgumentHelper(*concat_op).GetSingleArgument<int>("add_axis", 0);
+    if (add_axis) {
+      AddArgument("add_axis", add_axis, getMutableOperatorDef(node));
+    }
+    for (const auto sls_node : sls_nodes) {
+      for (const auto input : repr::nn::getInputs(sls_node)) {
+        nn->dataFlow.createEdge(input, node);
+      }
+    }
+    nn->dataFlow.deleteNode(concat_node);
+    nn->dataFlow.createEdge(node, concat_outputs.front());
+    for (size_t i = 1; i < concat_outputs.size(); ++i) {
+      nn->dataFlow.deleteNode(concat_outputs[i]);
+    }
+    for (size_t i = 0; i < sls_nodes.size(); ++i) {
+      nn->dataFlow.deleteNode(concat_inputs[i]);
+      nn->dataFlow.deleteNode(sls_nodes[i]);
+    }
+  }
+}
+
+void fuseElementwiseChains(repr::NNModule* nn) {
+  NOM_REQUIRE_OR_RET(isRegistered("FusedElementwise"));
+  const auto& supported_ops = FusedElementwiseOp::SupportedOps();
+  const std::unordered_set<std::string> supported(
+      supported_ops.begin(), supported_ops.end());
+  auto is_fusable = [&supported](repr::NNGraph::NodeRef node) {
+    const auto* op = getCPUOperatorDef(node);
+    return op && supported.count(op->type()) &&
+        repr::nn::getInputs(node).size() == 1 &&
+        repr::nn::getOutputs(node).size() == 1;
+  };
+  // The op following a fusable op in its chain, if any
+  auto next = [nn, &is_fusable](
+                  repr::NNGraph::NodeRef node) -> repr::NNGraph::NodeRef {
+    const auto output = repr::nn::getOutputs(node).front();
+    const auto consumers = repr::nn::getConsumers(output);
+    NOM_REQUIRE_OR_RET_NULL(consumers.size() == 1);
+    NOM_REQUIRE_OR_RET_NULL(isOnlyConsumedBy(nn, output, consumers.front()));
+    NOM_REQUIRE_OR_RET_NULL(is_fusable(consumers.front()));
+    return consumers.front();
+  };
+
+  // Collect the chains first, from the ops that don't follow another one
+  std::vector<std::vector<repr::NNGraph::NodeRef>> chains;
+  for (auto node : nn->dataFlow.getMutableNodes()) {
+    NOM_REQUIRE_OR_CONT(is_fusable(node));
+    const auto input = repr::nn::getInputs(node).front();
+    if (repr::nn::hasProducer(input)) {
+      const auto producer = repr::nn::getProducer(input);
+      NOM_REQUIRE_OR_CONT(!is_fusable(producer) || next(producer) != node);
+    }
+    std::vector<repr::NNGraph::NodeRef> chain{node};
+    while (auto following = next(chain.back())) {
+      chain.push_back(following);
+    }
+    if (chain.size() > 1) {
+      chains.push_back(std::move(chain));
+    }
+  }
+
+  for (const auto& chain : chains) {
+    const auto* first_op = getCPUOperatorDef(chain.front());
+    auto node = createFusedNode(nn, *first_op, "FusedElementwise");
+    std::vector<std::string> ops;
+    for (const auto op_node : chain) {
+      ops.push_back(getCPUOperatorDef(op_node)->type());
+    }
+    AddArgument("ops", ops, getMutableOperatorDef(node));
+
+    const auto input = repr::nn::getInputs(chain.front()).front();
+    const auto output = repr::nn::getOutputs(chain.back()).front();
+    std::vector<repr::NNGraph::NodeRef> intermediates;
+    for (size_t i = 0; i + 1 < chain.size(); ++i) {
+      intermediates.push_back(repr::nn::getOutputs(chain[i]).front());
+    }
+    for (const auto op_node : chain) {
+      nn->dataFlow.deleteNode(op_node);
+    }
+    for (const auto tensor : intermediates) {
+      nn->dataFlow.deleteNode(tensor);
+    }
+    nn->dataFlow.createEdge(input, node);
+    nn->dataFlow.createEdge(node, output);
+  }
+}
+
+void fuseForInference(repr::NNModule* nn) {
+  fuseSparseLengthsSumConcat(nn);
+  fuseConcatFC(nn);
+  fuseFCRelu(nn);
+  fuseElementwiseChains(nn);
+}
+
+REGISTER_OPT_PASS_FROM_FUNC(FuseFCRelu, fuseFCRelu);
+REGISTER_OPT_PASS_FROM_FUNC(FuseConcatFC, fuseConcatFC);
+REGISTER_OPT_PASS_FROM_FUNC(
+    FuseSparseLengthsSumConcat,
+    fuseSparseLengthsSumConcat);
+REGISTER_OPT_PASS_FROM_FUNC(FuseElementwiseChains, fuseElementwiseChains);
+REGISTER_OPT_PASS_FROM_FUNC(FuseForInference, fuseForInference);
+
 } // namespace opt
 } // namespace caffe2
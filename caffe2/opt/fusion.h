@@ -27,6 +27,21 @@ using namespace nom;
 
 CAFFE2_API void fuseConvBN(repr::NNModule* nn, caffe2::Workspace* ws);
 
+// Fusions of common patterns of inference nets into the fused CPU ops of
+// caffe2/operators. Only the ops of the default engine on CPU are fused, and
+// the intermediate blobs must not be external outputs.
+
+// FC followed by Relu into FCRelu
+CAFFE2_API void fuseFCRelu(repr::NNModule* nn);
+// Concat along axis 1 followed by FC into ConcatFC
+CAFFE2_API void fuseConcatFC(repr::NNModule* nn);
+// Concat along axis 1 of SparseLengthsSum outputs into SparseLengthsSumConcat
+CAFFE2_API void fuseSparseLengthsSumConcat(repr::NNModule* nn);
+// Chains of unary elementwise ops into FusedElementwise
+CAFFE2_API void fuseElementwiseChains(repr::NNModule* nn);
+// All of the above
+CAFFE2_API void fuseForInference(repr::NNModule* nn);
+
 // Generic activation fusion helper.
 //
 // \tparam OperationT The operator to be fused.
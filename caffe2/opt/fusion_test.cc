@@ -0,0 +1,190 @@
+#include "caffe2/core/common.h"
+#include "caffe2/core/workspace.h"
+#include "caffe2/opt/converter.h"
+#include "caffe2/opt/fusion.h"
+
+#include <gtest/gtest.h>
+
+#define ADD_ARG(_op, _name, _type, _val)    \
+  {                                         \
+    caffe2::Argument* arg = _op->add_arg(); \
+    arg->set_name(_name);                   \
+    arg->set_##_type(_val);                 \
+  }
+
+namespace {
+
+caffe2::OperatorDef* addOp(
+    caffe2::NetDef* net,
+    const std::string& type,
+    const std::vector<std::string>& inputs,
+    const std::vector<std::string>& outputs) {
+  caffe2::OperatorDef* def = net->add_op();
+  def->set_type(type);
+  for (const auto& input : inputs) {
+    def->add_input(input);
+  }
+  for (const auto& output : outputs) {
+    def->add_output(output);
+  }
+  return def;
+}
+
+template <typename T>
+void fillTensor(
+    caffe2::Workspace* ws,
+    const std::string& name,
+    const std::vector<int64_t>& dims,
+    const std::vector<T>& values) {
+  auto* tensor = BlobGetMutableTensor(ws->CreateBlob(name), caffe2::CPU);
+  tensor->Resize(dims);
+  T* data = tensor->template mutable_data<T>();
+  for (int64_t i = 0; i < tensor->numel(); ++i) {
+    data[i] = values[i % values.size()];
+  }
+}
+
+void fillFloats(
+    caffe2::Workspace* ws,
+    const std::string& name,
+    const std::vector<int64_t>& dims) {
+  fillTensor<float>(
+      ws, name, dims, {0.5f, -1.25f, 2.0f, -0.75f, 1.5f, 0.25f, -2.5f});
+}
+
+// Runs net, and then net with the inference fusions applied, on the inputs
+// set up by fill. Returns the fused net after checking that both produce the
+// same output.
+caffe2::NetDef runFused(
+    const caffe2::NetDef& net,
+    const std::function<void(caffe2::Workspace*)>& fill,
+    const std::string& output) {
+  auto nn = caffe2::convertToNNModule(net);
+  caffe2::opt::fuseForInference(&nn);
+  auto fused_net = caffe2::convertToCaffe2Proto(nn, net);
+
+  caffe2::Workspace ws;
+  fill(&ws);
+  EXPECT_TRUE(ws.RunNetOnce(net));
+  caffe2::Workspace fused_ws;
+  fill(&fused_ws);
+  EXPECT_TRUE(fused_ws.RunNetOnce(fused_net));
+
+  const auto& expected = ws.GetBlob(output)->Get<caffe2::TensorCPU>();
+  const auto& actual = fused_ws.GetBlob(output)->Get<caffe2::TensorCPU>();
+  EXPECT_EQ(expected.sizes(), actual.sizes());
+  for (int64_t i = 0; i < expected.numel(); ++i) {
+    EXPECT_NEAR(expected.data<float>()[i], actual.data<float>()[i], 1e-5f);
+  }
+  return fused_net;
+}
+
+} // namespace
+
+TEST(FusionTest, FCRelu) {
+  caffe2::NetDef net;
+  addOp(&net, "FC", {"X", "W", "b"}, {"Y"});
+  addOp(&net, "Relu", {"Y"}, {"Z"});
+  net.add_external_input("X");
+  net.add_external_input("W");
+  net.add_external_input("b");
+  net.add_external_output("Z");
+
+  auto fused_net = runFused(
+      net,
+      [](caffe2::Workspace* ws) {
+        fillFloats(ws, "X", {4, 5});
+        fillFloats(ws, "W", {3, 5});
+        fillFloats(ws, "b", {3});
+      },
+      "Z");
+  ASSERT_EQ(fused_net.op().size(), 1);
+  EXPECT_EQ(fused_net.op(0).type(), "FCRelu");
+  EXPECT_EQ(fused_net.op(0).output(0), "Z");
+}
+
+TEST(FusionTest, FCReluExternalOutput) {
+  caffe2::NetDef net;
+  addOp(&net, "FC", {"X", "W", "b"}, {"Y"});
+  addOp(&net, "Relu", {"Y"}, {"Z"});
+  net.add_external_input("X");
+  net.add_external_input("W");
+  net.add_external_input("b");
+  net.add_external_output("Y");
+  net.add_external_output("Z");
+
+  auto nn = caffe2::convertToNNModule(net);
+  caffe2::opt::fuseForInference(&nn);
+  auto fused_net = caffe2::convertToCaffe2Proto(nn, net);
+  EXPECT_EQ(fused_net.op().size(), 2);
+}
+
+TEST(FusionTest, ConcatFC) {
+  caffe2::NetDef net;
+  auto* concat = addOp(&net, "Concat", {"X1", "X2"}, {"X", "split_info"});
+  ADD_ARG(concat, "axis", i, 1);
+  addOp(&net, "FC", {"X", "W", "b"}, {"Y"});
+  net.add_external_input("X1");
+  net.add_external_input("X2");
+  net.add_external_input("W");
+  net.add_external_input("b");
+  net.add_external_output("Y");
+
+  auto fused_net = runFused(
+      net,
+      [](caffe2::Workspace* ws) {
+        fillFloats(ws, "X1", {4, 2});
+        fillFloats(ws, "X2", {4, 3});
+        fillFloats(ws, "W", {6, 5});
+        fillFloats(ws, "b", {6});
+      },
+      "Y");
+  ASSERT_EQ(fused_net.op().size(), 1);
+  EXPECT_EQ(fused_net.op(0).type(), "ConcatFC");
+  EXPECT_EQ(fused_net.op(0).input().size(), 4);
+}
+
+TEST(FusionTest, SparseLengthsSumConcat) {
+  caffe2::NetDef net;
+  addOp(&net, "SparseLengthsSum", {"D1", "I1", "L1"}, {"P1"});
+  addOp(&net, "SparseLengthsSum", {"D2", "I2", "L2"}, {"P2"});
+  auto* concat = addOp(&net, "Concat", {"P1", "P2"}, {"P", "split_info"});
+  ADD_ARG(concat, "axis", i, 1);
+  for (const auto& name : {"D1", "I1", "L1", "D2", "I2", "L2"}) {
+    net.add_external_input(name);
+  }
+  net.add_external_output("P");
+
+  auto fused_net = runFused(
+      net,
+      [](caffe2::Workspace* ws) {
+        fillFloats(ws, "D1", {5, 3});
+        fillTensor<int32_t>(ws, "I1", {6}, {4, 0, 2, 1, 3, 1});
+        fillTensor<int32_t>(ws, "L1", {3}, {2, 3, 1});
+        fillFloats(ws, "D2", {4, 2});
+        fillTensor<int64_t>(ws, "I2", {4}, {3, 0, 0, 2});
+        fillTensor<int32_t>(ws, "L2", {3}, {0, 1, 3});
+      },
+      "P");
+  ASSERT_EQ(fused_net.op().size(), 1);
+  EXPECT_EQ(fused_net.op(0).type(), "SparseLengthsSumConcat");
+  EXPECT_EQ(fused_net.op(0).input().size(), 6);
+}
+
+TEST(FusionTest, ElementwiseChain) {
+  caffe2::NetDef net;
+  addOp(&net, "Sigmoid", {"X"}, {"A"});
+  addOp(&net, "Tanh", {"A"}, {"B"});
+  addOp(&net, "Relu", {"B"}, {"Y"});
+  net.add_external_input("X");
+  net.add_external_output("Y");
+
+  auto fused_net = runFused(
+      net,
+      [](caffe2::Workspace* ws) { fillFloats(ws, "X", {3, 1500}); },
+      "Y");
+  ASSERT_EQ(fused_net.op().size(), 1);
+  EXPECT_EQ(fused_net.op(0).type(), "FusedElementwise");
+  EXPECT_EQ(fused_net.op(0).input(0), "X");
+  EXPECT_EQ(fused_net.op(0).output(0), "Y");
+}
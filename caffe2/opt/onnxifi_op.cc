@@ -198,6 +198,24 @@ OnnxifiOp<CPUContext>::buildInitializationList(
   return descs;
 }
 
+template <>
+void OnnxifiOp<CPUContext>::selectBackendGraph() {
+  current_graph_ = backend_graphs_.size() - 1;
+  if (current_graph_ == 0 || InputSize() == 0) {
+    return;
+  }
+  const auto& t = Input(nominal_batch_idx_);
+  if (t.sizes().empty()) {
+    return;
+  }
+  for (size_t i = 0; i + 1 < backend_graphs_.size(); ++i) {
+    if (t.size(0) <= backend_graphs_[i].batch_size) {
+      current_graph_ = i;
+      return;
+    }
+  }
+}
+
 template <>
 void OnnxifiOp<CPUContext>::extractOutputBatchSizes() {
   output_reshape_info_.skip = false;
@@ -206,15 +224,15 @@ void OnnxifiOp<CPUContext>::extractOutputBatchSizes() {
     return;
   }
 
-  // Get the real batch size from nominal input. If it's equal to
-  // max_batch_size, mark that we don't need to adjust batch size and return.
+  // Get the real batch size from nominal input. If it's equal to the batch
+  // size of the graph, mark that we don't need to adjust batch size and return.
   // Otherwise, do a pass of shape inference to get the real shapes of the
   // outputs.
   const auto& t = Input(nominal_batch_idx_);
   const auto dims = t.sizes();
   CAFFE_ENFORCE(
       !t.sizes().empty(), input_names_[nominal_batch_idx_], " cannot be empty");
-  if (dims[0] == max_batch_size_) {
+  if (dims[0] == backend_graphs_[current_graph_].batch_size) {
     output_reshape_info_.skip = true;
     return;
   }
@@ -301,6 +319,8 @@ void OnnxifiOp<CPUContext>::maybeAdjustOutputBatchSizes() {
 
 template <>
 bool OnnxifiOp<CPUContext>::RunOnDevice() {
+  selectBackendGraph();
+  const auto& backend_graph = backend_graphs_[current_graph_];
   CAFFE_ENFORCE_EQ(input_desc_.size(), InputSize());
   for (unsigned i = 0U; i < InputSize(); ++i) {
     const auto& input_tensor = Input(i);
@@ -375,7 +395,7 @@ bool OnnxifiOp<CPUContext>::RunOnDevice() {
     }
     CAFFE_ENFORCE_EQ(
         (*onnxSetIOAndRunGraphPointer_)(
-            graph_,
+            backend_graph.graph,
             input_desc_.size(),
             input_desc_.data(),
             output_desc_.size(),
@@ -393,7 +413,7 @@ bool OnnxifiOp<CPUContext>::RunOnDevice() {
   if (!ext_supported) {
     CAFFE_ENFORCE_EQ(
         lib_->onnxSetGraphIO(
-            graph_,
+            backend_graph.graph,
             input_desc_.size(),
             input_desc_.data(),
             output_desc_.size(),
@@ -403,7 +423,7 @@ bool OnnxifiOp<CPUContext>::RunOnDevice() {
     input_fence.tag = ONNXIFI_TAG_MEMORY_FENCE_V1;
     input_fence.type = ONNXIFI_SYNCHRONIZATION_EVENT;
     CAFFE_ENFORCE_EQ(
-        lib_->onnxInitEvent(backend_, &input_fence.event),
+        lib_->onnxInitEvent(backend_graph.backend, &input_fence.event),
         ONNXIFI_STATUS_SUCCESS);
     output_fence.tag = ONNXIFI_TAG_MEMORY_FENCE_V1;
     output_fence.type = ONNXIFI_SYNCHRONIZATION_EVENT;
@@ -411,7 +431,7 @@ bool OnnxifiOp<CPUContext>::RunOnDevice() {
     // Call the async run on backend, signal event on input fence and wait for
     // the event on output fence
     CAFFE_ENFORCE_EQ(
-        lib_->onnxRunGraph(graph_, &input_fence, &output_fence),
+        lib_->onnxRunGraph(backend_graph.graph, &input_fence, &output_fence),
         ONNXIFI_STATUS_SUCCESS);
     CAFFE_ENFORCE_EQ(
         lib_->onnxSignalEvent(input_fence.event), ONNXIFI_STATUS_SUCCESS);
@@ -446,6 +466,9 @@ OPERATOR_SCHEMA(Onnxifi)
     .Arg(
         "initializers",
         "Initialization pair indicating the mapping of the name between NetDef and ONNX model")
+    .Arg(
+        "batch_size_buckets",
+        "Increasing batch sizes below max_batch_size, for which the model is also compiled from onnx_model_bucket_<batch size>. A run uses the graph of the smallest batch size that fits its nominal input")
     .Arg(
         "output_resize_hints",
         "A list of key/value pairs indicating which input index to look up for real batch size for the given max output batch size");
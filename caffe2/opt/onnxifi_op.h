@@ -33,6 +33,18 @@ class OnnxifiOp final : public Operator<Context> {
     bool skip{false};
   };
 
+  // A backend graph compiled for inputs of at most batch_size rows
+  struct BackendGraph {
+    int batch_size{0};
+    // key of the graph in the backend graph map
+    std::string key;
+    onnxBackend backend{nullptr};
+    onnxGraph graph{nullptr};
+    onnx::SharedPtrBackendGraphInfo info;
+    // output shape hints of the graph, by output index
+    std::unordered_map<int, TensorInfo> output_shape_hints;
+  };
+
  public:
   USE_OPERATOR_CONTEXT_FUNCTIONS;
   explicit OnnxifiOp(const OperatorDef& operator_def, Workspace* ws)
@@ -64,30 +76,29 @@ class OnnxifiOp final : public Operator<Context> {
       input_desc_.push_back(onnxTensorDescriptorV1());
       input_desc_.back().name = input.c_str();
     }
-    all_offsets_.reserve(ws->Blobs().size());
-    all_scales_.reserve(ws->Blobs().size());
+    // Smaller batch sizes for which the graph is also compiled
+    const auto batch_size_buckets =
+        this->template GetRepeatedArgument<int>("batch_size_buckets");
+    // Each graph adds the quantization params of the weights, which the
+    // backend may point to, so they must never be reallocated
+    all_offsets_.reserve((batch_size_buckets.size() + 1) * ws->Blobs().size());
+    all_scales_.reserve((batch_size_buckets.size() + 1) * ws->Blobs().size());
     input_shapes_.resize(input_names_.size());
     output_shapes_.resize(output_names_.size());
     output_reshape_info_.begins.reserve(output_names_.size());
     output_reshape_info_.ends.reserve(output_names_.size());
     output_reshape_info_.fast_path.reserve(output_names_.size());
+    // For output, we try to get its output size hint
+    auto output_shape_hints = getOutputShapeHints("output_shape_hint_");
     int output_idx = 0;
     for (const auto& output : output_names_) {
       output_desc_.push_back(onnxTensorDescriptorV1());
       output_desc_.back().name = output.c_str();
 
-      // For output, we try to get its output size hint
       int64_t num_dims = 0;
-      const std::string key = c10::str("output_shape_hint_", output_idx);
-      auto output_shape_hint = this->template GetRepeatedArgument<int>(key);
-      if (!output_shape_hint.empty()) {
-        TensorInfo info;
-        info.onnxifi_type = output_shape_hint.front();
-        for (size_t i = 1; i < output_shape_hint.size(); ++i) {
-          info.dims.push_back(output_shape_hint[i]);
-        }
-        num_dims = info.dims.size();
-        output_shape_hints_.emplace(output_idx, std::move(info));
+      const auto it = output_shape_hints.find(output_idx);
+      if (it != output_shape_hints.end()) {
+        num_dims = it->second.dims.size();
       }
 
       // Initialize the tensors used to slice the output
@@ -121,12 +132,50 @@ class OnnxifiOp final : public Operator<Context> {
     // Subsequent call of this function with the same model id should find a
     // cached backend and therefore there is no need to repeat the above
     // process.
-    buildBackendAndGraph(ws, property_pointers, onnx_model_str);
+    op_id_string_ =
+        this->template GetSingleArgument<std::string>("model_id", "") + ":" +
+        this->template GetSingleArgument<std::string>("net_pos", "");
+    // The graphs are sorted by batch size, the one of the max batch size last
+    int last_batch_size = 0;
+    for (const auto batch_size : batch_size_buckets) {
+      CAFFE_ENFORCE(
+          batch_size > last_batch_size && batch_size < max_batch_size_,
+          "batch_size_buckets should be increasing and below max_batch_size ",
+          max_batch_size_);
+      last_batch_size = batch_size;
+      BackendGraph backend_graph;
+      backend_graph.batch_size = batch_size;
+      backend_graph.key = c10::str(op_id_string_, ":bucket_", batch_size);
+      backend_graph.output_shape_hints = getOutputShapeHints(
+          c10::str("output_shape_hint_bucket_", batch_size, "_"));
+      auto model_str = this->template GetSingleArgument<std::string>(
+          c10::str("onnx_model_bucket_", batch_size), "");
+      CAFFE_ENFORCE(
+          !model_str.empty(),
+          "onnx_model_bucket_",
+          batch_size,
+          " cannot be empty");
+      buildBackendAndGraph(ws, property_pointers, model_str, &backend_graph);
+      backend_graphs_.push_back(std::move(backend_graph));
+    }
+    BackendGraph backend_graph;
+    backend_graph.batch_size = max_batch_size_;
+    backend_graph.key = op_id_string_;
+    backend_graph.output_shape_hints = std::move(output_shape_hints);
+    buildBackendAndGraph(ws, property_pointers, onnx_model_str, &backend_graph);
+    backend_id_ = backend_graph.info->backend_id;
+    input_shape_info_ = backend_graph.info->weight_shape_info;
+    backend_graphs_.push_back(std::move(backend_graph));
+    current_graph_ = backend_graphs_.size() - 1;
+
+    getExtFunctionPointers();
   }
 
   ~OnnxifiOp() {
-    backend_graph_shared_ptr_.reset();
-    backend_graph_map_ptr_->remove(op_id_string_);
+    for (auto& backend_graph : backend_graphs_) {
+      backend_graph.info.reset();
+      backend_graph_map_ptr_->remove(backend_graph.key);
+    }
 #ifdef ONNXIFI_ENABLE_EXT
     traces_.reset();
 #endif
@@ -144,10 +193,32 @@ class OnnxifiOp final : public Operator<Context> {
   }
 #endif
  private:
+  // Parses the arguments `prefix`<output index> into output shape hints
+  std::unordered_map<int, TensorInfo> getOutputShapeHints(
+      const std::string& prefix) {
+    std::unordered_map<int, TensorInfo> hints;
+    for (int output_idx = 0; output_idx < static_cast<int>(output_names_.size());
+         ++output_idx) {
+      auto output_shape_hint = this->template GetRepeatedArgument<int>(
+          c10::str(prefix, output_idx));
+      if (!output_shape_hint.empty()) {
+        TensorInfo info;
+        info.onnxifi_type = output_shape_hint.front();
+        for (size_t i = 1; i < output_shape_hint.size(); ++i) {
+          info.dims.push_back(output_shape_hint[i]);
+        }
+        hints.emplace(output_idx, std::move(info));
+      }
+    }
+    return hints;
+  }
+
   uint64_t SetOutputShapeAndType(int output_idx, std::vector<size_t>* dims) {
     uint64_t type = ONNXIFI_DATATYPE_FLOAT32;
-    const auto it = output_shape_hints_.find(output_idx);
-    if (it != output_shape_hints_.end()) {
+    const auto& output_shape_hints =
+        backend_graphs_[current_graph_].output_shape_hints;
+    const auto it = output_shape_hints.find(output_idx);
+    if (it != output_shape_hints.end()) {
       std::copy(
           it->second.dims.begin(),
           it->second.dims.end(),
@@ -168,11 +239,8 @@ class OnnxifiOp final : public Operator<Context> {
   void buildBackendAndGraph(
       Workspace* ws,
       const std::vector<uint64_t>& property_pointers,
-      const std::string& onnx_model_str) {
-    op_id_string_ =
-        this->template GetSingleArgument<std::string>("model_id", "") + ":" +
-        this->template GetSingleArgument<std::string>("net_pos", "");
-
+      const std::string& onnx_model_str,
+      BackendGraph* backend_graph) {
     auto initializers =
         this->template GetRepeatedArgument<std::string>("initializers");
     // Build the Onnxifi engine
@@ -262,15 +330,10 @@ class OnnxifiOp final : public Operator<Context> {
       return std::make_shared<onnx::BackendGraphInfo>(
           backend_id, backend, graph, lib_, std::move(weight_shape_info));
     };
-    backend_graph_shared_ptr_ =
-        backend_graph_map_ptr_->insert(op_id_string_, creator);
-
-    backend_id_ = backend_graph_shared_ptr_->backend_id;
-    backend_ = backend_graph_shared_ptr_->backend;
-    graph_ = backend_graph_shared_ptr_->graph;
-    input_shape_info_ = backend_graph_shared_ptr_->weight_shape_info;
-
-    getExtFunctionPointers();
+    backend_graph->info =
+        backend_graph_map_ptr_->insert(backend_graph->key, creator);
+    backend_graph->backend = backend_graph->info->backend;
+    backend_graph->graph = backend_graph->info->graph;
   }
 
   /// Set up function pointer if onnxifi_ext is enabled
@@ -296,6 +359,9 @@ class OnnxifiOp final : public Operator<Context> {
 #endif
   }
 
+  // Picks the graph of the smallest batch size that fits the inputs
+  void selectBackendGraph();
+
   void extractOutputBatchSizes();
 
   // If needed, adjust output tensor shape based on the real input batch size.
@@ -320,9 +386,10 @@ class OnnxifiOp final : public Operator<Context> {
   std::string op_id_string_;
 
   onnxBackendID backend_id_{nullptr};
-  onnxBackend backend_{nullptr};
-  onnxGraph graph_{nullptr};
-  onnx::SharedPtrBackendGraphInfo backend_graph_shared_ptr_;
+  // The graphs compiled for the batch size buckets, then for max_batch_size
+  std::vector<BackendGraph> backend_graphs_;
+  // The graph of the current run
+  size_t current_graph_{0};
 
   // input/output descriptors
   std::vector<onnxTensorDescriptorV1> input_desc_;
@@ -381,9 +448,6 @@ class OnnxifiOp final : public Operator<Context> {
   std::vector<std::vector<float>> all_scales_;
   std::vector<std::vector<int32_t>> all_offsets_;
 
-  // output shape hints
-  std::unordered_map<int, TensorInfo> output_shape_hints_;
-
   // input shape info. Used by shape inference when inputs are not at
   // max_batch_size
   std::unordered_map<std::string, ShapeInfo> input_shape_info_;
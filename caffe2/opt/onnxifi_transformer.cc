@@ -1,5 +1,6 @@
 #include "caffe2/opt/onnxifi_transformer.h"
 
+#include <algorithm>
 #include <iostream>
 #include <unordered_set>
 
@@ -195,6 +196,19 @@ int64_t getBlob1stDimSize(const ShapeInfo& shape_info) {
   }
 }
 
+// Add an output shape hint, which is the onnxifi type followed by the dims
+void addOutputShapeHint(
+    const std::string& name,
+    const TensorShape& shape,
+    OperatorDef* op) {
+  auto* output_shape_hint_arg = op->add_arg();
+  output_shape_hint_arg->set_name(name);
+  output_shape_hint_arg->add_ints(onnxifiDataType(shape.data_type()));
+  for (const auto& d : shape.dims()) {
+    output_shape_hint_arg->add_ints(d);
+  }
+}
+
 NetDef composeResultNet(const OperatorDef& onnxifi_op) {
   NetDef net_opt;
   net_opt.add_op()->CopyFrom(onnxifi_op);
@@ -290,13 +304,8 @@ OperatorDef OnnxifiTransformer::buildOnnxifiOp(
     const auto& o = op.output(i);
     const auto it = output_shape_hints.find(o);
     if (it != output_shape_hints.end()) {
-      const auto& shape = it->second;
-      auto* output_shape_hint_arg = op.add_arg();
-      output_shape_hint_arg->set_name(c10::str("output_shape_hint_", i));
-      output_shape_hint_arg->add_ints(onnxifiDataType(shape.data_type()));
-      for (const auto& d : shape.dims()) {
-        output_shape_hint_arg->add_ints(d);
-      }
+      addOutputShapeHint(
+          c10::str("output_shape_hint_", i), it->second, &op);
 
       VLOG(2) << "Adding output hint: " << o;
     }
@@ -325,6 +334,27 @@ OperatorDef OnnxifiTransformer::buildOnnxifiOp(
   return op;
 }
 
+// Add the shape info of the inputs of the c2 net passed to the backend
+void OnnxifiTransformer::addInputShapeInfo(
+    const std::vector<std::string>& inputs,
+    const ShapeInfoMap& shape_hints,
+    NetDef* net) {
+  auto* shape_arg = net->add_arg();
+  auto* qshape_arg = net->add_arg();
+  shape_arg->set_name("input_shape_info");
+  qshape_arg->set_name("input_qshape_info");
+  for (const auto& i : inputs) {
+    const auto& info = shape_hints.at(i);
+    if (!info.is_quantized) {
+      shape_arg->mutable_tensors()->Add()->CopyFrom(
+          wrapShapeInfoIntoTensorProto(i, info));
+    } else {
+      qshape_arg->mutable_qtensors()->Add()->CopyFrom(
+          wrapShapeInfoIntoQTensorProto(i, info));
+    }
+  }
+}
+
 NetDef OnnxifiTransformer::SubnetToOnnxifiOpViaC2(
     const caffe2::NetDef& net,
     const std::unordered_set<std::string>& weights_in_ws,
@@ -369,22 +399,13 @@ NetDef OnnxifiTransformer::SubnetToOnnxifiOpViaC2(
       std::vector<std::string>(),
       &initialization_list,
       &total_inputs_vec);
-  auto* shape_arg = onnxifi_net.add_arg();
-  auto* qshape_arg = onnxifi_net.add_arg();
-  shape_arg->set_name("input_shape_info");
-  qshape_arg->set_name("input_qshape_info");
   onnxifi_net.clear_external_input();
   for (const auto& i : total_inputs_vec) {
     onnxifi_net.add_external_input(i);
-    auto info = shape_hints.at(i);
-    if (!info.is_quantized) {
-      shape_arg->mutable_tensors()->Add()->CopyFrom(
-          wrapShapeInfoIntoTensorProto(i, shape_hints.at(i)));
-    } else {
-      qshape_arg->mutable_qtensors()->Add()->CopyFrom(
-          wrapShapeInfoIntoQTensorProto(i, shape_hints.at(i)));
-    }
   }
+  // The nets of the batch size buckets only differ by their input shape info
+  const NetDef bucket_net_base(onnxifi_net);
+  addInputShapeInfo(total_inputs_vec, shape_hints, &onnxifi_net);
 
   // Compute output shape hints
   std::unordered_map<std::string, TensorShape> output_shape_hints;
@@ -411,6 +432,35 @@ NetDef OnnxifiTransformer::SubnetToOnnxifiOpViaC2(
       onnxifi_net_inputs,
       onnxifi_net_outputs,
       shape_hints);
+
+  // Pass the net again for each batch size bucket, with the shapes inferred
+  // for that batch size
+  if (!bucket_shape_hints_.empty()) {
+    auto* buckets_arg = onnxifi_op.add_arg();
+    buckets_arg->set_name("batch_size_buckets");
+    for (const auto& kv : bucket_shape_hints_) {
+      const int batch_size = kv.first;
+      const auto& bucket_shape_hints = kv.second;
+      buckets_arg->add_ints(batch_size);
+      NetDef bucket_net(bucket_net_base);
+      addInputShapeInfo(total_inputs_vec, bucket_shape_hints, &bucket_net);
+      std::string bucket_model_str;
+      bucket_net.SerializeToString(&bucket_model_str);
+      AddArgument(
+          c10::str("onnx_model_bucket_", batch_size),
+          bucket_model_str,
+          &onnxifi_op);
+      for (int i = 0; i < onnxifi_op.output_size(); ++i) {
+        const auto it = bucket_shape_hints.find(onnxifi_op.output(i));
+        if (it != bucket_shape_hints.end()) {
+          addOutputShapeHint(
+              c10::str("output_shape_hint_bucket_", batch_size, "_", i),
+              it->second.shape,
+              &onnxifi_op);
+        }
+      }
+    }
+  }
   NetDef net_opt = composeResultNet(onnxifi_op);
 
   // Debugging stuff
@@ -847,6 +897,40 @@ NetDef OnnxifiTransformer::TransformViaOnnx(
       *pred_net, onnx_supports, onnx_converter, opts_.debug);
 }
 
+void OnnxifiTransformer::inferBucketShapes(
+    Workspace* ws,
+    NetDef* pred_net,
+    const std::unordered_map<std::string, TensorShape>& shape_hints_mapped) {
+  const auto max_batch_size = opts_.bound_shape_spec.max_batch_size;
+  std::vector<int> batch_sizes(
+      opts_.batch_size_buckets.begin(), opts_.batch_size_buckets.end());
+  std::sort(batch_sizes.begin(), batch_sizes.end());
+  batch_sizes.erase(
+      std::unique(batch_sizes.begin(), batch_sizes.end()), batch_sizes.end());
+  for (const auto batch_size : batch_sizes) {
+    CAFFE_ENFORCE(
+        batch_size > 0 && batch_size < max_batch_size,
+        "Batch size bucket ",
+        batch_size,
+        " should be positive and below max_batch_size ",
+        max_batch_size);
+    // The hinted inputs of max batch size get the batch size of the bucket
+    auto bucket_hints = shape_hints_mapped;
+    for (auto& kv : bucket_hints) {
+      if (kv.second.dims_size() > 0 && kv.second.dims(0) == max_batch_size) {
+        kv.second.set_dims(0, batch_size);
+      }
+    }
+    bucket_shape_hints_.emplace(
+        batch_size,
+        inferShapes(
+            ws,
+            pred_net,
+            bucket_hints,
+            BoundShapeSpec(batch_size, opts_.bound_shape_spec.max_seq_size)));
+  }
+}
+
 // Cutting off the runnable part and replace with ONNXIFI ops. Asssume the nets
 // were topologically sorted
 void OnnxifiTransformer::transform(
@@ -885,6 +969,10 @@ void OnnxifiTransformer::transform(
   if (opts_.use_onnx) {
     shape_hints_onnx_ = stripShapeInfoMap(shape_hints);
   }
+  bucket_shape_hints_.clear();
+  if (!opts_.use_onnx && !opts_.batch_size_buckets.empty()) {
+    inferBucketShapes(&mapped_ws, pred_net, shape_hints_mapped);
+  }
 
   if (opts_.debug) {
     dumpNet(*pred_net, shape_hints, "debug_ssa_net.pb_txt");
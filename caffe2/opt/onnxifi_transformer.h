@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cstdint>
+#include <map>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -24,6 +25,11 @@ struct OnnxifiTransformerOptions final : public BackendTransformOptions {
 
   // Whether to adjust batch at the ouptuts or not
   bool adjust_batch{true};
+
+  // Batch sizes below max_batch_size for which the Onnxifi ops also compile
+  // their subgraph, so that small batches don't run the graph of the max batch
+  // size. Only used when passing c2 model
+  std::vector<int> batch_size_buckets;
 };
 
 class CAFFE2_API OnnxifiTransformer final : public BackendTransformerBase {
@@ -51,6 +57,12 @@ class CAFFE2_API OnnxifiTransformer final : public BackendTransformerBase {
       onnx::OnnxExporter* exporter,
       ShapeInfoMap* shape_hints);
 
+  // Add the shape info of the inputs of a c2 net passed to the backend
+  void addInputShapeInfo(
+      const std::vector<std::string>& inputs,
+      const ShapeInfoMap& shape_hints,
+      NetDef* net);
+
   // Convert a cutoff subgraph net to an Onnxifi op
   caffe2::NetDef SubnetToOnnxifiOpViaC2(
       const caffe2::NetDef& net,
@@ -112,6 +124,12 @@ class CAFFE2_API OnnxifiTransformer final : public BackendTransformerBase {
   // Determine backend id
   void getBackendId();
 
+  // Infer the shapes of the net for each of the batch size buckets
+  void inferBucketShapes(
+      Workspace* ws,
+      NetDef* pred_net,
+      const std::unordered_map<std::string, TensorShape>& shape_hints_mapped);
+
   // Options
   OnnxifiTransformerOptions opts_;
 
@@ -135,5 +153,8 @@ class CAFFE2_API OnnxifiTransformer final : public BackendTransformerBase {
 
   // A cache for ONNX shape hints
   std::unordered_map<std::string, TensorShape> shape_hints_onnx_;
+
+  // Shape info of the net for each batch size bucket, by batch size
+  std::map<int, ShapeInfoMap> bucket_shape_hints_;
 };
 } // namespace caffe2
@@ -30,9 +30,23 @@ void graphOptimzations(nom::repr::NNModule* nn, int level) {
   }
 }
 
+// The fused ops of these passes only run on CPU
+void cpuGraphOptimizations(nom::repr::NNModule* nn, int level) {
+  switch (level) {
+    case 1:
+      opt::fuseForInference(nn);
+    case 0:
+    default:
+      break;
+  }
+}
+
 NetDef optimize(NetDef net, Workspace* ws, int level) {
   auto nn = convertToNNModule(net);
   graphOptimzations(&nn, level);
+  if (net.device_option().device_type() == PROTO_CPU) {
+    cpuGraphOptimizations(&nn, level);
+  }
   workspaceOptimizations(&nn, ws, level);
   return convertToCaffe2Proto(nn, net);
 }
@@ -40,6 +54,9 @@ NetDef optimize(NetDef net, Workspace* ws, int level) {
 NetDef optimize(NetDef net, int level) {
   auto nn = convertToNNModule(net);
   graphOptimzations(&nn, level);
+  if (net.device_option().device_type() == PROTO_CPU) {
+    cpuGraphOptimizations(&nn, level);
+  }
   return convertToCaffe2Proto(nn, net);
 }
 
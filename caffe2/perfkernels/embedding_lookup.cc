@@ -1,5 +1,6 @@
 #include "caffe2/perfkernels/embedding_lookup.h"
 
+#include <c10/util/BFloat16.h>
 #include "caffe2/core/types.h"
 #include "caffe2/perfkernels/common.h"
 
@@ -105,6 +106,9 @@ static bool EmbeddingLookupGenericSlow(
   decltype(                                                                                        \
       EmbeddingLookup_##IndexType##_##InTypeName##_##OutType##_##IS_WEIGHT_POSITIONAL##__base)     \
       EmbeddingLookup_##IndexType##_##InTypeName##_##OutType##_##IS_WEIGHT_POSITIONAL##__avx2_fma; \
+  decltype(                                                                                        \
+      EmbeddingLookup_##IndexType##_##InTypeName##_##OutType##_##IS_WEIGHT_POSITIONAL##__base)     \
+      EmbeddingLookup_##IndexType##_##InTypeName##_##OutType##_##IS_WEIGHT_POSITIONAL##__avx512;   \
   bool                                                                                             \
       EmbeddingLookup_##IndexType##_##InTypeName##_##OutType##_##IS_WEIGHT_POSITIONAL(             \
           const int64_t block_size,                                                                \
@@ -123,6 +127,19 @@ static bool EmbeddingLookupGenericSlow(
     } else {                                                                                       \
       CAFFE_ENFORCE(scale_bias == nullptr, "scale_bias must be nullptr");                          \
     }                                                                                              \
+    AVX512_DO(                                                                                     \
+        EmbeddingLookup_##IndexType##_##InTypeName##_##OutType##_##IS_WEIGHT_POSITIONAL,           \
+        block_size,                                                                                \
+        output_size,                                                                               \
+        index_size,                                                                                \
+        data_size,                                                                                 \
+        input,                                                                                     \
+        indices,                                                                                   \
+        lengths,                                                                                   \
+        weights,                                                                                   \
+        scale_bias,                                                                                \
+        normalize_by_lengths,                                                                      \
+        out);                                                                                      \
     AVX2_FMA_DO(                                                                                   \
         EmbeddingLookup_##IndexType##_##InTypeName##_##OutType##_##IS_WEIGHT_POSITIONAL,           \
         block_size,                                                                                \
@@ -206,6 +223,8 @@ EMBEDDING_SPECIALIZATION(int32_t, float, float, float, false);
 EMBEDDING_SPECIALIZATION(int64_t, float, float, float, false);
 EMBEDDING_SPECIALIZATION(int32_t, half, at::Half, float, false);
 EMBEDDING_SPECIALIZATION(int64_t, half, at::Half, float, false);
+EMBEDDING_SPECIALIZATION(int32_t, bfloat16, at::BFloat16, float, false);
+EMBEDDING_SPECIALIZATION(int64_t, bfloat16, at::BFloat16, float, false);
 EMBEDDING_SPECIALIZATION(int32_t, uint8_t, uint8_t, float, false);
 EMBEDDING_SPECIALIZATION(int64_t, uint8_t, uint8_t, float, false);
 
@@ -213,6 +232,8 @@ EMBEDDING_SPECIALIZATION(int32_t, float, float, float, true);
 EMBEDDING_SPECIALIZATION(int64_t, float, float, float, true);
 EMBEDDING_SPECIALIZATION(int32_t, half, at::Half, float, true);
 EMBEDDING_SPECIALIZATION(int64_t, half, at::Half, float, true);
+EMBEDDING_SPECIALIZATION(int32_t, bfloat16, at::BFloat16, float, true);
+EMBEDDING_SPECIALIZATION(int64_t, bfloat16, at::BFloat16, float, true);
 EMBEDDING_SPECIALIZATION(int32_t, uint8_t, uint8_t, float, true);
 EMBEDDING_SPECIALIZATION(int64_t, uint8_t, uint8_t, float, true);
 
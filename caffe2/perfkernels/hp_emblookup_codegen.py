@@ -4,14 +4,70 @@ import argparse
 import sys
 
 
-sizeof = {"float": 4, "at::Half": 2, "uint8_t": 1}
+sizeof = {"float": 4, "at::Half": 2, "at::BFloat16": 2, "uint8_t": 1}
+
+# vector type, intrinsic prefix and number of floats of a register, and the
+# suffix of the generated functions
+isa_info = {
+    "avx2": ("__m256", "_mm256", 8, "__avx2_fma"),
+    "avx512": ("__m512", "_mm512", 16, "__avx512"),
+}
+
+
+def load_ps(InType, isa, addr, indent):
+    """Loads a register of floats from InType, for the types and ISAs whose
+    code is not spelled out in compute()"""
+    vec, pfx, vlen, _ = isa_info[isa]
+    # the narrow loads read vlen elements of InType
+    narrow = {16: ("_mm_loadu_si128", "__m128i"), 32: ("_mm256_loadu_si256", "__m256i")}
+    if InType == "float":
+        return "{}_loadu_ps({})".format(pfx, addr)
+    elif InType == "at::Half":
+        load, ptr = narrow[2 * vlen]
+        return (
+            "{pfx}_cvtph_ps(\n"
+            "{i}    {load}(reinterpret_cast<const {ptr}*>({addr})))"
+        ).format(pfx=pfx, load=load, ptr=ptr, addr=addr, i=indent)
+    elif InType == "at::BFloat16":
+        # a bfloat16 is the high half of the bits of a float
+        load, ptr = narrow[2 * vlen]
+        return (
+            "{pfx}_castsi{bits}_ps({pfx}_slli_epi32(\n"
+            "{i}    {pfx}_cvtepu16_epi32({load}(\n"
+            "{i}        reinterpret_cast<const {ptr}*>({addr}))),\n"
+            "{i}    16))"
+        ).format(
+            pfx=pfx, bits=32 * vlen, load=load, ptr=ptr, addr=addr, i=indent
+        )
+    elif InType == "uint8_t":
+        assert isa == "avx512"
+        return (
+            "{pfx}_cvtepi32_ps({pfx}_cvtepu8_epi32(\n"
+            "{i}    _mm_loadu_si128(reinterpret_cast<const __m128i*>({addr}))))"
+        ).format(pfx=pfx, addr=addr, i=indent)
+    else:
+        assert False
 
 
 def unroll(uf, IndexType, InType, OutType, use_weights, isa, fused, use_offsets):
+    vec, pfx, vlen, _ = isa_info[isa]
+
     def compute(regid, InType, use_weights, isa, prefetch):
         code = []
 
-        if InType == "float":
+        if isa == "avx512" or InType == "at::BFloat16":
+            vin = load_ps(InType, isa, "ip + (%d)" % regid, "            ")
+            if InType == "uint8_t":
+                vacc = "%s_add_ps(vop%d, vbio)" % (pfx, regid)
+            else:
+                vacc = "vop%d" % regid
+            code.append(
+                "        vop%d = %s_fmadd_ps(\n"
+                "            vwgt,\n"
+                "            %s,\n"
+                "            %s);" % (regid, pfx, vin, vacc)
+            )
+        elif InType == "float":
             code.append(
                 "        vop%d = _mm256_fmadd_ps(vwgt, _mm256_loadu_ps(ip + (%d)), vop%d);"  # noqa
                 % (regid, regid, regid)
@@ -57,8 +113,8 @@ def unroll(uf, IndexType, InType, OutType, use_weights, isa, fused, use_offsets)
     )
     code.append("      " + OutType + "* op = &out[rangeIndex * block_size];")
     for i in range(0, uf):
-        j = 8 * i
-        code.append("      __m256 vop" + str(j) + " = _mm256_setzero_ps();")
+        j = vlen * i
+        code.append("      {} vop{} = {}_setzero_ps();".format(vec, j, pfx))
 
     # inner loop
     if use_offsets:
@@ -113,7 +169,7 @@ def unroll(uf, IndexType, InType, OutType, use_weights, isa, fused, use_offsets)
         else:
             code.append("        bio = wgt * scale_bias[2 * idx + 1];")
             code.append("        wgt = wgt * scale_bias[2 * idx];")
-        code.append("        __m256 vbio = _mm256_set1_ps(bio);")
+        code.append("        {} vbio = {}_set1_ps(bio);".format(vec, pfx))
     else:
         code.append("        " + OutType + " wgt = 1.f;")
         code.append("        if (weights) {")
@@ -121,7 +177,7 @@ def unroll(uf, IndexType, InType, OutType, use_weights, isa, fused, use_offsets)
             "          wgt = weights[IS_WEIGHT_POSITIONAL ? (dataInd - start) : dataInd];"  # noqa
         )
         code.append("        }")
-    code.append("        __m256 vwgt = _mm256_set1_ps(wgt);")
+    code.append("        {} vwgt = {}_set1_ps(wgt);".format(vec, pfx))
 
     code.append("        const {}* ip = &input[idx * fused_block_size];".format(InType))
     code.append(
@@ -143,7 +199,7 @@ def unroll(uf, IndexType, InType, OutType, use_weights, isa, fused, use_offsets)
     )
 
     for i in range(0, uf):
-        j = 8 * i
+        j = vlen * i
         cachelinesize = 64
         byteoffset = sizeof[InType] * j
         prefetch = (byteoffset % cachelinesize) == 0
@@ -155,23 +211,26 @@ def unroll(uf, IndexType, InType, OutType, use_weights, isa, fused, use_offsets)
     else:
         code.append("      if (!normalize_by_lengths || lengths[rangeIndex] == 0) {")
     for i in range(0, uf):
-        j = 8 * i
-        code.append("        _mm256_storeu_ps(&op[" + str(j) + "], vop" + str(j) + ");")
+        j = vlen * i
+        code.append("        {}_storeu_ps(&op[{}], vop{});".format(pfx, j, j))
     code.append("      } else {")
     # inv of length
     if use_offsets:
-        code.append("        __m256 vlen_inv = _mm256_set1_ps(1.0f / length);")
+        code.append(
+            "        {} vlen_inv = {}_set1_ps(1.0f / length);".format(vec, pfx)
+        )
     else:
-        code.append("        __m256 vlen_inv = _mm256_set1_ps(1.0f / lengths[rangeIndex]);")
+        code.append(
+            "        {} vlen_inv = {}_set1_ps(1.0f / lengths[rangeIndex]);".format(
+                vec, pfx
+            )
+        )
     for i in range(0, uf):
-        j = 8 * i
+        j = vlen * i
         code.append(
-            "        _mm256_storeu_ps(&op["
-            + str(j)
-            + "], _mm256_mul_ps("
-            + "vop"
-            + str(j)
-            + ", vlen_inv));"
+            "        {}_storeu_ps(&op[{}], {}_mul_ps(vop{}, vlen_inv));".format(
+                pfx, j, pfx, j
+            )
         )
     code.append("      }")
 
@@ -180,9 +239,24 @@ def unroll(uf, IndexType, InType, OutType, use_weights, isa, fused, use_offsets)
 
 
 def generic(IndexType, InType, OutType, use_weights, isa, fused, use_offsets):
+    vec, pfx, vlen, _ = isa_info[isa]
+
     def compute(InType, use_weights, isa):
         code = []
-        if InType == "float":
+        if isa == "avx512" or InType == "at::BFloat16":
+            vin = load_ps(InType, isa, "&ip[j]", "                  ")
+            vop = "%s_loadu_ps(&op[j])" % pfx
+            if InType == "uint8_t":
+                vop = "%s_add_ps(%s, vbio)" % (pfx, vop)
+            code.append(
+                "          %s_storeu_ps(\n"
+                "              &op[j],\n"
+                "              %s_fmadd_ps(\n"
+                "                  vwgt,\n"
+                "                  %s,\n"
+                "                  %s));" % (pfx, pfx, vin, vop)
+            )
+        elif InType == "float":
             code.append(
                 "          _mm256_storeu_ps(\n"
                 "              &op[j],\n"
@@ -231,8 +305,8 @@ def generic(IndexType, InType, OutType, use_weights, isa, fused, use_offsets):
 
     # initialize to 0
     code.append("      int64_t j = 0;")
-    code.append("      for (; j + 8 <= block_size; j += 8) {")
-    code.append("        _mm256_storeu_ps(op + j, _mm256_setzero_ps());")
+    code.append("      for (; j + {} <= block_size; j += {}) {{".format(vlen, vlen))
+    code.append("        {}_storeu_ps(op + j, {}_setzero_ps());".format(pfx, pfx))
     code.append("      }")
     code.append("      for (; j < block_size; j++) {")
     code.append("        op[j] = 0.0f;")
@@ -291,7 +365,7 @@ def generic(IndexType, InType, OutType, use_weights, isa, fused, use_offsets):
         else:
             code.append("        bio = wgt * scale_bias[2 * idx + 1];")
             code.append("        wgt = wgt * scale_bias[2 * idx];")
-        code.append("        __m256 vbio = _mm256_set1_ps(bio);")
+        code.append("        {} vbio = {}_set1_ps(bio);".format(vec, pfx))
     else:
         code.append("        " + OutType + " wgt = 1.f;")
         code.append("        if (weights) {")
@@ -299,7 +373,7 @@ def generic(IndexType, InType, OutType, use_weights, isa, fused, use_offsets):
             "          wgt = weights[IS_WEIGHT_POSITIONAL ? (dataInd - start) : dataInd];"  # noqa
         )
         code.append("        }")
-    code.append("        __m256 vwgt = _mm256_set1_ps(wgt);")
+    code.append("        {} vwgt = {}_set1_ps(wgt);".format(vec, pfx))
 
     code.append("        const {}* ip = &input[idx * fused_block_size];".format(InType))
     code.append(
@@ -321,7 +395,7 @@ def generic(IndexType, InType, OutType, use_weights, isa, fused, use_offsets):
 
     # compute and store main loop
     code.append("        j = 0;")
-    code.append("        for (; j + 8 <= block_size; j += 8) {")
+    code.append("        for (; j + {} <= block_size; j += {}) {{".format(vlen, vlen))
     code.extend(compute(InType, use_weights, isa))
     code.append("        }")
     # leftover
@@ -335,6 +409,8 @@ def generic(IndexType, InType, OutType, use_weights, isa, fused, use_offsets):
             "              _mm256_cvtph_ps(*(reinterpret_cast<const __m128i*>(vtmp1)));"
         )
         code.append("          op[j] = std::fma(wgt, ((float*)(&vtmp2))[0], op[j]);")
+    elif InType == "at::BFloat16":
+        code.append("          op[j] = std::fma(wgt, float(ip[j]), op[j]);")
     elif InType == "uint8_t":
         code.append("          op[j] = std::fma(wgt, (float)ip[j], bio + op[j]);")
     else:
@@ -350,12 +426,14 @@ def generic(IndexType, InType, OutType, use_weights, isa, fused, use_offsets):
     else:
         code.append("      if (normalize_by_lengths && lengths[rangeIndex]) {")
         code.append("        float len_inv = 1.0f / lengths[rangeIndex];")
-    code.append("        __m256 vlen_inv = _mm256_set1_ps(len_inv);")
+    code.append("        {} vlen_inv = {}_set1_ps(len_inv);".format(vec, pfx))
     code.append("        j = 0;")
-    code.append("        for (; j + 8 <= block_size; j += 8) {")
+    code.append("        for (; j + {} <= block_size; j += {}) {{".format(vlen, vlen))
     code.append(
-        "          _mm256_storeu_ps(\n"
-        "              &op[j], _mm256_mul_ps(_mm256_loadu_ps(&op[j]), vlen_inv));"
+        "          {}_storeu_ps(\n"
+        "              &op[j], {}_mul_ps({}_loadu_ps(&op[j]), vlen_inv));".format(
+            pfx, pfx, pfx
+        )
     )
     code.append("        }")
     code.append("        for (; j < block_size; j++) {")
@@ -373,25 +451,40 @@ parser = argparse.ArgumentParser()
 parser.add_argument("-f", "--filename", help="file name")
 parser.add_argument("--fused", action="store_true")
 parser.add_argument("--use-offsets", action="store_true")
+parser.add_argument("--isa", choices=sorted(isa_info), default="avx2")
+parser.add_argument(
+    "--prefetch-distance",
+    type=int,
+    default=16,
+    help="number of indices ahead of the current one whose row is prefetched",
+)
 opts = parser.parse_args()
 if opts.filename:
     filename = opts.filename
 elif opts.fused:
     if opts.use_offsets:
-        filename = "embedding_lookup_fused_8bit_rowwise_idx_avx2.cc"
+        filename = "embedding_lookup_fused_8bit_rowwise_idx_{}.cc".format(opts.isa)
     else:
-        filename = "embedding_lookup_fused_8bit_rowwise_avx2.cc"
+        filename = "embedding_lookup_fused_8bit_rowwise_{}.cc".format(opts.isa)
 else:
     if opts.use_offsets:
-        filename = "embedding_lookup_idx_avx2.cc"
+        filename = "embedding_lookup_idx_{}.cc".format(opts.isa)
     else:
-        filename = "embedding_lookup_avx2.cc"
+        filename = "embedding_lookup_{}.cc".format(opts.isa)
 
 options = [
     ["int32_t", "int", "float", "float", "float", "float"],
     ["int64_t", "int64_t", "float", "float", "float", "float"],
     ["int32_t", "int", "half", "at::Half", "float", "float"],
     ["int64_t", "int64_t", "half", "at::Half", "float", "float"],
+]
+# bfloat16 tables, the fused kernels only read rows of 8-bit values
+if not opts.fused:
+    options += [
+        ["int32_t", "int", "bfloat16", "at::BFloat16", "float", "float"],
+        ["int64_t", "int64_t", "bfloat16", "at::BFloat16", "float", "float"],
+    ]
+options += [
     ["int32_t", "int", "uint8_t", "uint8_t", "float", "float"],
     ["int64_t", "int64_t", "uint8_t", "uint8_t", "float", "float"],
 ]
@@ -405,6 +498,8 @@ code.append("//// BY {}".format(sys.argv[0]))
 code.append("//// DO NOT MODIFY!!!")
 code.append("//// --------------------------\n")
 
+if not opts.fused:
+    code.append("#include <c10/util/BFloat16.h>")
 code.append("#include <c10/util/Half.h>")
 code.append("#include <immintrin.h>")
 
@@ -422,7 +517,7 @@ for o in options:
         fn_base = "{}EmbeddingLookup_{}_{}_{}".format(
             prefix, IndexTypeName, InTypeName, OutTypeName
         )
-    suffix = "__avx2_fma"
+    suffix = isa_info[opts.isa][3]
     fn = "static bool " + fn_base + suffix
     code.append(fn + "(")
 
@@ -444,7 +539,9 @@ for o in options:
     args.append("    " + OutType + "* out) {")
     code += args
 
-    code.append("  const " + IndexType + " prefdist_T0 = 16;")
+    code.append(
+        "  const {} prefdist_T0 = {};".format(IndexType, opts.prefetch_distance)
+    )
     # block_size is the number of elements and fused_block_size is the size of
     # an entire row, including scale and bias.
     offset = (8 // sizeof[InType]) if opts.fused else 0
@@ -458,17 +555,25 @@ for o in options:
 
     # code.append("printf(\"calling " + fn + "\\n\");");
 
-    code.append("  if (block_size == 128) {")
-    code += unroll(16, IndexType, InType, OutType, True, "AVX2", opts.fused, opts.use_offsets)
-    code.append("  } else if (block_size == 64) {")
-    code += unroll(8, IndexType, InType, OutType, True, "AVX2", opts.fused, opts.use_offsets)
-    code.append("  } else if (block_size == 32) {")
-    code += unroll(4, IndexType, InType, OutType, True, "AVX2", opts.fused, opts.use_offsets)
-    code.append("  } else if (block_size == 16) {")
-    code += unroll(2, IndexType, InType, OutType, True, "AVX2", opts.fused, opts.use_offsets)
+    # the common block sizes are unrolled into as many registers
+    vlen = isa_info[opts.isa][2]
+    for i, block_size in enumerate([128, 64, 32, 16]):
+        code.append(
+            "  {}if (block_size == {}) {{".format("} else " if i else "", block_size)
+        )
+        code += unroll(
+            block_size // vlen,
+            IndexType,
+            InType,
+            OutType,
+            True,
+            opts.isa,
+            opts.fused,
+            opts.use_offsets,
+        )
     code.append("  } else {")
     code.append("    // generic code")
-    code += generic(IndexType, InType, OutType, True, "AVX2", opts.fused, opts.use_offsets)
+    code += generic(IndexType, InType, OutType, True, opts.isa, opts.fused, opts.use_offsets)
     code.append("  }")
     code.append("  return dataInd == index_size;")
 
@@ -0,0 +1,108 @@
+#include "caffe2/predictor/predictor_memonger.h"
+
+#include <unordered_set>
+
+#include "caffe2/core/memonger.h"
+
+namespace caffe2 {
+
+namespace {
+
+bool hasNestedNet(const NetDef& net) {
+  for (const auto& op : net.op()) {
+    if (op.type().find("RecurrentNetwork") == 0) {
+      continue;
+    }
+    for (const auto& arg : op.arg()) {
+      if (arg.has_n() || arg.nets_size() > 0) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+std::unordered_map<std::string, std::vector<int>> inferBlobShapes(
+    const PredictorConfig& config,
+    const BoundShapeSpec& spec,
+    const ShapeInfoMap& input_shapes,
+    const std::unordered_set<std::string>& activations) {
+  std::unordered_map<std::string, std::vector<int>> blob_shapes;
+  ShapeInfoMap info = input_shapes;
+  for (const auto& name : config.predict_net->external_input()) {
+    if (!info.count(name) && config.ws->HasBlob(name)) {
+      info.emplace(name, getShapeInfoFromBlob(config.ws->GetBlob(name)));
+    }
+  }
+  try {
+    auto inferencer = getBoundShapeInferencer(spec);
+    inferencer->InferBoundShapeAndType(
+        *config.predict_net, info, config.ws.get());
+    for (const auto& kv : inferencer->shape_info()) {
+      const auto& shape = kv.second.shape;
+      if (!activations.count(kv.first) || shape.unknown_shape()) {
+        continue;
+      }
+      std::vector<int> dims(shape.dims().begin(), shape.dims().end());
+      blob_shapes.emplace(kv.first, std::move(dims));
+    }
+  } catch (const std::exception& e) {
+    LOG(WARNING) << "Bound shape inference failed, sharing activations by "
+                 << "lifetime only: " << e.what();
+    blob_shapes.clear();
+  }
+  return blob_shapes;
+}
+
+} // namespace
+
+PredictorConfig optimizeActivationMemory(
+    PredictorConfig config,
+    const BoundShapeSpec& spec,
+    const ShapeInfoMap& input_shapes) {
+  const NetDef& net = *config.predict_net;
+  if (hasNestedNet(net)) {
+    LOG(INFO) << "Memonger does not support nets with nested nets";
+    return config;
+  }
+
+  // Blobs the caller can see keep their names
+  std::unordered_set<std::string> pinned(
+      net.external_input().begin(), net.external_input().end());
+  pinned.insert(net.external_output().begin(), net.external_output().end());
+  pinned.insert(config.input_names.begin(), config.input_names.end());
+  pinned.insert(config.output_names.begin(), config.output_names.end());
+
+  std::unordered_set<std::string> activations;
+  std::vector<int> op_indices;
+  for (int i = 0; i < net.op_size(); ++i) {
+    const auto& op = net.op(i);
+    CAFFE_ENFORCE(
+        !op.is_gradient_op(), "Memonger only supports inference nets");
+    op_indices.push_back(i);
+    for (const auto& output : op.output()) {
+      if (!pinned.count(output) && !config.ws->HasBlob(output)) {
+        activations.insert(output);
+      }
+    }
+  }
+  if (activations.empty()) {
+    return config;
+  }
+
+  const std::vector<std::string> heads(
+      net.external_input().begin(), net.external_input().end());
+  auto optimized = std::make_shared<NetDef>(
+      memonger::compute_blob_recycling_for_dag(
+          net,
+          heads,
+          op_indices,
+          activations,
+          "",
+          std::unordered_set<std::string>(),
+          inferBlobShapes(config, spec, input_shapes, activations)));
+  config.predict_net = std::move(optimized);
+  return config;
+}
+
+} // namespace caffe2
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "caffe2/opt/bound_shape_inferencer.h"
+#include "caffe2/opt/shape_info.h"
+#include "caffe2/predictor/predictor_config.h"
+
+namespace caffe2 {
+
+/**
+ * Shares the activation blobs of `config->predict_net` by lifetime, so that a
+ * Predictor built from the config holds a minimal set of reused buffers.
+ *
+ * The sizes of the activations are bounded with the BoundShapeInferencer for
+ * `spec`, starting from the parameters of `config->ws` and `input_shapes`,
+ * and each activation takes the free blob of the closest size. If the shapes
+ * can't be inferred the blobs are shared by lifetime only.
+ *
+ * The inputs, outputs and parameters of the net keep their names. Nets with
+ * ops that run a nested NetDef (other than RecurrentNetwork) are left as is,
+ * because the blobs their subnets read are not visible to the pass.
+ *
+ * Usage:
+ *   Predictor p(optimizeActivationMemory(
+ *       makePredictorConfig(init_net, run_net), BoundShapeSpec(64, 64)));
+ */
+CAFFE2_API PredictorConfig optimizeActivationMemory(
+    PredictorConfig config,
+    const BoundShapeSpec& spec,
+    const ShapeInfoMap& input_shapes = ShapeInfoMap());
+
+} // namespace caffe2
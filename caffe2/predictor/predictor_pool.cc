@@ -0,0 +1,222 @@
+#include "caffe2/predictor/predictor_pool.h"
+
+#include <algorithm>
+#include <unordered_set>
+
+namespace caffe2 {
+
+struct PredictorPool::Instance {
+  std::unique_ptr<Workspace> ws;
+  NetBase* net = nullptr;
+};
+
+namespace {
+
+Blob* getLocalBlob(
+    Workspace* ws,
+    const std::vector<std::string>& local_blobs,
+    const std::string& name) {
+  // GetBlob falls back to the shared workspace, which must not be written to
+  CAFFE_ENFORCE(
+      std::find(local_blobs.begin(), local_blobs.end(), name) !=
+          local_blobs.end(),
+      "Blob is not an input of the net: ",
+      name);
+  return ws->GetBlob(name);
+}
+
+// Moves the tensor out of the blob, so that it stays valid when the next
+// call reuses the workspace
+Tensor takeTensor(Workspace* ws, const std::string& name) {
+  Blob* blob = ws->GetBlob(name);
+  CAFFE_ENFORCE(blob, "Blob does not exist: ", name);
+  CAFFE_ENFORCE(
+      BlobIsTensorType(*blob, CPU), "Blob is not a CPU Tensor: ", name);
+  Tensor tensor = std::move(*BlobGetMutableTensor(blob, CPU));
+  BlobSetTensor(blob, Tensor(CPU));
+  return tensor;
+}
+
+// Drops the references to the tensors of the caller
+void releaseInputs(const std::vector<Blob*>& inputs) {
+  for (Blob* blob : inputs) {
+    BlobSetTensor(blob, Tensor(CPU));
+  }
+}
+
+} // namespace
+
+PredictorPool::PredictorPool(
+    const NetDef& init_net,
+    const NetDef& run_net,
+    Workspace* parent,
+    bool run_init,
+    int optimization,
+    size_t initial_size)
+    : PredictorPool(
+          makePredictorConfig(
+              init_net,
+              run_net,
+              parent,
+              run_init,
+              optimization),
+          initial_size) {}
+
+PredictorPool::PredictorPool(PredictorConfig config, size_t initial_size)
+    : config_(std::move(config)) {
+  const Workspace* params = config_.ws.get();
+  std::unordered_set<std::string> local;
+  for (const auto& name : config_.predict_net->external_input()) {
+    if (!params->HasBlob(name) && local.insert(name).second) {
+      local_blobs_.push_back(name);
+    }
+  }
+  for (const auto& op : config_.predict_net->op()) {
+    for (const auto& output : op.output()) {
+      CAFFE_ENFORCE(
+          !params->HasBlob(output),
+          "PredictorPool: predict_net writes to the parameter blob ",
+          output);
+      if (local.insert(output).second) {
+        local_blobs_.push_back(output);
+      }
+    }
+  }
+
+  free_.reserve(initial_size);
+  for (size_t i = 0; i < initial_size; ++i) {
+    free_.push_back(createInstance());
+  }
+  size_ = initial_size;
+}
+
+PredictorPool::~PredictorPool() {}
+
+std::unique_ptr<PredictorPool::Instance> PredictorPool::createInstance()
+    const {
+  auto instance = caffe2::make_unique<Instance>();
+  instance->ws = caffe2::make_unique<Workspace>(config_.ws.get());
+  for (const auto& name : local_blobs_) {
+    BlobGetMutableTensor(instance->ws->CreateLocalBlob(name), CPU);
+  }
+  instance->net = instance->ws->CreateNet(config_.predict_net);
+  CAFFE_ENFORCE(instance->net);
+  return instance;
+}
+
+std::unique_ptr<PredictorPool::Instance> PredictorPool::acquire() {
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    if (!free_.empty()) {
+      auto instance = std::move(free_.back());
+      free_.pop_back();
+      return instance;
+    }
+    ++size_;
+  }
+  // Created outside of the lock, the other calls don't wait for it
+  return createInstance();
+}
+
+void PredictorPool::release(std::unique_ptr<Instance> instance) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  free_.push_back(std::move(instance));
+}
+
+size_t PredictorPool::size() const {
+  std::lock_guard<std::mutex> guard(mutex_);
+  return size_;
+}
+
+bool PredictorPool::operator()(const TensorList& inputs, TensorList* outputs) {
+  CAFFE_ENFORCE(
+      inputs.size() <=
+      static_cast<unsigned>(config_.predict_net->external_input_size()));
+  auto instance = acquire();
+  Workspace* ws = instance->ws.get();
+  std::vector<Blob*> input_blobs;
+  bool success = false;
+  try {
+    for (size_t i = 0; i < inputs.size(); ++i) {
+      Blob* blob = getLocalBlob(
+          ws, local_blobs_, config_.predict_net->external_input(i));
+      input_blobs.push_back(blob);
+      // This is evil and shares the same underlying tensor
+      BlobSetTensor(blob, inputs[i].UnsafeSharedInstance());
+    }
+    success = instance->net->Run();
+    if (success) {
+      outputs->clear();
+      for (const auto& name : config_.predict_net->external_output()) {
+        outputs->push_back(takeTensor(ws, name));
+      }
+    }
+  } catch (...) {
+    releaseInputs(input_blobs);
+    release(std::move(instance));
+    throw;
+  }
+  releaseInputs(input_blobs);
+  release(std::move(instance));
+  return success;
+}
+
+bool PredictorPool::operator()(const TensorMap& inputs, TensorList* outputs) {
+  TensorMap output_map;
+  if (!(*this)(inputs, &output_map)) {
+    return false;
+  }
+  outputs->clear();
+  for (const auto& name : config_.predict_net->external_output()) {
+    auto it = output_map.find(name);
+    CAFFE_ENFORCE(it != output_map.end(), "Output not found: ", name);
+    outputs->push_back(it->second.UnsafeSharedInstance());
+  }
+  return true;
+}
+
+bool PredictorPool::operator()(const TensorMap& inputs, TensorMap* outputs) {
+  if (!input_names().empty()) {
+    CAFFE_ENFORCE_EQ(inputs.size(), input_names().size());
+  }
+  auto instance = acquire();
+  Workspace* ws = instance->ws.get();
+  std::vector<Blob*> input_blobs;
+  bool success = false;
+  try {
+    for (auto& input : inputs) {
+      if (!input_names().empty()) {
+        CAFFE_ENFORCE(
+            std::find(
+                input_names().begin(), input_names().end(), input.first) !=
+                input_names().end(),
+            "Input can't be found: ",
+            input.first);
+      }
+      Blob* blob = getLocalBlob(ws, local_blobs_, input.first);
+      input_blobs.push_back(blob);
+      // This is evil and shares the same underlying tensor
+      BlobSetTensor(blob, input.second.UnsafeSharedInstance());
+    }
+    success = instance->net->Run();
+    if (success) {
+      const auto& names = output_names().empty()
+          ? std::vector<std::string>(
+                config_.predict_net->external_output().begin(),
+                config_.predict_net->external_output().end())
+          : output_names();
+      for (const auto& name : names) {
+        (*outputs)[name] = takeTensor(ws, name);
+      }
+    }
+  } catch (...) {
+    releaseInputs(input_blobs);
+    release(std::move(instance));
+    throw;
+  }
+  releaseInputs(input_blobs);
+  release(std::move(instance));
+  return success;
+}
+
+} // namespace caffe2
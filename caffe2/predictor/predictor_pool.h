@@ -0,0 +1,89 @@
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "caffe2/core/net.h"
+#include "caffe2/core/tensor.h"
+#include "caffe2/predictor/predictor.h"
+#include "caffe2/predictor/predictor_config.h"
+
+namespace caffe2 {
+
+/**
+ * A Predictor that can be called from many threads at once.
+ *
+ * The parameters are loaded once, into the workspace of the config, which is
+ * then only read. Each call runs `predict_net` in a child workspace taken
+ * from a pool, which holds its own instance of the net and the blobs the net
+ * writes to. The pool grows to the number of concurrent calls; the
+ * activations of a child workspace keep their memory across the calls it
+ * serves.
+ *
+ * Unlike Predictor, the output tensors are owned by the caller and stay
+ * valid after the call. `predict_net` must not write to the blobs of the
+ * parameter workspace.
+ */
+class CAFFE2_API PredictorPool {
+ public:
+  using TensorList = Predictor::TensorList;
+  using TensorMap = Predictor::TensorMap;
+
+  PredictorPool(
+      const NetDef& init_net,
+      const NetDef& run_net,
+      Workspace* parent = nullptr,
+      bool run_init = true,
+      int optimization = 1,
+      size_t initial_size = 0);
+
+  // Creates `initial_size` child workspaces up front, so that the first
+  // concurrent calls don't pay for creating them.
+  explicit PredictorPool(PredictorConfig config, size_t initial_size = 0);
+
+  ~PredictorPool();
+
+  // Same as the Predictor calls of the same signatures. Thread safe.
+  bool operator()(const TensorList& inputs, TensorList* outputs);
+  bool operator()(const TensorMap& inputs, TensorList* outputs);
+  bool operator()(const TensorMap& inputs, TensorMap* outputs);
+
+  const NetDef& def() const {
+    return *config_.predict_net;
+  };
+
+  // The parameter workspace shared by all the child workspaces
+  const Workspace* ws() const {
+    return config_.ws.get();
+  };
+
+  const std::vector<std::string>& input_names() const {
+    return config_.input_names;
+  }
+
+  const std::vector<std::string>& output_names() const {
+    return config_.output_names;
+  }
+
+  // Number of child workspaces created so far
+  size_t size() const;
+
+ private:
+  struct Instance;
+
+  std::unique_ptr<Instance> acquire();
+  void release(std::unique_ptr<Instance> instance);
+  std::unique_ptr<Instance> createInstance() const;
+
+  PredictorConfig config_;
+  // Blobs of each child workspace: the external inputs that the parameter
+  // workspace doesn't have, and every output of the ops of predict_net
+  std::vector<std::string> local_blobs_;
+
+  mutable std::mutex mutex_;
+  std::vector<std::unique_ptr<Instance>> free_;
+  size_t size_ = 0;
+};
+
+} // namespace caffe2
@@ -0,0 +1,176 @@
+#include "caffe2/core/tensor.h"
+#include "caffe2/predictor/predictor_pool.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+
+namespace caffe2 {
+
+namespace {
+
+const char* predictSpec = R"DOC(
+        name: "predict"
+        type: "simple"
+        external_input: "data"
+        external_input: "W"
+        external_input: "b"
+        external_output: "y"
+        op {
+          input: "data"
+          input: "W"
+          input: "b"
+          output: "y"
+          type: "FC"
+        }
+)DOC";
+
+const char* initSpec = R"DOC(
+        name: "init"
+        type: "simple"
+        op {
+          type: "ConstantFill"
+          output: "W"
+          arg {
+            name: "shape"
+            ints: 10
+            ints: 4
+          }
+          arg {
+            name: "value"
+            f: 2.0
+          }
+        }
+        op {
+          type: "ConstantFill"
+          output: "b"
+          arg {
+            name: "shape"
+            ints: 10
+          }
+          arg {
+            name: "value"
+            f: 2.0
+          }
+        }
+)DOC";
+
+NetDef parseNetDef(const std::string& value) {
+  NetDef def;
+  CAFFE_ENFORCE(
+      TextFormat::ParseFromString(value, &def),
+      "Failed to parse NetDef with value: ",
+      value);
+  return def;
+}
+
+Tensor filledTensor(int64_t rows, float value) {
+  Tensor t(std::vector<int64_t>{rows, 4}, CPU);
+  auto* data = t.mutable_data<float>();
+  for (int64_t i = 0; i < t.numel(); ++i) {
+    data[i] = value;
+  }
+  return t;
+}
+
+// Every output of FC(data, W = 2, b = 2) when data is filled with `value`
+float expected(float value) {
+  return 4 * 2 * value + 2;
+}
+
+bool allEqual(const Tensor& t, float value) {
+  const auto* data = t.data<float>();
+  for (int64_t i = 0; i < t.numel(); ++i) {
+    if (data[i] != value) {
+      return false;
+    }
+  }
+  return true;
+}
+
+} // namespace
+
+class PredictorPoolTest : public testing::Test {
+ public:
+  void SetUp() override {
+    pool_ = caffe2::make_unique<PredictorPool>(
+        makePredictorConfig(parseNetDef(initSpec), parseNetDef(predictSpec)));
+  }
+
+  std::unique_ptr<PredictorPool> pool_;
+};
+
+TEST_F(PredictorPoolTest, SimpleBatchSized) {
+  PredictorPool::TensorList input;
+  input.emplace_back(filledTensor(3, 1));
+  PredictorPool::TensorList output;
+  EXPECT_TRUE((*pool_)(input, &output));
+  EXPECT_EQ(output.size(), 1);
+  EXPECT_EQ(output.front().size(0), 3);
+  EXPECT_EQ(output.front().size(1), 10);
+  EXPECT_TRUE(allEqual(output.front(), expected(1)));
+  EXPECT_EQ(pool_->size(), 1);
+}
+
+TEST_F(PredictorPoolTest, MapInput) {
+  PredictorPool::TensorMap input;
+  input.emplace("data", filledTensor(2, 3));
+  PredictorPool::TensorMap output;
+  EXPECT_TRUE((*pool_)(input, &output));
+  EXPECT_EQ(output.size(), 1);
+  EXPECT_TRUE(allEqual(output.at("y"), expected(3)));
+}
+
+TEST_F(PredictorPoolTest, RejectsParameterInputs) {
+  PredictorPool::TensorMap input;
+  input.emplace("W", filledTensor(10, 0));
+  PredictorPool::TensorList output;
+  EXPECT_THROW((*pool_)(input, &output), EnforceNotMet);
+  // The failed call gives its workspace back
+  input.clear();
+  input.emplace("data", filledTensor(1, 1));
+  EXPECT_TRUE((*pool_)(input, &output));
+  EXPECT_TRUE(allEqual(output.front(), expected(1)));
+  EXPECT_EQ(pool_->size(), 1);
+}
+
+TEST_F(PredictorPoolTest, OutputsOutliveTheCall) {
+  PredictorPool::TensorList first, second;
+  PredictorPool::TensorList input;
+  input.emplace_back(filledTensor(1, 1));
+  EXPECT_TRUE((*pool_)(input, &first));
+  input[0] = filledTensor(1, 2);
+  EXPECT_TRUE((*pool_)(input, &second));
+  EXPECT_TRUE(allEqual(first.front(), expected(1)));
+  EXPECT_TRUE(allEqual(second.front(), expected(2)));
+}
+
+TEST_F(PredictorPoolTest, ConcurrentCalls) {
+  constexpr int kThreads = 8;
+  constexpr int kIters = 50;
+  std::atomic<int> failures{0};
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kThreads; ++t) {
+    threads.emplace_back([&, t]() {
+      for (int i = 0; i < kIters; ++i) {
+        const float value = t * kIters + i;
+        PredictorPool::TensorList input;
+        input.emplace_back(filledTensor(t + 1, value));
+        PredictorPool::TensorList output;
+        if (!(*pool_)(input, &output) || output.front().size(0) != t + 1 ||
+            !allEqual(output.front(), expected(value))) {
+          ++failures;
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(failures.load(), 0);
+  EXPECT_GE(pool_->size(), 1);
+  EXPECT_LE(pool_->size(), kThreads);
+}
+
+} // namespace caffe2
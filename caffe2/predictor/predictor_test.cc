@@ -2,6 +2,7 @@
 #include "caffe2/core/operator.h"
 #include "caffe2/core/tensor.h"
 #include "caffe2/predictor/predictor.h"
+#include "caffe2/predictor/predictor_memonger.h"
 #include "caffe2/utils/math.h"
 
 #include <gtest/gtest.h>
@@ -26,6 +27,42 @@ const char* predictSpec = R"DOC(
         }
 )DOC";
 
+const char* chainSpec = R"DOC(
+        name: "chain"
+        type: "simple"
+        external_input: "data"
+        external_input: "W"
+        external_input: "b"
+        external_output: "y"
+        op {
+          input: "data"
+          input: "W"
+          input: "b"
+          output: "h1"
+          type: "FC"
+        }
+        op {
+          input: "h1"
+          output: "h2"
+          type: "Sigmoid"
+        }
+        op {
+          input: "h2"
+          output: "h3"
+          type: "Sigmoid"
+        }
+        op {
+          input: "h3"
+          output: "h4"
+          type: "Sigmoid"
+        }
+        op {
+          input: "h4"
+          output: "y"
+          type: "Sigmoid"
+        }
+)DOC";
+
 const char* initSpec = R"DOC(
         name: "init"
         type: "dag"
@@ -205,4 +242,43 @@ TEST_F(PredictorTest, SimpleBatchSizedMapInput) {
   EXPECT_NEAR(output.front().data<float>()[4], 0.1209, 1E-4);
 }
 
+TEST(PredictorMemongerTest, SharesActivations) {
+  DeviceOption op;
+  op.set_random_seed(1701);
+  CPUContext ctx(op);
+  auto config = makePredictorConfig(
+      parseNetDef(initSpec), parseNetDef(chainSpec), nullptr, true, 0);
+  auto optimized = optimizeActivationMemory(
+      makePredictorConfig(
+          parseNetDef(initSpec), parseNetDef(chainSpec), nullptr, true, 0),
+      BoundShapeSpec(8, 8));
+
+  std::set<std::string> before, after;
+  for (const auto& op : config.predict_net->op()) {
+    before.insert(op.output().begin(), op.output().end());
+  }
+  for (const auto& op : optimized.predict_net->op()) {
+    after.insert(op.output().begin(), op.output().end());
+  }
+  EXPECT_LT(after.size(), before.size());
+  EXPECT_TRUE(after.count("y"));
+
+  Predictor reference(config);
+  Predictor p(optimized);
+  auto inputData = randomTensor({3, 4}, &ctx);
+  Predictor::TensorList input;
+  input.emplace_back(BlobGetMutableTensor(inputData.get(), CPU)->Alias());
+  Predictor::TensorList expected, output;
+  EXPECT_TRUE(reference(input, &expected));
+  EXPECT_TRUE(p(input, &output));
+  EXPECT_EQ(output.size(), 1);
+  EXPECT_EQ(output.front().sizes(), expected.front().sizes());
+  for (int64_t i = 0; i < output.front().numel(); ++i) {
+    EXPECT_NEAR(
+        output.front().data<float>()[i],
+        expected.front().data<float>()[i],
+        1E-6);
+  }
+}
+
 } // namespace caffe2
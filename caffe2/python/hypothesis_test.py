@@ -1350,6 +1350,37 @@ class TestOperators(hu.HypothesisTestCase):
             v += self.ws.blobs[str(counter)].fetch().tolist()
         self.assertEqual(v, truth)
 
+    @given(capacity=st.integers(1, 5),
+           num_elements=st.integers(1, 5),
+           num_records=st.integers(1, 4))
+    def test_safe_dequeue_blobs_num_records(
+            self, capacity, num_elements, num_records):
+        num_elements = min(num_elements, capacity)
+        self.ws.run(core.CreateOperator(
+            "CreateBlobsQueue", [], ["queue"], capacity=capacity,
+            num_blobs=1))
+        xs = np.random.randn(num_elements, 3).astype(np.float32)
+        for i in range(num_elements):
+            self.ws.create_blob("x").feed(xs[i:i + 1])
+            self.ws.run(core.CreateOperator(
+                "EnqueueBlobs", ["queue", "x"], ["x"]))
+        self.ws.run(core.CreateOperator("CloseBlobsQueue", ["queue"], []))
+
+        # the records in the queue are read together, in order
+        dequeue = core.CreateOperator(
+            "SafeDequeueBlobs", ["queue"], ["y", "status"],
+            num_records=num_records)
+        read = 0
+        while read < num_elements:
+            self.ws.run(dequeue)
+            count = min(num_records, num_elements - read)
+            np.testing.assert_array_equal(
+                self.ws.blobs["y"].fetch(), xs[read:read + count])
+            self.assertFalse(self.ws.blobs["status"].fetch())
+            read += count
+        self.ws.run(dequeue)
+        self.assertTrue(self.ws.blobs["status"].fetch())
+
     @given(num_queues=st.integers(1, 5),
            num_iter=st.integers(5, 10),
            capacity=st.integers(1, 5),
@@ -35,6 +35,19 @@ class TestObservers(unittest.TestCase):
         self.model.net.RemoveObserver(ob)
         assert(self.model.net.NumObservers() + 1 == num)
 
+    def testLatencyHistogramObserver(self):
+        ob = self.model.net.AddObserver("LatencyHistogramObserver")
+        for _ in range(3):
+            ws.RunNet(self.model.net)
+        stats = ob.latency_stats()
+        self.assertEqual(stats["net"]["count"], 3)
+        self.assertEqual(stats["operators"]["FC"]["count"], 3)
+        self.assertLessEqual(
+            stats["operators"]["FC"]["p50"], stats["operators"]["FC"]["max"])
+        ob.reset_latency_stats()
+        self.assertEqual(ob.latency_stats()["net"]["count"], 0)
+        self.model.net.RemoveObserver(ob)
+
     @given(
         num_layers=st.integers(1, 4),
         forward_only=st.booleans()
@@ -25,9 +25,13 @@ def onnxifi_caffe2_net(
         use_onnx=True,
         adjust_batch=True,
         black_list=None,
-        weight_names=None):
+        weight_names=None,
+        batch_size_buckets=None):
     """
     Transform the caffe2_net by collapsing ONNXIFI-runnable nodes into Onnxifi c2 ops
+
+    batch_size_buckets: batch sizes below max_batch_size for which the Onnxifi
+    ops also compile their subgraph (c2 model only)
     """
     shape_hints = {}
     for k, v in input_shapes.items():
@@ -40,7 +44,8 @@ def onnxifi_caffe2_net(
                              max_seq_size,
                              adjust_batch,
                              debug,
-                             use_onnx)
+                             use_onnx,
+                             batch_size_buckets if batch_size_buckets else [])
     pred_net_cut = caffe2_pb2.NetDef()
     pred_net_cut.ParseFromString(pred_net_str)
     return pred_net_cut
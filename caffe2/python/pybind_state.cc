@@ -14,6 +14,7 @@
 #include "caffe2/core/operator.h"
 #include "caffe2/core/stats.h"
 #include "caffe2/core/transform.h"
+#include "caffe2/observers/latency_histogram_observer.h"
 #include "caffe2/observers/profile_observer.h"
 #include "caffe2/observers/runcnt_observer.h"
 #include "caffe2/observers/time_observer.h"
@@ -376,6 +377,39 @@ void addObjectMethods(py::module& m) {
                 cast_ob, "Observer does not implement this function.");
             return cast_ob->average_time_children();
           })
+      .def(
+          "latency_stats",
+          [](ObserverBase<NetBase>* ob) {
+            auto* cast_ob = dynamic_cast_if_rtti<LatencyHistogramObserver*>(ob);
+            CAFFE_ENFORCE(
+                cast_ob, "Observer does not implement this function.");
+            auto to_dict = [](const LatencyStats& stats) {
+              py::dict result;
+              result["count"] = stats.count;
+              result["mean"] = stats.mean;
+              result["p50"] = stats.p50;
+              result["p90"] = stats.p90;
+              result["p99"] = stats.p99;
+              result["max"] = stats.max;
+              return result;
+            };
+            py::dict operators;
+            for (const auto& entry : cast_ob->GetOperatorStats()) {
+              operators[py::str(entry.first)] = to_dict(entry.second);
+            }
+            py::dict result;
+            result["net"] = to_dict(cast_ob->GetNetStats());
+            result["operators"] = operators;
+            return result;
+          })
+      .def(
+          "reset_latency_stats",
+          [](ObserverBase<NetBase>* ob) {
+            auto* cast_ob = dynamic_cast_if_rtti<LatencyHistogramObserver*>(ob);
+            CAFFE_ENFORCE(
+                cast_ob, "Observer does not implement this function.");
+            cast_ob->Reset();
+          })
       .def("debug_info", [](ObserverBase<NetBase>* ob) {
         return ob->debugInfo();
       });
@@ -1229,6 +1263,7 @@ void addGlobalMethods(py::module& m) {
     }                                                         \
   }
 
+        REGISTER_PYTHON_EXPOSED_OBSERVER(LatencyHistogramObserver);
         REGISTER_PYTHON_EXPOSED_OBSERVER(ProfileObserver);
         REGISTER_PYTHON_EXPOSED_OBSERVER(TimeObserver);
 #undef REGISTER_PYTHON_EXPOSED_OBSERVER
@@ -1714,7 +1749,8 @@ void addGlobalMethods(py::module& m) {
          int max_seq_size,
          bool adjust_batch,
          bool debug_builder,
-         bool use_onnx) -> py::bytes {
+         bool use_onnx,
+         const std::vector<int>& batch_size_buckets) -> py::bytes {
         caffe2::NetDef pred_net;
         CAFFE_ENFORCE(
             ParseProtoFromLargeString(
@@ -1731,6 +1767,7 @@ void addGlobalMethods(py::module& m) {
         opts.adjust_batch = adjust_batch;
         opts.debug = debug_builder;
         opts.use_onnx = use_onnx;
+        opts.batch_size_buckets = batch_size_buckets;
         OnnxifiTransformer ts(opts);
         Workspace* curr_ws = GetCurrentWorkspace();
         std::unordered_set<int> blacklist_set(
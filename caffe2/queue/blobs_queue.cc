@@ -1,6 +1,8 @@
 #include "caffe2/queue/blobs_queue.h"
 
+#include <algorithm>
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
 #include <memory>
 #include <mutex>
@@ -22,6 +24,19 @@ static constexpr uint64_t SDT_TIMEOUT = (uint64_t)-1;
 static constexpr uint64_t SDT_ABORT = (uint64_t)-2;
 static constexpr uint64_t SDT_CANCEL = (uint64_t)-3;
 
+namespace {
+
+void checkRecords(
+    c10::ArrayRef<std::vector<Blob*>> records,
+    size_t numBlobs) {
+  // checked before claiming, a claimed slot must be filled or emptied
+  for (const auto& record : records) {
+    CAFFE_ENFORCE(record.size() >= numBlobs);
+  }
+}
+
+} // namespace
+
 BlobsQueue::BlobsQueue(
     Workspace* ws,
     const std::string& queueName,
@@ -29,15 +44,18 @@ BlobsQueue::BlobsQueue(
     size_t numBlobs,
     bool enforceUniqueName,
     const std::vector<std::string>& fieldNames)
-    : numBlobs_(numBlobs), name_(queueName), stats_(queueName) {
+    : numBlobs_(numBlobs),
+      slots_(capacity),
+      name_(queueName),
+      stats_(queueName) {
+  CAFFE_ENFORCE_GT(capacity, 0, "Queue capacity must be positive");
   if (!fieldNames.empty()) {
     CAFFE_ENFORCE_EQ(
         fieldNames.size(), numBlobs, "Wrong number of fieldNames provided.");
     stats_.queue_dequeued_bytes.setDetails(fieldNames);
   }
-  queue_.reserve(capacity);
   for (size_t i = 0; i < capacity; ++i) {
-    std::vector<Blob*> blobs;
+    auto& blobs = slots_[i].blobs;
     blobs.reserve(numBlobs);
     for (size_t j = 0; j < numBlobs; ++j) {
       const auto blobName = queueName + "_" + to_string(i) + "_" + to_string(j);
@@ -49,125 +67,275 @@ BlobsQueue::BlobsQueue(
       }
       blobs.push_back(ws->CreateBlob(blobName));
     }
-    queue_.push_back(blobs);
   }
-  DCHECK_EQ(queue_.size(), capacity);
+  DCHECK_EQ(slots_.size(), capacity);
 }
 
 bool BlobsQueue::blockingRead(
     const std::vector<Blob*>& inputs,
     float timeout_secs) {
+  return blockingReadBatch(inputs, timeout_secs) == 1;
+}
+
+size_t BlobsQueue::blockingReadBatch(
+    c10::ArrayRef<std::vector<Blob*>> inputs,
+    float timeout_secs) {
   Timer readTimer;
   auto keeper = this->shared_from_this();
   const auto& name = name_.c_str();
   CAFFE_SDT(queue_read_start, name, (void*)this, SDT_BLOCKING_OP);
-  std::unique_lock<std::mutex> g(mutex_);
-  auto canRead = [this]() {
-    CAFFE_ENFORCE_LE(reader_, writer_);
-    return reader_ != writer_;
-  };
+  checkRecords(inputs, numBlobs_);
   // Decrease queue balance before reading to indicate queue read pressure
   // is being increased (-ve queue balance indicates more reads than writes)
-  CAFFE_EVENT(stats_, queue_balance, -1);
-  if (timeout_secs > 0) {
-    std::chrono::milliseconds timeout_ms(int(timeout_secs * 1000));
-    cv_.wait_for(
-        g, timeout_ms, [this, canRead]() { return closing_ || canRead(); });
-  } else {
-    cv_.wait(g, [this, canRead]() { return closing_ || canRead(); });
-  }
-  if (!canRead()) {
+  CAFFE_EVENT(stats_, queue_balance, -static_cast<int64_t>(inputs.size()));
+  int64_t first = 0;
+  const auto count = blockingClaim(true, inputs.size(), timeout_secs, &first);
+  if (count == 0) {
     if (timeout_secs > 0 && !closing_) {
       LOG(ERROR) << "DequeueBlobs timed out in " << timeout_secs << " secs";
       CAFFE_SDT(queue_read_end, name, (void*)this, SDT_TIMEOUT);
     } else {
       CAFFE_SDT(queue_read_end, name, (void*)this, SDT_CANCEL);
     }
-    return false;
+    return 0;
   }
-  DCHECK(canRead());
-  auto& result = queue_[reader_ % queue_.size()];
-  CAFFE_ENFORCE(inputs.size() >= result.size());
-  for (auto i = 0; i < result.size(); ++i) {
-    auto bytes = BlobStat::sizeBytes(*result[i]);
-    CAFFE_EVENT(stats_, queue_dequeued_bytes, bytes, i);
-    using std::swap;
-    swap(*(inputs[i]), *(result[i]));
+  doRead(inputs.slice(0, count), first);
+  CAFFE_EVENT(stats_, read_time_ns, readTimer.NanoSeconds());
+  return count;
+}
+
+bool BlobsQueue::tryRead(const std::vector<Blob*>& inputs) {
+  return tryReadBatch(inputs) == 1;
+}
+
+size_t BlobsQueue::tryReadBatch(c10::ArrayRef<std::vector<Blob*>> inputs) {
+  Timer readTimer;
+  auto keeper = this->shared_from_this();
+  const auto& name = name_.c_str();
+  CAFFE_SDT(queue_read_start, name, (void*)this, SDT_NONBLOCKING_OP);
+  checkRecords(inputs, numBlobs_);
+  int64_t first = 0;
+  const auto count = claim(true, inputs.size(), &first);
+  if (count == 0) {
+    CAFFE_SDT(queue_read_end, name, (void*)this, SDT_ABORT);
+    return 0;
   }
-  CAFFE_SDT(queue_read_end, name, (void*)this, writer_ - reader_);
-  CAFFE_EVENT(stats_, queue_dequeued_records);
-  ++reader_;
-  cv_.notify_all();
+  CAFFE_EVENT(stats_, queue_balance, -static_cast<int64_t>(count));
+  doRead(inputs.slice(0, count), first);
   CAFFE_EVENT(stats_, read_time_ns, readTimer.NanoSeconds());
-  return true;
+  return count;
 }
 
 bool BlobsQueue::tryWrite(const std::vector<Blob*>& inputs) {
+  return tryWriteBatch(inputs) == 1;
+}
+
+size_t BlobsQueue::tryWriteBatch(c10::ArrayRef<std::vector<Blob*>> inputs) {
   Timer writeTimer;
   auto keeper = this->shared_from_this();
   const auto& name = name_.c_str();
   CAFFE_SDT(queue_write_start, name, (void*)this, SDT_NONBLOCKING_OP);
-  std::unique_lock<std::mutex> g(mutex_);
-  if (!canWrite()) {
+  checkRecords(inputs, numBlobs_);
+  int64_t first = 0;
+  const auto count = claim(false, inputs.size(), &first);
+  if (count == 0) {
     CAFFE_SDT(queue_write_end, name, (void*)this, SDT_ABORT);
-    return false;
+    return 0;
   }
   // Increase queue balance before writing to indicate queue write pressure is
   // being increased (+ve queue balance indicates more writes than reads)
-  CAFFE_EVENT(stats_, queue_balance, 1);
-  DCHECK(canWrite());
-  doWrite(inputs);
+  CAFFE_EVENT(stats_, queue_balance, count);
+  doWrite(inputs.slice(0, count), first);
   CAFFE_EVENT(stats_, write_time_ns, writeTimer.NanoSeconds());
-  return true;
+  return count;
 }
 
 bool BlobsQueue::blockingWrite(const std::vector<Blob*>& inputs) {
+  return blockingWriteBatch(inputs) == 1;
+}
+
+size_t BlobsQueue::blockingWriteBatch(
+    c10::ArrayRef<std::vector<Blob*>> inputs) {
   Timer writeTimer;
   auto keeper = this->shared_from_this();
   const auto& name = name_.c_str();
   CAFFE_SDT(queue_write_start, name, (void*)this, SDT_BLOCKING_OP);
-  std::unique_lock<std::mutex> g(mutex_);
+  checkRecords(inputs, numBlobs_);
   // Increase queue balance before writing to indicate queue write pressure is
   // being increased (+ve queue balance indicates more writes than reads)
-  CAFFE_EVENT(stats_, queue_balance, 1);
-  cv_.wait(g, [this]() { return closing_ || canWrite(); });
-  if (!canWrite()) {
-    CAFFE_SDT(queue_write_end, name, (void*)this, SDT_ABORT);
-    return false;
+  CAFFE_EVENT(stats_, queue_balance, inputs.size());
+  size_t written = 0;
+  while (written < inputs.size()) {
+    int64_t first = 0;
+    const auto count =
+        blockingClaim(false, inputs.size() - written, 0.0f, &first);
+    if (count == 0) {
+      CAFFE_SDT(queue_write_end, name, (void*)this, SDT_ABORT);
+      break;
+    }
+    doWrite(inputs.slice(written, count), first);
+    written += count;
   }
-  DCHECK(canWrite());
-  doWrite(inputs);
-  CAFFE_EVENT(stats_, write_time_ns, writeTimer.NanoSeconds());
-  return true;
+  if (written > 0) {
+    CAFFE_EVENT(stats_, write_time_ns, writeTimer.NanoSeconds());
+  }
+  return written;
 }
 
 void BlobsQueue::close() {
   closing_ = true;
 
   std::lock_guard<std::mutex> g(mutex_);
-  cv_.notify_all();
+  readCv_.notify_all();
+  writeCv_.notify_all();
+}
+
+// Claims up to maxCount consecutive slots that are ready to be read (or
+// written), returns the number of claimed slots and the first position.
+size_t BlobsQueue::claim(bool isRead, size_t maxCount, int64_t* first) {
+  auto& position = isRead ? reader_ : writer_;
+  const int64_t readyOffset = isRead ? 1 : 0;
+  const int64_t capacity = slots_.size();
+  maxCount = std::min<size_t>(maxCount, capacity);
+  int64_t pos = position.load(std::memory_order_relaxed);
+  while (true) {
+    size_t count = 0;
+    bool stale = false;
+    for (; count < maxCount; ++count) {
+      const int64_t expected = 2 * ((pos + count) / capacity) + readyOffset;
+      const int64_t sequence = slots_[(pos + count) % capacity].sequence.load(
+          std::memory_order_acquire);
+      if (sequence != expected) {
+        // ahead of us: another thread claimed the slot at pos already,
+        // behind: the queue is empty (full) from here on
+        stale = count == 0 && sequence > expected;
+        break;
+      }
+    }
+    if (count == 0 && !stale) {
+      return 0;
+    }
+    // checking the slots before the claim is safe, only the claim of their
+    // positions can change their state
+    if (count > 0 && position.compare_exchange_weak(pos, pos + count)) {
+      *first = pos;
+      return count;
+    }
+    if (stale) {
+      pos = position.load(std::memory_order_relaxed);
+    }
+    if (isRead) {
+      CAFFE_EVENT(stats_, read_claim_retries);
+    } else {
+      CAFFE_EVENT(stats_, write_claim_retries);
+    }
+  }
+}
+
+// Same as claim(), waits for at least one slot unless the queue is closed
+size_t BlobsQueue::blockingClaim(
+    bool isRead,
+    size_t maxCount,
+    float timeout_secs,
+    int64_t* first) {
+  const auto deadline = std::chrono::steady_clock::now() +
+      std::chrono::milliseconds(int(timeout_secs * 1000));
+  auto& waiting = isRead ? waitingReaders_ : waitingWriters_;
+  auto& cv = isRead ? readCv_ : writeCv_;
+  auto ready = [this, isRead]() {
+    return closing_ || (isRead ? canRead() : canWrite());
+  };
+  while (true) {
+    const auto count = claim(isRead, maxCount, first);
+    if (count > 0 || closing_) {
+      return count;
+    }
+    std::unique_lock<std::mutex> g(mutex_);
+    // registered before checking `ready`, so that the thread making a slot
+    // ready either sees us waiting or we see the slot
+    ++waiting;
+    if (isRead) {
+      CAFFE_EVENT(stats_, blocked_reads);
+    } else {
+      CAFFE_EVENT(stats_, blocked_writes);
+    }
+    bool timedOut = false;
+    if (timeout_secs > 0) {
+      timedOut = !cv.wait_until(g, deadline, ready);
+    } else {
+      cv.wait(g, ready);
+    }
+    --waiting;
+    if (timedOut) {
+      g.unlock();
+      return claim(isRead, maxCount, first);
+    }
+  }
 }
 
-bool BlobsQueue::canWrite() {
-  // writer is always within [reader, reader + size)
-  // we can write if reader is within [reader, reader + size)
-  CAFFE_ENFORCE_LE(reader_, writer_);
-  CAFFE_ENFORCE_LE(writer_, reader_ + queue_.size());
-  return writer_ != reader_ + queue_.size();
+bool BlobsQueue::canRead() const {
+  const int64_t capacity = slots_.size();
+  const int64_t pos = reader_;
+  return slots_[pos % capacity].sequence == 2 * (pos / capacity) + 1;
 }
 
-void BlobsQueue::doWrite(const std::vector<Blob*>& inputs) {
-  auto& result = queue_[writer_ % queue_.size()];
-  CAFFE_ENFORCE(inputs.size() >= result.size());
+bool BlobsQueue::canWrite() const {
+  const int64_t capacity = slots_.size();
+  const int64_t pos = writer_;
+  return slots_[pos % capacity].sequence == 2 * (pos / capacity);
+}
+
+void BlobsQueue::doRead(
+    c10::ArrayRef<std::vector<Blob*>> inputs,
+    int64_t first) {
+  const int64_t capacity = slots_.size();
   const auto& name = name_.c_str();
-  for (auto i = 0; i < result.size(); ++i) {
-    using std::swap;
-    swap(*(inputs[i]), *(result[i]));
+  for (size_t r = 0; r < inputs.size(); ++r) {
+    auto& slot = slots_[(first + r) % capacity];
+    for (auto i = 0; i < slot.blobs.size(); ++i) {
+      auto bytes = BlobStat::sizeBytes(*slot.blobs[i]);
+      CAFFE_EVENT(stats_, queue_dequeued_bytes, bytes, i);
+      using std::swap;
+      swap(*(inputs[r][i]), *(slot.blobs[i]));
+    }
+    // free for the write one lap later
+    slot.sequence = 2 * ((first + r) / capacity) + 2;
+    CAFFE_EVENT(stats_, queue_dequeued_records);
+  }
+  CAFFE_SDT(queue_read_end, name, (void*)this, writer_ - reader_);
+  wakeWriters();
+}
+
+void BlobsQueue::doWrite(
+    c10::ArrayRef<std::vector<Blob*>> inputs,
+    int64_t first) {
+  const int64_t capacity = slots_.size();
+  const auto& name = name_.c_str();
+  for (size_t r = 0; r < inputs.size(); ++r) {
+    auto& slot = slots_[(first + r) % capacity];
+    for (auto i = 0; i < slot.blobs.size(); ++i) {
+      using std::swap;
+      swap(*(inputs[r][i]), *(slot.blobs[i]));
+    }
+    slot.sequence = 2 * ((first + r) / capacity) + 1;
   }
   CAFFE_SDT(
-      queue_write_end, name, (void*)this, reader_ + queue_.size() - writer_);
-  ++writer_;
-  cv_.notify_all();
+      queue_write_end, name, (void*)this, reader_ + capacity - writer_);
+  wakeReaders();
+}
+
+void BlobsQueue::wakeReaders() {
+  if (waitingReaders_ > 0) {
+    std::lock_guard<std::mutex> g(mutex_);
+    readCv_.notify_all();
+  }
+}
+
+void BlobsQueue::wakeWriters() {
+  if (waitingWriters_ > 0) {
+    std::lock_guard<std::mutex> g(mutex_);
+    writeCv_.notify_all();
+  }
 }
 
 } // namespace caffe2
@@ -6,6 +6,8 @@
 #include <mutex>
 #include <queue>
 
+#include <c10/util/ArrayRef.h>
+
 #include "caffe2/core/blob_stats.h"
 #include "caffe2/core/logging.h"
 #include "caffe2/core/stats.h"
@@ -15,7 +17,9 @@
 namespace caffe2 {
 
 // A thread-safe, bounded, blocking queue.
-// Modelled as a circular buffer.
+// Modelled as a circular buffer of slots, the reads and writes claim their
+// slots without a lock (a bounded MPMC queue in the style of Dmitry Vyukov),
+// the mutex is only taken to wait for a slot when the queue is empty or full.
 
 // Containing blobs are owned by the workspace.
 // On read, we swap out the underlying data for the blob passed in for blobs
@@ -37,25 +41,65 @@ class CAFFE2_API BlobsQueue : public std::enable_shared_from_this<BlobsQueue> {
   bool blockingRead(
       const std::vector<Blob*>& inputs,
       float timeout_secs = 0.0f);
+  bool tryRead(const std::vector<Blob*>& inputs);
   bool tryWrite(const std::vector<Blob*>& inputs);
   bool blockingWrite(const std::vector<Blob*>& inputs);
+
+  // Batched versions, one record per element of `inputs`, the records are
+  // claimed together whenever they are available at once.
+  // Reads wait for at least one record and return the number of records read
+  // (0 if the queue is closed and empty, or on timeout).
+  size_t blockingReadBatch(
+      c10::ArrayRef<std::vector<Blob*>> inputs,
+      float timeout_secs = 0.0f);
+  size_t tryReadBatch(c10::ArrayRef<std::vector<Blob*>> inputs);
+  // Writes as many records as the queue has room for.
+  size_t tryWriteBatch(c10::ArrayRef<std::vector<Blob*>> inputs);
+  // Writes all the records, returns the number written (fewer if closed).
+  size_t blockingWriteBatch(c10::ArrayRef<std::vector<Blob*>> inputs);
+
   void close();
   size_t getNumBlobs() const {
     return numBlobs_;
   }
 
  private:
-  bool canWrite();
-  void doWrite(const std::vector<Blob*>& inputs);
+  struct Slot {
+    // for the position p of the slot in lap l = p / capacity:
+    // 2 * l: free for the write at p, 2 * l + 1: holds the record of p
+    std::atomic<int64_t> sequence{0};
+    std::vector<Blob*> blobs;
+  };
+
+  size_t claim(bool isRead, size_t maxCount, int64_t* first);
+  size_t blockingClaim(
+      bool isRead,
+      size_t maxCount,
+      float timeout_secs,
+      int64_t* first);
+  bool canRead() const;
+  bool canWrite() const;
+  void doRead(c10::ArrayRef<std::vector<Blob*>> inputs, int64_t first);
+  void doWrite(c10::ArrayRef<std::vector<Blob*>> inputs, int64_t first);
+  void wakeReaders();
+  void wakeWriters();
 
   std::atomic<bool> closing_{false};
 
   size_t numBlobs_;
-  std::mutex mutex_; // protects all variables in the class.
-  std::condition_variable cv_;
-  int64_t reader_{0};
-  int64_t writer_{0};
-  std::vector<std::vector<Blob*>> queue_;
+  std::vector<Slot> slots_;
+  // next positions to read and write, on separate cache lines
+  char pad0_[64];
+  std::atomic<int64_t> reader_{0};
+  char pad1_[64];
+  std::atomic<int64_t> writer_{0};
+  char pad2_[64];
+
+  std::mutex mutex_; // only used to wait on the condition variables.
+  std::condition_variable readCv_;
+  std::condition_variable writeCv_;
+  std::atomic<int> waitingReaders_{0};
+  std::atomic<int> waitingWriters_{0};
   const std::string name_;
 
   struct QueueStats {
@@ -65,6 +109,11 @@ class CAFFE2_API BlobsQueue : public std::enable_shared_from_this<BlobsQueue> {
     CAFFE_DETAILED_EXPORTED_STAT(queue_dequeued_bytes);
     CAFFE_AVG_EXPORTED_STAT(read_time_ns);
     CAFFE_AVG_EXPORTED_STAT(write_time_ns);
+    // contention: failed claims retried, and waits for an empty / full queue
+    CAFFE_EXPORTED_STAT(read_claim_retries);
+    CAFFE_EXPORTED_STAT(write_claim_retries);
+    CAFFE_EXPORTED_STAT(blocked_reads);
+    CAFFE_EXPORTED_STAT(blocked_writes);
   } stats_;
 };
 } // namespace caffe2
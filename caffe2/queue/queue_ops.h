@@ -130,23 +130,37 @@ class SafeDequeueBlobsOp final : public Operator<Context> {
   bool dequeueMany(std::shared_ptr<BlobsQueue>& queue) {
     auto size = queue->getNumBlobs();
 
-    if (blobs_.size() != size) {
-      blobs_.resize(size);
-      blobPtrs_.resize(size);
-      for (int col = 0; col < size; ++col) {
-        blobPtrs_.at(col) = &blobs_.at(col);
+    if (records_.empty() || records_.front().size() != size) {
+      blobs_.clear();
+      blobs_.resize(numRecords_ * size);
+      records_.assign(numRecords_, std::vector<Blob*>(size));
+      for (int i = 0; i < numRecords_; ++i) {
+        for (int col = 0; col < size; ++col) {
+          records_[i][col] = &blobs_.at(i * size + col);
+        }
       }
     }
 
-    const int kTensorGrowthPct = 40;
-    for (int i = 0; i < numRecords_; ++i) {
-      if (!queue->blockingRead(blobPtrs_)) {
-        // if we read at least one record, status is still true
-        return i > 0;
+    // the records that are already in the queue are read together
+    int numRead = 0;
+    while (numRead < numRecords_) {
+      auto count = queue->blockingReadBatch(
+          c10::ArrayRef<std::vector<Blob*>>(records_).slice(numRead));
+      if (count == 0) {
+        break;
       }
+      numRead += count;
+    }
+    if (numRead == 0) {
+      return false;
+    }
+
+    // if we read at least one record, status is still true
+    const int kTensorGrowthPct = 40;
+    for (int i = 0; i < numRead; ++i) {
       for (int col = 0; col < size; ++col) {
         auto* out = this->Output(col);
-        const auto& in = blobPtrs_.at(col)->template Get<Tensor>();
+        const auto& in = records_[i][col]->template Get<Tensor>();
         if (i == 0) {
           out->CopyFrom(in);
         } else {
@@ -195,7 +209,7 @@ class SafeDequeueBlobsOp final : public Operator<Context> {
  private:
   int numRecords_;
   std::vector<Blob> blobs_;
-  std::vector<Blob*> blobPtrs_;
+  std::vector<std::vector<Blob*>> records_;
 };
 
 template <typename Context>
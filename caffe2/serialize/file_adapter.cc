@@ -2,9 +2,67 @@
 #include <c10/util/Exception.h>
 #include "caffe2/core/common.h"
 
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#endif
+
 namespace caffe2 {
 namespace serialize {
 
+#ifndef _WIN32
+
+FileAdapter::FileAdapter(const std::string& file_name) {
+  fd_ = open(file_name.c_str(), O_RDONLY);
+  if (fd_ < 0) {
+    AT_ERROR("open file failed, file path: ", file_name);
+  }
+  struct stat st;
+  if (fstat(fd_, &st) != 0) {
+    close(fd_);
+    AT_ERROR("stat file failed, file path: ", file_name);
+  }
+  size_ = st.st_size;
+}
+
+size_t FileAdapter::size() const {
+  return size_;
+}
+
+size_t FileAdapter::read(uint64_t pos, void* buf, size_t n, const char* what)
+    const {
+  size_t bytes_read = 0;
+  while (bytes_read < n) {
+    ssize_t result = pread(
+        fd_, static_cast<char*>(buf) + bytes_read, n - bytes_read,
+        pos + bytes_read);
+    if (result < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      AT_ERROR("file reader failed: ", what, ": ", strerror(errno));
+    }
+    if (result == 0) {
+      AT_ERROR("file reader failed: ", what, ": unexpected end of file");
+    }
+    bytes_read += result;
+  }
+  return n;
+}
+
+bool FileAdapter::supportsConcurrentReads() const {
+  return true;
+}
+
+FileAdapter::~FileAdapter() {
+  close(fd_);
+}
+
+#else
+
 FileAdapter::FileAdapter(const std::string& file_name) {
   file_stream_.open(file_name, std::ifstream::in | std::ifstream::binary);
   if (!file_stream_) {
@@ -22,7 +80,13 @@ size_t FileAdapter::read(uint64_t pos, void* buf, size_t n, const char* what)
   return istream_adapter_->read(pos, buf, n, what);
 }
 
+bool FileAdapter::supportsConcurrentReads() const {
+  return false;
+}
+
 FileAdapter::~FileAdapter() {}
 
+#endif
+
 } // namespace serialize
 } // namespace caffe2
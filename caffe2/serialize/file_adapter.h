@@ -17,11 +17,18 @@ class CAFFE2_API FileAdapter final : public ReadAdapterInterface {
   size_t size() const override;
   size_t read(uint64_t pos, void* buf, size_t n, const char* what = "")
       const override;
+  bool supportsConcurrentReads() const override;
   ~FileAdapter();
 
  private:
+#ifndef _WIN32
+  // read with pread, which doesn't move a shared file position
+  int fd_ = -1;
+  size_t size_ = 0;
+#else
   std::ifstream file_stream_;
   std::unique_ptr<IStreamAdapter> istream_adapter_;
+#endif
 };
 
 } // namespace serialize
@@ -180,6 +180,7 @@ static size_t getPadding(
 }
 
 bool PyTorchStreamReader::hasRecord(const std::string& name) {
+  std::lock_guard<std::mutex> guard(reader_lock_);
   std::string ss = archive_name_plus_slash_ + name;
   mz_zip_reader_locate_file(ar_.get(), ss.c_str(), nullptr, 0);
   bool result = ar_->m_last_error != MZ_ZIP_FILE_NOT_FOUND;
@@ -190,6 +191,25 @@ bool PyTorchStreamReader::hasRecord(const std::string& name) {
   return result;
 }
 
+std::vector<std::string> PyTorchStreamReader::getAllRecords() {
+  std::lock_guard<std::mutex> guard(reader_lock_);
+  mz_uint num_files = mz_zip_reader_get_num_files(ar_.get());
+  std::vector<std::string> out;
+  char buf[MZ_ZIP_MAX_ARCHIVE_FILENAME_SIZE];
+  for (mz_uint i = 0; i < num_files; i++) {
+    mz_zip_reader_get_filename(
+        ar_.get(), i, buf, MZ_ZIP_MAX_ARCHIVE_FILENAME_SIZE);
+    valid("getting filename");
+    const std::string name(buf);
+    if (name.compare(
+            0, archive_name_plus_slash_.size(), archive_name_plus_slash_) ==
+        0) {
+      out.push_back(name.substr(archive_name_plus_slash_.size()));
+    }
+  }
+  return out;
+}
+
 size_t PyTorchStreamReader::getRecordID(const std::string& name) {
   std::string ss = archive_name_plus_slash_ + name;
   size_t result = mz_zip_reader_locate_file(ar_.get(), ss.c_str(), nullptr, 0);
@@ -200,18 +220,92 @@ size_t PyTorchStreamReader::getRecordID(const std::string& name) {
   return result;
 }
 
+// records stored uncompressed by PyTorchStreamWriter are read directly,
+// without going through miniz
+static bool isStored(const mz_zip_archive_file_stat& stat) {
+  return stat.m_method == 0 && !stat.m_is_encrypted &&
+      stat.m_comp_size == stat.m_uncomp_size;
+}
+
 // return dataptr, size
 std::tuple<at::DataPtr, size_t> PyTorchStreamReader::getRecord(const std::string& name) {
+  size_t size;
+  {
+    std::lock_guard<std::mutex> guard(reader_lock_);
+    size_t key = getRecordID(name);
+    mz_zip_archive_file_stat stat;
+    mz_zip_reader_file_stat(ar_.get(), key, &stat);
+    valid("retrieving file meta-data for ", name.c_str());
+    size = stat.m_uncomp_size;
+    // records stored aligned can alias the memory of the reader, e.g. of a
+    // MmapFileAdapter, instead of being copied
+    if (isStored(stat)) {
+      size_t offset = getRecordOffsetByID(key);
+      if (offset % kFieldAlignment == 0) {
+        at::DataPtr view = in_->view(offset, size);
+        if (view) {
+          return std::make_tuple(std::move(view), size);
+        }
+      }
+    }
+  }
+  void* ptr = malloc(size);
+  at::DataPtr retval(ptr, ptr, free, at::kCPU);
+  getRecord(name, ptr, size);
+  return std::make_tuple(std::move(retval), size);
+}
+
+void PyTorchStreamReader::getRecord(
+    const std::string& name,
+    void* dst,
+    size_t n) {
+  std::unique_lock<std::mutex> guard(reader_lock_);
   size_t key = getRecordID(name);
   mz_zip_archive_file_stat stat;
   mz_zip_reader_file_stat(ar_.get(), key, &stat);
   valid("retrieving file meta-data for ", name.c_str());
-  void * ptr = malloc(stat.m_uncomp_size);
-  mz_zip_reader_extract_to_mem(ar_.get(), key, ptr, stat.m_uncomp_size, 0);
-  valid("reading file ", name.c_str());
+  CAFFE_ENFORCE_EQ(
+      n, stat.m_uncomp_size, "wrong buffer size for record ", name);
+  if (!isStored(stat)) {
+    mz_zip_reader_extract_to_mem(ar_.get(), key, dst, n, 0);
+    valid("reading file ", name.c_str());
+    return;
+  }
 
-  at::DataPtr retval(ptr, ptr, free, at::kCPU);
-  return std::make_tuple(std::move(retval), stat.m_uncomp_size);
+  size_t offset = getRecordOffsetByID(key);
+  // the archive is only locked while reading if the reader can't read
+  // concurrently, and the CRC is checked in parallel either way
+  if (in_->supportsConcurrentReads()) {
+    guard.unlock();
+  }
+  size_t read = in_->read(offset, dst, n, "reading file");
+  if (guard.owns_lock()) {
+    guard.unlock();
+  }
+  CAFFE_ENFORCE_EQ(read, n, "PytorchStreamReader failed reading file ", name);
+  if (mz_crc32(MZ_CRC32_INIT, static_cast<const unsigned char*>(dst), n) !=
+      stat.m_crc32) {
+    CAFFE_THROW(
+        "PytorchStreamReader failed reading file ",
+        name,
+        ": CRC-32 check failed");
+  }
+}
+
+size_t PyTorchStreamReader::getRecordSize(const std::string& name) {
+  std::lock_guard<std::mutex> guard(reader_lock_);
+  mz_zip_archive_file_stat stat;
+  mz_zip_reader_file_stat(ar_.get(), getRecordID(name), &stat);
+  valid("retrieving file meta-data for ", name.c_str());
+  return stat.m_uncomp_size;
+}
+
+uint32_t PyTorchStreamReader::getRecordCRC32(const std::string& name) {
+  std::lock_guard<std::mutex> guard(reader_lock_);
+  mz_zip_archive_file_stat stat;
+  mz_zip_reader_file_stat(ar_.get(), getRecordID(name), &stat);
+  valid("retrieving file meta-data for ", name.c_str());
+  return stat.m_crc32;
 }
 
 static int64_t read_le_16(uint8_t* buf) {
@@ -219,9 +313,14 @@ static int64_t read_le_16(uint8_t* buf) {
 }
 
 size_t PyTorchStreamReader::getRecordOffset(const std::string& name) {
+  std::lock_guard<std::mutex> guard(reader_lock_);
+  return getRecordOffsetByID(getRecordID(name));
+}
+
+size_t PyTorchStreamReader::getRecordOffsetByID(size_t key) {
   mz_zip_archive_file_stat stat;
-  mz_zip_reader_file_stat(ar_.get(), getRecordID(name), &stat);
-  valid("retrieving file meta-data for ", name.c_str());
+  mz_zip_reader_file_stat(ar_.get(), key, &stat);
+  valid("retrieving file meta-data for record ", std::to_string(key).c_str());
   uint8_t local_header[MZ_ZIP_LOCAL_DIR_HEADER_SIZE];
   in_->read(
       stat.m_local_header_ofs,
@@ -6,6 +6,8 @@
 #include <istream>
 #include <ostream>
 #include <fstream>
+#include <mutex>
+#include <vector>
 
 #include <c10/core/Allocator.h>
 #include <c10/core/Backend.h>
@@ -51,6 +53,13 @@ typedef struct mz_zip_archive mz_zip_archive;
 // 2. It provides a getRecordOffset function which returns the offset into the
 //    raw file where file data lives. If the file was written with PyTorchStreamWriter
 //    it is guarenteed to be 64 byte aligned.
+// 3. getRecord returns records stored aligned and uncompressed without copying
+//    them when the ReadAdapterInterface provides views of its memory, e.g.
+//    MmapFileAdapter.
+// 4. Its methods can be called from several threads at once. Records stored
+//    uncompressed are read outside of miniz with positional reads, which run
+//    in parallel when the ReadAdapterInterface supports it, as does checking
+//    their CRC-32.
 
 // PyTorchReader/Writer handle checking the version number on the archive format
 // and ensure that all files are written to a archive_name directory so they
@@ -104,8 +113,15 @@ class CAFFE2_API PyTorchStreamReader final {
 
   // return dataptr, size
   std::tuple<at::DataPtr, size_t> getRecord(const std::string& name);
+  // reads the record into dst, which holds n = getRecordSize(name) bytes
+  void getRecord(const std::string& name, void* dst, size_t n);
+  size_t getRecordSize(const std::string& name);
   size_t getRecordOffset(const std::string& name);
+  // the CRC-32 of the uncompressed record, from the central directory
+  uint32_t getRecordCRC32(const std::string& name);
   bool hasRecord(const std::string& name);
+  // the names of all the records, relative to the archive directory
+  std::vector<std::string> getAllRecords();
 
   ~PyTorchStreamReader();
   uint64_t version() const {
@@ -116,6 +132,7 @@ class CAFFE2_API PyTorchStreamReader final {
   size_t read(uint64_t pos, char* buf, size_t n);
   void valid(const char* what, const char* info = "");
   size_t getRecordID(const std::string& name);
+  size_t getRecordOffsetByID(size_t key);
 
   friend size_t
   istream_read_func(void* pOpaque, uint64_t file_ofs, void* pBuf, size_t n);
@@ -124,6 +141,8 @@ class CAFFE2_API PyTorchStreamReader final {
   std::string archive_name_plus_slash_;
   std::unique_ptr<ReadAdapterInterface> in_;
   int64_t version_;
+  // guards ar_, and in_ unless it supports concurrent reads
+  std::mutex reader_lock_;
 };
 
 class CAFFE2_API PyTorchStreamWriter final {
@@ -1,10 +1,16 @@
+#include <algorithm>
 #include <cstdio>
 #include <string>
 #include <array>
+#include <thread>
+#include <vector>
 
 #include <gtest/gtest.h>
 
+#include "caffe2/serialize/file_adapter.h"
 #include "caffe2/serialize/inline_container.h"
+#include "caffe2/serialize/mmap_file_adapter.h"
+#include "miniz.h"
 
 namespace caffe2 {
 namespace serialize {
@@ -45,6 +51,9 @@ TEST(PyTorchStreamWriterAndReader, SaveAndLoad) {
   ASSERT_TRUE(reader.hasRecord("key1"));
   ASSERT_TRUE(reader.hasRecord("key2"));
   ASSERT_FALSE(reader.hasRecord("key2000"));
+  std::vector<std::string> records = reader.getAllRecords();
+  ASSERT_NE(std::find(records.begin(), records.end(), "key1"), records.end());
+  ASSERT_NE(std::find(records.begin(), records.end(), "key2"), records.end());
   at::DataPtr data_ptr;
   int64_t size;
   std::tie(data_ptr, size) = reader.getRecord("key1");
@@ -61,6 +70,95 @@ TEST(PyTorchStreamWriterAndReader, SaveAndLoad) {
   ASSERT_EQ(size, data2.size());
   ASSERT_EQ(memcmp(data_ptr.get(), data2.data(), data2.size()), 0);
   ASSERT_EQ(memcmp(the_file.c_str() + off2, data2.data(), data2.size()), 0);
+
+  ASSERT_EQ(
+      reader.getRecordCRC32("key1"),
+      mz_crc32(MZ_CRC32_INIT,
+               reinterpret_cast<const unsigned char*>(data1.data()),
+               data1.size()));
+}
+
+TEST(PyTorchStreamWriterAndReader, LoadMmapped) {
+  const std::string file_name = "mmap_output.zip";
+  std::string data1(127, 'a');
+  std::string data2(4096, 'b');
+  {
+    PyTorchStreamWriter writer(file_name);
+    writer.writeRecord("key1", data1.data(), data1.size());
+    writer.writeRecord("key2", data2.data(), data2.size(), /*compress=*/true);
+    writer.writeEndOfFile();
+  }
+
+  at::DataPtr data_ptr1;
+  at::DataPtr data_ptr2;
+  size_t size1;
+  size_t size2;
+  {
+    PyTorchStreamReader reader(make_unique<MmapFileAdapter>(file_name));
+    std::tie(data_ptr1, size1) = reader.getRecord("key1");
+    std::tie(data_ptr2, size2) = reader.getRecord("key2");
+  }
+  std::remove(file_name.c_str());
+
+  // the uncompressed record points into the mapping, which outlives the
+  // reader, and the compressed one is extracted
+  ASSERT_EQ(size1, data1.size());
+  ASSERT_NE(data_ptr1.get(), data_ptr1.get_context());
+  ASSERT_EQ(reinterpret_cast<uintptr_t>(data_ptr1.get()) % kFieldAlignment, 0);
+  ASSERT_EQ(memcmp(data_ptr1.get(), data1.data(), data1.size()), 0);
+  ASSERT_EQ(size2, data2.size());
+  ASSERT_EQ(data_ptr2.get(), data_ptr2.get_context());
+  ASSERT_EQ(memcmp(data_ptr2.get(), data2.data(), data2.size()), 0);
+}
+
+TEST(PyTorchStreamWriterAndReader, LoadConcurrently) {
+  const std::string file_name = "concurrent_output.zip";
+  constexpr size_t kNumRecords = 16;
+  std::vector<std::string> data;
+  {
+    PyTorchStreamWriter writer(file_name);
+    for (size_t i = 0; i < kNumRecords; ++i) {
+      data.emplace_back(1000 + i, static_cast<char>('a' + i));
+      writer.writeRecord(
+          std::to_string(i), data[i].data(), data[i].size(), i % 2 == 1);
+    }
+    writer.writeEndOfFile();
+  }
+
+  PyTorchStreamReader reader(make_unique<FileAdapter>(file_name));
+  std::vector<std::string> loaded(kNumRecords);
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < kNumRecords; ++i) {
+    threads.emplace_back([&, i]() {
+      auto name = std::to_string(i);
+      loaded[i].resize(reader.getRecordSize(name));
+      reader.getRecord(name, &loaded[i][0], loaded[i].size());
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  std::remove(file_name.c_str());
+  ASSERT_EQ(loaded, data);
+}
+
+TEST(PyTorchStreamWriterAndReader, CheckCRC) {
+  std::ostringstream oss;
+  PyTorchStreamWriter writer([&](const void* b, size_t n) -> size_t {
+    oss.write(static_cast<const char*>(b), n);
+    return oss ? n : 0;
+  });
+  std::string data(100, 'a');
+  writer.writeRecord("key1", data.data(), data.size());
+  writer.writeEndOfFile();
+
+  std::string the_file = oss.str();
+  std::istringstream iss(the_file);
+  PyTorchStreamReader reader(&iss);
+  the_file[reader.getRecordOffset("key1")] = 'b';
+  std::istringstream corrupted_iss(the_file);
+  PyTorchStreamReader corrupted_reader(&corrupted_iss);
+  ASSERT_ANY_THROW(corrupted_reader.getRecord("key1"));
 }
 
 } // namespace
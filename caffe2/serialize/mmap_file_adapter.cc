@@ -0,0 +1,106 @@
+#include "caffe2/serialize/mmap_file_adapter.h"
+#include <c10/util/Exception.h>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#include <fstream>
+#include <sstream>
+#endif
+
+#include <algorithm>
+#include <cstring>
+
+namespace caffe2 {
+namespace serialize {
+
+struct MmapFileAdapter::Mapping {
+  C10_DISABLE_COPY_AND_ASSIGN(Mapping);
+  explicit Mapping(const std::string& file_name) {
+#ifndef _WIN32
+    const int fd = open(file_name.c_str(), O_RDONLY);
+    if (fd < 0) {
+      AT_ERROR("open file failed, file path: ", file_name);
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+      close(fd);
+      AT_ERROR("stat file failed, file path: ", file_name);
+    }
+    size = st.st_size;
+    if (size > 0) {
+      void* ptr =
+          mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+      close(fd);
+      if (ptr == MAP_FAILED) {
+        AT_ERROR("mmap file failed, file path: ", file_name);
+      }
+      data = static_cast<char*>(ptr);
+    } else {
+      close(fd);
+    }
+#else
+    std::ifstream file(file_name, std::ifstream::in | std::ifstream::binary);
+    if (!file) {
+      AT_ERROR("open file failed, file path: ", file_name);
+    }
+    std::stringstream contents;
+    contents << file.rdbuf();
+    buffer = contents.str();
+    data = &buffer[0];
+    size = buffer.size();
+#endif
+  }
+
+  ~Mapping() {
+#ifndef _WIN32
+    if (data) {
+      munmap(data, size);
+    }
+#endif
+  }
+
+  char* data = nullptr;
+  size_t size = 0;
+#ifdef _WIN32
+  std::string buffer;
+#endif
+};
+
+MmapFileAdapter::MmapFileAdapter(const std::string& file_name)
+    : mapping_(std::make_shared<Mapping>(file_name)) {}
+
+size_t MmapFileAdapter::size() const {
+  return mapping_->size;
+}
+
+size_t MmapFileAdapter::read(uint64_t pos, void* buf, size_t n, const char* what)
+    const {
+  if (pos >= mapping_->size) {
+    return 0;
+  }
+  n = std::min<size_t>(n, mapping_->size - pos);
+  std::memcpy(buf, mapping_->data + pos, n);
+  return n;
+}
+
+at::DataPtr MmapFileAdapter::view(uint64_t pos, size_t n) const {
+  if (n == 0 || pos + n > mapping_->size) {
+    return at::DataPtr();
+  }
+  // each view keeps the mapping alive
+  auto ctx = new std::shared_ptr<Mapping>(mapping_);
+  return at::DataPtr(
+      mapping_->data + pos,
+      ctx,
+      [](void* ctx) { delete static_cast<std::shared_ptr<Mapping>*>(ctx); },
+      at::kCPU);
+}
+
+MmapFileAdapter::~MmapFileAdapter() {}
+
+} // namespace serialize
+} // namespace caffe2
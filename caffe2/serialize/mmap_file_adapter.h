@@ -0,0 +1,37 @@
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "c10/macros/Macros.h"
+#include "caffe2/serialize/read_adapter_interface.h"
+
+namespace caffe2 {
+namespace serialize {
+
+// this is a reader mapping the whole file in memory, whose views share the
+// mapping: the records of a PyTorchStreamReader reading from it, e.g. tensor
+// storages, point into the page cache instead of being copied.
+// The mapping is private, so writing to a view copies the page rather than
+// changing the file, and it is unmapped when the adapter and all the views
+// are gone. Windows reads the file into memory instead.
+class CAFFE2_API MmapFileAdapter final : public ReadAdapterInterface {
+ public:
+  C10_DISABLE_COPY_AND_ASSIGN(MmapFileAdapter);
+  explicit MmapFileAdapter(const std::string& file_name);
+  size_t size() const override;
+  size_t read(uint64_t pos, void* buf, size_t n, const char* what = "")
+      const override;
+  at::DataPtr view(uint64_t pos, size_t n) const override;
+  bool supportsConcurrentReads() const override {
+    return true;
+  }
+  ~MmapFileAdapter();
+
+ private:
+  struct Mapping;
+  std::shared_ptr<Mapping> mapping_;
+};
+
+} // namespace serialize
+} // namespace caffe2
@@ -3,6 +3,7 @@
 #include <cstddef>
 #include <cstdint>
 
+#include "c10/core/Allocator.h"
 #include "c10/macros/Macros.h"
 
 namespace caffe2 {
@@ -16,6 +17,11 @@ class CAFFE2_API ReadAdapterInterface {
   virtual size_t size() const = 0;
   virtual size_t read(uint64_t pos, void* buf, size_t n, const char* what = "")
       const = 0;
+  // returns n bytes at pos aliasing the memory of the reader rather than
+  // copying them, or an empty DataPtr if the reader can't (the default)
+  virtual at::DataPtr view(uint64_t pos, size_t n) const;
+  // whether read can be called from several threads at once (default false)
+  virtual bool supportsConcurrentReads() const;
   virtual ~ReadAdapterInterface();
 };
 
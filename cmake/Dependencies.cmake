@@ -555,6 +555,21 @@ else()
 endif()
 
 
+# ---[ LLVM
+if(USE_LLVM)
+  find_package(LLVM CONFIG)
+  if(LLVM_FOUND)
+    message(STATUS "Found LLVM ${LLVM_PACKAGE_VERSION} in ${LLVM_DIR}")
+    include_directories(SYSTEM ${LLVM_INCLUDE_DIRS})
+    add_definitions(${LLVM_DEFINITIONS})
+    llvm_map_components_to_libnames(LLVM_LIBRARIES core orcjit passes native)
+    list(APPEND Caffe2_DEPENDENCY_LIBS ${LLVM_LIBRARIES})
+  else()
+    message(WARNING "Not compiling with LLVM. Suppress this warning with -DUSE_LLVM=OFF")
+    caffe2_update_option(USE_LLVM OFF)
+  endif()
+endif()
+
 # ---[ LMDB
 if(USE_LMDB)
   find_package(LMDB)
@@ -1127,6 +1142,7 @@ if (USE_ZSTD)
   include_directories(SYSTEM ${CMAKE_CURRENT_LIST_DIR}/../third_party/zstd/lib)
   add_subdirectory(${CMAKE_CURRENT_LIST_DIR}/../third_party/zstd/build/cmake)
   set_property(TARGET libzstd_static PROPERTY POSITION_INDEPENDENT_CODE ON)
+  set(CAFFE2_USE_ZSTD 1)
 endif()
 
 # ---[ Onnx
@@ -25,6 +25,22 @@ SET(AVX2_CODE "
   }
 ")
 
+SET(AVX512_CODE "
+  #include <immintrin.h>
+
+  int main()
+  {
+    __m512i a = _mm512_set1_epi64(0);
+    a = _mm512_mullo_epi64(a, a); // AVX512DQ
+    __m512 b = _mm512_set1_ps(0);
+    b = _mm512_fmadd_ps(b, b, b);
+    __mmask16 m = _mm512_cmp_ps_mask(b, b, _CMP_EQ_OQ);
+    b = _mm512_mask_blend_ps(m, b, b);
+    __m256i c = _mm256_abs_epi64(_mm256_set1_epi64x(0)); // AVX512VL
+    return 0;
+  }
+")
+
 MACRO(CHECK_SSE lang type flags)
   SET(__FLAG_I 1)
   SET(CMAKE_REQUIRED_FLAGS_SAVE ${CMAKE_REQUIRED_FLAGS})
@@ -59,3 +75,4 @@ CHECK_SSE(C "AVX2" " ;-mavx2 -mfma;/arch:AVX2")
 
 CHECK_SSE(CXX "AVX" " ;-mavx;/arch:AVX")
 CHECK_SSE(CXX "AVX2" " ;-mavx2 -mfma;/arch:AVX2")
+CHECK_SSE(CXX "AVX512" " ;-mavx512f -mavx512dq -mavx512bw -mavx512vl -mfma")
@@ -95,6 +95,7 @@ function (caffe2_print_configuration_summary)
     message(STATUS "    Snappy version      : ${Snappy_VERSION}")
   endif()
   message(STATUS "  USE_LITE_PROTO        : ${USE_LITE_PROTO}")
+  message(STATUS "  USE_LLVM              : ${USE_LLVM}")
   message(STATUS "  USE_LMDB              : ${USE_LMDB}")
   if(${USE_LMDB})
     message(STATUS "    LMDB version        : ${LMDB_VERSION}")
@@ -79,6 +79,10 @@
 #   USE_LMDB
 #     enables use of LMDB for storage
 #
+#   USE_LLVM
+#     compiles the kernels of the CPU fuser in process with LLVM's ORC JIT
+#     (needs LLVM 14 or newer, found through LLVM_DIR)
+#
 #   BUILD_BINARY
 #     enables the additional binaries/ build
 #
@@ -156,6 +160,8 @@
 #       OMP - use OpenMP for intra-op and native backend for inter-op tasks
 #       NATIVE - use native thread pool for both intra- and inter-op tasks
 #       TBB - using TBB for intra- and native thread pool for inter-op parallelism
+#       WORK_STEALING - use a work-stealing thread pool for intra-op and native
+#         backend for inter-op tasks
 #
 #   USE_TBB
 #      enable TBB support
@@ -839,6 +845,7 @@ if __name__ == '__main__':
                 'include/torch/csrc/autograd/utils/*.h',
                 'include/torch/csrc/cuda/*.h',
                 'include/torch/csrc/jit/*.h',
+                'include/torch/csrc/jit/aot/*.h',
                 'include/torch/csrc/jit/generated/*.h',
                 'include/torch/csrc/jit/passes/*.h',
                 'include/torch/csrc/jit/passes/utils/*.h',
@@ -1,6 +1,7 @@
 #include <gtest/gtest.h>
 
 #include <torch/torch.h>
+#include <torch/csrc/autograd/engine.h>
 
 #include <test/cpp/api/support.h>
 
@@ -123,6 +124,242 @@ TEST(AutogradAPITests, GradUnreachableTest) {
   ASSERT_FALSE(grad_res[1].defined());
 }
 
+TEST(AutogradAPITests, EngineStatsTest) {
+  auto& engine = Engine::get_default_engine();
+  const auto before = engine.stats();
+  Variable x = torch::randn({2, 2}, torch::requires_grad());
+  auto y = x;
+  for (int i = 0; i < 10; i++) {
+    y = y * 2;
+  }
+  backward({y.sum()}, {});
+  const auto after = engine.stats();
+
+  // GraphRoot, SumBackward, 10 MulBackwards and AccumulateGrad
+  const auto pushed = after.tasks_pushed - before.tasks_pushed;
+  ASSERT_EQ(pushed, 13);
+  ASSERT_EQ(after.tasks_popped - before.tasks_popped, pushed);
+  ASSERT_GE(after.batches - before.batches, 1);
+  ASSERT_LE(after.batches - before.batches, pushed);
+}
+
+TEST(AutogradAPITests, CheckpointTest) {
+  Variable x = torch::randn({4, 4}, torch::requires_grad());
+  Variable w = torch::randn({4, 4}, torch::requires_grad());
+  int calls = 0;
+  auto fn = [&](const variable_list& inputs) -> variable_list {
+    calls++;
+    auto h = inputs[0].mm(w).tanh();
+    return {h.mm(w).sigmoid()};
+  };
+  auto expected = grad({fn({x})[0].sum()}, {x, w});
+
+  auto out = checkpoint(fn, {x})[0].sum();
+  ASSERT_EQ(calls, 2);
+  auto res = grad({out}, {x, w});
+  // Run again for backward
+  ASSERT_EQ(calls, 3);
+  ASSERT_VARIABLE_EQ(res[0], expected[0]);
+  ASSERT_VARIABLE_EQ(res[1], expected[1]);
+}
+
+TEST(AutogradAPITests, CheckpointDropoutTest) {
+  Variable x = torch::randn({64}, torch::requires_grad());
+  auto fn = [](const variable_list& inputs) -> variable_list {
+    return {torch::dropout(inputs[0] * 2, 0.5, /*train=*/true).exp()};
+  };
+  auto out = checkpoint(fn, {x})[0];
+  // The rerun for backward draws the same dropout mask
+  out.sum().backward();
+  ASSERT_VARIABLE_EQ(x.grad(), torch::where(out == 1, torch::zeros_like(out), out * 4));
+}
+
+TEST(AutogradAPITests, CheckpointModifiedInputTest) {
+  Variable x = torch::randn({4}, torch::requires_grad());
+  auto y = x * 2;
+  auto out = checkpoint([](const variable_list& inputs) -> variable_list {
+    return {inputs[0].exp()};
+  }, {y})[0];
+  y.add_(1);
+  ASSERT_THROWS_WITH(out.sum().backward(), "modified by an inplace operation");
+}
+
+TEST(AutogradAPITests, SavedTensorHooksTest) {
+  struct CountingHooks : SavedTensorHooks {
+    struct Packed : PackedTensor {
+      Packed(at::Tensor data, int& unpacks) : data_(std::move(data)), unpacks_(unpacks) {}
+      at::Tensor unpack() override {
+        unpacks_++;
+        return data_;
+      }
+      at::Tensor data_;
+      int& unpacks_;
+    };
+
+    std::shared_ptr<PackedTensor> pack(const at::Tensor& data) override {
+      packs++;
+      return std::make_shared<Packed>(data.clone(), unpacks);
+    }
+
+    int packs = 0;
+    int unpacks = 0;
+  };
+
+  auto hooks = std::make_shared<CountingHooks>();
+  Variable x = torch::randn({4}, torch::requires_grad());
+  Variable y;
+  {
+    SavedTensorHooksGuard guard(hooks);
+    y = (x * x).exp();
+  }
+  // MulBackward saves both of its inputs, ExpBackward its result
+  ASSERT_EQ(hooks->packs, 3);
+  y.sum().backward();
+  ASSERT_EQ(hooks->unpacks, 3);
+  ASSERT_VARIABLE_EQ(x.grad(), 2 * x * y);
+}
+
+TEST(AutogradAPITests, HostOffloadTest_CUDA) {
+  const auto options = torch::TensorOptions(torch::kCUDA).requires_grad(true);
+  Variable x = torch::randn({64, 64}, options);
+  Variable w = torch::randn({64, 64}, options);
+  auto fn = [&] {
+    auto h = x;
+    for (int i = 0; i < 4; i++) {
+      h = h.mm(w).tanh();
+    }
+    return h.sum();
+  };
+  auto expected = grad({fn()}, {x, w});
+
+  Variable loss;
+  {
+    SavedTensorHooksGuard guard(std::make_shared<HostOffload>(/*min_bytes=*/0));
+    loss = fn();
+  }
+  auto res = grad({loss}, {x, w});
+  ASSERT_VARIABLE_EQ(res[0], expected[0]);
+  ASSERT_VARIABLE_EQ(res[1], expected[1]);
+}
+
+TEST(AutogradAPITests, ReducedPrecisionSaveTest) {
+  struct DtypeHooks : SavedTensorHooks {
+    std::shared_ptr<PackedTensor> pack(const at::Tensor& data) override {
+      dtypes.push_back(data.scalar_type());
+      return nullptr;
+    }
+    std::vector<at::ScalarType> dtypes;
+  };
+
+  Variable x = torch::randn({8, 8}, torch::dtype(torch::kDouble).requires_grad(true));
+  Variable w = torch::randn({8, 8}, torch::dtype(torch::kDouble).requires_grad(true));
+  auto expected = grad({x.mm(w).tanh().sum()}, {x, w});
+
+  for (auto dtype : {torch::kHalf, torch::kBFloat16}) {
+    auto next = std::make_shared<DtypeHooks>();
+    Variable loss;
+    {
+      SavedTensorHooksGuard guard(std::make_shared<ReducedPrecisionSave>(dtype, 0, next));
+      loss = x.mm(w).tanh().sum();
+    }
+    // MmBackward saves both inputs, TanhBackward its result
+    ASSERT_EQ(next->dtypes, std::vector<at::ScalarType>(3, dtype));
+    auto res = grad({loss}, {x, w});
+    ASSERT_EQ(res[0].scalar_type(), torch::kDouble);
+    ASSERT_TRUE(torch::allclose(res[0], expected[0], 5e-2, 5e-2));
+    ASSERT_TRUE(torch::allclose(res[1], expected[1], 5e-2, 5e-2));
+  }
+
+  // Integral tensors are left alone
+  Variable y = torch::randn({4, 6}, torch::requires_grad());
+  Variable values;
+  {
+    SavedTensorHooksGuard guard(std::make_shared<ReducedPrecisionSave>());
+    values = std::get<0>(y.max(1));
+  }
+  values.sum().backward();
+  ASSERT_VARIABLE_EQ(y.grad().sum(1), torch::ones({4}));
+
+  ASSERT_THROWS_WITH(ReducedPrecisionSave(torch::kInt), "expected Half or BFloat16");
+}
+
+TEST(AutogradAPITests, StaticGraphTest) {
+  Variable w = torch::randn({3, 3}, torch::requires_grad());
+  Variable w_ref = w.detach().requires_grad_();
+  StaticGraph graph;
+  std::vector<Node*> nodes;
+  for (int step = 0; step < 3; step++) {
+    auto x = torch::randn({2, 3});
+    x.mm(w_ref).tanh().index({torch::tensor({0, 2})}).sum().backward();
+    {
+      StaticGraphGuard guard(graph);
+      auto y = x.mm(w).tanh().index({torch::tensor({0, 2})}).sum();
+      nodes.push_back(y.grad_fn().get());
+      y.backward();
+    }
+    ASSERT_VARIABLE_EQ(w.grad(), w_ref.grad());
+  }
+  ASSERT_EQ(graph.num_recorded(), 4);
+  ASSERT_EQ(nodes[0], nodes[2]);
+  ASSERT_EQ(graph.num_reused_dependencies(), 2);
+}
+
+TEST(AutogradAPITests, StaticGraphChangedTest) {
+  Variable x = torch::randn({3}, torch::requires_grad());
+  StaticGraph graph;
+  {
+    StaticGraphGuard guard(graph);
+    (x * 2).sum().backward();
+  }
+  {
+    StaticGraphGuard guard(graph);
+    (x * 2).exp().sum().backward();
+  }
+  ASSERT_EQ(graph.num_recorded(), 3);
+  ASSERT_EQ(graph.num_reused_dependencies(), 0);
+  ASSERT_VARIABLE_EQ(x.grad(), 2 + 2 * (x * 2).exp());
+
+  // Carrying the graph of a step into the next one
+  Variable w = torch::randn({3}, torch::requires_grad());
+  auto h = torch::ones({3});
+  for (int step = 0; step < 2; step++) {
+    StaticGraphGuard guard(graph);
+    h = (h * w).tanh().detach();
+  }
+  {
+    StaticGraphGuard guard(graph);
+    h = (h * w).tanh();
+  }
+  {
+    StaticGraphGuard guard(graph);
+    ASSERT_THROWS_WITH((h * w), "from the previous step");
+  }
+}
+
+TEST(AutogradAPITests, FlattenGradsTest) {
+  Variable a = torch::randn({2, 3}, torch::requires_grad());
+  Variable b = torch::randn({4}, torch::requires_grad());
+  Variable c = torch::randn({2}, torch::dtype(torch::kDouble).requires_grad(true));
+  (b * 2).sum().backward();
+  auto buffers = flatten_grads({a, b, c});
+  ASSERT_EQ(buffers.size(), 2);
+  ASSERT_EQ(buffers[0].numel(), 10);
+  ASSERT_EQ(buffers[1].numel(), 2);
+  ASSERT_EQ(a.grad().data_ptr(), buffers[0].data_ptr());
+  ASSERT_VARIABLE_EQ(buffers[0], torch::cat({torch::zeros({6}), torch::full({4}, 2)}));
+
+  for (int step = 0; step < 2; step++) {
+    (a * 3).sum().backward();
+    (c * b.sum()).sum().backward();
+  }
+  ASSERT_EQ(b.grad().data_ptr<float>(), buffers[0].data_ptr<float>() + 6);
+  ASSERT_VARIABLE_EQ(a.grad(), torch::full({2, 3}, 6));
+  ASSERT_VARIABLE_EQ(buffers[1], 2 * b.sum().to(torch::kDouble).expand({2}));
+  a.grad().detach_();
+  a.grad().zero_();
+  ASSERT_VARIABLE_EQ(buffers[0].narrow(0, 0, 6), torch::zeros({6}));
+}
+
 TEST(CustomAutogradTest, CustomFunction) {
   struct MyFunction : public Function<MyFunction> {
     static Variable forward(AutogradContext *ctx, Variable var1, int mul, Variable var2) {
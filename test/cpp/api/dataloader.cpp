@@ -2302,4 +2302,308 @@ TEST(DataLoaderTest, CustomPreprocessPolicy) {
       }
     }
   }
-}
\ No newline at end of file
+}
+TEST(DataTest, ExampleNBytes) {
+  ASSERT_EQ(datasets::detail::example_nbytes(3), sizeof(int));
+  ASSERT_EQ(datasets::detail::example_nbytes(std::string("abc")), 3);
+  ASSERT_EQ(
+      datasets::detail::example_nbytes(torch::ones({2, 3}, torch::kFloat)),
+      6 * sizeof(float));
+  ASSERT_EQ(datasets::detail::example_nbytes(torch::Tensor()), 0);
+  ASSERT_EQ(
+      datasets::detail::example_nbytes(
+          Example<>(torch::ones(4, torch::kFloat), torch::ones(1, torch::kLong))),
+      4 * sizeof(float) + sizeof(int64_t));
+  ASSERT_EQ(
+      datasets::detail::example_nbytes(std::vector<int>{1, 2, 3}),
+      3 * sizeof(int));
+}
+
+TEST(DataLoaderTest, ChunkDatasetWithCacheBytes) {
+  const size_t batch_size = 5;
+  const size_t total_example_count = 35;
+  DummyChunkDataReader data_reader;
+  samplers::SequentialSampler sampler(0);
+
+  // at most a couple of batches fit in the cache at a time.
+  for (size_t cache_bytes : {sizeof(int), 2 * batch_size * sizeof(int)}) {
+    datasets::SharedBatchDataset<datasets::ChunkDataset<
+        DummyChunkDataReader,
+        samplers::SequentialSampler,
+        samplers::SequentialSampler>>
+        dataset = datasets::make_shared_dataset<datasets::ChunkDataset<
+            DummyChunkDataReader,
+            samplers::SequentialSampler,
+            samplers::SequentialSampler>>(
+            data_reader,
+            sampler,
+            sampler,
+            datasets::ChunkDatasetOptions(2, batch_size)
+                .cache_bytes(cache_bytes));
+
+    auto data_loader = torch::data::make_data_loader(
+        dataset, DataLoaderOptions(batch_size).workers(0));
+
+    std::vector<bool> result(total_example_count, false);
+    for (auto iterator = data_loader->begin(); iterator != data_loader->end();
+         ++iterator) {
+      DummyChunkDataReader::BatchType& batch = *iterator;
+      ASSERT_EQ(batch.size(), batch_size);
+      for (auto data : batch) {
+        result[data] = true;
+      }
+    }
+
+    for (auto data : result) {
+      ASSERT_EQ(data, true);
+    }
+  }
+}
+
+TEST(DataLoaderTest, ChunkDatasetWithAdaptivePreloaderCount) {
+  const size_t batch_size = 5;
+  const size_t total_example_count = 35;
+  DummyChunkDataReader data_reader;
+  samplers::SequentialSampler sampler(0);
+
+  // test functionality across epoch boundary
+  const int epoch_count = 3;
+
+  for (size_t preloader_count : {1, 4}) {
+    datasets::SharedBatchDataset<datasets::ChunkDataset<
+        DummyChunkDataReader,
+        samplers::SequentialSampler,
+        samplers::SequentialSampler>>
+        dataset = datasets::make_shared_dataset<datasets::ChunkDataset<
+            DummyChunkDataReader,
+            samplers::SequentialSampler,
+            samplers::SequentialSampler>>(
+            data_reader,
+            sampler,
+            sampler,
+            datasets::ChunkDatasetOptions(preloader_count, batch_size)
+                .adaptive_preloader_count(true));
+
+    auto data_loader = torch::data::make_data_loader(
+        dataset, DataLoaderOptions(batch_size).workers(2));
+
+    for (int epoch_index = 0; epoch_index < epoch_count; ++epoch_index) {
+      std::vector<bool> result(total_example_count, false);
+      for (auto iterator = data_loader->begin();
+           iterator != data_loader->end();
+           ++iterator) {
+        DummyChunkDataReader::BatchType& batch = *iterator;
+        ASSERT_EQ(batch.size(), batch_size);
+        for (auto data : batch) {
+          result[data] = true;
+        }
+      }
+
+      for (auto data : result) {
+        ASSERT_EQ(data, true);
+      }
+    }
+  }
+}
+
+TEST(DataLoaderTest, PrefetchToDeviceReturnsAllBatchesInOrder) {
+  auto tensor = torch::arange(20, torch::kFloat).reshape({10, 2});
+  for (size_t workers : {0, 2}) {
+    for (size_t prefetch_count : {1, 3, 20}) {
+      auto data_loader = torch::data::make_data_loader(
+          datasets::TensorDataset(tensor).map(
+              transforms::Stack<TensorExample>()),
+          samplers::SequentialSampler(10),
+          DataLoaderOptions(3)
+              .workers(workers)
+              .prefetch_to_device(torch::kCPU)
+              .device_prefetch_count(prefetch_count));
+      for (int epoch = 0; epoch < 2; ++epoch) {
+        int64_t offset = 0;
+        for (auto& batch : *data_loader) {
+          ASSERT_TRUE(batch.data.device().is_cpu());
+          ASSERT_TRUE(batch.data.allclose(
+              tensor.narrow(0, offset, batch.data.size(0))));
+          offset += batch.data.size(0);
+        }
+        ASSERT_EQ(offset, 10);
+      }
+    }
+  }
+}
+
+TEST(DataLoaderTest, PinMemoryAndPrefetchToDevice_CUDA) {
+  auto tensor = torch::arange(20, torch::kFloat).reshape({10, 2});
+  for (size_t workers : {0, 2}) {
+    auto data_loader = torch::data::make_data_loader(
+        datasets::TensorDataset(tensor).map(transforms::Stack<TensorExample>()),
+        samplers::SequentialSampler(10),
+        DataLoaderOptions(3)
+            .workers(workers)
+            .pin_memory(true)
+            .prefetch_to_device(torch::Device(torch::kCUDA, 0)));
+    int64_t offset = 0;
+    for (auto& batch : *data_loader) {
+      ASSERT_TRUE(batch.data.is_cuda());
+      ASSERT_TRUE(batch.data.cpu().allclose(
+          tensor.narrow(0, offset, batch.data.size(0))));
+      offset += batch.data.size(0);
+    }
+    ASSERT_EQ(offset, 10);
+  }
+}
+
+TEST(DataLoaderTest, PinMemory_CUDA) {
+  auto data_loader = torch::data::make_data_loader(
+      datasets::TensorDataset(torch::ones({10, 2}))
+          .map(transforms::Stack<TensorExample>()),
+      DataLoaderOptions(5).workers(2).pin_memory(true));
+  for (auto& batch : *data_loader) {
+    ASSERT_TRUE(batch.data.is_pinned());
+  }
+}
+
+struct SquaresDataset : datasets::PreallocatedDataset<SquaresDataset> {
+  explicit SquaresDataset(std::shared_ptr<datasets::BatchBufferPool> pool)
+      : PreallocatedDataset({2}, torch::kFloat, {}, torch::kLong, pool) {}
+
+  void get_into(size_t index, torch::Tensor data, torch::Tensor target)
+      override {
+    data.fill_(static_cast<double>(index * index));
+    target.fill_(static_cast<int64_t>(index));
+  }
+
+  torch::optional<size_t> size() const override {
+    return 10;
+  }
+};
+
+TEST(DataTest, BatchBufferPoolReusesReleasedBuffers) {
+  auto pool = std::make_shared<datasets::BatchBufferPool>(/*max_free_buffers=*/1);
+  auto first = pool->acquire({4, 3}, torch::kFloat);
+  const auto* first_data = first.data_ptr();
+  ASSERT_EQ(pool->free_buffers(), 0);
+  first = torch::Tensor();
+  ASSERT_EQ(pool->free_buffers(), 1);
+
+  // A smaller tensor reuses the buffer, a larger one does not fit in it.
+  auto second = pool->acquire({2, 3}, torch::kFloat);
+  ASSERT_EQ(second.data_ptr(), first_data);
+  ASSERT_EQ(second.sizes(), std::vector<int64_t>({2, 3}));
+  ASSERT_EQ(pool->free_buffers(), 0);
+  auto third = pool->acquire({5, 3}, torch::kFloat);
+  ASSERT_NE(third.data_ptr(), first_data);
+
+  // Only max_free_buffers buffers are kept.
+  second = torch::Tensor();
+  third = torch::Tensor();
+  ASSERT_EQ(pool->free_buffers(), 1);
+}
+
+TEST(DataLoaderTest, PreallocatedDatasetWritesIntoBatches) {
+  auto pool = std::make_shared<datasets::BatchBufferPool>();
+  for (size_t workers : {0, 2}) {
+    auto data_loader = torch::data::make_data_loader(
+        SquaresDataset(pool),
+        samplers::SequentialSampler(10),
+        DataLoaderOptions(4).workers(workers));
+    for (int epoch = 0; epoch < 2; ++epoch) {
+      int64_t index = 0;
+      for (auto& batch : *data_loader) {
+        ASSERT_EQ(batch.data.size(1), 2);
+        for (int64_t i = 0; i < batch.data.size(0); ++i, ++index) {
+          ASSERT_EQ(batch.target[i].item<int64_t>(), index);
+          ASSERT_TRUE(batch.data[i].eq(index * index).all().item<bool>());
+        }
+      }
+      ASSERT_EQ(index, 10);
+    }
+  }
+  // The batches have been released back into the pool.
+  ASSERT_GT(pool->free_buffers(), 0);
+}
+
+TEST(DataTest, RecordDatasetReadsWrittenRecords) {
+  auto tempfile = c10::make_tempfile();
+  std::vector<Example<>> examples;
+  {
+    datasets::RecordWriter writer(tempfile.name);
+    for (int64_t i = 0; i < 5; ++i) {
+      // Mix types and sizes, to exercise the alignment of the records.
+      examples.push_back(
+          {torch::arange(i + 1, torch::kDouble).reshape({1, i + 1}),
+           torch::full({}, i, torch::kLong)});
+      writer.write(examples.back());
+      writer.write(torch::ones(i, torch::kByte));
+    }
+    ASSERT_EQ(writer.size(), 10);
+  }
+
+  datasets::RecordDataset dataset(tempfile.name);
+  ASSERT_EQ(dataset.size().value(), 10);
+  for (size_t i = 0; i < 5; ++i) {
+    auto example = dataset.get(2 * i);
+    ASSERT_TRUE(example.data.equal(examples[i].data));
+    ASSERT_TRUE(example.target.equal(examples[i].target));
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(example.data.data_ptr()) % 64, 0);
+
+    auto untargeted = dataset.get(2 * i + 1);
+    ASSERT_TRUE(untargeted.data.equal(torch::ones(i, torch::kByte)));
+    ASSERT_FALSE(untargeted.target.defined());
+  }
+  ASSERT_THROWS_WITH(dataset.get(10), "out of range");
+}
+
+TEST(DataTest, RecordDatasetViewsOutliveDataset) {
+  auto tempfile = c10::make_tempfile();
+  {
+    datasets::RecordWriter writer(tempfile.name);
+    writer.write(torch::arange(10, torch::kFloat));
+    writer.close();
+    ASSERT_THROWS_WITH(writer.write(torch::ones(1)), "closed");
+  }
+  torch::Tensor data;
+  {
+    datasets::RecordDataset dataset(tempfile.name);
+    data = dataset.get(0).data;
+  }
+  ASSERT_TRUE(data.equal(torch::arange(10, torch::kFloat)));
+}
+
+TEST(DataTest, RecordDatasetRejectsOtherFiles) {
+  auto tempfile = c10::make_tempfile();
+  torch::save(torch::ones(10), tempfile.name);
+  ASSERT_THROWS_WITH(
+      datasets::RecordDataset(tempfile.name), "is not a record file");
+}
+
+TEST(DataLoaderTest, RecordDatasetWithDistributedRandomSampler) {
+  auto tempfile = c10::make_tempfile();
+  {
+    datasets::RecordWriter writer(tempfile.name);
+    for (int64_t i = 0; i < 20; ++i) {
+      writer.write(
+          torch::full({3}, i, torch::kFloat), torch::full({}, i, torch::kLong));
+    }
+  }
+
+  const size_t num_replicas = 2;
+  std::vector<bool> seen(20, false);
+  for (size_t rank = 0; rank < num_replicas; ++rank) {
+    auto data_loader = torch::data::make_data_loader(
+        datasets::RecordDataset(tempfile.name).map(transforms::Stack<>()),
+        samplers::DistributedRandomSampler(20, num_replicas, rank),
+        DataLoaderOptions(4).workers(2));
+    for (auto& batch : *data_loader) {
+      for (int64_t i = 0; i < batch.target.size(0); ++i) {
+        const auto index = batch.target[i].item<int64_t>();
+        ASSERT_TRUE(batch.data[i].eq(index).all().item<bool>());
+        ASSERT_FALSE(seen[index]);
+        seen[index] = true;
+      }
+    }
+  }
+  for (auto value : seen) {
+    ASSERT_TRUE(value);
+  }
+}
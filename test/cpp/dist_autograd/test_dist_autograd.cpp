@@ -89,10 +89,28 @@ TEST_F(DistAutogradTest, TestInitializedContextCleanupSendFunction) {
   sendFunction->setGrads({t});
 
   // Execute engine.
-  engine.executeSendFunction(context, sendFunction);
+  engine.executeSendFunctionAsync(context, sendFunction)->wait();
 
   // Validate appropriate cleanup.
   ASSERT_EQ(0, engine.numBackwardPasses());
+  ASSERT_EQ(0, context->stats().numSendFunctions);
+}
+
+TEST_F(DistAutogradTest, TestGradientAccumulationStats) {
+  autogradContainer_->newContext();
+  auto context = autogradContainer_->currentContext();
+  auto& engine = DistEngine::getInstance();
+
+  auto options = at::TensorOptions().requires_grad(true);
+  auto t = torch::ones({3}, options);
+  auto loss = (t * 2).sum();
+  engine.execute({loss});
+
+  auto stats = context->stats();
+  ASSERT_EQ(1, stats.numGradients);
+  ASSERT_EQ(3 * sizeof(float), stats.gradientBytes);
+  ASSERT_EQ(0, stats.numOutstandingRpcs);
+  ASSERT_TRUE(context->getGradients().at(t).equal(torch::full({3}, 2)));
 }
 
 } // namespace autograd
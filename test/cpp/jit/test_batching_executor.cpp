@@ -0,0 +1,150 @@
+#include <test/cpp/jit/test_base.h>
+#include <test/cpp/jit/test_utils.h>
+#include <torch/csrc/jit/batching_executor.h>
+#include <torch/torch.h>
+
+#include <atomic>
+#include <thread>
+
+namespace torch {
+namespace jit {
+
+void testBatchingExecutor() {
+  script::Module m("m");
+  m.define(R"(
+    def forward(self, x, scale: int):
+      return x * scale, x.sum(1)
+  )");
+
+  // Requests from several threads get their own outputs back
+  {
+    BatchingExecutorOptions options;
+    options.max_batch_size = 4;
+    options.num_workers = 2;
+    BatchingExecutor executor(m, options);
+    const int num_threads = 4;
+    const int num_requests = 8;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads; ++t) {
+      threads.emplace_back([&] {
+        for (int i = 0; i < num_requests; ++i) {
+          auto x = torch::randn({1 + i % 2, 3});
+          auto future = executor.submit({x, 2});
+          future->wait();
+          auto outputs = future->value().toTuple()->elements();
+          ASSERT_TRUE(outputs[0].toTensor().equal(x * 2));
+          ASSERT_TRUE(outputs[1].toTensor().allclose(x.sum(1)));
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    auto stats = executor.stats();
+    ASSERT_EQ(stats.num_requests, num_threads * num_requests);
+    ASSERT_TRUE(stats.num_batches <= stats.num_requests);
+    ASSERT_EQ(stats.num_failed_batches, 0);
+  }
+
+  // A full batch runs without waiting for the deadline, and requests with
+  // different non-tensor inputs run in different batches
+  {
+    BatchingExecutorOptions options;
+    options.max_batch_size = 4;
+    options.max_latency = std::chrono::seconds(10);
+    BatchingExecutor executor(m, options);
+    std::vector<c10::intrusive_ptr<c10::ivalue::Future>> futures;
+    std::vector<at::Tensor> inputs;
+    for (int i = 0; i < 4; ++i) {
+      inputs.push_back(torch::randn({1, 3}));
+      futures.push_back(executor.submit({inputs.back(), 3}));
+    }
+    for (int i = 0; i < 4; ++i) {
+      futures[i]->wait();
+      ASSERT_TRUE(futures[i]->value().toTuple()->elements()[0].toTensor().equal(
+          inputs[i] * 3));
+    }
+    ASSERT_EQ(executor.stats().num_batches, 1);
+
+    auto x = torch::randn({1, 3});
+    auto y = torch::randn({1, 3});
+    auto fx = executor.submit({x, 2});
+    auto fy = executor.submit({y, 5});
+    // Runs the requests left without waiting for the deadline
+    executor.shutdown();
+    ASSERT_TRUE(fx->value().toTuple()->elements()[0].toTensor().equal(x * 2));
+    ASSERT_TRUE(fy->value().toTuple()->elements()[0].toTensor().equal(y * 5));
+    ASSERT_EQ(executor.stats().num_batches, 3);
+    ASSERT_ANY_THROW(executor.submit({x, 2}));
+  }
+
+  // Inputs with different sizes are zero padded into one batch
+  {
+    BatchingExecutorOptions options;
+    options.max_batch_size = 2;
+    options.max_latency = std::chrono::seconds(10);
+    options.pad_inputs = true;
+    BatchingExecutor executor(m, options);
+    auto x = torch::randn({1, 2});
+    auto y = torch::randn({2, 3});
+    auto fx = executor.submit({x, 1});
+    auto fy = executor.submit({y, 1});
+    auto out_x = fx->value().toTuple()->elements();
+    auto out_y = fy->value().toTuple()->elements();
+    ASSERT_EQ(executor.stats().num_batches, 1);
+    ASSERT_EQ(out_x[0].toTensor().sizes(), at::IntArrayRef({1, 3}));
+    ASSERT_TRUE(out_x[0].toTensor().narrow(1, 0, 2).equal(x));
+    ASSERT_TRUE(out_x[1].toTensor().allclose(x.sum(1)));
+    ASSERT_TRUE(out_y[0].toTensor().equal(y));
+  }
+
+  // prepare_inputs runs on the concatenated inputs of the batch
+  {
+    BatchingExecutorOptions options;
+    options.max_batch_size = 2;
+    options.max_latency = std::chrono::seconds(10);
+    std::atomic<int> num_calls{0};
+    std::atomic<int64_t> batch_rows{0};
+    options.prepare_inputs = [&](std::vector<IValue> inputs) {
+      ++num_calls;
+      batch_rows = inputs[0].toTensor().size(0);
+      inputs[0] = inputs[0].toTensor() + 1;
+      return inputs;
+    };
+    BatchingExecutor executor(m, options);
+    auto x = torch::randn({1, 3});
+    auto y = torch::randn({1, 3});
+    auto fx = executor.submit({x, 2});
+    auto fy = executor.submit({y, 2});
+    ASSERT_TRUE(fx->value().toTuple()->elements()[0].toTensor().allclose(
+        (x + 1) * 2));
+    ASSERT_TRUE(fy->value().toTuple()->elements()[0].toTensor().allclose(
+        (y + 1) * 2));
+    ASSERT_EQ(num_calls.load(), 1);
+    ASSERT_EQ(batch_rows.load(), 2);
+  }
+
+  // An error in the batch completes all its futures with the error
+  {
+    script::Module bad("m");
+    bad.define(R"(
+      def forward(self, x):
+        return torch.mm(x, torch.ones(3, 2))
+    )");
+    BatchingExecutorOptions options;
+    options.max_batch_size = 2;
+    options.max_latency = std::chrono::seconds(10);
+    BatchingExecutor executor(bad, options);
+    auto fx = executor.submit({torch::randn({1, 4})});
+    auto fy = executor.submit({torch::randn({1, 4})});
+    fx->wait();
+    fy->wait();
+    ASSERT_ANY_THROW(fx->value());
+    ASSERT_ANY_THROW(fy->value());
+    ASSERT_EQ(executor.stats().num_failed_batches, 1);
+    ASSERT_ANY_THROW(executor.submit({2}));
+  }
+}
+
+} // namespace jit
+} // namespace torch
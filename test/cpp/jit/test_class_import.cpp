@@ -113,6 +113,43 @@ void testScriptObject() {
   ASSERT_TRUE(almostEqual(new_x, new_dx.toTensor()));
 }
 
+static const auto lazyClassSrc = R"JIT(
+class FooLazy:
+    def __init__(self, x):
+        self.x = x
+
+    def good(self):
+        return self.x + 1
+
+    def bad(self):
+        return self.x + undefined_name
+)JIT";
+
+void testLazyClassImport() {
+  auto cu = std::make_shared<CompilationUnit>();
+  auto src = std::make_shared<Source>(lazyClassSrc);
+  std::vector<at::Tensor> constantTable;
+  {
+    SourceImporter si(
+        cu,
+        &constantTable,
+        [src](const std::string& name) -> std::shared_ptr<Source> {
+          return src;
+        },
+        /*version=*/2,
+        /*lazy=*/true);
+    // The error in bad is only reported once it is compiled
+    si.loadNamedType(QualifiedName("__torch__.FooLazy"));
+  }
+
+  auto cls = cu->get_class(QualifiedName("__torch__.FooLazy"));
+  ASSERT_TRUE(cls->hasAttribute("x"));
+  auto good = cls->getMethod("good");
+  ASSERT_TRUE(good);
+  ASSERT_EQ(good->getSchema().arguments().size(), 1);
+  ASSERT_ANY_THROW(cls->getMethod("bad")->graph());
+}
+
 static const auto methodSrc = R"JIT(
 def __init__(self, x):
     return x
@@ -7,6 +7,9 @@
 #include "torch/csrc/jit/passes/dead_code_elimination.h"
 #include "torch/jit.h"
 
+#include <atomic>
+#include <thread>
+
 namespace torch {
 namespace jit {
 
@@ -179,6 +182,63 @@ graph(%x: Tensor, %y: Tensor):
   }
 }
 
+void testCustomOperatorOverloads() {
+  auto creator = [](const Node* node) -> Operation {
+    return [](Stack& stack) { return 0; };
+  };
+  RegisterOperators reg({
+      Operator("foo::overloaded(float a) -> float", creator),
+      Operator("foo::overloaded(int a, int b) -> int", creator),
+      Operator("foo::overloaded(float a, float b) -> float", creator),
+  });
+  const auto& ops = getAllOperatorsFor(Symbol::fromQualString("foo::overloaded"));
+  ASSERT_EQ(ops.size(), 3);
+
+  auto graph = std::make_shared<Graph>();
+  script::parseIR(
+      R"IR(
+graph(%x: float, %y: float, %i: int):
+  %a : float = foo::overloaded(%x)
+  %b : int = foo::overloaded(%i, %i)
+  %c : float = foo::overloaded(%x, %y)
+  return (%a, %b, %c)
+  )IR",
+      graph.get());
+  std::vector<Node*> nodes(graph->nodes().begin(), graph->nodes().end());
+  ASSERT_EQ(findOperatorFor(nodes[0]), ops[0]);
+  ASSERT_EQ(findOperatorFor(nodes[1]), ops[1]);
+  ASSERT_EQ(findOperatorFor(nodes[2]), ops[2]);
+
+  // Lookups don't take the registry lock, and the overloads they return stay
+  // valid while other threads register operators.
+  std::vector<std::thread> threads;
+  std::atomic<bool> failed{false};
+  for (int t = 0; t < 4; t++) {
+    threads.emplace_back([&] {
+      for (int i = 0; i < 1000; i++) {
+        const auto& overloads =
+            getAllOperatorsFor(Symbol::fromQualString("foo::overloaded"));
+        if (overloads.size() < 3 || findOperatorFor(nodes[2]) != ops[2]) {
+          failed = true;
+        }
+      }
+    });
+  }
+  std::vector<RegisterOperators> more;
+  for (int i = 0; i < 10; i++) {
+    more.emplace_back(std::vector<Operator>{Operator(
+        "foo::overloaded(int a, float b, float c) -> float", creator)});
+    getAllOperatorsFor(Symbol::fromQualString("foo::overloaded"));
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  ASSERT_FALSE(failed);
+  ASSERT_EQ(ops.size(), 3);
+  ASSERT_EQ(
+      getAllOperatorsFor(Symbol::fromQualString("foo::overloaded")).size(), 13);
+}
+
 void testIValueKWargs() {
   const auto text = R"(
     def foo(a : int, b : int, c : int = 4):
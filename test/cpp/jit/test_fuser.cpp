@@ -9,6 +9,7 @@
 #include "torch/csrc/jit/autodiff.h"
 #include "torch/csrc/jit/code_template.h"
 #include "torch/csrc/jit/custom_operator.h"
+#include "torch/csrc/jit/fuser/disk_cache.h"
 #include "torch/csrc/jit/fuser/interface.h"
 #include "torch/csrc/jit/import.h"
 #include "torch/csrc/jit/irparser.h"
@@ -46,6 +47,10 @@
 
 #include <c10/util/Exception.h>
 
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
 #include <algorithm>
 #include <cstddef>
 #include <functional>
@@ -228,5 +233,65 @@ void testRegisterFusionCachesKernel() {
   // and therefore share a KernelSpec to share kernels for specializations
   ASSERT_EQ(second_key, expected_key);
 }
+
+void testLLVMFusion() {
+#ifdef USE_LLVM
+  const auto graph_string = R"IR(
+    graph(%0 : Tensor,
+          %1 : Tensor):
+      %2 : Tensor = aten::sigmoid(%0)
+      %3 : Tensor = aten::mul(%2, %1)
+      %4 : int = prim::Constant[value=1]()
+      %5 : Tensor = aten::add(%3, %0, %4)
+      %6 : Tensor = aten::gt(%5, %1)
+      return (%5, %6))IR";
+  Graph graph;
+  torch::jit::script::parseIR(graph_string, &graph);
+
+  auto a = at::rand({3, 4, 5});
+  auto b = at::rand({4, 3, 5}).transpose(0, 1);
+  const auto sum = a.sigmoid() * b + a;
+
+  torch::jit::overrideCanFuseOnCPU(true);
+  // The kernel is LLVM IR rather than C++
+  const auto code = debugGetFusedKernelCode(graph, {a, b});
+  auto outputs = debugLaunchGraph(graph, {a, b});
+  torch::jit::overrideCanFuseOnCPU(false);
+  testing::FileCheck().check("define void @kernel_")->run(code);
+
+  ASSERT_EQ(outputs.size(), 2);
+  ASSERT_TRUE(outputs[0].allclose(sum));
+  ASSERT_TRUE(outputs[1].equal(sum > b));
+#endif
+}
+
+void testFusionDiskCache() {
+#ifndef _WIN32
+  char dir_template[] = "/tmp/pytorch_fusion_cacheXXXXXX";
+  const std::string dir = mkdtemp(dir_template);
+  setenv("PYTORCH_FUSION_CACHE_DIR", dir.c_str(), 1);
+
+  const std::string source = "kernel source";
+  const std::string binary("binary\0with nulls", 17);
+  ASSERT_FALSE(fuser::loadCachedBinary(source));
+  fuser::storeCachedBinary(source, binary);
+  auto loaded = fuser::loadCachedBinary(source);
+  ASSERT_TRUE(loaded);
+  ASSERT_EQ(*loaded, binary);
+  // Sources are compared in full, not only by their hash
+  ASSERT_FALSE(fuser::loadCachedBinary(source + " of another kernel"));
+
+  // Nothing fits in an empty cache
+  setenv("PYTORCH_FUSION_CACHE_SIZE_MB", "0", 1);
+  fuser::storeCachedBinary(source + " of another kernel", binary);
+  ASSERT_FALSE(fuser::loadCachedBinary(source));
+  ASSERT_FALSE(fuser::loadCachedBinary(source + " of another kernel"));
+
+  unsetenv("PYTORCH_FUSION_CACHE_SIZE_MB");
+  unsetenv("PYTORCH_FUSION_CACHE_DIR");
+  rmdir(dir.c_str());
+#endif
+}
+
 } // namespace jit
 } // namespace torch
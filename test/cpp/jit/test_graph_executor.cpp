@@ -28,5 +28,36 @@ void testGraphExecutor() {
   ASSERT_TRUE(almostEqual(stack[1].toTensor(), r1));
 }
 
+void testBackgroundCompilation() {
+  auto graph = std::make_shared<Graph>();
+  script::parseIR(
+      R"IR(
+graph(%a : Tensor, %b : Tensor):
+  %one : int = prim::Constant[value=1]()
+  %c : Tensor = aten::add(%a, %b, %one)
+  return (%c))IR",
+      &*graph);
+  auto a = at::randn({2, 3});
+  auto b = at::randn({2, 3});
+
+  const size_t num_calls = getNumBackgroundCompileCalls();
+  const bool executor_mode = getExecutorMode();
+  getNumBackgroundCompileCalls() = 2;
+  for (bool profiling : {false, true}) {
+    getExecutorMode() = profiling;
+    GraphExecutor executor(graph);
+    // up to two calls run the unoptimized plan, after profiling if any, and
+    // the next one waits for the optimized plan
+    for (int i = 0; i < 4; i++) {
+      auto stack = createStack({a, b});
+      executor.run(stack);
+      ASSERT_TRUE(almostEqual(stack[0].toTensor(), a + b));
+    }
+    ASSERT_EQ(executor.getDebugState().execution_plans.size(), 1);
+  }
+  getExecutorMode() = executor_mode;
+  getNumBackgroundCompileCalls() = num_calls;
+}
+
 } // namespace jit
 } // namespace torch
@@ -1,5 +1,6 @@
 #include <test/cpp/jit/test_base.h>
 
+#include <torch/csrc/jit/passes/inline_fork_wait.h>
 #include <torch/csrc/jit/passes/inliner.h>
 #include <torch/csrc/jit/script/compilation_unit.h>
 #include <torch/csrc/jit/script/module.h>
@@ -19,6 +20,19 @@ def foo3(x):
     return foo2(x)
 )JIT";
 
+const auto forkSource = R"JIT(
+def small(x):
+    return x + 1
+
+def big(x):
+    return x * 2 + x * 3 - x
+
+def forks(x):
+    a = torch.jit._fork(small, x)
+    b = torch.jit._fork(big, x)
+    return torch.jit._wait(a) + torch.jit._wait(b)
+)JIT";
+
 namespace torch {
 namespace jit {
 using namespace script;
@@ -50,5 +64,23 @@ void testInliner() {
     FileCheck().check_count("prim::Print", 3)->run(*g);
   }
 }
+
+void testInlineTrivialForks() {
+  CompilationUnit cu(forkSource);
+  auto& fn = cu.get_function("forks");
+
+  auto g = fn.graph()->copy();
+  InlineTrivialForks(g, /*max_nodes=*/3);
+  // Only the fork of small is inlined, big has 4 nodes
+  FileCheck()
+      .check("aten::add")
+      ->check_count("= prim::fork", 1, /*exactly=*/true)
+      ->check_count("aten::wait", 1, /*exactly=*/true)
+      ->run(*g);
+
+  auto x = at::randn({2, 3});
+  auto out = fn({x}).toTensor();
+  ASSERT_TRUE(out.allclose(x + 1 + (x * 2 + x * 3 - x)));
+}
 } // namespace jit
 } // namespace torch
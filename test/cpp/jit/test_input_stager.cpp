@@ -0,0 +1,71 @@
+#include <test/cpp/jit/test_base.h>
+#include <torch/csrc/jit/batching_executor.h>
+#include <torch/torch.h>
+
+#ifdef USE_CUDA
+#include <torch/csrc/cuda/input_stager.h>
+#endif
+
+namespace torch {
+namespace jit {
+
+void testInputStager() {
+#ifdef USE_CUDA
+  // Tensors, in tensor lists too, are copied to the GPU, and other inputs
+  // are returned as they are
+  {
+    torch::cuda::InputStager stager;
+    auto x = torch::randn({2, 3});
+    auto y = torch::arange(5);
+    auto e = torch::empty({0, 3});
+    auto g = torch::randn({4}, at::kCUDA);
+    std::vector<at::Tensor> list{y, x.t(), e};
+    for (int i = 0; i < 3; ++i) {
+      // More calls than buffers reuse them
+      auto staged = stager.stage({x, list, 7, g});
+      auto sx = staged[0].toTensor();
+      ASSERT_TRUE(sx.is_cuda());
+      ASSERT_TRUE(sx.cpu().equal(x));
+      auto slist = staged[1].toTensorListRef();
+      ASSERT_EQ(slist.size(), 3);
+      ASSERT_TRUE(slist[0].is_cuda());
+      ASSERT_TRUE(slist[0].cpu().equal(y));
+      ASSERT_TRUE(slist[1].cpu().equal(x.t()));
+      ASSERT_TRUE(slist[2].is_cuda());
+      ASSERT_EQ(slist[2].sizes(), e.sizes());
+      ASSERT_EQ(staged[2].toInt(), 7);
+      ASSERT_TRUE(staged[3].toTensor().is_same(g));
+    }
+  }
+
+  // With a BatchingExecutor, the batches run on the staged inputs
+  {
+    script::Module m("m");
+    m.define(R"(
+      def forward(self, x):
+        return x * 2
+    )");
+    auto stager = std::make_shared<torch::cuda::InputStager>();
+    BatchingExecutorOptions options;
+    options.num_workers = 2;
+    options.prepare_inputs = [stager](std::vector<IValue> inputs) {
+      return stager->stage(std::move(inputs));
+    };
+    BatchingExecutor executor(m, options);
+    std::vector<at::Tensor> inputs;
+    std::vector<c10::intrusive_ptr<c10::ivalue::Future>> futures;
+    for (int i = 0; i < 8; ++i) {
+      inputs.push_back(torch::randn({1, 16}));
+      futures.push_back(executor.submit({inputs.back()}));
+    }
+    for (size_t i = 0; i < futures.size(); ++i) {
+      auto output = futures[i]->value().toTensor();
+      ASSERT_TRUE(output.is_cuda());
+      ASSERT_TRUE(output.cpu().equal(inputs[i] * 2));
+    }
+  }
+#endif
+}
+
+} // namespace jit
+} // namespace torch
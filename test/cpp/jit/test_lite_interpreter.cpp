@@ -1,9 +1,17 @@
 #include <test/cpp/jit/test_base.h>
 #include <torch/csrc/jit/script/module.h>
 #include <torch/csrc/autograd/generated/variable_factories.h>
+#include <torch/csrc/jit/mobile/flat_bytecode.h>
 #include <torch/csrc/jit/mobile/import.h>
+#include <torch/csrc/jit/mobile/memory_plan.h>
 #include <torch/csrc/jit/mobile/module.h>
+#include <torch/csrc/jit/mobile/register_mobile_ops.h>
 #include <torch/csrc/jit/import.h>
+#include <torch/csrc/jit/instruction.h>
+#include <c10/core/CPUAllocator.h>
+#include <caffe2/serialize/inline_container.h>
+
+#include <cstring>
 
 // Tests go in torch::jit
 namespace torch {
@@ -127,5 +135,125 @@ void testLiteInterpreterPrimOverload() {
   auto output = bc.run_method("forward", inputs);
   AT_ASSERT(output.toIntList()[2] == 3);
 }
+
+void testLiteInterpreterOperatorTable() {
+  auto index = mobile::findOperator(c10::OperatorName("aten::add", "Tensor"));
+  ASSERT_TRUE(index.has_value());
+  const auto& entry = mobile::operatorEntry(*index);
+  ASSERT_EQ(std::string(entry.name), "aten::add");
+  ASSERT_EQ(std::string(entry.overload_name), "Tensor");
+
+  std::vector<IValue> stack{torch::ones({}), torch::ones({}), 2};
+  entry.fn(stack);
+  ASSERT_EQ(stack.size(), 1);
+  ASSERT_EQ(stack[0].toTensor().item<float>(), 3);
+
+  ASSERT_FALSE(
+      mobile::findOperator(c10::OperatorName("aten::add", "not_an_overload"))
+          .has_value());
+}
+
+void testLiteInterpreterMemoryPlan() {
+  script::Module m("m");
+  m.define(R"(
+    def forward(self, x):
+      y = x + x
+      z = y + 1
+      return z * z
+  )");
+  std::stringstream ss;
+  m._save_for_mobile(ss);
+  mobile::Module bc = _load_for_mobile(ss);
+
+  auto input = torch::ones({32, 32});
+  auto ref = m.forward({input}).toTensor();
+  auto res = bc.plan_memory("forward", {input}).toTensor();
+  AT_ASSERT(res.equal(ref));
+
+  const auto* plan = bc.find_method("forward")->memory_plan();
+  ASSERT_TRUE(plan);
+  ASSERT_TRUE(plan->size() > 0);
+  ASSERT_FALSE(plan->allocations().empty());
+  // The output outlives the run
+  ASSERT_FALSE(plan->allocations().back().planned);
+
+  for (int i = 0; i < 3; ++i) {
+    res = bc.forward({input}).toTensor();
+    AT_ASSERT(res.equal(ref));
+  }
+
+  // Inputs of another shape don't follow the plan
+  auto other = torch::ones({4, 4});
+  AT_ASSERT(bc.forward({other}).toTensor().equal(m.forward({other}).toTensor()));
+}
+
+void testLiteInterpreterFlatBytecode() {
+  script::Module m("m");
+  m.register_parameter("foo", torch::ones({}), false);
+  m.define(R"JIT(
+  def forward(self, x):
+      result = [1, 2]
+      result.append(3)
+      return self.foo + x + result[2]
+  )JIT");
+  std::stringstream ss;
+  m._save_for_mobile(ss);
+  {
+    caffe2::serialize::PyTorchStreamReader reader(&ss);
+    ASSERT_TRUE(reader.hasRecord(mobile::kFlatBytecodeRecord));
+  }
+  ss.clear();
+  ss.seekg(0);
+  mobile::Module bc = _load_for_mobile(ss);
+  auto output = bc.forward({torch::ones({})});
+  AT_ASSERT(output.toTensor().item<float>() == 5.0);
+
+  // Every kind of constant round trips
+  auto tensor = torch::arange(6, at::kFloat).view({2, 3}).t();
+  std::vector<IValue> constants{
+      tensor, 3, 2.5, true, "str", IValue(), c10::List<int64_t>({1, 2})};
+  std::vector<Instruction> instructions;
+  for (size_t i = 0; i < constants.size(); ++i) {
+    instructions.emplace_back(LOADC, i, 0);
+  }
+  instructions.emplace_back(RET, 0, 0);
+  std::vector<at::Tensor> storages;
+  std::vector<IValue> pickled_constants;
+  std::string data = mobile::serializeFlatBytecode(
+      {{"f", instructions, {}, constants, 0}}, storages, pickled_constants);
+  ASSERT_EQ(storages.size(), 1);
+  ASSERT_EQ(pickled_constants.size(), 1);
+
+  auto allocator = c10::GetCPUAllocator();
+  auto record = allocator->allocate(data.size());
+  std::memcpy(record.get(), data.data(), data.size());
+  mobile::CompilationUnit mcu;
+  mobile::parseFlatBytecode(
+      std::move(record),
+      data.size(),
+      [&](size_t index) {
+        const auto& storage = storages.at(index).storage();
+        auto nbytes = storage.numel() * storage.itemsize();
+        auto ptr = allocator->allocate(nbytes);
+        std::memcpy(ptr.get(), storage.data(), nbytes);
+        return std::make_tuple(std::move(ptr), nbytes);
+      },
+      [&]() { return c10::ivalue::Tuple::create(pickled_constants); },
+      c10::nullopt,
+      mcu);
+  ASSERT_EQ(mcu.methods().size(), 1);
+
+  Stack stack;
+  mcu.methods()[0]->run(stack);
+  ASSERT_EQ(stack.size(), constants.size());
+  AT_ASSERT(stack[0].toTensor().equal(tensor));
+  ASSERT_EQ(stack[0].toTensor().strides(), tensor.strides());
+  ASSERT_EQ(stack[1].toInt(), 3);
+  ASSERT_EQ(stack[2].toDouble(), 2.5);
+  ASSERT_TRUE(stack[3].toBool());
+  ASSERT_EQ(stack[4].toStringRef(), "str");
+  ASSERT_TRUE(stack[5].isNone());
+  ASSERT_EQ(stack[6].toIntList()[1], 2);
+}
 } // namespace torch
 } // namespace jit
@@ -10,31 +10,38 @@
 #include <torch/csrc/jit/passes/canonicalize.h>
 #include "torch/csrc/autograd/generated/variable_factories.h"
 #include "torch/csrc/autograd/variable.h"
+#include "torch/csrc/jit/aot/codegen.h"
 #include "torch/csrc/jit/argument_spec.h"
 #include "torch/csrc/jit/attributes.h"
 #include "torch/csrc/jit/autodiff.h"
 #include "torch/csrc/jit/code_template.h"
 #include "torch/csrc/jit/custom_operator.h"
 #include "torch/csrc/jit/fuser/interface.h"
+#include "torch/csrc/jit/graph_executor.h"
 #include "torch/csrc/jit/import.h"
 #include "torch/csrc/jit/interpreter.h"
 #include "torch/csrc/jit/irparser.h"
 #include "torch/csrc/jit/pass_manager.h"
 #include "torch/csrc/jit/passes/alias_analysis.h"
+#include "torch/csrc/jit/passes/batch_mm.h"
 #include "torch/csrc/jit/passes/bailout_graph.h"
 #include "torch/csrc/jit/passes/common_subexpression_elimination.h"
 #include "torch/csrc/jit/passes/constant_propagation.h"
 #include "torch/csrc/jit/passes/create_autodiff_subgraphs.h"
 #include "torch/csrc/jit/passes/dead_code_elimination.h"
+#include "torch/csrc/jit/passes/fold_batch_norm.h"
 #include "torch/csrc/jit/passes/graph_fuser.h"
 #include "torch/csrc/jit/passes/guard_elimination.h"
+#include "torch/csrc/jit/passes/inplace_rewrite.h"
 #include "torch/csrc/jit/passes/insert_guards.h"
 #include "torch/csrc/jit/passes/liveness.h"
 #include "torch/csrc/jit/passes/lower_grad_of.h"
 #include "torch/csrc/jit/passes/lower_tuples.h"
+#include "torch/csrc/jit/passes/memory_planning.h"
 #include "torch/csrc/jit/passes/requires_grad_analysis.h"
 #include "torch/csrc/jit/passes/shape_analysis.h"
 #include "torch/csrc/jit/passes/utils/subgraph_utils.h"
+#include "torch/csrc/jit/passes/vectorize_loops.h"
 #include "torch/csrc/jit/scope.h"
 #include "torch/csrc/jit/symbolic_script.h"
 #include "torch/csrc/jit/tracer.h"
@@ -52,6 +59,7 @@
 
 #include "onnx/onnx_pb.h"
 
+#include <c10/core/ArenaAllocator.h>
 #include <c10/util/Exception.h>
 
 #include <algorithm>
@@ -61,6 +69,7 @@
 #include <memory>
 #include <stdexcept>
 #include <string>
+#include <thread>
 #include <tuple>
 #include <unordered_set>
 #include <utility>
@@ -816,6 +825,55 @@ void testRecordFunction() {
 
   autograd::profiler::popCallback();
   autograd::profiler::popCallback();
+
+  // test callbacks with their own sampling probability; the inputs are only
+  // captured for the callbacks that run
+  int rare_cb_ctr = 0;
+  autograd::profiler::pushSampledCallback(
+      [&rare_cb_ctr](const autograd::profiler::RecordFunction& fn) {
+        if (std::string(fn.name().str()) == "test") {
+          ++rare_cb_ctr;
+        }
+      },
+      [](const autograd::profiler::RecordFunction&) {},
+      /* sampling_prob */ 0.1);
+  autograd::profiler::pushSampledCallback(
+      [](const autograd::profiler::RecordFunction&) {
+        TORCH_CHECK(false, "Callback with sampling probability 0 ran");
+      },
+      [](const autograd::profiler::RecordFunction&) {},
+      /* sampling_prob */ 0.0,
+      /* needs_inputs */ true);
+  int without_inputs_ctr = 0;
+  autograd::profiler::pushCallback(
+      [&without_inputs_ctr](const autograd::profiler::RecordFunction& fn) {
+        if (std::string(fn.name().str()) == "test" && fn.inputs().empty()) {
+          ++without_inputs_ctr;
+        }
+      });
+
+  run_test_function();
+  TORCH_CHECK(rare_cb_ctr > 0 && rare_cb_ctr < 1000);
+  TORCH_CHECK(without_inputs_ctr == 1000);
+
+  autograd::profiler::popCallback();
+  autograd::profiler::popCallback();
+  autograd::profiler::popCallback();
+
+  // test thread local callbacks
+  int thread_local_cb_ctr = 0;
+  autograd::profiler::pushThreadLocalCallback(
+      [&thread_local_cb_ctr](const autograd::profiler::RecordFunction& fn) {
+        if (std::string(fn.name().str()) == "test") {
+          ++thread_local_cb_ctr;
+        }
+      });
+  run_test_function();
+  std::thread other_thread(run_test_function);
+  other_thread.join();
+  TORCH_CHECK(thread_local_cb_ctr == 1000);
+  autograd::profiler::popThreadLocalCallback();
+  TORCH_CHECK(!autograd::profiler::hasCallbacks());
 }
 
 class TestThreadLocalDebugInfo
@@ -908,6 +966,57 @@ void testAutogradProfiler() {
   TORCH_CHECK(count == 200);
 }
 
+void testStreamingProfiler() {
+  constexpr int batch_size = 4;
+  constexpr int input_size = 256;
+
+  int hidden_size = 2 * input_size;
+  auto input = torch::randn({batch_size, input_size}, at::kCPU);
+  auto hx = torch::randn({batch_size, hidden_size}, at::kCPU);
+  auto cx = torch::randn({batch_size, hidden_size}, at::kCPU);
+  auto w_ih = t_def(torch::randn({4 * hidden_size, input_size}, at::kCPU));
+  auto w_hh = t_def(torch::randn({4 * hidden_size, hidden_size}, at::kCPU));
+
+  std::stringstream ss;
+  {
+    autograd::profiler::StreamingProfile guard(
+        ss,
+        autograd::profiler::ProfilerConfig(
+            autograd::profiler::ProfilerState::CPU, false),
+        autograd::profiler::StreamingFormat::ChromeTrace,
+        /*record_memory=*/true);
+    for (size_t i = 0; i < 100; ++i) {
+      std::tie(hx, cx) = lstm(input, hx, cx, w_ih, w_hh);
+    }
+  }
+
+  std::string result = ss.str();
+  auto count = [&](const std::string& str) {
+    size_t n = 0;
+    for (size_t pos = 0; (pos = result.find(str, pos)) != std::string::npos;
+         n++, pos++) {
+    }
+    return n;
+  };
+  TORCH_CHECK(result.front() == '[');
+  TORCH_CHECK(result.find("]") == result.size() - 2);
+  TORCH_CHECK(count("\"tanh\"") == 200);
+  TORCH_CHECK(count("\"ph\": \"B\"") == count("\"ph\": \"E\""));
+  TORCH_CHECK(count("\"name\": \"CPU memory\"") > 0);
+
+  std::stringstream binary;
+  {
+    autograd::profiler::StreamingProfile guard(
+        binary,
+        autograd::profiler::ProfilerConfig(
+            autograd::profiler::ProfilerState::CPU, false),
+        autograd::profiler::StreamingFormat::Binary);
+    std::tie(hx, cx) = lstm(input, hx, cx, w_ih, w_hh);
+  }
+  TORCH_CHECK(binary.str().compare(0, 4, "TPRF") == 0);
+  TORCH_CHECK(binary.str().find("tanh") != std::string::npos);
+}
+
 void testNoneSchemaMatch() {
   RegisterOperators reg({
       Operator(
@@ -1066,6 +1175,67 @@ void testInsertAndEliminateRedundantGuards() {
   ASSERT_EQ(num_guards, 2);
 }
 
+void testProfileSymbolicShapes() {
+  static const auto basic_example = R"JIT(
+  def basic(x, y, z):
+    a = x + y
+    return a * z
+  )JIT";
+
+  auto cu = compile(basic_example);
+  auto& fun = cu->get_function("basic");
+  const size_t num_profiled_runs = getNumProfiledRuns();
+  getNumProfiledRuns() = 2;
+  auto pr = ProfilingRecord::instrumentGraph(fun.graph());
+  getNumProfiledRuns() = num_profiled_runs;
+  Code cd(pr->profiled_graph_);
+  // the batch sizes of x and y change together, z's changes on its own
+  for (int64_t batch : {2, 4}) {
+    auto stack = createStack({at::randn({batch, 3}),
+                              at::randn({batch, 3}),
+                              at::randn({6 - batch, 1, 3})});
+    InterpreterState is{cd};
+    is.run(stack);
+  }
+  ASSERT_TRUE(pr->ready());
+
+  auto copy = pr->profiled_graph_->copy();
+  InsertGuards(copy);
+  auto guardOf = [&](size_t i) {
+    auto nodes = copy->block()->nodes();
+    auto guard = std::find_if(nodes.begin(), nodes.end(), [&](Node* n) {
+      return n->kind() == prim::Guard && n->input() == copy->inputs().at(i);
+    });
+    AT_ASSERT(guard != nodes.end());
+    return *guard;
+  };
+  auto x_symbols = guardOf(0)->is(attr::symbols);
+  auto z_symbols = guardOf(2)->is(attr::symbols);
+  ASSERT_EQ(x_symbols.size(), size_t(2));
+  ASSERT_TRUE(x_symbols[0] >= 0);
+  ASSERT_EQ(x_symbols[1], -1);
+  ASSERT_EQ(guardOf(1)->is(attr::symbols), x_symbols);
+  ASSERT_EQ(z_symbols.size(), size_t(3));
+  ASSERT_TRUE(z_symbols[0] >= 0);
+  ASSERT_NE(z_symbols[0], x_symbols[0]);
+
+  // the symbolic dims match any size, the others still have to match
+  auto x_type = guardOf(0)->output()->type()->expect<TensorType>();
+  ASSERT_FALSE(x_type->sizes()[0].has_value());
+  ASSERT_EQ(*x_type->sizes()[1], 3);
+  ASSERT_TRUE(x_type->matchTensor(at::randn({7, 3})));
+  ASSERT_FALSE(x_type->matchTensor(at::randn({7, 4})));
+  ASSERT_FALSE(x_type->matchTensor(at::randn({7, 3}, at::kDouble)));
+
+  // the guards on x, y and z are enough to know the ranks of a and a * z
+  EliminateRedundantGuards(copy);
+  auto nodes = copy->block()->nodes();
+  auto is_guard = [](Node* n) { return n->kind() == prim::Guard; };
+  ASSERT_EQ(std::count_if(nodes.begin(), nodes.end(), is_guard), 3);
+  ASSERT_EQ(
+      copy->outputs().at(0)->type()->expect<TensorType>()->dim(), size_t(3));
+}
+
 void testInsertBailOuts() {
   static const auto basic_example = R"JIT(
   def basic_loop(x, y):
@@ -1275,5 +1445,321 @@ def c(x):
   ASSERT_TRUE(callstack_objects.at("a1") == callstack_objects.at("a2"));
 }
 
+
+namespace {
+std::atomic<int64_t> num_cpu_allocations{0};
+
+void countCPUAllocations(
+    void* /*ptr*/,
+    int64_t alloc_size,
+    c10::Device device) {
+  if (alloc_size > 0 && device.is_cpu()) {
+    num_cpu_allocations++;
+  }
+}
+} // namespace
+
+void testMemoryPlanning() {
+  auto graph = std::make_shared<Graph>();
+  script::parseIR(
+      R"IR(
+graph(%a : Tensor, %b : Tensor):
+  %c : Tensor = aten::mul(%a, %b)
+  %d : Tensor = aten::mul(%c, %b)
+  %e : Tensor = aten::mul(%d, %a)
+  %f : Tensor = aten::mul(%e, %b)
+  return (%f))IR",
+      &*graph);
+  auto a = torch::rand({32, 32});
+  auto b = torch::rand({32, 32});
+  auto type = TensorType::create(a);
+  for (Value* input : graph->inputs()) {
+    input->setType(type);
+  }
+  for (Node* node : graph->nodes()) {
+    node->output()->setType(type);
+  }
+
+  PlanMemory(graph);
+  // %c and %e aren't alive at the same time and share their memory, %f is
+  // returned and not planned
+  testing::FileCheck()
+      .check("prim::MemoryPlanBegin[size=8192]")
+      ->check_count("prim::MemoryPlanSlot", 4, /*exactly*/ true)
+      ->check("prim::MemoryPlanEnd")
+      ->run(*graph);
+
+  auto expected = a * b * b * a * b;
+  Code code(graph);
+  c10::setMemoryUsageReporter(countCPUAllocations);
+  for (int i = 0; i < 3; i++) {
+    num_cpu_allocations = 0;
+    Stack stack{a, b};
+    InterpreterState(code).run(stack);
+    ASSERT_TRUE(stack.back().toTensor().allclose(expected));
+    // Only the output
+    ASSERT_EQ(num_cpu_allocations, 1);
+  }
+  c10::setMemoryUsageReporter(nullptr);
+  // The allocator is restored after the run
+  ASSERT_EQ(c10::impl::getThreadLocalCPUAllocator(), nullptr);
+}
+
+void testRewriteToInplaceOps() {
+  auto graph = std::make_shared<Graph>();
+  script::parseIR(
+      R"IR(
+graph(%x : Tensor, %y : Tensor):
+  %one : int = prim::Constant[value=1]()
+  %a : Tensor = aten::mul(%x, %y)
+  %b : Tensor = aten::relu(%a)
+  %c : Tensor = aten::add(%b, %y, %one)
+  %d : Tensor = aten::sigmoid(%c)
+  %e : Tensor = aten::mul(%c, %d)
+  return (%e))IR",
+      &*graph);
+  auto x = at::randn({2, 3});
+  auto y = at::randn({2, 3});
+  graph->inputs()[0]->setType(TensorType::create(x));
+  graph->inputs()[1]->setType(TensorType::create(y));
+  PropagateInputShapes(graph);
+
+  RewriteToInplaceOps(graph);
+  // %x is an input and %c is used after the sigmoid, the other inputs are
+  // dead after their op
+  testing::FileCheck()
+      .check("aten::mul(")
+      ->check("aten::relu_(")
+      ->check("aten::add_(")
+      ->check("aten::sigmoid(")
+      ->check("aten::mul_(")
+      ->run(*graph);
+
+  auto a = (x * y).relu() + y;
+  auto expected = a * a.sigmoid();
+  c10::setMemoryUsageReporter(countCPUAllocations);
+  num_cpu_allocations = 0;
+  Stack stack{x, y};
+  InterpreterState(Code(graph)).run(stack);
+  c10::setMemoryUsageReporter(nullptr);
+  ASSERT_TRUE(stack.back().toTensor().allclose(expected));
+  // Only the mul and the sigmoid allocate
+  ASSERT_EQ(num_cpu_allocations, 2);
+}
+
+// Parses graph, makes its inputs after the first num_inputs constants, and
+// checks that folding and fusing keep its result on inputs
+static void foldAndFuseBatchNorm(
+    const std::string& ir,
+    const std::vector<at::Tensor>& inputs,
+    size_t num_inputs,
+    std::shared_ptr<Graph>& graph) {
+  graph = std::make_shared<Graph>();
+  script::parseIR(ir, &*graph);
+  Stack stack(inputs.begin(), inputs.end());
+  InterpreterState(Code(graph)).run(stack);
+  auto expected = stack.back().toTensor();
+
+  WithInsertPoint guard(graph->block()->nodes().front());
+  for (size_t i = inputs.size(); i-- > num_inputs;) {
+    graph->inputs().at(i)->replaceAllUsesWith(
+        graph->insertConstant(inputs[i]));
+    graph->eraseInput(i);
+  }
+  for (size_t i = 0; i < num_inputs; ++i) {
+    graph->inputs().at(i)->setType(TensorType::create(inputs[i]));
+  }
+  FoldFrozenBatchNorm(graph);
+  PropagateInputShapes(graph);
+  FuseConvAndLinearRelu(graph);
+
+  stack.assign(inputs.begin(), inputs.begin() + num_inputs);
+  InterpreterState(Code(graph)).run(stack);
+  ASSERT_TRUE(stack.back().toTensor().allclose(expected, 1e-4, 1e-5));
+}
+
+void testFoldFrozenBatchNorm() {
+  auto bn_params = [](int64_t channels) {
+    return std::vector<at::Tensor>{torch::rand({channels}),
+                                   torch::rand({channels}),
+                                   torch::rand({channels}),
+                                   torch::rand({channels}) + 0.5};
+  };
+  {
+    std::vector<at::Tensor> inputs{torch::rand({2, 3, 8, 8}),
+                                   torch::rand({2, 4, 8, 8}),
+                                   torch::rand({4, 3, 3, 3}),
+                                   torch::rand({4})};
+    for (const auto& param : bn_params(4)) {
+      inputs.push_back(param);
+    }
+    std::shared_ptr<Graph> graph;
+    foldAndFuseBatchNorm(
+        R"IR(
+graph(%x : Tensor, %other : Tensor, %w : Tensor, %b : Tensor, %bn_w : Tensor, %bn_b : Tensor, %mean : Tensor, %var : Tensor):
+  %false : bool = prim::Constant[value=0]()
+  %momentum : float = prim::Constant[value=0.1]()
+  %eps : float = prim::Constant[value=1e-05]()
+  %one : int = prim::Constant[value=1]()
+  %ones : int[] = prim::ListConstruct(%one, %one)
+  %y : Tensor = aten::conv2d(%x, %w, %b, %ones, %ones, %ones, %one)
+  %z : Tensor = aten::batch_norm(%y, %bn_w, %bn_b, %mean, %var, %false, %momentum, %eps, %false)
+  %s : Tensor = aten::add(%z, %other, %one)
+  %r : Tensor = aten::relu(%s)
+  return (%r))IR",
+        inputs,
+        2,
+        graph);
+    testing::FileCheck()
+        .check_not("aten::batch_norm")
+        ->check("aten::conv2d")
+        ->check("aten::add_")
+        ->check("aten::relu_")
+        ->run(*graph);
+  }
+  {
+    // Without a bias
+    std::vector<at::Tensor> inputs{torch::rand({5, 3}), torch::rand({4, 3})};
+    for (const auto& param : bn_params(4)) {
+      inputs.push_back(param);
+    }
+    std::shared_ptr<Graph> graph;
+    foldAndFuseBatchNorm(
+        R"IR(
+graph(%x : Tensor, %w : Tensor, %bn_w : Tensor, %bn_b : Tensor, %mean : Tensor, %var : Tensor):
+  %none : Tensor? = prim::Constant()
+  %false : bool = prim::Constant[value=0]()
+  %momentum : float = prim::Constant[value=0.1]()
+  %eps : float = prim::Constant[value=1e-05]()
+  %y : Tensor = aten::linear(%x, %w, %none)
+  %z : Tensor = aten::batch_norm(%y, %bn_w, %bn_b, %mean, %var, %false, %momentum, %eps, %false)
+  %r : Tensor = aten::relu(%z)
+  return (%r))IR",
+        inputs,
+        1,
+        graph);
+    testing::FileCheck()
+        .check_not("aten::batch_norm")
+        ->check("aten::linear")
+        ->check("aten::relu_")
+        ->run(*graph);
+  }
+}
+
+void testVectorizeLoops() {
+  auto cu = compile(R"JIT(
+def map_rows(x, w):
+    out : List[Tensor] = []
+    for i in range(x.size(0)):
+        out.append(torch.relu(torch.mm(x[i], w)) * 2)
+    return torch.stack(out)
+)JIT");
+  auto x = at::randn({4, 2, 3});
+  auto w = at::randn({3, 5});
+  auto graph = cu->get_function("map_rows").graph()->copy();
+  graph->inputs()[0]->setType(TensorType::create(x));
+  graph->inputs()[1]->setType(TensorType::create(w));
+
+  VectorizeLoops(graph);
+  testing::FileCheck()
+      .check_not("prim::Loop")
+      ->check("aten::matmul")
+      ->check("aten::relu")
+      ->check("aten::mul")
+      ->check_not("aten::stack")
+      ->run(*graph);
+
+  Stack stack{x, w};
+  InterpreterState(Code(graph)).run(stack);
+  ASSERT_TRUE(stack.back().toTensor().allclose(at::relu(x.matmul(w)) * 2));
+}
+
+void testBatchIndependentOps() {
+  auto graph = std::make_shared<Graph>();
+  script::parseIR(
+      R"IR(
+graph(%x0 : Tensor, %x1 : Tensor, %x2 : Tensor, %x3 : Tensor, %w0 : Tensor, %w1 : Tensor, %w2 : Tensor, %w3 : Tensor):
+  %none : Tensor? = prim::Constant()
+  %r0 : Tensor = aten::relu(%x0)
+  %r1 : Tensor = aten::relu(%x1)
+  %r2 : Tensor = aten::relu(%x2)
+  %r3 : Tensor = aten::relu(%x3)
+  %l0 : Tensor = aten::linear(%r0, %w0, %none)
+  %l1 : Tensor = aten::linear(%r1, %w1, %none)
+  %l2 : Tensor = aten::linear(%r2, %w2, %none)
+  %l3 : Tensor = aten::linear(%r3, %w3, %none)
+  return (%l0, %l1, %l2, %l3))IR",
+      &*graph);
+  auto typeOf = [](at::IntArrayRef sizes) {
+    return TensorType::createContiguous(at::kFloat, at::kCUDA, sizes);
+  };
+  for (size_t i = 0; i < 4; ++i) {
+    graph->inputs()[i]->setType(typeOf({2, 3}));
+    graph->inputs()[4 + i]->setType(typeOf({5, 3}));
+  }
+  for (Node* n : graph->nodes()) {
+    if (n->kind() == aten::relu) {
+      n->output()->setType(typeOf({2, 3}));
+    } else if (n->kind() == aten::linear) {
+      n->output()->setType(typeOf({2, 5}));
+    }
+  }
+
+  BatchMM(graph);
+  // The relus run on the stacked inputs, and the linears, which depend on
+  // them, become a matmul of the stacked weights
+  testing::FileCheck()
+      .check("aten::stack")
+      ->check_count("aten::relu", 1, /*exactly=*/true)
+      ->check("aten::unbind")
+      ->check("aten::matmul")
+      ->check_not("aten::linear")
+      ->run(*graph);
+}
+
+void testAOTSource() {
+  auto cu = compile(R"JIT(
+def f(x, w):
+    y = torch.relu(torch.matmul(x, w))
+    if bool(y.sum() > 0):
+        y = y + 1
+    for i in range(x.size(0)):
+        y = y * 2
+    return y
+)JIT");
+  auto graph = cu->get_function("f").graph()->copy();
+  {
+    // The weight is a constant, as in a frozen module
+    WithInsertPoint guard(graph->block()->nodes().front());
+    graph->inputs()[1]->replaceAllUsesWith(
+        graph->insertConstant(at::randn({3, 5})));
+    graph->eraseInput(1);
+  }
+
+  auto source = aot::generateAOTSource(graph);
+  ASSERT_EQ(source.weights.size(), 15 * sizeof(float));
+  testing::FileCheck()
+      .check("torch_aot_load")
+      ->check("at::from_blob")
+      ->check("torch_aot_run")
+      ->check("at::matmul(")
+      ->check("at::relu(")
+      ->check("if (")
+      ->check("for (")
+      ->check("at::mul(")
+      ->check("outputs->push_back(")
+      ->run(source.source);
+
+  // Nodes without a C++ lowering are rejected
+  auto print_graph = std::make_shared<Graph>();
+  script::parseIR(
+      R"IR(
+graph(%x : Tensor):
+  prim::Print(%x)
+  return (%x))IR",
+      &*print_graph);
+  ASSERT_ANY_THROW(aot::generateAOTSource(print_graph));
+}
+
 } // namespace jit
 } // namespace torch
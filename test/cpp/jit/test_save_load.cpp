@@ -1,6 +1,7 @@
 #include <test/cpp/jit/test_base.h>
 #include <test/cpp/jit/test_utils.h>
 
+#include <cstdio>
 #include <sstream>
 
 #include <torch/csrc/jit/export.h>
@@ -57,5 +58,34 @@ void testSaveExtraFilesHook() {
   }
 }
 
+void testSaveLoadSharded() {
+  const std::string filename = "sharded_module.pt";
+  constexpr size_t kNumShards = 3;
+  Module m("__torch__.m");
+  std::vector<at::Tensor> params;
+  for (size_t i = 0; i < 5; ++i) {
+    params.push_back(at::randn({10 + static_cast<int64_t>(i)}));
+    m.register_parameter(
+        "p" + c10::to_string(i), params.back(), /*is_buffer=*/false);
+  }
+  ExportModule(m, filename, ExtraFilesMap(), false, kNumShards);
+
+  auto loaded = jit::load(filename);
+  auto loaded_params = loaded.parameters();
+  ASSERT_EQ(loaded_params.size(), params.size());
+  size_t i = 0;
+  for (const auto& param : loaded_params) {
+    ASSERT_TRUE(param.equal(params[i++]));
+  }
+
+  // The shards have to be next to the archive
+  std::remove((filename + ".1").c_str());
+  ASSERT_ANY_THROW(jit::load(filename));
+  std::remove(filename.c_str());
+  for (size_t shard = 2; shard < kNumShards; ++shard) {
+    std::remove((filename + "." + c10::to_string(shard)).c_str());
+  }
+}
+
 } // namespace jit
 } // namespace torch
@@ -11,6 +11,7 @@ namespace jit {
 #define TH_FORALL_TESTS(_)             \
   _(ADFormulas)                        \
   _(Attributes)                        \
+  _(BatchingExecutor)                  \
   _(Blocks)                            \
   _(CallStack)                         \
   _(CallStackCaching)                  \
@@ -19,6 +20,7 @@ namespace jit {
   _(CreateAutodiffSubgraphs)           \
   _(CustomOperators)                   \
   _(CustomOperatorAliasing)            \
+  _(CustomOperatorOverloads)           \
   _(IValueKWargs)                      \
   _(CustomFusion)                      \
   _(SchemaMatching)                    \
@@ -30,6 +32,8 @@ namespace jit {
   _(PassManagement)                    \
   _(Proto)                             \
   _(RegisterFusionCachesKernel)        \
+  _(LLVMFusion)                        \
+  _(FusionDiskCache)                   \
   _(SchemaParser)                      \
   _(TopologicalIndex)                  \
   _(TopologicalMove)                   \
@@ -49,7 +53,16 @@ namespace jit {
   _(NoneSchemaMatch)                   \
   _(ClassParser)                       \
   _(Profiler)                          \
+  _(StreamingProfiler)                 \
+  _(MemoryPlanning)                    \
+  _(RewriteToInplaceOps)               \
+  _(FoldFrozenBatchNorm)               \
+  _(BatchIndependentOps)               \
+  _(VectorizeLoops)                    \
+  _(AOTSource)                         \
   _(InsertAndEliminateRedundantGuards) \
+  _(ProfileSymbolicShapes)             \
+  _(BackgroundCompilation)             \
   _(InsertBailOuts)                    \
   _(PeepholeOptimize)                  \
   _(RecordFunction)                    \
@@ -60,20 +73,26 @@ namespace jit {
   _(ModuleDefine)                      \
   _(QualifiedName)                     \
   _(ClassImport)                       \
+  _(LazyClassImport)                   \
   _(ProfiledTensorTypeHashing)         \
   _(ScriptObject)                      \
   _(SaveExtraFilesHook)                \
+  _(SaveLoadSharded)                   \
   _(DCE)                               \
   _(CustomFusionNestedBlocks)          \
   _(ClassDerive)                       \
   _(ModuleInterfaceSerialization)      \
   _(ClassTypeAddRemoveAttr)            \
   _(Inliner)                           \
+  _(InlineTrivialForks)                \
   _(LiteInterpreterAdd)                \
   _(LiteInterpreterConv)               \
   _(LiteInterpreterInline)             \
   _(LiteInterpreterTuple)              \
   _(LiteInterpreterPrimOverload)       \
+  _(LiteInterpreterOperatorTable)      \
+  _(LiteInterpreterMemoryPlan)         \
+  _(LiteInterpreterFlatBytecode)       \
   _(CommonAncestor)
 
 #define TH_FORALL_TESTS_CUDA(_) \
@@ -82,7 +101,8 @@ namespace jit {
   _(Fusion)                     \
   _(GraphExecutor)              \
   _(ModuleConversion)           \
-  _(Interp)
+  _(Interp)                     \
+  _(InputStager)
 
 #define DECLARE_JIT_TEST(name) void test##name();
 TH_FORALL_TESTS(DECLARE_JIT_TEST)
@@ -67,6 +67,19 @@ def _compare_owner_value(context_id, rref, grad):
     return torch.equal(grads[rref.local_value()], grad)
 
 
+def _create_seeded_linear(in_features, out_features, seed):
+    torch.manual_seed(seed)
+    return torch.nn.Sequential(torch.nn.Linear(in_features, out_features), torch.nn.Tanh())
+
+
+def _module_params(module_rref):
+    return [p.detach().clone() for p in module_rref.local_value().parameters()]
+
+
+def _module_grads(module_rref):
+    return [p.grad.clone() for p in module_rref.local_value().parameters()]
+
+
 def my_py_add(t1, t2):
     return torch.add(t1, t2)
 
@@ -634,6 +647,31 @@ class DistAutogradTest(RpcAgentTestFixture):
     def test_grad_only_on_return_value_remote(self):
         self._test_grad_only_on_return_value(ExecMode.REMOTE)
 
+    @dist_init
+    def test_context_stats(self):
+        dst_rank = (self.rank + 1) % self.world_size
+        with dist_autograd.context() as context_id:
+            t1 = torch.ones(3, 3, requires_grad=True)
+            t2 = torch.zeros(3, 3, requires_grad=True)
+            ret = rpc.rpc_sync(
+                "worker{}".format(dst_rank), torch.add, args=(t1, t2))
+            ctx = dist_autograd._current_context()
+            stats = ctx._stats()
+            self.assertEqual(1, stats["num_send_functions"])
+            self.assertEqual(1, stats["num_recv_functions"])
+            self.assertEqual(0, stats["num_gradients"])
+
+            dist_autograd.backward([ret.sum()])
+
+            # The autograd functions are released once the backward pass is
+            # done, the gradients are kept.
+            stats = ctx._stats()
+            self.assertEqual(0, stats["num_send_functions"])
+            self.assertEqual(0, stats["num_recv_functions"])
+            self.assertEqual(2, stats["num_gradients"])
+            self.assertEqual(2 * t1.numel() * t1.element_size(),
+                             stats["gradient_bytes"])
+
     def _test_rpc_complex_args(self, exec_mode):
         with dist_autograd.context() as context_id:
             num_tensors = 10
@@ -1288,6 +1326,51 @@ class DistAutogradTest(RpcAgentTestFixture):
             self.assertEqual(t2.grad, grads[t2])
 
 
+    @dist_init
+    def test_pipeline(self):
+        if self.rank != 0:
+            return
+        from torch.distributed.rpc.pipeline import Pipeline
+
+        sizes = [5, 6, 3]
+        stages = [
+            rpc.remote("worker{}".format(i + 1), _create_seeded_linear,
+                       args=(sizes[i], sizes[i + 1], i))
+            for i in range(len(sizes) - 1)
+        ]
+        inputs = torch.randn(10, sizes[0])
+        targets = torch.randn(10, sizes[-1])
+
+        # The same model run locally
+        local = []
+        for stage in stages:
+            layer = torch.nn.Linear(1, 1)
+            weight, bias = rpc.rpc_sync(stage.owner(), _module_params, args=(stage,))
+            layer.weight.data = weight
+            layer.bias.data = bias
+            local.append(layer)
+        out = inputs
+        for layer in local:
+            out = layer(out).tanh()
+        expected_loss = torch.nn.functional.mse_loss(out, targets)
+        expected_loss.backward()
+
+        for chunks in [1, 3, 4]:
+            pipe = Pipeline(stages, chunks)
+            pipe.zero_grad()
+            loss = pipe.train_step(inputs, targets, torch.nn.functional.mse_loss)
+            self.assertEqual(loss, expected_loss)
+            for stage, layer in zip(stages, local):
+                weight_grad, bias_grad = rpc.rpc_sync(stage.owner(), _module_grads, args=(stage,))
+                self.assertEqual(weight_grad, layer.weight.grad)
+                self.assertEqual(bias_grad, layer.bias.grad)
+            stats = pipe.stats()
+            self.assertEqual(len(stats), len(stages))
+            for stage_stats in stats:
+                self.assertGreater(stage_stats.forward_time, 0)
+                self.assertGreater(stage_stats.backward_time, 0)
+                self.assertGreaterEqual(stage_stats.idle_time, 0)
+
     _test_clean_context_backward_context_id = None
 
     class MyBackwardFunc(Function):
@@ -126,6 +126,16 @@ def my_function(a, b, c):
 def my_tensor_function(a, b):
     return a + b
 
+
+@torch.jit.script
+def my_script_function(a, b):
+    # type: (Tensor, int) -> Tensor
+    return a * b + 1
+
+def return_tensors(*tensors):
+    return tensors
+
+
 def my_sleep_func(seconds=1):
     import time
     time.sleep(seconds)
@@ -627,6 +637,27 @@ class RpcTest(RpcAgentTestFixture):
         )
         self.assertEqual(ret, my_tensor_function(torch.ones(n, n), torch.ones(n, n)))
 
+    @dist_init
+    def test_py_tensors_layouts(self):
+        n = self.rank + 1
+        base = torch.arange(64, dtype=torch.float).view(8, 8)
+        tensors = (
+            base.t(),  # not contiguous
+            base[2:4],  # a slice of a larger storage
+            torch.arange(n, dtype=torch.int32),
+            torch.empty(0, 3),
+            torch.ones(n, n, requires_grad=True),
+            torch.sparse_coo_tensor([[0, 1]], [1.0, 2.0], size=(4,)),
+        )
+        for dst_rank in [(self.rank + 1) % self.world_size, self.rank]:
+            ret = rpc.rpc_sync(
+                "worker{}".format(dst_rank), return_tensors, args=tensors
+            )
+            self.assertEqual(len(ret), len(tensors))
+            for result, expected in zip(ret, tensors):
+                self.assertEqual(result.dtype, expected.dtype)
+                self.assertEqual(result, expected)
+
     @dist_init
     def test_py_tensors_multi_async_call(self):
         futs = []
@@ -728,6 +759,24 @@ class RpcTest(RpcAgentTestFixture):
     def test_stress_heavy_rpc(self):
         self._stress_test_rpc(heavy_rpc, repeat=20, args=(torch.ones(100, 100),))
 
+    @dist_init
+    def test_script_function(self):
+        n = self.rank + 1
+        dst_rank = n % self.world_size
+        ret = rpc.rpc_sync(
+            "worker{}".format(dst_rank),
+            my_script_function,
+            args=(torch.ones(n, n), n),
+        )
+        self.assertEqual(ret, my_script_function(torch.ones(n, n), n))
+
+        rref = rpc.remote(
+            "worker{}".format(dst_rank),
+            my_script_function,
+            kwargs={"a": torch.ones(n, n), "b": 2},
+        )
+        self.assertEqual(rref.to_here(), torch.ones(n, n) * 3)
+
     @dist_init
     def test_builtin_remote_ret(self):
         n = self.rank + 1
@@ -972,6 +1021,35 @@ class RpcTest(RpcAgentTestFixture):
         ret = ret_rref
         self.assertEqual(ret, torch.add(torch.ones(n, n), 1))
 
+    @dist_init
+    def test_to_here_many(self):
+        n = self.rank + 1
+        dst_rank = n % self.world_size
+        rrefs = [
+            rpc.remote("worker{}".format(dst_rank), torch.add, args=(torch.ones(n, n), i))
+            for i in range(10)
+        ]
+        rrefs.append(rpc.remote("worker{}".format(dst_rank), my_function, args=(n, 1, 2)))
+        rrefs.append(RRef(35))
+        values = rpc.to_here_many(rrefs)
+        for i in range(10):
+            self.assertEqual(values[i], torch.ones(n, n) + i)
+        self.assertEqual(values[10], n + 3)
+        self.assertEqual(values[11], 35)
+
+    @dist_init
+    def test_to_here_cache(self):
+        n = self.rank + 1
+        dst_rank = n % self.world_size
+        rref = rpc.remote(
+            "worker{}".format(dst_rank), torch.add, args=(torch.ones(n, n), 1))
+        first = rref.to_here(cache=True)
+        # The cached copy is returned as is, an uncached call fetches a new one
+        self.assertIs(rref.to_here(cache=True), first)
+        self.assertIsNot(rref.to_here(), first)
+        self.assertEqual(rref.to_here(), first)
+        self.assertIs(rpc.to_here_many([rref], cache=True)[0], first)
+
     @dist_init
     def test_local_rref_no_fork(self):
         local_rref = RRef(35)
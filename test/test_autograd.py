@@ -1,6 +1,7 @@
 import contextlib
 import gc
 import sys
+import os
 import math
 import tempfile
 import time
@@ -27,7 +28,7 @@ from torch.utils.checkpoint import checkpoint
 from common_utils import (TEST_MKL, TestCase, run_tests, skipIfNoLapack,
                           suppress_warnings, slowTest,
                           load_tests, random_symmetric_pd_matrix, random_symmetric_matrix, IS_WINDOWS, IS_MACOS)
-from torch.autograd import Variable, Function, detect_anomaly
+from torch.autograd import Variable, Function, detect_anomaly, detect_nonfinite
 from torch.autograd.function import InplaceFunction
 from torch.testing import randn_like
 from common_methods_invocations import (method_tests,
@@ -2594,6 +2595,32 @@ class TestAutograd(TestCase):
         print(prof.table())
         print(prof.key_averages(group_by_input_shape=True).table())
 
+    def test_profiler_memory(self):
+        x = torch.randn(1000, 1000)
+        with profile(profile_memory=True) as prof:
+            with record_function("outer"):
+                y = x * 2
+                with record_function("inner"):
+                    z = torch.empty(1000, 1000)
+                    del z
+        nbytes = 1000 * 1000 * 4
+        events = {evt.name: evt for evt in prof.function_events}
+
+        # record_function allocates a small handle
+        def assertAbout(usage, expected):
+            self.assertGreaterEqual(usage, expected - 1024)
+            self.assertLessEqual(usage, expected + 1024)
+
+        assertAbout(events["mul"].cpu_memory_usage, nbytes)
+        assertAbout(events["inner"].cpu_memory_usage, 0)
+        assertAbout(events["inner"].self_cpu_memory_usage, -nbytes)
+        assertAbout(events["inner"].cpu_peak_memory_usage, nbytes)
+        assertAbout(events["outer"].cpu_memory_usage, nbytes)
+        assertAbout(events["outer"].self_cpu_memory_usage, 0)
+        assertAbout(events["outer"].cpu_peak_memory_usage, 2 * nbytes)
+        self.assertIn("Self CPU Mem", prof.key_averages().table())
+        del y
+
     def test_profiler_no_cuda(self):
         print("")
         layer = torch.nn.Linear(20, 30)
@@ -3058,6 +3085,28 @@ class TestAutograd(TestCase):
                     out.backward()
             self.assertIn('MyFunc.apply', str(w[0].message))
 
+    def test_detect_nonfinite(self):
+        a = torch.tensor([1., 0.], requires_grad=True)
+        with detect_nonfinite() as check:
+            (a * 2).sum().backward()
+        self.assertFalse(check.found)
+
+        with detect_nonfinite() as check:
+            a.log().sum().backward()
+        self.assertTrue(check.found)
+        self.assertFalse(torch._C._is_finite_check_enabled())
+
+        # Gradients computed outside of the check don't trip it
+        a.log().sum().backward()
+        with detect_nonfinite() as check:
+            pass
+        self.assertFalse(check.found)
+
+        with self.assertRaisesRegex(RuntimeError, "Function 'LogBackward' returned non-finite values in its 0th output."):
+            with warnings.catch_warnings(record=True):
+                with detect_anomaly(), detect_nonfinite():
+                    a.log().sum().backward()
+
     @skipIfNoLapack
     def test_symeig_no_eigenvectors(self):
         A = torch.tensor([[1., 2.], [2., 4.]], dtype=torch.float32, requires_grad=True)
@@ -3280,6 +3329,38 @@ for shape in [(1,), ()]:
         self.assertEqual(order.count("Reentrant"), 10)
         self.assertEqual(order[-1], "MyFunction")
 
+    def test_parallel_cpu_backward(self):
+        import subprocess
+        # Independent towers that share their input, a reentrant (checkpointed)
+        # branch, and a parameter that receives gradients from every tower
+        script = """if True:
+            import torch
+            from torch.utils.checkpoint import checkpoint
+            torch.manual_seed(0)
+            x = torch.randn(64, 32, dtype=torch.double, requires_grad=True)
+            w = torch.randn(32, 32, dtype=torch.double, requires_grad=True)
+            towers = []
+            for i in range(8):
+                h = x
+                for _ in range(4):
+                    h = torch.tanh(h.mm(w) + i)
+                towers.append(h.sum())
+            towers.append(checkpoint(lambda t: t.mm(w).sin(), x).sum())
+            sum(towers).backward()
+            print(repr(x.grad.sum().item()), repr(w.grad.sum().item()))
+        """
+
+        def run(num_threads):
+            env = os.environ.copy()
+            env['PYTORCH_AUTOGRAD_CPU_THREADS'] = str(num_threads)
+            return subprocess.check_output([sys.executable, '-c', script], env=env)
+
+        serial = run(1)
+        parallel = run(4)
+        self.assertEqual(parallel, run(4))
+        self.assertEqual(
+            [float(v) for v in serial.split()], [float(v) for v in parallel.split()])
+
     @slowTest
     def test_checkpointing(self):
         num_inp = 2000
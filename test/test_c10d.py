@@ -253,6 +253,25 @@ class StoreTestBase(object):
     def test_set_get(self):
         self._test_set_get(self._create_store())
 
+    def _test_multi_set_get(self, fs):
+        fs.multi_set(["key0", "key1", "key2"], ["value0", "value1", "value2"])
+        self.assertEqual([b"value2", b"value0"], fs.multi_get(["key2", "key0"]))
+        self.assertEqual(b"value1", fs.get("key1"))
+
+    def test_multi_set_get(self):
+        self._test_multi_set_get(self._create_store())
+
+    def _test_compare_set(self, fs):
+        # A missing key is only set if it's expected to be missing.
+        self.assertEqual(b"value0", fs.compare_set("cs_key", "value0", "value1"))
+        self.assertEqual(b"value1", fs.compare_set("cs_key", "", "value1"))
+        self.assertEqual(b"value1", fs.compare_set("cs_key", "value0", "value2"))
+        self.assertEqual(b"value2", fs.compare_set("cs_key", "value1", "value2"))
+        self.assertEqual(b"value2", fs.get("cs_key"))
+
+    def test_compare_set(self):
+        self._test_compare_set(self._create_store())
+
 
 class FileStoreTest(TestCase, StoreTestBase):
     def setUp(self):
@@ -586,6 +605,21 @@ class ProcessGroupGlooTest(MultiProcessTestCase):
         for work in [pg.allreduce(torch.ones(i + 1)) for i in range(4)]:
             work.wait()
 
+    def test_lazy_init(self):
+        store = c10d.FileStore(self.file_name, self.world_size)
+        opts = self.opts()
+        opts.lazy_init = True
+        # Only rank 0 creates this group, which would wait for the other
+        # ranks forever if it connected in the constructor
+        if self.rank == 0:
+            c10d.ProcessGroupGloo(c10d.PrefixStore("unused", store), self.rank, self.world_size, opts)
+
+        pg = c10d.ProcessGroupGloo(c10d.PrefixStore("used", store), self.rank, self.world_size, opts)
+        for i in range(2):
+            tensor = torch.tensor([self.rank + i])
+            pg.allreduce(tensor).wait()
+            self.assertEqual(torch.tensor([self.world_size * (self.world_size - 1) // 2 + self.world_size * i]), tensor)
+
     def test_empty_tensors(self):
         store = c10d.FileStore(self.file_name, self.world_size)
         pg = c10d.ProcessGroupGloo(store, self.rank, self.world_size, self.opts())
@@ -851,6 +885,24 @@ class ProcessGroupGlooTest(MultiProcessTestCase):
     def test_allreduce_coalesced_basics(self):
         self._test_allreduce_coalesced_basics(lambda t: t.clone())
 
+    def test_allreduce_coalesced_flat_views(self):
+        store = c10d.FileStore(self.file_name, self.world_size)
+        pg = c10d.ProcessGroupGloo(store, self.rank, self.world_size, self.opts())
+
+        # Views of a single flat buffer are reduced in place, and the
+        # other tensors are staged, in either order.
+        flat = torch.arange(6, dtype=torch.float) + self.rank
+        views = [flat[:2].view(2, 1), flat[2:]]
+        expected = [t.clone() * self.world_size + sum(range(self.world_size))
+                    - self.rank * self.world_size for t in views]
+        pg.allreduce_coalesced(views).wait()
+        self.assertEqual(expected, views)
+
+        scattered = [flat[4:].clone(), flat[:2].clone()]
+        expected = [t * self.world_size for t in scattered]
+        pg.allreduce_coalesced(scattered).wait()
+        self.assertEqual(expected, scattered)
+
     def _test_allreduce_coalesced_stress(self, inputs):
         store = c10d.FileStore(self.file_name, self.world_size)
         pg = c10d.ProcessGroupGloo(store, self.rank, self.world_size, self.opts(threads=8))
@@ -1953,6 +2005,35 @@ class DistributedDataParallelTest(MultiProcessTestCase):
     def test_gloo_backend_cpu_module(self):
         self._test_gloo_backend([torch.device('cpu')], [])
 
+    @requires_gloo()
+    def test_ddp_uneven_inputs_join(self):
+        store = c10d.FileStore(self.file_name, self.world_size)
+        options = c10d.ProcessGroupGloo.Options()
+        options.devices = [c10d.ProcessGroupGloo.create_device(interface=LOOPBACK)]
+        process_group = c10d.ProcessGroupGloo(store, self.rank, self.world_size, options)
+        torch.manual_seed(1337)
+        ddp_model = DistributedDataParallel(
+            Net(), process_group=process_group, bucket_cap_mb=0.001)
+
+        # Every process runs a different number of iterations.
+        torch.manual_seed(self.rank)
+        with ddp_model.join():
+            for _ in range(3 + 2 * self.rank):
+                output = ddp_model(torch.randn(2, 2))
+                F.mse_loss(output, torch.randn(2, 4)).backward()
+                with torch.no_grad():
+                    for param in ddp_model.parameters():
+                        param -= param.grad
+                        param.grad = None
+        self.assertEqual(ddp_model._join_iterations, 3 + 2 * self.rank)
+
+        # The parameters are those of the process that ran the most iterations.
+        for param in ddp_model.parameters():
+            gathered = [torch.empty_like(param) for _ in range(self.world_size)]
+            process_group.allgather([gathered], [param.detach()]).wait()
+            for other in gathered:
+                self.assertEqual(other, param)
+
     @requires_gloo()
     @skip_if_not_multigpu
     def test_gloo_backend_1gpu_module_device_ids_integer_list(self):
@@ -2910,6 +2991,161 @@ class ReducerTest(TestCase):
         reducer.prepare_for_backward(output)
         output.backward()
 
+    def test_gradient_as_bucket_view(self):
+        batch_size = 10
+        model = self._create_mixed_precision_model()
+        parameters = [list(model.parameters())]
+        group_by_type = groupby(
+            range(len(parameters[0])),
+            key=lambda i: parameters[0][i].type())
+        buckets = [list(indices) for _, indices in group_by_type]
+        reducer = dist.Reducer(
+            parameters, buckets, self.process_group, gradient_as_bucket_view=True)
+        for p in model.parameters():
+            self.assertEqual(p.grad, torch.zeros_like(p))
+
+        loss = nn.CrossEntropyLoss()
+        input = torch.rand([batch_size, 2], dtype=torch.double)
+        target = torch.LongTensor([random.randrange(4) for _ in range(batch_size)])
+        grad_ptrs = [p.grad.data_ptr() for p in model.parameters()]
+        for _ in range(2):
+            model.zero_grad()
+            output = loss(model(input), target)
+            reducer.prepare_for_backward(output)
+            output.backward()
+            self.assertEqual(grad_ptrs, [p.grad.data_ptr() for p in model.parameters()])
+
+        expected = self._create_mixed_precision_model()
+        expected.load_state_dict(model.state_dict())
+        loss(expected(input), target).backward()
+        for p, q in zip(model.parameters(), expected.parameters()):
+            self.assertEqual(p.grad, q.grad)
+
+    def test_comm_hooks(self):
+        batch_size = 10
+        loss = nn.CrossEntropyLoss()
+        input = torch.rand([batch_size, 2], dtype=torch.double)
+        target = torch.LongTensor([random.randrange(4) for _ in range(batch_size)])
+        hooks = [
+            (c10d.AllreduceHook(self.process_group), 0),
+            (c10d.FP16CompressHook(self.process_group), 1e-3),
+            # A full rank approximation or all of the elements make the
+            # compression lossless.
+            (c10d.PowerSGDHook(self.process_group, matrix_approximation_rank=16), 1e-5),
+            (c10d.TopKHook(self.process_group, ratio=1.0), 0),
+        ]
+        for hook, prec in hooks:
+            model = self._create_mixed_precision_model()
+            reducer = self._create_reducer_for_models([model])
+            reducer.register_comm_hook(hook)
+            for _ in range(2):
+                model.zero_grad()
+                output = loss(model(input), target)
+                reducer.prepare_for_backward(output)
+                output.backward()
+
+            expected = self._create_mixed_precision_model()
+            expected.load_state_dict(model.state_dict())
+            loss(expected(input), target).backward()
+            for p, q in zip(model.parameters(), expected.parameters()):
+                self.assertEqual(p.grad, q.grad, prec=prec)
+
+    def test_top_k_hook_sparsity(self):
+        batch_size = 10
+        model = ReducerModule()
+        parameters = list(model.parameters())
+        reducer = dist.Reducer([parameters], [list(range(len(parameters)))], self.process_group)
+        reducer.register_comm_hook(c10d.TopKHook(self.process_group, ratio=0.1))
+        loss = nn.CrossEntropyLoss()
+        input = torch.rand([batch_size, 2])
+        target = torch.LongTensor([random.randrange(4) for _ in range(batch_size)])
+        output = loss(model(input), target)
+        reducer.prepare_for_backward(output)
+        output.backward()
+        num_sent = sum((p.grad != 0).sum().item() for p in parameters)
+        self.assertLessEqual(num_sent, sum(p.numel() for p in parameters) // 10)
+
+    def test_bucket_timing(self):
+        batch_size = 10
+        model = self._create_mixed_precision_model()
+        reducer = self._create_reducer_for_models([model])
+        loss = nn.CrossEntropyLoss()
+        input = torch.rand([batch_size, 2], dtype=torch.double)
+        target = torch.LongTensor([random.randrange(4) for _ in range(batch_size)])
+        reducer.set_bucket_timing(True)
+        for _ in range(2):
+            model.zero_grad()
+            output = loss(model(input), target)
+            reducer.prepare_for_backward(output)
+            output.backward()
+            stats = reducer.get_bucket_stats()
+            self.assertEqual(len(stats), 2)
+            for bucket in stats:
+                self.assertGreaterEqual(bucket.ready_ns, 0)
+                self.assertGreaterEqual(bucket.launch_ns, bucket.ready_ns)
+                self.assertGreaterEqual(bucket.finish_ns, bucket.launch_ns)
+            # Buckets are reduced in order.
+            self.assertGreaterEqual(stats[1].launch_ns, stats[0].launch_ns)
+
+    def test_rebuild_buckets(self):
+        batch_size = 10
+        model = self._create_mixed_precision_model()
+        parameters = [list(model.parameters())]
+        # The double fc1 weight and the float fc2 and fc3 weights.
+        buckets = [[0], [1, 2]]
+        reducer = dist.Reducer(parameters, buckets, self.process_group)
+        loss = nn.CrossEntropyLoss()
+        input = torch.rand([batch_size, 2], dtype=torch.double)
+        target = torch.LongTensor([random.randrange(4) for _ in range(batch_size)])
+
+        # Nothing to rebuild the buckets from before a backward pass.
+        self.assertFalse(reducer.rebuild_buckets())
+        for i in range(3):
+            model.zero_grad()
+            output = loss(model(input), target)
+            reducer.prepare_for_backward(output)
+            output.backward()
+            self.assertEqual(reducer.rebuild_buckets(), i == 0)
+
+        expected = self._create_mixed_precision_model()
+        expected.load_state_dict(model.state_dict())
+        loss(expected(input), target).backward()
+        for p, q in zip(model.parameters(), expected.parameters()):
+            self.assertEqual(p.grad, q.grad)
+
+    def test_sharded_optimizer_hook(self):
+        batch_size = 10
+        model = ReducerModule()
+        expected = copy.deepcopy(model)
+        parameters = list(model.parameters())
+        reducer = dist.Reducer([parameters], [[2], [0, 1]], self.process_group)
+        hook = c10d.ShardedOptimizerHook(self.process_group, parameters)
+        reducer.register_comm_hook(hook)
+        self.assertEqual([s.numel() for s in hook.shards()], [16, 60])
+        optimizer = torch.optim.SGD(hook.shards(), lr=0.1, momentum=0.9)
+        expected_optimizer = torch.optim.SGD(expected.parameters(), lr=0.1, momentum=0.9)
+        loss = nn.CrossEntropyLoss()
+        input = torch.rand([batch_size, 2])
+        target = torch.LongTensor([random.randrange(4) for _ in range(batch_size)])
+        for _ in range(3):
+            model.zero_grad()
+            optimizer.zero_grad()
+            output = loss(model(input), target)
+            reducer.prepare_for_backward(output)
+            output.backward()
+            optimizer.step()
+            hook.allgather_parameters()
+
+            expected_optimizer.zero_grad()
+            loss(expected(input), target).backward()
+            expected_optimizer.step()
+
+        for p, q in zip(model.parameters(), expected.parameters()):
+            self.assertEqual(p, q)
+        # Reinitializing the same buckets keeps the shards and their state.
+        reducer.initialize_buckets([[2], [0, 1]])
+        self.assertEqual(hook.layout_version(), 1)
+
     def test_forward_backward_multi_replica(self):
         batch_size = 10
         num_replicas = 2
@@ -7,6 +7,8 @@ from itertools import repeat
 import os
 from contextlib import contextmanager
 import threading
+import time
+from distutils.version import LooseVersion
 if sys.version_info[0] == 3:
     import queue
 else:
@@ -277,6 +279,108 @@ class TestCuda(TestCase):
         for _ in self._test_memory_stats_generator(self):
             self._check_memory_stat_consistency()
 
+    @unittest.skipIf(IS_WINDOWS or torch.version.cuda is None or
+                     LooseVersion(torch.version.cuda) < LooseVersion("10.2"),
+                     "expandable segments need CUDA 10.2")
+    def test_memory_expandable_segments(self):
+        import subprocess
+        env = dict(os.environ, PYTORCH_CUDA_ALLOCATOR_EXPANDABLE_SEGMENTS="1")
+        subprocess.check_call([sys.executable, '-c', """\
+import torch
+
+mb = 1 << 20
+torch.cuda.empty_cache()
+tensors = [torch.empty(n * mb, dtype=torch.uint8, device='cuda') for n in (30, 50, 70)]
+
+def large_segments():
+    return [s for s in torch.cuda.memory_snapshot() if s["segment_type"] == "large"]
+
+segments = large_segments()
+assert len(segments) == 1, segments
+assert segments[0]["is_expandable"]
+assert segments[0]["total_size"] >= 150 * mb
+assert segments[0]["reserved_size"] > segments[0]["total_size"]
+assert torch.cuda.memory_stats()["segment.large_pool.current"] == 1
+
+# freeing the last block returns its memory on empty_cache
+del tensors[2]
+torch.cuda.empty_cache()
+assert large_segments()[0]["total_size"] < 150 * mb
+assert torch.cuda.memory_reserved() == sum(s["total_size"] for s in torch.cuda.memory_snapshot())
+
+del tensors
+torch.cuda.empty_cache()
+assert len(large_segments()) == 0
+assert torch.cuda.memory_stats()["reserved_bytes.large_pool.current"] == 0
+"""], env=env)
+
+    @unittest.skipIf(IS_WINDOWS, "NamedTemporaryFile cannot be reopened on Windows")
+    def test_memory_trace(self):
+        torch.cuda.memory._record_memory_trace(True, max_entries=4)
+        try:
+            x = torch.empty(1000, device='cuda')
+            x.record_stream(torch.cuda.Stream())
+            del x
+            torch.cuda.empty_cache()
+            with tempfile.NamedTemporaryFile(mode='r') as f:
+                torch.cuda.memory._save_memory_trace(f.name)
+                lines = [line.split() for line in f]
+        finally:
+            torch.cuda.memory._record_memory_trace(False)
+
+        self.assertEqual([line[0] for line in lines], ['m', 'r', 'f', 'e'])
+        self.assertEqual(int(lines[0][3]), 4000)
+        # free and record_stream refer to the block that was allocated
+        self.assertEqual(lines[0][2], lines[1][2])
+        self.assertEqual(lines[0][2], lines[2][2])
+
+        # the ring buffer keeps the most recent events
+        torch.cuda.memory._record_memory_trace(True, max_entries=2)
+        try:
+            for _ in range(3):
+                torch.empty(10, device='cuda')
+            with tempfile.NamedTemporaryFile(mode='r') as f:
+                torch.cuda.memory._save_memory_trace(f.name)
+                actions = [line.split()[0] for line in f]
+        finally:
+            torch.cuda.memory._record_memory_trace(False)
+        self.assertEqual(actions, ['m', 'f'])
+
+    def test_memory_stats_size_classes(self):
+        import subprocess
+        env = dict(os.environ, PYTORCH_CUDA_ALLOCATOR_SIZE_CLASSES="1")
+        subprocess.check_call([sys.executable, '-c', """\
+import torch
+
+torch.cuda.empty_cache()
+side = torch.cuda.Stream()
+tensors = [torch.empty(n, dtype=torch.uint8, device='cuda') for n in (1, 700, 3000, 1 << 20)]
+with torch.cuda.stream(side):
+    tensors.append(torch.empty(5000, dtype=torch.uint8, device='cuda'))
+tensors[0].record_stream(side)
+allocated = torch.cuda.memory_allocated()
+del tensors
+
+stats = torch.cuda.memory_stats()
+assert stats["size_class_cached_blocks"] == 4, stats["size_class_cached_blocks"]
+assert stats["size_class_cached_bytes"] == 1024 + 4096 + (1 << 20) + 8192
+assert stats["allocated_bytes.all.current"] == 0
+assert allocated == stats["size_class_cached_bytes"] + 512
+
+states = [b["state"] for s in torch.cuda.memory_snapshot() for b in s["blocks"]]
+assert states.count("size_class_cached") == 4, states
+
+# a cached block is reused for a request of the same size class
+x = torch.empty(600, dtype=torch.uint8, device='cuda')
+assert torch.cuda.memory_stats()["size_class_cached_blocks"] == 3
+del x
+
+torch.cuda.empty_cache()
+stats = torch.cuda.memory_stats()
+assert stats["size_class_cached_blocks"] == 0
+assert stats["size_class_cached_bytes"] == 0
+"""], env=env)
+
     def test_cuda_get_device_name(self):
         # Testing the behaviour with None as an argument
         current_device = torch.cuda.current_device()
@@ -1471,6 +1575,41 @@ class TestCuda(TestCase):
         self.assertEqual(gpu_tensor1[0], 1)
         self.assertEqual(gpu_tensor0[0], 2)
 
+    def test_caching_pinned_memory_stats(self):
+        torch.cuda.empty_cache()
+        torch.cuda.reset_peak_host_memory_stats()
+        before = torch.cuda.host_memory_stats()
+
+        # requests of the same size class share a cached block
+        t = torch.empty(3000, dtype=torch.uint8).pin_memory()
+        stats = torch.cuda.host_memory_stats()
+        self.assertEqual(stats["allocation.current"], before["allocation.current"] + 1)
+        self.assertEqual(stats["allocated_bytes.current"], before["allocated_bytes.current"] + 4096)
+        ptr = t.data_ptr()
+        del t
+        t = torch.empty(4000, dtype=torch.uint8).pin_memory()
+        self.assertEqual(t.data_ptr(), ptr, 'allocation not reused')
+        self.assertEqual(torch.cuda.host_memory_stats()["segment.current"],
+                         stats["segment.current"])
+        del t
+
+        # the trimmer releases cached blocks above the limit
+        tensors = [torch.empty(1 << 20, dtype=torch.uint8).pin_memory() for _ in range(4)]
+        reserved = torch.cuda.host_memory_stats()["reserved_bytes.current"]
+        del tensors
+        try:
+            torch.cuda.memory._set_host_memory_max_cached_bytes(1 << 20)
+            for _ in range(100):
+                stats = torch.cuda.host_memory_stats()
+                if stats["num_trimmed_blocks"] >= before["num_trimmed_blocks"] + 3:
+                    break
+                time.sleep(0.01)
+            self.assertGreaterEqual(stats["num_trimmed_blocks"], before["num_trimmed_blocks"] + 3)
+            self.assertLessEqual(stats["reserved_bytes.current"], reserved - 3 * (1 << 20))
+            self.assertGreaterEqual(stats["reserved_bytes.peak"], reserved)
+        finally:
+            torch.cuda.memory._set_host_memory_max_cached_bytes(2 ** 63 - 1)
+
     def test_caching_allocator_record_stream_oom(self):
         """allocations delayed by a record_stream call should still be freed on
         an out-of-memory in cuda_malloc_retry. see issue #19219"""
@@ -1522,6 +1661,220 @@ class TestCuda(TestCase):
         x = torch.ones(65536, device='cuda', dtype=torch.float16)
         self.assertEqual(x.mean(dtype=torch.float32), 1)
 
+    def test_elementwise_vectorized(self):
+        # contiguous operands take the vectorized path when aligned, and the
+        # per-element one when a slice offset breaks the alignment
+        for dtype in [torch.half, torch.float, torch.double, torch.uint8]:
+            for n in [1, 7, 8, 1000, 65537]:
+                for offset in range(4):
+                    x = torch.arange(n + offset, device='cuda') % 100
+                    a = x.to(dtype)[offset:]
+                    b = x.flip(0).to(dtype)[offset:]
+                    a_ref = x[offset:].cpu().double()
+                    b_ref = x.flip(0)[offset:].cpu().double()
+                    self.assertEqual((a + b).cpu().double(), a_ref + b_ref)
+                    self.assertEqual((a * 2).cpu().double(), a_ref * 2)
+                    self.assertEqual((a < b).cpu(), a_ref < b_ref)
+
+    def test_multi_tensor_optimizers(self):
+        # sizes that take several chunks and, with 120 tensors, several launches
+        sizes = [1, 7, 65536, 65537, 200000] + [100] * 115
+        lr, beta1, beta2, weight_decay, eps = 0.01, 0.9, 0.999, 0.1, 1e-8
+        for amsgrad in [False, True]:
+            params = [torch.randn(n, device='cuda') for n in sizes]
+            grads = [torch.randn(n, device='cuda') for n in sizes]
+            exp_avgs = [torch.randn(n, device='cuda') for n in sizes]
+            exp_avg_sqs = [torch.rand(n, device='cuda') for n in sizes]
+            max_exp_avg_sqs = [torch.rand(n, device='cuda') for n in sizes]
+            steps = [i % 5 + 1 for i in range(len(sizes))]
+            expected = []
+            for p, g, m, v, v_max, step in zip(params, grads, exp_avgs, exp_avg_sqs, max_exp_avg_sqs, steps):
+                g = g + weight_decay * p
+                m = beta1 * m + (1 - beta1) * g
+                v = beta2 * v + (1 - beta2) * g * g
+                v_max = torch.max(v_max, v) if amsgrad else v_max
+                denom = ((v_max if amsgrad else v) / (1 - beta2 ** step)).sqrt() + eps
+                expected.append((p - lr / (1 - beta1 ** step) * m / denom, m, v, v_max))
+            torch._multi_tensor_adam(params, grads, exp_avgs, exp_avg_sqs, max_exp_avg_sqs, steps,
+                                     lr, beta1, beta2, weight_decay, eps, amsgrad)
+            for i, (p, m, v, v_max) in enumerate(expected):
+                self.assertEqual(params[i], p)
+                self.assertEqual(exp_avgs[i], m)
+                self.assertEqual(exp_avg_sqs[i], v)
+                self.assertEqual(max_exp_avg_sqs[i], v_max)
+
+        momentum, dampening = 0.9, 0.1
+        for nesterov in [False, True]:
+            params = [torch.randn(n, device='cuda') for n in sizes]
+            grads = [torch.randn(n, device='cuda') for n in sizes]
+            bufs = [torch.randn(n, device='cuda') for n in sizes]
+            expected = []
+            for p, g, buf in zip(params, grads, bufs):
+                g = g + weight_decay * p
+                buf = momentum * buf + (1 - dampening) * g
+                update = g + momentum * buf if nesterov else buf
+                expected.append((p - lr * update, buf))
+            torch._multi_tensor_sgd(params, grads, bufs, lr, momentum, dampening, weight_decay, nesterov)
+            for i, (p, buf) in enumerate(expected):
+                self.assertEqual(params[i], p)
+                self.assertEqual(bufs[i], buf)
+
+        with self.assertRaisesRegex(RuntimeError, "same length"):
+            torch._multi_tensor_sgd([torch.randn(3, device='cuda')], [], [], lr, 0, 0, 0, False)
+
+    def test_foreach_half(self):
+        sizes = [1, 65536, 65537, 200000] + [100] * 116
+        a = [torch.randn(n, device='cuda').half() for n in sizes]
+        b = [torch.randn(n, device='cuda').half() for n in sizes]
+        # the kernels compute in float
+        self.assertEqual(torch._foreach_add(a, b, alpha=0.5),
+                         [(x.float() + 0.5 * y.float()).half() for x, y in zip(a, b)], prec=1e-2)
+        self.assertEqual(torch._foreach_mul(a, 3), [x * 3 for x in a], prec=1e-2)
+        expected = [x * y for x, y in zip(a, b)]
+        torch._foreach_mul_(a, b)
+        self.assertEqual(a, expected, prec=1e-2)
+
+    @skipIfRocm
+    @unittest.skipIf(torch.version.cuda is None or LooseVersion(torch.version.cuda) < LooseVersion("10.1"),
+                     "CUDA graphs need CUDA 10.1")
+    def test_graph_capture_replay(self):
+        with self.assertRaisesRegex(RuntimeError, "default stream"):
+            torch.cuda.CUDAGraph().capture_begin()
+
+        weight = torch.randn(16, 16, device='cuda')
+        static_in = torch.randn(8, 16, device='cuda')
+        g = torch.cuda.CUDAGraph()
+        s = torch.cuda.Stream()
+        s.wait_stream(torch.cuda.current_stream())
+        with torch.cuda.stream(s):
+            # warm up so that library handles are not created during capture
+            (static_in.mm(weight) + 1).relu_()
+            # allocations during capture come from the private pool of the graph
+            g.capture_begin()
+            static_out = (static_in.mm(weight) + 1).relu_()
+            g.capture_end()
+        torch.cuda.current_stream().wait_stream(s)
+
+        for _ in range(3):
+            data = torch.randn(8, 16, device='cuda')
+            static_in.copy_(data)
+            g.replay()
+            self.assertEqual(static_out, (data.mm(weight) + 1).relu())
+
+        # memory of the graph is not handed to eager allocations
+        out_ptr = static_out.data_ptr()
+        del static_out
+        others = [torch.empty(8, 16, device='cuda') for _ in range(8)]
+        self.assertNotIn(out_ptr, [t.data_ptr() for t in others])
+
+        g.reset()
+        with self.assertRaisesRegex(RuntimeError, "not been captured"):
+            g.replay()
+
+    def test_record_stream_released_by_wait(self):
+        cycles_per_ms = get_cycles_per_ms()
+        stream = torch.cuda.Stream()
+        before = torch.cuda.memory_stats()
+
+        with torch.cuda.stream(stream):
+            tmp = torch.cuda.FloatTensor(4).zero_()
+            ptr = tmp.data_ptr()
+        torch.cuda.current_stream().wait_stream(stream)
+        tmp.record_stream(torch.cuda.current_stream())
+        torch.cuda._sleep(int(50 * cycles_per_ms))  # keep the use pending
+        tmp.add_(1)
+        del tmp
+
+        stats = torch.cuda.memory_stats()
+        self.assertEqual(stats["deferred_free.all.current"], before["deferred_free.all.current"] + 1)
+        with torch.cuda.stream(stream):
+            self.assertNotEqual(torch.cuda.FloatTensor(4).data_ptr(), ptr, 'allocation re-used to soon')
+
+        # once the allocation stream waits on the use, the block can be reused
+        # without waiting for the use to complete on the host
+        stream.wait_stream(torch.cuda.current_stream())
+        stats = torch.cuda.memory_stats()
+        self.assertEqual(stats["deferred_free.all.current"], before["deferred_free.all.current"])
+        self.assertEqual(stats["num_deferred_frees_released_by_wait"],
+                         before["num_deferred_frees_released_by_wait"] + 1)
+        with torch.cuda.stream(stream):
+            self.assertEqual(torch.cuda.FloatTensor(4).data_ptr(), ptr, 'allocation not re-used')
+        torch.cuda.synchronize()
+
+    def test_copy_async(self):
+        x = torch.randn(1000, 3, device='cuda')
+        torch.cuda._sleep(int(50 * get_cycles_per_ms()))  # keep the copy pending
+        y = x * 2
+        future = torch.cuda.copy_async(y.t())
+        self.assertFalse(future.done())
+        result = future.wait()
+        self.assertTrue(future.done())
+        self.assertEqual(result.device, torch.device('cpu'))
+        self.assertTrue(result.is_pinned())
+        self.assertTrue(result.is_contiguous())
+        self.assertEqual(result, (x * 2).t().cpu(), 0)
+
+        # the copy is ordered after the work on the current stream only
+        stream = torch.cuda.Stream()
+        with torch.cuda.stream(stream):
+            stream.wait_stream(torch.cuda.default_stream())
+            future = torch.cuda.copy_async(x)
+        self.assertEqual(future.wait(), x.cpu(), 0)
+
+        w = torch.randn(3, device='cuda', requires_grad=True)
+        self.assertFalse(torch.cuda.copy_async(w * 2).wait().requires_grad)
+        with self.assertRaisesRegex(RuntimeError, "expected a CUDA tensor"):
+            torch.cuda.copy_async(torch.randn(3))
+
+    def test_autocast(self):
+        a = torch.randn(8, 8, device='cuda')
+        w = torch.randn(8, 8, device='cuda', requires_grad=True)
+        h = torch.randn(8, 8, device='cuda', dtype=torch.half)
+        with torch.cuda.amp.autocast():
+            self.assertTrue(torch._C.is_autocast_enabled())
+            out = torch.mm(a, w)
+            self.assertEqual(out.dtype, torch.half)
+            self.assertEqual(torch.nn.functional.linear(a, w).dtype, torch.half)
+            self.assertEqual(torch.softmax(h, 0).dtype, torch.float)
+            self.assertEqual(h.sum().dtype, torch.float)
+            self.assertEqual(torch.nn.functional.mse_loss(h, h).dtype, torch.float)
+            # other ops run in the types of their inputs
+            self.assertEqual((h + h).dtype, torch.half)
+            self.assertEqual((a + a).dtype, torch.float)
+            # CPU tensors aren't cast
+            self.assertEqual(torch.mm(a.cpu(), a.cpu()).dtype, torch.float)
+            with torch.cuda.amp.autocast(enabled=False):
+                self.assertEqual(torch.mm(a, a).dtype, torch.float)
+            self.assertEqual(torch.mm(a, a).dtype, torch.half)
+        self.assertFalse(torch._C.is_autocast_enabled())
+        self.assertEqual(torch.mm(a, a).dtype, torch.float)
+
+        out.float().sum().backward()
+        self.assertEqual(w.grad.dtype, torch.float)
+        self.assertEqual(w.grad, a.half().float().t().mm(torch.ones(8, 8, device='cuda')), 1e-2)
+
+        @torch.cuda.amp.autocast()
+        def mm(x, y):
+            return torch.mm(x, y)
+        self.assertEqual(mm(a, a).dtype, torch.half)
+
+    def test_autocast_cache(self):
+        w = torch.randn(8, 8, device='cuda', requires_grad=True)
+        h = torch.randn(8, 8, device='cuda', dtype=torch.half)
+
+        def cast_of_w(out):
+            return out.grad_fn.next_functions[1][0]
+
+        with torch.cuda.amp.autocast():
+            out1 = torch.mm(h, w)
+            with torch.cuda.amp.autocast():
+                out2 = torch.mm(h, w)
+            # the weight is cast once per outermost region
+            self.assertIs(cast_of_w(out1), cast_of_w(out2))
+        with torch.cuda.amp.autocast():
+            out3 = torch.mm(h, w)
+        self.assertIsNot(cast_of_w(out1), cast_of_w(out3))
+
     def test_prod_large(self):
         # tests global reduction (should_global_reduce = true) in case of non-zero identity element
         x = torch.ones(240000, device='cuda', dtype=torch.float32)
@@ -1563,6 +1916,53 @@ class TestCuda(TestCase):
         with self.assertRaisesRegex(RuntimeError, r"but got device with index"):
             torch.backends.cuda.cufft_plan_cache[torch.cuda.device_count() + 10]
 
+        # hits, misses and evictions
+        plan_cache = torch.backends.cuda.cufft_plan_cache
+        with plan_cache_max_size(1):
+            plan_cache.clear()
+            x = torch.randn(4, 8, 2, device='cuda')
+            hits, misses, evictions = plan_cache.hits, plan_cache.misses, plan_cache.evictions
+            x.fft(1)
+            x.fft(1)
+            self.assertEqual(plan_cache.hits - hits, 1)
+            self.assertEqual(plan_cache.misses - misses, 1)
+            x.narrow(1, 0, 4).fft(1)
+            self.assertEqual(plan_cache.evictions - evictions, 1)
+            self.assertEqual(plan_cache.size, 1)
+
+        # the byte limit evicts plans until their workspaces fit
+        original_max_bytes = plan_cache.max_bytes
+        try:
+            plan_cache.max_bytes = 0
+            torch.randn(1000, 1000, 2, device='cuda').fft(2)
+            self.assertEqual(plan_cache.bytes, 0)
+        finally:
+            plan_cache.max_bytes = original_max_bytes
+
+        with self.assertRaisesRegex(RuntimeError, r"must be non-negative"):
+            plan_cache.max_bytes = -1
+
+        with self.assertRaisesRegex(RuntimeError, r"read-only property"):
+            plan_cache.hits = 0
+
+        # concurrent callers share plans
+        plan_cache.clear()
+        x = torch.randn(16, 64, 2, device='cuda')
+        expected = x.fft(1)
+        results = [None] * 8
+
+        def run(i):
+            results[i] = x.fft(1)
+
+        threads = [threading.Thread(target=run, args=(i,)) for i in range(8)]
+        for t in threads:
+            t.start()
+        for t in threads:
+            t.join()
+        for result in results:
+            self.assertEqual(result, expected)
+        self.assertEqual(plan_cache.size, 1)
+
         if TEST_MULTIGPU:
             # Test that different GPU has different cache
             x0 = torch.randn(2, 3, 3, device='cuda:0')
@@ -1149,6 +1149,42 @@ class TestDataLoader(TestCase):
     def test_shuffle_workers(self):
         self._test_shuffle(DataLoader(self.dataset, shuffle=True, num_workers=4))
 
+    def test_sequential_batch_workers_shared_memory_ring(self):
+        # A batch of 2 is 2 * 2 * 3 * 5 floats and 2 longs, so slots of 512
+        # bytes fit it but slots of 64 bytes don't.
+        for slot_size in [512, 64]:
+            kwargs = dict(batch_size=2, num_workers=4, shared_memory_slot_size=slot_size)
+            self._test_sequential(DataLoader(self.dataset, **kwargs))
+            # Holding on to the batches keeps their slots in use, so that the
+            # other batches are sent as usual.
+            batches = list(DataLoader(self.dataset, **kwargs))
+            self.assertEqual(torch.cat([sample for sample, _ in batches]), self.data)
+            self.assertEqual(torch.cat([target for _, target in batches]), self.labels)
+
+    def test_shared_memory_ring_pack_and_unpack(self):
+        ring = _utils.shared_ring.SharedMemoryRing(num_workers=1, slot_size=1024)
+        data = {'a': torch.arange(10.), 'b': [torch.ones(2, 3, dtype=torch.int64), 'c']}
+        packed = ring.pack(0, data)
+        self.assertIsInstance(packed, _utils.shared_ring._RingBatch)
+        unpacked = ring.unpack(packed)
+        self.assertEqual(unpacked['a'], data['a'])
+        self.assertEqual(unpacked['b'][0], data['b'][0])
+        self.assertEqual(unpacked['b'][1], 'c')
+        # The slot is held by the views until they are freed.
+        self.assertEqual(ring.refcounts[packed.slot].item(), 2)
+        del unpacked
+        gc.collect()
+        self.assertEqual(ring.refcounts[packed.slot].item(), 0)
+
+        # Batches too large for a slot are returned as they are.
+        large = torch.ones(1024)
+        self.assertIs(ring.pack(0, large), large)
+        # So are batches arriving while all the slots are in use.
+        held = [ring.unpack(ring.pack(0, torch.ones(1))) for _ in range(_utils.shared_ring.SLOTS_PER_WORKER)]
+        small = torch.ones(1)
+        self.assertIs(ring.pack(0, small), small)
+        del held
+
     def test_shuffle_batch_workers(self):
         self._test_shuffle(DataLoader(self.dataset, batch_size=2, shuffle=True, num_workers=4))
 
@@ -22,6 +22,40 @@ class TestIndexing(TestCase):
         self.assertEqual(v[:, None, None].shape, (5, 1, 1, 7, 3))
         self.assertEqual(v[..., None].shape, (5, 7, 3, 1))
 
+    def test_basic_index_matches_views(self, device):
+        v = torch.randn(5, 7, 3, device=device)
+        indices = [(1, 3), (slice(None), 3, slice(1, 5)), (Ellipsis, None, -1),
+                   (None, slice(-4, None, 2), Ellipsis, 0), (-5, slice(6, 2)),
+                   (slice(None), None, slice(None, None, 3), slice(10, 20)), ()]
+        expected = [v.select(0, 1).select(0, 3),
+                    v.select(1, 3).narrow(1, 1, 2),
+                    v.unsqueeze(2).select(3, -1),
+                    v.unsqueeze(0).narrow(1, 1, 4)[:, ::2].select(3, 0),
+                    v.select(0, 0).narrow(0, 6, 0),
+                    v.unsqueeze(1)[:, :, ::3].narrow(3, 3, 0),
+                    v]
+        for index, view in zip(indices, expected):
+            result = v[index]
+            self.assertEqual(result.shape, view.shape)
+            self.assertEqual(result.stride(), view.stride())
+            self.assertEqual(result, view)
+            self.assertEqual(result.storage_offset(), view.storage_offset())
+        # results are views sharing the data of the indexed tensor
+        v[:, 3, 1:2].fill_(7)
+        self.assertEqual(v.select(1, 3).select(1, 1), torch.full((5,), 7, device=device))
+        with self.assertRaisesRegex(IndexError, 'out of bounds'):
+            v[:, 7]
+
+    def test_single_index_tensor(self, device):
+        v = torch.randn(5, 7, 3, device=device)
+        idx = torch.tensor([4, 0, 2, 2], device=device)
+        self.assertEqual(v[idx], v.index_select(0, idx))
+        self.assertEqual(v[:, idx], v.index_select(1, idx))
+        self.assertEqual(v[:, [1, -1]], v.index_select(1, torch.tensor([1, 6], device=device)))
+        if device == 'cpu':
+            with self.assertRaisesRegex(IndexError, 'out of bounds'):
+                v[torch.tensor([5])]
+
     def test_step(self, device):
         v = torch.arange(10, device=device)
         self.assertEqual(v[::1], v)
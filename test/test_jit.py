@@ -1309,6 +1309,86 @@ graph(%packed_params_module, %a, %a_scale, %a_zero_point, %a_dtype, %r_scale, %r
         %r = aten::matmul(%a_dequant, %w_dequant_t)
         %r_quant = aten::quantize_per_tensor(%r, %r_scale, %r_zero_point, %r_dtype)
         %r_dequant = aten::dequantize(%r_quant)
+        return (%r_dequant)""",
+            # aten::conv2d - aten::relu -> quantized::conv2d_relu
+            """
+graph(%packed_params_module, %a, %a_scale, %a_zero_point, %a_dtype,
+%r_scale, %r_zero_point, %r_dtype, %stride, %padding, %dilation, %groups):
+        %a_quant = aten::quantize_per_tensor(%a, %a_scale, %a_zero_point, %a_dtype)
+        %a_dequant = aten::dequantize(%a_quant)
+        %packed_params = prim::GetAttr[name="_packed_params"](%packed_params_module)
+        %w_quant : Tensor, %b : Tensor? = quantized::conv2d_unpack(%packed_params)
+        %w_dequant = aten::dequantize(%w_quant)
+        # CHECK: quantized::conv2d_relu
+        # CHECK-NOT: aten::conv2d
+        # CHECK-NOT: aten::relu
+        %conv_out = aten::conv2d(%a_dequant, %w_dequant, %b, %stride, %padding, %dilation, %groups)
+        %r = aten::relu(%conv_out)
+        %r_quant = aten::quantize_per_tensor(%r, %r_scale, %r_zero_point, %r_dtype)
+        %r_dequant = aten::dequantize(%r_quant)
+        return (%r_dequant)""",
+            # aten::conv2d - aten::add_ -> quantized::conv2d_add
+            """
+graph(%packed_params_module, %a, %a_scale, %a_zero_point, %a_dtype, %other_quant,
+%r_scale, %r_zero_point, %r_dtype, %stride, %padding, %dilation, %groups,
+%out_scale, %out_zero_point, %out_dtype):
+        %alpha = prim::Constant[value=1]()
+        %a_quant = aten::quantize_per_tensor(%a, %a_scale, %a_zero_point, %a_dtype)
+        %a_dequant = aten::dequantize(%a_quant)
+        %packed_params = prim::GetAttr[name="_packed_params"](%packed_params_module)
+        %w_quant : Tensor, %b : Tensor? = quantized::conv2d_unpack(%packed_params)
+        %w_dequant = aten::dequantize(%w_quant)
+        # CHECK: quantized::conv2d_add
+        # CHECK-NOT: aten::conv2d
+        # CHECK-NOT: aten::add_
+        %r = aten::conv2d(%a_dequant, %w_dequant, %b, %stride, %padding, %dilation, %groups)
+        %r_quant = aten::quantize_per_tensor(%r, %r_scale, %r_zero_point, %r_dtype)
+        %r_dequant = aten::dequantize(%r_quant)
+        %other_dequant = aten::dequantize(%other_quant)
+        %out = aten::add_(%r_dequant, %other_dequant, %alpha)
+        %out_quant = aten::quantize_per_tensor(%out, %out_scale, %out_zero_point, %out_dtype)
+        %out_dequant = aten::dequantize(%out_quant)
+        return (%out_dequant)""",
+            # aten::conv2d - aten::add_ - aten::relu -> quantized::conv2d_add_relu
+            """
+graph(%packed_params_module, %a, %a_scale, %a_zero_point, %a_dtype, %other_quant,
+%r_scale, %r_zero_point, %r_dtype, %stride, %padding, %dilation, %groups,
+%out_scale, %out_zero_point, %out_dtype):
+        %alpha = prim::Constant[value=1]()
+        %a_quant = aten::quantize_per_tensor(%a, %a_scale, %a_zero_point, %a_dtype)
+        %a_dequant = aten::dequantize(%a_quant)
+        %packed_params = prim::GetAttr[name="_packed_params"](%packed_params_module)
+        %w_quant : Tensor, %b : Tensor? = quantized::conv2d_unpack(%packed_params)
+        %w_dequant = aten::dequantize(%w_quant)
+        # CHECK: quantized::conv2d_add_relu
+        # CHECK-NOT: aten::conv2d
+        # CHECK-NOT: aten::add_
+        # CHECK-NOT: aten::relu
+        %r = aten::conv2d(%a_dequant, %w_dequant, %b, %stride, %padding, %dilation, %groups)
+        %r_quant = aten::quantize_per_tensor(%r, %r_scale, %r_zero_point, %r_dtype)
+        %r_dequant = aten::dequantize(%r_quant)
+        %other_dequant = aten::dequantize(%other_quant)
+        %sum = aten::add_(%r_dequant, %other_dequant, %alpha)
+        %out = aten::relu(%sum)
+        %out_quant = aten::quantize_per_tensor(%out, %out_scale, %out_zero_point, %out_dtype)
+        %out_dequant = aten::dequantize(%out_quant)
+        return (%out_dequant)""",
+            # addmm - aten::hardtanh -> quantized::linear_hardtanh
+            """
+graph(%packed_params_module, %a, %a_scale, %a_zero_point, %a_dtype, %r_scale, %r_zero_point, %r_dtype, %4, %min, %max):
+        %a_quant = aten::quantize_per_tensor(%a, %a_scale, %a_zero_point, %a_dtype)
+        %a_dequant = aten::dequantize(%a_quant)
+        %packed_params = prim::GetAttr[name="_packed_params"](%packed_params_module)
+        %w_quant : Tensor, %b : Tensor? = quantized::linear_unpack(%packed_params)
+        %w_dequant = aten::dequantize(%w_quant)
+        %w_dequant_t = aten::t(%w_dequant)
+        # CHECK: quantized::linear_hardtanh
+        # CHECK-NOT: aten::addmm
+        # CHECK-NOT: aten::hardtanh
+        %linear_out = aten::addmm(%b, %a_dequant, %w_dequant_t, %4, %4)
+        %r = aten::hardtanh(%linear_out, %min, %max)
+        %r_quant = aten::quantize_per_tensor(%r, %r_scale, %r_zero_point, %r_dtype)
+        %r_dequant = aten::dequantize(%r_quant)
         return (%r_dequant)"""
         ]
         for input_str in input_strs:
@@ -1316,6 +1396,68 @@ graph(%packed_params_module, %a, %a_scale, %a_zero_point, %a_dtype, %r_scale, %r
             torch._C._jit_pass_quant_fusion(graph)
             FileCheck().run(input_str, graph)
 
+    def test_freeze_module(self):
+        class SubModule(torch.nn.Module):
+            def __init__(self):
+                super(SubModule, self).__init__()
+                self.weight = torch.nn.Parameter(torch.rand(3, 3))
+
+            def forward(self, x):
+                if self.training:
+                    x = x * 2
+                return torch.mm(x, self.weight)
+
+        class TestModule(torch.nn.Module):
+            def __init__(self):
+                super(TestModule, self).__init__()
+                self.sub = SubModule()
+                self.calls = 0
+
+            def forward(self, x):
+                self.calls += 1
+                return self.sub(x) + self.calls
+
+        scripted = torch.jit.script(TestModule())
+        with self.assertRaisesRegex(RuntimeError, "training mode"):
+            torch._C._jit_pass_freeze_module(scripted._c)
+
+        scripted.eval()
+        frozen = torch.jit._recursive.wrap_cpp_module(
+            torch._C._jit_pass_freeze_module(scripted._c))
+        # The weight is a constant and the training branch is gone, the
+        # attribute the module modifies is still read and written
+        FileCheck().check_not("prim::CallMethod") \
+            .check_not("name=\"weight\"") \
+            .check_not("prim::If") \
+            .run(str(frozen.graph))
+        FileCheck().check("prim::SetAttr[name=\"calls\"]").run(str(frozen.graph))
+
+        x = torch.rand(3, 3)
+        self.assertEqual(frozen(x), scripted(x))
+        self.assertEqual(frozen(x), scripted(x))
+
+    def test_prepack_winograd_conv(self):
+        model = torch.nn.Sequential(
+            torch.nn.Conv2d(16, 16, kernel_size=3, padding=1),
+            torch.nn.Conv2d(16, 8, kernel_size=3, stride=2, bias=False),
+            torch.nn.ReLU()).eval()
+        x = torch.randn(1, 16, 12, 12)
+        frozen = torch.jit._recursive.wrap_cpp_module(
+            torch._C._jit_pass_freeze_module(torch.jit.script(model)._c))
+        torch._C._jit_pass_prepack_winograd_conv(frozen._c)
+        # The strided conv is left alone
+        FileCheck().check_count("aten::_winograd_conv2d", 1, exactly=True) \
+            .check_count("aten::conv2d", 1, exactly=True) \
+            .run(str(frozen.graph))
+        with torch.no_grad():
+            self.assertEqual(model(x), frozen(x), prec=1e-4)
+
+        with TemporaryFileName() as fname:
+            torch.jit.save(frozen, fname)
+            loaded = torch.jit.load(fname)
+            with torch.no_grad():
+                self.assertEqual(model(x), loaded(x), prec=1e-4)
+
     @_tmp_donotuse_dont_inline_everything
     @unittest.skip("Temporarily turn off fold_convbn tests until \
     constants are handled properly, this test should not be passing \
@@ -1714,6 +1856,30 @@ graph(%Ra, %Rb):
         torch._C._jit_pass_complete_shape_analysis(graph, (x, y), False)
         FileCheck().check("Double(4, 3, 8, 5)").run(str(graph))
 
+    def test_shape_analysis_respecialize(self):
+        def fn(a, b):
+            c = a.matmul(b) * 2
+            return c.sum(1, keepdim=True) + c
+
+        # the output types of the nodes run on representative values are
+        # memoized across graphs, and must follow each new specialization
+        for n, m in [(3, 4), (5, 4), (3, 4), (3, 7)]:
+            x = torch.randn(n, 6)
+            y = torch.randn(6, m)
+            graph = torch.jit.script(fn).graph
+            torch._C._jit_pass_complete_shape_analysis(graph, (x, y), False)
+            out_type = list(graph.outputs())[0].type()
+            self.assertEqual(out_type.sizes(), list(fn(x, y).shape))
+            self.assertEqual(out_type.scalarType(), 'Double')
+
+        # same-sized operands are propagated without running the op
+        def same_size(a, b):
+            return a * b + a
+
+        graph = torch.jit.script(same_size).graph
+        torch._C._jit_pass_complete_shape_analysis(graph, (torch.randn(2, 3), torch.randn(2, 3)), False)
+        FileCheck().check_count("Double(2, 3)", 4, exactly=True).run(str(graph))
+
     # TODO: update verify to work with GraphExecutors
     @unittest.skip("verify needs to be updated to work with GraphExecutors")
     def test_verify(self):
@@ -3524,6 +3690,43 @@ graph(%Ra, %Rb):
             fn.save(f.name)
             self.assertTrue(torch.serialization._is_zipfile(f))
 
+    def test_load_share_storages(self):
+        class M(torch.nn.Module):
+            def __init__(self):
+                super(M, self).__init__()
+                self.shared = torch.nn.Parameter(torch.randn(64, 64))
+                self.variant = torch.nn.Parameter(torch.randn(64, 64))
+
+            def forward(self, x):
+                return x.mm(self.shared).mm(self.variant)
+
+        m = M()
+        a = io.BytesIO()
+        torch.jit.save(torch.jit.script(m), a)
+        with torch.no_grad():
+            m.variant.add_(1)
+        b = io.BytesIO()
+        torch.jit.save(torch.jit.script(m), b)
+
+        def load_both():
+            a.seek(0)
+            b.seek(0)
+            return torch.jit.load(a), torch.jit.load(b)
+
+        old_state = torch._C._jit_set_share_storages_import(True)
+        try:
+            ma, mb = load_both()
+        finally:
+            torch._C._jit_set_share_storages_import(old_state)
+        self.assertEqual(ma.shared.data_ptr(), mb.shared.data_ptr())
+        self.assertNotEqual(ma.variant.data_ptr(), mb.variant.data_ptr())
+        self.assertEqual(ma.variant + 1, mb.variant)
+        x = torch.randn(2, 64)
+        self.assertEqual(mb(x), m(x))
+
+        ma, mb = load_both()
+        self.assertNotEqual(ma.shared.data_ptr(), mb.shared.data_ptr())
+
     def test_python_bindings(self):
         lstm_cell = torch.jit.script(LSTMCellS)
 
@@ -806,6 +806,33 @@ class TestFuser(JitTestCase):
         ge = self.checkTrace(self.fn_test_relu, (x, y))
         self.assertAllFused(ge.graph_for(x, y))
 
+    @unittest.skipIf(not RUN_CUDA, "fuser requires CUDA")
+    def test_row_reductions_cuda(self):
+        def layer_norm(x, w, b):
+            mean = x.mean(-1, keepdim=True)
+            centered = x - mean
+            var = (centered * centered).mean(-1, keepdim=True)
+            return centered * torch.rsqrt(var + 1e-5) * w + b
+
+        def softmaxes(x, b):
+            return torch.log_softmax(x + b, -1), torch.softmax(x * 2, -1)
+
+        def row_sums(x, y):
+            return (x * y).sum(-1, keepdim=True), x - y.sum(-1, keepdim=True)
+
+        # rows that aren't a multiple of the block size
+        x = torch.randn(64, 1000, dtype=torch.float, device='cuda')
+        y = torch.randn(64, 1000, dtype=torch.float, device='cuda')
+        w = torch.randn(1000, dtype=torch.float, device='cuda')
+        b = torch.randn(1000, dtype=torch.float, device='cuda')
+        for fn, inputs in [(layer_norm, (x, w, b)), (row_sums, (x, y)), (softmaxes, (x, b))]:
+            ge = self.checkTrace(fn, inputs)
+            self.assertAllFused(ge.graph_for(*inputs))
+
+        # the rows of the two softmaxes have different sizes, this runs the fallback
+        x = torch.randn(64, 1, dtype=torch.float, device='cuda')
+        self.assertEqual(ge(x, b), softmaxes(x, b))
+
     @unittest.skipIf(not RUN_CUDA, "fuser requires CUDA")
     def test_erf_cuda(self):
         def fn_test_erf(x):
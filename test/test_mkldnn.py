@@ -12,6 +12,7 @@ skipIfNoTorchVision = unittest.skipIf(not HAS_TORCHVISION, "no torchvision")
 
 import torch
 import torch.jit
+from torch.testing import FileCheck
 from torch.utils import mkldnn as mkldnn_utils
 from common_utils import TestCase, run_tests, TemporaryFileName
 
@@ -122,6 +123,27 @@ class TestMkldnn(TestCase):
                 self._test_serialization(mkldnn_conv2d, (x.to_mkldnn(),))
                 self._test_tracing(mkldnn_conv2d, (x.to_mkldnn(),))
 
+    def test_conv2d_weight_cache(self):
+        conv2d = torch.nn.Conv2d(4, 8, kernel_size=3, padding=1, groups=2).float()
+        x = torch.randn(2, 4, 16, 16, dtype=torch.float32)
+
+        def check():
+            with torch.backends.mkldnn.flags(enabled=False):
+                expected = conv2d(x)
+            # the second call reuses the weight reordered by the first one
+            self.assertEqual(conv2d(x), expected)
+            self.assertEqual(conv2d(x), expected)
+
+        with torch.no_grad():
+            check()
+            # in-place updates bump the version of the weight
+            conv2d.weight.mul_(2)
+            check()
+            # new weights can take the address of freed ones
+            for _ in range(3):
+                conv2d.weight = torch.nn.Parameter(torch.randn(8, 2, 3, 3))
+                check()
+
     def test_relu(self):
         x = torch.randn((4, 5), dtype=torch.float32) * 10
         self.assertEqual(torch.relu(x), torch.relu(x.to_mkldnn()).to_dense())
@@ -353,6 +375,95 @@ class TestMkldnn(TestCase):
         torch.sigmoid_(mkldnn_x)
         self.assertEqual(x, mkldnn_x.to_dense())
 
+    def test_prepack_conv_weights(self):
+        model = torch.nn.Sequential(
+            torch.nn.Conv2d(3, 8, kernel_size=3, padding=1),
+            torch.nn.Conv2d(8, 4, kernel_size=3, stride=2, bias=False),
+            torch.nn.ReLU()).eval()
+        x = torch.randn(2, 3, 16, 16)
+        frozen = torch.jit._recursive.wrap_cpp_module(
+            torch._C._jit_pass_freeze_module(torch.jit.script(model)._c))
+        prepacked = mkldnn_utils.prepack_conv_weights(frozen)
+        # Only the input is converted, and the output of the second conv
+        FileCheck().check_count("aten::to_mkldnn", 1, exactly=True) \
+            .check_count("aten::conv2d", 2, exactly=True) \
+            .check_count("aten::to_dense", 1, exactly=True) \
+            .run(str(prepacked.graph))
+        self.assertEqual(model(x), prepacked(x))
+
+        with TemporaryFileName() as fname:
+            torch.jit.save(prepacked, fname)
+            loaded = torch.jit.load(fname)
+            self.assertEqual(model(x), loaded(x))
+
+    def test_propagate_layout(self):
+        class Net(torch.nn.Module):
+            def __init__(self):
+                super(Net, self).__init__()
+                self.conv1 = torch.nn.Conv2d(3, 8, kernel_size=3, padding=1)
+                self.bn = torch.nn.BatchNorm2d(8)
+                self.conv2 = torch.nn.Conv2d(8, 8, kernel_size=3, padding=1)
+                self.conv3 = torch.nn.Conv2d(8, 8, kernel_size=1)
+                self.pool = torch.nn.AdaptiveAvgPool2d(1)
+                self.fc = torch.nn.Linear(16, 10)
+
+            def forward(self, x):
+                x = torch.relu(self.bn(self.conv1(x)))
+                x = torch.nn.functional.max_pool2d(x, 2)
+                y = self.conv2(x)
+                z = self.conv3(x)
+                x = torch.cat([y + z, z], 1)
+                x = torch.flatten(self.pool(x), 1)
+                return self.fc(x)
+
+        model = Net().eval()
+        # non trivial running stats
+        model.bn.running_mean.uniform_()
+        model.bn.running_var.uniform_(1, 2)
+        x = torch.randn(2, 3, 16, 16)
+        frozen = torch.jit._recursive.wrap_cpp_module(
+            torch._C._jit_pass_freeze_module(torch.jit.script(model)._c))
+        prepacked = mkldnn_utils.prepack_conv_weights(frozen)
+        # Only the input is converted to MKLDNN, and only the final linear
+        # converts back to dense
+        FileCheck().check_count("aten::to_mkldnn", 1, exactly=True) \
+            .check_not("aten::to_dense").check("aten::cat").check("aten::linear") \
+            .run(str(prepacked.graph))
+        self.assertEqual(model(x), prepacked(x))
+
+    def test_dense_params(self):
+        # the parameters left dense by the layout propagation
+        x = torch.randn(4, 6, 5, 5)
+        weight, bias = torch.randn(6), torch.randn(6)
+        mean, var = torch.randn(6), torch.rand(6) + 1
+        self.assertEqual(
+            torch.batch_norm(x, weight, bias, mean, var, False, 0.1, 1e-5, False),
+            torch.batch_norm(x.to_mkldnn(), weight, bias, mean, var, False, 0.1, 1e-5, False).to_dense())
+        x2d = torch.randn(4, 6)
+        self.assertEqual(
+            torch.batch_norm(x2d, weight, bias, mean, var, False, 0.1, 1e-5, False),
+            torch.batch_norm(x2d.to_mkldnn(), weight, bias, mean, var, False, 0.1, 1e-5, False).to_dense())
+
+        for bias in [torch.randn(3), None]:
+            weight = torch.randn(3, 6)
+            self.assertEqual(
+                torch.nn.functional.linear(x2d, weight, bias),
+                torch._C._nn.linear(x2d.to_mkldnn(), weight, bias).to_dense())
+
+    def test_cat(self):
+        x = torch.randn(2, 3, 4, 5)
+        y = torch.randn(2, 6, 4, 5)
+        self.assertEqual(torch.cat([x, y], 1), torch.cat([x.to_mkldnn(), y.to_mkldnn()], 1).to_dense())
+        self.assertEqual(torch.cat([x, x], -1), torch.cat([x.to_mkldnn(), x.to_mkldnn()], -1).to_dense())
+
+    def test_add_broadcast(self):
+        x = torch.randn(2, 3, 4, 5)
+        y = torch.randn(3, 1, 1)
+        self.assertEqual(x + y, (x.to_mkldnn() + y.to_mkldnn()).to_dense())
+        mx = x.to_mkldnn()
+        mx += y.to_mkldnn()
+        self.assertEqual(x + y, mx.to_dense())
+
     def _test_serialization(self, module, inputs):
         with TemporaryFileName() as fname:
             torch.jit.save(module, fname)
@@ -115,6 +115,15 @@ def cuda_multiply_two(queue, ready, done):
         del cuda_event
 
 
+def cuda_ipc_pool_receive(queue, done):
+    pool = queue.get()
+    first = queue.get()
+    second = queue.get()
+    queue.put((first.sum().item(), second.sum().item(), pool.refcounts.sum().item()))
+    del first, second
+    done.wait()
+
+
 def requires_grad_variable_sharing(queue, ready):
     var = queue.get()
     ready.set()
@@ -518,6 +527,34 @@ if __name__ == "__main__":
             self.assertEqual(list(tensor), [4, 4, 4, 4])
         p.join()
 
+    @unittest.skipIf(NO_MULTIPROCESSING_SPAWN, "Disabled for environments that \
+                     don't support multiprocessing with spawn start method")
+    @unittest.skipIf(not TEST_CUDA_IPC, 'CUDA IPC not available')
+    def test_cuda_ipc_pool(self):
+        ctx = mp.get_context('spawn')
+        queue = ctx.Queue()
+        done = ctx.Event()
+        pool = mp.CudaIPCPool(1024)
+        first = pool.empty((4, 4))
+        first.fill_(1)
+        second = pool.empty((2, 3), dtype=torch.int64)
+        second.fill_(2)
+        self.assertEqual(second.data_ptr() - first.data_ptr(), 512)
+        p = ctx.Process(target=cuda_ipc_pool_receive, args=(queue, done))
+        p.start()
+        queue.put(pool)
+        queue.put(first)
+        queue.put(second[1])
+        # Both sub-allocations are held by the producer and the consumer
+        self.assertEqual(queue.get(), (16, 6, 4))
+        done.set()
+        p.join()
+        del first
+        # The freed sub-allocation is reused
+        self.assertEqual(pool.empty((10,)).data_ptr(), pool.slab.data_ptr())
+        with self.assertRaisesRegex(RuntimeError, "no free range"):
+            pool.empty((4096,))
+
     @staticmethod
     def _test_event_multiprocess_child(event, p2c, c2p):
         c2p.put(0)  # notify parent child is ready
@@ -47,7 +47,7 @@ from common_nn import NNTestCase, ModuleTest, CriterionTest, TestBase, \
     module_tests, criterion_tests, new_criterion_tests, loss_reference_fns, \
     ctcloss_reference, new_module_tests
 from common_device_type import instantiate_device_type_tests, dtypes, \
-    dtypesIfCUDA, skipCUDAIfNoCudnn, skipCUDAIfCudnnVersionLessThan, onlyCUDA, \
+    dtypesIfCUDA, skipCUDAIfNoCudnn, skipCUDAIfCudnnVersionLessThan, onlyCUDA, onlyCPU, \
     skipCUDAIfRocm, skipCUDAIf
 
 from torch.nn import MultiheadAttention
@@ -1888,6 +1888,15 @@ class TestNN(NNTestCase):
             clip_grad_norm_([p2], max_norm, norm_type=norm_type)
             self.assertEqual(p1.grad, p2.grad)
 
+        # Parameters without gradients are skipped
+        p3 = torch.randn(10, 10, requires_grad=True)
+        p1._grad = g.clone()
+        norm = clip_grad_norm_([p1, p3], max_norm)
+        self.assertEqual(norm, g.norm())
+        self.assertEqual(p1.grad.norm(), max_norm)
+        self.assertIsNone(p3.grad)
+        self.assertEqual(clip_grad_norm_([p3], max_norm), 0)
+
     def test_clip_grad_value(self):
         l = nn.Linear(10, 10)
         clip_value = 2.5
@@ -3950,6 +3959,22 @@ class TestNN(NNTestCase):
             bias=True).cuda()
         result = m(x)
 
+    @unittest.skipIf(not TEST_CUDA, 'CUDA not available')
+    @unittest.skipIf(not TEST_CUDNN, 'CUDNN not available')
+    def test_cudnn_benchmark_cache_save_load(self):
+        x = torch.randn(2, 3, 17, 19, device='cuda', requires_grad=True)
+        m = nn.Conv2d(3, 5, 3).cuda()
+        with torch.backends.cudnn.flags(enabled=True, benchmark=True):
+            m(x).sum().backward()
+            with TemporaryFileName() as fname:
+                torch.backends.cudnn.save_benchmark_cache(fname)
+                # everything in the file is already cached in this process
+                self.assertEqual(torch.backends.cudnn.load_benchmark_cache(fname), 0)
+
+                with open(fname, 'wb') as f:
+                    f.write(b'not a cache')
+                self.assertRaises(RuntimeError, lambda: torch.backends.cudnn.load_benchmark_cache(fname))
+
     @unittest.skipIf(not TEST_CUDA, 'CUDA not available')
     @unittest.skipIf(not TEST_CUDNN, 'CUDNN not available')
     def test_Conv2d_inconsistent_types_on_GPU_with_cudnn(self):
@@ -4350,6 +4375,28 @@ class TestNN(NNTestCase):
         with self.assertRaises(RuntimeError):
             torch.nn.functional.ctc_loss(log_probs, targets, input_lengths, target_lengths)
 
+    def test_CTCLoss_checkpointed_cpu(self):
+        target_lengths = [7, 0, 12, 3]
+        input_lengths = [23, 9, 30, 17]
+        targets = torch.randint(1, 6, (sum(target_lengths),), dtype=torch.long)
+        log_probs = torch.randn(30, 4, 6, dtype=torch.double).log_softmax(2).requires_grad_()
+        grad_out = torch.rand(4, dtype=torch.double)
+        loss, _ = torch._ctc_loss(log_probs, targets, input_lengths, target_lengths, 0, False)
+        grad, = torch.autograd.grad(loss, log_probs, grad_out)
+        for checkpoint_interval in [1, 2, 5, 6, 30, 31]:
+            loss_ckpt, log_alpha_ckpt = torch._ctc_loss_checkpointed(
+                log_probs, targets, input_lengths, target_lengths, 0, False, checkpoint_interval)
+            self.assertEqual(log_alpha_ckpt.size(1), (30 + checkpoint_interval - 1) // checkpoint_interval)
+            self.assertEqual(loss_ckpt, loss)
+            grad_ckpt, = torch.autograd.grad(loss_ckpt, log_probs, grad_out)
+            self.assertEqual(grad_ckpt, grad)
+
+        self.assertTrue(gradcheck(
+            lambda lp: torch._ctc_loss_checkpointed(lp, targets, input_lengths, target_lengths, 0, False, 4)[0],
+            (log_probs,)))
+        with self.assertRaisesRegex(RuntimeError, "checkpoint_interval"):
+            torch._ctc_loss_checkpointed(log_probs, targets, input_lengths, target_lengths, 0, False, 0)
+
     @unittest.skipIf(not TEST_CUDA, 'CUDA not available')
     def test_CTCLoss_long_targets(self):
         input_length = 4000
@@ -5527,6 +5574,55 @@ class TestNN(NNTestCase):
             self.assertEqual(output1, output2)
             self.assertEqual(hidden1, hidden2)
 
+    def test_rnn_fused_pointwise_cpu(self):
+        # Without autograd the CPU LSTM and GRU cells run their gate math in a
+        # fused kernel; compare against the differentiable path.
+        for mode in ('GRU', 'LSTM'):
+            for bidirectional in (False, True):
+                rnn = getattr(nn, mode)(7, 13, 2, bidirectional=bidirectional)
+                input = torch.randn(5, 3, 7)
+                lengths = [5, 4, 2]
+                num_directions = 2 if bidirectional else 1
+                hidden = torch.randn(2 * num_directions, 3, 13)
+                if mode == 'LSTM':
+                    hidden = (hidden, torch.randn(2 * num_directions, 3, 13))
+                for packed in (False, True):
+                    if packed:
+                        input_ = rnn_utils.pack_padded_sequence(input, lengths)
+                    else:
+                        input_ = input
+                    output_ref, hidden_ref = rnn(input_, hidden)
+                    with torch.no_grad():
+                        output, hidden_out = rnn(input_, hidden)
+                    if packed:
+                        output_ref, output = output_ref.data, output.data
+                    self.assertEqual(output, output_ref)
+                    self.assertEqual(hidden_out, hidden_ref)
+
+        for cell, hidden in ((nn.LSTMCell(7, 13), (torch.randn(3, 13), torch.randn(3, 13))),
+                             (nn.GRUCell(7, 13), torch.randn(3, 13))):
+            input = torch.randn(3, 7)
+            expected = cell(input, hidden)
+            with torch.no_grad():
+                self.assertEqual(cell(input, hidden), expected)
+
+    def test_rnn_fused_sequence_cpu(self):
+        # Without autograd, whole CPU LSTM and GRU layers run in a fused loop;
+        # the small hidden size lets the two directions run in parallel.
+        for mode in ('GRU', 'LSTM'):
+            for bias, batch_first in ((True, True), (False, False)):
+                rnn = getattr(nn, mode)(7, 5, 3, bias=bias, batch_first=batch_first,
+                                        bidirectional=True)
+                input = torch.randn(4, 6, 7)
+                hidden = torch.randn(6, 4 if batch_first else 6, 5)
+                if mode == 'LSTM':
+                    hidden = (hidden, torch.randn_like(hidden))
+                output_ref, hidden_ref = rnn(input, hidden)
+                with torch.no_grad():
+                    output, hidden_out = rnn(input, hidden)
+                self.assertEqual(output, output_ref)
+                self.assertEqual(hidden_out, hidden_ref)
+
     def _test_RNN_cpu_vs_cudnn(self, dropout, dtype=torch.double):
 
         def forward_backward(cuda, rnn, input_val, hx_val, grad_output, grad_hy, weights_val):
@@ -6686,6 +6782,35 @@ class TestNN(NNTestCase):
                         with cudnn.flags(enabled=False):
                             test(N, C, H, W, mode, padding_mode, align_corners=align_corners)
 
+    def test_grid_sample_backward_small_batch(self):
+        # with fewer samples than threads, the CPU backward splits the rows of
+        # the grid among the threads, each with its own copy of grad_input
+        num_threads = torch.get_num_threads()
+        try:
+            torch.set_num_threads(4)
+            for mode, padding_mode, align_corners in product(('bilinear', 'nearest'),
+                                                             ('zeros', 'border', 'reflection'),
+                                                             (True, False)):
+                def sample(inp, grid):
+                    return F.grid_sample(inp, grid, mode=mode, padding_mode=padding_mode,
+                                         align_corners=align_corners)
+
+                input = torch.randn(1, 3, 5, 7, dtype=torch.double, requires_grad=True)
+                grid = torch.randn(1, 9, 11, 2, dtype=torch.double, requires_grad=True)
+                self.assertTrue(gradcheck(sample, (input, grid)))
+
+                input = torch.randn(2, 8, 40, 33, requires_grad=True)
+                grid = torch.rand(2, 64, 48, 2).mul_(2.2).sub_(1.1).requires_grad_()
+                grad_output = torch.randn(2, 8, 64, 48)
+                grads = torch.autograd.grad(sample(input, grid), (input, grid), grad_output)
+                torch.set_num_threads(1)
+                expected = torch.autograd.grad(sample(input, grid), (input, grid), grad_output)
+                torch.set_num_threads(4)
+                self.assertEqual(grads[0], expected[0], prec=1e-4)
+                self.assertEqual(grads[1], expected[1], prec=1e-4)
+        finally:
+            torch.set_num_threads(num_threads)
+
     def test_grid_sample_3d(self):
         def test(N, C, D, H, W, mode, padding_mode, align_corners):
             def test_shape(N, C, ID, IH, IW, D, H, W, mode, padding_mode, align_corners):
@@ -7200,6 +7325,11 @@ class TestNN(NNTestCase):
                 input = torch.randn(1, 1, 2, 2, requires_grad=True)
                 gradcheck(lambda x: F.interpolate(x, out_size, **kwargs), [input])
 
+            # the CPU backward runs the planes in parallel
+            for in_size, out_size in [((7, 9), (16, 11)), ((12, 10), (5, 10)), ((6, 6), (6, 6))]:
+                input = torch.randn(2, 3, *in_size, dtype=torch.double, requires_grad=True)
+                self.assertTrue(gradcheck(lambda x: F.interpolate(x, out_size, **kwargs), [input]))
+
     def test_upsamplingBicubic2d(self):
         # test output against known input: align_corners=False result must match opencv
         in_t = torch.arange(8).view(1, 2, 2, 2).type(torch.FloatTensor)
@@ -7397,6 +7527,61 @@ class TestNN(NNTestCase):
 
         gradcheck(lambda i, w, b, pad: F.conv_tbc(i, w, b, pad), (inp, weight, bias, 3))
 
+    def test_conv_cpu_winograd_direct_nhwc(self):
+        # (batch, in_channels, out_channels, size, kernel, stride, padding)
+        shapes = [(1, 16, 32, 14, 3, 1, 1), (2, 32, 16, 9, 3, 1, 0), (1, 24, 40, 7, 1, 1, 0),
+                  (1, 16, 20, 11, 5, 2, 2)]
+        for n, c, k, size, kernel, stride, padding in shapes:
+            input = torch.randn(n, c, size, size + 3)
+            weight = torch.randn(k, c, kernel, kernel)
+            bias = torch.randn(k)
+            expected = F.conv2d(input.double(), weight.double(), bias.double(), stride, padding).float()
+
+            if kernel == 3 and stride == 1:
+                out = torch._winograd_conv2d(input, torch._winograd_conv2d_weight(weight), bias, [padding] * 2)
+                self.assertEqual(out, expected, prec=1e-3)
+            out = torch._direct_conv2d_nhwc(
+                input, torch._direct_conv2d_nhwc_weight(weight), None, [stride] * 2, [padding] * 2)
+            self.assertTrue(out.is_contiguous(memory_format=torch.channels_last))
+            self.assertEqual(out + bias.view(1, -1, 1, 1), expected, prec=1e-4)
+
+            # picked by conv2d for inference without MKLDNN
+            with torch.backends.mkldnn.flags(enabled=False), torch.no_grad():
+                self.assertEqual(F.conv2d(input, weight, bias, stride, padding), expected, prec=1e-3)
+                out = F.conv2d(input.contiguous(memory_format=torch.channels_last), weight, bias, stride, padding)
+                self.assertEqual(out, expected, prec=1e-4)
+
+        with self.assertRaisesRegex(RuntimeError, "_winograd_conv2d_weight"):
+            torch._winograd_conv2d_weight(torch.randn(4, 4, 5, 5))
+
+    def test_conv_cpu_benchmark_cache_save_load(self):
+        input = torch.randn(2, 16, 13, 11, requires_grad=True)
+        m = nn.Conv2d(16, 32, 3, padding=1)
+        m_grouped = nn.Conv2d(16, 32, 3, dilation=2, groups=4)
+        expected = m(input)
+        expected_grouped = m_grouped(input)
+        with torch.backends.cpu.flags(benchmark=True):
+            # the benchmarked call, then the cached one
+            for _ in range(2):
+                self.assertEqual(m(input), expected, prec=1e-4)
+                self.assertEqual(m_grouped(input), expected_grouped, prec=1e-4)
+                with torch.no_grad():
+                    self.assertEqual(m(input), expected, prec=1e-4)
+                    out = m(input.contiguous(memory_format=torch.channels_last))
+                    self.assertEqual(out, expected, prec=1e-4)
+            m(input).sum().backward()
+            self.assertIsNotNone(input.grad)
+
+            with TemporaryFileName() as fname:
+                torch.backends.cpu.save_benchmark_cache(fname)
+                # everything in the file is already cached in this process
+                self.assertEqual(torch.backends.cpu.load_benchmark_cache(fname), 0)
+
+                with open(fname, 'wb') as f:
+                    f.write(b'not a cache')
+                self.assertRaises(RuntimeError, lambda: torch.backends.cpu.load_benchmark_cache(fname))
+        self.assertFalse(torch.backends.cpu.benchmark)
+
     def run_conv_double_back_test(self, kern, stride, padding, chan_in, chan_out, batch_size,
                                   inp_size, dilation, no_weight, groups=1, use_cuda=False,
                                   use_bias=True, dtype=torch.double):
@@ -8906,6 +9091,189 @@ class TestNNDeviceType(NNTestCase):
         if self.device_type == 'cuda':
             self._test_LayerNorm_cuda_half(device)
 
+    @dtypesIfCUDA(torch.half, torch.float, torch.double)
+    @dtypes(torch.float, torch.double)
+    def test_LayerNorm_row_sizes(self, device, dtype):
+        # rows handled by one warp, by one block and by the two-pass kernels on CUDA
+        prec = 5e-2 if dtype == torch.half else 1e-4
+        for N in [1, 33, 1000, 1024, 1025, 4096, 8192, 8193]:
+            x = torch.randn(5, N, device=device, dtype=dtype, requires_grad=True)
+            weight = torch.randn(N, device=device, dtype=dtype, requires_grad=True)
+            bias = torch.randn(N, device=device, dtype=dtype, requires_grad=True)
+            out = F.layer_norm(x, (N,), weight, bias)
+            grad = torch.randn_like(out)
+            out.backward(grad)
+
+            x_ref = x.detach().double().requires_grad_()
+            weight_ref = weight.detach().double().requires_grad_()
+            bias_ref = bias.detach().double().requires_grad_()
+            out_ref = F.layer_norm(x_ref, (N,), weight_ref, bias_ref)
+            out_ref.backward(grad.double())
+            self.assertEqual(out.double(), out_ref, prec)
+            self.assertEqual(x.grad.double(), x_ref.grad, prec * 10)
+            self.assertEqual(weight.grad.double(), weight_ref.grad, prec * 10)
+            self.assertEqual(bias.grad.double(), bias_ref.grad, prec * 10)
+
+    @dtypesIfCUDA(torch.half, torch.float)
+    @dtypes(torch.float)
+    def test_add_layer_norm(self, device, dtype):
+        prec = 5e-2 if dtype == torch.half else 1e-5
+        for N in [16, 1000, 4096, 8193]:
+            x = torch.randn(3, 4, N, device=device, dtype=dtype, requires_grad=True)
+            r = torch.randn(3, 4, N, device=device, dtype=dtype, requires_grad=True)
+            weight = torch.randn(N, device=device, dtype=dtype, requires_grad=True)
+            bias = torch.randn(N, device=device, dtype=dtype, requires_grad=True)
+            out, s = torch._add_layer_norm(x, r, (N,), weight, bias)
+            (out.sum() + (s * 2).sum()).backward()
+
+            inputs_ref = [t.detach().clone().requires_grad_() for t in [x, r, weight, bias]]
+            x_ref, r_ref, weight_ref, bias_ref = inputs_ref
+            s_ref = x_ref + r_ref
+            out_ref = F.layer_norm(s_ref, (N,), weight_ref, bias_ref)
+            (out_ref.sum() + (s_ref * 2).sum()).backward()
+            self.assertEqual(s, s_ref, 0)
+            self.assertEqual(out, out_ref, prec)
+            for t, t_ref in zip([x, r, weight, bias], inputs_ref):
+                self.assertEqual(t.grad, t_ref.grad, prec * 10)
+
+        with torch.no_grad():
+            out, s = torch._add_layer_norm(x, r, (N,))
+        self.assertEqual(out, F.layer_norm(x + r, (N,)), prec)
+        with self.assertRaisesRegex(RuntimeError, "same shape as input"):
+            torch._add_layer_norm(x, r[0], (N,))
+
+    def _roi_align_reference(self, input, rois, spatial_scale, pooled_height, pooled_width,
+                             sampling_ratio, aligned):
+        # naive loops over the bins, in double
+        input = input.double()
+        height, width = input.size(2), input.size(3)
+        output = input.new_zeros(rois.size(0), input.size(1), pooled_height, pooled_width)
+
+        def bilinear(plane, y, x):
+            if y < -1 or y > height or x < -1 or x > width:
+                return 0
+            y, x = max(y, 0.), max(x, 0.)
+            y_low, x_low = min(int(y), height - 1), min(int(x), width - 1)
+            y_high, x_high = min(y_low + 1, height - 1), min(x_low + 1, width - 1)
+            ly = 0. if y_low == height - 1 else y - y_low
+            lx = 0. if x_low == width - 1 else x - x_low
+            return ((1 - ly) * (1 - lx) * plane[:, y_low, x_low] + (1 - ly) * lx * plane[:, y_low, x_high] +
+                    ly * (1 - lx) * plane[:, y_high, x_low] + ly * lx * plane[:, y_high, x_high])
+
+        for k, roi in enumerate(rois.double().tolist()):
+            offset = 0.5 if aligned else 0.
+            x1, y1, x2, y2 = [v * spatial_scale - offset for v in roi[1:]]
+            roi_w, roi_h = x2 - x1, y2 - y1
+            if not aligned:
+                roi_w, roi_h = max(roi_w, 1.), max(roi_h, 1.)
+            bin_h, bin_w = roi_h / pooled_height, roi_w / pooled_width
+            grid_h = sampling_ratio if sampling_ratio > 0 else int(math.ceil(bin_h))
+            grid_w = sampling_ratio if sampling_ratio > 0 else int(math.ceil(bin_w))
+            plane = input[int(roi[0])]
+            for ph in range(pooled_height):
+                for pw in range(pooled_width):
+                    val = 0
+                    for iy in range(grid_h):
+                        y = y1 + ph * bin_h + (iy + 0.5) * bin_h / grid_h
+                        for ix in range(grid_w):
+                            x = x1 + pw * bin_w + (ix + 0.5) * bin_w / grid_w
+                            val = val + bilinear(plane, y, x)
+                    output[k, :, ph, pw] = val / max(grid_h * grid_w, 1)
+        return output
+
+    def _random_rois(self, device, dtype, num_rois, batch_size, height, width):
+        x1 = torch.rand(num_rois, device=device, dtype=dtype) * width
+        y1 = torch.rand(num_rois, device=device, dtype=dtype) * height
+        x2 = x1 + torch.rand(num_rois, device=device, dtype=dtype) * width
+        y2 = y1 + torch.rand(num_rois, device=device, dtype=dtype) * height
+        batch = torch.randint(batch_size, (num_rois,), device=device).to(dtype)
+        return torch.stack([batch, x1, y1, x2, y2], 1)
+
+    @dtypesIfCUDA(torch.half, torch.float, torch.double)
+    @dtypes(torch.float, torch.double)
+    def test_roi_align(self, device, dtype):
+        prec = 1e-2 if dtype == torch.half else 1e-5
+        input = torch.randn(2, 3, 10, 12, device=device, dtype=dtype)
+        rois = self._random_rois(device, dtype, 7, 2, 10, 12)
+        for spatial_scale, sampling_ratio, aligned in [(1., -1, False), (0.5, 2, False), (1., 2, True)]:
+            out = torch.roi_align(input, rois, spatial_scale, 3, 4, sampling_ratio, aligned)
+            ref = self._roi_align_reference(input.cpu(), rois.cpu(), spatial_scale, 3, 4, sampling_ratio, aligned)
+            self.assertEqual(out.size(), (7, 3, 3, 4))
+            self.assertEqual(out.double().cpu(), ref, prec)
+
+        self.assertEqual(torch.roi_align(input, rois[:0], 1., 3, 4).size(), (0, 3, 3, 4))
+        with self.assertRaisesRegex(RuntimeError, "rois"):
+            torch.roi_align(input, rois[:, :4], 1., 3, 4)
+
+        if dtype == torch.double:
+            input = input[:, :, :5, :6].clone().requires_grad_()
+            rois = self._random_rois(device, dtype, 4, 2, 5, 6)
+            for aligned in [False, True]:
+                self.assertTrue(gradcheck(lambda x: torch.roi_align(x, rois, 1., 2, 2, 2, aligned), (input,)))
+
+    @dtypesIfCUDA(torch.half, torch.float)
+    @dtypes(torch.float)
+    def test_roi_align_backward(self, device, dtype):
+        prec = 5e-2 if dtype == torch.half else 1e-4
+        input = torch.randn(2, 4, 16, 16, device=device, dtype=dtype, requires_grad=True)
+        rois = self._random_rois(device, dtype, 20, 2, 16, 16)
+        torch.roi_align(input, rois, 1., 5, 5).sum().backward()
+        input_ref = input.detach().double().requires_grad_()
+        torch.roi_align(input_ref, rois.double(), 1., 5, 5).sum().backward()
+        self.assertEqual(input.grad.double(), input_ref.grad, prec)
+
+    def _nms_reference(self, boxes, scores, iou_threshold):
+        boxes = boxes.double().tolist()
+        keep = []
+        for i in scores.double().argsort(descending=True).tolist():
+            x1, y1, x2, y2 = boxes[i]
+            suppressed = False
+            for j in keep:
+                a1, b1, a2, b2 = boxes[j]
+                inter = max(min(x2, a2) - max(x1, a1), 0) * max(min(y2, b2) - max(y1, b1), 0)
+                union = (x2 - x1) * (y2 - y1) + (a2 - a1) * (b2 - b1) - inter
+                if inter > iou_threshold * union:
+                    suppressed = True
+                    break
+            if not suppressed:
+                keep.append(i)
+        return torch.tensor(keep, dtype=torch.long)
+
+    @dtypesIfCUDA(torch.float, torch.double)
+    @dtypes(torch.float, torch.double)
+    def test_batched_nms(self, device, dtype):
+        # more than 64 boxes, so that the CUDA kernels use several mask words
+        for num_boxes in [1, 10, 100, 500]:
+            xy = torch.rand(num_boxes, 2, device=device, dtype=dtype) * 100
+            wh = torch.rand(num_boxes, 2, device=device, dtype=dtype) * 30 + 1
+            boxes = torch.cat([xy, xy + wh], 1)
+            scores = torch.randperm(num_boxes, device=device).to(dtype)
+            for iou_threshold in [0.3, 0.7]:
+                keep = torch._nms(boxes, scores, iou_threshold)
+                self.assertEqual(keep.cpu(), self._nms_reference(boxes.cpu(), scores.cpu(), iou_threshold))
+
+                idxs = torch.randint(3, (num_boxes,), device=device)
+                keep = torch.batched_nms(boxes, scores, idxs, iou_threshold)
+                keep_ref = torch.cat([c.nonzero().view(-1)[self._nms_reference(
+                    boxes[c].cpu(), scores[c].cpu(), iou_threshold).to(device)] for c in [idxs == i for i in range(3)]])
+                self.assertEqual(keep.sort()[0], keep_ref.sort()[0])
+                # kept boxes are in decreasing order of score
+                self.assertEqual(scores[keep], scores[keep].sort(descending=True)[0])
+
+        empty = torch.empty(0, 4, device=device, dtype=dtype)
+        self.assertEqual(torch.batched_nms(empty, empty[:, 0], empty[:, 0].long(), 0.5).numel(), 0)
+
+    @dtypes(torch.float, torch.double)
+    def test_box_decode(self, device, dtype):
+        boxes = torch.tensor([[0., 0., 10., 20.], [5., 5., 9., 7.]], device=device, dtype=dtype)
+        deltas = torch.tensor([[0., 0., 0., 0., 0.1, -0.2, math.log(2), 10.]], device=device, dtype=dtype).repeat(2, 1)
+        out = torch.box_decode(boxes, deltas, 1., 2., 1., 1.)
+        self.assertEqual(out.size(), (2, 8))
+        self.assertEqual(out[:, :4], boxes)
+        clipped = math.exp(4.135166556742356)
+        self.assertEqual(out[0, 4:], torch.tensor([-4., 8. - 10. * clipped, 16., 8. + 10. * clipped], device=device, dtype=dtype))
+        self.assertEqual(out[1, 4:], torch.tensor([3.4, 5.8 - clipped, 11.4, 5.8 + clipped], device=device, dtype=dtype))
+
     def test_GroupNorm_general(self, device):
         self._test_GroupNorm_general(device)
 
@@ -9045,26 +9413,107 @@ class TestNNDeviceType(NNTestCase):
         test('threshold', 3, 2)
         test('threshold', 3, 2, inplace=True)
 
-    @unittest.skipIf(not TEST_CUDA, "CUDA unavailable")
     def test_max_pool2d_nhwc(self, device):
-        input = torch.randint(1, 10, (4, 8, 8, 8), dtype=torch.float32, device="cuda")
-        input = input.contiguous(memory_format=torch.channels_last).requires_grad_()
-        grad = torch.randint(1, 10, (4, 8, 1, 1), dtype=torch.float32, device="cuda")
-        pool = torch.nn.MaxPool2d((7, 7)).cuda()
-
-        ref_input = input.detach().clone().contiguous().requires_grad_(True)
-        ref_grad = grad.detach().clone().contiguous()
-        ref_pool = torch.nn.MaxPool2d((7, 7)).cuda()
-
-        out = pool(input)
-        out.backward(grad)
-        ref_out = ref_pool(ref_input)
-        ref_out.backward(ref_grad)
-
-        self.assertTrue(out.is_contiguous(memory_format=torch.channels_last))
-        self.assertTrue(ref_out.is_contiguous())
-        self.assertTrue(torch.allclose(out, ref_out))
-        self.assertTrue(torch.allclose(input.grad, ref_input.grad))
+        def helper(n, c, h, w, kernel_size, stride=None, padding=0, dilation=1):
+            if stride is None:
+                stride = kernel_size
+            input = torch.randn(n, c, h, w, dtype=torch.float32, device=device)
+            input = input.contiguous(memory_format=torch.channels_last).requires_grad_()
+            pool = torch.nn.MaxPool2d(kernel_size, stride, padding, dilation,
+                                      return_indices=True).to(device)
+
+            ref_input = input.detach().clone().contiguous().requires_grad_(True)
+            ref_pool = torch.nn.MaxPool2d(kernel_size, stride, padding, dilation,
+                                          return_indices=True).to(device)
+
+            out, ind = pool(input)
+            ref_out, ref_ind = ref_pool(ref_input)
+            grad = torch.randint(1, 10, out.shape, dtype=torch.float32, device=device)
+            out.backward(grad.contiguous(memory_format=torch.channels_last))
+            ref_out.backward(grad)
+
+            self.assertTrue(out.is_contiguous(memory_format=torch.channels_last))
+            self.assertTrue(ref_out.is_contiguous())
+            self.assertTrue(ind.is_contiguous(memory_format=torch.channels_last))
+            self.assertEqual(out, ref_out, 0)
+            self.assertEqual(ind, ref_ind, 0)
+            self.assertTrue(input.grad.is_contiguous(memory_format=torch.channels_last))
+            self.assertEqual(input.grad, ref_input.grad)
+
+        helper(4, 8, 8, 8, 7)
+        helper(2, 19, 9, 11, 3, 2, 1)
+        helper(2, 19, 10, 10, 3, 1, 1, 2)
+
+    @onlyCPU
+    def test_adaptive_avg_pool2d_nhwc(self, device):
+        def helper(n, c, h, w, output_size):
+            input = torch.randn(n, c, h, w, dtype=torch.float32, device=device)
+            input = input.contiguous(memory_format=torch.channels_last).requires_grad_()
+            grad = torch.randn(n, c, *output_size, dtype=torch.float32, device=device)
+            pool = torch.nn.AdaptiveAvgPool2d(output_size)
+
+            ref_input = input.detach().clone().contiguous().requires_grad_(True)
+
+            out = pool(input)
+            out.backward(grad)
+            ref_out = pool(ref_input)
+            ref_out.backward(grad)
+
+            self.assertTrue(out.is_contiguous(memory_format=torch.channels_last))
+            self.assertTrue(ref_out.is_contiguous())
+            self.assertEqual(out, ref_out)
+            self.assertEqual(input.grad, ref_input.grad)
+
+        helper(4, 8, 8, 8, (7, 7))
+        helper(2, 19, 9, 11, (4, 3))
+        helper(2, 19, 9, 11, (1, 1))
+
+    @onlyCPU
+    def test_upsamplingBilinear2d_nhwc(self, device):
+        for align_corners in [True, False]:
+            for c, out_size in [(8, (16, 16)), (19, (7, 13)), (3, (9, 11))]:
+                input = torch.randn(2, c, 9, 11, dtype=torch.float32, device=device)
+                input = input.contiguous(memory_format=torch.channels_last)
+                ref_input = input.contiguous()
+
+                out = F.interpolate(input, out_size, mode='bilinear', align_corners=align_corners)
+                ref_out = F.interpolate(ref_input, out_size, mode='bilinear', align_corners=align_corners)
+
+                self.assertTrue(out.is_contiguous(memory_format=torch.channels_last))
+                self.assertTrue(ref_out.is_contiguous())
+                self.assertEqual(out, ref_out)
+
+    @onlyCPU
+    def test_batchnorm_nhwc(self, device):
+        for c in [8, 19]:
+            input = torch.randn(4, c, 7, 9, dtype=torch.float32, device=device)
+            input = input.contiguous(memory_format=torch.channels_last).requires_grad_()
+            grad = torch.randn(4, c, 7, 9, dtype=torch.float32, device=device)
+            bn = nn.BatchNorm2d(c).to(device)
+            bn.weight.data.uniform_()
+            bn.bias.data.uniform_()
+
+            ref_input = input.detach().clone().contiguous().requires_grad_(True)
+            ref_bn = deepcopy(bn)
+
+            out = bn(input)
+            out.backward(grad.contiguous(memory_format=torch.channels_last))
+            ref_out = ref_bn(ref_input)
+            ref_out.backward(grad)
+
+            self.assertTrue(out.is_contiguous(memory_format=torch.channels_last))
+            self.assertTrue(ref_out.is_contiguous())
+            self.assertEqual(out, ref_out)
+            self.assertEqual(bn.running_mean, ref_bn.running_mean)
+            self.assertEqual(bn.running_var, ref_bn.running_var)
+            self.assertEqual(input.grad, ref_input.grad)
+            self.assertEqual(bn.weight.grad, ref_bn.weight.grad)
+
+            bn.eval()
+            ref_bn.eval()
+            out = bn(input)
+            self.assertTrue(out.is_contiguous(memory_format=torch.channels_last))
+            self.assertEqual(out, ref_bn(ref_input))
 
     def test_embedding_dense_grad(self, device):
         embd = nn.Embedding(20, 20).to(device)
@@ -9079,6 +9528,33 @@ class TestNNDeviceType(NNTestCase):
         fn = fn_wrapper(device)
         _assertGradAndGradgradChecks(self, fn, (weight, ))
 
+    @onlyCUDA
+    @dtypes(torch.half, torch.float)
+    def test_embedding_backward_deterministic(self, device, dtype):
+        # enough indices to take the partitioned path, with heavy reuse of few rows
+        num_weights = 100000
+        indices = torch.cat([torch.randint(0, 10, (5000,)), torch.randint(0, num_weights, (5000,))])
+        indices = indices[torch.randperm(indices.numel())].to(device)
+        offsets = torch.arange(0, indices.numel(), 7, device=device)
+        grad_out = torch.randn(indices.numel(), 16, device=device, dtype=dtype)
+        grad_bag = torch.randn(offsets.numel(), 16, device=device, dtype=dtype)
+        for scale_grad_by_freq in [False, True]:
+            results = []
+            for _ in range(2):
+                weight = torch.randn(num_weights, 16, device=device, dtype=dtype, requires_grad=True)
+                F.embedding(indices, weight, scale_grad_by_freq=scale_grad_by_freq).backward(grad_out)
+                bag_weight = weight.detach().clone().requires_grad_()
+                F.embedding_bag(indices, bag_weight, offsets, mode='mean',
+                                scale_grad_by_freq=scale_grad_by_freq).backward(grad_bag)
+                results.append((weight.grad, bag_weight.grad))
+            self.assertEqual(results[0][0], results[1][0], 0)
+            self.assertEqual(results[0][1], results[1][1], 0)
+
+            weight_ref = torch.zeros(num_weights, 16, dtype=torch.double, requires_grad=True)
+            F.embedding(indices.cpu(), weight_ref, scale_grad_by_freq=scale_grad_by_freq).backward(
+                grad_out.cpu().double())
+            self.assertEqual(results[0][0].double().cpu(), weight_ref.grad, 5e-2 if dtype == torch.half else 1e-4)
+
     @dtypesIfCUDA(torch.float16, torch.float64)
     @dtypes(torch.float64)
     def test_embedding_backward(self, device, dtype):
@@ -9176,6 +9652,24 @@ class TestNNDeviceType(NNTestCase):
                 grad_input, = torch.autograd.grad(output, input, create_graph=True)
                 grad_input.sum().backward()
 
+    @dtypesIfCUDA(torch.half, torch.float, torch.double)
+    @dtypes(torch.float, torch.double)
+    def test_softmax_long_rows(self, device, dtype):
+        # rows longer than one warp handles, up to and past one block on CUDA
+        prec = 1e-3 if dtype == torch.half else 1e-6
+        for dim_size in [1000, 1025, 2048, 5000, 8192, 8193]:
+            for fn in [F.softmax, F.log_softmax]:
+                input = torch.randn(7, dim_size, device=device, dtype=dtype, requires_grad=True)
+                output = fn(input, dim=1)
+                grad = torch.randn_like(output)
+                output.backward(grad)
+
+                input_ref = input.detach().double().requires_grad_()
+                output_ref = fn(input_ref, dim=1)
+                output_ref.backward(grad.double())
+                self.assertEqual(output.double(), output_ref, prec)
+                self.assertEqual(input.grad.double(), input_ref.grad, prec * 10)
+
     def test_conv_noncontig_weights(self, device):
         for dim in (1, 2, 3):
             for grouped in (False, True):
@@ -9834,6 +10328,45 @@ class TestNNDeviceType(NNTestCase):
         self._test_EmbeddingBag(device, 'sum', True, dtype, test_backward=test_backward)
         self._test_EmbeddingBag(device, 'mean', True, dtype, test_backward=test_backward)
 
+    @onlyCPU
+    @dtypes(torch.float, torch.double)
+    def test_embedding_bag_grouped(self, device, dtype):
+        num_bags = 5
+        weights, indices, offsets, per_sample_weights = [], [], [], []
+        for num_embeddings, embedding_dim in [(10, 3), (7, 16), (20, 1), (4, 8)]:
+            weights.append(torch.randn(num_embeddings, embedding_dim, device=device, dtype=dtype))
+            indices.append(torch.randint(num_embeddings, (12,), device=device, dtype=torch.long))
+            # includes an empty bag
+            offsets.append(torch.tensor([0, 2, 2, 7, 9], device=device, dtype=torch.long))
+            per_sample_weights.append(torch.randn(12, device=device, dtype=dtype))
+        # a table whose rows are not contiguous
+        weights[1] = weights[1].t().contiguous().t()
+
+        for mode, mode_id in [('sum', 0), ('mean', 1)]:
+            expected = torch.cat([F.embedding_bag(i, w, o, mode=mode)
+                                  for w, i, o in zip(weights, indices, offsets)], 1)
+            output = torch._embedding_bag_grouped(weights, indices, offsets, [], mode_id)
+            self.assertEqual(output.size(), (num_bags, 28))
+            self.assertEqual(output, expected)
+
+            out = torch.empty(0, device=device, dtype=dtype)
+            torch._embedding_bag_grouped(weights, indices, offsets, [], mode_id, out=out)
+            self.assertEqual(out, expected)
+
+        expected = torch.cat([F.embedding_bag(i, w, o, mode='sum', per_sample_weights=p)
+                              for w, i, o, p in zip(weights, indices, offsets, per_sample_weights)], 1)
+        output = torch._embedding_bag_grouped(weights, indices, offsets, per_sample_weights, 0)
+        self.assertEqual(output, expected)
+
+        # a single table is written in place
+        output = torch._embedding_bag_grouped(weights[:1], indices[:1], offsets[:1], [], 0)
+        self.assertEqual(output, F.embedding_bag(indices[0], weights[0], offsets[0], mode='sum'))
+
+        with self.assertRaisesRegex(RuntimeError, "only mode='sum' and mode='mean'"):
+            torch._embedding_bag_grouped(weights, indices, offsets, [], 2)
+        with self.assertRaisesRegex(RuntimeError, "bags"):
+            torch._embedding_bag_grouped(weights, indices, [offsets[0][:2]] + offsets[1:], [], 0)
+
     @onlyCUDA
     @dtypes(torch.half, torch.float, torch.double)
     def test_multihead_attention_dtype(self, device, dtype):
@@ -19,7 +19,9 @@ from torch.quantization import QConfig
 from torch.quantization import default_histogram_observer
 from torch.quantization import default_observer
 from torch.quantization import default_per_channel_weight_observer
-from torch.quantization._quantize_script import quantize_script
+from torch.quantization._quantize_script import quantize_script, \
+    quantize_embedding_bag_script
+from torch.testing import FileCheck
 
 from common_utils import run_tests
 from common_quantization import QuantizationTestCase, \
@@ -528,6 +530,22 @@ class PostTrainingDynamicQuantTest(QuantizationTestCase):
         model = quantize_dynamic(NestedModel().eval(), qconfig_dict)
         checkQuantized(model)
 
+    def test_per_channel_quantized_rnn(self):
+        r"""Test per channel dynamic quantization of the LSTM weights
+        """
+        model = LSTMDynamicModel().eval()
+        qconfig_dict = {
+            torch.nn.LSTM: per_channel_dynamic_qconfig
+        }
+        model_int8 = quantize_dynamic(model, qconfig_dict)
+        cell_int8 = model_int8.lstm
+        self.assertEqual(type(cell_int8), torch.nn.quantized.dynamic.LSTM)
+
+        x = torch.randn(5, 3, 2)
+        ref_out, _ = model.lstm(x)
+        output_int8, _ = cell_int8(x)
+        self.assertEqual(output_int8, ref_out, prec=0.1)
+
     def test_quantized_rnn(self):
         d_in, d_hid = 2, 2
         model = LSTMDynamicModel().eval()
@@ -916,6 +934,34 @@ class GraphModePostTrainingQuantTest(QuantizationTestCase):
         script_result = get_forward(quantized_script_model._c)(self.calib_data[0][0])
         self.assertEqual(eager_result, script_result)
 
+    def test_quantize_embedding_bag(self):
+        class EmbeddingBagModel(torch.nn.Module):
+            def __init__(self):
+                super(EmbeddingBagModel, self).__init__()
+                self.emb = torch.nn.EmbeddingBag(20, 16, mode='sum')
+
+            def forward(self, indices, offsets):
+                return self.emb(indices, offsets)
+
+        indices = torch.randint(0, 20, (12,))
+        offsets = torch.tensor([0, 3, 3, 8])
+        model = EmbeddingBagModel().eval()
+        qmodel = quantize_embedding_bag_script(torch.jit.script(model), 8)
+        FileCheck().check_not('aten::embedding_bag') \
+                   .check('quantized::embedding_bag_byte_rowwise_offsets') \
+                   .run(qmodel.emb.graph)
+        self.assertEqual(qmodel.emb.weight.numel(), 0)
+        self.assertEqual(qmodel(indices, offsets), model(indices, offsets),
+                         prec=0.05)
+
+        model = torch.nn.EmbeddingBag(20, 16, mode='mean').eval()
+        qmodel = quantize_embedding_bag_script(torch.jit.script(model), 4)
+        FileCheck().check_not('aten::embedding_bag') \
+                   .check('quantized::embedding_bag_4bit_rowwise_offsets') \
+                   .run(qmodel.graph)
+        self.assertEqual(qmodel(indices, offsets), model(indices, offsets),
+                         prec=0.5)
+
 
 class FunctionalModuleTest(QuantizationTestCase):
     # Histogram Observers are slow, so have no-deadline to ensure test doesn't time out
@@ -1302,6 +1348,39 @@ class ObserverTest(QuantizationTestCase):
             self.assertEqual(myobs.max_vals, loaded_obs.max_vals)
             self.assertEqual(myobs.calculate_qparams(), loaded_obs.calculate_qparams())
 
+    def test_observer_ops(self):
+        devices = ['cpu', 'cuda'] if torch.cuda.is_available() else ['cpu']
+        for device in devices:
+            x = torch.randn(4, 3, 5, 6, device=device)
+            y = torch.randn(4, 3, 5, 6, device=device) * 2
+            min_val, max_val = torch._observer_min_max(x, None, None)
+            self.assertEqual(min_val, x.min())
+            self.assertEqual(max_val, x.max())
+            min_val, max_val = torch._observer_min_max(y, min_val, max_val)
+            self.assertEqual(min_val, torch.min(x.min(), y.min()))
+            self.assertEqual(max_val, torch.max(x.max(), y.max()))
+
+            min_val, max_val = torch._observer_moving_average_min_max(x, None, None, 0.25)
+            min_val, max_val = torch._observer_moving_average_min_max(y, min_val, max_val, 0.25)
+            self.assertEqual(min_val, x.min() + 0.25 * (y.min() - x.min()))
+            self.assertEqual(max_val, x.max() + 0.25 * (y.max() - x.max()))
+
+            for ch_axis in range(x.dim()):
+                # The reference of the per channel observers
+                x_t = x.transpose(0, ch_axis).flatten(start_dim=1)
+                y_t = y.transpose(0, ch_axis).flatten(start_dim=1)
+                min_vals, max_vals = torch._observer_min_max(x, None, None, ch_axis)
+                min_vals, max_vals = torch._observer_min_max(y, min_vals, max_vals, ch_axis)
+                self.assertEqual(min_vals, torch.min(x_t.min(1)[0], y_t.min(1)[0]))
+                self.assertEqual(max_vals, torch.max(x_t.max(1)[0], y_t.max(1)[0]))
+
+            histogram, min_val, max_val = torch._observer_histogram(x, None, None, None, 16, 8)
+            self.assertEqual(histogram, torch.histc(x, 16, min=x.min().item(), max=x.max().item()))
+            histogram, min_val, max_val = torch._observer_histogram(y, histogram, min_val, max_val, 16, 8)
+            self.assertLessEqual(min_val.item(), min(x.min().item(), y.min().item()))
+            self.assertGreaterEqual(max_val.item(), max(x.max().item(), y.max().item()))
+            self.assertAlmostEqual(histogram.sum().item(), x.numel() + y.numel(), delta=1e-2)
+
     def test_observer_scriptable(self):
         obs_list = [MinMaxObserver(), MovingAverageMinMaxObserver()]
         for obs in obs_list:
@@ -398,6 +398,63 @@ class TestQuantizedOps(TestCase):
         self.assertEqual(qCrelu_hat, qCrelu_out_hat,
                          message="mulReLU.out failed")
 
+    """Tests the correctness of the add and mul ops with broadcasting."""
+    def test_qadd_qmul_broadcast(self):
+        ops_under_test = {
+            'add': (torch.ops.quantized.add, torch.add),
+            'mul': (torch.ops.quantized.mul, torch.mul),
+        }
+        A = torch.arange(-48, 48, dtype=torch.float).reshape(2, 3, 16)
+        B = torch.arange(-8, 8, dtype=torch.float)
+        scale_C = 0.5
+        zero_point_C = 5
+        for dtype in (torch.quint8, torch.qint8):
+            qA = torch.quantize_per_tensor(A, scale=2.0, zero_point=3, dtype=dtype)
+            qB = torch.quantize_per_tensor(B, scale=1.0, zero_point=4, dtype=dtype)
+            for name, (qop, op) in ops_under_test.items():
+                for a, b in ((qA, qB), (qB, qA), (qA, qB.reshape(1, 1, 16)), (qA[:, :1], qA)):
+                    C = op(a.dequantize(), b.dequantize())
+                    qC = torch.quantize_per_tensor(C, scale=scale_C, zero_point=zero_point_C,
+                                                   dtype=dtype)
+                    qC_hat = qop(a, b, scale=scale_C, zero_point=zero_point_C)
+                    self.assertEqual(qC.shape, qC_hat.shape)
+                    self.assertEqual(qC.int_repr(), qC_hat.int_repr(),
+                                     message="broadcasting {} failed".format(name))
+
+    """Tests the correctness of the quantized sigmoid op."""
+    @given(X=hu.tensor(shapes=hu.array_shapes(1, 5, 1, 5),
+                       qparams=hu.qparams(dtypes=[torch.quint8, torch.qint8])))
+    def test_qsigmoid(self, X):
+        X, (scale, zero_point, torch_type) = X
+        qX = torch.quantize_per_tensor(torch.from_numpy(X), scale=scale,
+                                       zero_point=zero_point, dtype=torch_type)
+        qY_hat = torch.sigmoid(qX)
+        # the output range [0, 1] is covered by the whole range of the dtype
+        self.assertEqual(qY_hat.q_scale(), 1.0 / 256)
+        self.assertEqual(qY_hat.q_zero_point(), 0 if torch_type == torch.quint8 else -128)
+        Y = torch.sigmoid(qX.dequantize())
+        qY = torch.quantize_per_tensor(Y, scale=1.0 / 256,
+                                       zero_point=qY_hat.q_zero_point(), dtype=torch_type)
+        # allow off-by-one from the vectorized exp
+        diff = (qY.int_repr().to(torch.int) - qY_hat.int_repr().to(torch.int)).abs()
+        self.assertLessEqual(diff.max().item(), 1)
+
+    """Tests the correctness of the quantized hardtanh op."""
+    @given(X=hu.tensor(shapes=hu.array_shapes(1, 5, 1, 5),
+                       qparams=hu.qparams()),
+           min_val=st.floats(-3.0, 0.0),
+           max_val=st.floats(0.0, 3.0))
+    def test_qhardtanh(self, X, min_val, max_val):
+        X, (scale, zero_point, torch_type) = X
+        qX = torch.quantize_per_tensor(torch.from_numpy(X), scale=scale,
+                                       zero_point=zero_point, dtype=torch_type)
+        q_min = torch.quantize_per_tensor(torch.tensor(min_val), scale, zero_point, torch_type)
+        q_max = torch.quantize_per_tensor(torch.tensor(max_val), scale, zero_point, torch_type)
+        Y = qX.dequantize().clamp(q_min.dequantize().item(), q_max.dequantize().item())
+        qY = torch.quantize_per_tensor(Y, scale=scale, zero_point=zero_point, dtype=torch_type)
+        qY_hat = F.hardtanh(qX, min_val, max_val)
+        self.assertEqual(qY, qY_hat, message="hardtanh failed")
+
     """Tests max pool operation on quantized tensors."""
     @given(X=hu.tensor(shapes=hu.array_shapes(min_dims=3, max_dims=4,
                                               min_side=1, max_side=10),
@@ -818,6 +875,29 @@ class TestQuantizedOps(TestCase):
             cat_q = q_cat_op(tensors_q, dim=ch_axis, scale=scale,
                              zero_point=zero_point)
 
+    """Tests quantized concatenation of inputs with different qparams."""
+    def test_cat_different_qparams(self):
+        X = torch.arange(-30, 30, dtype=torch.float).reshape(3, 4, 5)
+        Y = torch.arange(0, 45, dtype=torch.float).reshape(3, 3, 5)
+        scale, zero_point = 0.5, 10
+        for dtype in (torch.quint8, torch.qint8):
+            qX = torch.quantize_per_tensor(X, scale=1.0, zero_point=2, dtype=dtype)
+            qY = torch.quantize_per_tensor(Y, scale=0.25, zero_point=0, dtype=dtype)
+            for relu, op in ((False, torch.ops.quantized.cat), (True, torch.ops.quantized.cat_relu)):
+                # dim=-2 is not the NHWC fast path
+                ref = torch.cat([qX.dequantize(), qY.dequantize()], dim=1)
+                if relu:
+                    ref = F.relu(ref)
+                ref = torch.quantize_per_tensor(ref, scale, zero_point, dtype)
+                out = op([qX, qY], dim=-2, scale=scale, zero_point=zero_point)
+                self.assertEqual(ref.int_repr(), out.int_repr())
+                # slices of a non-contiguous input
+                out = op([qX.transpose(0, 2), qY.transpose(0, 2)], dim=1, scale=scale,
+                         zero_point=zero_point)
+                self.assertEqual(ref.transpose(0, 2).int_repr(), out.int_repr())
+        with self.assertRaisesRegex(RuntimeError, "Sizes of tensors must match"):
+            torch.ops.quantized.cat([qX, qY], dim=0, scale=scale, zero_point=zero_point)
+
     @no_deadline
     @given(X=hu.tensor(shapes=hu.array_shapes(min_dims=4, max_dims=4,
                                               min_side=5, max_side=10),
@@ -1367,6 +1447,39 @@ class TestQuantizedLinear(unittest.TestCase):
                 np.testing.assert_equal(
                     W_q.q_zero_point(), W_q_origin.q_zero_point())
 
+    """Tests that quantized::linear_hardtanh matches quantized::linear clamped
+    to the quantized min_val and max_val."""
+    @given(batch_size=st.integers(1, 4),
+           input_channels=st.integers(16, 32),
+           output_channels=st.integers(4, 8),
+           min_val=st.floats(-2.0, 0.0),
+           max_val=st.floats(0.0, 6.0),
+           qengine=st.sampled_from(("qnnpack", "fbgemm")))
+    def test_qlinear_hardtanh(self, batch_size, input_channels, output_channels,
+                              min_val, max_val, qengine):
+        if qengine not in torch.backends.quantized.supported_engines:
+            return
+        if qengine == 'qnnpack':
+            if IS_PPC or TEST_WITH_UBSAN or IS_MACOS:
+                return
+
+        with override_quantized_engine(qengine):
+            X_q = torch.quantize_per_tensor(
+                torch.rand(batch_size, input_channels), 0.02, 2, torch.quint8)
+            W_q = torch.quantize_per_tensor(
+                torch.rand(output_channels, input_channels) - 0.5, 0.01, 0,
+                torch.qint8)
+            b = torch.rand(output_channels) - 0.5
+            W_prepack = torch.ops.quantized.linear_prepack(W_q, b)
+            Y_scale, Y_zp = 0.04, 64
+            Y_q = torch.ops.quantized.linear_hardtanh(
+                X_q, W_prepack, Y_scale, Y_zp, min_val, max_val)
+            Y_q_ref = torch.ops.quantized.linear(X_q, W_prepack, Y_scale, Y_zp)
+            qmin = np.clip(np.round(min_val / Y_scale) + Y_zp, 0, 255)
+            qmax = np.clip(np.round(max_val / Y_scale) + Y_zp, 0, 255)
+            Y_ref = Y_q_ref.int_repr().clamp(int(qmin), int(qmax))
+            np.testing.assert_equal(Y_ref.numpy(), Y_q.int_repr().numpy())
+
 class TestQuantizedConv(unittest.TestCase):
     def _test_qconv_unpack_impl(
         self, qconv_prepack_fn, qconv_unpack_fn, inputs, strides, pads,
@@ -1605,6 +1718,43 @@ class TestQuantizedConv(unittest.TestCase):
                 dilations, X_scale, X_zero_point, W_scale, W_zero_point,
                 Y_scale, Y_zero_point, use_bias, use_relu, use_channelwise)
 
+    """Tests that the QNNPACK depthwise convolution reuses its packed weights
+    for inputs of another scale."""
+    @given(batch_size=st.integers(1, 3),
+           channels=st.sampled_from([2, 8, 17, 32]),
+           kernel=st.sampled_from([3, 5]),
+           stride=st.integers(1, 2),
+           pad=st.integers(0, 2),
+           X_scales=st.lists(st.floats(0.2, 1.6), min_size=2, max_size=2),
+           use_relu=st.booleans())
+    def test_qconv_qnnpack_depthwise(
+            self, batch_size, channels, kernel, stride, pad, X_scales, use_relu
+    ):
+        if 'qnnpack' not in torch.backends.quantized.supported_engines:
+            return
+        if IS_PPC or TEST_WITH_UBSAN or IS_MACOS:
+            return
+        with override_quantized_engine('qnnpack'):
+            qconv = torch.ops.quantized.conv2d
+            if use_relu:
+                qconv = torch.ops.quantized.conv2d_relu
+            qconv_prepack = torch.ops.quantized.conv2d_prepack
+            W = torch.randint(-5, 5, (channels, 1, kernel, kernel)).float()
+            W_q = torch.quantize_per_tensor(W, 0.5, 0, torch.qint8)
+            b = torch.randint(0, 10, (channels,)).float()
+            X = torch.randint(0, 4, (batch_size, channels, 12, 12)).float()
+            params = ([stride, stride], [pad, pad], [1, 1], channels)
+
+            W_prepack = qconv_prepack(W_q, b, *params)
+            for X_scale in X_scales:
+                X_q = torch.quantize_per_tensor(
+                    X * X_scale, X_scale, 0, torch.quint8)
+                Y_q = qconv(X_q, W_prepack, *params, 4.0, 2)
+                Y_ref = qconv(
+                    X_q, qconv_prepack(W_q, b, *params), *params, 4.0, 2)
+                np.testing.assert_equal(
+                    Y_ref.int_repr().numpy(), Y_q.int_repr().numpy())
+
     """Tests the correctness of the quantized::qconv_unpack op."""
     @given(
         inputs=hu.tensor_conv(
@@ -1642,6 +1792,58 @@ class TestQuantizedConv(unittest.TestCase):
                 qconv_prepack, qconv_unpack, inputs, (stride_h, stride_w),
                 (pad_h, pad_w), channelwise)
 
+    """Tests that the fused quantized::conv2d_add(_relu) ops match
+    quantized::conv2d followed by quantized::add(_relu)."""
+    @given(batch_size=st.integers(1, 3),
+           input_channels=st.sampled_from([2, 4, 8]),
+           output_channels=st.sampled_from([2, 4, 8]),
+           H=st.integers(4, 8),
+           W=st.integers(4, 8),
+           kernel=st.integers(1, 3),
+           stride=st.integers(1, 2),
+           pad=st.integers(0, 1),
+           use_relu=st.booleans(),
+           qengine=st.sampled_from(("qnnpack", "fbgemm")))
+    def test_qconv_add(self, batch_size, input_channels, output_channels,
+                       H, W, kernel, stride, pad, use_relu, qengine):
+        if qengine not in torch.backends.quantized.supported_engines:
+            return
+        if qengine == 'qnnpack':
+            if IS_PPC or TEST_WITH_UBSAN:
+                return
+
+        with override_quantized_engine(qengine):
+            if use_relu:
+                qconv_add = torch.ops.quantized.conv2d_add_relu
+                qadd = torch.ops.quantized.add_relu
+            else:
+                qconv_add = torch.ops.quantized.conv2d_add
+                qadd = torch.ops.quantized.add
+            X = torch.rand(batch_size, input_channels, H, W)
+            X_q = torch.quantize_per_tensor(X, 0.02, 2, torch.quint8)
+            W_q = torch.quantize_per_tensor(
+                torch.rand(output_channels, input_channels, kernel, kernel) - 0.5,
+                0.01, 0, torch.qint8)
+            b = torch.rand(output_channels)
+            strides, pads, dilations = [stride] * 2, [pad] * 2, [1, 1]
+            W_prepack = torch.ops.quantized.conv2d_prepack(
+                W_q, b, strides, pads, dilations, 1)
+
+            conv_scale, conv_zero_point = 0.05, 10
+            Y_q = torch.ops.quantized.conv2d(
+                X_q, W_prepack, strides, pads, dilations, 1,
+                conv_scale, conv_zero_point)
+            other_q = torch.quantize_per_tensor(
+                torch.rand(Y_q.shape) - 0.5, 0.03, 20, torch.quint8)
+            out_scale, out_zero_point = 0.08, 30
+            Z_q_ref = qadd(Y_q, other_q, out_scale, out_zero_point)
+            Z_q = qconv_add(X_q, other_q, W_prepack, strides, pads, dilations, 1,
+                            conv_scale, conv_zero_point, out_scale, out_zero_point)
+            self.assertEqual(Z_q.q_scale(), out_scale)
+            self.assertEqual(Z_q.q_zero_point(), out_zero_point)
+            np.testing.assert_equal(Z_q_ref.int_repr().numpy(),
+                                    Z_q.int_repr().numpy())
+
     @given(batch_size=st.integers(1, 4),
            input_channels_per_group=st.sampled_from([2, 4, 5, 8, 16]),
            D=st.integers(4, 8),
@@ -2047,5 +2249,153 @@ class TestComparatorOps(TestCase):
                              "'tensor.{}(scalar)'' failed".format(op))
 
 
+class TestQuantizedEmbeddingBag(TestCase):
+    """Tests the row-wise quantized embedding bag ops."""
+    def _test_embedding_bag_unpack(self, prepack, unpack, num_embeddings, embedding_dim, atol):
+        weight = torch.randn(num_embeddings, embedding_dim)
+        packed = prepack(weight)
+        self.assertEqual(packed.dtype, torch.uint8)
+        self.assertEqual(packed.size(0), num_embeddings)
+        unpacked = unpack(packed)
+        self.assertEqual(unpacked.size(), weight.size())
+        # The error is bounded by half of the step of each row, plus some slack
+        # for the 4-bit format storing scale and bias in half precision
+        step = (weight.max(1, keepdim=True)[0] - weight.min(1, keepdim=True)[0]) / atol
+        self.assertTrue(((unpacked - weight).abs() <= step / 2 + 1e-2).all())
+
+    def _test_embedding_bag(self, prepack, unpack, lookup, num_embeddings, embedding_dim,
+                            num_bags, mode, use_weights):
+        weight = torch.randn(num_embeddings, embedding_dim)
+        packed = prepack(weight)
+        dequantized = unpack(packed)
+
+        lengths = torch.randint(0, 5, (num_bags,))
+        offsets = torch.cat([torch.zeros(1, dtype=torch.long), lengths.cumsum(0)[:-1]])
+        indices = torch.randint(0, num_embeddings, (int(lengths.sum()),))
+        per_sample_weights = torch.rand(indices.numel()) if use_weights else None
+
+        result = lookup(packed, indices, offsets, mode, per_sample_weights)
+        modes = {0: 'sum', 1: 'mean'}
+        if use_weights:
+            # F.embedding_bag only supports per_sample_weights for mode='sum'
+            expected = F.embedding_bag(indices, dequantized, offsets, mode='sum',
+                                       per_sample_weights=per_sample_weights)
+            if mode == 1:
+                expected = expected / lengths.clamp(min=1).unsqueeze(1).float()
+        else:
+            expected = F.embedding_bag(indices, dequantized, offsets, mode=modes[mode])
+        self.assertEqual(result, expected, prec=1e-4)
+
+    @given(num_embeddings=st.integers(1, 50),
+           embedding_dim=st.integers(1, 40),
+           num_bags=st.integers(1, 10),
+           mode=st.sampled_from([0, 1]),
+           use_weights=st.booleans())
+    def test_embedding_bag_byte(self, num_embeddings, embedding_dim, num_bags, mode, use_weights):
+        prepack = torch.ops.quantized.embedding_bag_byte_prepack
+        unpack = torch.ops.quantized.embedding_bag_byte_unpack
+        self._test_embedding_bag_unpack(prepack, unpack, num_embeddings, embedding_dim, 255.)
+        self._test_embedding_bag(prepack, unpack, torch.ops.quantized.embedding_bag_byte_rowwise_offsets,
+                                 num_embeddings, embedding_dim, num_bags, mode, use_weights)
+
+    @given(num_embeddings=st.integers(1, 50),
+           embedding_dim=st.integers(1, 20).map(lambda x: 2 * x),
+           num_bags=st.integers(1, 10),
+           mode=st.sampled_from([0, 1]),
+           use_weights=st.booleans())
+    def test_embedding_bag_4bit(self, num_embeddings, embedding_dim, num_bags, mode, use_weights):
+        prepack = torch.ops.quantized.embedding_bag_4bit_prepack
+        unpack = torch.ops.quantized.embedding_bag_4bit_unpack
+        self._test_embedding_bag_unpack(prepack, unpack, num_embeddings, embedding_dim, 15.)
+        self._test_embedding_bag(prepack, unpack, torch.ops.quantized.embedding_bag_4bit_rowwise_offsets,
+                                 num_embeddings, embedding_dim, num_bags, mode, use_weights)
+
+    def test_embedding_bag_invalid_offsets(self):
+        packed = torch.ops.quantized.embedding_bag_byte_prepack(torch.randn(10, 4))
+        indices = torch.tensor([1, 2, 3], dtype=torch.long)
+        with self.assertRaisesRegex(RuntimeError, "offsets\\[0\\]"):
+            torch.ops.quantized.embedding_bag_byte_rowwise_offsets(
+                packed, indices, torch.tensor([1], dtype=torch.long))
+        with self.assertRaisesRegex(RuntimeError, "non-decreasing"):
+            torch.ops.quantized.embedding_bag_byte_rowwise_offsets(
+                packed, indices, torch.tensor([0, 2, 1], dtype=torch.long))
+
+
+@unittest.skipIf(not torch.cuda.is_available(), "CUDA is not available")
+class TestQuantizedCUDAOps(TestCase):
+    """Tests the quantized ops on CUDA devices against their CPU results."""
+    def test_quantize_dequantize(self):
+        x = torch.randn(4, 5, 6) * 10
+        for dtype in (torch.quint8, torch.qint8, torch.qint32):
+            qx = torch.quantize_per_tensor(x, 0.1, 3, dtype)
+            qx_cuda = torch.quantize_per_tensor(x.cuda(), 0.1, 3, dtype)
+            self.assertEqual(qx_cuda.device.type, 'cuda')
+            self.assertEqual(qx_cuda.int_repr().cpu().int(), qx.int_repr().int(), prec=1)
+            self.assertEqual(qx_cuda.dequantize().cpu(), qx.dequantize(), prec=0.1)
+            self.assertEqual(qx_cuda.cpu().int_repr(), qx_cuda.int_repr().cpu())
+
+        scales = torch.rand(5, dtype=torch.double) + 0.01
+        zero_points = torch.randint(0, 10, (5,), dtype=torch.long)
+        qx = torch.quantize_per_channel(x, scales, zero_points, 1, torch.quint8)
+        qx_cuda = torch.quantize_per_channel(x.cuda(), scales, zero_points, 1, torch.quint8)
+        self.assertEqual(qx_cuda.int_repr().cpu().int(), qx.int_repr().int(), prec=1)
+        self.assertEqual(qx_cuda.q_per_channel_scales(), scales)
+
+    def test_relu_add(self):
+        x = torch.randn(3, 4, 5) * 4
+        y = torch.randn(3, 4, 5) * 4
+        qx = torch.quantize_per_tensor(x, 0.05, 120, torch.quint8)
+        qy = torch.quantize_per_tensor(y, 0.04, 130, torch.quint8)
+        qx_cuda, qy_cuda = qx.cuda(), qy.cuda()
+        self.assertEqual(torch.relu(qx_cuda).int_repr().cpu().int(),
+                         torch.relu(qx).int_repr().int())
+        for op in (torch.ops.quantized.add, torch.ops.quantized.add_relu):
+            self.assertEqual(op(qx_cuda, qy_cuda, 0.1, 100).int_repr().cpu().int(),
+                             op(qx, qy, 0.1, 100).int_repr().int(), prec=1)
+
+    def _reference_requantize(self, y, scale, zero_point, relu):
+        if relu:
+            y = F.relu(y)
+        return torch.quantize_per_tensor(y, scale, zero_point, torch.quint8).int_repr().int()
+
+    def test_qlinear(self):
+        for use_channelwise, use_relu in ((False, False), (True, True)):
+            x = torch.rand(6, 7, 9) * 4 - 1
+            w = torch.randn(5, 9)
+            b = torch.randn(5)
+            qx = torch.quantize_per_tensor(x, 0.02, 50, torch.quint8)
+            if use_channelwise:
+                qw = torch.quantize_per_channel(
+                    w, torch.rand(5, dtype=torch.double) * 0.02 + 0.01,
+                    torch.zeros(5, dtype=torch.long), 0, torch.qint8)
+            else:
+                qw = torch.quantize_per_tensor(w, 0.02, 2, torch.qint8)
+            packed = torch.ops.quantized.linear_prepack(qw.cuda(), b.cuda())
+            w_unpacked, b_unpacked = torch.ops.quantized.linear_unpack(packed)
+            self.assertEqual(w_unpacked.int_repr().cpu(), qw.int_repr())
+            op = torch.ops.quantized.linear_relu if use_relu else torch.ops.quantized.linear
+            qy = op(qx.cuda(), packed, 0.1, 30)
+            y_ref = F.linear(qx.dequantize(), qw.dequantize(), b)
+            self.assertEqual(qy.int_repr().cpu().int(),
+                             self._reference_requantize(y_ref, 0.1, 30, use_relu), prec=1)
+
+    def test_qconv2d(self):
+        for groups, use_relu in ((1, False), (2, True)):
+            x = torch.rand(2, 4, 9, 8) * 4 - 1
+            w = torch.randn(6, 4 // groups, 3, 2)
+            b = torch.randn(6)
+            qx = torch.quantize_per_tensor(x, 0.02, 50, torch.quint8)
+            qw = torch.quantize_per_tensor(w, 0.02, 0, torch.qint8)
+            stride, padding, dilation = [2, 1], [1, 1], [1, 2]
+            packed = torch.ops.quantized.conv2d_prepack(
+                qw.cuda(), b.cuda(), stride, padding, dilation, groups)
+            op = torch.ops.quantized.conv2d_relu if use_relu else torch.ops.quantized.conv2d
+            qy = op(qx.cuda(), packed, stride, padding, dilation, groups, 0.1, 30)
+            y_ref = F.conv2d(qx.dequantize(), qw.dequantize(), b, stride, padding,
+                             dilation, groups)
+            self.assertEqual(qy.int_repr().cpu().int(),
+                             self._reference_requantize(y_ref, 0.1, 30, use_relu), prec=1)
+
+
 if __name__ == "__main__":
     run_tests()
@@ -148,6 +148,37 @@ class TestQuantizedTensor(TestCase):
         self.assertTrue(np.allclose(qr.int_repr(), quantize_c(r, scales, zero_points)))
         self.assertTrue(np.allclose(r.numpy(), rqr.numpy(), atol=2 / np.min(scales.numpy())))
 
+    def test_qtensor_quant_dequant_vectorized(self):
+        # The sizes cover whole vectors, their tails and several threads
+        dtype_ranges = {torch.quint8: (0, 255), torch.qint8: (-128, 127),
+                        torch.qint32: (-2 ** 31, 2 ** 31 - 1)}
+        for shape in [(7,), (3, 67), (5, 33, 41), (4, 103, 257)]:
+            r = torch.rand(shape, dtype=torch.float) * 40 - 20
+            for dtype, (quant_min, quant_max) in dtype_ranges.items():
+                scale, zero_point = 0.1, 3
+                qr = torch.quantize_per_tensor(r, scale, zero_point, dtype)
+                q_ref = np.clip(np.round(r.numpy() / scale) + zero_point, quant_min, quant_max)
+                # Rounding by the inverse scale may be off by one at the ties
+                self.assertTrue(np.allclose(qr.int_repr().numpy(), q_ref, atol=1))
+                rqr = qr.dequantize()
+                r_ref = (qr.int_repr().numpy().astype(np.float64) - zero_point) * scale
+                self.assertTrue(np.allclose(rqr.numpy(), r_ref, rtol=1e-5, atol=1e-5))
+
+                for axis in range(len(shape)):
+                    channels = shape[axis]
+                    scales = torch.rand(channels, dtype=torch.double) * 0.2 + 0.05
+                    zero_points = torch.randint(0, 10, (channels,), dtype=torch.long)
+                    qr = torch.quantize_per_channel(r, scales, zero_points, axis, dtype)
+                    expand = [1] * len(shape)
+                    expand[axis] = channels
+                    scales_np = scales.numpy().reshape(expand)
+                    zero_points_np = zero_points.numpy().reshape(expand)
+                    q_ref = np.clip(np.round(r.numpy() / scales_np) + zero_points_np, quant_min, quant_max)
+                    self.assertTrue(np.allclose(qr.int_repr().numpy(), q_ref, atol=1))
+                    rqr = qr.dequantize()
+                    r_ref = (qr.int_repr().numpy().astype(np.float64) - zero_points_np) * scales_np
+                    self.assertTrue(np.allclose(rqr.numpy(), r_ref, rtol=1e-5, atol=1e-5))
+
     def test_qtensor_permute(self):
         r = torch.rand(10, 30, 2, 2, dtype=torch.float) * 4 - 2
         scale = 0.02
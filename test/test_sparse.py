@@ -897,6 +897,7 @@ class TestSparse(TestCase):
         test_shape(10, 100, 100, 20)
         test_shape(100, 1000, 200, 20)
         test_shape(64, 10000, 300, 20)
+        test_shape(1000, 100, 64, 5000)
         test_shape(0, 100, 100, 0)
         test_shape(10, 0, 100, 0)
         test_shape(10, 100, 0, 0)
@@ -1227,6 +1228,8 @@ class TestSparse(TestCase):
         self._test_basic_ops_shape(9, 0, [10, 10, 10])
         self._test_basic_ops_shape(0, 0, [10, 10, 10])
         self._test_basic_ops_shape(0, 0, [10, 10, 0])
+        # More than one chunk of the parallel CPU kernels
+        self._test_basic_ops_shape(50000, 60000, [300, 300])
 
     def test_basic_ops_hybrid(self):
         self._test_basic_ops_shape(9, 12, [5, 6], [2, 3])
@@ -1241,6 +1244,7 @@ class TestSparse(TestCase):
         self._test_basic_ops_shape(9, 0, [10, 10, 10], [2, 0])
         self._test_basic_ops_shape(0, 0, [10, 10, 10], [2, 0])
         self._test_basic_ops_shape(0, 0, [10, 10, 0], [2, 0])
+        self._test_basic_ops_shape(50000, 60000, [300, 300], [2])
 
     def test_add_dense_sparse_mismatch(self):
         def test_shape(dense_size, sparse_dims_shape, dense_dims_shape, sparse_size):
@@ -2163,6 +2167,64 @@ class TestSparseOneOff(TestCase):
         with self.assertRaisesRegex(RuntimeError, "add: expected 'self' to be a CUDA tensor, but got a CPU tensor"):
             x + sparse_y
 
+    def _sparse_row_grad(self, num_rows, dim, nnz):
+        # uncoalesced, with repeated rows
+        indices = torch.randint(0, num_rows, (1, nnz))
+        values = torch.randn(nnz, dim)
+        return torch.sparse_coo_tensor(indices, values, (num_rows, dim))
+
+    def test_sparse_adagrad_(self):
+        lr, eps = 0.1, 1e-10
+        for num_rows, dim, nnz in [(10, 4, 30), (50, 17, 20), (5, 1, 8), (8, 3, 0)]:
+            for coalesce in [False, True]:
+                weight = torch.randn(num_rows, dim)
+                state_sum = torch.rand(num_rows, dim)
+                grad = self._sparse_row_grad(num_rows, dim, nnz)
+                if coalesce:
+                    grad = grad.coalesce()
+
+                # rows without a gradient see a zero update
+                dense_grad = grad.to_dense()
+                expected_sum = state_sum + dense_grad * dense_grad
+                expected_weight = weight - lr * dense_grad / (expected_sum.sqrt() + eps)
+
+                torch._sparse_adagrad_(weight, state_sum, grad, lr, eps)
+                self.assertEqual(state_sum, expected_sum, prec=1e-5)
+                self.assertEqual(weight, expected_weight, prec=1e-5)
+
+    def test_sparse_adagrad_rowwise(self):
+        lr, eps = 0.1, 1e-10
+        num_rows, dim, nnz = 20, 9, 40
+        weight = torch.randn(num_rows, dim)
+        state_sum = torch.rand(num_rows)
+        grad = self._sparse_row_grad(num_rows, dim, nnz)
+
+        dense_grad = grad.to_dense()
+        touched = grad.coalesce()._indices()[0]
+        expected_sum = state_sum.clone()
+        expected_sum[touched] += (dense_grad[touched] ** 2).mean(1)
+        expected_weight = weight.clone()
+        expected_weight[touched] -= lr * dense_grad[touched] / (expected_sum[touched].unsqueeze(1).sqrt() + eps)
+
+        torch._sparse_adagrad_(weight, state_sum, grad, lr, eps, rowwise=True)
+        self.assertEqual(state_sum, expected_sum, prec=1e-5)
+        self.assertEqual(weight, expected_weight, prec=1e-5)
+
+        with self.assertRaisesRegex(RuntimeError, "one value per row"):
+            torch._sparse_adagrad_(weight, torch.zeros(num_rows, dim), grad, lr, eps, rowwise=True)
+
+    def test_sparse_sgd_(self):
+        lr = 0.1
+        weight = torch.randn(10, 6)
+        grad = self._sparse_row_grad(10, 6, 25)
+        expected = weight - lr * grad.to_dense()
+        torch._sparse_sgd_(weight, grad, lr)
+        self.assertEqual(weight, expected, prec=1e-5)
+
+        with self.assertRaisesRegex(RuntimeError, "out of bounds"):
+            bad_grad = torch._sparse_coo_tensor_unsafe(torch.tensor([[0, 10]]), torch.randn(2, 6), (10, 6))
+            torch._sparse_sgd_(weight, bad_grad, lr)
+
 
 if __name__ == '__main__':
     run_tests()
@@ -67,12 +67,38 @@ class TestThroughputBenchmark(TestCase):
 
         print(stats)
 
-
     def test_script_module(self):
         self.linear_test(TwoLayerNet)
 
     def test_module(self):
         self.linear_test(TwoLayerNetModule)
 
+    def test_open_loop_batching(self):
+        D_in = 10
+        H = 5
+        D_out = 15
+        B = 8
+
+        bench = ThroughputBenchmark(TwoLayerNet(D_in, H, D_out))
+        bench.add_input(torch.randn(B, D_in), torch.randn(B, D_in))
+        stats = bench.benchmark(
+            num_calling_threads=2,
+            num_warmup_iters=10,
+            num_iters=200,
+            target_qps=2000,
+            max_batch_size=4,
+        )
+        print(stats)
+
+        self.assertEqual(stats.num_iters, 200)
+        self.assertEqual(len(stats.latencies_ms), 200)
+        self.assertEqual(len(stats.thread_cpu_time_ms), 2)
+        self.assertLessEqual(stats.latency_p50_ms, stats.latency_p90_ms)
+        self.assertLessEqual(stats.latency_p90_ms, stats.latency_p99_ms)
+        self.assertLessEqual(stats.latency_p99_ms, stats.latency_p999_ms)
+        self.assertLessEqual(stats.latency_p999_ms, max(stats.latencies_ms))
+        # The requests arrive over about 0.1s
+        self.assertGreater(stats.total_time_seconds, 0.05)
+
 if __name__ == '__main__':
     run_tests()
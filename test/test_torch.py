@@ -1048,6 +1048,20 @@ class _TestTorchMixin(object):
         self.assertEqual(y[:, 0], range(100))
         self.assertEqual(y[:, 40], range(4000, 4100))
 
+    def test_copy_transpose_like(self):
+        # sizes that aren't multiples of the register block or the tile
+        for dtype in [torch.uint8, torch.half, torch.float, torch.double, torch.int64, torch.bool]:
+            x = torch.arange(131 * 77).reshape(131, 77).to(dtype)
+            self.assertEqual(x.t().contiguous(), torch.stack([x[:, j] for j in range(77)]))
+            x = torch.arange(2 * 70 * 9 * 11).reshape(2, 70, 9, 11).to(dtype)
+            y = x.contiguous(memory_format=torch.channels_last)
+            self.assertEqual(y, x)
+            self.assertTrue(y.is_contiguous(memory_format=torch.channels_last))
+            self.assertEqual(y.contiguous(), x)
+            z = x.permute(0, 2, 3, 1).contiguous()
+            self.assertEqual(z, x.permute(0, 2, 3, 1))
+            self.assertEqual(z.permute(0, 3, 1, 2).contiguous(), x)
+
     def test_device(self):
         cpu = torch.device('cpu')
         self.assertEqual('cpu', str(cpu))
@@ -1350,6 +1364,9 @@ class _TestTorchMixin(object):
             self.assertIs(default_dtype, torch.tensor(((7, 5), (9, 5.))).dtype)
             self.assertIs(default_dtype, torch.tensor(((5., 5), (3, 5))).dtype)
             self.assertIs(torch.int64, torch.tensor(((5, 3), (3, 5))).dtype)
+            self.assertIs(default_dtype, torch.tensor([1, 2, 3.5]).dtype)
+            self.assertEqual(torch.tensor([1, 2, 3.5]).tolist(), [1., 2., 3.5])
+            self.assertIs(torch.int64, torch.tensor([[1, 2], (3, 4)]).dtype)
 
             if TEST_NUMPY:
                 self.assertIs(torch.float64, torch.tensor(np.array(())).dtype)
@@ -1468,6 +1485,18 @@ class _TestTorchMixin(object):
                 n_astensor[0][0] = 25.7
                 self.assertEqual(torch.tensor(n), n_astensor)
 
+            # objects supporting the buffer protocol don't copy either
+            import array
+            a = array.array('d', [1., 2., 3.])
+            a_astensor = torch.as_tensor(a)
+            self.assertIs(torch.float64, a_astensor.dtype)
+            a_astensor[0] = 5.
+            self.assertEqual(a[0], 5.)
+            self.assertEqual(torch.tensor(memoryview(a)), a_astensor)
+            b = b'\x01\x02'
+            self.assertEqual(torch.as_tensor(b).tolist(), [1, 2])
+            self.assertIs(torch.int64, torch.as_tensor(b).dtype)
+
             # changing dtype causes copy
             n = np.random.rand(5, 6).astype(np.float32)
             n_astensor = torch.as_tensor(n, dtype=torch.float64)
@@ -1932,6 +1961,62 @@ class _TestTorchMixin(object):
         # Make sure True isn't mistakenly taken as the 2nd dimension (interpreted as 1)
         self.assertRaises(TypeError, lambda: q.topk(4, True))
 
+    def _make_long_sort_input(self, n, dtype):
+        if dtype.is_floating_point:
+            x = torch.randn(n, dtype=dtype)
+            x[torch.randint(0, n, (100,))] = float('nan')
+            x[torch.randint(0, n, (100,))] = float('inf')
+            x[torch.randint(0, n, (100,))] = 0
+            return x
+        return torch.randint(0, 100, (n,)).to(dtype)
+
+    @unittest.skipIf(not TEST_NUMPY, "Numpy not found")
+    def test_sort_long_slices(self):
+        # slices this long go through the parallel radix sort
+        n = 100000
+        for dtype in [torch.float, torch.double, torch.long, torch.int, torch.int16, torch.int8, torch.uint8]:
+            x = self._make_long_sort_input(n, dtype)
+            values, indices = x.sort()
+            expected_indices = torch.from_numpy(np.argsort(x.numpy(), kind='stable'))
+            self.assertEqual(indices, expected_indices, 0)
+            self.assertEqual(values, x[expected_indices], 0)
+
+            # NaNs go first when descending
+            values, indices = x.sort(descending=True)
+            self.assertEqual(values, x[expected_indices].flip(0), 0)
+            self.assertEqual(values, x[indices], 0)
+
+            # along an inner dimension, into out= tensors
+            y = x.view(2, -1).t()
+            out_values, out_indices = torch.empty(0, dtype=dtype), torch.LongTensor()
+            torch.sort(y, 0, out=(out_values, out_indices))
+            self.assertEqual(out_values, torch.stack([r.sort()[0] for r in y.t()], 1), 0)
+            self.assertEqual(out_values, y.gather(0, out_indices), 0)
+
+    def test_topk_long_slice(self):
+        n = 100000
+        for dtype in [torch.float, torch.double, torch.long, torch.int8]:
+            x = self._make_long_sort_input(n, dtype)
+            for k in [1, 10, 1000, n // 2, n]:
+                for largest in [True, False]:
+                    values, indices = x.topk(k, largest=largest)
+                    expected = x.sort(descending=largest)[0][:k]
+                    self.assertEqual(values, expected, 0)
+                    self.assertEqual(x[indices], values, 0)
+                    self.assertEqual(indices.unique().numel(), k)
+
+    @unittest.skipIf(not TEST_NUMPY, "Numpy not found")
+    def test_unique_long(self):
+        n = 100000
+        for dtype in [torch.float, torch.long, torch.int8]:
+            x = torch.randint(-50, 50, (n,)).to(dtype).view(100, -1)
+            output, inverse, counts = torch.unique(x, sorted=True, return_inverse=True, return_counts=True)
+            expected_output, expected_inverse, expected_counts = np.unique(
+                x.numpy(), return_inverse=True, return_counts=True)
+            self.assertEqual(output, torch.from_numpy(expected_output), 0)
+            self.assertEqual(inverse, torch.from_numpy(expected_inverse).view(x.shape), 0)
+            self.assertEqual(counts, torch.from_numpy(expected_counts), 0)
+
     def test_median(self):
         for size in (155, 156):
             x = torch.rand(size, size)
@@ -3771,6 +3856,42 @@ class _TestTorchMixin(object):
         g2_normal = q.normal_(generator=g2)
         self.assertEqual(g1_normal, g2_normal)
 
+    def test_generator_cpu_philox_mode(self):
+        g = torch.Generator()
+        self.assertFalse(g.philox_mode())
+        g.set_philox_mode(True)
+        self.assertTrue(g.philox_mode())
+
+        p = torch.rand(100, 100)
+
+        def sample(num_threads):
+            torch.set_num_threads(num_threads)
+            g.manual_seed(1234)
+            return (torch.empty(10000).uniform_(-2, 3, generator=g),
+                    torch.empty(10000, dtype=torch.double).normal_(1, 2, generator=g),
+                    torch.empty(10000).bernoulli_(0.25, generator=g),
+                    torch.empty(100, 100).bernoulli_(p, generator=g),
+                    torch.empty(200, 300).t().uniform_(generator=g))
+
+        num_threads = torch.get_num_threads()
+        try:
+            serial = sample(1)
+            parallel = sample(4)
+        finally:
+            torch.set_num_threads(num_threads)
+        for serial_sample, parallel_sample in zip(serial, parallel):
+            self.assertEqual(serial_sample, parallel_sample, prec=0)
+        uniform, normal, bernoulli, bernoulli_p, strided = serial
+        self.assertTrue(uniform.min() >= -2 and uniform.max() <= 3)
+        self.assertEqual(normal.mean(), 1, prec=0.1)
+        self.assertEqual(normal.std(), 2, prec=0.1)
+        self.assertEqual(bernoulli.mean(), 0.25, prec=0.02)
+        self.assertTrue((bernoulli.eq(0) | bernoulli.eq(1)).all())
+        self.assertTrue((bernoulli_p.eq(0) | bernoulli_p.eq(1)).all())
+        self.assertTrue(strided.min() >= 0 and strided.max() <= 1)
+        # consecutive calls draw different numbers
+        self.assertNotEqual(torch.empty(10000).uniform_(-2, 3, generator=g), uniform)
+
     def test_sobolengine_unscrambled_lowdim(self):
         engine_1d = torch.quasirandom.SobolEngine(1)
         expected_1d = torch.tensor([0.5, 0.75, 0.25, 0.375, 0.875, 0.625, 0.125, 0.1875, 0.6875, 0.9375])
@@ -10157,6 +10278,150 @@ class TestTorchDeviceType(TestCase):
                         self.assertEqual(std1, std2)
                         self.assertEqual(mean1, mean2)
 
+    def test_aminmax(self, device):
+        for dtype in [torch.float, torch.double, torch.long, torch.uint8]:
+            x = torch.randint(0, 100, (30, 40, 5), device=device).to(dtype)
+            for dim in [[], [0], [1, 2], [-1]]:
+                for keepdim in [False, True]:
+                    min1, max1 = torch._aminmax(x, dim=dim, keepdim=keepdim)
+                    dims = dim if dim else list(range(x.dim()))
+                    self.assertEqual(min1, x.min_values(dims, keepdim))
+                    self.assertEqual(max1, x.max_values(dims, keepdim))
+        x = torch.rand(10, 10, device=device)
+        x[3, 4] = nan
+        min1, max1 = torch._aminmax(x, dim=[1])
+        self.assertTrue(torch.isnan(min1[3]) and torch.isnan(max1[3]))
+        self.assertFalse(torch.isnan(min1[:3]).any() or torch.isnan(max1[4:]).any())
+        self.assertRaises(RuntimeError, lambda: torch._aminmax(torch.empty(0, device=device)))
+
+    def test_sum_and_sumsq(self, device):
+        x = torch.randn(100, 30, 20, device=device, dtype=torch.double)
+        for dim in [[], [0], [0, 2], [-1]]:
+            for keepdim in [False, True]:
+                sum1, sumsq1 = torch._sum_and_sumsq(x, dim=dim, keepdim=keepdim)
+                dims = dim if dim else list(range(x.dim()))
+                self.assertEqual(sum1, x.sum(dims, keepdim=keepdim))
+                self.assertEqual(sumsq1, (x * x).sum(dims, keepdim=keepdim))
+        sum1, sumsq1 = torch._sum_and_sumsq(torch.empty(0, 3, device=device), dim=[0])
+        self.assertEqual(sum1, torch.zeros(3, device=device))
+        self.assertEqual(sumsq1, torch.zeros(3, device=device))
+
+        x = torch.randn(5, 4, device=device, dtype=torch.double, requires_grad=True)
+        self.assertTrue(torch.autograd.gradcheck(lambda x: torch._sum_and_sumsq(x, [1]), (x,)))
+        self.assertTrue(torch.autograd.gradcheck(lambda x: torch._aminmax(x, [0]), (x,)))
+
+    def test_segment_reduce(self, device):
+        lengths = torch.tensor([3, 0, 1, 4, 2], device=device)
+        offsets = torch.cat([torch.zeros(1, dtype=torch.long, device=device), lengths.cumsum(0)])
+        data = torch.randn(10, 3, 2, device=device, dtype=torch.double)
+        data[5, 1, 0] = nan
+        for reduce in ['sum', 'mean', 'max']:
+            expected = []
+            for start, length in zip(offsets.tolist(), lengths.tolist()):
+                segment = data[start:start + length]
+                if length == 0:
+                    expected.append(torch.zeros(3, 2, device=device, dtype=torch.double))
+                elif reduce == 'max':
+                    expected.append(segment.max(0)[0])
+                else:
+                    expected.append(getattr(segment, reduce)(0))
+            expected = torch.stack(expected)
+            self.assertEqual(torch.segment_reduce(data, reduce, lengths=lengths), expected)
+            self.assertEqual(torch.segment_reduce(data, reduce, offsets=offsets), expected)
+
+        # the max reduction picks a single row, so keep the entries distinct
+        data = torch.randn(10, 3, 2, device=device, dtype=torch.double, requires_grad=True)
+        for reduce in ['sum', 'mean', 'max']:
+            self.assertTrue(torch.autograd.gradcheck(
+                lambda x: torch.segment_reduce(x, reduce, lengths=lengths), (data,)))
+
+        if self.device_type == 'cpu':
+            with self.assertRaisesRegex(RuntimeError, "cover all"):
+                torch.segment_reduce(data, 'sum', lengths=torch.tensor([3, 4]))
+            with self.assertRaisesRegex(RuntimeError, "non-decreasing"):
+                torch.segment_reduce(data, 'sum', offsets=torch.tensor([0, 5, 4, 10]))
+        with self.assertRaisesRegex(RuntimeError, "unsupported reduction"):
+            torch.segment_reduce(data, 'min', lengths=lengths)
+        with self.assertRaisesRegex(RuntimeError, "exactly one of"):
+            torch.segment_reduce(data, 'sum', lengths=lengths, offsets=offsets)
+
+    def test_block_sparse(self, device):
+        for blocksize in [(4, 4), (8, 1), (1, 1)]:
+            weight = torch.randn(32, 24, device=device, dtype=torch.double)
+            # prune about 80% of the blocks
+            mask = torch.rand(32 // blocksize[0], 24 // blocksize[1], device=device) < 0.2
+            mask = mask.repeat_interleave(blocksize[0], 0).repeat_interleave(blocksize[1], 1)
+            weight = weight * mask.double()
+            crow_indices, col_indices, values = torch.to_block_sparse(weight, blocksize)
+            self.assertEqual(crow_indices.numel(), 32 // blocksize[0] + 1)
+            self.assertEqual(values.size()[1:], blocksize)
+            self.assertEqual(values.size(0), mask[::blocksize[0], ::blocksize[1]].sum().item())
+
+            dense = torch.randn(24, 13, device=device, dtype=torch.double)
+            self.assertEqual(torch.block_sparse_mm(crow_indices, col_indices, values, dense), weight.mm(dense))
+            self.assertEqual(torch.block_sparse_mm(crow_indices, col_indices, values, dense.t().contiguous().t()),
+                             weight.mm(dense))
+
+            input = torch.randn(2, 5, 24, device=device, dtype=torch.double)
+            bias = torch.randn(32, device=device, dtype=torch.double)
+            self.assertEqual(torch.block_sparse_linear(input, crow_indices, col_indices, values, bias),
+                             torch.nn.functional.linear(input, weight, bias))
+            self.assertEqual(torch.block_sparse_linear(input, crow_indices, col_indices, values),
+                             torch.nn.functional.linear(input, weight))
+
+        @torch.jit.script
+        def scripted(input, crow_indices, col_indices, values, bias):
+            # type: (Tensor, Tensor, Tensor, Tensor, Optional[Tensor]) -> Tensor
+            return torch.block_sparse_linear(input, crow_indices, col_indices, values, bias)
+
+        self.assertEqual(scripted(input, crow_indices, col_indices, values, bias),
+                         torch.nn.functional.linear(input, weight, bias))
+
+        empty = torch.zeros(8, 8, device=device, dtype=torch.double)
+        bsr = torch.to_block_sparse(empty, (4, 4))
+        self.assertEqual(bsr[0].tolist(), [0, 0, 0])
+        self.assertEqual(torch.block_sparse_mm(*bsr, torch.randn(8, 3, device=device, dtype=torch.double)),
+                         torch.zeros(8, 3, device=device, dtype=torch.double))
+
+        with self.assertRaisesRegex(RuntimeError, "multiples of the blocksize"):
+            torch.to_block_sparse(weight, (5, 4))
+        if self.device_type == 'cpu':
+            with self.assertRaisesRegex(RuntimeError, "out of bounds"):
+                torch.block_sparse_mm(torch.tensor([0, 1]), torch.tensor([3]), torch.randn(1, 2, 2, dtype=torch.double),
+                                      torch.randn(4, 3, dtype=torch.double))
+
+    @onlyCPU
+    def test_bfloat16_ops(self, device):
+        # sizes that are not multiples of the vector width exercise the tails
+        x = torch.randn(3, 37, device=device).bfloat16()
+        y = torch.randn(3, 37, device=device).bfloat16()
+        positive = x.abs() + 0.5
+
+        def check(op, *args):
+            # each bfloat16 result is the float result rounded to bfloat16
+            expected = op(*[a.float() for a in args]).bfloat16()
+            actual = op(*args)
+            self.assertEqual(actual.dtype, torch.bfloat16)
+            self.assertEqual(actual.float(), expected.float(), prec=1e-2)
+
+        for op in [torch.add, torch.sub, torch.mul, torch.div]:
+            check(op, x, y)
+        for op in [torch.relu, torch.sigmoid, torch.tanh, torch.exp, torch.sin, torch.cos, torch.neg,
+                   torch.floor, torch.ceil, torch.round, torch.trunc, torch.erf, torch.expm1]:
+            check(op, x)
+        for op in [torch.log, torch.log1p, torch.log2, torch.sqrt, torch.rsqrt, torch.reciprocal]:
+            check(op, positive)
+
+        # a bfloat16 running sum of ones would stop at 256
+        ones = torch.ones(10000, device=device, dtype=torch.bfloat16)
+        self.assertEqual(ones.sum().item(), 10000, prec=100)
+        self.assertEqual(ones.mean().item(), 1)
+        ones = torch.ones(2, 10000, device=device, dtype=torch.bfloat16)
+        self.assertEqual(ones.sum(1).float(), torch.full((2,), 10000, device=device), prec=100)
+        self.assertEqual(ones.t().sum(0).float(), torch.full((2,), 10000, device=device), prec=100)
+        check(lambda x: x.sum(1), x)
+        check(lambda x: x.mean(0), x)
+
     def test_zeros_like(self, device):
         expected = torch.zeros((100, 100,), device=device)
 
@@ -10364,6 +10629,47 @@ class TestTorchDeviceType(TestCase):
             y = x.clone()
             self.assertEqual(x, y)
 
+    def test_clone_copy_on_write(self, device):
+        old_state = torch._C._get_copy_on_write_clone()
+        torch._C._set_copy_on_write_clone(True)
+        try:
+            x = torch.randn(4, 5, device=device)
+            x_ref = x.clone().detach()
+            y = x.clone()
+            self.assertEqual(x.data_ptr(), y.data_ptr())
+            # writing either one gives it its own data
+            y.add_(1)
+            self.assertNotEqual(x.data_ptr(), y.data_ptr())
+            self.assertEqual(x, x_ref)
+            self.assertEqual(y, x_ref + 1)
+
+            z = x.clone()
+            x[0] = 0
+            self.assertEqual(z, x_ref)
+            self.assertEqual(x[1:], x_ref[1:])
+            torch.mul(z, 2, out=z)
+            self.assertEqual(z, x_ref * 2)
+
+            # the last one holding the data takes it back without a copy
+            v = torch.arange(3., device=device)
+            u = v.clone()
+            u_ptr = u.data_ptr()
+            del v
+            u.zero_()
+            self.assertEqual(u.data_ptr(), u_ptr)
+            self.assertEqual(u, torch.zeros(3, device=device))
+
+            # clones of views are copies
+            s = x[1:]
+            self.assertNotEqual(s.clone().data_ptr(), s.data_ptr())
+
+            # gradients flow through lazy clones
+            a = torch.randn(3, device=device, requires_grad=True)
+            a.clone().sum().backward()
+            self.assertEqual(a.grad, torch.ones(3, device=device))
+        finally:
+            torch._C._set_copy_on_write_clone(old_state)
+
     def test_cat_all_dtypes_and_devices(self, device):
         for dt in torch.testing.get_all_dtypes():
             x = torch.tensor([[1, 2], [3, 4]], dtype=dt, device=device)
@@ -10627,6 +10933,126 @@ class TestTorchDeviceType(TestCase):
         dest = torch.index_select(src, 0, idx)
         self.assertEqual(torch.tensor([True]), dest)
 
+    def test_index_select_index_patterns(self, device):
+        for dtype in [torch.float, torch.double, torch.int8, torch.int16, torch.bool]:
+            src = torch.randint(0, 2, (50, 6, 7), device=device).to(dtype)
+            for dim in range(3):
+                size = src.size(dim)
+                perm = torch.randperm(size, device=device)
+                patterns = [
+                    torch.arange(size, device=device),  # sorted
+                    torch.arange(size, device=device).repeat_interleave(2),  # duplicated
+                    torch.cat([perm[:size // 2].sort()[0], perm[size // 2:]]),  # partly clustered
+                    torch.randint(0, size, (3 * size,), device=device),  # random
+                    torch.tensor(size - 1, device=device),  # 0-dim
+                ]
+                for idx in patterns:
+                    expected = src[(slice(None),) * dim + (idx.view(-1),)]
+                    self.assertEqual(src.index_select(dim, idx), expected)
+                    out = torch.empty(0, dtype=dtype, device=device)
+                    torch.index_select(src, dim, idx, out=out)
+                    self.assertEqual(out, expected)
+        # size 1 dimensions, whose strides are arbitrary
+        src = torch.randn(4, 1, 3, device=device).transpose(0, 1).contiguous().transpose(0, 1)
+        idx = torch.tensor([2, 0, 2], device=device)
+        self.assertEqual(src.index_select(2, idx), src[:, :, idx])
+        self.assertEqual(torch.randn(0, 3, device=device).index_select(1, idx).shape, (0, 3))
+        if device == 'cpu':
+            with self.assertRaisesRegex(RuntimeError, "index out of range"):
+                src.index_select(2, torch.tensor([3]))
+            with self.assertRaisesRegex(RuntimeError, "index out of range"):
+                src.index_select(0, torch.tensor([-1]))
+
+    def test_gather_index_patterns(self, device):
+        src = torch.randn(30, 40, 50, device=device)
+        for dim in range(3):
+            index_shape = [30, 40, 50]
+            index_shape[dim] = 60
+            index = torch.randint(0, src.size(dim), index_shape, device=device)
+            if dim == 1:
+                # sorted along dim
+                index = index.sort(dim)[0]
+            for idx in [index, index.transpose(0, 2).contiguous().transpose(0, 2)]:
+                grids = [torch.arange(s, device=device).view([-1 if i == d else 1 for i in range(3)])
+                         for d, s in enumerate(idx.shape)]
+                grids[dim] = idx
+                expected = src[grids]
+                self.assertEqual(src.gather(dim, idx), expected)
+                out = torch.empty(0, device=device)
+                torch.gather(src, dim, idx, out=out)
+                self.assertEqual(out, expected)
+        self.assertEqual(src.gather(1, torch.empty(30, 0, 50, dtype=torch.long, device=device)).shape, (30, 0, 50))
+        if device == 'cpu':
+            with self.assertRaisesRegex(RuntimeError, "Invalid index in gather"):
+                src.gather(0, torch.full((1, 40, 50), 30, dtype=torch.long))
+            with self.assertRaisesRegex(RuntimeError, "same size apart from dimension"):
+                src.gather(0, torch.zeros(1, 39, 50, dtype=torch.long))
+
+    def test_foreach_pointwise_ops(self, device):
+        # includes empty tensors and sizes that span several chunks of the
+        # parallel loop and of the CUDA launches
+        sizes = [0, 1, 7, 100, 65537] + [3] * 120
+        for dtype in [torch.float, torch.double, torch.int, torch.long]:
+            make = ((lambda n: torch.randn(n, device=device, dtype=dtype)) if dtype.is_floating_point
+                    else (lambda n: torch.randint(-10, 10, (n,), device=device, dtype=dtype)))
+            a = [make(n) for n in sizes]
+            b = [make(n) for n in sizes]
+            for op, foreach_op, foreach_op_ in [(torch.add, torch._foreach_add, torch._foreach_add_),
+                                                (torch.mul, torch._foreach_mul, torch._foreach_mul_)]:
+                out = foreach_op(a, 3)
+                self.assertEqual(out, [op(x, 3) for x in a])
+                out = foreach_op(a, b)
+                self.assertEqual(out, [op(x, y) for x, y in zip(a, b)])
+                copies = [x.clone() for x in a]
+                versions = [x._version for x in copies]
+                foreach_op_(copies, b)
+                self.assertEqual(copies, [op(x, y) for x, y in zip(a, b)])
+                self.assertEqual([x._version for x in copies], [v + 1 for v in versions])
+            self.assertEqual(torch._foreach_add(a, b, alpha=2), [torch.add(x, y, alpha=2) for x, y in zip(a, b)])
+
+        # lists the kernels can't take run one op per tensor
+        a = [torch.randn(4, 5, device=device), torch.randn(5, 4, device=device).t(), torch.randn(3, device=device)]
+        b = [torch.randn(4, 5, device=device), torch.randn(4, 5, device=device),
+             torch.randn(3, device=device, dtype=torch.double)]
+        self.assertEqual(torch._foreach_add(a, b), [x + y for x, y in zip(a, b)])
+        self.assertEqual(torch._foreach_mul(a, 2.5), [x * 2.5 for x in a])
+        ints = [torch.arange(4, device=device), torch.arange(3, device=device)]
+        out = torch._foreach_add(ints, 0.5)
+        self.assertEqual(out, [x + 0.5 for x in ints])
+        self.assertEqual(out[0].dtype, torch.get_default_dtype())
+        self.assertEqual(torch._foreach_mul([], 2), [])
+
+        with self.assertRaisesRegex(RuntimeError, "same length"):
+            torch._foreach_add(a, b[:2])
+
+    def test_foreach_norm_and_scale(self, device):
+        sizes = [0, 1, 7, 100, 65537] + [3] * 120
+        for dtype in [torch.float, torch.double]:
+            tensors = [torch.randn(n, device=device, dtype=dtype) for n in sizes]
+            flat = torch.cat(tensors)
+            for ord in [2, 1, 3.5, inf]:
+                norm = torch._foreach_norm(tensors, ord)
+                self.assertEqual(norm.dim(), 0)
+                self.assertEqual(norm.dtype, dtype)
+                self.assertEqual(norm, flat.norm(ord))
+
+            scale = torch.tensor(0.25, device=device, dtype=dtype)
+            expected = [t * 0.25 for t in tensors]
+            versions = [t._version for t in tensors]
+            torch._foreach_mul_(tensors, scale)
+            self.assertEqual(tensors, expected)
+            self.assertEqual([t._version for t in tensors], [v + 1 for v in versions])
+
+        # lists the kernels can't take run one op per tensor
+        tensors = [torch.randn(4, 5, device=device).t(), torch.randn(3, device=device, dtype=torch.double)]
+        self.assertEqual(torch._foreach_norm(tensors).item(),
+                         torch.cat([t.reshape(-1).double() for t in tensors]).norm().item())
+        expected = [t * 2 for t in tensors]
+        torch._foreach_mul_(tensors, torch.tensor(2.))
+        self.assertEqual(tensors, expected)
+        with self.assertRaisesRegex(RuntimeError, "non-empty"):
+            torch._foreach_norm([])
+
     def test_take_empty(self, device):
         for input_shape in [(0,), (0, 1, 2, 0), (1, 2, 3)]:
             for indices_shape in [(0,), (0, 1, 2, 0)]:
@@ -10679,6 +11105,57 @@ class TestTorchDeviceType(TestCase):
                                             [False, True, False, True, False],
                                             [True, False, True, False, True]], device=device))
 
+    def test_index_put_accumulate_duplicate_rows(self, device):
+        # large enough for the parallel CPU kernel
+        for row_size, dtype in [(64, torch.float), (1, torch.double), (16, torch.long)]:
+            num_rows = 50
+            index = torch.randint(-num_rows, num_rows, (4096,), device=device)
+            values = torch.randn(4096, row_size, device=device).mul(8).to(dtype)
+            expected = torch.zeros(num_rows, row_size, dtype=torch.double, device=device)
+            for i, row in enumerate(index.tolist()):
+                expected[row] += values[i].double()
+            result = torch.zeros(num_rows, row_size, dtype=dtype, device=device)
+            result.index_put_((index,), values, accumulate=True)
+            self.assertEqual(result.double(), expected, prec=1e-3)
+            # deterministic
+            again = torch.zeros(num_rows, row_size, dtype=dtype, device=device)
+            again.index_put_((index,), values, accumulate=True)
+            self.assertEqual((result != again).sum().item(), 0)
+
+        # broadcast values
+        result = torch.zeros(10, 3, device=device)
+        index = torch.tensor([1, 1, -1, 3], device=device)
+        result.index_put_((index,), torch.tensor([1., 2., 3.], device=device), accumulate=True)
+        expected = torch.zeros(10, 3, device=device)
+        expected[1] = torch.tensor([2., 4., 6.])
+        expected[3] = expected[9] = torch.tensor([1., 2., 3.])
+        self.assertEqual(result, expected)
+        if device == 'cpu':
+            with self.assertRaisesRegex(IndexError, "out of bounds"):
+                result.index_put_((torch.tensor([10]),), torch.ones(3), accumulate=True)
+
+    def test_scatter_add_duplicate_indices(self, device):
+        for dim in range(3):
+            src = torch.randn(20, 30, 40, device=device)
+            index_shape = [20, 30, 40]
+            index_shape[dim] = 10
+            index = torch.randint(0, 5, index_shape, device=device)
+            self_shape = [20, 30, 40]
+            self_shape[dim] = 5
+            result = torch.zeros(self_shape, device=device).scatter_add_(dim, index, src)
+            src_used = src.narrow(dim, 0, 10)
+            expected = torch.stack([src_used.masked_fill(index != k, 0).sum(dim) for k in range(5)], dim)
+            self.assertEqual(result, expected, prec=1e-4)
+        # non-contiguous and out of range indices
+        result = torch.zeros(6, 4, device=device).t()
+        index = torch.tensor([[0, 5], [5, 0]], device=device)
+        result.scatter_add_(1, index, torch.ones(2, 2, device=device))
+        self.assertEqual(result[:2, 0], torch.tensor([1., 1.]))
+        self.assertEqual(result[:2, 5], torch.tensor([1., 1.]))
+        if device == 'cpu':
+            with self.assertRaisesRegex(RuntimeError, "Invalid index"):
+                result.scatter_add_(1, torch.tensor([[6]]), torch.ones(1, 1))
+
     def test_masked_scatter_bool_tensor(self, device):
         src = torch.tensor([True, True, True], device=device)
         dst = torch.tensor([False, False, False], device=device)
@@ -12336,6 +12813,40 @@ class TestTorchDeviceType(TestCase):
             self.assertAlmostEqual(a[0].item(), 0.47693627620447, places=13)
             self.assertAlmostEqual(a[1].item(), 0.90619380243682, places=13)
 
+    @onlyCPU
+    @dtypes(torch.float, torch.double)
+    def test_vectorized_special_functions(self, device, dtype):
+        # Contiguous inputs go through the vectorized kernels and strided ones
+        # through the scalar loop; both have to agree.
+        x = torch.empty(2, 1027, dtype=dtype, device=device)
+        x[0].uniform_(0.001, 40)
+        x[1].normal_(0, 10)
+        u = torch.empty(2, 1027, dtype=dtype, device=device).uniform_(-1.1, 1.1)
+        u[0, :4] = torch.tensor([-1, 1, 0, -0.0])
+        rtol = 1e-5 if dtype == torch.float else 1e-12
+        for fn, inp in [(torch.digamma, x), (lambda t: torch.polygamma(1, t), x),
+                        (torch.erfinv, u), (torch.sinh, x / 4), (torch.cosh, x / 4)]:
+            strided = inp.t().contiguous().t()
+            self.assertFalse(strided.is_contiguous())
+            self.assertTrue(torch.allclose(fn(inp), fn(strided), rtol=rtol, atol=0, equal_nan=True))
+
+    @onlyCPU
+    def test_cpu_fast_math(self, device):
+        x = torch.randn(1030, device=device) * 10
+        u = torch.rand(1030, device=device) * 2 - 1
+        ops = [(torch.exp, x), (torch.tanh, x), (torch.sigmoid, x), (torch.erfinv, u)]
+        expected = [op(inp) for op, inp in ops]
+        expected_double = x.double().exp()
+        self.assertFalse(torch.backends.cpu.fast_math)
+        with torch.backends.cpu.flags(fast_math=True):
+            self.assertTrue(torch.backends.cpu.fast_math)
+            actual = [op(inp) for op, inp in ops]
+            # only float tensors are affected
+            self.assertTrue(torch.equal(x.double().exp(), expected_double))
+        self.assertFalse(torch.backends.cpu.fast_math)
+        for a, e in zip(actual, expected):
+            self.assertTrue(torch.allclose(a, e, rtol=1e-6, atol=1e-6))
+
     @unittest.skipIf(not TEST_NUMPY, "Numpy not found")
     def test_ctor_with_numpy_array(self, device):
         correct_dtypes = [
@@ -13503,6 +14014,24 @@ class TestTorchDeviceType(TestCase):
         res6 = torch.baddbmm(.1, res2, .5, b1, b2)
         self.assertEqual(res6, res2 * .1 + res * .5)
 
+    @onlyCPU
+    @dtypes(torch.float, torch.double)
+    def test_bmm_small_matrices(self, device, dtype):
+        # covers the register blocked kernel, including row and column tails
+        # and a transposed batch1, for both bmm and baddbmm
+        for num_batches, M, N, O in [(1000, 16, 64, 16), (64, 5, 3, 7), (37, 33, 17, 31), (8, 64, 64, 64)]:
+            b1 = torch.randn(num_batches, M, N, dtype=dtype, device=device)
+            b1_t = torch.randn(num_batches, N, M, dtype=dtype, device=device).transpose(1, 2)
+            b2 = torch.randn(num_batches, N, O, dtype=dtype, device=device)
+            c = torch.randn(num_batches, M, O, dtype=dtype, device=device)
+            for a in (b1, b1_t):
+                expected = torch.stack([torch.mm(a[i], b2[i]) for i in range(num_batches)])
+                self.assertEqual(torch.bmm(a, b2), expected)
+                self.assertEqual(torch.baddbmm(c, a, b2, beta=0.5, alpha=2), c * 0.5 + expected * 2)
+            # like BLAS, self is ignored when beta is zero
+            nan = torch.full_like(c, float('nan'))
+            self.assertEqual(torch.baddbmm(nan, b1, b2, beta=0), torch.bmm(b1, b2))
+
     def _test_cop(self, torchfn, mathfn, dtype, device):
         def reference_implementation(res2):
             for i, j in iter_indices(sm1):
@@ -13651,6 +14180,44 @@ class TestTorchDeviceType(TestCase):
         z = torch.randn(2, 2, 1, device=device)
         self.assertRaises(RuntimeError, lambda: torch.cat([x, y, z], dim=1))
 
+    @onlyCPU
+    def test_cat_channels_last(self, device):
+        x = torch.randn(4, 3, 8, 8, device=device).contiguous(memory_format=torch.channels_last)
+        y = torch.randn(4, 5, 8, 8, device=device).contiguous(memory_format=torch.channels_last)
+        for dim in range(4):
+            other = y if dim == 1 else x
+            res = torch.cat((x, other), dim)
+            self.assertTrue(res.is_contiguous(memory_format=torch.channels_last))
+            self.assertEqual(res, torch.cat((x.contiguous(), other.contiguous()), dim))
+
+        # Mixed memory formats take the general path
+        res = torch.cat((x, y.contiguous()), 1)
+        self.assertEqual(res.narrow(1, 0, 3), x)
+        self.assertEqual(res.narrow(1, 3, 5), y)
+
+    @onlyCPU
+    def test_cat_out(self, device):
+        inputs = [torch.randn(16, i + 1, device=device) for i in range(100)]
+        expected = torch.cat([t.contiguous() for t in inputs], 1)
+        out = torch.empty(16, 5050, device=device)
+        data_ptr = out.data_ptr()
+        torch.cat(inputs, 1, out=out)
+        self.assertEqual(out, expected)
+        self.assertEqual(out.data_ptr(), data_ptr)
+
+        # A non-contiguous out is written to in place too
+        out = torch.empty(5050, 16, device=device).t()
+        torch.cat(inputs, 1, out=out)
+        self.assertEqual(out, expected)
+
+        # A wrong size out is resized
+        out = torch.empty(0, device=device)
+        torch.cat(inputs, 1, out=out)
+        self.assertEqual(out, expected)
+
+        with self.assertRaisesRegex(RuntimeError, 'scalar type'):
+            torch.cat(inputs, 1, out=torch.empty(0, dtype=torch.double, device=device))
+
     @slowTest
     @onlyCPU
     def test_cat_big(self, device):
@@ -221,6 +221,15 @@ grad_fn = std::shared_ptr<${op}>(new ${op}(${op_ctor}), deleteNode);
 grad_fn->set_next_edges(collect_next_edges( ${args_with_derivatives} ));
 """)
 
+# See Note [Static graphs]
+REUSE_OR_ASSIGN_GRAD_FN = CodeTemplate("""\
+grad_fn = reuse_static_node<${op}>( ${args_with_derivatives} );
+if (!grad_fn) {
+  ${assign_grad_fn}
+  record_static_node(grad_fn);
+}
+""")
+
 CALL_DEFAULT = CodeTemplate("""\
 TypeDefault::${api_name}(${type_method_args})""")
 
@@ -565,6 +574,10 @@ def emit_body(declaration):
     is_out_fn = name.endswith('_out')
     modifies_arguments = inplace or is_out_fn
     returns_void = len(returns) == 0
+    # The in-place ops over lists, e.g. _foreach_add_, return nothing and
+    # write every tensor of self
+    inplace_tensor_lists = [arg for arg in arguments
+                            if inplace and arg['name'] == 'self' and arg['dynamic_type'] == 'TensorList']
 
     base_name = name[:-1] if inplace else name[:-4] if is_out_fn else name
     view_info = VIEW_FUNCTIONS.get(base_name, None)
@@ -696,7 +709,12 @@ def emit_body(declaration):
             return body
 
         setup = []
-        setup.extend(ASSIGN_GRAD_FN.substitute(env).split('\n'))
+        if func is not None:
+            # NotImplemented nodes differ by name, so they are not reused
+            assign_grad_fn = ASSIGN_GRAD_FN.substitute(env).rstrip('\n').split('\n')
+            setup.extend(REUSE_OR_ASSIGN_GRAD_FN.substitute(env, assign_grad_fn=assign_grad_fn).split('\n'))
+        else:
+            setup.extend(ASSIGN_GRAD_FN.substitute(env).split('\n'))
         setup.extend(emit_save_inputs())
 
         body = []
@@ -742,6 +760,8 @@ def emit_body(declaration):
                 else:
                     expr = 'SavedVariable({}, {})'.format(var, str(is_output).lower())
             elif arg['type'] == 'TensorList':
+                # A node reused by a StaticGraph may have released the list
+                stmts.append('grad_fn->{}_released_ = false;'.format(name))
                 name += '_'
                 expr = 'make_saved_variable_list({})'.format(arg['name'])
             elif arg['type'] == 'IntArrayRef':
@@ -778,10 +798,10 @@ def emit_body(declaration):
             if not isinstance(view_info, dict):
                 if len(differentiable_output_vars) == len(tensor_output_vars):
                     # all outputs are differentiable
-                    return 'as_view({}, {}, true)'.format(view_info, call), []
+                    return 'as_view({}, std::move({}), true)'.format(view_info, call), []
                 elif len(differentiable_output_vars) == 0:
                     # no output is differentiable
-                    return 'as_view({}, {}, false)'.format(view_info, call), []
+                    return 'as_view({}, std::move({}), false)'.format(view_info, call), []
                 else:
                     # some of the outputs are differentiable
                     # need to expand to dict mode, i.e., one entry per output
@@ -794,7 +814,7 @@ def emit_body(declaration):
                 view_info_dict = view_info
 
             def wrap_view_single(output_var, base_var):
-                fmt = '{output_var} = as_view({base_var}, {output_var}, {is_differentiable});'
+                fmt = '{output_var} = as_view({base_var}, std::move({output_var}), {is_differentiable});'
                 if output_var in differentiable_output_vars:
                     # If `GradMode::is_enabled()` is False, this is a
                     # non-differentiable view. Gradients should not flow through.
@@ -873,6 +893,10 @@ def emit_body(declaration):
             call = call + ';'
         for stmt in extra_wrapping_stmts:
             call += '\n' + stmt
+        if name == 'clone':
+            # Only the clones asked for here, above the kernels, may be lazy,
+            # see Note [Copy-on-write storages] in c10/core/impl/COW.h
+            call = 'c10::impl::cow::LazyCloneRequest lazy_clone_request;\n' + call
         call = enforce_same_tensorimpl_and_storage(env, call)
         return call
 
@@ -917,6 +941,16 @@ def emit_body(declaration):
             return CONDITIONAL.substitute(cond='grad_fn', statements=stmts)
         return ''
 
+    def emit_materialize_cow():
+        # Not only for differentiable functions, since any write into a
+        # copy-on-write storage must materialize it first
+        if not modifies_arguments:
+            return []
+        return (['materialize_cow({});'.format(ret['name'])
+                 for ret in declaration['returns'] if ret['dynamic_type'] == 'Tensor'] +
+                ['for (const auto& t : {}) materialize_cow(t);'.format(arg['name'])
+                 for arg in inplace_tensor_lists])
+
     def emit_check_inplace():
         if not inplace:
             return []
@@ -927,6 +961,10 @@ def emit_body(declaration):
             return []
         return ['increment_version({});'.format(arg['name']) for arg in differentiable_outputs]
 
+    def emit_increment_list_versions():
+        return ['for (const auto& t : {}) increment_version(t);'.format(arg['name'])
+                for arg in inplace_tensor_lists]
+
     def check_record_function_input_type(simple_type):
         return simple_type in ['Tensor', 'Scalar']
 
@@ -945,6 +983,7 @@ def emit_body(declaration):
             RECORD_FUNCTION.substitute(combined, input_names=input_names))
     if strategy != 'use_type':
         body.extend(unpack_args(env, declaration))
+    body.extend(emit_materialize_cow())
     if requires_derivative:
         body.extend(emit_check_inplace())
         body.extend(setup_derivative(differentiable_inputs))
@@ -959,6 +998,7 @@ def emit_body(declaration):
         # requires that the counter is incremented before it is called
         body.extend(emit_increment_version())
         body.append(emit_history())
+    body.extend(emit_increment_list_versions())
     # post_record_trace must appear before save_outputs so that saved outputs
     # have their tracing state saved (that is setup by recordTrace)
     body.append(post_record_trace)
@@ -712,6 +712,29 @@ Tensor var_std_mean_backward(const variable_list& grads, const Tensor & self, co
   return grad;
 }
 
+Tensor aminmax_backward(const variable_list& grads, const Tensor & self, const Tensor & min, const Tensor & max, IntArrayRef dim, bool keepdim) {
+  Tensor grad;
+  for (size_t i = 0; i < 2; i++) {
+    if (!grads[i].defined()) continue;
+    auto value = sum_backward(i == 0 ? min : max, self.sizes(), dim, keepdim);
+    auto value_grad = sum_backward(grads[i], self.sizes(), dim, keepdim) * (self == value).type_as(grads[i]);
+    grad = grad.defined() ? grad + value_grad : value_grad;
+  }
+  return grad;
+}
+
+Tensor sum_and_sumsq_backward(const variable_list& grads, const Tensor & self, IntArrayRef dim, bool keepdim) {
+  Tensor grad;
+  if (grads[0].defined()) {
+    grad = sum_backward(grads[0], self.sizes(), dim, keepdim);
+  }
+  if (grads[1].defined()) {
+    Tensor sumsq_grad = 2 * self * sum_backward(grads[1], self.sizes(), dim, keepdim);
+    grad = grads[0].defined() ? grad + sumsq_grad : sumsq_grad;
+  }
+  return grad;
+}
+
 Tensor masked_scatter_backward(const Tensor & grad, const Tensor & mask, IntArrayRef sizes) {
   int64_t numel = 1;
   for (auto size : sizes) {
@@ -2422,6 +2445,46 @@ infinitely_differentiable_native_layer_norm_backward(
   return std::make_tuple(dX, dgamma, dbeta);
 }
 
+// The sum is both an output and the input of the layer norm, so its gradient
+// is dsum plus the gradient flowing back through the layer norm.
+std::tuple<Tensor, Tensor, Tensor, Tensor> add_layer_norm_backward(
+    const Tensor& dY,
+    const Tensor& dsum,
+    const Tensor& dmean,
+    const Tensor& drstd,
+    const Tensor& sum,
+    const Tensor& mean,
+    const Tensor& rstd,
+    const Tensor& gamma,
+    int64_t M,
+    int64_t N,
+    double eps,
+    std::array<bool, 4> grad_input_mask) {
+  Tensor dX;
+  Tensor dgamma;
+  Tensor dbeta;
+  const std::array<bool, 3> layer_norm_mask = {
+      grad_input_mask[0] || grad_input_mask[1],
+      grad_input_mask[2],
+      grad_input_mask[3]};
+  if (GradMode::is_enabled() || dmean.defined() || drstd.defined()) {
+    std::tie(dX, dgamma, dbeta) =
+        infinitely_differentiable_native_layer_norm_backward(
+            dY, dmean, drstd, sum, mean, rstd, gamma, M, N, eps, layer_norm_mask);
+  } else if (dY.defined()) {
+    std::tie(dX, dgamma, dbeta) = at::native_layer_norm_backward(
+        dY.is_contiguous() ? dY : dY.contiguous(), sum, mean, rstd, gamma, M, N, layer_norm_mask);
+  }
+  if (dsum.defined()) {
+    dX = dX.defined() ? dX + dsum : dsum;
+  }
+  return std::make_tuple(
+      grad_input_mask[0] ? dX : Tensor(),
+      grad_input_mask[1] ? dX : Tensor(),
+      dgamma,
+      dbeta);
+}
+
 std::tuple<Tensor, Tensor, Tensor> _trilinear_backward(const Tensor& grad_out, const Tensor& i1, const Tensor& i2, const Tensor& i3,
                                                        IntArrayRef expand1, IntArrayRef expand2, IntArrayRef expand3,
                                                        IntArrayRef sumdim, int64_t unroll_dim, std::array<bool, 3> grad_mask) {
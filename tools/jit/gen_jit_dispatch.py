@@ -272,6 +272,7 @@ def load_op_list(path):
 
 def gen_jit_dispatch(declarations, out, template_path, disable_autograd=False, selected_op_list_path=None):
     REGISTER_ATEN_OPS_CPP = CodeTemplate.from_file(template_path + '/register_aten_ops.cpp')
+    SELECTED_MOBILE_OPS_H = CodeTemplate.from_file(template_path + '/selected_mobile_ops.h')
 
     ops = []
 
@@ -471,6 +472,14 @@ def gen_jit_dispatch(declarations, out, template_path, disable_autograd=False, s
         }
         write(out, 'register_aten_ops_%d.cpp' % i, REGISTER_ATEN_OPS_CPP, env)
 
+    # The lite interpreter selects its operators at compile time, from the
+    # same list
+    env = {
+        'selective_build': 1 if selected_op_list is not None else 0,
+        'selected_ops': ' '.join('"{}",'.format(op) for op in sorted(selected_op_list or [])),
+    }
+    write(out, 'selected_mobile_ops.h', SELECTED_MOBILE_OPS_H, env)
+
 
 default_map = {'{}': 'None', 'nullptr': 'None', 'c10::nullopt': 'None'}
 
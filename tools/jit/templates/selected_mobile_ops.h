@@ -0,0 +1,11 @@
+#pragma once
+
+// ${generated_comment}
+
+// The operators of the lite interpreter included in this build, see
+// torch/csrc/jit/mobile/register_mobile_ops.h. Each entry of
+// TORCH_SELECTED_MOBILE_OPS is followed by a comma.
+
+#define TORCH_MOBILE_SELECTIVE_BUILD ${selective_build}
+
+#define TORCH_SELECTED_MOBILE_OPS ${selected_ops}
@@ -791,6 +791,67 @@ Example:
     tensor([ 0,  1, -4], dtype=torch.int8)
 """.format(**common_args))
 
+add_docstr(torch.block_sparse_linear,
+           r"""
+block_sparse_linear(input, crow_indices, col_indices, values, bias=None) -> Tensor
+
+Applies a linear transformation :math:`y = xA^T + b` to :attr:`input`, with a
+block sparse weight :math:`A` of ``(out_features, in_features)`` given by the
+:attr:`crow_indices`, :attr:`col_indices` and :attr:`values` returned by
+:func:`torch.to_block_sparse`. See :func:`torch.block_sparse_mm`.
+
+This is only supported for inference, it does not compute gradients.
+
+Args:
+    input (Tensor): the input of ``(*, in_features)``
+    crow_indices (LongTensor): the block row offsets of the weight
+    col_indices (LongTensor): the block columns of the blocks of the weight
+    values (Tensor): the blocks of the weight
+    bias (Tensor, optional): the bias of ``(out_features)``
+
+Example::
+
+    >>> weight = torch.randn(8, 4)
+    >>> weight[:4, 2:] = 0
+    >>> bsr = torch.to_block_sparse(weight, (4, 2))
+    >>> input = torch.randn(3, 4)
+    >>> torch.block_sparse_linear(input, *bsr).size()
+    torch.Size([3, 8])
+""")
+
+add_docstr(torch.block_sparse_mm,
+           r"""
+block_sparse_mm(crow_indices, col_indices, values, dense) -> Tensor
+
+Performs a matrix multiplication of a block sparse row (BSR) matrix, given by
+the :attr:`crow_indices`, :attr:`col_indices` and :attr:`values` returned by
+:func:`torch.to_block_sparse`, with the matrix :attr:`dense`.
+
+If :attr:`values` has blocks of :math:`(r \times c)` and :attr:`crow_indices`
+has :math:`m + 1` entries, the sparse matrix is :math:`(mr \times k)` and
+:attr:`dense` a :math:`(k \times p)` tensor, with :math:`k` a multiple of
+:math:`c`. The result is a :math:`(mr \times p)` tensor. Only the stored blocks
+are multiplied, so the cost is proportional to their number, unlike the one of
+multiplying the dense matrix with :func:`torch.mm`.
+
+This is only supported for inference, it does not compute gradients.
+
+Args:
+    crow_indices (LongTensor): the block row offsets of the sparse matrix
+    col_indices (LongTensor): the block columns of its blocks
+    values (Tensor): its blocks
+    dense (Tensor): the dense matrix to be multiplied
+
+Example::
+
+    >>> mat = torch.randn(4, 6)
+    >>> mat[2:, :4] = 0
+    >>> crow_indices, col_indices, values = torch.to_block_sparse(mat, (2, 2))
+    >>> dense = torch.randn(6, 3)
+    >>> torch.allclose(torch.block_sparse_mm(crow_indices, col_indices, values, dense), mat.mm(dense))
+    True
+""")
+
 add_docstr(torch.bmm,
            r"""
 bmm(input, mat2, out=None) -> Tensor
@@ -2267,6 +2328,14 @@ Returns the number of threads used for inter-op parallelism on CPU
 (e.g. in JIT interpreter)
 """)
 
+add_docstr(torch.get_intraop_thread_budget,
+           r"""
+get_intraop_thread_budget() -> int
+
+Returns the intra-op thread budget of the current thread, see
+:func:`torch.set_intraop_thread_budget`
+""")
+
 add_docstr(torch.gt,
            r"""
 gt(input, other, out=None) -> Tensor
@@ -4683,6 +4752,74 @@ Example::
     tensor([    nan,  1.8351,  0.8053,     nan])
 """.format(**common_args))
 
+add_docstr(torch.segment_reduce,
+           r"""
+segment_reduce(data, reduce, *, lengths=None, offsets=None) -> Tensor
+
+Reduces consecutive runs of rows of :attr:`data` along its first dimension.
+The segments are given either by their :attr:`lengths`, or by
+:attr:`offsets`, where segment ``i`` covers the rows
+``offsets[i]:offsets[i + 1]``. Exactly one of the two must be given, and the
+segments must cover all rows of :attr:`data`.
+
+Every segment is reduced by a single thread, so unlike :meth:`~Tensor.index_add_`
+and :meth:`~Tensor.scatter_add_` neither direction needs atomics. Empty
+segments reduce to zero.
+
+Args:
+    data (Tensor): the input tensor
+    reduce (str): the reduction, one of ``'sum'``, ``'mean'`` and ``'max'``
+    lengths (LongTensor, optional): the number of rows in every segment
+    offsets (LongTensor, optional): one more entry than there are segments,
+        starting at 0 and ending at ``data.size(0)``
+
+Example::
+
+    >>> data = torch.tensor([[1., 2.], [3., 4.], [5., 6.], [7., 8.]])
+    >>> torch.segment_reduce(data, 'sum', lengths=torch.tensor([1, 3]))
+    tensor([[ 1.,  2.],
+            [15., 18.]])
+    >>> torch.segment_reduce(data, 'max', offsets=torch.tensor([0, 2, 2, 4]))
+    tensor([[3., 4.],
+            [0., 0.],
+            [7., 8.]])
+""")
+
+add_docstr(torch.to_block_sparse,
+           r"""
+to_block_sparse(input, blocksize) -> (Tensor, Tensor, Tensor)
+
+Converts the 2D tensor :attr:`input` to the block sparse row (BSR) format used
+by :func:`torch.block_sparse_mm` and :func:`torch.block_sparse_linear`. The
+tensor is split into blocks of :attr:`blocksize`, which must divide its sizes,
+and only the blocks with a non-zero entry are kept.
+
+Returns a tuple ``(crow_indices, col_indices, values)`` where, for blocks of
+:math:`(r \times c)`:
+
+- ``values`` is of ``(nnz, r, c)`` and holds the kept blocks in row major order,
+- ``col_indices`` is of ``(nnz)`` and holds the block column of every block,
+- ``crow_indices`` is of ``(input.size(0) / r + 1)``: the blocks of block row
+  ``i`` are ``crow_indices[i]:crow_indices[i + 1]``.
+
+Args:
+    input (Tensor): the 2D tensor, typically a pruned weight
+    blocksize (tuple of ints): the size :math:`(r, c)` of the blocks
+
+Example::
+
+    >>> mat = torch.tensor([[1., 2., 0., 0.],
+    ...                     [3., 4., 0., 0.],
+    ...                     [0., 0., 0., 5.],
+    ...                     [0., 0., 0., 0.]])
+    >>> torch.to_block_sparse(mat, (2, 2))
+    (tensor([0, 1, 2]), tensor([0, 1]), tensor([[[1., 2.],
+             [3., 4.]],
+
+            [[0., 5.],
+             [0., 0.]]]))
+""")
+
 add_docstr(torch.set_flush_denormal,
            r"""
 set_flush_denormal(mode) -> bool
@@ -4729,6 +4866,18 @@ WARNING: Can only be called once and before any inter-op parallel work
 is started (e.g. JIT execution).
 """)
 
+add_docstr(torch.set_intraop_thread_budget,
+           r"""
+set_intraop_thread_budget(int)
+
+Limits the number of threads, including the current one, that CPU operations
+started on the current thread use for intra-op parallelism. 0 (the default)
+means no limit beyond :func:`torch.get_num_threads`. Inter-op tasks (e.g. JIT
+forks) inherit the budget of the thread that starts them, so with a budget of
+``n``, each of them can use up to ``n`` intra-op threads.
+Honored by all parallel backends.
+""")
+
 add_docstr(torch.sigmoid,
            r"""
 sigmoid(input, out=None) -> Tensor
@@ -7258,6 +7407,42 @@ Example::
 """)
 
 
+add_docstr(torch._C.Generator.set_philox_mode,
+           r"""
+Generator.set_philox_mode(enabled) -> Generator
+
+Makes :meth:`~Tensor.uniform_`, :meth:`~Tensor.normal_` and
+:meth:`~Tensor.bernoulli_` on float and double CPU tensors (and so
+:func:`torch.nn.functional.dropout`) draw their numbers from a counter-based
+Philox engine instead of the Mersenne Twister. The numbers are then generated
+in parallel, and are the same for a given seed whatever the number of threads.
+Only supported by CPU generators. The Philox offset is reset by
+:meth:`manual_seed`, and isn't part of the state of :meth:`get_state`.
+
+Arguments:
+    enabled (bool): Whether to use Philox.
+
+Example::
+
+    >>> g_cpu = torch.Generator()
+    >>> g_cpu.set_philox_mode(True)
+""")
+
+
+add_docstr(torch._C.Generator.philox_mode,
+           r"""
+Generator.philox_mode() -> bool
+
+Returns whether the generator is in Philox mode, see :meth:`set_philox_mode`.
+
+Example::
+
+    >>> g_cpu = torch.Generator()
+    >>> g_cpu.philox_mode()
+    False
+""")
+
+
 add_docstr(torch._C.Generator.device,
            r"""
 Generator.device -> device
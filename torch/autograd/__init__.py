@@ -11,7 +11,7 @@ from .variable import Variable
 from .function import Function, NestedIOFunction
 from .gradcheck import gradcheck, gradgradcheck
 from .grad_mode import no_grad, enable_grad, set_grad_enabled
-from .anomaly_mode import detect_anomaly, set_detect_anomaly
+from .anomaly_mode import detect_anomaly, set_detect_anomaly, detect_nonfinite
 from . import profiler
 
 __all__ = ['Variable', 'Function', 'backward', 'grad_mode']
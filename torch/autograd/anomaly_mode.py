@@ -101,3 +101,51 @@ class set_detect_anomaly(object):
     def __exit__(self, *args):
         torch.set_anomaly_enabled(self.prev)
         return False
+
+
+class detect_nonfinite(object):
+    r"""Context-manager that checks that the backward passes run inside it
+    compute finite gradients.
+
+    Unlike ``detect_anomaly``, the check is cheap enough to leave on in
+    training: the engine only sums the gradients of every node on the device
+    it runs on, and on exit the context-manager synchronizes once to tell
+    whether one of the sums is a nan or an inf. To find the node that
+    produced it, run the step again inside both ``detect_anomaly`` and
+    ``detect_nonfinite``, which makes the backward pass fail at the first
+    node returning non-finite values, with the traceback of the forward
+    operation that created it.
+
+    .. warning::
+        The check is global to the process, like ``detect_anomaly``; the sums
+        of backward passes on other threads end up in the same result.
+
+    Example:
+
+        >>> for data, target in loader:
+        ...     with autograd.detect_nonfinite() as check:
+        ...         loss = loss_fn(model(data), target)
+        ...         loss.backward()
+        ...     if check.found:
+        ...         optimizer.zero_grad()
+        ...         with autograd.detect_anomaly(), autograd.detect_nonfinite():
+        ...             loss_fn(model(data), target).backward()  # raises
+        ...     optimizer.step()
+        ...     optimizer.zero_grad()
+
+    """
+
+    def __init__(self):
+        self.prev = torch._C._is_finite_check_enabled()
+        self.found = False
+
+    def __enter__(self):
+        # Start from clean sums
+        torch._C._nonfinite_found()
+        torch._C._set_finite_check_enabled(True)
+        return self
+
+    def __exit__(self, *args):
+        torch._C._set_finite_check_enabled(self.prev)
+        self.found = torch._C._nonfinite_found()
+        return False
@@ -9,9 +9,11 @@ class EventList(list):
     """A list of Events (for pretty printing)"""
     def __init__(self, *args, **kwargs):
         use_cuda = kwargs.pop('use_cuda', True)
+        profile_memory = kwargs.pop('profile_memory', False)
         super(EventList, self).__init__(*args, **kwargs)
         self._cpu_children_populated = False
         self._use_cuda = use_cuda
+        self._profile_memory = profile_memory
 
     def __str__(self):
         return self.table()
@@ -85,13 +87,16 @@ class EventList(list):
             sort_by (str, optional): Attribute used to sort entries. By default
                 they are printed in the same order as they were registered.
                 Valid keys include: ``cpu_time``, ``cuda_time``, ``cpu_time_total``,
-                ``cuda_time_total``, ``count``.
+                ``cuda_time_total``, ``count``, and with memory profiling
+                ``cpu_memory_usage``, ``self_cpu_memory_usage``,
+                ``cpu_peak_memory_usage`` and their ``cuda`` counterparts.
 
         Returns:
             A string containing the table.
         """
         return build_table(
-            self, sort_by=sort_by, row_limit=row_limit, header=header, use_cuda=self._use_cuda)
+            self, sort_by=sort_by, row_limit=row_limit, header=header, use_cuda=self._use_cuda,
+            profile_memory=self._profile_memory)
 
     def export_chrome_trace(self, path):
         """Exports an EventList as a Chrome tracing tools file.
@@ -173,7 +178,7 @@ class EventList(list):
         for evt in self:
             stats[get_key(evt, group_by_input_shapes)].add(
                 evt, group_by_input_shapes)
-        return EventList(stats.values(), use_cuda=self._use_cuda)
+        return EventList(stats.values(), use_cuda=self._use_cuda, profile_memory=self._profile_memory)
 
     def total_average(self):
         """Averages all events.
@@ -214,6 +219,13 @@ class profile(object):
             self cpu time might be artificially increased because of the shape
             collection.
 
+        profile_memory (bool, optional): Attributes the memory allocated and freed
+            through the CPU allocator and the CUDA caching allocator to the function
+            that was running on the thread. For every function the profiler then
+            reports the bytes its call allocated (and hasn't freed) with and without
+            its children, and the most bytes allocated at any point of the call.
+            Default: ``False``
+
     .. warning:
         This context managers should not be called recursively, i.e. at most one
         instance should be enabled at any given time.
@@ -237,7 +249,7 @@ class profile(object):
         -----------------------------------  ---------------  ---------------  ---------------
 
     """
-    def __init__(self, enabled=True, use_cuda=False, record_shapes=False):
+    def __init__(self, enabled=True, use_cuda=False, record_shapes=False, profile_memory=False):
         self.enabled = enabled
         self.use_cuda = use_cuda
         self.function_events = None
@@ -245,6 +257,7 @@ class profile(object):
             return
         self.entered = False
         self.record_shapes = record_shapes
+        self.profile_memory = profile_memory
 
     def __enter__(self):
         if not self.enabled:
@@ -255,14 +268,15 @@ class profile(object):
         profiler_kind = torch.autograd.ProfilerState.CUDA if self.use_cuda \
             else torch.autograd.ProfilerState.CPU
         torch.autograd._enable_profiler(
-            torch.autograd.ProfilerConfig(profiler_kind, self.record_shapes))
+            torch.autograd.ProfilerConfig(profiler_kind, self.record_shapes, self.profile_memory))
         return self
 
     def __exit__(self, exc_type, exc_val, exc_tb):
         if not self.enabled:
             return
         records = torch.autograd._disable_profiler()
-        self.function_events = EventList(parse_cpu_trace(records), use_cuda=self.use_cuda)
+        self.function_events = EventList(
+            parse_cpu_trace(records), use_cuda=self.use_cuda, profile_memory=self.profile_memory)
         return False
 
     def __repr__(self):
@@ -483,6 +497,21 @@ def format_time(time_us):
     return '{:.3f}us'.format(time_us)
 
 
+def format_memory(nbytes):
+    """Returns a formatted memory size string"""
+    KB = 1024
+    MB = 1024 * KB
+    GB = 1024 * MB
+    if abs(nbytes) >= GB:
+        return '{:.2f} Gb'.format(nbytes * 1.0 / GB)
+    elif abs(nbytes) >= MB:
+        return '{:.2f} Mb'.format(nbytes * 1.0 / MB)
+    elif abs(nbytes) >= KB:
+        return '{:.2f} Kb'.format(nbytes * 1.0 / KB)
+    else:
+        return str(nbytes) + ' b'
+
+
 def format_time_share(time_us, total_time_us):
     """Defines how to format time in FunctionEvent"""
     if total_time_us == 0:
@@ -527,10 +556,34 @@ class Interval(object):
 Kernel = namedtuple('Kernel', ['name', 'device', 'interval'])
 
 
+class MemoryScope(object):
+    """Bytes allocated during a function call, on the CPU and on CUDA devices.
+
+    ``usage`` is what the call and its children allocated and didn't free,
+    ``children_usage`` the part of it allocated by the children, and ``peak``
+    the most that was allocated at any point of the call.
+    """
+    def __init__(self):
+        self.usage = [0, 0]
+        self.children_usage = [0, 0]
+        self.peak = [0, 0]
+
+    def add(self, device, nbytes):
+        i = 0 if device == -1 else 1
+        self.usage[i] += nbytes
+        self.peak[i] = max(self.peak[i], self.usage[i])
+
+    def add_child(self, child):
+        for i in range(2):
+            self.peak[i] = max(self.peak[i], self.usage[i] + child.peak[i])
+            self.usage[i] += child.usage[i]
+            self.children_usage[i] += child.usage[i]
+
+
 # TODO: record TID too
 class FunctionEvent(FormattedTimesMixin):
     """Profiling information about a single function."""
-    def __init__(self, id, name, thread, cpu_start, cpu_end, input_shapes=None):
+    def __init__(self, id, name, thread, cpu_start, cpu_end, input_shapes=None, memory=None):
         self.id = id
         self.name = name
         self.cpu_interval = Interval(cpu_start, cpu_end)
@@ -539,6 +592,11 @@ class FunctionEvent(FormattedTimesMixin):
         self.count = 1
         self.cpu_children = []
         self.input_shapes = input_shapes
+        memory = memory if memory is not None else MemoryScope()
+        self.cpu_memory_usage, self.cuda_memory_usage = memory.usage
+        self.self_cpu_memory_usage = memory.usage[0] - memory.children_usage[0]
+        self.self_cuda_memory_usage = memory.usage[1] - memory.children_usage[1]
+        self.cpu_peak_memory_usage, self.cuda_peak_memory_usage = memory.peak
 
     def append_kernel(self, name, device, start, end):
         self.kernels.append(Kernel(name, device, Interval(start, end)))
@@ -596,6 +654,12 @@ class FunctionEventAvg(FormattedTimesMixin):
         self.cuda_time_total = 0
         self.self_cpu_time_total = 0
         self.input_shapes = None
+        self.cpu_memory_usage = 0
+        self.cuda_memory_usage = 0
+        self.self_cpu_memory_usage = 0
+        self.self_cuda_memory_usage = 0
+        self.cpu_peak_memory_usage = 0
+        self.cuda_peak_memory_usage = 0
 
     def add(self, other, group_by_input_shapes=False):
         if self.key is None:
@@ -612,6 +676,12 @@ class FunctionEventAvg(FormattedTimesMixin):
         self.cpu_time_total += other.cpu_time
         self.cuda_time_total += other.cuda_time
         self.self_cpu_time_total += other.self_cpu_time_total
+        self.cpu_memory_usage += other.cpu_memory_usage
+        self.cuda_memory_usage += other.cuda_memory_usage
+        self.self_cpu_memory_usage += other.self_cpu_memory_usage
+        self.self_cuda_memory_usage += other.self_cuda_memory_usage
+        self.cpu_peak_memory_usage = max(self.cpu_peak_memory_usage, other.cpu_peak_memory_usage)
+        self.cuda_peak_memory_usage = max(self.cuda_peak_memory_usage, other.cuda_peak_memory_usage)
         self.count += 1
         return self
 
@@ -673,18 +743,25 @@ def parse_cpu_trace(thread_records):
     for record in itertools.chain(*thread_records):
         if record.kind() == 'mark':
             continue
+        elif record.kind() == 'memory_alloc':
+            # Memory of the function running on the thread, if any
+            if record_stack:
+                record_stack[-1][2].add(record.device(), record.alloc_size())
         elif record.kind() == 'push':
-            record_stack.append((next_id, record))
+            record_stack.append((next_id, record, MemoryScope()))
             next_id += 1
         elif record.kind() == 'pop':
-            function_id, start = record_stack.pop()
+            function_id, start, memory = record_stack.pop()
+            if record_stack:
+                record_stack[-1][2].add_child(memory)
             fe = FunctionEvent(
                 id=function_id,
                 name=string_table[start.name()],
                 thread=start.thread_id(),
                 cpu_start=start_record.cpu_elapsed_us(start),
                 cpu_end=start_record.cpu_elapsed_us(record),
-                input_shapes=start.shapes())
+                input_shapes=start.shapes(),
+                memory=memory)
             if start.has_cuda():
                 cuda_start = adjusted_time(start)
                 cuda_end = adjusted_time(record)
@@ -778,7 +855,7 @@ def parse_nvprof_trace(path):
 # Pretty printer
 
 
-def build_table(events, sort_by=None, header=None, row_limit=100, use_cuda=True):
+def build_table(events, sort_by=None, header=None, row_limit=100, use_cuda=True, profile_memory=False):
     """Prints a summary of events (which can be a list of FunctionEvent or FunctionEventAvg)."""
     if len(events) == 0:
         return ""
@@ -786,7 +863,7 @@ def build_table(events, sort_by=None, header=None, row_limit=100, use_cuda=True)
     if sort_by is not None:
         events = EventList(sorted(
             events, key=lambda evt: getattr(evt, sort_by), reverse=True
-        ), use_cuda=use_cuda)
+        ), use_cuda=use_cuda, profile_memory=profile_memory)
 
     has_input_shapes = any(
         [event.input_shapes is not None for event in events])
@@ -808,6 +885,18 @@ def build_table(events, sort_by=None, header=None, row_limit=100, use_cuda=True)
             'CUDA total',
             'CUDA time avg',
         ])
+    if profile_memory:
+        headers.extend([
+            'CPU Mem',
+            'Self CPU Mem',
+            'CPU Peak Mem',
+        ])
+        if use_cuda:
+            headers.extend([
+                'CUDA Mem',
+                'Self CUDA Mem',
+                'CUDA Peak Mem',
+            ])
     headers.append(
         'Number of Calls'
     )
@@ -872,6 +961,18 @@ def build_table(events, sort_by=None, header=None, row_limit=100, use_cuda=True)
                 evt.cuda_time_total_str,
                 evt.cuda_time_str,  # Cuda time avg
             ])
+        if profile_memory:
+            row_values.extend([
+                format_memory(evt.cpu_memory_usage),
+                format_memory(evt.self_cpu_memory_usage),
+                format_memory(evt.cpu_peak_memory_usage),
+            ])
+            if use_cuda:
+                row_values.extend([
+                    format_memory(evt.cuda_memory_usage),
+                    format_memory(evt.self_cuda_memory_usage),
+                    format_memory(evt.cuda_peak_memory_usage),
+                ])
         row_values.append(
             evt.count,  # Number of calls
         )
@@ -0,0 +1,69 @@
+import sys
+import torch
+from contextlib import contextmanager
+from torch.backends import ContextProp, PropModule, __allow_nonbracketed_mutation
+
+
+def save_benchmark_cache(path):
+    r"""Saves the convolution backends picked so far with
+    ``torch.backends.cpu.benchmark = True`` to the file at :attr:`path`,
+    so that another process can skip benchmarking them with
+    :func:`load_benchmark_cache`.
+
+    The file is only valid for the model of the CPU that is current when it
+    is saved.
+    """
+    torch._cpu_conv_save_benchmark_cache(path)
+
+
+def load_benchmark_cache(path):
+    r"""Loads the convolution backends saved by :func:`save_benchmark_cache`
+    from the file at :attr:`path`. Convolutions run with
+    ``torch.backends.cpu.benchmark = True`` then use them instead of
+    benchmarking the backends again. Backends already picked by this
+    process are kept.
+
+    If the file was saved on a different CPU model, a warning is raised and
+    nothing is loaded. Returns the number of backends loaded.
+    """
+    return torch._cpu_conv_load_benchmark_cache(path)
+
+
+def set_flags(_fast_math, _benchmark=None):
+    orig_flags = (torch._C._get_cpu_fast_math(), torch._C._get_cpu_benchmark())
+    torch._C._set_cpu_fast_math(_fast_math)
+    if _benchmark is not None:
+        torch._C._set_cpu_benchmark(_benchmark)
+    return orig_flags
+
+@contextmanager
+def flags(fast_math=False, benchmark=False):
+    r"""Context manager that sets the CPU math flags and restores them on exit.
+
+    With ``fast_math=True``, ``exp``, ``tanh``, ``sigmoid`` and ``erfinv`` on
+    float tensors use lower-precision vectorized implementations that are
+    accurate to a few ulp, but are not bitwise identical to the default ones.
+
+    With ``benchmark=True``, the first convolution of each shape on float CPU
+    tensors times the CPU backends which can run it (im2col, MKL-DNN, NNPACK,
+    and without grad Winograd and direct NHWC) and the later ones run the
+    fastest, like ``torch.backends.cudnn.benchmark``.
+    """
+    with __allow_nonbracketed_mutation():
+        orig_flags = set_flags(fast_math, benchmark)
+    try:
+        yield
+    finally:
+        with __allow_nonbracketed_mutation():
+            set_flags(*orig_flags)
+
+class CpuModule(PropModule):
+    def __init__(self, m, name):
+        super(CpuModule, self).__init__(m, name)
+
+    fast_math = ContextProp(torch._C._get_cpu_fast_math, torch._C._set_cpu_fast_math)
+    benchmark = ContextProp(torch._C._get_cpu_benchmark, torch._C._set_cpu_benchmark)
+
+# Cool stuff from torch/backends/cudnn/__init__.py and
+# https://stackoverflow.com/questions/2447353/getattr-on-a-module/7668273#7668273
+sys.modules[__name__] = CpuModule(sys.modules[__name__], __name__)
@@ -29,8 +29,15 @@ class cuFFTPlanCacheAttrContextProp(object):
 class cuFFTPlanCache(object):
     r"""
     Represents a specific plan cache for a specific `device_index`. The
-    attributes `size` and `max_size`, and method `clear`, can fetch and/ or
-    change properties of the C++ cuFFT plan cache.
+    attributes `size`, `max_size`, `bytes` and `max_bytes`, and method `clear`,
+    can fetch and/ or change properties of the C++ cuFFT plan cache. The
+    read-only attributes `hits`, `misses` and `evictions` count the lookups
+    that found a cached plan, the lookups that created a new plan, and the plans
+    evicted to stay within `max_size` or `max_bytes`.
+
+    The default `max_size` and `max_bytes` can be set with the environment
+    variables ``PYTORCH_CUFFT_PLAN_CACHE_SIZE`` and
+    ``PYTORCH_CUFFT_PLAN_CACHE_MAX_BYTES``.
     """
     def __init__(self, device_index):
         self.device_index = device_index
@@ -43,6 +50,23 @@ class cuFFTPlanCache(object):
     max_size = cuFFTPlanCacheAttrContextProp(torch._cufft_get_plan_cache_max_size,
                                              torch._cufft_set_plan_cache_max_size)
 
+    bytes = cuFFTPlanCacheAttrContextProp(
+        torch._cufft_get_plan_cache_bytes,
+        '.bytes is a read-only property showing the total workspace size of the plans '
+        'currently in the cache. To change the limit, set cufft_plan_cache.max_bytes.')
+
+    max_bytes = cuFFTPlanCacheAttrContextProp(torch._cufft_get_plan_cache_max_bytes,
+                                              torch._cufft_set_plan_cache_max_bytes)
+
+    hits = cuFFTPlanCacheAttrContextProp(
+        torch._cufft_get_plan_cache_hits, '.hits is a read-only property.')
+
+    misses = cuFFTPlanCacheAttrContextProp(
+        torch._cufft_get_plan_cache_misses, '.misses is a read-only property.')
+
+    evictions = cuFFTPlanCacheAttrContextProp(
+        torch._cufft_get_plan_cache_evictions, '.evictions is a read-only property.')
+
     def clear(self):
         return torch._cufft_clear_plan_cache(self.device_index)
 
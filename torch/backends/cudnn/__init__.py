@@ -85,6 +85,32 @@ def version():
     return __cudnn_version
 
 
+def save_benchmark_cache(path):
+    r"""Saves the convolution algorithms picked so far with
+    ``torch.backends.cudnn.benchmark = True`` to the file at :attr:`path`,
+    so that another process can skip benchmarking them with
+    :func:`load_benchmark_cache`.
+
+    The file is only valid for the cuDNN version and the model of the GPU
+    that is current when it is saved.
+    """
+    torch._cudnn_save_benchmark_cache(path)
+
+
+def load_benchmark_cache(path):
+    r"""Loads the convolution algorithms saved by :func:`save_benchmark_cache`
+    from the file at :attr:`path`. Convolutions run with
+    ``torch.backends.cudnn.benchmark = True`` then use them instead of
+    benchmarking the algorithms again. Algorithms already picked by this
+    process are kept.
+
+    If the file was saved with a different cuDNN version or GPU model, a
+    warning is raised and nothing is loaded. Returns the number of
+    algorithms loaded.
+    """
+    return torch._cudnn_load_benchmark_cache(path)
+
+
 CUDNN_TENSOR_TYPES = {
     'torch.cuda.HalfTensor',
     'torch.cuda.FloatTensor',
@@ -213,10 +213,144 @@ static PyObject *THPModule_errorIfAnyWorkerFails(PyObject *module, PyObject *_ig
 
 #endif
 
+// Together with `torch/utils/data/_utils/shared_ring.py`, the following lets
+// workers send batches to the main process through the slots of a shared
+// memory buffer allocated once, instead of sharing the storage of every tensor.
+//
+// The tensors of a batch are views of its slot, and `refcounts[slot]` counts
+// the views alive in the main process, plus one while the batch is in flight.
+// The worker owning the slot only reuses it once that count drops back to 0.
+//
+// `torch/multiprocessing/cuda_ipc_pool.py` shares sub-allocations of a CUDA
+// slab between processes the same way, with one slot per sub-allocation.
+#include <atomic>
+
+#include <torch/csrc/Exceptions.h>
+#include <torch/csrc/autograd/generated/variable_factories.h>
+#include <torch/csrc/autograd/python_variable.h>
+#include <torch/csrc/utils/python_arg_parser.h>
+#include <torch/csrc/utils/python_numbers.h>
+
+static_assert(
+    sizeof(std::atomic<int32_t>) == sizeof(int32_t) && ATOMIC_INT_LOCK_FREE == 2,
+    "The refcounts of the shared memory slots must be lock free int32s");
+
+static std::atomic<int32_t>& sharedRingRefcount(
+    const at::Tensor& refcounts,
+    int64_t slot) {
+  TORCH_CHECK(
+      refcounts.scalar_type() == at::kInt && refcounts.is_contiguous() &&
+          refcounts.device().is_cpu(),
+      "Expected the refcounts of a shared memory ring to be a contiguous CPU "
+      "int32 tensor");
+  TORCH_CHECK(
+      slot >= 0 && slot < refcounts.numel(),
+      "Slot ", slot, " is out of range for a shared memory ring of ",
+      refcounts.numel(), " slots");
+  return *reinterpret_cast<std::atomic<int32_t>*>(
+      refcounts.data_ptr<int32_t>() + slot);
+}
+
+// Returns a contiguous tensor of the given size and dtype viewing `buffer` at
+// `offset` bytes, on the device of `buffer`. If `refcounts` is given, the view
+// holds a reference to `slot` until it is freed.
+static PyObject *THPModule_sharedRingView(PyObject *module, PyObject *args, PyObject *kwargs) {
+  HANDLE_TH_ERRORS
+  static torch::PythonArgParser parser({
+    "_shared_ring_view(Tensor buffer, int64_t offset, IntArrayRef size, ScalarType dtype, Tensor? refcounts=None, int64_t slot=-1)",
+  });
+  torch::ParsedArgs<6> parsed_args;
+  auto r = parser.parse(args, kwargs, parsed_args);
+  auto buffer = r.tensor(0);
+  const auto offset = r.toInt64(1);
+  const auto size = r.intlist(2);
+  const auto dtype = r.scalartype(3);
+  auto refcounts = r.tensor(4);
+  const auto slot = r.toInt64(5);
+  TORCH_CHECK(
+      buffer.scalar_type() == at::kByte && buffer.is_contiguous(),
+      "Expected the buffer of a shared memory ring to be a contiguous uint8 "
+      "tensor");
+  int64_t nbytes = c10::elementSize(dtype);
+  for (const auto s : size) {
+    nbytes *= s;
+  }
+  TORCH_CHECK(
+      offset >= 0 && offset + nbytes <= buffer.numel(),
+      "View of ", nbytes, " bytes at offset ", offset,
+      " is out of range for a shared memory buffer of ", buffer.numel(),
+      " bytes");
+
+  std::function<void(void*)> deleter;
+  if (refcounts.defined()) {
+    sharedRingRefcount(refcounts, slot).fetch_add(1);
+    deleter = [buffer, refcounts, slot](void*) {
+      sharedRingRefcount(refcounts, slot).fetch_sub(1);
+    };
+  } else {
+    deleter = [buffer](void*) {};
+  }
+  return THPVariable_Wrap(torch::from_blob(
+      buffer.data_ptr<uint8_t>() + offset,
+      size,
+      deleter,
+      at::TensorOptions(dtype).device(buffer.device())));
+  END_HANDLE_TH_ERRORS
+}
+
+// Takes the first reference to a free slot, returning false if it is in use.
+static PyObject *THPModule_sharedRingTryAcquire(PyObject *module, PyObject *args) {
+  HANDLE_TH_ERRORS
+  if (PyTuple_GET_SIZE(args) != 2 || !THPVariable_Check(PyTuple_GET_ITEM(args, 0))) {
+    throw TypeError("_shared_ring_try_acquire expects a tensor and a slot.");
+  }
+  auto& refcount = sharedRingRefcount(
+      THPVariable_Unpack(PyTuple_GET_ITEM(args, 0)),
+      THPUtils_unpackLong(PyTuple_GET_ITEM(args, 1)));
+  int32_t expected = 0;
+  if (refcount.compare_exchange_strong(expected, 1)) {
+    Py_RETURN_TRUE;
+  }
+  Py_RETURN_FALSE;
+  END_HANDLE_TH_ERRORS
+}
+
+// Takes another reference to a slot in use.
+static PyObject *THPModule_sharedRingRetain(PyObject *module, PyObject *args) {
+  HANDLE_TH_ERRORS
+  if (PyTuple_GET_SIZE(args) != 2 || !THPVariable_Check(PyTuple_GET_ITEM(args, 0))) {
+    throw TypeError("_shared_ring_retain expects a tensor and a slot.");
+  }
+  auto& refcount = sharedRingRefcount(
+      THPVariable_Unpack(PyTuple_GET_ITEM(args, 0)),
+      THPUtils_unpackLong(PyTuple_GET_ITEM(args, 1)));
+  TORCH_CHECK(refcount.fetch_add(1) > 0, "Retained a free shared memory slot");
+  Py_RETURN_NONE;
+  END_HANDLE_TH_ERRORS
+}
+
+// Drops a reference to a slot.
+static PyObject *THPModule_sharedRingRelease(PyObject *module, PyObject *args) {
+  HANDLE_TH_ERRORS
+  if (PyTuple_GET_SIZE(args) != 2 || !THPVariable_Check(PyTuple_GET_ITEM(args, 0))) {
+    throw TypeError("_shared_ring_release expects a tensor and a slot.");
+  }
+  auto& refcount = sharedRingRefcount(
+      THPVariable_Unpack(PyTuple_GET_ITEM(args, 0)),
+      THPUtils_unpackLong(PyTuple_GET_ITEM(args, 1)));
+  TORCH_CHECK(refcount.fetch_sub(1) > 0, "Released a free shared memory slot");
+  Py_RETURN_NONE;
+  END_HANDLE_TH_ERRORS
+}
+
 PyMethodDef DataLoaderMethods[] = {
   {"_set_worker_signal_handlers",  (PyCFunction)THPModule_setWorkerSignalHandlers,  METH_NOARGS,   nullptr},
   {"_set_worker_pids",             (PyCFunction)THPModule_setWorkerPIDs,            METH_VARARGS,  nullptr},
   {"_remove_worker_pids",          (PyCFunction)THPModule_removeWorkerPIDs,         METH_O,        nullptr},
   {"_error_if_any_worker_fails",   (PyCFunction)THPModule_errorIfAnyWorkerFails,    METH_NOARGS,   nullptr},
+  {"_shared_ring_view",            (PyCFunction)(void(*)())THPModule_sharedRingView, METH_VARARGS | METH_KEYWORDS, nullptr},
+  {"_shared_ring_try_acquire",     (PyCFunction)THPModule_sharedRingTryAcquire,     METH_VARARGS,  nullptr},
+  {"_shared_ring_retain",          (PyCFunction)THPModule_sharedRingRetain,         METH_VARARGS,  nullptr},
+  {"_shared_ring_release",         (PyCFunction)THPModule_sharedRingRelease,        METH_VARARGS,  nullptr},
   {nullptr, nullptr, 0, nullptr}
 };
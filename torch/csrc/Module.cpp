@@ -192,6 +192,21 @@ static PyObject * THPModule_setNumInteropThreads(PyObject *module, PyObject *arg
   Py_RETURN_NONE;
 }
 
+static PyObject * THPModule_getIntraopThreadBudget(PyObject *module, PyObject *noargs)
+{
+  return PyLong_FromLong(at::get_intraop_thread_budget());
+}
+
+static PyObject * THPModule_setIntraopThreadBudget(PyObject *module, PyObject *arg)
+{
+  THPUtils_assert(THPUtils_checkLong(arg), "set_intraop_thread_budget expects an int, "
+          "but got %s", THPUtils_typename(arg));
+  int budget = (int)THPUtils_unpackLong(arg);
+  THPUtils_assert(budget >= 0, "set_intraop_thread_budget expects a non-negative integer");
+  at::set_intraop_thread_budget(budget);
+  Py_RETURN_NONE;
+}
+
 PyObject * THPModule_setDefaultTensorType(PyObject *_unused, PyObject *type)
 {
   HANDLE_TH_ERRORS
@@ -447,6 +462,48 @@ PyObject *THPModule_deterministicCuDNN(PyObject *_unused, PyObject *noargs)
   else Py_RETURN_FALSE;
 }
 
+PyObject *THPModule_setFastMathCPU(PyObject *_unused, PyObject *arg)
+{
+  THPUtils_assert(PyBool_Check(arg), "set_cpu_fast_math expects a bool, "
+          "but got %s", THPUtils_typename(arg));
+  at::globalContext().setFastMathCPU(arg == Py_True);
+  Py_RETURN_NONE;
+}
+
+PyObject *THPModule_fastMathCPU(PyObject *_unused, PyObject *noargs)
+{
+  if (at::globalContext().fastMathCPU()) Py_RETURN_TRUE;
+  else Py_RETURN_FALSE;
+}
+
+PyObject *THPModule_setBenchmarkCPU(PyObject *_unused, PyObject *arg)
+{
+  THPUtils_assert(PyBool_Check(arg), "set_cpu_benchmark expects a bool, "
+          "but got %s", THPUtils_typename(arg));
+  at::globalContext().setBenchmarkCPU(arg == Py_True);
+  Py_RETURN_NONE;
+}
+
+PyObject *THPModule_benchmarkCPU(PyObject *_unused, PyObject *noargs)
+{
+  if (at::globalContext().benchmarkCPU()) Py_RETURN_TRUE;
+  else Py_RETURN_FALSE;
+}
+
+PyObject *THPModule_setCopyOnWriteClone(PyObject *_unused, PyObject *arg)
+{
+  THPUtils_assert(PyBool_Check(arg), "set_copy_on_write_clone expects a bool, "
+          "but got %s", THPUtils_typename(arg));
+  at::globalContext().setCopyOnWriteClone(arg == Py_True);
+  Py_RETURN_NONE;
+}
+
+PyObject *THPModule_copyOnWriteClone(PyObject *_unused, PyObject *noargs)
+{
+  if (at::globalContext().copyOnWriteClone()) Py_RETURN_TRUE;
+  else Py_RETURN_FALSE;
+}
+
 PyObject *THPModule_setBenchmarkCuDNN(PyObject *_unused, PyObject *arg)
 {
   THPUtils_assert(PyBool_Check(arg), "set_benchmark_cudnn expects a bool, "
@@ -539,6 +596,8 @@ static PyMethodDef TorchMethods[] = {
   {"set_num_threads", (PyCFunction)THPModule_setNumThreads,     METH_O,       nullptr},
   {"get_num_interop_threads", (PyCFunction)THPModule_getNumInteropThreads,     METH_NOARGS,  nullptr},
   {"set_num_interop_threads", (PyCFunction)THPModule_setNumInteropThreads,     METH_O,       nullptr},
+  {"get_intraop_thread_budget", (PyCFunction)THPModule_getIntraopThreadBudget,     METH_NOARGS,  nullptr},
+  {"set_intraop_thread_budget", (PyCFunction)THPModule_setIntraopThreadBudget,     METH_O,       nullptr},
   {"_get_cudnn_enabled", (PyCFunction)THPModule_userEnabledCuDNN, METH_NOARGS,     nullptr},
   {"_set_cudnn_enabled", (PyCFunction)THPModule_setUserEnabledCuDNN, METH_O,  nullptr},
   {"_get_mkldnn_enabled", (PyCFunction)THPModule_userEnabledMkldnn, METH_NOARGS,     nullptr},
@@ -547,6 +606,12 @@ static PyMethodDef TorchMethods[] = {
   {"_set_cudnn_benchmark", (PyCFunction)THPModule_setBenchmarkCuDNN, METH_O,  nullptr},
   {"_get_cudnn_deterministic", (PyCFunction)THPModule_deterministicCuDNN, METH_NOARGS,     nullptr},
   {"_set_cudnn_deterministic", (PyCFunction)THPModule_setDeterministicCuDNN, METH_O,  nullptr},
+  {"_get_cpu_fast_math", (PyCFunction)THPModule_fastMathCPU, METH_NOARGS,     nullptr},
+  {"_set_cpu_fast_math", (PyCFunction)THPModule_setFastMathCPU, METH_O,  nullptr},
+  {"_get_cpu_benchmark", (PyCFunction)THPModule_benchmarkCPU, METH_NOARGS,     nullptr},
+  {"_set_cpu_benchmark", (PyCFunction)THPModule_setBenchmarkCPU, METH_O,  nullptr},
+  {"_get_copy_on_write_clone", (PyCFunction)THPModule_copyOnWriteClone, METH_NOARGS,     nullptr},
+  {"_set_copy_on_write_clone", (PyCFunction)THPModule_setCopyOnWriteClone, METH_O,  nullptr},
   {"_to_dlpack",      (PyCFunction)THPModule_toDLPack,          METH_O,       nullptr},
   {"_from_dlpack",    (PyCFunction)THPModule_fromDLPack,        METH_O,       nullptr},
   {"set_flush_denormal", (PyCFunction)THPModule_setFlushDenormal, METH_O,     nullptr},
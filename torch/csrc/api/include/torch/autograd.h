@@ -2,3 +2,8 @@
 
 #include <torch/csrc/autograd/autograd.h>
 #include <torch/csrc/autograd/custom_function.h>
+#include <torch/csrc/autograd/flat_grads.h>
+#include <torch/csrc/autograd/offload.h>
+#include <torch/csrc/autograd/recompute.h>
+#include <torch/csrc/autograd/reduced_precision.h>
+#include <torch/csrc/autograd/static_graph.h>
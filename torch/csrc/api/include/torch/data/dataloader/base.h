@@ -3,6 +3,7 @@
 #include <torch/data/dataloader_options.h>
 #include <torch/data/detail/data_shuttle.h>
 #include <torch/data/detail/sequencers.h>
+#include <torch/data/detail/transfer.h>
 #include <torch/data/iterator.h>
 #include <torch/data/samplers/random.h>
 #include <torch/data/worker_exception.h>
@@ -11,9 +12,14 @@
 #include <torch/csrc/utils/memory.h>
 #include <torch/csrc/utils/variadic.h>
 
+#include <c10/core/Event.h>
+#include <c10/core/Stream.h>
+#include <c10/core/StreamGuard.h>
+#include <c10/core/impl/VirtualGuardImpl.h>
 #include <c10/util/Exception.h>
 
 #include <cstddef>
+#include <deque>
 #include <exception>
 #include <memory>
 #include <thread>
@@ -137,6 +143,7 @@ class DataLoaderBase {
   /// new jobs.
   virtual void reset() {
     shuttle_.drain();
+    device_batches_.clear();
     sequence_number_ = 0;
     sequencer_ = new_sequencer();
     prefetch();
@@ -163,6 +170,34 @@ class DataLoaderBase {
   /// is exhausted. This operation will block until a batch is available if one
   /// is still expected.
   optional<BatchType> next() {
+    if (!options_.prefetch_to_device) {
+      return next_host_batch();
+    }
+    // Start copying the following batches before handing out this one, so that
+    // the copies overlap with the work queued on it.
+    while (device_batches_.size() <= options_.device_prefetch_count) {
+      auto batch = next_host_batch();
+      if (!batch) {
+        break;
+      }
+      device_batches_.push_back(copy_to_device(std::move(*batch)));
+    }
+    if (device_batches_.empty()) {
+      return nullopt;
+    }
+    auto device_batch = std::move(device_batches_.front());
+    device_batches_.pop_front();
+    if (device_batch.ready) {
+      // Make the work queued on the batch wait for its copy.
+      c10::impl::VirtualGuardImpl impl(device_batch.ready->device_type());
+      device_batch.ready->block(impl.getStream(transfer_stream_->device()));
+    }
+    return std::move(device_batch.batch);
+  }
+
+  /// Returns the next batch of data as loaded by the dataset, or an empty
+  /// `optional` if the DataLoader is exhausted.
+  optional<BatchType> next_host_batch() {
     if (options_.workers > 0) {
       while (optional<Result> result = this->pop_result()) {
         if (result->exception) {
@@ -173,11 +208,53 @@ class DataLoaderBase {
         }
       }
     } else if (auto batch_request = get_batch_request()) {
-      return this->main_thread_dataset_->get_batch(std::move(*batch_request));
+      auto batch =
+          this->main_thread_dataset_->get_batch(std::move(*batch_request));
+      if (options_.pin_memory) {
+        batch = detail::pin_memory(std::move(batch));
+      }
+      return batch;
     }
     return nullopt;
   }
 
+  /// A batch copied to `prefetch_to_device`, with the event recorded after its
+  /// copy on the transfer stream, if the copy is asynchronous.
+  struct DeviceBatch {
+    optional<Batch> batch;
+    std::unique_ptr<c10::Event> ready;
+  };
+
+  /// Starts copying `batch` to `prefetch_to_device` on the transfer stream.
+  DeviceBatch copy_to_device(Batch batch) {
+    Device device = *options_.prefetch_to_device;
+    DeviceBatch device_batch;
+    if (device.is_cpu()) {
+      device_batch.batch = detail::to_device(std::move(batch), device, false);
+      return device_batch;
+    }
+    c10::impl::VirtualGuardImpl impl(device.type());
+    if (!device.has_index()) {
+      device = impl.getDevice();
+    }
+    if (!transfer_stream_) {
+      transfer_stream_ = impl.getStreamFromPool(device);
+    }
+    // The caching allocator may hand the copies memory that the batches already
+    // returned were using, so wait for the work queued on them first.
+    c10::Event consumed(device.type());
+    consumed.record(impl.getStream(device));
+    consumed.block(*transfer_stream_);
+    {
+      c10::StreamGuard guard(*transfer_stream_);
+      device_batch.batch =
+          detail::to_device(std::move(batch), device, /*non_blocking=*/true);
+    }
+    device_batch.ready = torch::make_unique<c10::Event>(device.type());
+    device_batch.ready->record(*transfer_stream_);
+    return device_batch;
+  }
+
   /// The function that worker threads run.
   void worker_thread(Dataset& dataset) {
     while (true) {
@@ -187,6 +264,9 @@ class DataLoaderBase {
       }
       try {
         auto batch = dataset.get_batch(std::move(*job.batch_request));
+        if (options_.pin_memory) {
+          batch = detail::pin_memory(std::move(batch));
+        }
         shuttle_.push_result({std::move(batch), job.sequence_number});
       } catch (...) {
         shuttle_.push_result({std::current_exception(), job.sequence_number});
@@ -241,6 +321,12 @@ class DataLoaderBase {
 
   /// True if the DataLoader has joined its worker threads.
   bool joined_ = false;
+
+  /// The batches copied to `prefetch_to_device` ahead of time, in order.
+  std::deque<DeviceBatch> device_batches_;
+
+  /// The stream of `prefetch_to_device` the batches are copied on.
+  optional<c10::Stream> transfer_stream_;
 };
 } // namespace data
 } // namespace torch
@@ -37,6 +37,20 @@ struct DataLoaderOptions {
   /// Whether to omit the last batch if it contains less than `batch_size`
   /// examples.
   TORCH_ARG(bool, drop_last) = false;
+
+  /// Whether to copy the tensors of every batch into pinned (page-locked)
+  /// memory in the worker threads, so that copying them to a CUDA device does
+  /// not block the main thread. Requires CUDA.
+  TORCH_ARG(bool, pin_memory) = false;
+
+  /// A device to copy the tensors of every batch to before returning it. The
+  /// copies are made on a separate stream of the device, `device_prefetch_count`
+  /// batches ahead of the one returned, so that they overlap with the work
+  /// queued on the batches already returned.
+  TORCH_ARG(optional<Device>, prefetch_to_device);
+
+  /// The number of batches to copy to `prefetch_to_device` ahead of time.
+  TORCH_ARG(size_t, device_prefetch_count) = 1;
 };
 
 /// Like `DataLoaderOptions`, but without any unconfigured state.
@@ -52,7 +66,10 @@ struct FullDataLoaderOptions {
         max_jobs(options.max_jobs().value_or(2 * workers)),
         timeout(options.timeout()),
         enforce_ordering(options.enforce_ordering()),
-        drop_last(options.drop_last()) {}
+        drop_last(options.drop_last()),
+        pin_memory(options.pin_memory()),
+        prefetch_to_device(options.prefetch_to_device()),
+        device_prefetch_count(options.device_prefetch_count()) {}
 
   size_t batch_size;
   size_t workers;
@@ -60,6 +77,9 @@ struct FullDataLoaderOptions {
   optional<std::chrono::milliseconds> timeout;
   bool enforce_ordering;
   bool drop_last;
+  bool pin_memory;
+  optional<Device> prefetch_to_device;
+  size_t device_prefetch_count;
 };
 } // namespace data
 } // namespace torch
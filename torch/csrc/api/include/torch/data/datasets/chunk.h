@@ -3,6 +3,7 @@
 #include <torch/arg.h>
 #include <torch/csrc/utils/memory.h>
 #include <torch/data/datasets/stateful.h>
+#include <torch/data/example.h>
 #include <torch/data/samplers.h>
 #include <queue>
 #include <thread>
@@ -36,6 +37,42 @@ class ChunkDataReader {
 };
 
 namespace detail {
+/// Returns the number of bytes held by an example, to limit the bytes cached
+/// by a `ChunkDataset` (see `ChunkDatasetOptions::cache_bytes`). Tensors,
+/// strings, `Example`s and vectors of them are counted by their contents,
+/// other types by their size. Overload it for other types owning memory.
+template <typename T>
+size_t example_nbytes(const T& /* unused */) {
+  return sizeof(T);
+}
+
+inline size_t example_nbytes(const Tensor& tensor) {
+  return tensor.defined() ? tensor.nbytes() : 0;
+}
+
+inline size_t example_nbytes(const std::string& str) {
+  return str.size();
+}
+
+template <typename Data, typename Target>
+size_t example_nbytes(const Example<Data, Target>& example) {
+  return example_nbytes(example.data) + example_nbytes(example.target);
+}
+
+template <typename Data>
+size_t example_nbytes(const Example<Data, example::NoTarget>& example) {
+  return example_nbytes(example.data);
+}
+
+template <typename T>
+size_t example_nbytes(const std::vector<T>& examples) {
+  size_t nbytes = 0;
+  for (const auto& example : examples) {
+    nbytes += example_nbytes(example);
+  }
+  return nbytes;
+}
+
 /// BatchDataBuffer manages a queue of UnwrappedBatchData. After a new chunk is
 /// loaded, BatchDataBuffer splits it into small batches and push them into the
 /// queue. When get_batch is called from data loader, it pops cached batches and
@@ -53,22 +90,28 @@ class BatchDataBuffer {
   BatchDataBuffer(
       size_t batch_size,
       ExampleSampler& example_sampler,
-      size_t queue_capacity)
+      size_t queue_capacity,
+      size_t queue_byte_capacity = 0)
       : batch_size_(batch_size),
         example_sampler_(example_sampler),
-        queue_capacity_(queue_capacity) {}
+        queue_capacity_(queue_capacity),
+        queue_byte_capacity_(queue_byte_capacity) {}
 
   /// Return batch data from the queue. Called from the ChunkDataset main
   /// thread.
   BatchType get_batch() {
     std::unique_lock<std::mutex> lock(queue_mutex_);
-    cv_read_.wait(lock, [this] {
+    auto ready = [this] {
       // wait till there is available data in the queue or if all chunks are
       // loaded (i.e. the dataset is exhausted for this epoch)
       return (
           this->total_example_count_in_queue_ >= batch_size_ ||
           this->stop_);
-    });
+    };
+    if (!ready()) {
+      ++consumer_waits_;
+      cv_read_.wait(lock, ready);
+    }
     if (batch_queue_.empty()) {
       AT_ASSERT(stop_);
       // All batches have been retrieved. Return an empty batch.
@@ -82,6 +125,7 @@ class BatchDataBuffer {
     }
 
     total_example_count_in_queue_ -= batch.batch_data.size();
+    total_bytes_in_queue_ -= batch.batch_bytes;
     lock.unlock();
     cv_write_.notify_all();
 
@@ -91,33 +135,50 @@ class BatchDataBuffer {
   /// Push preloaded chunks to batch queue. Called from the ChunkDataset worker
   /// threads.
   void add_chunk_data(UnwrappedBatchType data) {
+    auto data_size = data.size();
+
+    // Shuffle the chunk before taking the queue lock, so that the preloaders
+    // only hold it to append the batches.
+    BatchRequestType indices;
+    {
+      std::lock_guard<std::mutex> lock(sampler_mutex_);
+      example_sampler_.reset(data_size);
+      auto example_indices = example_sampler_.next(data_size);
+      AT_ASSERT(
+          example_indices && example_indices.value().size() == data_size);
+      indices = std::move(example_indices.value());
+    }
+    UnwrappedBatchType shuffled;
+    shuffled.reserve(data_size);
+    std::vector<size_t> example_bytes;
+    if (queue_byte_capacity_ > 0) {
+      example_bytes.reserve(data_size);
+    }
+    for (size_t i : indices) {
+      TORCH_CHECK(i < data_size, "Index out of range");
+      if (queue_byte_capacity_ > 0) {
+        example_bytes.push_back(example_nbytes(data[i]));
+      }
+      shuffled.emplace_back(std::move(data[i]));
+    }
+
     std::unique_lock<std::mutex> lock(queue_mutex_);
-    cv_write_.wait(lock, [this] {
-      // stop loading if we have preloaded enough data.
-      return this->total_example_count_in_queue_ < this->queue_capacity_ ||
-          this->stop_;
-    });
+    wait_for_capacity(lock);
     if (stop_) {
       // When stop_ is true, it means no further chunk loading is necessary.
       // Return without any further processing.
       return;
     }
 
-    auto data_size = data.size();
-    auto remaining_size = data_size;
-    example_sampler_.reset(data_size);
-
-    auto fill_batch = [&](size_t example_count, UnwrappedBatchType& batch) {
-      auto batch_example_indices = this->example_sampler_.next(example_count);
-      AT_ASSERT(
-          batch_example_indices &&
-          batch_example_indices.value().size() == example_count);
-      BatchRequestType& indices = batch_example_indices.value();
-      for (size_t i : indices) {
-        TORCH_CHECK(i < data_size, "Index out of range");
-        batch.emplace_back(std::move(data[i]));
+    size_t next_example = 0;
+    auto fill_batch = [&](size_t example_count, UnwrappedBatchData& batch) {
+      for (size_t i = next_example; i < next_example + example_count; ++i) {
+        batch.batch_data.emplace_back(std::move(shuffled[i]));
+        if (queue_byte_capacity_ > 0) {
+          batch.batch_bytes += example_bytes[i];
+        }
       }
-      remaining_size -= example_count;
+      next_example += example_count;
     };
 
     if (!batch_queue_.empty()) {
@@ -127,22 +188,24 @@ class BatchDataBuffer {
       size_t current_count = batch.batch_data.size();
       if (current_count < batch_size_) {
         auto example_count =
-            std::min(remaining_size, batch_size_ - current_count);
-        fill_batch(example_count, batch.batch_data);
+            std::min(data_size - next_example, batch_size_ - current_count);
+        fill_batch(example_count, batch);
+        total_bytes_in_queue_ += batch.batch_bytes;
       }
     }
 
     // If we still have data remaining after filling the last pushed batch, add
     // them to the queue too.
-    while (remaining_size > 0) {
-      UnwrappedBatchType current_batch;
+    while (next_example < data_size) {
+      UnwrappedBatchData current_batch{UnwrappedBatchType()};
 
       // Allocate the batch memory ahead of time.
-      current_batch.reserve(batch_size_);
+      current_batch.batch_data.reserve(batch_size_);
 
-      auto example_count = std::min(remaining_size, batch_size_);
+      auto example_count = std::min(data_size - next_example, batch_size_);
       fill_batch(example_count, current_batch);
-      batch_queue_.emplace(std::move(current_batch));
+      total_bytes_in_queue_ += current_batch.batch_bytes;
+      batch_queue_.push(std::move(current_batch));
     }
     total_example_count_in_queue_ += data_size;
     lock.unlock();
@@ -153,12 +216,7 @@ class BatchDataBuffer {
   /// the ChunkDataset worker threads.
   void add_chunk_data(std::exception_ptr e_ptr) {
     std::unique_lock<std::mutex> lock(queue_mutex_);
-    cv_write_.wait(lock, [this] {
-      // stop loading if we have preloaded enough data.
-      return (
-        this->total_example_count_in_queue_ < this->queue_capacity_ ||
-        this->stop_);
-    });
+    wait_for_capacity(lock);
     if (stop_){
       // When stop_ is true, it means this current thread needs to be tore down,
       // the batch buffer will be discarded, so no need to enqueue any new
@@ -193,6 +251,38 @@ class BatchDataBuffer {
     // notify all readers too.
     cv_read_.notify_all();
   }
+
+  /// The number of times `get_batch` had to wait for the preloaders.
+  size_t consumer_waits() const {
+    return consumer_waits_.load();
+  }
+
+  /// The number of times a preloader had to wait for the queue to drain.
+  size_t producer_waits() const {
+    return producer_waits_.load();
+  }
+
+ private:
+  /// Whether the queue holds fewer examples, and bytes, than it can cache.
+  bool has_capacity() const {
+    return total_example_count_in_queue_ < queue_capacity_ &&
+        (queue_byte_capacity_ == 0 ||
+         total_bytes_in_queue_ < queue_byte_capacity_);
+  }
+
+  /// Waits until there is room in the queue, or the buffer is stopped.
+  void wait_for_capacity(std::unique_lock<std::mutex>& lock) {
+    auto ready = [this] {
+      // stop loading if we have preloaded enough data.
+      return this->has_capacity() || this->stop_;
+    };
+    if (!ready()) {
+      ++producer_waits_;
+      cv_write_.wait(lock, ready);
+    }
+  }
+
+ public:
   /// The batch size is needed to create batches from the chunk data. Similar to
   /// regular dataloader where the batches are created with prefetches,
   /// BatchDataBuffer perform the batch creation using the provided batch size.
@@ -201,6 +291,10 @@ class BatchDataBuffer {
   /// count of total example stored in the queue
   size_t total_example_count_in_queue_ = 0;
 
+  /// count of total bytes stored in the queue, only tracked when
+  /// queue_byte_capacity_ is set.
+  size_t total_bytes_in_queue_ = 0;
+
   /// struct that contains a raw unwrapped batch unit. An unwrapped batch unit is
   /// the raw data without 'optional' wrapper. It can be a collection of images,
   /// utterances, e.t.c.
@@ -212,6 +306,9 @@ class BatchDataBuffer {
     /// batch data to return
     UnwrappedBatchType batch_data;
 
+    /// bytes held by batch_data, as counted by example_nbytes.
+    size_t batch_bytes = 0;
+
     /// exception pointer which captures any abnormal exceptions while creating the
     /// batch.
     std::exception_ptr exception;
@@ -228,9 +325,21 @@ class BatchDataBuffer {
 
   ExampleSampler& example_sampler_;
 
+  // sync example_sampler_ calls, made by the preloaders outside queue_mutex_.
+  std::mutex sampler_mutex_;
+
   // configurable maximun number of elements the queue can hold at one time.
   size_t queue_capacity_;
 
+  // configurable maximum number of bytes the queue can hold at one time, 0
+  // meaning no limit. A preloader can add a whole chunk as long as the queue
+  // is below it, so it may be exceeded by the bytes of one chunk.
+  size_t queue_byte_capacity_;
+
+  // wait counters, read by ChunkDataset to adapt its preloader count.
+  std::atomic<size_t> consumer_waits_{0};
+  std::atomic<size_t> producer_waits_{0};
+
   // When set to true, it wakes the writer threads from the wait and exit current
   // function call. This is needed when ChunkDataSet.Reset is called while the
   // previous epoch is not exhausted yet. When ChunkDataset is waiting its
@@ -290,6 +399,16 @@ struct ChunkDatasetOptions {
   // penalty when this value is greater than 1, as we need to do extra merge
   // between multiple chunks before performing example sampling.
   TORCH_ARG(size_t, cross_chunk_shuffle_count) = 1;
+
+  /// The maximum number of bytes of examples to cache, as counted by
+  /// `detail::example_nbytes`, on top of `cache_size`. 0 means no limit.
+  TORCH_ARG(size_t, cache_bytes) = 0;
+
+  // When true, the dataset starts every epoch with a single preloader and
+  // scales up to `preloader_count` while `get_batch` keeps waiting for data,
+  // or back down while the cache is full. Otherwise all `preloader_count`
+  // preloaders run from the start.
+  TORCH_ARG(bool, adaptive_preloader_count) = false;
 };
 
 /// A stateful dataset that support hierarchical sampling and prefetching of
@@ -385,10 +504,17 @@ class ChunkDataset final
         detail::BatchDataBuffer<UnwrappedBatchType, ExampleSamplerType>>(
         options_.batch_size(),
         example_sampler_,
-        options_.cache_size());
+        options_.cache_size(),
+        options_.cache_bytes());
 
     // create new workers for this new epoch.
     quit_worker_ = false;
+    active_preloaders_ = options_.adaptive_preloader_count()
+        ? 1
+        : options_.preloader_count();
+    last_consumer_waits_ = 0;
+    last_producer_waits_ = 0;
+    chunks_exhausted_ = false;
 
     AT_ASSERT(running_preloaders_ == 0);
     running_preloaders_ = options_.preloader_count();
@@ -422,7 +548,7 @@ class ChunkDataset final
  private:
   /// running on worker thread to preload chunk data.
   void preloader(size_t id) {
-    while (!quit_worker_.load()) {
+    while (wait_until_active(id)) {
       try {
         std::vector<size_t> chunk_idx;
         {
@@ -430,6 +556,12 @@ class ChunkDataset final
           if (auto chunk_sampler_result = chunk_sampler_.next(this->options_.cross_chunk_shuffle_count())) {
             chunk_idx = chunk_sampler_result.value();
           } else {
+            {
+              // wake the idle preloaders so that they exit too.
+              std::lock_guard<std::mutex> preloader_lock(preloader_mutex_);
+              chunks_exhausted_ = true;
+            }
+            preloader_cv_.notify_all();
             break;
           }
         }
@@ -457,10 +589,47 @@ class ChunkDataset final
     }
   }
 
+  /// Called by preloader `id` before loading a chunk. With an adaptive
+  /// preloader count, it first moves the number of active preloaders one step
+  /// towards where the wait counters of the batch buffer point since the last
+  /// call, then blocks preloader `id` while it isn't active. Returns false
+  /// when the preloader should exit.
+  bool wait_until_active(size_t id) {
+    if (!options_.adaptive_preloader_count()) {
+      return !quit_worker_.load();
+    }
+    std::unique_lock<std::mutex> lock(preloader_mutex_);
+    const auto consumer_waits = batch_buffer_->consumer_waits();
+    const auto producer_waits = batch_buffer_->producer_waits();
+    const bool consumer_starved = consumer_waits > last_consumer_waits_;
+    const bool producers_blocked = producer_waits > last_producer_waits_;
+    last_consumer_waits_ = consumer_waits;
+    last_producer_waits_ = producer_waits;
+    if (consumer_starved && !producers_blocked &&
+        active_preloaders_ < options_.preloader_count()) {
+      ++active_preloaders_;
+      lock.unlock();
+      preloader_cv_.notify_all();
+      lock.lock();
+    } else if (producers_blocked && !consumer_starved && active_preloaders_ > 1) {
+      --active_preloaders_;
+    }
+    preloader_cv_.wait(lock, [this, id] {
+      return id < active_preloaders_ || quit_worker_.load() ||
+          chunks_exhausted_;
+    });
+    return !quit_worker_.load();
+  }
+
   /// Block the current thread until the workers finish execution and exit.
   void free_workers() {
     if (!quit_worker_.load()) {
-      quit_worker_ = true;
+      {
+        // hold the lock so that no idle preloader misses the notification.
+        std::lock_guard<std::mutex> lock(preloader_mutex_);
+        quit_worker_ = true;
+      }
+      preloader_cv_.notify_all();
       for (auto& worker_thread : preload_threads_) {
         worker_thread.join();
       }
@@ -511,6 +680,23 @@ class ChunkDataset final
   // mutex to synchronize chunk sampler next() call.
   mutable std::mutex chunk_index_guard_;
 
+  // number of preloaders allowed to load chunks, the others wait on
+  // preloader_cv_. Always preloader_count unless adaptive_preloader_count is
+  // set.
+  size_t active_preloaders_ = 0;
+
+  // the wait counters of the batch buffer as of the last adjustment of
+  // active_preloaders_.
+  size_t last_consumer_waits_ = 0;
+  size_t last_producer_waits_ = 0;
+
+  // set once the chunk sampler is exhausted, to let idle preloaders exit.
+  bool chunks_exhausted_ = false;
+
+  // sync active_preloaders_ and the fields above.
+  std::mutex preloader_mutex_;
+  std::condition_variable preloader_cv_;
+
   // boolean value to indicate whether we need to load the checkpoint for chunk_sampler_.
   bool load_checkpoint_;
 };
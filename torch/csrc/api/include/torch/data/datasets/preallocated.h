@@ -0,0 +1,154 @@
+#pragma once
+
+#include <torch/data/datasets/base.h>
+#include <torch/data/example.h>
+#include <torch/types.h>
+
+#include <c10/util/ArrayRef.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+namespace torch {
+namespace data {
+namespace datasets {
+
+/// A pool of batch tensors. `acquire` returns a tensor backed by a free
+/// buffer of the pool that is large enough, or by a new one, and the buffer
+/// goes back to the pool when the last reference to that tensor is released.
+/// At most `max_free_buffers` buffers are kept once released, the others are
+/// freed. Thread safe, so that the workers of a `DataLoader` can share it.
+class BatchBufferPool : public std::enable_shared_from_this<BatchBufferPool> {
+ public:
+  explicit BatchBufferPool(size_t max_free_buffers = 8)
+      : max_free_buffers_(max_free_buffers) {}
+
+  /// Returns an uninitialized contiguous tensor of the given sizes and
+  /// options.
+  Tensor acquire(IntArrayRef sizes, const TensorOptions& options) {
+    const auto nbytes = std::accumulate(
+                            sizes.begin(),
+                            sizes.end(),
+                            int64_t(1),
+                            std::multiplies<int64_t>()) *
+        static_cast<int64_t>(options.dtype().itemsize());
+    const auto device = options.device();
+    Tensor buffer;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      for (auto it = free_buffers_.begin(); it != free_buffers_.end(); ++it) {
+        if (it->device().type() == device.type() &&
+            (!device.has_index() || it->device() == device) &&
+            it->numel() >= nbytes) {
+          buffer = std::move(*it);
+          free_buffers_.erase(it);
+          break;
+        }
+      }
+    }
+    if (!buffer.defined()) {
+      // Never hand out an empty buffer, since its data pointer may be null.
+      buffer = torch::empty(
+          {std::max<int64_t>(nbytes, 1)}, options.dtype(torch::kByte));
+    }
+    std::weak_ptr<BatchBufferPool> weak_pool = shared_from_this();
+    return torch::from_blob(
+        buffer.data_ptr(),
+        sizes,
+        [weak_pool, buffer](void* /* unused */) mutable {
+          if (auto pool = weak_pool.lock()) {
+            pool->release(std::move(buffer));
+          }
+        },
+        options);
+  }
+
+  /// The number of buffers currently waiting to be reused.
+  size_t free_buffers() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return free_buffers_.size();
+  }
+
+ private:
+  void release(Tensor buffer) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (free_buffers_.size() < max_free_buffers_) {
+      free_buffers_.push_back(std::move(buffer));
+    }
+  }
+
+  const size_t max_free_buffers_;
+  std::vector<Tensor> free_buffers_;
+  mutable std::mutex mutex_;
+};
+
+/// A dataset of `Example<>`s of fixed sizes that writes its examples directly
+/// into the slices of a batch, instead of returning them one by one to be
+/// stacked by `transforms::Stack`. The batch tensors come from a
+/// `BatchBufferPool`, so that their memory is reused once a batch is released.
+///
+/// Subclasses implement `get_into`, which writes the example at `index` into
+/// `data` and `target`, the slices of the batch for that example.
+template <typename Self>
+class PreallocatedDataset : public BatchDataset<Self, Example<>> {
+ public:
+  PreallocatedDataset(
+      std::vector<int64_t> data_sizes,
+      TensorOptions data_options,
+      std::vector<int64_t> target_sizes,
+      TensorOptions target_options = torch::kLong,
+      std::shared_ptr<BatchBufferPool> pool = nullptr)
+      : data_sizes_(std::move(data_sizes)),
+        data_options_(std::move(data_options)),
+        target_sizes_(std::move(target_sizes)),
+        target_options_(std::move(target_options)),
+        pool_(pool ? std::move(pool) : std::make_shared<BatchBufferPool>()) {}
+
+  /// Writes the example at `index` into `data` and `target`.
+  virtual void get_into(size_t index, Tensor data, Tensor target) = 0;
+
+  /// Returns the batch of the examples at the given indices, written by
+  /// `get_into` into tensors acquired from the pool.
+  Example<> get_batch(ArrayRef<size_t> indices) override {
+    auto data =
+        pool_->acquire(batch_sizes(data_sizes_, indices.size()), data_options_);
+    auto target = pool_->acquire(
+        batch_sizes(target_sizes_, indices.size()), target_options_);
+    for (size_t i = 0; i < indices.size(); ++i) {
+      get_into(indices[i], data[i], target[i]);
+    }
+    return {std::move(data), std::move(target)};
+  }
+
+  /// The pool the batch tensors are acquired from.
+  const std::shared_ptr<BatchBufferPool>& pool() const {
+    return pool_;
+  }
+
+ private:
+  static std::vector<int64_t> batch_sizes(
+      const std::vector<int64_t>& example_sizes,
+      size_t batch_size) {
+    std::vector<int64_t> sizes;
+    sizes.reserve(example_sizes.size() + 1);
+    sizes.push_back(batch_size);
+    sizes.insert(sizes.end(), example_sizes.begin(), example_sizes.end());
+    return sizes;
+  }
+
+  std::vector<int64_t> data_sizes_;
+  TensorOptions data_options_;
+  std::vector<int64_t> target_sizes_;
+  TensorOptions target_options_;
+  std::shared_ptr<BatchBufferPool> pool_;
+};
+} // namespace datasets
+} // namespace data
+} // namespace torch
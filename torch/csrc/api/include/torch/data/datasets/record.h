@@ -0,0 +1,105 @@
+#pragma once
+
+#include <torch/data/datasets/base.h>
+#include <torch/data/example.h>
+#include <torch/types.h>
+
+#include <torch/csrc/WindowsTorchApiMacro.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace torch {
+namespace data {
+namespace datasets {
+
+/// Writes `Example<>`s to a record file, to be read by a `RecordDataset`.
+///
+/// The tensors of every example are stored back to back, contiguous and
+/// aligned to 64 bytes, followed by an index of their types, sizes and offsets
+/// that `close` writes at the end of the file. Records are stored in the byte
+/// order of the machine writing them and read as is.
+class TORCH_API RecordWriter {
+ public:
+  /// Creates (or truncates) the record file at `path`.
+  explicit RecordWriter(const std::string& path);
+
+  /// Closes the file, if `close` was not called.
+  ~RecordWriter();
+
+  /// Appends an example to the file. The target may be undefined.
+  void write(const Tensor& data, const Tensor& target = Tensor());
+
+  /// Appends an example to the file.
+  void write(const Example<>& example) {
+    write(example.data, example.target);
+  }
+
+  /// Writes the index and closes the file. No records can be written after.
+  void close();
+
+  /// The number of records written so far.
+  size_t size() const noexcept {
+    return entries_.size();
+  }
+
+  /// The location of a tensor in a record file.
+  struct TensorEntry {
+    /// The `ScalarType` of the tensor, or -1 for an undefined tensor.
+    int64_t scalar_type = -1;
+    /// The offset of its data from the start of the file.
+    int64_t offset = 0;
+    std::vector<int64_t> sizes;
+  };
+
+  /// The locations of the data and target tensors of a record.
+  struct RecordEntry {
+    TensorEntry data;
+    TensorEntry target;
+  };
+
+ private:
+  TensorEntry write_tensor(const Tensor& tensor);
+
+  std::string path_;
+  std::ofstream stream_;
+  std::vector<RecordEntry> entries_;
+  bool closed_ = false;
+};
+
+/// A dataset of the `Example<>`s of a record file written by a `RecordWriter`.
+///
+/// The file is memory-mapped and `get` returns tensors viewing the mapping,
+/// without copying or reading the file. The pages of the file are read on
+/// first access and cached by the OS, and the mapping is private, so writing
+/// to the tensors does not change the file. Copies of the dataset, as made by
+/// the workers of a `DataLoader`, share the mapping, which stays alive as long
+/// as any of them or any tensor returned by `get`.
+///
+/// As any sized dataset, it can be sharded across processes and shuffled with
+/// a `samplers::DistributedRandomSampler`.
+class TORCH_API RecordDataset : public Dataset<RecordDataset> {
+ public:
+  /// Maps the record file at `path`.
+  explicit RecordDataset(const std::string& path);
+
+  /// Returns views of the tensors of the record at the given `index`.
+  Example<> get(size_t index) override;
+
+  /// Returns the number of records in the file.
+  optional<size_t> size() const override;
+
+ private:
+  Tensor view(const RecordWriter::TensorEntry& entry) const;
+
+  std::shared_ptr<at::DataPtr> mapping_;
+  size_t mapping_size_ = 0;
+  std::vector<RecordWriter::RecordEntry> entries_;
+};
+} // namespace datasets
+} // namespace data
+} // namespace torch
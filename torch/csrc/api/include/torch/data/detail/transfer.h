@@ -0,0 +1,104 @@
+#pragma once
+
+#include <torch/data/example.h>
+#include <torch/types.h>
+
+#include <utility>
+#include <vector>
+
+namespace torch {
+namespace data {
+namespace detail {
+
+/// Copies the tensors of a batch into pinned (page-locked) memory, from which
+/// they can be copied to a CUDA device asynchronously. Tensors, `Example`s and
+/// vectors of them are pinned, other types are returned as they are.
+template <typename T>
+T pin_memory(T value) {
+  return value;
+}
+
+inline Tensor pin_memory(Tensor tensor) {
+  if (!tensor.defined() || !tensor.device().is_cpu() || tensor.is_pinned()) {
+    return tensor;
+  }
+  return tensor.pin_memory();
+}
+
+template <typename Data, typename Target>
+Example<Data, Target> pin_memory(Example<Data, Target> example) {
+  example.data = pin_memory(std::move(example.data));
+  example.target = pin_memory(std::move(example.target));
+  return example;
+}
+
+template <typename Data>
+Example<Data, example::NoTarget> pin_memory(
+    Example<Data, example::NoTarget> example) {
+  example.data = pin_memory(std::move(example.data));
+  return example;
+}
+
+template <typename T>
+std::vector<T> pin_memory(std::vector<T> values) {
+  for (auto& value : values) {
+    value = pin_memory(std::move(value));
+  }
+  return values;
+}
+
+template <typename T>
+optional<T> pin_memory(optional<T> value) {
+  if (value) {
+    *value = pin_memory(std::move(*value));
+  }
+  return value;
+}
+
+/// Copies the tensors of a batch to `device`, on the current stream of the
+/// device. Like `pin_memory`, it recurses into `Example`s and vectors and
+/// leaves other types alone.
+template <typename T>
+T to_device(T value, Device /* unused */, bool /* unused */) {
+  return value;
+}
+
+inline Tensor to_device(Tensor tensor, Device device, bool non_blocking) {
+  if (!tensor.defined()) {
+    return tensor;
+  }
+  return tensor.to(device, non_blocking);
+}
+
+template <typename Data, typename Target>
+Example<Data, Target> to_device(
+    Example<Data, Target> example,
+    Device device,
+    bool non_blocking) {
+  example.data = to_device(std::move(example.data), device, non_blocking);
+  example.target = to_device(std::move(example.target), device, non_blocking);
+  return example;
+}
+
+template <typename Data>
+Example<Data, example::NoTarget> to_device(
+    Example<Data, example::NoTarget> example,
+    Device device,
+    bool non_blocking) {
+  example.data = to_device(std::move(example.data), device, non_blocking);
+  return example;
+}
+
+template <typename T>
+std::vector<T> to_device(
+    std::vector<T> values,
+    Device device,
+    bool non_blocking) {
+  for (auto& value : values) {
+    value = to_device(std::move(value), device, non_blocking);
+  }
+  return values;
+}
+} // namespace detail
+} // namespace data
+} // namespace torch
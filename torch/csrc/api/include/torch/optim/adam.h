@@ -50,6 +50,11 @@ class TORCH_API Adam : public Optimizer {
  private:
   Adam() : options(0) {}
 
+  /// Takes the step with a single `_multi_tensor_adam` call if all
+  /// parameters and their state are on the same CUDA device. Returns false,
+  /// without doing anything, otherwise.
+  bool multi_tensor_step();
+
   template <typename Self, typename Archive>
   static void serialize(Self& self, Archive& archive) {
     _TORCH_OPTIM_SERIALIZE(step_buffers);
@@ -79,6 +79,13 @@ class TORCH_API OptimizerBase {
   /// Additionally, zeros out the buffers when this is called on the index
   Tensor& buffer_at(std::vector<Tensor>& buffers, size_t index);
 
+  /// Returns true if all `tensors` can be updated by the fused multi-tensor
+  /// optimizer ops, such as `_multi_tensor_adam`: they must be dense,
+  /// contiguous CUDA tensors on the device and of the type of `like`.
+  static bool is_multi_tensor_applicable(
+      const std::vector<Tensor>& tensors,
+      const Tensor& like);
+
   /// The parameters this optimizer optimizes.
   std::vector<Tensor> parameters_;
 };
@@ -48,6 +48,11 @@ class TORCH_API SGD : public Optimizer {
  private:
   SGD() : options(0) {}
 
+  /// Takes the step with a single `_multi_tensor_sgd` call if all
+  /// parameters and their state are on the same CUDA device. Returns false,
+  /// without doing anything, otherwise.
+  bool multi_tensor_step();
+
   /// Counts how often `step()` is called, for dampening.
   int64_t iteration_{0};
 };
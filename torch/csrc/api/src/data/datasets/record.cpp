@@ -0,0 +1,229 @@
+#include <torch/data/datasets/record.h>
+
+#include <torch/data/example.h>
+#include <torch/types.h>
+
+#include <TH/THAllocator.h>
+#include <c10/util/Exception.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <fstream>
+#include <memory>
+#include <numeric>
+#include <string>
+#include <vector>
+
+namespace torch {
+namespace data {
+namespace datasets {
+namespace {
+constexpr char kMagic[8] = {'P', 'T', 'R', 'E', 'C', 'O', 'R', 'D'};
+constexpr uint64_t kVersion = 1;
+// The magic, the version, the number of records and the offset of the index.
+constexpr int64_t kHeaderSize = sizeof(kMagic) + 3 * sizeof(uint64_t);
+constexpr int64_t kAlignment = 64;
+
+void write_int64(std::ofstream& stream, int64_t value) {
+  stream.write(reinterpret_cast<const char*>(&value), sizeof value);
+}
+
+// Reads an int64 at `offset` in the mapping, advancing `offset`.
+int64_t read_int64(const char* base, size_t size, size_t& offset) {
+  TORCH_CHECK(
+      offset + sizeof(int64_t) <= size,
+      "Record file is truncated: expected to read at offset ",
+      offset,
+      " but the file has ",
+      size,
+      " bytes");
+  int64_t value;
+  std::memcpy(&value, base + offset, sizeof value);
+  offset += sizeof value;
+  return value;
+}
+
+RecordWriter::TensorEntry read_entry(
+    const char* base,
+    size_t size,
+    size_t& offset) {
+  RecordWriter::TensorEntry entry;
+  entry.scalar_type = read_int64(base, size, offset);
+  entry.offset = read_int64(base, size, offset);
+  const auto dim = read_int64(base, size, offset);
+  TORCH_CHECK(
+      dim >= 0 &&
+          static_cast<size_t>(dim) <= (size - offset) / sizeof(int64_t),
+      "Record file has a tensor of invalid dimension ",
+      dim);
+  entry.sizes.reserve(dim);
+  for (int64_t d = 0; d < dim; ++d) {
+    entry.sizes.push_back(read_int64(base, size, offset));
+    TORCH_CHECK(
+        entry.sizes.back() >= 0, "Record file has a tensor of negative size");
+  }
+  if (entry.scalar_type >= 0) {
+    TORCH_CHECK(
+        entry.scalar_type <
+            static_cast<int64_t>(ScalarType::NumOptions),
+        "Record file has a tensor of unknown type ",
+        entry.scalar_type);
+    const auto nbytes = static_cast<int64_t>(c10::elementSize(
+                            static_cast<ScalarType>(entry.scalar_type))) *
+        std::accumulate(
+            entry.sizes.begin(),
+            entry.sizes.end(),
+            int64_t(1),
+            std::multiplies<int64_t>());
+    TORCH_CHECK(
+        entry.offset >= kHeaderSize &&
+            entry.offset + nbytes <= static_cast<int64_t>(size),
+        "Record file has a tensor outside of the file");
+  }
+  return entry;
+}
+} // namespace
+
+RecordWriter::RecordWriter(const std::string& path)
+    : path_(path), stream_(path, std::ios::binary | std::ios::trunc) {
+  TORCH_CHECK(stream_, "Error opening record file at ", path);
+  // The header is written again by close(), once the index is known.
+  stream_.write(kMagic, sizeof(kMagic));
+  write_int64(stream_, kVersion);
+  write_int64(stream_, 0);
+  write_int64(stream_, 0);
+}
+
+RecordWriter::~RecordWriter() {
+  if (!closed_) {
+    try {
+      close();
+    } catch (...) {
+    }
+  }
+}
+
+RecordWriter::TensorEntry RecordWriter::write_tensor(const Tensor& tensor) {
+  TensorEntry entry;
+  if (!tensor.defined()) {
+    return entry;
+  }
+  TORCH_CHECK(
+      tensor.layout() == kStrided,
+      "RecordWriter only supports dense tensors");
+  const auto contiguous = tensor.to(kCPU).contiguous();
+  entry.scalar_type = static_cast<int64_t>(contiguous.scalar_type());
+  entry.sizes = contiguous.sizes().vec();
+
+  // Pad to the alignment, so that the tensor can be viewed in place.
+  int64_t offset = stream_.tellp();
+  const auto padding = (kAlignment - offset % kAlignment) % kAlignment;
+  static const char kZeros[kAlignment] = {};
+  stream_.write(kZeros, padding);
+  entry.offset = offset + padding;
+  stream_.write(
+      static_cast<const char*>(contiguous.data_ptr()), contiguous.nbytes());
+  return entry;
+}
+
+void RecordWriter::write(const Tensor& data, const Tensor& target) {
+  TORCH_CHECK(!closed_, "Cannot write to a closed RecordWriter");
+  RecordEntry entry;
+  entry.data = write_tensor(data);
+  entry.target = write_tensor(target);
+  TORCH_CHECK(stream_, "Error writing record file at ", path_);
+  entries_.push_back(std::move(entry));
+}
+
+void RecordWriter::close() {
+  TORCH_CHECK(!closed_, "RecordWriter is already closed");
+  closed_ = true;
+  const int64_t index_offset = stream_.tellp();
+  for (const auto& entry : entries_) {
+    for (const auto* tensor : {&entry.data, &entry.target}) {
+      write_int64(stream_, tensor->scalar_type);
+      write_int64(stream_, tensor->offset);
+      write_int64(stream_, tensor->sizes.size());
+      for (const auto size : tensor->sizes) {
+        write_int64(stream_, size);
+      }
+    }
+  }
+  stream_.seekp(sizeof(kMagic) + sizeof(uint64_t));
+  write_int64(stream_, entries_.size());
+  write_int64(stream_, index_offset);
+  stream_.close();
+  TORCH_CHECK(stream_, "Error writing record file at ", path_);
+}
+
+RecordDataset::RecordDataset(const std::string& path) {
+  mapping_ = std::make_shared<at::DataPtr>(THMapAllocator::makeDataPtr(
+      path.c_str(), /*flags=*/0, /*size=*/0, &mapping_size_));
+  const auto* base = static_cast<const char*>(mapping_->get());
+  TORCH_CHECK(
+      base != nullptr && mapping_size_ >= static_cast<size_t>(kHeaderSize) &&
+          std::memcmp(base, kMagic, sizeof(kMagic)) == 0,
+      "File at ",
+      path,
+      " is not a record file");
+
+  size_t offset = sizeof(kMagic);
+  const auto version = read_int64(base, mapping_size_, offset);
+  TORCH_CHECK(
+      version == kVersion,
+      "Record file at ",
+      path,
+      " has version ",
+      version,
+      ", expected ",
+      kVersion);
+  const auto count = read_int64(base, mapping_size_, offset);
+  offset = read_int64(base, mapping_size_, offset);
+  TORCH_CHECK(
+      count >= 0 && offset >= kHeaderSize,
+      "Record file at ",
+      path,
+      " has no index, was the RecordWriter closed?");
+  entries_.reserve(count);
+  for (int64_t i = 0; i < count; ++i) {
+    RecordWriter::RecordEntry entry;
+    entry.data = read_entry(base, mapping_size_, offset);
+    entry.target = read_entry(base, mapping_size_, offset);
+    entries_.push_back(std::move(entry));
+  }
+}
+
+Tensor RecordDataset::view(const RecordWriter::TensorEntry& entry) const {
+  if (entry.scalar_type < 0) {
+    return Tensor();
+  }
+  auto* data = static_cast<char*>(mapping_->get()) + entry.offset;
+  // The view keeps the mapping alive.
+  auto mapping = mapping_;
+  return torch::from_blob(
+      data,
+      entry.sizes,
+      [mapping](void* /* unused */) {},
+      static_cast<ScalarType>(entry.scalar_type));
+}
+
+Example<> RecordDataset::get(size_t index) {
+  TORCH_CHECK(
+      index < entries_.size(),
+      "Index ",
+      index,
+      " is out of range for a record file of ",
+      entries_.size(),
+      " records");
+  const auto& entry = entries_[index];
+  return {view(entry.data), view(entry.target)};
+}
+
+optional<size_t> RecordDataset::size() const {
+  return entries_.size();
+}
+} // namespace datasets
+} // namespace data
+} // namespace torch
@@ -7,8 +7,10 @@
 
 #include <ATen/ATen.h>
 
+#include <algorithm>
 #include <cmath>
 #include <functional>
+#include <vector>
 
 namespace torch {
 namespace optim {
@@ -16,6 +18,9 @@ AdamOptions::AdamOptions(double learning_rate)
     : learning_rate_(learning_rate) {}
 
 void Adam::step() {
+  if (multi_tensor_step()) {
+    return;
+  }
   for (size_t i = 0; i < parameters_.size(); ++i) {
     Tensor p = parameters_.at(i);
     if (!p.grad().defined()) {
@@ -57,6 +62,57 @@ void Adam::step() {
   }
 }
 
+bool Adam::multi_tensor_step() {
+  std::vector<size_t> indices;
+  std::vector<Tensor> params, grads;
+  for (size_t i = 0; i < parameters_.size(); ++i) {
+    if (parameters_[i].grad().defined()) {
+      indices.push_back(i);
+      params.push_back(parameters_[i]);
+      grads.push_back(parameters_[i].grad());
+    }
+  }
+  if (params.empty() || !is_multi_tensor_applicable(params, params[0]) ||
+      !is_multi_tensor_applicable(grads, params[0])) {
+    return false;
+  }
+
+  std::vector<Tensor> exp_averages, exp_average_sqs, max_exp_average_sqs;
+  for (size_t i : indices) {
+    exp_averages.push_back(buffer_at(exp_average_buffers, i));
+    exp_average_sqs.push_back(buffer_at(exp_average_sq_buffers, i));
+    if (options.amsgrad()) {
+      max_exp_average_sqs.push_back(buffer_at(max_exp_average_sq_buffers, i));
+    }
+  }
+  if (!is_multi_tensor_applicable(exp_averages, params[0]) ||
+      !is_multi_tensor_applicable(exp_average_sqs, params[0]) ||
+      !is_multi_tensor_applicable(max_exp_average_sqs, params[0])) {
+    return false;
+  }
+
+  std::vector<int64_t> steps;
+  for (size_t i : indices) {
+    steps.push_back(buffer_at(step_buffers, i) += 1);
+  }
+
+  NoGradGuard guard;
+  at::_multi_tensor_adam(
+      params,
+      grads,
+      exp_averages,
+      exp_average_sqs,
+      max_exp_average_sqs,
+      steps,
+      options.learning_rate(),
+      options.beta1(),
+      options.beta2(),
+      std::max(options.weight_decay(), 0.),
+      options.eps(),
+      options.amsgrad());
+  return true;
+}
+
 void Adam::save(serialize::OutputArchive& archive) const {
   serialize(*this, archive);
 }
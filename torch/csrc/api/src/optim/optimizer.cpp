@@ -5,6 +5,7 @@
 #include <torch/serialize/archive.h>
 #include <torch/types.h>
 
+#include <algorithm>
 #include <string>
 #include <utility>
 #include <vector>
@@ -57,6 +58,16 @@ Tensor& OptimizerBase::buffer_at(std::vector<Tensor>& buffers, size_t index) {
   return buffers[index];
 }
 
+bool OptimizerBase::is_multi_tensor_applicable(
+    const std::vector<Tensor>& tensors,
+    const Tensor& like) {
+  return std::all_of(tensors.begin(), tensors.end(), [&](const Tensor& t) {
+    return t.defined() && t.is_cuda() && t.layout() == kStrided &&
+        t.is_contiguous() && t.device() == like.device() &&
+        t.scalar_type() == like.scalar_type();
+  });
+}
+
 void OptimizerBase::save(serialize::OutputArchive& archive) const {}
 void OptimizerBase::load(serialize::InputArchive& archive) {}
 
@@ -9,13 +9,19 @@
 
 #include <ATen/ATen.h>
 
+#include <algorithm>
 #include <functional>
+#include <vector>
 
 namespace torch {
 namespace optim {
 SGDOptions::SGDOptions(double learning_rate) : learning_rate_(learning_rate) {}
 
 void SGD::step() {
+  if (multi_tensor_step()) {
+    iteration_ += 1;
+    return;
+  }
   for (size_t i = 0; i < parameters_.size(); ++i) {
     Tensor p = parameters_.at(i);
 
@@ -49,6 +55,46 @@ void SGD::step() {
   iteration_ += 1;
 }
 
+bool SGD::multi_tensor_step() {
+  std::vector<size_t> indices;
+  std::vector<Tensor> params, grads;
+  for (size_t i = 0; i < parameters_.size(); ++i) {
+    if (parameters_[i].grad().defined()) {
+      indices.push_back(i);
+      params.push_back(parameters_[i]);
+      grads.push_back(parameters_[i].grad());
+    }
+  }
+  if (params.empty() || !is_multi_tensor_applicable(params, params[0]) ||
+      !is_multi_tensor_applicable(grads, params[0])) {
+    return false;
+  }
+
+  std::vector<Tensor> momentums;
+  if (options.momentum() != 0) {
+    for (size_t i : indices) {
+      momentums.push_back(buffer_at(momentum_buffers, i));
+    }
+    if (!is_multi_tensor_applicable(momentums, params[0])) {
+      return false;
+    }
+  }
+
+  // The first step initializes the momentum buffers with the undampened
+  // update, as in the loop in step().
+  NoGradGuard guard;
+  at::_multi_tensor_sgd(
+      params,
+      grads,
+      momentums,
+      options.learning_rate(),
+      options.momentum(),
+      iteration_ == 0 ? 0 : options.dampening(),
+      std::max(options.weight_decay(), 0.),
+      options.nesterov());
+  return true;
+}
+
 void SGD::save(serialize::OutputArchive& archive) const {
   optim::serialize(archive, "momentum_buffers", momentum_buffers);
   optim::serialize(archive, "iteration_", iteration_);
@@ -176,6 +176,7 @@ Tensor & copy_(Tensor & self, const Tensor & src, bool non_blocking) {
   // it automatically
   auto& self_ = unpack(self, "self", 0);
   auto& src_ = unpack(src, "src", 1);
+  materialize_cow(self);
   check_inplace(self);
   std::shared_ptr<CopyBackwards> grad_fn;
   auto requires_grad = compute_requires_grad(self, src);
@@ -208,6 +209,7 @@ Tensor& resize_(
   if (as_variable_ref(self).requires_grad()) {
     AT_ERROR("cannot resize variables that require grad");
   }
+  materialize_cow(self);
   if (torch::jit::tracer::isTracing()) {
     jit::tracer::ArgumentStash::popIntArrayRef("size");
     jit::tracer::warn("resize_", jit::tracer::WARN_RESIZE);
@@ -229,6 +231,7 @@ Tensor& resize_as_(
   if (as_variable_ref(self).requires_grad()) {
     AT_ERROR("cannot resize variables that require grad");
   }
+  materialize_cow(self);
   if (torch::jit::tracer::isTracing()) {
     jit::tracer::warn("resize_as_", jit::tracer::WARN_RESIZE);
     jit::tracer::delValueTrace(self);
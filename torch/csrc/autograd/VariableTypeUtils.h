@@ -7,6 +7,7 @@
 #include <torch/csrc/autograd/edge.h>
 #include <torch/csrc/autograd/grad_mode.h>
 #include <torch/csrc/autograd/saved_variable.h>
+#include <torch/csrc/autograd/static_graph.h>
 #include <torch/csrc/autograd/generated/Functions.h>
 #include <torch/csrc/autograd/functions/tensor.h>
 #include <torch/csrc/autograd/functions/basic_ops.h>
@@ -15,6 +16,7 @@
 #include <torch/csrc/jit/ir.h>
 
 #include <torch/csrc/utils/variadic.h>
+#include <c10/core/impl/COW.h>
 #include <torch/csrc/autograd/functions/utils.h>
 
 #include <array>
@@ -47,6 +49,15 @@ inline void check_inplace(const Tensor& tensor) {
   }
 }
 
+// Called on the tensors in-place and out= ops write before calling the kernel,
+// see Note [Copy-on-write storages] in c10/core/impl/COW.h
+inline void materialize_cow(const Tensor& tensor) {
+  if (tensor.defined() && tensor.unsafeGetTensorImpl()->has_storage()) {
+    c10::impl::cow::materialize_if_cow(
+        *tensor.unsafeGetTensorImpl()->storage().unsafeGetStorageImpl());
+  }
+}
+
 inline void throw_error_out_requires_grad(const char* name) {
   AT_ERROR(
       name, "(): functions with out=... arguments don't support automatic differentiation, "
@@ -1,8 +1,74 @@
 #include <torch/csrc/autograd/anomaly_mode.h>
 
+#include <ATen/ATen.h>
+#include <c10/core/StreamGuard.h>
+#include <c10/core/impl/VirtualGuardImpl.h>
+
+#include <cmath>
+#include <mutex>
+#include <unordered_map>
+
 namespace torch { namespace autograd {
 
 bool AnomalyMode::_enabled = false;
+bool FiniteCheckMode::_enabled = false;
+
+// Note [Finite checks]
+// ~~~~~~~~~~~~~~~~~~~~
+// A sum is finite only if all the numbers it adds are, so instead of an
+// isfinite() reduction and a flag, every gradient is summed into a 0-dim
+// double tensor: a single reduction, and an add that stays on the device.
+// Summing in double keeps large but finite gradients from overflowing (an
+// overflow would only cause a spurious replay). There is one sum per stream,
+// the stream the node ran on, so the adds are ordered after the kernels that
+// computed the gradients without any synchronization between streams.
+
+namespace {
+
+struct FiniteCheckSums {
+  std::mutex mutex;
+  std::unordered_map<c10::Stream, at::Tensor> sums;
+};
+
+FiniteCheckSums& finite_check_sums() {
+  static FiniteCheckSums sums;
+  return sums;
+}
+
+} // namespace
+
+void FiniteCheckMode::accumulate(const std::vector<at::Tensor>& grads) {
+  auto& state = finite_check_sums();
+  for (const auto& grad : grads) {
+    if (!grad.defined() || grad.layout() != at::kStrided ||
+        !at::isFloatingType(grad.scalar_type())) {
+      continue;
+    }
+    const auto device = grad.device();
+    const auto stream =
+        c10::impl::VirtualGuardImpl{device.type()}.getStream(device);
+    auto sum = grad.sum(at::kDouble);
+    std::lock_guard<std::mutex> lock(state.mutex);
+    auto& total = state.sums[stream];
+    if (total.defined()) {
+      total.add_(sum);
+    } else {
+      total = std::move(sum);
+    }
+  }
+}
+
+bool FiniteCheckMode::nonfinite_found() {
+  auto& state = finite_check_sums();
+  std::lock_guard<std::mutex> lock(state.mutex);
+  bool found = false;
+  for (const auto& entry : state.sums) {
+    c10::StreamGuard guard(entry.first);
+    found = found || !std::isfinite(entry.second.item<double>());
+  }
+  state.sums.clear();
+  return found;
+}
 
 AnomalyMetadata::~AnomalyMetadata() = default;
 
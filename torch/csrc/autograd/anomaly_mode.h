@@ -2,6 +2,10 @@
 
 #include <torch/csrc/WindowsTorchApiMacro.h>
 
+#include <ATen/core/Tensor.h>
+
+#include <vector>
+
 namespace torch { namespace autograd {
 
 struct TORCH_API AnomalyMode {
@@ -16,6 +20,33 @@ private:
   static bool _enabled;
 };
 
+// A check that backward computes finite gradients, cheap enough to leave on
+// in training. While it is enabled, the engine adds up every gradient that
+// a node computes on the device, in double, without waiting for the result.
+// nonfinite_found() then synchronizes once with every stream that computed
+// gradients, to tell whether one of the sums isn't finite. Finding the node
+// that produced the nan or inf is left to a replay of the step with
+// AnomalyMode enabled as well, which makes the engine check the gradients of
+// every node as soon as they are computed.
+// See Note [Finite checks]
+struct TORCH_API FiniteCheckMode {
+  static bool is_enabled() {
+    return _enabled;
+  }
+  static void set_enabled(bool enabled) {
+    _enabled = enabled;
+  }
+
+  // Adds the floating point gradients computed by a node to the sums
+  static void accumulate(const std::vector<at::Tensor>& grads);
+  // Whether a gradient accumulated since the last call had a nan or an inf.
+  // Resets the sums.
+  static bool nonfinite_found();
+
+private:
+  static bool _enabled;
+};
+
 
 struct TORCH_API AnomalyMetadata {
   virtual ~AnomalyMetadata();
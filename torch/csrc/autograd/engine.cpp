@@ -5,12 +5,14 @@
 #include <torch/csrc/autograd/grad_mode.h>
 #include <torch/csrc/autograd/anomaly_mode.h>
 #include <torch/csrc/autograd/variable.h>
+#include <torch/csrc/autograd/static_graph.h>
 #include <torch/csrc/utils/memory.h>
 
 #include <ATen/DeviceGuard.h>
 #include <ATen/ExpandUtils.h>
 #include <ATen/Parallel.h>
 #include <c10/util/Exception.h>
+#include <c10/util/StringUtil.h>
 #include <c10/core/Stream.h>
 #include <c10/core/Event.h>
 #include <c10/core/DeviceGuard.h>
@@ -20,6 +22,7 @@
 #include <atomic>
 #include <condition_variable>
 #include <cstdint>
+#include <cstdlib>
 #include <functional>
 #include <iostream>
 #include <memory>
@@ -51,7 +54,8 @@ static thread_local bool checkpoint_valid = true;
 // apply will never be entered concurrently (even if multiple graphs are
 // executed at the same time). Adding multiple threads per-device or removing
 // engine thread affinity to the device can break this invariant, and we depend
-// on it in a few places (e.g. AccumulateGrad function).
+// on it in a few places (e.g. AccumulateGrad function). The one exception is
+// Note [Parallel CPU workers], which is opt-in.
 
 // Number of nested reentrant backwards calls currently on this thread
 static thread_local int current_depth = 0;
@@ -76,12 +80,31 @@ struct CompareNodeTaskTime {
   }
 };
 
+// See Note [ReadyQueue]
 struct ReadyQueue {
+  // A task pushed to the queue that no worker has moved into heap_ yet
+  struct Pushed {
+    NodeTask task_;
+    Pushed* next_;
+  };
+
+  // Lock-free stack of the pushed tasks, newest first
+  std::atomic<Pushed*> pushed_{nullptr};
   std::priority_queue<NodeTask, std::vector<NodeTask>, CompareNodeTaskTime> heap_;
-  // To notify threads waiting on the ReadyQueue of available tasks on the heap_
+  // To notify threads waiting on the ReadyQueue of pushed tasks
   std::condition_variable not_empty_;
-  // To protect read and writes to heap_
+  // To protect read and writes to heap_, and to wait on not_empty_
   std::mutex mutex_;
+  // Number of threads waiting on not_empty_
+  std::atomic<int> sleepers_{0};
+
+  std::atomic<int64_t> tasks_pushed_{0};
+  std::atomic<int64_t> tasks_popped_{0};
+  std::atomic<int64_t> batches_{0};
+  std::atomic<int64_t> parks_{0};
+
+  ReadyQueue() = default;
+  ~ReadyQueue();
 
   // incrementOutstandingTasks indicates whether or not we should increment
   // 'outstanding_tasks_' for the associated GraphTask. This should mostly
@@ -89,7 +112,19 @@ struct ReadyQueue {
   // might set this to false.
   void push(NodeTask item, bool incrementOutstandingTasks = true);
   void pushShutdownTask();
-  NodeTask pop();
+  // Blocks until a task is available. If graph_task is given, returns nullopt
+  // instead once graph_task has no outstanding tasks left, which can happen
+  // when another thread sharing this queue ran its last task.
+  c10::optional<NodeTask> pop(const GraphTask* graph_task = nullptr);
+  // Wakes up the threads waiting in pop() for a graph_task to finish
+  void notifyGraphTaskDone();
+  bool empty();
+  void addStats(EngineStats& stats) const;
+
+ private:
+  void enqueue(NodeTask item);
+  // Moves the pushed tasks into heap_; must be called with mutex_ held
+  void drainPushed();
 };
 
 // Note [Reentrant backwards]
@@ -151,45 +186,170 @@ struct ReadyQueue {
 // the leaf streams with the default streams is sufficient to implement
 // the historic behavior.
 
+// Note [ReadyQueue]
+// ~~~~~~~~~~~~~~~~~
+// Every finished node pushes its ready successors, and in a graph of many
+// tiny nodes (an unrolled RNN, say) locking the queue for each push shows up
+// in the profile, mostly as contention between the pushing thread and the
+// worker draining the queue. So pushing doesn't lock: tasks go onto a
+// lock-free stack, and a worker that pops takes the whole stack at once and
+// moves it into its priority heap, under the queue mutex that only the
+// workers of that queue (usually just one) take. Popping in priority order
+// needs the heap, but the heap only sees one lock and one atomic exchange per
+// batch of pushed tasks. A pusher only touches the mutex when a worker is
+// asleep.
+//
+// Sleeping is the delicate part: a worker increments sleepers_ and then checks
+// pushed_ before waiting, and a pusher updates pushed_ and then checks
+// sleepers_. Both use sequentially consistent operations, so at least one of
+// them sees the other.
+
+// Note [Parallel CPU workers]
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// By default a single thread runs all the CPU nodes of every backward pass,
+// so the independent branches of a wide model (towers, ensembles, multi-head
+// losses) are differentiated one after the other. Setting
+// PYTORCH_AUTOGRAD_CPU_THREADS=N starts N threads that all pop tasks from the
+// CPU ReadyQueue, so that up to N ready CPU nodes run at the same time.
+//
+//  - A node still runs at most once per GraphTask, and a GraphTask's
+//    dependency counters are atomic, so the workers never lock to schedule a
+//    node. The GraphTask mutex only guards the input buffers of nodes that
+//    are waiting for more gradients.
+//
+//  - Gradients flowing into such a buffer are summed with
+//    InputBuffer::add_deferred()/flush_deferred() in the order of their
+//    producers' sequence numbers, so the result doesn't depend on which
+//    producer finished first. The summands are kept until the node is ready,
+//    which costs memory when a node has many producers.
+//
+//  - A worker that calls backward reentrantly waits in ReadyQueue::pop() for
+//    its GraphTask, so it is woken up even when another worker of the queue
+//    runs the last task (see Note [Reentrant backwards]).
+//
+//  - Every worker gets an intra-op thread budget of its share of the intra-op
+//    threads, so that the workers don't oversubscribe the machine.
+//
+// Nodes shared between GraphTasks that run concurrently (AccumulateGrad of a
+// parameter, or any node of a graph that is differentiated from several
+// threads at once) may then be entered concurrently. AccumulateGrad locks
+// for that; custom C++ nodes used this way must be thread-safe.
+
 int NodeTask::getReentrantDepth() const {
   std::shared_ptr<GraphTask> graph_task = base_.lock();
   TORCH_INTERNAL_ASSERT(graph_task, "GraphTask is no longer valid!")
   return graph_task->reentrant_depth_;
 }
 
-auto ReadyQueue::push(NodeTask item, bool incrementOutstandingTasks) -> void {
-  {
-    // Lock mutex for writing to heap_
-    std::lock_guard<std::mutex> lock(mutex_);
-    if (incrementOutstandingTasks) {
-      std::shared_ptr<GraphTask> graph_task = item.base_.lock();
-      TORCH_INTERNAL_ASSERT(graph_task, "GraphTask is no longer valid!");
-      ++graph_task->outstanding_tasks_;
+ReadyQueue::~ReadyQueue() {
+  Pushed* pushed = pushed_.exchange(nullptr);
+  while (pushed) {
+    std::unique_ptr<Pushed> current(pushed);
+    pushed = current->next_;
+  }
+}
+
+auto ReadyQueue::enqueue(NodeTask item) -> void {
+  auto* pushed = new Pushed{std::move(item), pushed_.load(std::memory_order_relaxed)};
+  while (!pushed_.compare_exchange_weak(pushed->next_, pushed)) {}
+  tasks_pushed_.fetch_add(1, std::memory_order_relaxed);
+  if (sleepers_.load() > 0) {
+    {
+      // Orders the notification with a sleeper testing pushed_
+      std::lock_guard<std::mutex> lock(mutex_);
     }
-    heap_.push(std::move(item));
+    not_empty_.notify_one();
   }
-  not_empty_.notify_one();
+}
+
+auto ReadyQueue::push(NodeTask item, bool incrementOutstandingTasks) -> void {
+  if (incrementOutstandingTasks) {
+    std::shared_ptr<GraphTask> graph_task = item.base_.lock();
+    TORCH_INTERNAL_ASSERT(graph_task, "GraphTask is no longer valid!");
+    ++graph_task->outstanding_tasks_;
+  }
+  enqueue(std::move(item));
 }
 
 auto ReadyQueue::pushShutdownTask() -> void {
-  {
-    std::lock_guard<std::mutex> lock(mutex_);
-    heap_.push(NodeTask({}, nullptr, InputBuffer(0), true));
+  enqueue(NodeTask({}, nullptr, InputBuffer(0), true));
+}
+
+auto ReadyQueue::drainPushed() -> void {
+  Pushed* pushed = pushed_.exchange(nullptr);
+  if (!pushed) {
+    return;
+  }
+  batches_.fetch_add(1, std::memory_order_relaxed);
+  while (pushed) {
+    std::unique_ptr<Pushed> current(pushed);
+    heap_.push(std::move(current->task_));
+    pushed = current->next_;
   }
-  not_empty_.notify_one();
 }
 
-auto ReadyQueue::pop() -> NodeTask {
+auto ReadyQueue::pop(const GraphTask* graph_task) -> c10::optional<NodeTask> {
   // Lock mutex for accesses to heap_
   std::unique_lock<std::mutex> lock(mutex_);
-  not_empty_.wait(lock, [this]{ return !heap_.empty(); });
+  auto graph_task_done = [graph_task]{
+    return graph_task && graph_task->outstanding_tasks_.load() == 0;
+  };
+  auto ready = [&]{
+    return !heap_.empty() || pushed_.load() != nullptr || graph_task_done();
+  };
+  if (!ready()) {
+    // See Note [ReadyQueue] for why ready() is tested again after this
+    ++sleepers_;
+    parks_.fetch_add(1, std::memory_order_relaxed);
+    not_empty_.wait(lock, ready);
+    --sleepers_;
+  }
+  if (graph_task_done()) {
+    return c10::nullopt;
+  }
+  drainPushed();
+  tasks_popped_.fetch_add(1, std::memory_order_relaxed);
   // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
   auto task = std::move(const_cast<NodeTask&>(heap_.top())); heap_.pop();
-  return task;
+  return std::move(task);
+}
+
+auto ReadyQueue::notifyGraphTaskDone() -> void {
+  {
+    // Taking the mutex orders this with a waiter testing outstanding_tasks_
+    // in pop(), so it can't miss the notification
+    std::lock_guard<std::mutex> lock(mutex_);
+  }
+  not_empty_.notify_all();
+}
+
+auto ReadyQueue::empty() -> bool {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return heap_.empty() && pushed_.load() == nullptr;
+}
+
+auto ReadyQueue::addStats(EngineStats& stats) const -> void {
+  stats.tasks_pushed += tasks_pushed_.load(std::memory_order_relaxed);
+  stats.tasks_popped += tasks_popped_.load(std::memory_order_relaxed);
+  stats.batches += batches_.load(std::memory_order_relaxed);
+  stats.parks += parks_.load(std::memory_order_relaxed);
+}
+
+static int num_cpu_threads_from_env() {
+  try {
+    if (auto* value = std::getenv("PYTORCH_AUTOGRAD_CPU_THREADS")) {
+      int nthreads = c10::stoi(value);
+      TORCH_CHECK(nthreads > 0);
+      return nthreads;
+    }
+  } catch (const std::exception& e) {
+    TORCH_WARN("Invalid PYTORCH_AUTOGRAD_CPU_THREADS variable value, ", e.what());
+  }
+  return 1;
 }
 
 // This limit is based on the default python recursion limit which is 1000
-Engine::Engine() : max_recursion_depth_(100) {}
+Engine::Engine() : max_recursion_depth_(100), num_cpu_threads_(1) {}
 
 // Send shutdown tasks to all ReadyQueues if no backward tasks are running
 // Even though readyQueue should be empty, shutdown tasks have the highest
@@ -197,12 +357,15 @@ Engine::Engine() : max_recursion_depth_(100) {}
 Engine::~Engine() {
   bool noBackward = true;
   for (auto& queue: ready_queues_) {
-    std::lock_guard<std::mutex> lock(queue->mutex_);
-    noBackward =  noBackward && queue->heap_.empty();
+    noBackward =  noBackward && queue->empty();
   }
   if (noBackward) {
-    for (auto& queue : ready_queues_) {
-     queue->pushShutdownTask();
+    for (size_t i = 0; i < ready_queues_.size(); i++) {
+      // One for each of the threads sharing the CPU queue
+      const int num_threads = i == 0 ? num_cpu_threads_ : 1;
+      for (int j = 0; j < num_threads; j++) {
+        ready_queues_[i]->pushShutdownTask();
+      }
     }
   }
   // Othewise threads are leaked
@@ -248,6 +411,11 @@ auto Engine::thread_init(int device) -> void {
   // arbitrarily picked to colocate devices.  Maybe the other approach is
   // better.
   set_device(device);
+  if (device == -1 && num_cpu_threads_ > 1) {
+    // See Note [Parallel CPU workers]
+    at::set_intraop_thread_budget(
+        std::max(1, at::get_num_threads() / num_cpu_threads_));
+  }
   std::shared_ptr<GraphTask> graph_task = nullptr;
   thread_main(graph_task, /* reentrant_thread */ false);
 }
@@ -277,7 +445,12 @@ auto Engine::thread_main(
   // Why the test on graph_task->outstanding_tasks_?  See
   // Note [Reentrant backwards]
   while (!reentrant_thread || graph_task->outstanding_tasks_ > 0) {
-    NodeTask task = queue->pop();
+    auto maybe_task = queue->pop(reentrant_thread ? graph_task.get() : nullptr);
+    if (!maybe_task) {
+      // Another thread of this queue finished graph_task
+      break;
+    }
+    NodeTask task = std::move(*maybe_task);
     // This will only work if the worker is running a non backward task
     // TODO Needs to be fixed this to work in all cases
     if (task.isShutdownTask_) {
@@ -318,10 +491,13 @@ auto Engine::thread_main(
         local_graph_task->not_done_.notify_all();
       }
     } else {
-      // If it's a task initiated from this thread, decrease the counter, but
-      // don't do anything - loop condition will do all checks for us next.
+      // If it's a task initiated from a thread of this queue, decrease the
+      // counter. If it was this thread, the loop condition will do all checks
+      // for us next; otherwise the owner may be waiting in pop().
       if (base_owner == worker_device) {
-        --local_graph_task->outstanding_tasks_;
+        if (--local_graph_task->outstanding_tasks_ == 0) {
+          queue->notifyGraphTaskDone();
+        }
         // Otherwise send a dummy function task to the owning thread just to
         // ensure that it's not sleeping. If it has work, it might see that
         // graph_task->outstanding_tasks_ == 0 before it gets to the task, but
@@ -562,10 +738,11 @@ void Engine::evaluate_function(
   }
 
   int num_outputs = outputs.size();
-  if (num_outputs == 0) { // Note: doesn't acquire the mutex
+  if (num_outputs == 0) {
     // Records leaf stream (if applicable)
     // See note "Streaming backwards"
     if (opt_parent_stream) {
+      std::lock_guard<std::mutex> lock(graph_task->mutex_);
       graph_task->leaf_streams.emplace(*opt_parent_stream);
     }
     return;
@@ -581,73 +758,102 @@ void Engine::evaluate_function(
         ss << "Function '" << fn.name() << "' returned nan values in its " << i << "th output.";
         throw std::runtime_error(ss.str());
       }
+      if (FiniteCheckMode::is_enabled() && output.defined() &&
+          output.layout() == at::kStrided &&
+          !at::isfinite(output).all().item<uint8_t>()) {
+        std::stringstream ss;
+        ss << "Function '" << fn.name() << "' returned non-finite values in its " << i << "th output.";
+        throw std::runtime_error(ss.str());
+      }
     }
+  } else if (FiniteCheckMode::is_enabled()) {
+    AutoGradMode grad_mode(false);
+    FiniteCheckMode::accumulate(outputs);
   }
 
-  // Lock mutex for the accesses to GraphTask dependencies_ and not_ready_ below
-  std::lock_guard<std::mutex> lock(graph_task->mutex_);
+  // See Note [Parallel CPU workers]
+  const bool defer_accumulation = num_cpu_threads_ > 1;
+  auto& dependencies = graph_task->dependencies_;
+  auto& not_ready = graph_task->not_ready_;
   for (int i = 0; i < num_outputs; ++i) {
     auto& output = outputs[i];
     const auto& next = fn.next_edge(i);
 
     if (!next.is_valid()) continue;
 
-    // Check if the next function is ready to be computed
-    bool is_ready = false;
-    auto& dependencies = graph_task->dependencies_;
     auto it = dependencies.find(next.function.get());
-
     if (it == dependencies.end()) {
       auto name = next.function->name();
       throw std::runtime_error(std::string("dependency not found for ") + name);
-    } else if (--it->second == 0) {
-      dependencies.erase(it);
-      is_ready = true;
     }
 
-    auto& not_ready = graph_task->not_ready_;
-    auto not_ready_it = not_ready.find(next.function.get());
-    if (not_ready_it == not_ready.end()) {
-      // Skip functions that aren't supposed to be executed
-      if (!exec_info_.empty()) {
-        auto it = exec_info_.find(next.function.get());
-        if (it == exec_info_.end() || !it->second.should_execute()) {
-          continue;
-        }
+    // Skip functions that aren't supposed to be executed
+    if (!exec_info_.empty()) {
+      auto exec_it = exec_info_.find(next.function.get());
+      if (exec_it == exec_info_.end() || !exec_it->second.should_execute()) {
+        continue;
       }
-      // No buffers have been allocated for the function
-      InputBuffer input_buffer(next.function->num_inputs());
-
-      // Accumulates into buffer
-      const auto opt_next_stream = next.function->stream(c10::DeviceType::CUDA);
-      input_buffer.add(next.input_nr,
-                       std::move(output),
-                       opt_parent_stream,
-                       opt_next_stream);
+    }
 
-      if (is_ready) {
-        auto& queue = ready_queue(input_buffer.device());
-        queue.push(
-            NodeTask(graph_task, next.function, std::move(input_buffer)));
+    const auto opt_next_stream = next.function->stream(c10::DeviceType::CUDA);
+    auto accumulate = [&](InputBuffer& input_buffer) {
+      if (defer_accumulation) {
+        input_buffer.add_deferred(next.input_nr,
+                                  std::move(output),
+                                  fn.sequence_nr(),
+                                  opt_parent_stream,
+                                  opt_next_stream);
       } else {
-        not_ready.emplace(next.function.get(), std::move(input_buffer));
+        input_buffer.add(next.input_nr,
+                         std::move(output),
+                         opt_parent_stream,
+                         opt_next_stream);
       }
-    } else {
-      // The function already has a buffer
-      auto &input_buffer = not_ready_it->second;
+    };
+
+    // Every producer accumulates into the buffer before it decrements the
+    // counter, so whoever brings the counter to zero finds the other inputs in
+    // the buffer. A counter of one means that this is the last producer.
+    bool accumulated = false;
+    if (it->second.load() != 1) {
+      {
+        std::lock_guard<std::mutex> lock(graph_task->mutex_);
+        auto not_ready_it = not_ready.find(next.function.get());
+        if (not_ready_it == not_ready.end()) {
+          // No buffers have been allocated for the function
+          not_ready_it = not_ready.emplace(
+              next.function.get(), InputBuffer(next.function->num_inputs())).first;
+        }
+        accumulate(not_ready_it->second);
+      }
+      accumulated = true;
+      if (--it->second != 0) {
+        continue;
+      }
+    }
 
-      // Accumulates into buffer
-      const auto opt_next_stream = next.function->stream(c10::DeviceType::CUDA);
+    // Check if the function already has a buffer
+    std::unique_lock<std::mutex> lock(graph_task->mutex_);
+    auto not_ready_it = not_ready.find(next.function.get());
+    if (not_ready_it == not_ready.end()) {
+      lock.unlock();
+      InputBuffer input_buffer(next.function->num_inputs());
       input_buffer.add(next.input_nr,
                        std::move(output),
                        opt_parent_stream,
                        opt_next_stream);
-      if (is_ready) {
-        auto& queue = ready_queue(input_buffer.device());
-        queue.push(
-            NodeTask(graph_task, next.function, std::move(input_buffer)));
-        not_ready.erase(not_ready_it);
+      auto& queue = ready_queue(input_buffer.device());
+      queue.push(NodeTask(graph_task, next.function, std::move(input_buffer)));
+    } else {
+      InputBuffer input_buffer = std::move(not_ready_it->second);
+      not_ready.erase(not_ready_it);
+      lock.unlock();
+      if (!accumulated) {
+        accumulate(input_buffer);
       }
+      input_buffer.flush_deferred();
+      auto& queue = ready_queue(input_buffer.device());
+      queue.push(NodeTask(graph_task, next.function, std::move(input_buffer)));
     }
   }
 }
@@ -710,12 +916,24 @@ auto Engine::execute(const edge_list& roots,
 
   // Now compute the dependencies for all executable functions and queue the root
   auto graph_root = std::make_shared<GraphRoot>(roots, inputs);
-  compute_dependencies(graph_root.get(), *graph_task);
+  // A static graph can hand over the dependencies of its last backward
+  // See Note [Static graphs]
+  auto* static_graph = outputs.empty() ? StaticGraph::current() : nullptr;
+  if (!static_graph || !static_graph->restore_dependencies(roots, *graph_task)) {
+    compute_dependencies(graph_root.get(), *graph_task);
+    if (static_graph) {
+      static_graph->remember_dependencies(roots, *graph_task);
+    }
+  }
 
   if (!outputs.empty()) {
     graph_task->init_to_execute(*graph_root, outputs);
   }
-  return execute_with_graph_task(graph_task, graph_root);
+  auto captured_vars = execute_with_graph_task(graph_task, graph_root);
+  if (static_graph) {
+    static_graph->keep_dependencies(*graph_task);
+  }
+  return captured_vars;
 }
 
 void Engine::enqueue_blocked_task_on_cpu(NodeTask task) {
@@ -830,6 +1048,15 @@ bool Engine::is_checkpoint_valid() {
   return checkpoint_valid;
 }
 
+EngineStats Engine::stats() {
+  std::call_once(start_threads_flag_, &Engine::start_threads, this);
+  EngineStats stats;
+  for (const auto& queue : ready_queues_) {
+    queue->addStats(stats);
+  }
+  return stats;
+}
+
 auto Engine::ready_queue(at::Device device) -> ReadyQueue& {
   // See Note [Allocating GPUs to autograd threads]
   if (device.type() == at::kCPU) {
@@ -856,16 +1083,23 @@ auto Engine::start_threads() -> void {
     }
   }
 
-  // One for CPU, plus one for every GPU device (but colocate GPUs of different
-  // types)
-  int num_threads = num_devices + 1;
-  ready_queues_ = std::vector<std::shared_ptr<ReadyQueue>>(num_threads);
+  // One queue for CPU, plus one for every GPU device (but colocate GPUs of
+  // different types)
+  int num_queues = num_devices + 1;
+  ready_queues_ = std::vector<std::shared_ptr<ReadyQueue>>(num_queues);
   for (auto& queue : ready_queues_)
     queue.reset(new ReadyQueue());
 
   thread_pool_shared_ = std::make_shared<ThreadPoolShared>();
 
-  for (int i = 0; i < num_threads; ++i) {
+  // One thread per GPU queue, and num_cpu_threads_ threads sharing the CPU
+  // queue. See Note [Parallel CPU workers]
+  num_cpu_threads_ = num_cpu_threads_from_env();
+  for (int i = 0; i < num_cpu_threads_; ++i) {
+    std::thread t(&Engine::thread_init, this, -1);
+    t.detach();
+  }
+  for (int i = 1; i < num_queues; ++i) {
     std::thread t(&Engine::thread_init, this, i - 1);
     t.detach();
   }
@@ -10,6 +10,7 @@
 #include <torch/csrc/autograd/functions/basic_ops.h>
 #include <torch/csrc/autograd/input_buffer.h>
 
+#include <atomic>
 #include <deque>
 #include <exception>
 #include <functional>
@@ -45,14 +46,16 @@ struct GraphTask {
   bool keep_graph_;
   bool grad_mode_;
 
-  // To protect reads/writes to no_ready_, dependencies_ , captured_vars_ and
+  // To protect reads/writes to not_ready_, captured_vars_, leaf_streams and
   // exception_
   std::mutex mutex_;
   // Notified when a task finishes executing.  Check outstanding_tasks_ to see
   // if all tasks are done.
   std::condition_variable not_done_;
   std::unordered_map<Node*, InputBuffer> not_ready_;
-  std::unordered_map<Node*, int> dependencies_;
+  // Filled in before the graph is executed; after that only the counters
+  // change, so workers can decrement them without holding mutex_
+  std::unordered_map<Node*, std::atomic<int>> dependencies_;
 
   struct ExecInfo {
     struct Capture {
@@ -141,6 +144,19 @@ struct NodeTask {
         isShutdownTask_(isShutdownTask) {}
 };
 
+// Counters of the engine's ready queues, since its threads started.
+// See Note [ReadyQueue]
+struct EngineStats {
+  // tasks pushed to a ready queue
+  int64_t tasks_pushed = 0;
+  // tasks popped by a worker
+  int64_t tasks_popped = 0;
+  // times a worker moved the tasks pushed since its last pop into the heap
+  int64_t batches = 0;
+  // times a worker went to sleep on an empty queue
+  int64_t parks = 0;
+};
+
 // A single instance of this struct should be created through the whole process lifetime.
 // The worker thread creation logic and Engine's destructor rely on this.
 struct TORCH_API Engine {
@@ -151,7 +167,7 @@ struct TORCH_API Engine {
   virtual ~Engine();
 
   using ready_queue_type = std::deque<std::pair<std::shared_ptr<Node>, InputBuffer>>;
-  using dependencies_type = std::unordered_map<Node*, int>;
+  using dependencies_type = std::unordered_map<Node*, std::atomic<int>>;
 
   // Given a list of (Node, input number) pairs computes the value of the graph
   // by following next_edge references.
@@ -191,6 +207,9 @@ struct TORCH_API Engine {
 
   bool is_checkpoint_valid();
 
+  // Sums the counters of all ready queues
+  EngineStats stats();
+
 protected:
   void compute_dependencies(Node* root, GraphTask& task);
   void evaluate_function(
@@ -221,6 +240,11 @@ protected:
   std::mutex post_callbacks_lock_;
   // How many nested reentrant calls are allowed until a new thread is used
   int max_recursion_depth_;
+  // Number of worker threads sharing the CPU ReadyQueue, read from
+  // PYTORCH_AUTOGRAD_CPU_THREADS when the threads are started. With more than
+  // one, independent CPU branches of a graph run concurrently.
+  // See Note [Parallel CPU workers]
+  int num_cpu_threads_;
 
   struct ThreadPoolShared {
     // Data structures used by the threads for executing reentrant backwards
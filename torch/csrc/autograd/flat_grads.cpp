@@ -0,0 +1,89 @@
+#include <torch/csrc/autograd/flat_grads.h>
+
+#include <torch/csrc/autograd/grad_mode.h>
+
+#include <ATen/ATen.h>
+#include <c10/util/Exception.h>
+
+#include <utility>
+
+namespace torch { namespace autograd {
+
+void set_grad_in_buffer(
+    const Variable& variable,
+    const at::Tensor& buffer,
+    int64_t offset) {
+  TORCH_CHECK(buffer.dim() == 1 && buffer.is_contiguous(),
+      "set_grad_in_buffer: expected a flat contiguous buffer");
+  TORCH_CHECK(variable.device() == buffer.device() &&
+      variable.scalar_type() == buffer.scalar_type(),
+      "set_grad_in_buffer: the buffer is a ", buffer.toString(), " on ",
+      buffer.device(), ", but the variable a ", variable.toString(), " on ",
+      variable.device());
+  TORCH_CHECK(offset >= 0 && offset + variable.numel() <= buffer.numel(),
+      "set_grad_in_buffer: ", variable.numel(), " elements from offset ",
+      offset, " don't fit into a buffer of ", buffer.numel());
+  AutoGradMode grad_mode(false);
+  auto grad = at::empty({0}, buffer.options());
+  grad.set_(
+      buffer.storage(),
+      buffer.storage_offset() + offset,
+      variable.sizes(),
+      at::detail::defaultStrides(variable.sizes()));
+  // A handle to the same variable, which we can set the .grad of
+  Variable target = variable;
+  const auto& current = target.grad();
+  if (current.defined()) {
+    if (current.is_sparse()) {
+      grad.zero_();
+      grad += current;
+    } else {
+      grad.copy_(current);
+    }
+  } else {
+    grad.zero_();
+  }
+  target.grad() = std::move(grad);
+}
+
+std::vector<at::Tensor> flatten_grads(const variable_list& variables) {
+  struct Group {
+    at::TensorOptions options;
+    std::vector<const Variable*> variables;
+    int64_t numel = 0;
+  };
+  std::vector<Group> groups;
+  for (const auto& variable : variables) {
+    TORCH_CHECK(variable.defined() && variable.layout() == at::kStrided,
+        "flatten_grads: expected dense variables");
+    auto it = groups.begin();
+    for (; it != groups.end(); it++) {
+      if (it->options.device() == variable.device() &&
+          it->options.dtype() == variable.dtype()) {
+        break;
+      }
+    }
+    if (it == groups.end()) {
+      groups.emplace_back();
+      it = groups.end() - 1;
+      it->options = variable.options();
+    }
+    it->variables.push_back(&variable);
+    it->numel += variable.numel();
+  }
+
+  std::vector<at::Tensor> buffers;
+  buffers.reserve(groups.size());
+  for (const auto& group : groups) {
+    auto buffer = at::empty({group.numel}, group.options);
+    int64_t offset = 0;
+    for (const auto* variable : group.variables) {
+      set_grad_in_buffer(*variable, buffer, offset);
+      offset += variable->numel();
+    }
+    buffers.push_back(std::move(buffer));
+  }
+  return buffers;
+}
+
+}} // namespace torch::autograd
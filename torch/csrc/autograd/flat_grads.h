@@ -0,0 +1,31 @@
+#pragma once
+
+#include <torch/csrc/WindowsTorchApiMacro.h>
+#include <torch/csrc/autograd/variable.h>
+
+#include <ATen/core/Tensor.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace torch { namespace autograd {
+
+// Makes the .grad of a variable the numel() elements of a flat buffer that
+// start at offset, keeping the value of the current .grad, or zeroing them
+// if there is none. AccumulateGrad then adds the gradients of a backward()
+// there in place. The .grad shares the storage of the buffer without being
+// an autograd view of it, so it can still be detach_()ed in place, as
+// zero_grad() does. Assigning another tensor to the .grad, or accumulating
+// with create_graph=True, takes it out of the buffer again.
+TORCH_API void set_grad_in_buffer(
+    const Variable& variable,
+    const at::Tensor& buffer,
+    int64_t offset);
+
+// Allocates one flat buffer per device and dtype for the gradients of the
+// variables, and makes their .grads parts of it, in the order of the
+// variables. Returns the buffers, in the order the variables first use them.
+// Optimizers can then update all the parameters of a buffer at once.
+TORCH_API std::vector<at::Tensor> flatten_grads(const variable_list& variables);
+
+}} // namespace torch::autograd
@@ -27,6 +27,7 @@ namespace torch { namespace autograd {
 struct Edge;
 struct FunctionPostHook;
 struct FunctionPreHook;
+struct StaticGraph;
 
 using tensor_list = std::vector<at::Tensor>;
 using variable_list = std::vector<Variable>;
@@ -338,6 +339,8 @@ struct TORCH_API Node : std::enable_shared_from_this<Node> {
   static uint64_t peek_at_next_sequence_nr();
 
  protected:
+  friend struct StaticGraph;
+
   static uint64_t& get_next_sequence_nr();
 
   /// Performs the `Node`'s actual operation.
@@ -346,9 +349,8 @@ struct TORCH_API Node : std::enable_shared_from_this<Node> {
   /// Calls `apply()`, but instruments it with tracing machinery.
   variable_list traced_apply(variable_list inputs);
 
-  // Since `Node`s are neither copyable nor moveable, we can have const
-  // fields.
-  const uint64_t sequence_nr_;
+  // Only changes when a `StaticGraph` reuses the node for a new step.
+  uint64_t sequence_nr_;
 
   edge_list next_edges_;
   PyObject* pyobj_ = nullptr; // weak reference
@@ -5,6 +5,7 @@
 #include <c10/core/Event.h>
 #include <c10/util/Optional.h>
 
+#include <algorithm>
 #include <cstddef>
 #include <utility>
 #include <vector>
@@ -98,6 +99,32 @@ namespace torch { namespace autograd {
   }
 }
 
+void InputBuffer::add_deferred(size_t pos,
+                               Variable&& var,
+                               uint64_t producer_sequence_nr,
+                               const c10::optional<c10::Stream>& opt_producer_stream,
+                               const c10::optional<c10::Stream>& opt_consumer_stream) {
+  TORCH_INTERNAL_ASSERT(pos < buffer.size());
+  if (!var.defined()) {
+    return;
+  }
+  deferred_.push_back(Deferred{
+      producer_sequence_nr, pos, std::move(var), opt_producer_stream, opt_consumer_stream});
+}
+
+void InputBuffer::flush_deferred() {
+  // A producer adding several outputs to this buffer does so in order, so a
+  // stable sort keeps its own variables in the order it produced them
+  std::stable_sort(deferred_.begin(), deferred_.end(),
+      [](const Deferred& a, const Deferred& b) {
+        return a.producer_sequence_nr > b.producer_sequence_nr;
+      });
+  for (auto& d : deferred_) {
+    add(d.pos, std::move(d.var), d.opt_producer_stream, d.opt_consumer_stream);
+  }
+  deferred_.clear();
+}
+
 auto InputBuffer::device() const -> at::Device {
   // Since we pick the first non-CPU tensor, this won't work with
   // mixed device-type operations (e.g., an op that is both CUDA
@@ -117,6 +144,7 @@ auto InputBuffer::device() const -> at::Device {
 }
 
 auto InputBuffer::variables(InputBuffer&& g) -> std::vector<Variable> {
+  TORCH_INTERNAL_ASSERT(g.deferred_.empty());
   std::vector<Variable> result = std::move(g.buffer);
   return result;
 }
@@ -31,6 +31,21 @@ struct InputBuffer {
            const c10::optional<c10::Stream>& opt_producer_stream,
            const c10::optional<c10::Stream>& opt_consumer_stream);
 
+  // Like add(), but holds the variable back until flush_deferred(). Gradients
+  // that reach a buffer from concurrently running producers are then summed in
+  // the order of the producers' sequence numbers instead of the order in which
+  // the producers happened to finish, so the result doesn't depend on the
+  // thread schedule.
+  void add_deferred(size_t pos,
+                    Variable&& var,
+                    uint64_t producer_sequence_nr,
+                    const c10::optional<c10::Stream>& opt_producer_stream,
+                    const c10::optional<c10::Stream>& opt_consumer_stream);
+
+  // Accumulates the deferred variables, from the highest producer sequence
+  // number to the lowest.
+  void flush_deferred();
+
   at::Device device() const;
 
   Variable operator[](size_t pos) { return buffer[pos]; }
@@ -39,7 +54,16 @@ struct InputBuffer {
   static std::vector<Variable> variables(InputBuffer&& g);
 
 private:
+  struct Deferred {
+    uint64_t producer_sequence_nr;
+    size_t pos;
+    Variable var;
+    c10::optional<c10::Stream> opt_producer_stream;
+    c10::optional<c10::Stream> opt_consumer_stream;
+  };
+
   std::vector<Variable> buffer;
+  std::vector<Deferred> deferred_;
 };
 
 }}  // namespace torch::autograd
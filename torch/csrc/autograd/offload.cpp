@@ -0,0 +1,159 @@
+#include <torch/csrc/autograd/offload.h>
+
+#include <ATen/ATen.h>
+#include <c10/core/Event.h>
+#include <c10/core/StreamGuard.h>
+#include <c10/core/impl/VirtualGuardImpl.h>
+
+#include <utility>
+
+namespace torch { namespace autograd {
+
+// Note [Offloading saved tensors]
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// pack() runs in the forward pass, on the thread of the op that saves the
+// tensor. It makes the copy stream of the device wait for the current stream
+// (which produced the tensor), and there copies the tensor into pinned host
+// memory. The device tensor is kept until that copy finished; later calls to
+// pack() drop the device tensors of the copies that are done, and with them
+// the last reference to most activations.
+//
+// unpack() runs in the backward pass, on the engine thread of the device,
+// whose current stream is the one that ran the op in forward (see Note
+// [Streaming backwards]). Unless the tensor was prefetched, it is copied back
+// there. Either way the tensors saved right before it are then prefetched,
+// since backward unpacks them next, more or less: each gets allocated on the
+// stream it was saved from, so the caching allocator sees it used there, and
+// filled by the copy stream once that stream caught up with the allocation.
+// unpack() makes the current stream wait for that copy, and lets go of the
+// device tensor, which from then on belongs to the node that unpacked it.
+
+struct HostOffload::Packed : PackedTensor {
+  Packed(std::shared_ptr<HostOffload> owner, size_t index, at::Tensor data, c10::Stream stream)
+      : owner_(std::move(owner)),
+        index_(index),
+        stream_(stream),
+        device_data_(std::move(data)),
+        to_host_(c10::DeviceType::CUDA) {}
+
+  at::Tensor unpack() override;
+  // Starts copying host_ back to the device; must be called with the owner's
+  // mutex_ held
+  void prefetch();
+
+  std::shared_ptr<HostOffload> owner_;
+  const size_t index_;
+  // The stream the tensor was saved from
+  const c10::Stream stream_;
+  // The saved tensor until it was copied to host_, or the prefetched copy
+  at::Tensor device_data_;
+  bool prefetched_ = false;
+  at::Tensor host_;
+  c10::Event to_host_;
+  c10::optional<c10::Event> to_device_;
+};
+
+HostOffload::HostOffload(size_t min_bytes, size_t prefetch_depth)
+    : min_bytes_(min_bytes), prefetch_depth_(prefetch_depth) {}
+
+std::shared_ptr<PackedTensor> HostOffload::pack(const at::Tensor& data) {
+  if (!data.is_cuda() || data.layout() != at::kStrided || !data.is_contiguous() ||
+      static_cast<size_t>(data.numel() * data.element_size()) < min_bytes_) {
+    return nullptr;
+  }
+  const auto device = data.device();
+  const auto guard = c10::impl::VirtualGuardImpl{c10::DeviceType::CUDA};
+  const auto stream = guard.getStream(device);
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  reclaim();
+  const auto copy_stream = this->copy_stream(device);
+  auto packed = std::make_shared<Packed>(shared_from_this(), packed_.size(), data, stream);
+
+  c10::Event produced{c10::DeviceType::CUDA};
+  produced.record(stream);
+  produced.block(copy_stream);
+  packed->host_ = at::empty(data.sizes(), data.options().device(at::kCPU).pinned_memory(true));
+  {
+    c10::OptionalStreamGuard stream_guard{copy_stream};
+    packed->host_.copy_(data, /*non_blocking=*/true);
+  }
+  packed->to_host_.record(copy_stream);
+
+  packed_.push_back(packed);
+  return packed;
+}
+
+c10::Stream HostOffload::copy_stream(at::Device device) {
+  if (copy_streams_.size() <= static_cast<size_t>(device.index())) {
+    copy_streams_.resize(device.index() + 1);
+  }
+  auto& stream = copy_streams_[device.index()];
+  if (!stream) {
+    const auto guard = c10::impl::VirtualGuardImpl{c10::DeviceType::CUDA};
+    stream = guard.getStreamFromPool(device);
+  }
+  return *stream;
+}
+
+void HostOffload::reclaim() {
+  for (; first_copying_ < packed_.size(); first_copying_++) {
+    auto packed = packed_[first_copying_].lock();
+    if (!packed || packed->prefetched_) {
+      continue;
+    }
+    if (!packed->to_host_.query()) {
+      break;
+    }
+    packed->device_data_.reset();
+  }
+}
+
+void HostOffload::prefetch_before(size_t index) {
+  for (size_t i = index; i > 0 && index - i < prefetch_depth_; i--) {
+    if (auto packed = packed_[i - 1].lock()) {
+      packed->prefetch();
+    }
+  }
+}
+
+void HostOffload::Packed::prefetch() {
+  if (device_data_.defined()) {
+    // Not copied away yet, or already prefetched
+    return;
+  }
+  const auto copy_stream = owner_->copy_stream(stream_.device());
+  {
+    c10::OptionalStreamGuard stream_guard{stream_};
+    device_data_ = at::empty(host_.sizes(), host_.options().device(stream_.device()).pinned_memory(false));
+  }
+  c10::Event allocated{c10::DeviceType::CUDA};
+  allocated.record(stream_);
+  allocated.block(copy_stream);
+  {
+    c10::OptionalStreamGuard stream_guard{copy_stream};
+    device_data_.copy_(host_, /*non_blocking=*/true);
+  }
+  to_device_.emplace(c10::DeviceType::CUDA);
+  to_device_->record(copy_stream);
+  prefetched_ = true;
+}
+
+at::Tensor HostOffload::Packed::unpack() {
+  std::lock_guard<std::mutex> lock(owner_->mutex_);
+  prefetch();
+  auto data = std::move(device_data_);
+  device_data_.reset();
+  if (to_device_) {
+    const auto guard = c10::impl::VirtualGuardImpl{c10::DeviceType::CUDA};
+    to_device_->block(guard.getStream(stream_.device()));
+    to_device_.reset();
+  } else {
+    // Still the saved tensor; keep it for the next unpack
+    device_data_ = data;
+  }
+  owner_->prefetch_before(index_);
+  return data;
+}
+
+}} // namespace torch::autograd
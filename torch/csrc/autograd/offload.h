@@ -0,0 +1,60 @@
+#pragma once
+
+#include <torch/csrc/WindowsTorchApiMacro.h>
+#include <torch/csrc/autograd/saved_variable.h>
+
+#include <c10/core/Stream.h>
+#include <c10/util/Optional.h>
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace torch { namespace autograd {
+
+// SavedTensorHooks that move the CUDA tensors saved for backward to pinned
+// host memory, copying them on a side stream in the forward pass and back
+// ahead of time in the backward pass, so the copies overlap with compute. Use
+// a new one for every forward pass:
+//
+//   auto offload = std::make_shared<HostOffload>();
+//   {
+//     SavedTensorHooksGuard guard(offload);
+//     loss = model->forward(input);
+//   }
+//   loss.backward();
+//
+// See Note [Offloading saved tensors]
+struct TORCH_API HostOffload
+    : SavedTensorHooks, std::enable_shared_from_this<HostOffload> {
+  // Saved tensors smaller than min_bytes stay on the device. When backward
+  // unpacks a saved tensor, the prefetch_depth tensors saved right before it
+  // start copying back to the device.
+  explicit HostOffload(size_t min_bytes = 1 << 20, size_t prefetch_depth = 2);
+
+  std::shared_ptr<PackedTensor> pack(const at::Tensor& data) override;
+
+ private:
+  struct Packed;
+
+  // The following must be called with mutex_ held
+  c10::Stream copy_stream(at::Device device);
+  // Drops the device data of the tensors that finished copying to the host
+  void reclaim();
+  void prefetch_before(size_t index);
+
+  const size_t min_bytes_;
+  const size_t prefetch_depth_;
+
+  // To protect everything below, and the state of the Packed tensors
+  std::mutex mutex_;
+  // The tensors in the order they were saved
+  std::vector<std::weak_ptr<Packed>> packed_;
+  // The first of packed_ that may still be copying to the host
+  size_t first_copying_ = 0;
+  // By device index
+  std::vector<c10::optional<c10::Stream>> copy_streams_;
+};
+
+}} // namespace torch::autograd
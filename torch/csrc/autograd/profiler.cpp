@@ -1,11 +1,17 @@
 #include <torch/csrc/autograd/profiler.h>
 #include <torch/csrc/jit/code_template.h>
 
+#include <c10/core/Allocator.h>
+
+#include <condition_variable>
+#include <deque>
 #include <fstream>
 #include <list>
 #include <mutex>
 #include <sstream>
 #include <string>
+#include <thread>
+#include <unordered_map>
 #include <vector>
 
 namespace torch { namespace autograd { namespace profiler {
@@ -21,6 +27,7 @@ void registerCUDAMethods(CUDAStubs* stubs) {
 }
 
 ProfilerState state = ProfilerState::Disabled;
+bool profile_memory = false;
 uint16_t next_thread_id = 0;
 std::mutex all_event_lists_mutex;
 std::list<std::shared_ptr<RangeEventList>> all_event_lists;
@@ -119,6 +126,62 @@ void popRange() {
   }
 }
 
+namespace {
+
+struct MemoryUsage {
+  std::mutex mutex;
+  std::unordered_map<void*, int64_t> sizes;
+  // By device index + 1, CPU first
+  std::vector<int64_t> totals;
+};
+
+MemoryUsage& memoryUsage() {
+  static MemoryUsage usage;
+  return usage;
+}
+
+// The memory usage reporter runs on whatever thread allocates or frees. It
+// remembers the size of every allocation the profiler saw, so that a free can
+// be recorded with the size that it gives back; frees of memory allocated
+// before the profiler was enabled are not recorded.
+void reportMemoryToProfiler(void* ptr, int64_t alloc_size, c10::Device device) {
+  if (state == ProfilerState::Disabled || state == ProfilerState::NVTX) {
+    return;
+  }
+  const int device_index = device.is_cpu() ? -1 : device.index();
+  auto& usage = memoryUsage();
+  int64_t total;
+  {
+    std::lock_guard<std::mutex> lock(usage.mutex);
+    if (alloc_size == 0) {
+      auto it = usage.sizes.find(ptr);
+      if (it == usage.sizes.end()) {
+        return;
+      }
+      alloc_size = -it->second;
+      usage.sizes.erase(it);
+    } else {
+      usage.sizes[ptr] = alloc_size;
+    }
+    const size_t slot = device_index + 1;
+    if (usage.totals.size() <= slot) {
+      usage.totals.resize(slot + 1);
+    }
+    total = usage.totals[slot] += alloc_size;
+  }
+  auto& list = getEventList();
+  list.record(thread_id, alloc_size, total, device_index);
+}
+
+void resetMemoryUsage() {
+  auto& usage = memoryUsage();
+  std::lock_guard<std::mutex> lock(usage.mutex);
+  usage.sizes.clear();
+  usage.totals.clear();
+}
+
+} // namespace
+
 void enableProfiler(ProfilerConfig config) {
   ProfilerState new_state = config.state;
   AT_ASSERT(new_state != ProfilerState::Disabled);
@@ -154,6 +217,10 @@ void enableProfiler(ProfilerConfig config) {
       [](const RecordFunction& /* unused */) { popRange(); },
       config.report_input_shapes);
   state = new_state;
+  if (config.profile_memory && state != ProfilerState::NVTX) {
+    profile_memory = true;
+    c10::setMemoryUsageReporter(&reportMemoryToProfiler);
+  }
 
   if(state == ProfilerState::CUDA) {
     // event recording appears to have some startup overhead, so we need to
@@ -183,6 +250,11 @@ thread_event_lists disableProfiler() {
   mark("__stop_profile");
 
   popCallback();
+  if (profile_memory) {
+    c10::setMemoryUsageReporter(nullptr);
+    resetMemoryUsage();
+    profile_memory = false;
+  }
   state = ProfilerState::Disabled;
 
   if (old_state == ProfilerState::NVTX) {
@@ -214,6 +286,13 @@ void Event::record(bool record_cuda) {
   cpu_ns_ = getTime();
 }
 
+void Event::destroy_cuda() {
+  if (event) {
+    cuda_stubs->destroy(event);
+    event = nullptr;
+  }
+}
+
 double Event::cuda_elapsed_us(const Event & e) {
   if(!e.has_cuda() || !has_cuda()) {
     throw std::logic_error("Events were not recorded for CUDA");
@@ -301,4 +380,307 @@ void RecordProfile::processEvents(const std::vector<Event*>& events) {
   out_ << "]\n";
 }
 
+// Note [Streaming profiles]
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~
+// Recording an event stays what it is without streaming: the thread appends
+// it to the current block of its own event list. Only when that block is full
+// does the thread take a lock, to queue the block for the Writer, which then
+// owns it. The Writer's thread waits for blocks and writes them out; reading
+// the CUDA time of an event synchronizes with its stream, so it is done there
+// as well, after which the CUDA event is destroyed. The blocks are written in
+// the order they fill up, so the events of different threads are interleaved,
+// but the events of one thread stay in order, and every event has its time.
+// The blocks that are not full when the profile ends are written last.
+//
+// CUDA times are measured from a start event recorded on every device when
+// the profile starts, next to the CPU time of that moment.
+//
+// With record_memory, the profiler records the allocations and frees of the
+// profile as usual, see enableProfiler.
+
+struct StreamingProfile::Writer {
+  Writer(std::ostream& out, StreamingFormat format)
+      : out_(out), format_(format), thread_([this] { run(); }) {}
+
+  // Writes the blocks still queued before it returns
+  ~Writer() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      done_ = true;
+    }
+    cv_.notify_one();
+    thread_.join();
+    if (format_ == StreamingFormat::ChromeTrace) {
+      out_ << "\n]\n";
+    }
+    out_.flush();
+    for (auto& start : cuda_starts_) {
+      start.destroy_cuda();
+    }
+  }
+
+  void push(std::vector<Event> block) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      blocks_.push_back(std::move(block));
+    }
+    cv_.notify_one();
+  }
+
+  // Must be called before any block is pushed
+  void start(int64_t start_ns, std::vector<Event> cuda_starts) {
+    start_ns_ = start_ns;
+    cuda_starts_ = std::move(cuda_starts);
+    if (format_ == StreamingFormat::ChromeTrace) {
+      out_ << "[";
+    } else {
+      out_.write("TPRF", 4);
+      writeRaw<uint32_t>(1);
+    }
+  }
+
+ private:
+  void run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+      cv_.wait(lock, [this] { return done_ || !blocks_.empty(); });
+      if (blocks_.empty()) {
+        return;
+      }
+      auto block = std::move(blocks_.front());
+      blocks_.pop_front();
+      lock.unlock();
+      for (auto& e : block) {
+        write(e);
+        e.destroy_cuda();
+      }
+      lock.lock();
+    }
+  }
+
+  // The CUDA time of an event in us since the start of the profile, or -1
+  double cudaTimeUs(Event& e) {
+    if (!e.has_cuda()) {
+      return -1;
+    }
+    for (auto& start : cuda_starts_) {
+      if (start.device() == e.device()) {
+        return (start.cpu_ns() - start_ns_) / 1000.0 + start.cuda_elapsed_us(e);
+      }
+    }
+    return -1;
+  }
+
+  void write(Event& e) {
+    const double cpu_us = (e.cpu_ns() - start_ns_) / 1000.0;
+    const double cuda_us = cudaTimeUs(e);
+    if (format_ == StreamingFormat::Binary) {
+      writeBinary(e, cpu_us, cuda_us);
+    } else {
+      writeChrome(e, cpu_us, cuda_us);
+    }
+  }
+
+  void writeChrome(const Event& e, double cpu_us, double cuda_us) {
+    const char* phase = nullptr;
+    switch (e.event_kind()) {
+      case EventKind::Mark: phase = "i"; break;
+      case EventKind::PushRange: phase = "B"; break;
+      case EventKind::PopRange: phase = "E"; break;
+      case EventKind::MemoryAlloc: {
+        beginChromeEvent("C", cpu_us, "Memory");
+        out_ << ", \"name\": \"";
+        if (e.device() < 0) {
+          out_ << "CPU";
+        } else {
+          out_ << "CUDA " << e.device();
+        }
+        out_ << " memory\", \"args\": {\"allocated\": " << e.total_allocated()
+             << "}}";
+        return;
+      }
+    }
+    const bool has_cuda = cuda_us >= 0;
+    if (has_cuda) {
+      next_correlation_++;
+    }
+    for (int track = 0; track < (has_cuda ? 2 : 1); track++) {
+      std::string pid = "CPU Functions";
+      if (track == 1) {
+        pid = "CUDA " + std::to_string(e.device());
+      }
+      beginChromeEvent(phase, track == 0 ? cpu_us : cuda_us, pid);
+      out_ << ", \"tid\": " << e.thread_id();
+      if (e.event_kind() == EventKind::Mark) {
+        out_ << ", \"s\": \"t\"";
+      }
+      if (e.event_kind() != EventKind::PopRange) {
+        out_ << ", \"name\": ";
+        writeJsonString(e.name());
+      }
+      out_ << ", \"args\": {";
+      const char* sep = "";
+      if (has_cuda) {
+        out_ << "\"correlation\": " << next_correlation_;
+        sep = ", ";
+      }
+      const auto& shapes = e.shapes();
+      if (track == 0 && !shapes.empty()) {
+        out_ << sep << "\"Input dims\": [";
+        for (size_t i = 0; i < shapes.size(); i++) {
+          out_ << (i > 0 ? ", [" : "[");
+          for (size_t dim = 0; dim < shapes[i].size(); dim++) {
+            out_ << (dim > 0 ? ", " : "") << shapes[i][dim];
+          }
+          out_ << "]";
+        }
+        out_ << "]";
+      }
+      out_ << "}}";
+    }
+  }
+
+  void beginChromeEvent(const char* phase, double ts, const std::string& pid) {
+    out_ << (first_ ? "\n" : ",\n");
+    first_ = false;
+    out_ << "{\"ph\": \"" << phase << "\", \"ts\": " << ts << ", \"pid\": \""
+         << pid << "\"";
+  }
+
+  void writeJsonString(const char* str) {
+    out_ << '"';
+    for (const char* c = str; *c; c++) {
+      if (*c == '"' || *c == '\\') {
+        out_ << '\\' << *c;
+      } else if (static_cast<unsigned char>(*c) < 0x20) {
+        out_ << ' ';
+      } else {
+        out_ << *c;
+      }
+    }
+    out_ << '"';
+  }
+
+  void writeBinary(const Event& e, double cpu_us, double cuda_us) {
+    const std::string name = e.name();
+    auto it = string_ids_.find(name);
+    if (it == string_ids_.end()) {
+      it = string_ids_.emplace(name, static_cast<uint32_t>(string_ids_.size())).first;
+      writeRaw<uint8_t>(0);
+      writeRaw<uint32_t>(it->second);
+      writeRaw<uint32_t>(static_cast<uint32_t>(name.size()));
+      out_.write(name.data(), name.size());
+    }
+    writeRaw<uint8_t>(1);
+    writeRaw<uint8_t>(static_cast<uint8_t>(e.event_kind()));
+    writeRaw<uint16_t>(e.thread_id());
+    writeRaw<uint32_t>(it->second);
+    writeRaw<int64_t>(e.cpu_ns() - start_ns_);
+    writeRaw<int64_t>(cuda_us < 0 ? -1 : static_cast<int64_t>(cuda_us * 1000));
+    writeRaw<int16_t>(static_cast<int16_t>(e.device()));
+    writeRaw<int64_t>(e.alloc_size());
+    writeRaw<int64_t>(e.total_allocated());
+  }
+
+  template <typename T>
+  void writeRaw(T value) {
+    out_.write(reinterpret_cast<const char*>(&value), sizeof(T));
+  }
+
+  std::ostream& out_;
+  const StreamingFormat format_;
+
+  // Only used by thread_, or before it gets the first block
+  int64_t start_ns_ = 0;
+  std::vector<Event> cuda_starts_;
+  bool first_ = true;
+  int64_t next_correlation_ = 0;
+  std::unordered_map<std::string, uint32_t> string_ids_;
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<std::vector<Event>> blocks_;
+  bool done_ = false;
+
+  std::thread thread_;
+};
+
+namespace {
+
+std::mutex streaming_writer_mutex;
+StreamingProfile::Writer* streaming_writer = nullptr;
+
+} // namespace
+
+bool streamBlock(std::vector<Event>& block) {
+  std::lock_guard<std::mutex> lock(streaming_writer_mutex);
+  if (!streaming_writer) {
+    return false;
+  }
+  streaming_writer->push(std::move(block));
+  return true;
+}
+
+StreamingProfile::StreamingProfile(
+    std::ostream& out,
+    ProfilerConfig config,
+    StreamingFormat format,
+    bool record_memory)
+    : out_(out) {
+  init(config, format, record_memory);
+}
+
+StreamingProfile::StreamingProfile(
+    const std::string& filename,
+    ProfilerConfig config,
+    StreamingFormat format,
+    bool record_memory)
+    : file_(new std::ofstream(filename, std::ios::binary)), out_(*file_) {
+  init(config, format, record_memory);
+}
+
+void StreamingProfile::init(
+    ProfilerConfig config,
+    StreamingFormat format,
+    bool record_memory) {
+  TORCH_CHECK(out_, "could not open file");
+  TORCH_CHECK(config.state == ProfilerState::CPU || config.state == ProfilerState::CUDA,
+      "StreamingProfile needs ProfilerState::CPU or ProfilerState::CUDA");
+  {
+    std::lock_guard<std::mutex> lock(streaming_writer_mutex);
+    TORCH_CHECK(!streaming_writer, "another StreamingProfile is running");
+  }
+  writer_.reset(new Writer(out_, format));
+  const int64_t start_ns = getTime();
+  config.profile_memory = config.profile_memory || record_memory;
+  enableProfiler(config);
+  std::vector<Event> cuda_starts;
+  if (config.state == ProfilerState::CUDA) {
+    cuda_stubs->onEachDevice([&](int d) {
+      cuda_starts.emplace_back(
+          EventKind::Mark, StringView("__cuda_start_event"), thread_id, true);
+    });
+  }
+  writer_->start(start_ns, std::move(cuda_starts));
+  {
+    std::lock_guard<std::mutex> lock(streaming_writer_mutex);
+    streaming_writer = writer_.get();
+  }
+}
+
+StreamingProfile::~StreamingProfile() {
+  thread_event_lists event_lists = disableProfiler();
+  {
+    std::lock_guard<std::mutex> lock(streaming_writer_mutex);
+    streaming_writer = nullptr;
+  }
+  for (auto& list : event_lists) {
+    writer_->push(std::move(list));
+  }
+  writer_.reset();
+  if (file_) {
+    file_->close();
+  }
+}
+
 }}}
@@ -33,6 +33,9 @@ struct TORCH_API CUDAStubs {
     fail();
     return 0.f;
   }
+  virtual void destroy(CUDAEventStub event) {
+    fail();
+  }
   virtual void nvtxMarkA(const char* name) {
     fail();
   }
@@ -102,17 +105,26 @@ enum class TORCH_API ProfilerState {
 };
 
 struct TORCH_API ProfilerConfig {
-  ProfilerConfig(ProfilerState state, bool report_input_shapes)
-      : state(state), report_input_shapes(report_input_shapes) {}
+  ProfilerConfig(
+      ProfilerState state,
+      bool report_input_shapes,
+      bool profile_memory = false)
+      : state(state),
+        report_input_shapes(report_input_shapes),
+        profile_memory(profile_memory) {}
   ~ProfilerConfig();
   ProfilerState state;
   bool report_input_shapes;
+  // Records a MemoryAlloc event for every allocation and free of the CPU
+  // allocator and the CUDA caching allocator, on the thread that made it
+  bool profile_memory;
 };
 
 enum class TORCH_API EventKind : uint16_t {
   Mark,
   PushRange,
-  PopRange
+  PopRange,
+  MemoryAlloc
 };
 #ifndef _MSC_VER
 #  pragma GCC diagnostic pop
@@ -131,6 +143,22 @@ struct TORCH_API Event final {
         shapes_(shapes) {
     record(record_cuda);
   }
+  // A MemoryAlloc event: alloc_size bytes were allocated (freed if negative)
+  // on a CUDA device, or on the CPU if device is -1, after which total_allocated
+  // bytes of memory were allocated there.
+  Event(
+      uint16_t thread_id,
+      int64_t alloc_size,
+      int64_t total_allocated,
+      int device)
+      : name_(""),
+        kind_(EventKind::MemoryAlloc),
+        thread_id_(thread_id),
+        device_(device),
+        alloc_size_(alloc_size),
+        total_allocated_(total_allocated) {
+    record(false);
+  }
 
   void record(bool record_cuda);
   std::string kind() const {
@@ -138,6 +166,7 @@ struct TORCH_API Event final {
       case EventKind::Mark: return "mark";
       case EventKind::PushRange: return "push";
       case EventKind::PopRange: return "pop";
+      case EventKind::MemoryAlloc: return "memory_alloc";
     }
     throw std::runtime_error("unknown EventKind");
   }
@@ -150,6 +179,12 @@ struct TORCH_API Event final {
   std::vector<std::vector<int64_t>> shapes() const {
     return shapes_;
   }
+  EventKind event_kind() const {
+    return kind_;
+  }
+  int64_t cpu_ns() const {
+    return cpu_ns_;
+  }
   double cpu_elapsed_us(const Event & e) {
     return (e.cpu_ns_ - cpu_ns_)/(1000.0);
   }
@@ -160,6 +195,14 @@ struct TORCH_API Event final {
   int device() const {
     return device_;
   }
+  int64_t alloc_size() const {
+    return alloc_size_;
+  }
+  int64_t total_allocated() const {
+    return total_allocated_;
+  }
+  // Destroys the CUDA event, once nothing needs its time anymore
+  void destroy_cuda();
 private:
   // signed to allow for negative intervals, initialized for safety.
   int64_t cpu_ns_ = 0;
@@ -169,8 +212,14 @@ private:
   std::vector<std::vector<int64_t>> shapes_;
   int device_ = -1;
   struct CUevent_st* event = nullptr;
+  int64_t alloc_size_ = 0;
+  int64_t total_allocated_ = 0;
 };
 
+// Takes a full block of events off the event list of a thread when the
+// profiler streams, see StreamingProfile
+TORCH_API bool streamBlock(std::vector<Event>& block);
+
 // a linked-list of fixed sized vectors, to avoid
 // a std::vector resize from taking a large amount of time inside
 // a profiling  event
@@ -184,6 +233,9 @@ struct RangeEventList {
   using block_type = std::vector<Event>;
 
   void allocBlock() {
+    if (!blocks.empty() && streamBlock(blocks.front())) {
+      blocks.pop_front();
+    }
     blocks.emplace_front();
     auto & new_block = blocks.front();
     new_block.reserve(num_block_elements);
@@ -247,6 +299,59 @@ private:
   void processEvents(const std::vector<Event*>& events);
 };
 
+enum class StreamingFormat {
+  // The JSON array format of chrome://tracing, one "B"/"E" pair per range
+  ChromeTrace,
+  // A sequence of records in native byte order, after the magic "TPRF" and a
+  // uint32_t version (1). Every record starts with a uint8_t tag:
+  //   0 - a string: uint32_t id, uint32_t length, the characters
+  //   1 - an event: uint8_t kind (EventKind), uint16_t thread id, uint32_t
+  //       id of its name, int64_t CPU time and CUDA time (-1 if none) in ns
+  //       since the start of the profile, int16_t device, int64_t allocated
+  //       size and total (MemoryAlloc only)
+  // A string record precedes the first event using it.
+  Binary,
+};
+
+// Like RecordProfile, but writes the events out while the profile runs,
+// instead of keeping them all in memory until it ends: whenever the event
+// list of a thread filled a block, a background thread takes it over and
+// writes it. With ProfilerState::CUDA, the kernels of every range show up on
+// a track of their device, with the same "correlation" id as the range.
+// With record_memory, the allocations and frees of the CPU allocator and of
+// the CUDA caching allocator are recorded as well, as a counter of the
+// allocated bytes per device.
+//
+// Usage:
+//   {
+//     StreamingProfile guard("filename.trace");
+//     // code you want to profile
+//   }
+struct TORCH_API StreamingProfile {
+  StreamingProfile(
+      std::ostream& out,
+      ProfilerConfig config = ProfilerConfig(ProfilerState::CPU, false),
+      StreamingFormat format = StreamingFormat::ChromeTrace,
+      bool record_memory = false);
+  StreamingProfile(
+      const std::string& filename,
+      ProfilerConfig config = ProfilerConfig(ProfilerState::CPU, false),
+      StreamingFormat format = StreamingFormat::ChromeTrace,
+      bool record_memory = false);
+
+  StreamingProfile(const StreamingProfile&) = delete;
+  StreamingProfile& operator=(const StreamingProfile&) = delete;
+
+  ~StreamingProfile();
+
+  struct Writer;
+private:
+  void init(ProfilerConfig config, StreamingFormat format, bool record_memory);
+  std::unique_ptr<std::ofstream> file_;
+  std::ostream& out_;
+  std::unique_ptr<Writer> writer_;
+};
+
 
 } // namespace profiler
 }} // namespace torch::autograd
@@ -32,6 +32,9 @@ struct CUDAMethods : public CUDAStubs {
     TORCH_CUDA_CHECK(cudaEventElapsedTime(&ms, event, event2));
     return ms*1000.0;
   }
+  void destroy(CUDAEventStub event) override {
+    TORCH_CUDA_CHECK(cudaEventDestroy(event));
+  }
   void nvtxMarkA(const char* name) override {
     ::nvtxMark(name);
   }
@@ -4,6 +4,7 @@
 #include <torch/csrc/Exceptions.h>
 #include <torch/csrc/THP_export.h>
 #include <torch/csrc/autograd/function.h>
+#include <torch/csrc/autograd/grad_mode.h>
 #include <torch/csrc/autograd/python_variable.h>
 #include <torch/csrc/autograd/utils/wrap_outputs.h>
 #include <torch/csrc/autograd/variable.h>
@@ -16,9 +17,11 @@
 
 #include <ATen/DeviceGuard.h>
 #include <ATen/ExpandUtils.h>
+#include <ATen/core/EnableNamedTensor.h>
 #include <c10/core/TensorOptions.h>
 #include <ATen/core/LegacyTypeDispatch.h>
 
+#include <algorithm>
 #include <vector>
 #include <tuple>
 
@@ -226,6 +229,95 @@ static Variable applySlicing(const Variable& self, PyObject* index, variable_lis
   return result;
 }
 
+// Applies an index made only of integers, slices, None and at most one
+// ellipsis as a single as_strided view, whose sizes, strides and offset are
+// computed in one pass, instead of as one select, slice or unsqueeze (and one
+// view) per component. Returns false for any other index, and for out of
+// bounds integers or unsupported slices, to leave them (and their errors) to
+// applySlicing. Recording a history for autograd or a trace needs the
+// separate views, so these also take the slow path.
+static bool applyBasicIndexing(const Variable& self, PyObject* index, Variable& result) {
+  if (jit::tracer::isTracing() || self.layout() != kStrided ||
+      isQIntType(self.scalar_type()) || (self.requires_grad() && GradMode::is_enabled())) {
+    return false;
+  }
+#ifdef BUILD_NAMEDTENSOR
+  if (self.has_names()) {
+    return false;
+  }
+#endif
+  const int64_t ndim = self.dim();
+  const auto size = PyTuple_GET_SIZE(index);
+  int64_t specified_dims = 0;
+  bool has_ellipsis = false;
+  for (Py_ssize_t i = 0; i < size; i++) {
+    PyObject* obj = PyTuple_GET_ITEM(index, i);
+    if (THPUtils_checkLong(obj) || PySlice_Check(obj)) {
+      specified_dims++;
+    } else if (obj == Py_Ellipsis && !has_ellipsis) {
+      has_ellipsis = true;
+    } else if (obj != Py_None) {
+      return false;
+    }
+  }
+  if (specified_dims > ndim) {
+    return false;
+  }
+
+  DimVector sizes;
+  DimVector strides;
+  int64_t storage_offset = self.storage_offset();
+  int64_t dim = 0;
+  for (Py_ssize_t i = 0; i < size; i++) {
+    PyObject* obj = PyTuple_GET_ITEM(index, i);
+    if (THPUtils_checkLong(obj)) {
+      int64_t idx = THPUtils_unpackLong(obj);
+      int64_t length = self.size(dim);
+      if (idx < -length || idx >= length) {
+        return false;
+      }
+      if (idx < 0) {
+        idx += length;
+      }
+      storage_offset += idx * self.stride(dim);
+      dim++;
+    } else if (PySlice_Check(obj)) {
+      Py_ssize_t start, stop, step;
+      if (!THPUtils_unpackSlice(obj, &start, &stop, &step)) {
+        throw python_error();
+      }
+      if (step <= 0) {
+        return false;
+      }
+      // same bounds as at::slice
+      int64_t length = self.size(dim);
+      int64_t begin = start < 0 ? start + length : start;
+      int64_t end = stop < 0 ? stop + length : stop;
+      begin = std::min(std::max<int64_t>(begin, 0), length);
+      end = std::min(std::max(end, begin), length);
+      storage_offset += begin * self.stride(dim);
+      sizes.push_back((end - begin + step - 1) / step);
+      strides.push_back(self.stride(dim) * step);
+      dim++;
+    } else if (obj == Py_Ellipsis) {
+      for (int64_t end = dim + ndim - specified_dims; dim < end; dim++) {
+        sizes.push_back(self.size(dim));
+        strides.push_back(self.stride(dim));
+      }
+    } else {
+      // same stride as at::unsqueeze
+      sizes.push_back(1);
+      strides.push_back(dim < ndim ? self.size(dim) * self.stride(dim) : 1);
+    }
+  }
+  for (; dim < ndim; dim++) {
+    sizes.push_back(self.size(dim));
+    strides.push_back(self.stride(dim));
+  }
+  result = self.as_strided(sizes, strides, storage_offset);
+  return true;
+}
+
 static std::vector<Tensor> typeConvertIndices(const Variable& self, const variable_list& indices) {
   std::vector<Tensor> converted_inds(indices.size());
   for (size_t i = 0; i < indices.size(); ++i) {
@@ -246,6 +338,32 @@ static Variable dispatch_index(const Variable& self, const variable_list& indice
   return self.index(converted_indices);
 }
 
+// Indexing by a single 1-d long tensor of a CPU tensor, e.g. x[idx] or
+// x[:, idx], is an index_select, which is cheaper than the general index. Its
+// indices are checked to be in bounds and non-negative first, since
+// index_select doesn't wrap negative indices like index does.
+static bool applySingleIndex(const Variable& self, const variable_list& indices, Variable& result) {
+  const int64_t dim = indices.size() - 1;
+  for (int64_t i = 0; i < dim; i++) {
+    if (indices[i].defined()) {
+      return false;
+    }
+  }
+  const auto& index = indices[dim];
+  if (jit::tracer::isTracing() || !index.defined() || index.scalar_type() != kLong ||
+      index.dim() != 1 || !self.device().is_cpu() || !index.device().is_cpu() ||
+      self.layout() != kStrided || dim >= self.dim()) {
+    return false;
+  }
+  AutoNoGIL no_gil;
+  if (index.numel() > 0 &&
+      (index.min().item<int64_t>() < 0 || index.max().item<int64_t>() >= self.size(dim))) {
+    return false;
+  }
+  result = self.index_select(dim, index);
+  return true;
+}
+
 static Variable dispatch_index_put_(Variable& self, const variable_list& indices, const Variable& value) {
   AutoNoGIL no_gil;
   std::vector<Tensor> converted_indices = typeConvertIndices(self, indices);
@@ -320,6 +438,13 @@ PyObject* THPVariable_getitem(PyObject* self, PyObject* index) {
     return wrap(applySlice(self_, 0, index, true));
   }
 
+  if (PyTuple_CheckExact(index)) {
+    Variable result;
+    if (applyBasicIndexing(self_, index, result)) {
+      return wrap(result);
+    }
+  }
+
   // wrap index in a tuple if it's not already one
   THPObjectPtr holder = wrapTuple(index);
 
@@ -334,6 +459,10 @@ PyObject* THPVariable_getitem(PyObject* self, PyObject* index) {
   }
 
   // indexing by tensors ("advanced" indexing)
+  Variable result;
+  if (applySingleIndex(sliced, variableIndices, result)) {
+    return wrap(result);
+  }
   return wrap(dispatch_index(sliced, variableIndices));
   Py_RETURN_NONE;
   END_HANDLE_TH_ERRORS
@@ -0,0 +1,183 @@
+#include <torch/csrc/autograd/recompute.h>
+
+#include <torch/csrc/autograd/function.h>
+#include <torch/csrc/autograd/grad_mode.h>
+
+#include <ATen/CPUGenerator.h>
+#include <c10/util/Exception.h>
+
+#include <utility>
+
+namespace torch { namespace autograd {
+
+// Note [Recomputed saved variables]
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// checkpoint(fn, inputs) runs fn like any other code, building its part of the
+// graph as usual. While it runs, every SavedVariable constructed on the thread
+// gets a consecutive index, and the ones of variables produced inside fn (that
+// is, whose grad_fn was created after fn started) keep the Recomputation
+// instead of their data. The data then dies with the forward pass, unless
+// something else holds on to it.
+//
+// When backward unpacks the first of these SavedVariables, the Recomputation
+// runs fn again on detached copies of the inputs, with grad mode enabled, so
+// that the same operations save the same variables in the same order. It
+// keeps the data of the ones whose index is recomputable; the graph built by
+// the rerun is thrown away. Every SavedVariable then takes its data from there,
+// and gives it back when it is reset, i.e. once its node ran without
+// retain_graph.
+//
+// Because data is matched by position, it doesn't matter whether the rerun
+// sees the same tensors, only that it saves the same number of variables; the
+// rerun fails otherwise. Version counters are kept as usual, so modifying an
+// input or a parameter in-place before backward is still an error.
+
+namespace {
+
+struct Scope {
+  Recomputation* recomputation;
+  // Nodes created from here on are part of fn; unused when replaying
+  uint64_t first_sequence_nr;
+  bool replaying;
+  uint32_t num_saved;
+};
+
+thread_local Scope* current_scope = nullptr;
+
+struct ScopeGuard {
+  explicit ScopeGuard(Scope* scope) : prev_scope_(current_scope) {
+    current_scope = scope;
+  }
+  ~ScopeGuard() {
+    current_scope = prev_scope_;
+  }
+
+  Scope* prev_scope_;
+};
+
+} // namespace
+
+struct Recomputation::CPURNGState {
+  at::mt19937 engine;
+  c10::optional<float> next_float_normal_sample;
+  c10::optional<double> next_double_normal_sample;
+
+  static std::shared_ptr<CPURNGState> get() {
+    auto* gen = at::detail::getDefaultCPUGenerator();
+    std::lock_guard<std::mutex> lock(gen->mutex_);
+    auto state = std::make_shared<CPURNGState>();
+    state->engine = gen->engine();
+    state->next_float_normal_sample = gen->next_float_normal_sample();
+    state->next_double_normal_sample = gen->next_double_normal_sample();
+    return state;
+  }
+
+  void set() const {
+    auto* gen = at::detail::getDefaultCPUGenerator();
+    std::lock_guard<std::mutex> lock(gen->mutex_);
+    gen->set_engine(engine);
+    gen->set_next_float_normal_sample(next_float_normal_sample);
+    gen->set_next_double_normal_sample(next_double_normal_sample);
+  }
+};
+
+variable_list checkpoint(const checkpoint_fn& fn, const variable_list& inputs) {
+  if (!GradMode::is_enabled() || current_scope) {
+    // Nothing is saved for backward, or this is part of an enclosing checkpoint
+    return fn(inputs);
+  }
+  auto recomputation = std::make_shared<Recomputation>(fn, inputs);
+  Scope scope{recomputation.get(), Node::peek_at_next_sequence_nr(), false, 0};
+  ScopeGuard guard(&scope);
+  return fn(inputs);
+}
+
+Recomputation::Recomputation(checkpoint_fn fn, const variable_list& inputs)
+    : fn_(std::move(fn)), cpu_rng_state_(CPURNGState::get()) {
+  inputs_.reserve(inputs.size());
+  inputs_require_grad_.reserve(inputs.size());
+  for (const auto& input : inputs) {
+    inputs_.emplace_back(input, /*is_output=*/false);
+    inputs_require_grad_.push_back(input.defined() && input.requires_grad());
+  }
+}
+
+at::Tensor Recomputation::get(uint32_t index) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!replayed_) {
+    replay();
+  }
+  TORCH_INTERNAL_ASSERT(index < replayed_data_.size() && recomputable_[index]);
+  return replayed_data_[index];
+}
+
+void Recomputation::release(uint32_t index) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (index < replayed_data_.size()) {
+    replayed_data_[index].reset();
+  }
+}
+
+void Recomputation::replay() {
+  variable_list inputs;
+  inputs.reserve(inputs_.size());
+  for (size_t i = 0; i < inputs_.size(); i++) {
+    auto input = inputs_[i].unpack();
+    if (input.defined()) {
+      input = input.detach();
+      input.requires_grad_(inputs_require_grad_[i]);
+    }
+    inputs.push_back(std::move(input));
+  }
+
+  replayed_data_.resize(recomputable_.size());
+  const auto cpu_rng_state = CPURNGState::get();
+  cpu_rng_state_->set();
+  {
+    Scope scope{this, 0, true, 0};
+    ScopeGuard guard(&scope);
+    AutoGradMode grad_mode(true);
+    try {
+      fn_(inputs);
+    } catch (...) {
+      cpu_rng_state->set();
+      throw;
+    }
+    cpu_rng_state->set();
+    TORCH_CHECK(scope.num_saved == recomputable_.size(),
+        "checkpoint: the function saved ", scope.num_saved, " variables for "
+        "backward when it was run again, but ", recomputable_.size(), " in the "
+        "forward pass. A checkpointed function has to run the same operations "
+        "every time.");
+  }
+  replayed_ = true;
+}
+
+namespace impl {
+
+std::shared_ptr<Recomputation> recomputation_for(
+    const Variable& variable, uint32_t& index) {
+  Scope* scope = current_scope;
+  if (!scope) {
+    return nullptr;
+  }
+  auto* recomputation = scope->recomputation;
+  index = scope->num_saved++;
+  if (scope->replaying) {
+    // replay() holds recomputation->mutex_
+    if (index < recomputation->recomputable_.size() &&
+        recomputation->recomputable_[index]) {
+      recomputation->replayed_data_[index] = variable.tensor_data();
+    }
+    return nullptr;
+  }
+  const auto& grad_fn = variable.grad_fn();
+  const bool recomputable =
+      grad_fn && grad_fn->sequence_nr() >= scope->first_sequence_nr;
+  recomputation->recomputable_.push_back(recomputable);
+  return recomputable ? recomputation->shared_from_this() : nullptr;
+}
+
+} // namespace impl
+
+}} // namespace torch::autograd
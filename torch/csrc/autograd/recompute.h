@@ -0,0 +1,64 @@
+#pragma once
+
+#include <torch/csrc/WindowsTorchApiMacro.h>
+#include <torch/csrc/autograd/saved_variable.h>
+#include <torch/csrc/autograd/variable.h>
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace torch { namespace autograd {
+
+using checkpoint_fn = std::function<variable_list(const variable_list&)>;
+
+// Runs fn(inputs) and returns its outputs, trading compute for memory: the
+// variables that the graph of fn saves for backward are not kept alive, but
+// rebuilt by running fn again when backward first needs one of them. Only the
+// inputs (and whatever fn captures, like parameters) stay alive in between.
+//
+// fn must run the same operations when it is run again, and can't modify its
+// inputs in-place. The CPU random number generator is rewound for the rerun,
+// so CPU dropout masks match; the CUDA generator isn't. Calls nested inside
+// another checkpoint() are part of the enclosing one.
+// See Note [Recomputed saved variables]
+TORCH_API variable_list checkpoint(
+    const checkpoint_fn& fn,
+    const variable_list& inputs);
+
+// The recipe for the saved variables of one checkpoint() call, shared by all
+// of them.
+struct TORCH_API Recomputation : std::enable_shared_from_this<Recomputation> {
+  Recomputation(checkpoint_fn fn, const variable_list& inputs);
+
+  // The data of the index-th variable saved by fn, running it again if this
+  // is the first one asked for
+  at::Tensor get(uint32_t index);
+  // Drops the data of the index-th variable, once its SavedVariable is reset
+  void release(uint32_t index);
+
+ private:
+  friend std::shared_ptr<Recomputation> impl::recomputation_for(
+      const Variable& variable, uint32_t& index);
+
+  // Must be called with mutex_ held
+  void replay();
+
+  checkpoint_fn fn_;
+  std::vector<SavedVariable> inputs_;
+  std::vector<bool> inputs_require_grad_;
+  // For every variable saved by fn in the forward pass, whether it was
+  // produced by fn (and its SavedVariable holds no data)
+  std::vector<bool> recomputable_;
+  struct CPURNGState;
+  std::shared_ptr<CPURNGState> cpu_rng_state_;
+
+  // To protect replayed_ and replayed_data_
+  std::mutex mutex_;
+  bool replayed_ = false;
+  std::vector<at::Tensor> replayed_data_;
+};
+
+}} // namespace torch::autograd
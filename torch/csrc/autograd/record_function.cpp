@@ -1,8 +1,14 @@
 #include <torch/csrc/autograd/record_function.h>
 #include <torch/csrc/autograd/function.h>
 #include <torch/csrc/utils/memory.h>
+#include <c10/util/Optional.h>
+
+#include <atomic>
+#include <cmath>
 #include <cstdlib>
+#include <limits>
 #include <random>
+#include <vector>
 
 namespace torch {
 namespace autograd {
@@ -10,106 +16,151 @@ namespace profiler {
 
 namespace {
 
-class CallbackManager {
- public:
-  void setSamplingProbability(double prob) {
-    if (prob == 1.0) {
-      sampling_prop_set = false;
-    } else {
-      TORCH_CHECK(prob >= 0.0 && prob < 1.0);
-      sampling_prop_set = true;
-    }
-    sampling_prob = prob;
-  }
+// Note [Sampled callbacks]
+// ~~~~~~~~~~~~~~~~~~~~~~~~
+// Drawing a random number for every RecordFunction would cost more than most
+// callbacks at low sampling probabilities. Instead, every thread draws how
+// many RecordFunctions to skip before a callback runs again, which for
+// independent draws with probability p is geometrically distributed, and then
+// counts them down. The callbacks pushed with sampled = true share one
+// countdown, since they run together.
+
+struct Callback {
+  RecordFunctionCallback start;
+  RecordFunctionCallback end;
+  bool needs_inputs;
+  // Sampled with getSamplingProbability(), together with the others
+  bool global_sampled;
+  double sampling_prob;
+  // Tells the countdowns of two callbacks pushed at the same index apart
+  uint64_t id;
+};
 
-  double getSamplingProbability() {
-    return sampling_prob;
-  }
+constexpr size_t kMaxCallbacks = 64;
 
-  bool shouldRunSampledCallbacks() {
-    return (num_sampled_callbacks > 0) &&
-        (!sampling_prop_set || (sample_zero_one() < sampling_prob));
-  }
+struct Countdown {
+  uint64_t id = 0;
+  double prob = 1.0;
+  int64_t left = 0;
 
-  void pushCallback(
-      RecordFunctionCallback start,
-      RecordFunctionCallback end,
-      bool needs_inputs,
-      bool sampled) {
-    start_callbacks.push_back(std::move(start));
-    end_callbacks.push_back(std::move(end));
-    if (callback_needs_inputs > 0 || needs_inputs) {
-      ++callback_needs_inputs;
+  // Whether to run this time, for a callback sampled with probability prob
+  bool next(uint64_t callback_id, double callback_prob) {
+    if (id != callback_id || prob != callback_prob) {
+      id = callback_id;
+      prob = callback_prob;
+      left = draw(prob);
     }
-    is_callback_sampled.push_back(sampled);
-    if (sampled) {
-      ++num_sampled_callbacks;
+    if (left > 0) {
+      --left;
+      return false;
     }
+    left = draw(prob);
+    return true;
   }
 
-  void popCallback() {
-    if (start_callbacks.empty()) {
-      throw std::runtime_error("Empty callbacks stack");
+  static int64_t draw(double prob) {
+    if (prob >= 1.0) {
+      return 0;
     }
-    start_callbacks.pop_back();
-    end_callbacks.pop_back();
-    if (callback_needs_inputs > 0) {
-      --callback_needs_inputs;
+    if (prob <= 0.0) {
+      return std::numeric_limits<int64_t>::max();
     }
-    if (is_callback_sampled.back()) {
-      --num_sampled_callbacks;
-    }
-    is_callback_sampled.pop_back();
-  }
-
-  bool hasCallbacks() {
-    return !start_callbacks.empty();
+    static thread_local auto gen =
+        torch::make_unique<std::mt19937>(std::random_device()());
+    // In (0, 1], so that the log is finite
+    const double u = 1.0 - std::uniform_real_distribution<double>(0.0, 1.0)(*gen);
+    const double skip = std::floor(std::log(u) / std::log1p(-prob));
+    return skip < static_cast<double>(std::numeric_limits<int64_t>::max())
+        ? static_cast<int64_t>(skip)
+        : std::numeric_limits<int64_t>::max();
   }
+};
 
-  bool needsInputs() {
-    return callback_needs_inputs > 0;
-  }
+uint64_t next_callback_id() {
+  static std::atomic<uint64_t> next_id{1};
+  return next_id++;
+}
 
-  bool hasNonSampledCallbacks() {
-    return num_sampled_callbacks < start_callbacks.size();
+// Global callbacks
+std::vector<Callback> global_callbacks;
+double sampling_prob = 1.0;
+
+struct ThreadLocalState {
+  std::vector<Callback> callbacks;
+  // By index of global_callbacks and callbacks
+  std::vector<Countdown> global_countdowns;
+  std::vector<Countdown> countdowns;
+  // For the global callbacks pushed with sampled = true
+  Countdown global_sampled_countdown;
+
+  ~ThreadLocalState() {
+    if (!callbacks.empty()) {
+      --detail::num_callback_sources;
+    }
   }
+};
 
-  std::vector<RecordFunctionCallback> start_callbacks;
-  std::vector<RecordFunctionCallback> end_callbacks;
-  std::vector<bool> is_callback_sampled;
-  size_t num_sampled_callbacks = 0;
-  size_t callback_needs_inputs = 0;
-  bool sampling_prop_set = false;
-  double sampling_prob = 1.0;
+ThreadLocalState& thread_local_state() {
+  static thread_local ThreadLocalState state;
+  return state;
+}
 
-  static double sample_zero_one() {
-    static thread_local auto gen =
-        torch::make_unique<std::mt19937>(std::random_device()());
-    std::uniform_real_distribution<double> dist(0.0, 1.0);
-    return dist(*gen);
+// Picks the callbacks of list to run, given the countdowns of the calling
+// thread for it
+uint64_t pick(
+    const std::vector<Callback>& callbacks,
+    std::vector<Countdown>& countdowns,
+    c10::optional<bool>& run_global_sampled,
+    bool& needs_inputs) {
+  uint64_t picked = 0;
+  if (countdowns.size() < callbacks.size()) {
+    countdowns.resize(callbacks.size());
   }
-};
+  for (size_t idx = 0; idx < callbacks.size(); ++idx) {
+    const auto& callback = callbacks[idx];
+    bool run = true;
+    if (callback.global_sampled) {
+      if (!run_global_sampled) {
+        run_global_sampled = thread_local_state().global_sampled_countdown.next(0, sampling_prob);
+      }
+      run = *run_global_sampled;
+    } else if (callback.sampling_prob < 1.0) {
+      run = countdowns[idx].next(callback.id, callback.sampling_prob);
+    }
+    if (run) {
+      picked |= uint64_t(1) << idx;
+      needs_inputs = needs_inputs || callback.needs_inputs;
+    }
+  }
+  return picked;
+}
+
+void push(std::vector<Callback>& callbacks, Callback callback) {
+  TORCH_CHECK(callbacks.size() < kMaxCallbacks,
+      "RecordFunction: can't push more than ", kMaxCallbacks, " callbacks");
+  TORCH_CHECK(callback.sampling_prob >= 0.0 && callback.sampling_prob <= 1.0,
+      "RecordFunction: the sampling probability must be between 0 and 1, got ",
+      callback.sampling_prob);
+  callback.id = next_callback_id();
+  callbacks.push_back(std::move(callback));
+}
 
 // thread_local_func_ points to the currently active RecordFunction.
 thread_local RecordFunction* thread_local_func_ = nullptr;
 
-CallbackManager& manager() {
-  static CallbackManager instance;
-  return instance;
-}
-
 } // namespace
 
+namespace detail {
+std::atomic<int> num_callback_sources{0};
+} // namespace detail
+
 void setSamplingProbability(double prob) {
-  manager().setSamplingProbability(prob);
+  TORCH_CHECK(prob >= 0.0 && prob <= 1.0);
+  sampling_prob = prob;
 }
 
 double getSamplingProbability() {
-  return manager().getSamplingProbability();
-}
-
-bool shouldRunSampledCallbacks() {
-  return manager().shouldRunSampledCallbacks();
+  return sampling_prob;
 }
 
 void pushCallback(
@@ -117,28 +168,65 @@ void pushCallback(
     RecordFunctionCallback end,
     bool needs_inputs,
     bool sampled) {
-  manager().pushCallback(
-      std::move(start), std::move(end), needs_inputs, sampled);
+  push(global_callbacks, {std::move(start), std::move(end), needs_inputs, sampled, 1.0, 0});
+  ++detail::num_callback_sources;
+}
+
+void pushSampledCallback(
+    RecordFunctionCallback start,
+    RecordFunctionCallback end,
+    double sampling_prob,
+    bool needs_inputs) {
+  push(global_callbacks, {std::move(start), std::move(end), needs_inputs, false, sampling_prob, 0});
+  ++detail::num_callback_sources;
 }
 
 void popCallback() {
-  manager().popCallback();
+  if (global_callbacks.empty()) {
+    throw std::runtime_error("Empty callbacks stack");
+  }
+  global_callbacks.pop_back();
+  --detail::num_callback_sources;
 }
 
-bool hasCallbacks() {
-  return manager().hasCallbacks();
+void pushThreadLocalCallback(
+    RecordFunctionCallback start,
+    RecordFunctionCallback end,
+    bool needs_inputs,
+    double sampling_prob) {
+  auto& callbacks = thread_local_state().callbacks;
+  push(callbacks, {std::move(start), std::move(end), needs_inputs, false, sampling_prob, 0});
+  if (callbacks.size() == 1) {
+    ++detail::num_callback_sources;
+  }
 }
 
-bool needsInputs() {
-  return manager().needsInputs();
+void popThreadLocalCallback() {
+  auto& callbacks = thread_local_state().callbacks;
+  if (callbacks.empty()) {
+    throw std::runtime_error("Empty thread local callbacks stack");
+  }
+  callbacks.pop_back();
+  if (callbacks.empty()) {
+    --detail::num_callback_sources;
+  }
 }
 
-bool hasNonSampledCallbacks() {
-  return manager().hasNonSampledCallbacks();
+bool RecordFunction::pickCallbacks() {
+  AT_ASSERT(!initialized_);
+  auto& state = thread_local_state();
+  c10::optional<bool> run_global_sampled;
+  needs_inputs_ = false;
+  global_callbacks_ = pick(
+      global_callbacks, state.global_countdowns, run_global_sampled, needs_inputs_);
+  thread_local_callbacks_ = pick(
+      state.callbacks, state.countdowns, run_global_sampled, needs_inputs_);
+  picked_ = true;
+  return global_callbacks_ != 0 || thread_local_callbacks_ != 0;
 }
 
 void RecordFunction::before(const char* name, int64_t sequence_nr) {
-  if (!hasCallbacks()) {
+  if (!hasCallbacks() || (!picked_ && !pickCallbacks())) {
     return;
   }
   AT_ASSERT(!initialized_);
@@ -150,7 +238,7 @@ void RecordFunction::before(const char* name, int64_t sequence_nr) {
 }
 
 void RecordFunction::before(std::string name, int64_t sequence_nr) {
-  if (!hasCallbacks()) {
+  if (!hasCallbacks() || (!picked_ && !pickCallbacks())) {
     return;
   }
   AT_ASSERT(!initialized_);
@@ -162,7 +250,7 @@ void RecordFunction::before(std::string name, int64_t sequence_nr) {
 }
 
 void RecordFunction::before(Node* fn, int64_t sequence_nr) {
-  if (!hasCallbacks()) {
+  if (!hasCallbacks() || (!picked_ && !pickCallbacks())) {
     return;
   }
   AT_ASSERT(!initialized_);
@@ -178,9 +266,15 @@ void RecordFunction::processCallbacks() {
   parent_ = thread_local_func_;
   thread_local_func_ = this;
 
-  for (size_t idx = 0; idx < manager().start_callbacks.size(); ++idx) {
-    if (!manager().is_callback_sampled[idx] || run_sampled_) {
-      manager().start_callbacks[idx](*this);
+  for (size_t idx = 0; idx < global_callbacks.size(); ++idx) {
+    if (global_callbacks_ & (uint64_t(1) << idx)) {
+      global_callbacks[idx].start(*this);
+    }
+  }
+  const auto& callbacks = thread_local_state().callbacks;
+  for (size_t idx = 0; idx < callbacks.size(); ++idx) {
+    if (thread_local_callbacks_ & (uint64_t(1) << idx)) {
+      callbacks[idx].start(*this);
     }
   }
 }
@@ -191,9 +285,15 @@ RecordFunction::~RecordFunction() {
 
 void RecordFunction::end() {
   if (initialized_) {
-    for (size_t idx = 0; idx < manager().end_callbacks.size(); ++idx) {
-      if (!manager().is_callback_sampled[idx] || run_sampled_) {
-        manager().end_callbacks[idx](*this);
+    for (size_t idx = 0; idx < global_callbacks.size(); ++idx) {
+      if (global_callbacks_ & (uint64_t(1) << idx)) {
+        global_callbacks[idx].end(*this);
+      }
+    }
+    const auto& callbacks = thread_local_state().callbacks;
+    for (size_t idx = 0; idx < callbacks.size(); ++idx) {
+      if (thread_local_callbacks_ & (uint64_t(1) << idx)) {
+        callbacks[idx].end(*this);
       }
     }
 
@@ -1,9 +1,14 @@
 #pragma once
 
 #include <ATen/core/ivalue.h>
+#include <c10/macros/Macros.h>
 #include <c10/util/SmallVector.h>
 #include <torch/csrc/WindowsTorchApiMacro.h>
 
+#include <atomic>
+#include <cstdint>
+#include <functional>
+
 namespace torch { namespace autograd {
 
 struct Node;
@@ -50,6 +55,15 @@ struct TORCH_API RecordFunction {
   // current returns the currently active RecordFunction in this thread.
   static RecordFunction* current();
 
+  // Decides which callbacks run for this RecordFunction, drawing the sampled
+  // ones; returns false if none does. Called by before() unless called first.
+  bool pickCallbacks();
+
+  // Whether a callback picked to run needs the inputs
+  bool needsInputs() const {
+    return needs_inputs_;
+  }
+
   // before function initializes RecordFunction members and calls
   // start callbacks
   void before(const char* name, int64_t sequence_nr = -1);
@@ -97,10 +111,6 @@ struct TORCH_API RecordFunction {
     return parent_;
   }
 
-  void setRunSampled(bool run_sampled) {
-    run_sampled_ = run_sampled;
-  }
-
   void end();
 
  private:
@@ -114,26 +124,37 @@ struct TORCH_API RecordFunction {
   RecordFunction* parent_ = nullptr;
 
   bool initialized_ = false;
-  bool run_sampled_ = false;
+  bool picked_ = false;
+  bool needs_inputs_ = false;
+  // Bit i is set if the i-th global or thread local callback runs
+  uint64_t global_callbacks_ = 0;
+  uint64_t thread_local_callbacks_ = 0;
 };
 
-TORCH_API bool hasCallbacks();
-TORCH_API bool needsInputs();
-TORCH_API bool hasNonSampledCallbacks();
+namespace detail {
+// The number of global callbacks, plus the number of threads that have thread
+// local callbacks. Only ever loaded relaxed, which is a plain load.
+TORCH_API extern std::atomic<int> num_callback_sources;
+} // namespace detail
+
+// Whether any callback may run on this thread; a callback that is sampled may
+// still not run for a RecordFunction
+inline bool hasCallbacks() {
+  return detail::num_callback_sources.load(std::memory_order_relaxed) != 0;
+}
 
+// The probability that the callbacks pushed with sampled = true run for a
+// RecordFunction; they either all run or none does
 TORCH_API void setSamplingProbability(double);
 TORCH_API double getSamplingProbability();
 
-TORCH_API bool shouldRunSampledCallbacks();
-
 // optional argument - function's seq_no
+// The inputs are only evaluated if a callback picked to run needs them.
 #define RECORD_FUNCTION(fn, inputs, ...) \
   torch::autograd::profiler::RecordFunction guard; \
-  if (torch::autograd::profiler::hasCallbacks()) { \
-    auto run_sampled = torch::autograd::profiler::shouldRunSampledCallbacks(); \
-    if (run_sampled || torch::autograd::profiler::hasNonSampledCallbacks()) { \
-      guard.setRunSampled(run_sampled); \
-      if (torch::autograd::profiler::needsInputs()) { \
+  if (C10_UNLIKELY(torch::autograd::profiler::hasCallbacks())) { \
+    if (guard.pickCallbacks()) { \
+      if (guard.needsInputs()) { \
         guard.before(fn, inputs, ##__VA_ARGS__); \
       } else { \
         guard.before(fn, ##__VA_ARGS__); \
@@ -143,13 +164,32 @@ TORCH_API bool shouldRunSampledCallbacks();
 
 // WARNING: all calls to pushCallback/popCallback are not thread safe and
 // must not overlap with other code execution
+// At most 64 global and 64 thread local callbacks can be pushed.
 using RecordFunctionCallback = std::function<void(const RecordFunction&)>;
 TORCH_API void pushCallback(
     RecordFunctionCallback start,
     RecordFunctionCallback end = [](const RecordFunction&){},
     bool needs_inputs = false,
     bool sampled = false);
+// Like pushCallback, but the callbacks run for a RecordFunction with
+// probability sampling_prob, drawn independently of the other callbacks.
+// Skipping a RecordFunction costs a decrement, so low probabilities keep the
+// overhead of always-on monitoring low.
+TORCH_API void pushSampledCallback(
+    RecordFunctionCallback start,
+    RecordFunctionCallback end,
+    double sampling_prob,
+    bool needs_inputs = false);
 TORCH_API void popCallback();
 
+// Callbacks that only run for the RecordFunctions of the current thread. They
+// can be pushed and popped while other threads run.
+TORCH_API void pushThreadLocalCallback(
+    RecordFunctionCallback start,
+    RecordFunctionCallback end = [](const RecordFunction&){},
+    bool needs_inputs = false,
+    double sampling_prob = 1.0);
+TORCH_API void popThreadLocalCallback();
+
 } // namespace profiler
 }} // namespace torch::autograd
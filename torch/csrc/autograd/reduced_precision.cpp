@@ -0,0 +1,51 @@
+#include <torch/csrc/autograd/reduced_precision.h>
+
+#include <ATen/ATen.h>
+#include <c10/util/Exception.h>
+
+#include <utility>
+
+namespace torch { namespace autograd {
+
+struct ReducedPrecisionSave::Packed : PackedTensor {
+  Packed(at::Tensor data, std::shared_ptr<PackedTensor> next, at::ScalarType dtype)
+      : data_(std::move(data)), next_(std::move(next)), dtype_(dtype) {}
+
+  at::Tensor unpack() override {
+    return (next_ ? next_->unpack() : data_).to(dtype_);
+  }
+
+  // The narrowed tensor, unless next_ took it
+  at::Tensor data_;
+  std::shared_ptr<PackedTensor> next_;
+  // The type of the saved tensor
+  const at::ScalarType dtype_;
+};
+
+ReducedPrecisionSave::ReducedPrecisionSave(
+    at::ScalarType dtype,
+    size_t min_bytes,
+    std::shared_ptr<SavedTensorHooks> next)
+    : dtype_(dtype), min_bytes_(min_bytes), next_(std::move(next)) {
+  TORCH_CHECK(dtype == at::kHalf || dtype == at::kBFloat16,
+              "ReducedPrecisionSave: expected Half or BFloat16, but got ", dtype);
+}
+
+std::shared_ptr<PackedTensor> ReducedPrecisionSave::pack(const at::Tensor& data) {
+  // Only the types wider than dtype_ get narrowed, which leaves the integral
+  // tensors, e.g. the indices of max pooling, and the complex ones alone
+  if (!at::isFloatingType(data.scalar_type()) ||
+      data.element_size() <= c10::elementSize(dtype_) ||
+      data.layout() != at::kStrided ||
+      static_cast<size_t>(data.numel() * data.element_size()) < min_bytes_) {
+    return next_ ? next_->pack(data) : nullptr;
+  }
+  auto narrowed = data.to(dtype_);
+  auto next = next_ ? next_->pack(narrowed) : nullptr;
+  if (next) {
+    narrowed.reset();
+  }
+  return std::make_shared<Packed>(std::move(narrowed), std::move(next), data.scalar_type());
+}
+
+}} // namespace torch::autograd
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <torch/csrc/WindowsTorchApiMacro.h>
+#include <torch/csrc/autograd/saved_variable.h>
+
+#include <c10/core/ScalarType.h>
+
+#include <cstddef>
+#include <memory>
+
+namespace torch { namespace autograd {
+
+// SavedTensorHooks that store the floating point tensors saved for backward
+// in a narrower floating point type, kHalf or kBFloat16, and cast them back
+// to their own type when backward unpacks them. Only the ops run while the
+// hooks are installed are affected, so they can be installed around a single
+// op or module:
+//
+//   {
+//     SavedTensorHooksGuard guard(std::make_shared<ReducedPrecisionSave>(at::kBFloat16));
+//     h = block->forward(h);
+//   }
+//
+// The gradients are computed from the rounded values, which is usually fine
+// for activations but not necessarily for everything a backward formula
+// saves, so the scope should be kept to the ops known to tolerate it.
+//
+// The narrowed tensors are passed on to next if given, e.g. to a HostOffload
+// to move them to host memory as well.
+struct TORCH_API ReducedPrecisionSave : SavedTensorHooks {
+  // Saved tensors smaller than min_bytes are kept as they are
+  explicit ReducedPrecisionSave(
+      at::ScalarType dtype = at::kHalf,
+      size_t min_bytes = 0,
+      std::shared_ptr<SavedTensorHooks> next = nullptr);
+
+  std::shared_ptr<PackedTensor> pack(const at::Tensor& data) override;
+
+ private:
+  struct Packed;
+
+  const at::ScalarType dtype_;
+  const size_t min_bytes_;
+  const std::shared_ptr<SavedTensorHooks> next_;
+};
+
+}} // namespace torch::autograd
@@ -2,6 +2,7 @@
 
 #include <torch/csrc/autograd/edge.h>
 #include <torch/csrc/autograd/function.h>
+#include <torch/csrc/autograd/recompute.h>
 #include <torch/csrc/autograd/variable.h>
 #include <torch/csrc/autograd/anomaly_mode.h>
 
@@ -14,6 +15,19 @@
 
 namespace torch { namespace autograd {
 
+namespace {
+thread_local std::shared_ptr<SavedTensorHooks> saved_tensor_hooks;
+} // namespace
+
+SavedTensorHooksGuard::SavedTensorHooksGuard(std::shared_ptr<SavedTensorHooks> hooks)
+    : prev_hooks_(std::move(saved_tensor_hooks)) {
+  saved_tensor_hooks = std::move(hooks);
+}
+
+SavedTensorHooksGuard::~SavedTensorHooksGuard() {
+  saved_tensor_hooks = std::move(prev_hooks_);
+}
+
 SavedVariable::SavedVariable(const Variable& variable, bool is_output, bool is_inplace_view) {
   if (variable.defined()) {
     was_default_constructed_ = false;
@@ -23,7 +37,16 @@ SavedVariable::SavedVariable(const Variable& variable, bool is_output, bool is_i
     is_inplace_view_ = is_inplace_view;
     // These copies are all shared_ptr copies, so slightly more expensive.
     // Do them here instead of in the init list in case data is undefined.
-    data_ = variable.tensor_data();
+    recomputation_ = impl::recomputation_for(variable, recompute_index_);
+    if (!recomputation_) {
+      data_ = variable.tensor_data();
+      if (saved_tensor_hooks) {
+        packed_ = saved_tensor_hooks->pack(data_);
+        if (packed_) {
+          data_.reset();
+        }
+      }
+    }
     if (variable.is_leaf()) {
       grad_accumulator_ = impl::grad_accumulator(variable);
     } else if (!is_output) {
@@ -36,8 +59,17 @@ SavedVariable::SavedVariable(const Variable& variable, bool is_output, bool is_i
   }
 }
 
+void SavedVariable::reset_data() {
+  data_.reset();
+  packed_.reset();
+  if (recomputation_) {
+    recomputation_->release(recompute_index_);
+    recomputation_.reset();
+  }
+}
+
 Variable SavedVariable::unpack(std::shared_ptr<Node> saved_for) const {
-  if (!data_.defined()) {
+  if (!data_.defined() && !recomputation_ && !packed_) {
     if (!was_default_constructed_) {
       throw std::runtime_error(ERR_BACKWARD_TWICE);
     }
@@ -57,8 +89,10 @@ Variable SavedVariable::unpack(std::shared_ptr<Node> saved_for) const {
   if (saved_version_ != version_counter_.current_version()) {
     std::stringstream message;
     message << "one of the variables needed for gradient computation has been "
-        "modified by an inplace operation: [" << data_.type().toString() << " "
-        << data_.sizes() << "]";
+        "modified by an inplace operation";
+    if (data_.defined()) {
+      message << ": [" << data_.type().toString() << " " << data_.sizes() << "]";
+    }
     if (grad_fn) {
         message << ", which is output " << output_nr_
             << " of " << grad_fn->name() << ",";
@@ -81,11 +115,13 @@ Variable SavedVariable::unpack(std::shared_ptr<Node> saved_for) const {
   // NB: saved views are unpacked as normal Variables (not views) even though
   // they still share the same storage. This works only because we never call
   // in-place functions on unpacked variables.
+  const auto data = recomputation_ ? recomputation_->get(recompute_index_)
+      : packed_ ? packed_->unpack() : data_;
   Variable var;
   if (grad_fn) {
-    var = make_variable(data_, Edge(std::move(grad_fn), output_nr_));
+    var = make_variable(data, Edge(std::move(grad_fn), output_nr_));
   } else {
-    var = make_variable(data_, requires_grad_);
+    var = make_variable(data, requires_grad_);
   }
   impl::set_version_counter(var, saved_version_);
 
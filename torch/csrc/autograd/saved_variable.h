@@ -11,9 +11,51 @@ namespace torch { namespace autograd {
 
 using Variable = at::Tensor;
 struct Node;
+struct Recomputation;
+
+namespace impl {
+// Called for every SavedVariable of a defined variable. Inside a checkpoint()
+// call, sets index to the variable's position among the variables saved
+// there, and returns the Recomputation that can rebuild it if it was produced
+// there. See Note [Recomputed saved variables]
+TORCH_API std::shared_ptr<Recomputation> recomputation_for(
+    const Variable& variable, uint32_t& index);
+} // namespace impl
 
 TORCH_API extern const char* ERR_BACKWARD_TWICE;
 
+/// The data of a saved variable, moved out of the way by `SavedTensorHooks`.
+struct TORCH_API PackedTensor {
+  virtual ~PackedTensor() = default;
+  /// Returns the data given to `SavedTensorHooks::pack()`. Called each time
+  /// the saved variable is unpacked, from the engine thread of its device.
+  virtual at::Tensor unpack() = 0;
+};
+
+/// Hooks that can move the data of saved variables somewhere else between the
+/// forward and the backward pass, e.g. to host memory.
+struct TORCH_API SavedTensorHooks {
+  virtual ~SavedTensorHooks() = default;
+  /// Called with the data of every variable saved on the thread while the
+  /// hooks are installed. Returns nullptr to leave the data in the saved
+  /// variable; the data is dropped otherwise.
+  virtual std::shared_ptr<PackedTensor> pack(const at::Tensor& data) = 0;
+};
+
+/// Installs `SavedTensorHooks` for the current thread, for the lifetime of the
+/// guard.
+class TORCH_API SavedTensorHooksGuard {
+ public:
+  explicit SavedTensorHooksGuard(std::shared_ptr<SavedTensorHooks> hooks);
+  ~SavedTensorHooksGuard();
+
+  SavedTensorHooksGuard(const SavedTensorHooksGuard&) = delete;
+  SavedTensorHooksGuard& operator=(const SavedTensorHooksGuard&) = delete;
+
+ private:
+  std::shared_ptr<SavedTensorHooks> prev_hooks_;
+};
+
 /// A snapshot of a variable at a certain version. A `SavedVariable` stores
 /// enough information to reconstruct a variable from a certain point in time.
 class TORCH_API SavedVariable {
@@ -28,9 +70,7 @@ class TORCH_API SavedVariable {
   /// circular reference.
   Variable unpack(std::shared_ptr<Node> saved_for = nullptr) const;
 
-  void reset_data() {
-    return data_.reset();
-  }
+  void reset_data();
 
   void reset_grad_function() {
     grad_fn_.reset();
@@ -38,6 +78,12 @@ class TORCH_API SavedVariable {
 
  private:
   at::Tensor data_;
+  // Set instead of data_ if the variable is rebuilt by running a checkpointed
+  // function again, recompute_index_ being its position in there
+  std::shared_ptr<Recomputation> recomputation_;
+  uint32_t recompute_index_ = 0;
+  // Set instead of data_ if SavedTensorHooks took the data
+  std::shared_ptr<PackedTensor> packed_;
 
   // The gradient function associated with this node. If has_grad_fn
   // is false, then this is a leaf node. Note that the grad_fn is not saved if
@@ -0,0 +1,158 @@
+#include <torch/csrc/autograd/static_graph.h>
+
+#include <torch/csrc/autograd/anomaly_mode.h>
+#include <torch/csrc/autograd/engine.h>
+
+#include <c10/util/Exception.h>
+
+#include <utility>
+
+namespace torch { namespace autograd {
+
+// Note [Static graphs]
+// ~~~~~~~~~~~~~~~~~~~~
+// The generated code of a differentiable operation asks the current step for
+// the node at the next position of the recorded ones before it creates its
+// own. If that node has the type the operation needs, the operation takes it
+// over: its next edges are compared with the gradient edges of the new inputs
+// (and only assigned if they differ), its input metadata is cleared for the
+// new outputs, everything the node saves is assigned as for a new node, and
+// it gets a new sequence number, as if it had just been created. Hooks
+// registered on the node in the previous step are dropped with the rest of
+// its old state.
+//
+// A node of any other type means that the step runs other operations than the
+// recorded ones, and the nodes from that position on are recorded again.
+// Nodes that are not created by the generated code, like custom functions or
+// CopySlices, are never recorded and simply created anew.
+//
+// As long as no node changed its next edges, a graph reachable from the same
+// roots is made of the same nodes: the roots and the edges of the nodes keep
+// every node the old graph reached alive, and every node the step created
+// anew would have changed an edge pointing to it. So the engine hands the
+// dependency counters of the last backward() to the next one, reset to their
+// initial values, instead of counting the dependencies again. Changing an
+// edge, or recording a node over another one, throws them away.
+//
+// The nodes of the previous step are rebound in place, so a step must not use
+// them: a node it directly depends on whose sequence number is still from the
+// previous step is an error.
+
+namespace {
+
+thread_local StaticGraph* current_graph = nullptr;
+
+} // namespace
+
+StaticGraph* StaticGraph::current() {
+  return current_graph;
+}
+
+std::shared_ptr<Node> StaticGraph::next_node(const std::type_info& type) {
+  if (cursor_ < nodes_.size()) {
+    const auto& node = nodes_[cursor_];
+    if (typeid(*node) == type) {
+      cursor_++;
+      return node;
+    }
+    nodes_.resize(cursor_);
+    forget_dependencies();
+  }
+  return nullptr;
+}
+
+void StaticGraph::bind(Node& node, bool edges_match) {
+  if (!edges_match) {
+    forget_dependencies();
+  }
+  for (const auto& edge : node.next_edges()) {
+    const auto& next = edge.function;
+    if (next && next->sequence_nr() >= prev_step_begin_ &&
+        next->sequence_nr() < prev_step_end_) {
+      nodes_.clear();
+      cursor_ = 0;
+      forget_dependencies();
+      TORCH_CHECK(false,
+          "StaticGraph: ", node.name(), " uses the result of ", next->name(),
+          " from the previous step, whose nodes this step rebinds. Detach the "
+          "tensors that a step passes on to the next one.");
+    }
+  }
+  node.sequence_nr_ = Node::get_next_sequence_nr()++;
+  node.clear_input_metadata();
+  node.pre_hooks_.clear();
+  node.post_hooks_.clear();
+  if (AnomalyMode::is_enabled()) {
+    node.metadata()->store_stack();
+  }
+}
+
+void StaticGraph::record(std::shared_ptr<Node> node) {
+  if (cursor_ == nodes_.size()) {
+    nodes_.push_back(std::move(node));
+    cursor_++;
+  }
+}
+
+void StaticGraph::begin_step() {
+  cursor_ = 0;
+  step_begin_ = Node::peek_at_next_sequence_nr();
+}
+
+void StaticGraph::end_step() {
+  prev_step_begin_ = step_begin_;
+  prev_step_end_ = Node::peek_at_next_sequence_nr();
+}
+
+bool StaticGraph::restore_dependencies(const edge_list& roots, GraphTask& task) {
+  if (!have_dependencies_ || roots != roots_) {
+    forget_dependencies();
+    return false;
+  }
+  size_t i = 0;
+  for (auto& dependency : dependencies_) {
+    dependency.second.store(counts_[i++], std::memory_order_relaxed);
+  }
+  task.dependencies_ = std::move(dependencies_);
+  dependencies_.clear();
+  have_dependencies_ = false;
+  num_reused_dependencies_++;
+  return true;
+}
+
+void StaticGraph::remember_dependencies(const edge_list& roots, const GraphTask& task) {
+  roots_ = roots;
+  counts_.clear();
+  counts_.reserve(task.dependencies_.size());
+  for (const auto& dependency : task.dependencies_) {
+    counts_.push_back(dependency.second.load(std::memory_order_relaxed));
+  }
+}
+
+void StaticGraph::keep_dependencies(GraphTask& task) {
+  if (roots_.empty()) {
+    return;
+  }
+  dependencies_ = std::move(task.dependencies_);
+  have_dependencies_ = true;
+}
+
+void StaticGraph::forget_dependencies() {
+  roots_.clear();
+  counts_.clear();
+  dependencies_.clear();
+  have_dependencies_ = false;
+}
+
+StaticGraphGuard::StaticGraphGuard(StaticGraph& graph)
+    : graph_(graph), prev_graph_(current_graph) {
+  current_graph = &graph_;
+  graph_.begin_step();
+}
+
+StaticGraphGuard::~StaticGraphGuard() {
+  graph_.end_step();
+  current_graph = prev_graph_;
+}
+
+}} // namespace torch::autograd
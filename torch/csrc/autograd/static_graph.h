@@ -0,0 +1,174 @@
+#pragma once
+
+#include <torch/csrc/WindowsTorchApiMacro.h>
+#include <torch/csrc/autograd/edge.h>
+#include <torch/csrc/autograd/function.h>
+#include <torch/csrc/autograd/variable.h>
+#include <torch/csrc/utils/variadic.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <typeinfo>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace torch { namespace autograd {
+
+struct GraphTask;
+
+// The autograd graph of a training step that builds the same graph every time.
+// The first step run under a StaticGraphGuard records the nodes created by the
+// differentiable operations; the following steps bind the new tensors to the
+// same nodes instead of allocating new ones, and a backward() from the same
+// roots reuses the dependency counts computed the last time:
+//
+//   StaticGraph graph;
+//   for (auto& batch : data_loader) {
+//     StaticGraphGuard guard(graph);
+//     auto loss = model->forward(batch.data);
+//     loss.backward();
+//   }
+//
+// A step may run different operations than the previous one; the nodes from
+// the first difference on are recorded again. Nothing of the graph of a step
+// may be used once the next step started: its nodes then belong to the new
+// tensors. State carried from one step to the next, like the hidden state of
+// an RNN, must be detached; the step fails if one of its operations directly
+// uses a node of the previous step that wasn't bound yet. A StaticGraph must
+// be used from one thread.
+// See Note [Static graphs]
+struct TORCH_API StaticGraph {
+  StaticGraph() = default;
+
+  StaticGraph(const StaticGraph&) = delete;
+  StaticGraph& operator=(const StaticGraph&) = delete;
+
+  // The graph of the current step on this thread, if any
+  static StaticGraph* current();
+
+  // The recorded node for the next operation of the step if it is a T, which
+  // the caller then binds; nullptr otherwise, after which the rest of the
+  // step is recorded again
+  std::shared_ptr<Node> next_node(const std::type_info& type);
+  // Prepares a node returned by next_node() for its new inputs and outputs.
+  // edges_match tells whether its next edges were the same as before.
+  void bind(Node& node, bool edges_match);
+  // Appends a node to the recorded ones, if they are being recorded
+  void record(std::shared_ptr<Node> node);
+
+  size_t num_recorded() const {
+    return nodes_.size();
+  }
+  // How many backward() calls of this graph reused the dependencies
+  int64_t num_reused_dependencies() const {
+    return num_reused_dependencies_;
+  }
+
+ private:
+  friend class StaticGraphGuard;
+  friend struct Engine;
+
+  void begin_step();
+  void end_step();
+
+  // Called by the engine for a backward() from roots, before and after
+  // executing it
+  bool restore_dependencies(const edge_list& roots, GraphTask& task);
+  void remember_dependencies(const edge_list& roots, const GraphTask& task);
+  void keep_dependencies(GraphTask& task);
+  void forget_dependencies();
+
+  // The nodes in the order the operations of a step create them
+  std::vector<std::shared_ptr<Node>> nodes_;
+  // The next one of nodes_ the step binds
+  size_t cursor_ = 0;
+
+  // Sequence numbers of the nodes created on the thread during the previous
+  // and during the current step
+  uint64_t prev_step_begin_ = 0;
+  uint64_t prev_step_end_ = 0;
+  uint64_t step_begin_ = 0;
+
+  // The dependency counts of the last backward(), valid as long as no node
+  // changed its next edges. The counters are handed to the GraphTask while it
+  // runs, and when it is done reset from counts_, in the order they iterate.
+  edge_list roots_;
+  std::vector<int> counts_;
+  std::unordered_map<Node*, std::atomic<int>> dependencies_;
+  bool have_dependencies_ = false;
+  int64_t num_reused_dependencies_ = 0;
+};
+
+// Makes a StaticGraph the graph of the current step on this thread, for the
+// lifetime of the guard
+class TORCH_API StaticGraphGuard {
+ public:
+  explicit StaticGraphGuard(StaticGraph& graph);
+  ~StaticGraphGuard();
+
+  StaticGraphGuard(const StaticGraphGuard&) = delete;
+  StaticGraphGuard& operator=(const StaticGraphGuard&) = delete;
+
+ private:
+  StaticGraph& graph_;
+  StaticGraph* prev_graph_;
+};
+
+namespace detail {
+// Compares the gradient edges of the given variables with the next edges of a
+// node, like `collect_next_edges` would collect them.
+struct MatchNextEdges : IterArgs<MatchNextEdges> {
+  explicit MatchNextEdges(const edge_list& next_edges)
+      : next_edges(next_edges) {}
+  const edge_list& next_edges;
+  size_t index = 0;
+  bool match = true;
+  using IterArgs<MatchNextEdges>::operator();
+  void operator()(const Variable& variable) {
+    if (!match || index >= next_edges.size()) {
+      match = false;
+    } else if (variable.defined()) {
+      match = impl::gradient_edge(variable) == next_edges[index++];
+    } else {
+      match = !next_edges[index++].is_valid();
+    }
+  }
+};
+} // namespace detail
+
+/// Returns the recorded node of type `T` for the next operation of the
+/// current `StaticGraph` step, with its next edges set to those of the given
+/// variables, or nullptr if there is none. Called by the generated code in
+/// place of creating the node.
+template <typename T, typename... Variables>
+std::shared_ptr<T> reuse_static_node(Variables&&... variables) {
+  auto* graph = StaticGraph::current();
+  if (!graph) {
+    return nullptr;
+  }
+  auto node = graph->next_node(typeid(T));
+  if (!node) {
+    return nullptr;
+  }
+  detail::MatchNextEdges match(node->next_edges());
+  match.apply(variables...);
+  const bool edges_match = match.match && match.index == node->num_outputs();
+  if (!edges_match) {
+    node->set_next_edges(collect_next_edges(variables...));
+  }
+  graph->bind(*node, edges_match);
+  return std::static_pointer_cast<T>(std::move(node));
+}
+
+/// Records a node just created by the generated code, if the current
+/// `StaticGraph` step records nodes.
+inline void record_static_node(std::shared_ptr<Node> node) {
+  if (auto* graph = StaticGraph::current()) {
+    graph->record(std::move(node));
+  }
+}
+
+}} // namespace torch::autograd
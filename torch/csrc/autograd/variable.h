@@ -216,6 +216,10 @@ struct TORCH_API AutogradMeta : public c10::AutogradMetaInterface {
     return requires_grad_ || grad_fn_;
   }
 
+  bool is_leaf() const override {
+    return grad_fn_ == nullptr;
+  }
+
   /// Accesses the gradient `Variable` of this `Variable`.
   Variable& grad() override {
     return grad_;
@@ -359,6 +363,23 @@ inline Variable make_variable_view(
     bool is_differentiable = true,
     bool allow_tensor_metadata_change = true) {
   if (data.defined()) {
+    // The view computed by the base op is usually referenced by nothing but
+    // `data`, in which case its TensorImpl becomes the Variable, instead of
+    // a shallow copy (which costs an allocation and refcount bumps on the
+    // storage and the version counter).
+    if (data.getIntrusivePtr().use_count() == 1 && data.getIntrusivePtr()->unique_version()) {
+      auto data_impl = c10::intrusive_ptr<at::TensorImpl>::reclaim(data.unsafeReleaseTensorImpl());
+      data_impl->set_allow_tensor_metadata_change(allow_tensor_metadata_change);
+      if (is_differentiable) {
+        // DifferentiableViewMeta shares the version counter of the base
+        data_impl->set_autograd_meta(c10::guts::make_unique<DifferentiableViewMeta>(
+          data_impl.get(), std::move(base)));
+      } else {
+        data_impl->set_version_counter(impl::version_counter(base));
+        data_impl->set_autograd_meta(nullptr);
+      }
+      return Variable(std::move(data_impl));
+    }
     if (is_differentiable) {
       /// Differentiable view. Track history with DifferentiableViewMeta.
       auto data_impl_copy = data.getIntrusivePtr()->shallow_copy_and_detach(
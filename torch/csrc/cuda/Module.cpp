@@ -2,10 +2,13 @@
 #include <unordered_map>
 #include <thread>
 #include <chrono>
+#include <fstream>
 #include <sstream>
 #include <TH/TH.h>
 #include <ATen/ATen.h>
+#include <ATen/cuda/AsyncCopy.h>
 #include <ATen/cuda/CUDAContext.h>
+#include <ATen/cuda/CUDAGraph.h>
 #include <ATen/CUDAGenerator.h>
 #include <c10/cuda/CUDAFunctions.h>
 #include <c10/cuda/CUDACachingAllocator.h>
@@ -292,6 +295,9 @@ PyObject * THCPModule_memoryStats(PyObject *_unused, PyObject *arg)
   py::dict result;
   result["num_alloc_retries"] = stats.num_alloc_retries;
   result["num_ooms"] = stats.num_ooms;
+  result["num_deferred_frees_released_by_wait"] = stats.num_deferred_frees_released_by_wait;
+  result["size_class_cached_blocks"] = stats.size_class_cached_blocks;
+  result["size_class_cached_bytes"] = stats.size_class_cached_bytes;
   result["allocation"] = statArrayToDict(stats.allocation);
   result["segment"] = statArrayToDict(stats.segment);
   result["active"] = statArrayToDict(stats.active);
@@ -300,6 +306,8 @@ PyObject * THCPModule_memoryStats(PyObject *_unused, PyObject *arg)
   result["reserved_bytes"] = statArrayToDict(stats.reserved_bytes);
   result["active_bytes"] = statArrayToDict(stats.active_bytes);
   result["inactive_split_bytes"] = statArrayToDict(stats.inactive_split_bytes);
+  result["deferred_free"] = statArrayToDict(stats.deferred_free);
+  result["deferred_free_bytes"] = statArrayToDict(stats.deferred_free_bytes);
 
   return result.release().ptr();
   END_HANDLE_TH_ERRORS
@@ -339,13 +347,17 @@ PyObject * THCPModule_memorySnapshot(PyObject *_unused, PyObject *noargs)
     segmentDict["total_size"] = segmentInfo.total_size;
     segmentDict["allocated_size"] = segmentInfo.allocated_size;
     segmentDict["active_size"] = segmentInfo.active_size;
+    segmentDict["reserved_size"] = segmentInfo.reserved_size;
     segmentDict["segment_type"] = (segmentInfo.is_large ? "large" : "small");
+    segmentDict["is_expandable"] = segmentInfo.is_expandable;
 
     py::list blocks;
     for (const auto& blockInfo : segmentInfo.blocks) {
       py::dict blockDict;
       blockDict["size"] = blockInfo.size;
-      blockDict["state"] = (blockInfo.allocated ? "active_allocated" : (blockInfo.active ? "active_pending_free" : "inactive"));
+      blockDict["state"] = (blockInfo.allocated ? "active_allocated" :
+          (blockInfo.active ? "active_pending_free" :
+          (blockInfo.size_class_cached ? "size_class_cached" : "inactive")));
       blocks.append(blockDict);
     }
     segmentDict["blocks"] = blocks;
@@ -364,6 +376,79 @@ PyObject * THCPModule_memorySnapshot(PyObject *_unused, PyObject *noargs)
   END_HANDLE_TH_ERRORS
 }
 
+PyObject * THCPModule_recordMemoryTrace(PyObject *_unused, PyObject *args)
+{
+  HANDLE_TH_ERRORS
+  PyObject* enabled = nullptr;
+  Py_ssize_t max_entries = 0;
+  if (!PyArg_ParseTuple(args, "On", &enabled, &max_entries)) {
+    return nullptr;
+  }
+  THPUtils_assert(max_entries > 0, "max_entries must be positive");
+  c10::cuda::CUDACachingAllocator::recordTrace(PyObject_IsTrue(enabled), max_entries);
+  END_HANDLE_TH_ERRORS
+  Py_RETURN_NONE;
+}
+
+PyObject * THCPModule_saveMemoryTrace(PyObject *_unused, PyObject *arg)
+{
+  HANDLE_TH_ERRORS
+  THPUtils_assert(THPUtils_checkString(arg), "invalid argument to _save_memory_trace");
+  const std::string path = THPUtils_unpackString(arg);
+  std::ofstream out(path);
+  THPUtils_assert(out.good(), "cannot open %s", path.c_str());
+  c10::cuda::CUDACachingAllocator::writeTrace(out, c10::cuda::CUDACachingAllocator::getTrace());
+  END_HANDLE_TH_ERRORS
+  Py_RETURN_NONE;
+}
+
+PyObject * THCPModule_hostMemoryStats(PyObject *_unused, PyObject *noargs)
+{
+  HANDLE_TH_ERRORS
+  using c10::cuda::CUDACachingAllocator::Stat;
+
+  const auto statToDict = [](const Stat& stat) {
+    py::dict dict;
+
+    dict["current"] = stat.current;
+    dict["peak"] = stat.peak;
+    dict["allocated"] = stat.allocated;
+    dict["freed"] = stat.freed;
+    return dict;
+  };
+
+  const THCCachingHostAllocatorStats stats = THCCachingHostAllocator_getStats();
+
+  py::dict result;
+  result["num_trimmed_blocks"] = stats.num_trimmed_blocks;
+  result["allocation"] = statToDict(stats.allocation);
+  result["segment"] = statToDict(stats.segment);
+  result["allocated_bytes"] = statToDict(stats.allocated_bytes);
+  result["reserved_bytes"] = statToDict(stats.reserved_bytes);
+
+  return result.release().ptr();
+  END_HANDLE_TH_ERRORS
+}
+
+PyObject * THCPModule_resetPeakHostMemoryStats(PyObject *_unused, PyObject *noargs)
+{
+  HANDLE_TH_ERRORS
+  THCCachingHostAllocator_resetPeakStats();
+  END_HANDLE_TH_ERRORS
+  Py_RETURN_NONE;
+}
+
+PyObject * THCPModule_setHostMemoryMaxCachedBytes(PyObject *_unused, PyObject *arg)
+{
+  HANDLE_TH_ERRORS
+  THPUtils_assert(THPUtils_checkLong(arg), "invalid argument to _set_host_memory_max_cached_bytes");
+  const int64_t max_cached_bytes = THPUtils_unpackLong(arg);
+  THPUtils_assert(max_cached_bytes >= 0, "max_cached_bytes must be non-negative");
+  THCCachingHostAllocator_setMaxCachedBytes(max_cached_bytes);
+  END_HANDLE_TH_ERRORS
+  Py_RETURN_NONE;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // Cuda module initialization
 ////////////////////////////////////////////////////////////////////////////////
@@ -486,6 +571,11 @@ static struct PyMethodDef _THCPModule_methods[] = {
   {"_cuda_resetAccumulatedMemoryStats", (PyCFunction) THCPModule_resetAccumulatedMemoryStats, METH_O, nullptr},
   {"_cuda_resetPeakMemoryStats", (PyCFunction) THCPModule_resetPeakMemoryStats, METH_O,  nullptr},
   {"_cuda_memorySnapshot", (PyCFunction) THCPModule_memorySnapshot, METH_NOARGS, nullptr},
+  {"_cuda_recordMemoryTrace", (PyCFunction) THCPModule_recordMemoryTrace, METH_VARARGS, nullptr},
+  {"_cuda_saveMemoryTrace", (PyCFunction) THCPModule_saveMemoryTrace, METH_O, nullptr},
+  {"_cuda_hostMemoryStats", (PyCFunction) THCPModule_hostMemoryStats, METH_NOARGS, nullptr},
+  {"_cuda_resetPeakHostMemoryStats", (PyCFunction) THCPModule_resetPeakHostMemoryStats, METH_NOARGS, nullptr},
+  {"_cuda_setHostMemoryMaxCachedBytes", (PyCFunction) THCPModule_setHostMemoryMaxCachedBytes, METH_O, nullptr},
   {"_cuda_cudaHostAllocator", (PyCFunction)THCPModule_cudaHostAllocator, METH_NOARGS, nullptr},
   {"_cuda_synchronize", (PyCFunction)THCPModule_cudaSynchronize, METH_NOARGS, nullptr},
   {"_cuda_ipc_collect", (PyCFunction)THCPModule_cudaIPCCollect, METH_NOARGS, nullptr},
@@ -511,8 +601,35 @@ PyMethodDef* THCPModule_methods() {
 
 namespace torch { namespace cuda {
 
+static void bindCUDAGraph(PyObject* module) {
+  auto m = py::handle(module).cast<py::module>();
+  py::class_<at::cuda::CUDAGraph>(m, "_CUDAGraph")
+    .def(py::init<>())
+    .def("capture_begin", &at::cuda::CUDAGraph::capture_begin,
+         py::call_guard<py::gil_scoped_release>())
+    .def("capture_end", &at::cuda::CUDAGraph::capture_end,
+         py::call_guard<py::gil_scoped_release>())
+    .def("replay", &at::cuda::CUDAGraph::replay,
+         py::call_guard<py::gil_scoped_release>())
+    .def("reset", &at::cuda::CUDAGraph::reset,
+         py::call_guard<py::gil_scoped_release>())
+    .def("pool", &at::cuda::CUDAGraph::pool);
+}
+
+static void bindHostCopyFuture(PyObject* module) {
+  auto m = py::handle(module).cast<py::module>();
+  py::class_<at::cuda::HostCopyFuture>(m, "_CudaHostCopyFuture")
+    .def("done", &at::cuda::HostCopyFuture::done)
+    .def("wait", &at::cuda::HostCopyFuture::wait,
+         py::call_guard<py::gil_scoped_release>());
+  m.def("_cuda_copy_to_host_async", &at::cuda::copy_to_host_async,
+        py::call_guard<py::gil_scoped_release>());
+}
+
 void initModule(PyObject *module) {
   python::initCommMethods(module);
+  bindCUDAGraph(module);
+  bindHostCopyFuture(module);
 }
 
 }}
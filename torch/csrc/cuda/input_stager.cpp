@@ -0,0 +1,128 @@
+#include <torch/csrc/cuda/input_stager.h>
+
+#include <ATen/cuda/CUDAContext.h>
+#include <THC/THCCachingHostAllocator.h>
+#include <c10/cuda/CUDACachingAllocator.h>
+#include <c10/cuda/CUDAGuard.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+namespace torch { namespace cuda {
+using namespace at;
+
+namespace {
+
+// The offsets of the tensors in a pinned buffer are aligned like the
+// blocks of the caching allocators
+constexpr int64_t kAlignment = 512;
+
+int64_t alignUp(int64_t nbytes) {
+  return (nbytes + kAlignment - 1) / kAlignment * kAlignment;
+}
+
+bool needsStaging(const Tensor& tensor) {
+  return tensor.defined() && tensor.device().is_cpu();
+}
+
+template <typename F>
+void forEachStagedTensor(std::vector<IValue>& inputs, const F& f) {
+  for (auto& input : inputs) {
+    if (input.isTensor()) {
+      auto tensor = input.toTensor();
+      if (needsStaging(tensor)) {
+        input = f(tensor);
+      }
+    } else if (input.isTensorList()) {
+      bool any = false;
+      for (const Tensor& tensor : input.toTensorListRef()) {
+        any = any || needsStaging(tensor);
+      }
+      if (!any) {
+        continue;
+      }
+      std::vector<Tensor> tensors = input.toTensorListRef().vec();
+      for (auto& tensor : tensors) {
+        if (needsStaging(tensor)) {
+          tensor = f(tensor);
+        }
+      }
+      input = std::move(tensors);
+    }
+  }
+}
+
+} // namespace
+
+InputStager::InputStager(InputStagerOptions options)
+    : options_(options),
+      stream_(at::cuda::getStreamFromPool(/*isHighPriority=*/false, options.device)) {
+  TORCH_CHECK(
+      options_.num_buffers >= 1,
+      "InputStager: expected num_buffers >= 1, but got ",
+      options_.num_buffers);
+  buffers_.reserve(options_.num_buffers);
+  for (int i = 0; i < options_.num_buffers; ++i) {
+    buffers_.push_back(std::make_unique<Buffer>());
+  }
+}
+
+std::vector<IValue> InputStager::stage(std::vector<IValue> inputs) {
+  int64_t num_tensors = 0;
+  int64_t nbytes = 0;
+  forEachStagedTensor(inputs, [&](const Tensor& tensor) {
+    ++num_tensors;
+    nbytes += alignUp(tensor.numel() * tensor.element_size());
+    return tensor;
+  });
+  if (num_tensors == 0) {
+    return inputs;
+  }
+  // Empty tensors take no space, but the buffer is still recorded below
+  nbytes = std::max<int64_t>(nbytes, 1);
+
+  Buffer& buffer = *buffers_[next_buffer_++ % buffers_.size()];
+  std::lock_guard<std::mutex> guard(buffer.mutex);
+  // The copies of the previous call using the buffer read from it
+  buffer.copied.synchronize();
+  if (!buffer.pinned.defined() || buffer.pinned.numel() < nbytes) {
+    // The old buffer goes back to the caching host allocator, which doesn't
+    // reuse it before the copies it recorded are done
+    buffer.pinned = at::empty({nbytes}, TensorOptions(kByte).pinned_memory(true));
+  }
+
+  const auto consumer = at::cuda::getCurrentCUDAStream(options_.device);
+  const c10::cuda::CUDAStreamGuard stream_guard(stream_);
+  uint8_t* base = buffer.pinned.data_ptr<uint8_t>();
+  int64_t offset = 0;
+  std::vector<Tensor> staged;
+  forEachStagedTensor(inputs, [&](const Tensor& tensor) {
+    const auto options = TensorOptions(tensor.scalar_type());
+    if (tensor.numel() == 0) {
+      return at::empty(tensor.sizes(), options.device(kCUDA, options_.device));
+    }
+    Tensor pinned = at::from_blob(base + offset, tensor.sizes(), options);
+    offset += alignUp(tensor.numel() * tensor.element_size());
+    pinned.copy_(tensor);
+    Tensor device_tensor = pinned.to(
+        options.device(kCUDA, options_.device), /*non_blocking=*/true);
+    staged.push_back(device_tensor);
+    return device_tensor;
+  });
+  // The copies above record their events on the views into the buffer,
+  // which the host allocator ignores but for the first one, so the buffer
+  // itself is recorded
+  AT_CUDA_CHECK(THCCachingHostAllocator_recordEvent(base, stream_));
+  buffer.copied.record(stream_);
+
+  // The inputs are used on the stream of the caller, once they are copied
+  buffer.copied.block(consumer);
+  for (const auto& tensor : staged) {
+    c10::cuda::CUDACachingAllocator::recordStream(
+        tensor.storage().data(), consumer);
+  }
+  return inputs;
+}
+
+}} // namespace torch::cuda
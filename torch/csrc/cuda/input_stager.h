@@ -0,0 +1,77 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <ATen/core/ivalue.h>
+#include <ATen/cuda/ATenCUDAGeneral.h>
+#include <ATen/cuda/CUDAContext.h>
+#include <ATen/cuda/CUDAEvent.h>
+#include <torch/csrc/WindowsTorchApiMacro.h>
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace torch { namespace cuda {
+
+struct InputStagerOptions {
+  // The GPU the inputs are copied to
+  c10::DeviceIndex device{0};
+  // The number of pinned buffers in the ring, i.e. of calls to stage() whose
+  // copies can be in flight at once. A call waits for the copies out of the
+  // buffer it takes to finish, so there should be at least as many as the
+  // threads staging inputs, e.g. the workers of a BatchingExecutor.
+  int num_buffers{2};
+};
+
+// Copies the inputs of a module from (pageable) CPU memory to a GPU without
+// blocking the calling thread on the transfers, for serving requests while
+// the model runs on the previous ones.
+//
+// stage() copies the CPU tensors of the inputs, at the top level or in
+// tensor lists, into the next pinned buffer of a ring, from the caching host
+// allocator, and issues async copies to the GPU on a stream of the stager.
+// The current stream of the calling thread on that GPU waits on an event
+// recorded after the copies, so the inputs returned are resident for the
+// ops the caller then runs on it, e.g. a module. Other inputs are returned
+// unchanged.
+//
+//   InputStager stager;
+//   auto output = module.forward(stager.stage({request_tensor}));
+//
+// With a BatchingExecutor, it stages the inputs of each batch:
+//
+//   auto stager = std::make_shared<InputStager>();
+//   BatchingExecutorOptions options;
+//   options.num_workers = 2;
+//   options.prepare_inputs = [stager](std::vector<IValue> inputs) {
+//     return stager->stage(std::move(inputs));
+//   };
+//
+// so that a worker copies a batch while the other runs the previous one.
+// stage() can be called from any number of threads.
+class TORCH_CUDA_API InputStager {
+ public:
+  explicit InputStager(InputStagerOptions options = InputStagerOptions());
+
+  InputStager(const InputStager&) = delete;
+  InputStager& operator=(const InputStager&) = delete;
+
+  std::vector<c10::IValue> stage(std::vector<c10::IValue> inputs);
+
+ private:
+  struct Buffer {
+    std::mutex mutex;
+    // Byte tensor of pinned memory, grown to the largest inputs staged
+    at::Tensor pinned;
+    // Recorded after the last copies out of pinned
+    at::cuda::CUDAEvent copied;
+  };
+
+  const InputStagerOptions options_;
+  at::cuda::CUDAStream stream_;
+  std::vector<std::unique_ptr<Buffer>> buffers_;
+  std::atomic<size_t> next_buffer_{0};
+};
+
+}} // namespace torch::cuda
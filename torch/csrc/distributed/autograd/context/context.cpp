@@ -63,19 +63,64 @@ DistAutogradContext::recvFunctions() const {
 
 void DistAutogradContext::accumulateGrad(
     const torch::autograd::Variable& variable,
-    const torch::Tensor& grad) {
+    torch::Tensor grad) {
   TORCH_INTERNAL_ASSERT(grad.defined());
   TORCH_INTERNAL_ASSERT(variable.requires_grad());
 
   std::lock_guard<std::mutex> guard(lock_);
   auto it = accumulatedGrads_.find(variable);
-  if (it != accumulatedGrads_.end()) {
-    // Accumulate multiple grads on the same variable.
-    it->value().add_(grad);
+  if (it == accumulatedGrads_.end()) {
+    // First grad for this variable. Steal it if this is the last reference,
+    // since later grads are accumulated into it in place.
+    accumulatedGrads_.insert(
+        variable, grad.use_count() == 1 ? std::move(grad) : grad.clone());
+    return;
+  }
+
+  // Accumulate multiple grads on the same variable.
+  auto accumulated = it->value();
+  if (accumulated.is_sparse() && !grad.is_sparse()) {
+    // A dense grad can't be added to a sparse one in place, but a sparse one
+    // can be added to a dense one.
+    if (grad.use_count() == 1) {
+      grad.add_(accumulated);
+      it->setValue(std::move(grad));
+    } else {
+      it->setValue(grad + accumulated);
+    }
   } else {
-    // First grad for this variable.
-    accumulatedGrads_.insert(variable, grad);
+    accumulated.add_(grad);
+  }
+}
+
+void DistAutogradContext::releaseAutogradFunctions() {
+  // Destroy the functions outside the lock, since the 'recv' functions hold a
+  // reference to this context.
+  std::unique_lock<std::mutex> lock(lock_);
+  auto sendFunctions = std::move(sendAutogradFunctions_);
+  auto recvFunctions = std::move(recvAutogradFunctions_);
+  sendAutogradFunctions_.clear();
+  recvAutogradFunctions_.clear();
+  lock.unlock();
+}
+
+DistAutogradContextStats DistAutogradContext::stats() const {
+  std::lock_guard<std::mutex> guard(lock_);
+  DistAutogradContextStats stats;
+  stats.numSendFunctions = sendAutogradFunctions_.size();
+  stats.numRecvFunctions = recvAutogradFunctions_.size();
+  stats.numOutstandingRpcs = outStandingRpcs_.size();
+  stats.numGradients = accumulatedGrads_.size();
+  stats.gradientBytes = 0;
+  for (const auto& entry : accumulatedGrads_) {
+    const auto& grad = entry.value();
+    if (grad.is_sparse()) {
+      stats.gradientBytes += grad._indices().nbytes() + grad._values().nbytes();
+    } else {
+      stats.gradientBytes += grad.nbytes();
+    }
   }
+  return stats;
 }
 
 std::shared_ptr<torch::autograd::GraphTask> DistAutogradContext::
@@ -14,6 +14,17 @@ namespace autograd {
 
 class RecvRpcBackward;
 
+// What a DistAutogradContext holds on to, see DistAutogradContext::stats().
+struct DistAutogradContextStats {
+  size_t numSendFunctions;
+  size_t numRecvFunctions;
+  size_t numOutstandingRpcs;
+  size_t numGradients;
+  // Bytes of the accumulated gradients, counting the indices and values of
+  // sparse gradients.
+  size_t gradientBytes;
+};
+
 // DistAutogradContext which stores information for a single distributed
 // autograd pass on a worker.
 class TORCH_API DistAutogradContext {
@@ -68,14 +79,23 @@ class TORCH_API DistAutogradContext {
   // These are the different workers that this context has sent RPCs to.
   std::unordered_set<rpc::worker_id_t> getKnownWorkerIds() const;
 
+  // Returns the number of autograd functions, rpcs and gradients held by this
+  // context, and the memory used by the gradients.
+  DistAutogradContextStats stats() const;
+
  private:
   friend class DistEngine;
 
   // Record that we would like to accumulate the provided gradient on the given
-  // variable.
+  // variable. The gradient is accumulated in place, so the first one is only
+  // stored as is if nothing else refers to it, otherwise it's cloned.
   void accumulateGrad(
       const torch::autograd::Variable& variable,
-      const torch::Tensor& grad);
+      torch::Tensor grad);
+
+  // Releases the 'send' and 'recv' functions once the backward pass on this
+  // node is done, together with the autograd graph they keep alive.
+  void releaseAutogradFunctions();
 
   // Retrieve the GraphTask.
   std::shared_ptr<torch::autograd::GraphTask> retrieveGraphTask();
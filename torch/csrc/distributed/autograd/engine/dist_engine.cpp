@@ -1,9 +1,11 @@
 #include <queue>
 
+#include <ATen/Parallel.h>
 #include <torch/csrc/autograd/functions/accumulate_grad.h>
 #include <torch/csrc/autograd/input_buffer.h>
 #include <torch/csrc/distributed/autograd/context/container.h>
 #include <torch/csrc/distributed/autograd/engine/dist_engine.h>
+#include <torch/csrc/distributed/autograd/rpc_messages/propagate_gradients_resp.h>
 
 namespace torch {
 namespace distributed {
@@ -177,10 +179,15 @@ void DistEngine::runEngineAndAccumulateGradients(
     const edge_list& outputEdges) {
   // Kick off autograd computation with the root node and retrieve all the
   // gradients.
-  // TODO: make this non-blocking
-  // (https://github.com/pytorch/pytorch/issues/26359)
-  variable_list grads = engine_.execute_with_graph_task(
-      autogradContext->retrieveGraphTask(), graphRoot);
+  // This blocks, so executeSendFunctionAsync runs it off the rpc thread.
+  auto graphTask = autogradContext->retrieveGraphTask();
+  variable_list grads = engine_.execute_with_graph_task(graphTask, graphRoot);
+  {
+    // Drop the references of the GraphTask to the grads, so that the context
+    // can accumulate into them without copying.
+    std::lock_guard<std::mutex> guard(graphTask->mutex_);
+    graphTask->captured_vars_.clear();
+  }
 
   // Accumulate all the gradients in the context.
   TORCH_INTERNAL_ASSERT(grads.size() == outputEdges.size());
@@ -194,14 +201,15 @@ void DistEngine::runEngineAndAccumulateGradients(
       auto& variable =
           std::static_pointer_cast<AccumulateGrad>(outputEdges[i].function)
               ->variable;
-      autogradContext->accumulateGrad(variable, grads[i]);
+      autogradContext->accumulateGrad(variable, std::move(grads[i]));
     }
   }
 }
 
-void DistEngine::executeSendFunction(
+std::shared_ptr<rpc::FutureMessage> DistEngine::executeSendFunctionAsync(
     const ContextPtr& autogradContext,
     const std::shared_ptr<Node>& sendFunction) {
+  auto future = std::make_shared<rpc::FutureMessage>();
   std::unique_lock<std::mutex> lock(initializedContextIdsLock_);
   if (initializedContextIds_.find(autogradContext->contextId()) ==
       initializedContextIds_.end()) {
@@ -213,24 +221,40 @@ void DistEngine::executeSendFunction(
     // Mark the autograd context id as initialized and unlock.
     initializedContextIds_.insert(autogradContext->contextId());
     lock.unlock();
-    ClearContextIdGuard guard(autogradContext->contextId());
 
     // Enqueue the current send function.
     auto graphTask = autogradContext->retrieveGraphTask();
     engine_.enqueue_blocked_task_on_cpu(torch::autograd::NodeTask(
         graphTask, sendFunction, torch::autograd::InputBuffer(0)));
 
-    // Run the autograd engine.
-    runEngineAndAccumulateGradients(autogradContext, dummyRoot, outputEdges);
+    // Wait for the backward pass on another thread, so that the rpc thread is
+    // free to receive the gradients of the other send functions meanwhile.
+    at::launch([this, autogradContext, dummyRoot, outputEdges, future]() {
+      try {
+        {
+          ClearContextIdGuard guard(autogradContext->contextId());
+
+          // Run the autograd engine.
+          runEngineAndAccumulateGradients(
+              autogradContext, dummyRoot, outputEdges);
 
-    // Wait for all of the outstanding rpcs to complete.
-    autogradContext->clearAndWaitForOutstandingRpcs();
+          // Wait for all of the outstanding rpcs to complete.
+          autogradContext->clearAndWaitForOutstandingRpcs();
+          autogradContext->releaseAutogradFunctions();
+        }
+        future->markCompleted(std::move(PropagateGradientsResp()).toMessage());
+      } catch (const std::exception& e) {
+        future->markCompleted(rpc::createExceptionResponse(rpc::Message(), e));
+      }
+    });
   } else {
     lock.unlock();
     auto graphTask = autogradContext->retrieveGraphTask();
     engine_.enqueue_blocked_task_on_cpu(torch::autograd::NodeTask(
         graphTask, sendFunction, torch::autograd::InputBuffer(0)));
+    future->markCompleted(std::move(PropagateGradientsResp()).toMessage());
   }
+  return future;
 }
 
 void DistEngine::execute(const variable_list& roots) {
@@ -268,6 +292,7 @@ void DistEngine::execute(const variable_list& roots) {
 
   // Wait for all of the outstanding rpcs to complete.
   autogradContext->clearAndWaitForOutstandingRpcs();
+  autogradContext->releaseAutogradFunctions();
 }
 
 void DistEngine::clearInitializedContextId(int64_t contextId) {
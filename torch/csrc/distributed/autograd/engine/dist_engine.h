@@ -7,6 +7,7 @@
 #include <torch/csrc/autograd/function.h>
 #include <torch/csrc/autograd/functions/basic_ops.h>
 #include <torch/csrc/distributed/autograd/context/context.h>
+#include <torch/csrc/distributed/rpc/future_message.h>
 
 namespace torch {
 namespace distributed {
@@ -41,7 +42,12 @@ class TORCH_API DistEngine {
   // This method is used to kick off the autograd computation on a node when it
   // receives gradients from the corresponding 'recv' method on another node.
   // The gradients are accumulated in the provided autograd context.
-  void executeSendFunction(
+  // It doesn't block: the first send function of a context starts the local
+  // backward pass on another thread, and the returned future holds the
+  // response to send, once the backward pass and the rpcs it sent are done.
+  // The send functions that arrive in the meantime are run by the engine as
+  // soon as they are enqueued, and their futures are already completed.
+  std::shared_ptr<rpc::FutureMessage> executeSendFunctionAsync(
       const ContextPtr& autogradContext,
       const std::shared_ptr<torch::autograd::Node>& sendFunction);
 
@@ -57,12 +57,24 @@ PyObject* dist_autograd_init(PyObject* /* unused */) {
                 }
                 return funcs;
               })
-          .def("_known_worker_ids", [](const ContextPtr& ctx) {
-            std::vector<rpc::worker_id_t> worker_ids;
-            for (const auto worker_id : ctx->getKnownWorkerIds()) {
-              worker_ids.push_back(worker_id);
-            }
-            return worker_ids;
+          .def(
+              "_known_worker_ids",
+              [](const ContextPtr& ctx) {
+                std::vector<rpc::worker_id_t> worker_ids;
+                for (const auto worker_id : ctx->getKnownWorkerIds()) {
+                  worker_ids.push_back(worker_id);
+                }
+                return worker_ids;
+              })
+          .def("_stats", [](const ContextPtr& ctx) {
+            auto stats = ctx->stats();
+            std::map<std::string, size_t> result;
+            result["num_send_functions"] = stats.numSendFunctions;
+            result["num_recv_functions"] = stats.numRecvFunctions;
+            result["num_outstanding_rpcs"] = stats.numOutstandingRpcs;
+            result["num_gradients"] = stats.numGradients;
+            result["gradient_bytes"] = stats.gradientBytes;
+            return result;
           });
 
   module.def(
@@ -11,6 +11,7 @@ namespace c10d {
 void broadcast_coalesced(
     std::shared_ptr<c10d::ProcessGroup> process_group,
     at::TensorList tensors,
-    size_t buffer_size);
+    size_t buffer_size,
+    int root_rank = 0);
 
 } // namespace c10d
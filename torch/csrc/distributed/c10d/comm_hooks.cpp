@@ -0,0 +1,222 @@
+#include <torch/csrc/distributed/c10d/comm_hooks.h>
+
+#include <algorithm>
+#include <cmath>
+
+#include <ATen/CPUGenerator.h>
+#include <c10/util/Exception.h>
+
+namespace c10d {
+namespace {
+
+// Gram-Schmidt orthonormalization of the columns of a [n, r] matrix, in place.
+void orthogonalize(at::Tensor& matrix) {
+  const auto num_cols = matrix.size(1);
+  for (int64_t i = 0; i < num_cols; i++) {
+    auto col = matrix.narrow(1, i, 1);
+    // The epsilon keeps the columns of rank deficient matrices finite
+    col.div_(col.norm().add_(1e-8));
+    if (i + 1 < num_cols) {
+      auto rest = matrix.narrow(1, i + 1, num_cols - i - 1);
+      rest.sub_(col.mm(col.t().mm(rest)));
+    }
+  }
+}
+
+} // namespace
+
+HookWork::HookWork(
+    std::vector<std::shared_ptr<ProcessGroup::Work>> works,
+    std::function<std::vector<at::Tensor>()> then)
+    : works_(std::move(works)), then_(std::move(then)) {}
+
+bool HookWork::wait() {
+  if (!isCompleted()) {
+    std::exception_ptr exception;
+    try {
+      for (auto& work : works_) {
+        work->wait();
+      }
+      result_ = then_();
+    } catch (...) {
+      exception = std::current_exception();
+    }
+    finish(exception);
+  }
+  return ProcessGroup::Work::wait();
+}
+
+std::vector<at::Tensor> HookWork::result() const {
+  return result_;
+}
+
+AllreduceHook::AllreduceHook(std::shared_ptr<ProcessGroup> process_group)
+    : process_group_(std::move(process_group)) {}
+
+std::shared_ptr<ProcessGroup::Work> AllreduceHook::runHook(
+    size_t /* unused */,
+    std::vector<at::Tensor>& tensors) {
+  auto work = process_group_->allreduce(tensors);
+  return std::make_shared<HookWork>(
+      std::vector<std::shared_ptr<ProcessGroup::Work>>{work},
+      [tensors] { return tensors; });
+}
+
+FP16CompressHook::FP16CompressHook(
+    std::shared_ptr<ProcessGroup> process_group)
+    : process_group_(std::move(process_group)) {}
+
+std::shared_ptr<ProcessGroup::Work> FP16CompressHook::runHook(
+    size_t /* unused */,
+    std::vector<at::Tensor>& tensors) {
+  std::vector<at::Tensor> compressed;
+  compressed.reserve(tensors.size());
+  for (const auto& tensor : tensors) {
+    compressed.push_back(tensor.to(at::kHalf));
+  }
+  auto work = process_group_->allreduce(compressed);
+  return std::make_shared<HookWork>(
+      std::vector<std::shared_ptr<ProcessGroup::Work>>{work},
+      [tensors, compressed] {
+        for (size_t i = 0; i < tensors.size(); i++) {
+          tensors[i].copy_(compressed[i]);
+        }
+        return tensors;
+      });
+}
+
+PowerSGDHook::PowerSGDHook(
+    std::shared_ptr<ProcessGroup> process_group,
+    int64_t matrix_approximation_rank,
+    uint64_t seed)
+    : process_group_(std::move(process_group)),
+      matrix_approximation_rank_(matrix_approximation_rank),
+      seed_(seed) {
+  TORCH_CHECK(
+      matrix_approximation_rank_ > 0,
+      "PowerSGDHook: Expected a positive matrix approximation rank, but got ",
+      matrix_approximation_rank_);
+}
+
+std::shared_ptr<ProcessGroup::Work> PowerSGDHook::runHook(
+    size_t bucket_index,
+    std::vector<at::Tensor>& tensors) {
+  auto& states = states_[bucket_index];
+  if (states.size() != tensors.size()) {
+    states.clear();
+    states.resize(tensors.size());
+  }
+
+  std::vector<at::Tensor> matrices;
+  std::vector<at::Tensor> ps;
+  for (size_t i = 0; i < tensors.size(); i++) {
+    const auto& tensor = tensors[i];
+    const auto numel = tensor.numel();
+    const auto cols = static_cast<int64_t>(
+        std::ceil(std::sqrt(static_cast<double>(numel))));
+    const auto rows = (numel + cols - 1) / cols;
+    auto& state = states[i];
+    // The buckets are reinitialized if their assignment changes
+    if (!state.error.defined() || state.error.numel() != numel) {
+      state.error = at::zeros_like(tensor);
+      // Every process starts from the same Q, from the same seed
+      auto generator = at::detail::createCPUGenerator(seed_ + bucket_index);
+      const auto rank =
+          std::min(matrix_approximation_rank_, std::min(rows, cols));
+      state.q = at::randn({cols, rank}, generator.get(), at::kFloat)
+                    .to(tensor.options());
+    }
+    auto matrix = at::zeros({rows * cols}, tensor.options());
+    matrix.narrow(0, 0, numel).copy_(tensor).add_(state.error);
+    matrix = matrix.view({rows, cols});
+    ps.push_back(matrix.mm(state.q));
+    matrices.push_back(std::move(matrix));
+  }
+  auto work = process_group_->allreduce(ps);
+
+  return std::make_shared<HookWork>(
+      std::vector<std::shared_ptr<ProcessGroup::Work>>{work},
+      [this, tensors, matrices, ps, &states]() mutable {
+        std::vector<at::Tensor> qs;
+        for (size_t i = 0; i < tensors.size(); i++) {
+          orthogonalize(ps[i]);
+          qs.push_back(matrices[i].t().mm(ps[i]));
+        }
+        process_group_->allreduce(qs)->wait();
+        for (size_t i = 0; i < tensors.size(); i++) {
+          const auto numel = tensors[i].numel();
+          auto approximation =
+              ps[i].mm(qs[i].t()).view({-1}).narrow(0, 0, numel);
+          states[i].error =
+              matrices[i].view({-1}).narrow(0, 0, numel) - approximation;
+          states[i].q = qs[i];
+          tensors[i].copy_(approximation);
+        }
+        return tensors;
+      });
+}
+
+TopKHook::TopKHook(std::shared_ptr<ProcessGroup> process_group, double ratio)
+    : process_group_(std::move(process_group)), ratio_(ratio) {
+  TORCH_CHECK(
+      ratio_ > 0 && ratio_ <= 1,
+      "TopKHook: Expected a ratio in (0, 1], but got ",
+      ratio_);
+}
+
+std::shared_ptr<ProcessGroup::Work> TopKHook::runHook(
+    size_t bucket_index,
+    std::vector<at::Tensor>& tensors) {
+  auto& errors = errors_[bucket_index];
+  if (errors.size() != tensors.size()) {
+    errors.clear();
+    errors.resize(tensors.size());
+  }
+
+  // Every process gathers the elements of every model replica of every
+  // process, for each of its model replicas.
+  const auto gathered_count = process_group_->getSize() * tensors.size();
+  std::vector<at::Tensor> values;
+  std::vector<at::Tensor> indices;
+  std::vector<std::vector<at::Tensor>> gathered_values(tensors.size());
+  std::vector<std::vector<at::Tensor>> gathered_indices(tensors.size());
+  for (size_t i = 0; i < tensors.size(); i++) {
+    const auto& tensor = tensors[i];
+    const auto numel = tensor.numel();
+    if (!errors[i].defined() || errors[i].numel() != numel) {
+      errors[i] = at::zeros_like(tensor);
+    }
+    auto compensated = tensor + errors[i];
+    const auto k = std::min(
+        numel,
+        std::max(
+            static_cast<int64_t>(1),
+            static_cast<int64_t>(static_cast<double>(numel) * ratio_)));
+    auto top_indices = std::get<1>(compensated.abs().topk(k));
+    values.push_back(compensated.index_select(0, top_indices));
+    errors[i] = compensated.index_fill_(0, top_indices, 0);
+    indices.push_back(std::move(top_indices));
+    for (size_t j = 0; j < gathered_count; j++) {
+      gathered_values[i].push_back(at::empty_like(values[i]));
+      gathered_indices[i].push_back(at::empty_like(indices[i]));
+    }
+  }
+  auto values_work = process_group_->allgather(gathered_values, values);
+  auto indices_work = process_group_->allgather(gathered_indices, indices);
+
+  return std::make_shared<HookWork>(
+      std::vector<std::shared_ptr<ProcessGroup::Work>>{values_work,
+                                                       indices_work},
+      [tensors, gathered_values, gathered_indices] {
+        for (size_t i = 0; i < tensors.size(); i++) {
+          tensors[i].zero_();
+          for (size_t j = 0; j < gathered_values[i].size(); j++) {
+            tensors[i].index_add_(
+                0, gathered_indices[i][j], gathered_values[i][j]);
+          }
+        }
+        return tensors;
+      });
+}
+
+} // namespace c10d
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include <ATen/ATen.h>
+#include <c10d/ProcessGroup.hpp>
+
+namespace c10d {
+
+// A communication hook replaces the allreduce of the dense buckets by the
+// Reducer. It's called as soon as a bucket is ready in the backward pass, with
+// the flattened contents of the bucket for every model replica, already
+// divided by the world size, and returns the pending reduction as a Work.
+// The Reducer waits on it at the end of the backward pass, after which its
+// `result` is the reduced contents for every model replica.
+//
+// Hooks with more than one round of communication kick off the first one in
+// `runHook`, to overlap it with the rest of the backward pass like the
+// allreduce does, and run the others on `wait` (see HookWork).
+class CommHookInterface {
+ public:
+  virtual ~CommHookInterface() = default;
+
+  virtual std::shared_ptr<ProcessGroup::Work> runHook(
+      size_t bucket_index,
+      std::vector<at::Tensor>& tensors) = 0;
+
+  // Called with the bucket assignment of the Reducer, as indices into the
+  // variables of the first model replica, when the hook is registered and
+  // every time the buckets are (re-)initialized after that.
+  virtual void onBucketsInitialized(
+      const std::vector<std::vector<size_t>>& /* unused */) {}
+};
+
+// The Work of a hook. Waiting on it waits on the communication kicked off by
+// the hook, then runs the continuation computing its result.
+class HookWork : public ProcessGroup::Work {
+ public:
+  HookWork(
+      std::vector<std::shared_ptr<ProcessGroup::Work>> works,
+      std::function<std::vector<at::Tensor>()> then);
+
+  bool wait() override;
+
+  std::vector<at::Tensor> result() const override;
+
+ protected:
+  std::vector<std::shared_ptr<ProcessGroup::Work>> works_;
+  std::function<std::vector<at::Tensor>()> then_;
+  std::vector<at::Tensor> result_;
+};
+
+// Allreduces the bucket contents, like the Reducer does without a hook.
+class AllreduceHook : public CommHookInterface {
+ public:
+  explicit AllreduceHook(std::shared_ptr<ProcessGroup> process_group);
+
+  std::shared_ptr<ProcessGroup::Work> runHook(
+      size_t bucket_index,
+      std::vector<at::Tensor>& tensors) override;
+
+ protected:
+  std::shared_ptr<ProcessGroup> process_group_;
+};
+
+// Allreduces the bucket contents cast to half precision, which halves the
+// bytes on the wire for float buckets.
+class FP16CompressHook : public CommHookInterface {
+ public:
+  explicit FP16CompressHook(std::shared_ptr<ProcessGroup> process_group);
+
+  std::shared_ptr<ProcessGroup::Work> runHook(
+      size_t bucket_index,
+      std::vector<at::Tensor>& tensors) override;
+
+ protected:
+  std::shared_ptr<ProcessGroup> process_group_;
+};
+
+// PowerSGD (Vogels et al., 2019). The contents of a bucket, plus the error
+// of their previous compression, are viewed as an [n, m] matrix M, padded
+// with zeros, and approximated by P Q^T, P [n, r] and Q [m, r], from a single
+// step of power iteration: P = M Q is allreduced and orthogonalized, then
+// Q = M^T P is allreduced. Q is kept for the next iteration, which starts from
+// it, and so is the local error M - P Q^T. This communicates (n + m) r
+// elements instead of n m.
+class PowerSGDHook : public CommHookInterface {
+ public:
+  PowerSGDHook(
+      std::shared_ptr<ProcessGroup> process_group,
+      int64_t matrix_approximation_rank = 1,
+      uint64_t seed = 0);
+
+  std::shared_ptr<ProcessGroup::Work> runHook(
+      size_t bucket_index,
+      std::vector<at::Tensor>& tensors) override;
+
+ protected:
+  struct State {
+    at::Tensor error;
+    at::Tensor q;
+  };
+
+  std::shared_ptr<ProcessGroup> process_group_;
+  const int64_t matrix_approximation_rank_;
+  const uint64_t seed_;
+  // The state of every bucket, for every model replica.
+  std::unordered_map<size_t, std::vector<State>> states_;
+};
+
+// Top-k sparsification. Only the `ratio` of the elements of the bucket
+// contents, plus the error of their previous compression, with the largest
+// magnitudes are allgathered, with their indices, and summed. The others are
+// kept as the error for the next iteration.
+class TopKHook : public CommHookInterface {
+ public:
+  TopKHook(std::shared_ptr<ProcessGroup> process_group, double ratio = 0.01);
+
+  std::shared_ptr<ProcessGroup::Work> runHook(
+      size_t bucket_index,
+      std::vector<at::Tensor>& tensors) override;
+
+ protected:
+  std::shared_ptr<ProcessGroup> process_group_;
+  const double ratio_;
+  // The error of every bucket, for every model replica.
+  std::unordered_map<size_t, std::vector<at::Tensor>> errors_;
+};
+
+} // namespace c10d
@@ -22,8 +22,10 @@
 
 #include <torch/csrc/Exceptions.h>
 #include <torch/csrc/distributed/c10d/comm.h>
+#include <torch/csrc/distributed/c10d/comm_hooks.h>
 #include <torch/csrc/distributed/c10d/ddp.h>
 #include <torch/csrc/distributed/c10d/reducer.h>
+#include <torch/csrc/distributed/c10d/sharded_optimizer.h>
 #include <torch/csrc/utils/object_ptr.h>
 #include <torch/csrc/utils/pybind.h>
 
@@ -35,6 +37,7 @@ namespace {
 
 #ifdef USE_C10D_GLOO
 constexpr char* GLOO_SOCKET_IFNAME_ENV = "GLOO_SOCKET_IFNAME";
+constexpr char* GLOO_LAZY_INIT_ENV = "GLOO_LAZY_INIT";
 #endif
 
 std::vector<std::string> split(char separator, const std::string& string) {
@@ -65,15 +68,23 @@ PyObject* c10d_init(PyObject* _unused) {
               std::vector<std::vector<torch::autograd::Variable>>,
               std::vector<std::vector<size_t>>,
               std::shared_ptr<::c10d::ProcessGroup>,
-              std::vector<std::vector<bool>>>(),
+              std::vector<std::vector<bool>>,
+              bool,
+              int64_t>(),
           py::arg("replicas"),
           py::arg("bucket_indices"),
           py::arg("process_group"),
-          py::arg("expect_sparse_gradients") = std::vector<std::vector<bool>>())
+          py::arg("expect_sparse_gradients") = std::vector<std::vector<bool>>(),
+          py::arg("gradient_as_bucket_view") = false,
+          py::arg("bucket_bytes_cap") = ::c10d::kDefaultBucketBytesCap)
       .def(
           "initialize_buckets",
           &::c10d::Reducer::initialize_buckets,
           py::call_guard<py::gil_scoped_release>())
+      .def(
+          "rebuild_buckets",
+          &::c10d::Reducer::rebuild_buckets,
+          py::call_guard<py::gil_scoped_release>())
       .def(
           "prepare_for_backward",
           &::c10d::Reducer::prepare_for_backward,
@@ -83,7 +94,76 @@ PyObject* c10d_init(PyObject* _unused) {
           [](::c10d::Reducer& reducer, const torch::autograd::Variable& output)
               -> void { reducer.prepare_for_backward({output}); },
           py::call_guard<py::gil_scoped_release>())
-      .def("get_backward_stats", &::c10d::Reducer::get_backward_stats);
+      .def(
+          "shadow_backward",
+          &::c10d::Reducer::shadow_backward,
+          py::call_guard<py::gil_scoped_release>())
+      .def(
+          "register_comm_hook",
+          &::c10d::Reducer::register_comm_hook,
+          py::arg("comm_hook"),
+          py::call_guard<py::gil_scoped_release>())
+      .def("get_backward_stats", &::c10d::Reducer::get_backward_stats)
+      .def(
+          "set_bucket_timing",
+          &::c10d::Reducer::set_bucket_timing,
+          py::arg("enabled"),
+          py::call_guard<py::gil_scoped_release>())
+      .def("get_bucket_stats", &::c10d::Reducer::get_bucket_stats);
+
+  py::class_<::c10d::BucketStats>(module, "BucketStats", R"(
+The times of the reduction of a gradient bucket in the last backward pass, in
+nanoseconds since the forward pass, -1 if it didn't happen.)")
+      .def_readonly("ready_ns", &::c10d::BucketStats::ready_ns)
+      .def_readonly("launch_ns", &::c10d::BucketStats::launch_ns)
+      .def_readonly("finish_ns", &::c10d::BucketStats::finish_ns);
+
+  auto commHook =
+      shared_ptr_class_<::c10d::CommHookInterface>(module, "CommHook", R"(
+A communication hook reducing the dense gradient buckets of a
+:class:`Reducer`, in place of the allreduce of their contents.)");
+
+  shared_ptr_class_<::c10d::AllreduceHook>(module, "AllreduceHook", commHook)
+      .def(
+          py::init<std::shared_ptr<::c10d::ProcessGroup>>(),
+          py::arg("process_group"));
+
+  shared_ptr_class_<::c10d::FP16CompressHook>(
+      module, "FP16CompressHook", commHook)
+      .def(
+          py::init<std::shared_ptr<::c10d::ProcessGroup>>(),
+          py::arg("process_group"));
+
+  shared_ptr_class_<::c10d::PowerSGDHook>(module, "PowerSGDHook", commHook)
+      .def(
+          py::init<std::shared_ptr<::c10d::ProcessGroup>, int64_t, uint64_t>(),
+          py::arg("process_group"),
+          py::arg("matrix_approximation_rank") = 1,
+          py::arg("seed") = 0);
+
+  shared_ptr_class_<::c10d::TopKHook>(module, "TopKHook", commHook)
+      .def(
+          py::init<std::shared_ptr<::c10d::ProcessGroup>, double>(),
+          py::arg("process_group"),
+          py::arg("ratio") = 0.01);
+
+  shared_ptr_class_<::c10d::ShardedOptimizerHook>(
+      module, "ShardedOptimizerHook", commHook, R"(
+Reduce-scatters the gradient buckets of a :class:`Reducer` so that every
+process only gets the reduced gradient of its shards, the chunks of the
+flattened buckets it owns. See :class:`torch.distributed.optim.ShardedOptimizer`.)")
+      .def(
+          py::init<
+              std::shared_ptr<::c10d::ProcessGroup>,
+              std::vector<torch::autograd::Variable>>(),
+          py::arg("process_group"),
+          py::arg("parameters"))
+      .def("shards", &::c10d::ShardedOptimizerHook::shards)
+      .def("layout_version", &::c10d::ShardedOptimizerHook::layout_version)
+      .def(
+          "allgather_parameters",
+          &::c10d::ShardedOptimizerHook::allgather_parameters,
+          py::call_guard<py::gil_scoped_release>());
 
   py::enum_<::c10d::ReduceOp>(module, "ReduceOp", R"(
 An enum-like class for available reduction operations: ``SUM``, ``PRODUCT``,
@@ -173,6 +253,55 @@ They are used in specifying strategies for reduction collectives, e.g.,
               "add",
               &::c10d::Store::add,
               py::call_guard<py::gil_scoped_release>())
+          .def(
+              "multi_set",
+              [](::c10d::Store& store,
+                 const std::vector<std::string>& keys,
+                 const std::vector<std::string>& values) {
+                std::vector<std::vector<uint8_t>> values_;
+                values_.reserve(values.size());
+                for (const auto& value : values) {
+                  values_.emplace_back(value.begin(), value.end());
+                }
+                store.multiSet(keys, values_);
+              },
+              py::call_guard<py::gil_scoped_release>())
+          // Returns a list of py::bytes, which needs the GIL.
+          .def(
+              "multi_get",
+              [](::c10d::Store& store, const std::vector<std::string>& keys) {
+                std::vector<std::vector<uint8_t>> values;
+                {
+                  py::gil_scoped_release release;
+                  values = store.multiGet(keys);
+                }
+                py::list result;
+                for (const auto& value : values) {
+                  result.append(py::bytes(
+                      reinterpret_cast<const char*>(value.data()),
+                      value.size()));
+                }
+                return result;
+              })
+          .def(
+              "compare_set",
+              [](::c10d::Store& store,
+                 const std::string& key,
+                 const std::string& expected_value,
+                 const std::string& desired_value) -> py::bytes {
+                std::vector<uint8_t> value;
+                {
+                  py::gil_scoped_release release;
+                  value = store.compareSet(
+                      key,
+                      std::vector<uint8_t>(
+                          expected_value.begin(), expected_value.end()),
+                      std::vector<uint8_t>(
+                          desired_value.begin(), desired_value.end()));
+                }
+                return py::bytes(
+                    reinterpret_cast<char*>(value.data()), value.size());
+              })
           .def(
               "set_timeout",
               &::c10d::Store::setTimeout,
@@ -435,7 +564,9 @@ They are used in specifying strategies for reduction collectives, e.g.,
       .def(py::init<>())
       .def_readwrite("devices", &::c10d::ProcessGroupGloo::Options::devices)
       .def_readwrite("timeout", &::c10d::ProcessGroupGloo::Options::timeout)
-      .def_readwrite("threads", &::c10d::ProcessGroupGloo::Options::threads);
+      .def_readwrite("threads", &::c10d::ProcessGroupGloo::Options::threads)
+      .def_readwrite(
+          "lazy_init", &::c10d::ProcessGroupGloo::Options::lazyInit);
 
   processGroupGloo.def_static(
       "create_device",
@@ -483,6 +614,9 @@ They are used in specifying strategies for reduction collectives, e.g.,
 
             options.timeout = timeout;
             options.threads = options.devices.size() * 2;
+            // Connect on the first operation if "GLOO_LAZY_INIT" is set.
+            char* lazyInitEnv = getenv(GLOO_LAZY_INIT_ENV);
+            options.lazyInit = lazyInitEnv && std::string(lazyInitEnv) == "1";
             return std::make_shared<::c10d::ProcessGroupGloo>(
                 store, rank, size, options);
           }),
@@ -597,12 +731,14 @@ They are used in specifying strategies for reduction collectives, e.g.,
       // function as a c10::ArrayRef.
       [](std::shared_ptr<::c10d::ProcessGroup> process_group,
          std::vector<at::Tensor> tensors,
-         size_t buffer_size) {
-        broadcast_coalesced(process_group, tensors, buffer_size);
+         size_t buffer_size,
+         int root_rank) {
+        broadcast_coalesced(process_group, tensors, buffer_size, root_rank);
       },
       py::arg("process_group"),
       py::arg("tensors"),
       py::arg("buffer_size"),
+      py::arg("root_rank") = 0,
       py::call_guard<py::gil_scoped_release>());
 
   Py_RETURN_TRUE;
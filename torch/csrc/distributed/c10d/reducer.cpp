@@ -1,9 +1,14 @@
 #include <torch/csrc/distributed/c10d/reducer.h>
 
+#include <algorithm>
 #include <functional>
+#include <thread>
 
+#include <c10/core/Event.h>
+#include <c10/core/impl/VirtualGuardImpl.h>
 #include <c10/util/Exception.h>
 #include <torch/csrc/autograd/engine.h>
+#include <torch/csrc/autograd/flat_grads.h>
 #include <torch/csrc/autograd/function_hook.h>
 #include <torch/csrc/autograd/functions/accumulate_grad.h>
 #include <torch/csrc/autograd/profiler.h>
@@ -42,15 +47,21 @@ Reducer::Reducer(
     std::vector<std::vector<torch::autograd::Variable>> replicas,
     std::vector<std::vector<size_t>> bucket_indices,
     std::shared_ptr<c10d::ProcessGroup> process_group,
-    std::vector<std::vector<bool>> expect_sparse_gradients)
+    std::vector<std::vector<bool>> expect_sparse_gradients,
+    bool gradient_as_bucket_view,
+    int64_t bucket_bytes_cap)
     : replicas_(std::move(replicas)),
       process_group_(std::move(process_group)),
       expect_sparse_gradients_(std::move(expect_sparse_gradients)),
+      gradient_as_bucket_view_(gradient_as_bucket_view),
       expect_autograd_hooks_(false),
       require_finalize_(false),
       next_bucket_(0),
+      bucket_bytes_cap_(bucket_bytes_cap),
+      has_rebuilt_buckets_(false),
       has_marked_unused_parameters_(false),
-      backward_stats_base_(0) {
+      backward_stats_base_(0),
+      bucket_timing_(false) {
   AT_ASSERTM(replicas_.size() >= 1, "Expected at least one model replica.");
   AT_ASSERTM(replicas_[0].size() >= 1, "Expected at least one parameter.");
 
@@ -190,6 +201,11 @@ void Reducer::mark_variable_ready_dense(VariableIndex index) {
   // of the bucket it would otherwise hold.
   auto bucket_view = replica.contents.narrow(0, offset, length);
   auto& grad = variable.grad();
+  if (gradient_as_bucket_view_ && grad.defined() &&
+      grad.data_ptr() == bucket_view.data_ptr()) {
+    // The gradient was accumulated into the bucket.
+    return;
+  }
   if (grad.defined()) {
     // Ensure that the gradient type matches the bucket type.
     AT_ASSERTM(
@@ -199,10 +215,9 @@ void Reducer::mark_variable_ready_dense(VariableIndex index) {
         ", got ",
         grad.type());
     // Assert that the grad tensor and the bucket don't share storage.
-    // If they did, we could avoid the copy altogether.
-    // The reason for not doing this is that existing code calls
-    // `detach_` from `zero_grad`, which is incompatible with views.
-    AT_ASSERT(!grad.is_alias_of(bucket_view));
+    // They only do with `gradient_as_bucket_view`, in which case the grad
+    // tensor sits at its place in the bucket unless it was replaced.
+    AT_ASSERT(gradient_as_bucket_view_ || !grad.is_alias_of(bucket_view));
     AT_ASSERT(grad.device() == bucket_view.device());
     AT_ASSERT(grad.numel() == bucket_view.numel());
     bucket_view.copy_(grad.view({-1}), /* non_blocking */ true);
@@ -276,6 +291,12 @@ void Reducer::mark_variable_ready(VariableIndex index) {
   // `prepare_for_backwards`), we know something is wrong.
   require_finalize_ = true;
 
+  // Record the order the gradients are ready in until it's complete.
+  if (!has_rebuilt_buckets_ && replica_index == 0 &&
+      ready_order_.size() < replicas_[0].size()) {
+    ready_order_.push_back(variable_index);
+  }
+
   const auto& bucket_index = variable_locators_[variable_index];
   auto& bucket = buckets_[bucket_index.bucket_index];
   auto& replica = bucket.replicas[replica_index];
@@ -310,22 +331,38 @@ void Reducer::mark_variable_ready(VariableIndex index) {
     mark_variable_ready_dense(index);
   }
 
-  // TODO(@pietern): Make this work for both CPU/CUDA tensors.
-  // When using CPU tensors we don't need to do this.
-  // // Record event so that we can wait for all of them.
-  // auto& event = replica.events[bucket_index.intra_bucket_index];
-  // event.record();
+  // Remember the stream of the copy, so that the reduction can wait on it.
+  // CPU tensors are copied synchronously.
+  if (replica.contents.is_cuda()) {
+    const auto device = replica.contents.device();
+    const auto stream =
+        c10::impl::VirtualGuardImpl(device.type()).getStream(device);
+    if (std::find(
+            replica.copy_streams.begin(), replica.copy_streams.end(), stream) ==
+        replica.copy_streams.end()) {
+      replica.copy_streams.push_back(stream);
+    }
+  }
 
   // Check if this was the final gradient for this bucket.
   if (--replica.pending == 0) {
+    sync_copy_streams(replica);
     // Prescale bucket contents to turn the global sum into the global average.
     replica.contents.div_(process_group_->getSize());
     // Kick off reduction if all replicas for this bucket are ready.
     if (--bucket.pending == 0) {
+      if (bucket_timing_) {
+        bucket_stats_[bucket_index.bucket_index].ready_ns =
+            current_time_in_nanos() - backward_stats_base_;
+      }
       mark_bucket_ready(bucket_index.bucket_index);
     }
   }
 
+  if (bucket_timing_) {
+    poll_finished_buckets();
+  }
+
   // Run finalizer function once the final bucket was marked ready.
   if (next_bucket_ == buckets_.size()) {
     torch::autograd::Engine::get_default_engine().queue_callback([=] {
@@ -353,19 +390,114 @@ void Reducer::mark_bucket_ready(size_t bucket_index) {
     auto& bucket = buckets_[next_bucket_];
     std::vector<at::Tensor> tensors;
     tensors.reserve(bucket.replicas.size());
-    for (const auto& replica : bucket.replicas) {
-      // TODO(@pietern): Ensure proper synchronization with the CUDA events
-      // that recorded copies into this contents tensor. If these copies are
-      // executed on non-default streams, the current stream for the device
-      // that holds the contents tensor must wait on these events.
-      //
-      // As long as autograd uses the default stream for every device,
-      // these operations are implicitly sequenced, and we don't need to
-      // do any extra synchronization here.
-      //
+    for (auto& replica : bucket.replicas) {
+      // The replicas can be finalized by different threads, each with its
+      // own current stream, so the reduction waits on the streams again.
+      sync_copy_streams(replica);
       tensors.push_back(replica.contents);
     }
-    bucket.work = process_group_->allreduce(tensors);
+    if (comm_hook_ && !bucket.expect_sparse_gradient) {
+      bucket.work = comm_hook_->runHook(next_bucket_, tensors);
+    } else {
+      bucket.work = process_group_->allreduce(tensors);
+    }
+    if (bucket_timing_) {
+      bucket_stats_[next_bucket_].launch_ns =
+          current_time_in_nanos() - backward_stats_base_;
+    }
+  }
+}
+
+void Reducer::set_bucket_timing(bool enabled) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  AT_ASSERTM(
+      !expect_autograd_hooks_,
+      "`set_bucket_timing` must NOT be called during autograd execution.");
+  bucket_timing_ = enabled;
+  bucket_stats_.assign(buckets_.size(), BucketStats());
+}
+
+void Reducer::poll_finished_buckets() {
+  for (size_t bucket_index = 0; bucket_index < next_bucket_; bucket_index++) {
+    auto& stats = bucket_stats_[bucket_index];
+    if (stats.finish_ns < 0 && buckets_[bucket_index].work->isCompleted()) {
+      stats.finish_ns = current_time_in_nanos() - backward_stats_base_;
+    }
+  }
+}
+
+void Reducer::shadow_backward() {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  AT_ASSERTM(
+      !expect_autograd_hooks_,
+      "`shadow_backward` must NOT be called during autograd execution.");
+
+  // The other processes rebuild their buckets after their first backward
+  // pass, this one has to take part in that in turn.
+  if (!has_rebuilt_buckets_ && ready_order_.size() < replicas_[0].size()) {
+    ready_order_.clear();
+    for (const auto& indices : bucket_indices_) {
+      ready_order_.insert(ready_order_.end(), indices.begin(), indices.end());
+    }
+  }
+
+  for (size_t bucket_index = 0; bucket_index < buckets_.size();
+       bucket_index++) {
+    auto& bucket = buckets_[bucket_index];
+    std::vector<at::Tensor> tensors;
+    tensors.reserve(bucket.replicas.size());
+    for (auto& replica : bucket.replicas) {
+      if (bucket.expect_sparse_gradient) {
+        const auto& variable = replica.variables.front();
+        tensors.push_back(at::zeros(
+            variable.sizes(), variable.options().layout(c10::kSparse)));
+      } else {
+        replica.contents.zero_();
+        tensors.push_back(replica.contents);
+      }
+    }
+    if (comm_hook_ && !bucket.expect_sparse_gradient) {
+      bucket.work = comm_hook_->runHook(bucket_index, tensors);
+    } else {
+      bucket.work = process_group_->allreduce(tensors);
+    }
+  }
+  for (auto& bucket : buckets_) {
+    bucket.work->wait();
+    bucket.work.reset();
+  }
+}
+
+void Reducer::sync_copy_streams(BucketReplica& replica) {
+  if (replica.copy_streams.empty()) {
+    return;
+  }
+  const auto device = replica.contents.device();
+  c10::impl::VirtualGuardImpl impl(device.type());
+  const auto current = impl.getStream(device);
+  for (const auto& stream : replica.copy_streams) {
+    if (stream != current) {
+      c10::Event event(device.type());
+      event.record(stream);
+      event.block(current);
+    }
+  }
+  // Everything that follows is ordered after the copies on this stream.
+  replica.copy_streams = {current};
+}
+
+void Reducer::register_comm_hook(
+    std::shared_ptr<CommHookInterface> comm_hook) {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  // The hook can't change while buckets are being reduced.
+  AT_ASSERTM(
+      !expect_autograd_hooks_,
+      "`register_comm_hook` must NOT be called during autograd execution.");
+  comm_hook_ = std::move(comm_hook);
+  if (comm_hook_) {
+    comm_hook_->onBucketsInitialized(bucket_indices_);
   }
 }
 
@@ -455,6 +587,14 @@ void Reducer::initialize_buckets(
 
         // Allocate bucket contents tensor.
         replica.contents = at::empty({static_cast<long>(offset)}, options);
+
+        // Move the gradients into the bucket.
+        if (gradient_as_bucket_view_) {
+          for (size_t i = 0; i < replica.variables.size(); i++) {
+            torch::autograd::set_grad_in_buffer(
+                replica.variables[i], replica.contents, replica.offsets[i]);
+          }
+        }
       }
 
       // Add bucket replica to enclosing bucket.
@@ -476,6 +616,67 @@ void Reducer::initialize_buckets(
 
     buckets_.push_back(std::move(bucket));
   }
+
+  bucket_indices_ = std::move(bucket_indices);
+  if (comm_hook_) {
+    comm_hook_->onBucketsInitialized(bucket_indices_);
+  }
+}
+
+bool Reducer::rebuild_buckets() {
+  std::vector<size_t> ready_order;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    AT_ASSERTM(
+        !expect_autograd_hooks_,
+        "`rebuild_buckets` must NOT be called during autograd execution.");
+    if (has_rebuilt_buckets_ || ready_order_.size() < replicas_[0].size()) {
+      return false;
+    }
+    has_rebuilt_buckets_ = true;
+    ready_order = std::move(ready_order_);
+    ready_order_.clear();
+  }
+
+  // Gradients may be ready in different orders across processes, but the
+  // buckets have to be reduced in the same one everywhere.
+  std::vector<at::Tensor> order_tensors = {
+      at::tensor(
+          std::vector<int64_t>(ready_order.begin(), ready_order.end()),
+          at::kLong)
+          .to(replicas_[0][0].device())};
+  BroadcastOptions opts;
+  opts.rootRank = 0;
+  process_group_->broadcast(order_tensors, opts)->wait();
+  const auto order_tensor = order_tensors.front().cpu();
+  const auto order_accessor = order_tensor.accessor<int64_t, 1>();
+  for (size_t i = 0; i < ready_order.size(); i++) {
+    ready_order[i] = order_accessor[i];
+  }
+
+  // Assign the buckets over the variables in the order they are ready in, and
+  // map the positions in that order back to variable indices.
+  std::vector<at::Tensor> tensors;
+  std::vector<bool> expect_sparse_gradient;
+  tensors.reserve(ready_order.size());
+  expect_sparse_gradient.reserve(ready_order.size());
+  for (const auto variable_index : ready_order) {
+    tensors.push_back(replicas_[0][variable_index]);
+    expect_sparse_gradient.push_back(
+        expect_sparse_gradients_[0][variable_index]);
+  }
+  auto bucket_indices = compute_bucket_assignment_by_size(
+      tensors,
+      {static_cast<size_t>(kDefaultFirstBucketBytes),
+       static_cast<size_t>(bucket_bytes_cap_)},
+      expect_sparse_gradient);
+  for (auto& bucket : bucket_indices) {
+    for (auto& index : bucket) {
+      index = ready_order[index];
+    }
+  }
+  initialize_buckets(std::move(bucket_indices));
+  return true;
 }
 
 // Traverse the autograd graph starting at the specified output.
@@ -518,9 +719,13 @@ void Reducer::prepare_for_backward(
   expect_autograd_hooks_ = true;
   next_bucket_ = 0;
   backward_stats_base_ = current_time_in_nanos();
+  if (bucket_timing_) {
+    bucket_stats_.assign(buckets_.size(), BucketStats());
+  }
   for (auto& bucket : buckets_) {
     for (auto& replica : bucket.replicas) {
       replica.pending = replica.variables.size();
+      replica.copy_streams.clear();
     }
     bucket.pending = bucket.replicas.size();
   }
@@ -584,6 +789,11 @@ void Reducer::finalize_bucket_dense(Bucket& bucket) {
       auto& grad = variable.grad();
       if (!grad.defined()) {
         grad = at::empty(bucket_view.sizes(), bucket_view.options());
+      } else if (
+          gradient_as_bucket_view_ &&
+          grad.data_ptr() == bucket_view.data_ptr()) {
+        // Reduced in place.
+        continue;
       }
       grad.copy_(bucket_view);
     }
@@ -616,12 +826,32 @@ void Reducer::finalize_backward() {
   AT_ASSERT(next_bucket_ == buckets_.size());
 
   // Wait for asynchronous reduction to complete and unflatten contents.
-  for (auto& bucket : buckets_) {
+  for (size_t bucket_index = 0; bucket_index < buckets_.size();
+       bucket_index++) {
+    auto& bucket = buckets_[bucket_index];
     AT_ASSERT(bucket.work);
     bucket.work->wait();
+    if (bucket_timing_) {
+      // Waiting on a CUDA reduction only makes the current stream wait.
+      while (!bucket.work->isCompleted()) {
+        std::this_thread::yield();
+      }
+      poll_finished_buckets();
+    }
     if (bucket.expect_sparse_gradient) {
       finalize_bucket_sparse(bucket);
     } else {
+      // Hooks don't necessarily reduce the bucket contents in place.
+      if (comm_hook_) {
+        const auto result = bucket.work->result();
+        AT_ASSERT(bucket.replicas.size() == result.size());
+        for (size_t i = 0; i < bucket.replicas.size(); i++) {
+          auto& contents = bucket.replicas[i].contents;
+          if (!result[i].is_same(contents)) {
+            contents.copy_(result[i]);
+          }
+        }
+      }
       finalize_bucket_dense(bucket);
     }
   }
@@ -10,20 +10,44 @@
 #include <c10d/ProcessGroup.hpp>
 #include <torch/csrc/autograd/function.h>
 #include <torch/csrc/autograd/variable.h>
+#include <torch/csrc/distributed/c10d/comm_hooks.h>
 
 namespace c10d {
 
+// The size limits of the buckets: the first one is small so that the first
+// reduction is kicked off early in the backward pass. Same as in
+// DistributedDataParallel.
+constexpr int64_t kDefaultFirstBucketBytes = 1024 * 1024;
+constexpr int64_t kDefaultBucketBytesCap = 25 * 1024 * 1024;
+
+// The times of the reduction of a bucket in a backward pass, in nanoseconds
+// relative to the time `prepare_for_backward` was called, -1 if it didn't
+// happen: the time its last gradient was ready, the time its reduction was
+// launched, which can be later since buckets are reduced in order, and the
+// first time the reduction was seen finished (see `set_bucket_timing`).
+struct BucketStats {
+  int64_t ready_ns = -1;
+  int64_t launch_ns = -1;
+  int64_t finish_ns = -1;
+};
+
 class Reducer {
  public:
   // The constructor takes a list of variables for every model replica.
   // The bucket assignment for this reducer is specified as a list of
   // buckets, each of which is specified as a list of indices into the
   // variables list for **a single replica** (i.e. `variables[0]`).
+  // With gradient_as_bucket_view, the gradients of the dense variables are
+  // kept in the bucket contents themselves instead of being copied there and
+  // back (see `set_grad_in_buffer`). The bucket_bytes_cap is the size limit
+  // of the buckets reassigned by `rebuild_buckets`.
   explicit Reducer(
       std::vector<std::vector<torch::autograd::Variable>> replicas,
       std::vector<std::vector<size_t>> bucket_indices,
       std::shared_ptr<c10d::ProcessGroup> process_group,
-      std::vector<std::vector<bool>> expect_sparse_gradients);
+      std::vector<std::vector<bool>> expect_sparse_gradients,
+      bool gradient_as_bucket_view = false,
+      int64_t bucket_bytes_cap = kDefaultBucketBytesCap);
 
   ~Reducer() noexcept(false);
 
@@ -33,6 +57,16 @@ class Reducer {
   // all live on the same device and have the same dimensionality.
   void initialize_buckets(std::vector<std::vector<size_t>> bucket_indices);
 
+  // The initial bucket assignment follows the reverse order of the
+  // variables, which is only an estimate of the order their gradients are
+  // ready in. This function reassigns the buckets once, in the order the
+  // gradients were ready in the first backward pass, so that no bucket waits
+  // on a gradient ready much later than the others. Every process uses the
+  // order of the process with rank 0, so this is a collective call, to be
+  // made by every process between backward passes. Returns whether the
+  // buckets were rebuilt.
+  bool rebuild_buckets();
+
   // This function is called when the forward function has produced an output,
   // and the user wishes to reduce gradients in the backwards pass.
   // If they don't, and wish to accumulate gradients before reducing them,
@@ -40,6 +74,19 @@ class Reducer {
   void prepare_for_backward(
       const std::vector<torch::autograd::Variable>& outputs);
 
+  // Runs the reductions of a backward pass with zero gradients and waits for
+  // them, without touching the gradients of the variables. A process that ran
+  // out of inputs calls this for every backward pass the other processes still
+  // run, so that their reductions don't wait on it forever. The gradients they
+  // end up with are scaled by the number of processes in the group, all the
+  // same, so the processes that have joined count as zero gradients.
+  void shadow_backward();
+
+  // Registers a hook to run the reduction of the dense buckets, instead of
+  // allreducing their contents (see CommHookInterface). Buckets that expect a
+  // sparse gradient are still allreduced.
+  void register_comm_hook(std::shared_ptr<CommHookInterface> comm_hook);
+
   // Returns the relative time in nanoseconds when gradients were ready,
   // with respect to the time `prepare_for_backward` was called. The outer
   // vector is for model replicas and the inner vector is for parameters.
@@ -47,6 +94,21 @@ class Reducer {
     return backward_stats_;
   }
 
+  // Turns the recording of the bucket times of the backward passes on or off
+  // (see `BucketStats`). Off by default. The finish times are polled in the
+  // autograd hooks, and at the end of the backward pass, which then waits on
+  // the host for the reductions the way `Work::wait` does for the CPU process
+  // groups, with CUDA ones too. That is the only cost of the timing, which can
+  // be turned on in production to diagnose the overlap of the reductions
+  // with the backward pass.
+  void set_bucket_timing(bool enabled);
+
+  // Returns the bucket times of the last backward pass, in the order the
+  // buckets are reduced in.
+  std::vector<BucketStats> get_bucket_stats() const {
+    return bucket_stats_;
+  }
+
  protected:
   // Forward declaration.
   struct Bucket;
@@ -61,6 +123,7 @@ class Reducer {
   std::vector<std::vector<torch::autograd::Variable>> replicas_;
   std::shared_ptr<c10d::ProcessGroup> process_group_;
   std::vector<std::vector<bool>> expect_sparse_gradients_;
+  const bool gradient_as_bucket_view_;
 
   std::vector<std::vector<std::shared_ptr<torch::autograd::Node>>>
       grad_accumulators_;
@@ -72,6 +135,14 @@ class Reducer {
   bool require_finalize_;
   size_t next_bucket_;
 
+  std::shared_ptr<CommHookInterface> comm_hook_;
+
+  const int64_t bucket_bytes_cap_;
+  bool has_rebuilt_buckets_;
+  // The indices of the variables of the first model replica, in the order
+  // their gradients were ready in the first backward pass.
+  std::vector<size_t> ready_order_;
+
   bool has_marked_unused_parameters_;
   std::vector<VariableIndex> unused_parameters_;
 
@@ -119,11 +190,12 @@ class Reducer {
     // This is reset to `variables.size()` every iteration.
     size_t pending;
 
-    // TODO(@pietern)
     // Memory copies from gradient tensors into the bucket are potentially
-    // done on different CUDA streams. We record an event for every copy
-    // so that we can synchronize with them prior to kicking off the reduction.
-    // std::vector<at::cuda::CUDAEvent> events;
+    // done on different CUDA streams. These are the streams that they were
+    // done on, which the stream the bucket is reduced on waits on, through
+    // an event, without blocking the host. It's a single stream unless
+    // autograd ran the backward pass on more than one.
+    std::vector<c10::Stream> copy_streams;
   };
 
   // A bucket holds N bucket replicas (1 per model replica).
@@ -147,6 +219,13 @@ class Reducer {
 
   std::vector<Bucket> buckets_;
 
+  // Makes the current stream of the device of the bucket replica wait on
+  // the streams its contents were copied on.
+  void sync_copy_streams(BucketReplica& replica);
+
+  // The bucket assignment the buckets were initialized with.
+  std::vector<std::vector<size_t>> bucket_indices_;
+
   // A variable locator locates a particular variable in the bucket
   // structure. The `bucket_index` field points to the bucket in the `buckets_`
   // vector. The `intra_bucket_index` field points to the index of the variable
@@ -166,6 +245,12 @@ class Reducer {
   // the point in time buckets were ready, or ideal bucket assignment/ordering.
   int64_t backward_stats_base_;
   std::vector<std::vector<int64_t>> backward_stats_;
+
+  bool bucket_timing_;
+  std::vector<BucketStats> bucket_stats_;
+
+  // Records the finish time of the launched reductions that completed.
+  void poll_finished_buckets();
 };
 
 std::vector<std::vector<size_t>> compute_bucket_assignment_by_size(
@@ -0,0 +1,147 @@
+#include <torch/csrc/distributed/c10d/sharded_optimizer.h>
+
+#include <c10/util/Exception.h>
+#include <torch/csrc/autograd/grad_mode.h>
+
+namespace c10d {
+
+ShardedOptimizerHook::ShardedOptimizerHook(
+    std::shared_ptr<ProcessGroup> process_group,
+    std::vector<torch::autograd::Variable> parameters)
+    : process_group_(std::move(process_group)),
+      parameters_(std::move(parameters)),
+      layout_version_(0) {}
+
+void ShardedOptimizerHook::onBucketsInitialized(
+    const std::vector<std::vector<size_t>>& bucket_indices) {
+  // Registering the hook reports the assignment the shards may already follow
+  if (!shards_.empty() && bucket_indices == bucket_indices_) {
+    return;
+  }
+  torch::autograd::AutoGradMode grad_mode(false);
+  const auto world_size = process_group_->getSize();
+  const auto rank = process_group_->getRank();
+  std::vector<Shard> shards;
+  shards.reserve(bucket_indices.size());
+  for (const auto& indices : bucket_indices) {
+    Shard shard;
+    shard.variable_indices = indices;
+    shard.numel = 0;
+    for (const auto index : indices) {
+      TORCH_CHECK(
+          index < parameters_.size(),
+          "ShardedOptimizerHook: The bucket assignment refers to parameter ",
+          index,
+          ", but only ",
+          parameters_.size(),
+          " parameters were given");
+      shard.numel += parameters_[index].numel();
+    }
+    shard.chunk_numel = (shard.numel + world_size - 1) / world_size;
+
+    const auto& first = parameters_[indices.front()];
+    auto flat = at::zeros({shard.chunk_numel * world_size}, first.options());
+    int64_t offset = 0;
+    for (const auto index : indices) {
+      const auto& parameter = parameters_[index];
+      flat.narrow(0, offset, parameter.numel()).copy_(parameter.reshape({-1}));
+      offset += parameter.numel();
+    }
+    shard.parameter = torch::autograd::make_variable(
+        flat.narrow(0, rank * shard.chunk_numel, shard.chunk_numel).clone(),
+        /*requires_grad=*/true);
+    shard.parameter.grad() = at::zeros_like(shard.parameter);
+    shards.push_back(std::move(shard));
+  }
+  shards_ = std::move(shards);
+  bucket_indices_ = bucket_indices;
+  layout_version_++;
+}
+
+std::shared_ptr<ProcessGroup::Work> ShardedOptimizerHook::runHook(
+    size_t bucket_index,
+    std::vector<at::Tensor>& tensors) {
+  TORCH_CHECK(
+      tensors.size() == 1,
+      "ShardedOptimizerHook: Only a single model replica per process is ",
+      "supported");
+  TORCH_CHECK(
+      bucket_index < shards_.size(),
+      "ShardedOptimizerHook: No shard for bucket ",
+      bucket_index);
+  auto& shard = shards_[bucket_index];
+  const auto& contents = tensors[0];
+  AT_ASSERT(contents.numel() == shard.numel);
+  const auto world_size = process_group_->getSize();
+  const auto rank = process_group_->getRank();
+
+  auto padded = contents;
+  if (shard.chunk_numel * world_size != shard.numel) {
+    padded = at::zeros({shard.chunk_numel * world_size}, contents.options());
+    padded.narrow(0, 0, shard.numel).copy_(contents);
+  }
+  auto& grad = shard.parameter.grad();
+  if (!grad.defined()) {
+    grad = at::zeros_like(shard.parameter);
+  }
+
+  std::shared_ptr<ProcessGroup::Work> work;
+  std::function<std::vector<at::Tensor>()> then;
+  if (contents.is_cuda()) {
+    std::vector<at::Tensor> outputs = {grad};
+    std::vector<std::vector<at::Tensor>> inputs = {padded.chunk(world_size)};
+    work = process_group_->reduce_scatter(outputs, inputs);
+    then = [tensors] { return tensors; };
+  } else {
+    std::vector<at::Tensor> buffers = {padded};
+    work = process_group_->allreduce(buffers);
+    const auto chunk_numel = shard.chunk_numel;
+    then = [tensors, grad, padded, rank, chunk_numel]() mutable {
+      grad.copy_(padded.narrow(0, rank * chunk_numel, chunk_numel));
+      return tensors;
+    };
+  }
+  return std::make_shared<HookWork>(
+      std::vector<std::shared_ptr<ProcessGroup::Work>>{work}, std::move(then));
+}
+
+std::vector<torch::autograd::Variable> ShardedOptimizerHook::shards() const {
+  std::vector<torch::autograd::Variable> shards;
+  shards.reserve(shards_.size());
+  for (const auto& shard : shards_) {
+    shards.push_back(shard.parameter);
+  }
+  return shards;
+}
+
+void ShardedOptimizerHook::allgather_parameters() {
+  torch::autograd::AutoGradMode grad_mode(false);
+  const auto world_size = process_group_->getSize();
+
+  // Kick off the allgather of every bucket before waiting on any of them
+  std::vector<at::Tensor> flats;
+  std::vector<std::shared_ptr<ProcessGroup::Work>> works;
+  flats.reserve(shards_.size());
+  works.reserve(shards_.size());
+  for (const auto& shard : shards_) {
+    auto flat = at::empty(
+        {shard.chunk_numel * world_size}, shard.parameter.options());
+    std::vector<std::vector<at::Tensor>> outputs = {flat.chunk(world_size)};
+    std::vector<at::Tensor> inputs = {shard.parameter};
+    works.push_back(process_group_->allgather(outputs, inputs));
+    flats.push_back(std::move(flat));
+  }
+
+  for (size_t i = 0; i < shards_.size(); i++) {
+    works[i]->wait();
+    int64_t offset = 0;
+    for (const auto index : shards_[i].variable_indices) {
+      auto& parameter = parameters_[index];
+      parameter.copy_(
+          flats[i].narrow(0, offset, parameter.numel()).view_as(parameter));
+      offset += parameter.numel();
+    }
+  }
+}
+
+} // namespace c10d
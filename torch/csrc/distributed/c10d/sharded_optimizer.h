@@ -0,0 +1,73 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include <ATen/ATen.h>
+#include <c10d/ProcessGroup.hpp>
+#include <torch/csrc/autograd/variable.h>
+#include <torch/csrc/distributed/c10d/comm_hooks.h>
+
+namespace c10d {
+
+// Shards the optimizer state across the processes of a group, as in ZeRO
+// (Rajbhandari et al., 2019). It's registered as the communication hook of the
+// Reducer of `parameters`, which must be the variables of its first model
+// replica. The flattened contents of every bucket are split into one chunk per
+// process, padded to the same size, and reduce-scattered as soon as the bucket
+// is ready, so that each process only receives the reduced gradient of the
+// chunks it owns: the gradient of its shards. An optimizer over `shards()` then
+// only keeps the state of 1 / world size of the parameters, and once it has
+// stepped, `allgather_parameters` gathers the updated shards of every process
+// back into the parameters.
+//
+// The gradients of the parameters themselves are left unreduced. The shards
+// follow the bucket assignment of the Reducer and are recreated from the
+// parameters if it changes, which bumps `layout_version`. Only a single model
+// replica per process and dense gradients are supported. Gloo and MPI don't
+// implement reduce_scatter, so CPU buckets are allreduced instead and only the
+// owned chunk of the result is kept.
+class ShardedOptimizerHook : public CommHookInterface {
+ public:
+  ShardedOptimizerHook(
+      std::shared_ptr<ProcessGroup> process_group,
+      std::vector<torch::autograd::Variable> parameters);
+
+  void onBucketsInitialized(
+      const std::vector<std::vector<size_t>>& bucket_indices) override;
+
+  std::shared_ptr<ProcessGroup::Work> runHook(
+      size_t bucket_index,
+      std::vector<at::Tensor>& tensors) override;
+
+  // The flat chunk of every bucket owned by this process, as leaf variables
+  // whose gradients are written by the hook.
+  std::vector<torch::autograd::Variable> shards() const;
+
+  // Bumped every time the shards are recreated.
+  int64_t layout_version() const {
+    return layout_version_;
+  }
+
+  // Gathers the shards of every process into the parameters. This is a
+  // collective call, to be made by every process after stepping its shards.
+  void allgather_parameters();
+
+ protected:
+  struct Shard {
+    // Indices of the bucket variables in `parameters_`, in bucket order.
+    std::vector<size_t> variable_indices;
+    // Number of elements of the bucket, and of each of its chunks.
+    int64_t numel;
+    int64_t chunk_numel;
+    torch::autograd::Variable parameter;
+  };
+
+  std::shared_ptr<ProcessGroup> process_group_;
+  std::vector<torch::autograd::Variable> parameters_;
+  std::vector<std::vector<size_t>> bucket_indices_;
+  std::vector<Shard> shards_;
+  int64_t layout_version_;
+};
+
+} // namespace c10d
@@ -87,11 +87,19 @@ Returns worker information of the node that owns this ``RRef``.
           .def(
               "to_here",
               &PyRRef::toHere,
+              py::arg("cache") = false,
               py::call_guard<py::gil_scoped_release>(),
               R"(
 Blocking call that copies the value of the RRef from the owner to the local node
 and returns it. If the current node is the owner, returns a reference to the
 local value.
+
+Arguments:
+    cache (bool): if ``True``, keep the copy and return it from later
+                  ``to_here(cache=True)`` calls instead of fetching the value
+                  again. Only use it for values that the owner doesn't
+                  modify. The cache is not used in a distributed autograd
+                  context. (default: ``False``)
               )")
           .def(
               "local_value",
@@ -182,6 +190,16 @@ Otherwise, throws an exception.
         return pyRpcBuiltin(agent, dst, opName, args, kwargs);
       });
 
+  module.def(
+      "_invoke_rpc_torchscript",
+      [](RpcAgent& agent,
+         const WorkerInfo& dst,
+         const std::string& qualifiedName,
+         const py::args& args,
+         const py::kwargs& kwargs) {
+        return pyRpcTorchscript(agent, dst, qualifiedName, args, kwargs);
+      });
+
   module.def(
       "_invoke_rpc_python_udf",
       [](RpcAgent& agent,
@@ -201,6 +219,16 @@ Otherwise, throws an exception.
         return pyRemoteBuiltin(agent, dst, opName, args, kwargs);
       });
 
+  module.def(
+      "_invoke_remote_torchscript",
+      [](RpcAgent& agent,
+         const WorkerInfo& dst,
+         const std::string& qualifiedName,
+         const py::args& args,
+         const py::kwargs& kwargs) {
+        return pyRemoteTorchscript(agent, dst, qualifiedName, args, kwargs);
+      });
+
   module.def(
       "_invoke_remote_python_udf",
       [](RpcAgent& agent,
@@ -210,6 +238,13 @@ Otherwise, throws an exception.
         return pyRemotePythonUdf(agent, dst, pickledPythonUDF, tensors);
       });
 
+  module.def(
+      "_to_here_many",
+      &PyRRef::toHereMany,
+      py::arg("rrefs"),
+      py::arg("cache") = false,
+      py::call_guard<py::gil_scoped_release>());
+
   module.def(
       "get_rpc_timeout",
       []() { return RpcAgent::getDefaultRpcAgent()->getRpcTimeout(); },
@@ -12,7 +12,8 @@ namespace rpc {
 
 namespace {
 
-// Write the message into the given ostream
+// Pickles the message into a string, tensors included. This is the fallback
+// for messages with tensors that can't be sent as raw buffers.
 std::string serialize(const Message& message) {
   // We cast const void* to void* here because we need to create a tensor using
   // that memory space. If is fine as that tensor stays function-local, and will
@@ -65,6 +66,32 @@ Message deserialize(MessageType type, const void* buf, size_t size) {
   return Message(std::move(payload), std::move(tensors), type, id);
 }
 
+// The tensor count of the metadata of a pickled message.
+constexpr int64_t kPickledMessage = -1;
+
+// The most listener threads receiving messages, and the most messages and
+// bytes sent in one batch.
+constexpr int kMaxListenerThreads = 4;
+constexpr size_t kMaxBatchMessages = 128;
+constexpr size_t kMaxBatchBytes = 64 * 1024;
+
+size_t messageBytes(const Message& message) {
+  size_t bytes = message.payload().size();
+  for (const auto& tensor : message.tensors()) {
+    bytes += tensor.nbytes();
+  }
+  return bytes;
+}
+
+bool canSendRaw(const std::vector<torch::Tensor>& tensors) {
+  for (const auto& tensor : tensors) {
+    if (tensor.layout() != torch::kStrided) {
+      return false;
+    }
+  }
+  return true;
+}
+
 } // namespace
 
 //////////////////////////  MessageCounter  /////////////////////////////////
@@ -132,7 +159,8 @@ ProcessGroupAgent::ProcessGroupAgent(
       sendCounts_(pg_->getSize()),
       recvCounts_(pg_->getSize()),
       nextId_(0),
-      sendMutexes_(pg_->getSize()),
+      numListenerThreads_(std::min(pg_->getSize(), kMaxListenerThreads)),
+      sendQueues_(pg_->getSize()),
       threadPool_(numSendRecvThreads) {
   collectNames();
   TORCH_CHECK(
@@ -201,7 +229,9 @@ void ProcessGroupAgent::join() {
   enqueueSend(
       SendWork(allWorkerInfo_[dst], Message({}, {}, MessageType::SHUTDOWN)));
   threadPool_.waitWorkComplete();
-  listenerThread_.join();
+  for (auto& listenerThread : listenerThreads_) {
+    listenerThread.join();
+  }
   futureTimeoutThread_.join();
   PythonRpcHandler::getInstance().cleanup();
 }
@@ -269,7 +299,9 @@ void ProcessGroupAgent::sync() {
 }
 
 void ProcessGroupAgent::start() {
-  listenerThread_ = std::thread(&ProcessGroupAgent::listenLoop, this);
+  for (int i = 0; i < numListenerThreads_; i++) {
+    listenerThreads_.emplace_back(&ProcessGroupAgent::listenLoop, this, i);
+  }
   futureTimeoutThread_ =
       std::thread(&ProcessGroupAgent::pollTimedOutRPCs, this);
 }
@@ -322,22 +354,22 @@ std::shared_ptr<FutureMessage> ProcessGroupAgent::send(
     threadPool_.run(std::bind(
         [this](const Message& message) {
           sendCounts_.increment(pg_->getRank());
-          // Unlike the other cases, need to add a tensor deleter, since the
-          // data outlives the scope of this function. It's shared_ptr<> due
-          // to c++11 lambda capture limitations with unique_ptr<>.
-          auto payload =
-              c10::guts::make_unique<std::string>(serialize(message));
-          const char* data = payload->data();
-          size_t len = payload->length();
-          std::string* delete_when_done = payload.release();
+          // The receiver gets its own copy of the tensors, as if they had
+          // been sent, without going through serialization.
+          std::vector<torch::Tensor> tensors;
+          tensors.reserve(message.tensors().size());
+          for (const auto& tensor : message.tensors()) {
+            auto copy = tensor.detach().clone();
+            copy.set_requires_grad(tensor.requires_grad());
+            tensors.push_back(std::move(copy));
+          }
           enqueueRecv(RecvWork(
               getWorkerInfo(pg_->getRank()),
-              message.type(),
-              torch::from_blob(
-                  (void*)data,
-                  len,
-                  [delete_when_done](void*) { delete delete_when_done; },
-                  {torch::kChar})));
+              Message(
+                  std::vector<char>(message.payload()),
+                  std::move(tensors),
+                  message.type(),
+                  message.id())));
         },
         std::move(message)));
     return future;
@@ -357,60 +389,249 @@ std::shared_ptr<FutureMessage> ProcessGroupAgent::send(
 }
 
 void ProcessGroupAgent::enqueueSend(SendWork work) {
-  // NB: this can be changed to use a native move capture when moved to C++14
-  threadPool_.run(std::bind(
-      [this](const SendWork& work) {
-        std::string serializedPayload = serialize(work.message_);
-
-        std::vector<torch::Tensor> preamble = {torch::tensor(
-            {(int64_t)pg_->getRank(),
-             (int64_t)serializedPayload.length(),
-             (int64_t)work.message_.type()},
-            {torch::kLong})};
-
-        // ProcessGroup is not thread-safe when sending with the same tag, hence
-        // the lock
-        std::vector<std::shared_ptr<c10d::ProcessGroup::Work>> pendingSends;
-        const auto dst = work.to_.id_;
-        if (work.message_.isShutdown()) {
-          pendingSends.reserve(1);
-          {
-            std::lock_guard<std::mutex> guard(sendMutexes_[dst]);
-            pendingSends.emplace_back(
-                pg_->send(preamble, dst, dst /* channelTag */));
-          }
-        } else {
-          std::vector<torch::Tensor> payload = {torch::from_blob(
-              (void*)serializedPayload.c_str(),
-              serializedPayload.length(),
-              {torch::kChar})};
-          pendingSends.reserve(2);
-
-          sendCounts_.increment(dst);
+  const auto dst = work.to_.id_;
+  auto& queue = sendQueues_[dst];
+  {
+    std::lock_guard<std::mutex> guard(queue.mutex_);
+    queue.messages_.push_back(std::move(work.message_));
+    if (queue.draining_) {
+      return;
+    }
+    queue.draining_ = true;
+  }
+  threadPool_.run([this, dst] { drainSendQueue(dst); });
+}
 
-          {
-            std::lock_guard<std::mutex> guard(sendMutexes_[dst]);
-            pendingSends.emplace_back(
-                pg_->send(preamble, dst, dst /* channelTag */));
-            pendingSends.emplace_back(
-                pg_->send(payload, dst, dst /* channelTag */));
+void ProcessGroupAgent::drainSendQueue(int dst) {
+  auto& queue = sendQueues_[dst];
+  try {
+    while (true) {
+      // Small messages are sent together, up to kMaxBatchBytes, the others
+      // and the shutdown on their own.
+      std::vector<Message> batch;
+      {
+        std::lock_guard<std::mutex> guard(queue.mutex_);
+        size_t batchBytes = 0;
+        while (!queue.messages_.empty() && batch.size() < kMaxBatchMessages) {
+          const auto& message = queue.messages_.front();
+          const auto bytes = messageBytes(message);
+          if (!batch.empty() &&
+              (message.isShutdown() || batchBytes + bytes > kMaxBatchBytes)) {
+            break;
+          }
+          batchBytes += bytes;
+          batch.push_back(std::move(queue.messages_.front()));
+          queue.messages_.pop_front();
+          if (batch.back().isShutdown() || batchBytes >= kMaxBatchBytes) {
+            break;
           }
         }
-        for (auto& pendingSend : pendingSends) {
-          pendingSend->wait();
+        if (batch.empty()) {
+          queue.draining_ = false;
+          return;
         }
-      },
-      std::move(work)));
+      }
+      for (const auto& message : batch) {
+        if (!message.isShutdown()) {
+          sendCounts_.increment(dst);
+        }
+      }
+      sendMessages(dst, batch);
+    }
+  } catch (...) {
+    // Let the next message start draining the queue again.
+    std::lock_guard<std::mutex> guard(queue.mutex_);
+    queue.draining_ = false;
+    throw;
+  }
+}
+
+void ProcessGroupAgent::sendMessages(
+    int dst,
+    const std::vector<Message>& messages) {
+  // See Note [Message Wire Format].
+  const auto rank = (int64_t)pg_->getRank();
+  std::vector<std::shared_ptr<c10d::ProcessGroup::Work>> pendingSends;
+  if (messages.front().isShutdown()) {
+    // Every listener thread of the destination gets one.
+    std::vector<torch::Tensor> preamble = {torch::tensor(
+        {rank, (int64_t)0, (int64_t)0, (int64_t)0}, {torch::kLong})};
+    for (int i = 0; i < numListenerThreads_; i++) {
+      pendingSends.emplace_back(
+          pg_->send(preamble, dst, dst * numListenerThreads_ + i));
+    }
+    for (auto& pendingSend : pendingSends) {
+      pendingSend->wait();
+    }
+    return;
+  }
+
+  std::vector<int64_t> meta;
+  std::vector<torch::Tensor> buffers;
+  std::vector<std::string> pickled;
+  // The payloads point into it.
+  pickled.reserve(messages.size());
+  std::vector<torch::Tensor> payloads;
+  int64_t payloadSize = 0;
+  for (const auto& message : messages) {
+    meta.push_back(message.type());
+    meta.push_back(message.id());
+    if (canSendRaw(message.tensors())) {
+      // Same as in `serialize`, the payload is only read from.
+      payloads.push_back(torch::from_blob(
+          const_cast<char*>(message.payload().data()), // NOLINT
+          message.payload().size(),
+          {torch::kChar}));
+      meta.push_back(message.payload().size());
+      const auto& tensors = message.tensors();
+      meta.push_back(tensors.size());
+      for (const auto& tensor : tensors) {
+        meta.push_back(static_cast<int64_t>(tensor.scalar_type()));
+        meta.push_back(static_cast<int64_t>(tensor.device().type()));
+        meta.push_back(tensor.device().index());
+        meta.push_back(tensor.requires_grad());
+        meta.push_back(tensor.dim());
+        meta.insert(meta.end(), tensor.sizes().begin(), tensor.sizes().end());
+        if (tensor.numel() > 0) {
+          // No copy for contiguous CPU tensors.
+          buffers.push_back(tensor.detach().cpu().contiguous());
+        }
+      }
+    } else {
+      pickled.push_back(serialize(message));
+      payloads.push_back(torch::from_blob(
+          const_cast<char*>(pickled.back().data()), // NOLINT
+          pickled.back().size(),
+          {torch::kChar}));
+      meta.push_back(pickled.back().size());
+      meta.push_back(kPickledMessage);
+    }
+    payloadSize += payloads.back().numel();
+  }
+  // The payload of a single message is sent straight from its vector.
+  if (payloadSize > 0) {
+    buffers.insert(
+        buffers.begin(),
+        payloads.size() == 1 ? payloads.front() : torch::cat(payloads));
+  }
+
+  std::vector<torch::Tensor> preamble = {torch::tensor(
+      {rank, (int64_t)messages.size(), (int64_t)meta.size(), payloadSize},
+      {torch::kLong})};
+  std::vector<torch::Tensor> metaTensor = {
+      torch::tensor(meta, {torch::kLong})};
+
+  // This is the only task sending to `dst`, so the sends of different
+  // messages can't be interleaved.
+  const auto tag = dst * numListenerThreads_ + rank % numListenerThreads_;
+  pendingSends.reserve(buffers.size() + 2);
+  pendingSends.emplace_back(pg_->send(preamble, dst, tag));
+  pendingSends.emplace_back(pg_->send(metaTensor, dst, tag));
+  for (auto& buffer : buffers) {
+    std::vector<torch::Tensor> tensors = {buffer};
+    pendingSends.emplace_back(pg_->send(tensors, dst, tag));
+  }
+  for (auto& pendingSend : pendingSends) {
+    pendingSend->wait();
+  }
+}
+
+std::vector<Message> ProcessGroupAgent::recvMessages(
+    int src,
+    int tag,
+    int64_t count,
+    int64_t metaSize,
+    int64_t payloadSize) {
+  // See Note [Message Wire Format].
+  const auto recv = [this, src, tag](const torch::Tensor& tensor) {
+    std::vector<torch::Tensor> tensors = {tensor};
+    pg_->recv(tensors, src, tag)->wait();
+  };
+
+  auto meta = torch::empty({metaSize}, {torch::kInt64});
+  recv(meta);
+  std::vector<char> payloads(payloadSize);
+  if (payloadSize > 0) {
+    recv(torch::from_blob(payloads.data(), payloadSize, {torch::kChar}));
+  }
+
+  const int64_t* items = meta.data_ptr<int64_t>();
+  int64_t offset = 0;
+  int64_t payloadOffset = 0;
+  std::vector<Message> messages;
+  messages.reserve(count);
+  for (int64_t m = 0; m < count; m++) {
+    TORCH_CHECK(offset + 4 <= metaSize, "Failed to deserialize a message.");
+    const auto type = static_cast<MessageType>(items[offset]);
+    const auto id = items[offset + 1];
+    const auto size = items[offset + 2];
+    const auto numTensors = items[offset + 3];
+    offset += 4;
+    TORCH_CHECK(
+        payloadOffset + size <= payloadSize,
+        "Failed to deserialize a message.");
+    const char* data = payloads.data() + payloadOffset;
+    payloadOffset += size;
+    if (numTensors == kPickledMessage) {
+      messages.push_back(deserialize(type, data, size));
+      continue;
+    }
+    // The payload of a single message is received straight into its vector.
+    std::vector<char> payload;
+    if (count == 1) {
+      payload = std::move(payloads);
+    } else {
+      payload.assign(data, data + size);
+    }
+
+    std::vector<torch::Tensor> tensors;
+    tensors.reserve(numTensors);
+    for (int64_t i = 0; i < numTensors; i++) {
+      TORCH_CHECK(offset + 5 <= metaSize, "Failed to deserialize a message.");
+      const auto scalarType = static_cast<c10::ScalarType>(items[offset]);
+      const c10::Device device(
+          static_cast<c10::DeviceType>(items[offset + 1]),
+          static_cast<c10::DeviceIndex>(items[offset + 2]));
+      const bool requiresGrad = items[offset + 3];
+      const auto dim = items[offset + 4];
+      offset += 5;
+      TORCH_CHECK(
+          offset + dim <= metaSize, "Failed to deserialize a message.");
+      std::vector<int64_t> sizes(items + offset, items + offset + dim);
+      offset += dim;
+
+      auto tensor = torch::empty(sizes, {scalarType});
+      if (tensor.numel() > 0) {
+        recv(tensor);
+      }
+      if (!device.is_cpu()) {
+        tensor = tensor.to(device);
+      }
+      tensor.set_requires_grad(requiresGrad);
+      tensors.push_back(std::move(tensor));
+    }
+    messages.emplace_back(std::move(payload), std::move(tensors), type, id);
+  }
+  TORCH_CHECK(offset == metaSize, "Failed to deserialize a message.");
+
+  return messages;
 }
 
 void ProcessGroupAgent::enqueueRecv(RecvWork work) {
   threadPool_.run(std::bind(
       [&](RecvWork& work) {
-        torch::Tensor& payload = work.payload_;
-        Message message =
-            deserialize(work.type_, payload.storage().data(), payload.numel());
+        Message& message = work.message_;
         if (message.isRequest()) {
-          send(work.from_, cb_->operator()(message));
+          // The response may only be ready once other requests are processed,
+          // e.g. for the backward pass of distributed autograd, so it's sent
+          // from a callback instead of blocking this thread on it.
+          auto from = work.from_;
+          cb_->callAsync(message)->addCallback(
+              [this, from](const Message& response) {
+                send(from, Message(response));
+                recvCounts_.increment(from.id_);
+              });
+          return;
         } else if (message.isResponse()) {
           auto id = message.id();
           std::shared_ptr<FutureMessage> fm = nullptr;
@@ -455,18 +676,22 @@ void ProcessGroupAgent::enqueueRecv(RecvWork work) {
       std::move(work)));
 }
 
-void ProcessGroupAgent::listenLoop() {
+void ProcessGroupAgent::listenLoop(int index) {
+  // This thread receives the messages of the peers whose rank is `index`
+  // modulo the number of listener threads, all on the same tag.
+  const auto tag = pg_->getRank() * numListenerThreads_ + index;
   while (true) {
-    // rank, tensor size, message type
-    std::vector<torch::Tensor> preamble = {torch::empty({3}, {torch::kInt64})};
-    pg_->recvAnysource(preamble, pg_->getRank())->wait();
+    // rank, number of messages, metadata size, payload size
+    std::vector<torch::Tensor> preamble = {torch::empty({4}, {torch::kInt64})};
+    pg_->recvAnysource(preamble, tag)->wait();
     int64_t* preamble_items = preamble.front().storage().data<int64_t>();
 
     auto srcRank = preamble_items[0];
-    auto size = preamble_items[1];
-    MessageType type = MessageType(preamble_items[2]);
+    auto count = preamble_items[1];
+    auto metaSize = preamble_items[2];
+    auto payloadSize = preamble_items[3];
 
-    if (type == MessageType::SHUTDOWN) {
+    if (count == 0) {
       // FIXME: This LOG also prints warnings no InitGoogleLogging() was invoked
       // before logging, but it is not appropriate to call InitGoogleLogging()
       // here either.
@@ -475,10 +700,12 @@ void ProcessGroupAgent::listenLoop() {
       return;
     }
 
-    std::vector<torch::Tensor> tensors = {torch::empty({size}, {torch::kChar})};
-    pg_->recv(tensors, srcRank, pg_->getRank())->wait();
-
-    enqueueRecv(RecvWork(allWorkerInfo_[srcRank], type, std::move(tensors[0])));
+    // The rest of the messages is received before the next preamble, as the
+    // sends of another sender could otherwise be taken for one.
+    auto messages = recvMessages(srcRank, tag, count, metaSize, payloadSize);
+    for (auto& message : messages) {
+      enqueueRecv(RecvWork(allWorkerInfo_[srcRank], std::move(message)));
+    }
   }
 }
 
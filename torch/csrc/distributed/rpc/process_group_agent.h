@@ -7,6 +7,7 @@
 #include <torch/csrc/distributed/rpc/rpc_agent.h>
 
 #include <atomic>
+#include <deque>
 #include <thread>
 
 namespace torch {
@@ -18,8 +19,8 @@ struct ProcessGroupRpcAgentOptions : public RpcAgentOptions {
   int numSendRecvThreads;
 };
 
-// SendWork and RecvWork will be put into a task queue, and later picked up by
-// worker threads from the same ThreadPool.
+// SendWork is put into the send queue of its destination, and RecvWork into a
+// task queue, and later picked up by worker threads from the same ThreadPool.
 struct SendWork {
   SendWork(const WorkerInfo& to, Message&& message)
       : to_(to), message_(message) {}
@@ -28,15 +29,15 @@ struct SendWork {
   Message message_;
 };
 
-// SendWork wraps a Message and RecvWork wraps a Tensor. The difference here is
-// to allow us to run serialization/deserialization in the worker threads.
+// RecvWork wraps a received Message, for the worker threads to process. The
+// tensors of the message are received directly into their own storages by the
+// listen loop (see Note [Message Wire Format]).
 struct RecvWork {
-  RecvWork(const WorkerInfo& from, MessageType type, torch::Tensor&& payload)
-      : from_(from), type_(type), payload_(payload) {}
+  RecvWork(const WorkerInfo& from, Message&& message)
+      : from_(from), message_(std::move(message)) {}
 
   const WorkerInfo& from_;
-  const MessageType type_;
-  torch::Tensor payload_;
+  Message message_;
 };
 
 class ProcessGroupAgent : public RpcAgent {
@@ -96,13 +97,49 @@ class ProcessGroupAgent : public RpcAgent {
     FutureInfo() {}
   };
 
+  // Note [Message Wire Format]
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~
+  //
+  // Messages are sent in batches, as a sequence of ProcessGroup sends, by the
+  // one task draining the send queue of their destination, so the sends of
+  // different batches aren't interleaved:
+  //   1. A preamble: the rank of the sender, the number of messages, and the
+  //      sizes of the metadata and of the payloads.
+  //   2. The metadata, an int64 tensor: for each message, its type, id,
+  //      payload size and number of tensors, and the dtype, device,
+  //      requires_grad and sizes of each tensor.
+  //   3. The payloads, one after the other.
+  //   4. The data of each tensor, straight from its own memory when it is a
+  //      contiguous CPU tensor, and received straight into a tensor allocated
+  //      with its dtype and sizes.
+  // Small messages are batched, up to 64KB, the others are sent on their own,
+  // with their payload sent straight from, and received straight into, their
+  // vector. Empty buffers are not sent. CUDA tensors go through host memory,
+  // since the ProcessGroup can't send device memory, and are moved back to
+  // their device on the receiver. Messages with tensors other than dense ones
+  // (the tensor count is then -1) are pickled into the payload with
+  // `torch::save`, tensors included. The tensors of a message don't share
+  // storage once received.
+  //
+  // Every sender uses the tag of one listener thread of the destination, by
+  // its rank, so that each thread receives whole batches from its own peers.
+  // A shutdown is a preamble with no messages, sent to every listener thread.
+  void drainSendQueue(int dst);
+  void sendMessages(int dst, const std::vector<Message>& messages);
+  std::vector<Message> recvMessages(
+      int src,
+      int tag,
+      int64_t count,
+      int64_t metaSize,
+      int64_t payloadSize);
+
   void collectNames();
   // put SendWork into a queue and notify the worker thread
   void enqueueSend(SendWork work);
   // put RecvWork into a queue and notify the worker thread
   void enqueueRecv(RecvWork work);
-  // receiving messages
-  void listenLoop();
+  // receiving messages from the peers of the listener thread `index`
+  void listenLoop(int index);
   // poll for timed out RPCs
   void pollTimedOutRPCs();
   // process timed out futures
@@ -159,10 +196,18 @@ class ProcessGroupAgent : public RpcAgent {
   MessageCounter recvCounts_;
 
   std::atomic<int64_t> nextId_;
-  // one mutex per ProcessGroup rank, as ProcessGroup::send is not thread-safe
-  // when using the same tag.
-  std::vector<std::mutex> sendMutexes_;
-  std::thread listenerThread_;
+  // The messages to send to a peer, drained in order by at most one task of
+  // the thread pool at a time, as ProcessGroup::send is not thread-safe when
+  // using the same tag.
+  struct SendQueue {
+    std::mutex mutex_;
+    std::deque<Message> messages_;
+    bool draining_ = false;
+  };
+  const int numListenerThreads_;
+  // one queue per ProcessGroup rank
+  std::vector<SendQueue> sendQueues_;
+  std::vector<std::thread> listenerThreads_;
   // A thread to poll existing futures and check for timed out ones.
   std::thread futureTimeoutThread_;
   // A threadPool that processing both SendWork and RecvWork. There are two
@@ -21,6 +21,13 @@ constexpr int TYPE_IDX = 1; // index of type (py::object or IValue)
 // NB: if more fields are added, make sure this field is also bumped
 constexpr int RREF_TUPLE_SIZE = 2;
 
+py::object toPyObject(IValue value) {
+  // acquiring GIL as torch::jit::toPyObject creates new py::object
+  // without grabbing the GIL.
+  AutoGIL ag;
+  return torch::jit::toPyObject(std::move(value));
+}
+
 } // namespace
 
 ///////////////////////////  PyRRef  //////////////////////////////////
@@ -45,26 +52,62 @@ WorkerInfo PyRRef::owner() const {
   return RRefContext::getInstance().agent()->getWorkerInfo(rref_->owner());
 }
 
-py::object PyRRef::toHere() {
+py::object PyRRef::toHere(bool cache) {
   if (rref_->isOwner()) {
     return localValue();
   } else {
     if (rref_->isPyObj()) {
       // UserRRef<py::object>::toHere() calls python_rpc_handler which acquires
       // GIL.
-      return std::static_pointer_cast<UserRRef<py::object>>(rref_)->toHere();
+      return std::static_pointer_cast<UserRRef<py::object>>(rref_)->toHere(
+          cache);
     } else {
-      IValue value =
-          std::static_pointer_cast<UserRRef<IValue>>(rref_)->toHere();
-
-      {
-        // acquiring GIL as torch::jit::toPyObject creates new py::object
-        // without grabbing the GIL.
-        AutoGIL ag;
-        return torch::jit::toPyObject(std::move(value));
+      return toPyObject(
+          std::static_pointer_cast<UserRRef<IValue>>(rref_)->toHere(cache));
+    }
+  }
+}
+
+std::vector<py::object> PyRRef::toHereMany(
+    const std::vector<PyRRef>& rrefs,
+    bool cache) {
+  // Send the requests for every value that isn't local or cached first.
+  std::vector<std::shared_ptr<FutureMessage>> futures(rrefs.size());
+  for (size_t i = 0; i < rrefs.size(); i++) {
+    const auto& rref = rrefs[i].rref_;
+    if (rref->isOwner()) {
+      continue;
+    }
+    if (rref->isPyObj()) {
+      auto userRRef = std::static_pointer_cast<UserRRef<py::object>>(rref);
+      if (!cache || !userRRef->hasCachedValue()) {
+        futures[i] = userRRef->fetchValue();
       }
+    } else {
+      auto userRRef = std::static_pointer_cast<UserRRef<IValue>>(rref);
+      if (!cache || !userRRef->hasCachedValue()) {
+        futures[i] = userRRef->fetchValue();
+      }
+    }
+  }
+
+  std::vector<py::object> values;
+  values.reserve(rrefs.size());
+  for (size_t i = 0; i < rrefs.size(); i++) {
+    const auto& rref = rrefs[i].rref_;
+    if (!futures[i]) {
+      values.push_back(PyRRef(rref).toHere(cache));
+    } else if (rref->isPyObj()) {
+      values.push_back(
+          std::static_pointer_cast<UserRRef<py::object>>(rref)
+              ->valueFromFetchResponse(futures[i]->wait(), cache));
+    } else {
+      values.push_back(toPyObject(
+          std::static_pointer_cast<UserRRef<IValue>>(rref)
+              ->valueFromFetchResponse(futures[i]->wait(), cache)));
     }
   }
+  return values;
 }
 
 py::object PyRRef::localValue() {
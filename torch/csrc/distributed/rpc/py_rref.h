@@ -18,11 +18,19 @@ class PyRRef {
 
   bool isOwner() const;
   WorkerInfo owner() const;
-  py::object toHere();
+  py::object toHere(bool cache = false);
   py::object localValue();
   py::tuple pickle() const;
   static PyRRef unpickle(const py::tuple& t);
 
+  // Same as calling ``toHere`` on every RRef, but all the fetch requests are
+  // sent before waiting on any of them, so that it takes one round trip
+  // instead of one per RRef, and the requests to the same owner are sent
+  // together by the agent.
+  static std::vector<py::object> toHereMany(
+      const std::vector<PyRRef>& rrefs,
+      bool cache = false);
+
  private:
   std::shared_ptr<RRef> rref_;
 };
@@ -59,6 +59,17 @@ std::shared_ptr<Operator> matchBuiltinOp(
       ") to a builtin operator");
 }
 
+Stack createStackForTorchscript(
+    const c10::QualifiedName& qualifiedName,
+    const py::args& args,
+    const py::kwargs& kwargs) {
+  const auto& fn = PythonRpcHandler::getInstance()
+                       .jitCompilationUnit()
+                       ->get_function(qualifiedName);
+  return torch::jit::createStackForSchema(
+      fn.getSchema(), args, kwargs, c10::nullopt);
+}
+
 void finishAcceptUserRRef(const Message& message) {
   RRefContext::handleException(message);
   auto rr = RemoteRet::fromMessage(message);
@@ -155,6 +166,24 @@ std::shared_ptr<FutureMessage> pyRpcBuiltin(
       agent, dst, std::move(*scriptCall).toMessage());
 }
 
+std::shared_ptr<FutureMessage> pyRpcTorchscript(
+    RpcAgent& agent,
+    const WorkerInfo& dst,
+    const std::string& qualifiedName,
+    const py::args& args,
+    const py::kwargs& kwargs) {
+  c10::QualifiedName name(qualifiedName);
+  auto stack = createStackForTorchscript(name, args, kwargs);
+  auto scriptCall = c10::guts::make_unique<ScriptCall>(name, std::move(stack));
+  // set forceGradRecording to true as even if the args does not contain any
+  // tensor, the return value might still contain tensors.
+  return sendMessageWithAutograd(
+      agent,
+      dst,
+      std::move(*scriptCall).toMessage(),
+      true /*forceGradRecording*/);
+}
+
 PyRRef pyRemoteBuiltin(
     RpcAgent& agent,
     const WorkerInfo& dst,
@@ -182,6 +211,36 @@ PyRRef pyRemoteBuiltin(
   return PyRRef(userRRef);
 }
 
+PyRRef pyRemoteTorchscript(
+    RpcAgent& agent,
+    const WorkerInfo& dst,
+    const std::string& qualifiedName,
+    const py::args& args,
+    const py::kwargs& kwargs) {
+  c10::QualifiedName name(qualifiedName);
+  auto stack = createStackForTorchscript(name, args, kwargs);
+
+  auto& ctx = RRefContext::getInstance();
+  // TODO: support creating RRefs on a local object.
+  TORCH_INTERNAL_ASSERT(
+      ctx.getWorkerId() != dst.id_,
+      "Does not support creating RRef on self yet.");
+  auto userRRef = ctx.createUserRRef<IValue>(dst.id_);
+
+  auto scriptRemoteCall = c10::guts::make_unique<ScriptRemoteCall>(
+      name, std::move(stack), userRRef->rrefId(), userRRef->forkId());
+
+  auto fm = sendMessageWithAutograd(
+      agent,
+      dst,
+      std::move(*scriptRemoteCall).toMessage(),
+      true /*forceGradRecording*/);
+
+  ctx.addPendingUser(userRRef->forkId(), userRRef);
+  fm->addCallback(finishAcceptUserRRef);
+  return PyRRef(userRRef);
+}
+
 std::shared_ptr<FutureMessage> pyRpcPythonUdf(
     RpcAgent& agent,
     const WorkerInfo& dst,
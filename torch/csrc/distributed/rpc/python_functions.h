@@ -24,6 +24,15 @@ std::shared_ptr<FutureMessage> pyRpcPythonUdf(
     std::string& pickledPythonUDF,
     std::vector<torch::Tensor>& tensors);
 
+// Calls the TorchScript function ``qualifiedName``, scripted on both the caller
+// and the callee.
+std::shared_ptr<FutureMessage> pyRpcTorchscript(
+    RpcAgent& agent,
+    const WorkerInfo& dst,
+    const std::string& qualifiedName,
+    const py::args& args,
+    const py::kwargs& kwargs);
+
 PyRRef pyRemoteBuiltin(
     RpcAgent& agent,
     const WorkerInfo& dst,
@@ -31,6 +40,13 @@ PyRRef pyRemoteBuiltin(
     const py::args& args,
     const py::kwargs& kwargs);
 
+PyRRef pyRemoteTorchscript(
+    RpcAgent& agent,
+    const WorkerInfo& dst,
+    const std::string& qualifiedName,
+    const py::args& args,
+    const py::kwargs& kwargs);
+
 PyRRef pyRemotePythonUdf(
     RpcAgent& agent,
     const WorkerInfo& dst,
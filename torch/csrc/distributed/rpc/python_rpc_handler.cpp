@@ -1,4 +1,5 @@
 #include <torch/csrc/distributed/rpc/python_rpc_handler.h>
+#include <torch/csrc/jit/pybind_utils.h>
 
 namespace torch {
 namespace distributed {
@@ -25,6 +26,7 @@ PythonRpcHandler::PythonRpcHandler() {
   pyLoadReturnValue_ = getFunction(module, "_load_return_value");
   pySerialize_ = getFunction(module, "serialize");
   pyHandleException_ = getFunction(module, "_handle_exception");
+  jitCompilationUnit_ = torch::jit::get_python_cu();
 }
 
 void PythonRpcHandler::cleanup() {
@@ -33,6 +35,14 @@ void PythonRpcHandler::cleanup() {
   pyLoadReturnValue_ = py::none();
   pySerialize_ = py::none();
   pyHandleException_ = py::none();
+  jitCompilationUnit_ = nullptr;
+}
+
+std::shared_ptr<torch::jit::script::CompilationUnit> PythonRpcHandler::
+    jitCompilationUnit() {
+  TORCH_CHECK(
+      jitCompilationUnit_, "The Python RPC handler has been cleaned up.");
+  return jitCompilationUnit_;
 }
 
 PythonRpcHandler& PythonRpcHandler::getInstance() {
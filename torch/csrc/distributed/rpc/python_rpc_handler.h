@@ -2,6 +2,7 @@
 
 #include <torch/csrc/distributed/rpc/message.h>
 #include <torch/csrc/distributed/rpc/types.h>
+#include <torch/csrc/jit/script/compilation_unit.h>
 #include <torch/csrc/utils/pybind.h>
 
 namespace torch {
@@ -42,6 +43,10 @@ class PYBIND11_EXPORT PythonRpcHandler {
   // Check if obj is RemoteException, then throw it
   void handleException(const py::object& obj);
 
+  // The compilation unit of the TorchScript functions scripted from Python,
+  // which can be used without GIL.
+  std::shared_ptr<torch::jit::script::CompilationUnit> jitCompilationUnit();
+
   // Explicitly clean up py::objects to avoid segment faults when
   // py::objects with CPython are cleaned up later at program exit
   // See similar issues reported https://github.com/pybind/pybind11/issues/1598
@@ -77,6 +82,9 @@ class PYBIND11_EXPORT PythonRpcHandler {
 
   // Ref to 'torch.distributed.rpc.internal._handle_exception'
   py::object pyHandleException_;
+
+  // Ref to `torch.jit._python_cu`.
+  std::shared_ptr<torch::jit::script::CompilationUnit> jitCompilationUnit_;
 };
 
 } // namespace rpc
@@ -41,6 +41,27 @@ Message RequestCallback::operator()(Message& request) const {
   }
 }
 
+std::shared_ptr<FutureMessage> RequestCallback::callAsync(
+    Message& request) const {
+  ClearAutogradContextGuard guard;
+  try {
+    return processMessageAsync(request);
+  } catch (std::exception& e) {
+    LOG(ERROR) << "Received error while processing request type "
+               << request.type() << ": " << e.what();
+    auto future = std::make_shared<FutureMessage>();
+    future->markCompleted(createExceptionResponse(request, e));
+    return future;
+  }
+}
+
+std::shared_ptr<FutureMessage> RequestCallback::processMessageAsync(
+    Message& request) const {
+  auto future = std::make_shared<FutureMessage>();
+  future->markCompleted(processMessage(request));
+  return future;
+}
+
 } // namespace rpc
 } // namespace distributed
 } // namespace torch
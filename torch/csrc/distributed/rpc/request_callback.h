@@ -1,5 +1,6 @@
 #pragma once
 
+#include <torch/csrc/distributed/rpc/future_message.h>
 #include <torch/csrc/distributed/rpc/message.h>
 
 namespace torch {
@@ -14,6 +15,11 @@ class TORCH_API RequestCallback {
   // Invoke the callback.
   Message operator()(Message& request) const;
 
+  // Invoke the callback without waiting for the requests that complete
+  // asynchronously (see ``processMessageAsync``). The returned future holds
+  // the response.
+  std::shared_ptr<FutureMessage> callAsync(Message& request) const;
+
   virtual ~RequestCallback() {}
 
  protected:
@@ -25,6 +31,13 @@ class TORCH_API RequestCallback {
   // to ensure delivery of the response/exception based on their implementation
   // specific mechanisms.
   virtual Message processMessage(Message& request) const = 0;
+
+  // Same as ``processMessage``, for RpcAgent implementations that can send a
+  // response once it's ready instead of blocking the thread that processes
+  // the request on it. The default completes the future with the response of
+  // ``processMessage``.
+  virtual std::shared_ptr<FutureMessage> processMessageAsync(
+      Message& request) const;
 };
 
 } // namespace rpc
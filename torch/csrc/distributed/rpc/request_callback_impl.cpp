@@ -29,6 +29,33 @@ namespace rpc {
 
 using namespace torch::distributed::autograd;
 
+namespace {
+
+// Runs the builtin operator or the TorchScript function of a ScriptCall, and
+// returns its result.
+IValue runScriptCall(ScriptCall& scriptCall) {
+  // Use a reference to the stack to avoid copying it.
+  auto& stack = scriptCall.stackRef();
+  if (scriptCall.hasOp()) {
+    scriptCall.op()->getOperation()(stack);
+  } else {
+    PythonRpcHandler::getInstance()
+        .jitCompilationUnit()
+        ->get_function(scriptCall.qualifiedName())
+        .run(stack);
+  }
+
+  TORCH_INTERNAL_ASSERT(
+      stack.size() == 1,
+      "Return value of a builtin operator or a "
+      "TorchScript function should be a single IValue, got a vector of "
+      "size ",
+      stack.size());
+  return std::move(stack.front());
+}
+
+} // namespace
+
 Message RequestCallbackImpl::processRpc(
     RpcCommandBase& rpc,
     MessageType messageType) const {
@@ -41,19 +68,7 @@ Message RequestCallbackImpl::processRpc(
   switch (messageType) {
     case MessageType::SCRIPT_CALL: {
       auto& scriptCall = static_cast<ScriptCall&>(rpc);
-
-      // sc is only alive within this block, use reference to avoid copy
-      auto& stack = scriptCall.stackRef();
-      scriptCall.op()->getOperation()(stack);
-
-      TORCH_INTERNAL_ASSERT(
-          stack.size() == 1,
-          "Return value of a builtin operator or a "
-          "TorchScript function should be a single IValue, got a vector of "
-          "size ",
-          stack.size());
-
-      return std::move(ScriptResp(std::move(stack.front()))).toMessage();
+      return std::move(ScriptResp(runScriptCall(scriptCall))).toMessage();
     }
     case MessageType::PYTHON_CALL: {
       auto& pyCall = static_cast<PythonCall&>(rpc);
@@ -71,17 +86,7 @@ Message RequestCallbackImpl::processRpc(
       auto ownerRRef = ctx.getOrCreateOwnerRRef<IValue>(src.retRRefId());
 
       // TODO: make this asynchronous
-      // src is only alive within this block, use reference to avoid copy
-      auto& stack = src.stackRef();
-      src.op()->getOperation()(stack);
-      TORCH_INTERNAL_ASSERT(
-          stack.size() == 1,
-          "Return value of a builtin operator or a "
-          "TorchScript function should be a single IValue, got a vector of "
-          "size ",
-          stack.size());
-
-      ownerRRef->setValue(std::move(stack.front()));
+      ownerRRef->setValue(runScriptCall(src));
       ctx.addForkOfOwner(src.retRRefId(), src.retForkId());
       return RemoteRet(src.retRRefId(), src.retForkId()).toMessage();
     }
@@ -176,27 +181,7 @@ Message RequestCallbackImpl::processRpc(
           MessageType::FORWARD_AUTOGRAD_RESP);
     }
     case MessageType::BACKWARD_AUTOGRAD_REQ: {
-      auto& gradientsCall = static_cast<PropagateGradientsReq&>(rpc);
-      const auto& autogradMetadata = gradientsCall.getAutogradMetadata();
-
-      // Retrieve the appropriate autograd context.
-      auto autogradContext =
-          DistAutogradContainer::getInstance().retrieveContext(
-              autogradMetadata.autogradContextId);
-
-      // Lookup the appropriate 'send' function to enqueue.
-      std::shared_ptr<SendRpcBackward> sendFunction =
-          autogradContext->retrieveSendFunction(
-              autogradMetadata.autogradMessageId);
-
-      // Attach the gradients to the send function.
-      sendFunction->setGrads(gradientsCall.getGrads());
-
-      // Now execute the autograd graph using the "distributed engine."
-      DistEngine::getInstance().executeSendFunction(
-          autogradContext, sendFunction);
-
-      return std::move(PropagateGradientsResp()).toMessage();
+      return processBackwardAutogradReq(rpc)->wait();
     }
     case MessageType::CLEANUP_AUTOGRAD_CONTEXT_REQ: {
       auto& cleanupContextReq = static_cast<CleanupAutogradContextReq&>(rpc);
@@ -216,6 +201,27 @@ Message RequestCallbackImpl::processRpc(
   }
 }
 
+std::shared_ptr<FutureMessage> RequestCallbackImpl::processBackwardAutogradReq(
+    RpcCommandBase& rpc) const {
+  auto& gradientsCall = static_cast<PropagateGradientsReq&>(rpc);
+  const auto& autogradMetadata = gradientsCall.getAutogradMetadata();
+
+  // Retrieve the appropriate autograd context.
+  auto autogradContext = DistAutogradContainer::getInstance().retrieveContext(
+      autogradMetadata.autogradContextId);
+
+  // Lookup the appropriate 'send' function to enqueue.
+  std::shared_ptr<SendRpcBackward> sendFunction =
+      autogradContext->retrieveSendFunction(autogradMetadata.autogradMessageId);
+
+  // Attach the gradients to the send function.
+  sendFunction->setGrads(gradientsCall.getGrads());
+
+  // Now execute the autograd graph using the "distributed engine."
+  return DistEngine::getInstance().executeSendFunctionAsync(
+      autogradContext, sendFunction);
+}
+
 Message RequestCallbackImpl::processMessage(Message& request) const {
   std::unique_ptr<RpcCommandBase> rpc = deserializeRequest(request);
   auto responseMessage = processRpc(*rpc, request.type());
@@ -223,6 +229,23 @@ Message RequestCallbackImpl::processMessage(Message& request) const {
   return responseMessage;
 }
 
+std::shared_ptr<FutureMessage> RequestCallbackImpl::processMessageAsync(
+    Message& request) const {
+  if (request.type() != MessageType::BACKWARD_AUTOGRAD_REQ) {
+    return RequestCallback::processMessageAsync(request);
+  }
+  std::unique_ptr<RpcCommandBase> rpc = deserializeRequest(request);
+  auto id = request.id();
+  auto backwardFuture = processBackwardAutogradReq(*rpc);
+  auto responseFuture = std::make_shared<FutureMessage>();
+  backwardFuture->addCallback([responseFuture, id](const Message& message) {
+    Message response = message;
+    response.setId(id);
+    responseFuture->markCompleted(std::move(response));
+  });
+  return responseFuture;
+}
+
 } // namespace rpc
 } // namespace distributed
 } // namespace torch
@@ -12,8 +12,15 @@ class TORCH_API RequestCallbackImpl : public RequestCallback {
  public:
   Message processMessage(Message& request) const override;
 
+  // Doesn't wait for the backward pass kicked off by BACKWARD_AUTOGRAD_REQ.
+  std::shared_ptr<FutureMessage> processMessageAsync(
+      Message& request) const override;
+
  private:
   Message processRpc(RpcCommandBase& rpc, MessageType messageType) const;
+
+  std::shared_ptr<FutureMessage> processBackwardAutogradReq(
+      RpcCommandBase& rpc) const;
 };
 
 } // namespace rpc
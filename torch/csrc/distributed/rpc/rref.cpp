@@ -1,5 +1,6 @@
 #include <torch/csrc/distributed/rpc/rref.h>
 
+#include <torch/csrc/distributed/autograd/context/container.h>
 #include <torch/csrc/distributed/autograd/rpc_messages/rpc_with_autograd.h>
 #include <torch/csrc/distributed/autograd/utils.h>
 #include <torch/csrc/distributed/rpc/python_rpc_handler.h>
@@ -43,6 +44,11 @@ T& unwrapAutogradMessage(
   }
 }
 
+// See UserRRef::toHere.
+bool canCacheValue() {
+  return !autograd::DistAutogradContainer::getInstance().hasValidContext();
+}
+
 } // namespace
 
 std::atomic<local_id_t> RRefContext::nextLocalId_{0};
@@ -146,6 +152,11 @@ UserRRef<T>::~UserRRef() {
     fm->addCallback(
         [](const Message& message) { RRefContext::handleException(message); });
   }
+  if (std::is_same<T, py::object>::value && cachedValue_.has_value()) {
+    // Releasing a py::object requires GIL.
+    AutoGIL ag;
+    cachedValue_.reset();
+  }
 }
 
 template <typename T>
@@ -154,44 +165,104 @@ const ForkId& UserRRef<T>::forkId() const {
 }
 
 template <>
-IValue UserRRef<IValue>::toHere() {
+std::shared_ptr<FutureMessage> UserRRef<IValue>::fetchValue() const {
   auto agent = RpcAgent::getDefaultRpcAgent();
 
   // ScriptRRefFetchCall message always carries autograd context id even if
   // the message itself does not contain any tensor, because the response would
   // potentially contain tensors.
-  auto futureResponse = autograd::sendMessageWithAutograd(
+  return autograd::sendMessageWithAutograd(
       *agent,
       agent->getWorkerInfo(ownerId_),
       ScriptRRefFetchCall(ownerId_, rrefId()).toMessage(),
       true /* forceGradRecording */);
-
-  const Message& message = futureResponse->wait();
-  RRefContext::handleException(message);
-  auto response = deserializeResponse(message);
-  auto& rfr = unwrapAutogradMessage<ScriptRRefFetchRet>(message, response);
-  return rfr.values().front();
 }
 
 template <>
-py::object UserRRef<py::object>::toHere() {
+std::shared_ptr<FutureMessage> UserRRef<py::object>::fetchValue() const {
   auto agent = RpcAgent::getDefaultRpcAgent();
 
   // PythonRRefFetchCall message always carries autograd context id even if
   // the message itself does not contain any tensor, because the response would
   // potentially contain tensors.
-  auto futureResponse = autograd::sendMessageWithAutograd(
+  return autograd::sendMessageWithAutograd(
       *agent,
       agent->getWorkerInfo(ownerId_),
       PythonRRefFetchCall(ownerId_, rrefId()).toMessage(),
       true /* forceGradRecording */);
+}
+
+template <>
+IValue UserRRef<IValue>::valueFromFetchResponse(
+    const Message& message,
+    bool cache) {
+  RRefContext::handleException(message);
+  auto response = deserializeResponse(message);
+  auto& rfr = unwrapAutogradMessage<ScriptRRefFetchRet>(message, response);
+  auto value = rfr.values().front();
+  if (cache && canCacheValue()) {
+    std::lock_guard<std::mutex> lock(cacheMutex_);
+    cachedValue_ = value;
+  }
+  return value;
+}
 
-  const Message& message = futureResponse->wait();
+template <>
+py::object UserRRef<py::object>::valueFromFetchResponse(
+    const Message& message,
+    bool cache) {
   RRefContext::handleException(message);
   auto response = deserializeResponse(message);
   auto& rfr = unwrapAutogradMessage<PythonRRefFetchRet>(message, response);
-  return PythonRpcHandler::getInstance().deserialize(
+  auto value = PythonRpcHandler::getInstance().deserialize(
       SerializedPyObj::fromIValues(rfr.values()));
+  if (cache && canCacheValue()) {
+    // Copying a py::object requires GIL.
+    AutoGIL ag;
+    std::lock_guard<std::mutex> lock(cacheMutex_);
+    cachedValue_ = value;
+  }
+  return value;
+}
+
+template <>
+c10::optional<IValue> UserRRef<IValue>::cachedValue() const {
+  if (!canCacheValue()) {
+    return c10::nullopt;
+  }
+  std::lock_guard<std::mutex> lock(cacheMutex_);
+  return cachedValue_;
+}
+
+template <>
+c10::optional<py::object> UserRRef<py::object>::cachedValue() const {
+  if (!canCacheValue()) {
+    return c10::nullopt;
+  }
+  // Copying a py::object requires GIL.
+  AutoGIL ag;
+  std::lock_guard<std::mutex> lock(cacheMutex_);
+  return cachedValue_;
+}
+
+template <typename T>
+bool UserRRef<T>::hasCachedValue() const {
+  if (!canCacheValue()) {
+    return false;
+  }
+  std::lock_guard<std::mutex> lock(cacheMutex_);
+  return cachedValue_.has_value();
+}
+
+template <typename T>
+T UserRRef<T>::toHere(bool cache) {
+  if (cache) {
+    auto value = cachedValue();
+    if (value.has_value()) {
+      return std::move(value.value());
+    }
+  }
+  return valueFromFetchResponse(fetchValue()->wait(), cache);
 }
 
 template class UserRRef<IValue>;
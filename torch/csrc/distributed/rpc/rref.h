@@ -249,8 +249,21 @@ class UserRRef final : public RRef {
   const ForkId& forkId() const;
 
   // Get of copy of the value from the ``OwnerRRef``. If the value is not ready
-  // yet, this call will block.
-  T toHere();
+  // yet, this call will block. With ``cache``, the copy is kept and returned
+  // by later calls with ``cache`` instead of fetching it again, which assumes
+  // that the owner doesn't modify the value. The cache is ignored in a
+  // distributed autograd context, so that every copy is recorded in the graph.
+  T toHere(bool cache = false);
+
+  // The two halves of ``toHere``, to fetch several values at once:
+  // ``fetchValue`` sends the fetch request to the owner, and the value is then
+  // retrieved from its response with ``valueFromFetchResponse``.
+  std::shared_ptr<FutureMessage> fetchValue() const;
+  T valueFromFetchResponse(const Message& message, bool cache);
+
+  // Returns the cached copy of the value, if any, see ``toHere``.
+  c10::optional<T> cachedValue() const;
+  bool hasCachedValue() const;
 
   // Upon destruction, this ``UserRRef`` will tell the owner to deref.
   ~UserRRef() override;
@@ -261,6 +274,9 @@ class UserRRef final : public RRef {
   UserRRef(worker_id_t ownerId, const RRefId& rrefId, const ForkId& forkId);
 
   const ForkId forkId_;
+
+  c10::optional<T> cachedValue_;
+  mutable std::mutex cacheMutex_;
 };
 
 // Keep the template only on the derived class because ``RRefContext`` needs to
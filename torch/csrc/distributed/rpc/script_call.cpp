@@ -13,10 +13,27 @@ ScriptCall::ScriptCall(
     std::vector<at::IValue>&& args)
     : op_(std::move(op)), stack_(args) {}
 
+ScriptCall::ScriptCall(
+    const c10::QualifiedName& qualifiedName,
+    std::vector<at::IValue>&& args)
+    : qualifiedName_(qualifiedName), stack_(args) {}
+
+bool ScriptCall::hasOp() const {
+  return op_ ? true : false;
+}
+
 std::shared_ptr<Operator> ScriptCall::op() const {
   return *op_;
 }
 
+bool ScriptCall::hasQualifiedName() const {
+  return qualifiedName_ ? true : false;
+}
+
+const c10::QualifiedName& ScriptCall::qualifiedName() const {
+  return *qualifiedName_;
+}
+
 const std::vector<at::IValue>& ScriptCall::stack() const {
   return stack_;
 }
@@ -44,23 +61,26 @@ void ScriptCall::toIValues(std::vector<at::IValue>& ivalues) const {
     // aten::add -> torch.ops.aten.add
     opName.replace(0, ATEN_PREFIX_.length(), BUILTIN_OP_NAMESPACE_);
     ivalues.emplace_back(std::move(opName));
+  } else if (qualifiedName_) {
+    ivalues.emplace_back(qualifiedName_->qualifiedName());
   }
 }
 
-std::shared_ptr<Operator> ScriptCall::fromIValues(
-    std::vector<at::IValue>& ivalues) {
-  const std::string& qualifiedName = ivalues.back().toStringRef();
+std::pair<std::shared_ptr<Operator>, c10::optional<c10::QualifiedName>>
+ScriptCall::fromIValues(std::vector<at::IValue>& ivalues) {
+  // Copy it since the IValue is popped below.
+  const std::string qualifiedName = ivalues.back().toStringRef();
+  ivalues.pop_back();
 
   if (qualifiedName.rfind(BUILTIN_OP_NAMESPACE_) == 0) {
-    ivalues.pop_back();
     const std::string& str_schema = ivalues.back().toStringRef();
     auto op = matchOperator(str_schema);
 
     ivalues.pop_back();
     // remove str_schema from ivalues
-    return op;
+    return {op, c10::nullopt};
   } else {
-    AT_ERROR("Unrecognized qualified name ", qualifiedName);
+    return {nullptr, c10::QualifiedName(qualifiedName)};
   }
 }
 
@@ -83,8 +103,13 @@ std::unique_ptr<ScriptCall> ScriptCall::fromMessage(const Message& message) {
       jit::unpickle(payload, payload_size, nullptr, &message.tensors());
 
   auto values = value.toTuple()->elements();
-  auto op = fromIValues(values);
-  return c10::guts::make_unique<ScriptCall>(op, std::move(values));
+  auto callee = fromIValues(values);
+  if (callee.first) {
+    return c10::guts::make_unique<ScriptCall>(callee.first, std::move(values));
+  } else {
+    return c10::guts::make_unique<ScriptCall>(
+        *callee.second, std::move(values));
+  }
 }
 
 std::shared_ptr<Operator> ScriptCall::matchOperator(
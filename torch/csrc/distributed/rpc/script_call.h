@@ -1,5 +1,6 @@
 #pragma once
 
+#include <ATen/core/qualified_name.h>
 #include <c10/util/Optional.h>
 #include <torch/csrc/distributed/rpc/message.h>
 #include <torch/csrc/distributed/rpc/rpc_command_base.h>
@@ -13,14 +14,23 @@ namespace rpc {
 
 using torch::jit::Operator;
 
-// A ScriptCall instance represents an invocation of a builtin operator for a
-// TorchScript function (not implemented yet). If it is a builtin operator, it
-// contains a shared ptr to the `Operator` and a list of arguments.
+// A ScriptCall instance represents an invocation of a builtin operator or of a
+// TorchScript function. If it is a builtin operator, it contains a shared ptr
+// to the `Operator` and a list of arguments. If it is a TorchScript function,
+// it contains its qualified name, which the callee looks up in the Python
+// compilation unit, i.e. the function must have been scripted there too.
+// Either way, the callee runs it without GIL.
 class TORCH_API ScriptCall : public RpcCommandBase {
  public:
   ScriptCall(std::shared_ptr<Operator> op, std::vector<at::IValue>&& args);
+  ScriptCall(
+      const c10::QualifiedName& qualifiedName,
+      std::vector<at::IValue>&& args);
 
+  bool hasOp() const;
   std::shared_ptr<Operator> op() const;
+  bool hasQualifiedName() const;
+  const c10::QualifiedName& qualifiedName() const;
   // return the argument stack of this builtin operator
   const std::vector<at::IValue>& stack() const;
   std::vector<at::IValue>& stackRef();
@@ -32,8 +42,10 @@ class TORCH_API ScriptCall : public RpcCommandBase {
 
  protected:
   virtual void toIValues(std::vector<at::IValue>& ivalues) const;
-  static std::shared_ptr<Operator> fromIValues(
-      std::vector<at::IValue>& ivalues);
+  // Pops the operator, or else the qualified name of the TorchScript function,
+  // off the back of ``ivalues``.
+  static std::pair<std::shared_ptr<Operator>, c10::optional<c10::QualifiedName>>
+  fromIValues(std::vector<at::IValue>& ivalues);
 
  private:
   // Given an operator symbol and a string schema, return the matched operator.
@@ -45,6 +57,9 @@ class TORCH_API ScriptCall : public RpcCommandBase {
   // This field has value if this ScriptCall represents invocation of a builtin
   // operator.
   c10::optional<std::shared_ptr<Operator>> op_;
+  // This field has value if this ScriptCall represents invocation of a
+  // TorchScript function.
+  c10::optional<c10::QualifiedName> qualifiedName_;
   std::vector<at::IValue> stack_;
 };
 
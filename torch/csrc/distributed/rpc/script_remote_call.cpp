@@ -16,6 +16,15 @@ ScriptRemoteCall::ScriptRemoteCall(
       retRRefId_(retRRefId),
       retForkId_(retForkId) {}
 
+ScriptRemoteCall::ScriptRemoteCall(
+    const c10::QualifiedName& qualifiedName,
+    std::vector<at::IValue>&& args,
+    const RRefId& retRRefId,
+    const ForkId& retForkId)
+    : ScriptCall(qualifiedName, std::move(args)),
+      retRRefId_(retRRefId),
+      retForkId_(retForkId) {}
+
 Message ScriptRemoteCall::toMessage() && {
   std::vector<IValue> ivalues;
   ScriptCall::toIValues(ivalues);
@@ -47,9 +56,20 @@ std::unique_ptr<ScriptRemoteCall> ScriptRemoteCall::fromMessage(
   auto retRRefId = ForkId::fromIValue(values.back());
   values.pop_back();
 
-  auto op = ScriptCall::fromIValues(values);
-  return c10::guts::make_unique<ScriptRemoteCall>(
-      op, std::move(values), std::move(retRRefId), std::move(retForkId));
+  auto callee = ScriptCall::fromIValues(values);
+  if (callee.first) {
+    return c10::guts::make_unique<ScriptRemoteCall>(
+        callee.first,
+        std::move(values),
+        std::move(retRRefId),
+        std::move(retForkId));
+  } else {
+    return c10::guts::make_unique<ScriptRemoteCall>(
+        *callee.second,
+        std::move(values),
+        std::move(retRRefId),
+        std::move(retForkId));
+  }
 }
 
 } // namespace rpc
@@ -13,7 +13,8 @@ namespace rpc {
 using torch::jit::Operator;
 
 // A ScriptRemoteCall instance represents an invocation of `dist.remote` on a
-// builtin operator. Currently, it does not support using RRef as arguments yet.
+// builtin operator or a TorchScript function. Currently, it does not support
+// using RRef as arguments yet.
 // Besides the operator and a vector of arguments, ScriptRemoteCall also
 // caontains the RRefId and the ForkId of the return value RRef.
 class TORCH_API ScriptRemoteCall final : public ScriptCall {
@@ -24,6 +25,12 @@ class TORCH_API ScriptRemoteCall final : public ScriptCall {
       const RRefId& retRRefId,
       const ForkId& retForkId);
 
+  ScriptRemoteCall(
+      const c10::QualifiedName& qualifiedName,
+      std::vector<at::IValue>&& args,
+      const RRefId& retRRefId,
+      const ForkId& retForkId);
+
   inline const RRefId& retRRefId() const {
     return retRRefId_;
   }
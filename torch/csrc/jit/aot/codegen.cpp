@@ -0,0 +1,896 @@
+#include <torch/csrc/jit/aot/codegen.h>
+
+#include <torch/csrc/jit/code_template.h>
+#include <torch/csrc/jit/constants.h>
+#include <torch/csrc/jit/graph_executor_impl.h>
+#include <torch/csrc/jit/passes/constant_propagation.h>
+#include <torch/csrc/jit/passes/dead_code_elimination.h>
+#include <torch/csrc/jit/passes/fold_batch_norm.h>
+#include <torch/csrc/jit/passes/freeze_module.h>
+#include <torch/csrc/jit/passes/inline_fork_wait.h>
+#include <torch/csrc/jit/passes/inliner.h>
+#include <torch/csrc/jit/passes/lower_tuples.h>
+#include <torch/csrc/jit/passes/peephole.h>
+
+#include <c10/util/StringUtil.h>
+
+#include <cctype>
+#include <cmath>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace torch {
+namespace jit {
+namespace aot {
+
+namespace {
+
+auto library_template = CodeTemplate(R"(
+// Generated by torch.jit.aot, do not edit
+#include <ATen/ATen.h>
+#include <ATen/ScalarOps.h>
+#include <c10/macros/Export.h>
+#include <c10/util/Optional.h>
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+template <typename T>
+T torch_aot_enum(int64_t value) {
+  return static_cast<T>(value);
+}
+
+template <typename T>
+c10::optional<T> torch_aot_enum(c10::optional<int64_t> value) {
+  if (!value) {
+    return c10::nullopt;
+  }
+  return static_cast<T>(*value);
+}
+
+at::TensorOptions torch_aot_options(
+    c10::optional<int64_t> dtype,
+    c10::optional<int64_t> layout,
+    c10::optional<at::Device> device,
+    c10::optional<bool> pin_memory) {
+  return at::TensorOptions()
+      .dtype(torch_aot_enum<at::ScalarType>(dtype))
+      .layout(torch_aot_enum<at::Layout>(layout))
+      .device(device)
+      .pinned_memory(pin_memory);
+}
+
+template <size_t N>
+std::array<bool, N> torch_aot_bools(const std::vector<bool>& list) {
+  TORCH_CHECK(list.size() == N, "expected a list of ", N, " bools");
+  std::array<bool, N> result;
+  for (size_t i = 0; i < N; ++i) {
+    result[i] = list[i];
+  }
+  return result;
+}
+
+template <typename T>
+T torch_aot_getitem(const std::vector<T>& list, int64_t index) {
+  const int64_t size = list.size();
+  if (index < 0) {
+    index += size;
+  }
+  TORCH_CHECK(index >= 0 && index < size, "list index out of range");
+  return list[index];
+}
+
+// Python's // and %, which round towards negative infinity
+int64_t torch_aot_floordiv(int64_t a, int64_t b) {
+  TORCH_CHECK(b != 0, "ZeroDivisionError: integer division by zero");
+  int64_t quotient = a / b;
+  if (a % b != 0 && ((a < 0) != (b < 0))) {
+    --quotient;
+  }
+  return quotient;
+}
+
+double torch_aot_floordiv(double a, double b) {
+  return std::floor(a / b);
+}
+
+int64_t torch_aot_remainder(int64_t a, int64_t b) {
+  TORCH_CHECK(b != 0, "ZeroDivisionError: integer modulo by zero");
+  return a - b * torch_aot_floordiv(a, b);
+}
+
+double torch_aot_remainder(double a, double b) {
+  return a - b * std::floor(a / b);
+}
+
+} // namespace
+
+extern "C" C10_EXPORT void* torch_aot_load(const char* weights, size_t size) {
+  TORCH_CHECK(
+      size == ${weights_size},
+      "torch_aot_load: expected ${weights_size} bytes of weights, got ",
+      size);
+  auto constants = new std::vector<at::Tensor>();
+  constants->reserve(${num_constants});
+  ${load_constants}
+  return constants;
+}
+
+extern "C" C10_EXPORT void torch_aot_free(void* state) {
+  delete static_cast<std::vector<at::Tensor>*>(state);
+}
+
+extern "C" C10_EXPORT void torch_aot_run(
+    void* state,
+    const std::vector<at::Tensor>* inputs,
+    std::vector<at::Tensor>* outputs) {
+  const auto& constants = *static_cast<std::vector<at::Tensor>*>(state);
+  (void)constants;
+  TORCH_CHECK(
+      inputs->size() == ${num_inputs},
+      "torch_aot_run: expected ${num_inputs} inputs, got ",
+      inputs->size());
+  ${body}
+}
+)");
+
+// The enums that the schemas type as ints, by argument name
+const std::unordered_map<std::string, std::string> enum_arguments = {
+    {"dtype", "at::ScalarType"},
+    {"layout", "at::Layout"},
+    {"memory_format", "at::MemoryFormat"},
+};
+
+// The arguments that the C++ API packs into a TensorOptions
+const std::vector<std::string> tensor_options_arguments = {
+    "dtype",
+    "layout",
+    "device",
+    "pin_memory"};
+
+// The ops with a native Tensor method but no at:: function
+const std::unordered_set<std::string> method_only_ops = {
+    "add_",         "addbmm_",      "addcdiv_",     "addcmul_",
+    "addmm_",       "addr_",        "atan2_",       "baddbmm_",
+    "bitwise_not_", "bitwise_xor_", "contiguous",   "copy_",
+    "digamma_",     "div_",         "eq_",          "erfinv_",
+    "expand",       "expand_as",    "fill_diagonal_", "fmod_",
+    "ge_",          "gt_",          "index_add_",   "index_copy_",
+    "index_fill_",  "item",         "le_",          "lerp_",
+    "lgamma_",      "logical_not_", "logical_xor_", "lt_",
+    "masked_fill_", "masked_scatter_", "mul_",      "mvlgamma_",
+    "narrow_copy",  "ne_",          "new_empty",    "new_full",
+    "new_zeros",    "permute",      "polygamma_",   "pow_",
+    "put_",         "remainder_",   "renorm_",      "repeat",
+    "reshape_as",   "resize_",      "scatter_",     "scatter_add_",
+    "sign_",        "squeeze_",     "sub_",         "sum_to_size",
+    "t_",           "to",           "transpose_",   "tril_",
+    "triu_",        "type_as",      "unfold",       "unsqueeze_",
+    "view",         "view_as",
+};
+
+// The ops on scalars that are operators in C++
+const std::unordered_map<std::string, std::string> scalar_binary_ops = {
+    {"add", "+"},
+    {"sub", "-"},
+    {"mul", "*"},
+    {"lt", "<"},
+    {"gt", ">"},
+    {"le", "<="},
+    {"ge", ">="},
+    {"eq", "=="},
+    {"ne", "!="},
+    {"__and__", "&"},
+    {"__or__", "|"},
+    {"__xor__", "^"},
+};
+
+bool isTensorLike(const TypePtr& type) {
+  if (auto optional_type = type->cast<OptionalType>()) {
+    return optional_type->getElementType()->isSubtypeOf(TensorType::get());
+  }
+  return type->isSubtypeOf(TensorType::get());
+}
+
+bool isScalar(const TypePtr& type) {
+  return type->kind() == TypeKind::IntType ||
+      type->kind() == TypeKind::FloatType ||
+      type->kind() == TypeKind::BoolType;
+}
+
+bool isNone(const Value* value) {
+  return value->type()->kind() == TypeKind::NoneType;
+}
+
+// Tensor? is an undefined tensor when it is None, as in the ATen API
+std::string cppType(const TypePtr& type) {
+  if (isTensorLike(type)) {
+    return "at::Tensor";
+  }
+  switch (type->kind()) {
+    case TypeKind::IntType:
+      return "int64_t";
+    case TypeKind::FloatType:
+      return "double";
+    case TypeKind::BoolType:
+      return "bool";
+    case TypeKind::NumberType:
+      return "at::Scalar";
+    case TypeKind::StringType:
+      return "std::string";
+    case TypeKind::DeviceObjType:
+      return "at::Device";
+    case TypeKind::OptionalType:
+      return "c10::optional<" +
+          cppType(type->expect<OptionalType>()->getElementType()) + ">";
+    case TypeKind::ListType:
+      return "std::vector<" +
+          cppType(type->expect<ListType>()->getElementType()) + ">";
+    default:
+      TORCH_CHECK(
+          false,
+          "AOT compilation doesn't support values of type ",
+          type->python_str());
+  }
+}
+
+std::string intLiteral(int64_t value) {
+  if (value == std::numeric_limits<int64_t>::min()) {
+    return "std::numeric_limits<int64_t>::min()";
+  }
+  return "int64_t(" + c10::to_string(value) + ")";
+}
+
+std::string floatLiteral(double value) {
+  if (std::isnan(value)) {
+    return "std::numeric_limits<double>::quiet_NaN()";
+  }
+  if (std::isinf(value)) {
+    return value > 0 ? "std::numeric_limits<double>::infinity()"
+                     : "-std::numeric_limits<double>::infinity()";
+  }
+  std::ostringstream out;
+  out << std::setprecision(std::numeric_limits<double>::max_digits10)
+      << value;
+  std::string literal = out.str();
+  if (literal.find_first_of(".e") == std::string::npos) {
+    literal += ".0";
+  }
+  return literal;
+}
+
+std::string stringLiteral(const std::string& value) {
+  std::ostringstream out;
+  out << "std::string(\"";
+  for (const char c : value) {
+    if (c == '"' || c == '\\') {
+      out << '\\' << c;
+    } else if (std::isprint(static_cast<unsigned char>(c))) {
+      out << c;
+    } else {
+      // Octal escapes take at most 3 digits, unlike hex ones
+      out << '\\' << std::oct << std::setw(3) << std::setfill('0')
+          << static_cast<int>(static_cast<unsigned char>(c)) << std::dec;
+    }
+  }
+  out << "\", " << value.size() << ")";
+  return out.str();
+}
+
+template <typename T, typename F>
+std::string listLiteral(const std::string& type, const T& list, F literal) {
+  std::string result = type + "{";
+  bool first = true;
+  for (const auto& element : list) {
+    if (!first) {
+      result += ", ";
+    }
+    first = false;
+    result += literal(element);
+  }
+  return result + "}";
+}
+
+class AOTCodeGenerator {
+ public:
+  explicit AOTCodeGenerator(std::shared_ptr<Graph> graph)
+      : graph_(std::move(graph)) {}
+
+  AOTSource run() {
+    for (const Value* input : graph_->inputs()) {
+      TORCH_CHECK(
+          input->type()->isSubtypeOf(TensorType::get()),
+          "AOT compilation requires the inputs to be tensors, but input '",
+          input->debugName(),
+          "' is a ",
+          input->type()->python_str());
+    }
+    for (const Value* output : graph_->outputs()) {
+      TORCH_CHECK(
+          output->type()->isSubtypeOf(TensorType::get()),
+          "AOT compilation requires the outputs to be tensors, but an output "
+          "is a ",
+          output->type()->python_str());
+    }
+
+    for (size_t i = 0; i < graph_->inputs().size(); ++i) {
+      line(0) << "const at::Tensor& " << name(graph_->inputs()[i])
+              << " = (*inputs)[" << i << "];\n";
+    }
+    emitBlock(graph_->block(), 0);
+    line(0) << "outputs->clear();\n";
+    for (const Value* output : graph_->outputs()) {
+      line(0) << "outputs->push_back(" << name(output) << ");\n";
+    }
+    // The template indents the body, without its last newline
+    std::string body = body_.str();
+    body.pop_back();
+
+    TemplateEnv env;
+    env.s("weights_size", c10::to_string(weights_.size()));
+    env.d("num_constants", num_constants_);
+    env.v("load_constants", load_);
+    env.d("num_inputs", graph_->inputs().size());
+    env.s("body", body);
+    return AOTSource{library_template.format(env), std::move(weights_)};
+  }
+
+ private:
+  std::ostream& line(size_t indent) {
+    for (size_t i = 0; i < indent; ++i) {
+      body_ << "  ";
+    }
+    return body_;
+  }
+
+  std::string name(const Value* value) {
+    TORCH_INTERNAL_ASSERT(!isNone(value));
+    return "v" + c10::to_string(value->unique());
+  }
+
+  // The expression passing value where target is expected
+  std::string expr(const Value* value, const TypePtr& target) {
+    if (!isNone(value)) {
+      return name(value);
+    }
+    if (isTensorLike(target)) {
+      return "at::Tensor()";
+    }
+    if (target->kind() == TypeKind::GeneratorType ||
+        (target->kind() == TypeKind::OptionalType &&
+         target->expect<OptionalType>()->getElementType()->kind() ==
+             TypeKind::GeneratorType)) {
+      return "nullptr";
+    }
+    return "c10::nullopt";
+  }
+
+  void declare(const Value* value, size_t indent) {
+    if (!isNone(value)) {
+      line(indent) << cppType(value->type()) << " " << name(value) << ";\n";
+    }
+  }
+
+  void assign(const Value* target, const Value* value, size_t indent) {
+    if (!isNone(target)) {
+      line(indent) << name(target) << " = " << expr(value, target->type())
+                   << ";\n";
+    }
+  }
+
+  void define(const Value* value, const std::string& rhs, size_t indent) {
+    line(indent) << cppType(value->type()) << " " << name(value) << " = "
+                 << rhs << ";\n";
+  }
+
+  void emitBlock(Block* block, size_t indent) {
+    for (Node* node : block->nodes()) {
+      emitNode(node, indent);
+    }
+  }
+
+  void emitNode(Node* node, size_t indent) {
+    switch (node->kind()) {
+      case prim::Constant:
+        emitConstant(node, indent);
+        return;
+      case prim::If:
+        emitIf(node, indent);
+        return;
+      case prim::Loop:
+        emitLoop(node, indent);
+        return;
+      case prim::ListConstruct: {
+        const auto element_type =
+            node->output()->type()->expect<ListType>()->getElementType();
+        std::string list = cppType(node->output()->type()) + "{";
+        for (size_t i = 0; i < node->inputs().size(); ++i) {
+          list += (i ? ", " : "") + expr(node->inputs()[i], element_type);
+        }
+        define(node->output(), list + "}", indent);
+        return;
+      }
+      case prim::ListUnpack:
+        line(indent) << "TORCH_CHECK(" << name(node->input()) << ".size() == "
+                     << node->outputs().size()
+                     << ", \"expected a list of " << node->outputs().size()
+                     << " elements\");\n";
+        for (size_t i = 0; i < node->outputs().size(); ++i) {
+          define(
+              node->outputs()[i],
+              name(node->input()) + "[" + c10::to_string(i) + "]",
+              indent);
+        }
+        return;
+      case prim::RaiseException:
+        line(indent) << "throw std::runtime_error(" << name(node->input())
+                     << ");\n";
+        return;
+      case prim::Uninitialized:
+        declare(node->output(), indent);
+        return;
+      case prim::unchecked_unwrap_optional:
+      case prim::unchecked_cast:
+      case aten::_unwrap_optional:
+        emitUnwrap(node, indent);
+        return;
+      case prim::NumToTensor:
+        define(
+            node->output(),
+            "at::scalar_to_tensor(at::Scalar(" + name(node->input()) + "))",
+            indent);
+        return;
+      case prim::device:
+        define(node->output(), name(node->input()) + ".device()", indent);
+        return;
+      case prim::dtype:
+        define(
+            node->output(),
+            "static_cast<int64_t>(" + name(node->input()) + ".scalar_type())",
+            indent);
+        return;
+      case aten::warn:
+        line(indent) << "TORCH_WARN(" << name(node->inputs().at(0))
+                     << ");\n";
+        return;
+      default:
+        break;
+    }
+    TORCH_CHECK(
+        node->kind().is_aten(),
+        "AOT compilation doesn't support ",
+        node->kind().toQualString(),
+        " nodes");
+    if (!emitSpecialOp(node, indent)) {
+      emitOperator(node, indent);
+    }
+  }
+
+  void emitConstant(Node* node, size_t indent) {
+    const Value* output = node->output();
+    if (isNone(output)) {
+      return;
+    }
+    const IValue value = *toIValue(output);
+    if (value.isTensor()) {
+      define(output, "constants[" + addConstant(value.toTensor()) + "]",
+             indent);
+    } else if (value.isInt()) {
+      define(output, intLiteral(value.toInt()), indent);
+    } else if (value.isDouble()) {
+      define(output, floatLiteral(value.toDouble()), indent);
+    } else if (value.isBool()) {
+      define(output, value.toBool() ? "true" : "false", indent);
+    } else if (value.isString()) {
+      define(output, stringLiteral(value.toStringRef()), indent);
+    } else if (value.isDevice()) {
+      define(
+          output,
+          "at::Device(" + stringLiteral(value.toDevice().str()) + ")",
+          indent);
+    } else if (value.isIntList()) {
+      define(
+          output,
+          listLiteral(
+              "std::vector<int64_t>", value.toIntListRef(), intLiteral),
+          indent);
+    } else if (value.isDoubleList()) {
+      define(
+          output,
+          listLiteral(
+              "std::vector<double>", value.toDoubleListRef(), floatLiteral),
+          indent);
+    } else if (value.isBoolList()) {
+      define(
+          output,
+          listLiteral("std::vector<bool>", value.toBoolList(), [](bool b) {
+            return std::string(b ? "true" : "false");
+          }),
+          indent);
+    } else if (value.isTensorList()) {
+      define(
+          output,
+          listLiteral(
+              "std::vector<at::Tensor>",
+              value.toTensorListRef(),
+              [&](const at::Tensor& tensor) {
+                return "constants[" + addConstant(tensor) + "]";
+              }),
+          indent);
+    } else {
+      TORCH_CHECK(
+          false,
+          "AOT compilation doesn't support constants of type ",
+          output->type()->python_str());
+    }
+  }
+
+  // Appends the data of the tensor to the weights, returning the index of the
+  // constant wrapping it
+  std::string addConstant(const at::Tensor& tensor) {
+    TORCH_CHECK(
+        tensor.layout() == at::kStrided && !tensor.is_quantized() &&
+            !tensor.is_mkldnn(),
+        "AOT compilation only supports dense tensor constants");
+    const at::Tensor data = tensor.cpu().contiguous();
+    weights_.resize(
+        (weights_.size() + kAOTWeightAlignment - 1) / kAOTWeightAlignment *
+            kAOTWeightAlignment,
+        '\0');
+    const size_t offset = weights_.size();
+    weights_.append(
+        static_cast<const char*>(data.data_ptr()),
+        data.numel() * data.element_size());
+
+    std::string load = "constants->push_back(at::from_blob(const_cast<char*>(weights) + " +
+        c10::to_string(offset) + ", " +
+        listLiteral("std::vector<int64_t>", data.sizes(), intLiteral) +
+        ", at::TensorOptions().dtype(at::ScalarType::" +
+        c10::toString(data.scalar_type()) + "))";
+    if (!tensor.device().is_cpu()) {
+      load += ".to(at::Device(" + stringLiteral(tensor.device().str()) + "))";
+    }
+    load_.push_back(load + ");");
+    return c10::to_string(num_constants_++);
+  }
+
+  void emitIf(Node* node, size_t indent) {
+    for (const Value* output : node->outputs()) {
+      declare(output, indent);
+    }
+    line(indent) << "if (" << name(node->input()) << ") {\n";
+    emitBranch(node, node->blocks()[0], indent + 1);
+    line(indent) << "} else {\n";
+    emitBranch(node, node->blocks()[1], indent + 1);
+    line(indent) << "}\n";
+  }
+
+  void emitBranch(Node* node, Block* block, size_t indent) {
+    emitBlock(block, indent);
+    for (size_t i = 0; i < node->outputs().size(); ++i) {
+      assign(node->outputs()[i], block->outputs()[i], indent);
+    }
+  }
+
+  // Loops have the inputs (max trip count, start condition, carried values),
+  // the block parameters (iteration, carried values) and the block outputs
+  // (condition, carried values), and output their carried values
+  void emitLoop(Node* node, size_t indent) {
+    Block* body = node->blocks()[0];
+    for (size_t i = 0; i < node->outputs().size(); ++i) {
+      declare(node->outputs()[i], indent);
+      assign(node->outputs()[i], node->inputs()[i + 2], indent);
+    }
+    const std::string id = c10::to_string(node->outputs().size()
+                                              ? node->output(0)->unique()
+                                              : body->param_node()
+                                                    ->outputs()[0]
+                                                    ->unique());
+    const std::string condition = "cond" + id;
+    const std::string iteration = "iter" + id;
+    line(indent) << "bool " << condition << " = " << name(node->inputs()[1])
+                 << ";\n";
+    line(indent) << "for (int64_t " << iteration << " = 0; " << condition
+                 << " && " << iteration << " < " << name(node->inputs()[0])
+                 << "; ++" << iteration << ") {\n";
+    const auto params = body->inputs();
+    if (params[0]->hasUses()) {
+      define(params[0], iteration, indent + 1);
+    }
+    for (size_t i = 0; i < node->outputs().size(); ++i) {
+      if (!isNone(params[i + 1])) {
+        define(params[i + 1], name(node->outputs()[i]), indent + 1);
+      }
+    }
+    emitBlock(body, indent + 1);
+    line(indent + 1) << condition << " = " << name(body->outputs()[0])
+                     << ";\n";
+    for (size_t i = 0; i < node->outputs().size(); ++i) {
+      assign(node->outputs()[i], body->outputs()[i + 1], indent + 1);
+    }
+    line(indent) << "}\n";
+  }
+
+  void emitUnwrap(Node* node, size_t indent) {
+    const Value* input = node->inputs().at(0);
+    const TypePtr& input_type = input->type();
+    if (isTensorLike(input_type) ||
+        input_type->kind() != TypeKind::OptionalType) {
+      define(node->output(), name(input), indent);
+      return;
+    }
+    line(indent) << "TORCH_CHECK(" << name(input)
+                 << ".has_value(), \"unwrapped a None value\");\n";
+    define(node->output(), "*" + name(input), indent);
+  }
+
+  // Emits the aten ops that the interpreter implements itself, rather than
+  // ATen. Returns false for the other ops.
+  bool emitSpecialOp(Node* node, size_t indent) {
+    const std::string op = node->kind().toUnqualString();
+    const auto inputs = node->inputs();
+    if (op == "__is__" || op == "__isnot__") {
+      const Value* value = inputs[0];
+      const Value* other = inputs[1];
+      if (isNone(value)) {
+        std::swap(value, other);
+      }
+      TORCH_CHECK(
+          isNone(other),
+          "AOT compilation only supports is and is not with None");
+      std::string is_none = "true";
+      if (!isNone(value)) {
+        if (isTensorLike(value->type())) {
+          is_none = "!" + name(value) + ".defined()";
+        } else if (value->type()->kind() == TypeKind::OptionalType) {
+          is_none = "!" + name(value) + ".has_value()";
+        } else {
+          is_none = "false";
+        }
+      }
+      define(
+          node->output(),
+          op == "__is__" ? is_none : "!(" + is_none + ")",
+          indent);
+      return true;
+    }
+    if (op == "__getitem__" &&
+        inputs[0]->type()->kind() == TypeKind::ListType) {
+      define(
+          node->output(),
+          "torch_aot_getitem(" + name(inputs[0]) + ", " + name(inputs[1]) +
+              ")",
+          indent);
+      return true;
+    }
+    if (op == "len" && inputs[0]->type()->kind() == TypeKind::ListType) {
+      define(
+          node->output(),
+          "static_cast<int64_t>(" + name(inputs[0]) + ".size())",
+          indent);
+      return true;
+    }
+    if (op == "append" && inputs[0]->type()->kind() == TypeKind::ListType) {
+      const auto element_type =
+          inputs[0]->type()->expect<ListType>()->getElementType();
+      line(indent) << name(inputs[0]) << ".push_back("
+                   << expr(inputs[1], element_type) << ");\n";
+      define(node->output(), name(inputs[0]), indent);
+      return true;
+    }
+    if (op == "list" && inputs[0]->type()->kind() == TypeKind::ListType) {
+      define(node->output(), name(inputs[0]), indent);
+      return true;
+    }
+    if (op == "dim" && inputs.size() == 1) {
+      define(node->output(), name(inputs[0]) + ".dim()", indent);
+      return true;
+    }
+    if (op == "size" && inputs.size() == 1) {
+      define(node->output(), name(inputs[0]) + ".sizes().vec()", indent);
+      return true;
+    }
+    if ((op == "Int" || op == "Float" || op == "Bool" ||
+         op == "ScalarImplicit") &&
+        inputs.size() == 1) {
+      const std::string type = cppType(node->output()->type());
+      if (inputs[0]->type()->isSubtypeOf(TensorType::get())) {
+        define(
+            node->output(),
+            op == "ScalarImplicit" ? name(inputs[0]) + ".item()"
+                                   : name(inputs[0]) + ".item<" + type + ">()",
+            indent);
+      } else {
+        define(
+            node->output(),
+            "static_cast<" + type + ">(" + name(inputs[0]) + ")",
+            indent);
+      }
+      return true;
+    }
+    for (const Value* input : inputs) {
+      if (!isScalar(input->type())) {
+        return false;
+      }
+    }
+    if (inputs.empty() || node->outputs().size() != 1 ||
+        !isScalar(node->output()->type())) {
+      return false;
+    }
+    const std::string type = cppType(node->output()->type());
+    auto cast = [&](const Value* value) {
+      return "static_cast<" + type + ">(" + name(value) + ")";
+    };
+    std::string rhs;
+    if (inputs.size() == 2 && scalar_binary_ops.count(op)) {
+      rhs = name(inputs[0]) + " " + scalar_binary_ops.at(op) + " " +
+          name(inputs[1]);
+    } else if (inputs.size() == 2 && op == "div") {
+      rhs = "static_cast<double>(" + name(inputs[0]) +
+          ") / static_cast<double>(" + name(inputs[1]) + ")";
+    } else if (inputs.size() == 2 && op == "floordiv") {
+      rhs = "torch_aot_floordiv(" + cast(inputs[0]) + ", " + cast(inputs[1]) +
+          ")";
+    } else if (inputs.size() == 2 && (op == "remainder" || op == "__mod__")) {
+      rhs = "torch_aot_remainder(" + cast(inputs[0]) + ", " +
+          cast(inputs[1]) + ")";
+    } else if (inputs.size() == 2 && (op == "min" || op == "max")) {
+      rhs = "std::" + op + "(" + cast(inputs[0]) + ", " + cast(inputs[1]) +
+          ")";
+    } else if (inputs.size() == 2 && op == "pow") {
+      rhs = "std::pow(static_cast<double>(" + name(inputs[0]) +
+          "), static_cast<double>(" + name(inputs[1]) + "))";
+    } else if (inputs.size() == 1 && op == "neg") {
+      rhs = "-" + name(inputs[0]);
+    } else if (inputs.size() == 1 && op == "__not__") {
+      rhs = "!" + name(inputs[0]);
+    } else {
+      TORCH_CHECK(
+          false,
+          "AOT compilation doesn't support ",
+          node->kind().toQualString(),
+          " on scalars");
+    }
+    define(node->output(), "static_cast<" + type + ">(" + rhs + ")", indent);
+    return true;
+  }
+
+  std::string argument(const Argument& arg, const Value* value) {
+    auto it = enum_arguments.find(arg.name());
+    if (it != enum_arguments.end() && !isNone(value) &&
+        arg.type()->kind() != TypeKind::ListType) {
+      return "torch_aot_enum<" + it->second + ">(" + name(value) + ")";
+    }
+    if (arg.N() && arg.type()->kind() == TypeKind::ListType &&
+        arg.type()->expect<ListType>()->getElementType()->kind() ==
+            TypeKind::BoolType) {
+      return "torch_aot_bools<" + c10::to_string(*arg.N()) + ">(" +
+          name(value) + ")";
+    }
+    return expr(value, arg.type());
+  }
+
+  // Emits the ATen call
+  void emitOperator(Node* node, size_t indent) {
+    const FunctionSchema* schema = node->maybeSchema();
+    TORCH_CHECK(
+        schema,
+        "AOT compilation doesn't support ",
+        node->kind().toQualString(),
+        " with inputs of types ",
+        c10::Join(
+            ", ", fmap(node->inputs(), [](const Value* value) {
+              return value->type()->python_str();
+            })));
+    TORCH_CHECK(
+        !schema->is_vararg() && schema->overload_name() != "out",
+        "AOT compilation doesn't support ",
+        schema->name(),
+        ".",
+        schema->overload_name());
+    const auto& args = schema->arguments();
+    const auto inputs = node->inputs();
+    const std::string op = node->kind().toUnqualString();
+
+    std::vector<std::string> call_args;
+    for (size_t i = 0; i < args.size(); ++i) {
+      bool packs_options = i + tensor_options_arguments.size() <= args.size();
+      for (size_t j = 0; packs_options && j < tensor_options_arguments.size();
+           ++j) {
+        packs_options = args[i + j].name() == tensor_options_arguments[j];
+      }
+      if (packs_options) {
+        std::vector<std::string> options;
+        for (size_t j = 0; j < tensor_options_arguments.size(); ++j) {
+          options.push_back(
+              isNone(inputs[i + j]) ? "c10::nullopt" : name(inputs[i + j]));
+        }
+        call_args.push_back(
+            "torch_aot_options(" + c10::Join(", ", options) + ")");
+        i += tensor_options_arguments.size() - 1;
+        continue;
+      }
+      call_args.push_back(argument(args[i], inputs[i]));
+    }
+
+    std::string call;
+    if (method_only_ops.count(op)) {
+      TORCH_INTERNAL_ASSERT(!call_args.empty());
+      call = call_args[0] + "." + op + "(" +
+          c10::Join(", ",
+                    std::vector<std::string>(
+                        call_args.begin() + 1, call_args.end())) +
+          ")";
+    } else {
+      call = "at::" + op + "(" + c10::Join(", ", call_args) + ")";
+    }
+
+    const auto outputs = node->outputs();
+    if (outputs.empty()) {
+      line(indent) << call << ";\n";
+    } else if (outputs.size() == 1) {
+      define(outputs[0], call, indent);
+    } else {
+      const std::string result = "result" + c10::to_string(outputs[0]->unique());
+      line(indent) << "auto " << result << " = " << call << ";\n";
+      for (size_t i = 0; i < outputs.size(); ++i) {
+        define(
+            outputs[i],
+            "std::get<" + c10::to_string(i) + ">(" + result + ")",
+            indent);
+      }
+    }
+  }
+
+  std::shared_ptr<Graph> graph_;
+  std::ostringstream body_;
+  std::vector<std::string> load_;
+  std::string weights_;
+  size_t num_constants_ = 0;
+};
+
+} // namespace
+
+std::shared_ptr<Graph> prepareForAOT(
+    const script::Module& module,
+    const std::string& method_name) {
+  script::Module frozen = freeze_module(module);
+  auto graph = frozen.get_method(method_name).graph()->copy();
+  Inline(*graph);
+  TORCH_CHECK(
+      !graph->inputs().at(0)->hasUses(),
+      "AOT compilation requires the attributes of the module to be constants, "
+      "but ",
+      method_name,
+      " mutates some of them");
+  graph->eraseInput(0);
+  InlineForkWait(graph);
+  LowerAllTuples(graph);
+  FoldFrozenBatchNorm(graph);
+  runOptimization(graph);
+  PeepholeOptimize(graph);
+  ConstantPropagation(graph);
+  EliminateDeadCode(graph);
+  return graph;
+}
+
+AOTSource generateAOTSource(const std::shared_ptr<Graph>& graph) {
+  return AOTCodeGenerator(graph).run();
+}
+
+} // namespace aot
+} // namespace jit
+} // namespace torch
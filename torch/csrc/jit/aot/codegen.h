@@ -0,0 +1,56 @@
+#pragma once
+
+#include <torch/csrc/WindowsTorchApiMacro.h>
+#include <torch/csrc/jit/ir.h>
+#include <torch/csrc/jit/script/module.h>
+
+#include <memory>
+#include <string>
+
+namespace torch {
+namespace jit {
+namespace aot {
+
+// Ahead-of-time compilation of TorchScript: a frozen, optimized graph is
+// lowered to a C++ translation unit calling the ATen ops directly, which is
+// compiled into a shared library ahead of deployment (see torch/jit/aot.py).
+// Running the library skips deserialization, compilation and optimization of
+// the graph, as well as the interpreter.
+//
+// The translation unit defines the C functions
+//
+//   void* torch_aot_load(const char* weights, size_t size);
+//   void torch_aot_run(
+//       void* state,
+//       const std::vector<at::Tensor>* inputs,
+//       std::vector<at::Tensor>* outputs);
+//   void torch_aot_free(void* state);
+//
+// torch_aot_load wraps the tensor constants of the graph around the weights
+// buffer, which has to outlive the returned state, so that the weights can be
+// mmapped rather than copied (see AOTLibrary).
+struct AOTSource {
+  std::string source;
+  // The data of the tensor constants, aligned at kAOTWeightAlignment
+  std::string weights;
+};
+
+constexpr size_t kAOTWeightAlignment = 64;
+
+// Freezes the module and returns its method \p method_name, with self removed,
+// calls inlined, forks run inline, tuples flattened and the graph optimized.
+// The parameters and attributes of the module become constants, so they
+// can't be mutated by the method.
+TORCH_API std::shared_ptr<Graph> prepareForAOT(
+    const script::Module& module,
+    const std::string& method_name = "forward");
+
+// Generates the source of the library running \p graph, whose inputs and
+// outputs have to be tensors. Throws if it has nodes that can't be lowered,
+// e.g. calls, forks or values other than tensors, scalars, strings, devices,
+// optionals and lists of them.
+TORCH_API AOTSource generateAOTSource(const std::shared_ptr<Graph>& graph);
+
+} // namespace aot
+} // namespace jit
+} // namespace torch
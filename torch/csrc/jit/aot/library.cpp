@@ -0,0 +1,98 @@
+#include <torch/csrc/jit/aot/library.h>
+
+#include <ATen/core/LegacyTypeDispatch.h>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <fstream>
+#include <sstream>
+
+namespace torch {
+namespace jit {
+namespace aot {
+
+namespace {
+
+using LoadFunction = void* (*)(const char*, size_t);
+
+} // namespace
+
+AOTLibrary::AOTLibrary(
+    const std::string& library_path,
+    const std::string& weights_path)
+    : library_(new at::DynamicLibrary(library_path.c_str())) {
+  auto load = reinterpret_cast<LoadFunction>(library_->sym("torch_aot_load"));
+  run_ = reinterpret_cast<RunFunction>(library_->sym("torch_aot_run"));
+  free_ = reinterpret_cast<FreeFunction>(library_->sym("torch_aot_free"));
+
+#ifndef _WIN32
+  const int fd = open(weights_path.c_str(), O_RDONLY);
+  TORCH_CHECK(fd >= 0, "AOTLibrary: couldn't open ", weights_path);
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    close(fd);
+    TORCH_CHECK(false, "AOTLibrary: couldn't stat ", weights_path);
+  }
+  weights_size_ = st.st_size;
+  if (weights_size_ > 0) {
+    // Copy on write, so that an op writing to a constant by mistake doesn't
+    // crash or change the file
+    weights_ = mmap(
+        nullptr,
+        weights_size_,
+        PROT_READ | PROT_WRITE,
+        MAP_PRIVATE,
+        fd,
+        0);
+  }
+  close(fd);
+  TORCH_CHECK(
+      weights_ != MAP_FAILED, "AOTLibrary: couldn't mmap ", weights_path);
+#else
+  std::ifstream file(weights_path, std::ios::binary);
+  TORCH_CHECK(file, "AOTLibrary: couldn't open ", weights_path);
+  std::stringstream contents;
+  contents << file.rdbuf();
+  weights_buffer_ = contents.str();
+  weights_ = &weights_buffer_[0];
+  weights_size_ = weights_buffer_.size();
+#endif
+
+  try {
+    state_ = load(static_cast<const char*>(weights_), weights_size_);
+  } catch (...) {
+#ifndef _WIN32
+    if (weights_) {
+      munmap(weights_, weights_size_);
+    }
+#endif
+    throw;
+  }
+}
+
+AOTLibrary::~AOTLibrary() {
+  // The constants wrap the weights
+  free_(state_);
+#ifndef _WIN32
+  if (weights_) {
+    munmap(weights_, weights_size_);
+  }
+#endif
+}
+
+std::vector<at::Tensor> AOTLibrary::run(
+    const std::vector<at::Tensor>& inputs) const {
+  at::AutoNonVariableTypeMode non_var_type_mode(true);
+  std::vector<at::Tensor> outputs;
+  run_(state_, &inputs, &outputs);
+  return outputs;
+}
+
+} // namespace aot
+} // namespace jit
+} // namespace torch
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <ATen/DynamicLibrary.h>
+#include <torch/csrc/WindowsTorchApiMacro.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace torch {
+namespace jit {
+namespace aot {
+
+// A shared library compiled from the source of generateAOTSource, with the
+// weights it was generated with. The weights file is mmapped, except on
+// Windows where it is read.
+struct TORCH_API AOTLibrary {
+  AOTLibrary(const std::string& library_path, const std::string& weights_path);
+  ~AOTLibrary();
+
+  AOTLibrary(const AOTLibrary&) = delete;
+  AOTLibrary& operator=(const AOTLibrary&) = delete;
+
+  // Runs the graph, with autograd off
+  std::vector<at::Tensor> run(const std::vector<at::Tensor>& inputs) const;
+
+ private:
+  using RunFunction = void (*)(
+      void*,
+      const std::vector<at::Tensor>*,
+      std::vector<at::Tensor>*);
+  using FreeFunction = void (*)(void*);
+
+  std::unique_ptr<at::DynamicLibrary> library_;
+  RunFunction run_ = nullptr;
+  FreeFunction free_ = nullptr;
+  void* state_ = nullptr;
+  void* weights_ = nullptr;
+  size_t weights_size_ = 0;
+  std::string weights_buffer_;
+};
+
+} // namespace aot
+} // namespace jit
+} // namespace torch
@@ -2,6 +2,7 @@
 
 #include <ATen/core/jit_type.h>
 #include <ATen/core/stack.h>
+#include <c10/util/SmallVector.h>
 #include <torch/csrc/WindowsTorchApiMacro.h>
 #include <torch/csrc/autograd/variable.h>
 #include <torch/csrc/jit/ir.h>
@@ -100,7 +101,7 @@ struct ArgumentSpec {
     // show overhead in extra refcounting along this path
     const at::Tensor* t = reinterpret_cast<const at::Tensor*>(&input);
     if ((arg.defined_ = t->defined())) {
-      arg.requires_grad_ = with_grad && autograd::Variable(*t).requires_grad();
+      arg.requires_grad_ = with_grad && t->requires_grad();
       arg.dim_ = t->dim();
       arg.device_ = t->is_cuda() ? t->get_device() : -1;
       arg.type_ = static_cast<unsigned>(t->scalar_type());
@@ -153,8 +154,10 @@ struct ArgumentSpec {
 
  private:
   size_t hash_code; // precomputed on construction
-  std::vector<ArgumentInfo> tensor_args;
-  std::vector<bool> optional_presence;
+  // inline storage saves a heap allocation per call of the small functions
+  // whose per-call overhead matters, see GraphExecutorImpl::getOrCompile
+  c10::SmallVector<ArgumentInfo, 8> tensor_args;
+  c10::SmallVector<bool, 8> optional_presence;
 };
 
 // ArgumentSpecCreator takes an initial graph and comes up with a set
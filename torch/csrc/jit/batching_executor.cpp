@@ -0,0 +1,359 @@
+#include <torch/csrc/jit/batching_executor.h>
+
+#include <ATen/ATen.h>
+#include <torch/csrc/autograd/grad_mode.h>
+
+#include <algorithm>
+#include <numeric>
+
+namespace torch {
+namespace jit {
+
+namespace {
+
+// The number of samples in a request: the first dimension of its tensor
+// inputs, which submit() checks to agree
+int64_t numRows(const std::vector<IValue>& inputs) {
+  for (const auto& input : inputs) {
+    if (input.isTensor()) {
+      return input.toTensor().size(0);
+    }
+  }
+  return 0;
+}
+
+bool sameNonTensorInput(const IValue& a, const IValue& b) {
+  if (a.isNone() || b.isNone()) {
+    return a.isNone() && b.isNone();
+  }
+  if (a.isInt() && b.isInt()) {
+    return a.toInt() == b.toInt();
+  }
+  if (a.isDouble() && b.isDouble()) {
+    return a.toDouble() == b.toDouble();
+  }
+  if (a.isBool() && b.isBool()) {
+    return a.toBool() == b.toBool();
+  }
+  if (a.isString() && b.isString()) {
+    return a.toStringRef() == b.toStringRef();
+  }
+  return false;
+}
+
+// Whether the request with the inputs b can run in the batch of the request
+// with the inputs a
+bool canBatch(
+    const std::vector<IValue>& a,
+    const std::vector<IValue>& b,
+    bool pad_inputs) {
+  if (a.size() != b.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < a.size(); ++i) {
+    if (a[i].isTensor() != b[i].isTensor()) {
+      return false;
+    }
+    if (!a[i].isTensor()) {
+      if (!sameNonTensorInput(a[i], b[i])) {
+        return false;
+      }
+      continue;
+    }
+    const auto& ta = a[i].toTensor();
+    const auto& tb = b[i].toTensor();
+    if (ta.scalar_type() != tb.scalar_type() || ta.device() != tb.device() ||
+        ta.dim() != tb.dim()) {
+      return false;
+    }
+    if (!pad_inputs && !std::equal(
+            ta.sizes().begin() + 1, ta.sizes().end(), tb.sizes().begin() + 1)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Concatenates the tensors along the first dimension, zero padding the other
+// dimensions to the largest sizes first
+at::Tensor catPadded(std::vector<at::Tensor>& tensors) {
+  const int64_t dim = tensors.front().dim();
+  std::vector<int64_t> max_sizes = tensors.front().sizes().vec();
+  bool need_pad = false;
+  for (const auto& tensor : tensors) {
+    for (int64_t d = 1; d < dim; ++d) {
+      need_pad |= tensor.size(d) != max_sizes[d];
+      max_sizes[d] = std::max(max_sizes[d], tensor.size(d));
+    }
+  }
+  if (need_pad) {
+    for (auto& tensor : tensors) {
+      // constant_pad_nd takes the padding of the last dimension first
+      std::vector<int64_t> pad(2 * (dim - 1), 0);
+      bool padded = false;
+      for (int64_t d = 1; d < dim; ++d) {
+        pad[2 * (dim - 1 - d) + 1] = max_sizes[d] - tensor.size(d);
+        padded |= tensor.size(d) != max_sizes[d];
+      }
+      if (padded) {
+        tensor = at::constant_pad_nd(tensor, pad, 0);
+      }
+    }
+  }
+  return at::cat(tensors);
+}
+
+// Splits an output of the batch into the outputs of its requests, which have
+// rows[i] rows each
+std::vector<IValue> splitOutput(
+    const IValue& output,
+    const std::vector<int64_t>& rows,
+    int64_t total_rows) {
+  std::vector<IValue> outputs;
+  outputs.reserve(rows.size());
+  if (output.isTensor()) {
+    const auto& tensor = output.toTensor();
+    TORCH_CHECK(
+        tensor.dim() > 0 && tensor.size(0) == total_rows,
+        "BatchingExecutor: the tensor outputs of a batch of ",
+        total_rows,
+        " rows must have ",
+        total_rows,
+        " rows, but got an output of sizes ",
+        tensor.sizes());
+    int64_t offset = 0;
+    for (const int64_t num_rows : rows) {
+      outputs.emplace_back(tensor.narrow(0, offset, num_rows));
+      offset += num_rows;
+    }
+  } else if (output.isTuple()) {
+    const auto& elements = output.toTuple()->elements();
+    std::vector<std::vector<IValue>> split_elements(rows.size());
+    for (const auto& element : elements) {
+      auto split = splitOutput(element, rows, total_rows);
+      for (size_t i = 0; i < rows.size(); ++i) {
+        split_elements[i].push_back(std::move(split[i]));
+      }
+    }
+    for (auto& request_elements : split_elements) {
+      outputs.emplace_back(c10::ivalue::Tuple::create(std::move(request_elements)));
+    }
+  } else if (output.isTensorList()) {
+    const auto list = output.toTensorList();
+    std::vector<c10::List<at::Tensor>> split_lists(rows.size());
+    for (const at::Tensor tensor : list) {
+      auto split = splitOutput(tensor, rows, total_rows);
+      for (size_t i = 0; i < rows.size(); ++i) {
+        split_lists[i].push_back(split[i].toTensor());
+      }
+    }
+    for (auto& request_list : split_lists) {
+      outputs.emplace_back(std::move(request_list));
+    }
+  } else {
+    // Anything else isn't per sample, and is returned to every request
+    for (size_t i = 0; i < rows.size(); ++i) {
+      outputs.push_back(output);
+    }
+  }
+  return outputs;
+}
+
+} // namespace
+
+BatchingExecutor::BatchingExecutor(
+    script::Module module,
+    BatchingExecutorOptions options,
+    std::string method_name)
+    : module_(std::move(module)),
+      options_(options),
+      method_name_(std::move(method_name)) {
+  TORCH_CHECK(
+      options_.max_batch_size >= 1,
+      "BatchingExecutor: max_batch_size must be positive");
+  TORCH_CHECK(
+      options_.num_workers >= 1,
+      "BatchingExecutor: num_workers must be positive");
+  TORCH_CHECK(
+      options_.max_latency.count() >= 0,
+      "BatchingExecutor: max_latency can't be negative");
+  const auto& schema = module_.get_method(method_name_).function().getSchema();
+  output_type_ = schema.returns().size() == 1
+      ? schema.returns()[0].type()
+      : TupleType::create(c10::fmap(
+            schema.returns(), [](const Argument& arg) { return arg.type(); }));
+
+  workers_.reserve(options_.num_workers);
+  for (int i = 0; i < options_.num_workers; ++i) {
+    workers_.emplace_back([this] { workerLoop(); });
+  }
+}
+
+BatchingExecutor::~BatchingExecutor() {
+  shutdown();
+}
+
+c10::intrusive_ptr<c10::ivalue::Future> BatchingExecutor::submit(
+    std::vector<IValue> inputs) {
+  int64_t num_rows = -1;
+  for (const auto& input : inputs) {
+    if (!input.isTensor()) {
+      continue;
+    }
+    const auto& tensor = input.toTensor();
+    TORCH_CHECK(
+        tensor.dim() > 0,
+        "BatchingExecutor: tensor inputs must have a batch dimension");
+    TORCH_CHECK(
+        num_rows == -1 || tensor.size(0) == num_rows,
+        "BatchingExecutor: the tensor inputs of a request must have the same "
+        "size of the first dimension, but got ",
+        num_rows,
+        " and ",
+        tensor.size(0));
+    num_rows = tensor.size(0);
+  }
+  TORCH_CHECK(
+      num_rows != -1,
+      "BatchingExecutor: a request must have at least one tensor input");
+
+  auto future = c10::make_intrusive<c10::ivalue::Future>(output_type_);
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    TORCH_CHECK(!shutdown_, "BatchingExecutor: submit() after shutdown()");
+    queue_.push_back(
+        Request{std::move(inputs), future, std::chrono::steady_clock::now()});
+    ++stats_.num_requests;
+  }
+  queue_cv_.notify_one();
+  return future;
+}
+
+void BatchingExecutor::shutdown() {
+  std::vector<std::thread> workers;
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    shutdown_ = true;
+    workers.swap(workers_);
+  }
+  queue_cv_.notify_all();
+  for (auto& worker : workers) {
+    worker.join();
+  }
+}
+
+BatchingExecutorStats BatchingExecutor::stats() const {
+  std::lock_guard<std::mutex> guard(mutex_);
+  return stats_;
+}
+
+void BatchingExecutor::workerLoop() {
+  while (true) {
+    std::vector<Request> batch;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      batch = takeBatch(lock);
+    }
+    if (batch.empty()) {
+      return;
+    }
+    runBatch(std::move(batch));
+  }
+}
+
+std::vector<BatchingExecutor::Request> BatchingExecutor::takeBatch(
+    std::unique_lock<std::mutex>& lock) {
+  while (true) {
+    if (queue_.empty()) {
+      if (shutdown_) {
+        return {};
+      }
+      queue_cv_.wait(lock);
+      continue;
+    }
+    // Another worker may take the front request while this one waits, so the
+    // deadline is recomputed after every wake up
+    const auto deadline = queue_.front().arrival + options_.max_latency;
+    if (shutdown_ ||
+        static_cast<int64_t>(queue_.size()) >= options_.max_batch_size ||
+        std::chrono::steady_clock::now() >= deadline) {
+      break;
+    }
+    queue_cv_.wait_until(lock, deadline);
+  }
+
+  std::vector<Request> batch;
+  batch.push_back(std::move(queue_.front()));
+  queue_.pop_front();
+  for (auto it = queue_.begin(); it != queue_.end() &&
+       static_cast<int64_t>(batch.size()) < options_.max_batch_size;) {
+    if (canBatch(batch.front().inputs, it->inputs, options_.pad_inputs)) {
+      batch.push_back(std::move(*it));
+      it = queue_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  ++stats_.num_batches;
+  if (!queue_.empty()) {
+    // The requests left behind can start the next batch on another worker
+    queue_cv_.notify_one();
+  }
+  return batch;
+}
+
+void BatchingExecutor::runBatch(std::vector<Request>&& batch) {
+  std::vector<IValue> outputs;
+  try {
+    std::vector<int64_t> rows;
+    rows.reserve(batch.size());
+    for (const auto& request : batch) {
+      rows.push_back(numRows(request.inputs));
+    }
+    const int64_t total_rows = std::accumulate(rows.begin(), rows.end(), int64_t{0});
+
+    // Non-tensor inputs are equal in all the requests of the batch, and are
+    // taken from the first one
+    std::vector<IValue> inputs = batch.front().inputs;
+    if (batch.size() > 1) {
+      for (size_t i = 0; i < inputs.size(); ++i) {
+        if (!inputs[i].isTensor()) {
+          continue;
+        }
+        std::vector<at::Tensor> tensors;
+        tensors.reserve(batch.size());
+        for (const auto& request : batch) {
+          tensors.push_back(request.inputs[i].toTensor());
+        }
+        inputs[i] = options_.pad_inputs ? catPadded(tensors) : at::cat(tensors);
+      }
+    }
+
+    if (options_.prepare_inputs) {
+      inputs = options_.prepare_inputs(std::move(inputs));
+    }
+
+    IValue output;
+    {
+      autograd::AutoGradMode grad_mode(!options_.no_grad);
+      output = module_.get_method(method_name_)(std::move(inputs));
+    }
+    outputs = splitOutput(output, rows, total_rows);
+  } catch (const std::exception& e) {
+    {
+      std::lock_guard<std::mutex> guard(mutex_);
+      ++stats_.num_failed_batches;
+    }
+    for (auto& request : batch) {
+      request.future->markCompleted(
+          c10::ivalue::Future::FutureError(std::string(e.what())));
+    }
+    return;
+  }
+  for (size_t i = 0; i < batch.size(); ++i) {
+    batch[i].future->markCompleted(std::move(outputs[i]));
+  }
+}
+
+} // namespace jit
+} // namespace torch
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <ATen/core/ivalue.h>
+#include <torch/csrc/WindowsTorchApiMacro.h>
+#include <torch/csrc/jit/script/module.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace torch {
+namespace jit {
+
+struct BatchingExecutorOptions {
+  // The largest number of requests run in one call of the method
+  int64_t max_batch_size{8};
+  // A batch runs once it has max_batch_size requests, or once its first
+  // request waited this long, whichever comes first. This bounds the time a
+  // request waits for others to batch with to max_latency, on top of the time
+  // it waits for a free worker.
+  std::chrono::microseconds max_latency{std::chrono::milliseconds(2)};
+  // Threads running batches at the same time. With more than one, a batch
+  // can be formed while the previous one runs.
+  int num_workers{1};
+  // If true, tensor inputs which only differ in the sizes of their
+  // dimensions after the first are zero padded at the end to the largest
+  // ones, e.g. for sequences of different lengths. Otherwise such requests
+  // are run in different batches.
+  bool pad_inputs{false};
+  // Run the method without autograd, like an inference server does
+  bool no_grad{true};
+  // If set, called by the worker on the inputs of a batch, once its requests
+  // are concatenated, and the method runs on what it returns. E.g. with a
+  // torch::cuda::InputStager, which copies them to the GPU without blocking
+  // the worker, the inputs of a batch are copied while another worker runs
+  // the previous batch.
+  std::function<std::vector<IValue>(std::vector<IValue>)> prepare_inputs;
+};
+
+struct BatchingExecutorStats {
+  int64_t num_requests{0};
+  int64_t num_batches{0};
+  int64_t num_failed_batches{0};
+};
+
+// Runs a method of a ScriptModule on batches of the requests submitted from
+// any number of threads, to get the throughput of large batches out of
+// requests that come one at a time, e.g. into a server.
+//
+// Each request is the list of the inputs of the method. The requests of a
+// batch have their tensor inputs concatenated along the first dimension (a
+// request can hold several samples), and their other inputs must be equal
+// ints, floats, bools, strings or None; requests which can't be batched with
+// the oldest one waiting are left for a later batch. The outputs of the call,
+// tensors or tuples or lists of tensors whose first dimension is the batch,
+// are split back along the first dimension and complete the futures returned
+// by submit(). An error in the call completes all the futures of the batch
+// with that error.
+//
+//   BatchingExecutor executor(torch::jit::load("model.pt"));
+//   auto future = executor.submit({torch::randn({1, 3, 224, 224})});
+//   future->wait();
+//   at::Tensor output = future->value().toTensor();
+//
+// The workers are std::threads owned by the executor, like the calling
+// threads of ThroughputBenchmark, rather than tasks of at::launch: they
+// block waiting for requests, which would take the threads of the inter-op
+// pool away from the ops. The destructor runs the requests already
+// submitted and joins the workers.
+class TORCH_API BatchingExecutor {
+ public:
+  explicit BatchingExecutor(
+      script::Module module,
+      BatchingExecutorOptions options = BatchingExecutorOptions(),
+      std::string method_name = "forward");
+  ~BatchingExecutor();
+
+  BatchingExecutor(const BatchingExecutor&) = delete;
+  BatchingExecutor& operator=(const BatchingExecutor&) = delete;
+
+  c10::intrusive_ptr<c10::ivalue::Future> submit(std::vector<IValue> inputs);
+
+  // Stops taking requests, runs the ones already submitted and joins the
+  // workers. Called by the destructor.
+  void shutdown();
+
+  BatchingExecutorStats stats() const;
+
+ private:
+  struct Request {
+    std::vector<IValue> inputs;
+    c10::intrusive_ptr<c10::ivalue::Future> future;
+    std::chrono::steady_clock::time_point arrival;
+  };
+
+  void workerLoop();
+  // Takes the batch out of queue_, waiting for it to fill up until the
+  // deadline of its first request. Empty once shut down and drained.
+  std::vector<Request> takeBatch(std::unique_lock<std::mutex>& lock);
+  void runBatch(std::vector<Request>&& batch);
+
+  script::Module module_;
+  const BatchingExecutorOptions options_;
+  const std::string method_name_;
+  // The type of the futures, the return type of the method
+  TypePtr output_type_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable queue_cv_;
+  std::deque<Request> queue_;
+  bool shutdown_{false};
+  BatchingExecutorStats stats_;
+  std::vector<std::thread> workers_;
+};
+
+} // namespace jit
+} // namespace torch
@@ -47,11 +47,15 @@ TORCH_API void ExportModule(
     const script::ExtraFilesMap& metadata = script::ExtraFilesMap(),
     bool bytecode_format = false);
 
+// With num_shards > 1, the tensor storages are spread over the archives
+// filename.1, ... filename.<num_shards - 1> as well, which are written in
+// parallel and have to be kept next to filename to load it.
 TORCH_API void ExportModule(
     const script::Module& module,
     const std::string& filename,
     const script::ExtraFilesMap& metadata = script::ExtraFilesMap(),
-    bool bytecode_format = false);
+    bool bytecode_format = false,
+    size_t num_shards = 1);
 
 TORCH_API void ExportModule(
     const script::Module& module,
@@ -5,7 +5,10 @@
 #include <torch/csrc/jit/passes/python_print.h>
 #include <torch/csrc/jit/pickle.h>
 #include <torch/csrc/jit/source_range_serialization.h>
+#include <torch/csrc/jit/storage_writer.h>
+#include <torch/csrc/utils/memory.h>
 #include <torch/csrc/jit/instruction.h>
+#include <torch/csrc/jit/mobile/flat_bytecode.h>
 #include <torch/csrc/jit/passes/inliner.h>
 
 #include <caffe2/serialize/inline_container.h>
@@ -33,8 +36,23 @@ void SetExportModuleExtraFilesHook(ExportModuleExtraFilesHook hook) {
 
 class ScriptModuleSerializer {
  public:
-  explicit ScriptModuleSerializer(const std::string& filename)
-      : writer_(filename) {}
+  explicit ScriptModuleSerializer(
+      const std::string& filename,
+      size_t num_shards = 1)
+      : writer_(filename) {
+    TORCH_CHECK(num_shards >= 1, "expected at least one shard");
+    // The storages are spread over filename.1, ..., filename.<num_shards - 1>
+    // too, whose names are recorded in the "shards" record of the archive
+    for (size_t i = 1; i < num_shards; ++i) {
+      std::string shard_filename = filename + "." + c10::to_string(i);
+      shards_.push_back(
+          torch::make_unique<caffe2::serialize::PyTorchStreamWriter>(
+              shard_filename));
+      shard_names_ += shard_filename.substr(
+                          shard_filename.find_last_of('/') + 1) +
+          "\n";
+    }
+  }
 
   explicit ScriptModuleSerializer(
       const std::function<size_t(const void *, size_t)>& writer_func)
@@ -58,6 +76,12 @@ class ScriptModuleSerializer {
     if (bytecode_format) {
       writeByteCode(module);
     }
+    if (!shards_.empty()) {
+      for (auto& shard : shards_) {
+        shard->writeEndOfFile();
+      }
+      writer_.writeRecord("shards", shard_names_.data(), shard_names_.size());
+    }
   }
 
  private:
@@ -74,12 +98,18 @@ class ScriptModuleSerializer {
     data_pickle.protocol();
     data_pickle.pushIValue(value);
     data_pickle.stop();
+    std::vector<caffe2::serialize::PyTorchStreamWriter*> writers{&writer_};
+    for (auto& shard : shards_) {
+      writers.push_back(shard.get());
+    }
+    StorageWriter storage_writer(writers);
     size_t i = 0;
     std::string prefix = archive_name + "/";
-    for (const auto& td : data_pickle.tensorData()) {
+    for (const auto& tensor : data_pickle.storageTensors()) {
       std::string fname = prefix + std::to_string(i++);
-      writer_.writeRecord(fname, td.data(), td.sizeInBytes());
+      storage_writer.write(fname, tensor);
     }
+    storage_writer.finish();
     std::string fname = archive_name + ".pkl";
     writer_.writeRecord(fname, data.data(), data.size());
 
@@ -147,6 +177,7 @@ class ScriptModuleSerializer {
   void writeByteCode(const script::Module& module) {
     auto methods = module.get_methods();
     std::vector<c10::IValue> elements;
+    std::vector<mobile::FlatFunctionDef> flat_functions;
     for (const auto& method : methods) {
       const auto& func = method.function();
       auto graph = func.graph()->copy();
@@ -164,6 +195,7 @@ class ScriptModuleSerializer {
 
       // instructions
       std::vector<IValue> inss;
+      std::vector<Instruction> flat_inss;
       for (size_t i = 0; i < code.instructions().size(); ++i) {
         Instruction ins = code.instructions()[i];
         TORCH_CHECK(isOpSupportedInMobile(ins.op), toString(ins.op),
@@ -201,6 +233,7 @@ class ScriptModuleSerializer {
         }
         std::vector<IValue> insv{toString(ins.op), ins.X, ins.N};
         inss.emplace_back(c10::ivalue::Tuple::create(std::move(insv)));
+        flat_inss.push_back(ins);
       }
       auto instructions = c10::ivalue::Tuple::create(std::move(inss));
       auto named_ins = c10::ivalue::Tuple::create({"instructions", instructions});
@@ -223,9 +256,39 @@ class ScriptModuleSerializer {
 
       auto element = c10::ivalue::Tuple::create({named_ins, named_ops, named_consts, named_regsize});
       elements.push_back(c10::ivalue::Tuple::create({func.qualname().qualifiedName(), element}));
+
+      flat_functions.push_back({func.qualname().qualifiedName(),
+                                std::move(flat_inss),
+                                std::move(opnames),
+                                code.constant_table(),
+                                code.register_size()});
     }
     auto telements = c10::ivalue::Tuple::create(std::move(elements));
     writeArchive("bytecode", telements);
+    writeFlatByteCode(flat_functions);
+  }
+
+  // The same bytecode in a record the lite interpreter reads in place, see
+  // Note [Flat bytecode]
+  void writeFlatByteCode(
+      const std::vector<mobile::FlatFunctionDef>& functions) {
+    std::vector<at::Tensor> storages;
+    std::vector<IValue> pickled_constants;
+    std::string data =
+        mobile::serializeFlatBytecode(functions, storages, pickled_constants);
+    for (size_t i = 0; i < storages.size(); ++i) {
+      auto storage = getWriteableTensorData(storages[i]);
+      writer_.writeRecord(
+          mobile::kFlatStoragePrefix + c10::to_string(i),
+          storage.data(),
+          storage.sizeInBytes());
+    }
+    if (!pickled_constants.empty()) {
+      writeArchive(
+          mobile::kFlatConstantsArchive,
+          c10::ivalue::Tuple::create(std::move(pickled_constants)));
+    }
+    writer_.writeRecord(mobile::kFlatBytecodeRecord, data.data(), data.size());
   }
 
   void convertNamedType(const c10::NamedTypePtr& class_type) {
@@ -246,6 +309,8 @@ class ScriptModuleSerializer {
   }
 
   caffe2::serialize::PyTorchStreamWriter writer_;
+  std::vector<std::unique_ptr<caffe2::serialize::PyTorchStreamWriter>> shards_;
+  std::string shard_names_;
   std::vector<at::Tensor> constant_table_;
   std::unordered_set<c10::NamedTypePtr> converted_types_;
   std::vector<c10::NamedTypePtr> class_deps_;
@@ -273,8 +338,9 @@ void ExportModule(
     const script::Module& module,
     const std::string& filename,
     const script::ExtraFilesMap& extra_files,
-    bool bytecode_format) {
-  ScriptModuleSerializer serializer(filename);
+    bool bytecode_format,
+    size_t num_shards) {
+  ScriptModuleSerializer serializer(filename, num_shards);
   serializer.serialize(module, extra_files, bytecode_format);
 }
 
@@ -45,13 +45,42 @@ IValue Function::operator()(
   return stack.front();
 }
 
+// Lazily compiled functions may be first used from several threads, and
+// their creators share the state of the compilation unit and the importer, so
+// definitions are serialized. Since creators define the functions they call,
+// the lock is reentrant and never taken while holding a compile_mutex.
+static std::recursive_mutex& definitionMutex() {
+  static std::recursive_mutex mutex;
+  return mutex;
+}
+
+void Function::define_unless_defining() {
+  std::lock_guard<std::recursive_mutex> lock(definitionMutex());
+  if (!defining_) {
+    ensure_defined();
+  }
+}
+
 void Function::ensure_defined() {
+  if (defined_) {
+    check_single_output();
+    return;
+  }
+  std::lock_guard<std::recursive_mutex> lock(definitionMutex());
   try {
     if (function_creator_) {
       auto creator = function_creator_;
       function_creator_ = placeholderCreator;
-      creator(*this);
+      defining_ = true;
+      try {
+        creator(*this);
+      } catch (...) {
+        defining_ = false;
+        throw;
+      }
+      defining_ = false;
       function_creator_ = nullptr;
+      defined_ = true;
     }
   } catch (RecursiveMethodCallError&) {
     throw script::ErrorReport() // TODO: once lower_first_class methods is
@@ -64,6 +93,8 @@ void Function::ensure_defined() {
 }
 
 const FunctionSchema& Function::getSchema() const {
+  // A lazily compiled function sets its schema when it is defined
+  graph();
   if (schema_ == nullptr) {
     schema_ = make_unique<FunctionSchema>(defaultSchemaFor(*this));
   }
@@ -2,6 +2,7 @@
 #include <torch/csrc/jit/graph_executor.h>
 #include <torch/csrc/jit/ir.h>
 #include <torch/csrc/utils/memory.h>
+#include <atomic>
 #include <mutex>
 
 namespace torch {
@@ -22,7 +23,8 @@ struct TORCH_API Function {
       std::function<void(Function&)> function_creator)
       : name_(std::move(name)),
         graph_(std::move(graph)),
-        function_creator_(std::move(function_creator)) {}
+        function_creator_(std::move(function_creator)),
+        defined_(!function_creator_) {}
 
   void run(Stack& stack);
 
@@ -32,16 +34,23 @@ struct TORCH_API Function {
       std::vector<IValue> stack,
       const Kwargs& kwargs = Kwargs());
 
+  // Defines the function first if it is compiled lazily, except while its
+  // creator emits the graph
   std::shared_ptr<Graph> graph() const {
+    if (!defined_) {
+      const_cast<Function*>(this)->define_unless_defining();
+    }
     return graph_;
   }
 
   std::shared_ptr<Graph> optimized_graph() const {
+    // Defines the function before taking compile_mutex, see ensure_defined
+    auto graph = this->graph();
     std::lock_guard<std::recursive_mutex> lock(compile_mutex);
     if (optimized_graph_) {
       return *optimized_graph_;
     }
-    optimized_graph_ = graph_->copy();
+    optimized_graph_ = graph->copy();
     preoptimizeGraph(*optimized_graph_);
     return *optimized_graph_;
   }
@@ -104,6 +113,8 @@ struct TORCH_API Function {
   }
 
  private:
+  void define_unless_defining();
+
   c10::QualifiedName name_;
   // The original, non-optimized graph
   std::shared_ptr<Graph> graph_; // for debugging and for inlining
@@ -128,6 +139,12 @@ struct TORCH_API Function {
   // that it can construct methods out of order
   std::function<void(Function&)> function_creator_;
 
+  // Whether the function_creator ran, and whether it is running, which only
+  // change under the definition lock of ensure_defined. Functions compiled
+  // lazily (see CompilationUnit::define) run it on first use.
+  std::atomic<bool> defined_;
+  bool defining_ = false;
+
   // if absent, then we generate a default schema based on the graph
   // mutable because getSchema caches the default schema if one is requested
   // before a call to setSchema
@@ -11,11 +11,15 @@
 #include <torch/csrc/jit/fuser/cpu/resource_strings.h>
 #include <torch/csrc/jit/fuser/cuda/resource_strings.h>
 
+#include <algorithm>
 #include <cmath>
 #include <cstdint>
 #include <iostream>
+#include <set>
 #include <sstream>
 #include <tuple>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 namespace torch {
@@ -313,13 +317,431 @@ static void emitIndexingFor(
   }
 }
 
+bool isRowReduction(const Node* node) {
+  return node->kind() == aten::sum || node->kind() == aten::mean;
+}
+
+bool isRowOp(const Node* node) {
+  return isRowReduction(node) || node->kind() == aten::softmax ||
+      node->kind() == aten::log_softmax;
+}
+
+std::unordered_set<const Value*> rowReducedValues(const Graph& graph) {
+  std::unordered_set<const Value*> reduced;
+  for (const Node* n : graph.nodes()) {
+    if (isRowReduction(n)) {
+      reduced.insert(n->output());
+      continue;
+    }
+    bool has_tensor_input = false;
+    bool all_reduced = true;
+    for (const Value* input : n->inputs()) {
+      if (input->type()->isSubtypeOf(TensorType::get())) {
+        has_tensor_input = true;
+        all_reduced &= reduced.count(input) > 0;
+      }
+    }
+    if (has_tensor_input && all_reduced) {
+      reduced.insert(n->outputs().begin(), n->outputs().end());
+    }
+  }
+  return reduced;
+}
+
+static bool isTensorValue(const Value* v) {
+  return v->type()->isSubtypeOf(TensorType::get());
+}
+
+// The bytes of the values of the given calc type
+static size_t calcTypeSize(const std::string& type) {
+  if (type == "double" || type == "int64_t") {
+    return 8;
+  } else if (type == "float" || type == "int") {
+    return 4;
+  } else if (type == "int16_t") {
+    return 2;
+  } else if (type == "bool" || type == "uint8_t" || type == "int8_t") {
+    return 1;
+  }
+  throw std::runtime_error("unknown type " + type + " in JIT row fusion");
+}
+
+// Writes the kernel of a graph with row ops (see generateKernel).
+//
+// Each value of the graph is either uniform (a constant or a scalar input), a
+// row value with a single element per row, or an element value. The threads of
+// the block loop over the row once per phase. Element values are computed in
+// the earliest loop that reads them, and kept in shared memory when a later
+// loop reads them again. A row reduction accumulates its input in the loop
+// that computes it, and is reduced over the block after that loop, followed by
+// the row values computed from it; a softmax needs two such loops before its
+// result. Every thread keeps the row values in its registers.
+static std::string generateRowKernel(
+    const std::string& name,
+    const Graph& graph,
+    const std::vector<std::pair<const Value*, const c10::optional<TensorDesc>>>& inputs,
+    const std::vector<std::pair<const Value*, const TensorDesc>>& outputs,
+    ReductionDesc& reduction_desc) {
+  TemplateEnv env;
+  env.s("kernelName", name);
+  env.s("IndexType", "unsigned int");
+
+  // Writes the parameters, in the same order as in the other kernels
+  std::vector<std::string> formals;
+  std::vector<const TensorDesc*> formal_descs;
+  for (const auto& input : inputs) {
+    env.d("formal", formals.size());
+    if (input.second.has_value()) {
+      env.s("scalar_type", scalarTypeName(input.second->scalar_type));
+      env.d("nDim", input.second->nDim());
+      formals.push_back(
+          format("const TensorInfo<${scalar_type},${nDim}> t${formal}", env));
+      formal_descs.push_back(&*input.second);
+    } else {
+      env.s("scalar_type", variableType(input.first->type()));
+      formals.push_back(format("${scalar_type} s${formal}", env));
+      formal_descs.push_back(nullptr);
+    }
+  }
+  for (const auto& output : outputs) {
+    env.d("formal", formals.size());
+    env.s("scalar_type", scalarTypeName(output.second.scalar_type));
+    env.d("nDim", output.second.nDim());
+    formals.push_back(
+        format("const TensorInfo<${scalar_type},${nDim}> t${formal}", env));
+    formal_descs.push_back(&output.second);
+  }
+
+  const auto reduced = rowReducedValues(graph);
+  auto isElement = [&](const Value* v) {
+    return isTensorValue(v) && !reduced.count(v);
+  };
+  auto isSoftmax = [](const Node* n) {
+    return n->kind() == aten::softmax || n->kind() == aten::log_softmax;
+  };
+
+  // The earliest loop that can compute each element value, and the first loop
+  // after which each row value is known
+  std::unordered_map<const Value*, size_t> earliest;
+  for (const auto& input : inputs) {
+    if (input.second.has_value()) {
+      earliest[input.first] = 0;
+    }
+  }
+  for (const Node* n : graph.nodes()) {
+    TORCH_INTERNAL_ASSERT(
+        n->kind() != prim::FusedConcat && n->kind() != prim::ConstantChunk &&
+        n->kind() != aten::rand_like);
+    if (!isTensorValue(n->output())) {
+      continue;
+    }
+    size_t e = 0;
+    for (const Value* input : n->inputs()) {
+      if (isTensorValue(input)) {
+        e = std::max(e, earliest.at(input));
+      }
+    }
+    const Value* self = n->inputs().at(0);
+    if (isRowReduction(n) && isElement(self)) {
+      e += 1;
+    } else if (isSoftmax(n) && isElement(self)) {
+      e += 2;
+    }
+    earliest[n->output()] = e;
+  }
+
+  // The loops that read each element value, and the loop that computes it
+  std::unordered_map<const Value*, std::set<size_t>> reads;
+  std::unordered_map<const Value*, size_t> phase;
+  size_t n_loops = 0;
+  auto setPhase = [&](const Value* v) {
+    const auto& v_reads = reads[v];
+    phase[v] = v_reads.empty() ? earliest.at(v) : *v_reads.begin();
+    n_loops = std::max(n_loops, phase[v] + 1);
+  };
+  for (const Node* n : graph.nodes().reverse()) {
+    const Value* o = n->output();
+    if (!isTensorValue(o)) {
+      continue;
+    }
+    if (!isElement(o)) {
+      n_loops = std::max(n_loops, earliest.at(o));
+      if (isRowReduction(n) && isElement(n->input(0))) {
+        reads[n->input(0)].insert(earliest.at(n->input(0)));
+      }
+      continue;
+    }
+    setPhase(o);
+    if (isSoftmax(n)) {
+      const Value* self = n->input(0);
+      const size_t e = earliest.at(self);
+      reads[self].insert({e, e + 1, phase[o]});
+      continue;
+    }
+    for (const Value* input : n->inputs()) {
+      if (isElement(input)) {
+        reads[input].insert(phase[o]);
+      }
+    }
+  }
+  for (const auto& input : inputs) {
+    if (input.second.has_value()) {
+      setPhase(input.first);
+    }
+  }
+
+  // Lays out the cached values in shared memory, by decreasing size so that
+  // they are all aligned
+  std::vector<std::pair<size_t, const Value*>> cached;
+  auto addCached = [&](const Value* v) {
+    const auto& v_reads = reads[v];
+    if (isElement(v) && !v_reads.empty() && *v_reads.rbegin() > phase[v]) {
+      cached.emplace_back(calcTypeSize(variableType(v->type())), v);
+    }
+  };
+  for (const auto& input : inputs) {
+    if (input.second.has_value()) {
+      addCached(input.first);
+    }
+  }
+  for (const Node* n : graph.nodes()) {
+    addCached(n->output());
+  }
+  std::stable_sort(
+      cached.begin(), cached.end(), [](const auto& a, const auto& b) {
+        return a.first > b.first;
+      });
+  std::stringstream row_caches;
+  size_t cache_bytes = 0;
+  for (const auto& c : cached) {
+    env.s("type", variableType(c.second->type()));
+    env.s("node", valueName(c.second));
+    env.d("offset", cache_bytes);
+    row_caches << format(
+        "${type}* c_${node} = reinterpret_cast<${type}*>(rowCache + rowSize * ${offset});\n",
+        env);
+    cache_bytes += c.first;
+  }
+  reduction_desc.shared_bytes_per_element = cache_bytes;
+  auto isCached = [&](const Value* v) {
+    return std::any_of(cached.begin(), cached.end(), [&](const auto& c) {
+      return c.second == v;
+    });
+  };
+
+  // The code before, in, and after each loop
+  std::vector<std::stringstream> before(n_loops);
+  std::vector<std::set<size_t>> offsets(n_loops);
+  std::vector<std::stringstream> cache_loads(n_loops);
+  std::vector<std::stringstream> loads(n_loops);
+  std::vector<std::stringstream> nodes(n_loops);
+  std::vector<std::stringstream> accumulations(n_loops);
+  std::vector<std::stringstream> cache_stores(n_loops);
+  std::vector<std::stringstream> stores(n_loops);
+  std::vector<std::stringstream> after(n_loops);
+  std::stringstream uniform;
+  bool has_half_tensor = false;
+
+  auto emitElement = [&](const Value* v) {
+    env.s("type", variableType(v->type()));
+    env.s("node", valueName(v));
+    for (const size_t q : reads[v]) {
+      if (q > phase[v]) {
+        cache_loads[q] << format("${type} ${node} = c_${node}[rowIndex];\n", env);
+      }
+    }
+    if (isCached(v)) {
+      cache_stores[phase[v]] << format("c_${node}[rowIndex] = ${node};\n", env);
+    }
+  };
+
+  // Acquires the inputs
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    const auto& input = inputs[i];
+    env.d("formal", i);
+    env.s("node", valueName(input.first));
+    if (!input.second.has_value()) {
+      env.s("type", variableType(input.first->type()));
+      uniform << format("${type} ${node} = s${formal};\n", env);
+      continue;
+    }
+    const auto scalar_type = input.second->scalar_type;
+    if (scalar_type == at::ScalarType::Half) {
+      env.s("access", format("__half2float(t${formal}.data[t${formal}_offset])", env));
+      has_half_tensor = true;
+    } else if (scalar_type == at::ScalarType::Bool) {
+      env.s("access", format("t${formal}.data[t${formal}_offset]", env));
+    } else {
+      env.s("access", format("__ldg(&t${formal}.data[t${formal}_offset])", env));
+    }
+    env.s("type", calcScalarTypeName(scalar_type));
+    const size_t q = phase[input.first];
+    offsets[q].insert(i);
+    loads[q] << format("${type} ${node} = ${access};\n", env);
+    emitElement(input.first);
+  }
+
+  // Generates code for the nodes
+  for (const Node* n : graph.nodes()) {
+    if (n->mustBeNone()) {
+      continue;
+    }
+    const Value* o = n->output();
+    env.s("node", valueName(o));
+    if (n->kind() == prim::Constant) {
+      const auto val = toIValue(o).value();
+      if (val.isDouble()) {
+        env.s("rhs", scalarValue(val.toDouble()));
+      } else if (val.isBool()) {
+        env.s("rhs", scalarValue(val.toBool()));
+      } else if (val.isInt()) {
+        env.s("rhs", scalarValue(val.toInt()));
+      } else {
+        // The dims of the row ops
+        continue;
+      }
+      env.s("type", variableType(o->type()));
+      uniform << format("${type} ${node} = ${rhs};\n", env);
+      continue;
+    }
+
+    env.s("type", variableType(o->type()));
+    const Value* self = n->inputs().at(0);
+    env.s("self", valueName(self));
+    const bool is_float = variableType(o->type()) == "float";
+    env.s("exp", is_float ? "expf" : "exp");
+    env.s("log", is_float ? "logf" : "log");
+    if (!isElement(o)) {
+      std::stringstream& out = after.at(earliest.at(o) - 1);
+      if (isRowReduction(n) && isElement(self)) {
+        const size_t e = earliest.at(self);
+        before[e] << format("${type} ${node}_acc = 0;\n", env);
+        accumulations[e] << format("${node}_acc += ${self};\n", env);
+        out << format("${type} ${node} = blockReduceSum(${node}_acc, reduceScratch)", env);
+        if (n->kind() == aten::mean) {
+          out << format(" / static_cast<${type}>(rowSize)", env);
+        }
+        out << ";\n";
+      } else if (isRowReduction(n)) {
+        // Reduces a single element
+        out << format("${type} ${node} = ${self};\n", env);
+      } else if (isSoftmax(n)) {
+        env.s("rhs", n->kind() == aten::softmax ? "1" : "0");
+        out << format("${type} ${node} = ${rhs};\n", env);
+      } else {
+        env.s("rhs", encodeRHS(n));
+        out << format("${type} ${node} = ${rhs};\n", env);
+      }
+      continue;
+    }
+
+    if (isSoftmax(n)) {
+      const size_t e = earliest.at(self);
+      before[e] << format("${type} ${node}_max = NEG_INFINITY;\n", env);
+      accumulations[e] << format(
+          "${node}_max = ${self} > ${node}_max ? ${self} : ${node}_max;\n", env);
+      after[e] << format(
+          "${node}_max = blockReduceMax(${node}_max, reduceScratch);\n", env);
+      before[e + 1] << format("${type} ${node}_sum = 0;\n", env);
+      accumulations[e + 1] << format(
+          "${node}_sum += ${exp}(${self} - ${node}_max);\n", env);
+      after[e + 1] << format(
+          "${node}_sum = blockReduceSum(${node}_sum, reduceScratch);\n", env);
+      env.s(
+          "rhs",
+          n->kind() == aten::softmax
+              ? format("${exp}(${self} - ${node}_max) / ${node}_sum", env)
+              : format("${self} - ${node}_max - ${log}(${node}_sum)", env));
+    } else {
+      env.s("rhs", encodeRHS(n));
+    }
+    nodes[phase[o]] << format("${type} ${node} = ${rhs};\n", env);
+    emitElement(o);
+  }
+
+  // Generates writes to output tensors, reduced outputs are written once per
+  // row, by the first thread
+  for (size_t i = 0; i < outputs.size(); ++i) {
+    const auto& output = outputs[i];
+    const size_t formal = inputs.size() + i;
+    env.d("formal", formal);
+    env.s("node", valueName(output.first));
+    if (output.second.scalar_type == at::ScalarType::Half) {
+      env.s("rhs", format("__float2half(${node})", env));
+      has_half_tensor = true;
+    } else {
+      env.s("rhs", format("${node}", env));
+    }
+    const std::string store =
+        format("t${formal}.data[t${formal}_offset] = ${rhs};\n", env);
+    if (isElement(output.first)) {
+      const size_t q = phase[output.first];
+      offsets[q].insert(formal);
+      stores[q] << store;
+    } else {
+      std::stringstream& out = after.at(earliest.at(output.first) - 1);
+      out << "if (threadIdx.x == 0) {\n";
+      out << "IndexType linearIndex = row;\n";
+      emitIndexingFor(
+          out,
+          format("t${formal}", env),
+          output.second.nDim(),
+          output.second.lastIsContiguous());
+      out << store << "}\n";
+    }
+  }
+
+  std::stringstream row_body;
+  for (size_t q = 0; q < n_loops; ++q) {
+    row_body << before[q].str();
+    row_body << "for (IndexType rowIndex = threadIdx.x; rowIndex < rowSize; "
+                "rowIndex += blockDim.x) {\n";
+    row_body << "IndexType linearIndex = row * rowSize + rowIndex;\n";
+    for (const size_t formal : offsets[q]) {
+      const TensorDesc& desc = *formal_descs[formal];
+      emitIndexingFor(
+          row_body,
+          "t" + c10::to_string(formal),
+          desc.nDim(),
+          desc.lastIsContiguous());
+    }
+    row_body << cache_loads[q].str() << loads[q].str() << nodes[q].str()
+             << accumulations[q].str() << cache_stores[q].str()
+             << stores[q].str();
+    row_body << "}\n";
+    row_body << after[q].str();
+  }
+
+  env.s("HalfHeader", has_half_tensor ? cuda::half_support_literal : "");
+  env.s("RandHeader", "");
+  env.s("RowReductionHeader", cuda::row_reduction_support_literal);
+  env.s("type_declarations", cuda::type_declarations_template.format(env));
+  env.v("formals", formals);
+  env.s("rowCaches", row_caches.str());
+  env.s("uniformValues", uniform.str());
+  env.s("rowBody", row_body.str());
+  return cuda::cuda_row_reduction_template.format(env);
+}
+
 // TODO: handle cases where we need to generate > 2^32 element tensors
 std::string generateKernel(
     const std::string& name,
     const Graph& graph,
     const std::vector<std::pair<const Value*, const c10::optional<TensorDesc>>>& inputs,
     const std::vector<std::pair<const Value*, const TensorDesc>>& outputs,
-    const bool use_cuda) {
+    const bool use_cuda,
+    ReductionDesc* reduction_desc) {
+  const auto& graph_nodes = graph.nodes();
+  if (std::any_of(graph_nodes.begin(), graph_nodes.end(), isRowOp)) {
+    TORCH_INTERNAL_ASSERT(use_cuda && reduction_desc);
+    std::string code_string =
+        generateRowKernel(name, graph, inputs, outputs, *reduction_desc);
+    if (debugFuser()) {
+      std::cerr << "fusion code:" << code_string << std::endl;
+    }
+    return code_string;
+  }
+
   TemplateEnv env;
   env.s("kernelName", name);
   env.s(
@@ -2,6 +2,7 @@
 
 #include <torch/csrc/WindowsTorchApiMacro.h>
 #include <torch/csrc/jit/fuser/arg_spec.h>
+#include <torch/csrc/jit/fuser/fused_kernel.h>
 #include <torch/csrc/jit/fuser/partition_desc.h>
 #include <torch/csrc/jit/fuser/tensor_desc.h>
 #include <torch/csrc/jit/ir.h>
@@ -9,20 +10,37 @@
 #include <iostream>
 #include <string>
 #include <tuple>
+#include <unordered_set>
 #include <vector>
 
 namespace torch {
 namespace jit {
 namespace fuser {
 
+// Whether the node sums, or averages, the last dimension of its input
+TORCH_API bool isRowReduction(const Node* node);
+
+// Whether the node is a row reduction, or a softmax or log_softmax of the last
+// dimension, which reduces the row twice before its pointwise result
+TORCH_API bool isRowOp(const Node* node);
+
+// The values of the graph that have a single element per row, i.e. the row
+// reductions and the values computed from them alone
+TORCH_API std::unordered_set<const Value*> rowReducedValues(const Graph& graph);
+
 // Creates a CPU or CUDA kernel for the given graph.
 // Returns the C++ or CUDA string implementing the kernel.
+// Graphs with row ops are only supported for CUDA, and generate kernels that
+// run a block per row of the map size: the block loops over the row once per
+// reduction, keeping in shared memory the values that later loops read again.
+// Their layout is written to reduction_desc, which must be given for them.
 TORCH_API std::string generateKernel(
     const std::string& name,
     const Graph& graph,
     const std::vector<std::pair<const Value*, const c10::optional<TensorDesc>>>& inputs,
     const std::vector<std::pair<const Value*, const TensorDesc>>& outputs,
-    const bool use_cuda);
+    const bool use_cuda,
+    ReductionDesc* reduction_desc = nullptr);
 
 } // namespace fuser
 } // namespace jit
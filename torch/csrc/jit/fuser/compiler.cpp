@@ -5,6 +5,7 @@
 #include <c10/util/Exception.h>
 #include <torch/csrc/jit/code_template.h>
 #include <torch/csrc/jit/fuser/codegen.h>
+#include <torch/csrc/jit/fuser/disk_cache.h>
 #include <torch/csrc/jit/fuser/interface.h>
 #include <torch/csrc/jit/fuser/kernel_cache.h>
 #include <torch/csrc/jit/fuser/tensor_desc.h>
@@ -13,6 +14,10 @@
 #include <torch/csrc/jit/passes/canonicalize.h>
 #include <torch/csrc/jit/passes/shape_analysis.h>
 
+#ifdef USE_LLVM
+#include <torch/csrc/jit/fuser/cpu/llvm_kernel.h>
+#endif
+
 #include <atomic>
 #include <iostream>
 #include <memory>
@@ -105,6 +110,9 @@ static void setInputChunkDescriptors(KernelSpec& spec) {
 }
 
 // Run a DFS traversal to find all inputs that affect a given output value
+// Note: the traversal stops at row reductions, whose inputs only need
+// the size of the rows, and whose outputs broadcast to it (see
+// setInputBroadcastGroups)
 static std::vector<int64_t> getInputDependencies(const Value* output) {
   std::vector<const Value*> queue{output};
   std::unordered_set<const Value*> inputs;
@@ -126,6 +134,9 @@ static std::vector<int64_t> getInputDependencies(const Value* output) {
       inputs.insert(val);
       continue;
     }
+    if (isRowReduction(producer)) {
+      continue;
+    }
     for (const Value* input : producer->inputs()) {
       if (/*bool inserted = */ seen.insert(input).second) {
         queue.push_back(input);
@@ -147,13 +158,28 @@ static std::vector<int64_t> getInputDependencies(const Value* output) {
 static void setInputBroadcastGroups(KernelSpec& spec) {
   std::unordered_set<std::vector<int64_t>, torch::hash<std::vector<int64_t>>>
       broadcast_groups;
+  auto addGroup = [&](const Value* value) {
+    auto group = getInputDependencies(value);
+    // Reduced outputs depend on no input
+    if (!group.empty()) {
+      broadcast_groups.insert(std::move(group));
+    }
+  };
   for (const Value* output : (spec.graph())->outputs()) {
     if (output->node()->kind() == prim::FusedConcat) {
       for (const Value* concat_input : output->node()->inputs()) {
-        broadcast_groups.insert(getInputDependencies(concat_input));
+        addGroup(concat_input);
       }
     } else {
-      broadcast_groups.insert(getInputDependencies(output));
+      addGroup(output);
+    }
+  }
+  // The rows that are reduced must have the map size, rather than be
+  // broadcast to it
+  const auto reduced = rowReducedValues(*spec.graph());
+  for (const Node* n : spec.graph()->nodes()) {
+    if (isRowOp(n) && !reduced.count(n->input(0))) {
+      addGroup(n->input(0));
     }
   }
   std::copy(
@@ -170,7 +196,9 @@ static void setInputBroadcastGroups(KernelSpec& spec) {
 // are always expandable to the outputs of pointwise operations they
 // or their descendants are involved in, which means that in a DAG of
 // pointwise operations all tensors are expandable to the (single) output.
-// Note: The logic is slightly complicated by concatenation and chunking.
+// Note: The logic is slightly complicated by concatenation and chunking,
+// and by row reductions, whose outputs have a single element per row of the
+// map size, and whose inputs must have the map size.
 static void upfrontCompilation(KernelSpec& spec) {
   setInputBroadcastGroups(spec);
   setInputChunkDescriptors(spec);
@@ -253,12 +281,21 @@ std::shared_ptr<FusedKernel> compileKernel(
   std::vector<TensorDesc> output_desc;
   std::vector<PartitionDesc> concat_desc;
   std::vector<std::pair<const Value*, const TensorDesc>> flat_outputs;
+  const auto reduced = rowReducedValues(*graph);
+  std::vector<bool> reduced_outputs;
   for (const Value* o : graph->outputs()) {
     // Creates output description
     std::vector<int64_t> sizes = map_size;
     if (o->node()->kind() == prim::FusedConcat) {
+      for (const Value* c : o->node()->inputs()) {
+        TORCH_INTERNAL_ASSERT(!reduced.count(c));
+      }
       sizes.at(o->node()->i(attr::dim)) *= o->node()->inputs().size();
     }
+    reduced_outputs.push_back(reduced.count(o) > 0);
+    if (reduced_outputs.back()) {
+      sizes.back() = 1;
+    }
 
     auto scalar_type = o->type()->expect<TensorType>()->scalarType();
     TORCH_INTERNAL_ASSERT(scalar_type);
@@ -280,9 +317,49 @@ std::shared_ptr<FusedKernel> compileKernel(
   }
 
   const bool use_cuda = device.is_cuda();
-  const std::string name = "kernel_" + c10::to_string(next_kernel_id++);
-  std::string code =
-      generateKernel(name, *graph, flat_inputs, flat_outputs, use_cuda);
+  // Kernels cached on disk are named after what their code is generated
+  // from, so that they have the same code in every process (see disk_cache.h)
+  std::string name = "kernel_" + c10::to_string(next_kernel_id++);
+  if (diskCacheDir()) {
+    std::stringstream key;
+    key << spec.graph()->toString(false) << device.type();
+    for (const auto& desc : input_desc) {
+      key << desc;
+    }
+    for (const auto& desc : output_desc) {
+      key << desc;
+    }
+    name = "kernel_" + diskCacheHash(key.str());
+  }
+#ifdef USE_LLVM
+  // CPU kernels are compiled in process when LLVM can lower them
+  if (!use_cuda) {
+    if (auto kernel = cpu::compileLLVMKernel(
+            name,
+            *graph,
+            flat_inputs,
+            flat_outputs,
+            input_desc,
+            output_desc,
+            chunk_desc,
+            concat_desc,
+            spec.hasRandom())) {
+      return kernel;
+    }
+  }
+#endif
+  c10::optional<ReductionDesc> reduction_desc;
+  if (spec.reducesRows()) {
+    reduction_desc = ReductionDesc();
+    reduction_desc->reduced_outputs = std::move(reduced_outputs);
+  }
+  std::string code = generateKernel(
+      name,
+      *graph,
+      flat_inputs,
+      flat_outputs,
+      use_cuda,
+      reduction_desc ? &*reduction_desc : nullptr);
   const FusedKernelConstructor& kernel_ctor =
       getConstructor(use_cuda ? at::DeviceType::CUDA : at::DeviceType::CPU);
   return kernel_ctor(
@@ -293,7 +370,8 @@ std::shared_ptr<FusedKernel> compileKernel(
       output_desc,
       chunk_desc,
       concat_desc,
-      spec.hasRandom());
+      spec.hasRandom(),
+      std::move(reduction_desc));
 }
 
 } // namespace fuser
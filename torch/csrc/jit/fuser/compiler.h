@@ -41,7 +41,8 @@ using FusedKernelConstructor = std::function<std::shared_ptr<FusedKernel>(
     std::vector<TensorDesc> output_desc,
     std::vector<PartitionDesc> chunk_desc,
     std::vector<PartitionDesc> concat_desc,
-    bool has_random)>;
+    bool has_random,
+    c10::optional<ReductionDesc> reduction_desc)>;
 
 TORCH_API void registerFusionBackend(
     at::Device::Type backend_type,
@@ -4,6 +4,7 @@
 #include <torch/csrc/jit/code_template.h>
 #include <torch/csrc/jit/fuser/compiler.h>
 #include <torch/csrc/jit/fuser/cpu/temp_file.h>
+#include <torch/csrc/jit/fuser/disk_cache.h>
 #include <torch/csrc/utils/memory.h>
 
 #ifdef _MSC_VER
@@ -11,6 +12,7 @@
 #endif
 
 #include <cstdlib>
+#include <fstream>
 #include <iostream>
 #include <sstream>
 #include <stdexcept>
@@ -237,7 +239,7 @@ static const std::string compile_string =
 #endif
     "-std=c++11 -fPIC ${fopenmp} -shared \"${cpp_file}\" -o \"${so_file}\" -lm";
 #endif
-static void runCompiler(
+static std::string compileCommand(
     const std::string& cpp_file,
     const std::string& so_file) {
   auto& config = getConfig();
@@ -246,7 +248,14 @@ static void runCompiler(
   env.s("fopenmp", config.openmp ? config.openmp_flags : "");
   env.s("cpp_file", cpp_file);
   env.s("so_file", so_file);
-  std::string result = format(compile_string, env);
+  return format(compile_string, env);
+}
+
+static void runCompiler(
+    const std::string& cpp_file,
+    const std::string& so_file) {
+  auto& config = getConfig();
+  std::string result = compileCommand(cpp_file, so_file);
 #ifdef _MSC_VER
   intptr_t r = run(result);
 #else
@@ -291,14 +300,31 @@ FusedKernelCPU::FusedKernelCPU(
           std::move(concat_desc),
           has_random) {
   TempFile so_file(so_template, so_suffix_len);
-  TempFile cpp_file(cpp_template, cpp_suffix_len);
-  cpp_file.write(code_);
-  cpp_file.sync();
+  // The shared library depends on the compiler and its flags besides the code
+  const std::string cache_source =
+      code_ + "\n// " + compileCommand("kernel.cpp", "kernel.so");
+  if (auto binary = loadCachedBinary(cache_source)) {
+    so_file.write(*binary);
+    so_file.sync();
+#ifdef _MSC_VER
+    so_file.close();
+#endif
+  } else {
+    TempFile cpp_file(cpp_template, cpp_suffix_len);
+    cpp_file.write(code_);
+    cpp_file.sync();
 #ifdef _MSC_VER
-  so_file.close();
-  cpp_file.close();
+    so_file.close();
+    cpp_file.close();
 #endif
-  runCompiler(cpp_file.name(), so_file.name());
+    runCompiler(cpp_file.name(), so_file.name());
+    if (diskCacheDir()) {
+      std::ifstream so_stream(so_file.name(), std::ios::binary);
+      std::stringstream so_contents;
+      so_contents << so_stream.rdbuf();
+      storeCachedBinary(cache_source, so_contents.str());
+    }
+  }
   if (debugFuser() >= 2)
     disas(so_file.name());
   so_lib = make_unique<at::DynamicLibrary>(so_file.name().c_str());
@@ -316,7 +342,10 @@ static std::shared_ptr<FusedKernel> createFusionKernel(
     std::vector<TensorDesc> output_desc,
     std::vector<PartitionDesc> chunk_desc,
     std::vector<PartitionDesc> concat_desc,
-    bool has_random) {
+    bool has_random,
+    c10::optional<ReductionDesc> reduction_desc) {
+  // Row reductions are only fused for CUDA (see runFusion)
+  TORCH_INTERNAL_ASSERT(!reduction_desc);
   return std::make_shared<FusedKernelCPU>(
       std::move(name),
       std::move(code),
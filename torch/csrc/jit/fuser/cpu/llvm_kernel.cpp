@@ -0,0 +1,825 @@
+#include <torch/csrc/jit/fuser/cpu/llvm_kernel.h>
+
+#include <ATen/Parallel.h>
+#include <c10/util/Exception.h>
+#include <torch/csrc/jit/constants.h>
+#include <torch/csrc/jit/fuser/compiler.h>
+
+#include <llvm/ExecutionEngine/Orc/ExecutionUtils.h>
+#include <llvm/ExecutionEngine/Orc/JITTargetMachineBuilder.h>
+#include <llvm/ExecutionEngine/Orc/LLJIT.h>
+#include <llvm/ExecutionEngine/Orc/ThreadSafeModule.h>
+#include <llvm/IR/IRBuilder.h>
+#include <llvm/IR/Intrinsics.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Module.h>
+#include <llvm/IR/Verifier.h>
+#include <llvm/Passes/PassBuilder.h>
+#include <llvm/Support/TargetSelect.h>
+#include <llvm/Support/raw_ostream.h>
+#include <llvm/Target/TargetMachine.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <mutex>
+#include <unordered_map>
+
+namespace torch {
+namespace jit {
+namespace fuser {
+namespace cpu {
+
+namespace {
+
+// Computes the elements [begin, end) of the outputs
+using KernelFunction = void (*)(uint32_t begin, uint32_t end, void** args);
+
+// Each thread computes at least this many elements, like the OpenMP threshold
+// of the C++ kernels
+constexpr int64_t kGrainSize = 100000;
+
+template <typename T>
+T unwrap(llvm::Expected<T> expected) {
+  if (!expected) {
+    TORCH_CHECK(
+        false,
+        "LLVM fuser backend: ",
+        llvm::toString(expected.takeError()));
+  }
+  return std::move(*expected);
+}
+
+void check(llvm::Error error) {
+  if (error) {
+    TORCH_CHECK(
+        false, "LLVM fuser backend: ", llvm::toString(std::move(error)));
+  }
+}
+
+// A single JIT holds the machine code of every kernel, which lives as long as
+// the process, like the kernel cache that owns the kernels.
+class LLVMJIT {
+ public:
+  LLVMJIT() {
+    llvm::InitializeNativeTarget();
+    llvm::InitializeNativeTargetAsmPrinter();
+    auto machine_builder =
+        unwrap(llvm::orc::JITTargetMachineBuilder::detectHost());
+    target_machine_ = unwrap(machine_builder.createTargetMachine());
+    jit_ = unwrap(llvm::orc::LLJITBuilder()
+                      .setJITTargetMachineBuilder(std::move(machine_builder))
+                      .create());
+    // Resolves the libm functions that the kernels call
+    jit_->getMainJITDylib().addGenerator(
+        unwrap(llvm::orc::DynamicLibrarySearchGenerator::GetForCurrentProcess(
+            jit_->getDataLayout().getGlobalPrefix())));
+  }
+
+  // Optimizes module for the host CPU, and returns its IR and the address of
+  // its function name
+  std::pair<std::string, KernelFunction> compile(
+      std::unique_ptr<llvm::LLVMContext> context,
+      std::unique_ptr<llvm::Module> module,
+      const std::string& name) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    module->setDataLayout(target_machine_->createDataLayout());
+    module->setTargetTriple(target_machine_->getTargetTriple().str());
+    optimize(*module);
+
+    std::string ir;
+    llvm::raw_string_ostream ir_stream(ir);
+    module->print(ir_stream, nullptr);
+    ir_stream.flush();
+
+    check(jit_->addIRModule(
+        llvm::orc::ThreadSafeModule(std::move(module), std::move(context))));
+    auto address = unwrap(jit_->lookup(name)).getAddress();
+    return {std::move(ir),
+            reinterpret_cast<KernelFunction>(static_cast<uintptr_t>(address))};
+  }
+
+ private:
+  void optimize(llvm::Module& module) {
+    llvm::LoopAnalysisManager lam;
+    llvm::FunctionAnalysisManager fam;
+    llvm::CGSCCAnalysisManager cgam;
+    llvm::ModuleAnalysisManager mam;
+    llvm::PassBuilder pass_builder(target_machine_.get());
+    pass_builder.registerModuleAnalyses(mam);
+    pass_builder.registerCGSCCAnalyses(cgam);
+    pass_builder.registerFunctionAnalyses(fam);
+    pass_builder.registerLoopAnalyses(lam);
+    pass_builder.crossRegisterProxies(lam, fam, cgam, mam);
+    pass_builder
+        .buildPerModuleDefaultPipeline(llvm::OptimizationLevel::O3)
+        .run(module, mam);
+  }
+
+  std::mutex mutex_;
+  std::unique_ptr<llvm::TargetMachine> target_machine_;
+  std::unique_ptr<llvm::orc::LLJIT> jit_;
+};
+
+LLVMJIT& getJIT() {
+  static LLVMJIT jit;
+  return jit;
+}
+
+struct FusedKernelLLVM : public FusedKernel {
+  FusedKernelLLVM(
+      std::string name,
+      std::string code,
+      std::vector<TensorDesc> input_desc,
+      std::vector<TensorDesc> output_desc,
+      std::vector<PartitionDesc> chunk_desc,
+      std::vector<PartitionDesc> concat_desc,
+      bool has_random,
+      KernelFunction kernel)
+      : FusedKernel(
+            std::move(name),
+            std::move(code),
+            std::move(input_desc),
+            std::move(output_desc),
+            std::move(chunk_desc),
+            std::move(concat_desc),
+            has_random),
+        kernel_(kernel) {}
+
+  at::Backend backend() const override {
+    return at::Backend::CPU;
+  }
+
+  void launch_raw(const uint32_t numel, std::vector<void*>& arguments)
+      const override {
+    void** args = arguments.data();
+    at::parallel_for(0, numel, kGrainSize, [&](int64_t begin, int64_t end) {
+      kernel_(begin, end, args);
+    });
+  }
+
+ private:
+  KernelFunction kernel_;
+};
+
+// The value of a graph value at one element of the outputs
+struct Scalar {
+  llvm::Value* value;
+  at::ScalarType type;
+};
+
+bool isSigned(at::ScalarType type) {
+  return type != at::kBool && type != at::kByte;
+}
+
+c10::optional<at::ScalarType> scalarTypeOf(const Value* value) {
+  const auto& type = value->type();
+  if (type->kind() == TypeKind::IntType) {
+    return at::kLong;
+  } else if (type->kind() == TypeKind::FloatType) {
+    return at::kDouble;
+  } else if (type->kind() == TypeKind::BoolType) {
+    return at::kBool;
+  } else if (auto tensor_type = type->cast<TensorType>()) {
+    return tensor_type->scalarType();
+  }
+  return c10::nullopt;
+}
+
+// Lowers a fusion group to the function
+//   void name(uint32_t begin, uint32_t end, void** args)
+// where args are the arguments of the C++ kernels: args[0] points to the
+// number of elements, and the following ones to the TensorInfo of each flat
+// input and output, or to the double of each scalar input. Elements are
+// indexed like in the C++ kernels, so that a contiguous tensor is accessed at
+// the loop index itself, which lets LLVM vectorize the loop.
+class KernelLowering {
+ public:
+  KernelLowering(llvm::LLVMContext& context, llvm::Module& module)
+      : context_(context), module_(module), builder_(context) {}
+
+  // Returns false if the graph can't be lowered
+  bool lower(
+      const std::string& name,
+      const Graph& graph,
+      const std::vector<
+          std::pair<const Value*, const c10::optional<TensorDesc>>>&
+          flat_inputs,
+      const std::vector<std::pair<const Value*, const TensorDesc>>&
+          flat_outputs) {
+    auto* index_type = builder_.getInt32Ty();
+    auto* args_type = builder_.getInt8PtrTy()->getPointerTo();
+    auto* function_type = llvm::FunctionType::get(
+        builder_.getVoidTy(), {index_type, index_type, args_type}, false);
+    function_ = llvm::Function::Create(
+        function_type, llvm::Function::ExternalLinkage, name, module_);
+    function_->addFnAttr(llvm::Attribute::NoUnwind);
+    auto arg = function_->arg_begin();
+    llvm::Value* begin = &*arg++;
+    llvm::Value* end = &*arg++;
+    llvm::Value* args = &*arg;
+
+    auto* entry = llvm::BasicBlock::Create(context_, "entry", function_);
+    auto* loop = llvm::BasicBlock::Create(context_, "loop", function_);
+    auto* exit = llvm::BasicBlock::Create(context_, "exit", function_);
+
+    // Loads the arguments once, before the loop
+    builder_.SetInsertPoint(entry);
+    size_t formal = 0;
+    auto load_arg = [&]() {
+      return builder_.CreateLoad(
+          builder_.getInt8PtrTy(),
+          builder_.CreateConstInBoundsGEP1_32(
+              builder_.getInt8PtrTy(), args, ++formal));
+    };
+    std::vector<TensorArg> input_tensors;
+    for (const auto& input : flat_inputs) {
+      if (input.second) {
+        if (!llvmType(input.second->scalar_type)) {
+          return false;
+        }
+        input_tensors.push_back(loadTensorArg(load_arg(), *input.second));
+      } else {
+        auto* value = builder_.CreateLoad(
+            builder_.getDoubleTy(),
+            builder_.CreateBitCast(
+                load_arg(), builder_.getDoubleTy()->getPointerTo()));
+        values_[input.first] = {value, at::kDouble};
+      }
+    }
+    std::vector<TensorArg> output_tensors;
+    for (const auto& output : flat_outputs) {
+      if (!llvmType(output.second.scalar_type)) {
+        return false;
+      }
+      output_tensors.push_back(loadTensorArg(load_arg(), output.second));
+    }
+    builder_.CreateCondBr(builder_.CreateICmpULT(begin, end), loop, exit);
+
+    builder_.SetInsertPoint(loop);
+    auto* index = builder_.CreatePHI(index_type, 2);
+    index->addIncoming(begin, entry);
+
+    size_t input_tensor = 0;
+    for (const auto& input : flat_inputs) {
+      if (input.second) {
+        const TensorArg& tensor = input_tensors[input_tensor++];
+        values_[input.first] = loadElement(tensor, index);
+      }
+    }
+    for (const Node* node : graph.nodes()) {
+      // FusedConcat and ConstantChunk are implemented through the flat
+      // outputs and inputs, and None is handled by the ops that take it
+      if (node->kind() == prim::FusedConcat ||
+          node->kind() == prim::ConstantChunk || node->mustBeNone()) {
+        continue;
+      }
+      auto result = lowerNode(node);
+      if (!result) {
+        return false;
+      }
+      values_[node->output()] = *result;
+    }
+    for (size_t i = 0; i < flat_outputs.size(); ++i) {
+      auto it = values_.find(flat_outputs[i].first);
+      if (it == values_.end()) {
+        return false;
+      }
+      storeElement(output_tensors[i], index, it->second);
+    }
+
+    auto* next = builder_.CreateAdd(
+        index, builder_.getInt32(1), "next", /*HasNUW=*/true);
+    index->addIncoming(next, builder_.GetInsertBlock());
+    builder_.CreateCondBr(builder_.CreateICmpULT(next, end), loop, exit);
+
+    builder_.SetInsertPoint(exit);
+    builder_.CreateRetVoid();
+    return true;
+  }
+
+ private:
+  struct TensorArg {
+    at::ScalarType type;
+    llvm::Value* data;
+    std::vector<llvm::Value*> sizes;
+    std::vector<llvm::Value*> strides;
+    bool last_is_contiguous;
+  };
+
+  // The type of a value of scalar type, or nullptr if there's none
+  llvm::Type* llvmType(at::ScalarType type) {
+    switch (type) {
+      case at::kBool:
+        return builder_.getInt1Ty();
+      case at::kByte:
+      case at::kChar:
+        return builder_.getInt8Ty();
+      case at::kShort:
+        return builder_.getInt16Ty();
+      case at::kInt:
+        return builder_.getInt32Ty();
+      case at::kLong:
+        return builder_.getInt64Ty();
+      case at::kFloat:
+        return builder_.getFloatTy();
+      case at::kDouble:
+        return builder_.getDoubleTy();
+      default:
+        return nullptr;
+    }
+  }
+
+  // Bools are stored as bytes
+  llvm::Type* storageType(at::ScalarType type) {
+    return type == at::kBool ? builder_.getInt8Ty() : llvmType(type);
+  }
+
+  // Loads the data pointer, sizes and strides of a TensorInfo
+  TensorArg loadTensorArg(llvm::Value* info, const TensorDesc& desc) {
+    const size_t ndim = desc.nDim();
+    auto* dims_type = llvm::ArrayType::get(builder_.getInt32Ty(), ndim);
+    auto* info_type = llvm::StructType::get(
+        context_, {builder_.getInt8PtrTy(), dims_type, dims_type});
+    auto* info_ptr = builder_.CreateBitCast(info, info_type->getPointerTo());
+
+    TensorArg tensor;
+    tensor.type = desc.scalar_type;
+    tensor.last_is_contiguous = desc.lastIsContiguous();
+    tensor.data = builder_.CreateBitCast(
+        builder_.CreateLoad(
+            builder_.getInt8PtrTy(),
+            builder_.CreateStructGEP(info_type, info_ptr, 0)),
+        storageType(desc.scalar_type)->getPointerTo());
+    for (size_t d = 0; d < ndim; ++d) {
+      tensor.sizes.push_back(builder_.CreateLoad(
+          builder_.getInt32Ty(),
+          builder_.CreateConstInBoundsGEP2_32(info_type, info_ptr, 1, d)));
+      tensor.strides.push_back(builder_.CreateLoad(
+          builder_.getInt32Ty(),
+          builder_.CreateConstInBoundsGEP2_32(info_type, info_ptr, 2, d)));
+    }
+    return tensor;
+  }
+
+  // Same as emitIndexingFor in codegen.cpp
+  llvm::Value* elementPointer(const TensorArg& tensor, llvm::Value* index) {
+    const int ndim = tensor.sizes.size();
+    llvm::Value* offset = builder_.getInt32(0);
+    llvm::Value* linear_index = index;
+    for (int d = ndim - 1; d >= 0; --d) {
+      llvm::Value* dim_index = d > 0
+          ? builder_.CreateURem(linear_index, tensor.sizes[d])
+          : linear_index;
+      if (d < ndim - 1 || !tensor.last_is_contiguous) {
+        dim_index = builder_.CreateMul(dim_index, tensor.strides[d]);
+      }
+      offset = d == ndim - 1 ? dim_index : builder_.CreateAdd(offset, dim_index);
+      if (d > 0) {
+        linear_index = builder_.CreateUDiv(linear_index, tensor.sizes[d]);
+      }
+    }
+    return builder_.CreateInBoundsGEP(
+        storageType(tensor.type),
+        tensor.data,
+        builder_.CreateZExt(offset, builder_.getInt64Ty()));
+  }
+
+  Scalar loadElement(const TensorArg& tensor, llvm::Value* index) {
+    llvm::Value* value = builder_.CreateLoad(
+        storageType(tensor.type), elementPointer(tensor, index));
+    if (tensor.type == at::kBool) {
+      value = builder_.CreateICmpNE(value, builder_.getInt8(0));
+    }
+    return {value, tensor.type};
+  }
+
+  void storeElement(
+      const TensorArg& tensor,
+      llvm::Value* index,
+      const Scalar& scalar) {
+    llvm::Value* value = cast(scalar, tensor.type);
+    if (tensor.type == at::kBool) {
+      value = builder_.CreateZExt(value, builder_.getInt8Ty());
+    }
+    builder_.CreateStore(value, elementPointer(tensor, index));
+  }
+
+  llvm::Value* cast(const Scalar& scalar, at::ScalarType type) {
+    if (scalar.type == type) {
+      return scalar.value;
+    }
+    const bool from_float = at::isFloatingType(scalar.type);
+    const bool to_float = at::isFloatingType(type);
+    if (type == at::kBool) {
+      return from_float
+          ? builder_.CreateFCmpUNE(
+                scalar.value, llvm::ConstantFP::get(scalar.value->getType(), 0))
+          : builder_.CreateICmpNE(
+                scalar.value,
+                llvm::ConstantInt::get(scalar.value->getType(), 0));
+    }
+    auto* llvm_type = llvmType(type);
+    if (from_float && to_float) {
+      return builder_.CreateFPCast(scalar.value, llvm_type);
+    } else if (from_float) {
+      return isSigned(type) ? builder_.CreateFPToSI(scalar.value, llvm_type)
+                            : builder_.CreateFPToUI(scalar.value, llvm_type);
+    } else if (to_float) {
+      return isSigned(scalar.type)
+          ? builder_.CreateSIToFP(scalar.value, llvm_type)
+          : builder_.CreateUIToFP(scalar.value, llvm_type);
+    }
+    return builder_.CreateIntCast(
+        scalar.value, llvm_type, isSigned(scalar.type));
+  }
+
+  llvm::Value* constant(double value, at::ScalarType type) {
+    auto* llvm_type = llvmType(type);
+    if (at::isFloatingType(type)) {
+      return llvm::ConstantFP::get(llvm_type, value);
+    }
+    return llvm::ConstantInt::get(llvm_type, static_cast<int64_t>(value));
+  }
+
+  llvm::Value* callIntrinsic(llvm::Intrinsic::ID id, llvm::Value* x) {
+    return builder_.CreateCall(
+        llvm::Intrinsic::getDeclaration(&module_, id, {x->getType()}), {x});
+  }
+
+  llvm::Value* callIntrinsic(
+      llvm::Intrinsic::ID id,
+      llvm::Value* x,
+      llvm::Value* y) {
+    return builder_.CreateCall(
+        llvm::Intrinsic::getDeclaration(&module_, id, {x->getType()}), {x, y});
+  }
+
+  // Calls the libm function name, or its float version namef
+  llvm::Value* callLibm(
+      const std::string& name,
+      at::ScalarType type,
+      std::vector<llvm::Value*> args) {
+    auto* llvm_type = llvmType(type);
+    std::vector<llvm::Type*> arg_types(args.size(), llvm_type);
+    auto callee = module_.getOrInsertFunction(
+        type == at::kFloat ? name + "f" : name,
+        llvm::FunctionType::get(llvm_type, arg_types, false));
+    return builder_.CreateCall(callee, args);
+  }
+
+  llvm::Value* select(llvm::Value* cond, llvm::Value* x, llvm::Value* y) {
+    return builder_.CreateSelect(cond, x, y);
+  }
+
+  // The comparisons compute on the operands converted to their common type,
+  // like C++ does in the C++ kernels
+  llvm::Value* compare(const Node* node) {
+    auto x = values_.at(node->input(0));
+    auto y = values_.at(node->input(1));
+    at::ScalarType type = at::kLong;
+    if (at::isFloatingType(x.type) || at::isFloatingType(y.type)) {
+      type = x.type == at::kDouble || y.type == at::kDouble ? at::kDouble
+                                                             : at::kFloat;
+    }
+    llvm::Value* a = cast(x, type);
+    llvm::Value* b = cast(y, type);
+    const bool is_float = at::isFloatingType(type);
+    switch (node->kind()) {
+      case aten::eq:
+        return is_float ? builder_.CreateFCmpOEQ(a, b)
+                        : builder_.CreateICmpEQ(a, b);
+      case aten::ne:
+        return is_float ? builder_.CreateFCmpUNE(a, b)
+                        : builder_.CreateICmpNE(a, b);
+      case aten::lt:
+        return is_float ? builder_.CreateFCmpOLT(a, b)
+                        : builder_.CreateICmpSLT(a, b);
+      case aten::le:
+        return is_float ? builder_.CreateFCmpOLE(a, b)
+                        : builder_.CreateICmpSLE(a, b);
+      case aten::gt:
+        return is_float ? builder_.CreateFCmpOGT(a, b)
+                        : builder_.CreateICmpSGT(a, b);
+      default:
+        return is_float ? builder_.CreateFCmpOGE(a, b)
+                        : builder_.CreateICmpSGE(a, b);
+    }
+  }
+
+  c10::optional<Scalar> lowerConstant(const Node* node) {
+    const auto value = toIValue(node->output()).value();
+    if (value.isDouble()) {
+      return Scalar{constant(value.toDouble(), at::kDouble), at::kDouble};
+    } else if (value.isBool()) {
+      return Scalar{builder_.getInt1(value.toBool()), at::kBool};
+    } else if (value.isInt()) {
+      return Scalar{builder_.getInt64(value.toInt()), at::kLong};
+    }
+    return c10::nullopt;
+  }
+
+  // Same as encodeRHS in codegen.cpp: the inputs are converted to the scalar
+  // type of the output, except for comparisons
+  c10::optional<Scalar> lowerNode(const Node* node) {
+    if (node->kind() == prim::Constant) {
+      return lowerConstant(node);
+    }
+    const auto type = scalarTypeOf(node->output());
+    if (!type || !llvmType(*type)) {
+      return c10::nullopt;
+    }
+    const bool is_float = at::isFloatingType(*type);
+    std::vector<llvm::Value*> in;
+    for (const Value* input : node->inputs()) {
+      auto it = values_.find(input);
+      if (it != values_.end()) {
+        in.push_back(cast(it->second, *type));
+      } else if (input->node()->mustBeNone()) {
+        in.push_back(nullptr);
+      } else {
+        return c10::nullopt;
+      }
+    }
+    auto result = [&](llvm::Value* value) {
+      return c10::optional<Scalar>(Scalar{value, *type});
+    };
+    auto from_bool = [&](llvm::Value* value) {
+      return c10::optional<Scalar>(
+          Scalar{cast({value, at::kBool}, *type), *type});
+    };
+    auto one = [&]() {
+      return constant(1, *type);
+    };
+
+    // Only clamp takes None
+    if (node->kind() != aten::clamp &&
+        std::find(in.begin(), in.end(), nullptr) != in.end()) {
+      return c10::nullopt;
+    }
+
+    // Ops that don't compute on the value
+    switch (node->kind()) {
+      case aten::_cast_Float:
+      case aten::type_as:
+        return result(in[0]);
+      case aten::eq:
+      case aten::ne:
+      case aten::lt:
+      case aten::le:
+      case aten::gt:
+      case aten::ge:
+        return from_bool(compare(node));
+      case aten::__and__:
+        return from_bool(builder_.CreateAnd(
+            cast({in[0], *type}, at::kBool), cast({in[1], *type}, at::kBool)));
+      case aten::__or__:
+        return from_bool(builder_.CreateOr(
+            cast({in[0], *type}, at::kBool), cast({in[1], *type}, at::kBool)));
+      case aten::where:
+        return result(
+            select(cast(values_.at(node->input(0)), at::kBool), in[1], in[2]));
+      default:
+        break;
+    }
+    if (*type == at::kBool) {
+      return c10::nullopt;
+    }
+
+    // add and sub take alpha
+    if ((node->kind() == aten::add || node->kind() == aten::sub) &&
+        in.size() != 3) {
+      return c10::nullopt;
+    }
+    if (!is_float) {
+      switch (node->kind()) {
+        case aten::add:
+          return result(
+              builder_.CreateAdd(in[0], builder_.CreateMul(in[2], in[1])));
+        case aten::sub:
+          return result(
+              builder_.CreateSub(in[0], builder_.CreateMul(in[2], in[1])));
+        case aten::mul:
+          return result(builder_.CreateMul(in[0], in[1]));
+        case aten::div:
+          return result(
+              isSigned(*type) ? builder_.CreateSDiv(in[0], in[1])
+                              : builder_.CreateUDiv(in[0], in[1]));
+        case aten::neg:
+          return result(builder_.CreateNeg(in[0]));
+        case aten::abs:
+          return result(select(
+              builder_.CreateICmpSLT(in[0], constant(0, *type)),
+              builder_.CreateNeg(in[0]),
+              in[0]));
+        case aten::relu:
+          return result(select(
+              builder_.CreateICmpSLT(in[0], constant(0, *type)),
+              constant(0, *type),
+              in[0]));
+        case aten::min:
+          return result(
+              select(builder_.CreateICmpSLT(in[0], in[1]), in[0], in[1]));
+        case aten::max:
+          return result(
+              select(builder_.CreateICmpSGT(in[0], in[1]), in[0], in[1]));
+        case aten::__xor__:
+          return result(builder_.CreateXor(in[0], in[1]));
+        case aten::__lshift__:
+          return result(builder_.CreateShl(in[0], in[1]));
+        case aten::__rshift__:
+          return result(
+              isSigned(*type) ? builder_.CreateAShr(in[0], in[1])
+                              : builder_.CreateLShr(in[0], in[1]));
+        default:
+          return c10::nullopt;
+      }
+    }
+
+    switch (node->kind()) {
+      // unary
+      case aten::abs:
+        return result(callIntrinsic(llvm::Intrinsic::fabs, in[0]));
+      case aten::sigmoid:
+        return result(builder_.CreateFDiv(
+            one(),
+            builder_.CreateFAdd(
+                one(),
+                callIntrinsic(llvm::Intrinsic::exp, builder_.CreateFNeg(in[0])))));
+      case aten::relu:
+        return result(select(
+            builder_.CreateFCmpOLT(in[0], constant(0, *type)),
+            constant(0, *type),
+            in[0]));
+      case aten::threshold:
+        return result(
+            select(builder_.CreateFCmpOLE(in[0], in[1]), in[2], in[0]));
+      case aten::log:
+        return result(callIntrinsic(llvm::Intrinsic::log, in[0]));
+      case aten::log10:
+        return result(callIntrinsic(llvm::Intrinsic::log10, in[0]));
+      case aten::log2:
+        return result(callIntrinsic(llvm::Intrinsic::log2, in[0]));
+      case aten::exp:
+        return result(callIntrinsic(llvm::Intrinsic::exp, in[0]));
+      case aten::sqrt:
+        return result(callIntrinsic(llvm::Intrinsic::sqrt, in[0]));
+      case aten::rsqrt:
+        return result(builder_.CreateFDiv(
+            one(), callIntrinsic(llvm::Intrinsic::sqrt, in[0])));
+      case aten::cos:
+        return result(callIntrinsic(llvm::Intrinsic::cos, in[0]));
+      case aten::sin:
+        return result(callIntrinsic(llvm::Intrinsic::sin, in[0]));
+      case aten::ceil:
+        return result(callIntrinsic(llvm::Intrinsic::ceil, in[0]));
+      case aten::floor:
+        return result(callIntrinsic(llvm::Intrinsic::floor, in[0]));
+      case aten::round:
+        return result(callIntrinsic(llvm::Intrinsic::round, in[0]));
+      case aten::trunc:
+        return result(callIntrinsic(llvm::Intrinsic::trunc, in[0]));
+      case aten::frac:
+        return result(builder_.CreateFSub(
+            in[0], callIntrinsic(llvm::Intrinsic::trunc, in[0])));
+      case aten::reciprocal:
+        return result(builder_.CreateFDiv(one(), in[0]));
+      case aten::neg:
+        return result(builder_.CreateFNeg(in[0]));
+      case aten::log1p:
+        return result(callLibm("log1p", *type, {in[0]}));
+      case aten::lgamma:
+        return result(callLibm("lgamma", *type, {in[0]}));
+      case aten::expm1:
+        return result(callLibm("expm1", *type, {in[0]}));
+      case aten::erf:
+        return result(callLibm("erf", *type, {in[0]}));
+      case aten::erfc:
+        return result(callLibm("erfc", *type, {in[0]}));
+      case aten::acos:
+        return result(callLibm("acos", *type, {in[0]}));
+      case aten::cosh:
+        return result(callLibm("cosh", *type, {in[0]}));
+      case aten::asin:
+        return result(callLibm("asin", *type, {in[0]}));
+      case aten::sinh:
+        return result(callLibm("sinh", *type, {in[0]}));
+      case aten::tan:
+        return result(callLibm("tan", *type, {in[0]}));
+      case aten::atan:
+        return result(callLibm("atan", *type, {in[0]}));
+      case aten::tanh:
+        return result(callLibm("tanh", *type, {in[0]}));
+
+      // binary
+      case aten::atan2:
+        return result(callLibm("atan2", *type, {in[0], in[1]}));
+      case aten::min:
+        return result(callIntrinsic(llvm::Intrinsic::minnum, in[0], in[1]));
+      case aten::max:
+        return result(callIntrinsic(llvm::Intrinsic::maxnum, in[0], in[1]));
+      case aten::pow:
+        return result(callIntrinsic(llvm::Intrinsic::pow, in[0], in[1]));
+      case aten::fmod:
+        return result(builder_.CreateFRem(in[0], in[1]));
+      case aten::mul:
+        return result(builder_.CreateFMul(in[0], in[1]));
+      case aten::div:
+        return result(builder_.CreateFDiv(in[0], in[1]));
+      case aten::add:
+        return result(
+            builder_.CreateFAdd(in[0], builder_.CreateFMul(in[2], in[1])));
+      case aten::sub:
+        return result(
+            builder_.CreateFSub(in[0], builder_.CreateFMul(in[2], in[1])));
+      case aten::addcmul:
+        return result(builder_.CreateFAdd(
+            in[0],
+            builder_.CreateFMul(builder_.CreateFMul(in[3], in[1]), in[2])));
+      case aten::lerp:
+        return result(builder_.CreateFAdd(
+            in[0],
+            builder_.CreateFMul(in[2], builder_.CreateFSub(in[1], in[0]))));
+
+      // The bounds come first so that a NaN bound is ignored, and a NaN input
+      // stays NaN
+      case aten::clamp: {
+        llvm::Value* x = in[0];
+        if (in[2]) {
+          x = select(builder_.CreateFCmpOGT(in[0], in[2]), in[2], in[0]);
+        }
+        if (in[1]) {
+          x = select(builder_.CreateFCmpOLT(in[0], in[1]), in[1], x);
+        }
+        return result(x);
+      }
+
+      // simple derivatives
+      case aten::_sigmoid_backward:
+        return result(builder_.CreateFMul(
+            builder_.CreateFMul(in[0], in[1]),
+            builder_.CreateFSub(one(), in[1])));
+      case aten::_tanh_backward:
+        return result(builder_.CreateFMul(
+            in[0],
+            builder_.CreateFSub(one(), builder_.CreateFMul(in[1], in[1]))));
+      default:
+        return c10::nullopt;
+    }
+  }
+
+  llvm::LLVMContext& context_;
+  llvm::Module& module_;
+  llvm::IRBuilder<> builder_;
+  llvm::Function* function_ = nullptr;
+  std::unordered_map<const Value*, Scalar> values_;
+};
+
+} // namespace
+
+std::shared_ptr<FusedKernel> compileLLVMKernel(
+    const std::string& name,
+    const Graph& graph,
+    const std::vector<std::pair<const Value*, const c10::optional<TensorDesc>>>&
+        flat_inputs,
+    const std::vector<std::pair<const Value*, const TensorDesc>>& flat_outputs,
+    std::vector<TensorDesc> input_desc,
+    std::vector<TensorDesc> output_desc,
+    std::vector<PartitionDesc> chunk_desc,
+    std::vector<PartitionDesc> concat_desc,
+    bool has_random) {
+  if (has_random) {
+    return nullptr;
+  }
+  auto context = std::make_unique<llvm::LLVMContext>();
+  auto module = std::make_unique<llvm::Module>(name, *context);
+  if (!KernelLowering(*context, *module)
+           .lower(name, graph, flat_inputs, flat_outputs)) {
+    return nullptr;
+  }
+  std::string errors;
+  llvm::raw_string_ostream error_stream(errors);
+  TORCH_INTERNAL_ASSERT(
+      !llvm::verifyModule(*module, &error_stream),
+      "LLVM fuser backend generated invalid IR: ",
+      error_stream.str());
+
+  auto compiled = getJIT().compile(std::move(context), std::move(module), name);
+  if (debugFuser()) {
+    std::cerr << "fusion code:" << compiled.first << std::endl;
+  }
+  return std::make_shared<FusedKernelLLVM>(
+      name,
+      std::move(compiled.first),
+      std::move(input_desc),
+      std::move(output_desc),
+      std::move(chunk_desc),
+      std::move(concat_desc),
+      has_random,
+      compiled.second);
+}
+
+} // namespace cpu
+} // namespace fuser
+} // namespace jit
+} // namespace torch
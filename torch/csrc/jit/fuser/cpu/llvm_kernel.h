@@ -0,0 +1,43 @@
+#pragma once
+
+#include <torch/csrc/WindowsTorchApiMacro.h>
+#include <torch/csrc/jit/fuser/fused_kernel.h>
+#include <torch/csrc/jit/ir.h>
+
+#include <c10/util/Optional.h>
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace torch {
+namespace jit {
+namespace fuser {
+namespace cpu {
+
+// Compiles a fusion group to machine code in process with LLVM's ORC JIT,
+// instead of generating C++ and running the system compiler on it. The
+// kernel takes the same arguments as the C++ kernels (see launchFusion), is
+// optimized and vectorized for the host CPU, and runs in parallel with
+// at::parallel_for rather than OpenMP.
+//
+// Returns nullptr when the graph uses an op or a scalar type the LLVM
+// lowering doesn't handle, in which case the caller falls back on the C++
+// kernel.
+TORCH_API std::shared_ptr<FusedKernel> compileLLVMKernel(
+    const std::string& name,
+    const Graph& graph,
+    const std::vector<std::pair<const Value*, const c10::optional<TensorDesc>>>&
+        flat_inputs,
+    const std::vector<std::pair<const Value*, const TensorDesc>>& flat_outputs,
+    std::vector<TensorDesc> input_desc,
+    std::vector<TensorDesc> output_desc,
+    std::vector<PartitionDesc> chunk_desc,
+    std::vector<PartitionDesc> concat_desc,
+    bool has_random);
+
+} // namespace cpu
+} // namespace fuser
+} // namespace jit
+} // namespace torch
@@ -1,5 +1,6 @@
 #include <torch/csrc/jit/fuser/cuda/fused_kernel.h>
 #include <torch/csrc/jit/fuser/compiler.h>
+#include <torch/csrc/jit/fuser/disk_cache.h>
 
 #include <ATen/ATen.h>
 #include <ATen/cuda/CUDAContext.h>
@@ -73,7 +74,8 @@ FusedKernelCUDA::FusedKernelCUDA(
     std::vector<TensorDesc> output_desc,
     std::vector<PartitionDesc> chunk_desc,
     std::vector<PartitionDesc> concat_desc,
-    bool has_random)
+    bool has_random,
+    c10::optional<ReductionDesc> reduction_desc)
     : FusedKernel(
           std::move(name),
           std::move(code),
@@ -81,7 +83,8 @@ FusedKernelCUDA::FusedKernelCUDA(
           std::move(output_desc),
           std::move(chunk_desc),
           std::move(concat_desc),
-          has_random),
+          has_random,
+          std::move(reduction_desc)),
       device_(device) {
   // Initializes driver's API context (if necessary)
   CUcontext pctx = 0;
@@ -103,37 +106,50 @@ FusedKernelCUDA::FusedKernelCUDA(
   int major, minor;
   getMajorMinor(prop_, major, minor);
 
-  // Creates the NVRTC program
-  nvrtcProgram program;
-  AT_CUDA_NVRTC_CHECK(nvrtc().nvrtcCreateProgram(
-      &program, code_.c_str(), nullptr, 0, nullptr, nullptr));
-
 #ifdef __HIP_PLATFORM_HCC__
   std::vector<const char*> args = {};
+  const std::string toolkit = "HIP";
 #else
   const std::string compute = "--gpu-architecture=compute_" +
       std::to_string(major) + std::to_string(minor);
   const std::vector<const char*> args = {
       "--std=c++11", compute.c_str(), "-default-device"};
+  const std::string toolkit = "CUDA " + std::to_string(CUDA_VERSION);
 #endif
-  const auto result =
-      nvrtc().nvrtcCompileProgram(program, args.size(), args.data());
-  if (result != NVRTC_SUCCESS) {
-    size_t logsize;
-    nvrtc().nvrtcGetProgramLogSize(program, &logsize);
-    std::vector<char> log(logsize);
-    nvrtc().nvrtcGetProgramLog(program, log.data());
-    std::stringstream cu;
-    cu << log.data();
-    throw std::runtime_error(cu.str());
+
+  // The PTX depends on the architecture and the toolkit besides the code
+  std::string cache_source = code_ + "\n// " + toolkit;
+  for (const char* arg : args) {
+    cache_source = cache_source + " " + arg;
+  }
+  if (auto binary = loadCachedBinary(cache_source)) {
+    ptx_.assign(binary->begin(), binary->end());
+  } else {
+    // Creates the NVRTC program
+    nvrtcProgram program;
+    AT_CUDA_NVRTC_CHECK(nvrtc().nvrtcCreateProgram(
+        &program, code_.c_str(), nullptr, 0, nullptr, nullptr));
+
+    const auto result =
+        nvrtc().nvrtcCompileProgram(program, args.size(), args.data());
+    if (result != NVRTC_SUCCESS) {
+      size_t logsize;
+      nvrtc().nvrtcGetProgramLogSize(program, &logsize);
+      std::vector<char> log(logsize);
+      nvrtc().nvrtcGetProgramLog(program, log.data());
+      std::stringstream cu;
+      cu << log.data();
+      throw std::runtime_error(cu.str());
+    }
+    ResourceGuard holdProgram(
+        [&] { AT_CUDA_NVRTC_CHECK(nvrtc().nvrtcDestroyProgram(&program)); });
+    AT_CUDA_NVRTC_CHECK(result);
+    size_t ptx_size;
+    AT_CUDA_NVRTC_CHECK(nvrtc().nvrtcGetPTXSize(program, &ptx_size));
+    ptx_.resize(ptx_size);
+    AT_CUDA_NVRTC_CHECK(nvrtc().nvrtcGetPTX(program, ptx_.data()));
+    storeCachedBinary(cache_source, std::string(ptx_.begin(), ptx_.end()));
   }
-  ResourceGuard holdProgram(
-      [&] { AT_CUDA_NVRTC_CHECK(nvrtc().nvrtcDestroyProgram(&program)); });
-  AT_CUDA_NVRTC_CHECK(result);
-  size_t ptx_size;
-  AT_CUDA_NVRTC_CHECK(nvrtc().nvrtcGetPTXSize(program, &ptx_size));
-  ptx_.resize(ptx_size);
-  AT_CUDA_NVRTC_CHECK(nvrtc().nvrtcGetPTX(program, ptx_.data()));
 
   AT_CUDA_DRIVER_CHECK(nvrtc().cuModuleLoadData(&module_, ptx_.data()));
   AT_CUDA_DRIVER_CHECK(
@@ -160,6 +176,17 @@ static int ceilDiv(const int a, const int b) {
   return (a + b - 1) / b;
 }
 
+// Row kernels keep a double per thread for their block reductions, followed
+// by the cached values of the row they reduce
+size_t FusedKernelCUDA::rowSharedBytes(const uint32_t row_size) const {
+  return kBlockSize * sizeof(double) +
+      row_size * reduction_desc_->shared_bytes_per_element;
+}
+
+bool FusedKernelCUDA::canReduceRows(const uint32_t row_size) const {
+  return reduction_desc_ && rowSharedBytes(row_size) <= prop_->sharedMemPerBlock;
+}
+
 void FusedKernelCUDA::launch_raw(
     const uint32_t numel,
     std::vector<void*>& arguments) const {
@@ -168,7 +195,17 @@ void FusedKernelCUDA::launch_raw(
   const auto prior_device = at::cuda::current_device();
   at::cuda::set_device(device_);
 
-  const auto nBlocks = std::min(maxBlocks_, ceilDiv(numel, kBlockSize));
+  // Row kernels run a block per row, and take the row size as their last
+  // argument (see launchFusion)
+  int nBlocks;
+  size_t shared_bytes = 0;
+  if (reduction_desc_) {
+    const auto row_size = *static_cast<uint32_t*>(arguments.back());
+    nBlocks = std::min(maxBlocks_, static_cast<int>(numel / row_size));
+    shared_bytes = rowSharedBytes(row_size);
+  } else {
+    nBlocks = std::min(maxBlocks_, ceilDiv(numel, kBlockSize));
+  }
 
   // Adds random state to arguments if necessary
   // Note: philox_engine_inputs defined here so its lifetime extends to the launch
@@ -196,7 +233,7 @@ void FusedKernelCUDA::launch_raw(
       kBlockSize,
       1,
       1,
-      0,
+      shared_bytes,
       stream,
       arguments.data(),
       nullptr));
@@ -217,7 +254,8 @@ static std::shared_ptr<FusedKernel> createFusionKernel(
     std::vector<TensorDesc> output_desc,
     std::vector<PartitionDesc> chunk_desc,
     std::vector<PartitionDesc> concat_desc,
-    bool has_random) {
+    bool has_random,
+    c10::optional<ReductionDesc> reduction_desc) {
   return std::make_shared<FusedKernelCUDA>(
       device,
       std::move(name),
@@ -226,7 +264,8 @@ static std::shared_ptr<FusedKernel> createFusionKernel(
       std::move(output_desc),
       std::move(chunk_desc),
       std::move(concat_desc),
-      has_random);
+      has_random,
+      std::move(reduction_desc));
 }
 
 RegisterFusionBackend reg(at::DeviceType::CUDA, createFusionKernel);
@@ -28,7 +28,8 @@ struct TORCH_CUDA_API FusedKernelCUDA : public ::torch::jit::fuser::FusedKernel
       std::vector<TensorDesc> output_desc,
       std::vector<PartitionDesc> chunk_desc,
       std::vector<PartitionDesc> concat_desc,
-      bool has_random);
+      bool has_random,
+      c10::optional<ReductionDesc> reduction_desc);
 
   ~FusedKernelCUDA() override;
 
@@ -39,9 +40,13 @@ struct TORCH_CUDA_API FusedKernelCUDA : public ::torch::jit::fuser::FusedKernel
     return at::Backend::CUDA;
   }
 
+  bool canReduceRows(const uint32_t row_size) const override;
+
  private:
   static constexpr auto kBlockSize = 128;
 
+  size_t rowSharedBytes(const uint32_t row_size) const;
+
   // Note: per device to store device properties and compute launch heuristics
   //  Acquiring these values at launch time would be too slow
   int16_t device_;
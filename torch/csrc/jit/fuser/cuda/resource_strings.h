@@ -182,6 +182,65 @@ void ${kernelName}(IndexType totalElements, ${formals} ${RandParam}) {
 }
 )");
 
+// Row kernels run a block per row of the map size, whose threads loop over the
+// row once per phase; see generateKernel. The block reductions use the first
+// blockDim.x doubles of the dynamic shared memory, the rest caches the values
+// the later phases read again.
+static auto cuda_row_reduction_template = CodeTemplate(R"(
+${type_declarations}
+${RowReductionHeader}
+
+extern "C" __global__
+void ${kernelName}(IndexType totalElements, ${formals}, IndexType rowSize) {
+  extern __shared__ double rowShared[];
+  double* reduceScratch = rowShared;
+  char* rowCache = reinterpret_cast<char*>(rowShared + blockDim.x);
+  ${rowCaches}
+  ${uniformValues}
+  const IndexType totalRows = totalElements / rowSize;
+  for (IndexType row = blockIdx.x; row < totalRows; row += gridDim.x) {
+    ${rowBody}
+  }
+}
+)");
+
+// Tree reductions over the threads of a block, whose size must be a power of
+// two. Every thread of the block gets the result.
+constexpr auto row_reduction_support_literal = R"(
+template <typename T>
+__device__ T blockReduceSum(T value, double* scratch) {
+  T* shared = reinterpret_cast<T*>(scratch);
+  __syncthreads();
+  shared[threadIdx.x] = value;
+  __syncthreads();
+  for (unsigned int stride = blockDim.x / 2; stride > 0; stride >>= 1) {
+    if (threadIdx.x < stride) {
+      shared[threadIdx.x] += shared[threadIdx.x + stride];
+    }
+    __syncthreads();
+  }
+  return shared[0];
+}
+
+template <typename T>
+__device__ T blockReduceMax(T value, double* scratch) {
+  T* shared = reinterpret_cast<T*>(scratch);
+  __syncthreads();
+  shared[threadIdx.x] = value;
+  __syncthreads();
+  for (unsigned int stride = blockDim.x / 2; stride > 0; stride >>= 1) {
+    if (threadIdx.x < stride) {
+      const T other = shared[threadIdx.x + stride];
+      if (other > shared[threadIdx.x]) {
+        shared[threadIdx.x] = other;
+      }
+    }
+    __syncthreads();
+  }
+  return shared[0];
+}
+)";
+
 // This snippet enables half support in the jit. Following the pattern for
 // reductions, fp16 input data is immediately upconverted to float
 // with __half2float(). All mathematical operations are done on float
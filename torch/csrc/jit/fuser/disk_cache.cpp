@@ -0,0 +1,199 @@
+#include <torch/csrc/jit/fuser/disk_cache.h>
+
+#include <torch/csrc/jit/fuser/compiler.h>
+
+#ifndef _WIN32
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utime.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace torch {
+namespace jit {
+namespace fuser {
+
+// Every cached file starts with the magic, followed by the size of the source,
+// the source and the binary
+static const std::string kMagic = "PYTORCH_FUSED_KERNEL_1\n";
+static const std::string kSuffix = ".kernel";
+static constexpr uint64_t kDefaultSizeLimitMB = 1024;
+
+c10::optional<std::string> diskCacheDir() {
+#ifdef _WIN32
+  return c10::nullopt;
+#else
+  const char* dir = getenv("PYTORCH_FUSION_CACHE_DIR");
+  if (!dir || dir[0] == '\0') {
+    return c10::nullopt;
+  }
+  return std::string(dir);
+#endif
+}
+
+static uint64_t sizeLimitBytes() {
+  uint64_t limit_mb = kDefaultSizeLimitMB;
+  if (const char* limit_env = getenv("PYTORCH_FUSION_CACHE_SIZE_MB")) {
+    limit_mb = std::strtoull(limit_env, nullptr, 10);
+  }
+  return limit_mb << 20;
+}
+
+// 64-bit FNV-1a, std::hash is not guaranteed to be the same across builds
+std::string diskCacheHash(const std::string& str) {
+  uint64_t hash = 14695981039346656037ULL;
+  for (const char c : str) {
+    hash ^= static_cast<unsigned char>(c);
+    hash *= 1099511628211ULL;
+  }
+  char hex[17];
+  snprintf(hex, sizeof(hex), "%016llx", static_cast<unsigned long long>(hash));
+  return hex;
+}
+
+#ifndef _WIN32
+
+static std::string pathOf(const std::string& dir, const std::string& source) {
+  return dir + "/" + diskCacheHash(source) + kSuffix;
+}
+
+static void warn(const std::string& message) {
+  if (debugFuser()) {
+    std::cerr << "warning: fused kernel disk cache: " << message << "\n";
+  }
+}
+
+// Deletes the least recently used files of the cache until it fits in its
+// size limit
+static void evict(const std::string& dir) {
+  DIR* d = opendir(dir.c_str());
+  if (!d) {
+    return;
+  }
+  // (last use, size, path) of the cached files
+  std::vector<std::tuple<time_t, uint64_t, std::string>> files;
+  uint64_t total = 0;
+  while (const dirent* entry = readdir(d)) {
+    const std::string name = entry->d_name;
+    if (name.size() <= kSuffix.size() ||
+        name.compare(name.size() - kSuffix.size(), kSuffix.size(), kSuffix) !=
+            0) {
+      continue;
+    }
+    const std::string path = dir + "/" + name;
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0 || !S_ISREG(st.st_mode)) {
+      continue;
+    }
+    files.emplace_back(st.st_mtime, st.st_size, path);
+    total += st.st_size;
+  }
+  closedir(d);
+
+  const uint64_t limit = sizeLimitBytes();
+  std::sort(files.begin(), files.end());
+  for (const auto& file : files) {
+    if (total <= limit) {
+      break;
+    }
+    // Another process may have evicted it already
+    unlink(std::get<2>(file).c_str());
+    total -= std::get<1>(file);
+  }
+}
+
+#endif
+
+c10::optional<std::string> loadCachedBinary(const std::string& source) {
+#ifdef _WIN32
+  return c10::nullopt;
+#else
+  const auto dir = diskCacheDir();
+  if (!dir) {
+    return c10::nullopt;
+  }
+  const std::string path = pathOf(*dir, source);
+  std::ifstream file(path, std::ios::binary);
+  if (!file) {
+    return c10::nullopt;
+  }
+  std::stringstream contents;
+  contents << file.rdbuf();
+  const std::string data = contents.str();
+
+  // Checks the whole source, rather than trusting the hash of the file name
+  uint64_t source_size = 0;
+  const size_t header_size = kMagic.size() + sizeof(source_size);
+  if (data.size() < header_size || data.compare(0, kMagic.size(), kMagic)) {
+    warn("ignoring the malformed " + path);
+    return c10::nullopt;
+  }
+  std::copy_n(
+      &data[kMagic.size()],
+      sizeof(source_size),
+      reinterpret_cast<char*>(&source_size));
+  if (source_size != source.size() ||
+      data.size() < header_size + source_size ||
+      data.compare(header_size, source_size, source) != 0) {
+    return c10::nullopt;
+  }
+
+  // Marks the binary as recently used, for eviction
+  utime(path.c_str(), nullptr);
+  return data.substr(header_size + source_size);
+#endif
+}
+
+void storeCachedBinary(const std::string& source, const std::string& binary) {
+#ifndef _WIN32
+  const auto dir = diskCacheDir();
+  if (!dir) {
+    return;
+  }
+  // Creates the directory, if it doesn't exist
+  mkdir(dir->c_str(), 0755);
+
+  // Writes a temporary file that is renamed in place, so that other
+  // processes never read a partial file
+  static std::atomic<uint64_t> next_temp_id{0};
+  const std::string path = pathOf(*dir, source);
+  const std::string temp_path = path + ".tmp" + std::to_string(getpid()) +
+      "_" + std::to_string(next_temp_id++);
+  {
+    std::ofstream file(temp_path, std::ios::binary);
+    const uint64_t source_size = source.size();
+    file << kMagic;
+    file.write(
+        reinterpret_cast<const char*>(&source_size), sizeof(source_size));
+    file << source << binary;
+    file.close();
+    if (!file) {
+      warn("failed to write " + temp_path);
+      unlink(temp_path.c_str());
+      return;
+    }
+  }
+  if (rename(temp_path.c_str(), path.c_str()) != 0) {
+    warn("failed to write " + path);
+    unlink(temp_path.c_str());
+    return;
+  }
+  evict(*dir);
+#endif
+}
+
+} // namespace fuser
+} // namespace jit
+} // namespace torch
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <c10/util/Optional.h>
+#include <torch/csrc/WindowsTorchApiMacro.h>
+
+#include <string>
+
+namespace torch {
+namespace jit {
+namespace fuser {
+
+// A cache of compiled kernels on disk, shared by the processes that set
+// PYTORCH_FUSION_CACHE_DIR to the same directory, so that they don't compile
+// the same fusion groups again. When the variable isn't set kernels are only
+// cached in memory, for the lifetime of the process.
+//
+// The backends store the binaries they compile (PTX, shared libraries) keyed
+// by the source they compiled, which includes the kernel code and what the
+// binary depends on besides it, like the GPU architecture or the compiler
+// flags. The kernels are named after the normalized graph and the tensor
+// descriptions they are generated from while the cache is enabled, so that
+// their code is the same in every process (see compileKernel).
+//
+// The cache is bounded by PYTORCH_FUSION_CACHE_SIZE_MB megabytes (1024 by
+// default), evicting the least recently used binaries first.
+// Note: not supported on Windows, where the cache is always disabled.
+
+// Returns the cache directory, if the cache is enabled
+TORCH_API c10::optional<std::string> diskCacheDir();
+
+// A hash of the string that is the same in every process, in hex
+TORCH_API std::string diskCacheHash(const std::string& str);
+
+// Returns the binary stored for the given source, if there is one
+TORCH_API c10::optional<std::string> loadCachedBinary(const std::string& source);
+
+// Stores the binary compiled from the given source, then evicts binaries
+// until the cache fits in its size limit.
+// Note: failures are not errors, the binary is simply not cached
+TORCH_API void storeCachedBinary(
+    const std::string& source,
+    const std::string& binary);
+
+} // namespace fuser
+} // namespace jit
+} // namespace torch
@@ -288,11 +288,20 @@ void launchFusion(
   }
 
   // Adds (flattened) output arguments
+  // Note: the outputs of row reductions have a single element per row
   outputs.reserve(fusion.outputDesc().size());
   const auto& ref_options = inputs[0].options();
+  const auto& reduction_desc = fusion.reductionDesc();
   for (size_t i = 0; i < fusion.outputDesc().size(); ++i) {
     const auto& c = fusion.concatDesc()[i];
-    if (c.isNoop()) {
+    if (reduction_desc && reduction_desc->reduced_outputs[i]) {
+      std::vector<int64_t> reduced_size(map_size.begin(), map_size.end());
+      reduced_size.back() = 1;
+      outputs.push_back(at::empty(
+          reduced_size,
+          ref_options.dtype(fusion.outputDesc()[i].scalar_type)));
+      addTensorInfo(fusion.outputDesc()[i], outputs[i]);
+    } else if (c.isNoop()) {
       outputs.push_back(at::empty(
           map_size, ref_options.dtype(fusion.outputDesc()[i].scalar_type)));
       addTensorInfo(fusion.outputDesc()[i], outputs[i]);
@@ -313,6 +322,12 @@ void launchFusion(
       }
     }
   }
+  // Row kernels take the size of the rows they reduce
+  uint32_t row_size = 0;
+  if (reduction_desc) {
+    row_size = map_size.back();
+    arguments.push_back(&row_size);
+  }
   // Skip launching the kernel for zero-element tensor inputs
   // launches are skipped, empty zero-sized output is returned
   if (numel > 0) {
@@ -360,12 +375,18 @@ bool runFusion(const int64_t key, Stack& stack, std::string* code_out) {
   if (device.is_cpu() && !canFuseOnCPU())
     return false;
 
+  // Row reductions are only fused for CUDA, without random numbers
+  if (spec.reducesRows() && (!device.is_cuda() || spec.hasRandom()))
+    return false;
+
   // Validates sizes and expands inputs as needed
   auto maybe_map_size = canRunKernel(spec, inputs);
 
   // Tries to run fallback if map size can't be computed
   if (!maybe_map_size)
     return false;
+  if (spec.reducesRows() && maybe_map_size->empty())
+    return false;
   if (spec.hasRandom()) {
     bool hasBroadcast = shouldExpandArgs(spec, inputs, *maybe_map_size);
     if (hasBroadcast)
@@ -383,6 +404,12 @@ bool runFusion(const int64_t key, Stack& stack, std::string* code_out) {
   maybe_kernel = spec.findKernel(arg_spec);
   AT_ASSERT(maybe_kernel);
 
+  // Tries to run fallback if the rows don't fit in shared memory
+  const auto& kernel = *maybe_kernel;
+  if (kernel->reductionDesc() &&
+      !kernel->canReduceRows(maybe_map_size->back()))
+    return false;
+
   if (code_out) {
     *code_out = maybe_kernel.value()->code();
   }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <ATen/ATen.h>
+#include <c10/util/Optional.h>
 #include <torch/csrc/jit/fuser/partition_desc.h>
 #include <torch/csrc/jit/fuser/tensor_desc.h>
 #include <torch/csrc/utils/disallow_copy.h>
@@ -13,6 +14,19 @@ namespace torch {
 namespace jit {
 namespace fuser {
 
+// The layout of a kernel that reduces the rows of the map size (see
+// generateKernel). These kernels run a block per row, and take the size of the
+// rows after their flat outputs.
+struct ReductionDesc {
+  // The bytes of shared memory that each element of a row needs, to keep the
+  // values that later phases of the kernel read again
+  size_t shared_bytes_per_element = 0;
+
+  // Same size as output_desc, whether each output has a single element per
+  // row, i.e. the map size with a last dimension of 1
+  std::vector<bool> reduced_outputs;
+};
+
 struct FusedKernel {
   TH_DISALLOW_COPY_AND_ASSIGN(FusedKernel);
 
@@ -23,14 +37,16 @@ struct FusedKernel {
       std::vector<TensorDesc> output_desc,
       std::vector<PartitionDesc> chunk_desc,
       std::vector<PartitionDesc> concat_desc,
-      bool has_random)
+      bool has_random,
+      c10::optional<ReductionDesc> reduction_desc = c10::nullopt)
       : name_(std::move(name)),
         code_(std::move(code)),
         input_desc_(std::move(input_desc)),
         output_desc_(std::move(output_desc)),
         chunk_desc_(std::move(chunk_desc)),
         concat_desc_(std::move(concat_desc)),
-        has_random_(has_random) {}
+        has_random_(has_random),
+        reduction_desc_(std::move(reduction_desc)) {}
 
   virtual ~FusedKernel() = default;
 
@@ -48,6 +64,12 @@ struct FusedKernel {
       const = 0;
   virtual at::Backend backend() const = 0;
 
+  // Whether a kernel with a reduction_desc can reduce rows of row_size
+  // elements, whose values it keeps in shared memory
+  virtual bool canReduceRows(const uint32_t row_size) const {
+    return false;
+  }
+
   // Getters
   const std::string& name() const {
     return name_;
@@ -70,6 +92,9 @@ struct FusedKernel {
   bool hasRandom() const {
     return has_random_;
   }
+  const c10::optional<ReductionDesc>& reductionDesc() const {
+    return reduction_desc_;
+  }
 
  protected:
   const std::string name_;
@@ -88,6 +113,9 @@ struct FusedKernel {
   const std::vector<PartitionDesc> concat_desc_;
 
   const bool has_random_;
+
+  // set for kernels that reduce rows
+  const c10::optional<ReductionDesc> reduction_desc_;
 };
 
 } // namespace fuser
@@ -4,6 +4,7 @@
 #include <c10/util/Optional.h>
 #include <torch/csrc/WindowsTorchApiMacro.h>
 #include <torch/csrc/jit/fuser/arg_spec.h>
+#include <torch/csrc/jit/fuser/codegen.h>
 #include <torch/csrc/jit/fuser/fused_kernel.h>
 #include <torch/csrc/jit/fuser/interface.h>
 #include <torch/csrc/jit/interpreter.h>
@@ -65,11 +66,14 @@ struct TORCH_API KernelSpec {
         inputBroadcastGroups_{},
         inputChunks_{},
         has_random_{false},
+        reduces_rows_{false},
         kernels_{} {
     for (const auto& n : graph_->nodes()) {
       if (n->kind() == aten::rand_like) {
         has_random_ = true;
-        break;
+      }
+      if (isRowOp(n)) {
+        reduces_rows_ = true;
       }
     }
     nTensorInputs_ = std::count_if(
@@ -113,6 +117,11 @@ struct TORCH_API KernelSpec {
     return has_random_;
   }
 
+  // Whether the kernel reduces the rows of the map size (see generateKernel)
+  bool reducesRows() const {
+    return reduces_rows_;
+  }
+
   // Cache functions
   c10::optional<std::shared_ptr<FusedKernel>> findKernel(
       const ArgSpec& arg_spec) const {
@@ -137,6 +146,7 @@ struct TORCH_API KernelSpec {
   std::vector<std::vector<int64_t>> inputBroadcastGroups_;
   std::vector<PartitionInfo> inputChunks_;
   bool has_random_;
+  bool reduces_rows_;
   mutable std::mutex mutex_;
   mutable std::
       unordered_map<ArgSpec, std::shared_ptr<FusedKernel>, torch::hash<ArgSpec>>
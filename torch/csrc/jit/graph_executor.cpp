@@ -1,5 +1,6 @@
 #include <torch/csrc/jit/graph_executor.h>
 
+#include <ATen/Parallel.h>
 #include <ATen/core/ivalue.h>
 #include <c10/util/Exception.h>
 #include <torch/csrc/autograd/grad_mode.h>
@@ -21,17 +22,21 @@
 #include <torch/csrc/jit/passes/decompose_ops.h>
 #include <torch/csrc/jit/passes/graph_fuser.h>
 #include <torch/csrc/jit/passes/inline_autodiff_subgraphs.h>
+#include <torch/csrc/jit/passes/inline_fork_wait.h>
+#include <torch/csrc/jit/passes/inplace_rewrite.h>
 #include <torch/csrc/jit/passes/inliner.h>
 #include <torch/csrc/jit/passes/inplace_check.h>
 #include <torch/csrc/jit/passes/loop_unrolling.h>
 #include <torch/csrc/jit/passes/lower_grad_of.h>
 #include <torch/csrc/jit/passes/lower_tuples.h>
+#include <torch/csrc/jit/passes/memory_planning.h>
 #include <torch/csrc/jit/passes/peephole.h>
 #include <torch/csrc/jit/passes/quantization.h>
 #include <torch/csrc/jit/passes/remove_expands.h>
 #include <torch/csrc/jit/passes/requires_grad_analysis.h>
 #include <torch/csrc/jit/passes/shape_analysis.h>
 #include <torch/csrc/jit/passes/specialize_autogradzero.h>
+#include <torch/csrc/jit/passes/vectorize_loops.h>
 #include <torch/csrc/jit/profiling_graph_executor_impl.h>
 #include <torch/csrc/jit/profiling_record.h>
 #include <torch/csrc/jit/resource_guard.h>
@@ -72,6 +77,11 @@ bool getAutodiffSubgraphInlining() {
   return autodiff_subgraph_inlining;
 }
 
+static std::atomic<size_t> num_background_compile_calls{0};
+std::atomic<size_t>& getNumBackgroundCompileCalls() {
+  return num_background_compile_calls;
+}
+
 thread_local std::weak_ptr<Graph> last_executed_optimized_graph;
 std::shared_ptr<Graph> lastExecutedOptimizedGraph() {
   return last_executed_optimized_graph.lock();
@@ -482,6 +492,82 @@ void GraphExecutorImplBase::run(Stack& stack) {
   last_executed_optimized_graph = plan.graph;
 }
 
+std::shared_ptr<GraphExecutorImplBase::BackgroundCompile> GraphExecutorImplBase::
+    compileInBackground(std::function<ExecutionPlan()> compile) {
+  auto background = std::make_shared<BackgroundCompile>();
+  // compilation reads the thread local settings of the call that needs it
+  const bool inlining = getAutodiffSubgraphInlining();
+  background->compile = [compile, inlining]() {
+    const bool old_inlining = getAutodiffSubgraphInlining();
+    debugSetAutodiffSubgraphInlining(inlining);
+    ResourceGuard restore(
+        [&]() { debugSetAutodiffSubgraphInlining(old_inlining); });
+    return compile();
+  };
+  num_background_compiles_++;
+  at::launch([this, background]() {
+    {
+      std::lock_guard<std::mutex> lock(compile_mutex);
+      if (background->started) {
+        num_background_compiles_--;
+        background_compile_done_.notify_all();
+        return;
+      }
+      background->started = true;
+    }
+    finishBackgroundCompile(*background);
+    std::lock_guard<std::mutex> lock(compile_mutex);
+    num_background_compiles_--;
+    background_compile_done_.notify_all();
+  });
+  return background;
+}
+
+void GraphExecutorImplBase::finishBackgroundCompile(
+    BackgroundCompile& background) {
+  c10::optional<ExecutionPlan> plan;
+  std::exception_ptr error;
+  try {
+    plan = background.compile();
+  } catch (...) {
+    error = std::current_exception();
+  }
+  std::lock_guard<std::mutex> lock(compile_mutex);
+  background.plan = std::move(plan);
+  background.error = std::move(error);
+  background.finished = true;
+  background_compile_done_.notify_all();
+}
+
+const ExecutionPlan* GraphExecutorImplBase::backgroundPlan(
+    BackgroundCompile& background,
+    std::unique_lock<std::mutex>& lock) {
+  if (!background.finished) {
+    if (background.fallback_calls < getNumBackgroundCompileCalls()) {
+      background.fallback_calls++;
+      return nullptr;
+    }
+    if (!background.started) {
+      // the thread pool may be busy with the very call waiting for it
+      background.started = true;
+      lock.unlock();
+      finishBackgroundCompile(background);
+      lock.lock();
+    }
+    background_compile_done_.wait(lock, [&]() { return background.finished; });
+  }
+  if (background.error) {
+    std::rethrow_exception(background.error);
+  }
+  return &*background.plan;
+}
+
+void GraphExecutorImplBase::waitForBackgroundCompiles() {
+  std::unique_lock<std::mutex> lock(compile_mutex);
+  background_compile_done_.wait(
+      lock, [&]() { return num_background_compiles_ == 0; });
+}
+
 // a Graph can be created via tracing, or via a language-based frontend
 // GraphExecutor runs it. It can run the same graph on many different sizes
 // and different requires_grad states, and handles specializations for each
@@ -516,6 +602,11 @@ struct GraphExecutorImpl : public GraphExecutorImplBase {
 
   const ExecutionPlan& getOrCompileFallback() {
     std::lock_guard<std::mutex> lock(compile_mutex);
+    return compileFallback();
+  }
+
+  // compile_mutex must be held
+  const ExecutionPlan& compileFallback() {
     if (!fallback) {
       auto graph_ = graph->copy();
       runRequiredPasses(graph_);
@@ -529,24 +620,57 @@ struct GraphExecutorImpl : public GraphExecutorImplBase {
     // path ArgumentSpec even computes its hashCode here.
     ArgumentSpec spec =
         arg_spec_creator_.create(autograd::GradMode::is_enabled(), stack);
+    // calls usually keep using the same specialization, which doesn't need
+    // the lock
+    if (const auto* last = last_hit_.load(std::memory_order_acquire)) {
+      if (last->first.hashCode() == spec.hashCode() && last->first == spec) {
+        logging::getLogger()->addStatValue(
+            logging::runtime_counters::EXECUTION_PLAN_CACHE_HIT, 1.0);
+        return last->second;
+      }
+    }
     {
-      std::lock_guard<std::mutex> lock(compile_mutex);
+      std::unique_lock<std::mutex> lock(compile_mutex);
       auto it = plan_cache.find(spec);
       if (it != plan_cache.end()) {
         logging::getLogger()->addStatValue(
             logging::runtime_counters::EXECUTION_PLAN_CACHE_HIT, 1.0);
+        last_hit_.store(&*it, std::memory_order_release);
         return it->second;
       }
-      auto plan = compileSpec(spec);
+      if (getNumBackgroundCompileCalls() > 0) {
+        auto& background = background_compiles[spec];
+        if (!background) {
+          auto opt_graph = graph->copy();
+          background = compileInBackground([this, spec, opt_graph]() {
+            return compileSpec(spec, opt_graph);
+          });
+        }
+        // the entry may be erased by another call while this one waits
+        auto compiling = background;
+        auto plan = backgroundPlan(*compiling, lock);
+        if (!plan) {
+          return compileFallback();
+        }
+        background_compiles.erase(spec);
+        auto r = plan_cache.emplace(std::move(spec), *plan);
+        logging::getLogger()->addStatValue(
+            logging::runtime_counters::EXECUTION_PLAN_CACHE_MISS, 1.0);
+        last_hit_.store(&*r.first, std::memory_order_release);
+        return r.first->second;
+      }
+      auto plan = compileSpec(spec, graph->copy());
       auto r = plan_cache.emplace(std::move(spec), std::move(plan));
       logging::getLogger()->addStatValue(
           logging::runtime_counters::EXECUTION_PLAN_CACHE_MISS, 1.0);
+      last_hit_.store(&*r.first, std::memory_order_release);
       return r.first->second;
     }
   }
 
-  ExecutionPlan compileSpec(const ArgumentSpec& spec) {
-    auto opt_graph = graph->copy();
+  ExecutionPlan compileSpec(
+      const ArgumentSpec& spec,
+      std::shared_ptr<Graph> opt_graph) {
     SOURCE_DUMP("Optimizing the following function:", opt_graph);
     arg_spec_creator_.specializeTypes(*opt_graph, spec);
 
@@ -580,7 +704,8 @@ struct GraphExecutorImpl : public GraphExecutorImplBase {
     //          symbolically differentiable subgraphs for further optimizations.
     // Phase 5. Apply non-differentiable optimizations to the graphs we've found
     //          (or the whole grpah if we know we won't need its derivative).
-    if (needsGradient(opt_graph)) {
+    const bool needs_gradient = needsGradient(opt_graph);
+    if (needs_gradient) {
       auto diff_nodes = CreateAutodiffSubgraphs(
           opt_graph,
           autodiff_subgraph_inlining ? autodiffSubgraphNodeThreshold : 1);
@@ -606,10 +731,18 @@ struct GraphExecutorImpl : public GraphExecutorImplBase {
     }
     // Make sure there are no leftovers from any passes.
     EliminateDeadCode(opt_graph);
+    if (!needs_gradient && getInplaceRewriteMode()) {
+      RewriteToInplaceOps(opt_graph);
+    }
+    if (!needs_gradient && getMemoryPlanningMode()) {
+      PlanMemory(opt_graph);
+    }
     return ExecutionPlan(opt_graph);
   }
 
-  ~GraphExecutorImpl() override = default;
+  ~GraphExecutorImpl() override {
+    waitForBackgroundCompiles();
+  }
 
   ArgumentSpecCreator arg_spec_creator_;
   // Populated only when optimize is false (and in that case plan_cache will be
@@ -619,6 +752,15 @@ struct GraphExecutorImpl : public GraphExecutorImplBase {
   // Mapping from argument configurations to optimized versions of the graph
   // that are specialized to the spec.
   std::unordered_map<ArgumentSpec, ExecutionPlan> plan_cache;
+  // The plan_cache entry of the last lookup. Entries are never erased, so
+  // it can be read without compile_mutex.
+  std::atomic<const std::pair<const ArgumentSpec, ExecutionPlan>*> last_hit_{
+      nullptr};
+
+  // The specializations compiling in the background, that aren't in
+  // plan_cache yet
+  std::unordered_map<ArgumentSpec, std::shared_ptr<BackgroundCompile>>
+      background_compiles;
 };
 
 GraphExecutor::GraphExecutor(std::shared_ptr<Graph> graph)
@@ -737,6 +879,9 @@ void runNondiffOptimization(std::shared_ptr<Graph>& graph) {
 }
 
 void runOptimization(std::shared_ptr<Graph>& graph) {
+  // Forks of a couple of ops cost more to schedule than to run inline.
+  InlineTrivialForks(graph, forkInlineThreshold);
+
   // Basic graph preprocessing to eliminate noise.
   EliminateDeadCode(graph);
   EliminateCommonSubexpression(graph);
@@ -745,8 +890,10 @@ void runOptimization(std::shared_ptr<Graph>& graph) {
   PeepholeOptimize(graph);
   ConstantPropagation(graph);
 
-  // Unroll small loops, and eliminate expressions that are the same at every
+  // Turn loops mapping pointwise functions over a tensor into tensor ops,
+  // unroll small loops, and eliminate expressions that are the same at every
   // iteration.
+  VectorizeLoops(graph);
   UnrollLoops(graph);
   EliminateCommonSubexpression(graph);
 
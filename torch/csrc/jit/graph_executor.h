@@ -62,6 +62,13 @@ TORCH_API std::shared_ptr<Graph> lastExecutedOptimizedGraph();
 
 TORCH_API std::atomic<bool> &getProfilingMode();
 TORCH_API std::atomic<bool>& getExecutorMode();
+// The number of runs the profiling executor profiles before optimizing a
+// graph. The dims that vary across them are generalized into shape symbols
+TORCH_API std::atomic<size_t>& getNumProfiledRuns();
+// When nonzero, optimized plans compile on the inter-op thread pool, and up
+// to this many calls that need a plan still compiling run an unoptimized plan
+// instead of waiting for it
+TORCH_API std::atomic<size_t>& getNumBackgroundCompileCalls();
 
 struct TORCH_API GraphOptimizerEnabledGuard {
   GraphOptimizerEnabledGuard(bool state)
@@ -18,7 +18,10 @@
 #include <torch/csrc/jit/script/compiler.h>
 #include <torch/csrc/jit/script/logging.h>
 
+#include <condition_variable>
 #include <cstdint>
+#include <exception>
+#include <functional>
 #include <iterator>
 #include <memory>
 #include <mutex>
@@ -41,6 +44,9 @@ bool getAutodiffSubgraphInlining();
 const size_t autodiffSubgraphNodeThreshold = 2;
 const size_t autodiffSubgraphInlineThreshold = 5;
 
+// Forks with at most this many nodes are run inline rather than in parallel
+const size_t forkInlineThreshold = 3;
+
 // a Graph can be created via tracing, or via a language-based frontend
 // GraphExecutor runs it. It can run the same graph on many different sizes
 // and different requires_grad states, and handles specializations for each
@@ -82,6 +88,45 @@ struct GraphExecutorImplBase {
   // GraphExecutors can be accessed from multiple threads, so this thread needs
   // to be held every time we access the fallback or plan_cache.
   std::mutex compile_mutex;
+
+  // A plan compiling on the inter-op thread pool, while the calls that need
+  // it run an unoptimized plan (see getNumBackgroundCompileCalls).
+  // Guarded by compile_mutex.
+  struct BackgroundCompile {
+    std::function<ExecutionPlan()> compile;
+    // the calls that ran the unoptimized plan so far
+    size_t fallback_calls = 0;
+    // set by the thread that runs `compile`, either the thread pool or a call
+    // that couldn't wait for it to get there
+    bool started = false;
+    bool finished = false;
+    c10::optional<ExecutionPlan> plan;
+    std::exception_ptr error;
+  };
+
+  // Launches `compile` on the inter-op thread pool
+  std::shared_ptr<BackgroundCompile> compileInBackground(
+      std::function<ExecutionPlan()> compile);
+
+  // Returns the plan of `background` once it's compiled. Returns nullptr,
+  // for the caller to run its unoptimized plan, until the calls that did so
+  // reach getNumBackgroundCompileCalls, and then waits for the plan (or
+  // compiles it, if the thread pool hasn't started to). Rethrows the error
+  // of the compilation, if any. `lock` must hold compile_mutex.
+  const ExecutionPlan* backgroundPlan(
+      BackgroundCompile& background,
+      std::unique_lock<std::mutex>& lock);
+
+  // The destructors of subclasses call this before destroying what their
+  // compilations use
+  void waitForBackgroundCompiles();
+
+ private:
+  void finishBackgroundCompile(BackgroundCompile& background);
+
+  std::condition_variable background_compile_done_;
+  // the background compilations the thread pool hasn't returned from
+  size_t num_background_compiles_ = 0;
 };
 
 } // namespace jit
@@ -15,10 +15,17 @@
 #include "caffe2/serialize/file_adapter.h"
 #include "caffe2/serialize/inline_container.h"
 #include "caffe2/serialize/istream_adapter.h"
+#include "caffe2/serialize/mmap_file_adapter.h"
 
 #include <ATen/ATen.h>
+#include <ATen/Parallel.h>
 
+#include <cstring>
 #include <fstream>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <sstream>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -28,6 +35,7 @@ namespace jit {
 
 using caffe2::serialize::FileAdapter;
 using caffe2::serialize::IStreamAdapter;
+using caffe2::serialize::MmapFileAdapter;
 using caffe2::serialize::PyTorchStreamReader;
 using caffe2::serialize::ReadAdapterInterface;
 
@@ -54,8 +62,224 @@ void postSetStateValidate(const IValue& v) {
   }
 }
 
+std::atomic<bool>& getLazyImportMode() {
+  static std::atomic<bool> lazy_import{true};
+  return lazy_import;
+}
+
+std::atomic<bool>& getMmapImportMode() {
+  static std::atomic<bool> mmap_import{false};
+  return mmap_import;
+}
+
+std::atomic<bool>& getShareStoragesImportMode() {
+  static std::atomic<bool> share_storages_import{false};
+  return share_storages_import;
+}
+
 namespace {
 
+// The sources and constants of an archive, which lazily compiled functions
+// may still look up once the archive is closed
+struct ImportedArchive {
+  explicit ImportedArchive(PyTorchStreamReader* reader) : reader_(reader) {}
+
+  std::shared_ptr<Source> findSource(const std::string& qualifier) {
+    auto it = sources_.find(qualifier);
+    if (it != sources_.end()) {
+      return it->second;
+    }
+    if (!reader_) {
+      return nullptr;
+    }
+    auto source =
+        findSourceInArchiveFromQualifier(*reader_, export_prefix_, qualifier);
+    sources_.emplace(qualifier, source);
+    return source;
+  }
+
+  // Stops reading the archive, after reading the sources that weren't read
+  // yet if they may still be needed
+  void close(bool read_remaining_sources) {
+    if (reader_ && read_remaining_sources) {
+      for (const auto& record : reader_->getAllRecords()) {
+        if (auto qualifier = archivePathToQualifier(record, export_prefix_)) {
+          findSource(*qualifier);
+        }
+      }
+    }
+    reader_ = nullptr;
+  }
+
+  std::vector<at::Tensor> constants_table_;
+
+ private:
+  PyTorchStreamReader* reader_;
+  const std::string export_prefix_ = "code/";
+  std::unordered_map<std::string, std::shared_ptr<Source>> sources_;
+};
+
+std::unique_ptr<ReadAdapterInterface> makeFileAdapter(
+    const std::string& filename) {
+  if (getMmapImportMode()) {
+    return caffe2::make_unique<MmapFileAdapter>(filename);
+  }
+  return caffe2::make_unique<FileAdapter>(filename);
+}
+
+// The records read while getShareStoragesImportMode() is set and still alive,
+// by size and CRC-32. The DataPtrs returned for them alias the first copy
+// read, which lives as long as any of them does.
+class SharedRecords {
+ public:
+  static SharedRecords& get() {
+    static SharedRecords shared_records;
+    return shared_records;
+  }
+
+  at::DataPtr share(uint32_t crc32, size_t size, at::DataPtr data) {
+    const Key key{crc32, size};
+    std::vector<std::shared_ptr<at::DataPtr>> candidates;
+    {
+      std::lock_guard<std::mutex> guard(mutex_);
+      auto& records = records_[key];
+      auto it = records.begin();
+      while (it != records.end()) {
+        if (auto record = it->lock()) {
+          candidates.push_back(std::move(record));
+          ++it;
+        } else {
+          it = records.erase(it);
+        }
+      }
+    }
+    // Equal CRCs don't make equal records, so the bytes are compared too,
+    // without the lock since records can be large
+    for (auto& candidate : candidates) {
+      if (std::memcmp(candidate->get(), data.get(), size) == 0) {
+        return alias(std::move(candidate));
+      }
+    }
+    auto record = std::make_shared<at::DataPtr>(std::move(data));
+    {
+      std::lock_guard<std::mutex> guard(mutex_);
+      records_[key].push_back(record);
+    }
+    return alias(std::move(record));
+  }
+
+ private:
+  using Key = std::pair<uint32_t, size_t>;
+  struct KeyHash {
+    size_t operator()(const Key& key) const {
+      return std::hash<size_t>()(key.second) * 31 + key.first;
+    }
+  };
+
+  static void deleteAlias(void* ctx) {
+    delete static_cast<std::shared_ptr<at::DataPtr>*>(ctx);
+  }
+
+  static at::DataPtr alias(std::shared_ptr<at::DataPtr> record) {
+    void* data = record->get();
+    return at::DataPtr(
+        data,
+        new std::shared_ptr<at::DataPtr>(std::move(record)),
+        &deleteAlias,
+        at::kCPU);
+  }
+
+  std::mutex mutex_;
+  std::unordered_map<Key, std::vector<std::weak_ptr<at::DataPtr>>, KeyHash>
+      records_;
+};
+
+at::DataPtr readRecord(
+    PyTorchStreamReader& reader,
+    const std::string& name,
+    bool share) {
+  at::DataPtr data;
+  size_t size;
+  std::tie(data, size) = reader.getRecord(name);
+  if (!share || size == 0) {
+    return data;
+  }
+  return SharedRecords::get().share(
+      reader.getRecordCRC32(name), size, std::move(data));
+}
+
+// Reads the records of a directory of the archives on the inter-op threads, so
+// that the storages are loaded in parallel while the pickle referencing them
+// is parsed. A record is read by whichever of its task and the unpickler
+// claims it first, so that the unpickler never waits for a task that didn't
+// start, e.g. when the pool is busy.
+class RecordPrefetcher {
+ public:
+  // Records missing from readers[0] are looked up in the other readers
+  RecordPrefetcher(
+      const std::vector<PyTorchStreamReader*>& readers,
+      const std::string& prefix)
+      : reader_(*readers.at(0)), share_(getShareStoragesImportMode()) {
+    for (PyTorchStreamReader* reader : readers) {
+      for (const auto& name : reader->getAllRecords()) {
+        if (name.compare(0, prefix.size(), prefix) != 0 ||
+            records_.count(name)) {
+          continue;
+        }
+        auto record = std::make_shared<Record>();
+        record->reader = reader;
+        records_.emplace(name, record);
+        at::launch([name, record, share = share_]() {
+          if (record->claimed.exchange(true)) {
+            return;
+          }
+          try {
+            record->promise.set_value(
+                readRecord(*record->reader, name, share));
+          } catch (...) {
+            record->promise.set_exception(std::current_exception());
+          }
+        });
+      }
+    }
+  }
+
+  ~RecordPrefetcher() {
+    // The tasks that started still read from the archive
+    for (auto& entry : records_) {
+      auto& record = entry.second;
+      if (record->claimed.exchange(true)) {
+        record->future.wait();
+      }
+    }
+  }
+
+  at::DataPtr getRecord(const std::string& name) {
+    auto it = records_.find(name);
+    if (it == records_.end()) {
+      return readRecord(reader_, name, share_);
+    }
+    auto record = std::move(it->second);
+    records_.erase(it);
+    if (!record->claimed.exchange(true)) {
+      return readRecord(*record->reader, name, share_);
+    }
+    return record->future.get();
+  }
+
+ private:
+  struct Record {
+    Record() : future(promise.get_future()) {}
+    PyTorchStreamReader* reader;
+    std::atomic<bool> claimed{false};
+    std::promise<at::DataPtr> promise;
+    std::future<at::DataPtr> future;
+  };
+
+  PyTorchStreamReader& reader_;
+  const bool share_;
+  std::unordered_map<std::string, std::shared_ptr<Record>> records_;
+};
 
 // This is a deserializer class which loads script modules from pt files.
 // Content of the file is written using PyTorchStreamWriter, for details please
@@ -64,19 +288,24 @@ namespace {
 // the constant table and the script module.
 class ScriptModuleDeserializer final {
  public:
+  // filename is where sharded archives look for their shards
   ScriptModuleDeserializer(
       std::shared_ptr<script::CompilationUnit> cu,
-      std::unique_ptr<PyTorchStreamReader> reader)
+      std::unique_ptr<PyTorchStreamReader> reader,
+      std::string filename = "")
       : compilation_unit_(cu),
         reader_(std::move(reader)),
+        filename_(std::move(filename)),
+        lazy_(getLazyImportMode()),
+        archive_(std::make_shared<ImportedArchive>(reader_.get())),
         source_importer_(
             compilation_unit_,
-            &constants_table_,
-            [this](const std::string& qualifier) {
-              return findSourceInArchiveFromQualifier(
-                  *reader_, export_prefix_, qualifier);
+            &archive_->constants_table_,
+            [archive = archive_](const std::string& qualifier) {
+              return archive->findSource(qualifier);
             },
-            reader_->version()) {}
+            reader_->version(),
+            lazy_) {}
 
   script::Module deserialize(
       c10::optional<at::Device> device,
@@ -84,13 +313,18 @@ class ScriptModuleDeserializer final {
 
  private:
   IValue readArchive(const std::string& archive_name);
+  void openShards();
 
   std::shared_ptr<script::CompilationUnit> compilation_unit_;
   std::unique_ptr<PyTorchStreamReader> reader_;
+  std::string filename_;
+  // The archives that hold storages too, see ExportModule
+  std::vector<std::unique_ptr<PyTorchStreamReader>> shards_;
   c10::optional<at::Device> device_;
-  std::vector<at::Tensor> constants_table_;
+  bool lazy_;
+  // Shared with the importer, which lazily compiled functions keep alive
+  std::shared_ptr<ImportedArchive> archive_;
   script::SourceImporter source_importer_;
-  std::string export_prefix_ = "code/";
 };
 
 IValue ScriptModuleDeserializer::readArchive(const std::string& archive_name) {
@@ -153,9 +387,13 @@ IValue ScriptModuleDeserializer::readArchive(const std::string& archive_name) {
   };
 
   std::string archive_name_plus_slash = archive_name + "/";
+  std::vector<PyTorchStreamReader*> readers{reader_.get()};
+  for (auto& shard : shards_) {
+    readers.push_back(shard.get());
+  }
+  RecordPrefetcher prefetcher(readers, archive_name_plus_slash);
   auto read_record = [&](const std::string& name) {
-    std::string ss = archive_name_plus_slash + name;
-    return std::get<0>(reader_->getRecord(ss));
+    return prefetcher.getRecord(archive_name_plus_slash + name);
   };
 
   Unpickler unpickler(
@@ -181,6 +419,7 @@ script::Module ScriptModuleDeserializer::deserialize(
     }
   }
   if (reader_->hasRecord("model.json")) {
+    archive_->close(/*read_remaining_sources=*/false);
 #ifndef C10_MOBILE
     return torch::jit::LEGACY_deserialize(
         compilation_unit_, std::move(reader_), device_);
@@ -188,11 +427,35 @@ script::Module ScriptModuleDeserializer::deserialize(
     AT_ERROR("Legacy model format is not supported on mobile.");
 #endif
   }
+  if (reader_->hasRecord("shards")) {
+    openShards();
+  }
   auto tuple = readArchive("constants").toTuple();
   for (auto constant : tuple->elements()) {
-    constants_table_.push_back(constant.toTensor());
+    archive_->constants_table_.push_back(constant.toTensor());
+  }
+  auto module = script::Module(readArchive("data").toObject());
+  archive_->close(/*read_remaining_sources=*/lazy_);
+  return module;
+}
+
+void ScriptModuleDeserializer::openShards() {
+  TORCH_CHECK(
+      !filename_.empty(),
+      "This archive has its tensors in several files, so it has to be loaded "
+      "from a file name");
+  at::DataPtr shards_ptr;
+  size_t shards_size;
+  std::tie(shards_ptr, shards_size) = reader_->getRecord("shards");
+  std::istringstream names(
+      std::string(static_cast<char*>(shards_ptr.get()), shards_size));
+  const std::string directory =
+      filename_.substr(0, filename_.find_last_of('/') + 1);
+  std::string name;
+  while (std::getline(names, name)) {
+    shards_.push_back(torch::make_unique<PyTorchStreamReader>(
+        makeFileAdapter(directory + name)));
   }
-  return script::Module(readArchive("data").toObject());
 }
 
 } // namespace
@@ -212,8 +475,10 @@ script::Module import_ir_module(
     const std::string& filename,
     c10::optional<at::Device> device,
     script::ExtraFilesMap& extra_files) {
-  auto reader = torch::make_unique<PyTorchStreamReader>(filename);
-  ScriptModuleDeserializer deserializer(std::move(cu), std::move(reader));
+  auto reader =
+      torch::make_unique<PyTorchStreamReader>(makeFileAdapter(filename));
+  ScriptModuleDeserializer deserializer(
+      std::move(cu), std::move(reader), filename);
   return deserializer.deserialize(device, extra_files);
 }
 
@@ -241,9 +506,12 @@ script::Module load(
     const std::string& filename,
     c10::optional<at::Device> device,
     script::ExtraFilesMap& extra_files) {
-  std::unique_ptr<FileAdapter> rai = caffe2::make_unique<FileAdapter>(filename);
-  auto module = load(std::move(rai), device, extra_files);
-  return module;
+  auto reader =
+      torch::make_unique<PyTorchStreamReader>(makeFileAdapter(filename));
+  auto cu = std::make_shared<script::CompilationUnit>();
+  ScriptModuleDeserializer deserializer(
+      std::move(cu), std::move(reader), filename);
+  return deserializer.deserialize(device, extra_files);
 }
 
 script::Module load(
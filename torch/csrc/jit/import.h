@@ -3,6 +3,7 @@
 #include <torch/csrc/jit/ir.h>
 #include <torch/csrc/jit/script/module.h>
 
+#include <atomic>
 #include <istream>
 
 namespace caffe2 {
@@ -16,6 +17,24 @@ namespace jit {
 
 static script::ExtraFilesMap default_extra_files;
 
+// Whether the imported functions and methods are compiled on first use
+// rather than when they are loaded, see CompilationUnit::define. On by
+// default, since a job rarely calls every method of a model.
+TORCH_API std::atomic<bool>& getLazyImportMode();
+
+// Whether loading from a file mmaps it, so that the tensors stored
+// uncompressed point into the page cache, which processes loading the same
+// file share, instead of being read into memory. Off by default, since the
+// file then must not be modified while the tensors are alive.
+TORCH_API std::atomic<bool>& getMmapImportMode();
+
+// Whether the tensor records of the archives loaded in the process which are
+// byte for byte equal share their storage, matched by their size and CRC-32,
+// so that variants of a model loaded side by side, say for A/B tests, only
+// take the memory of the tensors that differ. Off by default, since modifying
+// a shared tensor in place then modifies it in all the modules holding it.
+TORCH_API std::atomic<bool>& getShareStoragesImportMode();
+
 TORCH_API script::Module import_ir_module(
     std::shared_ptr<script::CompilationUnit> cu,
     const std::string& filename,
@@ -21,6 +21,23 @@ std::string qualifierToArchivePath(
   return export_prefix + path + "." + kExportSuffix;
 }
 
+c10::optional<std::string> archivePathToQualifier(
+    const std::string& path,
+    const std::string& export_prefix) {
+  const std::string suffix = "." + kExportSuffix;
+  if (path.size() <= export_prefix.size() + suffix.size() ||
+      path.compare(0, export_prefix.size(), export_prefix) != 0 ||
+      path.compare(path.size() - suffix.size(), suffix.size(), suffix) != 0) {
+    return c10::nullopt;
+  }
+  std::string qualifier = path.substr(
+      export_prefix.size(),
+      path.size() - export_prefix.size() - suffix.size());
+  std::replace_if(
+      qualifier.begin(), qualifier.end(), [](char c) { return c == '/'; }, '.');
+  return qualifier;
+}
+
 std::shared_ptr<Source> findSourceInArchiveFromQualifier(
     caffe2::serialize::PyTorchStreamReader& reader,
     const std::string& export_prefix,
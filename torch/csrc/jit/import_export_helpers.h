@@ -1,5 +1,7 @@
 #pragma once
 
+#include <c10/util/Optional.h>
+
 #include <memory>
 #include <string>
 
@@ -23,6 +25,12 @@ std::string qualifierToArchivePath(
     const std::string& qualifier,
     const std::string& export_prefix);
 
+// The inverse of qualifierToArchivePath, or c10::nullopt if path is not the
+// source file of a qualifier
+c10::optional<std::string> archivePathToQualifier(
+    const std::string& path,
+    const std::string& export_prefix);
+
 std::shared_ptr<Source> findSourceInArchiveFromQualifier(
     caffe2::serialize::PyTorchStreamReader& reader,
     const std::string& export_prefix,
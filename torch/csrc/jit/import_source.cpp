@@ -104,8 +104,9 @@ struct SourceImporterImpl : public Resolver,
       const std::shared_ptr<CompilationUnit> cu,
       const std::vector<at::Tensor>* tensor_table,
       SourceLoader source_loader,
-      size_t version)
-      : cu_(cu), source_loader_(std::move(source_loader)) {
+      size_t version,
+      bool lazy)
+      : cu_(cu), source_loader_(std::move(source_loader)), lazy_(lazy) {
     env_ = {
         {"torch", std::make_shared<BuiltinModule>("aten", version)},
         {"ops", std::make_shared<OpsValue>(version)},
@@ -133,7 +134,7 @@ struct SourceImporterImpl : public Resolver,
       to_be_defined_.erase(it);
       importNamedType(name.prefix(), cd);
     }
-    return cu_->get_type(name);
+    return cu()->get_type(name);
   }
 
   Function* findFunction(const QualifiedName& name) {
@@ -144,7 +145,7 @@ struct SourceImporterImpl : public Resolver,
       to_be_defined_.erase(it);
       importFunction(name.prefix(), d);
     }
-    return cu_->find_function(name);
+    return cu()->find_function(name);
   }
 
   void parseSourceIfNeeded(const std::string& qualifier) {
@@ -192,7 +193,7 @@ struct SourceImporterImpl : public Resolver,
   void LEGACY_import_methods(
       const script::Module& mod,
       const std::shared_ptr<Source>& src) {
-    auto self = SimpleSelf(mod.type());
+    const Self* self = makeSelf(mod.type());
     c10::QualifiedName prefix = *mod.type()->name();
     Parser p(src);
 
@@ -207,7 +208,7 @@ struct SourceImporterImpl : public Resolver,
       definitions.emplace_back(def);
       resolvers.emplace_back(shared_from_this());
     }
-    cu_->define(prefix, definitions, resolvers, &self);
+    cu()->define(prefix, definitions, resolvers, self);
   }
 
   std::shared_ptr<SugaredValue> resolveValue(
@@ -235,7 +236,13 @@ struct SourceImporterImpl : public Resolver,
   void importFunction(const std::string& qualifier, const Def& def) {
     std::vector<Def> definitions{def};
     std::vector<ResolverPtr> resolvers{shared_from_this()};
-    cu_->define(qualifier, definitions, resolvers, nullptr);
+    cu()->define(
+        qualifier,
+        definitions,
+        resolvers,
+        nullptr,
+        /*shouldMangle=*/false,
+        /*lazy=*/lazy_);
   }
 
   void importNamedType(
@@ -255,9 +262,9 @@ struct SourceImporterImpl : public Resolver,
       // ClassTypes)
       return importNamedTuple(qualified_name, class_def);
     } else if (superclass_name == "Interface") {
-      cu_->define_interface(qualified_name, class_def, shared_from_this(), /*is_module=*/false);
+      cu()->define_interface(qualified_name, class_def, shared_from_this(), /*is_module=*/false);
     } else if (superclass_name == "ModuleInterface") {
-      cu_->define_interface(qualified_name, class_def, shared_from_this(), /*is_module=*/true);
+      cu()->define_interface(qualified_name, class_def, shared_from_this(), /*is_module=*/true);
     } else {
       throw ErrorReport(class_def.range())
           << "Torchscript does not support class inheritance.";
@@ -269,7 +276,7 @@ struct SourceImporterImpl : public Resolver,
       const ClassDef& class_def,
       bool is_module) {
     auto class_type = ClassType::create(
-        c10::QualifiedName(qualified_classname), cu_, is_module);
+        c10::QualifiedName(qualified_classname), cu(), is_module);
 
     std::vector<Def> methods;
     std::vector<ResolverPtr> resolvers;
@@ -367,9 +374,14 @@ struct SourceImporterImpl : public Resolver,
       }
     }
 
-    cu_->register_type(class_type);
-    const auto self = SimpleSelf(class_type);
-    cu_->define(qualified_classname, methods, resolvers, &self);
+    cu()->register_type(class_type);
+    cu()->define(
+        qualified_classname,
+        methods,
+        resolvers,
+        makeSelf(class_type),
+        /*shouldMangle=*/false,
+        /*lazy=*/lazy_);
   }
 
   void importNamedTuple(
@@ -393,7 +405,7 @@ struct SourceImporterImpl : public Resolver,
     }
 
     auto tt = TupleType::createNamed(qualified_name, field_names, field_types);
-    cu_->register_type(tt);
+    cu()->register_type(tt);
   }
 
   void parsePossibleVersionNumber(Lexer& L) {
@@ -429,13 +441,29 @@ struct SourceImporterImpl : public Resolver,
     }
   }
 
-  std::shared_ptr<CompilationUnit> cu_;
+  std::shared_ptr<CompilationUnit> cu() const {
+    auto cu = cu_.lock();
+    TORCH_INTERNAL_ASSERT(cu, "the imported compilation unit was destroyed");
+    return cu;
+  }
+
+  // Lazily compiled methods use their self after they are defined
+  const Self* makeSelf(ClassTypePtr class_type) {
+    selves_.push_back(torch::make_unique<SimpleSelf>(std::move(class_type)));
+    return selves_.back().get();
+  }
+
+  // The functions of the compilation unit hold on to the importer until they
+  // are compiled, so it doesn't own the compilation unit
+  std::weak_ptr<CompilationUnit> cu_;
   std::unordered_map<std::string, std::shared_ptr<SugaredValue>> env_;
   SourceLoader source_loader_;
   std::unordered_set<std::string> loaded_sources_;
   // named types and functions loaded from a file but not yet defined because
   // their type has not been requested yet.
   std::unordered_map<QualifiedName, TreeRef> to_be_defined_;
+  std::vector<std::unique_ptr<SimpleSelf>> selves_;
+  bool lazy_;
 };
 
 std::shared_ptr<SugaredValue> ClassNamespaceValue::attr(
@@ -466,12 +494,14 @@ SourceImporter::SourceImporter(
     std::shared_ptr<CompilationUnit> cu,
     const std::vector<at::Tensor>* tensor_table,
     SourceLoader loader,
-    size_t version)
+    size_t version,
+    bool lazy)
     : pImpl(std::make_shared<SourceImporterImpl>(
           std::move(cu),
           tensor_table,
           std::move(loader),
-          version)) {}
+          version,
+          lazy)) {}
 
 TypePtr SourceImporter::loadNamedType(const QualifiedName& name) const {
   TypePtr t = pImpl->findNamedType(name);
@@ -25,7 +25,10 @@ struct TORCH_API SourceImporter {
       std::shared_ptr<CompilationUnit> cu,
       const std::vector<at::Tensor>* tensor_table,
       SourceLoader loader,
-      size_t version);
+      size_t version,
+      // if true, the imported functions and methods but __init__ are compiled
+      // on first use, so the tensor table and the loader have to outlive them
+      bool lazy = false);
 
   TypePtr loadNamedType(const QualifiedName& name) const;
 
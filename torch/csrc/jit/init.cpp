@@ -1,6 +1,8 @@
 #include <torch/csrc/utils/auto_gil.h>
 #include <torch/csrc/utils/pybind.h>
 
+#include <torch/csrc/jit/aot/codegen.h>
+#include <torch/csrc/jit/aot/library.h>
 #include <torch/csrc/jit/argument_spec.h>
 #include <torch/csrc/jit/autodiff.h>
 #include <torch/csrc/jit/export.h>
@@ -19,13 +21,17 @@
 #include <torch/csrc/jit/passes/dead_code_elimination.h>
 #include <torch/csrc/jit/passes/decompose_ops.h>
 #include <torch/csrc/jit/passes/erase_number_types.h>
+#include <torch/csrc/jit/passes/fold_batch_norm.h>
+#include <torch/csrc/jit/passes/freeze_module.h>
 #include <torch/csrc/jit/passes/fuse_linear.h>
 #include <torch/csrc/jit/passes/graph_fuser.h>
 #include <torch/csrc/jit/passes/inline_fork_wait.h>
+#include <torch/csrc/jit/passes/inplace_rewrite.h>
 #include <torch/csrc/jit/passes/inliner.h>
 #include <torch/csrc/jit/passes/loop_unrolling.h>
 #include <torch/csrc/jit/passes/lower_graph.h>
 #include <torch/csrc/jit/passes/lower_tuples.h>
+#include <torch/csrc/jit/passes/memory_planning.h>
 #include <torch/csrc/jit/passes/onnx.h>
 #include <torch/csrc/jit/passes/onnx/cast_all_constant_to_floating.h>
 #include <torch/csrc/jit/passes/onnx/constant_fold.h>
@@ -35,11 +41,14 @@
 #include <torch/csrc/jit/passes/onnx/scalar_type_analysis.h>
 #include <torch/csrc/jit/passes/onnx/unpack_quantized_weights.h>
 #include <torch/csrc/jit/passes/peephole.h>
+#include <torch/csrc/jit/passes/prepack_weights.h>
+#include <torch/csrc/jit/passes/propagate_mkldnn_layout.h>
 #include <torch/csrc/jit/passes/quantization.h>
 #include <torch/csrc/jit/passes/remove_expands.h>
 #include <torch/csrc/jit/passes/remove_inplace_ops.h>
 #include <torch/csrc/jit/passes/shape_analysis.h>
 #include <torch/csrc/jit/passes/specialize_autogradzero.h>
+#include <torch/csrc/jit/passes/vectorize_loops.h>
 #include <torch/csrc/jit/passes/subgraph_rewrite.h>
 #include <torch/csrc/jit/passes/utils/check_alias_annotation.h>
 #include <torch/csrc/jit/print_handler.h>
@@ -190,13 +199,39 @@ void initJITBindings(PyObject* module) {
           "_jit_pass_quant_fusion",
           [](std::shared_ptr<Graph>& g) { return QuantFusion(g); })
       .def("_jit_pass_fold_convbn", &FoldConvBatchNorm2d)
+      .def(
+          "_jit_pass_freeze_module",
+          [](const script::Module& module) { return freeze_module(module); })
       .def("_jit_pass_fuse_linear", &FuseLinear)
+      .def(
+          "_jit_aot_prepare",
+          [](const script::Module& module, const std::string& method_name) {
+            return aot::prepareForAOT(module, method_name);
+          })
+      .def(
+          "_jit_aot_generate_source",
+          [](const std::shared_ptr<Graph>& g) {
+            auto source = aot::generateAOTSource(g);
+            return py::make_tuple(source.source, py::bytes(source.weights));
+          })
+      .def("_jit_pass_fold_frozen_batch_norm", &FoldFrozenBatchNorm)
+      .def("_jit_pass_fuse_conv_linear_relu", &FuseConvAndLinearRelu)
       .def(
           "_jit_pass_fold_quantize",
           [](script::Module& module, const std::string& method_name) {
             FoldQuantizeCallIntoBuffer(module, method_name);
           })
       .def("_jit_pass_fold_prepack", &FoldPrepackedWeightIntoModule)
+      .def(
+          "_jit_pass_quantize_embedding_bag",
+          [](script::Module& module, int64_t bit_width) {
+            QuantizeEmbeddingBag(module, bit_width);
+          },
+          py::arg("module"),
+          py::arg("bit_width") = 8)
+      .def("_jit_pass_prepack_mkldnn_conv", &PrepackMKLDNNConvWeights)
+      .def("_jit_pass_prepack_winograd_conv", &PrepackWinogradConvWeights)
+      .def("_jit_pass_propagate_mkldnn_layout", PropagateMKLDNNLayout)
       .def(
           "_jit_pass_pattern_based_rewrite",
           [](const script::Module& m) { return PatternBasedRewrite(m); })
@@ -271,6 +306,7 @@ void initJITBindings(PyObject* module) {
             return LowerGraph(*graph, self._ivalue());
           })
       .def("_jit_pass_loop_unrolling", UnrollLoops)
+      .def("_jit_pass_vectorize_loops", VectorizeLoops)
       .def(
           "_jit_pass_constant_propagation",
           [](std::shared_ptr<Graph>& g) { return ConstantPropagation(g); })
@@ -278,6 +314,8 @@ void initJITBindings(PyObject* module) {
       .def(
           "_jit_pass_create_autodiff_subgraphs",
           [](std::shared_ptr<Graph> graph) { CreateAutodiffSubgraphs(graph); })
+      .def("_jit_pass_plan_memory", PlanMemory)
+      .def("_jit_pass_rewrite_to_inplace_ops", RewriteToInplaceOps)
       .def(
           "_jit_run_cpp_tests",
           [](bool runCuda) {
@@ -338,6 +376,56 @@ void initJITBindings(PyObject* module) {
             getExecutorMode() = profiling_flag;
             return oldState;
           })
+      .def(
+          "_jit_set_num_profiled_runs",
+          [](size_t num_runs) {
+            TORCH_CHECK(num_runs > 0, "expected at least one profiled run");
+            size_t oldState = getNumProfiledRuns();
+            getNumProfiledRuns() = num_runs;
+            return oldState;
+          })
+      .def(
+          "_jit_set_num_background_compile_calls",
+          [](size_t num_calls) {
+            size_t oldState = getNumBackgroundCompileCalls();
+            getNumBackgroundCompileCalls() = num_calls;
+            return oldState;
+          })
+      .def(
+          "_jit_set_memory_planning",
+          [](bool enabled) {
+            bool oldState = getMemoryPlanningMode();
+            getMemoryPlanningMode() = enabled;
+            return oldState;
+          })
+      .def(
+          "_jit_set_inplace_rewrite",
+          [](bool enabled) {
+            bool oldState = getInplaceRewriteMode();
+            getInplaceRewriteMode() = enabled;
+            return oldState;
+          })
+      .def(
+          "_jit_set_lazy_import",
+          [](bool enabled) {
+            bool oldState = getLazyImportMode();
+            getLazyImportMode() = enabled;
+            return oldState;
+          })
+      .def(
+          "_jit_set_mmap_import",
+          [](bool enabled) {
+            bool oldState = getMmapImportMode();
+            getMmapImportMode() = enabled;
+            return oldState;
+          })
+      .def(
+          "_jit_set_share_storages_import",
+          [](bool enabled) {
+            bool oldState = getShareStoragesImportMode();
+            getShareStoragesImportMode() = enabled;
+            return oldState;
+          })
       .def(
           "_jit_set_inline_everything_mode",
           [](bool enabled) { script::getInlineEverythingMode() = enabled; })
@@ -482,6 +570,13 @@ void initJITBindings(PyObject* module) {
         return py::bytes(reinterpret_cast<const char*>(data.get()), size);
       });
 
+  py::class_<aot::AOTLibrary>(m, "AOTLibrary")
+      .def(py::init<std::string, std::string>())
+      .def(
+          "run",
+          &aot::AOTLibrary::run,
+          py::call_guard<py::gil_scoped_release>());
+
   m.def(
       "_jit_get_operation",
       [](const std::string& op_name) {
@@ -37,7 +37,9 @@ namespace jit {
   _(TAIL_CALL, "F") /* replace current frame with function F */             \
   _(INTERFACE_CALL, "CI") /* call method X on the first argument (of N) */  \
   _(GET_ATTR, "S") /* get attribute from slot X in an Object */             \
-  _(SET_ATTR, "S") /* set attribute to slot X in an Object */
+  _(SET_ATTR, "S") /* set attribute to slot X in an Object */               \
+  _(FUSED_OP, "OI") /* N loads from here, then operator X */                \
+  _(FUSED_OP_STORE, "OI") /* FUSED_OP, then the STORE after the OP */
 
 enum OpCode : uint8_t {
 #define DEFINE_OP(op, _) op,
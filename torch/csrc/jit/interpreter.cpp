@@ -14,11 +14,13 @@
 #include <torch/csrc/jit/instruction.h>
 #include <torch/csrc/jit/operator.h>
 #include <torch/csrc/jit/passes/bailout_graph.h>
+#include <torch/csrc/jit/resource_guard.h>
 #include <torch/csrc/jit/script/compilation_unit.h>
 #include <torch/csrc/jit/script/jit_exception.h>
 
 #include <exception>
 #include <iostream>
+#include <limits>
 #include <memory>
 #include <mutex>
 #include <ostream>
@@ -29,6 +31,28 @@
 #include <utility>
 #include <vector>
 
+// Note [Interpreter dispatch]
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// With GCC and clang, InterpreterStateImpl::runImpl() goes from one
+// instruction to the next through a table of label addresses instead of
+// returning to a switch at the top of a loop. Every instruction then ends in
+// an indirect jump of its own, which the branch predictor can tell apart.
+#if defined(__GNUC__)
+#define JIT_USE_COMPUTED_GOTO
+#endif
+
+#ifdef JIT_USE_COMPUTED_GOTO
+#define INST(NAME) label_##NAME
+#define DISPATCH()                        \
+  do {                                    \
+    inst = af.instructions[af.pc];        \
+    goto* dispatch_table[inst.op];        \
+  } while (0)
+#else
+#define INST(NAME) case NAME
+#define DISPATCH() break
+#endif
+
 namespace torch {
 namespace jit {
 
@@ -331,6 +355,8 @@ struct BailoutBlock {
 struct CodeImpl {
   friend struct InterpreterState;
   std::vector<Instruction> instructions_;
+  // instructions_ with superinstructions, which is what the interpreter runs
+  std::vector<Instruction> fused_instructions_;
 
   // same length as instructions.
   // what node in the graph cause this
@@ -341,6 +367,10 @@ struct CodeImpl {
   std::vector<Operation> operator_table_;
   std::vector<Function*> function_table_;
   std::vector<TypePtr> type_table_;
+  // the shape symbols of the dims the GUARD of the same index checks,
+  // see ProfilingRecord::assignShapeSymbols
+  std::vector<std::vector<int64_t>> guard_symbols_;
+  size_t num_shape_symbols_ = 0;
   int register_size_ = 0;
   size_t n_outputs;
   size_t n_inputs;
@@ -388,6 +418,7 @@ struct CodeImpl {
     // we deferred the emission of bailout blocks so they appear at the end
     // emit them now and patch up the jumps
     insertBailoutBlocks();
+    insertSuperInstructions();
   }
 
   const std::vector<c10::IValue>& constant_table() const {
@@ -584,6 +615,14 @@ struct CodeImpl {
     emitLoadInputs(node->inputs().slice(1, 1));
     insertInstruction(GUARD, type_table_.size());
     type_table_.emplace_back(node->outputs().at(0)->type());
+    guard_symbols_.emplace_back();
+    if (node->hasAttribute(attr::symbols)) {
+      guard_symbols_.back() = node->is(attr::symbols);
+      for (int64_t symbol : guard_symbols_.back()) {
+        num_shape_symbols_ =
+            std::max(num_shape_symbols_, static_cast<size_t>(symbol + 1));
+      }
+    }
     insertInstruction(JF, 0 /* to be patched */);
 
     return instructions_.size() - 1;
@@ -645,6 +684,48 @@ struct CodeImpl {
           instructions_source_[block.jf_instruction_index]);
     }
   }
+  // Note [Superinstructions]
+  // ~~~~~~~~~~~~~~~~~~~~~~~~
+  // Most instructions belong to sequences that push the inputs of an operator
+  // (LOAD, MOVE and LOADC), run it (OP), and store its output (STORE). The
+  // first instruction of every such sequence is replaced by a FUSED_OP (or
+  // FUSED_OP_STORE, if the output is stored), which runs the whole sequence
+  // with one dispatch. It reads the loads and the STORE from instructions_,
+  // and the fused instructions keep the same indices, so the other
+  // instructions of a sequence are still there: jumps don't have to be
+  // patched, and a jump into the middle of a sequence runs the rest of it
+  // unfused. Only the interpreter sees the superinstructions; instructions()
+  // (and so the mobile bytecode) is unchanged.
+  void insertSuperInstructions() {
+    fused_instructions_ = instructions_;
+    const auto is_load = [](OpCode op) {
+      return op == LOAD || op == MOVE || op == LOADC;
+    };
+    const size_t size = instructions_.size();
+    size_t i = 0;
+    while (i < size) {
+      size_t num_loads = 0;
+      while (i + num_loads < size && is_load(instructions_[i + num_loads].op) &&
+             num_loads < std::numeric_limits<uint16_t>::max()) {
+        num_loads++;
+      }
+      const size_t op = i + num_loads;
+      if (op == size) {
+        break;
+      }
+      if (instructions_[op].op != OP) {
+        i = op + 1;
+        continue;
+      }
+      const bool store = op + 1 < size && instructions_[op + 1].op == STORE;
+      if (num_loads > 0 || store) {
+        fused_instructions_[i] = Instruction(
+            store ? FUSED_OP_STORE : FUSED_OP, instructions_[op].X, num_loads);
+      }
+      i = store ? op + 2 : op + 1;
+    }
+  }
+
   void emitInterfaceCall(
       std::string method_name_str,
       c10::ArrayRef<Value*> inputs) {
@@ -736,6 +817,16 @@ struct CodeImpl {
   }
 };
 
+// Interpreters waiting on a future are resumed on the thread that completes
+// it, rather than being scheduled on the inter-op pool again. The depth of
+// these nested resumptions is bounded so that long chains of forks don't
+// overflow the stack.
+static constexpr size_t kMaxInlineResumeDepth = 16;
+static thread_local size_t inline_resume_depth = 0;
+// Set while WAIT adds its callback, when the future may complete in between
+// and the callback is run right away, inside of the interpreter it resumes
+static thread_local bool adding_wait_callback = false;
+
 // InterpreterState state that and used to compute a Code
 struct InterpreterStateImpl : c10::intrusive_ptr_target {
   InterpreterStateImpl(const Code& code) {
@@ -776,24 +867,32 @@ struct InterpreterStateImpl : c10::intrusive_ptr_target {
     // to replace the current frame
     // with a frame of a bailout graph
     size_t base_pointer;
+    // the sizes the shape symbols of `function` are bound to, or -1
+    // before a GUARD binds them
+    std::vector<int64_t> shape_symbols;
   };
 
   // saved-by-value stuff that can exist on the stack inside runInterpreter
   struct ActiveFrame {
     size_t pc;
     Instruction* instructions;
+    // Without superinstructions, which read their operands from here
+    Instruction* unfused_instructions;
     IValue* constants;
     Operation* operators;
     Function** functions;
     TypePtr* types;
+    std::vector<int64_t>* guard_symbols;
 
     ActiveFrame(const Frame& frame)
         : pc(frame.pc),
-          instructions(frame.function->instructions_.data()),
+          instructions(frame.function->fused_instructions_.data()),
+          unfused_instructions(frame.function->instructions_.data()),
           constants(frame.function->constant_table_.data()),
           operators(frame.function->operator_table_.data()),
           functions(frame.function->function_table_.data()),
-          types(frame.function->type_table_.data()) {}
+          types(frame.function->type_table_.data()),
+          guard_symbols(frame.function->guard_symbols_.data()) {}
   };
 
   std::vector<Frame> frames;
@@ -804,7 +903,11 @@ struct InterpreterStateImpl : c10::intrusive_ptr_target {
   }
 
   void enterFrame(const Code& code, size_t base_pointer) {
-    frames.emplace_back(Frame{code.pImpl, 0, base_pointer});
+    frames.emplace_back(Frame{
+        code.pImpl,
+        0,
+        base_pointer,
+        std::vector<int64_t>(code.pImpl->num_shape_symbols_, -1)});
     registers.resize(registers.size() + code.pImpl->register_size_);
     // frames.back().function->dump(std::cout);
   }
@@ -814,6 +917,30 @@ struct InterpreterStateImpl : c10::intrusive_ptr_target {
     frames.pop_back();
   }
 
+  // Binds the symbolic dims of a guarded tensor to its sizes, or checks
+  // them against the sizes an earlier GUARD of the frame bound them to
+  bool bindShapeSymbols(const std::vector<int64_t>& symbols, const at::Tensor& t) {
+    if (symbols.empty()) {
+      return true;
+    }
+    if (!t.defined() || static_cast<size_t>(t.dim()) != symbols.size()) {
+      return false;
+    }
+    auto& bound = frames.back().shape_symbols;
+    for (size_t d = 0; d < symbols.size(); d++) {
+      if (symbols[d] < 0) {
+        continue;
+      }
+      int64_t& size = bound[symbols[d]];
+      if (size < 0) {
+        size = t.size(d);
+      } else if (size != t.size(d)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
   // relative to the end of the register list so that when we call
   // functions we are referring to the registers of the currenly executing
   // function.
@@ -821,6 +948,22 @@ struct InterpreterStateImpl : c10::intrusive_ptr_target {
     return *(registers.end() - reg);
   }
 
+  // Runs the num_loads instructions from af.pc on that a superinstruction
+  // fused with its operator
+  void loadArguments(ActiveFrame& af, size_t num_loads, Stack& stack) {
+    const Instruction* load = af.unfused_instructions + af.pc;
+    for (size_t i = 0; i < num_loads; ++i, ++load) {
+      if (load->op == LOADC) {
+        stack.emplace_back(af.constants[load->X]);
+      } else if (load->op == MOVE) {
+        stack.emplace_back(std::move(reg(load->X)));
+      } else {
+        stack.emplace_back(reg(load->X));
+      }
+    }
+    af.pc += num_loads;
+  }
+
   void dump(std::ostream& out, const Stack& stack) const {
     out << "Stack:\n";
     for (const auto& val : stack) {
@@ -844,67 +987,89 @@ struct InterpreterStateImpl : c10::intrusive_ptr_target {
 
     ActiveFrame af(frames.back());
     try {
+#ifdef JIT_USE_COMPUTED_GOTO
+      static void* dispatch_table[] = {
+#define DISPATCH_LABEL(op, _) &&label_##op,
+          FORALL_OPCODES(DISPATCH_LABEL)
+#undef DISPATCH_LABEL
+      };
+      Instruction inst = af.instructions[af.pc];
+      goto* dispatch_table[inst.op];
+      {
+#else
       while (true) {
 //         std::cout << "RUNNING ";
 //         frames.back().function->dump(std::cout, af.pc);
         Instruction inst = af.instructions[af.pc];
         switch (inst.op) {
-          case OP:
+#endif
+          INST(OP):
             af.operators[inst.X](stack);
             ++af.pc;
-            break;
-          case OPN:
+            DISPATCH();
+          INST(FUSED_OP):
+            loadArguments(af, inst.N, stack);
+            af.operators[inst.X](stack);
+            ++af.pc;
+            DISPATCH();
+          INST(FUSED_OP_STORE):
+            loadArguments(af, inst.N, stack);
+            af.operators[inst.X](stack);
+            reg(af.unfused_instructions[af.pc + 1].X) = pop(stack);
+            af.pc += 2;
+            DISPATCH();
+          INST(OPN):
             AT_ERROR("OPN is currently supported in mobile mode only.");
-            break;
-          case LOAD:
+            DISPATCH();
+          INST(LOAD):
             stack.emplace_back(reg(inst.X));
             ++af.pc;
-            break;
-          case MOVE:
+            DISPATCH();
+          INST(MOVE):
             stack.emplace_back(std::move(reg(inst.X)));
             ++af.pc;
-            break;
-          case STORE:
+            DISPATCH();
+          INST(STORE):
             reg(inst.X) = pop(stack);
             ++af.pc;
-            break;
-          case STOREN:
+            DISPATCH();
+          INST(STOREN):
             for (size_t i = inst.N; i > 0; --i) {
               reg(inst.X + i - 1) = pop(stack);
             }
             ++af.pc;
-            break;
-          case DROP:
+            DISPATCH();
+          INST(DROP):
             pop(stack);
             ++af.pc;
-            break;
-          case DROPR:
+            DISPATCH();
+          INST(DROPR):
             reg(inst.X) = IValue();
             ++af.pc;
-            break;
-          case LOADC:
+            DISPATCH();
+          INST(LOADC):
             stack.emplace_back(af.constants[inst.X]);
             ++af.pc;
-            break;
-          case GET_ATTR: {
+            DISPATCH();
+          INST(GET_ATTR): {
             auto userObj = pop(stack).toObject();
             auto value = userObj->getSlot(inst.X);
             push(stack, std::move(value));
             ++af.pc;
-          } break;
-          case SET_ATTR: {
+          } DISPATCH();
+          INST(SET_ATTR): {
             auto v = pop(stack);
             auto userObj = pop(stack).toObject();
             userObj->setSlot(inst.X, std::move(v));
             ++af.pc;
-          } break;
-          case JF:
+          } DISPATCH();
+          INST(JF):
             af.pc += (pop(stack).toBool()) ? 1 : inst.X;
-            break;
-          case JMP:
+            DISPATCH();
+          INST(JMP):
             af.pc += inst.X;
-            break;
-          case LOOP: {
+            DISPATCH();
+          INST(LOOP): {
             // stack: iteration_count, max_iter, cond, loop_carried_deps...
             auto frame = stack.end() - (inst.N + 1);
             int64_t trip_count = frame[0].toInt();
@@ -922,15 +1087,15 @@ struct InterpreterStateImpl : c10::intrusive_ptr_target {
               drop(stack, 3); // iteration_count, max_iter, cond
               af.pc += inst.X;
             }
-          } break;
-          case CALL: {
+          } DISPATCH();
+          INST(CALL): {
             const Code& code =
                 af.functions[inst.X]->get_executor().getPlanFor(stack).code;
             frames.back().pc = af.pc + 1;
             enterFrame(code, stack.size() - code.num_inputs());
             af = ActiveFrame(frames.back());
-          } break;
-          case INTERFACE_CALL: {
+          } DISPATCH();
+          INST(INTERFACE_CALL): {
             // note the hash table lookup to find the function
             // this can be more optimized if necessary, caching parts
             // of the hashing computation or storing the offset when
@@ -943,12 +1108,12 @@ struct InterpreterStateImpl : c10::intrusive_ptr_target {
             frames.back().pc = af.pc + 1;
             enterFrame(code, stack.size() - inst.N);
             af = ActiveFrame(frames.back());
-          } break;
-          case RET:
+          } DISPATCH();
+          INST(RET):
             if (frames.size() > 1) {
               leaveFrame();
               af = ActiveFrame(frames.back());
-              break;
+              DISPATCH();
             }
             if (future_) {
               auto num_outputs = frames.back().function->n_outputs;
@@ -960,7 +1125,7 @@ struct InterpreterStateImpl : c10::intrusive_ptr_target {
               }
             }
             return false;
-          case WAIT: {
+          INST(WAIT): {
             auto future = stack.back().toFuture();
             if (!future->completed()) {
               getOrCreateFuture();
@@ -973,10 +1138,18 @@ struct InterpreterStateImpl : c10::intrusive_ptr_target {
                     Stack stack)
                     : state_(std::move(state)), stack_(std::move(stack)) {}
                 void operator()() {
-                  at::launch(InterpreterContinuation(
+                  InterpreterContinuation continuation(
                       state_,
                       std::move(stack_),
-                      autograd::GradMode::is_enabled()));
+                      autograd::GradMode::is_enabled());
+                  if (adding_wait_callback ||
+                      inline_resume_depth >= kMaxInlineResumeDepth) {
+                    at::launch(std::move(continuation));
+                    return;
+                  }
+                  ++inline_resume_depth;
+                  ResourceGuard depth_guard([] { --inline_resume_depth; });
+                  continuation();
                 }
 
                private:
@@ -999,24 +1172,26 @@ struct InterpreterStateImpl : c10::intrusive_ptr_target {
               }
               // save pc into the frame so we continue here when restored
               frames.back().pc = af.pc;
+              adding_wait_callback = true;
               future->addCallback(
                   Callback(intrusive_from_this(), std::move(copied)));
+              adding_wait_callback = false;
 
               return true;
             }
             stack.pop_back();
             stack.emplace_back(future->value());
             ++af.pc;
-          } break;
-          case GUARD: {
+          } DISPATCH();
+          INST(GUARD): {
             auto t = stack.back().toTensor();
-            auto actual = t.defined() ? TensorType::create(t)
-                                      : TensorType::get()->withUndefined();
             const TypePtr &expected = af.types[inst.X];
-            push(stack, *expected == *actual);
+            push(stack,
+                 expected->expect<TensorType>()->matchTensor(t) &&
+                     bindShapeSymbols(af.guard_symbols[inst.X], t));
             ++af.pc;
-          } break;
-          case TAIL_CALL: {
+          } DISPATCH();
+          INST(TAIL_CALL): {
             af.functions[inst.X]->ensure_defined();
             const Code &code =
                 af.functions[inst.X]->get_executor().getPlanFor(stack).code;
@@ -1032,9 +1207,13 @@ struct InterpreterStateImpl : c10::intrusive_ptr_target {
             leaveFrame();
             enterFrame(code, base_pointer);
             af = ActiveFrame(frames.back());
-          } break;
+          } DISPATCH();
+#ifdef JIT_USE_COMPUTED_GOTO
+      }
+#else
         }
       }
+#endif
     } catch (std::exception& e) {
       frames.back().pc = af.pc;
       bool is_jit_exception = dynamic_cast<JITException*>(&e);
@@ -70,18 +70,6 @@ struct InterpreterState {
   friend struct InterpreterStateImpl;
 };
 
-// Created by wait()
-struct Suspend : public std::exception {
-  const char* what() const noexcept override {
-    return "Suspend";
-  }
-
-  explicit Suspend(c10::intrusive_ptr<Future> future_)
-      : future(std::move(future_)) {}
-
-  c10::intrusive_ptr<Future> future;
-};
-
 struct InterpreterContinuation {
   InterpreterContinuation(
       InterpreterState state_,
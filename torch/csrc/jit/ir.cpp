@@ -951,6 +951,9 @@ bool Node::hasSideEffects() const {
     case aten::manual_seed:
     case prim::AddStatValue:
     case prim::TimePoint:
+    case prim::MemoryPlanBegin:
+    case prim::MemoryPlanSlot:
+    case prim::MemoryPlanEnd:
     case prim::CallFunction:
     case prim::CallMethod:
     case prim::BailoutTemplate:
@@ -0,0 +1,448 @@
+#include <torch/csrc/jit/mobile/flat_bytecode.h>
+
+#include <ATen/ATen.h>
+#include <c10/util/Exception.h>
+#include <torch/csrc/autograd/variable.h>
+#include <torch/csrc/jit/mobile/module.h>
+
+#include <cstddef>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+#include <unordered_map>
+
+namespace torch {
+namespace jit {
+
+char const* toString(OpCode op);
+OpCode parseOpCode(const char* str);
+
+namespace mobile {
+
+// Note [Flat bytecode]
+// ~~~~~~~~~~~~~~~~~~~~
+// bytecode.pkl holds a tuple per instruction, operator and constant, which the
+// loader unpickles and converts one by one. The flat bytecode record holds the
+// same functions as arrays of fixed-size structs, which are read where they
+// are: the instructions are used in place by the interpreter, which keeps the
+// record alive, so with a mmapped archive (see MmapFileAdapter) loading them
+// only touches their pages. All offsets are in bytes from the start of the
+// record, and every struct is 8-byte aligned:
+//
+//   FlatHeader
+//   FlatString[num_opcodes]         names of the opcodes the values stand for
+//   FlatFunction[num_functions]
+//   for each function:
+//     Instruction[num_instructions]
+//     FlatString[2 * num_operators] name and overload name of each operator
+//     FlatConstant[num_constants]
+//   FlatTensor and int64_t sizes and strides of the tensor constants
+//   the characters of the strings
+//
+// Tensor constants are stored by their metadata, and their storages as
+// separate records; the constants of other types than None, int, float, bool,
+// string and CPU tensor go to a pickled tuple. The loader checks the magic
+// number, version and byte order, and maps the opcodes by name, so that the
+// instructions are copied only if the numbering of OpCode changed.
+
+namespace {
+constexpr char kMagic[8] = {'P', 'T', 'M', 'F', 'L', 'A', 'T', '\0'};
+constexpr uint32_t kVersion = 1;
+constexpr uint32_t kByteOrderMark = 0x01020304;
+constexpr size_t kAlignment = 8;
+
+struct FlatString {
+  uint32_t offset;
+  uint32_t size;
+};
+
+struct FlatHeader {
+  char magic[8];
+  uint32_t byte_order_mark;
+  uint32_t version;
+  uint32_t opcodes_offset;
+  uint32_t num_opcodes;
+  uint32_t functions_offset;
+  uint32_t num_functions;
+};
+
+struct FlatFunction {
+  FlatString qualname;
+  uint32_t instructions_offset;
+  uint32_t num_instructions;
+  uint32_t operators_offset;
+  uint32_t num_operators;
+  uint32_t constants_offset;
+  uint32_t num_constants;
+  uint32_t register_size;
+  uint32_t padding;
+};
+
+enum class FlatTag : uint32_t {
+  None,
+  Int,
+  Double,
+  Bool,
+  String,
+  Tensor,
+  // Constants of the other types, in the pickled tuple
+  Pickled,
+};
+
+struct FlatConstant {
+  FlatTag tag;
+  uint32_t padding;
+  union {
+    int64_t i;
+    double d;
+    FlatString s;
+    // Offset of the FlatTensor, or index of the pickled constant
+    uint64_t index;
+  };
+};
+
+struct FlatTensor {
+  uint32_t storage;
+  int32_t scalar_type;
+  uint64_t storage_numel;
+  int64_t storage_offset;
+  uint32_t dim;
+  // int64_t[2 * dim], the sizes then the strides
+  uint32_t sizes_offset;
+};
+
+static_assert(
+    std::is_trivially_copyable<Instruction>::value &&
+        sizeof(Instruction) == 8,
+    "instructions are used in place");
+static_assert(sizeof(FlatConstant) == 16, "unexpected padding");
+static_assert(sizeof(FlatTensor) == 32, "unexpected padding");
+
+class FlatReader {
+ public:
+  FlatReader(const char* data, size_t size) : data_(data), size_(size) {}
+
+  template <typename T>
+  const T* array(uint64_t offset, uint64_t n) const {
+    TORCH_CHECK(
+        offset % alignof(T) == 0 && offset <= size_ &&
+            n <= (size_ - offset) / sizeof(T),
+        "The flat bytecode record is corrupted");
+    return reinterpret_cast<const T*>(data_ + offset);
+  }
+
+  std::string string(const FlatString& str) const {
+    return std::string(array<char>(str.offset, str.size), str.size);
+  }
+
+ private:
+  const char* data_;
+  size_t size_;
+};
+
+bool isFlatTensor(const at::Tensor& tensor) {
+  return tensor.defined() && tensor.device().is_cpu() &&
+      tensor.layout() == at::kStrided && !tensor.is_quantized() &&
+      !tensor.requires_grad();
+}
+} // namespace
+
+std::string serializeFlatBytecode(
+    const std::vector<FlatFunctionDef>& functions,
+    std::vector<at::Tensor>& storages,
+    std::vector<c10::IValue>& pickled_constants) {
+  std::string data;
+  // The characters of the strings go last, and their FlatString are written
+  // over the structs holding them then; the locations are kept until then
+  std::vector<std::pair<std::string, size_t>> strings;
+  auto align = [&]() {
+    data.resize((data.size() + kAlignment - 1) / kAlignment * kAlignment);
+  };
+  auto reserve = [&](size_t nbytes) -> uint32_t {
+    align();
+    const size_t offset = data.size();
+    data.resize(offset + nbytes);
+    TORCH_CHECK(
+        data.size() <= std::numeric_limits<uint32_t>::max(),
+        "The bytecode is too large for the flat format");
+    return offset;
+  };
+  auto write = [&](size_t offset, const void* value, size_t nbytes) {
+    if (nbytes > 0) {
+      std::memcpy(&data[offset], value, nbytes);
+    }
+  };
+  auto string = [&](size_t location, const std::string& str) {
+    strings.emplace_back(str, location);
+  };
+
+  size_t num_opcodes = 0;
+#define COUNT_OP(op, _) ++num_opcodes;
+  FORALL_OPCODES(COUNT_OP)
+#undef COUNT_OP
+
+  const uint32_t header_offset = reserve(sizeof(FlatHeader));
+  FlatHeader header{};
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.byte_order_mark = kByteOrderMark;
+  header.version = kVersion;
+  header.num_opcodes = num_opcodes;
+  header.opcodes_offset = reserve(num_opcodes * sizeof(FlatString));
+  for (size_t i = 0; i < num_opcodes; ++i) {
+    string(
+        header.opcodes_offset + i * sizeof(FlatString),
+        toString(static_cast<OpCode>(i)));
+  }
+  header.num_functions = functions.size();
+  header.functions_offset = reserve(functions.size() * sizeof(FlatFunction));
+  write(header_offset, &header, sizeof(header));
+
+  std::unordered_map<const c10::StorageImpl*, uint32_t> storage_indices;
+  for (size_t f = 0; f < functions.size(); ++f) {
+    const auto& def = functions[f];
+    const size_t function_offset =
+        header.functions_offset + f * sizeof(FlatFunction);
+    FlatFunction function{};
+    string(function_offset + offsetof(FlatFunction, qualname), def.qualname);
+
+    function.num_instructions = def.instructions.size();
+    function.instructions_offset =
+        reserve(def.instructions.size() * sizeof(Instruction));
+    write(
+        function.instructions_offset,
+        def.instructions.data(),
+        def.instructions.size() * sizeof(Instruction));
+
+    function.num_operators = def.operators.size();
+    function.operators_offset =
+        reserve(2 * def.operators.size() * sizeof(FlatString));
+    for (size_t i = 0; i < def.operators.size(); ++i) {
+      const size_t location =
+          function.operators_offset + 2 * i * sizeof(FlatString);
+      string(location, def.operators[i].name);
+      string(location + sizeof(FlatString), def.operators[i].overload_name);
+    }
+
+    function.num_constants = def.constants.size();
+    function.constants_offset =
+        reserve(def.constants.size() * sizeof(FlatConstant));
+    for (size_t i = 0; i < def.constants.size(); ++i) {
+      const auto& value = def.constants[i];
+      const size_t location =
+          function.constants_offset + i * sizeof(FlatConstant);
+      FlatConstant constant{};
+      if (value.isNone()) {
+        constant.tag = FlatTag::None;
+      } else if (value.isInt()) {
+        constant.tag = FlatTag::Int;
+        constant.i = value.toInt();
+      } else if (value.isDouble()) {
+        constant.tag = FlatTag::Double;
+        constant.d = value.toDouble();
+      } else if (value.isBool()) {
+        constant.tag = FlatTag::Bool;
+        constant.i = value.toBool();
+      } else if (value.isString()) {
+        constant.tag = FlatTag::String;
+        string(location + offsetof(FlatConstant, s), value.toStringRef());
+      } else if (value.isTensor() && isFlatTensor(value.toTensor())) {
+        const auto& tensor = value.toTensor();
+        const auto* impl = tensor.storage().unsafeGetStorageImpl();
+        auto it = storage_indices.find(impl);
+        if (it == storage_indices.end()) {
+          it = storage_indices.emplace(impl, storages.size()).first;
+          storages.push_back(tensor);
+        }
+        FlatTensor flat{};
+        flat.storage = it->second;
+        flat.scalar_type = static_cast<int32_t>(tensor.scalar_type());
+        flat.storage_numel = tensor.storage().size();
+        flat.storage_offset = tensor.storage_offset();
+        flat.dim = tensor.dim();
+        const uint32_t tensor_offset = reserve(sizeof(FlatTensor));
+        flat.sizes_offset = reserve(2 * tensor.dim() * sizeof(int64_t));
+        write(
+            flat.sizes_offset,
+            tensor.sizes().data(),
+            tensor.dim() * sizeof(int64_t));
+        write(
+            flat.sizes_offset + tensor.dim() * sizeof(int64_t),
+            tensor.strides().data(),
+            tensor.dim() * sizeof(int64_t));
+        write(tensor_offset, &flat, sizeof(flat));
+        constant.tag = FlatTag::Tensor;
+        constant.index = tensor_offset;
+      } else {
+        constant.tag = FlatTag::Pickled;
+        constant.index = pickled_constants.size();
+        pickled_constants.push_back(value);
+      }
+      write(location, &constant, sizeof(constant));
+    }
+    function.register_size = def.register_size;
+    write(function_offset, &function, sizeof(function));
+  }
+
+  for (const auto& entry : strings) {
+    FlatString str;
+    str.offset = data.size();
+    str.size = entry.first.size();
+    data.append(entry.first);
+    TORCH_CHECK(
+        data.size() <= std::numeric_limits<uint32_t>::max(),
+        "The bytecode is too large for the flat format");
+    write(entry.second, &str, sizeof(str));
+  }
+  return data;
+}
+
+void parseFlatBytecode(
+    at::DataPtr record,
+    size_t size,
+    const std::function<std::tuple<at::DataPtr, size_t>(size_t)>& read_storage,
+    const std::function<c10::IValue()>& read_pickled_constants,
+    c10::optional<at::Device> device,
+    CompilationUnit& mcu) {
+  auto holder = std::make_shared<at::DataPtr>(std::move(record));
+  FlatReader reader(static_cast<const char*>(holder->get()), size);
+
+  const auto& header = *reader.array<FlatHeader>(0, 1);
+  TORCH_CHECK(
+      std::memcmp(header.magic, kMagic, sizeof(kMagic)) == 0,
+      "The flat bytecode record is corrupted");
+  TORCH_CHECK(
+      header.byte_order_mark == kByteOrderMark,
+      "The flat bytecode record was written with another byte order");
+  TORCH_CHECK(
+      header.version == kVersion,
+      "Unsupported flat bytecode version ",
+      header.version,
+      ", expected ",
+      kVersion);
+
+  // The instructions are used in place unless the opcodes were renumbered
+  std::vector<OpCode> opcodes;
+  bool renumbered = false;
+  const auto* opcode_names =
+      reader.array<FlatString>(header.opcodes_offset, header.num_opcodes);
+  for (size_t i = 0; i < header.num_opcodes; ++i) {
+    const auto name = reader.string(opcode_names[i]);
+    const OpCode op = parseOpCode(name.c_str());
+    TORCH_CHECK(name == toString(op), "Unknown opcode ", name);
+    opcodes.push_back(op);
+    renumbered |= op != static_cast<OpCode>(i);
+  }
+
+  const auto* functions =
+      reader.array<FlatFunction>(header.functions_offset, header.num_functions);
+  c10::optional<std::vector<c10::IValue>> pickled_constants;
+  std::unordered_map<uint32_t, at::Storage> storages;
+  for (size_t f = 0; f < header.num_functions; ++f) {
+    const auto& flat = functions[f];
+    auto function = std::unique_ptr<Function>(
+        new Function(c10::QualifiedName(reader.string(flat.qualname))));
+
+    const auto* instructions = reader.array<Instruction>(
+        flat.instructions_offset, flat.num_instructions);
+    if (renumbered) {
+      for (size_t i = 0; i < flat.num_instructions; ++i) {
+        const auto& ins = instructions[i];
+        TORCH_CHECK(ins.op < opcodes.size(), "Unknown opcode ", int(ins.op));
+        function->append_instruction(opcodes[ins.op], ins.X, ins.N);
+      }
+    } else {
+      function->set_flat_instructions(
+          holder, instructions, flat.num_instructions);
+    }
+
+    const auto* operators = reader.array<FlatString>(
+        flat.operators_offset, 2 * uint64_t(flat.num_operators));
+    for (size_t i = 0; i < flat.num_operators; ++i) {
+      function->append_operator(
+          reader.string(operators[2 * i]),
+          reader.string(operators[2 * i + 1]));
+    }
+    // vararg operators are stored in a separate table.
+    function->build_vararg_operator_table();
+
+    const auto* constants = reader.array<FlatConstant>(
+        flat.constants_offset, flat.num_constants);
+    for (size_t i = 0; i < flat.num_constants; ++i) {
+      const auto& constant = constants[i];
+      switch (constant.tag) {
+        case FlatTag::None:
+          function->append_constant(c10::IValue());
+          break;
+        case FlatTag::Int:
+          function->append_constant(constant.i);
+          break;
+        case FlatTag::Double:
+          function->append_constant(constant.d);
+          break;
+        case FlatTag::Bool:
+          function->append_constant(static_cast<bool>(constant.i));
+          break;
+        case FlatTag::String:
+          function->append_constant(reader.string(constant.s));
+          break;
+        case FlatTag::Tensor: {
+          const auto& tensor = *reader.array<FlatTensor>(constant.index, 1);
+          const auto* sizes = reader.array<int64_t>(
+              tensor.sizes_offset, 2 * uint64_t(tensor.dim));
+          TORCH_CHECK(
+              tensor.scalar_type >= 0 &&
+                  tensor.scalar_type <
+                      static_cast<int32_t>(at::ScalarType::NumOptions),
+              "The flat bytecode record is corrupted");
+          const auto type = static_cast<at::ScalarType>(tensor.scalar_type);
+          auto it = storages.find(tensor.storage);
+          if (it == storages.end()) {
+            at::DataPtr storage_ptr;
+            size_t storage_size;
+            std::tie(storage_ptr, storage_size) = read_storage(tensor.storage);
+            const auto type_meta = at::CPU(type).typeMeta();
+            TORCH_CHECK(
+                tensor.storage_numel <= storage_size / type_meta.itemsize(),
+                "The flat bytecode record is corrupted");
+            at::Storage storage(
+                type_meta,
+                tensor.storage_numel,
+                std::move(storage_ptr),
+                /*allocator=*/nullptr,
+                /*resizable=*/false);
+            it = storages.emplace(tensor.storage, std::move(storage)).first;
+          }
+          auto value = at::empty({0}, at::CPU(type).options())
+                           .set_(
+                               it->second,
+                               tensor.storage_offset,
+                               at::IntArrayRef(sizes, tensor.dim),
+                               at::IntArrayRef(sizes + tensor.dim, tensor.dim));
+          if (device && !device->is_cpu()) {
+            value = value.to(*device, value.scalar_type());
+          }
+          function->append_constant(
+              autograd::make_variable(std::move(value), false));
+        } break;
+        case FlatTag::Pickled: {
+          if (!pickled_constants) {
+            pickled_constants = read_pickled_constants().toTuple()->elements();
+          }
+          TORCH_CHECK(
+              constant.index < pickled_constants->size(),
+              "The flat bytecode record is corrupted");
+          function->append_constant((*pickled_constants)[constant.index]);
+        } break;
+        default:
+          AT_ERROR("The flat bytecode record is corrupted");
+      }
+    }
+
+    function->set_register_size(flat.register_size);
+    mcu.register_function(std::move(function));
+  }
+}
+
+} // namespace mobile
+} // namespace jit
+} // namespace torch
@@ -0,0 +1,60 @@
+#pragma once
+#include <ATen/core/ivalue.h>
+#include <ATen/core/operator_name.h>
+#include <c10/core/Allocator.h>
+#include <c10/util/Optional.h>
+#include <torch/csrc/WindowsTorchApiMacro.h>
+#include <torch/csrc/jit/instruction.h>
+
+#include <functional>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace torch {
+namespace jit {
+namespace mobile {
+class CompilationUnit;
+
+// The bytecode of a mobile module, as a record that the lite interpreter uses
+// in place rather than unpickling it: "bytecode.flat" in the archive, next to
+// bytecode.pkl. See Note [Flat bytecode]
+constexpr const char* kFlatBytecodeRecord = "bytecode.flat";
+// The storages of its tensor constants are the records
+// <kFlatStoragePrefix><index>, and the constants it doesn't hold are pickled
+// in a tuple as the "bytecode_constants" archive
+constexpr const char* kFlatStoragePrefix = "bytecode_flat/";
+constexpr const char* kFlatConstantsArchive = "bytecode_constants";
+
+struct FlatFunctionDef {
+  std::string qualname;
+  std::vector<Instruction> instructions;
+  std::vector<c10::OperatorName> operators;
+  std::vector<c10::IValue> constants;
+  size_t register_size;
+};
+
+// Returns the flat bytecode record of functions. The tensors to write the
+// storages of are appended to storages, and the constants to pickle to
+// pickled_constants.
+TORCH_API std::string serializeFlatBytecode(
+    const std::vector<FlatFunctionDef>& functions,
+    std::vector<at::Tensor>& storages,
+    std::vector<c10::IValue>& pickled_constants);
+
+// Registers the functions of a flat bytecode record with mcu. record must
+// stay valid until the functions are gone; they keep the allocation of its
+// DataPtr.
+TORCH_API void parseFlatBytecode(
+    at::DataPtr record,
+    size_t size,
+    // Returns the storage record of the given index, and its size
+    const std::function<std::tuple<at::DataPtr, size_t>(size_t)>& read_storage,
+    // Returns the pickled constants, called only if there are any
+    const std::function<c10::IValue()>& read_pickled_constants,
+    c10::optional<at::Device> device,
+    CompilationUnit& mcu);
+
+} // namespace mobile
+} // namespace jit
+} // namespace torch
@@ -1,8 +1,9 @@
 #include "function.h"
 #include "interpreter.h"
+#include "memory_plan.h"
+#include "register_mobile_ops.h"
 #include <torch/csrc/jit/instruction.h>
 #include <torch/csrc/jit/vararg_functions.h>
-#include <ATen/core/op_registration/op_registration.h>
 
 namespace torch{
 namespace jit{
@@ -35,42 +36,67 @@ void Function::append_operator(const std::string& name,
                                const std::string& overload_name) {
   // Keep the original opname in code_
   code_->op_names_.emplace_back(name, overload_name);
-  auto opname = code_->op_names_.back();
-  // Add "_" prefix to work around the double registration both of jit/generated
-  // and here. TODO: remove it when we have separate build for lite interpreter.
-  opname.name = "_" + opname.name;
-  auto op = c10::Dispatcher::singleton().findSchema(opname);
-  TORCH_CHECK(op.has_value(), opname.name, ".", opname.overload_name, " cannot be found.");
-  code_->operators_.emplace_back(op);
+  const auto& opname = code_->op_names_.back();
+  auto index = findOperator(opname);
+  TORCH_CHECK(
+      index.has_value(),
+      opname.name,
+      ".",
+      opname.overload_name,
+      " is not included in this build of the lite interpreter; add it to "
+      "the SELECTED_OP_LIST of the build.");
+  code_->operators_.emplace_back(*index);
+}
+
+void Function::set_flat_instructions(
+    std::shared_ptr<at::DataPtr> record,
+    const Instruction* instructions,
+    size_t size) {
+  TORCH_INTERNAL_ASSERT(code_->instructions_.empty());
+  for (size_t i = 0; i < size; ++i) {
+    TORCH_CHECK(isOpSupportedInMobile(instructions[i].op),
+                "Instruction ", i, " is not supported in mobile module.");
+  }
+  code_->flat_record_ = std::move(record);
+  code_->flat_instructions_ = instructions;
+  code_->num_flat_instructions_ = size;
 }
 
 void Function::build_vararg_operator_table() {
-  for (auto& ins : code_->instructions_) {
+  // The instructions are left as they are, so that they can be used in place
+  auto& vararg_operators = code_->vararg_operators_;
+  vararg_operators.resize(code_->op_names_.size());
+  for (const auto& ins : code_->instructions()) {
     if (ins.op == OPN) {
-      auto opname = code_->op_names_[ins.X];
+      TORCH_CHECK(
+          ins.X >= 0 && static_cast<size_t>(ins.X) < vararg_operators.size(),
+          "OPN operator ", ins.X, " is out of range.");
+      if (vararg_operators[ins.X]) {
+        continue;
+      }
+      const auto& opname = code_->op_names_[ins.X];
       if (opname.name == "prim::ListConstruct") {
         if (opname.overload_name == "int") {
-          code_->vararg_operators_.emplace_back(listConstructFunc<int64_t>);
+          vararg_operators[ins.X] = listConstructFunc<int64_t>;
         } else if (opname.overload_name == "float") {
-          code_->vararg_operators_.emplace_back(listConstructFunc<double>);
+          vararg_operators[ins.X] = listConstructFunc<double>;
         } else if (opname.overload_name == "bool") {
-          code_->vararg_operators_.emplace_back(listConstructFunc<bool>);
+          vararg_operators[ins.X] = listConstructFunc<bool>;
         } else if (opname.overload_name == "Tensor") {
-          code_->vararg_operators_.emplace_back(tensorListConstructFunc);
+          vararg_operators[ins.X] = tensorListConstructFunc;
         } else {
           AT_ERROR("Type of ListConstruct is not supported.");
         }
       } else if (opname.name == "prim::TupleConstruct") {
-        code_->vararg_operators_.emplace_back(tupleConstructFunc);
+        vararg_operators[ins.X] = tupleConstructFunc;
       } else if (opname.name == "prim::TupleUnpack") {
-        code_->vararg_operators_.emplace_back(tupleUnpackFunc);
+        vararg_operators[ins.X] = tupleUnpackFunc;
       } else if (opname.name == "aten::format") {
-        code_->vararg_operators_.emplace_back(formatFunc);
+        vararg_operators[ins.X] = formatFunc;
       }
       else {
         AT_ERROR("OPN operator ", opname.name, " is not supported.");
       }
-      ins.X = code_->vararg_operators_.size() - 1;
     }
   }
 }
@@ -83,6 +109,25 @@ void Function::set_register_size(size_t size) {
   code_->register_size_ = size;
 }
 
+void Function::plan_memory(Stack& stack) {
+  code_->memory_plan_ = nullptr;
+  MemoryPlanRecorder recorder;
+  {
+    // The registers are freed with the state, before the recording ends
+    InterpreterState interp_state(code_);
+    interp_state.run(stack);
+  }
+  code_->memory_plan_ = recorder.finish();
+}
+
+void Function::clear_memory_plan() {
+  code_->memory_plan_ = nullptr;
+}
+
+const MemoryPlan* Function::memory_plan() const {
+  return code_->memory_plan_.get();
+}
+
 bool Function::run(Stack& stack) const {
   InterpreterState interp_state(code_);
   return interp_state.run(stack);
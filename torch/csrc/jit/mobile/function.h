@@ -1,5 +1,6 @@
 #pragma once
 #include <ATen/core/ivalue.h>
+#include <c10/core/Allocator.h>
 //#include <aten/src/Aten/core/operator_name.h>
 #include <vector>
 
@@ -7,9 +8,11 @@ namespace torch{
 namespace jit{
 using Stack = std::vector<c10::IValue>;
 enum OpCode : uint8_t;
+struct Instruction;
 
 namespace mobile {
 struct Code;
+class MemoryPlan;
 
 class Function{
  public:
@@ -18,6 +21,11 @@ class Function{
   const std::string& name() const;
   const c10::QualifiedName& qualname() const;
   void append_instruction(OpCode op, int X, int N);
+  // Uses the instructions in place, from a record kept alive by record
+  void set_flat_instructions(
+      std::shared_ptr<at::DataPtr> record,
+      const Instruction* instructions,
+      size_t size);
   void append_operator(const std::string& name,
                        const std::string& overload_name);
   void append_vararg_operator(const std::string& name,
@@ -25,6 +33,13 @@ class Function{
   void build_vararg_operator_table();
   void append_constant(const c10::IValue& constant);
   void set_register_size(size_t size);
+  // Runs the function on sample inputs, and serves the CPU allocations of the
+  // following runs of the same shapes from a plan made from this one. See
+  // Note [Mobile memory planning]
+  void plan_memory(Stack& stack);
+  void clear_memory_plan();
+  // nullptr unless plan_memory() was called
+  const MemoryPlan* memory_plan() const;
 
  private:
   c10::QualifiedName name_;
@@ -4,6 +4,7 @@
 #include <torch/csrc/jit/unpickler.h>
 #include <caffe2/serialize/inline_container.h>
 #include <torch/csrc/jit/instruction.h>
+#include <torch/csrc/jit/mobile/flat_bytecode.h>
 
 
 #include <fstream>
@@ -24,10 +25,13 @@
 //       ('LOADC', 0, 0),
 //       ('OP', 1, 0),
 //       ('RET', 0, 0))),
-//     ('operators', (('_aten::add', 'Tensor'), ('_aten::add', 'Scalar'))),
+//     ('operators', (('aten::add', 'Tensor'), ('aten::add', 'Scalar'))),
 //     ('constants', (1, 4)),
 //     ('register_size', 2))),)
 
+// Archives written since have the same bytecode in a flat record too, which
+// is read instead when it's there, see Note [Flat bytecode].
+
 // Note that currently the backward compatibility is not supported by bytecode.
 // This format and process need to be revisted and redesigned if we want to
 // suppot backward compatibility in future.
@@ -121,9 +125,25 @@ BytecodeDeserializer::BytecodeDeserializer(std::unique_ptr<PyTorchStreamReader>
 
 mobile::Module BytecodeDeserializer::deserialize(c10::optional<at::Device> device) {
   device_ = device;
-  auto bvals = readArchive("bytecode").toTuple()->elements();
   auto mcu = std::make_shared<mobile::CompilationUnit>();
-  parseMethods(bvals, mcu);
+  if (reader_->hasRecord(mobile::kFlatBytecodeRecord)) {
+    at::DataPtr data;
+    size_t size;
+    std::tie(data, size) = reader_->getRecord(mobile::kFlatBytecodeRecord);
+    mobile::parseFlatBytecode(
+        std::move(data),
+        size,
+        [&](size_t index) {
+          return reader_->getRecord(
+              mobile::kFlatStoragePrefix + c10::to_string(index));
+        },
+        [&]() { return readArchive(mobile::kFlatConstantsArchive); },
+        device_,
+        *mcu);
+  } else {
+    auto bvals = readArchive("bytecode").toTuple()->elements();
+    parseMethods(bvals, mcu);
+  }
 
   return mobile::Module(readArchive("data").toObject(), mcu);
 }
@@ -1,7 +1,13 @@
 #include "interpreter.h"
 #include <torch/csrc/jit/mobile/function.h>
+#include <torch/csrc/jit/mobile/memory_plan.h>
+#include <torch/csrc/jit/mobile/register_mobile_ops.h>
+#include <ATen/core/LegacyTypeDispatch.h>
+#include <ATen/core/stack.h>
 #include <ATen/core/operator_name.h>
 
+#include <chrono>
+
 namespace torch{
 namespace jit{
 char const * toString(OpCode op);
@@ -11,6 +17,34 @@ InterpreterState::InterpreterState(std::shared_ptr<Code> code) : code_(code) {
   registers_.resize(code_->register_size_);
 }
 
+namespace {
+thread_local InterpreterProfiler* current_profiler = nullptr;
+
+int64_t nowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+} // namespace
+
+InterpreterProfiler::InterpreterProfiler() : previous_(current_profiler) {
+  current_profiler = this;
+}
+
+InterpreterProfiler::~InterpreterProfiler() {
+  current_profiler = previous_;
+}
+
+InterpreterProfiler* InterpreterProfiler::current() {
+  return current_profiler;
+}
+
+void InterpreterProfiler::record(const c10::OperatorName& name, int64_t ns) {
+  auto& stats = op_stats_[name];
+  ++stats.count;
+  stats.total_ns += ns;
+}
+
 namespace {
 template <typename dtype> // int64_t, bool, double
 void listConstruct(Stack& stack, int num_inputs) {
@@ -23,9 +57,15 @@ void listConstruct(Stack& stack, int num_inputs) {
 }
 
 bool InterpreterState::run(Stack& stack) {
+  c10::optional<MemoryPlanGuard> memory_plan_guard;
+  if (code_->memory_plan_) {
+    memory_plan_guard.emplace(code_->memory_plan_);
+  }
+  const Instruction* instructions = code_->instructions().data();
+  InterpreterProfiler* profiler = InterpreterProfiler::current();
   size_t pc = 0;
   while (true) {
-    Instruction inst = code_->instructions_[pc];
+    Instruction inst = instructions[pc];
 
 //    std::cout << "RUNNING " << pc << " " << code_->instructions_[pc];
 //    if (inst.op == OP) {
@@ -42,11 +82,26 @@ bool InterpreterState::run(Stack& stack) {
 //    }
     switch (inst.op) {
       case OP: {
-        c10::Dispatcher::singleton().callBoxed(*code_->operators_[inst.X], &stack);
+#ifdef USE_STATIC_DISPATCH
+        at::AutoNonVariableTypeMode non_var_type_mode(true);
+#endif
+        if (profiler) {
+          const auto start = nowNs();
+          operatorEntry(code_->operators_[inst.X]).fn(stack);
+          profiler->record(code_->op_names_[inst.X], nowNs() - start);
+        } else {
+          operatorEntry(code_->operators_[inst.X]).fn(stack);
+        }
         ++pc;
       } break;
       case OPN: {
-        code_->vararg_operators_[inst.X](inst.N, stack);
+        if (profiler) {
+          const auto start = nowNs();
+          code_->vararg_operators_[inst.X](inst.N, stack);
+          profiler->record(code_->op_names_[inst.X], nowNs() - start);
+        } else {
+          code_->vararg_operators_[inst.X](inst.N, stack);
+        }
         ++pc;
       } break;
       case LOAD:
@@ -1,21 +1,73 @@
 #pragma once
 #include <ATen/core/ivalue.h>
 #include <ATen/core/operator_name.h>
+#include <c10/core/Allocator.h>
+#include <c10/util/ArrayRef.h>
 #include <torch/csrc/jit/instruction.h>
-#include <ATen/core/dispatch/Dispatcher.h>
+
+#include <unordered_map>
 
 namespace torch{
 namespace jit{
 namespace mobile {
 using Stack = std::vector<c10::IValue>;
 using VarargFuncton = std::function<void(int, Stack&)>;
+class MemoryPlan;
 struct Code {
+  c10::ArrayRef<Instruction> instructions() const {
+    if (flat_instructions_) {
+      return {flat_instructions_, num_flat_instructions_};
+    }
+    return instructions_;
+  }
+
   std::vector<Instruction> instructions_;
+  // Set instead of instructions_ when the instructions are used in place from
+  // a flat bytecode record (see flat_bytecode.h), which flat_record_ keeps
+  std::shared_ptr<at::DataPtr> flat_record_;
+  const Instruction* flat_instructions_ = nullptr;
+  size_t num_flat_instructions_ = 0;
   std::vector<c10::OperatorName> op_names_;
-  std::vector<c10::optional<c10::OperatorHandle>> operators_;
+  // Indices of the operators in the table of register_mobile_ops.h
+  std::vector<size_t> operators_;
+  // Indexed like op_names_, set for the operators of OPN instructions
   std::vector<VarargFuncton> vararg_operators_;
   std::vector<c10::IValue> constants_;
   size_t register_size_; // Aggregated output size.
+  // Set by Function::plan_memory
+  std::shared_ptr<const MemoryPlan> memory_plan_;
+};
+
+// Collects the number of runs and the time of each operator run by the
+// interpreters of the current thread while it's alive, to break the latency
+// of mobile models down by operator. Profilers nest, the innermost one
+// collects.
+class TORCH_API InterpreterProfiler {
+ public:
+  struct OpStats {
+    int64_t count = 0;
+    int64_t total_ns = 0;
+  };
+
+  InterpreterProfiler();
+  ~InterpreterProfiler();
+  InterpreterProfiler(const InterpreterProfiler&) = delete;
+  InterpreterProfiler& operator=(const InterpreterProfiler&) = delete;
+
+  const std::unordered_map<c10::OperatorName, OpStats>& op_stats() const {
+    return op_stats_;
+  }
+  void clear() {
+    op_stats_.clear();
+  }
+
+  // The profiler collecting on the current thread, if any
+  static InterpreterProfiler* current();
+  void record(const c10::OperatorName& name, int64_t ns);
+
+ private:
+  InterpreterProfiler* previous_;
+  std::unordered_map<c10::OperatorName, OpStats> op_stats_;
 };
 
 struct InterpreterState {
@@ -0,0 +1,361 @@
+#include <torch/csrc/jit/mobile/memory_plan.h>
+
+#include <c10/core/ArenaAllocator.h>
+#include <c10/core/CPUAllocator.h>
+#include <c10/util/Exception.h>
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <mutex>
+
+namespace torch {
+namespace jit {
+namespace mobile {
+
+// Note [Mobile memory planning]
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// The lite interpreter has no graph to analyze, so the plan comes from a
+// sample run instead: MemoryPlanRecorder installs a CPU allocator on the
+// thread (like c10::ArenaAllocatorGuard does) that numbers the allocations
+// and notes, for each of them, how many allocations had been made when it was
+// freed. Its lifetime is the range of allocations it was alive for. The ones
+// freed before the recording ends are placed in one slab, largest first, each
+// at the lowest offset not taken by a placed allocation whose lifetime
+// overlaps its own, as PlanMemory() does for graphs.
+//
+// MemoryPlanGuard then takes a slab from the plan and serves the k-th
+// allocation of the run from its offset, as long as the run allocates the
+// same sizes in the same order. The lifetimes are only known for the sample
+// run, so before serving an allocation, the guard checks that the earlier
+// ones sharing its memory are gone, and leaves it to the CPU allocator
+// otherwise. A run that allocates another size stops using the plan.
+//
+// Every tensor served from a slab holds a reference to it, and the slab only
+// goes back to the plan once all of them are gone: a tensor kept after its run
+// pins the slab and the next run takes another one. In steady state, each run
+// reuses the same slab and the planned allocations don't allocate anything.
+//
+// The allocators are thread local, so only the allocations of the thread
+// running the function are planned; intra-op worker threads aren't.
+
+namespace {
+constexpr size_t kSlabAlignment = 64;
+constexpr size_t kAlive = std::numeric_limits<size_t>::max();
+
+size_t aligned(size_t nbytes) {
+  return (nbytes + kSlabAlignment - 1) / kSlabAlignment * kSlabAlignment;
+}
+
+at::Allocator* defaultAllocator(at::Allocator* prev_allocator) {
+  return prev_allocator ? prev_allocator
+                        : c10::GetAllocator(at::DeviceType::CPU);
+}
+} // namespace
+
+struct Recording {
+  std::mutex mutex;
+  bool active = true;
+  at::Allocator* fallback;
+  std::vector<size_t> nbytes;
+  // The number of allocations made when each one was freed, or kAlive
+  std::vector<size_t> ends;
+};
+
+namespace {
+// The recordings of the recorders alive on this thread, innermost last
+thread_local std::vector<std::shared_ptr<Recording>> recordings;
+
+struct RecordedAllocation {
+  at::DataPtr data;
+  size_t index;
+  std::shared_ptr<Recording> recording;
+
+  static void release(void* ctx) {
+    auto* allocation = static_cast<RecordedAllocation*>(ctx);
+    {
+      auto& recording = *allocation->recording;
+      std::lock_guard<std::mutex> lock(recording.mutex);
+      if (recording.active) {
+        recording.ends[allocation->index] = recording.nbytes.size();
+      }
+    }
+    delete allocation;
+  }
+};
+
+struct RecordingAllocator final : at::Allocator {
+  at::DataPtr allocate(size_t nbytes) const override;
+  at::DeleterFnPtr raw_deleter() const override {
+    return nullptr;
+  }
+};
+
+// Storages keep their allocator, so it has to outlive every recording
+RecordingAllocator recording_allocator;
+
+at::DataPtr RecordingAllocator::allocate(size_t nbytes) const {
+  if (recordings.empty()) {
+    // Resizing a recorded storage after the recording
+    return c10::GetAllocator(at::DeviceType::CPU)->allocate(nbytes);
+  }
+  const auto& recording = recordings.back();
+  at::DataPtr data = recording->fallback->allocate(nbytes);
+  if (nbytes == 0) {
+    return data;
+  }
+  auto* allocation = new RecordedAllocation();
+  {
+    std::lock_guard<std::mutex> lock(recording->mutex);
+    allocation->index = recording->nbytes.size();
+    recording->nbytes.push_back(nbytes);
+    recording->ends.push_back(kAlive);
+  }
+  allocation->recording = recording;
+  void* ptr = data.get();
+  allocation->data = std::move(data);
+  return at::DataPtr(
+      ptr,
+      allocation,
+      &RecordedAllocation::release,
+      at::Device(at::DeviceType::CPU));
+}
+} // namespace
+
+MemoryPlanRecorder::MemoryPlanRecorder()
+    : recording_(std::make_shared<Recording>()),
+      prev_allocator_(c10::impl::getThreadLocalCPUAllocator()) {
+  recording_->fallback = defaultAllocator(prev_allocator_);
+  recordings.push_back(recording_);
+  c10::impl::setThreadLocalCPUAllocator(&recording_allocator);
+}
+
+MemoryPlanRecorder::~MemoryPlanRecorder() {
+  if (recording_) {
+    finish();
+  }
+}
+
+std::shared_ptr<MemoryPlan> MemoryPlanRecorder::finish() {
+  TORCH_CHECK(recording_, "The memory plan recorder was already finished");
+  TORCH_INTERNAL_ASSERT(
+      !recordings.empty() && recordings.back() == recording_);
+  recordings.pop_back();
+  c10::impl::setThreadLocalCPUAllocator(prev_allocator_);
+
+  std::vector<size_t> nbytes;
+  std::vector<size_t> ends;
+  {
+    std::lock_guard<std::mutex> lock(recording_->mutex);
+    recording_->active = false;
+    nbytes = std::move(recording_->nbytes);
+    ends = std::move(recording_->ends);
+  }
+  recording_ = nullptr;
+
+  std::vector<PlannedAllocation> allocations;
+  std::vector<size_t> order;
+  for (size_t i = 0; i < nbytes.size(); i++) {
+    allocations.push_back({nbytes[i], ends[i] != kAlive, 0, {}});
+    if (allocations.back().planned) {
+      order.push_back(i);
+    }
+  }
+  std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+    return nbytes[a] > nbytes[b];
+  });
+
+  size_t size = 0;
+  std::vector<size_t> placed;
+  for (size_t i : order) {
+    std::vector<size_t> overlapping;
+    for (size_t other : placed) {
+      if (i < ends[other] && other < ends[i]) {
+        overlapping.push_back(other);
+      }
+    }
+    std::sort(overlapping.begin(), overlapping.end(), [&](size_t a, size_t b) {
+      return allocations[a].offset < allocations[b].offset;
+    });
+    size_t offset = 0;
+    for (size_t other : overlapping) {
+      if (offset + aligned(nbytes[i]) <= allocations[other].offset) {
+        break;
+      }
+      offset =
+          std::max(offset, allocations[other].offset + aligned(nbytes[other]));
+    }
+    allocations[i].offset = offset;
+    size = std::max(size, offset + aligned(nbytes[i]));
+    placed.push_back(i);
+  }
+
+  // Allocations sharing memory have disjoint lifetimes in the sample run; the
+  // guard checks that the earlier one is gone in the others
+  for (size_t i = 0; i < allocations.size(); i++) {
+    if (!allocations[i].planned) {
+      continue;
+    }
+    const size_t begin = allocations[i].offset;
+    const size_t end = begin + nbytes[i];
+    for (size_t other = 0; other < i; other++) {
+      if (allocations[other].planned && allocations[other].offset < end &&
+          begin < allocations[other].offset + nbytes[other]) {
+        allocations[i].overlapping.push_back(other);
+      }
+    }
+  }
+  return std::make_shared<MemoryPlan>(std::move(allocations), size);
+}
+
+struct SlabSlot {
+  Slab* slab;
+  // Set while the planned allocation is served from the slab
+  std::atomic<bool> live{false};
+};
+
+struct Slab {
+  char* data = nullptr;
+  std::unique_ptr<SlabSlot[]> slots;
+  // The run that took the slab, and every allocation it served
+  std::atomic<size_t> uses{0};
+  // Set while the slab is in use
+  std::shared_ptr<SlabPool> pool;
+};
+
+// The slabs of one plan
+struct SlabPool : std::enable_shared_from_this<SlabPool> {
+  SlabPool(size_t size, size_t num_allocations)
+      : size_(size), num_allocations_(num_allocations) {}
+
+  ~SlabPool() {
+    for (Slab* slab : free_) {
+      c10::free_cpu(slab->data);
+      delete slab;
+    }
+  }
+
+  Slab* take() {
+    Slab* slab = nullptr;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (!free_.empty()) {
+        slab = free_.back();
+        free_.pop_back();
+      }
+    }
+    if (!slab) {
+      slab = new Slab();
+      slab->data = static_cast<char*>(c10::alloc_cpu(size_));
+      slab->slots.reset(new SlabSlot[num_allocations_]);
+      for (size_t i = 0; i < num_allocations_; i++) {
+        slab->slots[i].slab = slab;
+      }
+    }
+    slab->uses.store(1, std::memory_order_relaxed);
+    slab->pool = shared_from_this();
+    return slab;
+  }
+
+  static void release(Slab* slab) {
+    if (slab->uses.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+      return;
+    }
+    auto pool = std::move(slab->pool);
+    std::lock_guard<std::mutex> lock(pool->mutex_);
+    pool->free_.push_back(slab);
+  }
+
+  static void releaseSlot(void* ctx) {
+    auto* slot = static_cast<SlabSlot*>(ctx);
+    slot->live.store(false, std::memory_order_release);
+    release(slot->slab);
+  }
+
+  const size_t size_;
+  const size_t num_allocations_;
+  std::mutex mutex_;
+  std::vector<Slab*> free_;
+};
+
+MemoryPlan::MemoryPlan(std::vector<PlannedAllocation> allocations, size_t size)
+    : allocations_(std::move(allocations)),
+      size_(size),
+      pool_(std::make_shared<SlabPool>(size_, allocations_.size())) {}
+
+namespace {
+thread_local MemoryPlanGuard* current_guard = nullptr;
+
+struct PlannedAllocator final : at::Allocator {
+  at::DataPtr allocate(size_t nbytes) const override {
+    MemoryPlanGuard* guard = current_guard;
+    if (!guard) {
+      // Resizing a planned storage after its run
+      return c10::GetAllocator(at::DeviceType::CPU)->allocate(nbytes);
+    }
+    return guard->allocate(nbytes);
+  }
+  at::DeleterFnPtr raw_deleter() const override {
+    return nullptr;
+  }
+};
+
+// Storages keep their allocator, so it has to outlive every run
+PlannedAllocator planned_allocator;
+} // namespace
+
+MemoryPlanGuard::MemoryPlanGuard(std::shared_ptr<const MemoryPlan> plan)
+    : plan_(std::move(plan)),
+      slab_(plan_->size() > 0 ? plan_->pool_->take() : nullptr),
+      prev_allocator_(c10::impl::getThreadLocalCPUAllocator()),
+      prev_guard_(current_guard) {
+  if (prev_allocator_ == &planned_allocator && prev_guard_) {
+    fallback_ = prev_guard_->fallback_;
+  } else {
+    fallback_ = defaultAllocator(prev_allocator_);
+  }
+  current_guard = this;
+  c10::impl::setThreadLocalCPUAllocator(&planned_allocator);
+}
+
+MemoryPlanGuard::~MemoryPlanGuard() {
+  current_guard = prev_guard_;
+  c10::impl::setThreadLocalCPUAllocator(prev_allocator_);
+  if (slab_) {
+    SlabPool::release(slab_);
+  }
+}
+
+at::DataPtr MemoryPlanGuard::allocate(size_t nbytes) {
+  if (nbytes == 0 || diverged_ || !slab_) {
+    return fallback_->allocate(nbytes);
+  }
+  const auto& allocations = plan_->allocations();
+  if (next_ >= allocations.size() || allocations[next_].nbytes != nbytes) {
+    diverged_ = true;
+    return fallback_->allocate(nbytes);
+  }
+  const size_t index = next_++;
+  const auto& allocation = allocations[index];
+  if (!allocation.planned) {
+    return fallback_->allocate(nbytes);
+  }
+  for (size_t other : allocation.overlapping) {
+    if (slab_->slots[other].live.load(std::memory_order_acquire)) {
+      return fallback_->allocate(nbytes);
+    }
+  }
+  auto& slot = slab_->slots[index];
+  slot.live.store(true, std::memory_order_relaxed);
+  slab_->uses.fetch_add(1, std::memory_order_relaxed);
+  num_served_++;
+  return at::DataPtr(
+      slab_->data + allocation.offset,
+      &slot,
+      &SlabPool::releaseSlot,
+      at::Device(at::DeviceType::CPU));
+}
+
+} // namespace mobile
+} // namespace jit
+} // namespace torch
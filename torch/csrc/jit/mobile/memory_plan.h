@@ -0,0 +1,104 @@
+#pragma once
+#include <c10/core/Allocator.h>
+#include <torch/csrc/WindowsTorchApiMacro.h>
+
+#include <memory>
+#include <vector>
+
+namespace torch {
+namespace jit {
+namespace mobile {
+
+// A plan of the CPU allocations of a mobile function, made from a sample run:
+// every run that allocates the same sizes in the same order serves them from
+// one preallocated slab instead of the CPU allocator. See
+// Note [Mobile memory planning]
+struct PlannedAllocation {
+  size_t nbytes;
+  // False for the allocations still alive after the sample run, e.g. the
+  // outputs, which are left to the CPU allocator
+  bool planned;
+  size_t offset;
+  // The earlier allocations sharing memory with this one, which must have
+  // been freed before it is served from the slab
+  std::vector<size_t> overlapping;
+};
+
+struct SlabPool;
+
+class TORCH_API MemoryPlan {
+ public:
+  MemoryPlan(std::vector<PlannedAllocation> allocations, size_t size);
+
+  // The bytes of the slab
+  size_t size() const {
+    return size_;
+  }
+  const std::vector<PlannedAllocation>& allocations() const {
+    return allocations_;
+  }
+
+ private:
+  friend class MemoryPlanGuard;
+
+  std::vector<PlannedAllocation> allocations_;
+  size_t size_;
+  std::shared_ptr<SlabPool> pool_;
+};
+
+struct Recording;
+
+// Records the CPU allocations made on the current thread for its lifetime,
+// and plans them with finish()
+class TORCH_API MemoryPlanRecorder {
+ public:
+  MemoryPlanRecorder();
+  ~MemoryPlanRecorder();
+
+  MemoryPlanRecorder(const MemoryPlanRecorder&) = delete;
+  MemoryPlanRecorder& operator=(const MemoryPlanRecorder&) = delete;
+
+  // Stops recording. The allocations that are still alive aren't planned.
+  std::shared_ptr<MemoryPlan> finish();
+
+ private:
+  std::shared_ptr<Recording> recording_;
+  at::Allocator* prev_allocator_;
+};
+
+struct Slab;
+
+// Serves the CPU allocations made on the current thread for its lifetime from
+// a slab of plan, as long as they follow the sample run. The first allocation
+// of another size, e.g. for inputs of another shape, ends the plan for the
+// rest of the run and everything goes to the CPU allocator.
+class TORCH_API MemoryPlanGuard {
+ public:
+  explicit MemoryPlanGuard(std::shared_ptr<const MemoryPlan> plan);
+  ~MemoryPlanGuard();
+
+  MemoryPlanGuard(const MemoryPlanGuard&) = delete;
+  MemoryPlanGuard& operator=(const MemoryPlanGuard&) = delete;
+
+  at::DataPtr allocate(size_t nbytes);
+
+  // The allocations of this run served from the slab so far
+  size_t num_served() const {
+    return num_served_;
+  }
+
+ private:
+  std::shared_ptr<const MemoryPlan> plan_;
+  Slab* slab_;
+  at::Allocator* prev_allocator_;
+  MemoryPlanGuard* prev_guard_;
+  // Where the allocations that aren't planned go
+  at::Allocator* fallback_;
+  size_t next_ = 0;
+  size_t num_served_ = 0;
+  bool diverged_ = false;
+};
+
+} // namespace mobile
+} // namespace jit
+} // namespace torch
@@ -26,6 +26,16 @@ c10::IValue Module::run_method(const std::string& method_name, Stack stack) {
   return stack.front();
 }
 
+c10::IValue Module::plan_memory(
+    const std::string& method_name,
+    Stack stack) {
+  auto m = find_method(method_name);
+  TORCH_CHECK(m, "Method '", method_name, "' is not defined.");
+  stack.insert(stack.begin(), object_);
+  m->plan_memory(stack);
+  return stack.front();
+}
+
 Function* Module::find_method(const std::string& basename) const {
   for (auto& fn : cu_->methods()) {
     if (fn->name() == basename) {
@@ -27,6 +27,9 @@ class TORCH_API Module {
     return run_method("forward", std::move(inputs));
   }
   Function* find_method(const std::string& basename) const;
+  // Runs method_name on sample inputs, which the following runs are planned
+  // after, see Function::plan_memory. Returns its output.
+  c10::IValue plan_memory(const std::string& method_name, Stack stack);
  private:
   c10::intrusive_ptr<c10::ivalue::Object> object_;
   std::shared_ptr<CompilationUnit> cu_;
@@ -1,14 +1,20 @@
-#include <ATen/core/op_registration/op_registration.h>
+#include <torch/csrc/jit/mobile/register_mobile_ops.h>
+#include <torch/csrc/jit/generated/selected_mobile_ops.h>
 #include <ATen/ATen.h>
 #include <ATen/core/stack.h>
 
-using Stack = std::vector<c10::IValue>;
+#include <cstring>
+
 using torch::jit::peek;
 using torch::jit::drop;
 using torch::jit::pack;
 using torch::jit::push;
 using torch::jit::pop;
 
+namespace torch {
+namespace jit {
+namespace mobile {
+
 namespace {
 at::Tensor toOptionalTensor(const c10::IValue& v) {
   if (v.isNone()) {
@@ -17,10 +23,6 @@ at::Tensor toOptionalTensor(const c10::IValue& v) {
   return v.toTensor();
 }
 
-at::Tensor optional_to_tensor(c10::optional<at::Tensor> v) {
-  return v.has_value() ? *v : at::Tensor();
-}
-
 template <typename T>
 void listAppend(Stack& stack) {
   T el = pop(stack).to<T>();
@@ -29,452 +31,441 @@ void listAppend(Stack& stack) {
   list.push_back(std::move(el));
   push(stack, std::move(list));
 }
+
+// Null-terminated, empty unless the build selects its operators
+constexpr const char* kSelectedOps[] = {TORCH_SELECTED_MOBILE_OPS nullptr};
+
+constexpr bool matchesOperator(
+    const char* selected,
+    const char* name,
+    const char* overload_name) {
+  while (*name && *selected == *name) {
+    ++selected;
+    ++name;
+  }
+  if (*name) {
+    return false;
+  }
+  if (!*overload_name) {
+    return !*selected;
+  }
+  if (*selected++ != '.') {
+    return false;
+  }
+  while (*overload_name && *selected == *overload_name) {
+    ++selected;
+    ++overload_name;
+  }
+  return !*overload_name && !*selected;
+}
+
+constexpr bool isSelected(const char* name, const char* overload_name) {
+  if (!TORCH_MOBILE_SELECTIVE_BUILD) {
+    return true;
+  }
+  for (size_t i = 0; kSelectedOps[i]; ++i) {
+    if (matchesOperator(kSelectedOps[i], name, overload_name)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Placeholder for the operators that are run as OPN instructions, which only
+// need an entry in the table
+void noop(Stack& stack) {}
+
+void add_Tensor(Stack& stack) {
+  auto result_ = at::add(
+      (std::move(peek(stack, 0, 3))).toTensor(),
+      (std::move(peek(stack, 1, 3))).toTensor(),
+      (std::move(peek(stack, 2, 3))).toScalar());
+  drop(stack, 3);
+  pack(stack, std::move(result_));
+}
+
+void add_Scalar(Stack& stack) {
+  auto result_ = at::add(
+      (std::move(peek(stack, 0, 3))).toTensor(),
+      (std::move(peek(stack, 1, 3))).toScalar(),
+      (std::move(peek(stack, 2, 3))).toScalar());
+  drop(stack, 3);
+  pack(stack, std::move(result_));
+}
+
+void adaptive_avg_pool2d(Stack& stack) {
+  auto result_ = at::adaptive_avg_pool2d(
+      (std::move(peek(stack, 0, 2))).toTensor(),
+      (std::move(peek(stack, 1, 2))).toIntListRef());
+  drop(stack, 2);
+  pack(stack, std::move(result_));
+}
+
+void mm(Stack& stack) {
+  auto result_ = at::mm(
+      (std::move(peek(stack, 0, 2))).toTensor(),
+      (std::move(peek(stack, 1, 2))).toTensor());
+  drop(stack, 2);
+  pack(stack, std::move(result_));
 }
 
-static auto registry0 = torch::RegisterOperators().op(
-  "_aten::add.Tensor",
-  torch::RegisterOperators::options().kernel(c10::TensorTypeId::CPUTensorId,
-  [](at::Tensor a, at::Tensor b, at::Scalar c) -> at::Tensor {
-    return at::add(a, b, c);
-  })
-).op(
-  "_aten::add.Scalar",
-  torch::RegisterOperators::options().kernel(c10::TensorTypeId::CPUTensorId,
-  [](at::Tensor a, at::Scalar b, at::Scalar c) -> at::Tensor {
-    return at::add(a, b, c);
-  })
-).op(
-  "_aten::add_.Tensor",
-  torch::RegisterOperators::options().kernel(c10::TensorTypeId::CPUTensorId,
-                                           [](at::Tensor a, at::Tensor b, at::Scalar c) -> at::Tensor {
-                                             return at::add(a, b, c);
-                                           })
-).op(
-  "_aten::adaptive_avg_pool2d(Tensor self, int[2] output_size) -> Tensor",
-  torch::RegisterOperators::options().kernel(c10::TensorTypeId::CPUTensorId,
-  [](c10::OperatorKernel* kernel, Stack* stack) {
-  #ifdef USE_STATIC_DISPATCH
-   at::AutoNonVariableTypeMode non_var_type_mode(true);
-  #endif
-   auto result_ = at::adaptive_avg_pool2d(
-       (std::move(peek(*stack, 0, 2))).toTensor(),
-       (std::move(peek(*stack, 1, 2))).toIntListRef()
-       );
-   drop(*stack, 2);
-   pack(*stack, std::move(result_));
-  })
-).op(
-  "_aten::mm",
-  torch::RegisterOperators::options().kernel(c10::TensorTypeId::CPUTensorId,
-  [](at::Tensor a, at::Tensor b) -> at::Tensor {
-    return at::mm(a, b);
-  })
-).op(
-  "_aten::_convolution(Tensor input, Tensor weight, Tensor? bias, int[] stride, int[] padding, int[] dilation, bool transposed, int[] output_padding, int groups, bool benchmark, bool deterministic, bool cudnn_enabled) -> Tensor",
-  torch::RegisterOperators::options().kernel(c10::TensorTypeId::CPUTensorId,
-  [](c10::OperatorKernel* kernel, Stack* stack) {
-#ifdef USE_STATIC_DISPATCH
-     at::AutoNonVariableTypeMode non_var_type_mode(true);
-#endif
-     auto result_ = at::_convolution(
-         (std::move(peek(*stack, 0, 12))).toTensor(),
-         (std::move(peek(*stack, 1, 12))).toTensor(),
-         toOptionalTensor((std::move(peek(*stack, 2, 12)))),
-         (std::move(peek(*stack, 3, 12))).toIntListRef(),
-         (std::move(peek(*stack, 4, 12))).toIntListRef(),
-         (std::move(peek(*stack, 5, 12))).toIntListRef(),
-         (std::move(peek(*stack, 6, 12))).toBool(),
-         (std::move(peek(*stack, 7, 12))).toIntListRef(),
-         (std::move(peek(*stack, 8, 12))).toInt(),
-         (std::move(peek(*stack, 9, 12))).toBool(),
-         (std::move(peek(*stack, 10, 12))).toBool(),
-         (std::move(peek(*stack, 11, 12))).toBool()
-         );
-     drop(*stack, 12);
-     pack(*stack, std::move(result_));
-   })
-).op(
-  "_aten::conv2d(Tensor input, Tensor weight, Tensor? bias=None, int[2] stride=1, int[2] padding=0, int[2] dilation=1, int groups=1) -> Tensor",
-  torch::RegisterOperators::options().kernel(c10::TensorTypeId::CPUTensorId,
-  [](c10::OperatorKernel* kernel, Stack* stack) {
-#ifdef USE_STATIC_DISPATCH
-     at::AutoNonVariableTypeMode non_var_type_mode(true);
-#endif
-     auto result_ = at::conv2d(
-         (std::move(peek(*stack, 0, 7))).toTensor(),
-         (std::move(peek(*stack, 1, 7))).toTensor(),
-         toOptionalTensor((std::move(peek(*stack, 2, 7)))),
-         (std::move(peek(*stack, 3, 7))).toIntListRef(),
-         (std::move(peek(*stack, 4, 7))).toIntListRef(),
-         (std::move(peek(*stack, 5, 7))).toIntListRef(),
-         (std::move(peek(*stack, 6, 7))).toInt()
-         );
-     drop(*stack, 7);
-     pack(*stack, std::move(result_));
-  })
-).op(
-  "_aten::batch_norm",
-  torch::RegisterOperators::options().kernel(c10::TensorTypeId::CPUTensorId,
-  [] (at::Tensor input, c10::optional<at::Tensor> weight, c10::optional<at::Tensor> bias,
-    c10::optional<at::Tensor> running_mean, c10::optional<at::Tensor> running_var,
-    bool training, double momentum, double eps, bool cudnn_enabled) {
-   return at::batch_norm(input, optional_to_tensor(weight), optional_to_tensor(bias),
-                         optional_to_tensor(running_mean), optional_to_tensor(running_var),
-                         training, momentum, eps, cudnn_enabled);
-  })
-).op(
-  "_aten::max_pool2d_with_indices(Tensor self, int[2] kernel_size, int[2] stride=[], int[2] padding=0, int[2] dilation=1, bool ceil_mode=False) -> (Tensor, Tensor)",
-  torch::RegisterOperators::options().kernel(c10::TensorTypeId::CPUTensorId,
-  [](c10::OperatorKernel* kernel, Stack* stack) {
-  #ifdef USE_STATIC_DISPATCH
-     at::AutoNonVariableTypeMode non_var_type_mode(true);
-  #endif
-     auto result_ = at::max_pool2d_with_indices(
-         (std::move(peek(*stack, 0, 6))).toTensor(),
-         (std::move(peek(*stack, 1, 6))).toIntListRef(),
-         (std::move(peek(*stack, 2, 6))).toIntListRef(),
-         (std::move(peek(*stack, 3, 6))).toIntListRef(),
-         (std::move(peek(*stack, 4, 6))).toIntListRef(),
-         (std::move(peek(*stack, 5, 6))).toBool()
-         );
-     drop(*stack, 6);
-     pack(*stack, std::move(result_));
-  })
-).op(
-  "_aten::max_pool2d(Tensor self, int[2] kernel_size, int[2] stride=[], int[2] padding=0, int[2] dilation=1, bool ceil_mode=False) -> Tensor",
-  torch::RegisterOperators::options().kernel(c10::TensorTypeId::CPUTensorId,
-  [](c10::OperatorKernel* kernel, Stack* stack) {
-#ifdef USE_STATIC_DISPATCH
-   at::AutoNonVariableTypeMode non_var_type_mode(true);
-#endif
-   auto result_ = at::max_pool2d(
-       (std::move(peek(*stack, 0, 6))).toTensor(),
-       (std::move(peek(*stack, 1, 6))).toIntListRef(),
-       (std::move(peek(*stack, 2, 6))).toIntListRef(),
-       (std::move(peek(*stack, 3, 6))).toIntListRef(),
-       (std::move(peek(*stack, 4, 6))).toIntListRef(),
-       (std::move(peek(*stack, 5, 6))).toBool()
-       );
-   drop(*stack, 6);
-   pack(*stack, std::move(result_));
-  })
-).op(
-  "_aten::threshold",
-  torch::RegisterOperators::options().kernel(c10::TensorTypeId::CPUTensorId,
-  [](at::Tensor self, at::Scalar threshold, at::Scalar value) {
-   return at::threshold_(self, threshold, value);
-  })
-).op(
-  "_aten::relu(Tensor self) -> Tensor",
-  torch::RegisterOperators::options().kernel(c10::TensorTypeId::CPUTensorId,
-  [](c10::OperatorKernel* kernel, Stack* stack) {
-
-  #ifdef USE_STATIC_DISPATCH
-  at::AutoNonVariableTypeMode non_var_type_mode(true);
-  #endif
-  auto result_ = at::relu(
-  (std::move(peek(*stack, 0, 1))).toTensor()
-  );
-  drop(*stack, 1);
-  pack(*stack, std::move(result_));
-})
-).op(
-  "_aten::relu_",
-  torch::RegisterOperators::options().kernel(c10::TensorTypeId::CPUTensorId,
-  [](at::Tensor a) -> at::Tensor {
-    return at::relu_(a);
-  })
-).op(
-  "_aten::t(Tensor(a) self) -> Tensor(a)",
-  torch::RegisterOperators::options().kernel(c10::TensorTypeId::CPUTensorId,
-  [](c10::OperatorKernel* kernel, Stack* stack) {
-
-  #ifdef USE_STATIC_DISPATCH
-  at::AutoNonVariableTypeMode non_var_type_mode(true);
-  #endif
-  auto result_ = at::t(
-  (std::move(peek(*stack, 0, 1))).toTensor()
-  );
-  drop(*stack, 1);
-  pack(*stack, std::move(result_));
-  }).aliasAnalysis(c10::AliasAnalysisKind::FROM_SCHEMA)
-).op(
-  "_aten::size.int",
-  torch::RegisterOperators::options().kernel(c10::TensorTypeId::CPUTensorId,
-  [](at::Tensor a, int64_t dim) -> int64_t {
-   return at::size(a, dim);
-  })
-).op(
-  "_aten::addmm(Tensor self, Tensor mat1, Tensor mat2, *, Scalar beta=1, Scalar alpha=1) -> Tensor",
-  torch::RegisterOperators::options().kernel(c10::TensorTypeId::CPUTensorId,
-  [](c10::OperatorKernel* kernel, Stack* stack) {
-
-  #ifdef USE_STATIC_DISPATCH
-  at::AutoNonVariableTypeMode non_var_type_mode(true);
-  #endif
-  constexpr size_t nvar = 5;
+void _convolution(Stack& stack) {
+  auto result_ = at::_convolution(
+      (std::move(peek(stack, 0, 12))).toTensor(),
+      (std::move(peek(stack, 1, 12))).toTensor(),
+      toOptionalTensor((std::move(peek(stack, 2, 12)))),
+      (std::move(peek(stack, 3, 12))).toIntListRef(),
+      (std::move(peek(stack, 4, 12))).toIntListRef(),
+      (std::move(peek(stack, 5, 12))).toIntListRef(),
+      (std::move(peek(stack, 6, 12))).toBool(),
+      (std::move(peek(stack, 7, 12))).toIntListRef(),
+      (std::move(peek(stack, 8, 12))).toInt(),
+      (std::move(peek(stack, 9, 12))).toBool(),
+      (std::move(peek(stack, 10, 12))).toBool(),
+      (std::move(peek(stack, 11, 12))).toBool());
+  drop(stack, 12);
+  pack(stack, std::move(result_));
+}
+
+void conv2d(Stack& stack) {
+  auto result_ = at::conv2d(
+      (std::move(peek(stack, 0, 7))).toTensor(),
+      (std::move(peek(stack, 1, 7))).toTensor(),
+      toOptionalTensor((std::move(peek(stack, 2, 7)))),
+      (std::move(peek(stack, 3, 7))).toIntListRef(),
+      (std::move(peek(stack, 4, 7))).toIntListRef(),
+      (std::move(peek(stack, 5, 7))).toIntListRef(),
+      (std::move(peek(stack, 6, 7))).toInt());
+  drop(stack, 7);
+  pack(stack, std::move(result_));
+}
+
+void batch_norm(Stack& stack) {
+  auto result_ = at::batch_norm(
+      (std::move(peek(stack, 0, 9))).toTensor(),
+      toOptionalTensor((std::move(peek(stack, 1, 9)))),
+      toOptionalTensor((std::move(peek(stack, 2, 9)))),
+      toOptionalTensor((std::move(peek(stack, 3, 9)))),
+      toOptionalTensor((std::move(peek(stack, 4, 9)))),
+      (std::move(peek(stack, 5, 9))).toBool(),
+      (std::move(peek(stack, 6, 9))).toDouble(),
+      (std::move(peek(stack, 7, 9))).toDouble(),
+      (std::move(peek(stack, 8, 9))).toBool());
+  drop(stack, 9);
+  pack(stack, std::move(result_));
+}
+
+void max_pool2d_with_indices(Stack& stack) {
+  auto result_ = at::max_pool2d_with_indices(
+      (std::move(peek(stack, 0, 6))).toTensor(),
+      (std::move(peek(stack, 1, 6))).toIntListRef(),
+      (std::move(peek(stack, 2, 6))).toIntListRef(),
+      (std::move(peek(stack, 3, 6))).toIntListRef(),
+      (std::move(peek(stack, 4, 6))).toIntListRef(),
+      (std::move(peek(stack, 5, 6))).toBool());
+  drop(stack, 6);
+  pack(stack, std::move(result_));
+}
+
+void max_pool2d(Stack& stack) {
+  auto result_ = at::max_pool2d(
+      (std::move(peek(stack, 0, 6))).toTensor(),
+      (std::move(peek(stack, 1, 6))).toIntListRef(),
+      (std::move(peek(stack, 2, 6))).toIntListRef(),
+      (std::move(peek(stack, 3, 6))).toIntListRef(),
+      (std::move(peek(stack, 4, 6))).toIntListRef(),
+      (std::move(peek(stack, 5, 6))).toBool());
+  drop(stack, 6);
+  pack(stack, std::move(result_));
+}
+
+void threshold(Stack& stack) {
+  auto self = (std::move(peek(stack, 0, 3))).toTensor();
+  auto result_ = at::threshold_(
+      self,
+      (std::move(peek(stack, 1, 3))).toScalar(),
+      (std::move(peek(stack, 2, 3))).toScalar());
+  drop(stack, 3);
+  pack(stack, std::move(result_));
+}
+
+void relu(Stack& stack) {
+  auto result_ = at::relu((std::move(peek(stack, 0, 1))).toTensor());
+  drop(stack, 1);
+  pack(stack, std::move(result_));
+}
+
+void relu_(Stack& stack) {
+  auto self = (std::move(peek(stack, 0, 1))).toTensor();
+  auto result_ = at::relu_(self);
+  drop(stack, 1);
+  pack(stack, std::move(result_));
+}
+
+void t(Stack& stack) {
+  auto result_ = at::t((std::move(peek(stack, 0, 1))).toTensor());
+  drop(stack, 1);
+  pack(stack, std::move(result_));
+}
+
+void size_int(Stack& stack) {
+  auto result_ = at::size(
+      (std::move(peek(stack, 0, 2))).toTensor(),
+      (std::move(peek(stack, 1, 2))).toInt());
+  drop(stack, 2);
+  pack(stack, result_);
+}
+
+void addmm(Stack& stack) {
   auto result_ = at::addmm(
-  (std::move(peek(*stack, 0, nvar))).toTensor(),
-  (std::move(peek(*stack, 1, nvar))).toTensor(),
-  (std::move(peek(*stack, 2, nvar))).toTensor(),
-  (std::move(peek(*stack, 3, nvar))).toScalar(),
-  (std::move(peek(*stack, 4, nvar))).toScalar()
-  );
-  drop(*stack, 5);
-  pack(*stack, std::move(result_));
-  })
-).op(
-  "_aten::view(Tensor(a) self, int[] size) -> Tensor(a)",
-  torch::RegisterOperators::options().kernel(c10::TensorTypeId::CPUTensorId,
-  [](c10::OperatorKernel* kernel, Stack* stack) {
-#ifdef USE_STATIC_DISPATCH
-   at::AutoNonVariableTypeMode non_var_type_mode(true);
-#endif
-   auto result_ = ((std::move(peek(*stack, 0, 2))).toTensor()).view(
-       (std::move(peek(*stack, 1, 2))).toIntListRef()
-       );
-   drop(*stack, 2);
-   pack(*stack, std::move(result_));
-  }).aliasAnalysis(c10::AliasAnalysisKind::FROM_SCHEMA)
-).op(
-  "_aten::dim",
-  torch::RegisterOperators::options().kernel(c10::TensorTypeId::CPUTensorId,
-  [](at::Tensor a) -> int64_t {
-   return a.dim();
-  })
-).op(
-  "_aten::eq",
-  torch::RegisterOperators::options().catchAllKernel(
-    [](int64_t a, int64_t b) -> bool {
-      return a == b;
-    })
-).op(
-  "_aten::log_softmax",
-  torch::RegisterOperators::options().kernel(c10::TensorTypeId::CPUTensorId,
-  [](at::Tensor a, int64_t b, c10::optional<int64_t> c) -> at::Tensor {
-    if (c.has_value()) {
-     return at::log_softmax(a, b, static_cast<c10::ScalarType>(c.value()));
-    } else {
-     return at::log_softmax(a, b);
+      (std::move(peek(stack, 0, 5))).toTensor(),
+      (std::move(peek(stack, 1, 5))).toTensor(),
+      (std::move(peek(stack, 2, 5))).toTensor(),
+      (std::move(peek(stack, 3, 5))).toScalar(),
+      (std::move(peek(stack, 4, 5))).toScalar());
+  drop(stack, 5);
+  pack(stack, std::move(result_));
+}
+
+void view(Stack& stack) {
+  auto result_ = ((std::move(peek(stack, 0, 2))).toTensor())
+                     .view((std::move(peek(stack, 1, 2))).toIntListRef());
+  drop(stack, 2);
+  pack(stack, std::move(result_));
+}
+
+void dim(Stack& stack) {
+  int64_t result_ = pop(stack).toTensor().dim();
+  push(stack, result_);
+}
+
+void eq(Stack& stack) {
+  int64_t a, b;
+  pop(stack, a, b);
+  push(stack, a == b);
+}
+
+void log_softmax(Stack& stack) {
+  auto dtype = (std::move(peek(stack, 2, 3))).toOptional<int64_t>();
+  at::Tensor result_;
+  if (dtype.has_value()) {
+    result_ = at::log_softmax(
+        (std::move(peek(stack, 0, 3))).toTensor(),
+        (std::move(peek(stack, 1, 3))).toInt(),
+        static_cast<c10::ScalarType>(dtype.value()));
+  } else {
+    result_ = at::log_softmax(
+        (std::move(peek(stack, 0, 3))).toTensor(),
+        (std::move(peek(stack, 1, 3))).toInt());
+  }
+  drop(stack, 3);
+  pack(stack, std::move(result_));
+}
+
+void flatten_using_ints(Stack& stack) {
+  auto result_ = at::flatten(
+      (std::move(peek(stack, 0, 3))).toTensor(),
+      (std::move(peek(stack, 1, 3))).toInt(),
+      (std::move(peek(stack, 2, 3))).toInt());
+  drop(stack, 3);
+  pack(stack, std::move(result_));
+}
+
+void Int(Stack& stack) {
+  int64_t result_ = pop(stack).toTensor().item<int64_t>();
+  push(stack, result_);
+}
+
+void NumToTensor(Stack& stack) {
+  auto result_ = at::scalar_to_tensor(pop(stack).toScalar());
+  push(stack, std::move(result_));
+}
+
+void embedding(Stack& stack) {
+  constexpr int N = 5;
+  auto result_ = at::embedding(
+      (std::move(peek(stack, 0, N))).toTensor(),
+      (std::move(peek(stack, 1, N))).toTensor(),
+      (std::move(peek(stack, 2, N))).toInt(),
+      (std::move(peek(stack, 3, N))).toBool(),
+      (std::move(peek(stack, 4, N))).toBool());
+  drop(stack, N);
+  pack(stack, std::move(result_));
+}
+
+void dropout(Stack& stack) {
+  auto result_ = at::dropout(
+      (std::move(peek(stack, 0, 3))).toTensor(),
+      (std::move(peek(stack, 1, 3))).toDouble(),
+      (std::move(peek(stack, 2, 3))).toBool());
+  drop(stack, 3);
+  pack(stack, std::move(result_));
+}
+
+void permute(Stack& stack) {
+  auto result_ = ((std::move(peek(stack, 0, 2))).toTensor())
+                     .permute((std::move(peek(stack, 1, 2))).toIntListRef());
+  drop(stack, 2);
+  pack(stack, std::move(result_));
+}
+
+void matmul(Stack& stack) {
+  auto result_ = at::matmul(
+      (std::move(peek(stack, 0, 2))).toTensor(),
+      (std::move(peek(stack, 1, 2))).toTensor());
+  drop(stack, 2);
+  pack(stack, std::move(result_));
+}
+
+void mul_Tensor(Stack& stack) {
+  auto result_ = at::mul(
+      (std::move(peek(stack, 0, 2))).toTensor(),
+      (std::move(peek(stack, 1, 2))).toTensor());
+  drop(stack, 2);
+  pack(stack, std::move(result_));
+}
+
+void tanh(Stack& stack) {
+  auto result_ = at::tanh((std::move(peek(stack, 0, 1))).toTensor());
+  drop(stack, 1);
+  pack(stack, std::move(result_));
+}
+
+void max_dim(Stack& stack) {
+  auto result_ = at::max(
+      (std::move(peek(stack, 0, 3))).toTensor(),
+      (std::move(peek(stack, 1, 3))).toInt(),
+      (std::move(peek(stack, 2, 3))).toBool());
+  drop(stack, 3);
+  pack(stack, std::move(result_));
+}
+
+void cat(Stack& stack) {
+  auto result_ = at::cat(
+      (std::move(peek(stack, 0, 2))).toTensorListRef(),
+      (std::move(peek(stack, 1, 2))).toInt());
+  drop(stack, 2);
+  pack(stack, std::move(result_));
+}
+
+void __is__(Stack& stack) {
+  c10::IValue self, obj;
+  pop(stack, self, obj);
+  push(stack, self.isSameIdentity(obj));
+}
+
+void log_softmax_int(Stack& stack) {
+  auto result_ = at::log_softmax(
+      (std::move(peek(stack, 0, 3))).toTensor(),
+      (std::move(peek(stack, 1, 3))).toInt(),
+      (std::move(peek(stack, 2, 3))).toOptional<c10::ScalarType>());
+  drop(stack, 3);
+  pack(stack, std::move(result_));
+}
+
+void softmax_int(Stack& stack) {
+  auto result_ = at::softmax(
+      (std::move(peek(stack, 0, 3))).toTensor(),
+      (std::move(peek(stack, 1, 3))).toInt(),
+      (std::move(peek(stack, 2, 3))).toOptional<c10::ScalarType>());
+  drop(stack, 3);
+  pack(stack, std::move(result_));
+}
+
+void warn(Stack& stack) {
+  drop(stack, 1);
+  pop(stack);
+}
+
+void append_Tensor(Stack& stack) {
+  listAppend<at::Tensor>(stack);
+}
+
+void append_int(Stack& stack) {
+  listAppend<int64_t>(stack);
+}
+
+// Operators left out of a selective build keep their entry and index, but not
+// their kernel
+#define MOBILE_OP(name, overload_name, fn) \
+  { name, overload_name, isSelected(name, overload_name) ? fn : nullptr }
+// The placeholders are always included
+#define MOBILE_VARARG_OP(name, overload_name) \
+  { name, overload_name, noop }
+
+constexpr OperatorEntry kOperators[] = {
+    MOBILE_OP("aten::add", "Tensor", add_Tensor),
+    MOBILE_OP("aten::add", "Scalar", add_Scalar),
+    // NB: add_ runs out of place
+    MOBILE_OP("aten::add_", "Tensor", add_Tensor),
+    MOBILE_OP("aten::adaptive_avg_pool2d", "", adaptive_avg_pool2d),
+    MOBILE_OP("aten::mm", "", mm),
+    MOBILE_OP("aten::_convolution", "", _convolution),
+    MOBILE_OP("aten::conv2d", "", conv2d),
+    MOBILE_OP("aten::batch_norm", "", batch_norm),
+    MOBILE_OP("aten::max_pool2d_with_indices", "", max_pool2d_with_indices),
+    MOBILE_OP("aten::max_pool2d", "", max_pool2d),
+    MOBILE_OP("aten::threshold", "", threshold),
+    MOBILE_OP("aten::relu", "", relu),
+    MOBILE_OP("aten::relu_", "", relu_),
+    MOBILE_OP("aten::t", "", t),
+    MOBILE_OP("aten::size", "int", size_int),
+    MOBILE_OP("aten::addmm", "", addmm),
+    MOBILE_OP("aten::view", "", view),
+    MOBILE_OP("aten::dim", "", dim),
+    MOBILE_OP("aten::eq", "", eq),
+    MOBILE_OP("aten::log_softmax", "", log_softmax),
+    MOBILE_OP("aten::flatten", "using_ints", flatten_using_ints),
+    MOBILE_OP("aten::Int", "", Int),
+    MOBILE_OP("prim::NumToTensor", "", NumToTensor),
+    MOBILE_VARARG_OP("prim::ListConstruct", "int"),
+    MOBILE_VARARG_OP("prim::ListConstruct", "float"),
+    MOBILE_VARARG_OP("prim::ListConstruct", "bool"),
+    MOBILE_VARARG_OP("prim::ListConstruct", "Tensor"),
+    MOBILE_VARARG_OP("prim::ListConstruct", "generic"),
+    // Pytext operators
+    MOBILE_OP("aten::embedding", "", embedding),
+    MOBILE_OP("aten::dropout", "", dropout),
+    MOBILE_OP("aten::permute", "", permute),
+    MOBILE_OP("aten::matmul", "", matmul),
+    MOBILE_OP("aten::mul", "Tensor", mul_Tensor),
+    MOBILE_OP("aten::tanh", "", tanh),
+    MOBILE_OP("aten::max", "dim", max_dim),
+    MOBILE_OP("aten::cat", "", cat),
+    MOBILE_OP("aten::__is__", "", __is__),
+    MOBILE_OP("aten::log_softmax", "int", log_softmax_int),
+    MOBILE_OP("aten::softmax", "int", softmax_int),
+    MOBILE_OP("aten::warn", "", warn),
+    MOBILE_VARARG_OP("prim::unchecked_cast", ""),
+    MOBILE_VARARG_OP("prim::TupleConstruct", ""),
+    MOBILE_VARARG_OP("prim::TupleUnpack", ""),
+    MOBILE_VARARG_OP("aten::format", ""),
+    MOBILE_OP("aten::append", "Tensor", append_Tensor),
+    MOBILE_OP("aten::append", "int", append_int),
+};
+
+#undef MOBILE_OP
+#undef MOBILE_VARARG_OP
+
+constexpr size_t kNumOperators = sizeof(kOperators) / sizeof(kOperators[0]);
+} // namespace
+
+const OperatorEntry& operatorEntry(size_t index) {
+  TORCH_INTERNAL_ASSERT(index < kNumOperators);
+  return kOperators[index];
+}
+
+c10::optional<size_t> findOperator(const c10::OperatorName& opname) {
+  for (size_t i = 0; i < kNumOperators; ++i) {
+    const auto& entry = kOperators[i];
+    if (entry.fn && opname.name == entry.name &&
+        opname.overload_name == entry.overload_name) {
+      return i;
     }
-  })
-).op(
-  "_aten::flatten.using_ints(Tensor self, int start_dim=0, int end_dim=-1) -> Tensor",
-  torch::RegisterOperators::options().kernel(c10::TensorTypeId::CPUTensorId,
-  [](c10::OperatorKernel* kernel, Stack* stack) {
-  #ifdef USE_STATIC_DISPATCH
-     at::AutoNonVariableTypeMode non_var_type_mode(true);
-  #endif
-     auto result_ = at::flatten(
-         (std::move(peek(*stack, 0, 3))).toTensor(),
-         (std::move(peek(*stack, 1, 3))).toInt(),
-         (std::move(peek(*stack, 2, 3))).toInt()
-     );
-     drop(*stack, 3);
-     pack(*stack, std::move(result_));
-  })
-).op(
-  "_aten::Int",
-  torch::RegisterOperators::options().kernel(c10::TensorTypeId::CPUTensorId,
-                                           [](at::Tensor a) -> int64_t {
-                                             return a.item<int64_t>();
-  })
-).op(
-  "_prim::NumToTensor",
-  torch::RegisterOperators::options().catchAllKernel(
-  [](at::Scalar s) -> at::Tensor {
-      return at::scalar_to_tensor(s);
-  })
-).op(
-  // Dummy operator that does nothing. Used to reserve a location of an operator table.
-  "_prim::ListConstruct.int",
-  torch::RegisterOperators::options().catchAllKernel(
-  []() {
-  })
-).op(
-  "_prim::ListConstruct.float",
-  torch::RegisterOperators::options().catchAllKernel(
-  []() {
-  })
-).op(
-  "_prim::ListConstruct.bool",
-  torch::RegisterOperators::options().catchAllKernel(
-  []() {
-  })
-).op(
-  "_prim::ListConstruct.Tensor",
-  torch::RegisterOperators::options().catchAllKernel(
-  []() {
-  })
-).op(
-  "_prim::ListConstruct.generic",
-  torch::RegisterOperators::options().catchAllKernel(
-  []() {
-  })
-
-// Pytext operators
-).op(
-  "_aten::embedding(Tensor weight, Tensor indices, int padding_idx=-1, bool scale_grad_by_freq=False, bool sparse=False) -> Tensor",
-  torch::RegisterOperators::options().kernel(c10::TensorTypeId::CPUTensorId,
-  [](c10::OperatorKernel* kernel, Stack* stack) {
-     constexpr int N = 5;
-     auto result_ = at::embedding(
-         (std::move(peek(*stack, 0, N))).toTensor(),
-         (std::move(peek(*stack, 1, N))).toTensor(),
-         (std::move(peek(*stack, 2, N))).toInt(),
-         (std::move(peek(*stack, 3, N))).toBool(),
-         (std::move(peek(*stack, 4, N))).toBool()
-     );
-     drop(*stack, N);
-     pack(*stack, std::move(result_));
-  })
-).op(
-  "_aten::dropout(Tensor input, float p, bool train) -> Tensor",
-  torch::RegisterOperators::options().kernel(c10::TensorTypeId::CPUTensorId,
-  [](c10::OperatorKernel* kernel, Stack* stack) {
-     auto result_ = at::dropout(
-         (std::move(peek(*stack, 0, 3))).toTensor(),
-         (std::move(peek(*stack, 1, 3))).toDouble(),
-         (std::move(peek(*stack, 2, 3))).toBool()
-     );
-     drop(*stack, 3);
-     pack(*stack, std::move(result_));
-  })
-).op(
-  "_aten::permute(Tensor(a) self, int[] dims) -> Tensor(a)",
-  torch::RegisterOperators::options().kernel(c10::TensorTypeId::CPUTensorId,
-  [](c10::OperatorKernel* kernel, Stack* stack) {
-     auto result_ = ((std::move(peek(*stack, 0, 2))).toTensor()).permute(
-         (std::move(peek(*stack, 1, 2))).toIntListRef()
-     );
-     drop(*stack, 2);
-     pack(*stack, std::move(result_));
-  }).aliasAnalysis(c10::AliasAnalysisKind::FROM_SCHEMA)
-).op(
-  "_aten::matmul(Tensor self, Tensor other) -> Tensor",
-  torch::RegisterOperators::options().kernel(c10::TensorTypeId::CPUTensorId,
-  [](c10::OperatorKernel* kernel, Stack* stack) {
-     auto result_ = at::matmul(
-         (std::move(peek(*stack, 0, 2))).toTensor(),
-         (std::move(peek(*stack, 1, 2))).toTensor()
-     );
-     drop(*stack, 2);
-     pack(*stack, std::move(result_));
-  })
-).op(
-  "_aten::mul.Tensor(Tensor self, Tensor other) -> Tensor",
-  torch::RegisterOperators::options().kernel(c10::TensorTypeId::CPUTensorId,
-  [](c10::OperatorKernel* kernel, Stack* stack) {
-     auto result_ = at::mul(
-         (std::move(peek(*stack, 0, 2))).toTensor(),
-         (std::move(peek(*stack, 1, 2))).toTensor()
-     );
-     drop(*stack, 2);
-     pack(*stack, std::move(result_));
-  })
-).op(
-  "_aten::tanh(Tensor self) -> Tensor",
-  torch::RegisterOperators::options().kernel(c10::TensorTypeId::CPUTensorId,
-  [](c10::OperatorKernel* kernel, Stack* stack) {
-     auto result_ = at::tanh(
-         (std::move(peek(*stack, 0, 1))).toTensor()
-     );
-     drop(*stack, 1);
-     pack(*stack, std::move(result_));
-  })
-).op(
-  "_aten::max.dim(Tensor self, int dim, bool keepdim=False) -> (Tensor values, Tensor indices)",
-  torch::RegisterOperators::options().kernel(c10::TensorTypeId::CPUTensorId,
-  [](c10::OperatorKernel* kernel, Stack* stack) {
-     auto result_ = at::max(
-         (std::move(peek(*stack, 0, 3))).toTensor(),
-         (std::move(peek(*stack, 1, 3))).toInt(),
-         (std::move(peek(*stack, 2, 3))).toBool()
-     );
-     drop(*stack, 3);
-     pack(*stack, std::move(result_));
-  })
-).op(
-  "_aten::cat(Tensor[] tensors, int dim=0) -> Tensor",
-  torch::RegisterOperators::options().kernel(c10::TensorTypeId::CPUTensorId,
-  [](c10::OperatorKernel* kernel, Stack* stack) {
-     auto result_ = at::cat(
-         (std::move(peek(*stack, 0, 2))).toTensorListRef(),
-         (std::move(peek(*stack, 1, 2))).toInt()
-     );
-     drop(*stack, 2);
-     pack(*stack, std::move(result_));
-  })
-).op(
-  "_aten::__is__(t1 self, t2 obj) -> bool",
-  torch::RegisterOperators::options().catchAllKernel(
-  [](c10::OperatorKernel* kernel, Stack* stack) {
-      c10::IValue self, obj;
-      pop(*stack, self, obj);
-      push(*stack, self.isSameIdentity(obj));
-  })
-).op(
-  "_aten::log_softmax.int(Tensor self, int dim, ScalarType? dtype=None) -> Tensor",
-  torch::RegisterOperators::options().kernel(c10::TensorTypeId::CPUTensorId,
-  [](c10::OperatorKernel* kernel, Stack* stack) {
-     auto result_ = at::log_softmax(
-       (std::move(peek(*stack, 0, 3))).toTensor(),
-       (std::move(peek(*stack, 1, 3))).toInt(),
-       (std::move(peek(*stack, 2, 3))).toOptional<c10::ScalarType>()
-     );
-     drop(*stack, 3);
-     pack(*stack, std::move(result_));
-  })
-).op(
-  "_aten::softmax.int(Tensor self, int dim, ScalarType? dtype=None) -> Tensor",
-  torch::RegisterOperators::options().kernel(c10::TensorTypeId::CPUTensorId,
-  [](c10::OperatorKernel* kernel, Stack* stack) {
-     auto result_ = at::softmax(
-       (std::move(peek(*stack, 0, 3))).toTensor(),
-       (std::move(peek(*stack, 1, 3))).toInt(),
-       (std::move(peek(*stack, 2, 3))).toOptional<c10::ScalarType>()
-     );
-     drop(*stack, 3);
-     pack(*stack, std::move(result_));
-  })
-).op(
-  "_aten::warn() -> void",
-  torch::RegisterOperators::options().catchAllKernel(
-  [](c10::OperatorKernel* kernel, Stack* stack) {
-    drop(*stack, 1);
-    pop(*stack);
-  })
-).op(
-  "_prim::unchecked_cast",
-  torch::RegisterOperators::options().catchAllKernel(
-  []() {
-  })
-).op(
-  "_prim::TupleConstruct",
-  torch::RegisterOperators::options().catchAllKernel(
-  []() {
-  })
-).op(
-  "_prim::TupleUnpack",
-  torch::RegisterOperators::options().catchAllKernel(
-  []() {
-  })
-).op(
-  "_aten::format",
-  torch::RegisterOperators::options().catchAllKernel(
-  []() {
-  })
-).op(
-  "_aten::append.Tensor(Tensor self) -> void",
-  torch::RegisterOperators::options().kernel(c10::TensorTypeId::CPUTensorId,
-  [](c10::OperatorKernel* kernel, Stack* stack) {
-    listAppend<at::Tensor>(*stack);
-  })
-).op(
-  "_aten::append.int(int self) -> void",
-  torch::RegisterOperators::options().catchAllKernel(
-  [](c10::OperatorKernel* kernel, Stack* stack) {
-    listAppend<int64_t>(*stack);
-  })
-);
+  }
+  return c10::nullopt;
+}
 
+} // namespace mobile
+} // namespace jit
+} // namespace torch
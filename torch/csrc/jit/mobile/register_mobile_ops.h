@@ -0,0 +1,37 @@
+#pragma once
+#include <ATen/core/ivalue.h>
+#include <ATen/core/operator_name.h>
+#include <c10/util/Optional.h>
+#include <torch/csrc/WindowsTorchApiMacro.h>
+
+#include <vector>
+
+namespace torch {
+namespace jit {
+namespace mobile {
+using Stack = std::vector<c10::IValue>;
+
+// The lite interpreter calls its operators through a static table rather than
+// the dispatcher, so that a build only contains, and initializes, the
+// operators of its models. With SELECTED_OP_LIST set (a yaml list of
+// "name.overload_name", as written by binaries/dump_operator_names), the
+// kernels of the other operators are left out of the build and their entries
+// are empty; the indices of the entries are the same in every build.
+using OperatorFunction = void (*)(Stack&);
+
+struct OperatorEntry {
+  const char* name;
+  const char* overload_name;
+  // nullptr if the operator isn't selected in this build
+  OperatorFunction fn;
+};
+
+TORCH_API const OperatorEntry& operatorEntry(size_t index);
+
+// Returns the index of the operator in the table, or nullopt if this build
+// doesn't include it
+TORCH_API c10::optional<size_t> findOperator(const c10::OperatorName& opname);
+
+} // namespace mobile
+} // namespace jit
+} // namespace torch
@@ -6,6 +6,8 @@
 #include <torch/csrc/jit/script/edit_distance.h>
 #include <torch/csrc/jit/script/error_report.h>
 
+#include <array>
+#include <atomic>
 #include <queue>
 #include <utility>
 #include <vector>
@@ -14,15 +16,76 @@ namespace torch {
 namespace jit {
 
 namespace {
-using OperatorMap =
-    std::unordered_map<Symbol, std::vector<std::shared_ptr<Operator>>>;
+
+// The overloads of one operator symbol. Published overloads are never
+// modified; registering an overload publishes a new OperatorOverloads.
+struct OperatorOverloads {
+  // in registration order
+  std::vector<std::shared_ptr<Operator>> all;
+  // Indices into all of the overloads that can match a node with the given
+  // number of inputs, so that findOperatorFor only tries those: non-vararg
+  // overloads by their number of arguments, and the vararg ones separately.
+  std::unordered_map<size_t, std::vector<size_t>> by_num_inputs;
+  std::vector<size_t> vararg;
+
+  void add(std::shared_ptr<Operator> op) {
+    const auto& schema = op->schema();
+    if (schema.is_vararg()) {
+      vararg.push_back(all.size());
+    } else {
+      by_num_inputs[schema.arguments().size()].push_back(all.size());
+    }
+    all.push_back(std::move(op));
+  }
+
+  std::shared_ptr<Operator> find(const Node* node) const {
+    const size_t num_inputs = node->inputs().size();
+    // the first matching overload in registration order wins
+    size_t found = all.size();
+    auto it = by_num_inputs.find(num_inputs);
+    if (it != by_num_inputs.end()) {
+      for (size_t index : it->second) {
+        if (all[index]->matches(node)) {
+          found = index;
+          break;
+        }
+      }
+    }
+    for (size_t index : vararg) {
+      if (index > found) {
+        break;
+      }
+      if (all[index]->matches(node)) {
+        found = index;
+        break;
+      }
+    }
+    return found < all.size() ? all[found] : nullptr;
+  }
+};
+
 struct OperatorRegistry {
  private:
   std::mutex lock;
-  OperatorMap operators;
   // list of operators whose schema have not yet been parsed, and must
   // be registered before any call to lookup an opeator
   std::vector<std::shared_ptr<Operator>> to_register;
+  std::atomic<bool> has_pending{false};
+
+  // Looking up the overloads of a symbol doesn't take the lock: they live in
+  // a two-level table of atomic pointers indexed by the unique id of the
+  // symbol, and those pointers are only ever replaced, never cleared.
+  // Replaced overloads are kept alive in retired_overloads, since readers
+  // may still hold references to them.
+  static constexpr size_t kSlotsPerChunk = 1024;
+  static constexpr size_t kMaxChunks = 4096;
+  using Slot = std::atomic<const OperatorOverloads*>;
+  std::array<std::atomic<Slot*>, kMaxChunks> chunks;
+  std::vector<std::unique_ptr<Slot[]>> owned_chunks;
+  std::vector<std::unique_ptr<const OperatorOverloads>> retired_overloads;
+  // the symbols with overloads, in registration order
+  std::vector<Symbol> symbols;
+
   // Those two maps are used to implement lookupByLiteral, which is needed for
   // the n->match(...) calls. Basically, every function schema is assigned a
   // unique string you can use to match it. However, parsing those strings or
@@ -37,20 +100,81 @@ struct OperatorRegistry {
   std::unordered_map<const char*, std::shared_ptr<Operator>>
       operators_by_sig_literal;
 
+  Slot* slotFor(Symbol name, bool create) {
+    const auto id = static_cast<c10::unique_t>(name);
+    const size_t chunk_index = id / kSlotsPerChunk;
+    TORCH_CHECK(chunk_index < kMaxChunks, "Too many symbols for the operator registry");
+    Slot* chunk = chunks[chunk_index].load(std::memory_order_acquire);
+    if (chunk == nullptr) {
+      if (!create) {
+        return nullptr;
+      }
+      // value-initialized, i.e. all nullptr
+      owned_chunks.emplace_back(new Slot[kSlotsPerChunk]());
+      chunk = owned_chunks.back().get();
+      chunks[chunk_index].store(chunk, std::memory_order_release);
+    }
+    return &chunk[id % kSlotsPerChunk];
+  }
+
   // XXX - caller must be holding lock
   void registerPendingOperators() {
     for (const auto& op : to_register) {
       Symbol sym = Symbol::fromQualString(op->schema().name());
-      operators[sym].push_back(op);
+      Slot* slot = slotFor(sym, /*create=*/true);
+      const OperatorOverloads* old = slot->load(std::memory_order_relaxed);
+      std::unique_ptr<OperatorOverloads> overloads(
+          old ? new OperatorOverloads(*old) : new OperatorOverloads());
+      overloads->add(op);
+      slot->store(overloads.release(), std::memory_order_release);
+      if (old) {
+        retired_overloads.emplace_back(old);
+      } else {
+        symbols.push_back(sym);
+      }
       operators_by_sig[canonicalSchemaString(op->schema())] = op;
     }
     to_register.clear();
+    has_pending.store(false, std::memory_order_release);
+  }
+
+  void registerPendingOperatorsIfAny() {
+    if (C10_UNLIKELY(has_pending.load(std::memory_order_acquire))) {
+      std::lock_guard<std::mutex> guard(lock);
+      registerPendingOperators();
+    }
+  }
+
+  const OperatorOverloads* lookup(Symbol name) {
+    registerPendingOperatorsIfAny();
+    const auto id = static_cast<c10::unique_t>(name);
+    if (id / kSlotsPerChunk >= kMaxChunks) {
+      return nullptr;
+    }
+    Slot* chunk = chunks[id / kSlotsPerChunk].load(std::memory_order_acquire);
+    if (chunk == nullptr) {
+      return nullptr;
+    }
+    return chunk[id % kSlotsPerChunk].load(std::memory_order_acquire);
   }
 
  public:
+  OperatorRegistry() {
+    for (auto& chunk : chunks) {
+      chunk.store(nullptr, std::memory_order_relaxed);
+    }
+  }
+
+  ~OperatorRegistry() {
+    for (const auto& sym : symbols) {
+      delete slotFor(sym, /*create=*/false)->load(std::memory_order_relaxed);
+    }
+  }
+
   void registerOperator(Operator&& op) {
     std::lock_guard<std::mutex> guard(lock);
     to_register.push_back(std::make_shared<Operator>(std::move(op)));
+    has_pending.store(true, std::memory_order_release);
   }
 
   const std::shared_ptr<Operator>& lookupByLiteral(const char* name) {
@@ -79,13 +203,14 @@ struct OperatorRegistry {
   }
 
   const std::vector<std::shared_ptr<Operator>>& getOperators(Symbol name) {
-    std::lock_guard<std::mutex> guard(lock);
-    registerPendingOperators();
     static std::vector<std::shared_ptr<Operator>> empty;
-    auto it = operators.find(name);
-    if (it != operators.end())
-      return it->second;
-    return empty;
+    const OperatorOverloads* overloads = lookup(name);
+    return overloads ? overloads->all : empty;
+  }
+
+  std::shared_ptr<Operator> findOperatorFor(const Node* node) {
+    const OperatorOverloads* overloads = lookup(node->kind());
+    return overloads ? overloads->find(node) : nullptr;
   }
 
   std::vector<Symbol> findSimilarOperators(Symbol input_op) {
@@ -100,11 +225,11 @@ struct OperatorRegistry {
     std::priority_queue<EntryPair, std::vector<EntryPair>, decltype(cmp)>
         rankings(cmp);
     static constexpr size_t MAX_EDIT_DIST = 2u;
-    for (const auto& op : operators) {
+    for (const auto& sym : symbols) {
       auto edit_dist = script::ComputeEditDistance(
-          input_op.toQualString(), op.first.toQualString(), MAX_EDIT_DIST);
+          input_op.toQualString(), sym.toQualString(), MAX_EDIT_DIST);
       if (edit_dist <= MAX_EDIT_DIST) {
-        rankings.emplace(edit_dist, op.first);
+        rankings.emplace(edit_dist, sym);
       }
     }
     std::vector<Symbol> ret;
@@ -119,9 +244,10 @@ struct OperatorRegistry {
     std::lock_guard<std::mutex> guard(lock);
     registerPendingOperators();
     std::vector<std::shared_ptr<Operator>> values;
-    values.clear();
-    for (auto & kv : operators) {
-      values.insert(values.end(), kv.second.begin(), kv.second.end());
+    for (const auto& sym : symbols) {
+      const auto& overloads =
+          slotFor(sym, /*create=*/false)->load(std::memory_order_relaxed)->all;
+      values.insert(values.end(), overloads.begin(), overloads.end());
     }
     return values;
   }
@@ -256,13 +382,7 @@ bool Operator::matches(const Node* node) const {
 }
 
 std::shared_ptr<Operator> findOperatorFor(const Node* node) {
-  const auto& candidates = getAllOperatorsFor(node->kind());
-  for (const auto& candidate : candidates) {
-    if (candidate->matches(node)) {
-      return candidate;
-    }
-  }
-  return nullptr;
+  return getRegistry().findOperatorFor(node);
 }
 
 const Operator& getOperatorFor(const Node* node) {
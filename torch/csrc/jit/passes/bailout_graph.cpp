@@ -274,6 +274,9 @@ struct BailOutInserter {
 
         bailout_node->output()->setType(it->output()->type());
         bailout_node->i_(attr::index, bailout_index_++);
+        if (it->hasAttribute(attr::symbols)) {
+          bailout_node->is_(attr::symbols, it->is(attr::symbols));
+        }
         // we can't immediately replace nodes since this action will corrupt
         // the liveness sets of following BailOut nodes if any of their
         // arguments are BailOut nodes themselves
@@ -368,31 +368,39 @@ RegisterOperators mm_batch_side_reg({Operator(
     },
     aliasAnalysisIsSpecialCase())});
 
-std::pair<std::vector<Node*>, std::vector<Node*>> gatherIndependentMMUses(
-    Value* value,
+// Sorts the nodes of a block, and filters out the nodes that depend on an
+// earlier one
+std::vector<Node*> filterIndependentNodes(
+    std::vector<Node*> nodes,
     AliasDb& alias_db) {
-  const auto postprocess = [&](std::vector<Node*> mms) {
-    if (mms.size() == 0) {
-      return mms;
-    }
-    std::sort(mms.begin(), mms.end(), [](Node* n, Node* m) {
-      return n->isBefore(m);
-    });
-    // Filter out dependent MMs. This algorithm might do very badly if e.g. you
-    // have a lot of independent MMs, that depend on the first one, but I doubt
-    // this will be a common scenario.
-    for (size_t i = 0; i < mms.size(); ++i) {
-      if (mms[i] == nullptr)
+  if (nodes.size() == 0) {
+    return nodes;
+  }
+  std::sort(nodes.begin(), nodes.end(), [](Node* n, Node* m) {
+    return n->isBefore(m);
+  });
+  // This algorithm might do very badly if e.g. you have a lot of independent
+  // nodes, that depend on the first one, but I doubt this will be a common
+  // scenario.
+  for (size_t i = 0; i < nodes.size(); ++i) {
+    if (nodes[i] == nullptr)
+      continue;
+    for (size_t j = i + 1; j < nodes.size(); ++j) {
+      if (nodes[j] == nullptr)
         continue;
-      for (size_t j = i + 1; j < mms.size(); ++j) {
-        if (mms[j] == nullptr)
-          continue;
-        if (!alias_db.couldMoveBeforeTopologically(mms[j], mms[i])) {
-          mms[j] = nullptr;
-        }
+      if (!alias_db.couldMoveBeforeTopologically(nodes[j], nodes[i])) {
+        nodes[j] = nullptr;
       }
     }
-    return c10::filter(mms, [](Node* n) { return n != nullptr; });
+  }
+  return c10::filter(nodes, [](Node* n) { return n != nullptr; });
+}
+
+std::pair<std::vector<Node*>, std::vector<Node*>> gatherIndependentMMUses(
+    Value* value,
+    AliasDb& alias_db) {
+  const auto postprocess = [&](std::vector<Node*> mms) {
+    return filterIndependentNodes(std::move(mms), alias_db);
   };
 
   Block* block = value->node()->owningBlock();
@@ -459,6 +467,297 @@ void BatchMMSide(Block* block, AliasDb& alias_db) {
   }
 }
 
+// This pass batches independent ops of the same kind, whose inputs and
+// outputs have the same shapes, into a single op over the stacked inputs.
+// Ensembles and multi-head models run dozens of such ops, each of them a
+// separate (and usually small) kernel launch on the GPU:
+//   * pointwise ops stack their inputs and unbind the result,
+//   * linears with different weights become a single batched matmul,
+//   * conv2ds with different weights become a grouped convolution,
+//   * linears and conv2ds sharing a weight run once over the concatenated
+//     inputs.
+// The shapes have to be complete in the graph (e.g. after shape
+// specialization), as stacking mismatched inputs would fail at runtime.
+
+// Tunable parameter, like min_fusion_size.
+static constexpr size_t min_batch_size = 4;
+
+static const OperatorSet& batchablePointwiseOps() {
+  static const OperatorSet ops = {
+      "aten::relu(Tensor self) -> Tensor",
+      "aten::sigmoid(Tensor self) -> Tensor",
+      "aten::tanh(Tensor self) -> Tensor",
+      "aten::exp(Tensor self) -> Tensor",
+      "aten::log(Tensor self) -> Tensor",
+      "aten::neg(Tensor self) -> Tensor",
+      "aten::sqrt(Tensor self) -> Tensor",
+      "aten::rsqrt(Tensor self) -> Tensor",
+      "aten::gelu(Tensor self) -> Tensor",
+      "aten::add(Tensor self, Tensor other, *, Scalar alpha) -> Tensor",
+      "aten::sub(Tensor self, Tensor other, *, Scalar alpha) -> Tensor",
+      "aten::mul(Tensor self, Tensor other) -> Tensor",
+      "aten::div(Tensor self, Tensor other) -> Tensor",
+  };
+  return ops;
+}
+
+static const char* linear_schema =
+    "aten::linear(Tensor input, Tensor weight, Tensor? bias=None) -> Tensor";
+static const char* conv2d_schema =
+    "aten::conv2d(Tensor input, Tensor weight, Tensor? bias=None, int[2] stride=1, int[2] padding=0, int[2] dilation=1, int groups=1) -> Tensor";
+
+static bool isCompleteCUDATensor(const Value* value) {
+  auto type = value->type()->cast<TensorType>();
+  return type && type->isComplete() && type->device()->is_cuda();
+}
+
+static bool isBatchable(Node* node) {
+  if (!batchablePointwiseOps().find(node) && !node->matches(linear_schema) &&
+      !node->matches(conv2d_schema)) {
+    return false;
+  }
+  if (node->matches(conv2d_schema)) {
+    auto groups = constant_as<int64_t>(node->namedInput(attr::groups));
+    if (!groups || *groups != 1) {
+      return false;
+    }
+  }
+  for (Value* input : node->inputs()) {
+    if (input->type()->isSubtypeOf(TensorType::get()) &&
+        !isCompleteCUDATensor(input)) {
+      return false;
+    }
+  }
+  return isCompleteCUDATensor(node->output());
+}
+
+// Nodes are batched together when they run the same op on tensors of the
+// same types, and the rest of their inputs are the same values
+static bool canBatchTogether(Node* a, Node* b) {
+  if (a->kind() != b->kind() || a->inputs().size() != b->inputs().size() ||
+      *a->output()->type() != *b->output()->type()) {
+    return false;
+  }
+  for (size_t i = 0; i < a->inputs().size(); ++i) {
+    Value* a_input = a->inputs()[i];
+    Value* b_input = b->inputs()[i];
+    if (a_input->type()->cast<TensorType>()
+            ? *a_input->type() != *b_input->type()
+            : a_input != b_input) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static bool sharedInput(const std::vector<Node*>& nodes, size_t i) {
+  return std::all_of(nodes.begin(), nodes.end(), [&](Node* n) {
+    return n->inputs()[i] == nodes[0]->inputs()[i];
+  });
+}
+
+// Concatenates (or stacks) the i-th inputs of the nodes along dim
+static Value* catInputs(
+    const std::vector<Node*>& nodes,
+    size_t i,
+    Symbol op,
+    int64_t dim) {
+  Graph* graph = nodes[0]->owningGraph();
+  auto inputs = fmap(nodes, [i](Node* n) { return n->inputs()[i]; });
+  Value* list =
+      graph->insertNode(graph->createList(TensorType::get(), inputs))->output();
+  return graph->insert(op, {list, graph->insertConstant(dim)});
+}
+
+// Replaces the outputs of the nodes with the slices of batched along dim
+static void splitOutputs(
+    const std::vector<Node*>& nodes,
+    Value* batched,
+    bool unbind,
+    int64_t dim) {
+  Graph* graph = nodes[0]->owningGraph();
+  Value* dim_value = graph->insertConstant(dim);
+  Value* list = unbind
+      ? graph->insert(aten::unbind, {batched, dim_value})
+      : graph->insert(
+            aten::chunk,
+            {batched,
+             graph->insertConstant(static_cast<int64_t>(nodes.size())),
+             dim_value});
+  Node* unpack = graph->insertNode(graph->createListUnpack(list, nodes.size()));
+  for (size_t i = 0; i < nodes.size(); ++i) {
+    unpack->outputs()[i]->setType(nodes[i]->output()->type());
+    nodes[i]->output()->replaceAllUsesWith(unpack->outputs()[i]);
+  }
+}
+
+// Runs the op of the nodes once, on its shared inputs and on the batched
+// inputs replacing the others
+static Value* insertBatchedOp(
+    const std::vector<Node*>& nodes,
+    const std::unordered_map<size_t, Value*>& batched_inputs) {
+  Graph* graph = nodes[0]->owningGraph();
+  Node* batched = graph->create(nodes[0]->kind());
+  for (size_t i = 0; i < nodes[0]->inputs().size(); ++i) {
+    auto it = batched_inputs.find(i);
+    batched->addInput(
+        it != batched_inputs.end() ? it->second : nodes[0]->inputs()[i]);
+  }
+  return graph->insertNode(batched)->output();
+}
+
+// Returns false, leaving the graph untouched, if the nodes can't be batched
+static bool batchNodes(const std::vector<Node*>& nodes) {
+  Graph* graph = nodes[0]->owningGraph();
+  Node* first = nodes[0];
+  const size_t num_inputs = first->inputs().size();
+  std::vector<size_t> varying;
+  for (size_t i = 0; i < num_inputs; ++i) {
+    if (!sharedInput(nodes, i)) {
+      varying.push_back(i);
+    }
+  }
+  // Nodes with all their inputs in common are left to CSE
+  if (varying.empty()) {
+    return false;
+  }
+
+  if (batchablePointwiseOps().find(first) ||
+      (first->matches(linear_schema) && varying == std::vector<size_t>{0})) {
+    // Linear treats all but the last dim of its input as batch dims. The
+    // shared inputs broadcast to the stacked ones, as long as those aren't
+    // broadcast themselves.
+    auto sizesOf = [](Value* v) {
+      return v->type()->expect<TensorType>()->sizes().concrete_sizes();
+    };
+    if (batchablePointwiseOps().find(first)) {
+      for (size_t i : varying) {
+        if (sizesOf(first->inputs()[i]) != sizesOf(first->output())) {
+          return false;
+        }
+      }
+    }
+    std::unordered_map<size_t, Value*> batched_inputs;
+    for (size_t i : varying) {
+      batched_inputs[i] = catInputs(nodes, i, aten::stack, 0);
+    }
+    splitOutputs(nodes, insertBatchedOp(nodes, batched_inputs), true, 0);
+    return true;
+  }
+
+  Value* bias = first->namedInput(attr::bias);
+  const bool varying_weight = !sharedInput(nodes, 1);
+  const bool varying_bias = !sharedInput(nodes, 2);
+  if (first->matches(linear_schema)) {
+    // (input @ weight^T + bias) for every node is
+    // stack(input) @ stack(weight)^T + stack(bias), broadcasting the inputs
+    // that are shared
+    if (first->namedInput(attr::input)->type()->expect<TensorType>()->dim() !=
+        size_t(2)) {
+      return false;
+    }
+    Value* input = sharedInput(nodes, 0) ? first->inputs()[0]
+                                         : catInputs(nodes, 0, aten::stack, 0);
+    Value* weight = graph->insert(
+        aten::transpose,
+        {catInputs(nodes, 1, aten::stack, 0),
+         graph->insertConstant(1),
+         graph->insertConstant(2)});
+    Value* output = graph->insert(aten::matmul, {input, weight});
+    if (varying_bias) {
+      bias = graph->insert(
+          aten::unsqueeze,
+          {catInputs(nodes, 2, aten::stack, 0), graph->insertConstant(1)});
+    }
+    if (bias->type()->isSubtypeOf(TensorType::get())) {
+      output = graph->insert(aten::add, {output, bias});
+    }
+    splitOutputs(nodes, output, true, 0);
+    return true;
+  }
+
+  AT_ASSERT(first->matches(conv2d_schema));
+  std::unordered_map<size_t, Value*> batched_inputs;
+  if (!varying_weight) {
+    // The nodes only differ by their inputs, which are concatenated along the
+    // batch dim
+    if (varying_bias) {
+      return false;
+    }
+    batched_inputs[0] = catInputs(nodes, 0, aten::cat, 0);
+    splitOutputs(nodes, insertBatchedOp(nodes, batched_inputs), false, 0);
+    return true;
+  }
+  // The weights are concatenated along the output channels. Different inputs
+  // are concatenated along the input channels, and each one is convolved
+  // with its own weight by a grouped convolution.
+  batched_inputs[1] = catInputs(nodes, 1, aten::cat, 0);
+  if (bias->type()->isSubtypeOf(TensorType::get())) {
+    batched_inputs[2] = catInputs(nodes, 2, aten::cat, 0);
+  }
+  if (!sharedInput(nodes, 0)) {
+    batched_inputs[0] = catInputs(nodes, 0, aten::cat, 1);
+    batched_inputs[6] =
+        graph->insertConstant(static_cast<int64_t>(nodes.size()));
+  }
+  splitOutputs(nodes, insertBatchedOp(nodes, batched_inputs), false, 1);
+  return true;
+}
+
+void gatherBatchableGroups(
+    Block* block,
+    AliasDb& alias_db,
+    std::vector<std::vector<Node*>>& groups) {
+  std::vector<std::vector<Node*>> block_groups;
+  for (Node* node : block->nodes()) {
+    for (Block* subblock : node->blocks()) {
+      gatherBatchableGroups(subblock, alias_db, groups);
+    }
+    if (!isBatchable(node)) {
+      continue;
+    }
+    auto it = std::find_if(
+        block_groups.begin(),
+        block_groups.end(),
+        [node](const std::vector<Node*>& group) {
+          return canBatchTogether(group[0], node);
+        });
+    if (it != block_groups.end()) {
+      it->push_back(node);
+    } else {
+      block_groups.push_back({node});
+    }
+  }
+  for (auto& group : block_groups) {
+    group = filterIndependentNodes(std::move(group), alias_db);
+    if (group.size() >= min_batch_size) {
+      groups.push_back(std::move(group));
+    }
+  }
+}
+
+void BatchIndependentOps(Block* block, AliasDb& alias_db) {
+  std::vector<std::vector<Node*>> groups;
+  gatherBatchableGroups(block, alias_db, groups);
+  // All the nodes are moved before the first one of their group, which is
+  // where the batched op is inserted. The moves are done before any node is
+  // inserted, as the alias db doesn't know about the new nodes.
+  for (auto& group : groups) {
+    group = c10::filter(group, [&](Node* n) {
+      return n == group[0] ||
+          alias_db.moveBeforeTopologicallyValid(n, group[0]);
+    });
+  }
+  for (const auto& group : groups) {
+    if (group.size() < min_batch_size) {
+      continue;
+    }
+    WithInsertPoint insert_guard{group[0]};
+    batchNodes(group);
+    // NB: the batched nodes are left to DCE
+  }
+}
+
 bool hasMutableOperators(Block* block) {
   for (auto n : block->nodes()) {
     if (n->kind().is_aten() && n->schema().is_mutable())
@@ -479,6 +778,8 @@ void BatchMM(std::shared_ptr<Graph>& graph) {
   AliasDb alias_db(graph);
   BatchMMTreeReduce(graph->block());
   BatchMMSide(graph->block(), alias_db);
+  AliasDb batch_alias_db(graph);
+  BatchIndependentOps(graph->block(), batch_alias_db);
   EliminateDeadCode(graph);
   // It's possible that transpose rearrangements have created sequences of
   // consecutive transposes that didn't exist before.
@@ -0,0 +1,188 @@
+#include <torch/csrc/jit/passes/fold_batch_norm.h>
+
+#include <torch/csrc/jit/constants.h>
+#include <torch/csrc/jit/passes/constant_propagation.h>
+#include <torch/csrc/jit/passes/subgraph_rewrite.h>
+#include <torch/csrc/jit/subgraph_matcher.h>
+
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace torch {
+namespace jit {
+
+namespace {
+
+using ValueMap = std::unordered_map<std::string, Value*>;
+
+// The ops whose bias batch norm is folded into, with the number of dimensions
+// of their weight
+const std::vector<std::pair<std::string, size_t>> folded_ops = {
+    {"aten::conv1d", 3},
+    {"aten::conv2d", 4},
+    {"aten::conv3d", 5},
+    {"aten::linear", 2},
+};
+
+// The inputs of the op, named as in callOf
+std::string inputsOf(const std::string& op) {
+  if (op == "aten::linear") {
+    return "%x, %w, %b";
+  }
+  return "%x, %w, %b, %stride, %padding, %dilation, %groups";
+}
+
+std::string callOf(
+    const std::string& op,
+    const std::string& weight,
+    const std::string& bias) {
+  if (op == "aten::linear") {
+    return op + "(%x, " + weight + ", " + bias + ")";
+  }
+  return op + "(%x, " + weight + ", " + bias +
+      ", %stride, %padding, %dilation, %groups)";
+}
+
+const std::string bn_inputs =
+    "%bn_w, %bn_b, %mean, %var, %training, %momentum, %eps, %cudnn_enabled";
+
+// Computes, as in torch/nn/utils/fusion.py:
+//   scale = bn_w / sqrt(var + eps)
+//   new_w = w * scale (broadcast over the output channels)
+//   new_b = (b - mean) * scale + bn_b
+// where a None bias counts as zero.
+std::string foldedReplacement(
+    const std::string& op,
+    size_t weight_dim,
+    bool has_bias) {
+  std::string shape = "%minus_one";
+  for (size_t i = 1; i < weight_dim; ++i) {
+    shape += ", %one";
+  }
+  std::string bias = has_bias ? R"IR(
+    %b_centered = aten::sub(%b, %mean, %one)
+    %new_b = aten::mul(%b_centered, %scale)
+    %new_b_shifted = aten::add(%new_b, %bn_b, %one)
+)IR"
+                              : R"IR(
+    %mean_scaled = aten::mul(%mean, %scale)
+    %new_b_shifted = aten::sub(%bn_b, %mean_scaled, %one)
+)IR";
+  return "graph(" + inputsOf(op) + ", " + bn_inputs + "):" + R"IR(
+    %one : int = prim::Constant[value=1]()
+    %minus_one : int = prim::Constant[value=-1]()
+    %var_eps = aten::add(%var, %eps, %one)
+    %invstd = aten::rsqrt(%var_eps)
+    %scale = aten::mul(%bn_w, %invstd)
+    %shape : int[] = prim::ListConstruct()IR" +
+      shape + ")" + R"IR(
+    %scale_w = aten::reshape(%scale, %shape)
+    %new_w = aten::mul(%w, %scale_w))IR" +
+      bias + "    %res = " + callOf(op, "%new_w", "%new_b_shifted") + R"IR(
+    return (%res))IR";
+}
+
+bool isConstantTensor(const Value* value) {
+  auto ivalue = toIValue(value);
+  return ivalue && ivalue->isTensor();
+}
+
+} // namespace
+
+void FoldFrozenBatchNorm(std::shared_ptr<Graph>& graph) {
+  for (const auto& folded_op : folded_ops) {
+    const std::string& op = folded_op.first;
+    std::string pattern = "graph(" + inputsOf(op) + ", " + bn_inputs +
+        "):\n    %y = " + callOf(op, "%w", "%b") +
+        "\n    %res = aten::batch_norm(%y, " + bn_inputs + ")" + R"IR(
+    return (%res))IR";
+
+    for (bool has_bias : {true, false}) {
+      auto filter = [&](const Match& match, const ValueMap& vmap) {
+        const auto& match_vmap = match.values_map;
+        auto matched = [&](const char* name) {
+          return match_vmap.at(vmap.at(name));
+        };
+        auto training = constant_as<bool>(matched("training"));
+        if (!training || *training) {
+          return false;
+        }
+        for (const char* name : {"w", "bn_w", "bn_b", "mean", "var"}) {
+          if (!isConstantTensor(matched(name))) {
+            return false;
+          }
+        }
+        if (!toIValue(matched("eps"))) {
+          return false;
+        }
+        auto bias = toIValue(matched("b"));
+        if (!bias || (has_bias ? !bias->isTensor() : !bias->isNone())) {
+          return false;
+        }
+        if (op == "aten::linear") {
+          auto input_type = matched("x")->type()->cast<TensorType>();
+          return input_type && input_type->dim() == size_t(2);
+        }
+        return true;
+      };
+      SubgraphRewriter rewriter;
+      rewriter.RegisterRewritePattern(
+          pattern, foldedReplacement(op, folded_op.second, has_bias));
+      rewriter.runOnGraph(graph, filter);
+    }
+  }
+  // Compute the folded weights and biases once
+  ConstantPropagation(graph);
+}
+
+void FuseConvAndLinearRelu(std::shared_ptr<Graph>& graph) {
+  for (const auto& folded_op : folded_ops) {
+    const std::string& op = folded_op.first;
+    std::string inputs = inputsOf(op);
+    std::string call = callOf(op, "%w", "%b");
+
+    std::string add_relu = "graph(" + inputs + ", %other, %alpha):\n" +
+        "    %y = " + call + R"IR(
+    %z = aten::add(%y, %other, %alpha)
+    %res = aten::relu(%z)
+    return (%res))IR";
+    std::string fused_add_relu = "graph(" + inputs + ", %other, %alpha):\n" +
+        "    %y = " + call + R"IR(
+    %z = aten::add_(%y, %other, %alpha)
+    %res = aten::relu_(%z)
+    return (%res))IR";
+    // The add is in-place only when it doesn't broadcast or promote
+    auto same_type = [](const Match& match, const ValueMap& vmap) {
+      const auto& match_vmap = match.values_map;
+      auto y_type = match_vmap.at(vmap.at("y"))->type()->cast<TensorType>();
+      auto other_type =
+          match_vmap.at(vmap.at("other"))->type()->cast<TensorType>();
+      if (!y_type || !other_type) {
+        return false;
+      }
+      auto y_sizes = y_type->sizes().concrete_sizes();
+      return y_sizes && y_sizes == other_type->sizes().concrete_sizes() &&
+          y_type->scalarType() &&
+          y_type->scalarType() == other_type->scalarType();
+    };
+    SubgraphRewriter add_relu_rewriter;
+    add_relu_rewriter.RegisterRewritePattern(add_relu, fused_add_relu);
+    add_relu_rewriter.runOnGraph(graph, same_type);
+
+    std::string relu = "graph(" + inputs + "):\n    %y = " + call + R"IR(
+    %res = aten::relu(%y)
+    return (%res))IR";
+    std::string fused_relu = "graph(" + inputs + "):\n    %y = " + call +
+        R"IR(
+    %res = aten::relu_(%y)
+    return (%res))IR";
+    SubgraphRewriter relu_rewriter;
+    relu_rewriter.RegisterRewritePattern(relu, fused_relu);
+    relu_rewriter.runOnGraph(graph);
+  }
+}
+
+} // namespace jit
+} // namespace torch
@@ -0,0 +1,37 @@
+/** \brief Folding batch norm into the preceding conv or linear of frozen
+ * graphs, and fusing the relu that follows them
+ */
+#pragma once
+
+#include <torch/csrc/jit/ir.h>
+
+namespace torch {
+namespace jit {
+
+/** \brief Fold eval-mode aten::batch_norm into the weight and bias of the
+ * aten::conv1d/conv2d/conv3d or aten::linear it normalizes.
+ *
+ * Only batch norms whose parameters and running stats are constants, like in
+ * the graphs of modules frozen by freeze_module, and whose conv or linear has
+ * a constant weight and bias are folded; the new weight and bias are computed
+ * once by constant propagation. A linear is only folded when its input is
+ * known to be 2-dimensional, since batch norm normalizes dimension 1 and the
+ * linear produces its features in the last one. Run FuseLinear first to turn
+ * addmm and matmul back into aten::linear.
+ */
+TORCH_API void FoldFrozenBatchNorm(std::shared_ptr<Graph>& graph);
+
+/** \brief Fuse the relu, or the add and the relu, that follow a conv or a
+ * linear into it.
+ *
+ * There are no fused kernels for these blocks, so the fusion makes the add and
+ * the relu in-place on the fresh output of the conv or the linear, which saves
+ * an allocation and a pass over memory for each of them. The add is only made
+ * in-place when the other operand is known to have the same sizes and scalar
+ * type as the conv output, so that neither broadcasting nor type promotion
+ * changes the result.
+ */
+TORCH_API void FuseConvAndLinearRelu(std::shared_ptr<Graph>& graph);
+
+} // namespace jit
+} // namespace torch
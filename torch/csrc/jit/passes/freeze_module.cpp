@@ -0,0 +1,134 @@
+#include <torch/csrc/jit/passes/freeze_module.h>
+
+#include <torch/csrc/jit/constants.h>
+#include <torch/csrc/jit/passes/alias_analysis.h>
+#include <torch/csrc/jit/passes/constant_pooling.h>
+#include <torch/csrc/jit/passes/constant_propagation.h>
+#include <torch/csrc/jit/passes/dead_code_elimination.h>
+#include <torch/csrc/jit/passes/inliner.h>
+
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace torch {
+namespace jit {
+
+namespace {
+
+// An attribute of every object of a class
+using Attribute = std::pair<const c10::ClassType*, std::string>;
+
+// Reads an attribute of the class of an object, if it has one
+c10::optional<Attribute> attributeOf(Node* node) {
+  auto type = node->inputs().at(0)->type()->cast<c10::ClassType>();
+  if (!type) {
+    return c10::nullopt;
+  }
+  return Attribute(type.get(), node->s(attr::name));
+}
+
+class ModuleFreezer {
+ public:
+  explicit ModuleFreezer(script::Module module) : module_(std::move(module)) {}
+
+  void run() {
+    std::vector<std::shared_ptr<Graph>> graphs;
+    for (const auto& method : module_.get_methods()) {
+      auto graph = method.graph();
+      Inline(*graph);
+      graphs.push_back(std::move(graph));
+    }
+    // An attribute modified by any method stays an attribute in all of them
+    for (auto& graph : graphs) {
+      AliasDb alias_db(graph);
+      findMutatedAttributes(graph->block(), alias_db);
+    }
+    for (auto& graph : graphs) {
+      std::unordered_map<Value*, IValue> objects;
+      objects.emplace(graph->inputs().at(0), module_._ivalue());
+      foldAttributes(*graph, graph->block(), objects);
+      ConstantPropagation(graph);
+      ConstantPooling(graph);
+      EliminateDeadCode(graph);
+    }
+  }
+
+ private:
+  void findMutatedAttributes(Block* block, const AliasDb& alias_db) {
+    for (Node* node : block->nodes()) {
+      if (node->kind() == prim::SetAttr ||
+          (node->kind() == prim::GetAttr && alias_db.hasOutputWriters(node))) {
+        if (auto attribute = attributeOf(node)) {
+          mutated_.insert(*attribute);
+        }
+      }
+      for (Block* sub_block : node->blocks()) {
+        findMutatedAttributes(sub_block, alias_db);
+      }
+    }
+  }
+
+  // objects maps the values known to be objects of the module, starting with
+  // self, to those objects
+  void foldAttributes(
+      Graph& graph,
+      Block* block,
+      std::unordered_map<Value*, IValue>& objects) {
+    for (Node* node : block->nodes()) {
+      for (Block* sub_block : node->blocks()) {
+        foldAttributes(graph, sub_block, objects);
+      }
+      if (node->kind() != prim::GetAttr) {
+        continue;
+      }
+      auto it = objects.find(node->input());
+      if (it == objects.end()) {
+        continue;
+      }
+      const auto& object = it->second.toObject();
+      const auto& name = node->s(attr::name);
+      IValue value = object->getAttr(name);
+      if (value.isObject()) {
+        // A submodule, whose own attributes may be folded
+        objects.emplace(node->output(), std::move(value));
+        continue;
+      }
+      if (mutated_.count(Attribute(object->type().get(), name))) {
+        continue;
+      }
+      if (value.isTensor()) {
+        value = value.toTensor().detach();
+      } else if (value.isTensorList()) {
+        c10::List<at::Tensor> tensors;
+        for (const at::Tensor& tensor : value.toTensorListRef()) {
+          tensors.push_back(tensor.detach());
+        }
+        value = std::move(tensors);
+      }
+      WithInsertPoint guard(graph.block()->nodes().front());
+      if (auto constant = tryInsertConstant(graph, value)) {
+        node->output()->replaceAllUsesWith(*constant);
+      }
+    }
+  }
+
+  script::Module module_;
+  std::set<Attribute> mutated_;
+};
+
+} // namespace
+
+script::Module freeze_module(const script::Module& module) {
+  script::Module frozen = module.clone();
+  TORCH_CHECK(
+      !frozen.is_training(),
+      "freeze_module: the module is in training mode, call eval() first");
+  ModuleFreezer(frozen).run();
+  return frozen;
+}
+
+} // namespace jit
+} // namespace torch
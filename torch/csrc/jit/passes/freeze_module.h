@@ -0,0 +1,17 @@
+#pragma once
+
+#include <torch/csrc/jit/script/module.h>
+
+namespace torch {
+namespace jit {
+
+// Returns a copy of a module in eval mode whose methods have all calls
+// inlined, and use the attributes that no method modifies as constants
+// instead of fetching them with prim::GetAttr. Constant propagation then
+// removes the code that only runs in training mode, and later passes see
+// the parameters of the module as constants. Tensor attributes are detached,
+// but still share their data with the original module.
+TORCH_API script::Module freeze_module(const script::Module& module);
+
+} // namespace jit
+} // namespace torch
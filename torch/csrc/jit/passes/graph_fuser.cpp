@@ -119,6 +119,60 @@ bool isSimpleMap(Node* node) {
   return true;
 }
 
+// A row op reduces the last dimension of a floating point CUDA tensor:
+//    - sum or mean over dim [-1] with keepdim=True, whose output has a single
+//      element per row and broadcasts to the consumers of the reduction
+//    - softmax or log_softmax over dim -1, computed from two reductions
+// The fused kernels run a block per row and keep the rows in shared memory,
+// see generateKernel.
+bool isFusableRowOp(Node* node) {
+  static OperatorSet row_ops{{
+      "aten::sum(Tensor self, int[1] dim, bool keepdim=False, *, ScalarType? dtype=None) -> Tensor",
+      "aten::mean(Tensor self, int[1] dim, bool keepdim=False, *, ScalarType? dtype=None) -> Tensor",
+      "aten::softmax(Tensor self, int dim, ScalarType? dtype=None) -> Tensor",
+      "aten::log_softmax(Tensor self, int dim, ScalarType? dtype=None) -> Tensor",
+  }};
+  if (!row_ops.find(node)) {
+    return false;
+  }
+  auto type = node->namedInput(attr::self)->type()->cast<TensorType>();
+  if (!type || !type->device() || !type->device()->is_cuda() ||
+      !type->scalarType() || !isFloatingType(*type->scalarType()) ||
+      !type->dim() || *type->dim() == 0) {
+    return false;
+  }
+  for (Value* input : node->inputs()) {
+    if (!input->type()->isSubtypeOf(TensorType::get()) &&
+        input->node()->kind() != prim::Constant) {
+      return false;
+    }
+  }
+  if (!node->namedInput(attr::dtype)->mustBeNone()) {
+    return false;
+  }
+  if (node->kind() == aten::softmax || node->kind() == aten::log_softmax) {
+    auto dim = node->get<int64_t>(attr::dim);
+    return dim && *dim == -1;
+  }
+  auto dims = node->get<c10::List<int64_t>>(attr::dim);
+  auto keepdim = node->get<bool>(attr::keepdim);
+  return dims && dims->size() == 1 && dims->get(0) == -1 && keepdim &&
+      *keepdim;
+}
+
+// Whether the node, or the fusion group, reduces rows
+bool hasRowOps(Node* node) {
+  auto isRowOp = [](Node* n) {
+    return n->kind() == aten::sum || n->kind() == aten::mean ||
+        n->kind() == aten::softmax || n->kind() == aten::log_softmax;
+  };
+  if (node->kind() == prim::FusionGroup) {
+    auto nodes = node->g(attr::Subgraph)->nodes();
+    return std::any_of(nodes.begin(), nodes.end(), isRowOp);
+  }
+  return isRowOp(node);
+}
+
 Value* broadcastSizes(at::ArrayRef<Value*> sizes) {
   AT_ASSERT(!sizes.empty());
   Graph* graph = sizes[0]->owningGraph();
@@ -207,7 +261,8 @@ struct GraphFuser {
     // are not necessarily correct.
     if (node->owningBlock() != block_)
       return false;
-    return node->kind() == prim::FusionGroup || isSimpleMap(node);
+    return node->kind() == prim::FusionGroup || isSimpleMap(node) ||
+        isFusableRowOp(node);
   }
 
   bool isFusableCatNode(Node* node) {
@@ -457,7 +512,8 @@ struct GraphFuser {
   }
 
   bool canFuseChunk(Node* consumer, Value* producer) {
-    if (consumer->kind() != prim::FusionGroup) {
+    // Row kernels don't chunk their inputs
+    if (consumer->kind() != prim::FusionGroup || hasRowOps(consumer)) {
       return false;
     }
     // Does the chunk have constant chunks/dim?
@@ -692,6 +748,8 @@ struct GraphFuser {
     if (chunk->kind() != prim::ConstantChunk &&
         chunk->kind() != prim::BroadcastingChunk)
       return false;
+    if (hasRowOps(consumer))
+      return false;
 
     // try to find a producer to move after the chunk/bchunk. The producer must
     // be fusible into the consumer.
@@ -700,6 +758,7 @@ struct GraphFuser {
         chunk->inputs().end(),
         [&](Value* producer_for_chunk) {
           return isFusableMap(producer_for_chunk->node()) &&
+              !hasRowOps(producer_for_chunk->node()) &&
               allUsersAreThisConsumerOrCalcSizes(chunk, producer_for_chunk);
         });
     if (it == chunk->inputs().end()) {
@@ -941,6 +1000,11 @@ struct GraphFuser {
       if (n->kind() == prim::Constant) {
         continue;
       }
+      // Row reductions don't keep the size of their input, neither do the
+      // nodes computed from them
+      if (n->kind() == aten::sum || n->kind() == aten::mean) {
+        continue;
+      }
       if (n->kind() == prim::ConstantChunk) {
         Node* sizes_node = graph->insertNode(
             graph->create(prim::ChunkSizes, shape_of.at(n->input()), 2));
@@ -960,6 +1024,12 @@ struct GraphFuser {
       auto tensor_inputs = filter(n->inputs(), [](Value* v) {
         return v->type()->isSubtypeOf(TensorType::get());
       });
+      if (std::any_of(
+              tensor_inputs.begin(), tensor_inputs.end(), [&](Value* v) {
+                return shape_of.count(v) == 0;
+              })) {
+        continue;
+      }
       auto shapes =
           fmap(tensor_inputs, [&](Value* v) { return shape_of.at(v); });
       AT_ASSERT(!shapes.empty());
@@ -1001,7 +1071,8 @@ struct GraphFuser {
   }
 
   bool canFuseWithConcat(Value* producer, Node* before_check) {
-    if (!isFusable(producer->node())) {
+    // Row kernels write their outputs whole
+    if (!isFusable(producer->node()) || hasRowOps(producer->node())) {
       return false;
     }
     // NB: it is important that this check happens after isFusable, which checks
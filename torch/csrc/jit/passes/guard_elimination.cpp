@@ -142,7 +142,11 @@ struct GuardElimination {
       auto n = *it;
       if (n->kind() == prim::Guard && guardsOutput(n) &&
           removableGuard(n->inputs().at(0)->node())) {
-        auto pttp = n->output()->type();
+        auto pttp = n->output()->type()->expect<TensorType>();
+        if (symbolic_inputs_) {
+          // the symbolic dims of the inputs only determine the output's rank
+          pttp = pttp->dimensionedOnly();
+        }
         n->output()->replaceAllUsesWith(n->inputs().at(0));
         n->inputs().at(0)->setType(pttp);
         GRAPH_UPDATE(
@@ -165,9 +169,12 @@ struct GuardElimination {
     bool all_inputs_guarded = true;
     size_t i = 0;
     for (auto input : n->inputs()) {
+      bool symbolic = input->node()->kind() == prim::Guard &&
+          isSymbolic(input->type()->expect<TensorType>());
+      symbolic_inputs_ |= symbolic;
       if ((input->node()->kind() == prim::Guard &&
            !input->type()->expect<TensorType>()->isSummarized()) ||
-          input->node()->kind() == prim::Constant ||
+          symbolic || input->node()->kind() == prim::Constant ||
           input->type()->isSubtypeOf(NumberType::get()) ||
           except.count(i) != 0) {
         AT_ASSERT(
@@ -185,6 +192,14 @@ struct GuardElimination {
   }
 
 private:
+  // Is `type` only missing the sizes and strides that varied across profiled
+  // runs? The outputs of the ops below then still have a known rank
+  static bool isSymbolic(const TensorTypePtr& type) {
+    return type->isSummarized() && type->scalarType() && type->device() &&
+        type->dim() && type->requiresGrad().has_value() &&
+        type->undefined().has_value();
+  }
+
   // `removableGuard` relies on the properties checked by `isSummarized()`
   // and passes shouldn't insert nodes between a guard and its uses that
   // may alter those properties.
@@ -214,6 +229,7 @@ private:
   bool removableGuard(Node *n) {
 
     const static auto no_exceptions = std::unordered_set<size_t>{};
+    symbolic_inputs_ = false;
     switch (n->kind()) {
     case aten::add:
     case aten::sub:
@@ -308,6 +324,8 @@ private:
 
   std::shared_ptr<Graph> graph_;
   std::unique_ptr<AliasDb> aliasDb_;
+  // did the last `removableGuard` check rely on inputs with symbolic dims?
+  bool symbolic_inputs_ = false;
   static std::unordered_set<Symbol> simple_ops_;
 };
 
@@ -1,5 +1,7 @@
 #include <torch/csrc/jit/passes/inline_fork_wait.h>
 
+#include <torch/csrc/jit/passes/inliner.h>
+
 namespace torch {
 namespace jit {
 
@@ -32,5 +34,64 @@ void InlineForkWait(const std::shared_ptr<Graph>& graph) {
   InlineForkWait(graph->block(), future_remap);
 }
 
+// The subgraph is shared with the graph the fork was copied from, so the
+// calls are inlined into a copy of it
+static std::shared_ptr<Graph> trivialForkSubgraph(Node* fork, size_t max_nodes) {
+  for (const Use& use : fork->output()->uses()) {
+    if (use.user->kind() != aten::wait) {
+      return nullptr;
+    }
+  }
+  auto subgraph = fork->g(attr::Subgraph)->copy();
+  Inline(*subgraph);
+  size_t num_nodes = 0;
+  for (Node* n : subgraph->nodes()) {
+    if (n->kind() == prim::Constant) {
+      continue;
+    }
+    if (!n->blocks().empty() || n->kind() == prim::fork ||
+        n->kind() == aten::wait || n->kind() == prim::CallFunction ||
+        n->kind() == prim::CallMethod || ++num_nodes > max_nodes) {
+      return nullptr;
+    }
+  }
+  return subgraph;
+}
+
+static void InlineTrivialForks(Block* b, size_t max_nodes) {
+  for (auto it = b->nodes().begin(); it != b->nodes().end();) {
+    Node* n = *it++;
+    for (auto sub_b : n->blocks()) {
+      InlineTrivialForks(sub_b, max_nodes);
+    }
+    if (n->kind() != prim::fork) {
+      continue;
+    }
+    auto subgraph = trivialForkSubgraph(n, max_nodes);
+    if (!subgraph) {
+      continue;
+    }
+    WithInsertPoint insert_guard(n);
+    auto output = insertGraph(*b->owningGraph(), *subgraph, n->inputs());
+    for (const Use& use : n->output()->uses()) {
+      use.user->output()->replaceAllUsesWith(output.at(0));
+    }
+    // The waits are destroyed along with the fork, they might be ahead of
+    // the iterator in this block
+    while (!n->output()->uses().empty()) {
+      Node* wait = n->output()->uses().back().user;
+      if (*it == wait) {
+        ++it;
+      }
+      wait->destroy();
+    }
+    n->destroy();
+  }
+}
+
+void InlineTrivialForks(const std::shared_ptr<Graph>& graph, size_t max_nodes) {
+  InlineTrivialForks(graph->block(), max_nodes);
+}
+
 } // namespace jit
 } // namespace torch
@@ -12,6 +12,15 @@ namespace jit {
 // produced from the (now-inlined) forked section.
 TORCH_API void InlineForkWait(const std::shared_ptr<Graph>& graph);
 
+// Inline the forks whose subgraphs are too small for running them on another
+// thread to pay off, i.e. that have at most max_nodes nodes besides constants
+// and no control flow or nested forks, once the functions they call are
+// inlined. Only forks whose futures are used by wait() calls alone are
+// inlined.
+TORCH_API void InlineTrivialForks(
+    const std::shared_ptr<Graph>& graph,
+    size_t max_nodes);
+
 
 } // namespace jit
 } // namespace torch
@@ -0,0 +1,202 @@
+#include <torch/csrc/jit/passes/inplace_rewrite.h>
+
+#include <torch/csrc/jit/operator.h>
+#include <torch/csrc/jit/passes/alias_analysis.h>
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace torch {
+namespace jit {
+
+namespace {
+
+// The ops whose in-place variant, named with a trailing underscore, takes
+// the same arguments
+const OperatorSet& rewritableOps() {
+  static const OperatorSet ops = {
+      "aten::add(Tensor self, Tensor other, *, Scalar alpha) -> Tensor",
+      "aten::add(Tensor self, Scalar other, Scalar alpha) -> Tensor",
+      "aten::sub(Tensor self, Tensor other, *, Scalar alpha) -> Tensor",
+      "aten::sub(Tensor self, Scalar other, Scalar alpha) -> Tensor",
+      "aten::mul(Tensor self, Tensor other) -> Tensor",
+      "aten::mul(Tensor self, Scalar other) -> Tensor",
+      "aten::div(Tensor self, Tensor other) -> Tensor",
+      "aten::div(Tensor self, Scalar other) -> Tensor",
+      "aten::relu(Tensor self) -> Tensor",
+      "aten::sigmoid(Tensor self) -> Tensor",
+      "aten::tanh(Tensor self) -> Tensor",
+      "aten::exp(Tensor self) -> Tensor",
+      "aten::log(Tensor self) -> Tensor",
+      "aten::neg(Tensor self) -> Tensor",
+      "aten::abs(Tensor self) -> Tensor",
+      "aten::sqrt(Tensor self) -> Tensor",
+      "aten::rsqrt(Tensor self) -> Tensor",
+      "aten::clamp(Tensor self, Scalar? min, Scalar? max) -> Tensor",
+  };
+  return ops;
+}
+
+bool forks(Block* block) {
+  for (Node* node : block->nodes()) {
+    if (node->kind() == prim::fork || node->kind() == aten::wait) {
+      return true;
+    }
+    for (Block* sub_block : node->blocks()) {
+      if (forks(sub_block)) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+// An in-place op writes its result into self, so both must have the same
+// layout
+bool sameLayout(const Value* self, const Value* output) {
+  auto self_type = self->type()->cast<TensorType>();
+  auto output_type = output->type()->cast<TensorType>();
+  if (!self_type || !output_type || !self_type->isComplete() ||
+      !output_type->isComplete()) {
+    return false;
+  }
+  return self_type->scalarType() == output_type->scalarType() &&
+      self_type->device() == output_type->device() &&
+      self_type->sizes().concrete_sizes() ==
+      output_type->sizes().concrete_sizes() &&
+      self_type->strides().concrete_sizes() ==
+      output_type->strides().concrete_sizes() &&
+      self_type->requiresGrad() == false;
+}
+
+struct InplaceRewriter {
+  explicit InplaceRewriter(std::shared_ptr<Graph> graph)
+      : graph_(std::move(graph)), alias_db_(graph_) {}
+
+  void run() {
+    if (forks(graph_->block())) {
+      return;
+    }
+    for (Node* node : graph_->nodes()) {
+      positions_.emplace(node, positions_.size());
+    }
+    positions_.emplace(graph_->return_node(), positions_.size());
+    collectValues(graph_->block());
+
+    // The decisions are all made on the original graph, which the alias db
+    // describes. Rewriting a node only makes its output alias its self,
+    // which is dead at that point, so it doesn't change the later
+    // decisions.
+    std::vector<Node*> rewritten;
+    for (Node* node : graph_->nodes()) {
+      if (canRewrite(node)) {
+        rewritten.push_back(node);
+      }
+    }
+    for (Node* node : rewritten) {
+      rewrite(node);
+    }
+  }
+
+ private:
+  // The position of the top-level node that contains node
+  size_t position(Node* node) const {
+    while (node->owningBlock() != graph_->block()) {
+      node = node->owningBlock()->owningNode();
+    }
+    return positions_.at(node);
+  }
+
+  void collectValue(Value* value, size_t defined_at) {
+    size_t last_use = defined_at;
+    for (const Use& use : value->uses()) {
+      last_use = std::max(last_use, position(use.user));
+    }
+    values_.push_back(value);
+    last_uses_.emplace(value, last_use);
+  }
+
+  void collectValues(Block* block) {
+    const size_t block_position = block == graph_->block()
+        ? 0
+        : position(block->owningNode());
+    for (Value* input : block->inputs()) {
+      collectValue(input, block_position);
+    }
+    for (Node* node : block->nodes()) {
+      for (Value* output : node->outputs()) {
+        collectValue(output, position(node));
+        if (node->kind() == prim::Constant) {
+          external_.push_back(output);
+        }
+      }
+      for (Block* sub_block : node->blocks()) {
+        collectValues(sub_block);
+      }
+    }
+  }
+
+  bool canRewrite(Node* node) {
+    if (!rewritableOps().find(node)) {
+      return false;
+    }
+    Value* self = node->inputs().at(0);
+    if (!sameLayout(self, node->output())) {
+      return false;
+    }
+    // Writing to the graph inputs or the constants would change them for
+    // the caller or the next run
+    if (alias_db_.mayContainAlias(graph_->inputs(), self) ||
+        alias_db_.mayContainAlias(external_, self)) {
+      return false;
+    }
+    // Overlapping inputs would be read after being written
+    for (Value* input : node->inputs().slice(1)) {
+      if (input != self && alias_db_.mayContainAlias(input, self)) {
+        return false;
+      }
+    }
+    const size_t node_position = positions_.at(node);
+    for (Value* value : values_) {
+      if (last_uses_.at(value) > node_position &&
+          alias_db_.mayContainAlias(value, self)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  void rewrite(Node* node) {
+    const std::string name = node->kind().toQualString();
+    Node* inplace =
+        graph_->create(Symbol::fromQualString(name + "_"), node->inputs());
+    inplace->insertBefore(node);
+    inplace->setScope(node->scope());
+    inplace->output()->copyMetadata(node->output());
+    node->replaceAllUsesWith(inplace);
+    node->destroy();
+  }
+
+  std::shared_ptr<Graph> graph_;
+  AliasDb alias_db_;
+  std::unordered_map<Node*, size_t> positions_;
+  std::vector<Value*> values_;
+  std::unordered_map<Value*, size_t> last_uses_;
+  // The tensors of constants, which outlive the run
+  std::vector<Value*> external_;
+};
+
+} // namespace
+
+void RewriteToInplaceOps(std::shared_ptr<Graph>& graph) {
+  InplaceRewriter(graph).run();
+}
+
+std::atomic<bool>& getInplaceRewriteMode() {
+  static std::atomic<bool> inplace_rewrite_mode{false};
+  return inplace_rewrite_mode;
+}
+
+} // namespace jit
+} // namespace torch
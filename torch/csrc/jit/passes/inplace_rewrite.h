@@ -0,0 +1,25 @@
+#pragma once
+
+#include <torch/csrc/jit/ir.h>
+
+#include <atomic>
+
+namespace torch {
+namespace jit {
+
+// Rewrites out-of-place pointwise ops of the top-level block (add, mul,
+// relu, ...) into their in-place variants (add_, mul_, relu_, ...) when
+// alias analysis shows that their self input is dead afterwards: no value
+// that may alias or contain it is used by a later node or returned, and it
+// doesn't alias a graph input or a constant. The result must also have the
+// sizes, strides, dtype and device of self, and self must not need
+// gradients. This is the opposite of RemoveInplaceOps, and saves the
+// allocation and the memory traffic of the output.
+TORCH_API void RewriteToInplaceOps(std::shared_ptr<Graph>& graph);
+
+// When set, the graph executors rewrite to in-place ops the optimized graphs
+// that don't need gradients. Off by default.
+TORCH_API std::atomic<bool>& getInplaceRewriteMode();
+
+} // namespace jit
+} // namespace torch
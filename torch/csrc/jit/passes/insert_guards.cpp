@@ -35,6 +35,9 @@ struct GuardInserter {
           auto guard = graph_->create(prim::Guard, {n->input()}, 1);
           auto go = guard->output();
           go->setType(pttp);
+          if (n->hasAttribute(attr::symbols)) {
+            guard->is_(attr::symbols, n->is(attr::symbols));
+          }
           guard->insertBefore(n);
           n->output()->replaceAllUsesWith(go);
         } else {
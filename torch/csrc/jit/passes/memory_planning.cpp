@@ -0,0 +1,522 @@
+#include <torch/csrc/jit/passes/memory_planning.h>
+
+#include <torch/csrc/jit/custom_operator.h>
+#include <torch/csrc/jit/operator.h>
+#include <torch/csrc/jit/passes/alias_analysis.h>
+
+#include <ATen/core/ivalue.h>
+#include <c10/core/Allocator.h>
+#include <c10/core/ArenaAllocator.h>
+#include <c10/core/CPUAllocator.h>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace torch {
+namespace jit {
+
+// Note [Memory planning]
+// ~~~~~~~~~~~~~~~~~~~~~~
+// PlanMemory() looks at the tensors output by the top-level aten nodes of a
+// graph. A tensor is planned if its type gives its sizes and strides on the
+// CPU, it doesn't need gradients, and alias analysis says that it is a new
+// tensor (it can't alias an input of its node) that can't escape (it can't
+// alias, or be contained in, a graph output). Its lifetime runs from its node
+// to the last top-level node that uses it, or uses any value that may alias
+// or contain it; a use inside a block counts as a use by the node owning the
+// block. Tensors are then placed in one slab, largest first, each one at the
+// lowest offset not taken by a placed tensor whose lifetime overlaps its own.
+//
+// The pass doesn't change the ops, it only inserts:
+//
+//   %plan : Capsule = prim::MemoryPlanBegin[size=...]()
+//   prim::MemoryPlanSlot[offsets=[...], nbytes=[...]](%plan)
+//   %y = aten::mul(%x, %x)
+//   prim::MemoryPlanSlot[offsets=[], nbytes=[]](%plan)
+//   ...
+//   prim::MemoryPlanEnd(%plan)
+//
+// MemoryPlanBegin takes a slab from the ones of its node and installs a CPU
+// allocator on the thread (like c10::ArenaAllocatorGuard does). A slot arms
+// the allocator with the offsets of the outputs of the next node: the first
+// allocation of each planned size is served from the slab, everything else
+// goes to the allocator that was installed before. The empty slot after the
+// node disarms it, so that a tensor that wasn't allocated by its node the way
+// its type says (e.g. an op that returns a view after all) never takes the
+// memory of another one. MemoryPlanEnd restores the previous allocator.
+//
+// Every tensor served from a slab holds a reference to it, and a slab only
+// goes back to its node once all of them are gone. A tensor the analysis
+// missed keeping alive after the run therefore only pins its slab, and the
+// next run takes another one. In steady state, each run reuses the same slab
+// and the planned tensors allocate nothing.
+//
+// The installed allocator is thread local, so the run must stay on its
+// thread; graphs that fork aren't planned.
+
+namespace {
+
+c10::OperatorOptions aliasAnalysisFromSchema() {
+  c10::OperatorOptions result;
+  result.setAliasAnalysis(c10::AliasAnalysisKind::FROM_SCHEMA);
+  return result;
+}
+
+constexpr size_t kSlabAlignment = 64;
+
+struct SlabPool;
+
+struct Slab {
+  char* data = nullptr;
+  // The run that took the slab, and every tensor it served
+  std::atomic<size_t> uses{0};
+  // Set while the slab is in use
+  std::shared_ptr<SlabPool> pool;
+};
+
+// The slabs of one prim::MemoryPlanBegin node
+struct SlabPool : std::enable_shared_from_this<SlabPool> {
+  explicit SlabPool(size_t size) : size_(size) {}
+
+  ~SlabPool() {
+    for (Slab* slab : free_) {
+      c10::free_cpu(slab->data);
+      delete slab;
+    }
+  }
+
+  Slab* take() {
+    Slab* slab = nullptr;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (!free_.empty()) {
+        slab = free_.back();
+        free_.pop_back();
+      }
+    }
+    if (!slab) {
+      slab = new Slab();
+      slab->data = static_cast<char*>(c10::alloc_cpu(size_));
+    }
+    slab->uses.store(1, std::memory_order_relaxed);
+    slab->pool = shared_from_this();
+    return slab;
+  }
+
+  static void release(void* ctx) {
+    auto* slab = static_cast<Slab*>(ctx);
+    if (slab->uses.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+      return;
+    }
+    auto pool = std::move(slab->pool);
+    std::lock_guard<std::mutex> lock(pool->mutex_);
+    pool->free_.push_back(slab);
+  }
+
+  const size_t size_;
+  std::mutex mutex_;
+  std::vector<Slab*> free_;
+};
+
+struct PlannedSlot {
+  size_t offset;
+  size_t nbytes;
+};
+
+struct MemoryPlanRun;
+
+thread_local MemoryPlanRun* current_run = nullptr;
+
+struct PlannedAllocator final : at::Allocator {
+  at::DataPtr allocate(size_t nbytes) const override;
+  at::DeleterFnPtr raw_deleter() const override {
+    return nullptr;
+  }
+};
+
+// Storages keep their allocator, so it has to outlive every run
+PlannedAllocator planned_allocator;
+
+// The state of one run of a planned graph, held by the value of its
+// prim::MemoryPlanBegin
+struct MemoryPlanRun : CustomClassHolder {
+  explicit MemoryPlanRun(SlabPool& pool)
+      : slab_(pool.take()),
+        prev_allocator_(c10::impl::getThreadLocalCPUAllocator()),
+        prev_run_(current_run) {
+    if (prev_allocator_ == &planned_allocator && prev_run_) {
+      fallback_ = prev_run_->fallback_;
+    } else if (prev_allocator_) {
+      fallback_ = prev_allocator_;
+    } else {
+      fallback_ = c10::GetAllocator(at::DeviceType::CPU);
+    }
+    current_run = this;
+    c10::impl::setThreadLocalCPUAllocator(&planned_allocator);
+  }
+
+  ~MemoryPlanRun() override {
+    finish();
+  }
+
+  void arm(const std::vector<PlannedSlot>& slots) {
+    slots_ = slots.empty() ? nullptr : &slots;
+    served_.assign(slots.size(), false);
+  }
+
+  bool take(size_t nbytes, at::DataPtr& data) {
+    if (!slots_) {
+      return false;
+    }
+    for (size_t i = 0; i < slots_->size(); i++) {
+      const auto& slot = (*slots_)[i];
+      if (!served_[i] && slot.nbytes == nbytes) {
+        served_[i] = true;
+        slab_->uses.fetch_add(1, std::memory_order_relaxed);
+        data = at::DataPtr(
+            slab_->data + slot.offset,
+            slab_,
+            &SlabPool::release,
+            at::Device(at::DeviceType::CPU));
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void finish() {
+    if (!slab_) {
+      return;
+    }
+    if (current_run == this) {
+      current_run = prev_run_;
+      c10::impl::setThreadLocalCPUAllocator(prev_allocator_);
+    } else {
+      // Finished out of order, e.g. when an exception destroys the values of
+      // several frames: unlink it from the runs installed after it
+      for (auto* run = current_run; run; run = run->prev_run_) {
+        if (run->prev_run_ == this) {
+          run->prev_run_ = prev_run_;
+          run->prev_allocator_ = prev_allocator_;
+          break;
+        }
+      }
+    }
+    slots_ = nullptr;
+    SlabPool::release(slab_);
+    slab_ = nullptr;
+  }
+
+  Slab* slab_;
+  at::Allocator* prev_allocator_;
+  MemoryPlanRun* prev_run_;
+  // Where the allocations that aren't planned go
+  at::Allocator* fallback_;
+  // The outputs of the next node, owned by its prim::MemoryPlanSlot
+  const std::vector<PlannedSlot>* slots_ = nullptr;
+  std::vector<bool> served_;
+};
+
+at::DataPtr PlannedAllocator::allocate(size_t nbytes) const {
+  MemoryPlanRun* run = current_run;
+  if (!run) {
+    // Resizing a planned storage after its run
+    return c10::GetAllocator(at::DeviceType::CPU)->allocate(nbytes);
+  }
+  at::DataPtr data;
+  if (nbytes > 0 && run->take(nbytes, data)) {
+    return data;
+  }
+  return run->fallback_->allocate(nbytes);
+}
+
+MemoryPlanRun& toRun(const IValue& value) {
+  return *static_cast<MemoryPlanRun*>(value.toCapsule().get());
+}
+
+RegisterOperators reg({
+    Operator(
+        "prim::MemoryPlanBegin() -> Capsule",
+        [](const Node* node) -> Operation {
+          auto pool = std::make_shared<SlabPool>(node->i(attr::size));
+          return [pool](Stack& stack) {
+            c10::intrusive_ptr<CustomClassHolder> run =
+                c10::make_intrusive<MemoryPlanRun>(*pool);
+            push(stack, IValue(std::move(run)));
+            return 0;
+          };
+        },
+        aliasAnalysisFromSchema()),
+    Operator(
+        "prim::MemoryPlanSlot(Capsule plan) -> ()",
+        [](const Node* node) -> Operation {
+          const auto& offsets = node->is(attr::offsets);
+          const auto& nbytes = node->is(attr::nbytes);
+          auto slots = std::make_shared<std::vector<PlannedSlot>>();
+          for (size_t i = 0; i < offsets.size(); i++) {
+            slots->push_back({static_cast<size_t>(offsets[i]),
+                              static_cast<size_t>(nbytes[i])});
+          }
+          return [slots](Stack& stack) {
+            toRun(pop(stack)).arm(*slots);
+            return 0;
+          };
+        },
+        aliasAnalysisFromSchema()),
+    Operator(
+        "prim::MemoryPlanEnd(Capsule plan) -> ()",
+        [](Stack& stack) {
+          toRun(pop(stack)).finish();
+          return 0;
+        },
+        aliasAnalysisFromSchema()),
+});
+
+// The bytes the storage of a planned value takes, or 0 if it isn't planned
+size_t plannedBytes(const Value* value) {
+  auto type = value->type()->cast<TensorType>();
+  if (!type || !type->isComplete() || type->device()->type() != at::kCPU ||
+      type->requiresGrad() != false) {
+    return 0;
+  }
+  const auto sizes = *type->sizes().concrete_sizes();
+  const auto strides = *type->strides().concrete_sizes();
+  if (sizes.size() != strides.size()) {
+    return 0;
+  }
+  size_t numel = 1;
+  for (size_t i = 0; i < sizes.size(); i++) {
+    if (sizes[i] == 0 || strides[i] < 0) {
+      return 0;
+    }
+    numel += (sizes[i] - 1) * strides[i];
+  }
+  return numel * elementSize(*type->scalarType());
+}
+
+bool forks(Block* block) {
+  for (Node* node : block->nodes()) {
+    if (node->kind() == prim::fork || node->kind() == aten::wait) {
+      return true;
+    }
+    for (Block* sub_block : node->blocks()) {
+      if (forks(sub_block)) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+struct PlannedValue {
+  Value* value;
+  size_t nbytes;
+  // Positions of the first and last top-level node it is alive for
+  size_t begin;
+  size_t end;
+  size_t offset;
+};
+
+struct MemoryPlanner {
+  explicit MemoryPlanner(std::shared_ptr<Graph> graph)
+      : graph_(std::move(graph)), alias_db_(graph_) {}
+
+  void run() {
+    if (forks(graph_->block())) {
+      return;
+    }
+    for (Node* node : graph_->nodes()) {
+      positions_.emplace(node, positions_.size());
+    }
+    positions_.emplace(graph_->return_node(), positions_.size());
+    collectValues(graph_->block());
+
+    findPlannedValues();
+    if (planned_.empty()) {
+      return;
+    }
+    const size_t size = assignOffsets();
+    insertPlan(size);
+  }
+
+ private:
+  // The position of the top-level node that contains node
+  size_t position(Node* node) const {
+    while (node->owningBlock() != graph_->block()) {
+      node = node->owningBlock()->owningNode();
+    }
+    return positions_.at(node);
+  }
+
+  void collectValue(Value* value, size_t defined_at) {
+    size_t last_use = defined_at;
+    for (const Use& use : value->uses()) {
+      last_use = std::max(last_use, position(use.user));
+    }
+    values_.push_back(value);
+    last_uses_.emplace(value, last_use);
+  }
+
+  void collectValues(Block* block) {
+    const size_t block_position = block == graph_->block()
+        ? 0
+        : position(block->owningNode());
+    for (Value* input : block->inputs()) {
+      collectValue(input, block_position);
+    }
+    for (Node* node : block->nodes()) {
+      for (Value* output : node->outputs()) {
+        collectValue(output, position(node));
+      }
+      for (Block* sub_block : node->blocks()) {
+        collectValues(sub_block);
+      }
+    }
+  }
+
+  bool isFresh(Node* node, Value* output) {
+    for (Value* input : node->inputs()) {
+      if (alias_db_.mayAlias(output, input)) {
+        return false;
+      }
+    }
+    for (Value* other : node->outputs()) {
+      if (other != output && alias_db_.mayAlias(output, other)) {
+        return false;
+      }
+    }
+    return !alias_db_.mayContainAlias(graph_->outputs(), output);
+  }
+
+  void findPlannedValues() {
+    for (Node* node : graph_->nodes()) {
+      if (!node->kind().is_aten() || !node->blocks().empty()) {
+        continue;
+      }
+      const size_t begin = positions_.at(node);
+      for (Value* output : node->outputs()) {
+        const size_t nbytes = plannedBytes(output);
+        if (nbytes == 0 || !isFresh(node, output)) {
+          continue;
+        }
+        size_t end = last_uses_.at(output);
+        for (Value* other : values_) {
+          if (other != output && alias_db_.mayContainAlias(other, output)) {
+            end = std::max(end, last_uses_.at(other));
+          }
+        }
+        planned_.push_back({output, nbytes, begin, end, 0});
+      }
+    }
+  }
+
+  // Returns the size of the slab
+  size_t assignOffsets() {
+    std::vector<PlannedValue*> order;
+    for (auto& value : planned_) {
+      order.push_back(&value);
+    }
+    std::stable_sort(
+        order.begin(), order.end(), [](PlannedValue* a, PlannedValue* b) {
+          return a->nbytes > b->nbytes;
+        });
+
+    auto aligned = [](size_t nbytes) {
+      return (nbytes + kSlabAlignment - 1) / kSlabAlignment * kSlabAlignment;
+    };
+    size_t size = 0;
+    std::vector<PlannedValue*> placed;
+    for (PlannedValue* value : order) {
+      std::vector<PlannedValue*> overlapping;
+      for (PlannedValue* other : placed) {
+        if (other->begin <= value->end && value->begin <= other->end) {
+          overlapping.push_back(other);
+        }
+      }
+      std::sort(
+          overlapping.begin(),
+          overlapping.end(),
+          [](PlannedValue* a, PlannedValue* b) { return a->offset < b->offset; });
+      size_t offset = 0;
+      for (PlannedValue* other : overlapping) {
+        if (offset + aligned(value->nbytes) <= other->offset) {
+          break;
+        }
+        offset = std::max(offset, other->offset + aligned(other->nbytes));
+      }
+      value->offset = offset;
+      size = std::max(size, offset + aligned(value->nbytes));
+      placed.push_back(value);
+    }
+    return size;
+  }
+
+  void insertPlan(size_t size) {
+    std::unordered_map<Node*, std::vector<PlannedValue*>> by_node;
+    for (auto& value : planned_) {
+      by_node[value.value->node()].push_back(&value);
+    }
+
+    Node* begin = graph_->create(prim::MemoryPlanBegin, 1);
+    begin->i_(attr::size, size);
+    begin->output()->setType(CapsuleType::get());
+    graph_->prependNode(begin);
+    Value* plan = begin->output();
+
+    // Decide where to disarm before inserting anything after the nodes
+    std::vector<std::pair<Node*, bool>> nodes;
+    for (Node* node : graph_->nodes()) {
+      if (by_node.count(node)) {
+        nodes.emplace_back(node, !by_node.count(node->next()));
+      }
+    }
+    for (const auto& entry : nodes) {
+      Node* node = entry.first;
+      std::vector<int64_t> offsets;
+      std::vector<int64_t> nbytes;
+      for (PlannedValue* value : by_node.at(node)) {
+        offsets.push_back(value->offset);
+        nbytes.push_back(value->nbytes);
+      }
+      Node* arm = graph_->create(prim::MemoryPlanSlot, {plan}, 0);
+      arm->is_(attr::offsets, std::move(offsets));
+      arm->is_(attr::nbytes, std::move(nbytes));
+      arm->insertBefore(node);
+      if (entry.second) {
+        Node* disarm = graph_->create(prim::MemoryPlanSlot, {plan}, 0);
+        disarm->is_(attr::offsets, std::vector<int64_t>());
+        disarm->is_(attr::nbytes, std::vector<int64_t>());
+        disarm->insertAfter(node);
+      }
+    }
+    graph_->appendNode(graph_->create(prim::MemoryPlanEnd, {plan}, 0));
+  }
+
+  std::shared_ptr<Graph> graph_;
+  AliasDb alias_db_;
+  // Of the top-level nodes, and the return node
+  std::unordered_map<Node*, size_t> positions_;
+  // Every value of the graph, and the position of its last use
+  std::vector<Value*> values_;
+  std::unordered_map<Value*, size_t> last_uses_;
+  std::vector<PlannedValue> planned_;
+};
+
+} // namespace
+
+void PlanMemory(std::shared_ptr<Graph>& graph) {
+  MemoryPlanner(graph).run();
+}
+
+std::atomic<bool>& getMemoryPlanningMode() {
+  static std::atomic<bool> memory_planning_mode{false};
+  return memory_planning_mode;
+}
+
+} // namespace jit
+} // namespace torch
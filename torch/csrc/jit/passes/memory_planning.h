@@ -0,0 +1,24 @@
+#pragma once
+
+#include <torch/csrc/jit/ir.h>
+
+#include <atomic>
+
+namespace torch {
+namespace jit {
+
+// Plans the memory of the CPU tensors that the top-level nodes of an inference
+// graph allocate and that die before the graph returns. Every run then takes
+// one preallocated slab, and each planned tensor is carved out of it at an
+// offset where it doesn't overlap any tensor alive at the same time, instead
+// of being allocated by the op. Only tensors whose sizes and strides are
+// known are planned; the graph must not need gradients, and must not fork.
+// See Note [Memory planning]
+TORCH_API void PlanMemory(std::shared_ptr<Graph>& graph);
+
+// When set, the graph executors plan the memory of the optimized graphs that
+// don't need gradients. Off by default.
+TORCH_API std::atomic<bool>& getMemoryPlanningMode();
+
+} // namespace jit
+} // namespace torch
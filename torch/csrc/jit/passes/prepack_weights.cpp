@@ -0,0 +1,177 @@
+#include <torch/csrc/jit/passes/prepack_weights.h>
+
+#include <ATen/ATen.h>
+#include <ATen/Context.h>
+#include <torch/csrc/jit/constants.h>
+#include <torch/csrc/jit/jit_log.h>
+#include <torch/csrc/jit/passes/fuse_linear.h>
+#include <torch/csrc/jit/passes/propagate_mkldnn_layout.h>
+
+#include <string>
+#include <vector>
+
+namespace torch {
+namespace jit {
+
+namespace {
+
+bool isDenseFloatCPUTensor(const IValue& value) {
+  if (!value.isTensor()) {
+    return false;
+  }
+  const auto& tensor = value.toTensor();
+  return tensor.layout() == at::kStrided && tensor.device().is_cpu() &&
+      tensor.scalar_type() == at::kFloat;
+}
+
+bool isTwoElementIntList(const IValue& value) {
+  return value.isIntList() && value.toIntListRef().size() == 2;
+}
+
+// Returns the arguments of conv after its input when conv can run on a
+// prepacked weight
+c10::optional<std::vector<IValue>> prepackableConvArgs(Node* conv) {
+  if (!conv->matches(
+          "aten::conv2d(Tensor input, Tensor weight, Tensor? bias, int[] stride, int[] padding, int[] dilation, int groups) -> Tensor")) {
+    return c10::nullopt;
+  }
+  std::vector<IValue> args;
+  for (size_t i = 1; i < conv->inputs().size(); ++i) {
+    auto arg = toIValue(conv->inputs()[i]);
+    if (!arg) {
+      return c10::nullopt;
+    }
+    args.push_back(std::move(*arg));
+  }
+  if (!isDenseFloatCPUTensor(args[0]) || args[0].toTensor().dim() != 4 ||
+      !(args[1].isNone() || isDenseFloatCPUTensor(args[1])) ||
+      !isTwoElementIntList(args[2]) || !isTwoElementIntList(args[3]) ||
+      !isTwoElementIntList(args[4])) {
+    return c10::nullopt;
+  }
+  return args;
+}
+
+void collectConvs(Block* block, std::vector<Node*>& convs) {
+  for (Node* node : block->nodes()) {
+    if (node->kind() == aten::conv2d) {
+      convs.push_back(node);
+    }
+    for (Block* sub_block : node->blocks()) {
+      collectConvs(sub_block, convs);
+    }
+  }
+}
+
+bool isWinogradConv(const std::vector<IValue>& args) {
+  const auto& weight = args[0].toTensor();
+  const auto stride = args[2].toIntListRef();
+  const auto dilation = args[4].toIntListRef();
+  return weight.size(2) == 3 && weight.size(3) == 3 && stride[0] == 1 &&
+      stride[1] == 1 && dilation[0] == 1 && dilation[1] == 1 &&
+      args[5].toInt() == 1;
+}
+
+void prepackWinogradConvs(Graph& graph) {
+  std::vector<Node*> convs;
+  collectConvs(graph.block(), convs);
+  for (Node* conv : convs) {
+    auto args = prepackableConvArgs(conv);
+    if (!args || !isWinogradConv(*args)) {
+      continue;
+    }
+    WithInsertPoint guard(conv);
+    Value* weight = graph.insertConstant(
+        at::_winograd_conv2d_weight((*args)[0].toTensor().detach()));
+    Value* output = graph.insert(
+        aten::_winograd_conv2d,
+        {conv->inputs()[0], weight, conv->inputs()[2], conv->inputs()[3]});
+    output->setType(conv->output()->type());
+    conv->output()->replaceAllUsesWith(output);
+    conv->destroy();
+  }
+}
+
+class ConvPrepacker {
+ public:
+  ConvPrepacker(script::Module& module, const script::Module& params_module)
+      : module_(module), params_module_(params_module) {}
+
+  void run(std::shared_ptr<Graph>& graph) {
+    std::vector<Node*> convs;
+    collectConvs(graph->block(), convs);
+    for (Node* conv : convs) {
+      if (auto args = prepackableConvArgs(conv)) {
+        prepack(*graph, conv, *args);
+      }
+    }
+    // A folded conv2d passes its MKLDNN output on directly to the ops with
+    // MKLDNN kernels that follow it, and to the next folded conv2d
+    PropagateMKLDNNLayout(graph);
+  }
+
+ private:
+  void prepack(Graph& graph, Node* conv, const std::vector<IValue>& args) {
+    script::Module params = params_module_.clone();
+    params.get_method("set_conv_params")(
+        std::vector<IValue>{args[2], args[3], args[4], args[5]});
+    params.get_method("set_weight_bias")(
+        std::vector<IValue>{args[0].toTensor().detach(), args[1]});
+    std::string name;
+    do {
+      name = "_mkldnn_conv_packed_params_module_for_" + c10::to_string(uid_++);
+    } while (module_.hasattr(name));
+    GRAPH_UPDATE("Adding new module: ", name);
+    module_.register_module(name, params);
+
+    WithInsertPoint guard(conv);
+    Value* params_value = graph.insertGetAttr(graph.inputs()[0], name)
+                              ->setType(params.type());
+    Value* input = graph.insert(aten::to_mkldnn, {conv->inputs()[0]});
+    conv->replaceInput(0, input);
+    conv->replaceInput(1, graph.insertGetAttr(params_value, "_packed_weight"));
+    conv->replaceInput(2, graph.insertGetAttr(params_value, "_packed_bias"));
+
+    WithInsertPoint after(conv->next());
+    Value* output = graph.insert(aten::to_dense, {conv->output()});
+    output->setType(conv->output()->type());
+    conv->output()->setType(TensorType::get());
+    conv->output()->replaceAllUsesWith(output);
+    output->node()->replaceInput(0, conv->output());
+  }
+
+  script::Module& module_;
+  const script::Module& params_module_;
+  size_t uid_ = 0;
+};
+
+} // namespace
+
+void PrepackMKLDNNConvWeights(
+    script::Module& module,
+    const script::Module& mkldnn_conv_params_module) {
+  TORCH_CHECK(
+      at::hasMKLDNN(),
+      "PrepackMKLDNNConvWeights: PyTorch was built without MKLDNN");
+  ConvPrepacker prepacker(module, mkldnn_conv_params_module);
+  for (auto& method : module.get_methods()) {
+    auto graph = method.graph();
+    GRAPH_DUMP("Before PrepackMKLDNNConvWeights: ", graph);
+    // so that the linear layers are kept in MKLDNN layout too
+    FuseLinear(graph);
+    prepacker.run(graph);
+    GRAPH_DUMP("After PrepackMKLDNNConvWeights: ", graph);
+  }
+}
+
+void PrepackWinogradConvWeights(script::Module& module) {
+  for (auto& method : module.get_methods()) {
+    auto graph = method.graph();
+    GRAPH_DUMP("Before PrepackWinogradConvWeights: ", graph);
+    prepackWinogradConvs(*graph);
+    GRAPH_DUMP("After PrepackWinogradConvWeights: ", graph);
+  }
+}
+
+} // namespace jit
+} // namespace torch
@@ -0,0 +1,46 @@
+/** \brief Precomputing the MKLDNN formats, or the Winograd transforms, of
+ * the constant weights of float convolutions
+ */
+#pragma once
+
+#include <torch/csrc/jit/script/module.h>
+
+namespace torch {
+namespace jit {
+
+/** \brief Reorder the constant weights of the aten::conv2d calls in the
+ * methods of a frozen module into MKLDNN format once, instead of on each call.
+ *
+ * Each folded conv2d gets its own clone of \p mkldnn_conv_params_module,
+ * registered as a submodule, whose set_conv_params and set_weight_bias methods
+ * are called with the constant arguments of the conv2d, and which has to
+ * provide the reordered weight and bias as its _packed_weight and _packed_bias
+ * attributes. The wrapper module is there to serialize the packed weights,
+ * which the JIT can't serialize itself, through __getstate__ and __setstate__;
+ * see MkldnnConvPackedParams in torch/utils/mkldnn.py. The conv2d then runs on
+ * MKLDNN tensors, converting its input to MKLDNN and its output back to dense,
+ * and PropagateMKLDNNLayout then keeps its output in MKLDNN layout across the
+ * ops with MKLDNN kernels that follow it.
+ *
+ * Only conv2d calls on constant dense float CPU weights, and whose other
+ * arguments but the input are constants too, are folded; run freeze_module
+ * first to make the weights of a module constants.
+ */
+TORCH_API void PrepackMKLDNNConvWeights(
+    script::Module& module,
+    const script::Module& mkldnn_conv_params_module);
+
+/** \brief Replace the aten::conv2d calls of the methods of a frozen module
+ * which are 3x3 convolutions by aten::_winograd_conv2d calls on their weights
+ * transformed once, as graph constants which are serialized with the module.
+ *
+ * Only conv2d calls on constant dense float CPU 3x3 weights, with stride and
+ * dilation 1, one group, and whose other arguments but the input are constants
+ * too, are replaced; run freeze_module first to make the weights of a module
+ * constants. _winograd_conv2d doesn't have a derivative: the module can only
+ * run inference afterwards.
+ */
+TORCH_API void PrepackWinogradConvWeights(script::Module& module);
+
+} // namespace jit
+} // namespace torch
@@ -0,0 +1,263 @@
+#include <torch/csrc/jit/passes/propagate_mkldnn_layout.h>
+
+#include <torch/csrc/jit/constants.h>
+#include <torch/csrc/jit/jit_log.h>
+#include <torch/csrc/jit/passes/dead_code_elimination.h>
+
+#include <vector>
+
+namespace torch {
+namespace jit {
+
+namespace {
+
+const char* cat_schema = "aten::cat(Tensor[] tensors, int dim) -> Tensor";
+
+bool isConstantBool(Value* value, bool expected) {
+  auto ivalue = toIValue(value);
+  return ivalue && ivalue->isBool() && ivalue->toBool() == expected;
+}
+
+bool isNone(Value* value) {
+  auto ivalue = toIValue(value);
+  return ivalue && ivalue->isNone();
+}
+
+bool acceptsAll(Node*) {
+  return true;
+}
+
+// MKLDNN only has an inference batch norm, which needs the affine parameters
+bool acceptsBatchNorm(Node* node) {
+  return isConstantBool(node->inputs()[5], false) &&
+      !isNone(node->inputs()[1]) && !isNone(node->inputs()[2]) &&
+      !isNone(node->inputs()[3]) && !isNone(node->inputs()[4]);
+}
+
+bool acceptsAvgPool(Node* node) {
+  return isNone(node->inputs()[6]);
+}
+
+bool acceptsDropout(Node* node) {
+  return isConstantBool(node->inputs()[2], false);
+}
+
+// An op with an MKLDNN kernel, or that only reads the sizes of its input, and
+// the positions of its inputs that can be MKLDNN tensors; its other inputs
+// stay dense.
+struct MKLDNNOp {
+  const char* schema;
+  std::vector<size_t> layout_inputs;
+  bool inplace;
+  bool (*accepts)(Node*);
+  // The output of the ops that return tensors is in MKLDNN layout
+  bool returns_tensor;
+};
+
+const std::vector<MKLDNNOp>& mkldnnOps() {
+  static const std::vector<MKLDNNOp> ops = {
+      {"aten::relu(Tensor self) -> Tensor", {0}, false, acceptsAll, true},
+      {"aten::relu_(Tensor(a!) self) -> Tensor(a!)", {0}, true, acceptsAll, true},
+      {"aten::sigmoid(Tensor self) -> Tensor", {0}, false, acceptsAll, true},
+      {"aten::add(Tensor self, Tensor other, *, Scalar alpha) -> Tensor",
+       {0, 1},
+       false,
+       acceptsAll,
+       true},
+      {"aten::add_(Tensor(a!) self, Tensor other, *, Scalar alpha) -> Tensor(a!)",
+       {0, 1},
+       true,
+       acceptsAll,
+       true},
+      {"aten::max_pool2d(Tensor self, int[] kernel_size, int[] stride, int[] padding, int[] dilation, bool ceil_mode) -> Tensor",
+       {0},
+       false,
+       acceptsAll,
+       true},
+      {"aten::avg_pool2d(Tensor self, int[] kernel_size, int[] stride, int[] padding, bool ceil_mode, bool count_include_pad, int? divisor_override) -> Tensor",
+       {0},
+       false,
+       acceptsAvgPool,
+       true},
+      {"aten::adaptive_avg_pool2d(Tensor self, int[] output_size) -> Tensor",
+       {0},
+       false,
+       acceptsAll,
+       true},
+      {"aten::batch_norm(Tensor input, Tensor? weight, Tensor? bias, Tensor? running_mean, Tensor? running_var, bool training, float momentum, float eps, bool cudnn_enabled) -> Tensor",
+       {0},
+       false,
+       acceptsBatchNorm,
+       true},
+      {"aten::dropout(Tensor input, float p, bool train) -> Tensor",
+       {0},
+       false,
+       acceptsDropout,
+       true},
+      {"aten::linear(Tensor input, Tensor weight, Tensor? bias) -> Tensor",
+       {0},
+       false,
+       acceptsAll,
+       true},
+      {"aten::flatten(Tensor self, int start_dim, int end_dim) -> Tensor",
+       {0},
+       false,
+       acceptsAll,
+       true},
+      {"aten::size(Tensor self) -> int[]", {0}, false, acceptsAll, false},
+      {"aten::size(Tensor self, int dim) -> int", {0}, false, acceptsAll, false},
+      {"aten::dim(Tensor self) -> int", {0}, false, acceptsAll, false},
+  };
+  return ops;
+}
+
+// The MKLDNN tensor `value` is a dense copy of, or nullptr
+Value* mkldnnSource(Value* value) {
+  Node* node = value->node();
+  return node->kind() == aten::to_dense ? node->input() : nullptr;
+}
+
+// Whether no use of `value` writes to it or may alias it. Lists of the
+// inputs of a cat are the only containers it can be in.
+bool isReadOnly(Value* value) {
+  for (const Use& use : value->uses()) {
+    Node* user = use.user;
+    if (user->kind() == prim::Return) {
+      continue;
+    }
+    if (user->kind() == prim::ListConstruct) {
+      for (const Use& list_use : user->output()->uses()) {
+        if (!list_use.user->matches(cat_schema)) {
+          return false;
+        }
+      }
+      continue;
+    }
+    const FunctionSchema* schema = user->maybeSchema();
+    if (!schema || use.offset >= schema->arguments().size() ||
+        schema->arguments()[use.offset].alias_info()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void collectNodes(Block* block, std::vector<Node*>& nodes) {
+  for (Node* node : block->nodes()) {
+    nodes.push_back(node);
+    for (Block* sub_block : node->blocks()) {
+      collectNodes(sub_block, nodes);
+    }
+  }
+}
+
+class MKLDNNLayoutPropagator {
+ public:
+  explicit MKLDNNLayoutPropagator(std::shared_ptr<Graph> graph)
+      : graph_(std::move(graph)) {}
+
+  void run() {
+    std::vector<Node*> nodes;
+    collectNodes(graph_->block(), nodes);
+    for (Node* node : nodes) {
+      if (node->matches(cat_schema)) {
+        propagateCat(node);
+        continue;
+      }
+      for (const MKLDNNOp& op : mkldnnOps()) {
+        if (node->matches(op.schema)) {
+          propagate(node, op);
+          break;
+        }
+      }
+    }
+    dropRoundTrips();
+    EliminateDeadCode(graph_);
+  }
+
+ private:
+  void propagate(Node* node, const MKLDNNOp& op) {
+    if (!op.accepts(node)) {
+      return;
+    }
+    std::vector<Value*> sources;
+    for (size_t i : op.layout_inputs) {
+      Value* input = node->inputs()[i];
+      Value* source = mkldnnSource(input);
+      // The self of an in-place op can be written to when it is the only use
+      // of a dense copy of a temporary, as nothing else sees either
+      const bool writable = op.inplace && i == 0 &&
+          input->uses().size() == 1 && source && source->uses().size() == 1 &&
+          source->node()->kind() != prim::Param;
+      if (!source || !(writable || isReadOnly(input))) {
+        return;
+      }
+      sources.push_back(source);
+    }
+    GRAPH_UPDATE("Running in MKLDNN layout: ", *node);
+    for (size_t j = 0; j < op.layout_inputs.size(); ++j) {
+      node->replaceInput(op.layout_inputs[j], sources[j]);
+    }
+    if (op.returns_tensor) {
+      convertOutputToDense(node);
+    }
+  }
+
+  void propagateCat(Node* cat) {
+    Node* list = cat->inputs()[0]->node();
+    if (list->kind() != prim::ListConstruct || list->inputs().empty()) {
+      return;
+    }
+    std::vector<Value*> sources;
+    for (Value* input : list->inputs()) {
+      Value* source = mkldnnSource(input);
+      if (!source || !isReadOnly(input)) {
+        return;
+      }
+      sources.push_back(source);
+    }
+    GRAPH_UPDATE("Running in MKLDNN layout: ", *cat);
+    WithInsertPoint guard(cat);
+    Node* mkldnn_list = graph_->insertNode(graph_->createList(TensorType::get(), sources));
+    cat->replaceInput(0, mkldnn_list->output());
+    convertOutputToDense(cat);
+  }
+
+  void convertOutputToDense(Node* node) {
+    WithInsertPoint guard(node->next());
+    Value* output = graph_->insert(aten::to_dense, {node->output()});
+    output->setType(node->output()->type());
+    node->output()->setType(TensorType::get());
+    node->output()->replaceAllUsesWith(output);
+    output->node()->replaceInput(0, node->output());
+  }
+
+  // aten::to_mkldnn(aten::to_dense(x)) is x, when neither copy is written to
+  void dropRoundTrips() {
+    std::vector<Node*> nodes;
+    collectNodes(graph_->block(), nodes);
+    for (Node* node : nodes) {
+      if (node->kind() != aten::to_mkldnn) {
+        continue;
+      }
+      Value* dense = node->inputs()[0];
+      Value* source = mkldnnSource(dense);
+      if (source && isReadOnly(dense) && isReadOnly(node->output())) {
+        node->output()->replaceAllUsesWith(source);
+      }
+    }
+  }
+
+  std::shared_ptr<Graph> graph_;
+};
+
+} // namespace
+
+void PropagateMKLDNNLayout(std::shared_ptr<Graph>& graph) {
+  GRAPH_DUMP("Before PropagateMKLDNNLayout: ", graph);
+  MKLDNNLayoutPropagator(graph).run();
+  GRAPH_DUMP("After PropagateMKLDNNLayout: ", graph);
+}
+
+} // namespace jit
+} // namespace torch
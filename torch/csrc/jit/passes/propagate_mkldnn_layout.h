@@ -0,0 +1,32 @@
+/** \brief Keeping the tensors of frozen graphs in MKLDNN layout across the ops
+ * that have MKLDNN kernels
+ */
+#pragma once
+
+#include <torch/csrc/jit/ir.h>
+
+namespace torch {
+namespace jit {
+
+/** \brief Move the aten::to_dense conversions of MKLDNN tensors past the ops
+ * that can run on them, and drop the aten::to_mkldnn conversions of their
+ * dense copies.
+ *
+ * Starting from the MKLDNN outputs of the convs folded by
+ * PrepackMKLDNNConvWeights, the relu, relu_, sigmoid, add, add_, max_pool2d,
+ * avg_pool2d, adaptive_avg_pool2d, eval-mode batch_norm and dropout, linear,
+ * flatten and cat whose tensor inputs are all dense copies of MKLDNN tensors
+ * run on the MKLDNN tensors instead, and their output is converted back to
+ * dense. So do aten::size and aten::dim, which only read the sizes. A dense
+ * copy converted back to MKLDNN is replaced by the tensor it copies. The
+ * tensors of a CNN are then converted to MKLDNN once at its entry, and
+ * reordered only around the ops without MKLDNN kernels.
+ *
+ * A dense copy is only replaced when nothing writes to or aliases it, other
+ * than an in-place op it is the only use of, so that the MKLDNN tensor it was
+ * copied from can stand for it.
+ */
+TORCH_API void PropagateMKLDNNLayout(std::shared_ptr<Graph>& graph);
+
+} // namespace jit
+} // namespace torch
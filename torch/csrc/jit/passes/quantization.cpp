@@ -1,6 +1,7 @@
 #include <torch/csrc/jit/passes/quantization.h>
 #include <torch/csrc/jit/passes/constant_propagation.h>
 #include <torch/csrc/jit/passes/fuse_linear.h>
+#include <torch/csrc/jit/passes/inliner.h>
 #include <torch/csrc/jit/passes/quantization_patterns.h>
 #include <torch/csrc/jit/passes/subgraph_rewrite.h>
 
@@ -12,6 +13,8 @@
 #include <torch/csrc/jit/script/schema_matching.h>
 #include <torch/csrc/jit/subgraph_matcher.h>
 
+#include <ATen/core/dispatch/Dispatcher.h>
+
 #include <algorithm>
 #include <stack>
 
@@ -83,6 +86,7 @@ bool nodeQuantizable(Node* n) {
       "conv2d",
       "linear",
       "relu",
+      "hardtanh",
   };
   std::vector<Symbol> aten_funcs = {
       Symbol::aten("addmm"), Symbol::aten("matmul"), Symbol::aten("add_")};
@@ -282,8 +286,47 @@ graph(%input, %weight, %bias, %4):
      %intermediate_val = aten::matmul(%input, %weight_t)
      %res = aten::add_(%intermediate_val, %bias, %4)
      return (%res) )";
-  std::vector<std::string> patterns = {
-      conv_functional_relu, conv_relu_module, matmul_add};
+  std::string add_functional_relu = R"(
+graph(%self, %a, %b, %alpha, %inplace):
+    %relu = prim::Constant[name="relu"]()
+    %intermediate_val = aten::add_(%a, %b, %alpha)
+    %r = prim::CallFunction(%relu, %intermediate_val, %inplace)
+    return (%r) )";
+  std::string add_relu_module = R"(
+graph(%self, %a, %b, %alpha):
+    %intermediate_val = aten::add_(%a, %b, %alpha)
+    %relu = match::module[name="ReLU"](%self)
+    %r = prim::CallMethod[name="forward"](%relu, %intermediate_val)
+    return (%r) )";
+  std::string linear_functional_hardtanh = R"(
+graph(%self, %input, %min, %max, %inplace):
+    %hardtanh = prim::Constant[name="hardtanh"]()
+    %linear = match::module[name="Linear"](%self)
+    %intermediate_val = prim::CallMethod[name="forward"](%linear, %input)
+    %r = prim::CallFunction(%hardtanh, %intermediate_val, %min, %max, %inplace)
+    return (%r) )";
+  std::string linear_hardtanh_module = R"(
+graph(%self, %input):
+    %linear = match::module[name="Linear"](%self)
+    %intermediate_val = prim::CallMethod[name="forward"](%linear, %input)
+    %hardtanh = match::module[name="Hardtanh"](%self)
+    %r = prim::CallMethod[name="forward"](%hardtanh, %intermediate_val)
+    return (%r) )";
+  std::string linear_relu6_module = R"(
+graph(%self, %input):
+    %linear = match::module[name="Linear"](%self)
+    %intermediate_val = prim::CallMethod[name="forward"](%linear, %input)
+    %relu6 = match::module[name="ReLU6"](%self)
+    %r = prim::CallMethod[name="forward"](%relu6, %intermediate_val)
+    return (%r) )";
+  std::vector<std::string> patterns = {conv_functional_relu,
+                                       conv_relu_module,
+                                       matmul_add,
+                                       add_functional_relu,
+                                       add_relu_module,
+                                       linear_functional_hardtanh,
+                                       linear_hardtanh_module,
+                                       linear_relu6_module};
 
   for (const auto& pattern : patterns) {
     findIntermediateValuesInPattern(*graph, pattern);
@@ -1160,5 +1203,136 @@ void FoldPrepackedWeightIntoModule(
         m, linear_params_module, conv_params_module);
   }
 }
+namespace {
+
+bool usesSelfAttr(Block* block, Value* self, const std::string& name) {
+  for (Node* n : block->nodes()) {
+    if (n->kind() == prim::GetAttr && n->input(0) == self &&
+        n->s(attr::name) == name) {
+      return true;
+    }
+    for (Block* b : n->blocks()) {
+      if (usesSelfAttr(b, self, name)) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+// Replace the dtype of the weight attribute with a constant, so that the
+// argument swapping of F.embedding_bag on long weights folds away
+void foldWeightDtype(Block* block, Value* self, c10::ScalarType dtype) {
+  for (Node* n : block->nodes()) {
+    if (n->kind() == prim::dtype &&
+        n->input()->node()->kind() == prim::GetAttr &&
+        n->input()->node()->input(0) == self &&
+        n->input()->node()->s(attr::name) == "weight") {
+      WithInsertPoint guard(n);
+      n->output()->replaceAllUsesWith(
+          n->owningGraph()->insertConstant(static_cast<int64_t>(dtype)));
+    }
+    for (Block* b : n->blocks()) {
+      foldWeightDtype(b, self, dtype);
+    }
+  }
+}
+
+} // namespace
+
+void QuantizeEmbeddingBag(script::Module& module, int64_t bit_width) {
+  TORCH_CHECK(
+      bit_width == 8 || bit_width == 4,
+      "QuantizeEmbeddingBag: Expected a bit width of 8 or 4, but got ",
+      bit_width);
+  const std::string prepack_op = bit_width == 8
+      ? "quantized::embedding_bag_byte_prepack"
+      : "quantized::embedding_bag_4bit_prepack";
+  const std::string lookup_op = bit_width == 8
+      ? "quantized::embedding_bag_byte_rowwise_offsets"
+      : "quantized::embedding_bag_4bit_rowwise_offsets";
+  const std::string pattern = R"(
+graph(%self, %indices, %offsets, %scale_grad_by_freq, %mode, %sparse, %per_sample_weights):
+    %weight = prim::GetAttr[name="weight"](%self)
+    %output : Tensor, %offset2bag : Tensor, %bag_size : Tensor, %max_indices : Tensor = aten::embedding_bag(%weight, %indices, %offsets, %scale_grad_by_freq, %mode, %sparse, %per_sample_weights)
+    return (%output) )";
+  const std::string replacement = R"(
+graph(%self, %indices, %offsets, %scale_grad_by_freq, %mode, %sparse, %per_sample_weights):
+    %packed_weight = prim::GetAttr[name="_packed_weight"](%self)
+    %output = )" + lookup_op +
+      R"((%packed_weight, %indices, %offsets, %mode, %per_sample_weights)
+    return (%output) )";
+  Graph pattern_graph;
+  std::unordered_map<std::string, Value*> vmap;
+  script::parseIR(pattern, &pattern_graph, vmap);
+
+  bool packed = false;
+  for (auto& method : module.get_methods()) {
+    auto graph = method.graph();
+    // F.embedding_bag is called, not inlined, by nn.EmbeddingBag, and the mode
+    // has to be a constant to pick the quantized lookup
+    Inline(*graph);
+    if (module.hasattr("weight") && module.attr("weight").isTensor()) {
+      foldWeightDtype(
+          graph->block(),
+          graph->inputs()[0],
+          module.attr("weight").toTensor().scalar_type());
+    }
+    ConstantPropagation(graph);
+    // Only the weight of this module is packed, and the quantized lookups
+    // have no max mode
+    auto filter = [&graph](
+                      const Match& match,
+                      const std::unordered_map<std::string, Value*>& vmap) {
+      const auto& match_vmap = match.values_map;
+      if (match_vmap.at(vmap.at("self")) != graph->inputs()[0]) {
+        return false;
+      }
+      auto mode = getIValue("mode", match_vmap, vmap);
+      return mode && (mode->toInt() == 0 || mode->toInt() == 1);
+    };
+    bool matched = false;
+    for (const auto& match : findPatternMatches(pattern_graph, *graph)) {
+      matched = matched || filter(match, vmap);
+    }
+    if (!matched) {
+      continue;
+    }
+    if (!packed) {
+      auto weight = module.attr("weight");
+      TORCH_CHECK(
+          weight.isTensor() && weight.toTensor().dim() == 2,
+          "QuantizeEmbeddingBag: Expected the weight of an embedding bag to "
+          "be a 2-dimensional tensor");
+      auto op = c10::Dispatcher::singleton().findSchema({prepack_op, ""});
+      TORCH_INTERNAL_ASSERT(op.has_value(), "Couldn't find ", prepack_op);
+      at::AutoNonVariableTypeMode non_var_type_mode(true);
+      module.register_buffer(
+          "_packed_weight",
+          c10::Dispatcher::singleton().callUnboxed<at::Tensor, at::Tensor>(
+              *op, weight.toTensor().data().contiguous()));
+      packed = true;
+    }
+    SubgraphRewriter rewriter;
+    rewriter.RegisterRewritePattern(pattern, replacement);
+    rewriter.runOnGraph(graph, filter);
+  }
+  if (packed) {
+    bool weight_used = false;
+    for (auto& method : module.get_methods()) {
+      auto graph = method.graph();
+      weight_used = weight_used ||
+          usesSelfAttr(graph->block(), graph->inputs()[0], "weight");
+    }
+    // The float weight is only kept for the lookups that were not rewritten
+    if (!weight_used) {
+      module.setattr(
+          "weight", at::empty({0}, module.attr("weight").toTensor().options()));
+    }
+  }
+  for (script::Module m : module.children()) {
+    QuantizeEmbeddingBag(m, bit_width);
+  }
+}
 } // namespace jit
 } // namespace torch
@@ -137,5 +137,18 @@ TORCH_API void FoldPrepackedWeightIntoModule(
     script::Module& module,
     const script::Module& linear_params_module,
     const script::Module& conv_params_module);
+
+/** \brief Replace the embedding bags of a module and all its submodules with
+ * the quantized row-wise lookups.
+ *
+ * The aten::embedding_bag calls on the "weight" attribute of a module, in sum
+ * or mean mode, are replaced with quantized::embedding_bag_byte_rowwise_offsets
+ * for a bit_width of 8 or quantized::embedding_bag_4bit_rowwise_offsets for 4,
+ * on the weight prepacked into a new buffer "_packed_weight". The float weight
+ * is emptied once no method of the module uses it anymore.
+ */
+TORCH_API void QuantizeEmbeddingBag(
+    script::Module& module,
+    int64_t bit_width = 8);
 } // namespace jit
 } // namespace torch
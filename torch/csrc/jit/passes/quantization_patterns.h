@@ -1,12 +1,15 @@
 #pragma once
 
 #include <string>
-#include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace torch {
 namespace jit {
 
-std::unordered_map<std::string, std::string> quant_fusion_pattern_and_replacements() {
+// The patterns are applied in order, so the fused ones come before the
+// patterns of their first op, which would otherwise match them partially.
+std::vector<std::pair<std::string, std::string>> quant_fusion_pattern_and_replacements() {
 
   std::string conv2d = R"(
 graph(%a_quant, %packed_params, %r_scale, %r_zero_point, %r_dtype, %stride, %padding, %dilation, %groups):
@@ -22,6 +25,79 @@ graph(%a_quant, %packed_params, %r_scale, %r_zero_point, %r_dtype, %stride, %pad
         %r_quant = quantized::conv2d(%a_quant, %packed_params, %stride, %padding, %dilation, %groups, %r_scale, %r_zero_point)
         return (%r_quant) )";
 
+  std::string conv2d_relu = R"(
+graph(%a_quant, %packed_params, %r_scale, %r_zero_point, %r_dtype, %stride, %padding, %dilation, %groups):
+        %a_dequant = aten::dequantize(%a_quant)
+        %w_quant : Tensor, %b : Tensor? = quantized::conv2d_unpack(%packed_params)
+        %w_dequant = aten::dequantize(%w_quant)
+        %conv_out = aten::conv2d(%a_dequant, %w_dequant, %b, %stride, %padding, %dilation, %groups)
+        %r = aten::relu(%conv_out)
+        %r_quant = aten::quantize_per_tensor(%r, %r_scale, %r_zero_point, %r_dtype)
+        return (%r_quant) )";
+
+  std::string quantized_conv2d_relu = R"(
+graph(%a_quant, %packed_params, %r_scale, %r_zero_point, %r_dtype, %stride, %padding, %dilation, %groups):
+        %r_quant = quantized::conv2d_relu(%a_quant, %packed_params, %stride, %padding, %dilation, %groups, %r_scale, %r_zero_point)
+        return (%r_quant) )";
+
+  // The conv output keeps its own observer, and so its qparams, in the fused
+  // conv2d_add, only the output of the add is requantized.
+  std::string conv2d_add = R"(
+graph(%a_quant, %other_quant, %packed_params, %r_scale, %r_zero_point, %r_dtype, %stride, %padding, %dilation, %groups, %out_scale, %out_zero_point, %out_dtype):
+        %alpha = prim::Constant[value=1]()
+        %a_dequant = aten::dequantize(%a_quant)
+        %w_quant : Tensor, %b : Tensor? = quantized::conv2d_unpack(%packed_params)
+        %w_dequant = aten::dequantize(%w_quant)
+        %r = aten::conv2d(%a_dequant, %w_dequant, %b, %stride, %padding, %dilation, %groups)
+        %r_quant = aten::quantize_per_tensor(%r, %r_scale, %r_zero_point, %r_dtype)
+        %r_dequant = aten::dequantize(%r_quant)
+        %other_dequant = aten::dequantize(%other_quant)
+        %out = aten::add_(%r_dequant, %other_dequant, %alpha)
+        %out_quant = aten::quantize_per_tensor(%out, %out_scale, %out_zero_point, %out_dtype)
+        return (%out_quant) )";
+
+  std::string quantized_conv2d_add = R"(
+graph(%a_quant, %other_quant, %packed_params, %r_scale, %r_zero_point, %r_dtype, %stride, %padding, %dilation, %groups, %out_scale, %out_zero_point, %out_dtype):
+        %out_quant = quantized::conv2d_add(%a_quant, %other_quant, %packed_params, %stride, %padding, %dilation, %groups, %r_scale, %r_zero_point, %out_scale, %out_zero_point)
+        return (%out_quant) )";
+
+  std::string conv2d_add_relu = R"(
+graph(%a_quant, %other_quant, %packed_params, %r_scale, %r_zero_point, %r_dtype, %stride, %padding, %dilation, %groups, %out_scale, %out_zero_point, %out_dtype):
+        %alpha = prim::Constant[value=1]()
+        %a_dequant = aten::dequantize(%a_quant)
+        %w_quant : Tensor, %b : Tensor? = quantized::conv2d_unpack(%packed_params)
+        %w_dequant = aten::dequantize(%w_quant)
+        %r = aten::conv2d(%a_dequant, %w_dequant, %b, %stride, %padding, %dilation, %groups)
+        %r_quant = aten::quantize_per_tensor(%r, %r_scale, %r_zero_point, %r_dtype)
+        %r_dequant = aten::dequantize(%r_quant)
+        %other_dequant = aten::dequantize(%other_quant)
+        %sum = aten::add_(%r_dequant, %other_dequant, %alpha)
+        %out = aten::relu(%sum)
+        %out_quant = aten::quantize_per_tensor(%out, %out_scale, %out_zero_point, %out_dtype)
+        return (%out_quant) )";
+
+  std::string quantized_conv2d_add_relu = R"(
+graph(%a_quant, %other_quant, %packed_params, %r_scale, %r_zero_point, %r_dtype, %stride, %padding, %dilation, %groups, %out_scale, %out_zero_point, %out_dtype):
+        %out_quant = quantized::conv2d_add_relu(%a_quant, %other_quant, %packed_params, %stride, %padding, %dilation, %groups, %r_scale, %r_zero_point, %out_scale, %out_zero_point)
+        return (%out_quant) )";
+
+  // F.hardtanh and nn.ReLU6 after a linear.
+  std::string addmm_hardtanh = R"(
+graph(%packed_params, %a_quant, %r_scale, %r_zero_point, %r_dtype, %4, %min, %max):
+        %a_dequant = aten::dequantize(%a_quant)
+        %w_quant : Tensor, %b : Tensor? = quantized::linear_unpack(%packed_params)
+        %w_dequant = aten::dequantize(%w_quant)
+        %w_dequant_t = aten::t(%w_dequant)
+        %linear_out = aten::addmm(%b, %a_dequant, %w_dequant_t, %4, %4)
+        %r = aten::hardtanh(%linear_out, %min, %max)
+        %r_quant = aten::quantize_per_tensor(%r, %r_scale, %r_zero_point, %r_dtype)
+        return (%r_quant) )";
+
+  std::string quantized_linear_hardtanh = R"(
+graph(%packed_params, %a_quant, %r_scale, %r_zero_point, %r_dtype, %4, %min, %max):
+        %r = quantized::linear_hardtanh(%a_quant, %packed_params, %r_scale, %r_zero_point, %min, %max)
+        return (%r) )";
+
   std::string addmm = R"(
 graph(%packed_params, %a_quant, %r_scale, %r_zero_point, %r_dtype, %4):
         %a_dequant = aten::dequantize(%a_quant)
@@ -64,6 +140,10 @@ graph(%packed_params, %a_quant, %r_scale, %r_zero_point, %r_dtype):
         return (%r) )";
 
   return {
+    {conv2d_add_relu, quantized_conv2d_add_relu},
+    {conv2d_add, quantized_conv2d_add},
+    {conv2d_relu, quantized_conv2d_relu},
+    {addmm_hardtanh, quantized_linear_hardtanh},
     {conv2d, quantized_conv2d},
     {addmm, quantized_linear},
     {matmul_with_bias, quantized_linear},
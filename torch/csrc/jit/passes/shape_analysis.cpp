@@ -13,9 +13,13 @@
 #include <ATen/DeviceGuard.h>
 #include <ATen/ExpandUtils.h>
 
+#include <cstring>
 #include <exception>
 #include <iostream>
 #include <memory>
+#include <mutex>
+#include <sstream>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -65,6 +69,120 @@ bool containsTensorType(const TypePtr& t) {
   return false;
 }
 
+// Running an op on representative values is the most expensive way of
+// propagating shapes, and graphs are respecialized to every new ArgumentSpec,
+// so the output types of the nodes run are memoized. They only depend on the
+// op and on what representativeValue makes of the inputs, i.e. the complete
+// types of the tensors and the values of the constants, which make the key,
+// so a respecialized graph only runs the nodes whose inputs changed.
+class RunningShapeCache {
+ public:
+  static RunningShapeCache& get() {
+    static RunningShapeCache cache;
+    return cache;
+  }
+
+  // The key of the node, or nullopt if one of its inputs isn't described by
+  // its type, e.g. a tensor constant
+  static c10::optional<std::string> key(Node* node) {
+    const FunctionSchema* schema = node->maybeSchema();
+    if (!schema) {
+      return c10::nullopt;
+    }
+    std::ostringstream ss;
+    ss << canonicalSchemaString(*schema);
+    for (Value* input : node->inputs()) {
+      ss << '|';
+      if (auto iv = toIValue(input)) {
+        if (!writeConstant(ss, *iv)) {
+          return c10::nullopt;
+        }
+      } else if (auto type = input->type()->cast<TensorType>()) {
+        if (!type->isComplete()) {
+          return c10::nullopt;
+        }
+        ss << 'T' << static_cast<int>(*type->scalarType()) << *type->device()
+           << at::IntArrayRef(*type->sizes().concrete_sizes())
+           << at::IntArrayRef(*type->strides().concrete_sizes());
+      } else {
+        ss << 'f';
+      }
+    }
+    return ss.str();
+  }
+
+  // The output types, nullptr for the outputs that aren't tensors
+  c10::optional<std::vector<TypePtr>> lookup(const std::string& key) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    auto it = entries_.find(key);
+    if (it == entries_.end()) {
+      return c10::nullopt;
+    }
+    return it->second;
+  }
+
+  void insert(std::string key, std::vector<TypePtr> types) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    // the nodes of a process seldom take that many signatures, which are
+    // dropped at once rather than tracking which are used
+    if (entries_.size() >= kMaxEntries) {
+      entries_.clear();
+    }
+    entries_.emplace(std::move(key), std::move(types));
+  }
+
+ private:
+  static constexpr size_t kMaxEntries = 16384;
+
+  static bool writeConstant(std::ostream& ss, const IValue& iv) {
+    // doubles are written as bits and strings with their length, for the
+    // keys of different values to differ
+    auto write_double = [&](double d) {
+      uint64_t bits;
+      std::memcpy(&bits, &d, sizeof(bits));
+      ss << bits << ',';
+    };
+    if (iv.isNone()) {
+      ss << 'N';
+    } else if (iv.isInt()) {
+      ss << 'i' << iv.toInt();
+    } else if (iv.isBool()) {
+      ss << 'b' << iv.toBool();
+    } else if (iv.isDouble()) {
+      ss << 'd';
+      write_double(iv.toDouble());
+    } else if (iv.isString()) {
+      const auto& str = iv.toStringRef();
+      ss << 's' << str.size() << ':' << str;
+    } else if (iv.isDevice()) {
+      ss << 'D' << iv.toDevice();
+    } else if (iv.isIntList()) {
+      ss << 'I';
+      for (int64_t i : iv.toIntListRef()) {
+        ss << i << ',';
+      }
+    } else if (iv.isDoubleList()) {
+      ss << 'F';
+      for (double d : iv.toDoubleListRef()) {
+        write_double(d);
+      }
+    } else if (iv.isBoolList()) {
+      ss << 'B';
+      for (bool b : iv.toBoolList()) {
+        ss << b;
+      }
+    } else {
+      return false;
+    }
+    return true;
+  }
+
+  std::mutex mutex_;
+  std::unordered_map<std::string, std::vector<TypePtr>> entries_;
+};
+
+constexpr size_t RunningShapeCache::kMaxEntries;
+
 class ShapePropagator {
  public:
   explicit ShapePropagator(std::shared_ptr<Graph> graph) : aliasDb_(graph) {
@@ -393,6 +511,18 @@ class ShapePropagator {
   bool PropagateShapeOnNodeByRunningIt(Node* node) {
     if (!canPropagateShapeByRunningIt(node))
       return false;
+    const auto key = RunningShapeCache::key(node);
+    if (key) {
+      if (auto types = RunningShapeCache::get().lookup(*key)) {
+        for (size_t i = 0; i < types->size(); ++i) {
+          if ((*types)[i]) {
+            node->outputs()[i]->setType((*types)[i]);
+          }
+        }
+        return true;
+      }
+    }
+
     auto op = getOperation(node);
     Stack stack;
 
@@ -414,6 +544,12 @@ class ShapePropagator {
       if (stack[i].isTensor())
         node->outputs()[i]->inferTypeFrom(stack[i].toTensor());
     }
+    if (key) {
+      RunningShapeCache::get().insert(
+          *key, fmap(stack, [](const IValue& v) -> TypePtr {
+            return v.isTensor() ? TensorType::create(v.toTensor()) : nullptr;
+          }));
+    }
     return true;
   }
 
@@ -1829,6 +1965,17 @@ class ShapePropagator {
       // so there's no need to insert explicit expand nodes. Note that "div" is
       // handled by the fallthrough because it's not always safe to run it due
       // to integer divide-by-zero.
+      // Contiguous floating operands of the same type and sizes give a
+      // result of that type, which doesn't need running the op, unlike
+      // broadcasting and type promotion.
+      auto lhs_type = tensor_types.at(0);
+      auto rhs_type = tensor_types.at(1);
+      if (*lhs_type == *rhs_type->withRequiresGrad(lhs_type->requiresGrad()) &&
+          at::isFloatingType(*lhs_type->scalarType()) &&
+          *lhs_type == *lhs_type->contiguous()) {
+        node->output()->setType(lhs_type);
+        return true;
+      }
       return PropagateShapeOnNodeByRunningIt(node);
     } else if (node->matches("aten::pow(Tensor self, Scalar exponent) -> Tensor")) {
       node->output()->setType(tensor_types.at(0));
@@ -0,0 +1,305 @@
+#include <torch/csrc/jit/passes/vectorize_loops.h>
+
+#include <torch/csrc/jit/constants.h>
+#include <torch/csrc/jit/operator.h>
+#include <torch/csrc/jit/passes/dead_code_elimination.h>
+
+#include <unordered_map>
+
+namespace torch {
+namespace jit {
+
+namespace {
+
+// The ops that compute every element of their output from the elements at
+// the same position in their inputs, broadcasting them
+const OperatorSet& pointwiseOps() {
+  static const OperatorSet ops = {
+      "aten::relu(Tensor self) -> Tensor",
+      "aten::sigmoid(Tensor self) -> Tensor",
+      "aten::tanh(Tensor self) -> Tensor",
+      "aten::exp(Tensor self) -> Tensor",
+      "aten::log(Tensor self) -> Tensor",
+      "aten::neg(Tensor self) -> Tensor",
+      "aten::abs(Tensor self) -> Tensor",
+      "aten::sqrt(Tensor self) -> Tensor",
+      "aten::rsqrt(Tensor self) -> Tensor",
+      "aten::reciprocal(Tensor self) -> Tensor",
+      "aten::sin(Tensor self) -> Tensor",
+      "aten::cos(Tensor self) -> Tensor",
+      "aten::erf(Tensor self) -> Tensor",
+      "aten::floor(Tensor self) -> Tensor",
+      "aten::ceil(Tensor self) -> Tensor",
+      "aten::add(Tensor self, Tensor other, *, Scalar alpha) -> Tensor",
+      "aten::add(Tensor self, Scalar other, Scalar alpha) -> Tensor",
+      "aten::sub(Tensor self, Tensor other, *, Scalar alpha) -> Tensor",
+      "aten::sub(Tensor self, Scalar other, Scalar alpha) -> Tensor",
+      "aten::mul(Tensor self, Tensor other) -> Tensor",
+      "aten::mul(Tensor self, Scalar other) -> Tensor",
+      "aten::div(Tensor self, Tensor other) -> Tensor",
+      "aten::div(Tensor self, Scalar other) -> Tensor",
+      "aten::pow(Tensor self, Scalar exponent) -> Tensor",
+      "aten::clamp(Tensor self, Scalar? min, Scalar? max) -> Tensor",
+      "aten::where(Tensor condition, Tensor self, Tensor other) -> Tensor",
+  };
+  return ops;
+}
+
+// The ops that multiply their first input, seen as a batch of rows, with a
+// matrix
+const OperatorSet& rowMatmulOps() {
+  static const OperatorSet ops = {
+      "aten::matmul(Tensor self, Tensor other) -> Tensor",
+      "aten::mm(Tensor self, Tensor mat2) -> Tensor",
+      "aten::linear(Tensor input, Tensor weight, Tensor? bias) -> Tensor",
+  };
+  return ops;
+}
+
+bool isTrueConstant(Value* val) {
+  c10::optional<bool> maybe_value = constant_as<bool>(val);
+  return maybe_value && *maybe_value;
+}
+
+bool isConstantInt(Value* v, int64_t value) {
+  auto constant = constant_as<int64_t>(v);
+  return constant && *constant == value;
+}
+
+c10::optional<size_t> dimOf(Value* v) {
+  auto type = v->type()->cast<TensorType>();
+  return type ? type->dim() : c10::nullopt;
+}
+
+struct LoopVectorizer {
+  explicit LoopVectorizer(Node* loop)
+      : loop_(loop), body_(loop->blocks().at(0)) {}
+
+  bool matches() {
+    return matchLoop() && matchBody() && matchList();
+  }
+
+  // Replaces the loop, the list and its stack, which must match
+  void rewrite() {
+    Graph* graph = loop_->owningGraph();
+    WithInsertPoint guard(loop_);
+    std::unordered_map<Value*, Value*> batched;
+    auto batchedValue = [&](Value* v) {
+      auto it = batched.find(v);
+      return it != batched.end() ? it->second : v;
+    };
+    for (Node* n : body_->nodes()) {
+      if (n == append_) {
+        continue;
+      }
+      if (isSlice(n)) {
+        batched[n->output()] = input_;
+        continue;
+      }
+      Value* output = nullptr;
+      if (n->kind() == aten::mm) {
+        // mm only takes matrices, the batch of slices has one more dim
+        output = graph->insert(
+            aten::matmul,
+            {batchedValue(n->inputs().at(0)), batchedValue(n->inputs().at(1))});
+      } else {
+        output = graph->insertNode(graph->createClone(n, batchedValue))
+                     ->output();
+      }
+      output->setType(unshapedType(n->output()->type()));
+      batched[n->output()] = output;
+    }
+    Value* result = batched.at(append_->inputs().at(1));
+    result->setType(stack_->output()->type());
+    stack_->output()->replaceAllUsesWith(result);
+    stack_->destroy();
+    loop_->destroy();
+    list_construct_->destroy();
+  }
+
+  Node* stack() const {
+    return stack_;
+  }
+
+ private:
+  bool matchLoop() {
+    if (!isTrueConstant(loop_->inputs().at(1)) ||
+        !isTrueConstant(body_->outputs().at(0)) ||
+        !loop_->outputs().empty()) {
+      return false;
+    }
+    Node* size = loop_->inputs().at(0)->node();
+    if (!size->matches("aten::size(Tensor self, int dim) -> int") ||
+        !isConstantInt(size->inputs().at(1), 0)) {
+      return false;
+    }
+    input_ = size->inputs().at(0);
+    auto dim = dimOf(input_);
+    return dim && *dim >= 1;
+  }
+
+  bool isSlice(Node* n) {
+    return n->matches(
+               "aten::select(Tensor self, int dim, int index) -> Tensor") &&
+        n->inputs().at(0) == input_ && isConstantInt(n->inputs().at(1), 0) &&
+        n->inputs().at(2) == body_->inputs().at(0);
+  }
+
+  // The rank of the (per-iteration) output of a pointwise or matmul node, if
+  // it is made from slices of the input and applying it to the whole input
+  // computes the stacked outputs
+  c10::optional<size_t> sliceRank(Node* n) {
+    if (pointwiseOps().find(n)) {
+      c10::optional<size_t> rank;
+      std::vector<size_t> invariant_ranks;
+      for (Value* input : n->inputs()) {
+        auto it = slice_ranks_.find(input);
+        if (it != slice_ranks_.end()) {
+          // As the slices are batched along a new leading dim, they can't
+          // broadcast each other
+          if (rank && *rank != it->second) {
+            return c10::nullopt;
+          }
+          rank = it->second;
+        } else if (input->type()->isSubtypeOf(TensorType::get())) {
+          auto dim = dimOf(input);
+          if (!dim) {
+            return c10::nullopt;
+          }
+          invariant_ranks.push_back(*dim);
+        }
+      }
+      if (!rank) {
+        return c10::nullopt;
+      }
+      // The loop invariants of the same rank or less broadcast to the batch
+      // of slices the same way they broadcast to a single one
+      for (size_t invariant_rank : invariant_ranks) {
+        if (invariant_rank > *rank) {
+          return c10::nullopt;
+        }
+      }
+      return rank;
+    }
+    if (rowMatmulOps().find(n)) {
+      auto it = slice_ranks_.find(n->inputs().at(0));
+      if (it == slice_ranks_.end() || it->second == 0) {
+        return c10::nullopt;
+      }
+      for (size_t i = 1; i < n->inputs().size(); ++i) {
+        Value* input = n->inputs()[i];
+        if (slice_ranks_.count(input)) {
+          return c10::nullopt;
+        }
+        auto dim = dimOf(input);
+        if (input->type()->isSubtypeOf(TensorType::get()) &&
+            (!dim || *dim != (i == 1 ? 2 : 1))) {
+          return c10::nullopt;
+        }
+      }
+      return it->second;
+    }
+    return c10::nullopt;
+  }
+
+  bool matchBody() {
+    for (Node* n : body_->nodes()) {
+      if (n->kind() == prim::Constant) {
+        continue;
+      }
+      if (isSlice(n)) {
+        slice_ranks_[n->output()] = *dimOf(input_) - 1;
+        continue;
+      }
+      if (n->matches(
+              "aten::append(Tensor[](a!) self, Tensor(c -> *) el) -> Tensor[](a!)")) {
+        if (append_) {
+          return false;
+        }
+        append_ = n;
+        continue;
+      }
+      auto rank = sliceRank(n);
+      if (!rank) {
+        return false;
+      }
+      slice_ranks_[n->output()] = *rank;
+    }
+    // The loop counter can only be used to take the slices
+    for (const Use& use : body_->inputs().at(0)->uses()) {
+      if (!isSlice(use.user)) {
+        return false;
+      }
+    }
+    // A slice appended as is would be a view of the input, rather than a
+    // copy made by the loop
+    return append_ && slice_ranks_.count(append_->inputs().at(1)) &&
+        !isSlice(append_->inputs().at(1)->node());
+  }
+
+  // The list must be created empty before the loop and only stacked after
+  // it
+  bool matchList() {
+    Value* list = append_->inputs().at(0);
+    list_construct_ = list->node();
+    if (list_construct_->kind() != prim::ListConstruct ||
+        !list_construct_->inputs().empty() ||
+        list_construct_->owningBlock() != loop_->owningBlock()) {
+      return false;
+    }
+    for (const Use& use : list->uses()) {
+      if (use.user == append_) {
+        continue;
+      }
+      if (stack_ ||
+          !use.user->matches("aten::stack(Tensor[] tensors, int dim) -> Tensor") ||
+          !isConstantInt(use.user->inputs().at(1), 0) ||
+          use.user->owningBlock() != loop_->owningBlock() ||
+          !loop_->isBefore(use.user)) {
+        return false;
+      }
+      stack_ = use.user;
+    }
+    return stack_ != nullptr;
+  }
+
+  Node* loop_;
+  Block* body_;
+  Value* input_ = nullptr;
+  Node* append_ = nullptr;
+  Node* list_construct_ = nullptr;
+  Node* stack_ = nullptr;
+  std::unordered_map<Value*, size_t> slice_ranks_;
+};
+
+void VectorizeLoops(Block* block) {
+  for (auto it = block->nodes().begin(); it != block->nodes().end();) {
+    // The loop is destroyed when it is vectorized, and so is the stack of its
+    // results, which is after it
+    Node* node = *it;
+    ++it;
+    for (Block* subblock : node->blocks()) {
+      VectorizeLoops(subblock);
+    }
+    if (node->kind() != prim::Loop) {
+      continue;
+    }
+    LoopVectorizer vectorizer(node);
+    if (vectorizer.matches()) {
+      if (*it == vectorizer.stack()) {
+        ++it;
+      }
+      vectorizer.rewrite();
+    }
+  }
+}
+
+} // namespace
+
+void VectorizeLoops(std::shared_ptr<Graph>& graph) {
+  VectorizeLoops(graph->block());
+  EliminateDeadCode(graph);
+}
+
+} // namespace jit
+} // namespace torch
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <torch/csrc/jit/ir.h>
+
+namespace torch {
+namespace jit {
+
+// Rewrites loops that map a function over the first dim of a tensor and
+// stack the results:
+//
+//   out = []
+//   for i in range(x.size(0)):
+//       out.append(f(x[i]))
+//   y = torch.stack(out)
+//
+// into f applied once to the whole of x, when f is made of pointwise ops
+// and of matmuls of the slice with a loop-invariant matrix, so that they run
+// as one kernel rather than one per iteration. The dims of x and of the
+// loop-invariant tensors must be known. Needs to run before UnrollLoops.
+TORCH_API void VectorizeLoops(std::shared_ptr<Graph>& graph);
+
+} // namespace jit
+} // namespace torch
@@ -237,7 +237,7 @@ void Pickler::pushStorageOfTensor(const at::Tensor& tensor) {
     std::string(toString(tensor.scalar_type())).append("Storage");
   pushGlobal("torch", data_type);
   // root_key
-  pushString(c10::to_string(tensor_data_.size()));
+  pushString(c10::to_string(storage_tensors_.size()));
   // location
   pushString(tensor.device().str());
   // size
@@ -249,7 +249,11 @@ void Pickler::pushStorageOfTensor(const at::Tensor& tensor) {
 
   // TODO: Skip this if not writing tensors
   memoized_storage_map_[addr] = pushNextBinPut();
-  tensor_data_.push_back(getWriteableTensorData(tensor));
+  storage_tensors_.push_back(tensor);
+}
+
+std::vector<WriteableTensorData> Pickler::tensorData() const {
+  return fmap(storage_tensors_, getWriteableTensorData);
 }
 
 void Pickler::pushBytes(const std::string& string) {
@@ -143,8 +143,13 @@ class Pickler {
   void startTuple();
   void endTuple();
 
-  const std::vector<WriteableTensorData>& tensorData() {
-    return tensor_data_;
+  // The pickled storages, all copied to the CPU at once
+  std::vector<WriteableTensorData> tensorData() const;
+
+  // The tensors whose storages were pickled, in the order of their keys and
+  // on their original devices, so that writers can copy them one at a time
+  const std::vector<at::Tensor>& storageTensors() const {
+    return storage_tensors_;
   }
 
   void pushEmptyDict();
@@ -248,7 +253,7 @@ class Pickler {
 
   // List of tensor storages to serialize in the same binary as the pickle data
   // similar to ivalues, they are memoized using BINPUT
-  std::vector<WriteableTensorData> tensor_data_;
+  std::vector<at::Tensor> storage_tensors_;
   std::unordered_map<const void*, uint32_t> memoized_storage_map_;
 
   std::unordered_map<std::string, uint32_t> memoized_globals_map_;
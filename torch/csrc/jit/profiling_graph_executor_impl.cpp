@@ -8,8 +8,10 @@
 #include <torch/csrc/jit/passes/graph_fuser.h>
 #include <torch/csrc/jit/passes/guard_elimination.h>
 #include <torch/csrc/jit/passes/inline_autodiff_subgraphs.h>
+#include <torch/csrc/jit/passes/inplace_rewrite.h>
 #include <torch/csrc/jit/passes/insert_guards.h>
 #include <torch/csrc/jit/passes/lower_grad_of.h>
+#include <torch/csrc/jit/passes/memory_planning.h>
 #include <torch/csrc/jit/passes/remove_expands.h>
 #include <torch/csrc/jit/passes/requires_grad_analysis.h>
 #include <torch/csrc/jit/passes/shape_analysis.h>
@@ -26,6 +28,7 @@ static std::atomic<bool> profiling_mode{false};
 static std::atomic<bool> executor_mode{true};
 static std::atomic<bool> profiling_mode{true};
 #endif
+static std::atomic<size_t> num_profiled_runs{1};
 
 
 std::atomic<bool>& getProfilingMode() {
@@ -34,6 +37,9 @@ std::atomic<bool>& getProfilingMode() {
 std::atomic<bool>& getExecutorMode() {
   return executor_mode;
 }
+std::atomic<size_t>& getNumProfiledRuns() {
+  return num_profiled_runs;
+}
 
 static bool needsGradientInProfilingMode(Block* b) {
   for (auto n : b->nodes()) {
@@ -64,12 +70,19 @@ ProfilingGraphExecutorImpl::ProfilingGraphExecutorImpl(
     const std::shared_ptr<Graph>& graph)
     : GraphExecutorImplBase(graph) {}
 
+ProfilingGraphExecutorImpl::~ProfilingGraphExecutorImpl() {
+  waitForBackgroundCompiles();
+}
+
 ExecutionPlan ProfilingGraphExecutorImpl::getPlanFor(Stack& stack) {
-  std::lock_guard<std::mutex> lock(compile_mutex);
+  std::unique_lock<std::mutex> lock(compile_mutex);
   GRAPH_DEBUG("Running ProfilingGraphExecutorImpl ", this);
   if (optimized_plan_) {
     return *optimized_plan_;
   }
+  if (background_compile_) {
+    return getBackgroundPlan(lock);
+  }
 
   std::shared_ptr<Graph> copy;
   if (getProfilingMode()) {
@@ -99,6 +112,31 @@ ExecutionPlan ProfilingGraphExecutorImpl::getPlanFor(Stack& stack) {
     return *optimized_plan_;
   }
 
+  if (getNumBackgroundCompileCalls() > 0) {
+    background_compile_ =
+        compileInBackground([this, copy]() { return optimize(copy); });
+    return getBackgroundPlan(lock);
+  }
+  optimized_plan_ = optimize(copy);
+  return *optimized_plan_;
+}
+
+ExecutionPlan ProfilingGraphExecutorImpl::getBackgroundPlan(
+    std::unique_lock<std::mutex>& lock) {
+  if (auto plan = backgroundPlan(*background_compile_, lock)) {
+    optimized_plan_ = *plan;
+    return *optimized_plan_;
+  }
+  if (!fallback_plan_) {
+    auto copy = graph->copy();
+    runRequiredPasses(copy);
+    fallback_plan_ = ExecutionPlan(copy);
+  }
+  return *fallback_plan_;
+}
+
+ExecutionPlan ProfilingGraphExecutorImpl::optimize(
+    std::shared_ptr<Graph> copy) {
   InsertGuards(copy);
   LowerGradOf(*copy);
   if (getProfilingMode()) {
@@ -143,10 +181,14 @@ ExecutionPlan ProfilingGraphExecutorImpl::getPlanFor(Stack& stack) {
     runNondiffOptimization(copy);
   }
   EliminateDeadCode(copy);
+  if (!needs_gradient && getInplaceRewriteMode()) {
+    RewriteToInplaceOps(copy);
+  }
+  if (!needs_gradient && getMemoryPlanningMode()) {
+    PlanMemory(copy);
+  }
   GRAPH_DUMP("Optimized Graph : ", copy);
-  // cache
-  optimized_plan_ = ExecutionPlan(copy);
-  return *optimized_plan_;
+  return ExecutionPlan(copy);
 }
 
 
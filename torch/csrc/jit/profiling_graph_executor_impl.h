@@ -9,16 +9,24 @@ struct ProfilingGraphExecutorImpl : public GraphExecutorImplBase {
 
   ExecutionPlan getPlanFor(Stack& stack) override;
   GraphExecutorState getDebugState() override;
-  ~ProfilingGraphExecutorImpl() override = default;
+  ~ProfilingGraphExecutorImpl() override;
 
  private:
   std::shared_ptr<Graph> prepareGraph(
       const std::shared_ptr<Graph>& graph,
       Stack& stack);
+  // Runs the optimizations on the profiled `copy` of the graph
+  ExecutionPlan optimize(std::shared_ptr<Graph> copy);
+  // Returns the optimized plan once it compiled in the background, or
+  // fallback_plan_ until then
+  ExecutionPlan getBackgroundPlan(std::unique_lock<std::mutex>& lock);
   std::unique_ptr<ProfilingRecord> pr_;
   c10::optional<ExecutionPlan>
       profiling_plan_; // plan to run in order to profiling the code
   c10::optional<ExecutionPlan> optimized_plan_;
+  // the unoptimized plan that runs while optimized_plan_ compiles
+  c10::optional<ExecutionPlan> fallback_plan_;
+  std::shared_ptr<BackgroundCompile> background_compile_;
 };
 
 } // namespace jit
@@ -1,11 +1,17 @@
 #include <torch/csrc/jit/profiling_record.h>
+#include <torch/csrc/jit/graph_executor.h>
 #include <torch/csrc/jit/passes/constant_propagation.h>
 
+#include <algorithm>
+#include <map>
+
 namespace torch {
 namespace jit {
 
 ProfilingRecord::ProfilingRecord(std::shared_ptr<Graph> g)
-    : profiled_graph_(std::move(g)), profiling_count_(1) {}
+    : profiled_graph_(std::move(g)),
+      num_runs_(getNumProfiledRuns()),
+      profiling_count_(num_runs_) {}
 
 ProfileOp* ProfilingRecord::createProfileNode(
     const std::function<void(Stack&)>& fp,
@@ -60,6 +66,11 @@ void ProfilingRecord::insertShapeProfile(Node *n, Value *i) {
       if (t.toTensor().defined()) {
         auto pttp = TensorType::create(t.toTensor());
         std::lock_guard<std::mutex> lock(this->mutex_);
+        if (this->profiling_count_ > 0) {
+          this->observed_sizes_[pno].emplace_back(
+              this->num_runs_ - this->profiling_count_,
+              t.toTensor().sizes().vec());
+        }
         if (auto type = pno->type()->cast<TensorType>()) {
           if (!first) {
             pttp = pttp->merge(type);
@@ -100,6 +111,57 @@ void ProfilingRecord::instrumentBlock(Block *block) {
   }
 }
 
+// A dim that took different sizes across the profiled runs becomes a shape
+// symbol, and dims that took the same sizes as each other in every run share
+// their symbol. `attr::symbols` on a prim::profile (and on the prim::Guard and
+// prim::BailOut that replace it) holds the symbol of each dim, or -1 for the
+// dims that didn't vary. The interpreter binds a symbol to the size its first
+// guard sees, and the other guards on it check that their dims are equal to
+// it, e.g. the batch size of the inputs of `x + y` may change from a run to
+// the next, but x and y still have to agree on it.
+// Only the values profiled exactly once a run are generalized, the profiles
+// in loops and in conditionals can't be lined up across runs.
+void ProfilingRecord::assignShapeSymbols() {
+  std::map<std::vector<int64_t>, int64_t> symbols_of_histories;
+  for (const auto& observed : observed_sizes_) {
+    const auto& observations = observed.second;
+    if (observations.size() != num_runs_) {
+      continue;
+    }
+    const size_t rank = observations[0].second.size();
+    bool once_a_run = true;
+    for (size_t run = 0; run < num_runs_; run++) {
+      once_a_run &= observations[run].first == run &&
+          observations[run].second.size() == rank;
+    }
+    if (!once_a_run) {
+      continue;
+    }
+
+    std::vector<int64_t> symbols(rank, -1);
+    bool varies = false;
+    for (size_t d = 0; d < rank; d++) {
+      std::vector<int64_t> history;
+      for (const auto& observation : observations) {
+        history.push_back(observation.second[d]);
+      }
+      if (std::all_of(history.begin(), history.end(), [&](int64_t size) {
+            return size == history[0];
+          })) {
+        continue;
+      }
+      auto symbol = symbols_of_histories.emplace(
+          std::move(history), symbols_of_histories.size());
+      symbols[d] = symbol.first->second;
+      varies = true;
+    }
+    if (varies) {
+      observed.first->node()->is_(attr::symbols, std::move(symbols));
+    }
+  }
+  observed_sizes_.clear();
+}
+
 std::unique_ptr<ProfilingRecord> ProfilingRecord::instrumentGraph(
     const std::shared_ptr<Graph>& graph) {
   auto new_g = graph->copy();
@@ -119,6 +181,9 @@ std::unique_ptr<ProfilingRecord> ProfilingRecord::instrumentGraph(
     if (raw_pr->profiling_count_ > 0)
     {
         raw_pr->profiling_count_--;
+        if (raw_pr->profiling_count_ == 0) {
+          raw_pr->assignShapeSymbols();
+        }
     }
   };
 
@@ -8,6 +8,8 @@
 #include <torch/csrc/jit/ir.h>
 
 #include <list>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace torch {
@@ -27,6 +29,7 @@ struct ProfilingRecord {
 
   std::shared_ptr<Graph> profiled_graph_;
   std::mutex mutex_;
+  size_t num_runs_;
   size_t profiling_count_;
   bool ready() const {
     return profiling_count_ == 0;
@@ -40,7 +43,14 @@ struct ProfilingRecord {
       at::ArrayRef<Value*> inputs);
   void instrumentBlock(Block* block);
   void insertShapeProfile(Node *n, Value *i);
+  // Generalizes the dims of the profiled tensors that varied across runs
+  // into shape symbols, see `attr::symbols` in `assignShapeSymbols`
+  void assignShapeSymbols();
   ProfilingRecord(std::shared_ptr<Graph> g);
+
+  // The (run, sizes) observed by each prim::profile output
+  std::unordered_map<Value*, std::vector<std::pair<size_t, std::vector<int64_t>>>>
+      observed_sizes_;
 };
 
 } // namespace jit
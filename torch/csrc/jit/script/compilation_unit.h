@@ -93,7 +93,11 @@ struct TORCH_API CompilationUnit {
       // if non-null, the first argument to each def, is bound to this value
       const Self* self,
       // see [name mangling]
-      bool shouldMangle = false);
+      bool shouldMangle = false,
+      // if true, the functions but __init__ are compiled on first use, i.e.
+      // when they are called or their graph or schema is looked up, and self
+      // has to outlive them
+      bool lazy = false);
 
   // same as above but parse the definitions from source
   // Returns the list of Function's just defined.
@@ -239,7 +243,8 @@ struct TORCH_API CompilationUnit {
       const Def& def,
       const ResolverPtr& resolver,
       const Self* self,
-      const std::unordered_map<std::string, Function*>& function_table,
+      const std::shared_ptr<const std::unordered_map<std::string, Function*>>&
+          function_table,
       bool shouldMangle = false) const;
 
   Function& register_function(std::unique_ptr<Function> fn) {
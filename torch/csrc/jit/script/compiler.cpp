@@ -3231,18 +3231,22 @@ struct to_ir {
   }
 };
 
+// Holds on to the resolver and the function table, since lazily compiled
+// functions use them after CompilationUnit::define returns
 struct FunctionResolver : public Resolver {
   explicit FunctionResolver(
-      Resolver* otherResolver,
-      const std::unordered_map<std::string, Function*>& functionTable)
-      : otherResolver_(otherResolver), functionTable_(functionTable) {}
+      ResolverPtr otherResolver,
+      std::shared_ptr<const std::unordered_map<std::string, Function*>>
+          functionTable)
+      : otherResolver_(std::move(otherResolver)),
+        functionTable_(std::move(functionTable)) {}
 
   std::shared_ptr<SugaredValue> resolveValue(
       const std::string& name,
       Function& m,
       const SourceRange& loc) override {
-    auto it = functionTable_.find(name);
-    if (it != functionTable_.end()) {
+    auto it = functionTable_->find(name);
+    if (it != functionTable_->end()) {
       return std::make_shared<FunctionValue>(it->second);
     }
     return otherResolver_->resolveValue(name, m, loc);
@@ -3254,8 +3258,9 @@ struct FunctionResolver : public Resolver {
   }
 
  private:
-  Resolver* otherResolver_;
-  const std::unordered_map<std::string, Function*>& functionTable_;
+  ResolverPtr otherResolver_;
+  std::shared_ptr<const std::unordered_map<std::string, Function*>>
+      functionTable_;
 };
 
 CompilationUnit::CompilationUnit(const std::string& source)
@@ -3296,7 +3301,8 @@ std::unique_ptr<Function> CompilationUnit::define(
     const Def& def,
     const ResolverPtr& resolver,
     const Self* self,
-    const std::unordered_map<std::string, Function*>& function_table,
+    const std::shared_ptr<const std::unordered_map<std::string, Function*>>&
+        function_table,
     bool shouldMangle) const {
   TORCH_INTERNAL_ASSERT(resolver);
   auto _resolver = resolver;
@@ -3304,8 +3310,7 @@ std::unique_ptr<Function> CompilationUnit::define(
     // if self is defined, then these are methods and do not go into the
     // global namespace otherwise, they get defined together so we add them to
     // the function table so the methods can see each other
-    _resolver =
-        std::make_shared<FunctionResolver>(resolver.get(), function_table);
+    _resolver = std::make_shared<FunctionResolver>(resolver, function_table);
   }
   auto creator = [def, _resolver, self](Function& method) {
     // Store the function name so that it can be referenced if there is an error
@@ -3343,10 +3348,12 @@ std::vector<Function*> CompilationUnit::define(
     const std::vector<Def>& definitions,
     const std::vector<ResolverPtr>& resolvers,
     const Self* self,
-    bool shouldMangle) {
+    bool shouldMangle,
+    bool lazy) {
   TORCH_INTERNAL_ASSERT(definitions.size() == resolvers.size());
   std::vector<Function*> functions;
-  std::unordered_map<std::string, Function*> function_table;
+  auto function_table =
+      std::make_shared<std::unordered_map<std::string, Function*>>();
 
   for (size_t i = 0; i < definitions.size(); i++) {
     auto fn = define(
@@ -3357,7 +3364,7 @@ std::vector<Function*> CompilationUnit::define(
         function_table,
         shouldMangle);
     const auto& name = fn->name();
-    function_table[name] = fn.get();
+    (*function_table)[name] = fn.get();
     functions.push_back(fn.get());
     register_function(std::move(fn));
   }
@@ -3371,6 +3378,9 @@ std::vector<Function*> CompilationUnit::define(
     }
   }
 
+  if (lazy) {
+    return functions;
+  }
   for (Function* function : functions) {
     function->ensure_defined();
   }
@@ -10,6 +10,7 @@
 #include <torch/csrc/jit/testing/file_check.h>
 
 #include <torch/csrc/jit/constants.h>
+#include <torch/csrc/jit/export.h>
 #include <torch/csrc/jit/graph_executor.h>
 #include <torch/csrc/jit/hooks_for_testing.h>
 #include <torch/csrc/jit/import_source.h>
@@ -618,16 +619,27 @@ void initJitScriptBindings(PyObject* module) {
           "save",
           [](Module& m,
              const std::string& filename,
-             const ExtraFilesMap& _extra_files = ExtraFilesMap()) {
-            m.save(filename, _extra_files);
+             const ExtraFilesMap& _extra_files = ExtraFilesMap(),
+             size_t _num_shards = 1) {
+            pybind11::gil_scoped_release no_gil;
+            ExportModule(
+                m,
+                filename,
+                _extra_files,
+                /*bytecode_format=*/false,
+                _num_shards);
           },
           py::arg("filename"),
-          py::arg("_extra_files") = ExtraFilesMap())
+          py::arg("_extra_files") = ExtraFilesMap(),
+          py::arg("_num_shards") = 1)
       .def(
           "save_to_buffer",
           [](Module& m, const ExtraFilesMap& _extra_files = ExtraFilesMap()) {
             std::ostringstream buf;
-            m.save(buf, _extra_files);
+            {
+              pybind11::gil_scoped_release no_gil;
+              m.save(buf, _extra_files);
+            }
             return py::bytes(buf.str());
           },
           py::arg("_extra_files") = ExtraFilesMap())
@@ -765,6 +777,7 @@ void initJitScriptBindings(PyObject* module) {
             // be deleted.
             module.register_attribute("training", BoolType::get(), true);
             addFunctionToModule(module, self);
+            pybind11::gil_scoped_release no_gil;
             module.save(filename, _extra_files);
           },
           py::arg("filename"),
@@ -778,7 +791,10 @@ void initJitScriptBindings(PyObject* module) {
             // see [issue 27343]
             module.register_attribute("training", BoolType::get(), true);
             addFunctionToModule(module, self);
-            module.save(buf, _extra_files);
+            {
+              pybind11::gil_scoped_release no_gil;
+              module.save(buf, _extra_files);
+            }
             return py::bytes(buf.str());
           },
           py::arg("_extra_files") = ExtraFilesMap())
@@ -947,6 +963,9 @@ void initJitScriptBindings(PyObject* module) {
           optional_device =
               reinterpret_cast<THPDevice*>(map_location.ptr())->device;
         }
+        // `cu` is a new CompilationUnit of torch.jit.load, that no other
+        // thread compiles into while the GIL is released
+        pybind11::gil_scoped_release no_gil;
         return import_ir_module(
             std::move(cu), filename, optional_device, extra_files);
       });
@@ -963,6 +982,7 @@ void initJitScriptBindings(PyObject* module) {
           optional_device =
               reinterpret_cast<THPDevice*>(map_location.ptr())->device;
         }
+        pybind11::gil_scoped_release no_gil;
         return import_ir_module(
             std::move(cu), in, optional_device, extra_files);
       });
@@ -0,0 +1,128 @@
+#include <torch/csrc/jit/storage_writer.h>
+
+#include <torch/csrc/utils/memory.h>
+
+#include <algorithm>
+
+namespace torch {
+namespace jit {
+
+constexpr size_t StorageWriter::kDefaultMaxBytesInFlight;
+
+StorageWriter::StorageWriter(
+    std::vector<caffe2::serialize::PyTorchStreamWriter*> shards,
+    size_t max_bytes_in_flight)
+    : max_bytes_in_flight_(max_bytes_in_flight) {
+  TORCH_INTERNAL_ASSERT(!shards.empty());
+  for (auto writer : shards) {
+    auto shard = torch::make_unique<Shard>();
+    shard->writer = writer;
+    shards_.push_back(std::move(shard));
+  }
+  for (auto& shard : shards_) {
+    Shard* s = shard.get();
+    s->thread = std::thread([this, s]() { run(*s); });
+  }
+}
+
+StorageWriter::~StorageWriter() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    done_ = true;
+  }
+  cv_.notify_all();
+  for (auto& shard : shards_) {
+    shard->thread.join();
+  }
+}
+
+size_t StorageWriter::write(const std::string& name, const at::Tensor& tensor) {
+  const size_t host_bytes =
+      tensor.storage().device_type() == at::DeviceType::CPU
+      ? 0
+      : tensor.element_size() * tensor.storage().size();
+  {
+    // A storage larger than the bound waits for the queues to drain
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [&] {
+      return error_ || bytes_in_flight_ == 0 ||
+          bytes_in_flight_ + host_bytes <= max_bytes_in_flight_;
+    });
+    if (error_) {
+      std::rethrow_exception(error_);
+    }
+    bytes_in_flight_ += host_bytes;
+  }
+
+  // The copy to the host runs outside of the lock, while the shards write
+  c10::optional<WriteableTensorData> data;
+  try {
+    data = getWriteableTensorData(tensor);
+  } catch (...) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    bytes_in_flight_ -= host_bytes;
+    cv_.notify_all();
+    throw;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = std::min_element(
+      shards_.begin(),
+      shards_.end(),
+      [](const std::unique_ptr<Shard>& a, const std::unique_ptr<Shard>& b) {
+        return a->bytes < b->bytes;
+      });
+  Shard& shard = **it;
+  shard.bytes += data->sizeInBytes();
+  shard.queue.push_back(Record{name, std::move(*data), host_bytes});
+  pending_++;
+  cv_.notify_all();
+  return it - shards_.begin();
+}
+
+void StorageWriter::run(Shard& shard) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    cv_.wait(lock, [&] { return done_ || !shard.queue.empty(); });
+    if (shard.queue.empty()) {
+      return;
+    }
+    size_t host_bytes = shard.queue.front().host_bytes;
+    {
+      // The record, and its host copy, are freed before more copies are let
+      // in
+      Record record = std::move(shard.queue.front());
+      shard.queue.pop_front();
+      if (!error_) {
+        lock.unlock();
+        std::exception_ptr error;
+        try {
+          shard.writer->writeRecord(
+              record.name, record.data.data(), record.data.sizeInBytes());
+        } catch (...) {
+          error = std::current_exception();
+        }
+        lock.lock();
+        if (error && !error_) {
+          error_ = error;
+        }
+      }
+    }
+    bytes_in_flight_ -= host_bytes;
+    pending_--;
+    cv_.notify_all();
+  }
+}
+
+void StorageWriter::finish() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  cv_.wait(lock, [&] { return pending_ == 0; });
+  if (error_) {
+    auto error = error_;
+    error_ = nullptr;
+    std::rethrow_exception(error);
+  }
+}
+
+} // namespace jit
+} // namespace torch
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <ATen/core/Tensor.h>
+#include <caffe2/serialize/inline_container.h>
+#include <torch/csrc/WindowsTorchApiMacro.h>
+#include <torch/csrc/jit/pickler.h>
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace torch {
+namespace jit {
+
+// Writes the storages of pickled tensors (see Pickler::storageTensors) as
+// records of one or more archives, the shards, one storage at a time. The
+// calling thread copies each storage to the host while a thread per shard
+// writes the previous ones, which is where miniz computes their CRC-32, so the
+// copies, checksums and writes of different storages overlap and the writes
+// to different shards run in parallel.
+//
+// The host copies waiting to be written are bounded by max_bytes_in_flight,
+// so saving GPU tensors doesn't hold host memory for all of them at once.
+// Storages already on the CPU are written in place.
+class TORCH_API StorageWriter {
+ public:
+  static constexpr size_t kDefaultMaxBytesInFlight = 256 << 20;
+
+  explicit StorageWriter(
+      std::vector<caffe2::serialize::PyTorchStreamWriter*> shards,
+      size_t max_bytes_in_flight = kDefaultMaxBytesInFlight);
+  // Waits for the writes, dropping their errors; call finish() to see them
+  ~StorageWriter();
+
+  StorageWriter(const StorageWriter&) = delete;
+  StorageWriter& operator=(const StorageWriter&) = delete;
+
+  // Queues the storage of tensor as the record name of the shard with the
+  // fewest bytes so far, blocking while too many bytes are in flight. Returns
+  // the index of the shard.
+  size_t write(const std::string& name, const at::Tensor& tensor);
+
+  // Waits for the queued records to be written, rethrowing the first error
+  void finish();
+
+ private:
+  struct Record {
+    std::string name;
+    WriteableTensorData data;
+    // The bytes copied to the host, which count towards max_bytes_in_flight
+    size_t host_bytes;
+  };
+  struct Shard {
+    caffe2::serialize::PyTorchStreamWriter* writer;
+    std::deque<Record> queue;
+    size_t bytes = 0;
+    std::thread thread;
+  };
+
+  void run(Shard& shard);
+
+  std::vector<std::unique_ptr<Shard>> shards_;
+  size_t max_bytes_in_flight_;
+  size_t bytes_in_flight_ = 0;
+  // The records queued or being written
+  size_t pending_ = 0;
+  bool done_ = false;
+  std::exception_ptr error_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+};
+
+} // namespace jit
+} // namespace torch
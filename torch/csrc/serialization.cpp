@@ -3,6 +3,7 @@
 
 #include <torch/csrc/THP.h>
 #include <torch/csrc/serialization.h>
+#include <torch/csrc/utils/auto_gil.h>
 
 template <class io>
 ssize_t doPartialRead(io fildes, void* buf, size_t nbytes);
@@ -14,8 +15,11 @@ static ssize_t doPartialPythonReadBuffered(PyObject* fildes, void* buf, size_t n
 static ssize_t doPartialPythonReadInto(PyObject* fildes, void* buf, size_t nbytes);
 static ssize_t doPartialPythonWrite(PyObject* fildes, void* buf, size_t nbytes);
 
+// Reading and writing file descriptors don't touch Python objects, so they
+// release the GIL, not to stall other threads while loading or saving.
 template <>
 ssize_t doPartialRead<int>(int fildes, void* buf, size_t nbytes) {
+  AutoNoGIL no_gil;
   return read(fildes, buf, nbytes);
 }
 
@@ -33,6 +37,7 @@ ssize_t doPartialRead<PyObject*>(PyObject* fildes, void* buf, size_t nbytes) {
 
 template <>
 ssize_t doPartialWrite<int>(int fildes, void* buf, size_t nbytes) {
+  AutoNoGIL no_gil;
   return write(fildes, buf, nbytes);
 }
 
@@ -132,10 +132,24 @@ FunctionParameter::FunctionParameter(const std::string& fmt, bool keyword_only)
   }
 }
 
+// THPVariable_Check goes through PyObject_IsInstance, which is slow for the
+// common cases of an exact Tensor and of a builtin number or sequence, so
+// these are decided from the type of `obj` first.
+static inline bool is_variable(PyObject* obj) {
+  if (THPVariable_CheckExact(obj)) {
+    return true;
+  }
+  if (obj == Py_None || PyFloat_CheckExact(obj) || PyLong_CheckExact(obj) ||
+      PyTuple_CheckExact(obj) || PyList_CheckExact(obj)) {
+    return false;
+  }
+  return THPVariable_Check(obj);
+}
+
 bool FunctionParameter::check(PyObject* obj) {
   switch (type_) {
     case ParameterType::TENSOR: {
-      return THPVariable_Check(obj) || (allow_numbers_as_tensors && THPUtils_checkScalar(obj));
+      return is_variable(obj) || (allow_numbers_as_tensors && THPUtils_checkScalar(obj));
     }
     case ParameterType::SCALAR:
     case ParameterType::COMPLEX:
@@ -144,10 +158,17 @@ bool FunctionParameter::check(PyObject* obj) {
       }
       // fallthrough
     case ParameterType::DOUBLE: {
+      if (PyFloat_CheckExact(obj)) {
+        return true;
+      }
+      if (THPVariable_CheckExact(obj)) {
+        auto& var = ((THPVariable*)obj)->cdata;
+        return !var.requires_grad() && var.dim() == 0;
+      }
       if (THPUtils_checkDouble(obj)) {
         return true;
       }
-      if (THPVariable_Check(obj)) {
+      if (is_variable(obj)) {
         auto& var = ((THPVariable*)obj)->cdata;
         return !var.requires_grad() && var.dim() == 0;
       }
@@ -157,7 +178,7 @@ bool FunctionParameter::check(PyObject* obj) {
       if (THPUtils_checkLong(obj)) {
         return true;
       }
-      if (THPVariable_Check(obj)) {
+      if (is_variable(obj)) {
         auto& var = ((THPVariable*)obj)->cdata;
         return at::isIntegralType(var.scalar_type(), /*includeBool=*/false) && !var.requires_grad() && var.dim() == 0;
       }
@@ -325,6 +346,7 @@ FunctionSignature::FunctionSignature(const std::string& fmt)
   : min_args(0)
   , max_args(0)
   , max_pos_args(0)
+  , allow_varargs_intlist(false)
   , hidden(false)
   , deprecated(false)
 {
@@ -385,6 +407,10 @@ FunctionSignature::FunctionSignature(const std::string& fmt)
       max_pos_args++;
     }
   }
+
+  // if there is a single positional IntArrayRef argument, i.e. expand(..), view(...),
+  // allow a var-args style IntArrayRef, so expand(5,3) behaves as expand((5,3))
+  allow_varargs_intlist = max_pos_args == 1 && params[0].type_ == ParameterType::INT_LIST;
 }
 
 std::string FunctionSignature::toString() const {
@@ -484,13 +510,6 @@ bool FunctionSignature::parse(PyObject* args, PyObject* kwargs, PyObject* dst[],
   auto nargs = PyTuple_GET_SIZE(args);
   ssize_t remaining_kwargs = kwargs ? PyDict_Size(kwargs) : 0;
   ssize_t arg_pos = 0;
-  bool allow_varargs_intlist = false;
-
-  // if there is a single positional IntArrayRef argument, i.e. expand(..), view(...),
-  // allow a var-args style IntArrayRef, so expand(5,3) behaves as expand((5,3))
-  if (max_pos_args == 1 && params[0].type_ == ParameterType::INT_LIST) {
-    allow_varargs_intlist = true;
-  }
 
   if (nargs > max_pos_args && !allow_varargs_intlist) {
     if (raise_exception) {
@@ -499,6 +518,14 @@ bool FunctionSignature::parse(PyObject* args, PyObject* kwargs, PyObject* dst[],
     }
     return false;
   }
+  if (!raise_exception && nargs + remaining_kwargs < min_args) {
+    // some required argument is missing, no need to check the others
+    return false;
+  }
+  if (remaining_kwargs == 0) {
+    // skip the keyword lookups of the parameters not given by position
+    kwargs = nullptr;
+  }
 
   int i = 0;
   for (auto& param : params) {
@@ -179,6 +179,7 @@ struct FunctionSignature {
   ssize_t min_args;
   ssize_t max_args;
   ssize_t max_pos_args;
+  bool allow_varargs_intlist;
   bool hidden;
   bool deprecated;
 };
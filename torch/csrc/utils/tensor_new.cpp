@@ -23,6 +23,7 @@
 #include <ATen/core/EnableNamedTensor.h>
 
 #include <stdexcept>
+#include <type_traits>
 #include <vector>
 
 using at::Backend;
@@ -223,6 +224,83 @@ void recursive_store(char* data, IntArrayRef sizes, IntArrayRef strides, int64_t
   }
 }
 
+// Stores the leaves of `obj`, lists or tuples nested to the given `sizes`,
+// into the contiguous `data`, in a single pass over `obj`. Returns false if
+// some leaf is not an exact Python float or int (an int for integral `T`), or
+// some sequence is not a list or a tuple of the expected length, leaving them
+// to `recursive_store`.
+template <typename T>
+bool store_homogeneous(T*& data, IntArrayRef sizes, int64_t dim, PyObject* obj) {
+  if (dim == (int64_t)sizes.size()) {
+    if (std::is_floating_point<T>::value && PyFloat_CheckExact(obj)) {
+      *data++ = static_cast<T>(PyFloat_AS_DOUBLE(obj));
+    } else if (PyLong_CheckExact(obj)) {
+      *data++ = std::is_floating_point<T>::value
+          ? static_cast<T>(THPUtils_unpackDouble(obj))
+          : static_cast<T>(THPUtils_unpackLong(obj));
+    } else {
+      return false;
+    }
+    return true;
+  }
+  if (!PyList_CheckExact(obj) && !PyTuple_CheckExact(obj)) {
+    return false;
+  }
+  auto n = PySequence_Fast_GET_SIZE(obj);
+  if (n != sizes[dim]) {
+    return false;
+  }
+  PyObject** items = PySequence_Fast_ITEMS(obj);
+  for (Py_ssize_t i = 0; i < n; i++) {
+    if (!store_homogeneous(data, sizes, dim + 1, items[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// The type a list of Python numbers is stored as by `store_homogeneous`, from
+// the first of them: the default type for a float, and long for an int, as
+// `infer_scalar_type` would if all of them were of the same type.
+c10::optional<ScalarType> homogeneous_scalar_type(PyObject* obj, int64_t ndim) {
+  for (int64_t dim = 0; dim < ndim; dim++) {
+    if (!PyList_CheckExact(obj) && !PyTuple_CheckExact(obj)) {
+      return c10::nullopt;
+    }
+    if (PySequence_Fast_GET_SIZE(obj) == 0) {
+      return c10::nullopt;
+    }
+    obj = PySequence_Fast_GET_ITEM(obj, 0);
+  }
+  if (PyFloat_CheckExact(obj)) {
+    return torch::tensors::get_default_scalar_type();
+  }
+  if (PyLong_CheckExact(obj)) {
+    return ScalarType::Long;
+  }
+  return c10::nullopt;
+}
+
+// Fills `tensor` from the nested list `data` with `store_homogeneous`.
+bool try_store_homogeneous(Tensor& tensor, PyObject* data) {
+  switch (tensor.scalar_type()) {
+    case ScalarType::Float: {
+      auto ptr = tensor.data_ptr<float>();
+      return store_homogeneous(ptr, tensor.sizes(), 0, data);
+    }
+    case ScalarType::Double: {
+      auto ptr = tensor.data_ptr<double>();
+      return store_homogeneous(ptr, tensor.sizes(), 0, data);
+    }
+    case ScalarType::Long: {
+      auto ptr = tensor.data_ptr<int64_t>();
+      return store_homogeneous(ptr, tensor.sizes(), 0, data);
+    }
+    default:
+      return false;
+  }
+}
+
 Tensor internal_new_from_data(
     c10::TensorTypeId type_id,
     at::ScalarType scalar_type,
@@ -272,10 +350,28 @@ Tensor internal_new_from_data(
     maybe_initialize_cuda(device);
     return tensor.to(device, inferred_scalar_type, /*non_blocking=*/false, /*copy=*/copy_numpy);
   }
+
+  // memoryviews, array.arrays and other objects sharing their memory through
+  // the buffer protocol or __array_interface__
+  auto array_like = tensor_from_array_like(data);
+  if (array_like.defined()) {
+    TORCH_CHECK(!pin_memory, "Can't pin tensor constructed from an array-like object");
+    const auto& inferred_scalar_type = type_inference ? array_like.scalar_type() : scalar_type;
+    auto device = device_opt.has_value() ? *device_opt : at::Device(computeDeviceType(type_id));
+    AutoNoGIL no_gil;
+    maybe_initialize_cuda(device);
+    return array_like.to(device, inferred_scalar_type, /*non_blocking=*/false, /*copy=*/copy_numpy);
+  }
 #endif
 
   auto sizes = compute_sizes(data);
-  ScalarType inferred_scalar_type = type_inference ? infer_scalar_type(data) : scalar_type;
+  // Lists of Python floats or ints are stored in a single pass, and their type
+  // is only inferred by walking them if that fails.
+  auto homogeneous_type = type_inference
+      ? homogeneous_scalar_type(data, sizes.size())
+      : c10::optional<ScalarType>(scalar_type);
+  ScalarType inferred_scalar_type =
+      homogeneous_type ? *homogeneous_type : infer_scalar_type(data);
   // This exists to prevent us from tracing the call to empty().  The actual
   // autograd code doesn't really matter, because requires_grad is always false
   // here.
@@ -283,9 +379,18 @@ Tensor internal_new_from_data(
   {
     at::AutoNonVariableTypeMode guard;
     tensor = at::empty(sizes, at::initialTensorOptions().dtype(inferred_scalar_type).pinned_memory(pin_memory));
-    recursive_store(
-        (char*)tensor.data_ptr(), tensor.sizes(), tensor.strides(), 0,
-        inferred_scalar_type, tensor.dtype().itemsize(), data);
+    if (!try_store_homogeneous(tensor, data)) {
+      if (type_inference && homogeneous_type) {
+        // the first number is not of the type of all of them
+        inferred_scalar_type = infer_scalar_type(data);
+        if (inferred_scalar_type != tensor.scalar_type()) {
+          tensor = at::empty(sizes, at::initialTensorOptions().dtype(inferred_scalar_type).pinned_memory(pin_memory));
+        }
+      }
+      recursive_store(
+          (char*)tensor.data_ptr(), tensor.sizes(), tensor.strides(), 0,
+          inferred_scalar_type, tensor.dtype().itemsize(), data);
+    }
   }
   auto device = device_opt.has_value() ? *device_opt : at::Device(computeDeviceType(type_id));
   AutoNoGIL no_gil;
@@ -16,6 +16,9 @@ bool is_numpy_scalar(PyObject* obj) {
 at::Tensor tensor_from_cuda_array_interface(PyObject* obj) {
     throw std::runtime_error("PyTorch was compiled without NumPy support");
 }
+at::Tensor tensor_from_array_like(PyObject* obj) {
+  return at::Tensor();
+}
 }}
 #else
 
@@ -23,9 +26,11 @@ at::Tensor tensor_from_cuda_array_interface(PyObject* obj) {
 #include <torch/csrc/Exceptions.h>
 #include <torch/csrc/autograd/python_variable.h>
 #include <torch/csrc/utils/object_ptr.h>
+#include <torch/csrc/utils/python_strings.h>
 
 #include <ATen/ATen.h>
 #include <ATen/TensorUtils.h>
+#include <c10/core/impl/COW.h>
 #include <memory>
 #include <sstream>
 #include <stdexcept>
@@ -89,6 +94,9 @@ PyObject* tensor_to_numpy(const at::Tensor& tensor) {
         "Can't call numpy() on Variable that requires grad. "
         "Use var.detach().numpy() instead.");
   }
+  // The array can write to the tensor without going through its ops, see
+  // Note [Copy-on-write storages] in c10/core/impl/COW.h
+  c10::impl::cow::materialize_if_cow(*tensor.storage().unsafeGetStorageImpl());
   auto dtype = aten_to_numpy_dtype(tensor.scalar_type());
   auto sizes = to_numpy_shape(tensor.sizes());
   auto strides = to_numpy_shape(tensor.strides());
@@ -227,6 +235,27 @@ ScalarType numpy_dtype_to_aten(int dtype) {
       ((PyTypeObject*)pytype.get())->tp_name);
 }
 
+at::Tensor tensor_from_array_like(PyObject* obj) {
+  // bytes and bytearray are sequences of ints, and are kept as such, and
+  // looking up __array_interface__ on lists would only slow them down
+  if (PyList_CheckExact(obj) || PyTuple_CheckExact(obj) || PyArray_Check(obj) ||
+      PyBytes_Check(obj) || PyByteArray_Check(obj) || THPUtils_checkString(obj)) {
+    return at::Tensor();
+  }
+  if (!PyObject_CheckBuffer(obj) && !PyObject_HasAttrString(obj, "__array_interface__")) {
+    return at::Tensor();
+  }
+  // NumPy views the memory of the object, and the array keeps it alive
+  auto array = THPObjectPtr(PyArray_FromAny(obj, nullptr, 0, 0, 0, nullptr));
+  if (!array) throw python_error();
+  auto tensor = tensor_from_numpy(array.get());
+  if (!PyArray_ISWRITEABLE((PyArrayObject*)array.get())) {
+    // don't hand out writable views of read-only memory
+    tensor = tensor.clone();
+  }
+  return tensor;
+}
+
 bool is_numpy_scalar(PyObject* obj) {
   return (PyArray_IsIntegerScalar(obj) ||
           PyArray_IsScalar(obj, Floating));
@@ -15,4 +15,10 @@ bool is_numpy_scalar(PyObject* obj);
 
 at::Tensor tensor_from_cuda_array_interface(PyObject* obj);
 
+// Returns a tensor sharing the memory of an object supporting the buffer
+// protocol or `__array_interface__`, other than an np.ndarray, bytes or a
+// string, or an undefined tensor for any other object. Read-only memory is
+// copied.
+at::Tensor tensor_from_array_like(PyObject* obj);
+
 }} // namespace torch::utils
@@ -1,5 +1,9 @@
 #pragma once
 
+#include <algorithm>
+#include <cmath>
+#include <ctime>
+#include <numeric>
 #include <random>
 #include <thread>
 
@@ -10,6 +14,37 @@ namespace torch {
 namespace throughput_benchmark {
 namespace detail {
 
+// CPU time of the calling thread, or -1 where it can't be measured
+inline double threadCpuTimeMs() {
+#ifdef _WIN32
+  return -1;
+#else
+  struct timespec ts;
+  if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) != 0) {
+    return -1;
+  }
+  return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000.0 / 1000.0;
+#endif
+}
+
+inline float percentile(const std::vector<float>& sorted, double p) {
+  if (sorted.empty()) {
+    return -1;
+  }
+  const auto rank = static_cast<size_t>(std::ceil(p * sorted.size()));
+  return sorted[std::min(std::max(rank, size_t{1}), sorted.size()) - 1];
+}
+
+template <class Input, class Output, class Model>
+void BenchmarkHelper<Input, Output, Model>::runBatch(
+    std::vector<Input>&& inputs) const {
+  if (inputs.size() == 1) {
+    runOnce(std::move(inputs.front()));
+  } else {
+    runOnce(batchInputs(std::move(inputs)));
+  }
+}
+
 template <class Input, class Output, class Model>
 BenchmarkExecutionStats BenchmarkHelper<Input, Output, Model>::benchmark(
     const BenchmarkConfig& config) const {
@@ -17,12 +52,26 @@ BenchmarkExecutionStats BenchmarkHelper<Input, Output, Model>::benchmark(
   TORCH_CHECK(
       config.num_worker_threads == 1,
       "Only parallelization by callers is supported");
+  TORCH_CHECK(config.max_batch_size >= 1, "max_batch_size must be positive");
+  const bool open_loop = config.target_qps > 0;
+  const int64_t batch_size = config.max_batch_size;
+
+  using Clock = std::chrono::high_resolution_clock;
+  using TimePoint = std::chrono::time_point<Clock>;
+  auto to_ms = [](Clock::duration d) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(d).count() /
+        1000.0 / 1000.0;
+  };
 
   // We pre-generate inputs here for each of the threads. This allows us to
   // safely move inputs out for each of the threads independently and thus avoid
   // overhead from the benchmark runner itself
   std::vector<std::vector<Input>> thread_inputs(config.num_calling_threads);
   std::vector<size_t> input_iters(config.num_calling_threads);
+  // In the open-loop mode the requests are shared by the threads, and arrive
+  // at the given times from the start of the measurement
+  std::vector<Input> requests;
+  std::vector<Clock::duration> arrivals;
   {
     std::random_device seeder;
     std::mt19937 engine(seeder());
@@ -32,16 +81,39 @@ BenchmarkExecutionStats BenchmarkHelper<Input, Output, Model>::benchmark(
         "Did you forget to call add_input()? ");
     std::uniform_int_distribution<int> dist(0, inputs_.size() - 1);
 
+    // Just in case we generate num_iters inputs for each of the threads in the
+    // closed-loop mode. This was if one thread does all the work we will be
+    // fine
+    const int64_t num_thread_inputs = config.num_warmup_iters * batch_size +
+        (open_loop ? 0 : config.num_iters);
     for (int thread_id = 0; thread_id < config.num_calling_threads;
          ++thread_id) {
-      // Just in case we generate num_iters inputs for each of the threads
-      // This was if one thread does all the work we will be fine
-      for (int i = 0; i < config.num_iters + config.num_warmup_iters; ++i) {
+      for (int64_t i = 0; i < num_thread_inputs; ++i) {
         thread_inputs[thread_id].push_back(cloneInput(inputs_[dist(engine)]));
       }
       input_iters[thread_id] = 0;
     }
+    if (open_loop) {
+      std::exponential_distribution<double> interarrival_s(config.target_qps);
+      double arrival_s = 0;
+      for (int64_t i = 0; i < config.num_iters; ++i) {
+        requests.push_back(cloneInput(inputs_[dist(engine)]));
+        arrival_s += interarrival_s(engine);
+        arrivals.push_back(std::chrono::duration_cast<Clock::duration>(
+            std::chrono::duration<double>(arrival_s)));
+      }
+    }
   }
+  auto take_inputs = [&](int thread_id, int64_t n) {
+    std::vector<Input> batch;
+    batch.reserve(n);
+    for (int64_t i = 0; i < n; ++i) {
+      batch.push_back(
+          std::move(thread_inputs[thread_id][input_iters[thread_id]]));
+      ++input_iters[thread_id];
+    }
+    return batch;
+  };
 
   std::mutex m;
   std::condition_variable worker_main_cv;
@@ -50,7 +122,15 @@ BenchmarkExecutionStats BenchmarkHelper<Input, Output, Model>::benchmark(
   int64_t initialized{0};
   int64_t finished{0};
   bool start{false};
+  TimePoint start_time;
   std::atomic<int64_t> num_attempted_iters{0};
+  // Held by the free calling thread that takes the next request in the
+  // open-loop mode
+  std::mutex dispatch_mutex;
+  int64_t next_request{0};
+  std::vector<std::vector<float>> thread_latencies_ms(
+      config.num_calling_threads);
+  std::vector<float> thread_cpu_time_ms(config.num_calling_threads, -1);
   std::vector<std::thread> callers;
 
   for (auto thread_id = 0; thread_id < config.num_calling_threads;
@@ -59,8 +139,7 @@ BenchmarkExecutionStats BenchmarkHelper<Input, Output, Model>::benchmark(
       // We use conditional variable as a barrier to make sure each thread
       // performs required warmeup iterations before we start measuring
       for (auto j = 0; j < config.num_warmup_iters; ++j) {
-        runOnce(std::move(thread_inputs[thread_id][input_iters[thread_id]]));
-        ++input_iters[thread_id];
+        runBatch(take_inputs(thread_id, batch_size));
       }
       {
         std::unique_lock<std::mutex> lock(m);
@@ -71,9 +150,49 @@ BenchmarkExecutionStats BenchmarkHelper<Input, Output, Model>::benchmark(
         }
       }
       LOG(INFO) << "Starting forward thread " << thread_id;
-      while (num_attempted_iters.fetch_add(1) < config.num_iters) {
-        runOnce(std::move(thread_inputs[thread_id][input_iters[thread_id]]));
-        ++input_iters[thread_id];
+      auto& latencies_ms = thread_latencies_ms[thread_id];
+      const double cpu_start_ms = threadCpuTimeMs();
+      if (open_loop) {
+        while (true) {
+          std::vector<Input> batch;
+          std::vector<TimePoint> batch_arrivals;
+          {
+            // Wait for the next request, and take it along with the ones
+            // that arrived in the meantime
+            std::lock_guard<std::mutex> guard(dispatch_mutex);
+            if (next_request >= config.num_iters) {
+              break;
+            }
+            std::this_thread::sleep_until(start_time + arrivals[next_request]);
+            const auto now = Clock::now();
+            do {
+              batch.push_back(std::move(requests[next_request]));
+              batch_arrivals.push_back(start_time + arrivals[next_request]);
+              ++next_request;
+            } while (next_request < config.num_iters &&
+                     static_cast<int64_t>(batch.size()) < batch_size &&
+                     start_time + arrivals[next_request] <= now);
+          }
+          runBatch(std::move(batch));
+          const auto end = Clock::now();
+          for (const auto& arrival : batch_arrivals) {
+            latencies_ms.push_back(to_ms(end - arrival));
+          }
+        }
+      } else {
+        int64_t first;
+        while ((first = num_attempted_iters.fetch_add(batch_size)) <
+               config.num_iters) {
+          const auto n = std::min(batch_size, config.num_iters - first);
+          const auto call_start = Clock::now();
+          runBatch(take_inputs(thread_id, n));
+          const float latency_ms = to_ms(Clock::now() - call_start);
+          latencies_ms.insert(latencies_ms.end(), n, latency_ms);
+        }
+      }
+      const double cpu_end_ms = threadCpuTimeMs();
+      if (cpu_start_ms >= 0 && cpu_end_ms >= 0) {
+        thread_cpu_time_ms[thread_id] = cpu_end_ms - cpu_start_ms;
       }
 
       {
@@ -87,10 +206,6 @@ BenchmarkExecutionStats BenchmarkHelper<Input, Output, Model>::benchmark(
     });
   }
 
-  using Clock = std::chrono::high_resolution_clock;
-  using TimePoint = std::chrono::time_point<Clock>;
-  TimePoint start_time;
-
   {
     std::unique_lock<std::mutex> lock(m);
     while (initialized != config.num_calling_threads) {
@@ -107,24 +222,39 @@ BenchmarkExecutionStats BenchmarkHelper<Input, Output, Model>::benchmark(
     worker_main_cv.wait(
         lock, [&]() { return finished == config.num_calling_threads; });
   }
-  auto end_time = std::chrono::high_resolution_clock::now();
+  auto end_time = Clock::now();
   LOG(INFO) << "Finished benchmark";
 
-  BenchmarkExecutionStats stats;
-  float total_time_ms = std::chrono::duration_cast<std::chrono::nanoseconds>(
-                            end_time - start_time)
-                            .count() /
-      1000.0 / 1000.0;
-  // We use config.num_iters instead of num_attempted_iters as it is
-  // repsesatative of the real work done. Last attempted iteration on each
-  // calling threads doesn't represent the real work (i.e. running the model)
-  stats.latency_avg_ms =
-      total_time_ms * config.num_calling_threads / config.num_iters;
-  stats.num_iters = config.num_iters;
-
   for (auto& t : callers) {
     t.join();
   }
+
+  BenchmarkExecutionStats stats;
+  stats.total_time_ms = to_ms(end_time - start_time);
+  for (const auto& latencies_ms : thread_latencies_ms) {
+    stats.latencies_ms.insert(
+        stats.latencies_ms.end(), latencies_ms.begin(), latencies_ms.end());
+  }
+  if (open_loop) {
+    stats.latency_avg_ms =
+        std::accumulate(
+            stats.latencies_ms.begin(), stats.latencies_ms.end(), 0.0) /
+        config.num_iters;
+  } else {
+    // We use config.num_iters instead of num_attempted_iters as it is
+    // repsesatative of the real work done. Last attempted iteration on each
+    // calling threads doesn't represent the real work (i.e. running the model)
+    stats.latency_avg_ms =
+        stats.total_time_ms * config.num_calling_threads / config.num_iters;
+  }
+  stats.num_iters = config.num_iters;
+  std::vector<float> sorted_latencies_ms = stats.latencies_ms;
+  std::sort(sorted_latencies_ms.begin(), sorted_latencies_ms.end());
+  stats.latency_p50_ms = percentile(sorted_latencies_ms, 0.5);
+  stats.latency_p90_ms = percentile(sorted_latencies_ms, 0.9);
+  stats.latency_p99_ms = percentile(sorted_latencies_ms, 0.99);
+  stats.latency_p999_ms = percentile(sorted_latencies_ms, 0.999);
+  stats.thread_cpu_time_ms = std::move(thread_cpu_time_ms);
   return stats;
 }
 
@@ -49,6 +49,9 @@ BenchmarkExecutionStats ThroughputBenchmark::benchmark(
     return script_module_.benchmark(config);
   } else {
     CHECK(module_.initialized());
+    TORCH_CHECK(
+        config.max_batch_size == 1,
+        "Request batching is only supported for ScriptModule");
     TORCH_WARN("Starting benchmark on an nn.Module. This can be slow due "
     "to Python GIL.For proper inference simulation you might want to switch to "
     "a ScriptModule instead");
@@ -123,6 +126,38 @@ ScriptModuleInput cloneInput<ScriptModuleInput>(
   return input;
 }
 
+template <>
+ModuleInput batchInputs<ModuleInput>(std::vector<ModuleInput>&& inputs) {
+  TORCH_CHECK(
+      inputs.size() == 1,
+      "Request batching is only supported for ScriptModule");
+  return std::move(inputs.front());
+}
+
+template <>
+ScriptModuleInput batchInputs<ScriptModuleInput>(
+    std::vector<ScriptModuleInput>&& inputs) {
+  ScriptModuleInput batch = std::move(inputs.front());
+  for (size_t i = 0; i < batch.size(); ++i) {
+    // Other arguments, such as the module itself, are taken from the first
+    // input
+    if (!batch[i].isTensor()) {
+      continue;
+    }
+    std::vector<at::Tensor> tensors;
+    tensors.reserve(inputs.size());
+    tensors.push_back(batch[i].toTensor());
+    for (size_t j = 1; j < inputs.size(); ++j) {
+      TORCH_CHECK(
+          inputs[j].size() == batch.size() && inputs[j][i].isTensor(),
+          "Batched inputs must have tensors at the same positions");
+      tensors.push_back(inputs[j][i].toTensor());
+    }
+    batch[i] = at::cat(tensors);
+  }
+  return batch;
+}
+
 } // namespace detail
 
 } // namespace throughput_benchmark
@@ -21,6 +21,19 @@ namespace throughput_benchmark {
 struct BenchmarkExecutionStats {
   float latency_avg_ms{-1};
   int64_t num_iters{-1};
+  // Wall time of the measured part of the benchmark
+  float total_time_ms{-1};
+  // Percentiles of the latencies of the requests. In the open-loop mode the
+  // latency of a request includes the time it waited for a calling thread
+  float latency_p50_ms{-1};
+  float latency_p90_ms{-1};
+  float latency_p99_ms{-1};
+  float latency_p999_ms{-1};
+  // Latency of every request, e.g. to build a histogram
+  std::vector<float> latencies_ms;
+  // CPU time spent by each calling thread in the measured part of the
+  // benchmark, -1 where it can't be measured
+  std::vector<float> thread_cpu_time_ms;
 };
 
 /**
@@ -49,6 +62,16 @@ struct BenchmarkConfig {
   // Number of iterations the benchmark should run with. This number is separate
   // from the warmup iterations
   int64_t num_iters{100};
+  // If positive, the benchmark runs an open loop instead of calling the model
+  // back to back: the requests arrive as a Poisson process at this rate (per
+  // second, across all the calling threads) and are served by the first free
+  // calling thread. This shows how latency grows with load.
+  double target_qps{0};
+  // Calling threads run the model on up to this many requests at once, with
+  // their tensor inputs concatenated along the first dimension. In the
+  // open-loop mode only the requests that already arrived are batched. Only
+  // supported for ScriptModule.
+  int max_batch_size{1};
 };
 
 namespace detail {
@@ -67,6 +90,8 @@ public:
   // even when running in the nn.Module mode. Otherwise destructor of the result
   // would race with Python
   void runOnce(Input&&) const;
+  // Runs the model once on the batch of inputs
+  void runBatch(std::vector<Input>&&) const;
   // This method is to be used when calling from Python dirrectly
   Output runOnce(py::args&&, py::kwargs&&) const;
   // Aggregate input in the format Model expects in order to avoid further
@@ -103,6 +128,10 @@ typedef at::IValue ScriptModuleOutput;
 template<class Input>
 Input cloneInput(const Input& input);
 
+// Concatenates the tensors of the inputs along their first dimension
+template<class Input>
+Input batchInputs(std::vector<Input>&& inputs);
+
 typedef BenchmarkHelper<
     ScriptModuleInput,
     at::IValue,
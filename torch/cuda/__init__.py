@@ -470,6 +470,7 @@ if not hasattr(torch._C, 'CudaDoubleStorageBase'):
 
     torch._C.__dict__['_CudaStreamBase'] = _dummy_type('CudaStreamBase')
     torch._C.__dict__['_CudaEventBase'] = _dummy_type('CudaEventBase')
+    torch._C.__dict__['_CUDAGraph'] = _dummy_type('CUDAGraph')
 
 
 @staticmethod
@@ -544,4 +545,7 @@ torch._storage_classes.add(BFloat16Storage)
 from . import sparse
 from . import profiler
 from . import nvtx
+from . import amp
 from .streams import Stream, Event
+from .graphs import CUDAGraph
+from .async_copy import CopyFuture, copy_async
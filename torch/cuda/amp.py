@@ -0,0 +1,63 @@
+import functools
+
+import torch
+
+
+class autocast(object):
+    r"""Context-manager that runs CUDA operators in mixed precision.
+
+    Inside an enabled region, matmuls, convolutions and ``linear`` run in
+    ``float16`` on Tensor Cores: their floating point CUDA inputs are cast to
+    half. Ops that need the range or precision of ``float32`` (softmax,
+    losses, reductions, ``exp``/``log``/``pow``, norms) get their inputs cast
+    to float. All other ops run in the types of their inputs. The casts are
+    recorded by autograd, so the backward pass runs in the same types and
+    gradients of ``float32`` parameters stay ``float32``.
+
+    Each parameter is converted to ``float16`` only once per region, however
+    many ops use it. The copies are dropped when the outermost region exits,
+    so enter it once per iteration, around the forward pass and the loss.
+    The backward pass doesn't need to be inside the region.
+
+    This context manager is thread local; it will not affect computation
+    in other threads.
+
+    Also functions as a decorator.
+
+    Arguments:
+        enabled (bool): whether to enable autocasting in the region. Use
+            ``enabled=False`` to run part of an enabled region in the types
+            of the inputs.
+
+    Example::
+
+        >>> model = Net().cuda()
+        >>> for input, target in data:
+        ...     optimizer.zero_grad()
+        ...     with torch.cuda.amp.autocast():
+        ...         output = model(input)
+        ...         loss = loss_fn(output, target)
+        ...     loss.backward()
+        ...     optimizer.step()
+    """
+    def __init__(self, enabled=True):
+        self._enabled = enabled
+
+    def __enter__(self):
+        self.prev = torch._C.is_autocast_enabled()
+        torch._C.set_autocast_enabled(self._enabled)
+        torch._C.autocast_increment_nesting()
+
+    def __exit__(self, *args):
+        # Drop the cast parameters when leaving the outermost region
+        if torch._C.autocast_decrement_nesting() == 0:
+            torch._C.clear_autocast_cache()
+        torch._C.set_autocast_enabled(self.prev)
+        return False
+
+    def __call__(self, func):
+        @functools.wraps(func)
+        def decorate_autocast(*args, **kwargs):
+            with self:
+                return func(*args, **kwargs)
+        return decorate_autocast
@@ -0,0 +1,45 @@
+import torch
+
+
+class CopyFuture(object):
+    r"""Handle to a copy started by :func:`copy_async`.
+
+    The CPU tensor returned by :meth:`wait` must not be read before the copy
+    has completed, i.e., before :meth:`done` returns ``True`` or :meth:`wait`
+    returns.
+    """
+
+    def __init__(self, future):
+        self._future = future
+
+    def done(self):
+        r"""Returns whether the copy has completed, without blocking."""
+        return self._future.done()
+
+    def wait(self):
+        r"""Blocks until the copy has completed and returns the CPU tensor."""
+        return self._future.wait()
+
+
+def copy_async(tensor):
+    r"""Starts copying a CUDA tensor to the CPU without synchronizing.
+
+    The copy is enqueued on the current stream, into pinned memory from the
+    caching host allocator, and the function returns right away. This lets
+    the host transfer a result while the device already computes the next
+    one::
+
+        future = torch.cuda.copy_async(output)
+        next_output = model(next_input)
+        result = future.wait()
+
+    Arguments:
+        tensor (Tensor): CUDA tensor to copy.
+
+    Returns:
+        A :class:`CopyFuture` whose :meth:`~CopyFuture.wait` returns a
+        contiguous CPU tensor with the contents of :attr:`tensor` on the
+        current stream at the time of the call. It does not require grad.
+    """
+    torch.cuda._lazy_init()
+    return CopyFuture(torch._C._cuda_copy_to_host_async(tensor))
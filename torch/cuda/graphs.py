@@ -0,0 +1,52 @@
+import torch
+
+
+class CUDAGraph(torch._C._CUDAGraph):
+    r"""Wrapper around a CUDA graph.
+
+    A graph records the kernels that a static-shape step, e.g., a training or
+    inference iteration, launches on the current stream between
+    :meth:`capture_begin` and :meth:`capture_end`, and :meth:`replay` runs all
+    of them again with a single launch::
+
+        g = torch.cuda.CUDAGraph()
+        s = torch.cuda.Stream()
+        with torch.cuda.stream(s):
+            g.capture_begin()
+            static_out = model(static_in)
+            g.capture_end()
+        for data in loader:
+            static_in.copy_(data)
+            g.replay()
+            # static_out holds the result for data
+
+    Kernels are not run during capture, and a replay reads and writes the
+    same memory as the captured kernels. New inputs therefore have to be
+    copied into the tensors used during capture, and outputs are overwritten
+    by the next replay. Tensors allocated during capture come from a private
+    memory pool that is kept until the graph is reset or deleted.
+
+    .. warning::
+        The default stream cannot be captured. Work that synchronizes with the
+        host (e.g., :meth:`~torch.Tensor.item`) must not be captured, and ops
+        that draw random numbers replay the same numbers every time.
+
+    .. note:: Needs CUDA 10.1 or newer.
+    """
+
+    def capture_begin(self):
+        r"""Starts capturing the work submitted to the current stream."""
+        super(CUDAGraph, self).capture_begin()
+
+    def capture_end(self):
+        r"""Ends the capture and instantiates the graph."""
+        super(CUDAGraph, self).capture_end()
+
+    def replay(self):
+        r"""Launches the captured work on the current stream."""
+        super(CUDAGraph, self).replay()
+
+    def reset(self):
+        r"""Deletes the graph and releases its memory pool, so that the graph
+        can be captured again."""
+        super(CUDAGraph, self).reset()
@@ -60,6 +60,11 @@ def memory_stats(device=None):
       number of inactive, non-releasable memory blocks.
     - ``"inactive_split_bytes.{all,large_pool,small_pool}.{current,peak,allocated,freed}"``:
       amount of inactive, non-releasable memory.
+    - ``"deferred_free.{all,large_pool,small_pool}.{current,peak,allocated,freed}"``:
+      number of freed memory blocks that wait for work on other streams they
+      were used on (see :meth:`~torch.Tensor.record_stream`).
+    - ``"deferred_free_bytes.{all,large_pool,small_pool}.{current,peak,allocated,freed}"``:
+      amount of freed memory that waits for work on other streams.
 
     For these core statistics, values are broken down as follows.
 
@@ -84,6 +89,18 @@ def memory_stats(device=None):
     - ``"num_alloc_retries"``: number of failed ``cudaMalloc`` calls that
       result in a cache flush and retry.
     - ``"num_ooms"``: number of out-of-memory errors thrown.
+    - ``"num_deferred_frees_released_by_wait"``: number of freed blocks
+      returned to the pool early because their allocation stream waited on
+      the other streams they were used on, e.g. with
+      :meth:`~torch.cuda.Stream.wait_stream`.
+
+    When the allocator runs in size-class mode (see :ref:`cuda-memory-management`),
+    two more statistics are reported:
+
+    - ``"size_class_cached_blocks"``: number of freed blocks held in size-class
+      free lists.
+    - ``"size_class_cached_bytes"``: amount of memory held in size-class free
+      lists. This memory is counted as reserved, but not as allocated or active.
 
     Arguments:
         device (torch.device or int, optional): selected device. Returns
@@ -316,6 +333,65 @@ def memory_snapshot():
     return torch._C._cuda_memorySnapshot()
 
 
+def _record_memory_trace(enabled=True, max_entries=1 << 20):
+    r"""Starts or stops recording allocator events (malloc, free, record_stream
+    and empty_cache) into a ring buffer that keeps the last :attr:`max_entries`
+    events. Starting a recording discards the previous one.
+
+    The recording can be saved with :func:`_save_memory_trace` and replayed
+    with the ``replay_cuda_allocator_trace`` binary.
+    """
+    torch._C._cuda_recordMemoryTrace(enabled, max_entries)
+
+
+def _save_memory_trace(path):
+    r"""Writes the events recorded since :func:`_record_memory_trace` to
+    :attr:`path`, oldest first."""
+    torch._C._cuda_saveMemoryTrace(path)
+
+
+def host_memory_stats():
+    r"""Returns a dictionary of statistics of the caching allocator for pinned
+    (page-locked) host memory, as used by :meth:`~torch.Tensor.pin_memory`.
+
+    The keys follow :func:`~torch.cuda.memory_stats`, without the breakdown by
+    pool type:
+
+    - ``"allocation.{current,peak,allocated,freed}"``: number of allocation
+      requests received by the allocator.
+    - ``"allocated_bytes.{current,peak,allocated,freed}"``: amount of allocated
+      memory. Requests are rounded up to a power of two.
+    - ``"segment.{current,peak,allocated,freed}"``: number of blocks reserved
+      with ``cudaHostAlloc()``.
+    - ``"reserved_bytes.{current,peak,allocated,freed}"``: amount of reserved
+      memory.
+    - ``"num_trimmed_blocks"``: number of cached blocks released because the
+      cache exceeded its limit (see :ref:`cuda-memory-management`).
+    """
+    result = []
+    for k, v in torch._C._cuda_hostMemoryStats().items():
+        if isinstance(v, dict):
+            result.extend((k + "." + stat, value) for stat, value in v.items())
+        else:
+            result.append((k, v))
+    result.sort()
+    return collections.OrderedDict(result)
+
+
+def reset_peak_host_memory_stats():
+    r"""Resets the "peak" stats tracked by the pinned host memory allocator.
+
+    See :func:`~torch.cuda.host_memory_stats` for details.
+    """
+    torch._C._cuda_resetPeakHostMemoryStats()
+
+
+def _set_host_memory_max_cached_bytes(max_cached_bytes):
+    r"""Limits the amount of freed pinned host memory kept cached. Blocks
+    above the limit are released by a background thread, largest first."""
+    torch._C._cuda_setHostMemoryMaxCachedBytes(max_cached_bytes)
+
+
 def memory_summary(device=None, abbreviated=False):
     r"""Returns a human-readable printout of the current memory allocator
     statistics for a given device.
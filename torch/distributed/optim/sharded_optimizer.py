@@ -0,0 +1,71 @@
+import torch.distributed as dist
+
+
+class ShardedOptimizer(object):
+    r"""
+    Shards the state of an optimizer across the processes of a
+    :class:`~torch.nn.parallel.DistributedDataParallel` module, as in ZeRO
+    (Rajbhandari et al., 2019), so that every process only keeps the state of
+    1 / world size of the parameters.
+
+    The optimizer steps the chunks of the flattened gradient buckets of the
+    module that this process owns, its shards. Their gradients are
+    reduce-scattered by a communication hook as soon as each bucket is ready,
+    overlapping with the backward pass like the allreduce does, and
+    :meth:`step` allgathers the updated shards back into the parameters. The
+    ``.grad`` of the parameters is then only the local gradient of each
+    process. Only single device modules with dense gradients are supported.
+
+    The shards follow the bucket assignment of the module, so the state of the
+    optimizer starts over if the module rebuilds its buckets, which it does
+    once, at the start of the second iteration.
+
+    Args:
+        module (DistributedDataParallel): the module to optimize.
+        optimizer_class (optim.Optimizer): the class of the optimizer stepping
+            the shards.
+        kwargs: arguments to pass to the optimizer constructor.
+
+    Example::
+
+        >>> ddp = torch.nn.parallel.DistributedDataParallel(model, device_ids=[i])
+        >>> opt = ShardedOptimizer(ddp, torch.optim.Adam, lr=1e-3)
+        >>> ddp(input).sum().backward()
+        >>> opt.step()
+    """
+
+    def __init__(self, module, optimizer_class, **kwargs):
+        if module.device_ids and len(module.device_ids) > 1:
+            raise ValueError(
+                "ShardedOptimizer only supports single device modules")
+        # The variables of the first model replica of the Reducer
+        self.parameters = [
+            parameter
+            for submodule in module.module.modules()
+            for parameter in submodule.parameters(recurse=False)
+            if parameter.requires_grad]
+        self.optimizer_class = optimizer_class
+        self.kwargs = kwargs
+        self.hook = dist.ShardedOptimizerHook(
+            module.process_group, self.parameters)
+        module.register_comm_hook(self.hook)
+        self._make_optimizer()
+
+    def _make_optimizer(self):
+        self.layout_version = self.hook.layout_version()
+        self.optimizer = self.optimizer_class(self.hook.shards(), **self.kwargs)
+
+    def zero_grad(self):
+        # The local gradients are accumulated into the buckets too
+        for parameter in self.parameters:
+            if parameter.grad is not None:
+                parameter.grad.detach_()
+                parameter.grad.zero_()
+        self.optimizer.zero_grad()
+
+    def step(self, closure=None):
+        if self.hook.layout_version() != self.layout_version:
+            self._make_optimizer()
+        loss = self.optimizer.step(closure)
+        self.hook.allgather_parameters()
+        return loss
@@ -1,7 +1,9 @@
 from . import _invoke_rpc_builtin, _invoke_rpc_python_udf
 from . import _invoke_remote_builtin, _invoke_remote_python_udf
+from . import _invoke_rpc_torchscript, _invoke_remote_torchscript
 from . import _start_rpc_agent
 from . import _destroy_rref_context, _cleanup_python_rpc_handler
+from . import _to_here_many
 from . import WorkerInfo
 from . import backend_registry
 from .internal import _internal_rpc_pickler, PythonUDF
@@ -175,7 +177,8 @@ def remote(to, func, args=None, kwargs=None):
 
     Arguments:
         to (str or WorkerInfo): id or name of the destination worker.
-        func (callable): builtin functions (like :meth:`torch.add`).
+        func (callable): builtin functions (like :meth:`torch.add`) or
+                         TorchScript functions, see :meth:`rpc_sync`.
         args (tuple): the argument tuple for the ``func`` invocation.
         kwargs (dict): is a dictionary of keyword arguments for the ``func``
                        invocation.
@@ -209,6 +212,9 @@ def remote(to, func, args=None, kwargs=None):
     if qualified_name is not None:
         return _invoke_remote_builtin(
             _agent, info, qualified_name, *args, **kwargs)
+    elif isinstance(func, torch._C.ScriptFunction):
+        return _invoke_remote_torchscript(
+            _agent, info, func.qualified_name, *args, **kwargs)
     else:
         (pickled_python_udf, tensors) = _default_pickler.serialize(
             PythonUDF(func, args, kwargs))
@@ -230,6 +236,10 @@ def _invoke_rpc(to, func, args=None, kwargs=None):
         fut = _invoke_rpc_builtin(
             _agent, info, qualified_name, *args, **kwargs
         )
+    elif isinstance(func, torch._C.ScriptFunction):
+        fut = _invoke_rpc_torchscript(
+            _agent, info, func.qualified_name, *args, **kwargs
+        )
     else:
         (pickled_python_udf, tensors) = _default_pickler.serialize(
             PythonUDF(func, args, kwargs))
@@ -249,6 +259,9 @@ def rpc_sync(to, func, args=None, kwargs=None):
         to (str or WorkerInfo): id or name of the destination worker.
         func (callable): any callable function. builtin functions (like
                          :meth:`torch.add`) can be sent over RPC more efficiently.
+                         So can TorchScript functions (see
+                         :func:`torch.jit.script`), which run without the GIL
+                         on ``to``. They must be scripted there too.
         args (tuple): the argument tuple for the ``func`` invocation.
         kwargs (dict): is a dictionary of keyword arguments for the ``func``
                        invocation.
@@ -311,3 +324,35 @@ def rpc_async(to, func, args=None, kwargs=None):
     """
     fut = _invoke_rpc(to, func, args, kwargs)
     return fut
+
+
+@_require_initialized
+def to_here_many(rrefs, cache=False):
+    r"""
+    Copy the values of a list of RRefs to the local node, like calling
+    ``to_here`` on each of them. The values of all the RRefs are requested
+    before waiting on any of them, so this takes a single round trip instead
+    of one per RRef, and the requests to the same owner are sent together.
+
+    Arguments:
+        rrefs (list): the RRefs to fetch the values of.
+        cache (bool): passed to ``to_here`` for every RRef. (default: ``False``)
+
+    Returns:
+        The list of the values of ``rrefs``.
+
+    Example::
+
+        On worker 0:
+        >>> import torch.distributed.rpc as rpc
+        >>> rpc.init_rpc("worker0", rank=0, world_size=2)
+        >>> rrefs = [rpc.remote("worker1", torch.ones, args=(i,)) for i in range(3)]
+        >>> values = rpc.to_here_many(rrefs)
+        >>> rpc.wait_all_workers()
+
+        On worker 1:
+        >>> import torch.distributed.rpc as rpc
+        >>> rpc.init_rpc("worker1", rank=1, world_size=2)
+        >>> rpc.wait_all_workers()
+    """
+    return _to_here_many(rrefs, cache)
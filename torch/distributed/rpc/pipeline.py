@@ -0,0 +1,256 @@
+from __future__ import absolute_import, division, print_function, unicode_literals
+
+import threading
+import time
+from collections import namedtuple
+
+import torch
+import torch.distributed.autograd as dist_autograd
+
+from . import RRef
+from .api import remote, rpc_async
+
+
+StageStats = namedtuple("StageStats", ["forward_time", "backward_time", "idle_time"])
+StageStats.__doc__ = r"""
+Where the time of a stage of a :class:`Pipeline` went in its last
+:meth:`~Pipeline.train_step`, in seconds, as measured by the worker of the
+stage. ``idle_time`` is the time the stage had nothing to run, which includes
+the fill and drain of the pipeline.
+"""
+
+
+class _BackwardMark(torch.autograd.Function):
+    # Identity, whose backward tells the stage when the backward of a
+    # micro-batch gets to the output of the stage, or to its input
+    @staticmethod
+    def forward(ctx, x, stage, index, is_input):
+        ctx.stage = stage
+        ctx.index = index
+        ctx.is_input = is_input
+        return x.view_as(x)
+
+    @staticmethod
+    def backward(ctx, grad):
+        if ctx.is_input:
+            ctx.stage.backward_finished(ctx.index)
+        else:
+            ctx.stage.backward_started(ctx.index)
+        return grad, None, None, None
+
+
+class _Stage(object):
+    # Lives on the worker of a stage. Runs the forward of the micro-batches
+    # one at a time, in order, and times the forward and backward passes.
+    def __init__(self, module_rref):
+        self.module = module_rref.local_value()
+        self.cond = threading.Condition()
+        self.reset()
+
+    def reset(self):
+        with self.cond:
+            self.next_forward = 0
+            self.backward_starts = {}
+            self.forward_time = 0.0
+            self.backward_time = 0.0
+            self.step_start = time.time()
+
+    def forward(self, index, x):
+        # Fetches the output of the previous stage before waiting for the turn
+        # of the micro-batch, so that the transfer overlaps with the forward of
+        # the previous micro-batch. The turn is taken even if that failed, or
+        # the next micro-batches would wait for it forever.
+        error = None
+        try:
+            if isinstance(x, RRef):
+                x = x.to_here()
+        except Exception as e:
+            error = e
+        with self.cond:
+            while self.next_forward != index:
+                self.cond.wait()
+        try:
+            if error is not None:
+                raise error
+            start = time.time()
+            if x.requires_grad:
+                x = _BackwardMark.apply(x, self, index, True)
+            out = _BackwardMark.apply(self.module(x), self, index, False)
+            with self.cond:
+                self.forward_time += time.time() - start
+            return out
+        finally:
+            with self.cond:
+                self.next_forward += 1
+                self.cond.notify_all()
+
+    def backward_started(self, index):
+        with self.cond:
+            self.backward_starts[index] = time.time()
+
+    def backward_finished(self, index):
+        with self.cond:
+            start = self.backward_starts.pop(index, None)
+            if start is not None:
+                self.backward_time += time.time() - start
+
+    def accumulate_grads(self, index, context_id):
+        # The first stage gets no mark on its input, so its backward is over
+        # when the whole backward of the micro-batch is
+        self.backward_finished(index)
+        grads = dist_autograd.get_gradients(context_id)
+        with self.cond:
+            for param in self.module.parameters():
+                grad = grads.get(param)
+                if grad is None:
+                    continue
+                if param.grad is None:
+                    param.grad = grad.clone()
+                else:
+                    param.grad.add_(grad)
+
+    def zero_grad(self):
+        self.module.zero_grad()
+
+    def stats(self):
+        with self.cond:
+            busy = self.forward_time + self.backward_time
+            idle = max(0.0, time.time() - self.step_start - busy)
+            return StageStats(self.forward_time, self.backward_time, idle)
+
+
+def _stage_call(stage_rref, method, *args):
+    return getattr(stage_rref.local_value(), method)(*args)
+
+
+class Pipeline(object):
+    r"""
+    Trains a sequence of modules placed on RPC workers as a pipeline: each
+    batch is split into micro-batches, which flow through the stages one after
+    the other, so that the stages work on different micro-batches at the same
+    time. Each stage sends its output straight to the worker of the next
+    stage, and fetches the output of the previous stage while it runs the
+    forward of the previous micro-batch.
+
+    The backward passes run through distributed autograd, one context per
+    micro-batch, as soon as the micro-batch got through the last stage. The
+    number of micro-batches in the pipeline is bounded by ``max_in_flight``,
+    the number of stages by default: a new micro-batch starts once the
+    backward of an earlier one is over, as in the one forward, one backward
+    (1F1B) schedule, which keeps the activations of at most that many
+    micro-batches alive on each stage.
+
+    Each worker of a stage must handle up to ``max_in_flight`` forward calls
+    waiting for their turn, besides the transfers and the backward pass, so
+    the RPC agents need more than ``max_in_flight`` threads (see
+    ``num_send_recv_threads``).
+
+    Arguments:
+        stages (list of RRef): RRefs to the modules of the stages, in
+            order, e.g. created with :meth:`~torch.distributed.rpc.remote`.
+            Each module takes a single tensor and returns a single tensor.
+        chunks (int): the number of micro-batches each batch is split into.
+        max_in_flight (int, optional): the number of micro-batches that can
+            be in the pipeline at the same time.
+
+    Example::
+        >>> stages = [rpc.remote("worker1", nn.Linear, args=(16, 32)),
+        >>>           rpc.remote("worker2", nn.Linear, args=(32, 4))]
+        >>> pipe = Pipeline(stages, chunks=8)
+        >>> pipe.zero_grad()
+        >>> loss = pipe.train_step(inputs, targets, nn.functional.mse_loss)
+        >>> print(pipe.stats())
+    """
+
+    def __init__(self, stages, chunks, max_in_flight=None):
+        if not stages:
+            raise ValueError("Pipeline needs at least one stage")
+        if chunks < 1:
+            raise ValueError("chunks must be positive, got {}".format(chunks))
+        self.chunks = chunks
+        self.max_in_flight = max_in_flight or len(stages)
+        self._owners = [stage.owner() for stage in stages]
+        self._stages = [
+            remote(owner, _Stage, args=(stage,))
+            for owner, stage in zip(self._owners, stages)
+        ]
+        self._stats = []
+
+    def _call_all(self, method, *args):
+        futures = [
+            rpc_async(owner, _stage_call, args=(stage, method) + args)
+            for owner, stage in zip(self._owners, self._stages)
+        ]
+        return [future.wait() for future in futures]
+
+    def zero_grad(self):
+        r"""Zeroes the gradients of the parameters of all stages."""
+        self._call_all("zero_grad")
+
+    def _run_micro_batch(self, index, x, target, loss_fn, weight):
+        with dist_autograd.context() as context_id:
+            for owner, stage in zip(self._owners, self._stages):
+                x = remote(owner, _stage_call, args=(stage, "forward", index, x))
+            loss = loss_fn(x.to_here(), target) * weight
+            dist_autograd.backward([loss])
+            self._call_all("accumulate_grads", index, context_id)
+            return loss.detach()
+
+    def train_step(self, inputs, targets, loss_fn):
+        r"""
+        Runs the forward and backward pass of a batch, accumulating the
+        gradients into the ``grad`` of the parameters of the stages, on their
+        workers. The batch is split along its first dimension.
+
+        Arguments:
+            inputs (Tensor): the input of the first stage.
+            targets (Tensor): passed to ``loss_fn`` with the output of the
+                last stage, split like ``inputs``.
+            loss_fn (callable): returns the mean loss of a micro-batch,
+                computed on the calling worker. Each micro-batch's loss is
+                weighted by its share of the batch, so that the gradients are
+                the ones of the mean loss of the whole batch.
+
+        Returns:
+            The loss of the batch.
+        """
+        micro_inputs = inputs.chunk(self.chunks)
+        micro_targets = targets.chunk(self.chunks)
+        if len(micro_inputs) != len(micro_targets):
+            raise ValueError("inputs and targets must have the same batch size")
+        self._call_all("reset")
+
+        batch_size = inputs.size(0)
+        losses = [None] * len(micro_inputs)
+        errors = []
+        in_flight = threading.Semaphore(self.max_in_flight)
+
+        def run(index):
+            try:
+                weight = micro_inputs[index].size(0) / batch_size
+                losses[index] = self._run_micro_batch(
+                    index, micro_inputs[index], micro_targets[index], loss_fn, weight)
+            except Exception as e:
+                errors.append(e)
+            finally:
+                in_flight.release()
+
+        threads = []
+        for index in range(len(micro_inputs)):
+            in_flight.acquire()
+            thread = threading.Thread(target=run, args=(index,))
+            thread.start()
+            threads.append(thread)
+        for thread in threads:
+            thread.join()
+        self._stats = self._call_all("stats")
+        if errors:
+            raise errors[0]
+        return sum(losses)
+
+    def stats(self):
+        r"""
+        Returns a :class:`StageStats` for every stage, of the last
+        :meth:`train_step`.
+        """
+        return list(self._stats)
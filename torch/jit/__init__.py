@@ -93,7 +93,7 @@ def optimized_execution(should_optimize):
 DEFAULT_EXTRA_FILES_MAP = torch._C.ExtraFilesMap()
 
 
-def save(m, f, _extra_files=DEFAULT_EXTRA_FILES_MAP):
+def save(m, f, _extra_files=DEFAULT_EXTRA_FILES_MAP, _num_shards=1):
     """
         Save an offline version of this module for use in a separate process. The saved
         module serializes all of the methods, submodules, parameters, and attributes of this
@@ -112,6 +112,9 @@ def save(m, f, _extra_files=DEFAULT_EXTRA_FILES_MAP):
             f: A file-like object (has to implement write and flush) or a string
                containing a file name.
             _extra_files: Map from filename to contents which will be stored as part of 'f'.
+            _num_shards: The number of files the tensors are spread over, written in parallel:
+               ``f`` and ``f + '.1'``, ..., ``f + '.<_num_shards - 1>'``, which have to stay
+               next to ``f``. Only supported when ``f`` is a file name.
 
         .. warning::
             If you are using Python 2, ``torch.jit.save`` does NOT support ``StringIO.StringIO``
@@ -150,8 +153,10 @@ def save(m, f, _extra_files=DEFAULT_EXTRA_FILES_MAP):
     if isinstance(f, str) or \
             (sys.version_info[0] == 2 and isinstance(f, unicode)) or \
             (sys.version_info[0] == 3 and isinstance(f, pathlib.Path)):
-        m.save(f, _extra_files=_extra_files)
+        m.save(f, _extra_files=_extra_files, _num_shards=_num_shards)
     else:
+        if _num_shards != 1:
+            raise RuntimeError("torch.jit.save can only shard modules saved to a file name")
         ret = m.save_to_buffer(_extra_files=_extra_files)
         f.write(ret)
 
@@ -0,0 +1,103 @@
+"""
+Ahead-of-time compilation of TorchScript modules into shared libraries.
+
+``compile_library`` freezes a module, lowers its optimized ``forward`` graph
+to C++ calling the ATen ops directly and compiles it with the system
+compiler, writing ``<path>`` and its weights ``<path>.weights``.
+``load_library`` loads them back, without parsing, compiling or optimizing
+TorchScript: the weights are mmapped and the ops run without the
+interpreter. The inputs and outputs of ``forward`` have to be tensors, or
+tuples of tensors which are flattened.
+
+It can also be run on a serialized module::
+
+    python -m torch.jit.aot model.pt model.so
+"""
+from __future__ import absolute_import, division, print_function, unicode_literals
+
+import argparse
+import os
+import subprocess
+import sys
+
+import torch
+from torch.utils.cpp_extension import include_paths
+
+
+def _compile_command(compiler, source_path, library_path, extra_cflags):
+    lib_path = os.path.join(os.path.dirname(torch.__file__), 'lib')
+    return ([compiler, '-O3', '-std=c++14', '-shared', '-fPIC',
+             '-D_GLIBCXX_USE_CXX11_ABI=' + str(int(torch._C._GLIBCXX_USE_CXX11_ABI))] +
+            ['-I' + path for path in include_paths()] +
+            list(extra_cflags) +
+            [source_path, '-o', library_path,
+             '-L' + lib_path, '-Wl,-rpath,' + lib_path, '-lc10', '-ltorch'])
+
+
+def compile_library(module, path, method_name='forward', compiler=None,
+                    extra_cflags=(), keep_source=False, verbose=False):
+    r"""
+    Compiles ``module.<method_name>`` into the shared library ``path``,
+    writing its weights to ``path + '.weights'``.
+
+    The module is frozen first, so it has to be in eval mode and its methods
+    must not mutate its attributes. The compiler defaults to the ``CXX``
+    environment variable, or ``c++``.
+    """
+    if sys.platform == 'win32':
+        raise RuntimeError('torch.jit.aot does not support Windows yet')
+    if isinstance(module, torch.jit.ScriptModule):
+        module = module._c
+    graph = torch._C._jit_aot_prepare(module, method_name)
+    source, weights = torch._C._jit_aot_generate_source(graph)
+
+    source_path = path + '.cpp'
+    with open(source_path, 'w') as f:
+        f.write(source)
+    with open(path + '.weights', 'wb') as f:
+        f.write(weights)
+
+    compiler = compiler or os.environ.get('CXX', 'c++')
+    command = _compile_command(compiler, source_path, path, extra_cflags)
+    if verbose:
+        print(graph)
+        print(' '.join(command))
+    try:
+        subprocess.check_call(command)
+    finally:
+        if not keep_source:
+            os.remove(source_path)
+
+
+def load_library(path):
+    r"""
+    Loads the library compiled by ``compile_library``, returning a function
+    taking and returning tensors.
+    """
+    library = torch._C.AOTLibrary(path, path + '.weights')
+
+    def run(*inputs):
+        outputs = library.run(list(inputs))
+        return outputs[0] if len(outputs) == 1 else tuple(outputs)
+    run._library = library
+    return run
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description='Compiles a serialized TorchScript module into a shared library')
+    parser.add_argument('module', help='the module saved by torch.jit.save')
+    parser.add_argument('library', help='the library to write, with its weights next to it')
+    parser.add_argument('--method', default='forward')
+    parser.add_argument('--keep-source', action='store_true')
+    parser.add_argument('--verbose', action='store_true')
+    args = parser.parse_args()
+
+    module = torch.jit.load(args.module)
+    module.eval()
+    compile_library(module, args.library, method_name=args.method,
+                    keep_source=args.keep_source, verbose=args.verbose)
+
+
+if __name__ == '__main__':
+    main()
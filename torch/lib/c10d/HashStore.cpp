@@ -77,6 +77,24 @@ int64_t HashStore::add(const std::string& key, int64_t i) {
   return ti;
 }
 
+std::vector<uint8_t> HashStore::compareSet(
+    const std::string& key,
+    const std::vector<uint8_t>& expectedValue,
+    const std::vector<uint8_t>& desiredValue) {
+  std::unique_lock<std::mutex> lock(m_);
+  auto it = map_.find(key);
+  if (it == map_.end()) {
+    if (!expectedValue.empty()) {
+      return expectedValue;
+    }
+  } else if (it->second != expectedValue) {
+    return it->second;
+  }
+  map_[key] = desiredValue;
+  cv_.notify_all();
+  return desiredValue;
+}
+
 bool HashStore::check(const std::vector<std::string>& keys) {
   std::unique_lock<std::mutex> lock(m_);
   for (const auto& key : keys) {
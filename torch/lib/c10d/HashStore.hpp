@@ -28,6 +28,11 @@ class HashStore : public Store {
 
   int64_t add(const std::string& key, int64_t value) override;
 
+  std::vector<uint8_t> compareSet(
+      const std::string& key,
+      const std::vector<uint8_t>& expectedValue,
+      const std::vector<uint8_t>& desiredValue) override;
+
   bool check(const std::vector<std::string>& keys) override;
 
  protected:
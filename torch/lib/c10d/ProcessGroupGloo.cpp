@@ -402,7 +402,9 @@ void ProcessGroupGloo::RecvWork::abort() {
 }
 
 ProcessGroupGloo::Options::Options()
-    : timeout(std::chrono::milliseconds(10 * 1000)), threads(2) {}
+    : timeout(std::chrono::milliseconds(10 * 1000)),
+      threads(2),
+      lazyInit(false) {}
 
 namespace {
 
@@ -552,13 +554,33 @@ ProcessGroupGloo::ProcessGroupGloo(
     Options options)
     : ProcessGroup(rank, size),
       store_(new GlooStore(store)),
+      devices_(options.devices),
+      timeout_(options.timeout),
       stop_(false),
-      collectiveCounter_(0) {
+      collectiveCounter_(0),
+      stagingBuffers_(std::make_shared<StagingBuffers>()) {
   auto& devices = options.devices;
   if (devices.empty()) {
     throw std::runtime_error("No device(s) specified");
   }
 
+  if (!options.lazyInit) {
+    std::call_once(connectFlag_, &ProcessGroupGloo::connectContexts, this);
+  }
+
+  // Every worker thread stores the AsyncWork object it's currently
+  // working on in the workInProgress_ vector. It must have size equal
+  // to the number of workers such that they can simply index into it
+  // using the worker index they are started with.
+  workInProgress_.resize(options.threads);
+
+  threads_.resize(options.threads);
+  for (size_t i = 0; i < threads_.size(); i++) {
+    threads_[i] = std::thread(&ProcessGroupGloo::runLoop, this, i);
+  }
+}
+
+void ProcessGroupGloo::connectContexts() {
   // Create and connect a context for every device.
   //
   // Note that the same device can be specified multiple times, either
@@ -571,25 +593,16 @@ ProcessGroupGloo::ProcessGroupGloo(
   // option is needed if you have a fast NIC that cannot be saturated
   // by a single I/O thread.
   //
-  contexts_.reserve(options.devices.size());
-  for (size_t i = 0; i < options.devices.size(); i++) {
+  std::vector<std::shared_ptr<::gloo::Context>> contexts;
+  contexts.reserve(devices_.size());
+  for (size_t i = 0; i < devices_.size(); i++) {
     auto context = std::make_shared<::gloo::rendezvous::Context>(rank_, size_);
     auto store = ::gloo::rendezvous::PrefixStore(std::to_string(i), *store_);
-    context->setTimeout(options.timeout);
-    context->connectFullMesh(store, options.devices[i]);
-    contexts_.push_back(std::move(context));
-  }
-
-  // Every worker thread stores the AsyncWork object it's currently
-  // working on in the workInProgress_ vector. It must have size equal
-  // to the number of workers such that they can simply index into it
-  // using the worker index they are started with.
-  workInProgress_.resize(options.threads);
-
-  threads_.resize(options.threads);
-  for (size_t i = 0; i < threads_.size(); i++) {
-    threads_[i] = std::thread(&ProcessGroupGloo::runLoop, this, i);
+    context->setTimeout(timeout_);
+    context->connectFullMesh(store, devices_[i]);
+    contexts.push_back(std::move(context));
   }
+  contexts_ = std::move(contexts);
 }
 
 ProcessGroupGloo::~ProcessGroupGloo() {
@@ -615,6 +628,9 @@ uint32_t ProcessGroupGloo::nextTag() {
 }
 
 std::shared_ptr<::gloo::Context> ProcessGroupGloo::getContext(uint32_t tag) {
+  // A no-op unless lazyInit deferred connecting; if connecting throws, the
+  // next operation tries again
+  std::call_once(connectFlag_, &ProcessGroupGloo::connectContexts, this);
   return contexts_[tag % contexts_.size()];
 }
 
@@ -856,8 +872,12 @@ class AsyncAllreduceCoalescedWork : public AsyncAllreduceWork {
       const std::shared_ptr<gloo::Context>& context,
       std::vector<at::Tensor>& inputs,
       ReduceOp reduceOp,
-      uint32_t tag)
-      : AsyncAllreduceWork(context, inputs, reduceOp, tag) {}
+      uint32_t tag,
+      std::shared_ptr<StagingBuffers> stagingBuffers)
+      : AsyncAllreduceWork(context, inputs, reduceOp, tag),
+        stagingBuffers(std::move(stagingBuffers)) {}
+
+  std::shared_ptr<StagingBuffers> stagingBuffers;
 
   void run() override {
     allreduceCoalesced(inputs);
@@ -865,19 +885,38 @@ class AsyncAllreduceCoalescedWork : public AsyncAllreduceWork {
 
  private:
   void allreduceCoalesced(std::vector<at::Tensor>& tensors) {
-    // reduce coalesced, flattened tensors.
-    at::Tensor coalescedTensor = flattenDenseTensors(tensors);
+    // Tensors that are views of a flat buffer are reduced in place.
+    at::Tensor coalescedTensor = flatViewOf(tensors);
+    if (coalescedTensor.defined()) {
+      std::vector<at::Tensor> allreduceInput = {coalescedTensor};
+      allreduce(allreduceInput);
+      return;
+    }
+
+    // Otherwise they're reduced in a staging buffer.
+    int64_t numel = 0;
+    for (const auto& tensor : tensors) {
+      numel += tensor.numel();
+    }
+    at::Tensor staging = stagingBuffers->acquire(numel, tensors[0].options());
+    ResourceGuard guard([&] { stagingBuffers->release(staging); });
+    coalescedTensor = staging.narrow(0, 0, numel);
+    int64_t offset = 0;
+    for (const auto& tensor : tensors) {
+      coalescedTensor.narrow(0, offset, tensor.numel())
+          .view(tensor.sizes())
+          .copy_(tensor);
+      offset += tensor.numel();
+    }
     std::vector<at::Tensor> allreduceInput = {coalescedTensor};
     allreduce(allreduceInput);
 
     // separate and reshape tensors.
-    size_t offset = 0;
+    offset = 0;
     for (at::Tensor& tensor : tensors) {
-      const int64_t tensorNumel = tensor.numel();
-      const c10::IntArrayRef tensorShape = tensor.sizes();
-      tensor.copy_(coalescedTensor.slice(0, offset, offset + tensorNumel)
-                       .view(tensorShape));
-      offset += tensorNumel;
+      tensor.copy_(coalescedTensor.narrow(0, offset, tensor.numel())
+                       .view(tensor.sizes()));
+      offset += tensor.numel();
     }
   }
 };
@@ -1385,7 +1424,7 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupGloo::allreduce_coalesced(
   if (device.type() == c10::kCPU) {
     if (layout == c10::kStrided) {
       work = std::make_shared<AsyncAllreduceCoalescedWork>(
-          std::move(context), tensors, opts.reduceOp, tag);
+          std::move(context), tensors, opts.reduceOp, tag, stagingBuffers_);
     } else {
       invalidArgument("unsupported layout");
     }
@@ -1767,16 +1806,19 @@ class AsyncAllgatherCoalescedWork : public ProcessGroupGloo::AsyncWork {
       const std::shared_ptr<gloo::Context>& context,
       std::vector<std::vector<at::Tensor>>& output_lists,
       std::vector<at::Tensor>& input_list,
-      uint32_t tag)
+      uint32_t tag,
+      std::shared_ptr<StagingBuffers> stagingBuffers)
       : context(context),
         output_lists(output_lists),
         input_list(input_list),
-        tag(tag) {}
+        tag(tag),
+        stagingBuffers(std::move(stagingBuffers)) {}
 
   std::shared_ptr<gloo::Context> context;
   std::vector<std::vector<at::Tensor>> output_lists;
   std::vector<at::Tensor> input_list;
   const uint32_t tag;
+  std::shared_ptr<StagingBuffers> stagingBuffers;
 
   void allgather_coalesced() {
     assert(!output_lists.empty());
@@ -1787,30 +1829,60 @@ class AsyncAllgatherCoalescedWork : public ProcessGroupGloo::AsyncWork {
     gloo::AllgatherOptions opts(context);
     opts.setTag(tag);
 
+    // Tensors that are views of a flat buffer are used in place, the others
+    // are staged in a reused buffer.
+    std::vector<at::Tensor> staging;
+    ResourceGuard guard([&] {
+      for (auto& buffer : staging) {
+        stagingBuffers->release(std::move(buffer));
+      }
+    });
+
     // Use single flattened input tensor.
-    at::Tensor flatInputTensor = flattenDenseTensors(input_list);
+    at::Tensor flatInputTensor = flatViewOf(input_list);
+    if (!flatInputTensor.defined()) {
+      int64_t input_numel = 0;
+      for (const auto& t : input_list) {
+        input_numel += t.numel();
+      }
+      staging.push_back(
+          stagingBuffers->acquire(input_numel, input_list[0].options()));
+      flatInputTensor = staging.back().narrow(0, 0, input_numel);
+      int64_t offset = 0;
+      for (const auto& t : input_list) {
+        flatInputTensor.narrow(0, offset, t.numel()).view(t.sizes()).copy_(t);
+        offset += t.numel();
+      }
+    }
     GENERATE_ALL_TYPES(scalarType, setInput, opts, flatInputTensor);
 
-    // Compute total number of elements we need to allocate for all tensors
-    // requested.
-    int64_t output_numel = 0;
-    for (const auto& t : output_lists[0]) {
-      output_numel += t.numel();
-    }
-    output_numel *= output_lists.size();
     // Use single flat output tensor.
-    at::Tensor flatOutputTensor =
-        at::empty({output_numel}, output_lists[0][0].options());
+    std::vector<at::Tensor> outputs;
+    for (const auto& output_list : output_lists) {
+      outputs.insert(outputs.end(), output_list.begin(), output_list.end());
+    }
+    at::Tensor flatOutputTensor = flatViewOf(outputs);
+    const bool stagedOutput = !flatOutputTensor.defined();
+    if (stagedOutput) {
+      // Compute total number of elements we need to allocate for all tensors
+      // requested.
+      int64_t output_numel = 0;
+      for (const auto& t : outputs) {
+        output_numel += t.numel();
+      }
+      staging.push_back(
+          stagingBuffers->acquire(output_numel, outputs[0].options()));
+      flatOutputTensor = staging.back().narrow(0, 0, output_numel);
+    }
     GENERATE_ALL_TYPES(scalarType, setOutput, opts, flatOutputTensor);
     gloo::allgather(opts);
 
-    int64_t current_element = 0;
-    for (auto& output_list : output_lists) {
-      for (auto& output_tensor : output_list) {
+    if (stagedOutput) {
+      int64_t current_element = 0;
+      for (auto& output_tensor : outputs) {
         output_tensor.copy_(
             flatOutputTensor.narrow(0, current_element, output_tensor.numel())
-                .reshape(output_tensor.sizes()),
-            true);
+                .view(output_tensor.sizes()));
         current_element += output_tensor.numel();
       }
     }
@@ -1842,6 +1914,13 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupGloo::allgather_coalesced(
 
   assertSameDevice(invalidArgument, input_list);
 
+  // The tensors are flattened into a single one.
+  if (!std::all_of(input_list.begin(), input_list.end(), [&](at::Tensor& t) {
+        return t.type() == input_list[0].type();
+      })) {
+    invalidArgument("tensors must all have the same type");
+  }
+
   // Expect i'th tensor of each list from 'output_lists' match i'th tensor
   // from 'input_list' in type and size.
   for (const auto& output_list : output_lists) {
@@ -1874,7 +1953,7 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupGloo::allgather_coalesced(
   auto tag = nextTag();
   auto context = getContext(tag);
   auto work = std::make_shared<AsyncAllgatherCoalescedWork>(
-      std::move(context), output_lists, input_list, tag);
+      std::move(context), output_lists, input_list, tag, stagingBuffers_);
   enqueue(work);
   return work;
 }
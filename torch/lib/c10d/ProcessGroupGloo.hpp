@@ -129,6 +129,12 @@ class ProcessGroupGloo : public ProcessGroup {
     std::vector<std::shared_ptr<::gloo::transport::Device>> devices;
     std::chrono::milliseconds timeout;
     int threads;
+
+    // Connect the contexts on the first operation rather than in the
+    // constructor, so that groups that are never used cost no rendezvous.
+    // The first operation must then be one that all ranks of the group run,
+    // since it connects the full mesh; a send or recv hangs.
+    bool lazyInit;
   };
 
   // Helper functions to create a new device object.
@@ -223,6 +229,10 @@ class ProcessGroupGloo : public ProcessGroup {
   // In order to use more than one device (or allow for parallelism on
   // a single device), you need multiple contexts.
   std::vector<std::shared_ptr<::gloo::Context>> contexts_;
+  // What the contexts are connected with, kept for lazyInit
+  std::vector<std::shared_ptr<::gloo::transport::Device>> devices_;
+  std::chrono::milliseconds timeout_;
+  std::once_flag connectFlag_;
   std::vector<std::thread> threads_;
   bool stop_;
 
@@ -235,6 +245,9 @@ class ProcessGroupGloo : public ProcessGroup {
   // Returns next collective tag to use (uses collectiveCounter_).
   uint32_t nextTag();
 
+  // Creates and connects a context for every device.
+  void connectContexts();
+
   // Returns the context to use for the specified tag.
   // With `nextTag` returning an increasing number, this should lead
   // to contexts being used in a round-robin fashion.
@@ -257,6 +270,9 @@ class ProcessGroupGloo : public ProcessGroup {
   std::mutex workMutex_;
   std::condition_variable workProduceCV_;
   std::condition_variable workConsumeCV_;
+
+  // Staging buffers of the coalesced collectives, shared with their work.
+  std::shared_ptr<StagingBuffers> stagingBuffers_;
 };
 
 } // namespace c10d
@@ -91,6 +91,28 @@ void checkSameSizeAndType(
   }
 }
 
+void checkCoalescedTensors(const std::vector<at::Tensor>& tensors) {
+  if (tensors.empty()) {
+    throw std::runtime_error("Tensor list must be nonempty");
+  }
+  for (const auto& tensor : tensors) {
+    checkSingleTensorHelper(tensor);
+    if (tensor.type() != tensors[0].type() ||
+        tensor.device() != tensors[0].device()) {
+      throw std::runtime_error(
+          "Tensors must have the same type and be on the same device");
+    }
+  }
+}
+
+int64_t sumNumel(const std::vector<at::Tensor>& tensors) {
+  int64_t numel = 0;
+  for (const auto& tensor : tensors) {
+    numel += tensor.numel();
+  }
+  return numel;
+}
+
 } // namespace
 
 ProcessGroupMPI::AsyncWork::AsyncWork(at::Tensor tensor, MPI_Request request)
@@ -364,8 +386,56 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupMPI::allreduce(
 std::shared_ptr<ProcessGroup::Work> ProcessGroupMPI::allreduce_coalesced(
     std::vector<at::Tensor>& tensors,
     const AllreduceCoalescedOptions& opts) {
-  throw std::runtime_error(
-      "allreduce_coalesced is currently not supported with MPI");
+  checkCoalescedTensors(tensors);
+
+  std::function<void(std::unique_ptr<WorkEntry>&)> runFunc =
+      [opts, this](std::unique_ptr<WorkEntry>& entry) {
+        auto& tensors = entry->src;
+        // Tensors that are views of a flat buffer are reduced in place.
+        auto flat = flatViewOf(tensors);
+        at::Tensor staging;
+        if (!flat.defined()) {
+          const auto numel = sumNumel(tensors);
+          staging = stagingBuffers_.acquire(numel, tensors[0].options());
+          flat = staging.narrow(0, 0, numel);
+          int64_t offset = 0;
+          for (const auto& tensor : tensors) {
+            flat.narrow(0, offset, tensor.numel())
+                .view(tensor.sizes())
+                .copy_(tensor);
+            offset += tensor.numel();
+          }
+        }
+        ResourceGuard guard([&] {
+          if (staging.defined()) {
+            stagingBuffers_.release(staging);
+          }
+        });
+
+        c10::DeviceGuard deviceGuard(flat.device());
+        {
+          std::unique_lock<std::mutex> globalLock(pgGlobalMutex_);
+          MPI_CHECK(MPI_Allreduce(
+              MPI_IN_PLACE,
+              flat.data_ptr(),
+              flat.numel(),
+              mpiDatatype.at(flat.scalar_type()),
+              mpiOp.at(opts.reduceOp),
+              pgComm_));
+        }
+
+        if (staging.defined()) {
+          int64_t offset = 0;
+          for (auto& tensor : tensors) {
+            tensor.copy_(
+                flat.narrow(0, offset, tensor.numel()).view(tensor.sizes()));
+            offset += tensor.numel();
+          }
+        }
+      };
+  auto entry = std::unique_ptr<WorkEntry>(
+      new WorkEntry(&tensors, nullptr, std::move(runFunc)));
+  return enqueue(std::move(entry));
 }
 
 std::shared_ptr<ProcessGroup::Work> ProcessGroupMPI::reduce(
@@ -441,11 +511,91 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupMPI::allgather(
 }
 
 std::shared_ptr<ProcessGroup::Work> ProcessGroupMPI::allgather_coalesced(
-    std::vector<std::vector<at::Tensor>>& /* unused */,
-    std::vector<at::Tensor>& /* unused */,
+    std::vector<std::vector<at::Tensor>>& outputTensorLists,
+    std::vector<at::Tensor>& inputTensors,
     const AllgatherOptions& /* unused */) {
-  throw std::runtime_error(
-      "ProcessGroupMPI does not support allgather_coalesced");
+  checkCoalescedTensors(inputTensors);
+  if (outputTensorLists.size() != static_cast<size_t>(size_)) {
+    throw std::runtime_error(
+        "All gather coalesced: number of output lists should equal "
+        "to the world size");
+  }
+  // The outputs of every rank, in rank order.
+  std::vector<at::Tensor> outputTensors;
+  for (const auto& outputTensorList : outputTensorLists) {
+    if (outputTensorList.size() != inputTensors.size()) {
+      throw std::runtime_error(
+          "All gather coalesced: output lists should have as many tensors "
+          "as the input list");
+    }
+    for (size_t i = 0; i < inputTensors.size(); ++i) {
+      checkSameSizeAndType(inputTensors[i], {outputTensorList[i]});
+    }
+    outputTensors.insert(
+        outputTensors.end(), outputTensorList.begin(), outputTensorList.end());
+  }
+
+  std::function<void(std::unique_ptr<WorkEntry>&)> runFunc =
+      [this](std::unique_ptr<WorkEntry>& entry) {
+        auto& inputs = entry->src;
+        auto& outputs = entry->dst;
+        std::vector<at::Tensor> staging;
+        ResourceGuard guard([&] {
+          for (auto& buffer : staging) {
+            stagingBuffers_.release(std::move(buffer));
+          }
+        });
+
+        // Tensors that are views of a flat buffer are used in place, the
+        // others are staged in a reused buffer.
+        auto flatInput = flatViewOf(inputs);
+        if (!flatInput.defined()) {
+          const auto numel = sumNumel(inputs);
+          staging.push_back(
+              stagingBuffers_.acquire(numel, inputs[0].options()));
+          flatInput = staging.back().narrow(0, 0, numel);
+          int64_t offset = 0;
+          for (const auto& tensor : inputs) {
+            flatInput.narrow(0, offset, tensor.numel())
+                .view(tensor.sizes())
+                .copy_(tensor);
+            offset += tensor.numel();
+          }
+        }
+        auto flatOutput = flatViewOf(outputs);
+        const bool stagedOutput = !flatOutput.defined();
+        if (stagedOutput) {
+          const auto numel = sumNumel(outputs);
+          staging.push_back(
+              stagingBuffers_.acquire(numel, outputs[0].options()));
+          flatOutput = staging.back().narrow(0, 0, numel);
+        }
+
+        c10::DeviceGuard deviceGuard(flatInput.device());
+        {
+          std::unique_lock<std::mutex> globalLock(pgGlobalMutex_);
+          MPI_CHECK(MPI_Allgather(
+              flatInput.data_ptr(),
+              flatInput.numel(),
+              mpiDatatype.at(flatInput.scalar_type()),
+              flatOutput.data_ptr(),
+              flatInput.numel(),
+              mpiDatatype.at(flatInput.scalar_type()),
+              pgComm_));
+        }
+
+        if (stagedOutput) {
+          int64_t offset = 0;
+          for (auto& tensor : outputs) {
+            tensor.copy_(flatOutput.narrow(0, offset, tensor.numel())
+                             .view(tensor.sizes()));
+            offset += tensor.numel();
+          }
+        }
+      };
+  auto entry = std::unique_ptr<WorkEntry>(
+      new WorkEntry(&inputTensors, &outputTensors, std::move(runFunc)));
+  return enqueue(std::move(entry));
 }
 
 std::shared_ptr<ProcessGroup::Work> ProcessGroupMPI::gather(
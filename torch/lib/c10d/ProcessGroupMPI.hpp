@@ -190,6 +190,9 @@ class ProcessGroupMPI : public ProcessGroup {
   std::condition_variable queueProduceCV_;
   std::condition_variable queueConsumeCV_;
 
+  // Staging buffers of the coalesced collectives, used by the worker thread.
+  StagingBuffers stagingBuffers_;
+
   // Global states
   static void initMPIOnce();
   static void mpiExit();
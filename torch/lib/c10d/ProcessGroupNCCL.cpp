@@ -1,6 +1,11 @@
 #include <c10d/ProcessGroupNCCL.hpp>
 
+#include <limits.h>
+#include <unistd.h>
+
+#include <algorithm>
 #include <map>
+#include <system_error>
 #include <tuple>
 #include <unordered_set>
 
@@ -109,6 +114,25 @@ void syncStreams(
   }
 }
 
+// Parses an environment variable that is either unset, 0 or 1
+bool parseEnvVarFlag(const char* envVarName) {
+  char* stringValue = getenv(envVarName);
+  if (stringValue == nullptr) {
+    return false;
+  }
+  try {
+    auto val = std::stoi(stringValue);
+    if (val == 1) {
+      return true;
+    } else if (val == 0) {
+      return false;
+    }
+  } catch (std::exception& e) {
+  }
+  throw std::runtime_error(
+      "Invalid value for environment variable: " + std::string(envVarName));
+}
+
 } // namespace
 
 const int64_t ProcessGroupNCCL::kWatchdogThreadSleepMillis = 100;
@@ -233,24 +257,10 @@ ProcessGroupNCCL::ProcessGroupNCCL(
       ncclCommCounter_(0),
       terminateWatchdog_(false),
       opTimeout_(opTimeout) {
-  char* blockingWait = getenv(NCCL_BLOCKING_WAIT);
-  try {
-    if (blockingWait != nullptr) {
-      auto val = std::stoi(blockingWait);
-      if (val == 1) {
-        // Make wait() and synchronize() a blocking call.
-        blockingWait_ = true;
-      } else if (val != 0) {
-        throw std::runtime_error(
-            "Invalid value for environment variable: " +
-            std::string(NCCL_BLOCKING_WAIT));
-      }
-    }
-  } catch (std::exception& e) {
-    throw std::runtime_error(
-        "Invalid value for environment variable: " +
-        std::string(NCCL_BLOCKING_WAIT));
-  }
+  // Make wait() and synchronize() a blocking call.
+  blockingWait_ = parseEnvVarFlag(NCCL_BLOCKING_WAIT);
+  hierarchicalAllreduce_ = parseEnvVarFlag(NCCL_HIERARCHICAL_ALLREDUCE);
+  highPriorityStreams_ = parseEnvVarFlag(NCCL_HIGH_PRIORITY_STREAMS);
 
 #ifdef ENABLE_NCCL_ERROR_CHECKING
   ncclCommWatchdogThread_ =
@@ -339,7 +349,14 @@ void ProcessGroupNCCL::broadcastUniqueNCCLID(ncclUniqueId* ncclID) {
   // may create multiple NCCL communicators, so we use a sequence
   // number to differentiate between them.
   std::string storeKey = std::to_string(ncclCommCounter_++);
-  if (rank_ == 0) {
+  broadcastUniqueNCCLID(ncclID, storeKey, rank_ == 0);
+}
+
+void ProcessGroupNCCL::broadcastUniqueNCCLID(
+    ncclUniqueId* ncclID,
+    const std::string& storeKey,
+    bool isRoot) {
+  if (isRoot) {
     auto vec = std::vector<uint8_t>(
         reinterpret_cast<uint8_t*>(ncclID),
         reinterpret_cast<uint8_t*>(ncclID) + NCCL_UNIQUE_ID_BYTES);
@@ -404,7 +421,7 @@ std::vector<std::shared_ptr<NCCLComm>>& ProcessGroupNCCL::getNCCLComm(
     ncclComms[i] = NCCLComm::create(numRanks, rank, ncclID);
 
     // Creates the NCCL streams
-    streamVal.push_back(at::cuda::getStreamFromPool());
+    streamVal.push_back(at::cuda::getStreamFromPool(highPriorityStreams_));
   }
 
   C10D_NCCL_CHECK(ncclGroupEnd());
@@ -428,6 +445,109 @@ std::vector<std::shared_ptr<NCCLComm>>& ProcessGroupNCCL::getNCCLComm(
   return devNCCLCommMap_[devicesKey];
 }
 
+void ProcessGroupNCCL::initTopology() {
+  char hostname[HOST_NAME_MAX + 1] = {0};
+  if (gethostname(hostname, HOST_NAME_MAX) != 0) {
+    throw std::system_error(errno, std::system_category());
+  }
+  const std::string host(hostname);
+  store_->set(
+      "hierarchical/hostname/" + std::to_string(rank_),
+      std::vector<uint8_t>(host.begin(), host.end()));
+
+  // Nodes are ordered by their lowest rank, and ranks within a node by rank.
+  // The hostnames of every rank are gathered with a single request.
+  std::vector<std::string> keys;
+  keys.reserve(size_);
+  for (int rank = 0; rank < size_; ++rank) {
+    keys.push_back("hierarchical/hostname/" + std::to_string(rank));
+  }
+  const auto hosts = store_->multiGet(keys);
+  std::vector<std::string> nodes;
+  std::unordered_map<std::string, std::vector<int>> nodeRanks;
+  for (int rank = 0; rank < size_; ++rank) {
+    const std::string rankHost(hosts[rank].begin(), hosts[rank].end());
+    if (nodeRanks.find(rankHost) == nodeRanks.end()) {
+      nodes.push_back(rankHost);
+    }
+    nodeRanks[rankHost].push_back(rank);
+  }
+
+  const auto& localRanks = nodeRanks[host];
+  localSize_ = localRanks.size();
+  localRank_ = std::find(localRanks.begin(), localRanks.end(), rank_) -
+      localRanks.begin();
+  nodeCount_ = nodes.size();
+  nodeRank_ = std::find(nodes.begin(), nodes.end(), host) - nodes.begin();
+  topologyIsUniform_ = std::all_of(
+      nodeRanks.begin(),
+      nodeRanks.end(),
+      [&](const std::pair<const std::string, std::vector<int>>& node) {
+        return node.second.size() == localRanks.size();
+      });
+  topologyInitialized_ = true;
+}
+
+std::vector<std::shared_ptr<NCCLComm>>& ProcessGroupNCCL::
+    getHierarchicalNCCLComms(
+        const std::string& devicesKey,
+        const at::Device& device) {
+  usedDeviceIdxs_.insert(device.index());
+
+  {
+    std::lock_guard<std::mutex> lock(devNCCLCommMapLock_);
+    if (devNCCLCommMap_.find(devicesKey) != devNCCLCommMap_.end()) {
+      // Reuse the cached communicators if there are.
+      return devNCCLCommMap_[devicesKey];
+    }
+  }
+
+  // The lowest rank of each node creates the intra-node unique NCCL ID, and
+  // the ranks of the first node the inter-node ones.
+  const auto prefix =
+      "hierarchical/" + std::to_string(ncclCommCounter_++) + "/";
+  ncclUniqueId intraNodeID;
+  ncclUniqueId interNodeID;
+  if (localRank_ == 0) {
+    C10D_NCCL_CHECK(ncclGetUniqueId(&intraNodeID));
+  }
+  if (nodeRank_ == 0) {
+    C10D_NCCL_CHECK(ncclGetUniqueId(&interNodeID));
+  }
+  broadcastUniqueNCCLID(
+      &intraNodeID,
+      prefix + "intra/" + std::to_string(nodeRank_),
+      localRank_ == 0);
+  broadcastUniqueNCCLID(
+      &interNodeID,
+      prefix + "inter/" + std::to_string(localRank_),
+      nodeRank_ == 0);
+
+  at::cuda::OptionalCUDAGuard gpuGuard(device);
+
+  // Every rank creates its intra-node communicator first, so that all of
+  // them exist before any inter-node one is waited on.
+  std::vector<std::shared_ptr<NCCLComm>> ncclComms = {
+      NCCLComm::create(localSize_, localRank_, intraNodeID),
+      NCCLComm::create(nodeCount_, nodeRank_, interNodeID)};
+
+  ncclStreams_.emplace(
+      devicesKey,
+      std::vector<at::cuda::CUDAStream>{
+          at::cuda::getStreamFromPool(highPriorityStreams_)});
+  ncclEvents_.emplace(
+      std::piecewise_construct,
+      std::make_tuple(devicesKey),
+      std::make_tuple(1));
+
+  // Hold the lock before modifying the cache.
+  std::lock_guard<std::mutex> lock(devNCCLCommMapLock_);
+
+  // Move the NCCL resource to cache
+  devNCCLCommMap_.emplace(devicesKey, std::move(ncclComms));
+  return devNCCLCommMap_[devicesKey];
+}
+
 namespace {
 
 // Check that all `tensors' have the same type and shape and are distributed
@@ -467,6 +587,56 @@ void check_gpu_tensors(const std::vector<at::Tensor>& tensors) {
   }
 }
 
+// Check the tensors of a coalesced collective, which are flattened into a
+// single one on a single GPU.
+void check_coalesced_gpu_tensors(const std::vector<at::Tensor>& tensors) {
+  if (tensors.size() == 0) {
+    throw std::runtime_error("Tensor list must be nonempty");
+  }
+  const auto& first = tensors.front();
+  for (const auto& t : tensors) {
+    if (!t.is_cuda() || t.is_sparse()) {
+      throw std::runtime_error("Tensors must be CUDA and dense");
+    }
+    if (t.scalar_type() != first.scalar_type()) {
+      throw std::runtime_error("Tensors must have identical type");
+    }
+    if (t.device() != first.device()) {
+      throw std::runtime_error("Tensors must be on the same GPU device");
+    }
+  }
+}
+
+int64_t sumNumel(const std::vector<at::Tensor>& tensors) {
+  int64_t numel = 0;
+  for (const auto& t : tensors) {
+    numel += t.numel();
+  }
+  return numel;
+}
+
+// Copy the tensors into the flat staging buffer, or back out of it, on the
+// stream.
+void copyStaging(
+    const std::vector<at::Tensor>& tensors,
+    at::Tensor& flat,
+    at::cuda::CUDAStream& stream,
+    bool toFlat) {
+  at::cuda::CUDAStreamGuard guard(stream);
+  int64_t offset = 0;
+  for (const auto& t : tensors) {
+    // See [Sync Streams].
+    c10::cuda::CUDACachingAllocator::recordStream(t.storage().data(), stream);
+    auto view = flat.narrow(0, offset, t.numel()).view(t.sizes());
+    if (toFlat) {
+      view.copy_(t, true);
+    } else {
+      t.copy_(view, true);
+    }
+    offset += t.numel();
+  }
+}
+
 // Flatten each list in `tensor_lists' for a gather or scatter operation, and
 // ensure compatibility with the corresponding tensor in `other'.
 std::vector<at::Tensor> flatten_for_scatter_gather(
@@ -595,6 +765,15 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::allreduce(
     const AllreduceOptions& opts) {
   check_gpu_tensors(tensors);
 
+  if (hierarchicalAllreduce_ && tensors.size() == 1) {
+    if (!topologyInitialized_) {
+      initTopology();
+    }
+    if (topologyIsUniform_ && localSize_ > 1 && nodeCount_ > 1) {
+      return allreduceHierarchical(tensors, opts);
+    }
+  }
+
   return collective(
       tensors,
       tensors,
@@ -613,11 +792,136 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::allreduce(
       });
 }
 
+std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::allreduceHierarchical(
+    std::vector<at::Tensor>& tensors,
+    const AllreduceOptions& opts) {
+  const auto devices = getDeviceList(tensors);
+  const auto key = "hierarchical:" + getKeyFromDevices(devices);
+  auto& ncclComms = getHierarchicalNCCLComms(key, devices[0]);
+
+  // First let NCCL streams wait for input tensors allocation streams
+  syncStreams(devices, ncclEvents_[key], ncclStreams_[key]);
+
+  auto work = initWork(devices);
+
+  at::cuda::OptionalCUDAGuard gpuGuard(devices[0]);
+  at::cuda::CUDAStream& ncclStream = ncclStreams_[key][0];
+  auto& tensor = tensors[0];
+  c10::cuda::CUDACachingAllocator::recordStream(
+      tensor.storage().data(), ncclStream);
+
+  // Each rank of a node reduces a chunk of the tensor across nodes. The
+  // tensor is padded to a whole number of chunks if needed. The buffers are
+  // allocated on the NCCL stream, the only one using them.
+  const int64_t numel = tensor.numel();
+  const int64_t chunkNumel = (numel + localSize_ - 1) / localSize_;
+  at::Tensor buffer = tensor.view({-1});
+  at::Tensor chunk;
+  {
+    at::cuda::CUDAStreamGuard streamGuard(ncclStream);
+    if (chunkNumel * localSize_ != numel) {
+      buffer = at::zeros({chunkNumel * localSize_}, tensor.options());
+      buffer.narrow(0, 0, numel).copy_(tensor.view({-1}));
+    }
+    chunk = at::empty({chunkNumel}, tensor.options());
+  }
+
+  const auto dataType = getNcclDataType(tensor.scalar_type());
+  const auto reduceOp = ncclOp[opts.reduceOp];
+  const auto intraNodeComm = ncclComms[0]->getNcclComm();
+  const auto interNodeComm = ncclComms[1]->getNcclComm();
+  {
+    // Not a NCCL group, each of the collectives depends on the previous one.
+    std::lock_guard<std::mutex> lock(
+        *c10::cuda::CUDACachingAllocator::getFreeMutex());
+    C10D_NCCL_CHECK(ncclReduceScatter(
+        buffer.data_ptr(),
+        chunk.data_ptr(),
+        chunkNumel,
+        dataType,
+        reduceOp,
+        intraNodeComm,
+        ncclStream.stream()));
+    C10D_NCCL_CHECK(ncclAllReduce(
+        chunk.data_ptr(),
+        chunk.data_ptr(),
+        chunkNumel,
+        dataType,
+        reduceOp,
+        interNodeComm,
+        ncclStream.stream()));
+    C10D_NCCL_CHECK(ncclAllGather(
+        chunk.data_ptr(),
+        buffer.data_ptr(),
+        chunkNumel,
+        dataType,
+        intraNodeComm,
+        ncclStream.stream()));
+  }
+
+  if (chunkNumel * localSize_ != numel) {
+    at::cuda::CUDAStreamGuard streamGuard(ncclStream);
+    tensor.view({-1}).copy_(buffer.narrow(0, 0, numel));
+  }
+
+  work->cudaEvents_[0].record(ncclStream);
+  work->ncclComms_ = ncclComms;
+  work->blockingWait_ = blockingWait_;
+  work->opTimeout_ = opTimeout_;
+  return work;
+}
+
+// The tensors are reduced in place if they're views of a flat buffer, and in a
+// reused staging buffer otherwise, with a single ncclAllReduce either way.
 std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::allreduce_coalesced(
     std::vector<at::Tensor>& tensors,
     const AllreduceCoalescedOptions& opts) {
-  throw std::runtime_error(
-      "allreduce_coalesced is currently not supported with NCCL");
+  check_coalesced_gpu_tensors(tensors);
+
+  const auto numel = sumNumel(tensors);
+  at::Tensor flat = flatViewOf(tensors);
+  at::Tensor staging;
+  auto& stagingBuffers =
+      stagingBuffers_[getKeyFromDevices({tensors[0].device()})];
+  if (!flat.defined()) {
+    staging = stagingBuffers.acquire(numel, tensors[0].options());
+    flat = staging.narrow(0, 0, numel);
+  }
+  std::vector<at::Tensor> flatTensors = {flat};
+
+  auto work = collective(
+      flatTensors,
+      flatTensors,
+      [&](at::Tensor& input,
+          at::Tensor& output,
+          ncclComm_t comm,
+          at::cuda::CUDAStream& stream) {
+        return ncclAllReduce(
+            input.data_ptr(),
+            output.data_ptr(),
+            input.numel(),
+            getNcclDataType(input.scalar_type()),
+            ncclOp[opts.reduceOp],
+            comm,
+            stream.stream());
+      },
+      [&](std::vector<at::cuda::CUDAStream>& ncclStreams) {
+        if (staging.defined()) {
+          copyStaging(tensors, flat, ncclStreams[0], true);
+        }
+      },
+      [&](std::vector<at::cuda::CUDAStream>& ncclStreams) {
+        if (staging.defined()) {
+          copyStaging(tensors, flat, ncclStreams[0], false);
+        }
+      });
+
+  // The next collective using the buffer is ordered after this one on the
+  // NCCL stream.
+  if (staging.defined()) {
+    stagingBuffers.release(std::move(staging));
+  }
+  return work;
 }
 
 std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::broadcast(
@@ -712,11 +1016,91 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::allgather(
 }
 
 std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::allgather_coalesced(
-    std::vector<std::vector<at::Tensor>>& /* unused */,
-    std::vector<at::Tensor>& /* unused */,
+    std::vector<std::vector<at::Tensor>>& outputTensorLists,
+    std::vector<at::Tensor>& inputTensors,
     const AllgatherOptions& /* unused */) {
-  throw std::runtime_error(
-      "ProcessGroupNCCL does not support allgather_coalesced");
+  check_coalesced_gpu_tensors(inputTensors);
+  if (outputTensorLists.size() != static_cast<size_t>(size_)) {
+    throw std::runtime_error(
+        "allgather_coalesced: the number of output lists should equal the "
+        "world size");
+  }
+  std::vector<at::Tensor> outputTensors;
+  for (const auto& outputTensorList : outputTensorLists) {
+    if (outputTensorList.size() != inputTensors.size()) {
+      throw std::runtime_error(
+          "allgather_coalesced: the output lists should have as many "
+          "tensors as the input list");
+    }
+    for (size_t i = 0; i < inputTensors.size(); ++i) {
+      if (outputTensorList[i].sizes() != inputTensors[i].sizes() ||
+          outputTensorList[i].scalar_type() !=
+              inputTensors[i].scalar_type() ||
+          outputTensorList[i].device() != inputTensors[i].device()) {
+        throw std::runtime_error(
+            "allgather_coalesced: the output tensors should match the input "
+            "tensors in size, type and device");
+      }
+    }
+    outputTensors.insert(
+        outputTensors.end(), outputTensorList.begin(), outputTensorList.end());
+  }
+
+  // Both sides go through reused staging buffers, unless they're views of a
+  // flat buffer already.
+  auto& stagingBuffers =
+      stagingBuffers_[getKeyFromDevices({inputTensors[0].device()})];
+  at::Tensor flatInput = flatViewOf(inputTensors);
+  at::Tensor inputStaging;
+  if (!flatInput.defined()) {
+    const auto numel = sumNumel(inputTensors);
+    inputStaging = stagingBuffers.acquire(numel, inputTensors[0].options());
+    flatInput = inputStaging.narrow(0, 0, numel);
+  }
+  at::Tensor flatOutput = flatViewOf(outputTensors);
+  at::Tensor outputStaging;
+  if (!flatOutput.defined()) {
+    const auto numel = sumNumel(outputTensors);
+    outputStaging = stagingBuffers.acquire(numel, outputTensors[0].options());
+    flatOutput = outputStaging.narrow(0, 0, numel);
+  }
+  std::vector<at::Tensor> flatInputs = {flatInput};
+  std::vector<at::Tensor> flatOutputs = {flatOutput};
+
+  auto work = collective(
+      flatInputs,
+      flatOutputs,
+      [&](at::Tensor& input,
+          at::Tensor& output,
+          ncclComm_t comm,
+          at::cuda::CUDAStream& stream) {
+        c10::cuda::CUDACachingAllocator::recordStream(
+            output.storage().data(), stream);
+        return ncclAllGather(
+            input.data_ptr(),
+            output.data_ptr(),
+            input.numel(),
+            getNcclDataType(input.scalar_type()),
+            comm,
+            stream.stream());
+      },
+      [&](std::vector<at::cuda::CUDAStream>& ncclStreams) {
+        if (inputStaging.defined()) {
+          copyStaging(inputTensors, flatInput, ncclStreams[0], true);
+        }
+      },
+      [&](std::vector<at::cuda::CUDAStream>& ncclStreams) {
+        if (outputStaging.defined()) {
+          copyStaging(outputTensors, flatOutput, ncclStreams[0], false);
+        }
+      });
+
+  for (auto* staging : {&inputStaging, &outputStaging}) {
+    if (staging->defined()) {
+      stagingBuffers.release(std::move(*staging));
+    }
+  }
+  return work;
 }
 
 std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::reduce_scatter(
@@ -17,6 +17,22 @@ namespace c10d {
 // non-blocking.
 constexpr const char* NCCL_BLOCKING_WAIT = "NCCL_BLOCKING_WAIT";
 
+// Environment variable which controls whether or not allreduce is
+// hierarchical: a reduce-scatter within each node, over NVLink, an allreduce of
+// the scattered chunks across nodes, and an allgather within each node. Only
+// a 1 / (ranks per node) part of the data crosses the network. The nodes are
+// found from the hostnames of the ranks, exchanged through the store, and
+// allreduce is flat unless every node has the same number of ranks, each
+// with a single device.
+constexpr const char* NCCL_HIERARCHICAL_ALLREDUCE =
+    "NCCL_HIERARCHICAL_ALLREDUCE";
+
+// Environment variable which controls whether or not the NCCL streams are
+// taken from the high priority pool of CUDA streams, so that the scheduler
+// runs the NCCL kernels ahead of the compute kernels queued at the same time.
+constexpr const char* NCCL_HIGH_PRIORITY_STREAMS =
+    "NCCL_HIGH_PRIORITY_STREAMS";
+
 // ProcessGroupNCCL implements NCCL bindings for c10d.
 //
 // All functions of the class are expected to be called in the same order
@@ -223,12 +239,34 @@ class ProcessGroupNCCL : public ProcessGroup {
   // Helper that broadcasts nccl unique ID to all ranks through the store
   void broadcastUniqueNCCLID(ncclUniqueId* ncclID);
 
+  // Helper that broadcasts nccl unique ID from the root to the other ranks
+  // through the store, under the given key
+  void broadcastUniqueNCCLID(
+      ncclUniqueId* ncclID,
+      const std::string& storeKey,
+      bool isRoot);
+
   // Helper that either looks up the cached NCCL communicators or creates
   // a new set of NCCL communicators as a cache entry
   std::vector<std::shared_ptr<NCCLComm>>& getNCCLComm(
       const std::string& devicesKey,
       const std::vector<at::Device>& devices);
 
+  // Helper that exchanges the hostnames of all ranks through the store to
+  // find the node topology of the group
+  void initTopology();
+
+  // Helper that either looks up the cached intra-node and inter-node NCCL
+  // communicators of the hierarchical allreduce or creates them
+  std::vector<std::shared_ptr<NCCLComm>>& getHierarchicalNCCLComms(
+      const std::string& devicesKey,
+      const at::Device& device);
+
+  // The hierarchical allreduce of a single tensor
+  std::shared_ptr<ProcessGroup::Work> allreduceHierarchical(
+      std::vector<at::Tensor>& tensors,
+      const AllreduceOptions& opts);
+
   // Wrapper method which can be overridden for tests.
   virtual std::exception_ptr checkForNCCLErrors(
       const std::vector<std::shared_ptr<NCCLComm>>& ncclComms);
@@ -327,6 +365,10 @@ class ProcessGroupNCCL : public ProcessGroup {
   // The CUDA events used to sync NCCL streams
   std::unordered_map<std::string, std::vector<at::cuda::CUDAEvent>> ncclEvents_;
 
+  // The staging buffers of the coalesced collectives. They are only used on
+  // the NCCL stream of their devices key, which orders their reuse.
+  std::unordered_map<std::string, StagingBuffers> stagingBuffers_;
+
   // Device Indexes used for all collectives in this group
   std::set<int> usedDeviceIdxs_;
 
@@ -356,6 +398,22 @@ class ProcessGroupNCCL : public ProcessGroup {
 
   // Timeout for operations. This is only used when blockingWait_ is enabled.
   std::chrono::milliseconds opTimeout_;
+
+  // Whether or not allreduce is hierarchical, when the topology allows it.
+  bool hierarchicalAllreduce_ = false;
+
+  // Whether or not the NCCL streams are high priority streams.
+  bool highPriorityStreams_ = false;
+
+  // The node topology, found on the first hierarchical allreduce: the rank of
+  // this process within its node and of its node among the nodes, ordered by
+  // their lowest ranks, the number of ranks per node and the number of nodes.
+  bool topologyInitialized_ = false;
+  bool topologyIsUniform_ = false;
+  int localRank_ = 0;
+  int localSize_ = 1;
+  int nodeRank_ = 0;
+  int nodeCount_ = 1;
 };
 
 } // namespace c10d
@@ -38,6 +38,26 @@ class Store {
       const std::vector<std::string>& keys,
       const std::chrono::milliseconds& timeout) = 0;
 
+  // Batched set and get of several keys, e.g. for the exchange of a value by
+  // every rank of a large job. multiGet waits for all of the keys. These
+  // default to one call per key; stores with a server answer them with a
+  // single request.
+  virtual void multiSet(
+      const std::vector<std::string>& keys,
+      const std::vector<std::vector<uint8_t>>& values);
+
+  virtual std::vector<std::vector<uint8_t>> multiGet(
+      const std::vector<std::string>& keys);
+
+  // Atomically sets the key to desiredValue if its current value is
+  // expectedValue, or if it doesn't exist and expectedValue is empty.
+  // Returns the value of the key after the call, or expectedValue if the key
+  // doesn't exist and wasn't set.
+  virtual std::vector<uint8_t> compareSet(
+      const std::string& key,
+      const std::vector<uint8_t>& expectedValue,
+      const std::vector<uint8_t>& desiredValue);
+
   void setTimeout(const std::chrono::milliseconds& timeout);
 
  protected:
@@ -1,6 +1,6 @@
 #include <c10d/TCPStore.hpp>
 
-#include <poll.h>
+#include <sys/epoll.h>
 
 #include <unistd.h>
 #include <algorithm>
@@ -10,12 +10,24 @@ namespace c10d {
 
 namespace {
 
-enum class QueryType : uint8_t { SET, GET, ADD, CHECK, WAIT };
+enum class QueryType : uint8_t {
+  SET,
+  GET,
+  ADD,
+  CHECK,
+  WAIT,
+  MULTI_SET,
+  MULTI_GET,
+  COMPARE_SET
+};
 
 enum class CheckResponseType : uint8_t { READY, NOT_READY };
 
 enum class WaitResponseType : uint8_t { STOP_WAITING };
 
+// The events handled per epoll_wait call
+constexpr int kMaxEvents = 64;
+
 } // anonymous namespace
 
 // TCPStoreDaemon class methods
@@ -28,6 +40,16 @@ TCPStoreDaemon::TCPStoreDaemon(int storeListenSocket)
         "Failed to create the control pipe to start the "
         "TCPStoreDaemon run");
   }
+  SYSCHECK_ERR_RETURN_NEG1(epollFd_ = ::epoll_create1(EPOLL_CLOEXEC));
+  // TCPStore's listening socket accepts new connections, and the read end of
+  // the pipe signals the stopping of the daemon run when it's closed.
+  for (auto fd : {storeListenSocket_, controlPipeFd_[0]}) {
+    struct epoll_event event = {};
+    event.events = EPOLLIN;
+    event.data.fd = fd;
+    SYSCHECK_ERR_RETURN_NEG1(
+        ::epoll_ctl(epollFd_, EPOLL_CTL_ADD, fd, &event));
+  }
   daemonThread_ = std::thread(&TCPStoreDaemon::run, this);
 }
 
@@ -38,9 +60,10 @@ TCPStoreDaemon::~TCPStoreDaemon() {
   join();
   // Close unclosed sockets
   for (auto socket : sockets_) {
-    if (socket != -1) {
-      ::close(socket);
-    }
+    ::close(socket);
+  }
+  if (epollFd_ != -1) {
+    ::close(epollFd_);
   }
   // Now close the rest control pipe
   for (auto fd : controlPipeFd_) {
@@ -55,58 +78,56 @@ void TCPStoreDaemon::join() {
 }
 
 void TCPStoreDaemon::run() {
-  std::vector<struct pollfd> fds;
-  fds.push_back({.fd = storeListenSocket_, .events = POLLIN});
-  // Push the read end of the pipe to signal the stopping of the daemon run
-  fds.push_back({.fd = controlPipeFd_[0], .events = POLLHUP});
+  std::vector<struct epoll_event> events(kMaxEvents);
 
   // receive the queries
-  bool finished = false;
-  while (!finished) {
-    for (size_t i = 0; i < sockets_.size(); i++) {
-      fds[i].revents = 0;
-    }
-
-    SYSCHECK_ERR_RETURN_NEG1(::poll(fds.data(), fds.size(), -1));
-
-    // TCPStore's listening socket has an event and it should now be able to
-    // accept new connections.
-    if (fds[0].revents != 0) {
-      if (fds[0].revents ^ POLLIN) {
-        throw std::system_error(
-            ECONNABORTED,
-            std::system_category(),
-            "Unexpected poll revent on the master's listening socket: " +
-                std::to_string(fds[0].revents));
-      }
-      int sockFd = std::get<0>(tcputil::accept(storeListenSocket_));
-      sockets_.push_back(sockFd);
-      fds.push_back({.fd = sockFd, .events = POLLIN});
-    }
-    // The pipe receives an event which tells us to shutdown the daemon
-    if (fds[1].revents != 0) {
-      // Will be POLLUP when the pipe is closed
-      if (fds[1].revents ^ POLLHUP) {
-        throw std::system_error(
-            ECONNABORTED,
-            std::system_category(),
-            "Unexpected poll revent on the control pipe's reading fd: " +
-                std::to_string(fds[1].revents));
+  while (true) {
+    int numEvents;
+    SYSCHECK_ERR_RETURN_NEG1(
+        numEvents = ::epoll_wait(epollFd_, events.data(), kMaxEvents, -1));
+
+    for (int i = 0; i < numEvents; i++) {
+      const int fd = events[i].data.fd;
+      const auto revents = events[i].events;
+
+      // The pipe receives an event which tells us to shutdown the daemon
+      if (fd == controlPipeFd_[0]) {
+        // Will be EPOLLHUP when the pipe is closed
+        if (!(revents & EPOLLHUP)) {
+          throw std::system_error(
+              ECONNABORTED,
+              std::system_category(),
+              "Unexpected epoll event on the control pipe's reading fd: " +
+                  std::to_string(revents));
+        }
+        return;
       }
-      finished = true;
-      break;
-    }
-    // Skipping the fds[0] and fds[1],
-    // fds[0] is master's listening socket
-    // fds[1] is control pipe's reading fd
-    for (size_t fdIdx = 2; fdIdx < fds.size(); ++fdIdx) {
-      if (fds[fdIdx].revents == 0) {
+
+      // The listening socket has an event and it should now be able to
+      // accept new connections.
+      if (fd == storeListenSocket_) {
+        if (revents ^ EPOLLIN) {
+          throw std::system_error(
+              ECONNABORTED,
+              std::system_category(),
+              "Unexpected epoll event on the master's listening socket: " +
+                  std::to_string(revents));
+        }
+        int sockFd = std::get<0>(tcputil::accept(storeListenSocket_));
+        struct epoll_event event = {};
+        event.events = EPOLLIN;
+        event.data.fd = sockFd;
+        SYSCHECK_ERR_RETURN_NEG1(
+            ::epoll_ctl(epollFd_, EPOLL_CTL_ADD, sockFd, &event));
+        sockets_.insert(sockFd);
         continue;
       }
 
-      // Now query the socket that has the event
+      // Now query the socket that has the event. The sockets are level
+      // triggered, so a client that sent several queries is served again on
+      // the next epoll_wait.
       try {
-        query(fds[fdIdx].fd);
+        query(fd);
       } catch (...) {
         // There was an error when processing query. Probably an exception
         // occurred in recv/send what would indicate that socket on the other
@@ -115,39 +136,31 @@ void TCPStoreDaemon::run() {
         // exception, other connections will get an exception once they try to
         // use the store. We will go ahead and close this connection whenever
         // we hit an exception here.
-        ::close(fds[fdIdx].fd);
-
-        // Remove all the tracking state of the close FD
-        for (auto it = waitingSockets_.begin(); it != waitingSockets_.end();) {
-          for (auto vecIt = it->second.begin(); vecIt != it->second.end();) {
-            if (*vecIt == fds[fdIdx].fd) {
-              vecIt = it->second.erase(vecIt);
-            } else {
-              ++vecIt;
-            }
-          }
-          if (it->second.size() == 0) {
-            it = waitingSockets_.erase(it);
-          } else {
-            ++it;
-          }
-        }
-        for (auto it = keysAwaited_.begin(); it != keysAwaited_.end();) {
-          if (it->first == fds[fdIdx].fd) {
-            it = keysAwaited_.erase(it);
-          } else {
-            ++it;
-          }
-        }
-        fds.erase(fds.begin() + fdIdx);
-        sockets_.erase(sockets_.begin() + fdIdx - 2);
-        --fdIdx;
-        continue;
+        closeSocket(fd);
       }
     }
   }
 }
 
+void TCPStoreDaemon::closeSocket(int socket) {
+  // Closing the socket also removes it from the epoll set
+  ::close(socket);
+  sockets_.erase(socket);
+
+  // Remove all the tracking state of the close FD
+  for (auto it = waitingSockets_.begin(); it != waitingSockets_.end();) {
+    auto& sockets = it->second;
+    sockets.erase(
+        std::remove(sockets.begin(), sockets.end(), socket), sockets.end());
+    if (sockets.empty()) {
+      it = waitingSockets_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  keysAwaited_.erase(socket);
+}
+
 void TCPStoreDaemon::stop() {
   if (controlPipeFd_[1] != -1) {
     // close the write end of the pipe
@@ -159,8 +172,11 @@ void TCPStoreDaemon::stop() {
 // query communicates with the worker. The format
 // of the query is as follows:
 // type of query | size of arg1 | arg1 | size of arg2 | arg2 | ...
-// or, in the case of wait
+// or, in the case of check, wait and multi get
 // type of query | number of args | size of arg1 | arg1 | ...
+// and in the case of multi set
+// type of query | number of keys | size of key1 | key1 | ... |
+//   size of value1 | value1 | ...
 void TCPStoreDaemon::query(int socket) {
   QueryType qt;
   tcputil::recvBytes<QueryType>(socket, &qt, 1);
@@ -180,6 +196,15 @@ void TCPStoreDaemon::query(int socket) {
   } else if (qt == QueryType::WAIT) {
     waitHandler(socket);
 
+  } else if (qt == QueryType::MULTI_SET) {
+    multiSetHandler(socket);
+
+  } else if (qt == QueryType::MULTI_GET) {
+    multiGetHandler(socket);
+
+  } else if (qt == QueryType::COMPARE_SET) {
+    compareSetHandler(socket);
+
   } else {
     throw std::runtime_error("Unexpected query type");
   }
@@ -228,13 +253,46 @@ void TCPStoreDaemon::getHandler(int socket) const {
   tcputil::sendVector<uint8_t>(socket, data);
 }
 
-void TCPStoreDaemon::checkHandler(int socket) const {
-  SizeType nargs;
-  tcputil::recvBytes<SizeType>(socket, &nargs, 1);
-  std::vector<std::string> keys(nargs);
-  for (size_t i = 0; i < nargs; i++) {
-    keys[i] = tcputil::recvString(socket);
+void TCPStoreDaemon::multiSetHandler(int socket) {
+  auto keys = recvKeys(socket);
+  for (const auto& key : keys) {
+    tcpStore_[key] = tcputil::recvVector<uint8_t>(socket);
   }
+  for (const auto& key : keys) {
+    wakeupWaitingClients(key);
+  }
+}
+
+void TCPStoreDaemon::multiGetHandler(int socket) const {
+  auto keys = recvKeys(socket);
+  for (size_t i = 0; i < keys.size(); i++) {
+    tcputil::sendVector<uint8_t>(
+        socket, tcpStore_.at(keys[i]), (i != (keys.size() - 1)));
+  }
+}
+
+void TCPStoreDaemon::compareSetHandler(int socket) {
+  std::string key = tcputil::recvString(socket);
+  auto expectedValue = tcputil::recvVector<uint8_t>(socket);
+  auto desiredValue = tcputil::recvVector<uint8_t>(socket);
+
+  auto it = tcpStore_.find(key);
+  if (it == tcpStore_.end()) {
+    if (!expectedValue.empty()) {
+      tcputil::sendVector<uint8_t>(socket, expectedValue);
+      return;
+    }
+  } else if (it->second != expectedValue) {
+    tcputil::sendVector<uint8_t>(socket, it->second);
+    return;
+  }
+  tcpStore_[key] = desiredValue;
+  tcputil::sendVector<uint8_t>(socket, desiredValue);
+  wakeupWaitingClients(key);
+}
+
+void TCPStoreDaemon::checkHandler(int socket) const {
+  auto keys = recvKeys(socket);
   // Now we have received all the keys
   if (checkKeys(keys)) {
     tcputil::sendValue<CheckResponseType>(socket, CheckResponseType::READY);
@@ -244,21 +302,31 @@ void TCPStoreDaemon::checkHandler(int socket) const {
 }
 
 void TCPStoreDaemon::waitHandler(int socket) {
-  SizeType nargs;
-  tcputil::recvBytes<SizeType>(socket, &nargs, 1);
-  std::vector<std::string> keys(nargs);
-  for (size_t i = 0; i < nargs; i++) {
-    keys[i] = tcputil::recvString(socket);
-  }
+  auto keys = recvKeys(socket);
   if (checkKeys(keys)) {
     tcputil::sendValue<WaitResponseType>(
         socket, WaitResponseType::STOP_WAITING);
   } else {
+    // Only the keys that are missing wake up the client when they're set
+    size_t numKeysAwaited = 0;
     for (auto& key : keys) {
-      waitingSockets_[key].push_back(socket);
+      if (tcpStore_.count(key) == 0) {
+        waitingSockets_[key].push_back(socket);
+        numKeysAwaited++;
+      }
     }
-    keysAwaited_[socket] = keys.size();
+    keysAwaited_[socket] = numKeysAwaited;
+  }
+}
+
+std::vector<std::string> TCPStoreDaemon::recvKeys(int socket) const {
+  SizeType nargs;
+  tcputil::recvBytes<SizeType>(socket, &nargs, 1);
+  std::vector<std::string> keys(nargs);
+  for (size_t i = 0; i < nargs; i++) {
+    keys[i] = tcputil::recvString(socket);
   }
+  return keys;
 }
 
 bool TCPStoreDaemon::checkKeys(const std::vector<std::string>& keys) const {
@@ -363,12 +431,7 @@ int64_t TCPStore::addHelper_(const std::string& key, int64_t value) {
 
 bool TCPStore::check(const std::vector<std::string>& keys) {
   tcputil::sendValue<QueryType>(storeSocket_, QueryType::CHECK);
-  SizeType nkeys = keys.size();
-  tcputil::sendBytes<SizeType>(storeSocket_, &nkeys, 1, (nkeys > 0));
-  for (size_t i = 0; i < nkeys; i++) {
-    std::string regKey = regularPrefix_ + keys[i];
-    tcputil::sendString(storeSocket_, regKey, (i != (nkeys - 1)));
-  }
+  sendKeys_(regularKeys_(keys));
   auto checkResponse = tcputil::recvValue<CheckResponseType>(storeSocket_);
   if (checkResponse == CheckResponseType::READY) {
     return true;
@@ -379,6 +442,49 @@ bool TCPStore::check(const std::vector<std::string>& keys) {
   }
 }
 
+void TCPStore::multiSet(
+    const std::vector<std::string>& keys,
+    const std::vector<std::vector<uint8_t>>& values) {
+  if (keys.size() != values.size()) {
+    throw std::invalid_argument(
+        "multiSet expects as many values as keys, got " +
+        std::to_string(values.size()) + " values for " +
+        std::to_string(keys.size()) + " keys");
+  }
+  tcputil::sendValue<QueryType>(storeSocket_, QueryType::MULTI_SET);
+  sendKeys_(regularKeys_(keys), true);
+  for (size_t i = 0; i < values.size(); i++) {
+    tcputil::sendVector<uint8_t>(
+        storeSocket_, values[i], (i != (values.size() - 1)));
+  }
+}
+
+std::vector<std::vector<uint8_t>> TCPStore::multiGet(
+    const std::vector<std::string>& keys) {
+  auto regKeys = regularKeys_(keys);
+  waitHelper_(regKeys, timeout_);
+  tcputil::sendValue<QueryType>(storeSocket_, QueryType::MULTI_GET);
+  sendKeys_(regKeys);
+  std::vector<std::vector<uint8_t>> values;
+  values.reserve(regKeys.size());
+  for (size_t i = 0; i < regKeys.size(); i++) {
+    values.push_back(tcputil::recvVector<uint8_t>(storeSocket_));
+  }
+  return values;
+}
+
+std::vector<uint8_t> TCPStore::compareSet(
+    const std::string& key,
+    const std::vector<uint8_t>& expectedValue,
+    const std::vector<uint8_t>& desiredValue) {
+  std::string regKey = regularPrefix_ + key;
+  tcputil::sendValue<QueryType>(storeSocket_, QueryType::COMPARE_SET);
+  tcputil::sendString(storeSocket_, regKey, true);
+  tcputil::sendVector<uint8_t>(storeSocket_, expectedValue, true);
+  tcputil::sendVector<uint8_t>(storeSocket_, desiredValue);
+  return tcputil::recvVector<uint8_t>(storeSocket_);
+}
+
 void TCPStore::wait(const std::vector<std::string>& keys) {
   wait(keys, timeout_);
 }
@@ -386,12 +492,7 @@ void TCPStore::wait(const std::vector<std::string>& keys) {
 void TCPStore::wait(
     const std::vector<std::string>& keys,
     const std::chrono::milliseconds& timeout) {
-  std::vector<std::string> regKeys;
-  regKeys.resize(keys.size());
-  for (size_t i = 0; i < keys.size(); ++i) {
-    regKeys[i] = regularPrefix_ + keys[i];
-  }
-  waitHelper_(regKeys, timeout);
+  waitHelper_(regularKeys_(keys), timeout);
 }
 
 void TCPStore::waitHelper_(
@@ -409,15 +510,30 @@ void TCPStore::waitHelper_(
         sizeof(timeoutTV)));
   }
   tcputil::sendValue<QueryType>(storeSocket_, QueryType::WAIT);
-  SizeType nkeys = keys.size();
-  tcputil::sendBytes<SizeType>(storeSocket_, &nkeys, 1, (nkeys > 0));
-  for (size_t i = 0; i < nkeys; i++) {
-    tcputil::sendString(storeSocket_, keys[i], (i != (nkeys - 1)));
-  }
+  sendKeys_(keys);
   auto waitResponse = tcputil::recvValue<WaitResponseType>(storeSocket_);
   if (waitResponse != WaitResponseType::STOP_WAITING) {
     throw std::runtime_error("Stop_waiting response is expected");
   }
 }
 
+void TCPStore::sendKeys_(const std::vector<std::string>& keys, bool moreData) {
+  SizeType nkeys = keys.size();
+  tcputil::sendBytes<SizeType>(storeSocket_, &nkeys, 1, moreData || nkeys > 0);
+  for (size_t i = 0; i < nkeys; i++) {
+    tcputil::sendString(
+        storeSocket_, keys[i], moreData || (i != (nkeys - 1)));
+  }
+}
+
+std::vector<std::string> TCPStore::regularKeys_(
+    const std::vector<std::string>& keys) {
+  std::vector<std::string> regKeys;
+  regKeys.reserve(keys.size());
+  for (const auto& key : keys) {
+    regKeys.push_back(regularPrefix_ + key);
+  }
+  return regKeys;
+}
+
 } // namespace c10d
@@ -3,12 +3,17 @@
 #include <memory>
 #include <thread>
 #include <unordered_map>
+#include <unordered_set>
 
 #include <c10d/Store.hpp>
 #include <c10d/Utils.hpp>
 
 namespace c10d {
 
+// The server of the store. It serves every client from a single thread,
+// waiting on their sockets with epoll, so that it scales to the thousands of
+// clients of a large job: an event costs the same however many clients are
+// connected.
 class TCPStoreDaemon {
  public:
   explicit TCPStoreDaemon(int storeListenSocket);
@@ -27,9 +32,14 @@ class TCPStoreDaemon {
   void getHandler(int socket) const;
   void checkHandler(int socket) const;
   void waitHandler(int socket);
+  void multiSetHandler(int socket);
+  void multiGetHandler(int socket) const;
+  void compareSetHandler(int socket);
 
+  std::vector<std::string> recvKeys(int socket) const;
   bool checkKeys(const std::vector<std::string>& keys) const;
   void wakeupWaitingClients(const std::string& key);
+  void closeSocket(int socket);
 
   std::thread daemonThread_;
   std::unordered_map<std::string, std::vector<uint8_t>> tcpStore_;
@@ -38,8 +48,9 @@ class TCPStoreDaemon {
   // From socket -> number of keys awaited
   std::unordered_map<int, size_t> keysAwaited_;
 
-  std::vector<int> sockets_;
+  std::unordered_set<int> sockets_;
   int storeListenSocket_;
+  int epollFd_ = -1;
   std::vector<int> controlPipeFd_{-1, -1};
 };
 
@@ -62,6 +73,18 @@ class TCPStore : public Store {
 
   bool check(const std::vector<std::string>& keys) override;
 
+  void multiSet(
+      const std::vector<std::string>& keys,
+      const std::vector<std::vector<uint8_t>>& values) override;
+
+  std::vector<std::vector<uint8_t>> multiGet(
+      const std::vector<std::string>& keys) override;
+
+  std::vector<uint8_t> compareSet(
+      const std::string& key,
+      const std::vector<uint8_t>& expectedValue,
+      const std::vector<uint8_t>& desiredValue) override;
+
   void wait(const std::vector<std::string>& keys) override;
 
   void wait(
@@ -74,6 +97,8 @@ class TCPStore : public Store {
   void waitHelper_(
       const std::vector<std::string>& keys,
       const std::chrono::milliseconds& timeout);
+  void sendKeys_(const std::vector<std::string>& keys, bool moreData = false);
+  std::vector<std::string> regularKeys_(const std::vector<std::string>& keys);
   void waitForWorkers_();
 
   bool isServer_;
@@ -3,11 +3,13 @@
 #include <sys/socket.h>
 #include <sys/types.h>
 
+#include <algorithm>
 #include <chrono>
 #include <cstdint>
 #include <cstdlib>
 #include <functional>
 #include <limits>
+#include <mutex>
 #include <string>
 #include <system_error>
 #include <tuple>
@@ -259,6 +261,71 @@ inline at::Tensor flattenDenseTensors(at::TensorList tensors) {
   return at::cat(::c10d::fmap(tensors, flatten));
 }
 
+// Returns the flat tensor that the dense tensors are consecutive views of,
+// e.g. when they already live in a bucket, or an undefined tensor if they
+// aren't. Coalesced collectives run on it in place, without flattening the
+// tensors into a buffer and copying them back.
+inline at::Tensor flatViewOf(at::TensorList tensors) {
+  if (tensors.empty()) {
+    return at::Tensor();
+  }
+  const auto& first = tensors[0];
+  int64_t numel = 0;
+  for (const auto& tensor : tensors) {
+    if (tensor.layout() != at::kStrided || !tensor.is_contiguous() ||
+        !tensor.is_alias_of(first) ||
+        tensor.scalar_type() != first.scalar_type() ||
+        tensor.storage_offset() != first.storage_offset() + numel) {
+      return at::Tensor();
+    }
+    numel += tensor.numel();
+  }
+  return first.as_strided({numel}, {1});
+}
+
+// Flat staging buffers reused by the coalesced collectives across calls,
+// instead of allocating new ones every time. A buffer is taken for the
+// duration of a collective, so concurrent collectives get distinct buffers.
+// At most kMaxFreeBuffers are kept, the largest ones.
+class StagingBuffers {
+ public:
+  // Returns a flat buffer of at least numel elements.
+  at::Tensor acquire(int64_t numel, const at::TensorOptions& options) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      for (auto it = free_.begin(); it != free_.end(); ++it) {
+        if (it->device() == options.device() &&
+            it->dtype() == options.dtype() && it->numel() >= numel) {
+          auto buffer = std::move(*it);
+          free_.erase(it);
+          return buffer;
+        }
+      }
+    }
+    return at::empty({numel}, options);
+  }
+
+  void release(at::Tensor buffer) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    free_.push_back(std::move(buffer));
+    if (free_.size() > kMaxFreeBuffers) {
+      free_.erase(std::min_element(
+          free_.begin(),
+          free_.end(),
+          [](const at::Tensor& a, const at::Tensor& b) {
+            return a.numel() < b.numel();
+          }));
+    }
+  }
+
+ private:
+  static constexpr size_t kMaxFreeBuffers = 8;
+
+
+  std::mutex mutex_;
+  std::vector<at::Tensor> free_;
+};
+
 inline at::Tensor newLikeFlat(
     std::vector<std::vector<at::Tensor>>& tensors,
     size_t deviceIdx) {
@@ -22,6 +22,20 @@ void testHelper(const std::string& prefix = "") {
   c10d::test::check(serverStore, "key1", "value1");
   c10d::test::check(serverStore, "key2", "value2");
 
+  // Batched set/get and compare-and-set
+  serverStore.multiSet(
+      {"multi0", "multi1"},
+      {std::vector<uint8_t>{'a'}, std::vector<uint8_t>{'b', 'c'}});
+  c10d::test::check(serverStore, "multi1", "bc");
+  auto values = serverStore.multiGet({"multi1", "multi0", "key0"});
+  if (values.size() != 3 || values[0].size() != 2 || values[1].size() != 1 ||
+      values[2].size() != 6) {
+    throw std::runtime_error("Unexpected multiGet result");
+  }
+  serverStore.compareSet("multi0", {'a'}, {'d'});
+  serverStore.compareSet("multi0", {'a'}, {'e'});
+  c10d::test::check(serverStore, "multi0", "d");
+
   // Hammer on TCPStore
   std::vector<std::thread> threads;
   const auto numIterations = 1000;
@@ -16,10 +16,11 @@ contents, and we recommend referring to very good docs of the original module.
 import torch
 import sys
 from .reductions import init_reductions
+from .cuda_ipc_pool import CudaIPCPool
 import multiprocessing
 
 __all__ = ['set_sharing_strategy', 'get_sharing_strategy',
-           'get_all_sharing_strategies']
+           'get_all_sharing_strategies', 'CudaIPCPool']
 
 
 from multiprocessing import *
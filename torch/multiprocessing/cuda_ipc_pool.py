@@ -0,0 +1,180 @@
+import threading
+import uuid
+import weakref
+
+import torch
+
+
+_BLOCK_SIZE = 512
+
+# The pools created by this process, to find the pool of a CUDA tensor being
+# sent, and the pools received from other processes, to rebuild their tensors.
+_local_pools = weakref.WeakValueDictionary()
+_received_pools = weakref.WeakValueDictionary()
+
+
+class CudaIPCPool(object):
+    r"""A pool of CUDA memory that is shared with other processes once, to share
+    the tensors allocated from it without the cost of sharing each of them.
+
+    Sending a CUDA tensor to another process normally shares its allocation
+    through a new CUDA IPC handle, with its own reference counter and
+    interprocess event. A pool instead allocates one slab of ``size`` bytes,
+    and :meth:`empty` returns tensors viewing sub-allocations of it. Once the
+    pool itself has been sent to a process, these tensors, and any view of
+    them, are sent to that process as their offset in the slab. They are rebuilt
+    as views of the slab it already mapped, and about the only per tensor cost
+    left is the recording of the event of the pool.
+
+    The reference counts of the sub-allocations are kept in one shared memory
+    tensor. A sub-allocation is reused by :meth:`empty` only once no tensor
+    viewing it is alive in any process, and no tensor viewing it is still in
+    flight, so the pool never has to wait for consumers when freeing memory.
+    Like for other shared CUDA tensors, consumers must be done with the work
+    queued on a tensor when they free it.
+
+    Arguments:
+        size (int): the size of the slab, in bytes.
+        device (torch.device or int, optional): the device of the slab. Defaults
+            to the current device.
+
+    Example::
+
+        >>> pool = torch.multiprocessing.CudaIPCPool(2 ** 30)
+        >>> queue.put(pool)  # Once, before any of its tensors
+        >>> for batch in batches:
+        ...     tensor = pool.empty(batch.size(), dtype=batch.dtype)
+        ...     tensor.copy_(batch)
+        ...     queue.put(tensor)
+    """
+
+    def __init__(self, size, device=None):
+        if device is None:
+            device = torch.cuda.current_device()
+        device = torch.device('cuda', device) if isinstance(device, int) else torch.device(device)
+        self.id = uuid.uuid4().hex
+        self.num_blocks = max(1, (size + _BLOCK_SIZE - 1) // _BLOCK_SIZE)
+        self.slab = torch.empty(self.num_blocks * _BLOCK_SIZE, dtype=torch.uint8, device=device)
+        self.refcounts = torch.zeros(self.num_blocks, dtype=torch.int32).share_memory_()
+        self.event = torch.cuda.Event(interprocess=True)
+        with torch.cuda.device(device):
+            self.event.record()
+        # The number of blocks of every sub-allocation, by first block.
+        self._allocations = {}
+        self._lock = threading.Lock()
+        _local_pools[self.id] = self
+
+    @property
+    def device(self):
+        return self.slab.device
+
+    def empty(self, size, dtype=torch.float32):
+        r"""Returns an uninitialized contiguous tensor of the given size and
+        dtype, allocated from the pool. Raises a ``RuntimeError`` if there is no
+        free range of the slab large enough."""
+        size = torch.Size(size)
+        nbytes = size.numel() * torch.empty((), dtype=dtype).element_size()
+        num_blocks = max(1, (nbytes + _BLOCK_SIZE - 1) // _BLOCK_SIZE)
+        with self._lock:
+            start = self._find_blocks(num_blocks)
+            if start is None:
+                self._collect()
+                start = self._find_blocks(num_blocks)
+            if start is None:
+                raise RuntimeError(
+                    "CudaIPCPool of {} bytes has no free range of {} bytes left".format(
+                        self.slab.numel(), nbytes))
+            acquired = torch._C._shared_ring_try_acquire(self.refcounts, start)
+            assert acquired
+            self._allocations[start] = num_blocks
+        tensor = torch._C._shared_ring_view(
+            self.slab, start * _BLOCK_SIZE, size, dtype, self.refcounts, start)
+        # The tensor holds the sub-allocation from now on.
+        torch._C._shared_ring_release(self.refcounts, start)
+        return tensor
+
+    def _collect(self):
+        # Frees the sub-allocations no longer referenced by any process.
+        for start in [s for s in self._allocations if self.refcounts[s].item() == 0]:
+            del self._allocations[start]
+
+    def _find_blocks(self, num_blocks):
+        # First fit
+        end = 0
+        for start in sorted(self._allocations):
+            if start - end >= num_blocks:
+                return end
+            end = start + self._allocations[start]
+        if self.num_blocks - end >= num_blocks:
+            return end
+        return None
+
+    def _block_of(self, tensor):
+        # The first block of the sub-allocation `tensor` views, if any.
+        storage = tensor.storage()
+        offset = storage.data_ptr() - self.slab.data_ptr()
+        if offset < 0 or offset >= self.slab.numel() or offset % _BLOCK_SIZE != 0:
+            return None
+        if offset == 0 and storage.size() * storage.element_size() == self.slab.numel():
+            # The storage of the slab itself
+            return None
+        start = offset // _BLOCK_SIZE
+        return start if start in self._allocations else None
+
+    def __reduce__(self):
+        return (_rebuild_pool, (self.id, self.slab, self.refcounts, self.event))
+
+
+def _rebuild_pool(pool_id, slab, refcounts, event):
+    pool = _received_pools.get(pool_id)
+    if pool is None:
+        pool = CudaIPCPool.__new__(CudaIPCPool)
+        pool.id = pool_id
+        pool.slab = slab
+        pool.refcounts = refcounts
+        pool.event = event
+        pool.num_blocks = refcounts.numel()
+        _received_pools[pool_id] = pool
+    return pool
+
+
+def _rebuild_pooled_tensor(tensor_cls, pool_id, start, storage_numel, dtype,
+                           size, stride, storage_offset, requires_grad):
+    pool = _received_pools.get(pool_id)
+    if pool is None:
+        raise RuntimeError(
+            "Received a tensor of a CudaIPCPool that was not sent to this "
+            "process, or is no longer alive in it. Send the pool before its tensors.")
+    try:
+        torch.cuda.current_stream(pool.slab.device).wait_event(pool.event)
+        storage_view = torch._C._shared_ring_view(
+            pool.slab, start * _BLOCK_SIZE, [storage_numel], dtype, pool.refcounts, start)
+    finally:
+        # Drop the reference taken by the sender, the view holds one now.
+        torch._C._shared_ring_release(pool.refcounts, start)
+    t = storage_view.as_strided(size, stride, storage_offset)
+    if tensor_cls == torch.nn.parameter.Parameter:
+        t = torch.nn.parameter.Parameter(t)
+    t.requires_grad = requires_grad
+    return t
+
+
+def _reduce_pooled_tensor(tensor):
+    r"""Returns the reduction of a tensor viewing a sub-allocation of a pool
+    created by this process, or ``None``."""
+    for pool in list(_local_pools.values()):
+        if pool.slab.device != tensor.device:
+            continue
+        with pool._lock:
+            start = pool._block_of(tensor)
+            if start is None:
+                continue
+            # Hold the sub-allocation until the receiver has rebuilt the tensor
+            torch._C._shared_ring_retain(pool.refcounts, start)
+        pool.event.record(torch.cuda.current_stream(tensor.device))
+        storage = tensor.storage()
+        return (_rebuild_pooled_tensor,
+                (type(tensor), pool.id, start, storage.size(), tensor.dtype,
+                 tensor.size(), tensor.stride(), tensor.storage_offset(),
+                 tensor.requires_grad))
+    return None
@@ -8,6 +8,7 @@ import multiprocessing
 from multiprocessing.util import register_after_fork
 from multiprocessing.reduction import ForkingPickler
 import sys
+from .cuda_ipc_pool import _reduce_pooled_tensor
 try:
     # Early load resource_sharer to prevent a partially initialized instance
     # from being inherited in a forked child process. The reduce_storage method
@@ -232,6 +233,10 @@ def reduce_tensor(tensor):
     # thing.
     #
     if storage.is_cuda:
+        # Tensors allocated from a CudaIPCPool reuse the IPC handle of the pool
+        pooled = _reduce_pooled_tensor(tensor)
+        if pooled is not None:
+            return pooled
         (device,
          handle,
          storage_size_bytes,
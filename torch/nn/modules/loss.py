@@ -1279,6 +1279,12 @@ class CTCLoss(_Loss):
 
         The regular implementation uses the (more common in PyTorch) `torch.long` dtype.
 
+    .. Note::
+        On CPU, when `batch x T x (2 * max(target_lengths) + 1)` is large, only every
+        :math:`\lceil\sqrt{T}\rceil`-th time step of the forward variables is kept for
+        the backward, which recomputes the others. This takes much less memory for
+        long inputs, for about one more forward pass in the backward.
+
 
     .. include:: cudnn_deterministic.rst
 
@@ -217,6 +217,14 @@ class DistributedDataParallel(Module):
                          are getting different gradients, which should not
                          happen if DistributedDataParallel is correctly used.
                          (default: ``False``)
+        gradient_as_bucket_view: when setting to ``True``, the ``.grad`` of
+                         every dense parameter becomes a part of the
+                         flattened bucket it is reduced in, so gradients are
+                         accumulated and reduced there instead of being copied
+                         into the bucket and back. Assigning a new tensor to a
+                         ``.grad`` opts that parameter out of this until the
+                         buckets are rebuilt; ``zero_grad()`` keeps it.
+                         (default: ``False``)
 
     Attributes:
         module (Module): the module to be parallelized
@@ -230,7 +238,8 @@ class DistributedDataParallel(Module):
                  output_device=None, dim=0, broadcast_buffers=True,
                  process_group=None, bucket_cap_mb=25,
                  find_unused_parameters=False,
-                 check_reduction=False):
+                 check_reduction=False,
+                 gradient_as_bucket_view=False):
 
         super(DistributedDataParallel, self).__init__()
 
@@ -278,8 +287,11 @@ class DistributedDataParallel(Module):
         self.module = module
         self.broadcast_buffers = broadcast_buffers
         self.find_unused_parameters = find_unused_parameters
+        self.gradient_as_bucket_view = gradient_as_bucket_view
         self.require_backward_grad_sync = True
         self.require_forward_param_sync = True
+        self._join_enabled = False
+        self._join_iterations = 0
 
         if check_reduction:
             # This argument is no longer used since the reducer
@@ -379,7 +391,9 @@ class DistributedDataParallel(Module):
             parameters,
             list(reversed(bucket_indices)),
             self.process_group,
-            expect_sparse_gradient)
+            expect_sparse_gradient,
+            self.gradient_as_bucket_view,
+            self.bucket_bytes_cap)
 
         # passing a handle to torch.nn.SyncBatchNorm layer
         self._passing_sync_batchnorm_handle(self._module_copies)
@@ -397,6 +411,9 @@ class DistributedDataParallel(Module):
         super(DistributedDataParallel, self).__setstate__(state)
         self.__dict__.setdefault('require_forward_param_sync', True)
         self.__dict__.setdefault('require_backward_grad_sync', True)
+        self.__dict__.setdefault('gradient_as_bucket_view', False)
+        self.__dict__.setdefault('_join_enabled', False)
+        self.__dict__.setdefault('_join_iterations', 0)
         self._ddp_init_helper()
 
     def _check_default_group(self):
@@ -437,7 +454,108 @@ class DistributedDataParallel(Module):
         finally:
             self.require_backward_grad_sync = old_require_backward_grad_sync
 
+    @contextmanager
+    def join(self, enable=True):
+        r"""
+        A context manager to train with a different number of inputs on every
+        DDP process. Within this context, every forward pass with gradient
+        synchronization takes part in a vote on whether any process still has
+        inputs, a single element allreduce. Once a process has run out of inputs
+        and leaves the context, it shadows the collectives of the other
+        processes with zero gradients until they have all run out too, instead
+        of them waiting on it forever, so that no process has to pad its inputs
+        for the slowest one.
+
+        The gradients are still divided by the number of processes in the
+        group, so the processes that have joined count as zero gradients. When
+        all of them have joined, the parameters and buffers of the process that
+        ran the most iterations are broadcast to the others. Collectives outside
+        of DDP, such as those of :class:`torch.distributed.optim.ShardedOptimizer`,
+        are not shadowed.
+
+        Args:
+            enable (bool): whether to enable the uneven input detection. Pass
+                ``False`` to disable it when the inputs are known to be even.
+
+        Example::
+
+            >>> ddp = torch.nn.DistributedDataParallel(model, pg)
+            >>> with ddp.join():
+            ...     for input in inputs:  # as many as this process has
+            ...         ddp(input).sum().backward()
+            ...         optimizer.step()
+        """
+        old_join_enabled = self._join_enabled
+        self._join_enabled = enable
+        self._join_iterations = 0
+        try:
+            yield
+        finally:
+            self._join_enabled = old_join_enabled
+        if enable:
+            self._join_shadow()
+
+    def _join_vote(self, active):
+        vote = torch.tensor(
+            [int(active)], device=self.modules_params[0][0].device)
+        self.process_group.allreduce(vote).wait()
+        return vote.item()
+
+    def _join_shadow(self):
+        while self._join_vote(False) > 0:
+            # The collectives of a forward and a backward pass, in the order
+            # the processes that still have inputs run them.
+            self.reducer.rebuild_buckets()
+            self._sync_params()
+            self.reducer.shadow_backward()
+        self.require_forward_param_sync = True
+
+        # Encode the iteration count and rank of every process to find the
+        # one that ran the most iterations, the highest rank on ties.
+        world_size = self.process_group.size()
+        authoritative = torch.tensor(
+            [self._join_iterations * world_size + self.process_group.rank()],
+            device=self.modules_params[0][0].device)
+        self.process_group.allreduce(authoritative, dist.ReduceOp.MAX).wait()
+        with torch.no_grad():
+            dist._broadcast_coalesced(
+                self.process_group,
+                self.modules_params[0] + self.modules_buffers[0],
+                self.broadcast_bucket_size,
+                authoritative.item() % world_size)
+
+    def register_comm_hook(self, hook):
+        r"""
+        Registers a communication hook reducing the gradient buckets instead of
+        allreducing them, to compress the gradients on the wire. The hook runs
+        as soon as a bucket is ready, overlapping with the backward pass like
+        the allreduce does. Buckets of sparse gradients are still allreduced.
+
+        The built-in hooks are ``torch.distributed.AllreduceHook``,
+        ``FP16CompressHook``, ``PowerSGDHook`` and ``TopKHook``, the last two
+        with error feedback. Others can be written in C++ against
+        ``c10d::CommHookInterface``. :class:`torch.distributed.optim.ShardedOptimizer`
+        registers one to shard the optimizer state.
+
+        Example::
+
+            >>> ddp = torch.nn.DistributedDataParallel(model, pg)
+            >>> ddp.register_comm_hook(
+            ...     dist.PowerSGDHook(pg, matrix_approximation_rank=2))
+        """
+        self.reducer.register_comm_hook(hook)
+
     def forward(self, *inputs, **kwargs):
+        if (self._join_enabled and torch.is_grad_enabled() and
+                self.require_backward_grad_sync):
+            self._join_vote(True)
+            self._join_iterations += 1
+
+        # Once, after the first backward pass, reassign the buckets in the
+        # order the gradients were ready in.
+        if torch.is_grad_enabled() and self.require_backward_grad_sync:
+            self.reducer.rebuild_buckets()
+
         if self.require_forward_param_sync:
             self._sync_params()
 
@@ -6,6 +6,7 @@ from torch import Tensor  # noqa: F401
 from torch.nn import _VF
 from torch._jit_internal import Tuple, Optional, List  # noqa: F401
 from torch.nn.utils.rnn import PackedSequence
+from torch.nn.quantized.modules.utils import _quantize_weight
 import numbers
 
 
@@ -244,9 +245,7 @@ class RNNBase(torch.nn.Module):
                         #
                         #   w_ih, w_hh
                         weight_observer(weight)
-                        wt_scale, wt_zp = weight_observer.calculate_qparams()
-                        qweight = torch.quantize_per_tensor(
-                            weight.float(), float(wt_scale), int(wt_zp), torch.qint8)
+                        qweight = _quantize_weight(weight.float(), weight_observer)
                         packed_weight = \
                             torch.ops.quantized.linear_prepack(qweight, bias)
 
@@ -1,6 +1,5 @@
 import warnings
 import torch
-from torch._six import inf
 
 
 def clip_grad_norm_(parameters, max_norm, norm_type=2):
@@ -17,25 +16,25 @@ def clip_grad_norm_(parameters, max_norm, norm_type=2):
             infinity norm.
 
     Returns:
-        Total norm of the parameters (viewed as a single vector).
+        Total norm of the parameters (viewed as a single vector), as a
+        one-element tensor.
+
+    The norm and the scaling run as a few ops over all the gradients, on their
+    device, without reading the norm on the host, which would wait for the
+    backward pass to finish.
     """
     if isinstance(parameters, torch.Tensor):
         parameters = [parameters]
-    parameters = list(filter(lambda p: p.grad is not None, parameters))
+    grads = [p.grad.detach() for p in parameters if p.grad is not None]
     max_norm = float(max_norm)
     norm_type = float(norm_type)
-    if norm_type == inf:
-        total_norm = max(p.grad.data.abs().max() for p in parameters)
-    else:
-        total_norm = 0
-        for p in parameters:
-            param_norm = p.grad.data.norm(norm_type)
-            total_norm += param_norm.item() ** norm_type
-        total_norm = total_norm ** (1. / norm_type)
-    clip_coef = max_norm / (total_norm + 1e-6)
-    if clip_coef < 1:
-        for p in parameters:
-            p.grad.data.mul_(clip_coef)
+    if len(grads) == 0:
+        return torch.tensor(0.)
+    total_norm = torch._foreach_norm(grads, norm_type)
+    # Scales by 1 when the norm is below max_norm rather than testing it on
+    # the host
+    clip_coef = (max_norm / (total_norm + 1e-6)).clamp_(max=1.0)
+    torch._foreach_mul_(grads, clip_coef)
     return total_norm
 
 
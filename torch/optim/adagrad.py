@@ -2,6 +2,11 @@ import torch
 from .optimizer import Optimizer
 
 
+def _can_use_fused_sparse_step(param, state_sum, grad):
+    return (not param.is_cuda and param.dtype == torch.float32 and grad.sparse_dim() == 1 and
+            param.is_contiguous() and state_sum.is_contiguous())
+
+
 class Adagrad(Optimizer):
     """Implements Adagrad algorithm.
 
@@ -77,7 +82,10 @@ class Adagrad(Optimizer):
 
                 clr = group['lr'] / (1 + (state['step'] - 1) * group['lr_decay'])
 
-                if grad.is_sparse:
+                if grad.is_sparse and _can_use_fused_sparse_step(p.data, state['sum'], grad):
+                    # fused update straight from the uncoalesced gradient
+                    torch._sparse_adagrad_(p.data, state['sum'], grad, clr, group['eps'])
+                elif grad.is_sparse:
                     grad = grad.coalesce()  # the update is non-linear so indices must be unique
                     grad_indices = grad._indices()
                     grad_values = grad._values()
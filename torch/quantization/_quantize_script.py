@@ -118,6 +118,17 @@ def convert_script(model, inplace=False):
 
     return model
 
+def quantize_embedding_bag_script(model, bit_width=8, inplace=False):
+    r"""Replaces the embedding bags of a script module, in sum or mean mode,
+    with lookups on their weights quantized row-wise to `bit_width` (8 or 4)
+    bits, and drops the float weights.
+    """
+    _check_is_script_module(model)
+    if not inplace:
+        model = model.copy()
+    torch._C._jit_pass_quantize_embedding_bag(model._c, bit_width)
+    return model
+
 # TODO: non-scriptable QConfig will be supported later
 def script_qconfig(qconfig):
     return QConfig(
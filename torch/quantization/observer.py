@@ -300,14 +300,7 @@ class MinMaxObserver(_ObserverBase):
     def forward(self, x_orig):
         r"""Records the running minimum and maximum of ``x``."""
         x = x_orig.detach()  # avoid keeping autograd tape
-        min_val = self.min_val
-        max_val = self.max_val
-        if min_val is None or max_val is None:
-            min_val = torch.min(x)
-            max_val = torch.max(x)
-        else:
-            min_val = torch.min(torch.min(x), min_val)
-            max_val = torch.max(torch.max(x), max_val)
+        min_val, max_val = torch._observer_min_max(x, self.min_val, self.max_val)
         self.min_val = min_val
         self.max_val = max_val
         return x_orig
@@ -385,14 +378,8 @@ class MovingAverageMinMaxObserver(MinMaxObserver):
 
     def forward(self, x_orig):
         x = x_orig.detach()  # avoid keeping autograd tape
-        min_val = self.min_val
-        max_val = self.max_val
-        if min_val is None or max_val is None:
-            min_val = torch.min(x)
-            max_val = torch.max(x)
-        else:
-            min_val = min_val + self.averaging_constant * (torch.min(x) - min_val)
-            max_val = max_val + self.averaging_constant * (torch.max(x) - max_val)
+        min_val, max_val = torch._observer_moving_average_min_max(
+            x, self.min_val, self.max_val, self.averaging_constant)
         self.min_val = min_val
         self.max_val = max_val
         return x_orig
@@ -445,26 +432,9 @@ class PerChannelMinMaxObserver(_ObserverBase):
             )
 
     def forward(self, x_orig):
-        return self._forward(x_orig)
-
-    @torch.jit.ignore
-    def _forward(self, x_orig):
         x = x_orig.detach()  # avoid keeping autograd tape
-        min_vals = self.min_vals
-        max_vals = self.max_vals
-        x_dim = x.size()
-
-        new_axis_list = list(range(len(x_dim)))
-        new_axis_list[self.ch_axis] = 0
-        new_axis_list[0] = self.ch_axis
-        y = x.permute(tuple(new_axis_list))
-        y = torch.flatten(y, start_dim=1)
-        if min_vals is None or max_vals is None:
-            min_vals = torch.min(y, 1)[0]
-            max_vals = torch.max(y, 1)[0]
-        else:
-            min_vals = torch.min(torch.min(y, 1)[0], min_vals)
-            max_vals = torch.max(torch.max(y, 1)[0], max_vals)
+        min_vals, max_vals = torch._observer_min_max(
+            x, self.min_vals, self.max_vals, self.ch_axis)
         self.min_vals = min_vals
         self.max_vals = max_vals
         return x_orig
@@ -522,21 +492,8 @@ class MovingAveragePerChannelMinMaxObserver(PerChannelMinMaxObserver):
 
     def forward(self, x_orig):
         x = x_orig.detach()  # avoid keeping autograd tape
-        min_vals = self.min_vals
-        max_vals = self.max_vals
-        x_dim = x.size()
-
-        new_axis_list = list(range(len(x_dim)))
-        new_axis_list[self.ch_axis] = 0
-        new_axis_list[0] = self.ch_axis
-        y = x.permute(tuple(new_axis_list))
-        y = torch.flatten(y, start_dim=1)
-        if min_vals is None or max_vals is None:
-            min_vals = torch.min(y, 1)[0]
-            max_vals = torch.max(y, 1)[0]
-        else:
-            min_vals = min_vals + self.averaging_constant * (torch.min(y, 1)[0] - min_vals)
-            max_vals = max_vals + self.averaging_constant * (torch.max(y, 1)[0] - max_vals)
+        min_vals, max_vals = torch._observer_moving_average_min_max(
+            x, self.min_vals, self.max_vals, self.averaging_constant, self.ch_axis)
         self.min_vals = min_vals
         self.max_vals = max_vals
         return x_orig
@@ -717,82 +674,17 @@ class HistogramObserver(_ObserverBase):
         new_max = self.min_val + bin_width * (end_bin + 1)
         return new_min, new_max
 
-    @torch.jit.ignore
-    def _adjust_min_max(self, combined_min, combined_max, upsample_rate):
-        # type: (Tensor, Tensor, int) -> Tuple[Tensor, Tensor, int, int]
-        # We ensure that:
-        # (combined_max - combined_min)/(downsample_rate*Nbins) = (max - min)/(upsample_rate*Nbins)
-        # This allows us to have a common grid of resolution s, where we can align
-        # the input histogram
-        # start_idx maps min_val to the histogram bin index.
-
-        hist_bin_width = (self.max_val - self.min_val) / (self.bins * upsample_rate)
-        downsample_rate = torch.ceil((combined_max - combined_min) / (self.bins * hist_bin_width)).to(torch.int).item()
-        e = downsample_rate * (self.bins * hist_bin_width) - (combined_max - combined_min)
-        combined_max = combined_max + e / 2
-        combined_min = combined_min - e / 2
-        start_idx = torch.round((self.min_val - combined_min) / hist_bin_width).to(torch.int).item()
-        return combined_min, combined_max, downsample_rate, start_idx
-
-    @torch.jit.ignore
-    def _combine_histograms(self, orig_hist, new_hist, upsample_rate, downsample_rate, start_idx, Nbins):
-        # type: (Tensor, Tensor, int, int, int, int) -> Tensor
-        # First up-sample the histogram with new data by a factor of L
-        # This creates an approximate probability density thats piecwise constant
-        upsampled_histogram = new_hist.repeat_interleave(upsample_rate)
-        # Now insert the upsampled histogram into the output
-        # histogram, which is initialized with zeros.
-        # The offset at which the histogram is introduced is determined
-        # by the start index as the output histogram can cover a wider range
-        histogram_with_output_range = torch.zeros((Nbins * downsample_rate))
-        histogram_with_output_range[start_idx:Nbins * upsample_rate + start_idx] = upsampled_histogram
-        # Compute integral histogram, double precision is needed to ensure
-        # that there are no overflows
-        integral_histogram = torch.cumsum(histogram_with_output_range, 0,
-                                          dtype=torch.double)[downsample_rate - 1 :: downsample_rate]
-        # Finally perform interpolation
-        shifted_integral_histogram = torch.zeros((Nbins))
-        shifted_integral_histogram[1:Nbins] = integral_histogram[0:-1]
-        interpolated_histogram = (integral_histogram - shifted_integral_histogram) / upsample_rate
-        orig_hist = orig_hist + interpolated_histogram.to(torch.float)
-        return orig_hist
-
     def forward(self, x_orig):
         # type: (Tensor) -> Tensor
         x = x_orig.detach()
-        min_val = self.min_val
-        max_val = self.max_val
-        if min_val is None or max_val is None:
-            min_val = torch.min(x)
-            max_val = torch.max(x)
-            self.min_val = min_val
-            self.max_val = max_val
-            self.histogram = torch.histc(x, self.bins, min=min_val, max=max_val)
-        else:
-            new_min = torch.min(x)
-            new_max = torch.max(x)
-            combined_min = torch.min(new_min, min_val)
-            combined_max = torch.max(new_max, max_val)
-            # combine the existing histogram and new histogram into 1 histogram
-            # We do this by first upsampling the histogram to a dense grid
-            # and then downsampling the histogram efficiently
-            combined_min, combined_max, downsample_rate, start_idx = \
-                self._adjust_min_max(combined_min, combined_max, self.upsample_rate)
-            combined_histogram = torch.histc(x, self.bins, min=combined_min, max=combined_max)
-            if combined_min == min_val and combined_max == max_val:
-                combined_histogram += self.histogram
-            else:
-                combined_histogram = self._combine_histograms(
-                    combined_histogram,
-                    self.histogram,
-                    self.upsample_rate,
-                    downsample_rate,
-                    start_idx,
-                    self.bins)
-
-            self.histogram = combined_histogram
-            self.min_val = combined_min
-            self.max_val = combined_max
+        # The existing histogram is resampled onto the combined range of the
+        # observed and new values, see _observer_histogram
+        histogram, min_val, max_val = torch._observer_histogram(
+            x, self.histogram, self.min_val, self.max_val, self.bins,
+            self.upsample_rate)
+        self.histogram = histogram
+        self.min_val = min_val
+        self.max_val = max_val
         return x
 
     @torch.jit.export
@@ -46,9 +46,11 @@ def default_collate(batch):
     elem_type = type(elem)
     if isinstance(elem, torch.Tensor):
         out = None
-        if torch.utils.data.get_worker_info() is not None:
+        worker_info = torch.utils.data.get_worker_info()
+        if worker_info is not None and not worker_info._uses_shared_ring:
             # If we're in a background process, concatenate directly into a
-            # shared memory tensor to avoid an extra copy
+            # shared memory tensor to avoid an extra copy. Workers sending
+            # batches through a shared memory ring copy them into it instead.
             numel = sum([x.numel() for x in batch])
             storage = elem.storage()._new_shared(numel)
             out = elem.new(storage)
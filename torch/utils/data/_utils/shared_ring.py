@@ -0,0 +1,131 @@
+r""""Contains definitions of the shared memory ring through which the
+_MultiProcessingDataLoaderIter workers send batches to the main process when
+``shared_memory_slot_size`` is set.
+
+These **needs** to be in global scope since Py2 doesn't support serializing
+static methods.
+"""
+
+import torch
+from collections import namedtuple
+from torch._six import container_abcs, string_classes
+
+
+SLOTS_PER_WORKER = 3
+r"""Number of slots of each worker. A worker has at most two tasks outstanding,
+so this leaves one slot for the batch being consumed by the main process."""
+
+_ALIGNMENT = 64
+
+# A tensor of a batch, stored at `offset` bytes in the slot of the batch.
+_RingTensor = namedtuple('_RingTensor', ['offset', 'size', 'dtype'])
+
+# A batch whose tensors are stored in `slot`, with `data` its structure.
+_RingBatch = namedtuple('_RingBatch', ['slot', 'data'])
+
+
+class SharedMemoryRing(object):
+    r"""Slots of ``slot_size`` bytes of shared memory, :data:`SLOTS_PER_WORKER`
+    for each worker, allocated once by the main process and shared with the
+    workers when they start.
+
+    A worker :meth:`pack`\ s a batch by copying its tensors into one of its free
+    slots, and sends back only the structure of the batch, with the offsets of
+    its tensors. The main process :meth:`unpack`\ s it into tensors viewing the
+    slot, so that no storage is shared per tensor, and the slot becomes free
+    again once all of them are freed. Batches that don't fit in a slot, or
+    arrive while none of the slots of the worker is free, are sent as is.
+    """
+
+    def __init__(self, num_workers, slot_size):
+        self.slot_size = slot_size
+        num_slots = num_workers * SLOTS_PER_WORKER
+        self.buffer = torch.empty(num_slots * slot_size, dtype=torch.uint8).share_memory_()
+        self.refcounts = torch.zeros(num_slots, dtype=torch.int32).share_memory_()
+
+    def pack(self, worker_id, data):
+        tensors = []
+        _collect_tensors(data, tensors)
+        if not tensors:
+            return data
+        offsets = []
+        nbytes = 0
+        for tensor in tensors:
+            offsets.append(nbytes)
+            nbytes += tensor.numel() * tensor.element_size()
+            nbytes = (nbytes + _ALIGNMENT - 1) // _ALIGNMENT * _ALIGNMENT
+        if nbytes > self.slot_size:
+            return data
+        for slot in range(worker_id * SLOTS_PER_WORKER, (worker_id + 1) * SLOTS_PER_WORKER):
+            if torch._C._shared_ring_try_acquire(self.refcounts, slot):
+                break
+        else:
+            return data
+        base = slot * self.slot_size
+        placeholders = {}
+        for tensor, offset in zip(tensors, offsets):
+            view = torch._C._shared_ring_view(self.buffer, base + offset, tensor.size(), tensor.dtype)
+            view.copy_(tensor)
+            placeholders[id(tensor)] = _RingTensor(offset, tuple(tensor.size()), tensor.dtype)
+        return _RingBatch(slot, _replace_tensors(data, lambda t: placeholders[id(t)]))
+
+    def unpack(self, data):
+        if not isinstance(data, _RingBatch):
+            return data
+        base = data.slot * self.slot_size
+
+        def view(placeholder):
+            return torch._C._shared_ring_view(
+                self.buffer, base + placeholder.offset, placeholder.size,
+                placeholder.dtype, self.refcounts, data.slot)
+
+        try:
+            return _replace_placeholders(data.data, view)
+        finally:
+            # Drop the reference of the worker, the views now hold the slot.
+            torch._C._shared_ring_release(self.refcounts, data.slot)
+
+
+def _is_packable(tensor):
+    return tensor.device.type == 'cpu' and tensor.layout == torch.strided and not tensor.requires_grad
+
+
+def _collect_tensors(data, tensors):
+    # Walks the same containers as `pin_memory`.
+    if isinstance(data, torch.Tensor):
+        if _is_packable(data) and all(t is not data for t in tensors):
+            tensors.append(data)
+    elif isinstance(data, string_classes):
+        pass
+    elif isinstance(data, container_abcs.Mapping):
+        for v in data.values():
+            _collect_tensors(v, tensors)
+    elif isinstance(data, container_abcs.Sequence):
+        for v in data:
+            _collect_tensors(v, tensors)
+
+
+def _rebuild(data, fn, recurse):
+    if isinstance(data, string_classes):
+        return data
+    elif isinstance(data, container_abcs.Mapping):
+        return {k: recurse(v, fn) for k, v in data.items()}
+    elif isinstance(data, tuple) and hasattr(data, '_fields'):  # namedtuple
+        return type(data)(*(recurse(v, fn) for v in data))
+    elif isinstance(data, (list, tuple)):
+        return type(data)(recurse(v, fn) for v in data)
+    elif isinstance(data, container_abcs.Sequence):
+        return [recurse(v, fn) for v in data]
+    return data
+
+
+def _replace_tensors(data, fn):
+    if isinstance(data, torch.Tensor):
+        return fn(data) if _is_packable(data) else data
+    return _rebuild(data, fn, _replace_tensors)
+
+
+def _replace_placeholders(data, fn):
+    if isinstance(data, _RingTensor):
+        return fn(data)
+    return _rebuild(data, fn, _replace_placeholders)
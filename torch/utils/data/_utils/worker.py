@@ -106,7 +106,7 @@ _IterableDatasetStopIteration = namedtuple('_IterableDatasetStopIteration', ['wo
 
 def _worker_loop(dataset_kind, dataset, index_queue, data_queue, done_event,
                  auto_collation, collate_fn, drop_last, seed, init_fn, worker_id,
-                 num_workers):
+                 num_workers, shared_ring=None):
     # See NOTE [ Data Loader Multiprocessing Shutdown Logic ] for details on the
     # logic of this function.
 
@@ -124,7 +124,8 @@ def _worker_loop(dataset_kind, dataset, index_queue, data_queue, done_event,
 
         global _worker_info
         _worker_info = WorkerInfo(id=worker_id, num_workers=num_workers,
-                                  seed=seed, dataset=dataset)
+                                  seed=seed, dataset=dataset,
+                                  _uses_shared_ring=shared_ring is not None)
 
         from torch.utils.data import _DatasetKind
 
@@ -189,6 +190,12 @@ def _worker_loop(dataset_kind, dataset, index_queue, data_queue, done_event,
                         # See NOTE [ Python Traceback Reference Cycle Problem ]
                         data = ExceptionWrapper(
                             where="in DataLoader worker process {}".format(worker_id))
+            if shared_ring is not None and not isinstance(data, (ExceptionWrapper, _IterableDatasetStopIteration)):
+                try:
+                    data = shared_ring.pack(worker_id, data)
+                except Exception:
+                    data = ExceptionWrapper(
+                        where="in DataLoader worker process {}".format(worker_id))
             data_queue.put((idx, data))
             del data, idx, index, r  # save memory
     except KeyboardInterrupt:
@@ -132,6 +132,66 @@ class MkldnnBatchNorm2d(torch.jit.ScriptModule):
         )
 
 
+class MkldnnConvPackedParams(torch.nn.Module):
+    r"""Holds the MKLDNN weight and bias of a conv2d folded by
+    torch._C._jit_pass_prepack_mkldnn_conv, and serializes them as dense
+    tensors."""
+
+    def __init__(self):
+        super(MkldnnConvPackedParams, self).__init__()
+        self.stride = [1, 1]
+        self.padding = [0, 0]
+        self.dilation = [1, 1]
+        self.groups = 1
+        self._packed_weight = torch.zeros([1, 1, 1, 1])
+        self._packed_bias = torch.zeros([1])
+
+    @torch.jit.export
+    def set_conv_params(self, stride, padding, dilation, groups):
+        # type: (List[int], List[int], List[int], int) -> None
+        self.stride = stride
+        self.padding = padding
+        self.dilation = dilation
+        self.groups = groups
+
+    @torch.jit.export
+    def set_weight_bias(self, weight, bias):
+        # type: (torch.Tensor, Optional[torch.Tensor]) -> None
+        self._packed_weight = torch._C._nn.mkldnn_reorder_conv2d_weight(
+            weight.to_mkldnn(),
+            self.padding,
+            self.stride,
+            self.dilation,
+            self.groups)
+        if bias is None:
+            self._packed_bias = torch.zeros([weight.size(0)], dtype=torch.float).to_mkldnn()
+        else:
+            self._packed_bias = bias.to_mkldnn()
+
+    def forward(self, x):
+        return x
+
+    @torch.jit.export
+    def __getstate__(self):
+        return (self._packed_weight.to_dense(),
+                self._packed_bias.to_dense(),
+                self.stride,
+                self.padding,
+                self.dilation,
+                self.groups,
+                self.training)
+
+    @torch.jit.export
+    def __setstate__(self, state):
+        # type: (Tuple[Tensor, Tensor, List[int], List[int], List[int], int, bool]) -> None
+        self.stride = state[2]
+        self.padding = state[3]
+        self.dilation = state[4]
+        self.groups = state[5]
+        self.set_weight_bias(state[0], state[1])
+        self.training = state[6]
+
+
 def to_mkldnn(module):
     def m_fn(m):
         if isinstance(m, torch.nn.Linear):
@@ -150,3 +210,15 @@ def to_mkldnn(module):
         return new_m
 
     return m_fn_rec(module)
+
+
+def prepack_conv_weights(module):
+    r"""Reorders the constant weights of the conv2d calls of a frozen
+    ScriptModule into MKLDNN format once, instead of on each call. The tensors
+    are then converted to MKLDNN layout once before the first conv2d, and kept
+    in it across the relu, add, pooling, batch norm, linear, flatten and cat
+    that follow, being converted back to dense only around the other ops. The
+    module is modified in place and returned."""
+    params = torch.jit.script(MkldnnConvPackedParams())._c
+    torch._C._jit_pass_prepack_mkldnn_conv(module._c, params)
+    return module
@@ -37,6 +37,37 @@ class ExecutionStats(object):
     def num_iters(self):
         return self._c_stats.num_iters
 
+    @property
+    def latency_p50_ms(self):
+        return self._c_stats.latency_p50_ms
+
+    @property
+    def latency_p90_ms(self):
+        return self._c_stats.latency_p90_ms
+
+    @property
+    def latency_p99_ms(self):
+        return self._c_stats.latency_p99_ms
+
+    @property
+    def latency_p999_ms(self):
+        return self._c_stats.latency_p999_ms
+
+    @property
+    def latencies_ms(self):
+        '''
+        Returns the latency of every request, e.g. to plot a histogram
+        '''
+        return self._c_stats.latencies_ms
+
+    @property
+    def thread_cpu_time_ms(self):
+        '''
+        Returns the CPU time each calling thread spent while measuring, or -1
+        where it can't be measured
+        '''
+        return self._c_stats.thread_cpu_time_ms
+
     @property
     def iters_per_second(self):
         '''
@@ -46,13 +77,16 @@ class ExecutionStats(object):
 
     @property
     def total_time_seconds(self):
-        return self.num_iters * (
-            self.latency_avg_ms / 1000.0) / self.benchmark_config.num_calling_threads
-
+        return self._c_stats.total_time_ms / 1000.0
 
     def __str__(self):
         return '\n'.join([
             "Average latency per example: " + format_time(time_ms=self.latency_avg_ms),
+            "Latency percentiles: p50 {}, p90 {}, p99 {}, p99.9 {}".format(
+                format_time(time_ms=self.latency_p50_ms),
+                format_time(time_ms=self.latency_p90_ms),
+                format_time(time_ms=self.latency_p99_ms),
+                format_time(time_ms=self.latency_p999_ms)),
             "Total number of iterations: {}".format(self.num_iters),
             "Total number of iterations per second (across all threads): {:.2f}".format(self.iters_per_second),
             "Total time: " + format_time(time_s=self.total_time_seconds)
@@ -117,7 +151,8 @@ class ThroughputBenchmark(object):
         '''
         self._benchmark.add_input(*args, **kwargs)
 
-    def benchmark(self, num_calling_threads=1, num_warmup_iters=10, num_iters=100):
+    def benchmark(self, num_calling_threads=1, num_warmup_iters=10, num_iters=100,
+                  target_qps=0, max_batch_size=1):
         '''
         Args:
             num_warmup_iters (int): Warmup iters are used to make sure we run a module
@@ -132,14 +167,33 @@ class ThroughputBenchmark(object):
                 iterations might be slightly larger. Which is reported as
                 stats.num_iters where stats is the result of this function
 
-        This function returns BenchmarkExecutionStats object which is defined via pybind11.
-        It currently has two fields:
+            target_qps (float): If positive, run an open loop instead of calling
+                the module back to back: num_iters requests arrive as a Poisson
+                process at this rate across all the calling threads, and each is
+                served by the first free thread. Latencies then include the time
+                requests wait for a thread, which shows how latency grows with
+                load.
+
+            max_batch_size (int): Calling threads run the module on up to this
+                many requests at once, with their tensor inputs concatenated
+                along the first dimension. In the open-loop mode only the
+                requests that already arrived are batched. Only supported for
+                ScriptModule.
+
+        This function returns an ExecutionStats object wrapping the
+        BenchmarkExecutionStats defined via pybind11. Its fields include:
             - num_iters - number of actual iterations the benchmark have made
-            - avg_latency_ms - average time it took to infer on one input example in milliseconds
+            - latency_avg_ms - average time it took to infer on one input example in milliseconds
+            - latency_p50_ms, latency_p90_ms, latency_p99_ms, latency_p999_ms -
+              percentiles of the latencies of the requests
+            - latencies_ms - latency of every request
+            - thread_cpu_time_ms - CPU time spent by each calling thread
         '''
         config = torch._C.BenchmarkConfig()
         config.num_calling_threads = num_calling_threads
         config.num_warmup_iters = num_warmup_iters
         config.num_iters = num_iters
+        config.target_qps = target_qps
+        config.max_batch_size = max_batch_size
         c_stats = self._benchmark.benchmark(config)
         return ExecutionStats(c_stats, config)